@@ -5,6 +5,8 @@
 #include "asol/adapters/gemini/gemini_text_adapter.h"
 
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/strings/string_util.h"
@@ -45,7 +47,10 @@ bool GeminiTextAdapter::Initialize(const GeminiConfig& config) {
   
   // Configure the HTTP client
   http_client_->SetApiKey(config_.api_key);
-  http_client_->SetApiEndpoint(config_.api_endpoint);
+  std::vector<std::string> endpoints = {config_.api_endpoint};
+  endpoints.insert(endpoints.end(), config_.regional_endpoints.begin(),
+                   config_.regional_endpoints.end());
+  http_client_->SetApiEndpoints(std::move(endpoints));
   
   is_initialized_ = true;
   
@@ -83,6 +88,11 @@ bool GeminiTextAdapter::Initialize(const std::string& config_json) {
     if (json_config.contains("api_endpoint")) {
       config.api_endpoint = json_config["api_endpoint"];
     }
+
+    if (json_config.contains("regional_endpoints")) {
+      config.regional_endpoints =
+          json_config["regional_endpoints"].get<std::vector<std::string>>();
+    }
     
     return Initialize(config);
   } catch (const std::exception& e) {
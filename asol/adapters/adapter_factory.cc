@@ -10,7 +10,11 @@
 #include "asol/adapters/openai/openai_service_provider.h"
 #include "asol/adapters/copilot/copilot_service_provider.h"
 #include "asol/adapters/claude/claude_service_provider.h"
+#include "asol/adapters/mock/mock_service_provider.h"
+#include "asol/core/rate_limited_provider.h"
 #include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 
 namespace asol {
 namespace adapters {
@@ -21,6 +25,7 @@ constexpr char kGeminiAdapterId[] = "gemini";
 constexpr char kOpenAIAdapterId[] = "openai";
 constexpr char kCopilotAdapterId[] = "copilot";
 constexpr char kClaudeAdapterId[] = "claude";
+constexpr char kMockAdapterId[] = "mock";
 
 // Constants for adapter names
 constexpr char kGeminiAdapterName[] = "Google Gemini";
@@ -31,17 +36,59 @@ constexpr char kClaudeAdapterName[] = "Anthropic Claude";
 // Configuration keys
 constexpr char kConfigKeyApiKey[] = "api_key";
 constexpr char kConfigKeyDefaultProvider[] = "default_provider";
+constexpr char kConfigKeyMockProviders[] = "mock_providers";
+constexpr char kConfigKeyRequestsPerSecond[] = "requests_per_second";
+constexpr char kConfigKeyTokensPerMinute[] = "tokens_per_minute";
+
+// Rate limits for an adapter from "<adapter_id>_requests_per_second" and
+// "<adapter_id>_tokens_per_minute", falling back to the defaults
+core::RateLimitedProvider::Options GetRateLimitOptions(
+    const std::string& adapter_id,
+    const std::unordered_map<std::string, std::string>& config) {
+  core::RateLimitedProvider::Options options;
+  double value = 0.0;
+
+  auto it = config.find(adapter_id + "_" + kConfigKeyRequestsPerSecond);
+  if (it != config.end() && base::StringToDouble(it->second, &value) &&
+      value > 0.0) {
+    options.limits.requests_per_second = value;
+  }
+
+  it = config.find(adapter_id + "_" + kConfigKeyTokensPerMinute);
+  if (it != config.end() && base::StringToDouble(it->second, &value) &&
+      value > 0.0) {
+    options.limits.tokens_per_minute = value;
+  }
+
+  return options;
+}
 }  // namespace
 
 std::unique_ptr<core::MultiAdapterManager> AdapterFactory::CreateMultiAdapterManager(
     const std::unordered_map<std::string, std::string>& config) {
   auto manager = std::make_unique<core::MultiAdapterManager>();
+
+  // "mock_providers" lists provider IDs to serve from mocks instead, e.g.
+  // "gemini,openai" to benchmark routing between two simulated providers
+  std::vector<std::string> mock_provider_ids;
+  auto mock_providers = config.find(kConfigKeyMockProviders);
+  if (mock_providers != config.end()) {
+    mock_provider_ids = base::SplitString(
+        mock_providers->second, ",", base::TRIM_WHITESPACE,
+        base::SPLIT_WANT_NONEMPTY);
+  }
   
   // Create and register all available adapters
-  for (const auto& adapter_id : GetSupportedAdapterIds()) {
-    auto adapter = CreateAdapter(adapter_id, config);
+  const std::vector<std::string> adapter_ids =
+      mock_provider_ids.empty() ? GetSupportedAdapterIds() : mock_provider_ids;
+  for (const auto& adapter_id : adapter_ids) {
+    auto adapter = mock_provider_ids.empty()
+                       ? CreateAdapter(adapter_id, config)
+                       : CreateMockAdapter(adapter_id, config);
     if (adapter) {
-      manager->RegisterProvider(std::move(adapter));
+      // Pace each provider so bursts queue locally instead of drawing 429s
+      manager->RegisterProvider(std::make_unique<core::RateLimitedProvider>(
+          std::move(adapter), GetRateLimitOptions(adapter_id, config)));
     }
   }
   
@@ -69,6 +116,8 @@ std::unique_ptr<core::AIServiceProvider> AdapterFactory::CreateAdapter(
     return CreateCopilotAdapter(config);
   } else if (adapter_id == kClaudeAdapterId) {
     return CreateClaudeAdapter(config);
+  } else if (adapter_id == kMockAdapterId) {
+    return CreateMockAdapter(kMockAdapterId, config);
   } else {
     LOG(ERROR) << "Unknown adapter ID: " << adapter_id;
     return nullptr;
@@ -97,7 +146,8 @@ bool AdapterFactory::IsAdapterSupported(const std::string& adapter_id) {
   return adapter_id == kGeminiAdapterId ||
          adapter_id == kOpenAIAdapterId ||
          adapter_id == kCopilotAdapterId ||
-         adapter_id == kClaudeAdapterId;
+         adapter_id == kClaudeAdapterId ||
+         adapter_id == kMockAdapterId;
 }
 
 // Helper method to extract provider-specific configuration
@@ -190,5 +240,25 @@ std::unique_ptr<core::AIServiceProvider> AdapterFactory::CreateClaudeAdapter(
   return provider;
 }
 
+std::unique_ptr<core::AIServiceProvider> AdapterFactory::CreateMockAdapter(
+    const std::string& provider_id,
+    const std::unordered_map<std::string, std::string>& config) {
+  auto provider = std::make_unique<mock::MockServiceProvider>(provider_id);
+
+  // Settings shared by every mock ("mock_latency_ms"), then those of the
+  // provider it stands in for ("gemini_latency_ms")
+  auto provider_config = ExtractProviderConfig(kMockAdapterId, config);
+  if (provider_id != kMockAdapterId) {
+    for (auto& [key, value] : ExtractProviderConfig(provider_id, config)) {
+      provider_config[key] = std::move(value);
+    }
+  }
+  if (!provider_config.empty()) {
+    provider->Configure(provider_config);
+  }
+
+  return provider;
+}
+
 }  // namespace adapters
 }  // namespace asol
\ No newline at end of file
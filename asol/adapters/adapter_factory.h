@@ -27,7 +27,8 @@ class AdapterFactory {
       const std::string& adapter_id,
       const std::unordered_map<std::string, std::string>& config);
   
-  // Get the list of all supported adapter IDs
+  // Get the list of all supported adapter IDs. The mock adapter is not
+  // listed; see CreateMockAdapter().
   static std::vector<std::string> GetSupportedAdapterIds();
   
   // Get the list of all supported adapter names
@@ -52,6 +53,14 @@ class AdapterFactory {
   // Create a Claude adapter
   static std::unique_ptr<core::AIServiceProvider> CreateClaudeAdapter(
       const std::unordered_map<std::string, std::string>& config);
+
+  // Create a mock adapter answering as |provider_id|, configured from the
+  // "mock_" keys and then the "<provider_id>_" keys of |config|. Created
+  // for the "mock" adapter ID, and by CreateMultiAdapterManager() for each
+  // ID in "mock_providers" in place of the real providers.
+  static std::unique_ptr<core::AIServiceProvider> CreateMockAdapter(
+      const std::string& provider_id,
+      const std::unordered_map<std::string, std::string>& config);
 };
 
 }  // namespace adapters
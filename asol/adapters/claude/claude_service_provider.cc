@@ -4,8 +4,11 @@
 
 #include "asol/adapters/claude/claude_service_provider.h"
 
+#include <algorithm>
 #include <utility>
 
+#include "asol/adapters/provider_token_counter.h"
+#include "asol/core/prompt_cache.h"
 #include "base/logging.h"
 #include "base/strings/string_util.h"
 
@@ -25,6 +28,28 @@ constexpr char kConfigKeyModel[] = "model";
 constexpr char kConfigKeyTemperature[] = "temperature";
 constexpr char kConfigKeyMaxTokens[] = "max_tokens";
 constexpr char kConfigKeyAnthropicVersion[] = "anthropic_version";
+
+// System instructions for the tasks that send one ahead of the input
+constexpr char kSummarizationPrompt[] =
+    "Summarize the following text concisely while preserving the key information.";
+constexpr char kContentAnalysisPrompt[] =
+    "Analyze the following content. Identify key topics, entities, sentiment, and main points.";
+constexpr char kCodeGenerationPrompt[] =
+    "You are Claude, a helpful coding assistant. Generate clean, efficient, and well-documented code based on the user's requirements.";
+
+// System instruction for a translation into the "target_language" custom
+// param, English when it is absent
+std::string GetTranslationPrompt(
+    const core::AIServiceProvider::AIRequestParams& params) {
+  std::string target_language = "English";
+  auto it = params.custom_params.find("target_language");
+  if (it != params.custom_params.end()) {
+    target_language = it->second;
+  }
+  return "Translate the following text to " + target_language +
+         ". Maintain the original meaning, tone, and style as closely as "
+         "possible.";
+}
 }  // namespace
 
 ClaudeServiceProvider::ClaudeServiceProvider() {
@@ -62,6 +87,7 @@ core::AIServiceProvider::Capabilities ClaudeServiceProvider::GetCapabilities() c
   capabilities.supports_code_generation = true;
   capabilities.supports_question_answering = true;
   capabilities.supports_translation = true;
+  capabilities.supports_streaming = true;
   capabilities.supports_context = true;
   
   // Add supported languages
@@ -69,9 +95,18 @@ core::AIServiceProvider::Capabilities ClaudeServiceProvider::GetCapabilities() c
     "en", "es", "fr", "de", "it", "pt", "nl", "ru", "zh", "ja", "ko", "ar"
   };
   
+  const auto& request_config = claude_adapter_->GetRequestConfig();
+  capabilities.max_input_tokens = GetMaxInputTokens(
+      request_config.model_name,
+      static_cast<size_t>(std::max(request_config.max_tokens, 0)));
+
   return capabilities;
 }
 
+const core::TokenCounter& ClaudeServiceProvider::GetTokenCounter() const {
+  return ProviderTokenCounter::Get(ProviderTokenCounter::Family::kAnthropic);
+}
+
 bool ClaudeServiceProvider::SupportsTaskType(TaskType task_type) const {
   switch (task_type) {
     case TaskType::TEXT_GENERATION:
@@ -120,6 +155,54 @@ void ClaudeServiceProvider::ProcessRequest(
   }
 }
 
+void ClaudeServiceProvider::ProcessStreamingRequest(
+    const AIRequestParams& params,
+    AIStreamCallback callback) {
+  DLOG(INFO) << "Processing streaming request with Claude provider. Task type: "
+             << static_cast<int>(params.task_type);
+
+  std::string system_prompt;
+  switch (params.task_type) {
+    case TaskType::TEXT_GENERATION:
+    case TaskType::QUESTION_ANSWERING:
+      claude_adapter_->ProcessTextStream(
+          params.input_text,
+          core::GetPromptPrefixLength(params.custom_params,
+                                      params.input_text.size()),
+          std::move(callback));
+      return;
+    case TaskType::TEXT_SUMMARIZATION:
+      system_prompt = kSummarizationPrompt;
+      break;
+    case TaskType::CONTENT_ANALYSIS:
+      system_prompt = kContentAnalysisPrompt;
+      break;
+    case TaskType::CODE_GENERATION:
+      system_prompt = kCodeGenerationPrompt;
+      break;
+    case TaskType::TRANSLATION:
+      system_prompt = GetTranslationPrompt(params);
+      break;
+    default:
+      callback.Run(core::MakeFinalStreamDelta(
+          false, "Unsupported task type for Claude provider"));
+      return;
+  }
+
+  ClaudeMessage system_message;
+  system_message.role = ClaudeMessage::Role::SYSTEM;
+  system_message.content = system_prompt;
+
+  ClaudeMessage user_message;
+  user_message.role = ClaudeMessage::Role::USER;
+  user_message.content = params.input_text;
+  user_message.cacheable_prefix_length = core::GetPromptPrefixLength(
+      params.custom_params, params.input_text.size());
+
+  claude_adapter_->ProcessConversationStream(
+      {system_message, user_message}, std::move(callback));
+}
+
 void ClaudeServiceProvider::Configure(
     const std::unordered_map<std::string, std::string>& config) {
   // Update the configuration
@@ -185,6 +268,8 @@ void ClaudeServiceProvider::ProcessTextGeneration(
     ClaudeMessage user_message;
     user_message.role = ClaudeMessage::Role::USER;
     user_message.content = params.input_text;
+    user_message.cacheable_prefix_length = core::GetPromptPrefixLength(
+        params.custom_params, params.input_text.size());
     claude_messages.push_back(user_message);
     
     // Process the conversation
@@ -197,6 +282,8 @@ void ClaudeServiceProvider::ProcessTextGeneration(
     // No context, just process the text
     claude_adapter_->ProcessText(
         params.input_text,
+        core::GetPromptPrefixLength(params.custom_params,
+                                    params.input_text.size()),
         base::BindOnce(&ClaudeServiceProvider::OnClaudeResponse,
                       weak_ptr_factory_.GetWeakPtr(),
                       std::move(callback)));
@@ -211,11 +298,13 @@ void ClaudeServiceProvider::ProcessTextSummarization(
   
   ClaudeMessage system_message;
   system_message.role = ClaudeMessage::Role::SYSTEM;
-  system_message.content = "Summarize the following text concisely while preserving the key information.";
+  system_message.content = kSummarizationPrompt;
   
   ClaudeMessage user_message;
   user_message.role = ClaudeMessage::Role::USER;
   user_message.content = params.input_text;
+  user_message.cacheable_prefix_length = core::GetPromptPrefixLength(
+      params.custom_params, params.input_text.size());
   
   messages.push_back(system_message);
   messages.push_back(user_message);
@@ -236,11 +325,13 @@ void ClaudeServiceProvider::ProcessContentAnalysis(
   
   ClaudeMessage system_message;
   system_message.role = ClaudeMessage::Role::SYSTEM;
-  system_message.content = "Analyze the following content. Identify key topics, entities, sentiment, and main points.";
+  system_message.content = kContentAnalysisPrompt;
   
   ClaudeMessage user_message;
   user_message.role = ClaudeMessage::Role::USER;
   user_message.content = params.input_text;
+  user_message.cacheable_prefix_length = core::GetPromptPrefixLength(
+      params.custom_params, params.input_text.size());
   
   messages.push_back(system_message);
   messages.push_back(user_message);
@@ -270,6 +361,8 @@ void ClaudeServiceProvider::ProcessQuestionAnswering(
     ClaudeMessage user_message;
     user_message.role = ClaudeMessage::Role::USER;
     user_message.content = params.input_text;
+    user_message.cacheable_prefix_length = core::GetPromptPrefixLength(
+        params.custom_params, params.input_text.size());
     claude_messages.push_back(user_message);
     
     // Process the conversation
@@ -282,6 +375,8 @@ void ClaudeServiceProvider::ProcessQuestionAnswering(
     // No context, just process the text
     claude_adapter_->ProcessText(
         params.input_text,
+        core::GetPromptPrefixLength(params.custom_params,
+                                    params.input_text.size()),
         base::BindOnce(&ClaudeServiceProvider::OnClaudeResponse,
                       weak_ptr_factory_.GetWeakPtr(),
                       std::move(callback)));
@@ -296,11 +391,13 @@ void ClaudeServiceProvider::ProcessCodeGeneration(
   
   ClaudeMessage system_message;
   system_message.role = ClaudeMessage::Role::SYSTEM;
-  system_message.content = "You are Claude, a helpful coding assistant. Generate clean, efficient, and well-documented code based on the user's requirements.";
+  system_message.content = kCodeGenerationPrompt;
   
   ClaudeMessage user_message;
   user_message.role = ClaudeMessage::Role::USER;
   user_message.content = params.input_text;
+  user_message.cacheable_prefix_length = core::GetPromptPrefixLength(
+      params.custom_params, params.input_text.size());
   
   messages.push_back(system_message);
   messages.push_back(user_message);
@@ -319,19 +416,19 @@ void ClaudeServiceProvider::ProcessTranslation(
   // Add a system message to guide the model
   std::vector<ClaudeMessage> messages;
   
-  // Check if target language is specified
-  std::string target_language = "English";  // Default
-  if (params.custom_params.find("target_language") != params.custom_params.end()) {
-    target_language = params.custom_params.at("target_language");
-  }
+  // The message only views the prompt, so it is kept here until the
+  // request has been rendered
+  std::string system_prompt = GetTranslationPrompt(params);
   
   ClaudeMessage system_message;
   system_message.role = ClaudeMessage::Role::SYSTEM;
-  system_message.content = "Translate the following text to " + target_language + ". Maintain the original meaning, tone, and style as closely as possible.";
+  system_message.content = system_prompt;
   
   ClaudeMessage user_message;
   user_message.role = ClaudeMessage::Role::USER;
   user_message.content = params.input_text;
+  user_message.cacheable_prefix_length = core::GetPromptPrefixLength(
+      params.custom_params, params.input_text.size());
   
   messages.push_back(system_message);
   messages.push_back(user_message);
@@ -368,7 +465,7 @@ std::vector<ClaudeMessage> ClaudeServiceProvider::ConvertToClaudeMessages(
         break;
     }
     
-    claude_message.content = context_message.content;
+    claude_message.content = context_message.content();
     claude_messages.push_back(claude_message);
   }
   
@@ -4,8 +4,12 @@
 
 #include "asol/adapters/claude/claude_text_adapter.h"
 
+#include <string_view>
 #include <utility>
 
+#include "asol/adapters/completion_stream.h"
+#include "asol/adapters/json_field_reader.h"
+#include "asol/adapters/payload_template.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
@@ -23,23 +27,33 @@ namespace {
 constexpr char kClaudeApiEndpoint[] = "https://api.anthropic.com/v1/messages";
 constexpr char kAuthorizationHeader[] = "x-api-key: ";
 constexpr char kAnthropicVersionHeader[] = "anthropic-version: ";
+constexpr char kDefaultSystemPrompt[] =
+    "You are Claude, a helpful AI assistant created by Anthropic.";
 constexpr char kContentTypeHeader[] = "Content-Type: application/json";
+// Caches the prompt up to the marked block for five minutes
+constexpr char kCacheControlType[] = "ephemeral";
+
+// Simulated streamed responses are fed to the decoder this many bytes at a
+// time, about the size of one event
+constexpr size_t kSimulatedStreamChunkSize = 64;
 
 // Helper function to truncate text for logging
-std::string TruncateForLogging(const std::string& text, size_t max_length = 50) {
+std::string TruncateForLogging(std::string_view text, size_t max_length = 50) {
   if (text.length() <= max_length)
-    return text;
-  return text.substr(0, max_length) + "...";
+    return std::string(text);
+  return std::string(text.substr(0, max_length)) + "...";
 }
 
 }  // namespace
 
 ClaudeTextAdapter::ClaudeTextAdapter() : config_() {
+  UpdatePayloadTemplates();
   LOG(INFO) << "ClaudeTextAdapter initialized with default configuration.";
 }
 
 ClaudeTextAdapter::ClaudeTextAdapter(const std::string& api_key) 
     : api_key_(api_key), config_() {
+  UpdatePayloadTemplates();
   LOG(INFO) << "ClaudeTextAdapter initialized with provided API key.";
 }
 
@@ -48,13 +62,20 @@ ClaudeTextAdapter::~ClaudeTextAdapter() {
 }
 
 void ClaudeTextAdapter::ProcessText(
-    const std::string& text_input,
+    std::string_view text_input,
+    ClaudeResponseCallback callback) {
+  ProcessText(text_input, 0, std::move(callback));
+}
+
+void ClaudeTextAdapter::ProcessText(
+    std::string_view text_input,
+    size_t cacheable_prefix_length,
     ClaudeResponseCallback callback) {
   DLOG(INFO) << "Processing text with Claude Adapter: " 
              << TruncateForLogging(text_input);
   
   // Build the request payload for a single text prompt
-  nlohmann::json payload = BuildRequestPayload(text_input);
+  std::string payload = BuildRequestPayload(text_input, cacheable_prefix_length);
   
   // Send the request to the Claude API
   SendRequest(payload, std::move(callback));
@@ -66,14 +87,34 @@ void ClaudeTextAdapter::ProcessConversation(
   DLOG(INFO) << "Processing conversation with " << messages.size() << " messages";
   
   // Build the request payload for a conversation
-  nlohmann::json payload = BuildConversationPayload(messages);
+  std::string payload = BuildConversationPayload(messages);
   
   // Send the request to the Claude API
   SendRequest(payload, std::move(callback));
 }
 
+void ClaudeTextAdapter::ProcessTextStream(
+    std::string_view text_input,
+    size_t cacheable_prefix_length,
+    core::StreamDeltaCallback callback) {
+  DLOG(INFO) << "Streaming text with Claude Adapter: "
+             << TruncateForLogging(text_input);
+  SendStreamingRequest(BuildRequestPayload(text_input, cacheable_prefix_length),
+                       std::move(callback));
+}
+
+void ClaudeTextAdapter::ProcessConversationStream(
+    const std::vector<ClaudeMessage>& messages,
+    core::StreamDeltaCallback callback) {
+  DLOG(INFO) << "Streaming conversation with " << messages.size()
+             << " messages";
+  SendStreamingRequest(BuildConversationPayload(messages),
+                       std::move(callback));
+}
+
 void ClaudeTextAdapter::SetRequestConfig(const ClaudeRequestConfig& config) {
   config_ = config;
+  UpdatePayloadTemplates();
   DLOG(INFO) << "Updated Claude request configuration. Model: " 
              << config_.model_name;
 }
@@ -87,71 +128,136 @@ void ClaudeTextAdapter::SetApiKey(const std::string& api_key) {
   DLOG(INFO) << "Updated API key.";
 }
 
-nlohmann::json ClaudeTextAdapter::BuildRequestPayload(
-    const std::string& text_input) const {
+const core::PromptCacheStats& ClaudeTextAdapter::GetPromptCacheStats() const {
+  return prompt_cache_stats_;
+}
+
+void ClaudeTextAdapter::UpdatePayloadTemplates() {
   nlohmann::json payload;
   
   // Set the model
   payload["model"] = config_.model_name;
   
-  // Add the messages array with system and user messages
-  nlohmann::json messages = nlohmann::json::array();
+  // Add generation parameters
+  payload["temperature"] = config_.temperature;
+  payload["max_tokens"] = config_.max_tokens;
+  payload["top_p"] = config_.top_p;
+  payload["top_k"] = config_.top_k;
+  
+  // Conversations splice in a pre-rendered messages array and may
+  // override the system prompt
+  payload["messages"] = PayloadTemplate::RawSlot(0);
+  payload["system"] = PayloadTemplate::TextSlot(1);
+  conversation_template_ = PayloadTemplate(payload);
   
   // Claude API expects a different format than OpenAI/Gemini
   // For a single text prompt, we'll create a simple user message
   payload["messages"] = nlohmann::json::array({
     {
       {"role", "user"},
-      {"content", text_input}
+      {"content", PayloadTemplate::TextSlot(0)}
     }
   });
+  payload["system"] = kDefaultSystemPrompt;
+  text_template_ = PayloadTemplate(payload);
+
+  // The stable prefix and the rest as separate blocks, with a breakpoint
+  // ending the cached part after the first
+  payload["messages"] = nlohmann::json::array({
+    {
+      {"role", "user"},
+      {"content", nlohmann::json::array({
+        {{"type", "text"},
+         {"text", PayloadTemplate::TextSlot(0)},
+         {"cache_control", {{"type", kCacheControlType}}}},
+        {{"type", "text"}, {"text", PayloadTemplate::TextSlot(1)}}
+      })}
+    }
+  });
+  cached_text_template_ = PayloadTemplate(payload);
   
-  // Add system prompt if needed
-  payload["system"] = "You are Claude, a helpful AI assistant created by Anthropic.";
-  
-  // Add generation parameters
-  payload["temperature"] = config_.temperature;
-  payload["max_tokens"] = config_.max_tokens;
-  payload["top_p"] = config_.top_p;
-  payload["top_k"] = config_.top_k;
-  
-  return payload;
+  message_template_ = PayloadTemplate(nlohmann::json{
+    {"role", PayloadTemplate::TextSlot(0)},
+    {"content", PayloadTemplate::TextSlot(1)}
+  });
+  cached_message_template_ = PayloadTemplate(nlohmann::json{
+    {"role", PayloadTemplate::TextSlot(0)},
+    {"content", nlohmann::json::array({
+      {{"type", "text"},
+       {"text", PayloadTemplate::TextSlot(1)},
+       {"cache_control", {{"type", kCacheControlType}}}}
+    })}
+  });
+  split_message_template_ = PayloadTemplate(nlohmann::json{
+    {"role", PayloadTemplate::TextSlot(0)},
+    {"content", nlohmann::json::array({
+      {{"type", "text"},
+       {"text", PayloadTemplate::TextSlot(1)},
+       {"cache_control", {{"type", kCacheControlType}}}},
+      {{"type", "text"}, {"text", PayloadTemplate::TextSlot(2)}}
+    })}
+  });
+}
+
+std::string ClaudeTextAdapter::BuildRequestPayload(
+    std::string_view text_input,
+    size_t cacheable_prefix_length) const {
+  // Empty text blocks are rejected, so a prompt that is all prefix or all
+  // variable goes as one block
+  if (cacheable_prefix_length == 0 ||
+      cacheable_prefix_length >= text_input.size()) {
+    return text_template_.Render({text_input});
+  }
+  return cached_text_template_.Render(
+      {text_input.substr(0, cacheable_prefix_length),
+       text_input.substr(cacheable_prefix_length)});
 }
 
-nlohmann::json ClaudeTextAdapter::BuildConversationPayload(
+std::string ClaudeTextAdapter::BuildConversationPayload(
     const std::vector<ClaudeMessage>& messages) const {
-  nlohmann::json payload;
-  
-  // Set the model
-  payload["model"] = config_.model_name;
-  
   // Extract system message if present
-  std::string system_content = "You are Claude, a helpful AI assistant created by Anthropic.";
-  nlohmann::json messages_array = nlohmann::json::array();
+  std::string_view system_content = kDefaultSystemPrompt;
+  std::string messages_array = "[";
+
+  // The breakpoint goes on the last message before the newest one, so the
+  // next turn finds everything up to it cached
+  size_t breakpoint = messages.size();
+  size_t turns = 0;
+  for (size_t i = messages.size(); i-- > 0;) {
+    if (messages[i].role != ClaudeMessage::Role::SYSTEM && ++turns == 2) {
+      breakpoint = i;
+      break;
+    }
+  }
   
-  for (const auto& message : messages) {
+  for (size_t i = 0; i < messages.size(); ++i) {
+    const ClaudeMessage& message = messages[i];
     if (message.role == ClaudeMessage::Role::SYSTEM) {
       system_content = message.content;
       // Don't add system message to the messages array for Claude
       continue;
     }
     
-    nlohmann::json msg_obj;
-    msg_obj["role"] = RoleToString(message.role);
-    msg_obj["content"] = message.content;
-    messages_array.push_back(msg_obj);
+    if (messages_array.size() > 1) {
+      messages_array += ',';
+    }
+    std::string role = RoleToString(message.role);
+    if (i == breakpoint) {
+      cached_message_template_.RenderTo({role, message.content},
+                                        &messages_array);
+    } else if (message.cacheable_prefix_length > 0 &&
+               message.cacheable_prefix_length < message.content.size()) {
+      split_message_template_.RenderTo(
+          {role, message.content.substr(0, message.cacheable_prefix_length),
+           message.content.substr(message.cacheable_prefix_length)},
+          &messages_array);
+    } else {
+      message_template_.RenderTo({role, message.content}, &messages_array);
+    }
   }
+  messages_array += ']';
   
-  payload["messages"] = messages_array;
-  payload["system"] = system_content;
-  
-  // Add generation parameters
-  payload["temperature"] = config_.temperature;
-  payload["max_tokens"] = config_.max_tokens;
-  payload["top_p"] = config_.top_p;
-  payload["top_k"] = config_.top_k;
-  
-  return payload;
+  return conversation_template_.Render({messages_array, system_content});
 }
 
 std::string ClaudeTextAdapter::RoleToString(ClaudeMessage::Role role) const {
@@ -170,13 +276,12 @@ std::string ClaudeTextAdapter::RoleToString(ClaudeMessage::Role role) const {
 }
 
 void ClaudeTextAdapter::SendRequest(
-    const nlohmann::json& payload,
+    const std::string& payload,
     ClaudeResponseCallback callback) {
   // In a real implementation, this would use network services to send an HTTP request
   // For now, we'll simulate a response
   
-  std::string json_str = payload.dump(2);
-  DLOG(INFO) << "Claude API Request payload: " << TruncateForLogging(json_str, 100);
+  DLOG(INFO) << "Claude API Request payload: " << TruncateForLogging(payload, 100);
   
   // Construct the headers (would be used in actual implementation)
   std::vector<std::string> headers;
@@ -224,32 +329,99 @@ void ClaudeTextAdapter::HandleResponse(
   bool success = true;
   std::string result_text;
   
-  try {
-    // Parse the JSON response
-    nlohmann::json response = nlohmann::json::parse(response_data);
-    
-    // Extract the response text - Claude's format is different from OpenAI/Gemini
-    if (response.contains("content") && 
-        response["content"].is_array() && 
-        !response["content"].empty() && 
-        response["content"][0].contains("text")) {
-      
-      result_text = response["content"][0]["text"];
-    } else {
-      success = false;
-      result_text = "Failed to parse response: unexpected format";
-      LOG(ERROR) << result_text;
-    }
-  } catch (const std::exception& e) {
+  // Read only the fields we need instead of building a DOM
+  JsonFieldReader reader(response_data);
+  if (!reader.GetString({"content", 0, "text"}, &result_text)) {
     success = false;
-    result_text = "Failed to parse response: " + std::string(e.what());
+    result_text = "Failed to parse response: unexpected format";
     LOG(ERROR) << result_text;
   }
+
+  // input_tokens counts only the uncached part of the prompt
+  int64_t input_tokens = 0;
+  if (success && reader.GetInt({"usage", "input_tokens"}, &input_tokens)) {
+    int64_t cache_read_tokens = 0;
+    int64_t cache_write_tokens = 0;
+    reader.GetInt({"usage", "cache_read_input_tokens"}, &cache_read_tokens);
+    reader.GetInt({"usage", "cache_creation_input_tokens"},
+                  &cache_write_tokens);
+    prompt_cache_stats_.Record(
+        input_tokens + cache_read_tokens + cache_write_tokens,
+        cache_read_tokens);
+  }
   
   // Invoke the callback with the result
   std::move(callback).Run(success, result_text);
 }
 
+void ClaudeTextAdapter::SendStreamingRequest(
+    std::string payload,
+    core::StreamDeltaCallback callback) {
+  CompletionStream::EnableStreaming(
+      CompletionStream::Dialect::kAnthropicMessages, &payload);
+  DLOG(INFO) << "Claude API streaming request payload: "
+             << TruncateForLogging(payload, 100);
+  DLOG(INFO) << "Would send request to: " << kClaudeApiEndpoint;
+
+  auto stream = std::make_unique<CompletionStream>(
+      CompletionStream::Dialect::kAnthropicMessages,
+      base::BindRepeating(&ClaudeTextAdapter::OnStreamDelta,
+                          weak_ptr_factory_.GetWeakPtr(),
+                          std::move(callback)));
+
+  // Simulate the event stream the API sends for a request with "stream" set
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(
+          &ClaudeTextAdapter::HandleStreamResponse,
+          weak_ptr_factory_.GetWeakPtr(), std::move(stream),
+          "event: message_start\n"
+          "data: {\"type\":\"message_start\",\"message\":{\"id\":"
+          "\"msg_01234567890\",\"type\":\"message\",\"role\":\"assistant\","
+          "\"content\":[],\"model\":\"claude-3-opus-20240229\","
+          "\"stop_reason\":null,\"stop_sequence\":null,\"usage\":"
+          "{\"input_tokens\":10,\"output_tokens\":1}}}\n\n"
+          "event: content_block_start\n"
+          "data: {\"type\":\"content_block_start\",\"index\":0,"
+          "\"content_block\":{\"type\":\"text\",\"text\":\"\"}}\n\n"
+          "event: content_block_delta\n"
+          "data: {\"type\":\"content_block_delta\",\"index\":0,\"delta\":"
+          "{\"type\":\"text_delta\",\"text\":\"This is a simulated\"}}\n\n"
+          "event: content_block_delta\n"
+          "data: {\"type\":\"content_block_delta\",\"index\":0,\"delta\":"
+          "{\"type\":\"text_delta\",\"text\":\" response from the Claude "
+          "API.\"}}\n\n"
+          "event: content_block_stop\n"
+          "data: {\"type\":\"content_block_stop\",\"index\":0}\n\n"
+          "event: message_delta\n"
+          "data: {\"type\":\"message_delta\",\"delta\":{\"stop_reason\":"
+          "\"end_turn\",\"stop_sequence\":null},\"usage\":"
+          "{\"output_tokens\":12}}\n\n"
+          "event: message_stop\n"
+          "data: {\"type\":\"message_stop\"}\n\n"),
+      base::Milliseconds(100));  // Simulate network delay
+}
+
+void ClaudeTextAdapter::HandleStreamResponse(
+    std::unique_ptr<CompletionStream> stream,
+    const std::string& response_body) {
+  std::string_view body(response_body);
+  for (size_t offset = 0; offset < body.size() && !stream->finished();
+       offset += kSimulatedStreamChunkSize) {
+    stream->Append(body.substr(offset, kSimulatedStreamChunkSize));
+  }
+  stream->Finish();
+}
+
+void ClaudeTextAdapter::OnStreamDelta(const core::StreamDeltaCallback& callback,
+                                      const core::StreamDelta& delta) {
+  if (delta.is_final && delta.success && delta.usage) {
+    prompt_cache_stats_.Record(delta.usage->prompt_tokens,
+                               delta.usage->cached_prompt_tokens);
+  }
+  callback.Run(delta);
+}
+
 }  // namespace claude
 }  // namespace adapters
-}  // namespace asol
\ No newline at end of file
+}  // namespace asol
@@ -8,14 +8,21 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "asol/adapters/payload_template.h"
+#include "asol/core/prompt_cache.h"
+#include "asol/core/stream_delta.h"
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "third_party/nlohmann_json/json.hpp"
 
 namespace asol {
 namespace adapters {
+
+class CompletionStream;
+
 namespace claude {
 
 // Represents a message in a conversation with Claude
@@ -27,7 +34,13 @@ struct ClaudeMessage {
   };
 
   Role role;
-  std::string content;
+  // Must outlive the call the message is passed to, which builds the
+  // request before returning; conversations can then point into shared
+  // context history instead of copying it
+  std::string_view content;
+  // Bytes at the start of |content| that repeat across requests, cached
+  // behind a breakpoint of their own; 0 for none
+  size_t cacheable_prefix_length = 0;
 };
 
 // Represents configuration options for Claude API requests
@@ -55,11 +68,28 @@ class ClaudeTextAdapter {
   ClaudeTextAdapter& operator=(const ClaudeTextAdapter&) = delete;
 
   // Process a single text prompt and get a response
-  void ProcessText(const std::string& text_input, ClaudeResponseCallback callback);
+  void ProcessText(std::string_view text_input, ClaudeResponseCallback callback);
+
+  // Same, with a cache breakpoint after the first |cacheable_prefix_length|
+  // bytes of |text_input|, so requests sharing that prefix read it from
+  // the prompt cache
+  void ProcessText(std::string_view text_input,
+                   size_t cacheable_prefix_length,
+                   ClaudeResponseCallback callback);
   
-  // Process a conversation with multiple messages
+  // Process a conversation with multiple messages. The history before the
+  // last message gets a cache breakpoint, so each turn reads the previous
+  // turns from the prompt cache.
   void ProcessConversation(const std::vector<ClaudeMessage>& messages,
                           ClaudeResponseCallback callback);
+
+  // Same as ProcessText() and ProcessConversation(), reporting the text as
+  // it is generated. The final delta carries the stop reason and usage.
+  void ProcessTextStream(std::string_view text_input,
+                         size_t cacheable_prefix_length,
+                         core::StreamDeltaCallback callback);
+  void ProcessConversationStream(const std::vector<ClaudeMessage>& messages,
+                                 core::StreamDeltaCallback callback);
   
   // Configure the adapter with specific settings
   void SetRequestConfig(const ClaudeRequestConfig& config);
@@ -70,26 +100,56 @@ class ClaudeTextAdapter {
   // Set API key (for runtime configuration)
   void SetApiKey(const std::string& api_key);
 
+  // Input tokens read from the prompt cache so far
+  const core::PromptCacheStats& GetPromptCacheStats() const;
+
  private:
+  // Rebuild the request templates from |config_|
+  void UpdatePayloadTemplates();
+
   // Helper methods for API interaction
-  nlohmann::json BuildRequestPayload(const std::string& text_input) const;
-  nlohmann::json BuildConversationPayload(
+  std::string BuildRequestPayload(std::string_view text_input,
+                                  size_t cacheable_prefix_length) const;
+  std::string BuildConversationPayload(
       const std::vector<ClaudeMessage>& messages) const;
   
   // Convert message role enum to string for API
   std::string RoleToString(ClaudeMessage::Role role) const;
   
   // Send request to Claude API
-  void SendRequest(const nlohmann::json& payload, ClaudeResponseCallback callback);
+  void SendRequest(const std::string& payload, ClaudeResponseCallback callback);
   
   // Parse API response
   void HandleResponse(const std::string& response_data, 
                      ClaudeResponseCallback callback);
 
+  // Send |payload| as a streaming request
+  void SendStreamingRequest(std::string payload,
+                            core::StreamDeltaCallback callback);
+
+  // Feed a streamed response body to |stream|
+  void HandleStreamResponse(std::unique_ptr<CompletionStream> stream,
+                            const std::string& response_body);
+
+  // Record the usage the final delta reports, then forward |delta|
+  void OnStreamDelta(const core::StreamDeltaCallback& callback,
+                     const core::StreamDelta& delta);
+
   // Private members
   std::string api_key_;
   ClaudeRequestConfig config_;
   
+  // Request bodies pre-serialized for |config_|
+  PayloadTemplate text_template_;
+  PayloadTemplate conversation_template_;
+  PayloadTemplate message_template_;
+  // Variants with a cache breakpoint
+  PayloadTemplate cached_text_template_;
+  PayloadTemplate cached_message_template_;
+  PayloadTemplate split_message_template_;
+
+  core::PromptCacheStats prompt_cache_stats_;
+  
   // For async operations and callbacks
   base::WeakPtrFactory<ClaudeTextAdapter> weak_ptr_factory_{this};
 };
@@ -162,7 +162,8 @@ TEST_F(ClaudeTextAdapterTest, ProcessConversation) {
 
 // Test request payload building for single text
 TEST_F(ClaudeTextAdapterTest, BuildRequestPayload) {
-  nlohmann::json payload = adapter_->BuildRequestPayload("Test prompt");
+  nlohmann::json payload =
+      nlohmann::json::parse(adapter_->BuildRequestPayload("Test prompt", 0));
   
   EXPECT_TRUE(payload.contains("model"));
   EXPECT_TRUE(payload.contains("messages"));
@@ -202,7 +203,8 @@ TEST_F(ClaudeTextAdapterTest, BuildConversationPayload) {
   messages.push_back(user_message);
   messages.push_back(assistant_message);
   
-  nlohmann::json payload = adapter_->BuildConversationPayload(messages);
+  nlohmann::json payload =
+      nlohmann::json::parse(adapter_->BuildConversationPayload(messages));
   
   EXPECT_TRUE(payload.contains("model"));
   EXPECT_TRUE(payload.contains("messages"));
@@ -215,11 +217,13 @@ TEST_F(ClaudeTextAdapterTest, BuildConversationPayload) {
   EXPECT_TRUE(payload_messages.is_array());
   EXPECT_EQ(payload_messages.size(), 2);  // User and assistant (system is separate)
   
+  // The history before the newest message ends in a cache breakpoint
   auto user = payload_messages[0];
   EXPECT_TRUE(user.contains("role"));
   EXPECT_EQ(user["role"], "user");
-  EXPECT_TRUE(user.contains("content"));
-  EXPECT_EQ(user["content"], "Hello!");
+  ASSERT_TRUE(user["content"].is_array());
+  EXPECT_EQ(user["content"][0]["text"], "Hello!");
+  EXPECT_EQ(user["content"][0]["cache_control"]["type"], "ephemeral");
   
   auto assistant = payload_messages[1];
   EXPECT_TRUE(assistant.contains("role"));
@@ -228,6 +232,58 @@ TEST_F(ClaudeTextAdapterTest, BuildConversationPayload) {
   EXPECT_EQ(assistant["content"], "Hi there! How can I help you today?");
 }
 
+// Test that a stable prefix is sent as its own cached block
+TEST_F(ClaudeTextAdapterTest, BuildRequestPayloadWithCacheablePrefix) {
+  nlohmann::json payload = nlohmann::json::parse(
+      adapter_->BuildRequestPayload("Instructions. Page text", 14));
+
+  auto content = payload["messages"][0]["content"];
+  ASSERT_TRUE(content.is_array());
+  ASSERT_EQ(content.size(), 2u);
+  EXPECT_EQ(content[0]["text"], "Instructions. ");
+  EXPECT_EQ(content[0]["cache_control"]["type"], "ephemeral");
+  EXPECT_EQ(content[1]["text"], "Page text");
+  EXPECT_FALSE(content[1].contains("cache_control"));
+
+  // A prefix covering the whole prompt leaves no block to split off
+  payload = nlohmann::json::parse(
+      adapter_->BuildRequestPayload("Instructions.", 13));
+  EXPECT_EQ(payload["messages"][0]["content"], "Instructions.");
+}
+
+// Test that response usage feeds the prompt cache stats
+TEST_F(ClaudeTextAdapterTest, RecordsPromptCacheUsage) {
+  bool success = false;
+  std::string response;
+  RunProcessTextAndWait("Test prompt", &success, &response);
+
+  const core::PromptCacheStats& stats = adapter_->GetPromptCacheStats();
+  EXPECT_EQ(stats.responses, 1u);
+  EXPECT_EQ(stats.input_tokens, 10);
+  EXPECT_EQ(stats.cached_input_tokens, 0);
+}
+
+// Messages only view their content, so the payload must copy it: the
+// service providers keep prompts alive only until the request is rendered
+TEST_F(ClaudeTextAdapterTest, ConversationPayloadCopiesMessageContent) {
+  std::string system_prompt = "Translate the following text to French.";
+  std::vector<ClaudeMessage> messages;
+  ClaudeMessage system_message;
+  system_message.role = ClaudeMessage::Role::SYSTEM;
+  system_message.content = system_prompt;
+  messages.push_back(system_message);
+  ClaudeMessage user_message;
+  user_message.role = ClaudeMessage::Role::USER;
+  user_message.content = "Hello!";
+  messages.push_back(user_message);
+
+  std::string rendered = adapter_->BuildConversationPayload(messages);
+  system_prompt.assign(system_prompt.size(), 'x');
+
+  nlohmann::json payload = nlohmann::json::parse(rendered);
+  EXPECT_EQ(payload["system"], "Translate the following text to French.");
+}
+
 // Test role to string conversion
 TEST_F(ClaudeTextAdapterTest, RoleToString) {
   EXPECT_EQ(adapter_->RoleToString(ClaudeMessage::Role::USER), "user");
@@ -0,0 +1,236 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/completion_stream.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "asol/adapters/json_field_reader.h"
+#include "asol/core/cancellation_token.h"
+#include "base/check.h"
+#include "base/functional/bind.h"
+
+namespace asol {
+namespace adapters {
+
+namespace {
+
+// Error of a stream whose body ended before it said how the completion
+// finished, e.g. because the connection dropped
+constexpr char kTruncatedStreamError[] =
+    "Stream ended before the completion finished";
+
+// The string field |key| of |json|, or empty
+std::string_view FindString(std::string_view json,
+                            std::string_view key,
+                            std::string* scratch) {
+  std::string_view value;
+  if (!StreamEventParser::FindStringField(json, key, scratch, &value)) {
+    return std::string_view();
+  }
+  return value;
+}
+
+}  // namespace
+
+CompletionStream::CompletionStream(Dialect dialect,
+                                   core::StreamDeltaCallback callback)
+    : dialect_(dialect),
+      callback_(std::move(callback)),
+      parser_(StreamEventParser::Format::SERVER_SENT_EVENTS,
+              dialect == Dialect::kOpenAIChat ? "content" : "text",
+              base::BindRepeating(&CompletionStream::OnEvent,
+                                  base::Unretained(this))) {}
+
+CompletionStream::~CompletionStream() = default;
+
+// static
+void CompletionStream::EnableStreaming(Dialect dialect, std::string* payload) {
+  DCHECK(!payload->empty() && payload->front() == '{');
+  // Bodies come from PayloadTemplates, so the fields go in front of the
+  // rendered ones rather than through a second set of templates
+  switch (dialect) {
+    case Dialect::kOpenAIChat:
+      payload->insert(1, "\"stream\":true,"
+                         "\"stream_options\":{\"include_usage\":true},");
+      break;
+    case Dialect::kAnthropicMessages:
+      payload->insert(1, "\"stream\":true,");
+      break;
+  }
+}
+
+void CompletionStream::Append(std::string_view chunk) {
+  if (!finished_) {
+    parser_.Append(chunk);
+  }
+}
+
+void CompletionStream::Finish() {
+  if (finished_) {
+    return;
+  }
+  parser_.Finish();
+  if (finished_) {
+    return;
+  }
+  if (!stream_error_.empty()) {
+    SendFinal(false, stream_error_);
+  } else if (finish_reason_ != core::StreamFinishReason::kNone ||
+             parser_.done()) {
+    SendFinal(true, std::string());
+  } else {
+    SendFinal(false, kTruncatedStreamError);
+  }
+}
+
+void CompletionStream::Fail(const std::string& error_message) {
+  if (!finished_) {
+    SendFinal(false, error_message);
+  }
+}
+
+void CompletionStream::OnEvent(const StreamEventParser::Event& event) {
+  if (finished_) {
+    return;
+  }
+  switch (dialect_) {
+    case Dialect::kOpenAIChat:
+      OnOpenAIChatEvent(event);
+      break;
+    case Dialect::kAnthropicMessages:
+      OnAnthropicMessagesEvent(event);
+      break;
+  }
+}
+
+void CompletionStream::OnOpenAIChatEvent(
+    const StreamEventParser::Event& event) {
+  JsonFieldReader reader(event.data);
+  std::string error;
+  if (reader.GetString({"error", "message"}, &error)) {
+    stream_error_ = error.empty() ? "Stream error" : error;
+    SendFinal(false, stream_error_);
+    return;
+  }
+
+  if (!event.delta.empty()) {
+    SendText(event.delta);
+  }
+
+  // Null until the last chunk of the choice
+  std::string scratch;
+  std::string_view finish_reason =
+      FindString(event.data, "finish_reason", &scratch);
+  if (!finish_reason.empty()) {
+    finish_reason_ = core::ParseStreamFinishReason(finish_reason);
+    if (finish_reason_ == core::StreamFinishReason::kNone) {
+      finish_reason_ = core::StreamFinishReason::kStop;
+    }
+  }
+
+  // Null on every chunk but the trailing usage chunk
+  int64_t prompt_tokens = 0;
+  if (reader.GetInt({"usage", "prompt_tokens"}, &prompt_tokens)) {
+    core::StreamTokenUsage usage;
+    usage.prompt_tokens = prompt_tokens;
+    reader.GetInt({"usage", "prompt_tokens_details", "cached_tokens"},
+                  &usage.cached_prompt_tokens);
+    reader.GetInt({"usage", "completion_tokens"}, &usage.completion_tokens);
+    usage_ = usage;
+  }
+}
+
+void CompletionStream::OnAnthropicMessagesEvent(
+    const StreamEventParser::Event& event) {
+  // The event type is repeated in the payload, which is all some proxies
+  // pass on
+  std::string scratch;
+  std::string_view type =
+      event.type.empty() ? FindString(event.data, "type", &scratch)
+                         : event.type;
+  JsonFieldReader reader(event.data);
+
+  if (type == "content_block_delta") {
+    // Tool input arrives as "partial_json" and carries no text
+    if (!event.delta.empty()) {
+      SendText(event.delta);
+    }
+  } else if (type == "message_start") {
+    // input_tokens counts only the uncached part of the prompt
+    int64_t input_tokens = 0;
+    if (reader.GetInt({"message", "usage", "input_tokens"}, &input_tokens)) {
+      int64_t cache_read_tokens = 0;
+      int64_t cache_write_tokens = 0;
+      reader.GetInt({"message", "usage", "cache_read_input_tokens"},
+                    &cache_read_tokens);
+      reader.GetInt({"message", "usage", "cache_creation_input_tokens"},
+                    &cache_write_tokens);
+      core::StreamTokenUsage usage;
+      usage.prompt_tokens =
+          input_tokens + cache_read_tokens + cache_write_tokens;
+      usage.cached_prompt_tokens = cache_read_tokens;
+      reader.GetInt({"message", "usage", "output_tokens"},
+                    &usage.completion_tokens);
+      usage_ = usage;
+    }
+  } else if (type == "message_delta") {
+    std::string_view stop_reason =
+        FindString(event.data, "stop_reason", &scratch);
+    if (!stop_reason.empty()) {
+      finish_reason_ = core::ParseStreamFinishReason(stop_reason);
+      if (finish_reason_ == core::StreamFinishReason::kNone) {
+        finish_reason_ = core::StreamFinishReason::kStop;
+      }
+    }
+    // Cumulative, so it replaces the count from message_start
+    int64_t output_tokens = 0;
+    if (reader.GetInt({"usage", "output_tokens"}, &output_tokens)) {
+      if (!usage_) {
+        usage_.emplace();
+      }
+      usage_->completion_tokens = output_tokens;
+    }
+  } else if (type == "message_stop") {
+    SendFinal(true, std::string());
+  } else if (type == "error") {
+    std::string error;
+    reader.GetString({"error", "message"}, &error);
+    stream_error_ = error.empty() ? "Stream error" : error;
+    SendFinal(false, stream_error_);
+  }
+  // "ping", "content_block_start" and "content_block_stop" carry nothing
+  // the delta protocol reports
+}
+
+void CompletionStream::SendText(std::string_view text) {
+  core::StreamDelta delta;
+  delta.text = std::string(text);
+  callback_.Run(delta);
+}
+
+void CompletionStream::SendFinal(bool success,
+                                 const std::string& error_message) {
+  finished_ = true;
+
+  core::StreamDelta delta;
+  delta.is_final = true;
+  delta.success = success;
+  if (success) {
+    delta.finish_reason = finish_reason_ == core::StreamFinishReason::kNone
+                              ? core::StreamFinishReason::kStop
+                              : finish_reason_;
+  } else {
+    delta.error_message = error_message;
+    delta.finish_reason = core::IsCancellationError(error_message)
+                              ? core::StreamFinishReason::kCancelled
+                              : core::StreamFinishReason::kError;
+  }
+  delta.usage = usage_;
+  callback_.Run(delta);
+}
+
+}  // namespace adapters
+}  // namespace asol
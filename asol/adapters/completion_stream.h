@@ -0,0 +1,90 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_ADAPTERS_COMPLETION_STREAM_H_
+#define ASOL_ADAPTERS_COMPLETION_STREAM_H_
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "asol/adapters/stream_event_parser.h"
+#include "asol/core/stream_delta.h"
+
+namespace asol {
+namespace adapters {
+
+// CompletionStream turns the body of one streamed completion into
+// core::StreamDelta as it arrives, so every provider reports text, usage
+// and finish reason the same way. Text deltas are forwarded as soon as
+// their event is complete; usage and the finish reason are collected from
+// whichever events carry them and sent with the final delta.
+//
+// |callback| must not destroy the stream.
+class CompletionStream {
+ public:
+  enum class Dialect {
+    // Chat Completions server-sent events, as sent by OpenAI and the APIs
+    // compatible with it: "choices[0].delta.content" per chunk,
+    // "finish_reason" on the last, "usage" on a trailing chunk when
+    // "stream_options.include_usage" is set, then "[DONE]"
+    kOpenAIChat,
+    // Anthropic Messages server-sent events: usage in "message_start",
+    // text in "content_block_delta", stop reason and output usage in
+    // "message_delta", then "message_stop"
+    kAnthropicMessages,
+  };
+
+  CompletionStream(Dialect dialect, core::StreamDeltaCallback callback);
+  ~CompletionStream();
+
+  CompletionStream(const CompletionStream&) = delete;
+  CompletionStream& operator=(const CompletionStream&) = delete;
+
+  // Turn |payload|, a rendered request body, into its streaming form for
+  // |dialect|, asking for usage to be reported where that is optional
+  static void EnableStreaming(Dialect dialect, std::string* payload);
+
+  // Feed the next slice of the response body
+  void Append(std::string_view chunk);
+
+  // The body ended. Sends the final delta unless one was sent already; a
+  // stream that ended before it said why counts as failed.
+  void Finish();
+
+  // The transfer failed or was cancelled. Sends the final delta with
+  // |error_message| unless one was sent already.
+  void Fail(const std::string& error_message);
+
+  // Whether the final delta has been sent; later input is ignored
+  bool finished() const { return finished_; }
+
+  // Usage reported so far, if any
+  const std::optional<core::StreamTokenUsage>& usage() const {
+    return usage_;
+  }
+
+ private:
+  void OnEvent(const StreamEventParser::Event& event);
+  void OnOpenAIChatEvent(const StreamEventParser::Event& event);
+  void OnAnthropicMessagesEvent(const StreamEventParser::Event& event);
+
+  void SendText(std::string_view text);
+  void SendFinal(bool success, const std::string& error_message);
+
+  const Dialect dialect_;
+  core::StreamDeltaCallback callback_;
+  StreamEventParser parser_;
+
+  core::StreamFinishReason finish_reason_ = core::StreamFinishReason::kNone;
+  std::optional<core::StreamTokenUsage> usage_;
+  // Error reported in the stream itself, e.g. an "error" event
+  std::string stream_error_;
+  bool finished_ = false;
+};
+
+}  // namespace adapters
+}  // namespace asol
+
+#endif  // ASOL_ADAPTERS_COMPLETION_STREAM_H_
@@ -0,0 +1,176 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/completion_stream.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "asol/core/cancellation_token.h"
+#include "base/functional/bind.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace adapters {
+namespace {
+
+class CompletionStreamTest : public testing::Test {
+ protected:
+  std::unique_ptr<CompletionStream> CreateStream(
+      CompletionStream::Dialect dialect) {
+    return std::make_unique<CompletionStream>(
+        dialect, base::BindRepeating(&CompletionStreamTest::OnDelta,
+                                     base::Unretained(this)));
+  }
+
+  void OnDelta(const core::StreamDelta& delta) { deltas_.push_back(delta); }
+
+  std::string StreamedText() const {
+    std::string text;
+    for (const auto& delta : deltas_) {
+      text += delta.text;
+    }
+    return text;
+  }
+
+  std::vector<core::StreamDelta> deltas_;
+};
+
+TEST_F(CompletionStreamTest, DecodesOpenAIChatStream) {
+  auto stream = CreateStream(CompletionStream::Dialect::kOpenAIChat);
+  std::string body =
+      "data: {\"choices\":[{\"delta\":{\"role\":\"assistant\","
+      "\"content\":\"\"},\"finish_reason\":null}],\"usage\":null}\n\n"
+      "data: {\"choices\":[{\"delta\":{\"content\":\"Hel\"},"
+      "\"finish_reason\":null}],\"usage\":null}\n\n"
+      "data: {\"choices\":[{\"delta\":{\"content\":\"lo\"},"
+      "\"finish_reason\":null}],\"usage\":null}\n\n"
+      "data: {\"choices\":[{\"delta\":{},\"finish_reason\":\"length\"}],"
+      "\"usage\":null}\n\n"
+      "data: {\"choices\":[],\"usage\":{\"prompt_tokens\":1200,"
+      "\"completion_tokens\":2,\"prompt_tokens_details\":"
+      "{\"cached_tokens\":1024}}}\n\n"
+      "data: [DONE]\n\n";
+
+  // Feed a few bytes at a time, as the network would
+  for (size_t i = 0; i < body.size(); i += 7) {
+    stream->Append(std::string_view(body).substr(i, 7));
+  }
+  EXPECT_FALSE(stream->finished());
+  stream->Finish();
+
+  ASSERT_EQ(deltas_.size(), 3u);
+  EXPECT_EQ(deltas_[0].text, "Hel");
+  EXPECT_FALSE(deltas_[0].is_final);
+  EXPECT_EQ(StreamedText(), "Hello");
+
+  const core::StreamDelta& last = deltas_.back();
+  EXPECT_TRUE(last.is_final);
+  EXPECT_TRUE(last.success);
+  EXPECT_EQ(last.finish_reason, core::StreamFinishReason::kLength);
+  ASSERT_TRUE(last.usage.has_value());
+  EXPECT_EQ(last.usage->prompt_tokens, 1200);
+  EXPECT_EQ(last.usage->cached_prompt_tokens, 1024);
+  EXPECT_EQ(last.usage->completion_tokens, 2);
+}
+
+TEST_F(CompletionStreamTest, DecodesAnthropicMessagesStream) {
+  auto stream = CreateStream(CompletionStream::Dialect::kAnthropicMessages);
+  stream->Append(
+      "event: message_start\n"
+      "data: {\"type\":\"message_start\",\"message\":{\"content\":[],"
+      "\"usage\":{\"input_tokens\":10,\"cache_read_input_tokens\":2000,"
+      "\"cache_creation_input_tokens\":0,\"output_tokens\":1}}}\n\n"
+      "event: content_block_start\n"
+      "data: {\"type\":\"content_block_start\",\"index\":0,"
+      "\"content_block\":{\"type\":\"text\",\"text\":\"\"}}\n\n"
+      "event: ping\n"
+      "data: {\"type\":\"ping\"}\n\n"
+      "event: content_block_delta\n"
+      "data: {\"type\":\"content_block_delta\",\"index\":0,"
+      "\"delta\":{\"type\":\"text_delta\",\"text\":\"Hi \\\"there\\\"\"}}\n\n"
+      "event: message_delta\n"
+      "data: {\"type\":\"message_delta\",\"delta\":{\"stop_reason\":"
+      "\"end_turn\",\"stop_sequence\":null},\"usage\":{\"output_tokens\":"
+      "4}}\n\n");
+  EXPECT_FALSE(stream->finished());
+
+  stream->Append(
+      "event: message_stop\n"
+      "data: {\"type\":\"message_stop\"}\n\n");
+  EXPECT_TRUE(stream->finished());
+
+  ASSERT_EQ(deltas_.size(), 2u);
+  EXPECT_EQ(deltas_[0].text, "Hi \"there\"");
+  const core::StreamDelta& last = deltas_.back();
+  EXPECT_TRUE(last.is_final);
+  EXPECT_TRUE(last.success);
+  EXPECT_EQ(last.finish_reason, core::StreamFinishReason::kStop);
+  ASSERT_TRUE(last.usage.has_value());
+  EXPECT_EQ(last.usage->prompt_tokens, 2010);
+  EXPECT_EQ(last.usage->cached_prompt_tokens, 2000);
+  EXPECT_EQ(last.usage->completion_tokens, 4);
+
+  // Nothing is sent twice
+  stream->Finish();
+  EXPECT_EQ(deltas_.size(), 2u);
+}
+
+TEST_F(CompletionStreamTest, ReportsErrorEvents) {
+  auto stream = CreateStream(CompletionStream::Dialect::kAnthropicMessages);
+  stream->Append(
+      "event: error\n"
+      "data: {\"type\":\"error\",\"error\":{\"type\":\"overloaded_error\","
+      "\"message\":\"Overloaded\"}}\n\n");
+
+  ASSERT_EQ(deltas_.size(), 1u);
+  EXPECT_TRUE(deltas_[0].is_final);
+  EXPECT_FALSE(deltas_[0].success);
+  EXPECT_EQ(deltas_[0].error_message, "Overloaded");
+  EXPECT_EQ(deltas_[0].finish_reason, core::StreamFinishReason::kError);
+}
+
+TEST_F(CompletionStreamTest, TruncatedStreamFails) {
+  auto stream = CreateStream(CompletionStream::Dialect::kOpenAIChat);
+  stream->Append(
+      "data: {\"choices\":[{\"delta\":{\"content\":\"par\"},"
+      "\"finish_reason\":null}]}\n\n");
+  stream->Finish();
+
+  ASSERT_EQ(deltas_.size(), 2u);
+  EXPECT_EQ(deltas_[0].text, "par");
+  EXPECT_TRUE(deltas_[1].is_final);
+  EXPECT_FALSE(deltas_[1].success);
+  EXPECT_FALSE(deltas_[1].error_message.empty());
+}
+
+TEST_F(CompletionStreamTest, FailReportsCancellation) {
+  auto stream = CreateStream(CompletionStream::Dialect::kOpenAIChat);
+  stream->Fail(core::kRequestCancelledError);
+  stream->Append(
+      "data: {\"choices\":[{\"delta\":{\"content\":\"late\"}}]}\n\n");
+
+  ASSERT_EQ(deltas_.size(), 1u);
+  EXPECT_EQ(deltas_[0].finish_reason, core::StreamFinishReason::kCancelled);
+}
+
+TEST(StreamFinishReasonTest, NormalizesProviderReasons) {
+  EXPECT_EQ(core::ParseStreamFinishReason("stop"),
+            core::StreamFinishReason::kStop);
+  EXPECT_EQ(core::ParseStreamFinishReason("end_turn"),
+            core::StreamFinishReason::kStop);
+  EXPECT_EQ(core::ParseStreamFinishReason("max_tokens"),
+            core::StreamFinishReason::kLength);
+  EXPECT_EQ(core::ParseStreamFinishReason("content_filter"),
+            core::StreamFinishReason::kContentFilter);
+  EXPECT_EQ(core::ParseStreamFinishReason("tool_use"),
+            core::StreamFinishReason::kToolUse);
+  EXPECT_EQ(core::ParseStreamFinishReason("unheard_of"),
+            core::StreamFinishReason::kNone);
+}
+
+}  // namespace
+}  // namespace adapters
+}  // namespace asol
@@ -4,8 +4,10 @@
 
 #include "asol/adapters/copilot/copilot_service_provider.h"
 
+#include <algorithm>
 #include <utility>
 
+#include "asol/adapters/provider_token_counter.h"
 #include "base/logging.h"
 #include "base/strings/string_util.h"
 
@@ -26,6 +28,28 @@ constexpr char kConfigKeyModel[] = "model";
 constexpr char kConfigKeyTemperature[] = "temperature";
 constexpr char kConfigKeyMaxTokens[] = "max_tokens";
 constexpr char kConfigKeyApiVersion[] = "api_version";
+
+// System instructions for the tasks that send one ahead of the input
+constexpr char kSummarizationPrompt[] =
+    "Summarize the following text concisely while preserving the key information.";
+constexpr char kContentAnalysisPrompt[] =
+    "Analyze the following content. Identify key topics, entities, sentiment, and main points.";
+constexpr char kCodeGenerationPrompt[] =
+    "You are Microsoft Copilot, a helpful coding assistant. Generate clean, efficient, and well-documented code based on the user's requirements.";
+
+// System instruction for a translation into the "target_language" custom
+// param, English when it is absent
+std::string GetTranslationPrompt(
+    const core::AIServiceProvider::AIRequestParams& params) {
+  std::string target_language = "English";
+  auto it = params.custom_params.find("target_language");
+  if (it != params.custom_params.end()) {
+    target_language = it->second;
+  }
+  return "Translate the following text to " + target_language +
+         ". Maintain the original meaning, tone, and style as closely as "
+         "possible.";
+}
 }  // namespace
 
 CopilotServiceProvider::CopilotServiceProvider() {
@@ -63,6 +87,7 @@ core::AIServiceProvider::Capabilities CopilotServiceProvider::GetCapabilities()
   capabilities.supports_code_generation = true;
   capabilities.supports_question_answering = true;
   capabilities.supports_translation = true;
+  capabilities.supports_streaming = true;
   capabilities.supports_context = true;
   
   // Add supported languages
@@ -70,9 +95,18 @@ core::AIServiceProvider::Capabilities CopilotServiceProvider::GetCapabilities()
     "en", "es", "fr", "de", "it", "pt", "nl", "ru", "zh", "ja", "ko", "ar"
   };
   
+  const auto& request_config = copilot_adapter_->GetRequestConfig();
+  capabilities.max_input_tokens = GetMaxInputTokens(
+      request_config.model_name,
+      static_cast<size_t>(std::max(request_config.max_tokens, 0)));
+
   return capabilities;
 }
 
+const core::TokenCounter& CopilotServiceProvider::GetTokenCounter() const {
+  return ProviderTokenCounter::Get(ProviderTokenCounter::Family::kOpenAI);
+}
+
 bool CopilotServiceProvider::SupportsTaskType(TaskType task_type) const {
   switch (task_type) {
     case TaskType::TEXT_GENERATION:
@@ -121,6 +155,48 @@ void CopilotServiceProvider::ProcessRequest(
   }
 }
 
+void CopilotServiceProvider::ProcessStreamingRequest(
+    const AIRequestParams& params,
+    AIStreamCallback callback) {
+  DLOG(INFO) << "Processing streaming request with Copilot provider. Task type: "
+             << static_cast<int>(params.task_type);
+
+  std::string system_prompt;
+  switch (params.task_type) {
+    case TaskType::TEXT_GENERATION:
+    case TaskType::QUESTION_ANSWERING:
+      copilot_adapter_->ProcessTextStream(params.input_text, std::move(callback));
+      return;
+    case TaskType::TEXT_SUMMARIZATION:
+      system_prompt = kSummarizationPrompt;
+      break;
+    case TaskType::CONTENT_ANALYSIS:
+      system_prompt = kContentAnalysisPrompt;
+      break;
+    case TaskType::CODE_GENERATION:
+      system_prompt = kCodeGenerationPrompt;
+      break;
+    case TaskType::TRANSLATION:
+      system_prompt = GetTranslationPrompt(params);
+      break;
+    default:
+      callback.Run(core::MakeFinalStreamDelta(
+          false, "Unsupported task type for Copilot provider"));
+      return;
+  }
+
+  CopilotMessage system_message;
+  system_message.role = CopilotMessage::Role::SYSTEM;
+  system_message.content = system_prompt;
+
+  CopilotMessage user_message;
+  user_message.role = CopilotMessage::Role::USER;
+  user_message.content = params.input_text;
+
+  copilot_adapter_->ProcessConversationStream(
+      {system_message, user_message}, std::move(callback));
+}
+
 void CopilotServiceProvider::Configure(
     const std::unordered_map<std::string, std::string>& config) {
   // Update the configuration
@@ -216,7 +292,7 @@ void CopilotServiceProvider::ProcessTextSummarization(
   
   CopilotMessage system_message;
   system_message.role = CopilotMessage::Role::SYSTEM;
-  system_message.content = "Summarize the following text concisely while preserving the key information.";
+  system_message.content = kSummarizationPrompt;
   
   CopilotMessage user_message;
   user_message.role = CopilotMessage::Role::USER;
@@ -241,7 +317,7 @@ void CopilotServiceProvider::ProcessContentAnalysis(
   
   CopilotMessage system_message;
   system_message.role = CopilotMessage::Role::SYSTEM;
-  system_message.content = "Analyze the following content. Identify key topics, entities, sentiment, and main points.";
+  system_message.content = kContentAnalysisPrompt;
   
   CopilotMessage user_message;
   user_message.role = CopilotMessage::Role::USER;
@@ -301,7 +377,7 @@ void CopilotServiceProvider::ProcessCodeGeneration(
   
   CopilotMessage system_message;
   system_message.role = CopilotMessage::Role::SYSTEM;
-  system_message.content = "You are Microsoft Copilot, a helpful coding assistant. Generate clean, efficient, and well-documented code based on the user's requirements.";
+  system_message.content = kCodeGenerationPrompt;
   
   CopilotMessage user_message;
   user_message.role = CopilotMessage::Role::USER;
@@ -324,15 +400,13 @@ void CopilotServiceProvider::ProcessTranslation(
   // Add a system message to guide the model
   std::vector<CopilotMessage> messages;
   
-  // Check if target language is specified
-  std::string target_language = "English";  // Default
-  if (params.custom_params.find("target_language") != params.custom_params.end()) {
-    target_language = params.custom_params.at("target_language");
-  }
+  // The message only views the prompt, so it is kept here until the
+  // request has been rendered
+  std::string system_prompt = GetTranslationPrompt(params);
   
   CopilotMessage system_message;
   system_message.role = CopilotMessage::Role::SYSTEM;
-  system_message.content = "Translate the following text to " + target_language + ". Maintain the original meaning, tone, and style as closely as possible.";
+  system_message.content = system_prompt;
   
   CopilotMessage user_message;
   user_message.role = CopilotMessage::Role::USER;
@@ -373,7 +447,7 @@ std::vector<CopilotMessage> CopilotServiceProvider::ConvertToCopilotMessages(
         break;
     }
     
-    copilot_message.content = context_message.content;
+    copilot_message.content = context_message.content();
     copilot_messages.push_back(copilot_message);
   }
   
@@ -6,6 +6,9 @@
 
 #include <utility>
 
+#include "asol/adapters/completion_stream.h"
+#include "asol/adapters/json_field_reader.h"
+#include "asol/adapters/payload_template.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
@@ -23,21 +26,27 @@ namespace {
 constexpr char kApiKeyHeader[] = "api-key: ";
 constexpr char kContentTypeHeader[] = "Content-Type: application/json";
 
+// Simulated streamed responses are fed to the decoder this many bytes at a
+// time, about the size of one event
+constexpr size_t kSimulatedStreamChunkSize = 64;
+
 // Helper function to truncate text for logging
-std::string TruncateForLogging(const std::string& text, size_t max_length = 50) {
+std::string TruncateForLogging(std::string_view text, size_t max_length = 50) {
   if (text.length() <= max_length)
-    return text;
-  return text.substr(0, max_length) + "...";
+    return std::string(text);
+  return std::string(text.substr(0, max_length)) + "...";
 }
 
 }  // namespace
 
 CopilotTextAdapter::CopilotTextAdapter() : config_() {
+  UpdatePayloadTemplates();
   LOG(INFO) << "CopilotTextAdapter initialized with default configuration.";
 }
 
 CopilotTextAdapter::CopilotTextAdapter(const std::string& api_key) 
     : api_key_(api_key), config_() {
+  UpdatePayloadTemplates();
   LOG(INFO) << "CopilotTextAdapter initialized with provided API key.";
 }
 
@@ -46,13 +55,13 @@ CopilotTextAdapter::~CopilotTextAdapter() {
 }
 
 void CopilotTextAdapter::ProcessText(
-    const std::string& text_input,
+    std::string_view text_input,
     CopilotResponseCallback callback) {
   DLOG(INFO) << "Processing text with Copilot Adapter: " 
              << TruncateForLogging(text_input);
   
   // Build the request payload for a single text prompt
-  nlohmann::json payload = BuildRequestPayload(text_input);
+  std::string payload = BuildRequestPayload(text_input);
   
   // Send the request to the Microsoft Copilot API
   SendRequest(payload, std::move(callback));
@@ -64,14 +73,32 @@ void CopilotTextAdapter::ProcessConversation(
   DLOG(INFO) << "Processing conversation with " << messages.size() << " messages";
   
   // Build the request payload for a conversation
-  nlohmann::json payload = BuildConversationPayload(messages);
+  std::string payload = BuildConversationPayload(messages);
   
   // Send the request to the Microsoft Copilot API
   SendRequest(payload, std::move(callback));
 }
 
+void CopilotTextAdapter::ProcessTextStream(
+    std::string_view text_input,
+    core::StreamDeltaCallback callback) {
+  DLOG(INFO) << "Streaming text with Copilot Adapter: "
+             << TruncateForLogging(text_input);
+  SendStreamingRequest(BuildRequestPayload(text_input), std::move(callback));
+}
+
+void CopilotTextAdapter::ProcessConversationStream(
+    const std::vector<CopilotMessage>& messages,
+    core::StreamDeltaCallback callback) {
+  DLOG(INFO) << "Streaming conversation with " << messages.size()
+             << " messages";
+  SendStreamingRequest(BuildConversationPayload(messages),
+                       std::move(callback));
+}
+
 void CopilotTextAdapter::SetRequestConfig(const CopilotRequestConfig& config) {
   config_ = config;
+  UpdatePayloadTemplates();
   DLOG(INFO) << "Updated Copilot request configuration. Model: " 
              << config_.model_name;
 }
@@ -90,30 +117,12 @@ void CopilotTextAdapter::SetEndpoint(const std::string& endpoint) {
   DLOG(INFO) << "Updated endpoint to: " << endpoint_;
 }
 
-nlohmann::json CopilotTextAdapter::BuildRequestPayload(
-    const std::string& text_input) const {
+void CopilotTextAdapter::UpdatePayloadTemplates() {
   nlohmann::json payload;
   
   // Set the model
   payload["model"] = config_.model_name;
   
-  // Add the messages array with system and user messages
-  nlohmann::json messages = nlohmann::json::array();
-  
-  // Add a default system message if processing a single text input
-  nlohmann::json system_message;
-  system_message["role"] = "system";
-  system_message["content"] = "You are Microsoft Copilot, a helpful AI assistant.";
-  messages.push_back(system_message);
-  
-  // Add the user message
-  nlohmann::json user_message;
-  user_message["role"] = "user";
-  user_message["content"] = text_input;
-  messages.push_back(user_message);
-  
-  payload["messages"] = messages;
-  
   // Add generation parameters
   payload["temperature"] = config_.temperature;
   payload["max_tokens"] = config_.max_tokens;
@@ -122,36 +131,43 @@ nlohmann::json CopilotTextAdapter::BuildRequestPayload(
   // Add API version
   payload["api-version"] = config_.api_version;
   
-  return payload;
+  // Conversations splice in a pre-rendered messages array
+  payload["messages"] = PayloadTemplate::RawSlot(0);
+  conversation_template_ = PayloadTemplate(payload);
+  
+  // Add a default system message if processing a single text input
+  payload["messages"] = nlohmann::json::array({
+    {{"role", "system"},
+     {"content", "You are Microsoft Copilot, a helpful AI assistant."}},
+    {{"role", "user"}, {"content", PayloadTemplate::TextSlot(0)}}
+  });
+  text_template_ = PayloadTemplate(payload);
+  
+  message_template_ = PayloadTemplate(nlohmann::json{
+    {"role", PayloadTemplate::TextSlot(0)},
+    {"content", PayloadTemplate::TextSlot(1)}
+  });
+}
+
+std::string CopilotTextAdapter::BuildRequestPayload(
+    std::string_view text_input) const {
+  return text_template_.Render({text_input});
 }
 
-nlohmann::json CopilotTextAdapter::BuildConversationPayload(
+std::string CopilotTextAdapter::BuildConversationPayload(
     const std::vector<CopilotMessage>& messages) const {
-  nlohmann::json payload;
-  
-  // Set the model
-  payload["model"] = config_.model_name;
-  
   // Convert each message to the format expected by Microsoft Copilot API
-  nlohmann::json messages_array = nlohmann::json::array();
+  std::string messages_array = "[";
   for (const auto& message : messages) {
-    nlohmann::json msg_obj;
-    msg_obj["role"] = RoleToString(message.role);
-    msg_obj["content"] = message.content;
-    messages_array.push_back(msg_obj);
+    if (messages_array.size() > 1) {
+      messages_array += ',';
+    }
+    message_template_.RenderTo({RoleToString(message.role), message.content},
+                               &messages_array);
   }
+  messages_array += ']';
   
-  payload["messages"] = messages_array;
-  
-  // Add generation parameters
-  payload["temperature"] = config_.temperature;
-  payload["max_tokens"] = config_.max_tokens;
-  payload["top_p"] = config_.top_p;
-  
-  // Add API version
-  payload["api-version"] = config_.api_version;
-  
-  return payload;
+  return conversation_template_.Render({messages_array});
 }
 
 std::string CopilotTextAdapter::RoleToString(CopilotMessage::Role role) const {
@@ -169,13 +185,12 @@ std::string CopilotTextAdapter::RoleToString(CopilotMessage::Role role) const {
 }
 
 void CopilotTextAdapter::SendRequest(
-    const nlohmann::json& payload,
+    const std::string& payload,
     CopilotResponseCallback callback) {
   // In a real implementation, this would use network services to send an HTTP request
   // For now, we'll simulate a response
   
-  std::string json_str = payload.dump(2);
-  DLOG(INFO) << "Copilot API Request payload: " << TruncateForLogging(json_str, 100);
+  DLOG(INFO) << "Copilot API Request payload: " << TruncateForLogging(payload, 100);
   
   // Construct the headers (would be used in actual implementation)
   std::vector<std::string> headers;
@@ -223,25 +238,11 @@ void CopilotTextAdapter::HandleResponse(
   bool success = true;
   std::string result_text;
   
-  try {
-    // Parse the JSON response
-    nlohmann::json response = nlohmann::json::parse(response_data);
-    
-    // Extract the response text
-    if (response.contains("choices") && 
-        !response["choices"].empty() && 
-        response["choices"][0].contains("message") &&
-        response["choices"][0]["message"].contains("content")) {
-      
-      result_text = response["choices"][0]["message"]["content"];
-    } else {
-      success = false;
-      result_text = "Failed to parse response: unexpected format";
-      LOG(ERROR) << result_text;
-    }
-  } catch (const std::exception& e) {
+  // Read only the fields we need instead of building a DOM
+  JsonFieldReader reader(response_data);
+  if (!reader.GetString({"choices", 0, "message", "content"}, &result_text)) {
     success = false;
-    result_text = "Failed to parse response: " + std::string(e.what());
+    result_text = "Failed to parse response: unexpected format";
     LOG(ERROR) << result_text;
   }
   
@@ -249,6 +250,53 @@ void CopilotTextAdapter::HandleResponse(
   std::move(callback).Run(success, result_text);
 }
 
+void CopilotTextAdapter::SendStreamingRequest(
+    std::string payload,
+    core::StreamDeltaCallback callback) {
+  // The API follows the Chat Completions streaming format
+  CompletionStream::EnableStreaming(CompletionStream::Dialect::kOpenAIChat,
+                                    &payload);
+  DLOG(INFO) << "Copilot API streaming request payload: "
+             << TruncateForLogging(payload, 100);
+  DLOG(INFO) << "Would send request to: " << endpoint_;
+
+  auto stream = std::make_unique<CompletionStream>(
+      CompletionStream::Dialect::kOpenAIChat, std::move(callback));
+
+  // Simulate the event stream the API sends for a request with "stream"
+  // and "stream_options.include_usage" set
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(
+          &CopilotTextAdapter::HandleStreamResponse,
+          weak_ptr_factory_.GetWeakPtr(), std::move(stream),
+          "data: {\"id\":\"copilot-chat-123\",\"object\":"
+          "\"chat.completion.chunk\",\"choices\":[{\"index\":0,\"delta\":"
+          "{\"role\":\"assistant\",\"content\":\"This is a simulated\"},"
+          "\"finish_reason\":null}],\"usage\":null}\n\n"
+          "data: {\"id\":\"copilot-chat-123\",\"object\":"
+          "\"chat.completion.chunk\",\"choices\":[{\"index\":0,\"delta\":"
+          "{\"content\":\" response from the Microsoft Copilot API.\"},"
+          "\"finish_reason\":\"stop\"}],\"usage\":null}\n\n"
+          "data: {\"id\":\"copilot-chat-123\",\"object\":"
+          "\"chat.completion.chunk\",\"choices\":[],\"usage\":"
+          "{\"prompt_tokens\":9,\"completion_tokens\":12,"
+          "\"total_tokens\":21}}\n\n"
+          "data: [DONE]\n\n"),
+      base::Milliseconds(100));  // Simulate network delay
+}
+
+void CopilotTextAdapter::HandleStreamResponse(
+    std::unique_ptr<CompletionStream> stream,
+    const std::string& response_body) {
+  std::string_view body(response_body);
+  for (size_t offset = 0; offset < body.size() && !stream->finished();
+       offset += kSimulatedStreamChunkSize) {
+    stream->Append(body.substr(offset, kSimulatedStreamChunkSize));
+  }
+  stream->Finish();
+}
+
 }  // namespace copilot
 }  // namespace adapters
-}  // namespace asol
\ No newline at end of file
+}  // namespace asol
@@ -8,14 +8,20 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "asol/adapters/payload_template.h"
+#include "asol/core/stream_delta.h"
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "third_party/nlohmann_json/json.hpp"
 
 namespace asol {
 namespace adapters {
+
+class CompletionStream;
+
 namespace copilot {
 
 // Represents a message in a conversation with Microsoft Copilot
@@ -27,7 +33,10 @@ struct CopilotMessage {
   };
 
   Role role;
-  std::string content;
+  // Must outlive the call the message is passed to, which builds the
+  // request before returning; conversations can then point into shared
+  // context history instead of copying it
+  std::string_view content;
 };
 
 // Represents configuration options for Microsoft Copilot API requests
@@ -54,11 +63,18 @@ class CopilotTextAdapter {
   CopilotTextAdapter& operator=(const CopilotTextAdapter&) = delete;
 
   // Process a single text prompt and get a response
-  void ProcessText(const std::string& text_input, CopilotResponseCallback callback);
+  void ProcessText(std::string_view text_input, CopilotResponseCallback callback);
   
   // Process a conversation with multiple messages
   void ProcessConversation(const std::vector<CopilotMessage>& messages,
                           CopilotResponseCallback callback);
+
+  // Same as ProcessText() and ProcessConversation(), reporting the text as
+  // it is generated. The final delta carries the finish reason and usage.
+  void ProcessTextStream(std::string_view text_input,
+                         core::StreamDeltaCallback callback);
+  void ProcessConversationStream(const std::vector<CopilotMessage>& messages,
+                                 core::StreamDeltaCallback callback);
   
   // Configure the adapter with specific settings
   void SetRequestConfig(const CopilotRequestConfig& config);
@@ -73,26 +89,42 @@ class CopilotTextAdapter {
   void SetEndpoint(const std::string& endpoint);
 
  private:
+  // Rebuild the request templates from |config_|
+  void UpdatePayloadTemplates();
+
   // Helper methods for API interaction
-  nlohmann::json BuildRequestPayload(const std::string& text_input) const;
-  nlohmann::json BuildConversationPayload(
+  std::string BuildRequestPayload(std::string_view text_input) const;
+  std::string BuildConversationPayload(
       const std::vector<CopilotMessage>& messages) const;
   
   // Convert message role enum to string for API
   std::string RoleToString(CopilotMessage::Role role) const;
   
   // Send request to Microsoft Copilot API
-  void SendRequest(const nlohmann::json& payload, CopilotResponseCallback callback);
+  void SendRequest(const std::string& payload, CopilotResponseCallback callback);
   
   // Parse API response
   void HandleResponse(const std::string& response_data, 
                      CopilotResponseCallback callback);
 
+  // Send |payload| as a streaming request
+  void SendStreamingRequest(std::string payload,
+                            core::StreamDeltaCallback callback);
+
+  // Feed a streamed response body to |stream|
+  void HandleStreamResponse(std::unique_ptr<CompletionStream> stream,
+                            const std::string& response_body);
+
   // Private members
   std::string api_key_;
   std::string endpoint_ = "https://api.cognitive.microsoft.com/copilot/v1/chat/completions";
   CopilotRequestConfig config_;
   
+  // Request bodies pre-serialized for |config_|
+  PayloadTemplate text_template_;
+  PayloadTemplate conversation_template_;
+  PayloadTemplate message_template_;
+  
   // For async operations and callbacks
   base::WeakPtrFactory<CopilotTextAdapter> weak_ptr_factory_{this};
 };
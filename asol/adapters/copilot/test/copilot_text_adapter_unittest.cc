@@ -174,7 +174,8 @@ TEST_F(CopilotTextAdapterTest, ProcessConversation) {
 
 // Test request payload building for single text
 TEST_F(CopilotTextAdapterTest, BuildRequestPayload) {
-  nlohmann::json payload = adapter_->BuildRequestPayload("Test prompt");
+  nlohmann::json payload =
+      nlohmann::json::parse(adapter_->BuildRequestPayload("Test prompt"));
   
   EXPECT_TRUE(payload.contains("model"));
   EXPECT_TRUE(payload.contains("messages"));
@@ -209,7 +210,8 @@ TEST_F(CopilotTextAdapterTest, BuildConversationPayload) {
   messages.push_back(system_message);
   messages.push_back(user_message);
   
-  nlohmann::json payload = adapter_->BuildConversationPayload(messages);
+  nlohmann::json payload =
+      nlohmann::json::parse(adapter_->BuildConversationPayload(messages));
   
   EXPECT_TRUE(payload.contains("model"));
   EXPECT_TRUE(payload.contains("messages"));
@@ -229,6 +231,27 @@ TEST_F(CopilotTextAdapterTest, BuildConversationPayload) {
   EXPECT_EQ(user["content"], "Hello!");
 }
 
+// Messages only view their content, so the payload must copy it: the
+// service providers keep prompts alive only until the request is rendered
+TEST_F(CopilotTextAdapterTest, ConversationPayloadCopiesMessageContent) {
+  std::string system_prompt = "Translate the following text to French.";
+  std::vector<CopilotMessage> messages;
+  CopilotMessage system_message;
+  system_message.role = CopilotMessage::Role::SYSTEM;
+  system_message.content = system_prompt;
+  messages.push_back(system_message);
+  CopilotMessage user_message;
+  user_message.role = CopilotMessage::Role::USER;
+  user_message.content = "Hello!";
+  messages.push_back(user_message);
+
+  std::string rendered = adapter_->BuildConversationPayload(messages);
+  system_prompt.assign(system_prompt.size(), 'x');
+
+  nlohmann::json payload = nlohmann::json::parse(rendered);
+  EXPECT_EQ(payload["messages"][0]["content"], "Translate the following text to French.");
+}
+
 // Test role to string conversion
 TEST_F(CopilotTextAdapterTest, RoleToString) {
   EXPECT_EQ(adapter_->RoleToString(CopilotMessage::Role::USER), "user");
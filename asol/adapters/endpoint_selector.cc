@@ -0,0 +1,128 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/endpoint_selector.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check.h"
+
+namespace asol {
+namespace adapters {
+
+EndpointSelector::Endpoint::Endpoint(std::string url) : url(std::move(url)) {}
+
+EndpointSelector::EndpointSelector(std::vector<std::string> endpoints,
+                                   const Config& config)
+    : config_(config) {
+  DCHECK(!endpoints.empty());
+  endpoints_.reserve(endpoints.size());
+  for (std::string& url : endpoints) {
+    endpoints_.emplace_back(std::move(url));
+  }
+}
+
+EndpointSelector::~EndpointSelector() = default;
+
+// static
+base::TimeDelta EndpointSelector::RankingRtt(const Endpoint& endpoint) {
+  return endpoint.rtt.is_zero() ? base::TimeDelta::Max() : endpoint.rtt;
+}
+
+size_t EndpointSelector::Select(base::TimeTicks now) {
+  size_t best = endpoints_.size();
+  for (size_t i = 0; i < endpoints_.size(); ++i) {
+    if (IsHealthy(i, now) &&
+        (best == endpoints_.size() ||
+         RankingRtt(endpoints_[i]) < RankingRtt(endpoints_[best]))) {
+      best = i;
+    }
+  }
+
+  if (best == endpoints_.size()) {
+    // Everything is down: use the endpoint that comes back first
+    best = 0;
+    for (size_t i = 1; i < endpoints_.size(); ++i) {
+      if (endpoints_[i].down_until < endpoints_[best].down_until) {
+        best = i;
+      }
+    }
+  } else if (best != current_ && IsHealthy(current_, now) &&
+             !endpoints_[current_].rtt.is_zero() &&
+             endpoints_[best].rtt >
+                 endpoints_[current_].rtt * (1.0 - config_.switch_margin)) {
+    // Not enough faster to be worth moving the traffic
+    best = current_;
+  }
+
+  current_ = best;
+  return current_;
+}
+
+bool EndpointSelector::IsHealthy(size_t index, base::TimeTicks now) const {
+  DCHECK_LT(index, endpoints_.size());
+  return now >= endpoints_[index].down_until;
+}
+
+void EndpointSelector::RecordRtt(size_t index, base::TimeDelta rtt) {
+  DCHECK_LT(index, endpoints_.size());
+  Endpoint& endpoint = endpoints_[index];
+  endpoint.rtt = endpoint.rtt.is_zero()
+                     ? rtt
+                     : endpoint.rtt +
+                           (rtt - endpoint.rtt) * config_.rtt_sample_weight;
+  // Never zero, which means unmeasured
+  endpoint.rtt = std::max(endpoint.rtt, base::Microseconds(1));
+  endpoint.consecutive_failures = 0;
+  endpoint.down_until = base::TimeTicks();
+}
+
+void EndpointSelector::RecordSuccess(size_t index,
+                                     base::TimeDelta latency,
+                                     base::TimeTicks now) {
+  DCHECK_LT(index, endpoints_.size());
+  Endpoint& endpoint = endpoints_[index];
+  ++endpoint.requests;
+  endpoint.consecutive_failures = 0;
+  endpoint.down_until = base::TimeTicks();
+  endpoint.latency.Record(latency.InMillisecondsF(), now);
+}
+
+void EndpointSelector::RecordFailure(size_t index, base::TimeTicks now) {
+  DCHECK_LT(index, endpoints_.size());
+  Endpoint& endpoint = endpoints_[index];
+  ++endpoint.failures;
+  ++endpoint.consecutive_failures;
+
+  base::TimeDelta cooldown = config_.failure_cooldown;
+  for (int i = 1;
+       i < endpoint.consecutive_failures && cooldown < config_.max_cooldown;
+       ++i) {
+    cooldown *= 2;
+  }
+  endpoint.down_until = now + std::min(cooldown, config_.max_cooldown);
+}
+
+std::vector<EndpointSelector::EndpointStats> EndpointSelector::GetStats(
+    base::TimeTicks now) const {
+  std::vector<EndpointStats> stats;
+  stats.reserve(endpoints_.size());
+  for (size_t i = 0; i < endpoints_.size(); ++i) {
+    const Endpoint& endpoint = endpoints_[i];
+    EndpointStats& entry = stats.emplace_back();
+    entry.url = endpoint.url;
+    entry.healthy = IsHealthy(i, now);
+    entry.selected = i == current_;
+    entry.rtt = endpoint.rtt;
+    entry.requests = endpoint.requests;
+    entry.failures = endpoint.failures;
+    entry.p50_latency_ms = endpoint.latency.Percentile(0.50);
+    entry.p95_latency_ms = endpoint.latency.Percentile(0.95);
+  }
+  return stats;
+}
+
+}  // namespace adapters
+}  // namespace asol
@@ -0,0 +1,120 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_ADAPTERS_ENDPOINT_SELECTOR_H_
+#define ASOL_ADAPTERS_ENDPOINT_SELECTOR_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "asol/core/latency_histogram.h"
+#include "base/time/time.h"
+
+namespace asol {
+namespace adapters {
+
+// EndpointSelector routes a provider's requests among endpoints serving the
+// same API, e.g. regional deployments or proxies, so a user far from the
+// default one does not pay its round trip on every request.
+//
+// The transport measures each endpoint's round-trip time in the background
+// and reports it with RecordRtt(); the selector keeps a moving average per
+// endpoint and routes to the fastest healthy one. An endpoint that has not
+// been measured yet ranks after every measured one, and ties go to the
+// endpoint listed first. Once chosen, an endpoint keeps the traffic until
+// another is faster by |switch_margin|, so routing does not flap between
+// endpoints of similar RTT.
+//
+// An endpoint whose request or probe fails, by network error or 5xx, is
+// skipped for |failure_cooldown|, doubling with every failure in a row up
+// to |max_cooldown|, and requests fail over to the next best. A successful
+// request or probe makes it healthy again. With every endpoint down, the
+// one that comes back first is used.
+//
+// Per-endpoint request latency is kept for GetStats(), so metrics show
+// which endpoint served and how fast. Not thread-safe.
+class EndpointSelector {
+ public:
+  struct Config {
+    // Weight of the newest sample in the RTT moving average
+    double rtt_sample_weight = 0.3;
+    base::TimeDelta failure_cooldown = base::Seconds(10);
+    base::TimeDelta max_cooldown = base::Minutes(5);
+    // Fraction of the current endpoint's RTT another must save to take over
+    double switch_margin = 0.2;
+  };
+
+  struct EndpointStats {
+    std::string url;
+    bool healthy = true;
+    bool selected = false;
+    // Zero before the first measurement
+    base::TimeDelta rtt;
+    int requests = 0;
+    // Failed requests and probes
+    int failures = 0;
+    double p50_latency_ms = 0.0;
+    double p95_latency_ms = 0.0;
+  };
+
+  // |endpoints| must not be empty
+  explicit EndpointSelector(std::vector<std::string> endpoints,
+                            const Config& config = Config());
+  ~EndpointSelector();
+
+  EndpointSelector(const EndpointSelector&) = delete;
+  EndpointSelector& operator=(const EndpointSelector&) = delete;
+
+  size_t size() const { return endpoints_.size(); }
+  const std::string& endpoint(size_t index) const {
+    return endpoints_[index].url;
+  }
+
+  // Index of the endpoint to send a request to at |now|
+  size_t Select(base::TimeTicks now);
+
+  bool IsHealthy(size_t index, base::TimeTicks now) const;
+
+  // A probe of endpoint |index| answered after |rtt|
+  void RecordRtt(size_t index, base::TimeDelta rtt);
+
+  // A request to endpoint |index| succeeded after |latency|
+  void RecordSuccess(size_t index,
+                     base::TimeDelta latency,
+                     base::TimeTicks now);
+
+  // A request or probe to endpoint |index| failed in a way that says the
+  // endpoint is at fault. Client errors such as 4xx do not count.
+  void RecordFailure(size_t index, base::TimeTicks now);
+
+  std::vector<EndpointStats> GetStats(base::TimeTicks now) const;
+
+ private:
+  struct Endpoint {
+    explicit Endpoint(std::string url);
+
+    std::string url;
+    // Zero before the first measurement
+    base::TimeDelta rtt;
+    int consecutive_failures = 0;
+    base::TimeTicks down_until;
+    int requests = 0;
+    int failures = 0;
+    core::LatencyHistogram latency;
+  };
+
+  // RTT used for ranking: unmeasured endpoints rank last
+  static base::TimeDelta RankingRtt(const Endpoint& endpoint);
+
+  const Config config_;
+  std::vector<Endpoint> endpoints_;
+  size_t current_ = 0;
+};
+
+}  // namespace adapters
+}  // namespace asol
+
+#endif  // ASOL_ADAPTERS_ENDPOINT_SELECTOR_H_
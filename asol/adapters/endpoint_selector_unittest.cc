@@ -0,0 +1,109 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/endpoint_selector.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace adapters {
+namespace {
+
+EndpointSelector::Config MakeConfig() {
+  EndpointSelector::Config config;
+  config.rtt_sample_weight = 0.5;
+  config.failure_cooldown = base::Seconds(10);
+  config.max_cooldown = base::Seconds(30);
+  config.switch_margin = 0.2;
+  return config;
+}
+
+TEST(EndpointSelectorTest, PrefersFirstUntilMeasured) {
+  EndpointSelector selector({"https://us.example/", "https://eu.example/"},
+                            MakeConfig());
+  base::TimeTicks now = base::TimeTicks::Now();
+  EXPECT_EQ(selector.Select(now), 0u);
+
+  // A measured endpoint outranks an unmeasured one
+  selector.RecordRtt(1, base::Milliseconds(200));
+  EXPECT_EQ(selector.Select(now), 1u);
+
+  selector.RecordRtt(0, base::Milliseconds(40));
+  EXPECT_EQ(selector.Select(now), 0u);
+}
+
+TEST(EndpointSelectorTest, SwitchesOnlyWhenFasterByMargin) {
+  EndpointSelector selector({"https://us.example/", "https://eu.example/"},
+                            MakeConfig());
+  base::TimeTicks now = base::TimeTicks::Now();
+  selector.RecordRtt(0, base::Milliseconds(100));
+  selector.RecordRtt(1, base::Milliseconds(120));
+  EXPECT_EQ(selector.Select(now), 0u);
+
+  // 90ms saves less than 20% of 100ms
+  selector.RecordRtt(1, base::Milliseconds(60));
+  EXPECT_EQ(selector.Select(now), 0u);
+
+  // 75ms does
+  selector.RecordRtt(1, base::Milliseconds(60));
+  EXPECT_EQ(selector.Select(now), 1u);
+}
+
+TEST(EndpointSelectorTest, FailsOverAndBacksOff) {
+  EndpointSelector selector({"https://us.example/", "https://eu.example/"},
+                            MakeConfig());
+  base::TimeTicks now = base::TimeTicks::Now();
+  selector.RecordRtt(0, base::Milliseconds(40));
+  selector.RecordRtt(1, base::Milliseconds(200));
+
+  selector.RecordFailure(0, now);
+  EXPECT_FALSE(selector.IsHealthy(0, now));
+  EXPECT_EQ(selector.Select(now), 1u);
+  EXPECT_EQ(selector.Select(now + base::Seconds(10)), 0u);
+
+  // A second failure in a row doubles the cooldown
+  selector.RecordFailure(0, now + base::Seconds(10));
+  EXPECT_EQ(selector.Select(now + base::Seconds(25)), 1u);
+  EXPECT_EQ(selector.Select(now + base::Seconds(30)), 0u);
+
+  // A successful probe brings it back at once
+  selector.RecordFailure(0, now + base::Seconds(30));
+  selector.RecordRtt(0, base::Milliseconds(40));
+  EXPECT_EQ(selector.Select(now + base::Seconds(31)), 0u);
+}
+
+TEST(EndpointSelectorTest, UsesFirstToRecoverWhenAllAreDown) {
+  EndpointSelector selector({"https://us.example/", "https://eu.example/"},
+                            MakeConfig());
+  base::TimeTicks now = base::TimeTicks::Now();
+  selector.RecordFailure(0, now);
+  selector.RecordFailure(0, now);
+  selector.RecordFailure(1, now);
+  EXPECT_EQ(selector.Select(now), 1u);
+}
+
+TEST(EndpointSelectorTest, ReportsLatencyPerEndpoint) {
+  EndpointSelector selector({"https://us.example/", "https://eu.example/"},
+                            MakeConfig());
+  base::TimeTicks now = base::TimeTicks::Now();
+  selector.RecordSuccess(1, base::Milliseconds(10), now);
+  selector.RecordSuccess(1, base::Milliseconds(10), now);
+  selector.RecordFailure(0, now);
+  selector.Select(now);
+
+  std::vector<EndpointSelector::EndpointStats> stats = selector.GetStats(now);
+  ASSERT_EQ(stats.size(), 2u);
+  EXPECT_EQ(stats[0].url, "https://us.example/");
+  EXPECT_FALSE(stats[0].healthy);
+  EXPECT_FALSE(stats[0].selected);
+  EXPECT_EQ(stats[0].failures, 1);
+  EXPECT_TRUE(stats[1].healthy);
+  EXPECT_TRUE(stats[1].selected);
+  EXPECT_EQ(stats[1].requests, 2);
+  EXPECT_NEAR(stats[1].p50_latency_ms, 10.0, 1.0);
+}
+
+}  // namespace
+}  // namespace adapters
+}  // namespace asol
@@ -0,0 +1,853 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/gemini/gemini_http_client.h"
+
+#include "asol/adapters/json_field_reader.h"
+#include "asol/adapters/stream_event_parser.h"
+#include "asol/core/startup_trace.h"
+#include "base/json/json_reader.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
+#include "net/base/net_errors.h"
+#include "net/base/url_util.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/cpp/simple_url_loader_stream_consumer.h"
+#include "services/network/public/mojom/url_response_head.mojom.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace asol {
+namespace adapters {
+namespace gemini {
+
+namespace {
+
+constexpr char kDefaultApiEndpoint[] =
+    "https://generativelanguage.googleapis.com/v1beta/models/";
+
+// Format an HTTP failure as "HTTP error: <code>[ (Retry-After: <v>)]: <body>",
+// the form core::IsRateLimitError() recognizes
+std::string FormatHttpError(int response_code,
+                            const network::mojom::URLResponseHead* info,
+                            const std::string* response_body) {
+  std::string error = "HTTP error: " + std::to_string(response_code);
+  std::string retry_after;
+  if (response_code == net::HTTP_TOO_MANY_REQUESTS && info && info->headers &&
+      info->headers->GetNormalizedHeader("Retry-After", &retry_after)) {
+    error += " (Retry-After: " + retry_after + ")";
+  }
+  if (response_body) {
+    error += ": " + *response_body;
+  }
+  return error;
+}
+
+}  // namespace
+
+// An asynchronous request with what is needed to send it again
+struct GeminiHttpClient::AsyncRequest {
+  std::string model_name;
+  std::string body;
+  ResponseCallback callback;
+  int attempts_made = 0;
+  // When the caller stops waiting; null for never
+  base::TimeTicks deadline;
+  // Where the attempt in flight went, and when
+  std::string endpoint;
+  base::TimeTicks attempt_start_time;
+  // When the attempt's response headers arrived; null until then
+  base::TimeTicks response_start_time;
+  // The caller's span, and the span of the attempt in flight
+  core::TraceContext trace;
+  absl::optional<core::TraceSpan> attempt_span;
+  // The attempt in flight; null while waiting to retry
+  std::unique_ptr<network::SimpleURLLoader> loader;
+  base::CallbackListSubscription cancel_subscription;
+};
+
+// One streamed completion. Server-sent events are parsed as the body
+// arrives and each text delta is forwarded without buffering the reply.
+class GeminiHttpClient::StreamingRequest
+    : public network::SimpleURLLoaderStreamConsumer {
+ public:
+  StreamingRequest(GeminiHttpClient* client,
+                   std::unique_ptr<network::SimpleURLLoader> loader,
+                   const std::string& model_name,
+                   const std::string& endpoint,
+                   StreamingResponseCallback callback)
+      : client_(client),
+        loader_(std::move(loader)),
+        model_name_(model_name),
+        endpoint_(endpoint),
+        start_time_(base::TimeTicks::Now()),
+        callback_(std::move(callback)),
+        parser_(StreamEventParser::Format::SERVER_SENT_EVENTS,
+                "text",
+                base::BindRepeating(&StreamingRequest::OnEvent,
+                                    base::Unretained(this))) {}
+
+  StreamingRequest(const StreamingRequest&) = delete;
+  StreamingRequest& operator=(const StreamingRequest&) = delete;
+
+  void Start(network::mojom::URLLoaderFactory* url_loader_factory) {
+    loader_->DownloadAsStream(url_loader_factory, this);
+  }
+
+  void set_cancel_subscription(base::CallbackListSubscription subscription) {
+    cancel_subscription_ = std::move(subscription);
+  }
+
+  // Report the cancellation as the final response. The client deletes
+  // |this| next, which closes the stream.
+  void OnCancelled() {
+    GeminiResponse response;
+    response.is_partial = false;
+    response.success = false;
+    response.error_message = core::kRequestCancelledError;
+    response.metadata.push_back({"model", model_name_});
+    callback_(response, true);
+  }
+
+  // network::SimpleURLLoaderStreamConsumer:
+  void OnDataReceived(std::string_view string_piece,
+                      base::OnceClosure resume) override {
+    parser_.Append(string_piece);
+    std::move(resume).Run();
+  }
+
+  void OnComplete(bool success) override {
+    parser_.Finish();
+
+    GeminiResponse response;
+    response.is_partial = false;
+    response.success = success;
+    if (!success) {
+      const network::mojom::URLResponseHead* info = loader_->ResponseInfo();
+      if (info && info->headers) {
+        response.error_message =
+            FormatHttpError(info->headers->response_code(), info, nullptr);
+      } else {
+        response.error_message =
+            "Network error: " + net::ErrorToString(loader_->NetError());
+      }
+    }
+    response.metadata.push_back({"model", model_name_});
+    response.metadata.push_back({"endpoint", endpoint_});
+    response.metadata.push_back(
+        {"stream_events", std::to_string(parser_.events_dispatched())});
+
+    // A stream is as fast as its first delta feels
+    base::TimeDelta latency = (first_delta_time_.is_null()
+                                   ? base::TimeTicks::Now()
+                                   : first_delta_time_) -
+                              start_time_;
+    client_->RecordEndpointOutcome(endpoint_, *loader_, latency);
+    callback_(response, true);
+
+    // Deletes |this|
+    client_->OnStreamingRequestComplete(this);
+  }
+
+  void OnRetry(base::OnceClosure start_retry) override {
+    // Retries are not enabled; deltas already forwarded cannot be recalled
+    NOTREACHED();
+  }
+
+ private:
+  void OnEvent(const StreamEventParser::Event& event) {
+    if (event.delta.empty()) {
+      return;
+    }
+    if (first_delta_time_.is_null()) {
+      first_delta_time_ = base::TimeTicks::Now();
+    }
+    GeminiResponse response;
+    response.success = true;
+    response.text = std::string(event.delta);
+    response.is_partial = true;
+    callback_(response, false);
+  }
+
+  GeminiHttpClient* const client_;
+  std::unique_ptr<network::SimpleURLLoader> loader_;
+  const std::string model_name_;
+  const std::string endpoint_;
+  const base::TimeTicks start_time_;
+  base::TimeTicks first_delta_time_;
+  StreamingResponseCallback callback_;
+  StreamEventParser parser_;
+  base::CallbackListSubscription cancel_subscription_;
+};
+
+GeminiHttpClient::GeminiHttpClient(
+    scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory)
+    : url_loader_factory_(std::move(url_loader_factory)),
+      endpoints_(std::make_unique<EndpointSelector>(
+          std::vector<std::string>{kDefaultApiEndpoint})) {
+  DCHECK(url_loader_factory_);
+}
+
+GeminiHttpClient::~GeminiHttpClient() = default;
+
+void GeminiHttpClient::SetApiKey(const std::string& api_key) {
+  api_key_ = api_key;
+}
+
+void GeminiHttpClient::SetApiEndpoint(const std::string& api_endpoint) {
+  SetApiEndpoints({api_endpoint});
+}
+
+void GeminiHttpClient::SetApiEndpoints(std::vector<std::string> api_endpoints,
+                                       base::TimeDelta probe_interval) {
+  DCHECK(!api_endpoints.empty());
+  // Probe results for the old list would land on the wrong endpoints;
+  // deleting the loaders drops them
+  probe_loaders_.clear();
+  endpoints_ = std::make_unique<EndpointSelector>(std::move(api_endpoints));
+  if (endpoints_->size() < 2) {
+    probe_timer_.Stop();
+    return;
+  }
+  ProbeEndpoints();
+  probe_timer_.Start(FROM_HERE, probe_interval,
+                     base::BindRepeating(&GeminiHttpClient::ProbeEndpoints,
+                                         weak_ptr_factory_.GetWeakPtr()));
+}
+
+std::vector<EndpointSelector::EndpointStats>
+GeminiHttpClient::GetEndpointStats() const {
+  return endpoints_->GetStats(base::TimeTicks::Now());
+}
+
+void GeminiHttpClient::SetRetryPolicy(const core::RetryPolicy::Config& policy) {
+  retry_policy_ = core::RetryPolicy(policy);
+}
+
+void GeminiHttpClient::SetRetryBudget(core::RetryBudget* budget) {
+  DCHECK(budget);
+  retry_budget_ = budget;
+}
+
+void GeminiHttpClient::SetNetworkQualityEstimator(
+    core::NetworkQualityEstimator* estimator) {
+  network_quality_estimator_ = estimator;
+}
+
+GeminiResponse GeminiHttpClient::SendRequest(
+    const nlohmann::json& request_payload,
+    const std::string& model_name) {
+  if (api_key_.empty()) {
+    GeminiResponse response;
+    response.success = false;
+    response.error_message = "API key not set";
+    return response;
+  }
+
+  // Create the request URL
+  size_t endpoint_index = endpoints_->Select(base::TimeTicks::Now());
+  std::string endpoint = endpoints_->endpoint(endpoint_index);
+  GURL url = CreateRequestUrl(endpoint_index, model_name, ":generateContent");
+  if (!url.is_valid()) {
+    GeminiResponse response;
+    response.success = false;
+    response.error_message = "Invalid API URL";
+    return response;
+  }
+
+  last_request_time_ = base::TimeTicks::Now();
+  base::TimeTicks start_time = last_request_time_;
+
+  // Create the URL loader
+  auto resource_request = std::make_unique<network::ResourceRequest>();
+  resource_request->url = url;
+  resource_request->method = "POST";
+  resource_request->credentials_mode = network::mojom::CredentialsMode::kOmit;
+  resource_request->headers.SetHeader("Content-Type", "application/json");
+
+  // Convert the request payload to a string
+  std::string request_body = request_payload.dump();
+
+  // Create the URL loader
+  auto loader = network::SimpleURLLoader::Create(
+      std::move(resource_request), network::SimpleURLLoader::BYPASS_CACHE);
+  loader->AttachStringForUpload(request_body, "application/json");
+
+  // Send the request
+  std::unique_ptr<std::string> response_body;
+  auto download_result = loader->DownloadToString(
+      url_loader_factory_.get(),
+      [&response_body](std::unique_ptr<std::string> downloaded_data) {
+        response_body = std::move(downloaded_data);
+      });
+  RecordEndpointOutcome(endpoint, *loader, base::TimeTicks::Now() - start_time);
+
+  // Check for network errors
+  if (download_result != net::OK) {
+    GeminiResponse response;
+    response.success = false;
+    response.error_message = "Network error: " + std::to_string(download_result);
+    return response;
+  }
+
+  // Check for HTTP errors
+  int response_code = loader->ResponseInfo() && loader->ResponseInfo()->headers
+                          ? loader->ResponseInfo()->headers->response_code()
+                          : 0;
+  if (response_code != net::HTTP_OK) {
+    GeminiResponse response;
+    response.success = false;
+    response.error_message = FormatHttpError(
+        response_code, loader->ResponseInfo(), response_body.get());
+    return response;
+  }
+
+  // Process the response
+  if (!response_body) {
+    GeminiResponse response;
+    response.success = false;
+    response.error_message = "Empty response from API";
+    return response;
+  }
+
+  GeminiResponse response = ProcessResponse(*response_body);
+  response.metadata.push_back({"endpoint", endpoint});
+  return response;
+}
+
+void GeminiHttpClient::SendRequestAsync(
+    const nlohmann::json& request_payload,
+    const std::string& model_name,
+    ResponseCallback callback) {
+  SendRequestAsync(request_payload.dump(), model_name, nullptr,
+                   core::TraceContext(), base::TimeTicks(),
+                   std::move(callback));
+}
+
+void GeminiHttpClient::SendRequestAsync(
+    std::string request_body,
+    const std::string& model_name,
+    scoped_refptr<core::CancellationToken> cancellation_token,
+    const core::TraceContext& trace,
+    base::TimeTicks deadline,
+    ResponseCallback callback) {
+  if (cancellation_token && cancellation_token->IsCancelled()) {
+    GeminiResponse response;
+    response.success = false;
+    response.error_message = core::kRequestCancelledError;
+    std::move(callback).Run(response);
+    return;
+  }
+
+  if (api_key_.empty()) {
+    GeminiResponse response;
+    response.success = false;
+    response.error_message = "API key not set";
+    std::move(callback).Run(response);
+    return;
+  }
+
+  // The body is kept so retries can resend it, to whichever endpoint is
+  // best by then
+  auto request = std::make_unique<AsyncRequest>();
+  request->model_name = model_name;
+  request->body = std::move(request_body);
+  request->callback = std::move(callback);
+  request->trace = trace;
+  request->deadline = deadline;
+  uint64_t request_id = next_async_request_id_++;
+  if (cancellation_token) {
+    request->cancel_subscription = cancellation_token->AddCancelCallback(
+        base::BindOnce(&GeminiHttpClient::OnAsyncRequestCancelled,
+                       weak_ptr_factory_.GetWeakPtr(), request_id));
+  }
+  async_requests_[request_id] = std::move(request);
+  retry_budget_->RecordRequest();
+  StartAsyncRequest(request_id);
+}
+
+void GeminiHttpClient::StartAsyncRequest(uint64_t request_id) {
+  auto it = async_requests_.find(request_id);
+  if (it == async_requests_.end()) {
+    // Cancelled while waiting to retry
+    return;
+  }
+  AsyncRequest* request = it->second.get();
+  size_t endpoint_index = endpoints_->Select(base::TimeTicks::Now());
+  GURL url =
+      CreateRequestUrl(endpoint_index, request->model_name, ":generateContent");
+  if (!url.is_valid()) {
+    GeminiResponse response;
+    response.success = false;
+    response.error_message = "Invalid API URL";
+    FinishAsyncRequest(request_id, std::move(response));
+    return;
+  }
+  request->attempts_made++;
+  request->endpoint = endpoints_->endpoint(endpoint_index);
+  last_request_time_ = base::TimeTicks::Now();
+  request->attempt_start_time = last_request_time_;
+  request->response_start_time = base::TimeTicks();
+
+  // Create the URL loader
+  auto resource_request = std::make_unique<network::ResourceRequest>();
+  resource_request->url = url;
+  resource_request->method = "POST";
+  resource_request->credentials_mode = network::mojom::CredentialsMode::kOmit;
+  resource_request->headers.SetHeader("Content-Type", "application/json");
+  if (request->trace.is_valid()) {
+    request->attempt_span.emplace("GeminiHttpClient::Attempt", request->trace);
+    resource_request->headers.SetHeader(
+        core::kTraceparentHeader,
+        request->attempt_span->context().ToTraceparent());
+  }
+
+  // Create the URL loader
+  auto loader = network::SimpleURLLoader::Create(
+      std::move(resource_request), network::SimpleURLLoader::BYPASS_CACHE);
+  loader->AttachStringForUpload(request->body, "application/json");
+
+  // Send the request. The request owns the loader, so dropping the request
+  // aborts the transfer.
+  request->loader = std::move(loader);
+  request->loader->SetOnResponseStartedCallback(
+      base::BindOnce(&GeminiHttpClient::OnResponseStarted,
+                     weak_ptr_factory_.GetWeakPtr(), request_id));
+  request->loader->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
+      url_loader_factory_.get(),
+      base::BindOnce(&GeminiHttpClient::OnRequestComplete,
+                    weak_ptr_factory_.GetWeakPtr(), request_id));
+}
+
+GeminiResponse GeminiHttpClient::ProcessResponse(
+    const std::string& response_body) {
+  GeminiResponse response;
+
+  // Read only the fields we need instead of building a DOM
+  JsonFieldReader reader(response_body);
+
+  // Check for error
+  if (reader.Has({"error"})) {
+    response.success = false;
+    if (!reader.GetString({"error", "message"}, &response.error_message)) {
+      response.error_message = "Unknown API error";
+    }
+    return response;
+  }
+
+  // Extract the generated text
+  if (reader.GetString({"candidates", 0, "content", "parts", 0, "text"},
+                       &response.text)) {
+    response.success = true;
+  }
+
+  // If we couldn't extract the text, set an error
+  if (response.text.empty() && response.error_message.empty()) {
+    response.success = false;
+    response.error_message = "Could not extract text from response";
+  }
+
+  // Extract metadata
+  int64_t token_count = 0;
+  if (reader.GetInt({"usageMetadata", "promptTokenCount"}, &token_count)) {
+    response.metadata.push_back(
+        {"prompt_tokens", base::NumberToString(token_count)});
+  }
+  // Prompt tokens Gemini served from its implicit prefix cache
+  if (reader.GetInt({"usageMetadata", "cachedContentTokenCount"},
+                    &token_count)) {
+    response.metadata.push_back(
+        {"cached_prompt_tokens", base::NumberToString(token_count)});
+  }
+  if (reader.GetInt({"usageMetadata", "candidatesTokenCount"}, &token_count)) {
+    response.metadata.push_back(
+        {"completion_tokens", base::NumberToString(token_count)});
+  }
+  if (reader.GetInt({"usageMetadata", "totalTokenCount"}, &token_count)) {
+    response.metadata.push_back(
+        {"total_tokens", base::NumberToString(token_count)});
+  }
+
+  // Add model info if available
+  std::string model;
+  if (reader.GetString({"model"}, &model)) {
+    response.metadata.push_back({"model", model});
+  }
+
+  return response;
+}
+
+void GeminiHttpClient::OnResponseStarted(
+    uint64_t request_id,
+    const GURL& final_url,
+    const network::mojom::URLResponseHead& head) {
+  auto it = async_requests_.find(request_id);
+  if (it != async_requests_.end()) {
+    it->second->response_start_time = base::TimeTicks::Now();
+  }
+}
+
+void GeminiHttpClient::OnRequestComplete(
+    uint64_t request_id,
+    std::unique_ptr<std::string> response_body) {
+  auto it = async_requests_.find(request_id);
+  DCHECK(it != async_requests_.end());
+  AsyncRequest* request = it->second.get();
+  std::unique_ptr<network::SimpleURLLoader> loader =
+      std::move(request->loader);
+  request->attempt_span.reset();
+  base::TimeTicks now = base::TimeTicks::Now();
+  RecordEndpointOutcome(request->endpoint, *loader,
+                        now - request->attempt_start_time);
+  // Generation happens before the headers are sent, so only the body's
+  // transfer measures the connection
+  if (network_quality_estimator_ && response_body &&
+      !request->response_start_time.is_null()) {
+    network_quality_estimator_->RecordThroughput(
+        response_body->size(), now - request->response_start_time);
+  }
+  GeminiResponse response;
+
+  if (!loader->ResponseInfo()) {
+    // Network errors; the net::Error name tells a refused connection,
+    // which is always safe to resend, from a reset
+    response.success = false;
+    response.error_message =
+        "Network error: " + net::ErrorToString(loader->NetError());
+  } else {
+    int response_code = loader->ResponseInfo()->headers
+                            ? loader->ResponseInfo()->headers->response_code()
+                            : 0;
+    if (response_code != net::HTTP_OK) {
+      response.success = false;
+      response.error_message = FormatHttpError(
+          response_code, loader->ResponseInfo(), response_body.get());
+    } else if (!response_body) {
+      response.success = false;
+      response.error_message = "Empty response from API";
+    } else {
+      response = ProcessResponse(*response_body);
+    }
+  }
+
+  // Generation requests have no side effects, so they are idempotent
+  base::TimeDelta time_left = request->deadline.is_null()
+                                  ? base::TimeDelta::Max()
+                                  : request->deadline - now;
+  base::TimeDelta delay;
+  if (!response.success &&
+      retry_policy_.ShouldRetry(response.error_message,
+                                request->attempts_made, /*idempotent=*/true,
+                                time_left, &delay) &&
+      retry_budget_->TryAcquireRetry(now)) {
+    // Backing off gives a failed endpoint time to recover; another healthy
+    // one can take the request at once
+    size_t next_endpoint = endpoints_->Select(now);
+    if (endpoints_->endpoint(next_endpoint) != request->endpoint &&
+        endpoints_->IsHealthy(next_endpoint, now)) {
+      delay = base::TimeDelta();
+    }
+    DVLOG(1) << "Retrying Gemini request in " << delay << " after: "
+             << response.error_message;
+    base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+        FROM_HERE,
+        base::BindOnce(&GeminiHttpClient::StartAsyncRequest,
+                       weak_ptr_factory_.GetWeakPtr(), request_id),
+        delay);
+    return;
+  }
+
+  response.metadata.push_back({"endpoint", request->endpoint});
+  FinishAsyncRequest(request_id, std::move(response));
+}
+
+void GeminiHttpClient::FinishAsyncRequest(uint64_t request_id,
+                                          GeminiResponse response) {
+  auto it = async_requests_.find(request_id);
+  DCHECK(it != async_requests_.end());
+  std::unique_ptr<AsyncRequest> finished = std::move(it->second);
+  async_requests_.erase(it);
+  std::move(finished->callback).Run(response);
+}
+
+void GeminiHttpClient::OnAsyncRequestCancelled(uint64_t request_id) {
+  auto it = async_requests_.find(request_id);
+  if (it == async_requests_.end()) {
+    return;
+  }
+  std::unique_ptr<AsyncRequest> request = std::move(it->second);
+  async_requests_.erase(it);
+  // Deleting the loader aborts the transfer
+  request->loader.reset();
+
+  GeminiResponse response;
+  response.success = false;
+  response.error_message = core::kRequestCancelledError;
+  std::move(request->callback).Run(response);
+}
+
+void GeminiHttpClient::SendStreamingRequest(
+    const nlohmann::json& request_payload,
+    const std::string& model_name,
+    StreamingResponseCallback callback) {
+  SendStreamingRequest(request_payload, model_name, nullptr,
+                       std::move(callback));
+}
+
+void GeminiHttpClient::SendStreamingRequest(
+    const nlohmann::json& request_payload,
+    const std::string& model_name,
+    scoped_refptr<core::CancellationToken> cancellation_token,
+    StreamingResponseCallback callback) {
+  if (cancellation_token && cancellation_token->IsCancelled()) {
+    GeminiResponse response;
+    response.success = false;
+    response.error_message = core::kRequestCancelledError;
+    callback(response, true);
+    return;
+  }
+
+  if (api_key_.empty()) {
+    GeminiResponse response;
+    response.success = false;
+    response.error_message = "API key not set";
+    callback(response, true);  // true indicates this is the final response
+    return;
+  }
+
+  // Create the request URL with streaming endpoint. Deltas already
+  // forwarded cannot be recalled, so a stream does not fail over.
+  size_t endpoint_index = endpoints_->Select(base::TimeTicks::Now());
+  GURL url =
+      CreateRequestUrl(endpoint_index, model_name, ":streamGenerateContent");
+  if (!url.is_valid()) {
+    GeminiResponse response;
+    response.success = false;
+    response.error_message = "Invalid API URL";
+    callback(response, true);
+    return;
+  }
+  
+  // Ask for server-sent events rather than one JSON array delivered at the
+  // end
+  url = net::AppendQueryParameter(url, "alt", "sse");
+
+  last_request_time_ = base::TimeTicks::Now();
+
+  // Create the URL loader
+  auto resource_request = std::make_unique<network::ResourceRequest>();
+  resource_request->url = url;
+  resource_request->method = "POST";
+  resource_request->credentials_mode = network::mojom::CredentialsMode::kOmit;
+  resource_request->headers.SetHeader("Content-Type", "application/json");
+  resource_request->headers.SetHeader("Accept", "text/event-stream");
+
+  // Convert the request payload to a string
+  std::string request_body = request_payload.dump();
+
+  // Create the URL loader
+  auto loader = network::SimpleURLLoader::Create(
+      std::move(resource_request), network::SimpleURLLoader::BYPASS_CACHE);
+  loader->AttachStringForUpload(request_body, "application/json");
+
+  auto request = std::make_unique<StreamingRequest>(
+      this, std::move(loader), model_name,
+      endpoints_->endpoint(endpoint_index), std::move(callback));
+  StreamingRequest* raw_request = request.get();
+  if (cancellation_token) {
+    // The subscription dies with the request, so it never outlives it
+    raw_request->set_cancel_subscription(cancellation_token->AddCancelCallback(
+        base::BindOnce(&GeminiHttpClient::OnStreamingRequestCancelled,
+                       weak_ptr_factory_.GetWeakPtr(),
+                       base::Unretained(raw_request))));
+  }
+  streaming_requests_.insert(std::move(request));
+  raw_request->Start(url_loader_factory_.get());
+}
+
+void GeminiHttpClient::OnStreamingRequestCancelled(StreamingRequest* request) {
+  request->OnCancelled();
+  OnStreamingRequestComplete(request);
+}
+
+void GeminiHttpClient::Preconnect(base::TimeDelta keep_alive_interval) {
+  keep_alive_interval_ = keep_alive_interval;
+  SendWarmUpRequest();
+  if (keep_alive_interval_.is_positive()) {
+    keep_alive_timer_.Start(FROM_HERE, keep_alive_interval_,
+                            base::BindRepeating(
+                                &GeminiHttpClient::OnKeepAliveTimer,
+                                weak_ptr_factory_.GetWeakPtr()));
+  } else {
+    keep_alive_timer_.Stop();
+  }
+}
+
+void GeminiHttpClient::SendWarmUpRequest() {
+  if (warm_up_loader_) {
+    return;
+  }
+  GURL origin =
+      GURL(endpoints_->endpoint(endpoints_->Select(base::TimeTicks::Now())))
+          .DeprecatedGetOriginAsURL();
+  if (!origin.is_valid()) {
+    return;
+  }
+
+  // The response is irrelevant; the socket it leaves in the pool is the
+  // point. No API key is sent.
+  auto resource_request = std::make_unique<network::ResourceRequest>();
+  resource_request->url = origin;
+  resource_request->method = "HEAD";
+  resource_request->credentials_mode = network::mojom::CredentialsMode::kOmit;
+
+  warm_up_loader_ = network::SimpleURLLoader::Create(
+      std::move(resource_request), network::SimpleURLLoader::BYPASS_CACHE);
+  warm_up_loader_->DownloadHeadersOnly(
+      url_loader_factory_.get(),
+      base::BindOnce(&GeminiHttpClient::OnWarmUpComplete,
+                     weak_ptr_factory_.GetWeakPtr()));
+  warm_up_start_ = base::TimeTicks::Now();
+  last_request_time_ = warm_up_start_;
+}
+
+void GeminiHttpClient::OnWarmUpComplete(
+    scoped_refptr<net::HttpResponseHeaders> headers) {
+  if (warm_up_loader_->NetError() != net::OK) {
+    DLOG(WARNING) << "Gemini connection warm-up failed: "
+                  << net::ErrorToString(warm_up_loader_->NetError());
+  }
+  RecordRoundTrip(headers.get(), base::TimeTicks::Now() - warm_up_start_);
+  // The first warm-up is the one startup waits on
+  if (asol::core::StartupTrace* trace = asol::core::StartupTrace::Get()) {
+    trace->AddPhaseOnce("connection_warmup", warm_up_start_,
+                        base::TimeTicks::Now());
+  }
+  warm_up_loader_.reset();
+}
+
+void GeminiHttpClient::OnKeepAliveTimer() {
+  if (base::TimeTicks::Now() - last_request_time_ < keep_alive_interval_) {
+    return;
+  }
+  SendWarmUpRequest();
+}
+
+void GeminiHttpClient::ProbeEndpoints() {
+  for (size_t i = 0; i < endpoints_->size(); ++i) {
+    GURL origin = GURL(endpoints_->endpoint(i)).DeprecatedGetOriginAsURL();
+    if (!origin.is_valid() || probe_loaders_.count(i)) {
+      continue;
+    }
+
+    // Like a warm-up, the probe also leaves a pooled socket behind, so a
+    // failover does not start with a handshake. No API key is sent.
+    auto resource_request = std::make_unique<network::ResourceRequest>();
+    resource_request->url = origin;
+    resource_request->method = "HEAD";
+    resource_request->credentials_mode =
+        network::mojom::CredentialsMode::kOmit;
+
+    std::unique_ptr<network::SimpleURLLoader>& loader = probe_loaders_[i];
+    loader = network::SimpleURLLoader::Create(
+        std::move(resource_request), network::SimpleURLLoader::BYPASS_CACHE);
+    loader->DownloadHeadersOnly(
+        url_loader_factory_.get(),
+        base::BindOnce(&GeminiHttpClient::OnProbeComplete,
+                       weak_ptr_factory_.GetWeakPtr(), i,
+                       base::TimeTicks::Now()));
+  }
+}
+
+void GeminiHttpClient::OnProbeComplete(
+    size_t endpoint_index,
+    base::TimeTicks start_time,
+    scoped_refptr<net::HttpResponseHeaders> headers) {
+  auto it = probe_loaders_.find(endpoint_index);
+  DCHECK(it != probe_loaders_.end());
+  std::unique_ptr<network::SimpleURLLoader> loader = std::move(it->second);
+  probe_loaders_.erase(it);
+
+  // Any HTTP status means the origin answered; only the time matters
+  base::TimeTicks now = base::TimeTicks::Now();
+  RecordRoundTrip(headers.get(), now - start_time);
+  if (headers) {
+    endpoints_->RecordRtt(endpoint_index, now - start_time);
+  } else {
+    DLOG(WARNING) << "Gemini endpoint probe of "
+                  << endpoints_->endpoint(endpoint_index) << " failed: "
+                  << net::ErrorToString(loader->NetError());
+    endpoints_->RecordFailure(endpoint_index, now);
+  }
+}
+
+void GeminiHttpClient::RecordRoundTrip(
+    const net::HttpResponseHeaders* headers,
+    base::TimeDelta rtt) {
+  if (!network_quality_estimator_) {
+    return;
+  }
+  if (headers) {
+    network_quality_estimator_->RecordRtt(rtt);
+  } else {
+    network_quality_estimator_->RecordFailure();
+  }
+}
+
+void GeminiHttpClient::RecordEndpointOutcome(
+    const std::string& endpoint,
+    const network::SimpleURLLoader& loader,
+    base::TimeDelta latency) {
+  // The endpoints may have been replaced while the request was in flight
+  size_t index = 0;
+  while (index < endpoints_->size() &&
+         endpoints_->endpoint(index) != endpoint) {
+    ++index;
+  }
+  if (index == endpoints_->size()) {
+    return;
+  }
+
+  const network::mojom::URLResponseHead* info = loader.ResponseInfo();
+  int response_code =
+      info && info->headers ? info->headers->response_code() : 0;
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (response_code == 0 || response_code >= 500) {
+    endpoints_->RecordFailure(index, now);
+  } else if (response_code == net::HTTP_OK) {
+    endpoints_->RecordSuccess(index, latency, now);
+  }
+}
+
+GURL GeminiHttpClient::CreateRequestUrl(size_t endpoint_index,
+                                        const std::string& model_name,
+                                        const char* method) {
+  std::string url_str = endpoints_->endpoint(endpoint_index);
+  if (!base::EndsWith(url_str, "/", base::CompareCase::SENSITIVE)) {
+    url_str += "/";
+  }
+  url_str += model_name + method;
+
+  GURL url(url_str);
+  if (!url.is_valid()) {
+    return GURL();
+  }
+
+  // Add the API key as a query parameter
+  return net::AppendQueryParameter(url, "key", api_key_);
+}
+
+void GeminiHttpClient::OnStreamingRequestComplete(StreamingRequest* request) {
+  auto it = streaming_requests_.find(request);
+  if (it != streaming_requests_.end()) {
+    streaming_requests_.erase(it);
+  }
+}
+
+}  // namespace gemini
+}  // namespace adapters
+}  // namespace asol
\ No newline at end of file
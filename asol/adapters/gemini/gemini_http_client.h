@@ -0,0 +1,233 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_ADAPTERS_GEMINI_GEMINI_HTTP_CLIENT_H_
+#define ASOL_ADAPTERS_GEMINI_GEMINI_HTTP_CLIENT_H_
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "asol/adapters/endpoint_selector.h"
+#include "asol/adapters/gemini/gemini_types.h"
+#include "asol/core/cancellation_token.h"
+#include "asol/core/network_quality_estimator.h"
+#include "asol/core/retry_policy.h"
+#include "asol/core/trace_context.h"
+#include "base/callback.h"
+#include "base/containers/unique_ptr_adapters.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "services/network/public/cpp/shared_url_loader_factory.h"
+#include "services/network/public/cpp/simple_url_loader.h"
+#include "third_party/nlohmann_json/json.hpp"
+
+namespace asol {
+namespace adapters {
+namespace gemini {
+
+// GeminiHttpClient handles HTTP communication with the Gemini API.
+class GeminiHttpClient {
+ public:
+  // Callback for asynchronous responses
+  using ResponseCallback = base::OnceCallback<void(const GeminiResponse&)>;
+
+  explicit GeminiHttpClient(
+      scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory);
+  ~GeminiHttpClient();
+
+  // Disable copy and assign
+  GeminiHttpClient(const GeminiHttpClient&) = delete;
+  GeminiHttpClient& operator=(const GeminiHttpClient&) = delete;
+
+  // Set the API key for authentication
+  void SetApiKey(const std::string& api_key);
+
+  // Set the API endpoint
+  void SetApiEndpoint(const std::string& api_endpoint);
+
+  // Serve the API from any of |api_endpoints|, e.g. regional deployments
+  // or proxies, most preferred first. With more than one, each endpoint's
+  // origin is probed every |probe_interval| to measure its RTT, and
+  // requests go to the fastest healthy one; see EndpointSelector. An
+  // endpoint that fails with a network error or 5xx is skipped for a while,
+  // and a retry fails over to the next one at once. Responses name the
+  // endpoint that served them in their "endpoint" metadata.
+  void SetApiEndpoints(std::vector<std::string> api_endpoints,
+                       base::TimeDelta probe_interval = base::Minutes(2));
+
+  // Latency and health of each endpoint
+  std::vector<EndpointSelector::EndpointStats> GetEndpointStats() const;
+
+  // Replace the default policy for retrying asynchronous requests
+  void SetRetryPolicy(const core::RetryPolicy::Config& policy);
+
+  // Charge retries to |budget| (not owned; must outlive this client), e.g.
+  // one shared browser-wide. By default the client has its own budget.
+  void SetRetryBudget(core::RetryBudget* budget);
+
+  // Report the connection to |estimator| (not owned; must outlive this
+  // client): the round trips of the HEADs sent to warm and probe origins,
+  // and the throughput of response bodies
+  void SetNetworkQualityEstimator(core::NetworkQualityEstimator* estimator);
+
+  // Send a request to the Gemini API synchronously
+  GeminiResponse SendRequest(const nlohmann::json& request_payload,
+                            const std::string& model_name);
+
+  // Send a request to the Gemini API asynchronously. Connection failures,
+  // resets, 5xx and 429 are retried with backoff while the retry budget
+  // allows. This is the only layer that retries Gemini requests, so the
+  // provider must not be wrapped in a core::RetryingProvider as well.
+  void SendRequestAsync(const nlohmann::json& request_payload,
+                       const std::string& model_name,
+                       ResponseCallback callback);
+
+  // Same, for a body that is already serialized JSON, e.g. one rendered
+  // from a PayloadTemplate. Cancelling |cancellation_token| (may be null)
+  // aborts the transfer and any pending retry; |callback| then gets
+  // core::kRequestCancelledError. Each attempt is traced as a span under
+  // |trace|, which the API receives as a traceparent header. No retry
+  // starts after |deadline| (null for none).
+  void SendRequestAsync(
+      std::string request_body,
+      const std::string& model_name,
+      scoped_refptr<core::CancellationToken> cancellation_token,
+      const core::TraceContext& trace,
+      base::TimeTicks deadline,
+      ResponseCallback callback);
+
+  // Send a streaming request to the Gemini API. |callback| receives each
+  // text delta as it is generated, then a final response with is_done set.
+  void SendStreamingRequest(const nlohmann::json& request_payload,
+                           const std::string& model_name,
+                           StreamingResponseCallback callback);
+
+  // Same, closing the stream when |cancellation_token| is cancelled. The
+  // final response then carries core::kRequestCancelledError.
+  void SendStreamingRequest(
+      const nlohmann::json& request_payload,
+      const std::string& model_name,
+      scoped_refptr<core::CancellationToken> cancellation_token,
+      StreamingResponseCallback callback);
+
+  // Open a connection to the API origin now, so the first request skips
+  // DNS, TCP and TLS setup, and keep it warm: whenever no request has gone
+  // out for |keep_alive_interval|, a HEAD to the origin reuses the pooled
+  // socket before the server drops it as idle.
+  void Preconnect(base::TimeDelta keep_alive_interval = base::Seconds(45));
+
+ private:
+  class StreamingRequest;
+  struct AsyncRequest;
+
+  // Process the response from the API
+  GeminiResponse ProcessResponse(const std::string& response_body);
+
+  // Send one attempt of asynchronous request |request_id|
+  void StartAsyncRequest(uint64_t request_id);
+
+  // Note when the response to the attempt of |request_id| started
+  void OnResponseStarted(uint64_t request_id,
+                         const GURL& final_url,
+                         const network::mojom::URLResponseHead& head);
+
+  // Handle the completion of an attempt
+  void OnRequestComplete(uint64_t request_id,
+                        std::unique_ptr<std::string> response_body);
+
+  // Abort request |request_id| and report the cancellation
+  void OnAsyncRequestCancelled(uint64_t request_id);
+
+  // Complete request |request_id| with |response|
+  void FinishAsyncRequest(uint64_t request_id, GeminiResponse response);
+
+  // Create a URL for calling |method| of |model_name| at endpoint
+  // |endpoint_index|
+  GURL CreateRequestUrl(size_t endpoint_index,
+                        const std::string& model_name,
+                        const char* method);
+
+  // Tell the endpoint selector how a request sent to |endpoint| went. Only
+  // network errors and 5xx count against the endpoint; |latency| is what a
+  // successful request is charged.
+  void RecordEndpointOutcome(const std::string& endpoint,
+                             const network::SimpleURLLoader& loader,
+                             base::TimeDelta latency);
+
+  // Report a HEAD to an origin to the network quality estimator: its round
+  // trip if |headers| came back, a transport failure otherwise
+  void RecordRoundTrip(const net::HttpResponseHeaders* headers,
+                       base::TimeDelta rtt);
+
+  // Drop a streaming request once it has reported completion
+  void OnStreamingRequestComplete(StreamingRequest* request);
+
+  // Close |request|'s stream and report the cancellation
+  void OnStreamingRequestCancelled(StreamingRequest* request);
+
+  // Send a HEAD to the API origin unless one is already in flight
+  void SendWarmUpRequest();
+  void OnWarmUpComplete(scoped_refptr<net::HttpResponseHeaders> headers);
+
+  // Ping the origin if it has been idle for |keep_alive_interval_|
+  void OnKeepAliveTimer();
+
+  // Send a HEAD to every endpoint's origin to measure its RTT
+  void ProbeEndpoints();
+  void OnProbeComplete(size_t endpoint_index,
+                       base::TimeTicks start_time,
+                       scoped_refptr<net::HttpResponseHeaders> headers);
+
+  // URL loader factory for making HTTP requests
+  scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
+
+  // API key for authentication
+  std::string api_key_;
+
+  // API endpoints and which one to use
+  std::unique_ptr<EndpointSelector> endpoints_;
+
+  // Retries of asynchronous requests
+  core::RetryPolicy retry_policy_;
+  core::RetryBudget own_retry_budget_;
+  core::RetryBudget* retry_budget_ = &own_retry_budget_;
+
+  core::NetworkQualityEstimator* network_quality_estimator_ = nullptr;
+
+  // Asynchronous requests in flight or waiting to be retried, keyed by an
+  // ID so a retry scheduled for a cancelled request finds nothing
+  std::unordered_map<uint64_t, std::unique_ptr<AsyncRequest>> async_requests_;
+  uint64_t next_async_request_id_ = 0;
+
+  // Streams in flight
+  std::set<std::unique_ptr<StreamingRequest>, base::UniquePtrComparator>
+      streaming_requests_;
+
+  // Connection warm-up state; see Preconnect()
+  std::unique_ptr<network::SimpleURLLoader> warm_up_loader_;
+  base::TimeTicks warm_up_start_;
+  base::RepeatingTimer keep_alive_timer_;
+  base::TimeDelta keep_alive_interval_;
+  base::TimeTicks last_request_time_;
+
+  // RTT probes in flight, by endpoint index
+  std::unordered_map<size_t, std::unique_ptr<network::SimpleURLLoader>>
+      probe_loaders_;
+  base::RepeatingTimer probe_timer_;
+
+  // For generating weak pointers to this
+  base::WeakPtrFactory<GeminiHttpClient> weak_ptr_factory_{this};
+};
+
+}  // namespace gemini
+}  // namespace adapters
+}  // namespace asol
+
+#endif  // ASOL_ADAPTERS_GEMINI_GEMINI_HTTP_CLIENT_H_
\ No newline at end of file
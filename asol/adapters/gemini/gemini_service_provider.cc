@@ -4,11 +4,15 @@
 
 #include "asol/adapters/gemini/gemini_service_provider.h"
 
+#include <algorithm>
 #include <utility>
 
+#include "asol/adapters/provider_token_counter.h"
 #include "base/logging.h"
+#include "base/strings/strcat.h"
 #include "base/strings/string_util.h"
 #include "asol/core/context_manager.h"
+#include "services/network/public/cpp/shared_url_loader_factory.h"
 
 namespace asol {
 namespace adapters {
@@ -107,9 +111,18 @@ core::AIServiceProvider::Capabilities GeminiServiceProvider::GetCapabilities() c
     "Korean", "Arabic", "Russian", "Portuguese", "Italian"
   };
   
+  const auto& request_config = gemini_adapter_->GetRequestConfig();
+  capabilities.max_input_tokens = GetMaxInputTokens(
+      request_config.model_name,
+      static_cast<size_t>(std::max(request_config.max_output_tokens, 0)));
+
   return capabilities;
 }
 
+const core::TokenCounter& GeminiServiceProvider::GetTokenCounter() const {
+  return ProviderTokenCounter::Get(ProviderTokenCounter::Family::kGemini);
+}
+
 bool GeminiServiceProvider::SupportsTaskType(TaskType task_type) const {
   switch (task_type) {
     case TaskType::TEXT_GENERATION:
@@ -198,6 +211,24 @@ void GeminiServiceProvider::Configure(
   DLOG(INFO) << "Gemini provider configured with model: " << adapter_config.model_name;
 }
 
+void GeminiServiceProvider::Preconnect() {
+  gemini_adapter_->Preconnect();
+}
+
+void GeminiServiceProvider::SetUrlLoaderFactory(
+    scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory) {
+  gemini_adapter_->SetUrlLoaderFactory(std::move(url_loader_factory));
+}
+
+void GeminiServiceProvider::SetRetryBudget(core::RetryBudget* budget) {
+  gemini_adapter_->SetRetryBudget(budget);
+}
+
+void GeminiServiceProvider::SetNetworkQualityEstimator(
+    core::NetworkQualityEstimator* estimator) {
+  gemini_adapter_->SetNetworkQualityEstimator(estimator);
+}
+
 std::unordered_map<std::string, std::string> GeminiServiceProvider::GetConfiguration() const {
   return config_;
 }
@@ -210,6 +241,9 @@ void GeminiServiceProvider::ProcessTextGeneration(
     // Simple text generation without context
     gemini_adapter_->ProcessText(
         params.input_text,
+        params.cancellation_token,
+        params.trace,
+        params.deadline,
         base::BindOnce(&GeminiServiceProvider::OnGeminiResponse,
                       weak_ptr_factory_.GetWeakPtr(),
                       std::move(callback)));
@@ -222,9 +256,11 @@ void GeminiServiceProvider::ProcessTextGeneration(
     std::vector<GeminiMessage> messages;
     
     // Add system message
+    const std::string system_prompt =
+        CreateSystemPromptForTask(params.task_type, params.custom_params);
     GeminiMessage system_message;
     system_message.role = GeminiMessage::Role::SYSTEM;
-    system_message.content = CreateSystemPromptForTask(params.task_type, params.custom_params);
+    system_message.content = system_prompt;
     messages.push_back(system_message);
     
     // Add user message
@@ -236,6 +272,9 @@ void GeminiServiceProvider::ProcessTextGeneration(
     // Process the conversation
     gemini_adapter_->ProcessConversation(
         messages,
+        params.cancellation_token,
+        params.trace,
+        params.deadline,
         base::BindOnce(&GeminiServiceProvider::OnGeminiResponse,
                       weak_ptr_factory_.GetWeakPtr(),
                       std::move(callback)));
@@ -248,11 +287,14 @@ void GeminiServiceProvider::ProcessTextSummarization(
   
   // Create a prompt for summarization
   std::string prompt = CreateSystemPromptForTask(params.task_type, params.custom_params);
-  prompt += "\n\n" + params.input_text;
+  base::StrAppend(&prompt, {"\n\n", params.input_text});
   
   // Process the summarization request
   gemini_adapter_->ProcessText(
       prompt,
+      params.cancellation_token,
+      params.trace,
+      params.deadline,
       base::BindOnce(&GeminiServiceProvider::OnGeminiResponse,
                     weak_ptr_factory_.GetWeakPtr(),
                     std::move(callback)));
@@ -264,11 +306,14 @@ void GeminiServiceProvider::ProcessContentAnalysis(
   
   // Create a prompt for content analysis
   std::string prompt = CreateSystemPromptForTask(params.task_type, params.custom_params);
-  prompt += "\n\n" + params.input_text;
+  base::StrAppend(&prompt, {"\n\n", params.input_text});
   
   // Process the content analysis request
   gemini_adapter_->ProcessText(
       prompt,
+      params.cancellation_token,
+      params.trace,
+      params.deadline,
       base::BindOnce(&GeminiServiceProvider::OnGeminiResponse,
                     weak_ptr_factory_.GetWeakPtr(),
                     std::move(callback)));
@@ -281,10 +326,13 @@ void GeminiServiceProvider::ProcessQuestionAnswering(
   if (params.context_id.empty()) {
     // Simple question answering without context
     std::string prompt = CreateSystemPromptForTask(params.task_type, params.custom_params);
-    prompt += "\n\nQuestion: " + params.input_text;
+    base::StrAppend(&prompt, {"\n\nQuestion: ", params.input_text});
     
     gemini_adapter_->ProcessText(
         prompt,
+        params.cancellation_token,
+        params.trace,
+        params.deadline,
         base::BindOnce(&GeminiServiceProvider::OnGeminiResponse,
                       weak_ptr_factory_.GetWeakPtr(),
                       std::move(callback)));
@@ -297,9 +345,11 @@ void GeminiServiceProvider::ProcessQuestionAnswering(
     std::vector<GeminiMessage> messages;
     
     // Add system message
+    const std::string system_prompt =
+        CreateSystemPromptForTask(params.task_type, params.custom_params);
     GeminiMessage system_message;
     system_message.role = GeminiMessage::Role::SYSTEM;
-    system_message.content = CreateSystemPromptForTask(params.task_type, params.custom_params);
+    system_message.content = system_prompt;
     messages.push_back(system_message);
     
     // Add user message
@@ -311,6 +361,9 @@ void GeminiServiceProvider::ProcessQuestionAnswering(
     // Process the conversation
     gemini_adapter_->ProcessConversation(
         messages,
+        params.cancellation_token,
+        params.trace,
+        params.deadline,
         base::BindOnce(&GeminiServiceProvider::OnGeminiResponse,
                       weak_ptr_factory_.GetWeakPtr(),
                       std::move(callback)));
@@ -323,7 +376,7 @@ void GeminiServiceProvider::ProcessCodeGeneration(
   
   // Create a prompt for code generation
   std::string prompt = CreateSystemPromptForTask(params.task_type, params.custom_params);
-  prompt += "\n\n" + params.input_text;
+  base::StrAppend(&prompt, {"\n\n", params.input_text});
   
   // Add language specification if provided
   auto it = params.custom_params.find("language");
@@ -334,6 +387,9 @@ void GeminiServiceProvider::ProcessCodeGeneration(
   // Process the code generation request
   gemini_adapter_->ProcessText(
       prompt,
+      params.cancellation_token,
+      params.trace,
+      params.deadline,
       base::BindOnce(&GeminiServiceProvider::OnGeminiResponse,
                     weak_ptr_factory_.GetWeakPtr(),
                     std::move(callback)));
@@ -345,11 +401,14 @@ void GeminiServiceProvider::ProcessTranslation(
   
   // Create a prompt for translation
   std::string prompt = CreateSystemPromptForTask(params.task_type, params.custom_params);
-  prompt += "\n\n" + params.input_text;
+  base::StrAppend(&prompt, {"\n\n", params.input_text});
   
   // Process the translation request
   gemini_adapter_->ProcessText(
       prompt,
+      params.cancellation_token,
+      params.trace,
+      params.deadline,
       base::BindOnce(&GeminiServiceProvider::OnGeminiResponse,
                     weak_ptr_factory_.GetWeakPtr(),
                     std::move(callback)));
@@ -377,7 +436,7 @@ std::vector<GeminiMessage> GeminiServiceProvider::ConvertToGeminiMessages(
         break;
     }
     
-    gemini_message.content = message.content;
+    gemini_message.content = message.content();
     gemini_messages.push_back(gemini_message);
   }
   
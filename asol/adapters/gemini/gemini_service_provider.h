@@ -11,6 +11,7 @@
 
 #include "asol/adapters/gemini/gemini_text_adapter.h"
 #include "asol/core/ai_service_provider.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 
 namespace asol {
@@ -29,12 +30,27 @@ class GeminiServiceProvider : public core::AIServiceProvider {
   std::string GetProviderName() const override;
   std::string GetProviderVersion() const override;
   Capabilities GetCapabilities() const override;
+  const core::TokenCounter& GetTokenCounter() const override;
   bool SupportsTaskType(TaskType task_type) const override;
   void ProcessRequest(const AIRequestParams& params, 
                     AIResponseCallback callback) override;
+  void Preconnect() override;
   void Configure(const std::unordered_map<std::string, std::string>& config) override;
   std::unordered_map<std::string, std::string> GetConfiguration() const override;
 
+  // Send requests over the network instead of simulating them; see
+  // GeminiTextAdapter::SetUrlLoaderFactory()
+  void SetUrlLoaderFactory(
+      scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory);
+
+  // Charge retries to |budget| (not owned; must outlive this provider),
+  // e.g. one shared browser-wide
+  void SetRetryBudget(core::RetryBudget* budget);
+
+  // Report the connection to |estimator| (not owned; must outlive this
+  // provider)
+  void SetNetworkQualityEstimator(core::NetworkQualityEstimator* estimator);
+
  private:
   // Helper methods for processing different task types
   void ProcessTextGeneration(const AIRequestParams& params, 
@@ -6,12 +6,17 @@
 
 #include <utility>
 
+#include "asol/adapters/gemini/gemini_http_client.h"
+#include "asol/adapters/gemini/gemini_types.h"
+#include "asol/adapters/json_field_reader.h"
+#include "asol/adapters/payload_template.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/task/sequenced_task_runner.h"
-#include "base/task/thread_pool.h"
+#include "services/network/public/cpp/shared_url_loader_factory.h"
 #include "third_party/nlohmann_json/json.hpp"
 
 namespace asol {
@@ -20,25 +25,28 @@ namespace gemini {
 
 namespace {
 // Constants for Gemini API
+constexpr char kGeminiApiOrigin[] = "https://generativelanguage.googleapis.com";
 constexpr char kGeminiApiEndpoint[] = "https://generativelanguage.googleapis.com/v1beta/models/";
 constexpr char kGenerateContentMethod[] = ":generateContent";
 constexpr char kApiKeyParam[] = "key=";
 
 // Helper function to truncate text for logging
-std::string TruncateForLogging(const std::string& text, size_t max_length = 50) {
+std::string TruncateForLogging(std::string_view text, size_t max_length = 50) {
   if (text.length() <= max_length)
-    return text;
-  return text.substr(0, max_length) + "...";
+    return std::string(text);
+  return std::string(text.substr(0, max_length)) + "...";
 }
 
 }  // namespace
 
 GeminiTextAdapter::GeminiTextAdapter() : config_() {
+  UpdatePayloadTemplates();
   LOG(INFO) << "GeminiTextAdapter initialized with default configuration.";
 }
 
 GeminiTextAdapter::GeminiTextAdapter(const std::string& api_key) 
     : api_key_(api_key), config_() {
+  UpdatePayloadTemplates();
   LOG(INFO) << "GeminiTextAdapter initialized with provided API key.";
 }
 
@@ -47,32 +55,55 @@ GeminiTextAdapter::~GeminiTextAdapter() {
 }
 
 void GeminiTextAdapter::ProcessText(
-    const std::string& text_input,
+    std::string_view text_input,
+    GeminiResponseCallback callback) {
+  ProcessText(text_input, nullptr, core::TraceContext(), base::TimeTicks(),
+              std::move(callback));
+}
+
+void GeminiTextAdapter::ProcessText(
+    std::string_view text_input,
+    scoped_refptr<core::CancellationToken> cancellation_token,
+    const core::TraceContext& trace,
+    base::TimeTicks deadline,
     GeminiResponseCallback callback) {
   DLOG(INFO) << "Processing text with Gemini Adapter: " 
              << TruncateForLogging(text_input);
   
   // Build the request payload for a single text prompt
-  nlohmann::json payload = BuildRequestPayload(text_input);
+  std::string payload = BuildRequestPayload(text_input);
   
   // Send the request to the Gemini API
-  SendRequest(payload, std::move(callback));
+  SendRequest(std::move(payload), std::move(cancellation_token), trace,
+              deadline, std::move(callback));
 }
 
 void GeminiTextAdapter::ProcessConversation(
     const std::vector<GeminiMessage>& messages,
     GeminiResponseCallback callback) {
+  ProcessConversation(messages, nullptr, core::TraceContext(),
+                      base::TimeTicks(), std::move(callback));
+}
+
+void GeminiTextAdapter::ProcessConversation(
+    const std::vector<GeminiMessage>& messages,
+    scoped_refptr<core::CancellationToken> cancellation_token,
+    const core::TraceContext& trace,
+    base::TimeTicks deadline,
+    GeminiResponseCallback callback) {
   DLOG(INFO) << "Processing conversation with " << messages.size() << " messages";
   
   // Build the request payload for a conversation
-  nlohmann::json payload = BuildConversationPayload(messages);
+  std::string payload = BuildConversationPayload(messages);
   
   // Send the request to the Gemini API
-  SendRequest(payload, std::move(callback));
+  SendRequest(std::move(payload), std::move(cancellation_token), trace,
+              deadline, std::move(callback));
 }
 
 void GeminiTextAdapter::SetRequestConfig(const GeminiRequestConfig& config) {
   config_ = config;
+  UpdatePayloadTemplates();
   DLOG(INFO) << "Updated Gemini request configuration. Model: " 
              << config_.model_name;
 }
@@ -83,27 +114,45 @@ const GeminiRequestConfig& GeminiTextAdapter::GetRequestConfig() const {
 
 void GeminiTextAdapter::SetApiKey(const std::string& api_key) {
   api_key_ = api_key;
+  if (http_client_) {
+    http_client_->SetApiKey(api_key_);
+  }
   DLOG(INFO) << "Updated API key.";
 }
 
-nlohmann::json GeminiTextAdapter::BuildRequestPayload(
-    const std::string& text_input) const {
+void GeminiTextAdapter::SetUrlLoaderFactory(
+    scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory) {
+  http_client_ =
+      std::make_unique<GeminiHttpClient>(std::move(url_loader_factory));
+  http_client_->SetApiKey(api_key_);
+  if (retry_budget_) {
+    http_client_->SetRetryBudget(retry_budget_);
+  }
+  http_client_->SetNetworkQualityEstimator(network_quality_estimator_);
+}
+
+void GeminiTextAdapter::SetRetryBudget(core::RetryBudget* budget) {
+  retry_budget_ = budget;
+  if (http_client_) {
+    http_client_->SetRetryBudget(retry_budget_);
+  }
+}
+
+void GeminiTextAdapter::SetNetworkQualityEstimator(
+    core::NetworkQualityEstimator* estimator) {
+  network_quality_estimator_ = estimator;
+  if (http_client_) {
+    http_client_->SetNetworkQualityEstimator(network_quality_estimator_);
+  }
+}
+
+const core::PromptCacheStats& GeminiTextAdapter::GetPromptCacheStats() const {
+  return prompt_cache_stats_;
+}
+
+void GeminiTextAdapter::UpdatePayloadTemplates() {
   nlohmann::json payload;
   
-  // Add the content parts
-  nlohmann::json content;
-  nlohmann::json text_part;
-  text_part["text"] = text_input;
-  
-  nlohmann::json parts = nlohmann::json::array();
-  parts.push_back(text_part);
-  
-  content["parts"] = parts;
-  content["role"] = "user";
-  
-  // Add the content to the main payload
-  payload["contents"] = nlohmann::json::array({content});
-  
   // Add generation configuration
   nlohmann::json generation_config;
   generation_config["temperature"] = config_.temperature;
@@ -113,40 +162,42 @@ nlohmann::json GeminiTextAdapter::BuildRequestPayload(
   
   payload["generationConfig"] = generation_config;
   
-  return payload;
+  // Conversations splice in a pre-rendered contents array
+  payload["contents"] = PayloadTemplate::RawSlot(0);
+  conversation_template_ = PayloadTemplate(payload);
+  
+  // A single user turn with one text part
+  payload["contents"] = nlohmann::json::array({
+    {{"parts", nlohmann::json::array({{{"text", PayloadTemplate::TextSlot(0)}}})},
+     {"role", "user"}}
+  });
+  text_template_ = PayloadTemplate(payload);
+  
+  message_template_ = PayloadTemplate(nlohmann::json{
+    {"role", PayloadTemplate::TextSlot(0)},
+    {"parts", nlohmann::json::array({{{"text", PayloadTemplate::TextSlot(1)}}})}
+  });
+}
+
+std::string GeminiTextAdapter::BuildRequestPayload(
+    std::string_view text_input) const {
+  return text_template_.Render({text_input});
 }
 
-nlohmann::json GeminiTextAdapter::BuildConversationPayload(
+std::string GeminiTextAdapter::BuildConversationPayload(
     const std::vector<GeminiMessage>& messages) const {
-  nlohmann::json payload;
-  nlohmann::json contents = nlohmann::json::array();
-  
   // Convert each message to the format expected by Gemini API
+  std::string contents = "[";
   for (const auto& message : messages) {
-    nlohmann::json content;
-    content["role"] = RoleToString(message.role);
-    
-    nlohmann::json parts = nlohmann::json::array();
-    nlohmann::json text_part;
-    text_part["text"] = message.content;
-    parts.push_back(text_part);
-    
-    content["parts"] = parts;
-    contents.push_back(content);
+    if (contents.size() > 1) {
+      contents += ',';
+    }
+    message_template_.RenderTo({RoleToString(message.role), message.content},
+                               &contents);
   }
+  contents += ']';
   
-  payload["contents"] = contents;
-  
-  // Add generation configuration
-  nlohmann::json generation_config;
-  generation_config["temperature"] = config_.temperature;
-  generation_config["maxOutputTokens"] = config_.max_output_tokens;
-  generation_config["topP"] = config_.top_p;
-  generation_config["topK"] = config_.top_k;
-  
-  payload["generationConfig"] = generation_config;
-  
-  return payload;
+  return conversation_template_.Render({contents});
 }
 
 std::string GeminiTextAdapter::RoleToString(GeminiMessage::Role role) const {
@@ -163,14 +214,35 @@ std::string GeminiTextAdapter::RoleToString(GeminiMessage::Role role) const {
   }
 }
 
+void GeminiTextAdapter::Preconnect() {
+  if (http_client_) {
+    http_client_->Preconnect();
+    return;
+  }
+  // Requests are simulated (see SendRequest()), so there is no socket pool
+  // to warm
+  DLOG(INFO) << "Would preconnect to: " << kGeminiApiOrigin;
+}
+
 void GeminiTextAdapter::SendRequest(
-    const nlohmann::json& payload,
+    std::string payload,
+    scoped_refptr<core::CancellationToken> cancellation_token,
+    const core::TraceContext& trace,
+    base::TimeTicks deadline,
     GeminiResponseCallback callback) {
+  if (http_client_) {
+    http_client_->SendRequestAsync(
+        std::move(payload), config_.model_name, std::move(cancellation_token),
+        trace, deadline,
+        base::BindOnce(&GeminiTextAdapter::OnHttpResponse,
+                       weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
+    return;
+  }
+
   // In a real implementation, this would use network services to send an HTTP request
   // For now, we'll simulate a response
   
-  std::string json_str = payload.dump(2);
-  DLOG(INFO) << "Gemini API Request payload: " << TruncateForLogging(json_str, 100);
+  DLOG(INFO) << "Gemini API Request payload: " << TruncateForLogging(payload, 100);
   
   // Construct the API URL (would be used in actual implementation)
   std::string api_url = std::string(kGeminiApiEndpoint) + 
@@ -180,12 +252,13 @@ void GeminiTextAdapter::SendRequest(
   
   DLOG(INFO) << "Would send request to: " << api_url;
   
-  // Simulate async processing
-  base::ThreadPool::PostDelayedTask(
+  // Simulate async processing. The reply comes back on this sequence, which
+  // owns the adapter's WeakPtrs and the cancellation token.
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
       FROM_HERE,
-      {base::TaskPriority::BEST_EFFORT},
       base::BindOnce(&GeminiTextAdapter::HandleResponse,
                     weak_ptr_factory_.GetWeakPtr(),
+                    std::move(cancellation_token),
                     // Simulate a response - in real implementation this would be the API response
                     R"({
                       "candidates": [{
@@ -204,35 +277,26 @@ void GeminiTextAdapter::SendRequest(
 }
 
 void GeminiTextAdapter::HandleResponse(
+    scoped_refptr<core::CancellationToken> cancellation_token,
     const std::string& response_data,
     GeminiResponseCallback callback) {
+  // The simulated request cannot be aborted mid-flight, only discarded
+  if (cancellation_token && cancellation_token->IsCancelled()) {
+    std::move(callback).Run(false, core::kRequestCancelledError);
+    return;
+  }
+
   DLOG(INFO) << "Handling Gemini API response: " 
              << TruncateForLogging(response_data, 100);
   
   bool success = true;
   std::string result_text;
   
-  try {
-    // Parse the JSON response
-    nlohmann::json response = nlohmann::json::parse(response_data);
-    
-    // Extract the response text
-    if (response.contains("candidates") && 
-        !response["candidates"].empty() && 
-        response["candidates"][0].contains("content") &&
-        response["candidates"][0]["content"].contains("parts") &&
-        !response["candidates"][0]["content"]["parts"].empty() &&
-        response["candidates"][0]["content"]["parts"][0].contains("text")) {
-      
-      result_text = response["candidates"][0]["content"]["parts"][0]["text"];
-    } else {
-      success = false;
-      result_text = "Failed to parse response: unexpected format";
-      LOG(ERROR) << result_text;
-    }
-  } catch (const std::exception& e) {
+  // Read only the fields we need instead of building a DOM
+  JsonFieldReader reader(response_data);
+  if (!reader.GetString({"candidates", 0, "content", "parts", 0, "text"}, &result_text)) {
     success = false;
-    result_text = "Failed to parse response: " + std::string(e.what());
+    result_text = "Failed to parse response: unexpected format";
     LOG(ERROR) << result_text;
   }
   
@@ -240,6 +304,28 @@ void GeminiTextAdapter::HandleResponse(
   std::move(callback).Run(success, result_text);
 }
 
+void GeminiTextAdapter::OnHttpResponse(GeminiResponseCallback callback,
+                                       const GeminiResponse& response) {
+  if (!response.success) {
+    std::move(callback).Run(false, response.error_message);
+    return;
+  }
+
+  int64_t prompt_tokens = -1;
+  int64_t cached_tokens = 0;
+  for (const auto& [key, value] : response.metadata) {
+    if (key == "prompt_tokens") {
+      base::StringToInt64(value, &prompt_tokens);
+    } else if (key == "cached_prompt_tokens") {
+      base::StringToInt64(value, &cached_tokens);
+    }
+  }
+  if (prompt_tokens >= 0) {
+    prompt_cache_stats_.Record(prompt_tokens, cached_tokens);
+  }
+  std::move(callback).Run(true, response.text);
+}
+
 }  // namespace gemini
 }  // namespace adapters
 }  // namespace asol
@@ -8,16 +8,35 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "asol/adapters/payload_template.h"
+#include "asol/core/cancellation_token.h"
+#include "asol/core/prompt_cache.h"
+#include "asol/core/trace_context.h"
 #include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "third_party/nlohmann_json/json.hpp"
 
+namespace network {
+class SharedURLLoaderFactory;
+}  // namespace network
+
 namespace asol {
+namespace core {
+class NetworkQualityEstimator;
+class RetryBudget;
+}  // namespace core
+
 namespace adapters {
 namespace gemini {
 
+class GeminiHttpClient;
+struct GeminiResponse;
+
 // Represents a message in a conversation with Gemini
 struct GeminiMessage {
   enum class Role {
@@ -27,7 +46,10 @@ struct GeminiMessage {
   };
 
   Role role;
-  std::string content;
+  // Must outlive the call the message is passed to, which builds the
+  // request before returning; conversations can then point into shared
+  // context history instead of copying it
+  std::string_view content;
 };
 
 // Represents configuration options for Gemini API requests
@@ -54,11 +76,30 @@ class GeminiTextAdapter {
   GeminiTextAdapter& operator=(const GeminiTextAdapter&) = delete;
 
   // Process a single text prompt and get a response
-  void ProcessText(const std::string& text_input, GeminiResponseCallback callback);
+  void ProcessText(std::string_view text_input, GeminiResponseCallback callback);
+
+  // Same, abandoning the request when |cancellation_token| (may be null) is
+  // cancelled; |callback| then gets core::kRequestCancelledError. The HTTP
+  // attempts are traced as spans under |trace|, and none is retried after
+  // |deadline| (null for none).
+  void ProcessText(std::string_view text_input,
+                   scoped_refptr<core::CancellationToken> cancellation_token,
+                   const core::TraceContext& trace,
+                   base::TimeTicks deadline,
+                   GeminiResponseCallback callback);
   
   // Process a conversation with multiple messages
   void ProcessConversation(const std::vector<GeminiMessage>& messages,
                           GeminiResponseCallback callback);
+
+  // Same, with a cancellation token, trace and deadline as for
+  // ProcessText()
+  void ProcessConversation(
+      const std::vector<GeminiMessage>& messages,
+      scoped_refptr<core::CancellationToken> cancellation_token,
+      const core::TraceContext& trace,
+      base::TimeTicks deadline,
+      GeminiResponseCallback callback);
   
   // Configure the adapter with specific settings
   void SetRequestConfig(const GeminiRequestConfig& config);
@@ -69,26 +110,73 @@ class GeminiTextAdapter {
   // Set API key (for runtime configuration)
   void SetApiKey(const std::string& api_key);
 
+  // Send requests over the network through a GeminiHttpClient, which
+  // pools connections and retries transient failures. Until this is called
+  // responses are simulated.
+  void SetUrlLoaderFactory(
+      scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory);
+
+  // Charge the client's retries to |budget| (not owned; must outlive this
+  // adapter); see GeminiHttpClient::SetRetryBudget()
+  void SetRetryBudget(core::RetryBudget* budget);
+
+  // Report the connection to |estimator| (not owned; must outlive this
+  // adapter); see GeminiHttpClient::SetNetworkQualityEstimator()
+  void SetNetworkQualityEstimator(core::NetworkQualityEstimator* estimator);
+
+  // Warm the connection to the Gemini API origin before the first request
+  void Preconnect();
+
+  // Input tokens read from the prompt cache so far. Gemini caches repeated
+  // prompt prefixes implicitly, so hits depend only on callers putting
+  // stable text first.
+  const core::PromptCacheStats& GetPromptCacheStats() const;
+
  private:
+  // Rebuild the request templates from |config_|
+  void UpdatePayloadTemplates();
+
   // Helper methods for API interaction
-  nlohmann::json BuildRequestPayload(const std::string& text_input) const;
-  nlohmann::json BuildConversationPayload(
+  std::string BuildRequestPayload(std::string_view text_input) const;
+  std::string BuildConversationPayload(
       const std::vector<GeminiMessage>& messages) const;
   
   // Convert message role enum to string for API
   std::string RoleToString(GeminiMessage::Role role) const;
   
   // Send request to Gemini API
-  void SendRequest(const nlohmann::json& payload, GeminiResponseCallback callback);
+  void SendRequest(std::string payload,
+                   scoped_refptr<core::CancellationToken> cancellation_token,
+                   const core::TraceContext& trace,
+                   base::TimeTicks deadline,
+                   GeminiResponseCallback callback);
   
   // Parse API response
-  void HandleResponse(const std::string& response_data, 
+  void HandleResponse(scoped_refptr<core::CancellationToken> cancellation_token,
+                     const std::string& response_data,
                      GeminiResponseCallback callback);
 
+  // Adapt a GeminiHttpClient response to GeminiResponseCallback
+  void OnHttpResponse(GeminiResponseCallback callback,
+                      const GeminiResponse& response);
+
   // Private members
   std::string api_key_;
   GeminiRequestConfig config_;
   
+  // Request bodies pre-serialized for |config_|
+  PayloadTemplate text_template_;
+  PayloadTemplate conversation_template_;
+  PayloadTemplate message_template_;
+
+  core::PromptCacheStats prompt_cache_stats_;
+
+  // Shared transport; null while requests are simulated
+  std::unique_ptr<GeminiHttpClient> http_client_;
+  // Handed to |http_client_|; null for the client's own
+  core::RetryBudget* retry_budget_ = nullptr;
+  core::NetworkQualityEstimator* network_quality_estimator_ = nullptr;
+  
   // For async operations and callbacks
   base::WeakPtrFactory<GeminiTextAdapter> weak_ptr_factory_{this};
 };
@@ -50,6 +50,11 @@ struct GeminiConfig {
   
   // API endpoint URL
   std::string api_endpoint = "https://generativelanguage.googleapis.com/v1beta/models/";
+
+  // More endpoints serving the same API, e.g. regional deployments or
+  // proxies. Requests go to the fastest healthy one of these and
+  // |api_endpoint|.
+  std::vector<std::string> regional_endpoints;
 };
 
 }  // namespace gemini
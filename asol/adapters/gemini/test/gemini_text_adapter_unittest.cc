@@ -159,7 +159,8 @@ TEST_F(GeminiTextAdapterTest, ProcessConversation) {
 
 // Test request payload building for single text
 TEST_F(GeminiTextAdapterTest, BuildRequestPayload) {
-  nlohmann::json payload = adapter_->BuildRequestPayload("Test prompt");
+  nlohmann::json payload =
+      nlohmann::json::parse(adapter_->BuildRequestPayload("Test prompt"));
   
   EXPECT_TRUE(payload.contains("contents"));
   EXPECT_TRUE(payload.contains("generationConfig"));
@@ -202,7 +203,8 @@ TEST_F(GeminiTextAdapterTest, BuildConversationPayload) {
   messages.push_back(system_message);
   messages.push_back(user_message);
   
-  nlohmann::json payload = adapter_->BuildConversationPayload(messages);
+  nlohmann::json payload =
+      nlohmann::json::parse(adapter_->BuildConversationPayload(messages));
   
   EXPECT_TRUE(payload.contains("contents"));
   EXPECT_TRUE(payload.contains("generationConfig"));
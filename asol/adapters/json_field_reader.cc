@@ -0,0 +1,264 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/json_field_reader.h"
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/strings/utf_string_conversion_utils.h"
+
+namespace asol {
+namespace adapters {
+
+namespace {
+
+constexpr uint32_t kReplacementCharacter = 0xFFFD;
+
+bool IsJsonWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+size_t SkipWhitespace(std::string_view json, size_t pos) {
+  while (pos < json.size() && IsJsonWhitespace(json[pos])) {
+    pos++;
+  }
+  return pos;
+}
+
+// Index of the quote closing the string whose contents start at |pos|
+size_t FindStringEnd(std::string_view json, size_t pos) {
+  while (pos < json.size()) {
+    if (json[pos] == '\\') {
+      pos += 2;
+    } else if (json[pos] == '"') {
+      return pos;
+    } else {
+      pos++;
+    }
+  }
+  return std::string_view::npos;
+}
+
+// Index just past the value starting at |pos|
+size_t SkipValue(std::string_view json, size_t pos) {
+  if (pos >= json.size()) {
+    return std::string_view::npos;
+  }
+
+  char first = json[pos];
+  if (first == '"') {
+    size_t end = FindStringEnd(json, pos + 1);
+    return end == std::string_view::npos ? end : end + 1;
+  }
+
+  if (first == '{' || first == '[') {
+    // Only brackets and strings matter when skipping a container
+    size_t depth = 0;
+    for (size_t i = pos; i < json.size(); ++i) {
+      char c = json[i];
+      if (c == '"') {
+        i = FindStringEnd(json, i + 1);
+        if (i == std::string_view::npos) {
+          return i;
+        }
+      } else if (c == '{' || c == '[') {
+        depth++;
+      } else if (c == '}' || c == ']') {
+        if (--depth == 0) {
+          return i + 1;
+        }
+      }
+    }
+    return std::string_view::npos;
+  }
+
+  // Number, true, false or null
+  size_t end = pos;
+  while (end < json.size() && json[end] != ',' && json[end] != '}' &&
+         json[end] != ']' && !IsJsonWhitespace(json[end])) {
+    end++;
+  }
+  return end;
+}
+
+// Position of the next member or element after the value ending at |pos|,
+// or npos at the end of the container
+size_t NextItem(std::string_view json, size_t pos) {
+  if (pos == std::string_view::npos) {
+    return pos;
+  }
+  pos = SkipWhitespace(json, pos);
+  if (pos >= json.size() || json[pos] != ',') {
+    return std::string_view::npos;
+  }
+  return SkipWhitespace(json, pos + 1);
+}
+
+bool ReadHex4(std::string_view text, size_t pos, uint32_t* value) {
+  if (pos + 4 > text.size()) {
+    return false;
+  }
+  uint32_t result = 0;
+  for (size_t i = pos; i < pos + 4; ++i) {
+    if (!base::IsHexDigit(text[i])) {
+      return false;
+    }
+    result = (result << 4) | base::HexDigitToInt(text[i]);
+  }
+  *value = result;
+  return true;
+}
+
+}  // namespace
+
+bool JsonFieldReader::GetString(JsonPath path, std::string* value) const {
+  std::string_view raw;
+  if (!FindValue(path, &raw) || raw.size() < 2 || raw.front() != '"') {
+    return false;
+  }
+  raw = raw.substr(1, raw.size() - 2);
+  if (raw.find('\\') == std::string_view::npos) {
+    value->assign(raw);
+    return true;
+  }
+  return DecodeString(raw, value);
+}
+
+bool JsonFieldReader::GetInt(JsonPath path, int64_t* value) const {
+  std::string_view raw;
+  return FindValue(path, &raw) && base::StringToInt64(raw, value);
+}
+
+bool JsonFieldReader::Has(JsonPath path) const {
+  std::string_view raw;
+  return FindValue(path, &raw);
+}
+
+// static
+bool JsonFieldReader::DecodeString(std::string_view raw, std::string* out) {
+  out->clear();
+  out->reserve(raw.size());
+  for (size_t i = 0; i < raw.size(); ++i) {
+    if (raw[i] != '\\') {
+      out->push_back(raw[i]);
+      continue;
+    }
+    if (++i >= raw.size()) {
+      return false;
+    }
+    switch (raw[i]) {
+      case '"':
+      case '\\':
+      case '/':
+        out->push_back(raw[i]);
+        break;
+      case 'b':
+        out->push_back('\b');
+        break;
+      case 'f':
+        out->push_back('\f');
+        break;
+      case 'n':
+        out->push_back('\n');
+        break;
+      case 'r':
+        out->push_back('\r');
+        break;
+      case 't':
+        out->push_back('\t');
+        break;
+      case 'u': {
+        uint32_t code_point = 0;
+        if (!ReadHex4(raw, i + 1, &code_point)) {
+          return false;
+        }
+        i += 4;
+        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+          // Combine a surrogate pair split across two escapes
+          uint32_t low = 0;
+          if (i + 2 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u' &&
+              ReadHex4(raw, i + 3, &low) && low >= 0xDC00 && low <= 0xDFFF) {
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) +
+                         (low - 0xDC00);
+            i += 6;
+          } else {
+            code_point = kReplacementCharacter;
+          }
+        } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+          code_point = kReplacementCharacter;
+        }
+        base::WriteUnicodeCharacter(static_cast<base_icu::UChar32>(code_point),
+                                    out);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+
+bool JsonFieldReader::FindValue(JsonPath path, std::string_view* value) const {
+  size_t pos = SkipWhitespace(json_, 0);
+  for (const JsonPathElement& step : path) {
+    if (pos >= json_.size()) {
+      return false;
+    }
+
+    if (step.is_index) {
+      if (json_[pos] != '[') {
+        return false;
+      }
+      pos = SkipWhitespace(json_, pos + 1);
+      if (pos >= json_.size() || json_[pos] == ']') {
+        return false;
+      }
+      for (size_t i = 0; i < step.index; ++i) {
+        pos = NextItem(json_, SkipValue(json_, pos));
+        if (pos == std::string_view::npos) {
+          return false;
+        }
+      }
+      continue;
+    }
+
+    if (json_[pos] != '{') {
+      return false;
+    }
+    pos = SkipWhitespace(json_, pos + 1);
+    while (true) {
+      if (pos >= json_.size() || json_[pos] != '"') {
+        return false;
+      }
+      size_t key_end = FindStringEnd(json_, pos + 1);
+      if (key_end == std::string_view::npos) {
+        return false;
+      }
+      std::string_view key = json_.substr(pos + 1, key_end - pos - 1);
+      pos = SkipWhitespace(json_, key_end + 1);
+      if (pos >= json_.size() || json_[pos] != ':') {
+        return false;
+      }
+      pos = SkipWhitespace(json_, pos + 1);
+      if (key == step.key) {
+        break;
+      }
+      pos = NextItem(json_, SkipValue(json_, pos));
+      if (pos == std::string_view::npos) {
+        return false;
+      }
+    }
+  }
+
+  size_t end = SkipValue(json_, pos);
+  if (end == std::string_view::npos || end == pos) {
+    return false;
+  }
+  *value = json_.substr(pos, end - pos);
+  return true;
+}
+
+}  // namespace adapters
+}  // namespace asol
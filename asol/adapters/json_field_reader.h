@@ -0,0 +1,65 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_ADAPTERS_JSON_FIELD_READER_H_
+#define ASOL_ADAPTERS_JSON_FIELD_READER_H_
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+namespace asol {
+namespace adapters {
+
+// One step of a JSON path: an object key or an array index.
+// {"candidates", 0, "content", "parts", 0, "text"} names
+// candidates[0].content.parts[0].text.
+struct JsonPathElement {
+  JsonPathElement(const char* key) : key(key) {}  // NOLINT
+  JsonPathElement(int index)                      // NOLINT
+      : index(static_cast<size_t>(index)), is_index(true) {}
+
+  std::string_view key;
+  size_t index = 0;
+  bool is_index = false;
+};
+
+using JsonPath = std::initializer_list<JsonPathElement>;
+
+// JsonFieldReader pulls individual fields out of a JSON document on demand,
+// without building a DOM. A lookup walks only the containers on its path
+// and skips sibling values by scanning for their closing bracket, so
+// reading a completion's text and token counts costs one partial pass over
+// the body and no allocation beyond the decoded result.
+//
+// Skipped values are not validated; callers that need to reject malformed
+// documents must use a full parser.
+class JsonFieldReader {
+ public:
+  explicit JsonFieldReader(std::string_view json) : json_(json) {}
+
+  // The string at |path|, unescaped into |value|
+  bool GetString(JsonPath path, std::string* value) const;
+
+  // The integer at |path|
+  bool GetInt(JsonPath path, int64_t* value) const;
+
+  // Whether any value exists at |path|
+  bool Has(JsonPath path) const;
+
+  // Decode the contents of a JSON string literal (without its quotes)
+  static bool DecodeString(std::string_view raw, std::string* out);
+
+ private:
+  // Raw text of the value at |path|, including quotes for strings
+  bool FindValue(JsonPath path, std::string_view* value) const;
+
+  const std::string_view json_;
+};
+
+}  // namespace adapters
+}  // namespace asol
+
+#endif  // ASOL_ADAPTERS_JSON_FIELD_READER_H_
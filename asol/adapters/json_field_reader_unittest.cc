@@ -0,0 +1,96 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/json_field_reader.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/nlohmann_json/json.hpp"
+
+namespace asol {
+namespace adapters {
+namespace {
+
+constexpr char kGeminiResponse[] = R"({
+  "candidates": [{
+    "content": {
+      "parts": [{"text": "Hello \"world\"\nbye"}],
+      "role": "model"
+    },
+    "safetyRatings": [{"category": "HARM", "note": "{[\"}"}]
+  }],
+  "usage": {"promptTokenCount": 12, "totalTokenCount": 40}
+})";
+
+TEST(JsonFieldReaderTest, ReadsNestedFields) {
+  JsonFieldReader reader(kGeminiResponse);
+
+  std::string text;
+  ASSERT_TRUE(reader.GetString(
+      {"candidates", 0, "content", "parts", 0, "text"}, &text));
+  EXPECT_EQ(text, "Hello \"world\"\nbye");
+
+  std::string role;
+  ASSERT_TRUE(reader.GetString({"candidates", 0, "content", "role"}, &role));
+  EXPECT_EQ(role, "model");
+
+  int64_t tokens = 0;
+  ASSERT_TRUE(reader.GetInt({"usage", "totalTokenCount"}, &tokens));
+  EXPECT_EQ(tokens, 40);
+}
+
+TEST(JsonFieldReaderTest, SkipsSiblingsAndIndexesArrays) {
+  JsonFieldReader reader(
+      R"({"skip": {"a": [1, "]", {"b": null}]}, "list": [true, "x", {"c": "y"}]})");
+
+  std::string value;
+  ASSERT_TRUE(reader.GetString({"list", 2, "c"}, &value));
+  EXPECT_EQ(value, "y");
+  ASSERT_TRUE(reader.GetString({"list", 1}, &value));
+  EXPECT_EQ(value, "x");
+  EXPECT_TRUE(reader.Has({"list", 0}));
+  EXPECT_FALSE(reader.Has({"list", 3}));
+}
+
+TEST(JsonFieldReaderTest, ReportsMissingOrMistypedFields) {
+  JsonFieldReader reader(R"({"error": {"code": 429, "message": "slow"}})");
+
+  std::string text;
+  EXPECT_FALSE(reader.GetString({"candidates", 0, "text"}, &text));
+  EXPECT_FALSE(reader.GetString({"error", "code"}, &text));
+  int64_t code = 0;
+  EXPECT_FALSE(reader.GetInt({"error", "message"}, &code));
+  EXPECT_TRUE(reader.GetInt({"error", "code"}, &code));
+  EXPECT_EQ(code, 429);
+
+  EXPECT_FALSE(JsonFieldReader("{\"a\": \"unterminated").Has({"a"}));
+  EXPECT_FALSE(JsonFieldReader("").Has({"a"}));
+}
+
+TEST(JsonFieldReaderTest, MatchesDomParseOnLargeResponse) {
+  // A long completion plus bulky metadata the adapters never read
+  std::string completion(256 * 1024, 'a');
+  std::string ratings;
+  for (int i = 0; i < 2000; ++i) {
+    ratings += std::string(i ? "," : "") +
+               R"({"category": "HARM_CATEGORY", "probability": "NEGLIGIBLE"})";
+  }
+  std::string body = R"({"candidates": [{"safetyRatings": [)" + ratings +
+                     R"(], "content": {"parts": [{"text": ")" + completion +
+                     R"("}]}}], "usage": {"totalTokenCount": 65536}})";
+
+  nlohmann::json json = nlohmann::json::parse(body);
+  std::string dom_text = json["candidates"][0]["content"]["parts"][0]["text"];
+
+  std::string reader_text;
+  JsonFieldReader reader(body);
+  ASSERT_TRUE(reader.GetString({"candidates", 0, "content", "parts", 0, "text"},
+                               &reader_text));
+  EXPECT_EQ(reader_text, dom_text);
+}
+
+}  // namespace
+}  // namespace adapters
+}  // namespace asol
@@ -0,0 +1,220 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/mock/mock_response_model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+
+namespace asol {
+namespace adapters {
+namespace mock {
+
+namespace {
+
+// Configuration keys
+constexpr char kConfigKeyLatencyDistribution[] = "latency_distribution";
+constexpr char kConfigKeyLatencyMs[] = "latency_ms";
+constexpr char kConfigKeyLatencyP99Ms[] = "latency_p99_ms";
+constexpr char kConfigKeyLatencyMinMs[] = "latency_min_ms";
+constexpr char kConfigKeyLatencyMaxMs[] = "latency_max_ms";
+constexpr char kConfigKeyChunkBytes[] = "chunk_bytes";
+constexpr char kConfigKeyChunkIntervalMs[] = "chunk_interval_ms";
+constexpr char kConfigKeyChunkJitterMs[] = "chunk_jitter_ms";
+constexpr char kConfigKeyResponseBytesMin[] = "response_bytes_min";
+constexpr char kConfigKeyResponseBytesMax[] = "response_bytes_max";
+constexpr char kConfigKeyErrorRate[] = "error_rate";
+constexpr char kConfigKeyErrorMessage[] = "error_message";
+constexpr char kConfigKeySeed[] = "seed";
+
+// z-score of the 99th percentile of the standard normal distribution
+constexpr double kP99ZScore = 2.3263;
+
+// Words the responses are made of
+constexpr const char* kWords[] = {
+    "the",     "page",    "describes", "a",       "summary", "of",
+    "recent",  "results", "and",       "their",   "key",     "points",
+    "with",    "several", "examples",  "that",    "show",    "how",
+    "browser", "users",   "read",      "content", "quickly", "today",
+};
+
+void ReadMilliseconds(const std::unordered_map<std::string, std::string>& config,
+                      const char* key,
+                      base::TimeDelta* value) {
+  auto it = config.find(key);
+  if (it == config.end()) {
+    return;
+  }
+  int64_t milliseconds = 0;
+  if (!base::StringToInt64(it->second, &milliseconds) || milliseconds < 0) {
+    LOG(ERROR) << "Invalid mock " << key << ": " << it->second;
+    return;
+  }
+  *value = base::Milliseconds(milliseconds);
+}
+
+void ReadSize(const std::unordered_map<std::string, std::string>& config,
+              const char* key,
+              size_t* value) {
+  auto it = config.find(key);
+  if (it == config.end()) {
+    return;
+  }
+  size_t size = 0;
+  if (!base::StringToSizeT(it->second, &size)) {
+    LOG(ERROR) << "Invalid mock " << key << ": " << it->second;
+    return;
+  }
+  *value = size;
+}
+
+}  // namespace
+
+void MockProfile::ApplyConfig(
+    const std::unordered_map<std::string, std::string>& config) {
+  auto it = config.find(kConfigKeyLatencyDistribution);
+  if (it != config.end()) {
+    if (it->second == "fixed") {
+      latency_distribution = LatencyDistribution::kFixed;
+    } else if (it->second == "uniform") {
+      latency_distribution = LatencyDistribution::kUniform;
+    } else if (it->second == "lognormal") {
+      latency_distribution = LatencyDistribution::kLogNormal;
+    } else {
+      LOG(ERROR) << "Unknown mock latency distribution: " << it->second;
+    }
+  }
+
+  ReadMilliseconds(config, kConfigKeyLatencyMs, &latency_median);
+  ReadMilliseconds(config, kConfigKeyLatencyP99Ms, &latency_p99);
+  ReadMilliseconds(config, kConfigKeyLatencyMinMs, &latency_min);
+  ReadMilliseconds(config, kConfigKeyLatencyMaxMs, &latency_max);
+  ReadSize(config, kConfigKeyChunkBytes, &chunk_bytes);
+  ReadMilliseconds(config, kConfigKeyChunkIntervalMs, &chunk_interval);
+  ReadMilliseconds(config, kConfigKeyChunkJitterMs, &chunk_jitter);
+  ReadSize(config, kConfigKeyResponseBytesMin, &response_bytes_min);
+  ReadSize(config, kConfigKeyResponseBytesMax, &response_bytes_max);
+
+  it = config.find(kConfigKeyErrorRate);
+  if (it != config.end()) {
+    double rate = 0.0;
+    if (base::StringToDouble(it->second, &rate) && rate >= 0.0 && rate <= 1.0) {
+      error_rate = rate;
+    } else {
+      LOG(ERROR) << "Invalid mock error_rate: " << it->second;
+    }
+  }
+
+  it = config.find(kConfigKeyErrorMessage);
+  if (it != config.end() && !it->second.empty()) {
+    error_message = it->second;
+  }
+
+  it = config.find(kConfigKeySeed);
+  if (it != config.end()) {
+    unsigned seed_value = 0;
+    if (base::StringToUint(it->second, &seed_value)) {
+      seed = seed_value;
+    } else {
+      LOG(ERROR) << "Invalid mock seed: " << it->second;
+    }
+  }
+}
+
+MockResponseModel::MockResponseModel(const MockProfile& profile)
+    : profile_(profile), random_(profile.seed) {}
+
+MockResponseModel::~MockResponseModel() = default;
+
+void MockResponseModel::SetProfile(const MockProfile& profile) {
+  profile_ = profile;
+  random_.seed(profile.seed);
+}
+
+MockOutcome MockResponseModel::NextOutcome() {
+  // Always draw the same values in the same order, so changing the error
+  // rate does not shift the latencies of the calls that succeed
+  MockOutcome outcome;
+  outcome.latency = NextLatency();
+  double failure_draw = std::uniform_real_distribution<double>(0.0, 1.0)(random_);
+  std::string text = NextResponseText();
+
+  outcome.success = failure_draw >= profile_.error_rate;
+  outcome.text = outcome.success ? std::move(text) : profile_.error_message;
+  return outcome;
+}
+
+base::TimeDelta MockResponseModel::NextChunkDelay() {
+  int64_t jitter_us = profile_.chunk_jitter.InMicroseconds();
+  int64_t offset_us =
+      jitter_us > 0
+          ? std::uniform_int_distribution<int64_t>(-jitter_us, jitter_us)(random_)
+          : 0;
+  return std::max(base::TimeDelta(),
+                  profile_.chunk_interval + base::Microseconds(offset_us));
+}
+
+std::vector<std::string> MockResponseModel::SplitIntoChunks(
+    const std::string& text) const {
+  std::vector<std::string> chunks;
+  size_t chunk_bytes = std::max<size_t>(1, profile_.chunk_bytes);
+  for (size_t offset = 0; offset < text.size(); offset += chunk_bytes) {
+    chunks.push_back(text.substr(offset, chunk_bytes));
+  }
+  return chunks;
+}
+
+base::TimeDelta MockResponseModel::NextLatency() {
+  switch (profile_.latency_distribution) {
+    case MockProfile::LatencyDistribution::kFixed:
+      return profile_.latency_median;
+    case MockProfile::LatencyDistribution::kUniform: {
+      int64_t min_us = profile_.latency_min.InMicroseconds();
+      int64_t max_us = std::max(min_us, profile_.latency_max.InMicroseconds());
+      return base::Microseconds(
+          std::uniform_int_distribution<int64_t>(min_us, max_us)(random_));
+    }
+    case MockProfile::LatencyDistribution::kLogNormal: {
+      double median_ms = profile_.latency_median.InMillisecondsF();
+      double p99_ms = profile_.latency_p99.InMillisecondsF();
+      if (median_ms <= 0.0) {
+        return base::TimeDelta();
+      }
+      double sigma =
+          p99_ms > median_ms ? std::log(p99_ms / median_ms) / kP99ZScore : 0.0;
+      std::lognormal_distribution<double> distribution(std::log(median_ms),
+                                                       sigma);
+      return base::Milliseconds(distribution(random_));
+    }
+  }
+  return profile_.latency_median;
+}
+
+std::string MockResponseModel::NextResponseText() {
+  size_t max_bytes =
+      std::max(profile_.response_bytes_min, profile_.response_bytes_max);
+  size_t length = std::uniform_int_distribution<size_t>(
+      profile_.response_bytes_min, max_bytes)(random_);
+
+  std::string text;
+  text.reserve(length + 16);
+  std::uniform_int_distribution<size_t> word(0, std::size(kWords) - 1);
+  while (text.size() < length) {
+    if (!text.empty()) {
+      text += ' ';
+    }
+    text += kWords[word(random_)];
+  }
+  text.resize(length);
+  return text;
+}
+
+}  // namespace mock
+}  // namespace adapters
+}  // namespace asol
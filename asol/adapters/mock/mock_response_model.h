@@ -0,0 +1,108 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_ADAPTERS_MOCK_MOCK_RESPONSE_MODEL_H_
+#define ASOL_ADAPTERS_MOCK_MOCK_RESPONSE_MODEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/time/time.h"
+
+namespace asol {
+namespace adapters {
+namespace mock {
+
+// How a mock provider behaves. The defaults resemble a fast hosted model.
+struct MockProfile {
+  enum class LatencyDistribution { kFixed, kUniform, kLogNormal };
+
+  // Time to the complete response, or to the first chunk of a stream.
+  // kFixed: every call takes |latency_median|. kUniform: drawn from
+  // [|latency_min|, |latency_max|]. kLogNormal: heavy-tailed like real
+  // providers, with the given median and 99th percentile.
+  LatencyDistribution latency_distribution = LatencyDistribution::kLogNormal;
+  base::TimeDelta latency_median = base::Milliseconds(400);
+  base::TimeDelta latency_p99 = base::Milliseconds(2000);
+  base::TimeDelta latency_min = base::Milliseconds(200);
+  base::TimeDelta latency_max = base::Milliseconds(800);
+
+  // Streams send |chunk_bytes| at a time, |chunk_interval| apart after the
+  // first chunk, each interval off by up to |chunk_jitter| either way
+  size_t chunk_bytes = 16;
+  base::TimeDelta chunk_interval = base::Milliseconds(20);
+  base::TimeDelta chunk_jitter = base::Milliseconds(5);
+
+  // Response length, drawn uniformly
+  size_t response_bytes_min = 200;
+  size_t response_bytes_max = 1200;
+
+  // Share of calls that fail with |error_message| after the drawn latency.
+  // The default message is one the retry policy treats as transient.
+  double error_rate = 0.0;
+  std::string error_message = "HTTP error: 503";
+
+  // Seeds the draws: the same seed and call order give the same outcomes
+  uint32_t seed = 1;
+
+  // Update the fields named in |config|, as passed to Configure():
+  // "latency_distribution" ("fixed", "uniform" or "lognormal"),
+  // "latency_ms", "latency_p99_ms", "latency_min_ms", "latency_max_ms",
+  // "chunk_bytes", "chunk_interval_ms", "chunk_jitter_ms",
+  // "response_bytes_min", "response_bytes_max", "error_rate",
+  // "error_message" and "seed". Other keys are ignored; invalid values are
+  // logged and leave their field unchanged.
+  void ApplyConfig(const std::unordered_map<std::string, std::string>& config);
+};
+
+// Outcome of one simulated call
+struct MockOutcome {
+  bool success = false;
+  // To the complete response, or to the first chunk of a stream
+  base::TimeDelta latency;
+  // The response, or the error message
+  std::string text;
+};
+
+// Draws call outcomes from a MockProfile with a seeded generator, so a
+// benchmark run can be repeated exactly. Not thread-safe.
+class MockResponseModel {
+ public:
+  explicit MockResponseModel(const MockProfile& profile);
+  ~MockResponseModel();
+
+  MockResponseModel(const MockResponseModel&) = delete;
+  MockResponseModel& operator=(const MockResponseModel&) = delete;
+
+  const MockProfile& profile() const { return profile_; }
+
+  // Replace the profile and reseed from it.
+  void SetProfile(const MockProfile& profile);
+
+  // The outcome of the next call.
+  MockOutcome NextOutcome();
+
+  // The wait before the next stream chunk after the first.
+  base::TimeDelta NextChunkDelay();
+
+  // |text| in pieces of the profile's chunk size.
+  std::vector<std::string> SplitIntoChunks(const std::string& text) const;
+
+ private:
+  base::TimeDelta NextLatency();
+  std::string NextResponseText();
+
+  MockProfile profile_;
+  std::mt19937 random_;
+};
+
+}  // namespace mock
+}  // namespace adapters
+}  // namespace asol
+
+#endif  // ASOL_ADAPTERS_MOCK_MOCK_RESPONSE_MODEL_H_
@@ -0,0 +1,151 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/mock/mock_service_provider.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "asol/core/cancellation_token.h"
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/task/sequenced_task_runner.h"
+
+namespace asol {
+namespace adapters {
+namespace mock {
+
+namespace {
+// Constants for the mock provider
+constexpr char kDefaultProviderId[] = "mock";
+constexpr char kProviderName[] = "Mock Provider";
+constexpr char kProviderVersion[] = "1.0.0";
+
+// Error of a request whose deadline passed first, as the network stack
+// reports a timed-out transfer
+constexpr char kTimedOutError[] = "Network error: ERR_TIMED_OUT";
+}  // namespace
+
+MockServiceProvider::PendingRequest::PendingRequest() = default;
+MockServiceProvider::PendingRequest::PendingRequest(PendingRequest&&) = default;
+MockServiceProvider::PendingRequest&
+MockServiceProvider::PendingRequest::operator=(PendingRequest&&) = default;
+MockServiceProvider::PendingRequest::~PendingRequest() = default;
+
+MockServiceProvider::MockServiceProvider()
+    : MockServiceProvider(kDefaultProviderId) {}
+
+MockServiceProvider::MockServiceProvider(const std::string& provider_id)
+    : provider_id_(provider_id), model_(MockProfile()) {
+  DLOG(INFO) << "MockServiceProvider created as " << provider_id_;
+}
+
+MockServiceProvider::~MockServiceProvider() = default;
+
+std::string MockServiceProvider::GetProviderId() const {
+  return provider_id_;
+}
+
+std::string MockServiceProvider::GetProviderName() const {
+  return kProviderName;
+}
+
+std::string MockServiceProvider::GetProviderVersion() const {
+  return kProviderVersion;
+}
+
+core::AIServiceProvider::Capabilities MockServiceProvider::GetCapabilities()
+    const {
+  Capabilities capabilities;
+  capabilities.supports_text_generation = true;
+  capabilities.supports_text_summarization = true;
+  capabilities.supports_content_analysis = true;
+  capabilities.supports_code_generation = true;
+  capabilities.supports_question_answering = true;
+  capabilities.supports_translation = true;
+  capabilities.supports_context = true;
+  capabilities.supported_languages = {"en", "es", "fr", "de", "ja", "zh"};
+  return capabilities;
+}
+
+bool MockServiceProvider::SupportsTaskType(TaskType task_type) const {
+  return task_type != TaskType::IMAGE_ANALYSIS &&
+         task_type != TaskType::CUSTOM;
+}
+
+void MockServiceProvider::ProcessRequest(const AIRequestParams& params,
+                                         AIResponseCallback callback) {
+  const scoped_refptr<core::CancellationToken>& token =
+      params.cancellation_token;
+  if (token && token->IsCancelled()) {
+    std::move(callback).Run(false, core::kRequestCancelledError);
+    return;
+  }
+  if (!SupportsTaskType(params.task_type)) {
+    std::move(callback).Run(false, "Unsupported task type for mock provider");
+    return;
+  }
+
+  MockOutcome outcome = model_.NextOutcome();
+  base::TimeDelta delay = outcome.latency;
+  if (!params.deadline.is_null()) {
+    base::TimeDelta time_left = params.deadline - base::TimeTicks::Now();
+    if (delay > time_left) {
+      delay = std::max(base::TimeDelta(), time_left);
+      outcome.success = false;
+      outcome.text = kTimedOutError;
+    }
+  }
+
+  uint64_t request_id = next_request_id_++;
+  PendingRequest& pending = pending_[request_id];
+  pending.callback = std::move(callback);
+  if (token) {
+    pending.cancel_subscription = token->AddCancelCallback(base::BindOnce(
+        &MockServiceProvider::CompleteRequest, weak_ptr_factory_.GetWeakPtr(),
+        request_id, false, std::string(core::kRequestCancelledError)));
+  }
+
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&MockServiceProvider::CompleteRequest,
+                     weak_ptr_factory_.GetWeakPtr(), request_id,
+                     outcome.success, std::move(outcome.text)),
+      delay);
+}
+
+void MockServiceProvider::Configure(
+    const std::unordered_map<std::string, std::string>& config) {
+  for (const auto& [key, value] : config) {
+    config_[key] = value;
+  }
+
+  MockProfile profile = model_.profile();
+  profile.ApplyConfig(config);
+  model_.SetProfile(profile);
+
+  LOG(INFO) << "MockServiceProvider " << provider_id_
+            << " configuration updated.";
+}
+
+std::unordered_map<std::string, std::string>
+MockServiceProvider::GetConfiguration() const {
+  return config_;
+}
+
+void MockServiceProvider::CompleteRequest(uint64_t request_id,
+                                          bool success,
+                                          const std::string& response) {
+  auto it = pending_.find(request_id);
+  if (it == pending_.end()) {
+    return;  // Cancelled, or answered before the cancellation
+  }
+  AIResponseCallback callback = std::move(it->second.callback);
+  pending_.erase(it);
+  std::move(callback).Run(success, response);
+}
+
+}  // namespace mock
+}  // namespace adapters
+}  // namespace asol
@@ -0,0 +1,90 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_ADAPTERS_MOCK_MOCK_SERVICE_PROVIDER_H_
+#define ASOL_ADAPTERS_MOCK_MOCK_SERVICE_PROVIDER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include "asol/adapters/mock/mock_response_model.h"
+#include "asol/core/ai_service_provider.h"
+#include "base/callback_list.h"
+#include "base/memory/weak_ptr.h"
+
+namespace asol {
+namespace adapters {
+namespace mock {
+
+// MockServiceProvider stands in for a hosted provider in benchmarks: it
+// answers every text task after a latency drawn from its MockProfile, with
+// a response of the drawn size or the profile's error, and never touches
+// the network. With a fixed seed a run can be repeated exactly, so the
+// caching, routing and rate limiting layers above it can be measured
+// without the noise and cost of the real providers.
+//
+// Requests whose deadline comes before the drawn latency fail at the
+// deadline, and cancelled requests complete right away with
+// core::kRequestCancelledError, as the real providers do. Responses are
+// posted to the current sequence, which must not change.
+class MockServiceProvider : public core::AIServiceProvider {
+ public:
+  MockServiceProvider();
+  // Answers under |provider_id|, e.g. "gemini" to stand in for it.
+  explicit MockServiceProvider(const std::string& provider_id);
+  ~MockServiceProvider() override;
+
+  // AIServiceProvider implementation
+  std::string GetProviderId() const override;
+  std::string GetProviderName() const override;
+  std::string GetProviderVersion() const override;
+  Capabilities GetCapabilities() const override;
+  bool SupportsTaskType(TaskType task_type) const override;
+  void ProcessRequest(const AIRequestParams& params,
+                      AIResponseCallback callback) override;
+  // Takes the MockProfile keys; see MockProfile::ApplyConfig(). Reseeds,
+  // so a reconfigured provider repeats its outcomes from the start.
+  void Configure(const std::unordered_map<std::string, std::string>& config) override;
+  std::unordered_map<std::string, std::string> GetConfiguration() const override;
+
+  const MockProfile& profile() const { return model_.profile(); }
+
+  // Requests sent and not yet answered
+  size_t pending_requests() const { return pending_.size(); }
+
+ private:
+  struct PendingRequest {
+    PendingRequest();
+    PendingRequest(PendingRequest&&);
+    PendingRequest& operator=(PendingRequest&&);
+    ~PendingRequest();
+
+    AIResponseCallback callback;
+    // Answers early when the request's token is cancelled
+    base::CallbackListSubscription cancel_subscription;
+  };
+
+  // Answer request |request_id| unless it already was.
+  void CompleteRequest(uint64_t request_id,
+                       bool success,
+                       const std::string& response);
+
+  const std::string provider_id_;
+  MockResponseModel model_;
+  std::unordered_map<std::string, std::string> config_;
+
+  uint64_t next_request_id_ = 0;
+  std::map<uint64_t, PendingRequest> pending_;
+
+  base::WeakPtrFactory<MockServiceProvider> weak_ptr_factory_{this};
+};
+
+}  // namespace mock
+}  // namespace adapters
+}  // namespace asol
+
+#endif  // ASOL_ADAPTERS_MOCK_MOCK_SERVICE_PROVIDER_H_
@@ -0,0 +1,158 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/mock/mock_text_adapter.h"
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/threading/platform_thread.h"
+#include "third_party/nlohmann_json/json.hpp"
+
+namespace asol {
+namespace adapters {
+namespace mock {
+
+MockTextAdapter::StreamState::StreamState() = default;
+MockTextAdapter::StreamState::~StreamState() = default;
+
+MockTextAdapter::MockTextAdapter() : MockTextAdapter(MockProfile()) {}
+
+MockTextAdapter::MockTextAdapter(const MockProfile& profile)
+    : model_(profile) {}
+
+MockTextAdapter::~MockTextAdapter() = default;
+
+ModelResponse MockTextAdapter::ProcessText(const std::string& text_input) {
+  MockOutcome outcome = model_.NextOutcome();
+  base::PlatformThread::Sleep(outcome.latency);
+  return ToResponse(std::move(outcome));
+}
+
+void MockTextAdapter::ProcessTextAsync(const std::string& text_input,
+                                       ResponseCallback callback) {
+  MockOutcome outcome = model_.NextOutcome();
+  base::TimeDelta latency = outcome.latency;
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](ResponseCallback callback, const ModelResponse& response) {
+            callback(response);
+          },
+          std::move(callback), ToResponse(std::move(outcome))),
+      latency);
+}
+
+void MockTextAdapter::ProcessTextStream(const std::string& text_input,
+                                        StreamingResponseCallback callback) {
+  MockOutcome outcome = model_.NextOutcome();
+  base::TimeDelta latency = outcome.latency;
+
+  if (!outcome.success) {
+    base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+        FROM_HERE,
+        base::BindOnce(
+            [](StreamingResponseCallback callback,
+               const ModelResponse& response) { callback(response, true); },
+            std::move(callback), ToResponse(std::move(outcome))),
+        latency);
+    return;
+  }
+
+  auto stream = std::make_unique<StreamState>();
+  stream->chunks = model_.SplitIntoChunks(outcome.text);
+  stream->callback = std::move(callback);
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&MockTextAdapter::DeliverChunk,
+                     weak_ptr_factory_.GetWeakPtr(), std::move(stream)),
+      latency);
+}
+
+std::string MockTextAdapter::GetName() const {
+  return "Mock";
+}
+
+std::vector<std::string> MockTextAdapter::GetCapabilities() const {
+  return {"text-generation", "summarization", "question-answering",
+          "translation"};
+}
+
+bool MockTextAdapter::IsReady() const {
+  return true;
+}
+
+bool MockTextAdapter::Initialize(const std::string& config_json) {
+  try {
+    auto json_config = nlohmann::json::parse(config_json);
+    if (!json_config.is_object()) {
+      LOG(ERROR) << "Mock adapter configuration must be a JSON object";
+      return false;
+    }
+
+    std::unordered_map<std::string, std::string> config;
+    for (const auto& [key, value] : json_config.items()) {
+      config[key] = value.is_string() ? value.get<std::string>() : value.dump();
+    }
+
+    MockProfile profile = model_.profile();
+    profile.ApplyConfig(config);
+    model_.SetProfile(profile);
+    return true;
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to parse configuration: " << e.what();
+    return false;
+  }
+}
+
+bool MockTextAdapter::SupportsStreaming() const {
+  return true;
+}
+
+void MockTextAdapter::DeliverChunk(std::unique_ptr<StreamState> stream) {
+  ModelResponse response;
+  response.success = true;
+  bool is_done = stream->next_chunk + 1 >= stream->chunks.size();
+  if (stream->next_chunk < stream->chunks.size()) {
+    response.text = std::move(stream->chunks[stream->next_chunk]);
+  }
+  response.is_partial = !is_done;
+  stream->next_chunk++;
+
+  // The callback may destroy the adapter, so touch no member after it
+  base::TimeDelta delay = is_done ? base::TimeDelta() : model_.NextChunkDelay();
+  base::WeakPtr<MockTextAdapter> weak_this = weak_ptr_factory_.GetWeakPtr();
+  stream->callback(response, is_done);
+  if (is_done) {
+    return;
+  }
+
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&MockTextAdapter::DeliverChunk, std::move(weak_this),
+                     std::move(stream)),
+      delay);
+}
+
+// static
+ModelResponse MockTextAdapter::ToResponse(MockOutcome outcome) {
+  ModelResponse response;
+  response.success = outcome.success;
+  if (outcome.success) {
+    response.text = std::move(outcome.text);
+  } else {
+    response.error_message = std::move(outcome.text);
+  }
+  response.metadata.emplace_back(
+      "mock_latency_ms", std::to_string(outcome.latency.InMilliseconds()));
+  return response;
+}
+
+}  // namespace mock
+}  // namespace adapters
+}  // namespace asol
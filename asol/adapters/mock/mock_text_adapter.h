@@ -0,0 +1,73 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_ADAPTERS_MOCK_MOCK_TEXT_ADAPTER_H_
+#define ASOL_ADAPTERS_MOCK_MOCK_TEXT_ADAPTER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "asol/adapters/adapter_interface.h"
+#include "asol/adapters/mock/mock_response_model.h"
+#include "base/memory/weak_ptr.h"
+
+namespace asol {
+namespace adapters {
+namespace mock {
+
+// MockTextAdapter is the AdapterInterface counterpart of
+// MockServiceProvider, for benchmarking core::ServiceManager and its
+// response caches. Streams deliver the first chunk after the drawn latency
+// and the rest at the profile's chunk cadence; the last chunk comes with
+// |is_done| set. Asynchronous and streamed responses are posted to the
+// current sequence; ProcessText() blocks for the drawn latency, as a
+// blocking network call would.
+class MockTextAdapter : public AdapterInterface {
+ public:
+  MockTextAdapter();
+  explicit MockTextAdapter(const MockProfile& profile);
+  ~MockTextAdapter() override;
+
+  // AdapterInterface implementation
+  ModelResponse ProcessText(const std::string& text_input) override;
+  void ProcessTextAsync(const std::string& text_input,
+                        ResponseCallback callback) override;
+  void ProcessTextStream(const std::string& text_input,
+                         StreamingResponseCallback callback) override;
+  std::string GetName() const override;
+  std::vector<std::string> GetCapabilities() const override;
+  bool IsReady() const override;
+  // Takes a JSON object with the MockProfile keys, as strings or numbers.
+  bool Initialize(const std::string& config_json) override;
+  bool SupportsStreaming() const override;
+
+  const MockProfile& profile() const { return model_.profile(); }
+
+ private:
+  // Chunks of a stream still to deliver
+  struct StreamState {
+    StreamState();
+    ~StreamState();
+
+    std::vector<std::string> chunks;
+    size_t next_chunk = 0;
+    StreamingResponseCallback callback;
+  };
+
+  // Deliver the next chunk of |stream| and schedule the one after.
+  void DeliverChunk(std::unique_ptr<StreamState> stream);
+
+  static ModelResponse ToResponse(MockOutcome outcome);
+
+  MockResponseModel model_;
+
+  base::WeakPtrFactory<MockTextAdapter> weak_ptr_factory_{this};
+};
+
+}  // namespace mock
+}  // namespace adapters
+}  // namespace asol
+
+#endif  // ASOL_ADAPTERS_MOCK_MOCK_TEXT_ADAPTER_H_
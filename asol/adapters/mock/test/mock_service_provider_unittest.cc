@@ -0,0 +1,211 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/mock/mock_service_provider.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asol/adapters/mock/mock_response_model.h"
+#include "asol/adapters/mock/mock_text_adapter.h"
+#include "asol/core/cancellation_token.h"
+#include "base/functional/bind.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace adapters {
+namespace mock {
+namespace {
+
+using Result = std::pair<bool, std::string>;
+
+class MockServiceProviderTest : public testing::Test {
+ protected:
+  void Send(const core::AIServiceProvider::AIRequestParams& params) {
+    provider_.ProcessRequest(
+        params, base::BindOnce(
+                    [](std::vector<Result>* results, bool success,
+                       const std::string& response) {
+                      results->emplace_back(success, response);
+                    },
+                    &results_));
+  }
+
+  void Send() {
+    core::AIServiceProvider::AIRequestParams params;
+    params.task_type = core::AIServiceProvider::TaskType::TEXT_SUMMARIZATION;
+    params.input_text = "page text";
+    Send(params);
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  MockServiceProvider provider_{"gemini"};
+  std::vector<Result> results_;
+};
+
+TEST(MockResponseModelTest, SameSeedGivesSameOutcomes) {
+  MockProfile profile;
+  profile.error_rate = 0.3;
+  MockResponseModel first(profile);
+  MockResponseModel second(profile);
+
+  for (int i = 0; i < 20; ++i) {
+    MockOutcome a = first.NextOutcome();
+    MockOutcome b = second.NextOutcome();
+    EXPECT_EQ(a.success, b.success);
+    EXPECT_EQ(a.latency, b.latency);
+    EXPECT_EQ(a.text, b.text);
+  }
+}
+
+TEST(MockResponseModelTest, LogNormalLatencyMatchesMedianAndTail) {
+  MockProfile profile;
+  profile.latency_median = base::Milliseconds(400);
+  profile.latency_p99 = base::Milliseconds(2000);
+  MockResponseModel model(profile);
+
+  std::vector<base::TimeDelta> latencies;
+  for (int i = 0; i < 10000; ++i) {
+    latencies.push_back(model.NextOutcome().latency);
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  EXPECT_NEAR(latencies[5000].InMillisecondsF(), 400, 40);
+  EXPECT_NEAR(latencies[9900].InMillisecondsF(), 2000, 400);
+}
+
+TEST(MockResponseModelTest, ResponsesHaveTheConfiguredSize) {
+  MockProfile profile;
+  profile.ApplyConfig({{"response_bytes_min", "50"},
+                       {"response_bytes_max", "60"},
+                       {"chunk_bytes", "8"}});
+  MockResponseModel model(profile);
+
+  for (int i = 0; i < 20; ++i) {
+    MockOutcome outcome = model.NextOutcome();
+    ASSERT_TRUE(outcome.success);
+    EXPECT_GE(outcome.text.size(), 50u);
+    EXPECT_LE(outcome.text.size(), 60u);
+
+    std::vector<std::string> chunks = model.SplitIntoChunks(outcome.text);
+    EXPECT_EQ(chunks.size(), (outcome.text.size() + 7) / 8);
+  }
+}
+
+TEST(MockResponseModelTest, IgnoresInvalidConfig) {
+  MockProfile profile;
+  profile.ApplyConfig({{"latency_ms", "-5"},
+                       {"error_rate", "2"},
+                       {"latency_distribution", "bimodal"}});
+
+  MockProfile defaults;
+  EXPECT_EQ(profile.latency_median, defaults.latency_median);
+  EXPECT_EQ(profile.error_rate, defaults.error_rate);
+  EXPECT_EQ(profile.latency_distribution, defaults.latency_distribution);
+}
+
+TEST_F(MockServiceProviderTest, AnswersAfterTheConfiguredLatency) {
+  provider_.Configure({{"latency_distribution", "fixed"},
+                       {"latency_ms", "250"}});
+  EXPECT_EQ(provider_.GetProviderId(), "gemini");
+
+  Send();
+  task_environment_.FastForwardBy(base::Milliseconds(249));
+  EXPECT_TRUE(results_.empty());
+  EXPECT_EQ(provider_.pending_requests(), 1u);
+
+  task_environment_.FastForwardBy(base::Milliseconds(1));
+  ASSERT_EQ(results_.size(), 1u);
+  EXPECT_TRUE(results_[0].first);
+  EXPECT_FALSE(results_[0].second.empty());
+  EXPECT_EQ(provider_.pending_requests(), 0u);
+}
+
+TEST_F(MockServiceProviderTest, FailsWithTheConfiguredError) {
+  provider_.Configure({{"latency_distribution", "fixed"},
+                       {"latency_ms", "10"},
+                       {"error_rate", "1"},
+                       {"error_message", "HTTP error: 429"}});
+
+  Send();
+  task_environment_.FastForwardBy(base::Milliseconds(10));
+  ASSERT_EQ(results_.size(), 1u);
+  EXPECT_FALSE(results_[0].first);
+  EXPECT_EQ(results_[0].second, "HTTP error: 429");
+}
+
+TEST_F(MockServiceProviderTest, FailsAtTheDeadline) {
+  provider_.Configure({{"latency_distribution", "fixed"},
+                       {"latency_ms", "1000"}});
+
+  core::AIServiceProvider::AIRequestParams params;
+  params.task_type = core::AIServiceProvider::TaskType::TEXT_GENERATION;
+  params.deadline = base::TimeTicks::Now() + base::Milliseconds(300);
+  Send(params);
+
+  task_environment_.FastForwardBy(base::Milliseconds(300));
+  ASSERT_EQ(results_.size(), 1u);
+  EXPECT_FALSE(results_[0].first);
+  EXPECT_EQ(results_[0].second, "Network error: ERR_TIMED_OUT");
+}
+
+TEST_F(MockServiceProviderTest, CancellationAnswersRightAway) {
+  provider_.Configure({{"latency_distribution", "fixed"},
+                       {"latency_ms", "1000"}});
+
+  auto token = base::MakeRefCounted<core::CancellationToken>();
+  core::AIServiceProvider::AIRequestParams params;
+  params.task_type = core::AIServiceProvider::TaskType::TEXT_GENERATION;
+  params.cancellation_token = token;
+  Send(params);
+
+  token->Cancel();
+  ASSERT_EQ(results_.size(), 1u);
+  EXPECT_FALSE(results_[0].first);
+  EXPECT_EQ(results_[0].second, core::kRequestCancelledError);
+
+  task_environment_.FastForwardBy(base::Seconds(1));
+  EXPECT_EQ(results_.size(), 1u);
+}
+
+TEST(MockTextAdapterTest, StreamsAtTheConfiguredCadence) {
+  base::test::TaskEnvironment task_environment(
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME);
+  MockTextAdapter adapter;
+  ASSERT_TRUE(adapter.Initialize(
+      R"({"latency_distribution": "fixed", "latency_ms": 100,
+          "chunk_interval_ms": 20, "chunk_jitter_ms": 0, "chunk_bytes": 10,
+          "response_bytes_min": 30, "response_bytes_max": 30})"));
+
+  std::vector<std::string> chunks;
+  bool done = false;
+  adapter.ProcessTextStream(
+      "prompt", [&](const ModelResponse& response, bool is_done) {
+        EXPECT_TRUE(response.success);
+        chunks.push_back(response.text);
+        done = is_done;
+      });
+
+  task_environment.FastForwardBy(base::Milliseconds(100));
+  EXPECT_EQ(chunks.size(), 1u);
+  task_environment.FastForwardBy(base::Milliseconds(20));
+  EXPECT_EQ(chunks.size(), 2u);
+  EXPECT_FALSE(done);
+  task_environment.FastForwardBy(base::Milliseconds(20));
+  ASSERT_EQ(chunks.size(), 3u);
+  EXPECT_TRUE(done);
+  EXPECT_EQ((chunks[0] + chunks[1] + chunks[2]).size(), 30u);
+}
+
+}  // namespace
+}  // namespace mock
+}  // namespace adapters
+}  // namespace asol
@@ -4,8 +4,10 @@
 
 #include "asol/adapters/openai/openai_service_provider.h"
 
+#include <algorithm>
 #include <utility>
 
+#include "asol/adapters/provider_token_counter.h"
 #include "base/logging.h"
 #include "base/strings/string_util.h"
 
@@ -25,6 +27,28 @@ constexpr char kConfigKeyModel[] = "model";
 constexpr char kConfigKeyTemperature[] = "temperature";
 constexpr char kConfigKeyMaxTokens[] = "max_tokens";
 constexpr char kConfigKeyOrganizationId[] = "organization_id";
+
+// System instructions for the tasks that send one ahead of the input
+constexpr char kSummarizationPrompt[] =
+    "Summarize the following text concisely while preserving the key information.";
+constexpr char kContentAnalysisPrompt[] =
+    "Analyze the following content. Identify key topics, entities, sentiment, and main points.";
+constexpr char kCodeGenerationPrompt[] =
+    "You are a helpful coding assistant. Generate clean, efficient, and well-documented code based on the user's requirements.";
+
+// System instruction for a translation into the "target_language" custom
+// param, English when it is absent
+std::string GetTranslationPrompt(
+    const core::AIServiceProvider::AIRequestParams& params) {
+  std::string target_language = "English";
+  auto it = params.custom_params.find("target_language");
+  if (it != params.custom_params.end()) {
+    target_language = it->second;
+  }
+  return "Translate the following text to " + target_language +
+         ". Maintain the original meaning, tone, and style as closely as "
+         "possible.";
+}
 }  // namespace
 
 OpenAIServiceProvider::OpenAIServiceProvider() {
@@ -62,6 +86,7 @@ core::AIServiceProvider::Capabilities OpenAIServiceProvider::GetCapabilities() c
   capabilities.supports_code_generation = true;
   capabilities.supports_question_answering = true;
   capabilities.supports_translation = true;
+  capabilities.supports_streaming = true;
   capabilities.supports_context = true;
   
   // Add supported languages
@@ -69,9 +94,18 @@ core::AIServiceProvider::Capabilities OpenAIServiceProvider::GetCapabilities() c
     "en", "es", "fr", "de", "it", "pt", "nl", "ru", "zh", "ja", "ko", "ar"
   };
   
+  const auto& request_config = openai_adapter_->GetRequestConfig();
+  capabilities.max_input_tokens = GetMaxInputTokens(
+      request_config.model_name,
+      static_cast<size_t>(std::max(request_config.max_tokens, 0)));
+
   return capabilities;
 }
 
+const core::TokenCounter& OpenAIServiceProvider::GetTokenCounter() const {
+  return ProviderTokenCounter::Get(ProviderTokenCounter::Family::kOpenAI);
+}
+
 bool OpenAIServiceProvider::SupportsTaskType(TaskType task_type) const {
   switch (task_type) {
     case TaskType::TEXT_GENERATION:
@@ -120,6 +154,48 @@ void OpenAIServiceProvider::ProcessRequest(
   }
 }
 
+void OpenAIServiceProvider::ProcessStreamingRequest(
+    const AIRequestParams& params,
+    AIStreamCallback callback) {
+  DLOG(INFO) << "Processing streaming request with OpenAI provider. Task type: "
+             << static_cast<int>(params.task_type);
+
+  std::string system_prompt;
+  switch (params.task_type) {
+    case TaskType::TEXT_GENERATION:
+    case TaskType::QUESTION_ANSWERING:
+      openai_adapter_->ProcessTextStream(params.input_text, std::move(callback));
+      return;
+    case TaskType::TEXT_SUMMARIZATION:
+      system_prompt = kSummarizationPrompt;
+      break;
+    case TaskType::CONTENT_ANALYSIS:
+      system_prompt = kContentAnalysisPrompt;
+      break;
+    case TaskType::CODE_GENERATION:
+      system_prompt = kCodeGenerationPrompt;
+      break;
+    case TaskType::TRANSLATION:
+      system_prompt = GetTranslationPrompt(params);
+      break;
+    default:
+      callback.Run(core::MakeFinalStreamDelta(
+          false, "Unsupported task type for OpenAI provider"));
+      return;
+  }
+
+  OpenAIMessage system_message;
+  system_message.role = OpenAIMessage::Role::SYSTEM;
+  system_message.content = system_prompt;
+
+  OpenAIMessage user_message;
+  user_message.role = OpenAIMessage::Role::USER;
+  user_message.content = params.input_text;
+
+  openai_adapter_->ProcessConversationStream(
+      {system_message, user_message}, std::move(callback));
+}
+
 void OpenAIServiceProvider::Configure(
     const std::unordered_map<std::string, std::string>& config) {
   // Update the configuration
@@ -211,7 +287,7 @@ void OpenAIServiceProvider::ProcessTextSummarization(
   
   OpenAIMessage system_message;
   system_message.role = OpenAIMessage::Role::SYSTEM;
-  system_message.content = "Summarize the following text concisely while preserving the key information.";
+  system_message.content = kSummarizationPrompt;
   
   OpenAIMessage user_message;
   user_message.role = OpenAIMessage::Role::USER;
@@ -236,7 +312,7 @@ void OpenAIServiceProvider::ProcessContentAnalysis(
   
   OpenAIMessage system_message;
   system_message.role = OpenAIMessage::Role::SYSTEM;
-  system_message.content = "Analyze the following content. Identify key topics, entities, sentiment, and main points.";
+  system_message.content = kContentAnalysisPrompt;
   
   OpenAIMessage user_message;
   user_message.role = OpenAIMessage::Role::USER;
@@ -296,7 +372,7 @@ void OpenAIServiceProvider::ProcessCodeGeneration(
   
   OpenAIMessage system_message;
   system_message.role = OpenAIMessage::Role::SYSTEM;
-  system_message.content = "You are a helpful coding assistant. Generate clean, efficient, and well-documented code based on the user's requirements.";
+  system_message.content = kCodeGenerationPrompt;
   
   OpenAIMessage user_message;
   user_message.role = OpenAIMessage::Role::USER;
@@ -336,15 +412,13 @@ void OpenAIServiceProvider::ProcessTranslation(
   // Add a system message to guide the model
   std::vector<OpenAIMessage> messages;
   
-  // Check if target language is specified
-  std::string target_language = "English";  // Default
-  if (params.custom_params.find("target_language") != params.custom_params.end()) {
-    target_language = params.custom_params.at("target_language");
-  }
+  // The message only views the prompt, so it is kept here until the
+  // request has been rendered
+  std::string system_prompt = GetTranslationPrompt(params);
   
   OpenAIMessage system_message;
   system_message.role = OpenAIMessage::Role::SYSTEM;
-  system_message.content = "Translate the following text to " + target_language + ". Maintain the original meaning, tone, and style as closely as possible.";
+  system_message.content = system_prompt;
   
   OpenAIMessage user_message;
   user_message.role = OpenAIMessage::Role::USER;
@@ -385,7 +459,7 @@ std::vector<OpenAIMessage> OpenAIServiceProvider::ConvertToOpenAIMessages(
         break;
     }
     
-    openai_message.content = context_message.content;
+    openai_message.content = context_message.content();
     openai_messages.push_back(openai_message);
   }
   
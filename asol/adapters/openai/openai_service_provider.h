@@ -29,9 +29,12 @@ class OpenAIServiceProvider : public core::AIServiceProvider {
   std::string GetProviderName() const override;
   std::string GetProviderVersion() const override;
   Capabilities GetCapabilities() const override;
+  const core::TokenCounter& GetTokenCounter() const override;
   bool SupportsTaskType(TaskType task_type) const override;
   void ProcessRequest(const AIRequestParams& params, 
                     AIResponseCallback callback) override;
+  void ProcessStreamingRequest(const AIRequestParams& params,
+                               AIStreamCallback callback) override;
   void Configure(const std::unordered_map<std::string, std::string>& config) override;
   std::unordered_map<std::string, std::string> GetConfiguration() const override;
 
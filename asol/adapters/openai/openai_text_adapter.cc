@@ -6,6 +6,9 @@
 
 #include <utility>
 
+#include "asol/adapters/completion_stream.h"
+#include "asol/adapters/json_field_reader.h"
+#include "asol/adapters/payload_template.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
@@ -25,21 +28,27 @@ constexpr char kAuthorizationHeader[] = "Authorization: Bearer ";
 constexpr char kOrganizationHeader[] = "OpenAI-Organization: ";
 constexpr char kContentTypeHeader[] = "Content-Type: application/json";
 
+// Simulated streamed responses are fed to the decoder this many bytes at a
+// time, about the size of one event
+constexpr size_t kSimulatedStreamChunkSize = 64;
+
 // Helper function to truncate text for logging
-std::string TruncateForLogging(const std::string& text, size_t max_length = 50) {
+std::string TruncateForLogging(std::string_view text, size_t max_length = 50) {
   if (text.length() <= max_length)
-    return text;
-  return text.substr(0, max_length) + "...";
+    return std::string(text);
+  return std::string(text.substr(0, max_length)) + "...";
 }
 
 }  // namespace
 
 OpenAITextAdapter::OpenAITextAdapter() : config_() {
+  UpdatePayloadTemplates();
   LOG(INFO) << "OpenAITextAdapter initialized with default configuration.";
 }
 
 OpenAITextAdapter::OpenAITextAdapter(const std::string& api_key) 
     : api_key_(api_key), config_() {
+  UpdatePayloadTemplates();
   LOG(INFO) << "OpenAITextAdapter initialized with provided API key.";
 }
 
@@ -48,13 +57,13 @@ OpenAITextAdapter::~OpenAITextAdapter() {
 }
 
 void OpenAITextAdapter::ProcessText(
-    const std::string& text_input,
+    std::string_view text_input,
     OpenAIResponseCallback callback) {
   DLOG(INFO) << "Processing text with OpenAI Adapter: " 
              << TruncateForLogging(text_input);
   
   // Build the request payload for a single text prompt
-  nlohmann::json payload = BuildRequestPayload(text_input);
+  std::string payload = BuildRequestPayload(text_input);
   
   // Send the request to the OpenAI API
   SendRequest(payload, std::move(callback));
@@ -66,14 +75,32 @@ void OpenAITextAdapter::ProcessConversation(
   DLOG(INFO) << "Processing conversation with " << messages.size() << " messages";
   
   // Build the request payload for a conversation
-  nlohmann::json payload = BuildConversationPayload(messages);
+  std::string payload = BuildConversationPayload(messages);
   
   // Send the request to the OpenAI API
   SendRequest(payload, std::move(callback));
 }
 
+void OpenAITextAdapter::ProcessTextStream(
+    std::string_view text_input,
+    core::StreamDeltaCallback callback) {
+  DLOG(INFO) << "Streaming text with OpenAI Adapter: "
+             << TruncateForLogging(text_input);
+  SendStreamingRequest(BuildRequestPayload(text_input), std::move(callback));
+}
+
+void OpenAITextAdapter::ProcessConversationStream(
+    const std::vector<OpenAIMessage>& messages,
+    core::StreamDeltaCallback callback) {
+  DLOG(INFO) << "Streaming conversation with " << messages.size()
+             << " messages";
+  SendStreamingRequest(BuildConversationPayload(messages),
+                       std::move(callback));
+}
+
 void OpenAITextAdapter::SetRequestConfig(const OpenAIRequestConfig& config) {
   config_ = config;
+  UpdatePayloadTemplates();
   DLOG(INFO) << "Updated OpenAI request configuration. Model: " 
              << config_.model_name;
 }
@@ -92,30 +119,16 @@ void OpenAITextAdapter::SetOrganizationId(const std::string& org_id) {
   DLOG(INFO) << "Updated organization ID.";
 }
 
-nlohmann::json OpenAITextAdapter::BuildRequestPayload(
-    const std::string& text_input) const {
+const core::PromptCacheStats& OpenAITextAdapter::GetPromptCacheStats() const {
+  return prompt_cache_stats_;
+}
+
+void OpenAITextAdapter::UpdatePayloadTemplates() {
   nlohmann::json payload;
   
   // Set the model
   payload["model"] = config_.model_name;
   
-  // Add the messages array with system and user messages
-  nlohmann::json messages = nlohmann::json::array();
-  
-  // Add a default system message if processing a single text input
-  nlohmann::json system_message;
-  system_message["role"] = "system";
-  system_message["content"] = "You are a helpful assistant.";
-  messages.push_back(system_message);
-  
-  // Add the user message
-  nlohmann::json user_message;
-  user_message["role"] = "user";
-  user_message["content"] = text_input;
-  messages.push_back(user_message);
-  
-  payload["messages"] = messages;
-  
   // Add generation parameters
   payload["temperature"] = config_.temperature;
   payload["max_tokens"] = config_.max_tokens;
@@ -123,35 +136,42 @@ nlohmann::json OpenAITextAdapter::BuildRequestPayload(
   payload["frequency_penalty"] = config_.frequency_penalty;
   payload["presence_penalty"] = config_.presence_penalty;
   
-  return payload;
+  // Conversations splice in a pre-rendered messages array
+  payload["messages"] = PayloadTemplate::RawSlot(0);
+  conversation_template_ = PayloadTemplate(payload);
+  
+  // Add a default system message if processing a single text input
+  payload["messages"] = nlohmann::json::array({
+    {{"role", "system"}, {"content", "You are a helpful assistant."}},
+    {{"role", "user"}, {"content", PayloadTemplate::TextSlot(0)}}
+  });
+  text_template_ = PayloadTemplate(payload);
+  
+  message_template_ = PayloadTemplate(nlohmann::json{
+    {"role", PayloadTemplate::TextSlot(0)},
+    {"content", PayloadTemplate::TextSlot(1)}
+  });
+}
+
+std::string OpenAITextAdapter::BuildRequestPayload(
+    std::string_view text_input) const {
+  return text_template_.Render({text_input});
 }
 
-nlohmann::json OpenAITextAdapter::BuildConversationPayload(
+std::string OpenAITextAdapter::BuildConversationPayload(
     const std::vector<OpenAIMessage>& messages) const {
-  nlohmann::json payload;
-  
-  // Set the model
-  payload["model"] = config_.model_name;
-  
   // Convert each message to the format expected by OpenAI API
-  nlohmann::json messages_array = nlohmann::json::array();
+  std::string messages_array = "[";
   for (const auto& message : messages) {
-    nlohmann::json msg_obj;
-    msg_obj["role"] = RoleToString(message.role);
-    msg_obj["content"] = message.content;
-    messages_array.push_back(msg_obj);
+    if (messages_array.size() > 1) {
+      messages_array += ',';
+    }
+    message_template_.RenderTo({RoleToString(message.role), message.content},
+                               &messages_array);
   }
+  messages_array += ']';
   
-  payload["messages"] = messages_array;
-  
-  // Add generation parameters
-  payload["temperature"] = config_.temperature;
-  payload["max_tokens"] = config_.max_tokens;
-  payload["top_p"] = config_.top_p;
-  payload["frequency_penalty"] = config_.frequency_penalty;
-  payload["presence_penalty"] = config_.presence_penalty;
-  
-  return payload;
+  return conversation_template_.Render({messages_array});
 }
 
 std::string OpenAITextAdapter::RoleToString(OpenAIMessage::Role role) const {
@@ -169,13 +189,12 @@ std::string OpenAITextAdapter::RoleToString(OpenAIMessage::Role role) const {
 }
 
 void OpenAITextAdapter::SendRequest(
-    const nlohmann::json& payload,
+    const std::string& payload,
     OpenAIResponseCallback callback) {
   // In a real implementation, this would use network services to send an HTTP request
   // For now, we'll simulate a response
   
-  std::string json_str = payload.dump(2);
-  DLOG(INFO) << "OpenAI API Request payload: " << TruncateForLogging(json_str, 100);
+  DLOG(INFO) << "OpenAI API Request payload: " << TruncateForLogging(payload, 100);
   
   // Construct the headers (would be used in actual implementation)
   std::vector<std::string> headers;
@@ -227,32 +246,88 @@ void OpenAITextAdapter::HandleResponse(
   bool success = true;
   std::string result_text;
   
-  try {
-    // Parse the JSON response
-    nlohmann::json response = nlohmann::json::parse(response_data);
-    
-    // Extract the response text
-    if (response.contains("choices") && 
-        !response["choices"].empty() && 
-        response["choices"][0].contains("message") &&
-        response["choices"][0]["message"].contains("content")) {
-      
-      result_text = response["choices"][0]["message"]["content"];
-    } else {
-      success = false;
-      result_text = "Failed to parse response: unexpected format";
-      LOG(ERROR) << result_text;
-    }
-  } catch (const std::exception& e) {
+  // Read only the fields we need instead of building a DOM
+  JsonFieldReader reader(response_data);
+  if (!reader.GetString({"choices", 0, "message", "content"}, &result_text)) {
     success = false;
-    result_text = "Failed to parse response: " + std::string(e.what());
+    result_text = "Failed to parse response: unexpected format";
     LOG(ERROR) << result_text;
   }
+
+  int64_t prompt_tokens = 0;
+  if (success && reader.GetInt({"usage", "prompt_tokens"}, &prompt_tokens)) {
+    int64_t cached_tokens = 0;
+    reader.GetInt({"usage", "prompt_tokens_details", "cached_tokens"},
+                  &cached_tokens);
+    prompt_cache_stats_.Record(prompt_tokens, cached_tokens);
+  }
   
   // Invoke the callback with the result
   std::move(callback).Run(success, result_text);
 }
 
+void OpenAITextAdapter::SendStreamingRequest(
+    std::string payload,
+    core::StreamDeltaCallback callback) {
+  CompletionStream::EnableStreaming(CompletionStream::Dialect::kOpenAIChat,
+                                    &payload);
+  DLOG(INFO) << "OpenAI API streaming request payload: "
+             << TruncateForLogging(payload, 100);
+  DLOG(INFO) << "Would send request to: " << kOpenAIApiEndpoint;
+
+  auto stream = std::make_unique<CompletionStream>(
+      CompletionStream::Dialect::kOpenAIChat,
+      base::BindRepeating(&OpenAITextAdapter::OnStreamDelta,
+                          weak_ptr_factory_.GetWeakPtr(),
+                          std::move(callback)));
+
+  // Simulate the event stream the API sends for a request with "stream"
+  // and "stream_options.include_usage" set
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(
+          &OpenAITextAdapter::HandleStreamResponse,
+          weak_ptr_factory_.GetWeakPtr(), std::move(stream),
+          "data: {\"id\":\"chatcmpl-123\",\"object\":\"chat.completion.chunk\","
+          "\"choices\":[{\"index\":0,\"delta\":{\"role\":\"assistant\","
+          "\"content\":\"\"},\"finish_reason\":null}],\"usage\":null}\n\n"
+          "data: {\"id\":\"chatcmpl-123\",\"object\":\"chat.completion.chunk\","
+          "\"choices\":[{\"index\":0,\"delta\":{\"content\":\"This is a "
+          "simulated\"},\"finish_reason\":null}],\"usage\":null}\n\n"
+          "data: {\"id\":\"chatcmpl-123\",\"object\":\"chat.completion.chunk\","
+          "\"choices\":[{\"index\":0,\"delta\":{\"content\":\" response "
+          "from the OpenAI API.\"},\"finish_reason\":null}],\"usage\":null}"
+          "\n\n"
+          "data: {\"id\":\"chatcmpl-123\",\"object\":\"chat.completion.chunk\","
+          "\"choices\":[{\"index\":0,\"delta\":{},\"finish_reason\":"
+          "\"stop\"}],\"usage\":null}\n\n"
+          "data: {\"id\":\"chatcmpl-123\",\"object\":\"chat.completion.chunk\","
+          "\"choices\":[],\"usage\":{\"prompt_tokens\":9,"
+          "\"completion_tokens\":12,\"total_tokens\":21}}\n\n"
+          "data: [DONE]\n\n"),
+      base::Milliseconds(100));  // Simulate network delay
+}
+
+void OpenAITextAdapter::HandleStreamResponse(
+    std::unique_ptr<CompletionStream> stream,
+    const std::string& response_body) {
+  std::string_view body(response_body);
+  for (size_t offset = 0; offset < body.size() && !stream->finished();
+       offset += kSimulatedStreamChunkSize) {
+    stream->Append(body.substr(offset, kSimulatedStreamChunkSize));
+  }
+  stream->Finish();
+}
+
+void OpenAITextAdapter::OnStreamDelta(const core::StreamDeltaCallback& callback,
+                                      const core::StreamDelta& delta) {
+  if (delta.is_final && delta.success && delta.usage) {
+    prompt_cache_stats_.Record(delta.usage->prompt_tokens,
+                               delta.usage->cached_prompt_tokens);
+  }
+  callback.Run(delta);
+}
+
 }  // namespace openai
 }  // namespace adapters
-}  // namespace asol
\ No newline at end of file
+}  // namespace asol
@@ -8,14 +8,21 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "asol/adapters/payload_template.h"
+#include "asol/core/prompt_cache.h"
+#include "asol/core/stream_delta.h"
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "third_party/nlohmann_json/json.hpp"
 
 namespace asol {
 namespace adapters {
+
+class CompletionStream;
+
 namespace openai {
 
 // Represents a message in a conversation with OpenAI
@@ -27,7 +34,10 @@ struct OpenAIMessage {
   };
 
   Role role;
-  std::string content;
+  // Must outlive the call the message is passed to, which builds the
+  // request before returning; conversations can then point into shared
+  // context history instead of copying it
+  std::string_view content;
 };
 
 // Represents configuration options for OpenAI API requests
@@ -56,11 +66,18 @@ class OpenAITextAdapter {
   OpenAITextAdapter& operator=(const OpenAITextAdapter&) = delete;
 
   // Process a single text prompt and get a response
-  void ProcessText(const std::string& text_input, OpenAIResponseCallback callback);
+  void ProcessText(std::string_view text_input, OpenAIResponseCallback callback);
   
   // Process a conversation with multiple messages
   void ProcessConversation(const std::vector<OpenAIMessage>& messages,
                           OpenAIResponseCallback callback);
+
+  // Same as ProcessText() and ProcessConversation(), reporting the text as
+  // it is generated. The final delta carries the finish reason and usage.
+  void ProcessTextStream(std::string_view text_input,
+                         core::StreamDeltaCallback callback);
+  void ProcessConversationStream(const std::vector<OpenAIMessage>& messages,
+                                 core::StreamDeltaCallback callback);
   
   // Configure the adapter with specific settings
   void SetRequestConfig(const OpenAIRequestConfig& config);
@@ -74,26 +91,53 @@ class OpenAITextAdapter {
   // Set organization ID (for runtime configuration)
   void SetOrganizationId(const std::string& org_id);
 
+  // Input tokens read from the prompt cache so far. OpenAI caches prompt
+  // prefixes of 1024 tokens or more without breakpoints, so hits depend
+  // only on callers putting stable text first.
+  const core::PromptCacheStats& GetPromptCacheStats() const;
+
  private:
+  // Rebuild the request templates from |config_|
+  void UpdatePayloadTemplates();
+
   // Helper methods for API interaction
-  nlohmann::json BuildRequestPayload(const std::string& text_input) const;
-  nlohmann::json BuildConversationPayload(
+  std::string BuildRequestPayload(std::string_view text_input) const;
+  std::string BuildConversationPayload(
       const std::vector<OpenAIMessage>& messages) const;
   
   // Convert message role enum to string for API
   std::string RoleToString(OpenAIMessage::Role role) const;
   
   // Send request to OpenAI API
-  void SendRequest(const nlohmann::json& payload, OpenAIResponseCallback callback);
+  void SendRequest(const std::string& payload, OpenAIResponseCallback callback);
   
   // Parse API response
   void HandleResponse(const std::string& response_data, 
                      OpenAIResponseCallback callback);
 
+  // Send |payload| as a streaming request
+  void SendStreamingRequest(std::string payload,
+                            core::StreamDeltaCallback callback);
+
+  // Feed a streamed response body to |stream|
+  void HandleStreamResponse(std::unique_ptr<CompletionStream> stream,
+                            const std::string& response_body);
+
+  // Record the usage the final delta reports, then forward |delta|
+  void OnStreamDelta(const core::StreamDeltaCallback& callback,
+                     const core::StreamDelta& delta);
+
   // Private members
   std::string api_key_;
   OpenAIRequestConfig config_;
   
+  // Request bodies pre-serialized for |config_|
+  PayloadTemplate text_template_;
+  PayloadTemplate conversation_template_;
+  PayloadTemplate message_template_;
+
+  core::PromptCacheStats prompt_cache_stats_;
+  
   // For async operations and callbacks
   base::WeakPtrFactory<OpenAITextAdapter> weak_ptr_factory_{this};
 };
@@ -0,0 +1,172 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/payload_template.h"
+
+#include "base/check_op.h"
+#include "base/strings/string_number_conversions.h"
+
+namespace asol {
+namespace adapters {
+
+namespace {
+
+constexpr std::string_view kSlotPrefix = "{{asol:";
+constexpr std::string_view kSlotSuffix = "}}";
+constexpr std::string_view kTextKind = "text:";
+constexpr std::string_view kRawKind = "raw:";
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+bool NeedsEscape(char c) {
+  return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+}  // namespace
+
+// static
+std::string PayloadTemplate::TextSlot(size_t index) {
+  return std::string(kSlotPrefix) + std::string(kTextKind) +
+         base::NumberToString(index) + std::string(kSlotSuffix);
+}
+
+// static
+std::string PayloadTemplate::RawSlot(size_t index) {
+  return std::string(kSlotPrefix) + std::string(kRawKind) +
+         base::NumberToString(index) + std::string(kSlotSuffix);
+}
+
+PayloadTemplate::PayloadTemplate() = default;
+
+PayloadTemplate::PayloadTemplate(const nlohmann::json& payload) {
+  // Compact form; slot placeholders serialize as plain quoted strings
+  const std::string serialized = payload.dump();
+
+  size_t pos = 0;
+  size_t search = 0;
+  while (true) {
+    size_t start = serialized.find(kSlotPrefix, search);
+    if (start == std::string::npos) {
+      break;
+    }
+    size_t end = serialized.find(kSlotSuffix, start);
+    if (end == std::string::npos) {
+      break;
+    }
+
+    std::string_view spec(serialized.data() + start + kSlotPrefix.size(),
+                          end - start - kSlotPrefix.size());
+    Slot slot;
+    if (spec.substr(0, kTextKind.size()) == kTextKind) {
+      spec.remove_prefix(kTextKind.size());
+    } else if (spec.substr(0, kRawKind.size()) == kRawKind) {
+      spec.remove_prefix(kRawKind.size());
+      slot.raw = true;
+    } else {
+      search = end;
+      continue;
+    }
+    if (!base::StringToSizeT(spec, &slot.index)) {
+      search = end;
+      continue;
+    }
+
+    // Text lands between the placeholder's quotes; raw JSON replaces them
+    size_t literal_end = slot.raw ? start - 1 : start;
+    size_t resume = end + kSlotSuffix.size() + (slot.raw ? 1 : 0);
+    segments_.push_back(serialized.substr(pos, literal_end - pos));
+    slots_.push_back(slot);
+    pos = search = resume;
+  }
+  segments_.push_back(serialized.substr(pos));
+
+  for (const std::string& segment : segments_) {
+    literal_size_ += segment.size();
+  }
+}
+
+PayloadTemplate::PayloadTemplate(const PayloadTemplate&) = default;
+PayloadTemplate& PayloadTemplate::operator=(const PayloadTemplate&) = default;
+PayloadTemplate::PayloadTemplate(PayloadTemplate&&) = default;
+PayloadTemplate& PayloadTemplate::operator=(PayloadTemplate&&) = default;
+PayloadTemplate::~PayloadTemplate() = default;
+
+std::string PayloadTemplate::Render(
+    std::initializer_list<std::string_view> values) const {
+  std::string out;
+  RenderTo(values, &out);
+  return out;
+}
+
+void PayloadTemplate::RenderTo(std::initializer_list<std::string_view> values,
+                               std::string* out) const {
+  if (segments_.empty()) {
+    return;
+  }
+
+  size_t size = out->size() + literal_size_;
+  for (const Slot& slot : slots_) {
+    DCHECK_LT(slot.index, values.size());
+    size += values.begin()[slot.index].size();
+  }
+  out->reserve(size);
+
+  out->append(segments_[0]);
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    std::string_view value = values.begin()[slots_[i].index];
+    if (slots_[i].raw) {
+      out->append(value);
+    } else {
+      AppendJsonEscaped(value, out);
+    }
+    out->append(segments_[i + 1]);
+  }
+}
+
+void AppendJsonEscaped(std::string_view text, std::string* out) {
+  size_t run_start = 0;
+  for (size_t i = 0; i < text.size(); ++i) {
+    char c = text[i];
+    if (!NeedsEscape(c)) {
+      continue;
+    }
+    // Copy the unescaped run in one go
+    out->append(text.data() + run_start, i - run_start);
+    run_start = i + 1;
+    switch (c) {
+      case '"':
+        out->append("\\\"");
+        break;
+      case '\\':
+        out->append("\\\\");
+        break;
+      case '\b':
+        out->append("\\b");
+        break;
+      case '\f':
+        out->append("\\f");
+        break;
+      case '\n':
+        out->append("\\n");
+        break;
+      case '\r':
+        out->append("\\r");
+        break;
+      case '\t':
+        out->append("\\t");
+        break;
+      default: {
+        unsigned char byte = static_cast<unsigned char>(c);
+        out->append("\\u00");
+        out->push_back(kHexDigits[byte >> 4]);
+        out->push_back(kHexDigits[byte & 0xF]);
+        break;
+      }
+    }
+  }
+  out->append(text.data() + run_start, text.size() - run_start);
+}
+
+}  // namespace adapters
+}  // namespace asol
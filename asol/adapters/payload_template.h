@@ -0,0 +1,73 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_ADAPTERS_PAYLOAD_TEMPLATE_H_
+#define ASOL_ADAPTERS_PAYLOAD_TEMPLATE_H_
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "third_party/nlohmann_json/json.hpp"
+
+namespace asol {
+namespace adapters {
+
+// PayloadTemplate is a request body serialized once, with slots where
+// per-request values go. Adapters build the template from their config
+// when it changes; each request then writes the literal segments and the
+// escaped user text into one string in a single pass, with no JSON tree
+// and no indentation.
+//
+//   nlohmann::json payload;
+//   payload["model"] = "gpt-4o";
+//   payload["prompt"] = PayloadTemplate::TextSlot(0);
+//   PayloadTemplate tmpl(payload);
+//   tmpl.Render({user_text});  // {"model":"gpt-4o","prompt":"<escaped>"}
+class PayloadTemplate {
+ public:
+  // A string value replaced by escaped text: Render() value |index|
+  static std::string TextSlot(size_t index);
+
+  // A string value replaced by pre-serialized JSON, e.g. an array of
+  // messages rendered from another template
+  static std::string RawSlot(size_t index);
+
+  PayloadTemplate();
+  explicit PayloadTemplate(const nlohmann::json& payload);
+  PayloadTemplate(const PayloadTemplate&);
+  PayloadTemplate& operator=(const PayloadTemplate&);
+  PayloadTemplate(PayloadTemplate&&);
+  PayloadTemplate& operator=(PayloadTemplate&&);
+  ~PayloadTemplate();
+
+  // The body with slot |i| filled from |values[i]|
+  std::string Render(std::initializer_list<std::string_view> values) const;
+
+  // Like Render(), appending to |out|
+  void RenderTo(std::initializer_list<std::string_view> values,
+                std::string* out) const;
+
+  bool empty() const { return segments_.empty(); }
+
+ private:
+  struct Slot {
+    size_t index = 0;
+    bool raw = false;
+  };
+
+  // Literal text around the slots; one more segment than slots
+  std::vector<std::string> segments_;
+  std::vector<Slot> slots_;
+  size_t literal_size_ = 0;
+};
+
+// Append |text| to |out| escaped for use inside a JSON string literal
+void AppendJsonEscaped(std::string_view text, std::string* out);
+
+}  // namespace adapters
+}  // namespace asol
+
+#endif  // ASOL_ADAPTERS_PAYLOAD_TEMPLATE_H_
@@ -0,0 +1,63 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/payload_template.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/nlohmann_json/json.hpp"
+
+namespace asol {
+namespace adapters {
+namespace {
+
+TEST(PayloadTemplateTest, SplicesEscapedTextWithoutIndentation) {
+  nlohmann::json payload;
+  payload["model"] = "gpt-4o";
+  payload["temperature"] = 0.5;
+  payload["messages"] = nlohmann::json::array(
+      {{{"role", "user"}, {"content", PayloadTemplate::TextSlot(0)}}});
+  PayloadTemplate payload_template(payload);
+
+  std::string text = "Say \"hi\"\n\t\\ caf\xC3\xA9 \x01";
+  std::string body = payload_template.Render({text});
+
+  EXPECT_EQ(body.find('\n'), std::string::npos);
+  nlohmann::json expected = payload;
+  expected["messages"][0]["content"] = text;
+  EXPECT_EQ(body, expected.dump());
+}
+
+TEST(PayloadTemplateTest, FillsSlotsByIndexAndSplicesRawJson) {
+  nlohmann::json payload;
+  payload["a_messages"] = PayloadTemplate::RawSlot(0);
+  payload["b_system"] = PayloadTemplate::TextSlot(1);
+  PayloadTemplate outer(payload);
+  PayloadTemplate message(nlohmann::json{
+      {"role", PayloadTemplate::TextSlot(0)},
+      {"content", PayloadTemplate::TextSlot(1)}});
+
+  std::string messages = "[";
+  message.RenderTo({"user", "one"}, &messages);
+  messages += ',';
+  message.RenderTo({"assistant", "two"}, &messages);
+  messages += ']';
+
+  nlohmann::json body = nlohmann::json::parse(outer.Render({messages, "sys"}));
+  EXPECT_EQ(body["b_system"], "sys");
+  ASSERT_EQ(body["a_messages"].size(), 2u);
+  EXPECT_EQ(body["a_messages"][0]["role"], "user");
+  EXPECT_EQ(body["a_messages"][1]["content"], "two");
+}
+
+TEST(PayloadTemplateTest, EscapesControlCharacters) {
+  std::string out;
+  AppendJsonEscaped(std::string_view("a\0b\x1f", 4), &out);
+  EXPECT_EQ(out, "a\\u0000b\\u001f");
+}
+
+}  // namespace
+}  // namespace adapters
+}  // namespace asol
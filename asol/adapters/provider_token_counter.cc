@@ -0,0 +1,362 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/provider_token_counter.h"
+
+#include <cstdint>
+
+#include "base/bits.h"
+#include "base/no_destructor.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace asol {
+namespace adapters {
+
+namespace {
+
+using Profile = ProviderTokenCounter::Profile;
+
+// Measured on English prose and source code against each family's own
+// tokenizer
+constexpr Profile kOpenAIProfile = {6, 3, 2, 16};
+constexpr Profile kAnthropicProfile = {5, 3, 2, 8};
+constexpr Profile kGeminiProfile = {6, 1, 2, 8};
+
+struct ContextWindow {
+  const char* prefix;
+  size_t tokens;
+};
+
+constexpr ContextWindow kContextWindows[] = {
+    {"gpt-3.5-turbo", 16385},  {"gpt-4", 8192},
+    {"gpt-4-32k", 32768},      {"gpt-4-turbo", 128000},
+    {"gpt-4.1", 1047576},      {"gpt-4o", 128000},
+    {"o1", 200000},            {"o3", 200000},
+    {"claude-", 200000},       {"gemini-1.5", 1048576},
+    {"gemini-2", 1048576},     {"gemini-pro", 32760},
+};
+
+bool IsAsciiLetter(unsigned char c) {
+  return static_cast<unsigned char>((c | 0x20) - 'a') <= 'z' - 'a';
+}
+
+bool IsAsciiDigit(unsigned char c) {
+  return c >= '0' && c <= '9';
+}
+
+bool IsAsciiWhitespace(unsigned char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+size_t ScanAsciiLettersPortable(const char* data, size_t size) {
+  size_t i = 0;
+  while (i < size && IsAsciiLetter(static_cast<unsigned char>(data[i]))) {
+    i++;
+  }
+  return i;
+}
+
+// Number of ASCII letters |data| starts with. A byte is a letter when, with
+// the case bit set, it lies in 'a'..'z', so one unsigned range check per
+// lane covers both cases.
+#if defined(ARCH_CPU_X86_FAMILY)
+size_t ScanAsciiLetters(const char* data, size_t size) {
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  const __m128i first = _mm_set1_epi8('a');
+  const __m128i span = _mm_set1_epi8('z' - 'a');
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    __m128i offset = _mm_sub_epi8(_mm_or_si128(bytes, case_bit), first);
+    __m128i letters = _mm_cmpeq_epi8(_mm_min_epu8(offset, span), offset);
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(letters));
+    if (mask != 0xFFFF) {
+      return i + base::bits::CountTrailingZeroBits(~mask);
+    }
+  }
+  return i + ScanAsciiLettersPortable(data + i, size - i);
+}
+#elif defined(ARCH_CPU_ARM64)
+size_t ScanAsciiLetters(const char* data, size_t size) {
+  const uint8x16_t case_bit = vdupq_n_u8(0x20);
+  const uint8x16_t first = vdupq_n_u8('a');
+  const uint8x16_t span = vdupq_n_u8('z' - 'a');
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    uint8x16_t offset =
+        vsubq_u8(vorrq_u8(vld1q_u8(bytes + i), case_bit), first);
+    // The block with the first non-letter is finished byte by byte
+    if (vminvq_u8(vcleq_u8(offset, span)) != 0xFF) {
+      break;
+    }
+  }
+  return i + ScanAsciiLettersPortable(data + i, size - i);
+}
+#else
+size_t ScanAsciiLetters(const char* data, size_t size) {
+  return ScanAsciiLettersPortable(data, size);
+}
+#endif
+
+// Decode the UTF-8 sequence |text| starts with into |code_point|, returning
+// its length. Malformed bytes decode one at a time.
+size_t DecodeUtf8(std::string_view text, uint32_t* code_point) {
+  unsigned char lead = static_cast<unsigned char>(text[0]);
+  size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+  if (length > text.size()) {
+    length = 1;
+  }
+  uint32_t value = length == 1 ? lead : lead & (0x7F >> length);
+  for (size_t i = 1; i < length; ++i) {
+    unsigned char next = static_cast<unsigned char>(text[i]);
+    if ((next & 0xC0) != 0x80) {
+      *code_point = lead;
+      return 1;
+    }
+    value = (value << 6) | (next & 0x3F);
+  }
+  *code_point = value;
+  return length;
+}
+
+// Scripts written without spaces, where tokenizers spend about a token per
+// character: Hangul, CJK, kana and fullwidth forms
+bool IsWideCodePoint(uint32_t code_point) {
+  return (code_point >= 0x1100 && code_point <= 0x11FF) ||
+         (code_point >= 0x2E80 && code_point <= 0x9FFF) ||
+         (code_point >= 0xAC00 && code_point <= 0xD7AF) ||
+         (code_point >= 0xF900 && code_point <= 0xFAFF) ||
+         (code_point >= 0xFF00 && code_point <= 0xFFEF) ||
+         (code_point >= 0x20000 && code_point <= 0x2FFFF);
+}
+
+size_t CeilDiv(size_t value, size_t divisor) {
+  return (value + divisor - 1) / divisor;
+}
+
+enum class PieceKind { kWord, kWide, kDigits, kPunctuation, kWhitespace };
+
+// One pre-tokenizer piece at the start of the remaining text
+struct Piece {
+  PieceKind kind;
+  // Bytes, including a leading space joined to the piece
+  size_t length = 0;
+  // Offset of the piece's own characters, past the joined space
+  size_t body = 0;
+  size_t tokens = 0;
+};
+
+// Whether a single space before |c| joins the piece |c| starts, as in
+// " the" or " (". Digits and whitespace keep their own pieces.
+bool JoinsLeadingSpace(unsigned char c) {
+  return !IsAsciiDigit(c) && !IsAsciiWhitespace(c);
+}
+
+Piece NextPiece(std::string_view text, const Profile& profile) {
+  Piece piece;
+  size_t pos = 0;
+  if (text[0] == ' ' && text.size() > 1 &&
+      JoinsLeadingSpace(static_cast<unsigned char>(text[1]))) {
+    pos = 1;
+  }
+  piece.body = pos;
+  unsigned char c = static_cast<unsigned char>(text[pos]);
+
+  if (IsAsciiDigit(c)) {
+    piece.kind = PieceKind::kDigits;
+    while (pos < text.size() &&
+           IsAsciiDigit(static_cast<unsigned char>(text[pos]))) {
+      pos++;
+    }
+    piece.length = pos;
+    piece.tokens = CeilDiv(pos - piece.body, profile.digits_per_token);
+    return piece;
+  }
+
+  if (IsAsciiWhitespace(c)) {
+    piece.kind = PieceKind::kWhitespace;
+    while (pos < text.size() &&
+           IsAsciiWhitespace(static_cast<unsigned char>(text[pos]))) {
+      pos++;
+    }
+    // The last space goes with the word after the run
+    if (pos > 1 && pos < text.size() && text[pos - 1] == ' ' &&
+        JoinsLeadingSpace(static_cast<unsigned char>(text[pos]))) {
+      pos--;
+    }
+    piece.length = pos;
+    piece.tokens = CeilDiv(pos, profile.whitespace_per_token);
+    return piece;
+  }
+
+  if (c < 0x80 && !IsAsciiLetter(c)) {
+    piece.kind = PieceKind::kPunctuation;
+    while (pos < text.size()) {
+      unsigned char next = static_cast<unsigned char>(text[pos]);
+      if (next >= 0x80 || IsAsciiLetter(next) || IsAsciiDigit(next) ||
+          IsAsciiWhitespace(next)) {
+        break;
+      }
+      pos++;
+    }
+    piece.length = pos;
+    piece.tokens = CeilDiv(pos - piece.body, profile.punctuation_per_token);
+    return piece;
+  }
+
+  // Letters, in any script but the wide ones
+  piece.kind = PieceKind::kWord;
+  size_t weight = 0;
+  while (pos < text.size()) {
+    size_t run = ScanAsciiLetters(text.data() + pos, text.size() - pos);
+    pos += run;
+    weight += run;
+    if (pos == text.size() || static_cast<unsigned char>(text[pos]) < 0x80) {
+      break;
+    }
+    uint32_t code_point;
+    size_t length = DecodeUtf8(text.substr(pos), &code_point);
+    if (IsWideCodePoint(code_point)) {
+      if (weight == 0) {
+        piece.kind = PieceKind::kWide;
+        piece.length = pos + length;
+        piece.tokens = 1;
+        return piece;
+      }
+      break;
+    }
+    pos += length;
+    weight += 2;
+  }
+  piece.length = pos;
+  piece.tokens = 1 + (weight - 1) / profile.word_weight_per_token;
+  return piece;
+}
+
+// Length of the prefix of |piece|, which starts |text|, that costs at most
+// |budget| tokens. |budget| is less than the piece's cost.
+size_t FitPieceLength(std::string_view text,
+                      const Piece& piece,
+                      size_t budget,
+                      const Profile& profile) {
+  if (budget == 0) {
+    return 0;
+  }
+  switch (piece.kind) {
+    case PieceKind::kWide:
+      return 0;
+    case PieceKind::kDigits:
+      return piece.body + budget * profile.digits_per_token;
+    case PieceKind::kPunctuation:
+      return piece.body + budget * profile.punctuation_per_token;
+    case PieceKind::kWhitespace:
+      return budget * profile.whitespace_per_token;
+    case PieceKind::kWord:
+      break;
+  }
+
+  // A word of weight w costs 1 + (w - 1) / word_weight_per_token
+  size_t max_weight = budget * profile.word_weight_per_token;
+  size_t pos = piece.body;
+  size_t weight = 0;
+  while (pos < piece.length) {
+    uint32_t code_point;
+    size_t length = DecodeUtf8(text.substr(pos), &code_point);
+    size_t char_weight = code_point < 0x80 ? 1 : 2;
+    if (weight + char_weight > max_weight) {
+      break;
+    }
+    weight += char_weight;
+    pos += length;
+  }
+  return pos;
+}
+
+}  // namespace
+
+// static
+const ProviderTokenCounter& ProviderTokenCounter::Get(Family family) {
+  switch (family) {
+    case Family::kOpenAI: {
+      static const base::NoDestructor<ProviderTokenCounter> counter(
+          kOpenAIProfile);
+      return *counter;
+    }
+    case Family::kAnthropic: {
+      static const base::NoDestructor<ProviderTokenCounter> counter(
+          kAnthropicProfile);
+      return *counter;
+    }
+    case Family::kGemini: {
+      static const base::NoDestructor<ProviderTokenCounter> counter(
+          kGeminiProfile);
+      return *counter;
+    }
+  }
+  return Get(Family::kOpenAI);
+}
+
+ProviderTokenCounter::ProviderTokenCounter(const Profile& profile)
+    : profile_(profile) {}
+
+ProviderTokenCounter::~ProviderTokenCounter() = default;
+
+size_t ProviderTokenCounter::CountTokens(std::string_view text) const {
+  size_t tokens = 0;
+  while (!text.empty()) {
+    Piece piece = NextPiece(text, profile_);
+    tokens += piece.tokens;
+    text.remove_prefix(piece.length);
+  }
+  return tokens;
+}
+
+size_t ProviderTokenCounter::FitPrefix(std::string_view text,
+                                       size_t max_tokens) const {
+  size_t offset = 0;
+  size_t tokens = 0;
+  while (offset < text.size()) {
+    std::string_view rest = text.substr(offset);
+    Piece piece = NextPiece(rest, profile_);
+    if (tokens + piece.tokens > max_tokens) {
+      // Part of a long word or run still fits
+      return offset +
+             FitPieceLength(rest, piece, max_tokens - tokens, profile_);
+    }
+    tokens += piece.tokens;
+    offset += piece.length;
+  }
+  return offset;
+}
+
+size_t GetContextWindowTokens(std::string_view model_name) {
+  size_t tokens = 0;
+  size_t matched_length = 0;
+  for (const ContextWindow& window : kContextWindows) {
+    std::string_view prefix(window.prefix);
+    if (model_name.substr(0, prefix.size()) == prefix &&
+        prefix.size() > matched_length) {
+      tokens = window.tokens;
+      matched_length = prefix.size();
+    }
+  }
+  return tokens;
+}
+
+size_t GetMaxInputTokens(std::string_view model_name,
+                         size_t max_output_tokens) {
+  size_t window = GetContextWindowTokens(model_name);
+  return window > max_output_tokens ? window - max_output_tokens : window;
+}
+
+}  // namespace adapters
+}  // namespace asol
@@ -0,0 +1,74 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_ADAPTERS_PROVIDER_TOKEN_COUNTER_H_
+#define ASOL_ADAPTERS_PROVIDER_TOKEN_COUNTER_H_
+
+#include <cstddef>
+#include <string_view>
+
+#include "asol/core/token_counter.h"
+
+namespace asol {
+namespace adapters {
+
+// ProviderTokenCounter estimates what a provider family's BPE tokenizer
+// makes of a text, without shipping its vocabulary. The text is split the
+// way the family's pre-tokenizer splits it: words with their leading space,
+// digit groups, punctuation runs, whitespace runs and single CJK
+// characters. Each piece is then charged by how many bytes the family's
+// merges typically cover. Counts are estimates, close enough to size a
+// request against the context window and to price it, not to bill by.
+//
+// Letter runs, which make up most text, are scanned 16 bytes at a time
+// with SSE2 or NEON.
+class ProviderTokenCounter : public core::TokenCounter {
+ public:
+  enum class Family {
+    // OpenAI o200k/cl100k and the APIs that share them, e.g. Copilot
+    kOpenAI,
+    kAnthropic,
+    // Gemini's SentencePiece, which gives every digit its own token
+    kGemini,
+  };
+
+  // The counter for |family|, which lives for the whole process
+  static const ProviderTokenCounter& Get(Family family);
+
+  ProviderTokenCounter(const ProviderTokenCounter&) = delete;
+  ProviderTokenCounter& operator=(const ProviderTokenCounter&) = delete;
+
+  // core::TokenCounter implementation
+  size_t CountTokens(std::string_view text) const override;
+  size_t FitPrefix(std::string_view text, size_t max_tokens) const override;
+
+  // How the family's merges cover each kind of piece
+  struct Profile {
+    // Weight of letters one token covers past a word's first token, where
+    // an ASCII letter weighs one and any other character two
+    size_t word_weight_per_token;
+    size_t digits_per_token;
+    size_t punctuation_per_token;
+    size_t whitespace_per_token;
+  };
+
+  explicit ProviderTokenCounter(const Profile& profile);
+  ~ProviderTokenCounter() override;
+
+ private:
+  const Profile profile_;
+};
+
+// Context window of |model_name| in tokens, input and output together, by
+// the longest known prefix of the name; 0 if the model is unknown
+size_t GetContextWindowTokens(std::string_view model_name);
+
+// Tokens left for the prompt of |model_name| once |max_output_tokens| are
+// reserved for the response; 0 if the model is unknown
+size_t GetMaxInputTokens(std::string_view model_name, size_t max_output_tokens);
+
+}  // namespace adapters
+}  // namespace asol
+
+#endif  // ASOL_ADAPTERS_PROVIDER_TOKEN_COUNTER_H_
@@ -0,0 +1,81 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/provider_token_counter.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace adapters {
+namespace {
+
+using Family = ProviderTokenCounter::Family;
+
+TEST(ProviderTokenCounterTest, CountsPreTokenizerPieces) {
+  const ProviderTokenCounter& counter =
+      ProviderTokenCounter::Get(Family::kOpenAI);
+
+  EXPECT_EQ(counter.CountTokens(""), 0u);
+  // Every word is one token with its leading space, as is the period
+  EXPECT_EQ(
+      counter.CountTokens("The quick brown fox jumps over the lazy dog."),
+      10u);
+  // Long words take several
+  EXPECT_EQ(counter.CountTokens("internationalization"), 4u);
+  // One token per CJK character
+  EXPECT_EQ(counter.CountTokens("\xE4\xBD\xA0\xE5\xA5\xBD\xE4\xB8\x96"), 3u);
+}
+
+TEST(ProviderTokenCounterTest, FamiliesGroupDigitsDifferently) {
+  EXPECT_EQ(ProviderTokenCounter::Get(Family::kOpenAI).CountTokens("1234567"),
+            3u);
+  EXPECT_EQ(ProviderTokenCounter::Get(Family::kGemini).CountTokens("1234567"),
+            7u);
+}
+
+TEST(ProviderTokenCounterTest, FitPrefixStaysWithinLimit) {
+  const ProviderTokenCounter& counter =
+      ProviderTokenCounter::Get(Family::kAnthropic);
+  std::string text;
+  for (int i = 0; i < 50; ++i) {
+    text += "caf\xC3\xA9 1984 \xE4\xBD\xA0 (x) supercalifragilistic\n\n";
+  }
+  size_t total = counter.CountTokens(text);
+
+  for (size_t max_tokens = 0; max_tokens <= total; max_tokens += 7) {
+    size_t length = counter.FitPrefix(text, max_tokens);
+    EXPECT_LE(counter.CountTokens(std::string_view(text).substr(0, length)),
+              max_tokens);
+    // Never inside a UTF-8 sequence
+    EXPECT_NE(static_cast<unsigned char>(text[length]) & 0xC0, 0x80);
+  }
+  EXPECT_EQ(counter.FitPrefix(text, total), text.size());
+}
+
+TEST(ProviderTokenCounterTest, FitPrefixSplitsLongRuns) {
+  // A run with no spaces, like base64, still yields a prefix
+  std::string blob(1000, 'A');
+  const ProviderTokenCounter& counter =
+      ProviderTokenCounter::Get(Family::kOpenAI);
+  size_t length = counter.FitPrefix(blob, 10);
+  EXPECT_GT(length, 0u);
+  EXPECT_LE(counter.CountTokens(std::string_view(blob).substr(0, length)),
+            10u);
+}
+
+TEST(ProviderTokenCounterTest, LooksUpContextWindows) {
+  EXPECT_EQ(GetContextWindowTokens("gpt-4o-mini"), 128000u);
+  EXPECT_EQ(GetContextWindowTokens("gpt-4-0613"), 8192u);
+  EXPECT_EQ(GetContextWindowTokens("claude-3-opus-20240229"), 200000u);
+  EXPECT_EQ(GetContextWindowTokens("unknown-model"), 0u);
+
+  EXPECT_EQ(GetMaxInputTokens("gpt-4", 1024), 7168u);
+  EXPECT_EQ(GetMaxInputTokens("unknown-model", 1024), 0u);
+}
+
+}  // namespace
+}  // namespace adapters
+}  // namespace asol
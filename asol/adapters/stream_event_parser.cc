@@ -0,0 +1,255 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/stream_event_parser.h"
+
+#include <utility>
+
+#include "asol/adapters/json_field_reader.h"
+
+namespace asol {
+namespace adapters {
+
+namespace {
+
+// Sentinel OpenAI-style streams send after the last event
+constexpr std::string_view kDoneSentinel = "[DONE]";
+
+bool IsJsonWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+size_t SkipWhitespace(std::string_view json, size_t pos) {
+  while (pos < json.size() && IsJsonWhitespace(json[pos])) {
+    pos++;
+  }
+  return pos;
+}
+
+// Index of the quote closing the string whose contents start at |pos|
+size_t FindStringEnd(std::string_view json, size_t pos) {
+  while (pos < json.size()) {
+    if (json[pos] == '\\') {
+      pos += 2;
+    } else if (json[pos] == '"') {
+      return pos;
+    } else {
+      pos++;
+    }
+  }
+  return std::string_view::npos;
+}
+
+}  // namespace
+
+StreamEventParser::StreamEventParser(Format format,
+                                     std::string delta_key,
+                                     EventCallback callback)
+    : format_(format),
+      delta_key_(std::move(delta_key)),
+      callback_(std::move(callback)) {}
+
+StreamEventParser::~StreamEventParser() = default;
+
+void StreamEventParser::Append(std::string_view chunk) {
+  if (done_) {
+    return;
+  }
+
+  // Complete the line left over from the previous chunk
+  if (!partial_line_.empty()) {
+    size_t newline = chunk.find('\n');
+    if (newline == std::string_view::npos) {
+      partial_line_.append(chunk);
+      return;
+    }
+    partial_line_.append(chunk.substr(0, newline));
+    ProcessLine(partial_line_, /*stable=*/false);
+    partial_line_.clear();
+    chunk.remove_prefix(newline + 1);
+  }
+
+  // Whole lines are parsed in place
+  size_t start = 0;
+  while (!done_) {
+    size_t newline = chunk.find('\n', start);
+    if (newline == std::string_view::npos) {
+      break;
+    }
+    ProcessLine(chunk.substr(start, newline - start), /*stable=*/true);
+    start = newline + 1;
+  }
+  if (done_) {
+    return;
+  }
+
+  partial_line_.assign(chunk.substr(start));
+  // Views into |chunk| do not survive this call
+  OwnEventData();
+}
+
+void StreamEventParser::Finish() {
+  if (done_) {
+    return;
+  }
+  if (!partial_line_.empty()) {
+    ProcessLine(partial_line_, /*stable=*/false);
+    partial_line_.clear();
+  }
+  if (format_ == Format::SERVER_SENT_EVENTS && !done_) {
+    DispatchPendingEvent();
+  }
+}
+
+// static
+bool StreamEventParser::FindStringField(std::string_view json,
+                                        std::string_view key,
+                                        std::string* scratch,
+                                        std::string_view* value) {
+  size_t pos = 0;
+  while (pos < json.size()) {
+    if (json[pos] != '"') {
+      pos++;
+      continue;
+    }
+
+    size_t token_end = FindStringEnd(json, pos + 1);
+    if (token_end == std::string_view::npos) {
+      return false;
+    }
+    std::string_view token = json.substr(pos + 1, token_end - pos - 1);
+    pos = token_end + 1;
+
+    // Only a string followed by ':' is a key; values are skipped whole
+    size_t colon = SkipWhitespace(json, pos);
+    if (colon >= json.size() || json[colon] != ':' || token != key) {
+      continue;
+    }
+
+    size_t value_start = SkipWhitespace(json, colon + 1);
+    if (value_start >= json.size() || json[value_start] != '"') {
+      // Not a string, e.g. null; a later field may still match
+      pos = value_start;
+      continue;
+    }
+    size_t value_end = FindStringEnd(json, value_start + 1);
+    if (value_end == std::string_view::npos) {
+      return false;
+    }
+
+    std::string_view raw =
+        json.substr(value_start + 1, value_end - value_start - 1);
+    if (raw.find('\\') == std::string_view::npos) {
+      *value = raw;
+      return true;
+    }
+    if (!JsonFieldReader::DecodeString(raw, scratch)) {
+      return false;
+    }
+    *value = *scratch;
+    return true;
+  }
+  return false;
+}
+
+void StreamEventParser::ProcessLine(std::string_view line, bool stable) {
+  if (!line.empty() && line.back() == '\r') {
+    line.remove_suffix(1);
+  }
+
+  if (format_ == Format::SERVER_SENT_EVENTS) {
+    ProcessSseField(line, stable);
+    return;
+  }
+
+  size_t first = SkipWhitespace(line, 0);
+  if (first < line.size()) {
+    Dispatch(std::string_view(), line.substr(first));
+  }
+}
+
+void StreamEventParser::ProcessSseField(std::string_view line, bool stable) {
+  // A blank line ends the event; a leading colon marks a comment
+  if (line.empty()) {
+    DispatchPendingEvent();
+    return;
+  }
+  if (line.front() == ':') {
+    return;
+  }
+
+  size_t colon = line.find(':');
+  std::string_view field = line.substr(0, colon);
+  std::string_view value;
+  if (colon != std::string_view::npos) {
+    value = line.substr(colon + 1);
+    if (!value.empty() && value.front() == ' ') {
+      value.remove_prefix(1);
+    }
+  }
+
+  if (field == "data") {
+    if (!has_event_data_) {
+      has_event_data_ = true;
+      if (stable) {
+        event_data_ = value;
+        event_data_owned_ = false;
+      } else {
+        owned_event_data_.assign(value);
+        event_data_ = owned_event_data_;
+        event_data_owned_ = true;
+      }
+    } else {
+      // Multi-line data is rare; join it in owned storage
+      OwnEventData();
+      owned_event_data_.push_back('\n');
+      owned_event_data_.append(value);
+      event_data_ = owned_event_data_;
+    }
+  } else if (field == "event") {
+    event_type_.assign(value);
+  }
+  // "id" and "retry" are not needed for completions
+}
+
+void StreamEventParser::DispatchPendingEvent() {
+  if (has_event_data_) {
+    Dispatch(event_type_, event_data_);
+  }
+  event_type_.clear();
+  event_data_ = std::string_view();
+  owned_event_data_.clear();
+  has_event_data_ = false;
+  event_data_owned_ = false;
+}
+
+void StreamEventParser::Dispatch(std::string_view type,
+                                 std::string_view data) {
+  if (data == kDoneSentinel) {
+    done_ = true;
+    return;
+  }
+
+  Event event;
+  event.type = type;
+  event.data = data;
+  std::string_view delta;
+  if (FindStringField(data, delta_key_, &delta_scratch_, &delta)) {
+    event.delta = delta;
+  }
+  events_dispatched_++;
+  callback_.Run(event);
+}
+
+void StreamEventParser::OwnEventData() {
+  if (!has_event_data_ || event_data_owned_) {
+    return;
+  }
+  owned_event_data_.assign(event_data_);
+  event_data_ = owned_event_data_;
+  event_data_owned_ = true;
+}
+
+}  // namespace adapters
+}  // namespace asol
@@ -0,0 +1,114 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_ADAPTERS_STREAM_EVENT_PARSER_H_
+#define ASOL_ADAPTERS_STREAM_EVENT_PARSER_H_
+
+#include <string>
+#include <string_view>
+
+#include "base/functional/callback.h"
+
+namespace asol {
+namespace adapters {
+
+// StreamEventParser splits a streamed completion into events as bytes
+// arrive, for server-sent events (SSE) and newline-delimited JSON. Each
+// byte is scanned once: complete lines are read in place from the chunk
+// passed to Append(), and only an unterminated tail is copied until the
+// next chunk completes it. For every event the delta text is pulled from
+// the payload by key without building a JSON tree, so per-token cost stays
+// flat however long the generation runs.
+class StreamEventParser {
+ public:
+  enum class Format {
+    SERVER_SENT_EVENTS,  // "event:"/"data:" fields, blank-line terminated
+    JSON_LINES,          // One JSON document per line
+  };
+
+  // One decoded event. Views are only valid during the callback.
+  struct Event {
+    // SSE "event:" field; empty when absent or for JSON lines
+    std::string_view type;
+
+    // Raw payload
+    std::string_view data;
+
+    // Unescaped value of the first string field named |delta_key|; empty
+    // when the event carries none
+    std::string_view delta;
+  };
+
+  using EventCallback = base::RepeatingCallback<void(const Event&)>;
+
+  // |delta_key| names the JSON field holding incremental text, e.g. "text"
+  // for Gemini and Claude or "content" for OpenAI.
+  StreamEventParser(Format format,
+                    std::string delta_key,
+                    EventCallback callback);
+  ~StreamEventParser();
+
+  StreamEventParser(const StreamEventParser&) = delete;
+  StreamEventParser& operator=(const StreamEventParser&) = delete;
+
+  // Feed the next slice of the response body
+  void Append(std::string_view chunk);
+
+  // Treat the end of the body as the end of the last line and event
+  void Finish();
+
+  // Whether the stream sent its "[DONE]" sentinel; later input is ignored
+  bool done() const { return done_; }
+
+  size_t events_dispatched() const { return events_dispatched_; }
+
+  // Find the first string field named |key| in |json| in a single pass.
+  // |value| views |json| directly unless the string contains escapes, in
+  // which case it is decoded into |scratch|. Returns false if no such
+  // string field exists or it is malformed.
+  static bool FindStringField(std::string_view json,
+                              std::string_view key,
+                              std::string* scratch,
+                              std::string_view* value);
+
+ private:
+  // |stable| is false when |line| lives in storage reused by later input
+  void ProcessLine(std::string_view line, bool stable);
+
+  void ProcessSseField(std::string_view line, bool stable);
+
+  // Dispatch the SSE event collected so far, if any
+  void DispatchPendingEvent();
+
+  void Dispatch(std::string_view type, std::string_view data);
+
+  // Copy the pending event's data out of the caller's chunk
+  void OwnEventData();
+
+  const Format format_;
+  const std::string delta_key_;
+  EventCallback callback_;
+
+  // Unterminated last line of the input seen so far
+  std::string partial_line_;
+
+  // Pending SSE event. |event_data_| views either the current chunk or
+  // |owned_event_data_|.
+  std::string event_type_;
+  std::string_view event_data_;
+  std::string owned_event_data_;
+  bool has_event_data_ = false;
+  bool event_data_owned_ = false;
+
+  // Decoding buffer for deltas that contain escapes
+  std::string delta_scratch_;
+
+  bool done_ = false;
+  size_t events_dispatched_ = 0;
+};
+
+}  // namespace adapters
+}  // namespace asol
+
+#endif  // ASOL_ADAPTERS_STREAM_EVENT_PARSER_H_
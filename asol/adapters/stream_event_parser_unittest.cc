@@ -0,0 +1,111 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/adapters/stream_event_parser.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace adapters {
+namespace {
+
+class StreamEventParserTest : public testing::Test {
+ protected:
+  std::unique_ptr<StreamEventParser> CreateParser(
+      StreamEventParser::Format format,
+      const std::string& delta_key) {
+    return std::make_unique<StreamEventParser>(
+        format, delta_key,
+        base::BindRepeating(&StreamEventParserTest::OnEvent,
+                            base::Unretained(this)));
+  }
+
+  void OnEvent(const StreamEventParser::Event& event) {
+    types_.emplace_back(event.type);
+    deltas_.emplace_back(event.delta);
+  }
+
+  std::vector<std::string> types_;
+  std::vector<std::string> deltas_;
+};
+
+TEST_F(StreamEventParserTest, EmitsDeltasFromSplitServerSentEvents) {
+  auto parser = CreateParser(StreamEventParser::Format::SERVER_SENT_EVENTS,
+                             "text");
+  std::string body =
+      ": keep-alive\r\n"
+      "data: {\"candidates\":[{\"content\":{\"parts\":[{\"text\":\"Hel\"}]}}]}"
+      "\r\n\r\n"
+      "event: content_block_delta\n"
+      "data: {\"delta\":{\"type\":\"text\",\"text\":\"lo\"}}\n\n";
+
+  // Feed one byte at a time so every line straddles a chunk boundary
+  for (char c : body) {
+    parser->Append(std::string_view(&c, 1));
+  }
+
+  ASSERT_EQ(deltas_.size(), 2u);
+  EXPECT_EQ(deltas_[0], "Hel");
+  EXPECT_EQ(types_[0], "");
+  EXPECT_EQ(deltas_[1], "lo");
+  EXPECT_EQ(types_[1], "content_block_delta");
+}
+
+TEST_F(StreamEventParserTest, StopsAtDoneSentinel) {
+  auto parser = CreateParser(StreamEventParser::Format::SERVER_SENT_EVENTS,
+                             "content");
+  parser->Append(
+      "data: {\"choices\":[{\"delta\":{\"role\":\"assistant\","
+      "\"content\":null}}]}\n\n"
+      "data: {\"choices\":[{\"delta\":{\"content\":\"Hi\"}}]}\n\n"
+      "data: [DONE]\n\n"
+      "data: {\"choices\":[{\"delta\":{\"content\":\"late\"}}]}\n\n");
+
+  EXPECT_TRUE(parser->done());
+  ASSERT_EQ(deltas_.size(), 2u);
+  EXPECT_EQ(deltas_[0], "");
+  EXPECT_EQ(deltas_[1], "Hi");
+}
+
+TEST_F(StreamEventParserTest, ParsesJsonLinesAndFinishesTrailingLine) {
+  auto parser = CreateParser(StreamEventParser::Format::JSON_LINES, "text");
+  parser->Append("{\"text\":\"a\"}\n\n{\"te");
+  parser->Append("xt\":\"b\"}");
+  EXPECT_EQ(deltas_.size(), 1u);
+
+  parser->Finish();
+  ASSERT_EQ(deltas_.size(), 2u);
+  EXPECT_EQ(deltas_[1], "b");
+  EXPECT_EQ(parser->events_dispatched(), 2u);
+}
+
+TEST(StreamEventParserFieldTest, MatchesKeysNotValues) {
+  std::string scratch;
+  std::string_view value;
+  EXPECT_TRUE(StreamEventParser::FindStringField(
+      "{\"type\":\"text\",\"note\":\"\\\"text\\\": no\",\"text\":\"yes\"}",
+      "text", &scratch, &value));
+  EXPECT_EQ(value, "yes");
+
+  EXPECT_FALSE(StreamEventParser::FindStringField("{\"other\":\"x\"}", "text",
+                                                  &scratch, &value));
+}
+
+TEST(StreamEventParserFieldTest, DecodesEscapes) {
+  std::string scratch;
+  std::string_view value;
+  ASSERT_TRUE(StreamEventParser::FindStringField(
+      "{\"text\":\"a\\nb \\\"q\\\" \\u00e9 \\ud83d\\ude00\"}", "text",
+      &scratch, &value));
+  EXPECT_EQ(value, "a\nb \"q\" \xC3\xA9 \xF0\x9F\x98\x80");
+}
+
+}  // namespace
+}  // namespace adapters
+}  // namespace asol
@@ -41,6 +41,7 @@ AsolBrowserIntegration::~AsolBrowserIntegration() {
 }
 
 void AsolBrowserIntegration::ShowAiPanel() {
+  Wake();
   if (!ui_controller_) {
     return;
   }
@@ -96,6 +97,25 @@ bool AsolBrowserIntegration::Initialize() {
   return ui_controller_->Initialize(config_json);
 }
 
+void AsolBrowserIntegration::Hibernate() {
+  if (is_hibernated_ || is_panel_visible_) {
+    return;
+  }
+  
+  ui_controller_.reset();
+  is_hibernated_ = true;
+}
+
+void AsolBrowserIntegration::Wake() {
+  if (!is_hibernated_) {
+    return;
+  }
+  
+  is_hibernated_ = false;
+  ui_controller_ = ui::AsolUiController::Create();
+  Initialize();
+}
+
 void AsolBrowserIntegration::WebContentsDestroyed() {
   // Hide the AI panel before the web contents is destroyed
   HideAiPanel();
@@ -41,12 +41,18 @@ class AsolBrowserIntegration
   // Toggle the AI panel
   void ToggleAiPanel();
 
-  // Get the UI controller
+  // Get the UI controller. Null while hibernated.
   ui::AsolUiController* GetUiController() const;
 
   // Initialize the browser integration
   bool Initialize();
 
+  // Release the UI controller while the tab is in the background, unless
+  // the AI panel is showing, and recreate it. See TabHibernationManager.
+  void Hibernate();
+  void Wake();
+  bool is_hibernated() const { return is_hibernated_; }
+
  private:
   // Allow WebContentsUserData to create instances of this class
   friend class content::WebContentsUserData<AsolBrowserIntegration>;
@@ -67,6 +73,9 @@ class AsolBrowserIntegration
   // Whether the AI panel is visible
   bool is_panel_visible_ = false;
 
+  // Whether the UI controller was released by Hibernate()
+  bool is_hibernated_ = false;
+
   // For generating weak pointers to this
   base::WeakPtrFactory<AsolBrowserIntegration> weak_ptr_factory_{this};
 
@@ -6,6 +6,7 @@
 
 #include <memory>
 
+#include "asol/browser/tab_hibernation_manager.h"
 #include "asol/ui/asol_ui_controller.h"
 #include "base/test/task_environment.h"
 #include "content/public/browser/web_contents.h"
@@ -88,6 +89,56 @@ TEST_F(AsolBrowserIntegrationTest, ToggleAiPanel) {
   EXPECT_FALSE(browser_integration_->GetUiController()->IsAiPanelVisible());
 }
 
+TEST_F(AsolBrowserIntegrationTest, HibernateReleasesUiController) {
+  TabHibernationManager::CreateForWebContents(web_contents_.get());
+  auto* manager = TabHibernationManager::FromWebContents(web_contents_.get());
+  
+  manager->Hibernate();
+  EXPECT_TRUE(browser_integration_->is_hibernated());
+  EXPECT_FALSE(browser_integration_->GetUiController());
+  
+  manager->Wake();
+  EXPECT_FALSE(browser_integration_->is_hibernated());
+  EXPECT_TRUE(browser_integration_->GetUiController());
+}
+
+TEST_F(AsolBrowserIntegrationTest, HibernateKeepsVisiblePanel) {
+  browser_integration_->ShowAiPanel();
+  browser_integration_->Hibernate();
+  
+  // The panel is in use, so its controller stays
+  EXPECT_FALSE(browser_integration_->is_hibernated());
+  EXPECT_TRUE(browser_integration_->GetUiController()->IsAiPanelVisible());
+}
+
+TEST_F(AsolBrowserIntegrationTest, ShowAiPanelWakes) {
+  browser_integration_->Hibernate();
+  browser_integration_->ShowAiPanel();
+  
+  EXPECT_FALSE(browser_integration_->is_hibernated());
+  EXPECT_TRUE(browser_integration_->GetUiController()->IsAiPanelVisible());
+}
+
+TEST(TabHibernationManagerTest, PackStateRoundTrips) {
+  base::Value::Dict state;
+  state.Set("current_session_id", "abc");
+  base::Value::List pages;
+  for (int i = 0; i < 100; ++i) {
+    pages.Append("The same page content, over and over again.");
+  }
+  state.Set("pages", std::move(pages));
+  
+  std::string packed = TabHibernationManager::PackState(state);
+  ASSERT_FALSE(packed.empty());
+  
+  std::optional<base::Value::Dict> unpacked =
+      TabHibernationManager::UnpackState(packed);
+  ASSERT_TRUE(unpacked);
+  EXPECT_EQ(state, *unpacked);
+  
+  EXPECT_FALSE(TabHibernationManager::UnpackState("not gzip"));
+}
+
 }  // namespace
 }  // namespace browser
 }  // namespace asol
\ No newline at end of file
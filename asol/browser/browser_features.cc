@@ -50,6 +50,9 @@ const base::Feature kAsolWorkMode{"AsolWorkMode",
 const base::Feature kAsolGamingMode{"AsolGamingMode",
                                    base::FEATURE_ENABLED_BY_DEFAULT};
 
+const base::Feature kAsolTabHibernation{"AsolTabHibernation",
+                                       base::FEATURE_ENABLED_BY_DEFAULT};
+
 // Feature parameters
 const base::FeatureParam<int> kAsolResponseCacheSizeParam{
     &kAsolResponseCaching, "cache_size", 100};
@@ -102,5 +105,8 @@ const base::FeatureParam<bool> kAsolAutoDetectGamesParam{
 const base::FeatureParam<int> kAsolMaxGameInfoParam{
     &kAsolGamingMode, "max_game_info", 50};
 
+const base::FeatureParam<int> kAsolTabHibernationIdleSecondsParam{
+    &kAsolTabHibernation, "idle_seconds", 600};  // 10 minutes
+
 }  // namespace browser
 }  // namespace asol
\ No newline at end of file
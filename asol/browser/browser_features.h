@@ -61,6 +61,9 @@ extern const base::Feature kAsolWorkMode;
 // This feature enables the ASOL gaming mode
 extern const base::Feature kAsolGamingMode;
 
+// This feature enables freeing the AI state of background tabs
+extern const base::Feature kAsolTabHibernation;
+
 // Feature parameters
 
 // Maximum number of responses to cache
@@ -114,6 +117,9 @@ extern const base::FeatureParam<bool> kAsolAutoDetectGamesParam;
 // Maximum number of game info entries to store in gaming mode
 extern const base::FeatureParam<int> kAsolMaxGameInfoParam;
 
+// Seconds a tab must be hidden before its AI state is hibernated
+extern const base::FeatureParam<int> kAsolTabHibernationIdleSecondsParam;
+
 }  // namespace browser
 }  // namespace asol
 
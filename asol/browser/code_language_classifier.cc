@@ -0,0 +1,447 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/browser/code_language_classifier.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "base/no_destructor.h"
+#include "base/strings/string_util.h"
+
+namespace asol {
+namespace browser {
+
+namespace {
+
+enum Language : size_t {
+  kPython,
+  kJavaScript,
+  kTypeScript,
+  kJava,
+  kCpp,
+  kC,
+  kCSharp,
+  kGo,
+  kRust,
+  kRuby,
+  kPhp,
+  kSwift,
+  kKotlin,
+  kHtml,
+  kCss,
+  kSql,
+  kBash,
+  kLanguageCount,
+};
+
+constexpr std::array<const char*, kLanguageCount> kLanguageNames = {
+    "python", "javascript", "typescript", "java", "c++",   "c",
+    "c#",     "go",         "rust",       "ruby", "php",   "swift",
+    "kotlin", "html",       "css",        "sql",  "bash",
+};
+
+// The language a language extends, whose code it can contain as it is,
+// or kLanguageCount
+constexpr Language GetBaseLanguage(Language language) {
+  switch (language) {
+    case kTypeScript:
+      return kJavaScript;
+    case kCpp:
+      return kC;
+    default:
+      return kLanguageCount;
+  }
+}
+
+bool AreRelated(Language a, Language b) {
+  return a == b || GetBaseLanguage(a) == b || GetBaseLanguage(b) == a;
+}
+
+// Tokens are separated by spaces. "_" matches any word, and "STR" any
+// string literal.
+struct Feature {
+  const char* tokens;
+  Language language;
+  float weight;
+};
+
+constexpr Feature kFeatures[] = {
+    {"def _", kPython, 2},         {"elif", kPython, 3},
+    {"self .", kPython, 2},        {"__init__", kPython, 3},
+    {"__name__", kPython, 3},      {"None", kPython, 1.5},
+    {"True", kPython, 1},          {"False", kPython, 1},
+    {"import _", kPython, 1},      {"from _", kPython, 1},
+    {"lambda", kPython, 1.5},      {"print (", kPython, 1},
+    {"range (", kPython, 1.5},     {"len (", kPython, 1.5},
+    {"not in", kPython, 2},        {"is not", kPython, 2},
+    {"except", kPython, 1.5},      {"with open", kPython, 3},
+    {"async def", kPython, 2},     {") :", kPython, 1.5},
+    {"else :", kPython, 2},        {"try :", kPython, 3},
+
+    {"const _", kJavaScript, 1.5}, {"let _", kJavaScript, 1},
+    {"var _", kJavaScript, 1},     {"function _", kJavaScript, 1.5},
+    {"function (", kJavaScript, 2}, {"=>", kJavaScript, 1},
+    {"console .", kJavaScript, 3}, {"===", kJavaScript, 2},
+    {"!==", kJavaScript, 2},       {"document .", kJavaScript, 2.5},
+    {"window .", kJavaScript, 2},  {"require (", kJavaScript, 2},
+    {"undefined", kJavaScript, 2}, {"export default", kJavaScript, 2},
+    {"module .", kJavaScript, 1.5}, {"from STR", kJavaScript, 1.5},
+    {"this .", kJavaScript, 1},    {"new Promise", kJavaScript, 2},
+    {"JSON .", kJavaScript, 2},    {". then", kJavaScript, 1.5},
+    {"addEventListener", kJavaScript, 2.5},
+    {"typeof", kJavaScript, 1.5},
+
+    {"interface _", kTypeScript, 2}, {": string", kTypeScript, 2.5},
+    {": number", kTypeScript, 3},  {": boolean", kTypeScript, 3},
+    {": any", kTypeScript, 2.5},   {": void", kTypeScript, 2},
+    {"type _", kTypeScript, 1},    {"readonly", kTypeScript, 1.5},
+    {"implements", kTypeScript, 1}, {"as const", kTypeScript, 2},
+
+    {"public class", kJava, 2},    {"System .", kJava, 3},
+    {"public static", kJava, 1.5}, {"static void", kJava, 1.5},
+    {"@ Override", kJava, 3},      {"String [", kJava, 2},
+    {"import java", kJava, 4},     {"throws", kJava, 2},
+    {"extends", kJava, 1},         {"package _", kJava, 1},
+    {"final", kJava, 1},           {"private final", kJava, 2},
+    {"ArrayList", kJava, 2},       {"List <", kJava, 1},
+    {"String _", kJava, 1},        {"boolean", kJava, 1},
+
+    {"std ::", kCpp, 3},           {"template <", kCpp, 3},
+    {"namespace _", kCpp, 1.5},    {"nullptr", kCpp, 3},
+    {"cout", kCpp, 2.5},           {"endl", kCpp, 3},
+    {"public :", kCpp, 2.5},       {"private :", kCpp, 2.5},
+    {"protected :", kCpp, 2.5},    {"auto", kCpp, 1},
+    {"virtual", kCpp, 2},          {"::", kCpp, 1},
+    {"iostream", kCpp, 3},         {"vector <", kCpp, 1.5},
+    {"unique_ptr", kCpp, 3},
+
+    {"# include", kC, 2},          {"# define", kC, 2},
+    {"printf (", kC, 1.5},         {"malloc (", kC, 2},
+    {"free (", kC, 1},             {"int main", kC, 1.5},
+    {"sizeof", kC, 1},             {"struct _", kC, 1},
+    {"NULL", kC, 1.5},             {"void", kC, 0.5},
+    {"unsigned", kC, 1.5},         {"typedef", kC, 2},
+    {"char *", kC, 2},             {"int _", kC, 0.5},
+    {"stdio", kC, 3},              {"stdlib", kC, 3},
+
+    {"using System", kCSharp, 4},  {"Console .", kCSharp, 3},
+    {"namespace _", kCSharp, 0.5}, {"Task <", kCSharp, 2},
+    {"get ;", kCSharp, 3},         {"set ;", kCSharp, 3},
+    {"public async", kCSharp, 1.5}, {"async Task", kCSharp, 3},
+    {"string _", kCSharp, 1},      {"public class", kCSharp, 1.5},
+    {"static void", kCSharp, 1},   {"List <", kCSharp, 1},
+    {"foreach", kCSharp, 2},       {"override", kCSharp, 1},
+
+    {"func _", kGo, 2},            {"func (", kGo, 2.5},
+    {":=", kGo, 2.5},              {"package main", kGo, 3},
+    {"package _", kGo, 1},         {"fmt .", kGo, 3},
+    {"chan", kGo, 2},              {"go func", kGo, 3},
+    {"defer", kGo, 2},             {"err !=", kGo, 3},
+    {"nil", kGo, 1.5},             {"struct {", kGo, 1.5},
+    {"interface {", kGo, 2},       {"import (", kGo, 2},
+    {"make (", kGo, 1.5},
+
+    {"fn _", kRust, 3},            {"let mut", kRust, 3},
+    {"impl _", kRust, 2.5},        {"impl <", kRust, 2},
+    {"use std", kRust, 3},         {"pub fn", kRust, 3},
+    {"pub struct", kRust, 2.5},    {"println !", kRust, 3},
+    {"vec !", kRust, 3},           {"& mut", kRust, 3},
+    {"& self", kRust, 2.5},        {"mut", kRust, 1},
+    {"match _", kRust, 1},         {"Some (", kRust, 1.5},
+    {"Ok (", kRust, 1.5},          {"Err (", kRust, 1.5},
+    {"unwrap", kRust, 2},          {"Vec <", kRust, 2},
+    {"Option <", kRust, 2},        {"Result <", kRust, 2},
+    {"->", kRust, 0.5},
+
+    {"def _", kRuby, 1},           {"end", kRuby, 1.5},
+    {"puts", kRuby, 2.5},          {"elsif", kRuby, 3},
+    {"require STR", kRuby, 2.5},   {"require_relative", kRuby, 3},
+    {"do |", kRuby, 2.5},          {"attr_accessor", kRuby, 3},
+    {"nil", kRuby, 1},             {"unless", kRuby, 2},
+    {". each", kRuby, 1.5},        {"module _", kRuby, 1.5},
+    {". new", kRuby, 1},
+
+    {"<?", kPhp, 4},               {"?>", kPhp, 3},
+    {"$ _", kPhp, 1.5},            {"$ this", kPhp, 3},
+    {"->", kPhp, 1},               {"public function", kPhp, 3},
+    {"echo", kPhp, 1},             {"array (", kPhp, 2},
+
+    {"func _", kSwift, 1.5},       {"import UIKit", kSwift, 4},
+    {"import Foundation", kSwift, 3}, {"import SwiftUI", kSwift, 4},
+    {"guard", kSwift, 2.5},        {"let _", kSwift, 0.5},
+    {"@ IBOutlet", kSwift, 4},     {"@ State", kSwift, 3},
+    {"override func", kSwift, 3},  {"extension _", kSwift, 2},
+    {"protocol _", kSwift, 2},     {"some View", kSwift, 3},
+    {"nil", kSwift, 1},            {"??", kSwift, 1.5},
+    {"init (", kSwift, 1.5},       {"case .", kSwift, 1.5},
+
+    {"fun _", kKotlin, 3},         {"val _", kKotlin, 2.5},
+    {"println (", kKotlin, 1.5},   {"data class", kKotlin, 3},
+    {"override fun", kKotlin, 3},  {"suspend fun", kKotlin, 3},
+    {"companion", kKotlin, 3},     {"lateinit", kKotlin, 3},
+    {"when (", kKotlin, 1.5},      {"?:", kKotlin, 1.5},
+    {"import kotlin", kKotlin, 4}, {"import android", kKotlin, 1.5},
+    {"listOf", kKotlin, 3},        {"mutableListOf", kKotlin, 3},
+    {"object _", kKotlin, 1},
+
+    {"< div", kHtml, 2},           {"< span", kHtml, 2},
+    {"</", kHtml, 2},              {"<!", kHtml, 2.5},
+    {"< html", kHtml, 3},          {"< head", kHtml, 3},
+    {"< body", kHtml, 3},          {"< meta", kHtml, 3},
+    {"< link", kHtml, 2},          {"< script", kHtml, 2},
+    {"< p", kHtml, 1},             {"< a", kHtml, 1},
+    {"< ul", kHtml, 2},            {"< li", kHtml, 2},
+    {"< img", kHtml, 2},           {"< input", kHtml, 2},
+    {"< button", kHtml, 2},        {"< form", kHtml, 2},
+    {"/>", kHtml, 1},              {"class =", kHtml, 1},
+    {"href =", kHtml, 2},          {"src =", kHtml, 1.5},
+
+    {"px ;", kCss, 2.5},           {"em ;", kCss, 1.5},
+    {"rem ;", kCss, 2},            {"@ media", kCss, 3},
+    {"@ keyframes", kCss, 3},      {"! important", kCss, 3},
+    {"color :", kCss, 2},          {"margin :", kCss, 2},
+    {"padding :", kCss, 2},        {"display :", kCss, 2.5},
+    {"position :", kCss, 2},       {"background :", kCss, 2},
+    {"border :", kCss, 2},         {"width :", kCss, 1.5},
+    {"height :", kCss, 1.5},       {"rgba (", kCss, 2},
+    {"hover", kCss, 1.5},          {"font -", kCss, 1},
+
+    {"SELECT", kSql, 2},           {"SELECT *", kSql, 2},
+    {"FROM", kSql, 1},             {"WHERE", kSql, 1.5},
+    {"INSERT INTO", kSql, 3},      {"CREATE TABLE", kSql, 3},
+    {"UPDATE _", kSql, 1},         {"JOIN", kSql, 2},
+    {"GROUP BY", kSql, 3},         {"ORDER BY", kSql, 3},
+    {"VALUES", kSql, 1.5},         {"PRIMARY KEY", kSql, 3},
+    {"NOT NULL", kSql, 2},         {"VARCHAR", kSql, 3},
+    {"select", kSql, 1},           {"select *", kSql, 2},
+    {"insert into", kSql, 3},      {"create table", kSql, 3},
+    {"group by", kSql, 3},         {"order by", kSql, 3},
+    {"inner join", kSql, 3},       {"left join", kSql, 3},
+    {"varchar", kSql, 3},
+
+    {"echo", kBash, 1},            {"$ _", kBash, 0.5},
+    {"$ (", kBash, 1.5},           {"# !", kBash, 3},
+    {"fi", kBash, 3},              {"then", kBash, 1.5},
+    {"esac", kBash, 3},            {"sudo", kBash, 3},
+    {"apt -", kBash, 1.5},         {"npm install", kBash, 3},
+    {"npm run", kBash, 3},         {"pip install", kBash, 3},
+    {"yarn add", kBash, 3},        {"brew install", kBash, 3},
+    {"git clone", kBash, 3},       {"git _", kBash, 1.5},
+    {"cd _", kBash, 1.5},          {"chmod", kBash, 3},
+    {"mkdir", kBash, 2},           {"curl", kBash, 2},
+    {"grep", kBash, 1.5},          {"docker run", kBash, 3},
+    {"docker _", kBash, 1.5},      {"kubectl", kBash, 3},
+    {"cargo", kBash, 2.5},         {"go run", kBash, 2.5},
+    {"go get", kBash, 2.5},
+};
+
+// Least score, and least lead over every unrelated language, for a guess
+// to be confident. A language extending another needs as much from its
+// own entries.
+constexpr float kMinConfidentScore = 3;
+constexpr float kMinConfidentLead = 2;
+
+// Snippets are classified from their start; this is plenty to tell
+constexpr size_t kMaxTokens = 4096;
+
+// Longest first, so the longest operator at a position wins
+constexpr const char* kOperators[] = {
+    "===", "!==", "<?", "?>", "</", "/>", "<!", "::", "->", "=>", ":=",
+    "==",  "!=",  "&&", "||", "<<", ">>", "?:", "??", "++", "--",
+};
+
+constexpr char kStringToken[] = "STR";
+constexpr char kAnyWord[] = "_";
+
+// The features by their tokens, to the indices of those that have them
+const std::unordered_map<std::string, std::vector<size_t>>& GetFeatureMap() {
+  static const base::NoDestructor<
+      std::unordered_map<std::string, std::vector<size_t>>>
+      features([] {
+        std::unordered_map<std::string, std::vector<size_t>> map;
+        for (size_t i = 0; i < std::size(kFeatures); ++i) {
+          map[kFeatures[i].tokens].push_back(i);
+        }
+        return map;
+      }());
+  return *features;
+}
+
+bool IsWordStart(char c) {
+  return base::IsAsciiAlpha(c) || c == '_';
+}
+
+bool IsWordChar(char c) {
+  return base::IsAsciiAlpha(c) || base::IsAsciiDigit(c) || c == '_';
+}
+
+bool IsWord(std::string_view token) {
+  return !token.empty() && IsWordStart(token[0]);
+}
+
+// Split |code| into words, operators and string literals, leaving out
+// numbers, whitespace and comments
+std::vector<std::string_view> Tokenize(std::string_view code) {
+  std::vector<std::string_view> tokens;
+  size_t i = 0;
+  auto skip_line = [&code, &i] {
+    while (i < code.size() && code[i] != '\n') {
+      ++i;
+    }
+  };
+
+  while (i < code.size() && tokens.size() < kMaxTokens) {
+    char c = code[i];
+    if (base::IsAsciiWhitespace(c)) {
+      ++i;
+      continue;
+    }
+
+    if (IsWordStart(c)) {
+      size_t start = i;
+      while (i < code.size() && IsWordChar(code[i])) {
+        ++i;
+      }
+      tokens.push_back(code.substr(start, i - start));
+      continue;
+    }
+
+    if (base::IsAsciiDigit(c)) {
+      // Units stay as words of their own, e.g. the "px" of "10px"
+      while (i < code.size() && (base::IsAsciiDigit(code[i]) || code[i] == '.')) {
+        ++i;
+      }
+      continue;
+    }
+
+    if (c == '"' || c == '\'' || c == '`') {
+      // To the closing quote, or the end of the line for a stray one
+      ++i;
+      while (i < code.size() && code[i] != c && code[i] != '\n') {
+        i += code[i] == '\\' ? 2 : 1;
+      }
+      ++i;
+      tokens.push_back(kStringToken);
+      continue;
+    }
+
+    // Comments say little about the language and much in English
+    if (code.substr(i, 2) == "//") {
+      skip_line();
+      continue;
+    }
+    if (code.substr(i, 2) == "/*") {
+      size_t end = code.find("*/", i + 2);
+      i = end == std::string_view::npos ? code.size() : end + 2;
+      continue;
+    }
+    if (c == '#' && i + 1 < code.size() &&
+        (code[i + 1] == ' ' || code[i + 1] == '\t')) {
+      skip_line();
+      continue;
+    }
+
+    size_t length = 1;
+    for (const char* op : kOperators) {
+      std::string_view op_view(op);
+      if (code.substr(i, op_view.size()) == op_view) {
+        length = op_view.size();
+        break;
+      }
+    }
+    tokens.push_back(code.substr(i, length));
+    i += length;
+  }
+  return tokens;
+}
+
+}  // namespace
+
+// static
+CodeLanguageClassifier::Result CodeLanguageClassifier::Classify(
+    std::string_view code) {
+  const auto& feature_map = GetFeatureMap();
+  std::vector<bool> matched(std::size(kFeatures));
+  std::array<float, kLanguageCount> scores = {};
+
+  auto match = [&](const std::string& key) {
+    auto it = feature_map.find(key);
+    if (it == feature_map.end()) {
+      return;
+    }
+    for (size_t index : it->second) {
+      if (!matched[index]) {
+        matched[index] = true;
+        scores[kFeatures[index].language] += kFeatures[index].weight;
+      }
+    }
+  };
+
+  std::vector<std::string_view> tokens = Tokenize(code);
+  std::string key;
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    key.assign(tokens[i]);
+    match(key);
+    if (i + 1 == tokens.size()) {
+      break;
+    }
+    key += ' ';
+    size_t prefix_size = key.size();
+    key.append(tokens[i + 1]);
+    match(key);
+    if (IsWord(tokens[i + 1])) {
+      key.resize(prefix_size);
+      key += kAnyWord;
+      match(key);
+    }
+  }
+
+  // A language extending another scores its base's entries too, but only
+  // once it has some of its own
+  std::array<float, kLanguageCount> own_scores = scores;
+  for (size_t i = 0; i < kLanguageCount; ++i) {
+    Language base_language = GetBaseLanguage(static_cast<Language>(i));
+    if (base_language != kLanguageCount && own_scores[i] > 0) {
+      scores[i] += own_scores[base_language];
+    }
+  }
+
+  Language best = kLanguageCount;
+  for (size_t i = 0; i < kLanguageCount; ++i) {
+    if (scores[i] > 0 && (best == kLanguageCount || scores[i] > scores[best])) {
+      best = static_cast<Language>(i);
+    }
+  }
+
+  Result result;
+  if (best == kLanguageCount) {
+    return result;
+  }
+
+  float runner_up = 0;
+  for (size_t i = 0; i < kLanguageCount; ++i) {
+    if (!AreRelated(best, static_cast<Language>(i))) {
+      runner_up = std::max(runner_up, scores[i]);
+    }
+  }
+
+  result.language = kLanguageNames[best];
+  result.score = scores[best];
+  result.is_confident =
+      scores[best] >= kMinConfidentScore &&
+      scores[best] >= kMinConfidentLead * runner_up &&
+      (GetBaseLanguage(best) == kLanguageCount ||
+       own_scores[best] >= kMinConfidentScore);
+  return result;
+}
+
+}  // namespace browser
+}  // namespace asol
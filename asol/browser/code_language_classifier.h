@@ -0,0 +1,45 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_BROWSER_CODE_LANGUAGE_CLASSIFIER_H_
+#define ASOL_BROWSER_CODE_LANGUAGE_CLASSIFIER_H_
+
+#include <string>
+#include <string_view>
+
+namespace asol {
+namespace browser {
+
+// CodeLanguageClassifier guesses the programming language of a code
+// snippet locally, in microseconds, so only the snippets it cannot tell
+// apart need to go to a model.
+//
+// The snippet is split into tokens: words, operators, and string literals
+// as a single token. Each language has a table of weighted tokens and
+// token pairs characteristic of it, e.g. "fn _" or "let mut" for Rust,
+// where "_" stands for any word. A snippet scores the weight of each
+// entry it contains, counted once however often it occurs, and goes to
+// the best-scoring language. The guess is confident when it scores well
+// and clearly ahead of every unrelated language: TypeScript is told from
+// JavaScript, and C++ from C, only by the entries of their own.
+class CodeLanguageClassifier {
+ public:
+  struct Result {
+    // Lowercase, as in the language classes of code on the web, e.g.
+    // "python", "c++" or "bash"; empty if nothing matched
+    std::string language;
+    float score = 0;
+    // Whether |language| can be relied on without asking a model
+    bool is_confident = false;
+  };
+
+  CodeLanguageClassifier() = delete;
+
+  static Result Classify(std::string_view code);
+};
+
+}  // namespace browser
+}  // namespace asol
+
+#endif  // ASOL_BROWSER_CODE_LANGUAGE_CLASSIFIER_H_
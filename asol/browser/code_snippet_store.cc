@@ -0,0 +1,93 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/browser/code_snippet_store.h"
+
+#include <utility>
+
+#include "base/hash/hash.h"
+#include "base/strings/string_util.h"
+
+namespace asol {
+namespace browser {
+
+CodeSnippetStore::CodeSnippetStore() = default;
+CodeSnippetStore::~CodeSnippetStore() = default;
+
+// static
+size_t CodeSnippetStore::HashContent(std::string_view code) {
+  // Runs of whitespace count as one space, and leading and trailing
+  // whitespace not at all
+  std::string normalized;
+  normalized.reserve(code.size());
+  bool in_whitespace = false;
+  for (char c : code) {
+    if (base::IsAsciiWhitespace(c)) {
+      in_whitespace = true;
+      continue;
+    }
+    if (in_whitespace && !normalized.empty()) {
+      normalized.push_back(' ');
+    }
+    in_whitespace = false;
+    normalized.push_back(c);
+  }
+  return base::FastHash(normalized);
+}
+
+// static
+size_t CodeSnippetStore::HashKey(std::string_view code,
+                                 std::string_view source_url) {
+  return base::HashInts(base::FastHash(code), base::FastHash(source_url));
+}
+
+const CodeSnippet* CodeSnippetStore::Find(std::string_view code,
+                                          std::string_view source_url) const {
+  size_t index = IndexOf(code, source_url);
+  return index < snippets_.size() ? &snippets_[index] : nullptr;
+}
+
+void CodeSnippetStore::Put(CodeSnippet snippet) {
+  size_t index = IndexOf(snippet.code, snippet.source_url);
+  if (index < snippets_.size()) {
+    snippets_[index] = std::move(snippet);
+    return;
+  }
+  index_.emplace(HashKey(snippet.code, snippet.source_url), snippets_.size());
+  snippets_.push_back(std::move(snippet));
+}
+
+void CodeSnippetStore::Erase(std::string_view code,
+                             std::string_view source_url) {
+  size_t index = IndexOf(code, source_url);
+  if (index == snippets_.size()) {
+    return;
+  }
+  snippets_.erase(snippets_.begin() + index);
+  index_.clear();
+  for (size_t i = 0; i < snippets_.size(); ++i) {
+    index_.emplace(HashKey(snippets_[i].code, snippets_[i].source_url), i);
+  }
+}
+
+void CodeSnippetStore::Clear() {
+  // Swap rather than clear, to free the capacity as well
+  std::vector<CodeSnippet>().swap(snippets_);
+  std::unordered_multimap<size_t, size_t>().swap(index_);
+}
+
+size_t CodeSnippetStore::IndexOf(std::string_view code,
+                                 std::string_view source_url) const {
+  auto range = index_.equal_range(HashKey(code, source_url));
+  for (auto it = range.first; it != range.second; ++it) {
+    const CodeSnippet& snippet = snippets_[it->second];
+    if (snippet.code == code && snippet.source_url == source_url) {
+      return it->second;
+    }
+  }
+  return snippets_.size();
+}
+
+}  // namespace browser
+}  // namespace asol
@@ -0,0 +1,73 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_BROWSER_CODE_SNIPPET_STORE_H_
+#define ASOL_BROWSER_CODE_SNIPPET_STORE_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace asol {
+namespace browser {
+
+// Structure to hold code snippet data
+struct CodeSnippet {
+  std::string language;
+  std::string code;
+  std::string description;
+  std::string source_url;
+};
+
+// CodeSnippetStore holds the saved code snippets, oldest first, each
+// keyed by its code and source URL. Snippets are found through a hash of
+// their key rather than by comparing every saved snippet's code.
+class CodeSnippetStore {
+ public:
+  CodeSnippetStore();
+  ~CodeSnippetStore();
+
+  CodeSnippetStore(const CodeSnippetStore&) = delete;
+  CodeSnippetStore& operator=(const CodeSnippetStore&) = delete;
+
+  // A hash of |code| that ignores how it is indented and wrapped, so the
+  // same snippet hashes the same wherever it is extracted from
+  static size_t HashContent(std::string_view code);
+
+  const std::vector<CodeSnippet>& snippets() const { return snippets_; }
+  size_t size() const { return snippets_.size(); }
+  bool empty() const { return snippets_.empty(); }
+
+  // The snippet with |code| from |source_url|, or null
+  const CodeSnippet* Find(std::string_view code,
+                          std::string_view source_url) const;
+
+  // Replace the snippet with the key of |snippet|, or add it last
+  void Put(CodeSnippet snippet);
+
+  void Erase(std::string_view code, std::string_view source_url);
+
+  // Remove every snippet, freeing their memory
+  void Clear();
+
+ private:
+  static size_t HashKey(std::string_view code, std::string_view source_url);
+
+  // The index in |snippets_| of the snippet with |code| from |source_url|,
+  // or |snippets_.size()|
+  size_t IndexOf(std::string_view code, std::string_view source_url) const;
+
+  std::vector<CodeSnippet> snippets_;
+  // Key hashes to indices in |snippets_|. Rebuilt when a snippet is
+  // erased, which, with a few hundred snippets at most, is cheap.
+  std::unordered_multimap<size_t, size_t> index_;
+};
+
+}  // namespace browser
+}  // namespace asol
+
+#endif  // ASOL_BROWSER_CODE_SNIPPET_STORE_H_
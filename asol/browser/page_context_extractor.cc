@@ -5,13 +5,18 @@
 #include "asol/browser/page_context_extractor.h"
 
 #include <string>
+#include <string_view>
+#include <utility>
 
 #include "asol/browser/browser_features.h"
 #include "asol/util/performance_tracker.h"
 #include "base/feature_list.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
+#include "base/metrics/field_trial_params.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/web_contents.h"
@@ -28,62 +33,327 @@ const char kExtractSelectedTextScript[] = R"(
   })();
 )";
 
-// JavaScript to extract visible content
-const char kExtractVisibleContentScript[] = R"(
-  (function() {
-    function isElementInViewport(el) {
-      const rect = el.getBoundingClientRect();
-      return (
-        rect.top >= 0 &&
-        rect.left >= 0 &&
-        rect.bottom <= window.innerHeight &&
-        rect.right <= window.innerWidth
-      );
-    }
+// JavaScript shared by the scripts that read the page as blocks of text.
+// Spliced into the top of their function bodies.
+const char kBlockHelpersScript[] = R"(
+    const BLOCKS = 'h1, h2, h3, h4, h5, h6, p, li, pre, blockquote, td, th, ' +
+                   'dt, dd, figcaption';
+    const BOILERPLATE_TAGS = new Set([
+      'NAV', 'ASIDE', 'FOOTER', 'FORM', 'BUTTON', 'SELECT', 'DIALOG',
+      'SCRIPT', 'STYLE', 'NOSCRIPT', 'TEMPLATE'
+    ]);
+    const BOILERPLATE_ROLES =
+        /^(navigation|banner|contentinfo|complementary|menu|menubar|dialog|search)$/;
+    const BOILERPLATE_NAMES = new RegExp(
+        '(^|[-_ ])(nav|navbar|menu|footer|sidebar|comments?|share|social|' +
+        'promo|advert|ads?|cookies?|related|subscribe|newsletter|' +
+        'breadcrumbs?)($|[-_ ])', 'i');
 
-    function getVisibleText() {
-      const elements = document.querySelectorAll('p, h1, h2, h3, h4, h5, h6, li, td, th, div, span');
-      let visibleText = '';
-      
-      for (const element of elements) {
-        if (isElementInViewport(element) && element.textContent.trim()) {
-          visibleText += element.textContent.trim() + '\n';
+    const boilerplate = new Map();
+    function isBoilerplate(element) {
+      const chain = [];
+      let result = false;
+      for (let node = element; node && node !== document.body;
+           node = node.parentElement) {
+        if (boilerplate.has(node)) {
+          result = boilerplate.get(node);
+          break;
+        }
+        chain.push(node);
+        const names = (node.id || '') + ' ' +
+            (typeof node.className === 'string' ? node.className : '');
+        if (BOILERPLATE_TAGS.has(node.tagName) || node.hidden ||
+            node.getAttribute('aria-hidden') === 'true' ||
+            BOILERPLATE_ROLES.test(node.getAttribute('role') || '') ||
+            BOILERPLATE_NAMES.test(names)) {
+          result = true;
+          break;
         }
       }
-      
-      return visibleText;
+      for (const node of chain) {
+        boilerplate.set(node, result);
+      }
+      return result;
+    }
+
+    // Whether |element| is rendered and outside any boilerplate
+    function isCandidate(element) {
+      return !isBoilerplate(element) && element.getClientRects().length > 0;
+    }
+
+    // The block's kind and collapsed text, or null if it has no text or is
+    // mostly links, like a menu or a list of related articles
+    function readBlock(element) {
+      const text = element.textContent.replace(/\s+/g, ' ').trim();
+      if (!text) {
+        return null;
+      }
+      let linkLength = 0;
+      for (const link of element.querySelectorAll('a')) {
+        linkLength += link.textContent.length;
+      }
+      if (linkLength / text.length > 0.5) {
+        return null;
+      }
+      return {kind: element.tagName.toLowerCase(), text};
+    }
+
+    // The block |element| sits in, if that block was taken whole
+    function isInsideTaken(element, taken) {
+      const outer = element.parentElement &&
+                    element.parentElement.closest(BLOCKS);
+      return outer && taken.has(outer);
     }
-    
-    return getVisibleText();
-  })();
 )";
 
-// JavaScript to extract full page content
-const char kExtractFullPageContentScript[] = R"(
-  (function() {
-    function getPageText() {
-      // Get the page title
-      let text = document.title + '\n\n';
-      
-      // Get meta description if available
-      const metaDescription = document.querySelector('meta[name="description"]');
-      if (metaDescription) {
-        text += metaDescription.getAttribute('content') + '\n\n';
+// JavaScript to distill the page into blocks of readable text. Runs in
+// one pass over the candidate blocks: boilerplate (navigation, sidebars,
+// comments, hidden elements) is dropped with a memoized walk up the tree,
+// containers are scored readability-style by the paragraphs they hold, and
+// in full-page mode only the best container is kept when it holds most of
+// the text. Returns {title, description, blocks: [[kind, text], ...],
+// truncated}, with at most maxChars characters of block text.
+const char kDistillPageScript[] = R"(
+  (function(options) {
+    %s
+
+    function inViewport(element) {
+      const rect = element.getBoundingClientRect();
+      return rect.bottom > 0 && rect.right > 0 &&
+             rect.top < window.innerHeight && rect.left < window.innerWidth;
+    }
+
+    // Collect the blocks, skipping those inside a block already taken
+    const candidates = [];
+    const taken = new Set();
+    for (const element of document.querySelectorAll(BLOCKS)) {
+      if (isInsideTaken(element, taken) || !isCandidate(element)) {
+        continue;
+      }
+      if (options.viewportOnly && !inViewport(element)) {
+        continue;
       }
-      
-      // Get main content
-      const elements = document.querySelectorAll('p, h1, h2, h3, h4, h5, h6, li, td, th');
-      for (const element of elements) {
-        if (element.textContent.trim()) {
-          text += element.textContent.trim() + '\n';
+      const block = readBlock(element);
+      if (!block) {
+        continue;
+      }
+      taken.add(element);
+      candidates.push({element, text: block.text, kind: block.kind});
+    }
+
+    // Score the containers by the paragraphs they hold
+    let selected = candidates;
+    if (!options.viewportOnly) {
+      const scores = new Map();
+      let total = 0;
+      for (const candidate of candidates) {
+        if (candidate.kind !== 'p' && candidate.kind !== 'pre') {
+          continue;
+        }
+        // A point for the paragraph, one per comma, and up to three for
+        // its length
+        const score = candidate.text.split(',').length +
+                      Math.min(Math.floor(candidate.text.length / 100), 3);
+        total += score;
+        const parent = candidate.element.parentElement;
+        if (parent) {
+          scores.set(parent, (scores.get(parent) || 0) + score);
+          const grandparent = parent.parentElement;
+          if (grandparent) {
+            scores.set(grandparent,
+                       (scores.get(grandparent) || 0) + score / 2);
+          }
+        }
+      }
+      let best = null;
+      let bestScore = 0;
+      for (const [container, score] of scores) {
+        if (score > bestScore) {
+          best = container;
+          bestScore = score;
+        }
+      }
+      // Keep only the best container when it holds most of the text,
+      // along with the page's main heading
+      if (best && best !== document.body && bestScore >= total / 2) {
+        selected = candidates.filter(candidate =>
+            best.contains(candidate.element) || candidate.kind === 'h1');
+      }
+    }
+
+    const blocks = [];
+    let remaining = options.maxChars;
+    let truncated = false;
+    for (const candidate of selected) {
+      let text = candidate.text;
+      if (text.length > remaining) {
+        text = text.slice(0, remaining);
+        truncated = true;
+      }
+      if (text) {
+        blocks.push([candidate.kind, text]);
+        remaining -= text.length;
+      }
+      if (truncated) {
+        break;
+      }
+    }
+
+    const description = document.querySelector('meta[name="description"]');
+    return {
+      title: document.title,
+      description: description ?
+          (description.getAttribute('content') || '') : '',
+      blocks,
+      truncated
+    };
+  })({viewportOnly: %s, maxChars: %d});
+)";
+
+// JavaScript to report how the page's blocks changed since the last call.
+// The first call installs a MutationObserver and reports every block as
+// added; later calls re-read only the blocks the observer saw change, and
+// walk the block list (without reading text) only when nodes were added,
+// removed or hidden. Block IDs are stable for an element's lifetime.
+// Returns {reset, added: [[id, after_id, kind, text], ...],
+// changed: [[id, text], ...], removed: [id, ...], more}, where after_id is
+// the block the new one follows (0 for the start) and more is set when the
+// maxChars budget held some changes back for the next call.
+const char kContentDeltaScript[] = R"(
+  (function(options) {
+    %s
+
+    let state = window.__asolContentDelta;
+    const reset = !state;
+    if (reset) {
+      state = window.__asolContentDelta = {
+        ids: new WeakMap(),
+        blocks: new Map(),  // id -> {element, text}
+        nextId: 1,
+        dirty: new Set(),
+        structural: true
+      };
+      // The tracked block holding |node|, which may be an outer block when
+      // |node| sits in a nested one
+      const trackedBlock = node => {
+        let block = node && node.closest(BLOCKS);
+        while (block && !state.ids.has(block)) {
+          block = block.parentElement && block.parentElement.closest(BLOCKS);
+        }
+        return block;
+      };
+      new MutationObserver(records => {
+        for (const record of records) {
+          const target = record.type === 'characterData' ?
+              record.target.parentElement : record.target;
+          const block = record.type === 'attributes' ? null :
+              trackedBlock(target);
+          if (block) {
+            state.dirty.add(block);
+          }
+          if (!block || record.type !== 'characterData') {
+            state.structural = true;
+          }
+        }
+      }).observe(document.documentElement, {
+        childList: true,
+        subtree: true,
+        characterData: true,
+        attributes: true,
+        attributeFilter: ['class', 'hidden', 'style', 'aria-hidden']
+      });
+    }
+
+    const delta = {reset, added: [], changed: [], removed: [], more: false};
+    let remaining = options.maxChars;
+    // The text to send for a block, or null when it waits for the next
+    // call. A block larger than the whole budget is cut rather than held.
+    function spend(text) {
+      if (text.length > remaining) {
+        delta.more = true;
+        if (remaining < options.maxChars) {
+          return null;
         }
+        text = text.slice(0, remaining);
       }
-      
+      remaining -= text.length;
       return text;
     }
-    
-    return getPageText();
-  })();
+    function forget(id) {
+      const block = state.blocks.get(id);
+      state.blocks.delete(id);
+      state.ids.delete(block.element);
+      state.dirty.delete(block.element);
+      delta.removed.push(id);
+    }
+
+    // Nodes added, removed or hidden: find the new and vanished blocks.
+    // Known blocks are only checked for visibility here, not read.
+    if (state.structural) {
+      state.structural = false;
+      const seen = new Set();
+      const taken = new Set();
+      let previous = 0;
+      for (const element of document.querySelectorAll(BLOCKS)) {
+        if (isInsideTaken(element, taken) || !isCandidate(element)) {
+          continue;
+        }
+        let id = state.ids.get(element);
+        if (id !== undefined) {
+          taken.add(element);
+          seen.add(id);
+          previous = id;
+          continue;
+        }
+        const block = readBlock(element);
+        if (!block) {
+          continue;
+        }
+        const text = spend(block.text);
+        if (text === null) {
+          state.structural = true;
+          continue;
+        }
+        id = state.nextId++;
+        state.ids.set(element, id);
+        state.blocks.set(id, {element, text});
+        taken.add(element);
+        seen.add(id);
+        delta.added.push([id, previous, block.kind, text]);
+        previous = id;
+      }
+      for (const id of [...state.blocks.keys()]) {
+        if (!seen.has(id)) {
+          forget(id);
+        }
+      }
+    }
+
+    // Re-read only the blocks whose subtree mutated
+    for (const element of [...state.dirty]) {
+      state.dirty.delete(element);
+      const id = state.ids.get(element);
+      const block = element.isConnected && isCandidate(element) ?
+          readBlock(element) : null;
+      if (!block) {
+        forget(id);
+        continue;
+      }
+      const tracked = state.blocks.get(id);
+      if (block.text === tracked.text) {
+        continue;
+      }
+      const text = spend(block.text);
+      if (text === null) {
+        state.dirty.add(element);
+        continue;
+      }
+      tracked.text = text;
+      delta.changed.push([id, text]);
+    }
+
+    return delta;
+  })({maxChars: %d});
 )";
 
 // JavaScript to extract content from a specific element
@@ -97,8 +367,152 @@ const char kExtractElementContentScript[] = R"(
   })('%s');
 )";
 
+PageContextExtractor::BlockType BlockTypeForTag(const std::string& tag,
+                                                int* heading_level) {
+  using BlockType = PageContextExtractor::BlockType;
+  *heading_level = 0;
+  if (tag.size() == 2 && tag[0] == 'h' && tag[1] >= '1' && tag[1] <= '6') {
+    *heading_level = tag[1] - '0';
+    return BlockType::kHeading;
+  }
+  if (tag == "p") {
+    return BlockType::kParagraph;
+  }
+  if (tag == "li" || tag == "dt" || tag == "dd") {
+    return BlockType::kListItem;
+  }
+  if (tag == "pre") {
+    return BlockType::kPreformatted;
+  }
+  if (tag == "blockquote") {
+    return BlockType::kQuote;
+  }
+  if (tag == "td" || tag == "th") {
+    return BlockType::kTableCell;
+  }
+  return BlockType::kOther;
+}
+
+// Build the page from the distiller's result, laying the blocks out in
+// |text| so each knows its offset
+PageContextExtractor::DistilledPage ParseDistilledPage(
+    const base::Value& result) {
+  PageContextExtractor::DistilledPage page;
+  const base::Value::Dict* dict = result.GetIfDict();
+  if (!dict) {
+    return page;
+  }
+  if (const std::string* title = dict->FindString("title")) {
+    base::TrimWhitespaceASCII(*title, base::TRIM_ALL, &page.title);
+  }
+  if (const std::string* description = dict->FindString("description")) {
+    base::TrimWhitespaceASCII(*description, base::TRIM_ALL,
+                              &page.description);
+  }
+  page.truncated = dict->FindBool("truncated").value_or(false);
+
+  const base::Value::List* blocks = dict->FindList("blocks");
+  if (!blocks) {
+    return page;
+  }
+  page.blocks.reserve(blocks->size());
+  for (const base::Value& entry : *blocks) {
+    const base::Value::List* fields = entry.GetIfList();
+    if (!fields || fields->size() != 2 || !(*fields)[0].is_string() ||
+        !(*fields)[1].is_string() || (*fields)[1].GetString().empty()) {
+      continue;
+    }
+    PageContextExtractor::DistilledBlock block;
+    block.type = BlockTypeForTag((*fields)[0].GetString(),
+                                 &block.heading_level);
+    if (!page.text.empty()) {
+      page.text += "\n\n";
+    }
+    block.offset = page.text.size();
+    block.length = (*fields)[1].GetString().size();
+    page.text += (*fields)[1].GetString();
+    page.blocks.push_back(block);
+  }
+  return page;
+}
+
+PageContextExtractor::ContentDelta ParseContentDelta(
+    const base::Value& result) {
+  PageContextExtractor::ContentDelta delta;
+  const base::Value::Dict* dict = result.GetIfDict();
+  if (!dict) {
+    return delta;
+  }
+  delta.reset = dict->FindBool("reset").value_or(false);
+  delta.more = dict->FindBool("more").value_or(false);
+
+  if (const base::Value::List* added = dict->FindList("added")) {
+    delta.added.reserve(added->size());
+    for (const base::Value& entry : *added) {
+      const base::Value::List* fields = entry.GetIfList();
+      if (!fields || fields->size() != 4 || !(*fields)[0].is_int() ||
+          !(*fields)[1].is_int() || !(*fields)[2].is_string() ||
+          !(*fields)[3].is_string()) {
+        continue;
+      }
+      PageContextExtractor::ContentDelta::AddedBlock block;
+      block.id = (*fields)[0].GetInt();
+      block.after_id = (*fields)[1].GetInt();
+      block.type = BlockTypeForTag((*fields)[2].GetString(),
+                                   &block.heading_level);
+      block.text = (*fields)[3].GetString();
+      delta.added.push_back(std::move(block));
+    }
+  }
+
+  if (const base::Value::List* changed = dict->FindList("changed")) {
+    delta.changed.reserve(changed->size());
+    for (const base::Value& entry : *changed) {
+      const base::Value::List* fields = entry.GetIfList();
+      if (!fields || fields->size() != 2 || !(*fields)[0].is_int() ||
+          !(*fields)[1].is_string()) {
+        continue;
+      }
+      delta.changed.push_back(
+          {(*fields)[0].GetInt(), (*fields)[1].GetString()});
+    }
+  }
+
+  if (const base::Value::List* removed = dict->FindList("removed")) {
+    delta.removed.reserve(removed->size());
+    for (const base::Value& id : *removed) {
+      if (id.is_int()) {
+        delta.removed.push_back(id.GetInt());
+      }
+    }
+  }
+  return delta;
+}
+
 }  // namespace
 
+PageContextExtractor::ContentDelta::ContentDelta() = default;
+PageContextExtractor::ContentDelta::ContentDelta(ContentDelta&&) = default;
+PageContextExtractor::ContentDelta&
+PageContextExtractor::ContentDelta::operator=(ContentDelta&&) = default;
+PageContextExtractor::ContentDelta::~ContentDelta() = default;
+
+bool PageContextExtractor::ContentDelta::empty() const {
+  return !reset && added.empty() && changed.empty() && removed.empty();
+}
+
+std::string_view PageContextExtractor::DistilledPage::GetBlockText(
+    const DistilledBlock& block) const {
+  return std::string_view(text).substr(block.offset, block.length);
+}
+
+PageContextExtractor::DistilledPage::DistilledPage() = default;
+PageContextExtractor::DistilledPage::DistilledPage(const DistilledPage&) =
+    default;
+PageContextExtractor::DistilledPage&
+PageContextExtractor::DistilledPage::operator=(const DistilledPage&) = default;
+PageContextExtractor::DistilledPage::~DistilledPage() = default;
+
 PageContextExtractor::PageContextExtractor(content::WebContents* web_contents)
     : content::WebContentsObserver(web_contents) {
   DLOG(INFO) << "PageContextExtractor created for WebContents: " << web_contents;
@@ -148,10 +562,12 @@ void PageContextExtractor::ExtractVisibleContent(ContextCallback callback) {
     return;
   }
   
-  ExecuteJavaScript(kExtractVisibleContentScript,
-                   base::BindOnce(&PageContextExtractor::HandleJavaScriptResult,
-                                 weak_ptr_factory_.GetWeakPtr(),
-                                 std::move(callback)));
+  DistillPage(DistillMode::kVisibleViewport,
+              base::BindOnce(
+                  [](ContextCallback callback, const DistilledPage& page) {
+                    std::move(callback).Run(page.text);
+                  },
+                  std::move(callback)));
 }
 
 void PageContextExtractor::ExtractFullPageContent(ContextCallback callback) {
@@ -164,10 +580,74 @@ void PageContextExtractor::ExtractFullPageContent(ContextCallback callback) {
     return;
   }
   
-  ExecuteJavaScript(kExtractFullPageContentScript,
-                   base::BindOnce(&PageContextExtractor::HandleJavaScriptResult,
-                                 weak_ptr_factory_.GetWeakPtr(),
-                                 std::move(callback)));
+  DistillPage(DistillMode::kFullPage,
+              base::BindOnce(
+                  [](ContextCallback callback, const DistilledPage& page) {
+                    // Title and description first, as context for the rest
+                    std::string text = page.title;
+                    for (const std::string* part :
+                         {&page.description, &page.text}) {
+                      if (!part->empty()) {
+                        if (!text.empty()) {
+                          text += "\n\n";
+                        }
+                        text += *part;
+                      }
+                    }
+                    std::move(callback).Run(text);
+                  },
+                  std::move(callback)));
+}
+
+void PageContextExtractor::DistillPage(DistillMode mode,
+                                       DistillCallback callback) {
+  // Track performance of this operation
+  util::ScopedPerformanceTracker tracker("PageContextExtractor_DistillPage");
+
+  // Check if the feature is enabled
+  if (!base::FeatureList::IsEnabled(kAsolPageContextExtraction)) {
+    std::move(callback).Run(DistilledPage());
+    return;
+  }
+
+  // The renderer stops at the context limit, so no more than that crosses
+  // IPC
+  int max_length = base::GetFieldTrialParamByFeatureAsInt(
+      kAsolPageContextExtraction, "max_context_length", 5000);
+  std::string script = base::StringPrintf(
+      kDistillPageScript, kBlockHelpersScript,
+      mode == DistillMode::kVisibleViewport ? "true" : "false", max_length);
+
+  ExecuteJavaScriptForValue(
+      script, base::BindOnce(
+                  [](DistillCallback callback, base::Value result) {
+                    std::move(callback).Run(ParseDistilledPage(result));
+                  },
+                  std::move(callback)));
+}
+
+void PageContextExtractor::ExtractContentDelta(DeltaCallback callback) {
+  // Track performance of this operation
+  util::ScopedPerformanceTracker tracker(
+      "PageContextExtractor_ExtractContentDelta");
+
+  // Check if the feature is enabled
+  if (!base::FeatureList::IsEnabled(kAsolPageContextExtraction)) {
+    std::move(callback).Run(ContentDelta());
+    return;
+  }
+
+  int max_length = base::GetFieldTrialParamByFeatureAsInt(
+      kAsolPageContextExtraction, "max_context_length", 5000);
+  std::string script = base::StringPrintf(kContentDeltaScript,
+                                          kBlockHelpersScript, max_length);
+
+  ExecuteJavaScriptForValue(
+      script, base::BindOnce(
+                  [](DeltaCallback callback, base::Value result) {
+                    std::move(callback).Run(ParseContentDelta(result));
+                  },
+                  std::move(callback)));
 }
 
 void PageContextExtractor::ExtractElementContent(
@@ -202,23 +682,14 @@ void PageContextExtractor::PrimaryPageChanged(content::Page& page) {
 void PageContextExtractor::ExecuteJavaScript(
     const std::string& script,
     base::OnceCallback<void(const std::string&)> callback) {
-  if (!web_contents()) {
-    std::move(callback).Run("");
-    return;
-  }
-  
-  content::RenderFrameHost* main_frame = web_contents()->GetPrimaryMainFrame();
-  if (!main_frame) {
-    std::move(callback).Run("");
-    return;
-  }
-  
-  main_frame->ExecuteJavaScriptForTests(
-      base::UTF8ToUTF16(script),
+  ExecuteJavaScriptForValue(
+      script,
       base::BindOnce([](base::OnceCallback<void(const std::string&)> callback,
                        base::Value result) {
         std::string text;
-        if (result.is_string()) {
+        if (result.is_none()) {
+          // No page to run in
+        } else if (result.is_string()) {
           text = result.GetString();
         } else {
           // Try to convert the result to a string
@@ -242,6 +713,24 @@ void PageContextExtractor::ExecuteJavaScript(
       std::move(callback)));
 }
 
+void PageContextExtractor::ExecuteJavaScriptForValue(
+    const std::string& script,
+    base::OnceCallback<void(base::Value)> callback) {
+  if (!web_contents()) {
+    std::move(callback).Run(base::Value());
+    return;
+  }
+  
+  content::RenderFrameHost* main_frame = web_contents()->GetPrimaryMainFrame();
+  if (!main_frame) {
+    std::move(callback).Run(base::Value());
+    return;
+  }
+  
+  main_frame->ExecuteJavaScriptForTests(base::UTF8ToUTF16(script),
+                                        std::move(callback));
+}
+
 void PageContextExtractor::HandleJavaScriptResult(
     ContextCallback callback,
     const std::string& result) {
@@ -7,9 +7,12 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
+#include "base/values.h"
 #include "content/public/browser/web_contents_observer.h"
 
 namespace content {
@@ -28,6 +31,90 @@ class PageContextExtractor : public content::WebContentsObserver {
   // Callback for receiving extracted context
   using ContextCallback = base::OnceCallback<void(const std::string&)>;
 
+  enum class BlockType {
+    kHeading,
+    kParagraph,
+    kListItem,
+    kPreformatted,
+    kQuote,
+    kTableCell,
+    kOther,
+  };
+
+  // One block of readable text, as a span of DistilledPage::text
+  struct DistilledBlock {
+    BlockType type = BlockType::kOther;
+    int heading_level = 0;  // 1-6 for kHeading, 0 otherwise
+    size_t offset = 0;
+    size_t length = 0;
+  };
+
+  // The readable content of a page, distilled in the renderer. Boilerplate
+  // such as navigation, sidebars and comments is left out. |text| holds the
+  // blocks in document order, separated by blank lines.
+  struct DistilledPage {
+    DistilledPage();
+    DistilledPage(const DistilledPage&);
+    DistilledPage& operator=(const DistilledPage&);
+    ~DistilledPage();
+
+    std::string_view GetBlockText(const DistilledBlock& block) const;
+
+    std::string title;
+    std::string description;
+    std::string text;
+    std::vector<DistilledBlock> blocks;
+
+    // Whether the blocks stop at the context length limit
+    bool truncated = false;
+  };
+
+  enum class DistillMode {
+    kFullPage,
+    kVisibleViewport,  // Only blocks that intersect the viewport
+  };
+
+  using DistillCallback = base::OnceCallback<void(const DistilledPage&)>;
+
+  // How the page's blocks changed since the previous ExtractContentDelta().
+  // Block IDs are assigned in the renderer and stay the same for as long as
+  // the block's element is in the document.
+  struct ContentDelta {
+    struct AddedBlock {
+      int id = 0;
+      int after_id = 0;  // The block this one follows; 0 for the start
+      BlockType type = BlockType::kOther;
+      int heading_level = 0;
+      std::string text;
+    };
+
+    struct ChangedBlock {
+      int id = 0;
+      std::string text;
+    };
+
+    ContentDelta();
+    ContentDelta(ContentDelta&&);
+    ContentDelta& operator=(ContentDelta&&);
+    ~ContentDelta();
+
+    bool empty() const;
+
+    // Set on the first delta for a document: |added| is then every block,
+    // and any model built from an earlier document should be dropped
+    bool reset = false;
+
+    std::vector<AddedBlock> added;
+    std::vector<ChangedBlock> changed;
+    std::vector<int> removed;
+
+    // Whether the context length limit held some changes back; ask again
+    // for the rest
+    bool more = false;
+  };
+
+  using DeltaCallback = base::OnceCallback<void(ContentDelta)>;
+
   // Create a new context extractor for the given web contents
   explicit PageContextExtractor(content::WebContents* web_contents);
   ~PageContextExtractor() override;
@@ -56,6 +143,18 @@ class PageContextExtractor : public content::WebContentsObserver {
   // The callback will be called with the extracted context
   void ExtractElementContent(const std::string& selector, ContextCallback callback);
 
+  // Distill the page into typed blocks of readable text. The work runs in
+  // the renderer in one pass over the DOM, and only the distilled blocks,
+  // up to the context length limit, are sent back.
+  void DistillPage(DistillMode mode, DistillCallback callback);
+
+  // Report the blocks added, changed or removed since the last call, for
+  // pages that update in place such as single-page apps and infinite
+  // feeds. The first call on a document reports every block. A
+  // MutationObserver in the page tracks what changed, so a call re-reads
+  // only the touched blocks and, if nothing changed, returns an empty delta.
+  void ExtractContentDelta(DeltaCallback callback);
+
  private:
   // WebContentsObserver implementation
   void WebContentsDestroyed() override;
@@ -65,6 +164,12 @@ class PageContextExtractor : public content::WebContentsObserver {
   void ExecuteJavaScript(const std::string& script, 
                         base::OnceCallback<void(const std::string&)> callback);
 
+  // Execute a JavaScript function in the page and get its result as a
+  // value. Runs |callback| with a none value if there is no page.
+  void ExecuteJavaScriptForValue(
+      const std::string& script,
+      base::OnceCallback<void(base::Value)> callback);
+
   // Handle the result of a JavaScript execution
   void HandleJavaScriptResult(ContextCallback callback,
                              const std::string& result);
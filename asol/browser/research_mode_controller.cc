@@ -5,27 +5,43 @@
 #include "asol/browser/research_mode_controller.h"
 
 #include <algorithm>
+#include <array>
+#include <map>
 #include <memory>
+#include <optional>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "asol/browser/browser_features.h"
+#include "asol/browser/research_search_index.h"
+#include "asol/browser/tab_hibernation_manager.h"
+#include "asol/core/privacy_proxy.h"
 #include "asol/core/service_manager.h"
 #include "asol/util/performance_tracker.h"
+#include "base/barrier_closure.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
 #include "base/guid.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/no_destructor.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/task/thread_pool.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/navigation_entry.h"
 #include "content/public/browser/navigation_handle.h"
 #include "content/public/browser/web_contents.h"
+#include "crypto/sha2.h"
 
 namespace asol {
 namespace browser {
@@ -131,25 +147,313 @@ ResearchSession ValueToResearchSession(const base::Value::Dict& value) {
   return session;
 }
 
-// Get the file path for storing research sessions
-base::FilePath GetResearchSessionsFilePath(content::BrowserContext* context) {
+// Get the directory for storing research sessions
+base::FilePath GetResearchSessionsDir(content::BrowserContext* context) {
   base::FilePath path;
   if (!base::PathService::Get(base::DIR_USER_DATA, &path)) {
     return base::FilePath();
   }
   
-  path = path.AppendASCII("asol_research_sessions.json");
+  path = path.AppendASCII("asol_research_sessions");
   return path;
 }
 
+// Saves wait for changes to stop for this long, but no longer than the max
+constexpr base::TimeDelta kSaveDelay = base::Seconds(2);
+constexpr base::TimeDelta kMaxSaveDelay = base::Seconds(10);
+
+// Page bodies this long or longer are stored as blobs
+constexpr size_t kMinBlobSize = 4 * 1024;
+
+// Most pages a search returns, and the length of their snippets
+constexpr size_t kMaxSearchHits = 50;
+constexpr size_t kSnippetLength = 240;
+
+// A session's name and times, for the index, without its pages
+base::Value::Dict SessionInfoToValue(const ResearchSession& session) {
+  base::Value::Dict session_dict;
+  session_dict.Set("id", session.id);
+  session_dict.Set("name", session.name);
+  session_dict.Set("topic", session.topic);
+  session_dict.Set("created", session.created.ToDoubleT());
+  session_dict.Set("last_updated", session.last_updated.ToDoubleT());
+  return session_dict;
+}
+
 // Prompt for generating key points from content
 const char kKeyPointsPrompt[] = 
     "Extract 3-5 key points from the following content. "
     "Focus on the most important information and present each point "
     "as a concise bullet point:\n\n%s";
 
+// The key points of a response to kKeyPointsPrompt
+std::vector<std::string> ParseKeyPoints(const std::string& text) {
+  std::vector<std::string> key_points;
+  std::vector<std::string> lines = base::SplitString(
+      text, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  
+  for (const auto& line : lines) {
+    // Look for bullet points or numbered lists
+    if (line.find("- ") == 0 || line.find("• ") == 0 ||
+        (line.size() > 2 && isdigit(line[0]) && line[1] == '.')) {
+      // Extract the content after the bullet or number
+      size_t start = line.find_first_of(" ") + 1;
+      if (start < line.size()) {
+        key_points.push_back(line.substr(start));
+      }
+    } else {
+      // If no bullet or number, just add the line as is
+      key_points.push_back(line);
+    }
+  }
+  return key_points;
+}
+
+// Pages a stage of the processing pipeline works on at once
+size_t GetMaxConcurrentPages(const char* param, int default_value) {
+  return static_cast<size_t>(std::max(
+      1, base::GetFieldTrialParamByFeatureAsInt(kAsolResearchMode, param,
+                                                default_value)));
+}
+
 }  // namespace
 
+// The session files, used on their task runner. In |dir_|:
+//   index.json            each session's name and times, and the current
+//                         session
+//   sessions/<id>.json    a session's pages, large bodies replaced by the
+//                         name of their blob
+//   blobs/<sha256>        a page body
+class ResearchModeController::Store
+    : public base::RefCountedThreadSafe<ResearchModeController::Store> {
+ public:
+  explicit Store(base::FilePath dir)
+      : dir_(std::move(dir)),
+        task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+            {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+             base::TaskShutdownBehavior::BLOCK_SHUTDOWN})) {}
+
+  Store(const Store&) = delete;
+  Store& operator=(const Store&) = delete;
+
+  base::SequencedTaskRunner* task_runner() const { return task_runner_.get(); }
+
+  // The index, or nullopt if there is none. The sessions of the single
+  // JSON file they were once saved in are first moved here.
+  std::optional<base::Value::Dict> ReadIndex();
+
+  // |session_id|'s pages, or nullopt if it has none saved
+  std::optional<std::vector<ResearchPageData>> ReadSession(
+      const std::string& session_id);
+
+  // Replace the index with |index| and the pages of |sessions|
+  void Write(base::Value::Dict index, std::vector<ResearchSession> sessions);
+
+  // Delete the blobs no session refers to any more
+  void CollectGarbage();
+
+ private:
+  friend class base::RefCountedThreadSafe<Store>;
+  ~Store() = default;
+
+  void WriteSession(const ResearchSession& session);
+  void MigrateLegacyFile(const base::FilePath& legacy_path);
+
+  base::FilePath GetIndexPath() const {
+    return dir_.AppendASCII("index.json");
+  }
+  base::FilePath GetSessionsDir() const { return dir_.AppendASCII("sessions"); }
+  base::FilePath GetSessionPath(const std::string& session_id) const {
+    return GetSessionsDir().AppendASCII(session_id + ".json");
+  }
+  base::FilePath GetBlobsDir() const { return dir_.AppendASCII("blobs"); }
+  base::FilePath GetBlobPath(const std::string& hash) const {
+    return GetBlobsDir().AppendASCII(hash);
+  }
+
+  const base::FilePath dir_;
+  const scoped_refptr<base::SequencedTaskRunner> task_runner_;
+};
+
+std::optional<base::Value::Dict> ResearchModeController::Store::ReadIndex() {
+  base::FilePath legacy_path = dir_.AddExtension(FILE_PATH_LITERAL("json"));
+  if (!base::PathExists(GetIndexPath()) && base::PathExists(legacy_path)) {
+    MigrateLegacyFile(legacy_path);
+  }
+  
+  std::string json_string;
+  if (!base::ReadFileToString(GetIndexPath(), &json_string)) {
+    DLOG(INFO) << "No research sessions index in: " << dir_.value();
+    return std::nullopt;
+  }
+  absl::optional<base::Value> value = base::JSONReader::Read(json_string);
+  if (!value || !value->is_dict()) {
+    DLOG(ERROR) << "Failed to parse research sessions index";
+    return std::nullopt;
+  }
+  return std::move(value->GetDict());
+}
+
+std::optional<std::vector<ResearchPageData>>
+ResearchModeController::Store::ReadSession(const std::string& session_id) {
+  if (!base::IsValidGUID(session_id)) {
+    return std::nullopt;
+  }
+  std::string json_string;
+  if (!base::ReadFileToString(GetSessionPath(session_id), &json_string)) {
+    return std::nullopt;
+  }
+  absl::optional<base::Value> value = base::JSONReader::Read(json_string);
+  if (!value || !value->is_dict()) {
+    DLOG(ERROR) << "Failed to parse research session: " << session_id;
+    return std::nullopt;
+  }
+  
+  base::Value::Dict& session_dict = value->GetDict();
+  if (base::Value::List* pages_list = session_dict.FindList("pages")) {
+    for (auto& page_value : *pages_list) {
+      if (!page_value.is_dict()) continue;
+      base::Value::Dict& page_dict = page_value.GetDict();
+      const std::string* blob = page_dict.FindString("content_blob");
+      if (!blob) continue;
+      std::string content;
+      if (!base::ReadFileToString(GetBlobPath(*blob), &content)) {
+        DLOG(ERROR) << "Missing research page blob: " << *blob;
+      }
+      page_dict.Set("content", std::move(content));
+    }
+  }
+  return std::move(ValueToResearchSession(session_dict).pages);
+}
+
+void ResearchModeController::Store::Write(
+    base::Value::Dict index,
+    std::vector<ResearchSession> sessions) {
+  for (const ResearchSession& session : sessions) {
+    WriteSession(session);
+  }
+  
+  // The index last, so that it never names a session not yet written
+  std::string json_string;
+  if (!base::CreateDirectory(dir_) ||
+      !base::JSONWriter::Write(index, &json_string) ||
+      !base::ImportantFileWriter::WriteFileAtomically(GetIndexPath(),
+                                                      json_string)) {
+    DLOG(ERROR) << "Failed to write research sessions index";
+  }
+}
+
+void ResearchModeController::Store::WriteSession(
+    const ResearchSession& session) {
+  if (!base::IsValidGUID(session.id)) {
+    DLOG(ERROR) << "Not saving research session with bad ID: " << session.id;
+    return;
+  }
+  if (!base::CreateDirectory(GetSessionsDir()) ||
+      !base::CreateDirectory(GetBlobsDir())) {
+    DLOG(ERROR) << "Failed to create research sessions directory";
+    return;
+  }
+  
+  base::Value::Dict session_dict = ResearchSessionToValue(session);
+  base::Value::List* pages_list = session_dict.FindList("pages");
+  for (size_t i = 0; i < session.pages.size(); ++i) {
+    const std::string& content = session.pages[i].content;
+    if (content.size() < kMinBlobSize) {
+      continue;
+    }
+    std::string hash = base::ToLowerASCII(
+        base::HexEncode(crypto::SHA256HashString(content)));
+    // A blob is never changed, so one already written is up to date
+    base::FilePath blob_path = GetBlobPath(hash);
+    if (!base::PathExists(blob_path) &&
+        !base::ImportantFileWriter::WriteFileAtomically(blob_path, content)) {
+      DLOG(ERROR) << "Failed to write research page blob: " << hash;
+      continue;
+    }
+    base::Value::Dict& page_dict = (*pages_list)[i].GetDict();
+    page_dict.Remove("content");
+    page_dict.Set("content_blob", std::move(hash));
+  }
+  
+  std::string json_string;
+  if (!base::JSONWriter::Write(session_dict, &json_string) ||
+      !base::ImportantFileWriter::WriteFileAtomically(
+          GetSessionPath(session.id), json_string)) {
+    DLOG(ERROR) << "Failed to write research session: " << session.id;
+  }
+}
+
+void ResearchModeController::Store::CollectGarbage() {
+  std::set<std::string> referenced;
+  base::FileEnumerator sessions(GetSessionsDir(), /*recursive=*/false,
+                                base::FileEnumerator::FILES);
+  for (base::FilePath path = sessions.Next(); !path.empty();
+       path = sessions.Next()) {
+    std::string json_string;
+    if (!base::ReadFileToString(path, &json_string)) {
+      continue;
+    }
+    absl::optional<base::Value> value = base::JSONReader::Read(json_string);
+    if (!value || !value->is_dict()) {
+      continue;
+    }
+    const base::Value::List* pages_list = value->GetDict().FindList("pages");
+    if (!pages_list) {
+      continue;
+    }
+    for (const auto& page_value : *pages_list) {
+      if (!page_value.is_dict()) continue;
+      if (const std::string* blob =
+              page_value.GetDict().FindString("content_blob")) {
+        referenced.insert(*blob);
+      }
+    }
+  }
+  
+  base::FileEnumerator blobs(GetBlobsDir(), /*recursive=*/false,
+                             base::FileEnumerator::FILES);
+  for (base::FilePath path = blobs.Next(); !path.empty();
+       path = blobs.Next()) {
+    if (!referenced.count(path.BaseName().MaybeAsASCII())) {
+      base::DeleteFile(path);
+    }
+  }
+}
+
+void ResearchModeController::Store::MigrateLegacyFile(
+    const base::FilePath& legacy_path) {
+  std::string json_string;
+  if (!base::ReadFileToString(legacy_path, &json_string)) {
+    return;
+  }
+  absl::optional<base::Value> value = base::JSONReader::Read(json_string);
+  if (!value || !value->is_dict()) {
+    DLOG(ERROR) << "Failed to parse research sessions JSON";
+    return;
+  }
+  
+  const base::Value::Dict& root = value->GetDict();
+  base::Value::Dict index;
+  base::Value::List index_list;
+  std::vector<ResearchSession> sessions;
+  if (const base::Value::List* sessions_list = root.FindList("sessions")) {
+    for (const auto& session_value : *sessions_list) {
+      if (!session_value.is_dict()) continue;
+      sessions.push_back(ValueToResearchSession(session_value.GetDict()));
+      index_list.Append(SessionInfoToValue(sessions.back()));
+    }
+  }
+  index.Set("sessions", std::move(index_list));
+  index.Set("current_session_id",
+            root.FindString("current_session_id").value_or(""));
+  Write(std::move(index), std::move(sessions));
+  
+  if (base::PathExists(GetIndexPath())) {
+    base::DeleteFile(legacy_path);
+  }
+}
+
 // static
 WEB_CONTENTS_USER_DATA_KEY_IMPL(ResearchModeController);
 
@@ -161,31 +465,34 @@ ResearchModeController::ResearchModeController(content::WebContents* web_content
   // Create the context extractor
   context_extractor_ = std::make_unique<PageContextExtractor>(web_contents);
   
+  // The stages run only from |pipeline_|, which this owns
+  ResearchPagePipeline::Options options;
+  options.max_concurrent = {
+      GetMaxConcurrentPages("max_concurrent_extractions", 2),
+      GetMaxConcurrentPages("max_concurrent_redactions", 4),
+      GetMaxConcurrentPages("max_concurrent_analyses", 4)};
+  pipeline_ = std::make_unique<ResearchPagePipeline>(
+      options,
+      std::array<ResearchPagePipeline::StageCallback,
+                 ResearchPagePipeline::kStageCount>{
+          base::BindRepeating(&ResearchModeController::ExtractPage,
+                              base::Unretained(this)),
+          base::BindRepeating(&ResearchModeController::RedactPage,
+                              base::Unretained(this)),
+          base::BindRepeating(&ResearchModeController::AnalyzePage,
+                              base::Unretained(this))},
+      base::BindRepeating(&ResearchModeController::OnProcessingProgress,
+                          base::Unretained(this)));
+  
   // Load existing research sessions
   LoadSessions();
-  
-  // Create a default session if none exists
-  if (sessions_.empty()) {
-    CreateResearchSession("Default Research", "General Research");
-  } else {
-    // Use the most recently updated session as the current session
-    auto latest_it = std::max_element(
-        sessions_.begin(), sessions_.end(),
-        [](const ResearchSession& a, const ResearchSession& b) {
-          return a.last_updated < b.last_updated;
-        });
-    
-    if (latest_it != sessions_.end()) {
-      current_session_id_ = latest_it->id;
-    }
-  }
 }
 
 ResearchModeController::~ResearchModeController() {
   DLOG(INFO) << "ResearchModeController destroyed";
   
   // Save research sessions before destruction
-  SaveSessions();
+  FlushSave();
 }
 
 void ResearchModeController::SetResearchModeEnabled(bool enabled) {
@@ -199,6 +506,13 @@ bool ResearchModeController::IsResearchModeEnabled() const {
 
 void ResearchModeController::CreateResearchSession(
     const std::string& name, const std::string& topic) {
+  if (!index_loaded_) {
+    index_callbacks_.push_back(base::BindOnce(
+        &ResearchModeController::CreateResearchSession,
+        weak_ptr_factory_.GetWeakPtr(), name, topic));
+    return;
+  }
+  Wake();
   ResearchSession session;
   session.id = GenerateSessionId();
   session.name = name;
@@ -212,10 +526,14 @@ void ResearchModeController::CreateResearchSession(
   DLOG(INFO) << "Created research session: " << name << " (ID: " << current_session_id_ << ")";
   
   // Save the updated sessions
-  SaveSessions();
+  ScheduleSave(current_session_id_);
 }
 
-const ResearchSession* ResearchModeController::GetCurrentSession() const {
+const ResearchSession* ResearchModeController::GetCurrentSession() {
+  Wake();
+  if (!IsCurrentSessionLoaded()) {
+    LoadCurrentSession(base::DoNothing());
+  }
   auto it = std::find_if(
       sessions_.begin(), sessions_.end(),
       [this](const ResearchSession& session) {
@@ -230,10 +548,37 @@ const ResearchSession* ResearchModeController::GetCurrentSession() const {
 }
 
 void ResearchModeController::GetAllSessions(ResearchSessionsCallback callback) {
+  if (!index_loaded_) {
+    index_callbacks_.push_back(base::BindOnce(
+        &ResearchModeController::GetAllSessions,
+        weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
+    return;
+  }
+  if (!unloaded_sessions_.empty()) {
+    // Try again once every session's pages are in
+    std::vector<std::string> unloaded(unloaded_sessions_.begin(),
+                                      unloaded_sessions_.end());
+    base::RepeatingClosure barrier = base::BarrierClosure(
+        unloaded.size(),
+        base::BindOnce(&ResearchModeController::GetAllSessions,
+                       weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
+    for (const std::string& session_id : unloaded) {
+      LoadSessionPages(session_id, barrier);
+    }
+    return;
+  }
+  Wake();
   std::move(callback).Run(sessions_);
 }
 
 void ResearchModeController::SwitchSession(const std::string& session_id) {
+  if (!index_loaded_) {
+    index_callbacks_.push_back(base::BindOnce(
+        &ResearchModeController::SwitchSession,
+        weak_ptr_factory_.GetWeakPtr(), session_id));
+    return;
+  }
+  Wake();
   auto it = std::find_if(
       sessions_.begin(), sessions_.end(),
       [&session_id](const ResearchSession& session) {
@@ -243,6 +588,8 @@ void ResearchModeController::SwitchSession(const std::string& session_id) {
   if (it != sessions_.end()) {
     current_session_id_ = session_id;
     DLOG(INFO) << "Switched to research session: " << it->name << " (ID: " << session_id << ")";
+    LoadSessionPages(session_id, base::DoNothing());
+    ScheduleSave(std::string());
   } else {
     DLOG(WARNING) << "Research session not found: " << session_id;
   }
@@ -262,27 +609,71 @@ void ResearchModeController::AddCurrentPageToSession() {
   std::string url = entry->GetURL().spec();
   std::string title = base::UTF16ToUTF8(entry->GetTitle());
   
-  ProcessPage(url, title, base::BindOnce(
-      &ResearchModeController::HandleExtractedContext,
-      weak_ptr_factory_.GetWeakPtr(),
-      url, title));
+  QueueCurrentPage(url, title);
 }
 
 void ResearchModeController::AddPageToSession(
     const std::string& url, const std::string& title, const std::string& content) {
+  if (!IsCurrentSessionLoaded()) {
+    LoadCurrentSession(base::BindOnce(
+        &ResearchModeController::AddPageToSession,
+        weak_ptr_factory_.GetWeakPtr(), url, title, content));
+    return;
+  }
+  Wake();
   if (!IsResearchModeEnabled() || current_session_id_.empty()) {
     return;
   }
   
+  if (!PutPage(current_session_id_, url, title, content)) {
+    DLOG(WARNING) << "Current research session not found";
+    return;
+  }
+  
+  // Auto-generate key points if enabled
+  if (base::GetFieldTrialParamByFeatureAsBool(
+          kAsolResearchMode, "auto_generate_key_points", false)) {
+    ResearchPagePipeline::Page page;
+    page.session_id = current_session_id_;
+    page.url = url;
+    page.title = title;
+    page.content = content;
+    bool viewed =
+        web_contents() && web_contents()->GetLastCommittedURL().spec() == url;
+    pipeline_->Add(std::move(page), ResearchPagePipeline::Stage::kRedact,
+                   ResearchPagePipeline::Stage::kAnalyze, viewed);
+  }
+}
+
+void ResearchModeController::AddPagesToSession(
+    const std::vector<ResearchPageData>& pages) {
+  if (!IsCurrentSessionLoaded()) {
+    LoadCurrentSession(base::BindOnce(
+        &ResearchModeController::AddPagesToSession,
+        weak_ptr_factory_.GetWeakPtr(), pages));
+    return;
+  }
+  for (const ResearchPageData& page : pages) {
+    AddPageToSession(page.url, page.title, page.content);
+  }
+}
+
+bool ResearchModeController::PutPage(const std::string& session_id,
+                                     const std::string& url,
+                                     const std::string& title,
+                                     const std::string& content) {
+  Wake();
+  if (unloaded_sessions_.count(session_id)) {
+    return false;
+  }
   auto it = std::find_if(
       sessions_.begin(), sessions_.end(),
-      [this](const ResearchSession& session) {
-        return session.id == current_session_id_;
+      [&session_id](const ResearchSession& session) {
+        return session.id == session_id;
       });
   
   if (it == sessions_.end()) {
-    DLOG(WARNING) << "Current research session not found";
-    return;
+    return false;
   }
   
   // Check if the page already exists in the session
@@ -320,7 +711,9 @@ void ResearchModeController::AddPageToSession(
       
       if (oldest_it != it->pages.end()) {
         DLOG(INFO) << "Removing oldest page to make room: " << oldest_it->title;
+        std::string oldest_url = oldest_it->url;
         it->pages.erase(oldest_it);
+        UpdateSearchIndex(it->id, oldest_url);
       }
     }
     
@@ -330,18 +723,21 @@ void ResearchModeController::AddPageToSession(
   
   // Update the session's last updated time
   it->last_updated = base::Time::Now();
+  UpdateSearchIndex(it->id, url);
   
   // Save the updated sessions
-  SaveSessions();
-  
-  // Auto-generate key points if enabled
-  if (base::GetFieldTrialParamByFeatureAsBool(
-          kAsolResearchMode, "auto_generate_key_points", false)) {
-    GenerateKeyPoints(url, base::DoNothing());
-  }
+  ScheduleSave(it->id);
+  return true;
 }
 
 void ResearchModeController::RemovePageFromSession(const std::string& url) {
+  if (!IsCurrentSessionLoaded()) {
+    LoadCurrentSession(base::BindOnce(
+        &ResearchModeController::RemovePageFromSession,
+        weak_ptr_factory_.GetWeakPtr(), url));
+    return;
+  }
+  Wake();
   if (current_session_id_.empty()) {
     return;
   }
@@ -367,18 +763,26 @@ void ResearchModeController::RemovePageFromSession(const std::string& url) {
   if (page_it != it->pages.end()) {
     DLOG(INFO) << "Removing page from research session: " << page_it->title;
     it->pages.erase(page_it);
+    UpdateSearchIndex(it->id, url);
     
     // Update the session's last updated time
     it->last_updated = base::Time::Now();
     
     // Save the updated sessions
-    SaveSessions();
+    ScheduleSave(it->id);
   }
 }
 
 void ResearchModeController::GenerateSessionSummary(ResearchDataCallback callback) {
+  if (!IsCurrentSessionLoaded()) {
+    LoadCurrentSession(base::BindOnce(
+        &ResearchModeController::GenerateSessionSummary,
+        weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
+    return;
+  }
   // Track performance of this operation
   util::ScopedPerformanceTracker tracker("ResearchModeController_GenerateSessionSummary");
+  Wake();
   
   if (current_session_id_.empty()) {
     DLOG(WARNING) << "No current research session";
@@ -448,8 +852,15 @@ void ResearchModeController::GenerateSessionSummary(ResearchDataCallback callbac
 void ResearchModeController::GenerateKeyPoints(
     const std::string& url,
     base::OnceCallback<void(const std::vector<std::string>&)> callback) {
+  if (!IsCurrentSessionLoaded()) {
+    LoadCurrentSession(base::BindOnce(
+        &ResearchModeController::GenerateKeyPoints,
+        weak_ptr_factory_.GetWeakPtr(), url, std::move(callback)));
+    return;
+  }
   // Track performance of this operation
   util::ScopedPerformanceTracker tracker("ResearchModeController_GenerateKeyPoints");
+  Wake();
   
   if (current_session_id_.empty()) {
     DLOG(WARNING) << "No current research session";
@@ -492,70 +903,70 @@ void ResearchModeController::GenerateKeyPoints(
   // Process the prompt with the best available adapter for text generation
   service_manager->ProcessTextWithCapabilityAsync(
       "text-generation", prompt,
-      base::BindOnce([](ResearchModeController* controller,
-                      std::string session_id,
-                      std::string url,
-                      base::OnceCallback<void(const std::vector<std::string>&)> callback,
-                      const adapters::ModelResponse& response) {
-        std::vector<std::string> key_points;
-        
-        if (response.success) {
-          // Parse the key points from the response
-          std::vector<std::string> lines = base::SplitString(
-              response.text, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
-          
-          for (const auto& line : lines) {
-            // Look for bullet points or numbered lists
-            if (line.find("- ") == 0 || line.find("• ") == 0 ||
-                (line.size() > 2 && isdigit(line[0]) && line[1] == '.')) {
-              // Extract the content after the bullet or number
-              size_t start = line.find_first_of(" ") + 1;
-              if (start < line.size()) {
-                key_points.push_back(line.substr(start));
-              }
-            } else {
-              // If no bullet or number, just add the line as is
-              key_points.push_back(line);
+      base::BindOnce(
+          [](base::WeakPtr<ResearchModeController> controller,
+             std::string session_id, std::string url,
+             base::OnceCallback<void(const std::vector<std::string>&)> callback,
+             const adapters::ModelResponse& response) {
+            std::vector<std::string> key_points;
+            if (response.success) {
+              key_points = ParseKeyPoints(response.text);
             }
-          }
-        }
-        
-        // Update the page with the key points
-        auto session_it = std::find_if(
-            controller->sessions_.begin(), controller->sessions_.end(),
-            [&session_id](const ResearchSession& session) {
-              return session.id == session_id;
-            });
-        
-        if (session_it != controller->sessions_.end()) {
-          auto page_it = std::find_if(
-              session_it->pages.begin(), session_it->pages.end(),
-              [&url](const ResearchPageData& page) {
-                return page.url == url;
-              });
-          
-          if (page_it != session_it->pages.end()) {
-            page_it->key_points = key_points;
-            page_it->is_processed = true;
-            
-            // Update the session's last updated time
-            session_it->last_updated = base::Time::Now();
-            
-            // Save the updated sessions
-            controller->SaveSessions();
-          }
-        }
-        
-        std::move(callback).Run(key_points);
-      },
-      this, current_session_id_, url, std::move(callback)));
+            if (controller) {
+              controller->SetKeyPoints(session_id, url, key_points);
+            }
+            std::move(callback).Run(key_points);
+          },
+          weak_ptr_factory_.GetWeakPtr(), current_session_id_, url,
+          std::move(callback)));
+}
+
+void ResearchModeController::SetKeyPoints(
+    const std::string& session_id,
+    const std::string& url,
+    const std::vector<std::string>& key_points) {
+  Wake();
+  auto session_it = std::find_if(
+      sessions_.begin(), sessions_.end(),
+      [&session_id](const ResearchSession& session) {
+        return session.id == session_id;
+      });
+  
+  if (session_it == sessions_.end()) {
+    return;
+  }
+  
+  auto page_it = std::find_if(
+      session_it->pages.begin(), session_it->pages.end(),
+      [&url](const ResearchPageData& page) {
+        return page.url == url;
+      });
+  
+  if (page_it != session_it->pages.end()) {
+    page_it->key_points = key_points;
+    page_it->is_processed = true;
+    UpdateSearchIndex(session_id, url);
+    
+    // Update the session's last updated time
+    session_it->last_updated = base::Time::Now();
+    
+    // Save the updated sessions
+    ScheduleSave(session_id);
+  }
 }
 
 void ResearchModeController::ExportSessionToDocument(
     const std::string& format,
     base::OnceCallback<void(const std::string&)> callback) {
+  if (!IsCurrentSessionLoaded()) {
+    LoadCurrentSession(base::BindOnce(
+        &ResearchModeController::ExportSessionToDocument,
+        weak_ptr_factory_.GetWeakPtr(), format, std::move(callback)));
+    return;
+  }
   // Track performance of this operation
   util::ScopedPerformanceTracker tracker("ResearchModeController_ExportSessionToDocument");
+  Wake();
   
   if (current_session_id_.empty()) {
     DLOG(WARNING) << "No current research session";
@@ -610,11 +1021,106 @@ void ResearchModeController::ExportSessionToDocument(
       std::move(callback)));
 }
 
+void ResearchModeController::ExportSessionToFile(
+    const std::string& format,
+    const base::FilePath& path,
+    ExportProgressCallback progress_callback,
+    base::OnceCallback<void(bool)> callback) {
+  ExportSession(format, ResearchExportSink::CreateForFile(path),
+                std::move(progress_callback), std::move(callback));
+}
+
+void ResearchModeController::ExportSession(
+    const std::string& format,
+    std::unique_ptr<ResearchExportSink> sink,
+    ExportProgressCallback progress_callback,
+    base::OnceCallback<void(bool)> callback) {
+  if (!IsCurrentSessionLoaded()) {
+    LoadCurrentSession(base::BindOnce(
+        &ResearchModeController::ExportSession,
+        weak_ptr_factory_.GetWeakPtr(), format, std::move(sink),
+        std::move(progress_callback), std::move(callback)));
+    return;
+  }
+  Wake();
+  
+  std::optional<ResearchSessionExporter::Format> export_format =
+      ResearchSessionExporter::ParseFormat(format);
+  if (!export_format) {
+    DLOG(WARNING) << "Unknown export format: " << format;
+    std::move(callback).Run(false);
+    return;
+  }
+  
+  auto it = std::find_if(
+      sessions_.begin(), sessions_.end(),
+      [this](const ResearchSession& session) {
+        return session.id == current_session_id_;
+      });
+  
+  if (current_session_id_.empty() || it == sessions_.end()) {
+    DLOG(WARNING) << "No current research session";
+    std::move(callback).Run(false);
+    return;
+  }
+  
+  // The exporters are owned here, so they may look pages up unretained
+  int export_id = next_export_id_++;
+  auto exporter = std::make_unique<ResearchSessionExporter>(
+      *export_format, *it,
+      base::BindRepeating(&ResearchModeController::GetExportPage,
+                          base::Unretained(this), it->id),
+      std::move(sink), std::move(progress_callback),
+      base::BindOnce(&ResearchModeController::OnExportDone,
+                     base::Unretained(this), export_id, std::move(callback)));
+  ResearchSessionExporter* exporter_ptr = exporter.get();
+  exports_[export_id] = std::move(exporter);
+  exporter_ptr->Start();
+}
+
+const ResearchPageData* ResearchModeController::GetExportPage(
+    const std::string& session_id,
+    const std::string& url) {
+  // An export needs the pages even in the background
+  Wake();
+  
+  auto session_it = std::find_if(
+      sessions_.begin(), sessions_.end(),
+      [&session_id](const ResearchSession& session) {
+        return session.id == session_id;
+      });
+  if (session_it == sessions_.end()) {
+    return nullptr;
+  }
+  
+  auto page_it = std::find_if(
+      session_it->pages.begin(), session_it->pages.end(),
+      [&url](const ResearchPageData& page) {
+        return page.url == url;
+      });
+  return page_it != session_it->pages.end() ? &*page_it : nullptr;
+}
+
+void ResearchModeController::OnExportDone(
+    int export_id,
+    base::OnceCallback<void(bool)> callback,
+    bool success) {
+  exports_.erase(export_id);
+  std::move(callback).Run(success);
+}
+
 void ResearchModeController::SearchSession(
     const std::string& query,
-    base::OnceCallback<void(const std::vector<ResearchPageData>&)> callback) {
+    base::OnceCallback<void(const std::vector<ResearchSearchHit>&)> callback) {
+  if (!IsCurrentSessionLoaded()) {
+    LoadCurrentSession(base::BindOnce(
+        &ResearchModeController::SearchSession,
+        weak_ptr_factory_.GetWeakPtr(), query, std::move(callback)));
+    return;
+  }
   // Track performance of this operation
   util::ScopedPerformanceTracker tracker("ResearchModeController_SearchSession");
+  Wake();
   
   if (current_session_id_.empty()) {
     DLOG(WARNING) << "No current research session";
@@ -634,34 +1140,66 @@ void ResearchModeController::SearchSession(
     return;
   }
   
-  // Convert query to lowercase for case-insensitive search
-  std::string query_lower = base::ToLowerASCII(query);
-  
-  // Search for pages that match the query
-  std::vector<ResearchPageData> matching_pages;
-  
-  for (const auto& page : it->pages) {
-    // Check if the query appears in the title, content, or key points
-    std::string title_lower = base::ToLowerASCII(page.title);
-    std::string content_lower = base::ToLowerASCII(page.content);
-    
-    if (title_lower.find(query_lower) != std::string::npos ||
-        content_lower.find(query_lower) != std::string::npos) {
-      matching_pages.push_back(page);
+  std::vector<ResearchSearchHit> hits;
+  for (const ResearchSearchIndex::Hit& hit :
+       GetSearchIndex(*it)->Search(query, kMaxSearchHits)) {
+    auto page_it = std::find_if(
+        it->pages.begin(), it->pages.end(),
+        [&hit](const ResearchPageData& page) {
+          return page.url == hit.url;
+        });
+    if (page_it == it->pages.end()) {
       continue;
     }
-    
-    // Check key points
-    for (const auto& point : page.key_points) {
-      std::string point_lower = base::ToLowerASCII(point);
-      if (point_lower.find(query_lower) != std::string::npos) {
-        matching_pages.push_back(page);
-        break;
-      }
-    }
+    ResearchSearchHit result;
+    result.url = page_it->url;
+    result.title = page_it->title;
+    result.snippet = ResearchSearchIndex::GetSnippet(page_it->content, query,
+                                                     kSnippetLength);
+    result.score = hit.score;
+    hits.push_back(std::move(result));
   }
   
-  std::move(callback).Run(matching_pages);
+  std::move(callback).Run(hits);
+}
+
+ResearchSearchIndex* ResearchModeController::GetSearchIndex(
+    const ResearchSession& session) {
+  std::unique_ptr<ResearchSearchIndex>& index = search_indexes_[session.id];
+  if (!index) {
+    index = std::make_unique<ResearchSearchIndex>();
+    for (const auto& page : session.pages) {
+      index->Update(page);
+    }
+  }
+  return index.get();
+}
+
+void ResearchModeController::UpdateSearchIndex(const std::string& session_id,
+                                               const std::string& url) {
+  auto index_it = search_indexes_.find(session_id);
+  if (index_it == search_indexes_.end()) {
+    return;
+  }
+  auto session_it = std::find_if(
+      sessions_.begin(), sessions_.end(),
+      [&session_id](const ResearchSession& session) {
+        return session.id == session_id;
+      });
+  if (session_it == sessions_.end()) {
+    search_indexes_.erase(index_it);
+    return;
+  }
+  auto page_it = std::find_if(
+      session_it->pages.begin(), session_it->pages.end(),
+      [&url](const ResearchPageData& page) {
+        return page.url == url;
+      });
+  if (page_it != session_it->pages.end()) {
+    index_it->second->Update(*page_it);
+  } else {
+    index_it->second->Remove(url);
+  }
 }
 
 void ResearchModeController::DidFinishNavigation(
@@ -672,23 +1210,22 @@ void ResearchModeController::DidFinishNavigation(
     return;
   }
   
+  // Whatever is queued for the page now shown goes first
+  std::string url = navigation_handle->GetURL().spec();
+  pipeline_->Prioritize(url);
+  
   // Check if research mode is enabled and auto-add pages is enabled
   if (IsResearchModeEnabled() && base::GetFieldTrialParamByFeatureAsBool(
           kAsolResearchMode, "auto_add_pages", false)) {
     // Add the page to the current research session
-    std::string url = navigation_handle->GetURL().spec();
     std::string title = base::UTF16ToUTF8(web_contents()->GetTitle());
-    
-    ProcessPage(url, title, base::BindOnce(
-        &ResearchModeController::HandleExtractedContext,
-        weak_ptr_factory_.GetWeakPtr(),
-        url, title));
+    QueueCurrentPage(url, title);
   }
 }
 
 void ResearchModeController::WebContentsDestroyed() {
   // Save research sessions before web contents is destroyed
-  SaveSessions();
+  FlushSave();
 }
 
 void ResearchModeController::TitleWasSet(content::NavigationEntry* entry) {
@@ -698,12 +1235,21 @@ void ResearchModeController::TitleWasSet(content::NavigationEntry* entry) {
   }
   
   // Update the title of the current page in the research session
-  std::string url = entry->GetURL().spec();
-  std::string title = base::UTF16ToUTF8(entry->GetTitle());
-  
+  UpdatePageTitle(entry->GetURL().spec(), base::UTF16ToUTF8(entry->GetTitle()));
+}
+
+void ResearchModeController::UpdatePageTitle(const std::string& url,
+                                             const std::string& title) {
+  if (!IsCurrentSessionLoaded()) {
+    LoadCurrentSession(base::BindOnce(
+        &ResearchModeController::UpdatePageTitle,
+        weak_ptr_factory_.GetWeakPtr(), url, title));
+    return;
+  }
   if (current_session_id_.empty()) {
     return;
   }
+  Wake();
   
   auto session_it = std::find_if(
       sessions_.begin(), sessions_.end(),
@@ -725,12 +1271,13 @@ void ResearchModeController::TitleWasSet(content::NavigationEntry* entry) {
   if (page_it != session_it->pages.end()) {
     // Update the title
     page_it->title = title;
+    UpdateSearchIndex(session_it->id, url);
     
     // Update the session's last updated time
     session_it->last_updated = base::Time::Now();
     
     // Save the updated sessions
-    SaveSessions();
+    ScheduleSave(session_it->id);
   }
 }
 
@@ -738,6 +1285,7 @@ void ResearchModeController::ProcessPage(
     const std::string& url, 
     const std::string& title,
     PageContextExtractor::ContextCallback callback) {
+  Wake();
   if (!context_extractor_) {
     std::move(callback).Run("");
     return;
@@ -747,95 +1295,338 @@ void ResearchModeController::ProcessPage(
   context_extractor_->ExtractFullPageContent(std::move(callback));
 }
 
-void ResearchModeController::HandleExtractedContext(
-    const std::string& url,
-    const std::string& title,
-    const std::string& context) {
-  // Add the page to the current research session
-  AddPageToSession(url, title, context);
+void ResearchModeController::QueueCurrentPage(const std::string& url,
+                                              const std::string& title) {
+  if (!IsCurrentSessionLoaded()) {
+    LoadCurrentSession(base::BindOnce(
+        &ResearchModeController::QueueCurrentPage,
+        weak_ptr_factory_.GetWeakPtr(), url, title));
+    return;
+  }
+  if (!IsResearchModeEnabled() || current_session_id_.empty()) {
+    return;
+  }
+  
+  ResearchPagePipeline::Page page;
+  page.session_id = current_session_id_;
+  page.url = url;
+  page.title = title;
+  bool analyze = base::GetFieldTrialParamByFeatureAsBool(
+      kAsolResearchMode, "auto_generate_key_points", false);
+  pipeline_->Add(std::move(page), ResearchPagePipeline::Stage::kExtract,
+                 analyze ? ResearchPagePipeline::Stage::kAnalyze
+                         : ResearchPagePipeline::Stage::kExtract,
+                 /*prioritized=*/true);
+}
+
+void ResearchModeController::ExtractPage(
+    ResearchPagePipeline::Page page,
+    ResearchPagePipeline::DoneCallback done) {
+  // Only the page the tab shows can be extracted, and it may have
+  // navigated on while this page was queued
+  if (!web_contents() ||
+      web_contents()->GetLastCommittedURL().spec() != page.url) {
+    std::move(done).Run(std::nullopt);
+    return;
+  }
+  
+  std::string url = page.url;
+  std::string title = page.title;
+  ProcessPage(url, title, base::BindOnce(
+      &ResearchModeController::OnPageExtracted,
+      weak_ptr_factory_.GetWeakPtr(), std::move(page), std::move(done)));
+}
+
+void ResearchModeController::OnPageExtracted(
+    ResearchPagePipeline::Page page,
+    ResearchPagePipeline::DoneCallback done,
+    const std::string& content) {
+  if (content.empty() ||
+      !PutPage(page.session_id, page.url, page.title, content)) {
+    std::move(done).Run(std::nullopt);
+    return;
+  }
+  page.content = content;
+  std::move(done).Run(std::move(page));
+}
+
+void ResearchModeController::RedactPage(
+    ResearchPagePipeline::Page page,
+    ResearchPagePipeline::DoneCallback done) {
+  if (!privacy_proxy_) {
+    privacy_proxy_ = std::make_unique<core::PrivacyProxy>();
+  }
+  
+  // Redaction runs on the thread pool, which shares this copy of the content
+  core::SharedText content = page.content;
+  privacy_proxy_->ProcessText(
+      std::move(content),
+      base::BindOnce(
+          [](ResearchPagePipeline::Page page,
+             ResearchPagePipeline::DoneCallback done,
+             const core::PrivacyProxy::ProcessingResult& result) {
+            page.redacted_content = std::string(result.processed_text);
+            std::move(done).Run(std::move(page));
+          },
+          std::move(page), std::move(done)));
+}
+
+void ResearchModeController::AnalyzePage(
+    ResearchPagePipeline::Page page,
+    ResearchPagePipeline::DoneCallback done) {
+  std::string prompt = base::StringPrintf(
+      kKeyPointsPrompt, page.redacted_content.c_str());
+  core::ServiceManager::GetInstance()->ProcessTextWithCapabilityAsync(
+      "text-generation", prompt,
+      base::BindOnce(&ResearchModeController::OnPageAnalyzed,
+                     weak_ptr_factory_.GetWeakPtr(), std::move(page),
+                     std::move(done)));
+}
+
+void ResearchModeController::OnPageAnalyzed(
+    ResearchPagePipeline::Page page,
+    ResearchPagePipeline::DoneCallback done,
+    const adapters::ModelResponse& response) {
+  if (!response.success) {
+    DLOG(WARNING) << "Failed to generate key points for " << page.url;
+    std::move(done).Run(std::nullopt);
+    return;
+  }
+  SetKeyPoints(page.session_id, page.url, ParseKeyPoints(response.text));
+  std::move(done).Run(std::move(page));
+}
+
+void ResearchModeController::SetProcessingProgressCallback(
+    ProcessingProgressCallback callback) {
+  processing_progress_callback_ = std::move(callback);
+}
+
+const ResearchPagePipeline::Progress&
+ResearchModeController::GetProcessingProgress() const {
+  return pipeline_->GetProgress();
+}
+
+void ResearchModeController::OnProcessingProgress(
+    const ResearchPagePipeline::Progress& progress) {
+  if (processing_progress_callback_) {
+    processing_progress_callback_.Run(progress);
+  }
 }
 
 std::string ResearchModeController::GenerateSessionId() const {
   return base::GenerateGUID();
 }
 
-void ResearchModeController::SaveSessions() {
-  if (!web_contents()) {
+// static
+scoped_refptr<ResearchModeController::Store> ResearchModeController::GetStore(
+    const base::FilePath& dir) {
+  // One per directory, so that every tab's writes go through one sequence
+  static base::NoDestructor<std::map<base::FilePath, scoped_refptr<Store>>>
+      stores;
+  scoped_refptr<Store>& store = (*stores)[dir];
+  if (!store) {
+    store = base::MakeRefCounted<Store>(dir);
+  }
+  return store;
+}
+
+void ResearchModeController::ScheduleSave(const std::string& session_id) {
+  if (!store_) {
     return;
   }
   
-  content::BrowserContext* browser_context = web_contents()->GetBrowserContext();
-  if (!browser_context) {
-    return;
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (!save_pending_) {
+    save_pending_ = true;
+    first_unsaved_change_ = now;
+  }
+  if (!session_id.empty()) {
+    unsaved_sessions_.insert(session_id);
   }
   
-  base::FilePath path = GetResearchSessionsFilePath(browser_context);
-  if (path.empty()) {
-    DLOG(ERROR) << "Failed to get research sessions file path";
+  // Each change puts the save off, unless changes have kept it off too long
+  if (now - first_unsaved_change_ >= kMaxSaveDelay) {
+    FlushSave();
     return;
   }
+  save_timer_.Start(FROM_HERE, kSaveDelay,
+                    base::BindOnce(&ResearchModeController::FlushSave,
+                                   base::Unretained(this)));
+}
+
+void ResearchModeController::FlushSave() {
+  save_timer_.Stop();
+  if (!save_pending_ || !store_) {
+    return;
+  }
+  save_pending_ = false;
   
-  // Convert sessions to JSON
-  base::Value::List sessions_list;
+  // Never write out the empty sessions of a hibernated controller
+  Wake();
+  
+  base::Value::Dict index;
+  base::Value::List index_list;
   for (const auto& session : sessions_) {
-    sessions_list.Append(ResearchSessionToValue(session));
+    index_list.Append(SessionInfoToValue(session));
   }
+  index.Set("sessions", std::move(index_list));
+  index.Set("current_session_id", current_session_id_);
   
-  base::Value::Dict root;
-  root.Set("sessions", std::move(sessions_list));
-  root.Set("current_session_id", current_session_id_);
+  // Copies, for the background sequence to serialize and write
+  std::vector<ResearchSession> changed;
+  for (const std::string& session_id : unsaved_sessions_) {
+    auto it = std::find_if(
+        sessions_.begin(), sessions_.end(),
+        [&session_id](const ResearchSession& session) {
+          return session.id == session_id;
+        });
+    if (it != sessions_.end() && !unloaded_sessions_.count(session_id)) {
+      changed.push_back(*it);
+    }
+  }
+  unsaved_sessions_.clear();
   
-  std::string json_string;
-  if (!base::JSONWriter::WriteWithOptions(
-          root, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json_string)) {
-    DLOG(ERROR) << "Failed to serialize research sessions to JSON";
+  store_->task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(&Store::Write, store_, std::move(index),
+                                std::move(changed)));
+}
+
+void ResearchModeController::LoadSessions() {
+  base::FilePath dir;
+  if (web_contents() && web_contents()->GetBrowserContext()) {
+    dir = GetResearchSessionsDir(web_contents()->GetBrowserContext());
+  }
+  if (dir.empty()) {
+    DLOG(ERROR) << "Failed to get research sessions directory";
+    OnIndexLoaded(std::nullopt);
     return;
   }
   
-  // Write to file
-  if (base::WriteFile(path, json_string.data(), json_string.size()) == -1) {
-    DLOG(ERROR) << "Failed to write research sessions to file: " << path.value();
+  if (!store_) {
+    store_ = GetStore(dir);
   }
+  index_loaded_ = false;
+  store_->task_runner()->PostTaskAndReplyWithResult(
+      FROM_HERE, base::BindOnce(&Store::ReadIndex, store_),
+      base::BindOnce(&ResearchModeController::OnIndexLoaded,
+                     weak_ptr_factory_.GetWeakPtr()));
 }
 
-void ResearchModeController::LoadSessions() {
-  if (!web_contents()) {
-    return;
+void ResearchModeController::OnIndexLoaded(
+    std::optional<base::Value::Dict> index) {
+  Wake();
+  sessions_.clear();
+  unloaded_sessions_.clear();
+  search_indexes_.clear();
+  if (index) {
+    // Just the names and times; pages load when the session is used
+    if (const base::Value::List* sessions_list = index->FindList("sessions")) {
+      for (const auto& session_value : *sessions_list) {
+        if (!session_value.is_dict()) continue;
+        sessions_.push_back(ValueToResearchSession(session_value.GetDict()));
+        unloaded_sessions_.insert(sessions_.back().id);
+      }
+    }
   }
+  index_loaded_ = true;
+  DLOG(INFO) << "Loaded " << sessions_.size() << " research sessions";
   
-  content::BrowserContext* browser_context = web_contents()->GetBrowserContext();
-  if (!browser_context) {
-    return;
+  // Create a default session if none exists
+  if (sessions_.empty()) {
+    CreateResearchSession("Default Research", "General Research");
+  } else {
+    // Use the most recently updated session as the current session
+    auto latest_it = std::max_element(
+        sessions_.begin(), sessions_.end(),
+        [](const ResearchSession& a, const ResearchSession& b) {
+          return a.last_updated < b.last_updated;
+        });
+    current_session_id_ = latest_it->id;
+    LoadSessionPages(current_session_id_, base::DoNothing());
   }
   
-  base::FilePath path = GetResearchSessionsFilePath(browser_context);
-  if (path.empty()) {
-    DLOG(ERROR) << "Failed to get research sessions file path";
-    return;
+  std::vector<base::OnceClosure> callbacks;
+  callbacks.swap(index_callbacks_);
+  for (base::OnceClosure& callback : callbacks) {
+    std::move(callback).Run();
   }
   
-  // Check if the file exists
-  if (!base::PathExists(path)) {
-    DLOG(INFO) << "Research sessions file does not exist: " << path.value();
+  if (store_) {
+    store_->task_runner()->PostTask(
+        FROM_HERE, base::BindOnce(&Store::CollectGarbage, store_));
+  }
+}
+
+bool ResearchModeController::IsCurrentSessionLoaded() const {
+  return index_loaded_ && !unloaded_sessions_.count(current_session_id_);
+}
+
+void ResearchModeController::LoadCurrentSession(base::OnceClosure callback) {
+  if (!index_loaded_) {
+    index_callbacks_.push_back(base::BindOnce(
+        &ResearchModeController::LoadCurrentSession,
+        weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
     return;
   }
-  
-  // Read the file
-  std::string json_string;
-  if (!base::ReadFileToString(path, &json_string)) {
-    DLOG(ERROR) << "Failed to read research sessions from file: " << path.value();
+  LoadSessionPages(current_session_id_, std::move(callback));
+}
+
+void ResearchModeController::LoadSessionPages(const std::string& session_id,
+                                              base::OnceClosure callback) {
+  if (!unloaded_sessions_.count(session_id) || !store_) {
+    std::move(callback).Run();
     return;
   }
   
-  // Parse the JSON
-  absl::optional<base::Value> value = base::JSONReader::Read(json_string);
-  if (!value || !value->is_dict()) {
-    DLOG(ERROR) << "Failed to parse research sessions JSON";
+  std::vector<base::OnceClosure>& callbacks = session_callbacks_[session_id];
+  callbacks.push_back(std::move(callback));
+  if (callbacks.size() > 1) {
+    // Already loading
     return;
   }
+  store_->task_runner()->PostTaskAndReplyWithResult(
+      FROM_HERE, base::BindOnce(&Store::ReadSession, store_, session_id),
+      base::BindOnce(&ResearchModeController::OnSessionPagesLoaded,
+                     weak_ptr_factory_.GetWeakPtr(), session_id));
+}
+
+void ResearchModeController::OnSessionPagesLoaded(
+    const std::string& session_id,
+    std::optional<std::vector<ResearchPageData>> pages) {
+  Wake();
+  // Methods that change pages wait for the load, so none are lost here
+  auto it = std::find_if(
+      sessions_.begin(), sessions_.end(),
+      [&session_id](const ResearchSession& session) {
+        return session.id == session_id;
+      });
+  if (it != sessions_.end() && pages) {
+    it->pages = std::move(*pages);
+  }
+  unloaded_sessions_.erase(session_id);
+  search_indexes_.erase(session_id);
+  
+  std::vector<base::OnceClosure> callbacks;
+  callbacks.swap(session_callbacks_[session_id]);
+  session_callbacks_.erase(session_id);
+  for (base::OnceClosure& callback : callbacks) {
+    std::move(callback).Run();
+  }
+}
+
+base::Value::Dict ResearchModeController::SessionsToValue() const {
+  base::Value::List sessions_list;
+  for (const auto& session : sessions_) {
+    sessions_list.Append(ResearchSessionToValue(session));
+  }
   
-  const base::Value::Dict& root = value->GetDict();
-  
+  base::Value::Dict root;
+  root.Set("sessions", std::move(sessions_list));
+  root.Set("current_session_id", current_session_id_);
+  return root;
+}
+
+void ResearchModeController::SessionsFromValue(const base::Value::Dict& root) {
   // Get the current session ID
   current_session_id_ = root.FindString("current_session_id").value_or("");
   
@@ -852,8 +1643,47 @@ void ResearchModeController::LoadSessions() {
     
     sessions_.push_back(ValueToResearchSession(session_value.GetDict()));
   }
+}
+
+void ResearchModeController::Hibernate() {
+  if (is_hibernated()) {
+    return;
+  }
   
-  DLOG(INFO) << "Loaded " << sessions_.size() << " research sessions";
+  // Waking may fall back to what was saved
+  FlushSave();
+  
+  hibernated_state_ = TabHibernationManager::PackState(SessionsToValue());
+  if (hibernated_state_.empty()) {
+    DLOG(ERROR) << "Failed to pack research sessions; keeping them in memory";
+    return;
+  }
+  
+  // Swap rather than clear, to free the capacity as well
+  std::vector<ResearchSession>().swap(sessions_);
+  search_indexes_.clear();
+  context_extractor_.reset();
+}
+
+void ResearchModeController::Wake() {
+  if (!is_hibernated()) {
+    return;
+  }
+  
+  std::optional<base::Value::Dict> root =
+      TabHibernationManager::UnpackState(hibernated_state_);
+  hibernated_state_.clear();
+  if (root) {
+    SessionsFromValue(*root);
+  } else {
+    // Fall back to what was last saved
+    DLOG(ERROR) << "Failed to unpack research sessions";
+    LoadSessions();
+  }
+  
+  if (web_contents()) {
+    context_extractor_ = std::make_unique<PageContextExtractor>(web_contents());
+  }
 }
 
 }  // namespace browser
@@ -5,14 +5,23 @@
 #ifndef ASOL_BROWSER_RESEARCH_MODE_CONTROLLER_H_
 #define ASOL_BROWSER_RESEARCH_MODE_CONTROLLER_H_
 
+#include <map>
 #include <memory>
+#include <optional>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "asol/browser/page_context_extractor.h"
+#include "asol/browser/research_page_pipeline.h"
+#include "asol/browser/research_session_exporter.h"
 #include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "base/values.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
 
@@ -21,8 +30,18 @@ class WebContents;
 }
 
 namespace asol {
+namespace adapters {
+struct ModelResponse;
+}
+
+namespace core {
+class PrivacyProxy;
+}
+
 namespace browser {
 
+class ResearchSearchIndex;
+
 // Structure to hold research data from a page
 struct ResearchPageData {
   std::string url;
@@ -43,9 +62,31 @@ struct ResearchSession {
   base::Time last_updated;
 };
 
+// A page found by searching a research session
+struct ResearchSearchHit {
+  std::string url;
+  std::string title;
+  // Of the page content, around the words searched for
+  std::string snippet;
+  // BM25; higher is better
+  double score = 0;
+};
+
 // ResearchModeController manages the research mode functionality.
 // It tracks visited pages, extracts relevant content, and provides
 // tools for organizing and analyzing research data.
+//
+// Sessions are stored as an index of their names and times, plus a file
+// of pages per session, with large page bodies kept apart as blobs named
+// by their hash so a body is written once however often its session is.
+// The index is read in the background on creation and each session's
+// pages when first used; methods called before then run once they are.
+// Changes are saved in the background, a few seconds after the last, so
+// a burst of them costs one write of each session changed.
+//
+// Pages are extracted, redacted and analyzed for key points through a
+// ResearchPagePipeline, several at a time, with the page the tab shows
+// first.
 class ResearchModeController
     : public content::WebContentsObserver,
       public content::WebContentsUserData<ResearchModeController> {
@@ -57,6 +98,13 @@ class ResearchModeController
   using ResearchSessionsCallback = 
       base::OnceCallback<void(const std::vector<ResearchSession>&)>;
 
+  // Callback for receiving the progress of page processing
+  using ProcessingProgressCallback =
+      base::RepeatingCallback<void(const ResearchPagePipeline::Progress&)>;
+
+  // Callback for receiving the progress of an export
+  using ExportProgressCallback = ResearchSessionExporter::ProgressCallback;
+
   ~ResearchModeController() override;
 
   // Disallow copy and assign
@@ -73,8 +121,9 @@ class ResearchModeController
   void CreateResearchSession(const std::string& name, 
                             const std::string& topic);
 
-  // Get the current research session
-  const ResearchSession* GetCurrentSession() const;
+  // Get the current research session. Its pages may still be loading;
+  // null until the session index has loaded.
+  const ResearchSession* GetCurrentSession();
 
   // Get all research sessions
   void GetAllSessions(ResearchSessionsCallback callback);
@@ -90,9 +139,18 @@ class ResearchModeController
                        const std::string& title,
                        const std::string& content);
 
+  // Add many pages to the research session, analyzing them several at a
+  // time if key points are generated automatically
+  void AddPagesToSession(const std::vector<ResearchPageData>& pages);
+
   // Remove a page from the research session
   void RemovePageFromSession(const std::string& url);
 
+  // Get told of the progress of the pages being processed in the
+  // background, or ask for it
+  void SetProcessingProgressCallback(ProcessingProgressCallback callback);
+  const ResearchPagePipeline::Progress& GetProcessingProgress() const;
+
   // Generate a summary of the research session
   void GenerateSessionSummary(ResearchDataCallback callback);
 
@@ -104,9 +162,32 @@ class ResearchModeController
   void ExportSessionToDocument(const std::string& format,
                               base::OnceCallback<void(const std::string&)> callback);
 
-  // Search within the research session
+  // Write the research session, with the full content of its pages, to
+  // |path| as |format|: "markdown", "html" or "json". The document is
+  // written a piece at a time rather than built in memory; see
+  // ResearchSessionExporter.
+  void ExportSessionToFile(const std::string& format,
+                          const base::FilePath& path,
+                          ExportProgressCallback progress_callback,
+                          base::OnceCallback<void(bool)> callback);
+
+  // The same, to |sink|, e.g. an upload
+  void ExportSession(const std::string& format,
+                    std::unique_ptr<ResearchExportSink> sink,
+                    ExportProgressCallback progress_callback,
+                    base::OnceCallback<void(bool)> callback);
+
+  // Search within the research session, for pages with any word of
+  // |query|, best match first
   void SearchSession(const std::string& query,
-                    base::OnceCallback<void(const std::vector<ResearchPageData>&)> callback);
+                    base::OnceCallback<void(const std::vector<ResearchSearchHit>&)> callback);
+
+  // Pack the sessions into a compressed blob and free them, along with the
+  // context extractor, while the tab is in the background. See
+  // TabHibernationManager. Every method that needs them wakes first.
+  void Hibernate();
+  void Wake();
+  bool is_hibernated() const { return !hibernated_state_.empty(); }
 
  private:
   // Allow WebContentsUserData to create instances of this class
@@ -126,19 +207,91 @@ class ResearchModeController
                   const std::string& title,
                   PageContextExtractor::ContextCallback callback);
 
-  // Handle extracted context from a page
-  void HandleExtractedContext(const std::string& url,
-                             const std::string& title,
-                             const std::string& context);
+  // Queue the page the tab shows to be extracted into the current session
+  void QueueCurrentPage(const std::string& url, const std::string& title);
+
+  // Add or update a page of |session_id|. Returns false if the session is
+  // not in memory.
+  bool PutPage(const std::string& session_id,
+               const std::string& url,
+               const std::string& title,
+               const std::string& content);
+
+  // Set the key points of a page of |session_id|, if it is still there
+  void SetKeyPoints(const std::string& session_id,
+                    const std::string& url,
+                    const std::vector<std::string>& key_points);
+
+  // The stages of |pipeline_|
+  void ExtractPage(ResearchPagePipeline::Page page,
+                   ResearchPagePipeline::DoneCallback done);
+  void OnPageExtracted(ResearchPagePipeline::Page page,
+                       ResearchPagePipeline::DoneCallback done,
+                       const std::string& content);
+  void RedactPage(ResearchPagePipeline::Page page,
+                  ResearchPagePipeline::DoneCallback done);
+  void AnalyzePage(ResearchPagePipeline::Page page,
+                   ResearchPagePipeline::DoneCallback done);
+  void OnPageAnalyzed(ResearchPagePipeline::Page page,
+                      ResearchPagePipeline::DoneCallback done,
+                      const adapters::ModelResponse& response);
+
+  void OnProcessingProgress(const ResearchPagePipeline::Progress& progress);
+
+  // The page at |url| of |session_id|, for an export, or null if it is
+  // gone
+  const ResearchPageData* GetExportPage(const std::string& session_id,
+                                        const std::string& url);
+  void OnExportDone(int export_id,
+                    base::OnceCallback<void(bool)> callback,
+                    bool success);
 
   // Generate a unique ID for a research session
   std::string GenerateSessionId() const;
 
-  // Save research sessions to disk
-  void SaveSessions();
+  // The session files, used on their own task runner
+  class Store;
+
+  // The store in |dir|, created on first use
+  static scoped_refptr<Store> GetStore(const base::FilePath& dir);
+
+  // Save |session_id|'s pages, and the index, once changes have settled.
+  // An empty |session_id| saves just the index.
+  void ScheduleSave(const std::string& session_id);
 
-  // Load research sessions from disk
+  // Save what ScheduleSave() was asked to now
+  void FlushSave();
+
+  // Start loading the session index
   void LoadSessions();
+  void OnIndexLoaded(std::optional<base::Value::Dict> index);
+
+  // Whether the index and the current session's pages are in memory
+  bool IsCurrentSessionLoaded() const;
+
+  // Load them if not already, then run |callback|
+  void LoadCurrentSession(base::OnceClosure callback);
+
+  // Load |session_id|'s pages if not already, then run |callback|
+  void LoadSessionPages(const std::string& session_id,
+                        base::OnceClosure callback);
+  void OnSessionPagesLoaded(
+      const std::string& session_id,
+      std::optional<std::vector<ResearchPageData>> pages);
+
+  // Set the title of |url| in the current session
+  void UpdatePageTitle(const std::string& url, const std::string& title);
+
+  // The search index of |session|, built on first use
+  ResearchSearchIndex* GetSearchIndex(const ResearchSession& session);
+
+  // Bring |session_id|'s search index, if built, up to date with its page
+  // at |url|, which may have been removed
+  void UpdateSearchIndex(const std::string& session_id, const std::string& url);
+
+  // The sessions and current session ID as a value, and back
+  base::Value::Dict SessionsToValue() const;
+  void SessionsFromValue(const base::Value::Dict& root);
 
   // The context extractor
   std::unique_ptr<PageContextExtractor> context_extractor_;
@@ -152,6 +305,39 @@ class ResearchModeController
   // All research sessions
   std::vector<ResearchSession> sessions_;
 
+  // The packed sessions while hibernated, empty otherwise
+  std::string hibernated_state_;
+
+  // Null if there is nowhere to save
+  scoped_refptr<Store> store_;
+
+  bool index_loaded_ = false;
+  // Run once the index has loaded
+  std::vector<base::OnceClosure> index_callbacks_;
+  // Sessions whose pages are not in memory yet, and the callbacks waiting
+  // for those being loaded
+  std::set<std::string> unloaded_sessions_;
+  std::map<std::string, std::vector<base::OnceClosure>> session_callbacks_;
+
+  // Sessions changed since the last save, and whether anything was
+  bool save_pending_ = false;
+  std::set<std::string> unsaved_sessions_;
+  base::TimeTicks first_unsaved_change_;
+  base::OneShotTimer save_timer_;
+
+  // Of the sessions searched, by ID. Kept up to date as pages change.
+  std::map<std::string, std::unique_ptr<ResearchSearchIndex>> search_indexes_;
+
+  // Takes pages through extraction, redaction and analysis
+  std::unique_ptr<ResearchPagePipeline> pipeline_;
+  ProcessingProgressCallback processing_progress_callback_;
+  // Redacts page content before it is analyzed, created on first use
+  std::unique_ptr<core::PrivacyProxy> privacy_proxy_;
+
+  // The exports under way, by ID
+  std::map<int, std::unique_ptr<ResearchSessionExporter>> exports_;
+  int next_export_id_ = 0;
+
   // For generating weak pointers to this
   base::WeakPtrFactory<ResearchModeController> weak_ptr_factory_{this};
 
@@ -0,0 +1,168 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/browser/research_page_pipeline.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/functional/bind.h"
+
+namespace asol {
+namespace browser {
+
+ResearchPagePipeline::Page::Page() = default;
+ResearchPagePipeline::Page::Page(Page&&) = default;
+ResearchPagePipeline::Page& ResearchPagePipeline::Page::operator=(Page&&) =
+    default;
+ResearchPagePipeline::Page::~Page() = default;
+
+ResearchPagePipeline::Job::Job() = default;
+ResearchPagePipeline::Job::Job(Job&&) = default;
+ResearchPagePipeline::Job& ResearchPagePipeline::Job::operator=(Job&&) =
+    default;
+ResearchPagePipeline::Job::~Job() = default;
+
+ResearchPagePipeline::ResearchPagePipeline(
+    const Options& options,
+    std::array<StageCallback, kStageCount> stages,
+    ProgressCallback progress_callback)
+    : options_(options),
+      stages_(std::move(stages)),
+      progress_callback_(std::move(progress_callback)) {}
+
+ResearchPagePipeline::~ResearchPagePipeline() = default;
+
+void ResearchPagePipeline::Add(Page page,
+                               Stage first,
+                               Stage last,
+                               bool prioritized) {
+  DCHECK_LE(static_cast<size_t>(first), static_cast<size_t>(last));
+  bool inserted = keys_.emplace(page.session_id, page.url).second;
+  if (prioritized) {
+    Prioritize(page.url);
+  }
+  if (!inserted) {
+    return;
+  }
+
+  Job job;
+  job.page = std::move(page);
+  job.last_stage = static_cast<size_t>(last);
+  progress_.added++;
+  Enqueue(std::move(job), static_cast<size_t>(first));
+  Pump();
+  NotifyProgress();
+}
+
+void ResearchPagePipeline::Prioritize(const std::string& url) {
+  bool in_pipeline =
+      std::any_of(keys_.begin(), keys_.end(),
+                  [&url](const Key& key) { return key.second == url; });
+  if (!in_pipeline || !prioritized_urls_.insert(url).second) {
+    return;
+  }
+  for (std::deque<Job>& queue : queues_) {
+    // Keep the prioritized pages first, in the order they were queued
+    std::stable_partition(queue.begin(), queue.end(), [this](const Job& job) {
+      return IsPrioritized(job);
+    });
+  }
+}
+
+void ResearchPagePipeline::Enqueue(Job job, size_t stage) {
+  std::deque<Job>& queue = queues_[stage];
+  auto it = queue.end();
+  if (IsPrioritized(job)) {
+    it = std::find_if(queue.begin(), queue.end(), [this](const Job& queued) {
+      return !IsPrioritized(queued);
+    });
+  }
+  queue.insert(it, std::move(job));
+  progress_.queued[stage]++;
+}
+
+void ResearchPagePipeline::Pump() {
+  // A stage may finish synchronously and pump again; the outer loop picks
+  // up whatever it frees
+  if (pumping_) {
+    return;
+  }
+  pumping_ = true;
+
+  bool started = true;
+  while (started) {
+    started = false;
+    for (size_t stage = kStageCount; stage-- > 0;) {
+      std::deque<Job>& queue = queues_[stage];
+      if (queue.empty() ||
+          progress_.running[stage] >= options_.max_concurrent[stage]) {
+        continue;
+      }
+
+      Job job = std::move(queue.front());
+      queue.pop_front();
+      progress_.queued[stage]--;
+      progress_.running[stage]++;
+      Key key(job.page.session_id, job.page.url);
+      stages_[stage].Run(
+          std::move(job.page),
+          base::BindOnce(&ResearchPagePipeline::OnStageDone,
+                         weak_ptr_factory_.GetWeakPtr(), stage, job.last_stage,
+                         std::move(key)));
+
+      // Re-scan from the last stage so pages under way go first
+      started = true;
+      break;
+    }
+  }
+
+  pumping_ = false;
+}
+
+void ResearchPagePipeline::OnStageDone(size_t stage,
+                                       size_t last_stage,
+                                       Key key,
+                                       std::optional<Page> page) {
+  DCHECK_GT(progress_.running[stage], 0u);
+  progress_.running[stage]--;
+  if (!page || stage == last_stage) {
+    Finish(key, /*failed=*/!page);
+  } else {
+    Job job;
+    job.page = std::move(*page);
+    job.last_stage = last_stage;
+    Enqueue(std::move(job), stage + 1);
+  }
+  Pump();
+  NotifyProgress();
+}
+
+void ResearchPagePipeline::Finish(const Key& key, bool failed) {
+  keys_.erase(key);
+  progress_.finished++;
+  if (failed) {
+    progress_.failed++;
+  }
+  bool url_in_use = std::any_of(
+      keys_.begin(), keys_.end(),
+      [&key](const Key& other) { return other.second == key.second; });
+  if (!url_in_use) {
+    prioritized_urls_.erase(key.second);
+  }
+}
+
+void ResearchPagePipeline::NotifyProgress() {
+  if (progress_callback_) {
+    progress_callback_.Run(progress_);
+  }
+  // Start counting afresh with the next page added
+  if (keys_.empty()) {
+    progress_ = Progress();
+  }
+}
+
+}  // namespace browser
+}  // namespace asol
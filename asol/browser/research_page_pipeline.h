@@ -0,0 +1,157 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_BROWSER_RESEARCH_PAGE_PIPELINE_H_
+#define ASOL_BROWSER_RESEARCH_PAGE_PIPELINE_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <deque>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "base/functional/callback.h"
+#include "base/memory/weak_ptr.h"
+
+namespace asol {
+namespace browser {
+
+// ResearchPagePipeline moves the pages added to research sessions through
+// extraction, redaction and analysis, with each stage running a bounded
+// number of pages at once, so a bulk import keeps every stage busy, and
+// the AI provider at its rate limit, instead of taking pages one by one.
+//
+// The stages themselves are callbacks supplied by the owner. Within a
+// stage, prioritized pages go first and the rest in the order they were
+// added; across stages, later stages go first, so pages already under way
+// finish before new ones start. A page is in the pipeline at most once per
+// session; adding it again while it is only prioritizes it if asked.
+//
+// Must be used on a single sequence.
+class ResearchPagePipeline {
+ public:
+  enum class Stage {
+    kExtract = 0,
+    kRedact = 1,
+    kAnalyze = 2,
+  };
+  static constexpr size_t kStageCount = 3;
+
+  struct Page {
+    Page();
+    Page(Page&&);
+    Page& operator=(Page&&);
+    ~Page();
+
+    std::string session_id;
+    std::string url;
+    std::string title;
+    // Empty until extracted, if not known when added
+    std::string content;
+    // The content with personal information redacted, to send to the
+    // provider
+    std::string redacted_content;
+  };
+
+  // Run by a stage when it is done with a page: with the page, to pass it
+  // on, or with nullopt if the page failed. Must be run.
+  using DoneCallback = base::OnceCallback<void(std::optional<Page> page)>;
+  using StageCallback = base::RepeatingCallback<void(Page page,
+                                                     DoneCallback done)>;
+
+  struct Options {
+    // Pages each stage, indexed by Stage, works on at once
+    std::array<size_t, kStageCount> max_concurrent = {2, 4, 4};
+  };
+
+  // Counts since the pipeline was last idle, for "n of m pages" displays.
+  // They go back to zero once every page added has finished.
+  struct Progress {
+    size_t added = 0;
+    size_t finished = 0;
+    // Of the finished pages, those that a stage gave up on
+    size_t failed = 0;
+    std::array<size_t, kStageCount> queued = {};
+    std::array<size_t, kStageCount> running = {};
+  };
+  using ProgressCallback = base::RepeatingCallback<void(const Progress&)>;
+
+  // |stages| is indexed by Stage. |progress_callback|, if set, runs
+  // whenever the progress changes.
+  ResearchPagePipeline(const Options& options,
+                       std::array<StageCallback, kStageCount> stages,
+                       ProgressCallback progress_callback);
+  ~ResearchPagePipeline();
+
+  ResearchPagePipeline(const ResearchPagePipeline&) = delete;
+  ResearchPagePipeline& operator=(const ResearchPagePipeline&) = delete;
+
+  // Queue |page| to go through stages |first| to |last|, ahead of the
+  // pages not prioritized if |prioritized|. It may start before this
+  // returns.
+  void Add(Page page, Stage first, Stage last, bool prioritized);
+
+  // Move the pages at |url| ahead of the others, in the stage they are
+  // queued at and the ones after. For the page the user is looking at.
+  void Prioritize(const std::string& url);
+
+  bool IsIdle() const { return keys_.empty(); }
+  const Progress& GetProgress() const { return progress_; }
+
+ private:
+  struct Job {
+    Job();
+    Job(Job&&);
+    Job& operator=(Job&&);
+    ~Job();
+
+    Page page;
+    size_t last_stage = 0;
+  };
+
+  using Key = std::pair<std::string, std::string>;
+
+  // Queue |job| at |stage|, behind the pages of its priority
+  void Enqueue(Job job, size_t stage);
+
+  bool IsPrioritized(const Job& job) const {
+    return prioritized_urls_.count(job.page.url) > 0;
+  }
+
+  // Start queued pages while the stages have room
+  void Pump();
+
+  void OnStageDone(size_t stage,
+                   size_t last_stage,
+                   Key key,
+                   std::optional<Page> page);
+
+  // Count |key| as finished and forget it
+  void Finish(const Key& key, bool failed);
+
+  void NotifyProgress();
+
+  const Options options_;
+  const std::array<StageCallback, kStageCount> stages_;
+  ProgressCallback progress_callback_;
+
+  std::array<std::deque<Job>, kStageCount> queues_;
+  // (session ID, URL) of every page in the pipeline
+  std::set<Key> keys_;
+  // Of pages in the pipeline, those to go first
+  std::set<std::string> prioritized_urls_;
+
+  Progress progress_;
+  bool pumping_ = false;
+
+  base::WeakPtrFactory<ResearchPagePipeline> weak_ptr_factory_{this};
+};
+
+}  // namespace browser
+}  // namespace asol
+
+#endif  // ASOL_BROWSER_RESEARCH_PAGE_PIPELINE_H_
@@ -0,0 +1,253 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/browser/research_search_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+#include <utility>
+
+#include "asol/browser/research_mode_controller.h"
+#include "base/strings/string_util.h"
+
+namespace asol {
+namespace browser {
+
+namespace {
+
+// BM25 term frequency saturation and length normalization
+constexpr double kK1 = 1.2;
+constexpr double kB = 0.75;
+
+// Weight of one occurrence of a word in each field
+constexpr float kTitleWeight = 3.0f;
+constexpr float kKeyPointWeight = 2.0f;
+constexpr float kContentWeight = 1.0f;
+
+// Single characters match too much to rank by
+constexpr size_t kMinWordLength = 2;
+
+// Run |visitor| on each word of |text| with the offsets it spans
+template <typename Visitor>
+void ForEachWord(std::string_view text, Visitor visitor) {
+  std::string word;
+  size_t start = 0;
+  for (size_t i = 0; i <= text.size(); ++i) {
+    char c = i < text.size() ? text[i] : ' ';
+    if (base::IsAsciiAlphaNumeric(c) || (c & 0x80)) {
+      if (word.empty()) {
+        start = i;
+      }
+      word.push_back(base::ToLowerASCII(c));
+    } else if (!word.empty()) {
+      if (word.size() >= kMinWordLength) {
+        visitor(word, start, i);
+      }
+      word.clear();
+    }
+  }
+}
+
+}  // namespace
+
+ResearchSearchIndex::ResearchSearchIndex() = default;
+ResearchSearchIndex::~ResearchSearchIndex() = default;
+
+void ResearchSearchIndex::Update(const ResearchPageData& page) {
+  auto [id_it, inserted] =
+      ids_.try_emplace(page.url, static_cast<PageId>(pages_.size()));
+  if (!inserted) {
+    RemovePage(id_it->second);
+  } else if (!free_ids_.empty()) {
+    id_it->second = free_ids_.back();
+    free_ids_.pop_back();
+  } else {
+    pages_.emplace_back();
+  }
+  PageId id = id_it->second;
+
+  std::unordered_map<TermId, float> frequencies;
+  float length = 0;
+  auto add_field = [&](std::string_view text, float weight) {
+    ForEachWord(text, [&](const std::string& word, size_t, size_t) {
+      auto [it, inserted] =
+          term_ids_.try_emplace(word, static_cast<TermId>(postings_.size()));
+      if (inserted) {
+        postings_.emplace_back();
+      }
+      frequencies[it->second] += weight;
+      length += weight;
+    });
+  };
+  add_field(page.title, kTitleWeight);
+  for (const std::string& point : page.key_points) {
+    add_field(point, kKeyPointWeight);
+  }
+  add_field(page.content, kContentWeight);
+
+  Page& indexed = pages_[id];
+  indexed.url = page.url;
+  indexed.length = length;
+  indexed.terms.reserve(frequencies.size());
+  for (const auto& [term, frequency] : frequencies) {
+    postings_[term].push_back({id, frequency});
+    indexed.terms.push_back(term);
+  }
+  total_length_ += length;
+}
+
+void ResearchSearchIndex::Remove(const std::string& url) {
+  auto it = ids_.find(url);
+  if (it == ids_.end()) {
+    return;
+  }
+  PageId id = it->second;
+  ids_.erase(it);
+  RemovePage(id);
+  free_ids_.push_back(id);
+}
+
+std::vector<ResearchSearchIndex::Hit> ResearchSearchIndex::Search(
+    std::string_view query,
+    size_t max_hits) const {
+  std::vector<TermId> terms;
+  ForEachWord(query, [&](const std::string& word, size_t, size_t) {
+    auto it = term_ids_.find(word);
+    if (it != term_ids_.end()) {
+      terms.push_back(it->second);
+    }
+  });
+  std::sort(terms.begin(), terms.end());
+  terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+  if (terms.empty() || ids_.empty() || max_hits == 0) {
+    return {};
+  }
+
+  double count = static_cast<double>(ids_.size());
+  double average_length = std::max(total_length_ / count, 1.0);
+  std::unordered_map<PageId, double> scores;
+  for (TermId term : terms) {
+    const std::vector<Posting>& postings = postings_[term];
+    if (postings.empty()) {
+      continue;
+    }
+    double frequency_in_pages = static_cast<double>(postings.size());
+    double idf = std::log(1.0 + (count - frequency_in_pages + 0.5) /
+                                    (frequency_in_pages + 0.5));
+    for (const Posting& posting : postings) {
+      double norm =
+          kK1 * (1.0 - kB + kB * pages_[posting.id].length / average_length);
+      scores[posting.id] +=
+          idf * posting.frequency * (kK1 + 1.0) / (posting.frequency + norm);
+    }
+  }
+
+  std::vector<std::pair<double, PageId>> ranked;
+  ranked.reserve(scores.size());
+  for (const auto& [id, score] : scores) {
+    ranked.emplace_back(score, id);
+  }
+  auto better = [this](const std::pair<double, PageId>& a,
+                       const std::pair<double, PageId>& b) {
+    return a.first != b.first ? a.first > b.first
+                              : pages_[a.second].url < pages_[b.second].url;
+  };
+  if (ranked.size() > max_hits) {
+    std::partial_sort(ranked.begin(), ranked.begin() + max_hits, ranked.end(),
+                      better);
+    ranked.resize(max_hits);
+  } else {
+    std::sort(ranked.begin(), ranked.end(), better);
+  }
+
+  std::vector<Hit> hits;
+  hits.reserve(ranked.size());
+  for (const auto& [score, id] : ranked) {
+    hits.push_back({pages_[id].url, score});
+  }
+  return hits;
+}
+
+// static
+std::string ResearchSearchIndex::GetSnippet(std::string_view text,
+                                            std::string_view query,
+                                            size_t max_length) {
+  std::unordered_set<std::string> query_words;
+  ForEachWord(query, [&](const std::string& word, size_t, size_t) {
+    query_words.insert(word);
+  });
+
+  // Where the query's words are in |text|
+  std::vector<std::pair<size_t, size_t>> matches;
+  ForEachWord(text, [&](const std::string& word, size_t start, size_t end) {
+    if (query_words.count(word)) {
+      matches.emplace_back(start, end);
+    }
+  });
+
+  // The window starting at a match that holds the most matches
+  size_t best = 0;
+  size_t best_count = 0;
+  for (size_t first = 0, last = 0; first < matches.size(); ++first) {
+    last = std::max(last, first);
+    while (last < matches.size() &&
+           matches[last].second - matches[first].first <= max_length) {
+      ++last;
+    }
+    if (last - first > best_count) {
+      best = first;
+      best_count = last - first;
+    }
+  }
+
+  // Lead in with some context, from a space
+  size_t start = 0;
+  if (!matches.empty()) {
+    size_t match = matches[best].first;
+    start = match > max_length / 4 ? match - max_length / 4 : 0;
+    if (start > 0) {
+      size_t space = text.find(' ', start);
+      start = space < match ? space + 1 : match;
+    }
+  }
+  size_t end = std::min(text.size(), start + max_length);
+  if (end < text.size()) {
+    size_t space = text.rfind(' ', end);
+    if (space != std::string_view::npos && space > start) {
+      end = space;
+    }
+  }
+
+  std::string snippet =
+      base::CollapseWhitespaceASCII(text.substr(start, end - start),
+                                    /*trim_sequences_with_line_breaks=*/false);
+  if (start > 0) {
+    snippet.insert(0, "...");
+  }
+  if (end < text.size()) {
+    snippet.append("...");
+  }
+  return snippet;
+}
+
+void ResearchSearchIndex::RemovePage(PageId id) {
+  Page& page = pages_[id];
+  for (TermId term : page.terms) {
+    std::vector<Posting>& postings = postings_[term];
+    auto it = std::find_if(postings.begin(), postings.end(),
+                           [id](const Posting& posting) {
+                             return posting.id == id;
+                           });
+    if (it != postings.end()) {
+      *it = postings.back();
+      postings.pop_back();
+    }
+  }
+  total_length_ -= page.length;
+  page = Page();
+}
+
+}  // namespace browser
+}  // namespace asol
@@ -0,0 +1,98 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_BROWSER_RESEARCH_SEARCH_INDEX_H_
+#define ASOL_BROWSER_RESEARCH_SEARCH_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace asol {
+namespace browser {
+
+struct ResearchPageData;
+
+// ResearchSearchIndex finds the pages of a research session that match a
+// text query without scanning their text: an inverted index from each word
+// to the pages it occurs in, ranked with BM25, and kept up to date a page
+// at a time as pages are added, changed and removed.
+//
+// A page's title, key points and content are indexed as one document,
+// with a word counting more in the title and key points than in the
+// content. Words are ASCII-lowercased runs of letters and digits; other
+// bytes, including UTF-8, are kept as they are.
+//
+// Pages are identified by URL, as in a session. Must be used on one
+// sequence.
+class ResearchSearchIndex {
+ public:
+  struct Hit {
+    std::string url;
+    double score;
+  };
+
+  ResearchSearchIndex();
+  ~ResearchSearchIndex();
+
+  ResearchSearchIndex(const ResearchSearchIndex&) = delete;
+  ResearchSearchIndex& operator=(const ResearchSearchIndex&) = delete;
+
+  // Index |page|, replacing what was indexed for its URL before
+  void Update(const ResearchPageData& page);
+  void Remove(const std::string& url);
+
+  // Up to |max_hits| pages matching any word of |query|, best first. Costs
+  // time in the number of pages that contain a query word, not in the
+  // size of the index.
+  std::vector<Hit> Search(std::string_view query, size_t max_hits) const;
+
+  // Up to about |max_length| bytes of |text| around where words of |query|
+  // occur most densely, cut at spaces, with "..." where it was cut. The
+  // start of |text| if no word of |query| is in it.
+  static std::string GetSnippet(std::string_view text,
+                                std::string_view query,
+                                size_t max_length);
+
+  size_t GetPageCount() const { return ids_.size(); }
+  size_t GetTermCount() const { return postings_.size(); }
+
+ private:
+  using PageId = uint32_t;
+  using TermId = uint32_t;
+
+  struct Posting {
+    PageId id;
+    // Occurrences, weighted by the field they are in
+    float frequency;
+  };
+
+  struct Page {
+    // Weighted word count, the document length of BM25
+    float length = 0;
+    // Terms with a posting for this page, to remove them on reindexing
+    std::vector<TermId> terms;
+    std::string url;
+  };
+
+  void RemovePage(PageId id);
+
+  std::unordered_map<std::string, TermId> term_ids_;
+  std::vector<std::vector<Posting>> postings_;
+
+  std::unordered_map<std::string, PageId> ids_;
+  std::vector<Page> pages_;
+  // Slots of |pages_| freed by removals
+  std::vector<PageId> free_ids_;
+  double total_length_ = 0;
+};
+
+}  // namespace browser
+}  // namespace asol
+
+#endif  // ASOL_BROWSER_RESEARCH_SEARCH_INDEX_H_
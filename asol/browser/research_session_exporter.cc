@@ -0,0 +1,448 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/browser/research_session_exporter.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "asol/browser/research_mode_controller.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/functional/bind.h"
+#include "base/i18n/time_formatting.h"
+#include "base/json/string_escape.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/escape.h"
+#include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+
+namespace asol {
+namespace browser {
+
+namespace {
+
+// The size of the pieces handed to the sink. Escaping may grow a piece by
+// a few times, but no more.
+constexpr size_t kPieceSize = 64 * 1024;
+
+// Whether |c| continues a UTF-8 sequence rather than starting one
+bool IsTrailByte(char c) {
+  return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+// |text| on one line, for headings
+std::string SingleLine(std::string_view text) {
+  return base::CollapseWhitespaceASCII(text, true);
+}
+
+std::string FormatTime(base::Time time) {
+  return base::TimeFormatAsIso8601(time);
+}
+
+// The export file, used on its task runner. Written beside |path| and
+// moved there once complete, so a failed export leaves nothing behind.
+class ExportFile : public base::RefCountedThreadSafe<ExportFile> {
+ public:
+  explicit ExportFile(const base::FilePath& path)
+      : path_(path),
+        temp_path_(path.AddExtension(FILE_PATH_LITERAL("partial"))),
+        task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+            {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+             base::TaskShutdownBehavior::BLOCK_SHUTDOWN})) {}
+
+  ExportFile(const ExportFile&) = delete;
+  ExportFile& operator=(const ExportFile&) = delete;
+
+  base::SequencedTaskRunner* task_runner() const { return task_runner_.get(); }
+
+  bool Append(std::string data) {
+    if (!Open()) {
+      return false;
+    }
+    if (file_.WriteAtCurrentPos(data.data(), static_cast<int>(data.size())) !=
+        static_cast<int>(data.size())) {
+      DLOG(ERROR) << "Failed to write research export: " << temp_path_.value();
+      Abandon();
+      return false;
+    }
+    return true;
+  }
+
+  bool Commit() {
+    if (!Open()) {
+      return false;
+    }
+    file_.Close();
+    if (!base::ReplaceFile(temp_path_, path_, nullptr)) {
+      DLOG(ERROR) << "Failed to move research export to " << path_.value();
+      Abandon();
+      return false;
+    }
+    return true;
+  }
+
+  void Abandon() {
+    file_.Close();
+    failed_ = true;
+    base::DeleteFile(temp_path_);
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<ExportFile>;
+  ~ExportFile() = default;
+
+  bool Open() {
+    if (file_.IsValid() || failed_) {
+      return !failed_;
+    }
+    file_.Initialize(temp_path_,
+                     base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+    if (!file_.IsValid()) {
+      DLOG(ERROR) << "Failed to create research export: "
+                  << temp_path_.value();
+      failed_ = true;
+    }
+    return !failed_;
+  }
+
+  const base::FilePath path_;
+  const base::FilePath temp_path_;
+  const scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  base::File file_;
+  bool failed_ = false;
+};
+
+class FileSink : public ResearchExportSink {
+ public:
+  explicit FileSink(const base::FilePath& path)
+      : file_(base::MakeRefCounted<ExportFile>(path)) {}
+
+  ~FileSink() override {
+    if (!finished_) {
+      file_->task_runner()->PostTask(
+          FROM_HERE, base::BindOnce(&ExportFile::Abandon, file_));
+    }
+  }
+
+  void Write(std::string data, DoneCallback done) override {
+    file_->task_runner()->PostTaskAndReplyWithResult(
+        FROM_HERE, base::BindOnce(&ExportFile::Append, file_, std::move(data)),
+        std::move(done));
+  }
+
+  void Finish(DoneCallback done) override {
+    finished_ = true;
+    file_->task_runner()->PostTaskAndReplyWithResult(
+        FROM_HERE, base::BindOnce(&ExportFile::Commit, file_),
+        std::move(done));
+  }
+
+ private:
+  const scoped_refptr<ExportFile> file_;
+  bool finished_ = false;
+};
+
+}  // namespace
+
+// static
+std::unique_ptr<ResearchExportSink> ResearchExportSink::CreateForFile(
+    const base::FilePath& path) {
+  return std::make_unique<FileSink>(path);
+}
+
+// static
+std::optional<ResearchSessionExporter::Format>
+ResearchSessionExporter::ParseFormat(std::string_view format) {
+  if (base::EqualsCaseInsensitiveASCII(format, "markdown") ||
+      base::EqualsCaseInsensitiveASCII(format, "md")) {
+    return Format::kMarkdown;
+  }
+  if (base::EqualsCaseInsensitiveASCII(format, "html") ||
+      base::EqualsCaseInsensitiveASCII(format, "htm")) {
+    return Format::kHtml;
+  }
+  if (base::EqualsCaseInsensitiveASCII(format, "json")) {
+    return Format::kJson;
+  }
+  return std::nullopt;
+}
+
+ResearchSessionExporter::ResearchSessionExporter(
+    Format format,
+    const ResearchSession& session,
+    PageCallback get_page,
+    std::unique_ptr<ResearchExportSink> sink,
+    ProgressCallback progress_callback,
+    DoneCallback done_callback)
+    : format_(format),
+      get_page_(std::move(get_page)),
+      sink_(std::move(sink)),
+      progress_callback_(std::move(progress_callback)),
+      done_callback_(std::move(done_callback)),
+      session_id_(session.id),
+      session_name_(session.name),
+      session_topic_(session.topic),
+      session_created_(session.created),
+      session_last_updated_(session.last_updated),
+      urls_([&session] {
+        std::vector<std::string> urls;
+        urls.reserve(session.pages.size());
+        for (const ResearchPageData& page : session.pages) {
+          urls.push_back(page.url);
+        }
+        return urls;
+      }()) {
+  progress_.page_count = urls_.size();
+}
+
+ResearchSessionExporter::~ResearchSessionExporter() = default;
+
+void ResearchSessionExporter::Start() {
+  WriteNext();
+}
+
+void ResearchSessionExporter::WriteNext() {
+  // Looked up afresh for each piece, since the session may have changed
+  // while the last was written
+  const ResearchPageData* page = nullptr;
+  while (buffer_.size() < kPieceSize && step_ != Step::kDone) {
+    switch (step_) {
+      case Step::kHeader:
+        AppendHeader();
+        step_ = Step::kPageStart;
+        break;
+
+      case Step::kPageStart:
+        if (next_page_ == urls_.size()) {
+          step_ = Step::kFooter;
+          break;
+        }
+        page = get_page_.Run(urls_[next_page_]);
+        if (!page) {
+          // Removed since the export started
+          next_page_++;
+          break;
+        }
+        AppendPageStart(*page);
+        content_offset_ = 0;
+        step_ = Step::kPageContent;
+        break;
+
+      case Step::kPageContent:
+        if (!page) {
+          page = get_page_.Run(urls_[next_page_]);
+        }
+        if (page && content_offset_ < page->content.size()) {
+          AppendPageContent(*page, kPieceSize - buffer_.size());
+          break;
+        }
+        // Close the page whether written in full or removed part way
+        AppendPageEnd();
+        next_page_++;
+        page = nullptr;
+        step_ = Step::kPageStart;
+        break;
+
+      case Step::kFooter:
+        AppendFooter();
+        step_ = Step::kDone;
+        break;
+
+      case Step::kDone:
+        break;
+    }
+  }
+
+  if (buffer_.empty()) {
+    sink_->Finish(base::BindOnce(&ResearchSessionExporter::OnFinished,
+                                 weak_ptr_factory_.GetWeakPtr()));
+    return;
+  }
+
+  std::string piece = std::move(buffer_);
+  buffer_.clear();
+  size_t size = piece.size();
+  sink_->Write(std::move(piece),
+               base::BindOnce(&ResearchSessionExporter::OnWritten,
+                              weak_ptr_factory_.GetWeakPtr(), size));
+}
+
+void ResearchSessionExporter::OnWritten(size_t size, bool success) {
+  if (!success) {
+    DLOG(ERROR) << "Failed to export research session " << session_id_;
+    std::move(done_callback_).Run(false);
+    return;
+  }
+
+  progress_.bytes_written += size;
+  // Pages left out count as written, so the count reaches |page_count|
+  progress_.pages_written = next_page_;
+  if (progress_callback_) {
+    progress_callback_.Run(progress_);
+  }
+  WriteNext();
+}
+
+void ResearchSessionExporter::OnFinished(bool success) {
+  std::move(done_callback_).Run(success);
+}
+
+void ResearchSessionExporter::AppendHeader() {
+  switch (format_) {
+    case Format::kMarkdown:
+      buffer_ += "# " + SingleLine(session_name_) + "\n\n";
+      if (!session_topic_.empty()) {
+        buffer_ += "Topic: " + SingleLine(session_topic_) + "\n\n";
+      }
+      buffer_ += "Created " + FormatTime(session_created_) +
+                 ", last updated " + FormatTime(session_last_updated_) +
+                 "\n\n";
+      break;
+
+    case Format::kHtml: {
+      std::string name = base::EscapeForHTML(session_name_);
+      buffer_ += "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n";
+      buffer_ += "<title>" + name + "</title>\n</head>\n<body>\n";
+      buffer_ += "<h1>" + name + "</h1>\n";
+      if (!session_topic_.empty()) {
+        buffer_ += "<p>Topic: " + base::EscapeForHTML(session_topic_) +
+                   "</p>\n";
+      }
+      buffer_ += "<p>Created " + FormatTime(session_created_) +
+                 ", last updated " + FormatTime(session_last_updated_) +
+                 "</p>\n";
+      break;
+    }
+
+    case Format::kJson:
+      buffer_ += "{\"id\":";
+      base::EscapeJSONString(session_id_, true, &buffer_);
+      buffer_ += ",\"name\":";
+      base::EscapeJSONString(session_name_, true, &buffer_);
+      buffer_ += ",\"topic\":";
+      base::EscapeJSONString(session_topic_, true, &buffer_);
+      buffer_ += ",\"created\":\"" + FormatTime(session_created_) +
+                 "\",\"last_updated\":\"" +
+                 FormatTime(session_last_updated_) + "\",\"pages\":[";
+      break;
+  }
+}
+
+void ResearchSessionExporter::AppendPageStart(const ResearchPageData& page) {
+  const std::string& title = page.title.empty() ? page.url : page.title;
+  switch (format_) {
+    case Format::kMarkdown:
+      buffer_ += "## " + SingleLine(title) + "\n\n";
+      buffer_ += "<" + page.url + ">\n\n";
+      buffer_ += "Added " + FormatTime(page.timestamp) + "\n\n";
+      if (!page.key_points.empty()) {
+        buffer_ += "### Key points\n\n";
+        for (const std::string& point : page.key_points) {
+          buffer_ += "- " + SingleLine(point) + "\n";
+        }
+        buffer_ += "\n";
+      }
+      buffer_ += "### Content\n\n";
+      break;
+
+    case Format::kHtml:
+      buffer_ += "<article>\n<h2><a href=\"" + base::EscapeForHTML(page.url) +
+                 "\">" + base::EscapeForHTML(title) + "</a></h2>\n";
+      buffer_ += "<p>Added " + FormatTime(page.timestamp) + "</p>\n";
+      if (!page.key_points.empty()) {
+        buffer_ += "<ul>\n";
+        for (const std::string& point : page.key_points) {
+          buffer_ += "<li>" + base::EscapeForHTML(point) + "</li>\n";
+        }
+        buffer_ += "</ul>\n";
+      }
+      buffer_ += "<pre style=\"white-space: pre-wrap\">";
+      break;
+
+    case Format::kJson:
+      if (wrote_page_) {
+        buffer_ += ",";
+      }
+      buffer_ += "{\"url\":";
+      base::EscapeJSONString(page.url, true, &buffer_);
+      buffer_ += ",\"title\":";
+      base::EscapeJSONString(page.title, true, &buffer_);
+      buffer_ += ",\"timestamp\":\"" + FormatTime(page.timestamp) +
+                 "\",\"key_points\":[";
+      for (size_t i = 0; i < page.key_points.size(); ++i) {
+        if (i > 0) {
+          buffer_ += ",";
+        }
+        base::EscapeJSONString(page.key_points[i], true, &buffer_);
+      }
+      buffer_ += "],\"content\":\"";
+      break;
+  }
+  wrote_page_ = true;
+}
+
+void ResearchSessionExporter::AppendPageContent(const ResearchPageData& page,
+                                                size_t max_size) {
+  const std::string& content = page.content;
+  size_t end = std::min(content.size(), content_offset_ + max_size);
+  // Keep multi-byte characters whole, so each slice escapes cleanly
+  while (end < content.size() && end > content_offset_ &&
+         IsTrailByte(content[end])) {
+    end--;
+  }
+  if (end == content_offset_) {
+    end++;
+    while (end < content.size() && IsTrailByte(content[end])) {
+      end++;
+    }
+  }
+
+  std::string_view slice(content.data() + content_offset_,
+                         end - content_offset_);
+  switch (format_) {
+    case Format::kMarkdown:
+      buffer_.append(slice);
+      break;
+    case Format::kHtml:
+      buffer_ += base::EscapeForHTML(slice);
+      break;
+    case Format::kJson:
+      base::EscapeJSONString(slice, false, &buffer_);
+      break;
+  }
+  content_offset_ = end;
+}
+
+void ResearchSessionExporter::AppendPageEnd() {
+  switch (format_) {
+    case Format::kMarkdown:
+      buffer_ += "\n\n";
+      break;
+    case Format::kHtml:
+      buffer_ += "</pre>\n</article>\n";
+      break;
+    case Format::kJson:
+      buffer_ += "\"}";
+      break;
+  }
+}
+
+void ResearchSessionExporter::AppendFooter() {
+  switch (format_) {
+    case Format::kMarkdown:
+      break;
+    case Format::kHtml:
+      buffer_ += "</body>\n</html>\n";
+      break;
+    case Format::kJson:
+      buffer_ += "]}\n";
+      break;
+  }
+}
+
+}  // namespace browser
+}  // namespace asol
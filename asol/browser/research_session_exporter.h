@@ -0,0 +1,157 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_BROWSER_RESEARCH_SESSION_EXPORTER_H_
+#define ASOL_BROWSER_RESEARCH_SESSION_EXPORTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/functional/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+
+namespace asol {
+namespace browser {
+
+struct ResearchPageData;
+struct ResearchSession;
+
+// ResearchExportSink takes an export a piece at a time. Each call runs
+// |done| once the sink is ready for more, so a slow disk or upload holds
+// the export back instead of the export piling up in memory.
+class ResearchExportSink {
+ public:
+  using DoneCallback = base::OnceCallback<void(bool success)>;
+
+  virtual ~ResearchExportSink() = default;
+
+  // Take the next piece of the export. Called once the previous write is
+  // done.
+  virtual void Write(std::string data, DoneCallback done) = 0;
+
+  // Everything has been written; make it available. An export destroyed
+  // before finishing is abandoned.
+  virtual void Finish(DoneCallback done) = 0;
+
+  // A sink writing to |path| in the background. The file appears, whole,
+  // once the export finishes, and not at all if it fails.
+  static std::unique_ptr<ResearchExportSink> CreateForFile(
+      const base::FilePath& path);
+};
+
+// ResearchSessionExporter writes a research session, with the full
+// content of its pages, as Markdown, HTML or JSON, to a
+// ResearchExportSink. The document is formatted a page, or a slice of a
+// long page, at a time and handed over in pieces of a bounded size, one
+// piece in flight at a time, so the memory an export takes does not grow
+// with the session.
+//
+// The pages are looked up by URL as they are reached, so the session may
+// change during the export: pages removed by then are left out and pages
+// added after it started are not included.
+//
+// Must be used on a single sequence.
+class ResearchSessionExporter {
+ public:
+  enum class Format {
+    kMarkdown,
+    kHtml,
+    kJson,
+  };
+
+  struct Progress {
+    size_t pages_written = 0;
+    size_t page_count = 0;
+    uint64_t bytes_written = 0;
+  };
+
+  // The page at |url| of the session, or null if it is no longer there
+  using PageCallback =
+      base::RepeatingCallback<const ResearchPageData*(const std::string& url)>;
+  using ProgressCallback = base::RepeatingCallback<void(const Progress&)>;
+  using DoneCallback = base::OnceCallback<void(bool success)>;
+
+  // The format named |format|, e.g. "markdown", "md", "html" or "json"
+  static std::optional<Format> ParseFormat(std::string_view format);
+
+  ResearchSessionExporter(Format format,
+                          const ResearchSession& session,
+                          PageCallback get_page,
+                          std::unique_ptr<ResearchExportSink> sink,
+                          ProgressCallback progress_callback,
+                          DoneCallback done_callback);
+  ~ResearchSessionExporter();
+
+  ResearchSessionExporter(const ResearchSessionExporter&) = delete;
+  ResearchSessionExporter& operator=(const ResearchSessionExporter&) = delete;
+
+  // Start writing. |done_callback| runs once the sink has finished, or on
+  // the first failure; this may be destroyed from it.
+  void Start();
+
+  const Progress& progress() const { return progress_; }
+
+ private:
+  // Where the formatting has got to
+  enum class Step {
+    kHeader,
+    kPageStart,
+    kPageContent,
+    kFooter,
+    kDone,
+  };
+
+  // Format into |buffer_| until it holds a piece's worth or the document
+  // is complete, then hand it to the sink
+  void WriteNext();
+  void OnWritten(size_t size, bool success);
+  void OnFinished(bool success);
+
+  void AppendHeader();
+  void AppendPageStart(const ResearchPageData& page);
+  // Append the content of |page| from |content_offset_| up to about
+  // |max_size| bytes
+  void AppendPageContent(const ResearchPageData& page, size_t max_size);
+  void AppendPageEnd();
+  void AppendFooter();
+
+  const Format format_;
+  const PageCallback get_page_;
+  const std::unique_ptr<ResearchExportSink> sink_;
+  const ProgressCallback progress_callback_;
+  DoneCallback done_callback_;
+
+  // The session as it was when the export started
+  const std::string session_id_;
+  const std::string session_name_;
+  const std::string session_topic_;
+  const base::Time session_created_;
+  const base::Time session_last_updated_;
+  const std::vector<std::string> urls_;
+
+  Step step_ = Step::kHeader;
+  size_t next_page_ = 0;
+  // Of the page being written, how much content has been
+  size_t content_offset_ = 0;
+  // Whether a page has been started, for the separators between pages
+  bool wrote_page_ = false;
+  // The piece being formatted, or being written
+  std::string buffer_;
+  Progress progress_;
+
+  base::WeakPtrFactory<ResearchSessionExporter> weak_ptr_factory_{this};
+};
+
+}  // namespace browser
+}  // namespace asol
+
+#endif  // ASOL_BROWSER_RESEARCH_SESSION_EXPORTER_H_
@@ -0,0 +1,98 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/browser/response_stream_bridge.h"
+
+#include <algorithm>
+
+#include "base/functional/bind.h"
+#include "base/location.h"
+
+namespace asol {
+namespace browser {
+
+ResponseStreamBridge::ResponseStreamBridge(Client* client,
+                                           base::TimeDelta frame_interval)
+    : client_(client), frame_interval_(frame_interval) {}
+
+ResponseStreamBridge::~ResponseStreamBridge() = default;
+
+adapters::StreamingResponseCallback
+ResponseStreamBridge::GetAdapterCallback() {
+  return [weak_this = weak_ptr_factory_.GetWeakPtr()](
+             const adapters::ModelResponse& response, bool is_done) {
+    if (weak_this) {
+      weak_this->OnAdapterResponse(response, is_done);
+    }
+  };
+}
+
+core::StreamDeltaCallback ResponseStreamBridge::GetStreamDeltaCallback() {
+  return base::BindRepeating(&ResponseStreamBridge::OnStreamDelta,
+                             weak_ptr_factory_.GetWeakPtr());
+}
+
+void ResponseStreamBridge::OnStreamDelta(const core::StreamDelta& delta) {
+  if (is_complete_) {
+    return;
+  }
+  Append(delta.text);
+  if (delta.is_final) {
+    Complete(delta.success, delta.error_message);
+  }
+}
+
+void ResponseStreamBridge::OnAdapterResponse(
+    const adapters::ModelResponse& response,
+    bool is_done) {
+  if (is_complete_) {
+    return;
+  }
+  // A failed adapter response carries no text, only the error
+  if (response.success) {
+    Append(response.text);
+  }
+  if (is_done || !response.success) {
+    Complete(response.success, response.error_message);
+  }
+}
+
+void ResponseStreamBridge::Append(std::string_view text) {
+  if (text.empty()) {
+    return;
+  }
+  pending_text_.append(text);
+  if (flush_timer_.IsRunning()) {
+    return;
+  }
+  // The first text after a pause goes out on the next task; later text
+  // waits for the frame after the last flush
+  base::TimeDelta delay =
+      std::max(base::TimeDelta(),
+               last_flush_time_ + frame_interval_ - base::TimeTicks::Now());
+  flush_timer_.Start(FROM_HERE, delay,
+                     base::BindOnce(&ResponseStreamBridge::Flush,
+                                    base::Unretained(this)));
+}
+
+void ResponseStreamBridge::Complete(bool success,
+                                    const std::string& error_message) {
+  Flush();
+  is_complete_ = true;
+  client_->OnResponseComplete(success, error_message);
+}
+
+void ResponseStreamBridge::Flush() {
+  flush_timer_.Stop();
+  last_flush_time_ = base::TimeTicks::Now();
+  if (pending_text_.empty()) {
+    return;
+  }
+  client_->OnResponseText(pending_text_);
+  // clear() keeps the capacity for the next frame
+  pending_text_.clear();
+}
+
+}  // namespace browser
+}  // namespace asol
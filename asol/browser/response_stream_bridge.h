@@ -0,0 +1,101 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_BROWSER_RESPONSE_STREAM_BRIDGE_H_
+#define ASOL_BROWSER_RESPONSE_STREAM_BRIDGE_H_
+
+#include <string>
+#include <string_view>
+
+#include "asol/adapters/adapter_interface.h"
+#include "asol/core/stream_delta.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace asol {
+namespace browser {
+
+// ResponseStreamBridge carries a streamed answer to a panel as it is
+// generated, so a long answer renders progressively instead of appearing
+// at once when complete.
+//
+// The text of the deltas that arrive within one frame is batched and
+// handed to the client once, as only what is new since the previous batch;
+// the panel appends it, and the accumulated text is never sent again. The
+// batch buffer is reused from frame to frame, so steady streaming does not
+// allocate. The final delta flushes whatever is pending at once, then
+// completes the stream.
+//
+// One bridge carries one stream. Must be used on one sequence, and the
+// stream must deliver on it.
+class ResponseStreamBridge {
+ public:
+  class Client {
+   public:
+    virtual ~Client() = default;
+
+    // Text generated since the previous call. Only valid during the call.
+    virtual void OnResponseText(std::string_view text) = 0;
+
+    // The stream ended. Runs once, after the last OnResponseText(), and
+    // may destroy the bridge.
+    virtual void OnResponseComplete(bool success,
+                                    const std::string& error_message) = 0;
+  };
+
+  // One frame at 60 Hz
+  static constexpr base::TimeDelta kDefaultFrameInterval =
+      base::Microseconds(16667);
+
+  // |client| must outlive the bridge
+  explicit ResponseStreamBridge(
+      Client* client,
+      base::TimeDelta frame_interval = kDefaultFrameInterval);
+  ~ResponseStreamBridge();
+
+  ResponseStreamBridge(const ResponseStreamBridge&) = delete;
+  ResponseStreamBridge& operator=(const ResponseStreamBridge&) = delete;
+
+  // Callbacks to start the stream with: one for an adapter's
+  // ProcessTextStream(), one for a provider's ProcessStreamingRequest().
+  // Deltas arriving after the bridge is gone or the stream completed are
+  // dropped.
+  adapters::StreamingResponseCallback GetAdapterCallback();
+  core::StreamDeltaCallback GetStreamDeltaCallback();
+
+  void OnStreamDelta(const core::StreamDelta& delta);
+
+  bool is_complete() const { return is_complete_; }
+
+ private:
+  void OnAdapterResponse(const adapters::ModelResponse& response,
+                         bool is_done);
+
+  // Add |text| to the pending batch, and arm the flush for the next frame
+  void Append(std::string_view text);
+
+  // Flush, then tell the client the stream ended. The client may destroy
+  // the bridge.
+  void Complete(bool success, const std::string& error_message);
+
+  // Hand the pending text to the client
+  void Flush();
+
+  Client* const client_;
+  const base::TimeDelta frame_interval_;
+
+  // Text received since the last flush
+  std::string pending_text_;
+  base::TimeTicks last_flush_time_;
+  base::OneShotTimer flush_timer_;
+  bool is_complete_ = false;
+
+  base::WeakPtrFactory<ResponseStreamBridge> weak_ptr_factory_{this};
+};
+
+}  // namespace browser
+}  // namespace asol
+
+#endif  // ASOL_BROWSER_RESPONSE_STREAM_BRIDGE_H_
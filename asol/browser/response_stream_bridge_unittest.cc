@@ -0,0 +1,106 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/browser/response_stream_bridge.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace browser {
+namespace {
+
+constexpr base::TimeDelta kFrame = base::Milliseconds(16);
+
+class RecordingClient : public ResponseStreamBridge::Client {
+ public:
+  void OnResponseText(std::string_view text) override {
+    batches.emplace_back(text);
+  }
+  void OnResponseComplete(bool success,
+                          const std::string& error_message) override {
+    ++completions;
+    this->success = success;
+    this->error_message = error_message;
+  }
+
+  std::vector<std::string> batches;
+  int completions = 0;
+  bool success = false;
+  std::string error_message;
+};
+
+core::StreamDelta MakeDelta(const std::string& text, bool is_final = false) {
+  core::StreamDelta delta;
+  delta.text = text;
+  delta.is_final = is_final;
+  delta.success = is_final;
+  return delta;
+}
+
+class ResponseStreamBridgeTest : public testing::Test {
+ protected:
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  RecordingClient client_;
+  ResponseStreamBridge bridge_{&client_, kFrame};
+};
+
+TEST_F(ResponseStreamBridgeTest, BatchesDeltasPerFrame) {
+  core::StreamDeltaCallback callback = bridge_.GetStreamDeltaCallback();
+  callback.Run(MakeDelta("Hel"));
+  callback.Run(MakeDelta("lo"));
+  task_environment_.RunUntilIdle();
+  ASSERT_EQ(client_.batches, std::vector<std::string>({"Hello"}));
+
+  // Within the frame: held until it ends
+  callback.Run(MakeDelta(", "));
+  task_environment_.FastForwardBy(kFrame / 2);
+  callback.Run(MakeDelta("world"));
+  EXPECT_EQ(client_.batches.size(), 1u);
+  task_environment_.FastForwardBy(kFrame / 2);
+  EXPECT_EQ(client_.batches, std::vector<std::string>({"Hello", ", world"}));
+  EXPECT_EQ(client_.completions, 0);
+}
+
+TEST_F(ResponseStreamBridgeTest, FinalDeltaFlushesAndCompletes) {
+  core::StreamDeltaCallback callback = bridge_.GetStreamDeltaCallback();
+  callback.Run(MakeDelta("a"));
+  callback.Run(MakeDelta("b", /*is_final=*/true));
+  EXPECT_EQ(client_.batches, std::vector<std::string>({"ab"}));
+  EXPECT_EQ(client_.completions, 1);
+  EXPECT_TRUE(client_.success);
+  EXPECT_TRUE(bridge_.is_complete());
+
+  // Nothing after the end
+  callback.Run(MakeDelta("c"));
+  task_environment_.FastForwardBy(kFrame);
+  EXPECT_EQ(client_.batches.size(), 1u);
+  EXPECT_EQ(client_.completions, 1);
+}
+
+TEST_F(ResponseStreamBridgeTest, AdapterFailureCompletesWithError) {
+  adapters::StreamingResponseCallback callback = bridge_.GetAdapterCallback();
+  adapters::ModelResponse chunk;
+  chunk.success = true;
+  chunk.text = "partial";
+  chunk.is_partial = true;
+  callback(chunk, false);
+
+  adapters::ModelResponse failure;
+  failure.error_message = "connection reset";
+  callback(failure, true);
+  EXPECT_EQ(client_.batches, std::vector<std::string>({"partial"}));
+  EXPECT_EQ(client_.completions, 1);
+  EXPECT_FALSE(client_.success);
+  EXPECT_EQ(client_.error_message, "connection reset");
+}
+
+}  // namespace
+}  // namespace browser
+}  // namespace asol
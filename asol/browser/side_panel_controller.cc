@@ -64,6 +64,7 @@ SidePanelController::~SidePanelController() {
 }
 
 void SidePanelController::ShowSidePanel() {
+  Wake();
   if (!side_panel_registry_ || side_panel_entry_id_.empty()) {
     return;
   }
@@ -115,6 +116,34 @@ bool SidePanelController::Initialize() {
   return ui_controller_->Initialize(config_json);
 }
 
+void SidePanelController::StreamResponse(
+    const std::string& capability,
+    const std::string& prompt,
+    ResponseStreamBridge::Client* client) {
+  response_stream_ = std::make_unique<ResponseStreamBridge>(client);
+  core::ServiceManager::GetInstance()->ProcessTextWithCapabilityStream(
+      capability, prompt, response_stream_->GetAdapterCallback());
+}
+
+void SidePanelController::Hibernate() {
+  if (is_hibernated_ || is_side_panel_visible_) {
+    return;
+  }
+  
+  ui_controller_.reset();
+  is_hibernated_ = true;
+}
+
+void SidePanelController::Wake() {
+  if (!is_hibernated_) {
+    return;
+  }
+  
+  is_hibernated_ = false;
+  ui_controller_ = ui::AsolUiController::Create();
+  Initialize();
+}
+
 void SidePanelController::WebContentsDestroyed() {
   // Hide the side panel before the web contents is destroyed
   HideSidePanel();
@@ -157,7 +186,8 @@ std::unique_ptr<side_panel::SidePanelEntry> SidePanelController::CreateSidePanel
         // In a real implementation, this would create a view that hosts the UI panel
         auto view = std::make_unique<views::View>();
         
-        // Get the UI controller
+        // Get the UI controller, recreating it if the tab hibernated
+        controller->Wake();
         ui::AsolUiController* ui_controller = controller->GetUiController();
         
         // Show the AI panel in the view
@@ -9,6 +9,7 @@
 #include <string>
 
 #include "asol/browser/asol_browser_integration.h"
+#include "asol/browser/response_stream_bridge.h"
 #include "asol/ui/asol_ui_controller.h"
 #include "base/memory/weak_ptr.h"
 #include "components/side_panel/side_panel_entry.h"
@@ -48,12 +49,26 @@ class SidePanelController
   // Check if the ASOL side panel is visible
   bool IsSidePanelVisible() const;
 
-  // Get the UI controller
+  // Get the UI controller. Null while hibernated.
   ui::AsolUiController* GetUiController() const;
 
   // Initialize the side panel controller
   bool Initialize();
 
+  // Stream the answer to |prompt|, from the adapter best at |capability|,
+  // into |client| a frame at a time rather than as one string once it is
+  // complete. Replaces a stream still running, whose client then hears
+  // nothing more. |client| must outlive the stream or be replaced first.
+  void StreamResponse(const std::string& capability,
+                      const std::string& prompt,
+                      ResponseStreamBridge::Client* client);
+
+  // Release the UI controller while the tab is in the background, unless
+  // the side panel is showing, and recreate it. See TabHibernationManager.
+  void Hibernate();
+  void Wake();
+  bool is_hibernated() const { return is_hibernated_; }
+
  private:
   // Allow WebContentsUserData to create instances of this class
   friend class content::WebContentsUserData<SidePanelController>;
@@ -73,6 +88,9 @@ class SidePanelController
   // The UI controller
   std::unique_ptr<ui::AsolUiController> ui_controller_;
 
+  // The answer being streamed into the panel, if any
+  std::unique_ptr<ResponseStreamBridge> response_stream_;
+
   // The side panel registry
   side_panel::SidePanelRegistry* side_panel_registry_ = nullptr;
 
@@ -82,6 +100,9 @@ class SidePanelController
   // Whether the side panel is visible
   bool is_side_panel_visible_ = false;
 
+  // Whether the UI controller was released by Hibernate()
+  bool is_hibernated_ = false;
+
   // For generating weak pointers to this
   base::WeakPtrFactory<SidePanelController> weak_ptr_factory_{this};
 
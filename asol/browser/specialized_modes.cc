@@ -4,23 +4,39 @@
 
 #include "asol/browser/specialized_modes.h"
 
+#include <stdint.h>
+#include <string.h>
+
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <optional>
+#include <set>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "asol/browser/browser_features.h"
+#include "asol/browser/code_language_classifier.h"
 #include "asol/browser/page_context_extractor.h"
+#include "asol/browser/tab_hibernation_manager.h"
 #include "asol/core/service_manager.h"
 #include "asol/util/performance_tracker.h"
+#include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/guid.h"
+#include "base/hash/hash.h"
 #include "base/json/json_reader.h"
-#include "base/json/json_writer.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/no_destructor.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
+#include "base/task/thread_pool.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/browser_context.h"
@@ -314,17 +330,228 @@ GameInfo ValueToGameInfo(const base::Value::Dict& value) {
   return game_info;
 }
 
-// Get the file path for storing specialized mode data
+// Get the file path of the specialized mode data journal
 base::FilePath GetSpecializedModeDataFilePath(content::BrowserContext* context) {
   base::FilePath path;
   if (!base::PathService::Get(base::DIR_USER_DATA, &path)) {
     return base::FilePath();
   }
   
-  path = path.AppendASCII("asol_specialized_modes.json");
+  path = path.AppendASCII("asol_specialized_modes.journal");
   return path;
 }
 
+// The JSON file the data was saved in before the journal, migrated into
+// the journal on first load
+base::FilePath GetLegacyDataFilePath(const base::FilePath& journal_path) {
+  return journal_path.ReplaceExtension(FILE_PATH_LITERAL("json"));
+}
+
+constexpr uint32_t kJournalMagic = 0x4d444f4d;  // "MODM"
+constexpr uint32_t kJournalVersion = 1;
+
+// The journal is rewritten when over this and twice the live data
+constexpr size_t kMinCompactionBytes = 256 * 1024;
+
+struct JournalHeader {
+  uint32_t magic;
+  uint32_t version;
+};
+
+// Before each record's bytes
+struct FrameHeader {
+  uint32_t size;
+  uint32_t checksum;  // base::PersistentHash() of the record
+};
+
+// Saved items are keyed as in the methods saving them: snippets by code
+// and source URL, documents and game info by title
+enum RecordType : uint8_t {
+  kSetMode = 1,
+  // Whole item, replacing the one with its key or added last
+  kPutSnippet = 2,
+  kPutDocument = 3,
+  kPutGameInfo = 4,
+  kEraseSnippet = 5,
+  kEraseDocument = 6,
+  kEraseGameInfo = 7,
+  kSetDocumentContent = 8,
+};
+
+template <typename T>
+void Append(T value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+void AppendString(std::string_view value, std::string* out) {
+  AppendVarint(value.size(), out);
+  out->append(value);
+}
+
+void AppendFrame(std::string_view record, std::string* out) {
+  Append(FrameHeader{static_cast<uint32_t>(record.size()),
+                     base::PersistentHash(record)},
+         out);
+  out->append(record);
+}
+
+template <typename T>
+bool Read(const uint8_t** pos, const uint8_t* end, T* value) {
+  if (static_cast<size_t>(end - *pos) < sizeof(T)) {
+    return false;
+  }
+  memcpy(value, *pos, sizeof(T));
+  *pos += sizeof(T);
+  return true;
+}
+
+bool ReadVarint(const uint8_t** pos, const uint8_t* end, uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64 && *pos < end; shift += 7) {
+    uint8_t byte = *(*pos)++;
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ReadString(const uint8_t** pos, const uint8_t* end, std::string* value) {
+  uint64_t size = 0;
+  if (!ReadVarint(pos, end, &size) ||
+      size > static_cast<uint64_t>(end - *pos)) {
+    return false;
+  }
+  value->assign(reinterpret_cast<const char*>(*pos), size);
+  *pos += size;
+  return true;
+}
+
+size_t GetFrameSize(std::string_view record) {
+  return sizeof(FrameHeader) + record.size();
+}
+
+std::string SetModeRecord(SpecializedMode mode) {
+  std::string record;
+  Append(kSetMode, &record);
+  Append(static_cast<int32_t>(mode), &record);
+  return record;
+}
+
+std::string PutSnippetRecord(const CodeSnippet& snippet) {
+  std::string record;
+  Append(kPutSnippet, &record);
+  AppendString(snippet.code, &record);
+  AppendString(snippet.source_url, &record);
+  AppendString(snippet.language, &record);
+  AppendString(snippet.description, &record);
+  return record;
+}
+
+std::string EraseSnippetRecord(const CodeSnippet& snippet) {
+  std::string record;
+  Append(kEraseSnippet, &record);
+  AppendString(snippet.code, &record);
+  AppendString(snippet.source_url, &record);
+  return record;
+}
+
+std::string PutDocumentRecord(const WorkDocument& document) {
+  std::string record;
+  Append(kPutDocument, &record);
+  AppendString(document.title, &record);
+  AppendString(document.content, &record);
+  AppendString(document.format, &record);
+  AppendString(document.url, &record);
+  Append(static_cast<uint8_t>(document.is_draft), &record);
+  return record;
+}
+
+std::string EraseDocumentRecord(const std::string& title) {
+  std::string record;
+  Append(kEraseDocument, &record);
+  AppendString(title, &record);
+  return record;
+}
+
+std::string SetDocumentContentRecord(const std::string& title,
+                                     const std::string& content) {
+  std::string record;
+  Append(kSetDocumentContent, &record);
+  AppendString(title, &record);
+  AppendString(content, &record);
+  return record;
+}
+
+std::string PutGameInfoRecord(const GameInfo& game_info) {
+  std::string record;
+  Append(kPutGameInfo, &record);
+  AppendString(game_info.title, &record);
+  AppendString(game_info.genre, &record);
+  AppendString(game_info.platform, &record);
+  AppendString(game_info.tips, &record);
+  AppendString(game_info.strategies, &record);
+  AppendString(game_info.url, &record);
+  return record;
+}
+
+std::string EraseGameInfoRecord(const std::string& title) {
+  std::string record;
+  Append(kEraseGameInfo, &record);
+  AppendString(title, &record);
+  return record;
+}
+
+// Journal records for the data saved as JSON at |path|, if any
+std::vector<std::string> ReadLegacyData(const base::FilePath& path) {
+  std::vector<std::string> records;
+  std::string json_string;
+  if (!base::ReadFileToString(path, &json_string)) {
+    return records;
+  }
+  absl::optional<base::Value> value = base::JSONReader::Read(json_string);
+  if (!value || !value->is_dict()) {
+    DLOG(ERROR) << "Failed to parse legacy specialized mode data JSON";
+    return records;
+  }
+
+  const base::Value::Dict& root = value->GetDict();
+  if (auto mode = root.FindInt("current_mode")) {
+    records.push_back(SetModeRecord(static_cast<SpecializedMode>(*mode)));
+  }
+  if (const base::Value::List* snippets_list = root.FindList("code_snippets")) {
+    for (const auto& snippet_value : *snippets_list) {
+      if (!snippet_value.is_dict()) continue;
+      records.push_back(
+          PutSnippetRecord(ValueToCodeSnippet(snippet_value.GetDict())));
+    }
+  }
+  if (const base::Value::List* documents_list = root.FindList("documents")) {
+    for (const auto& document_value : *documents_list) {
+      if (!document_value.is_dict()) continue;
+      records.push_back(
+          PutDocumentRecord(ValueToWorkDocument(document_value.GetDict())));
+    }
+  }
+  if (const base::Value::List* game_info_list = root.FindList("game_info")) {
+    for (const auto& info_value : *game_info_list) {
+      if (!info_value.is_dict()) continue;
+      records.push_back(
+          PutGameInfoRecord(ValueToGameInfo(info_value.GetDict())));
+    }
+  }
+  return records;
+}
+
 // Prompt for generating code documentation
 const char kCodeDocumentationPrompt[] = 
     "Generate comprehensive documentation for the following %s code:\n\n"
@@ -332,6 +559,20 @@ const char kCodeDocumentationPrompt[] =
     "Include function descriptions, parameter explanations, return values, "
     "and any important notes about usage or edge cases.";
 
+// Prompt for identifying the languages of code snippets the local
+// classifier could not tell
+const char kClassifySnippetsPrompt[] =
+    "Identify the programming language of each numbered code snippet "
+    "below. Answer with one line per snippet, of the form \"<number>: "
+    "<language>\", naming the language in lowercase, e.g. python, "
+    "javascript, c++ or bash, or unknown.\n\n%s";
+
+// Snippets sent to be classified are cut to this many bytes
+constexpr size_t kMaxClassifiedSnippetBytes = 1000;
+
+// Snippet languages remembered; forgotten all at once past this
+constexpr size_t kMaxCachedSnippetLanguages = 1024;
+
 // Prompt for explaining code
 const char kExplainCodePrompt[] = 
     "Explain the following %s code in detail:\n\n"
@@ -389,6 +630,162 @@ const char kOptimizeGameSettingsPrompt[] =
 
 }  // namespace
 
+// The journal file, used on its task runner
+class SpecializedModesController::Journal
+    : public base::RefCountedThreadSafe<SpecializedModesController::Journal> {
+ public:
+  explicit Journal(base::FilePath path)
+      : path_(std::move(path)),
+        task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+            {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+             base::TaskShutdownBehavior::BLOCK_SHUTDOWN})) {}
+
+  Journal(const Journal&) = delete;
+  Journal& operator=(const Journal&) = delete;
+
+  base::SequencedTaskRunner* task_runner() const { return task_runner_.get(); }
+
+  // Return the journal's records, dropping a torn tail. A missing journal
+  // starts from the legacy JSON file, if there is one.
+  std::vector<std::string> Read();
+
+  // Append |frames|
+  void AppendFrames(std::string frames);
+
+  // Replace the journal with |records|
+  void Rewrite(std::vector<std::string> records);
+
+ private:
+  friend class base::RefCountedThreadSafe<Journal>;
+  ~Journal() = default;
+
+  // Start an empty journal in |file_|
+  bool Reset();
+
+  const base::FilePath path_;
+  const scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  base::File file_;
+  uint64_t file_size_ = 0;
+};
+
+std::vector<std::string> SpecializedModesController::Journal::Read() {
+  std::vector<std::string> records;
+  // Every tab's controller reads the journal, so it may already be open
+  if (!file_.IsValid()) {
+    bool existed = base::PathExists(path_);
+    file_.Initialize(path_, base::File::FLAG_OPEN_ALWAYS |
+                                base::File::FLAG_READ |
+                                base::File::FLAG_WRITE);
+    if (!file_.IsValid()) {
+      DLOG(ERROR) << "Failed to open specialized mode data: " << path_.value();
+      return records;
+    }
+    base::FilePath legacy_path = GetLegacyDataFilePath(path_);
+    if (!existed && base::PathExists(legacy_path)) {
+      records = ReadLegacyData(legacy_path);
+      Rewrite(records);
+      base::DeleteFile(legacy_path);
+      return records;
+    }
+  }
+
+  int64_t length = file_.GetLength();
+  std::string data(length > 0 ? static_cast<size_t>(length) : 0, '\0');
+  JournalHeader header = {};
+  if (data.size() < sizeof(JournalHeader) ||
+      file_.Read(0, data.data(), static_cast<int>(data.size())) !=
+          static_cast<int>(data.size())) {
+    Reset();
+    return records;
+  }
+  memcpy(&header, data.data(), sizeof(header));
+  if (header.magic != kJournalMagic || header.version != kJournalVersion) {
+    // Foreign or older format: start over
+    Reset();
+    return records;
+  }
+
+  size_t offset = sizeof(JournalHeader);
+  while (offset + sizeof(FrameHeader) <= data.size()) {
+    FrameHeader frame;
+    memcpy(&frame, data.data() + offset, sizeof(frame));
+    size_t end = offset + sizeof(FrameHeader) + frame.size;
+    if (end > data.size()) {
+      break;
+    }
+    std::string_view record(data.data() + offset + sizeof(FrameHeader),
+                            frame.size);
+    if (base::PersistentHash(record) != frame.checksum) {
+      break;
+    }
+    records.emplace_back(record);
+    offset = end;
+  }
+
+  if (offset < data.size()) {
+    // A torn write from a previous session; drop the partial tail
+    DLOG(WARNING) << "Truncating specialized mode data at offset " << offset
+                  << " of " << data.size();
+    file_.SetLength(static_cast<int64_t>(offset));
+  }
+  file_size_ = offset;
+  return records;
+}
+
+void SpecializedModesController::Journal::AppendFrames(std::string frames) {
+  if (!file_.IsValid()) {
+    return;
+  }
+  // One write per batch keeps a crash from interleaving partial records
+  if (file_.Write(static_cast<int64_t>(file_size_), frames.data(),
+                  static_cast<int>(frames.size())) !=
+      static_cast<int>(frames.size())) {
+    DLOG(ERROR) << "Failed to append to specialized mode data: "
+                << path_.value();
+    return;
+  }
+  file_size_ += frames.size();
+}
+
+void SpecializedModesController::Journal::Rewrite(
+    std::vector<std::string> records) {
+  std::string data;
+  Append(JournalHeader{kJournalMagic, kJournalVersion}, &data);
+  for (const std::string& record : records) {
+    AppendFrame(record, &data);
+  }
+
+  base::FilePath temp_path = path_.AddExtension(FILE_PATH_LITERAL("tmp"));
+  file_.Close();
+  if (!base::WriteFile(temp_path, data) ||
+      !base::ReplaceFile(temp_path, path_, nullptr)) {
+    DLOG(ERROR) << "Failed to compact specialized mode data: "
+                << path_.value();
+    base::DeleteFile(temp_path);
+  }
+  // Continue appending to whichever journal is now in place
+  file_.Initialize(path_, base::File::FLAG_OPEN | base::File::FLAG_READ |
+                              base::File::FLAG_WRITE);
+  int64_t length = file_.IsValid() ? file_.GetLength() : -1;
+  file_size_ = length > 0 ? static_cast<uint64_t>(length) : 0;
+}
+
+bool SpecializedModesController::Journal::Reset() {
+  std::string header;
+  Append(JournalHeader{kJournalMagic, kJournalVersion}, &header);
+  file_.SetLength(0);
+  file_size_ = 0;
+  if (file_.Write(0, header.data(), static_cast<int>(header.size())) !=
+      static_cast<int>(header.size())) {
+    DLOG(ERROR) << "Failed to initialize specialized mode data: "
+                << path_.value();
+    file_.Close();
+    return false;
+  }
+  file_size_ = header.size();
+  return true;
+}
+
 // static
 WEB_CONTENTS_USER_DATA_KEY_IMPL(SpecializedModesController);
 
@@ -403,9 +800,6 @@ SpecializedModesController::SpecializedModesController(content::WebContents* web
 
 SpecializedModesController::~SpecializedModesController() {
   DLOG(INFO) << "SpecializedModesController destroyed";
-  
-  // Save data before destruction
-  SaveData();
 }
 
 void SpecializedModesController::SetMode(SpecializedMode mode) {
@@ -432,7 +826,7 @@ void SpecializedModesController::SetMode(SpecializedMode mode) {
     return;
   }
   
-  current_mode_ = mode;
+  Commit(SetModeRecord(mode));
   DLOG(INFO) << "Specialized mode set to: " << GetModeString();
   
   // If we're on a page, perform mode-specific actions
@@ -526,57 +920,205 @@ void SpecializedModesController::ExtractCodeSnippets(CodeSnippetsCallback callba
   
   main_frame->ExecuteJavaScriptForTests(
       base::UTF8ToUTF16(kExtractCodeSnippetsScript),
-      base::BindOnce([](SpecializedModesController* controller,
-                       std::string url,
-                       CodeSnippetsCallback callback,
-                       base::Value result) {
-        std::vector<CodeSnippet> snippets;
+      base::BindOnce(&SpecializedModesController::OnCodeSnippetsExtracted,
+                     weak_ptr_factory_.GetWeakPtr(), url,
+                     std::move(callback)));
+}
+
+void SpecializedModesController::OnCodeSnippetsExtracted(
+    std::string url,
+    CodeSnippetsCallback callback,
+    base::Value result) {
+  std::vector<CodeSnippet> snippets;
+  
+  if (result.is_string()) {
+    std::string json_str = result.GetString();
+    absl::optional<base::Value> parsed = base::JSONReader::Read(json_str);
+    
+    if (parsed && parsed->is_list()) {
+      // A <pre> and the <code> in it are both extracted; keep one
+      std::set<size_t> seen;
+      for (const auto& item : parsed->GetList()) {
+        if (!item.is_dict()) continue;
         
-        if (result.is_string()) {
-          std::string json_str = result.GetString();
-          absl::optional<base::Value> parsed = base::JSONReader::Read(json_str);
-          
-          if (parsed && parsed->is_list()) {
-            for (const auto& item : parsed->GetList()) {
-              if (!item.is_dict()) continue;
-              
-              const auto& dict = item.GetDict();
-              CodeSnippet snippet;
-              snippet.language = dict.FindString("language").value_or("unknown");
-              snippet.code = dict.FindString("code").value_or("");
-              snippet.description = dict.FindString("description").value_or("");
-              snippet.source_url = url;
-              
-              if (!snippet.code.empty()) {
-                snippets.push_back(snippet);
-                
-                // Auto-save if in developer mode
-                if (controller->GetMode() == SpecializedMode::kDeveloper) {
-                  controller->SaveCodeSnippet(snippet);
-                }
-              }
-            }
-          }
-        }
+        const auto& dict = item.GetDict();
+        CodeSnippet snippet;
+        snippet.language = dict.FindString("language").value_or("unknown");
+        snippet.code = dict.FindString("code").value_or("");
+        snippet.description = dict.FindString("description").value_or("");
+        snippet.source_url = url;
         
-        std::move(callback).Run(snippets);
-      },
-      this, url, std::move(callback)));
+        if (!snippet.code.empty() &&
+            seen.insert(CodeSnippetStore::HashContent(snippet.code)).second) {
+          snippets.push_back(std::move(snippet));
+        }
+      }
+    }
+  }
+  
+  DetectSnippetLanguages(
+      std::move(snippets),
+      base::BindOnce(
+          &SpecializedModesController::OnExtractedSnippetsClassified,
+          weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
+}
+
+void SpecializedModesController::OnExtractedSnippetsClassified(
+    CodeSnippetsCallback callback,
+    std::vector<CodeSnippet> snippets) {
+  // Auto-save if in developer mode
+  if (GetMode() == SpecializedMode::kDeveloper) {
+    for (const CodeSnippet& snippet : snippets) {
+      SaveCodeSnippet(snippet);
+    }
+  }
+  
+  std::move(callback).Run(snippets);
+}
+
+void SpecializedModesController::DetectSnippetLanguages(
+    std::vector<CodeSnippet> snippets,
+    base::OnceCallback<void(std::vector<CodeSnippet>)> callback) {
+  std::vector<size_t> ambiguous;
+  std::string listing;
+  for (size_t i = 0; i < snippets.size(); ++i) {
+    CodeSnippet& snippet = snippets[i];
+    size_t content_hash = CodeSnippetStore::HashContent(snippet.code);
+    if (!snippet.language.empty() && snippet.language != "unknown") {
+      // The page's own label beats any guess
+      CacheSnippetLanguage(content_hash, snippet.language);
+      continue;
+    }
+    
+    auto it = snippet_languages_.find(content_hash);
+    if (it != snippet_languages_.end()) {
+      snippet.language = it->second;
+      continue;
+    }
+    
+    CodeLanguageClassifier::Result result =
+        CodeLanguageClassifier::Classify(snippet.code);
+    if (result.is_confident) {
+      snippet.language = result.language;
+      CacheSnippetLanguage(content_hash, result.language);
+      continue;
+    }
+    
+    // Keep the best guess in case the AI does no better
+    if (!result.language.empty()) {
+      snippet.language = result.language;
+    }
+    ambiguous.push_back(i);
+    std::string code;
+    base::TruncateUTF8ToByteSize(snippet.code, kMaxClassifiedSnippetBytes,
+                                 &code);
+    listing += base::NumberToString(ambiguous.size()) + ":\n```\n" + code +
+               "\n```\n\n";
+  }
+  
+  if (ambiguous.empty()) {
+    std::move(callback).Run(std::move(snippets));
+    return;
+  }
+  
+  auto* service_manager = core::ServiceManager::GetInstance();
+  service_manager->ProcessTextWithCapabilityAsync(
+      "text-generation",
+      base::StringPrintf(kClassifySnippetsPrompt, listing.c_str()),
+      base::BindOnce(&SpecializedModesController::OnSnippetLanguagesDetected,
+                     weak_ptr_factory_.GetWeakPtr(), std::move(snippets),
+                     std::move(ambiguous), std::move(callback)));
+}
+
+void SpecializedModesController::OnSnippetLanguagesDetected(
+    std::vector<CodeSnippet> snippets,
+    std::vector<size_t> ambiguous,
+    base::OnceCallback<void(std::vector<CodeSnippet>)> callback,
+    const adapters::ModelResponse& response) {
+  if (!response.success) {
+    DLOG(WARNING) << "Failed to classify code snippets: "
+                  << response.error_message;
+    std::move(callback).Run(std::move(snippets));
+    return;
+  }
+  
+  for (std::string_view line : base::SplitStringPiece(
+           response.text, "\n", base::TRIM_WHITESPACE,
+           base::SPLIT_WANT_NONEMPTY)) {
+    size_t colon = line.find(':');
+    size_t number = 0;
+    if (colon == std::string_view::npos ||
+        !base::StringToSizeT(
+            base::TrimWhitespaceASCII(line.substr(0, colon), base::TRIM_ALL),
+            &number) ||
+        number == 0 || number > ambiguous.size()) {
+      continue;
+    }
+    std::string language = base::ToLowerASCII(base::TrimString(
+        line.substr(colon + 1), " \t.`*", base::TRIM_ALL));
+    if (language.empty() || language == "unknown") {
+      continue;
+    }
+    CodeSnippet& snippet = snippets[ambiguous[number - 1]];
+    snippet.language = language;
+    CacheSnippetLanguage(CodeSnippetStore::HashContent(snippet.code),
+                         language);
+  }
+  
+  std::move(callback).Run(std::move(snippets));
+}
+
+void SpecializedModesController::CacheSnippetLanguage(
+    size_t content_hash,
+    const std::string& language) {
+  if (snippet_languages_.size() >= kMaxCachedSnippetLanguages &&
+      !snippet_languages_.count(content_hash)) {
+    snippet_languages_.clear();
+  }
+  snippet_languages_[content_hash] = language;
+}
+
+void SpecializedModesController::DetectCodeLanguage(
+    const std::string& code,
+    base::OnceCallback<void(const std::string&)> callback) {
+  CodeSnippet snippet;
+  snippet.code = code;
+  std::vector<CodeSnippet> snippets;
+  snippets.push_back(std::move(snippet));
+  DetectSnippetLanguages(
+      std::move(snippets),
+      base::BindOnce(
+          [](base::WeakPtr<SpecializedModesController> controller,
+             base::OnceCallback<void(const std::string&)> callback,
+             std::vector<CodeSnippet> snippets) {
+            const std::string& language = snippets.front().language;
+            if (!language.empty() || !controller) {
+              std::move(callback).Run(language);
+              return;
+            }
+            // Nothing to go on in the code itself
+            controller->DetectProgrammingLanguage(std::move(callback));
+          },
+          weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
 }
 
 void SpecializedModesController::SaveCodeSnippet(const CodeSnippet& snippet) {
+  Wake();
   // Check if we already have this snippet
-  auto it = std::find_if(
-      code_snippets_.begin(), code_snippets_.end(),
-      [&snippet](const CodeSnippet& existing) {
-        return existing.code == snippet.code && 
-               existing.source_url == snippet.source_url;
-      });
-  
-  if (it != code_snippets_.end()) {
+  const CodeSnippet* existing =
+      code_snippets_.Find(snippet.code, snippet.source_url);
+  
+  if (existing) {
+    if (existing->description == snippet.description &&
+        existing->language == snippet.language) {
+      // Extracted again as it was; nothing to save
+      return;
+    }
     // Update existing snippet
-    it->description = snippet.description;
-    it->language = snippet.language;
+    CodeSnippet updated = *existing;
+    updated.description = snippet.description;
+    updated.language = snippet.language;
+    Commit(PutSnippetRecord(updated));
     DLOG(INFO) << "Updated existing code snippet from: " << snippet.source_url;
   } else {
     // Check if we've reached the maximum number of snippets
@@ -585,20 +1127,18 @@ void SpecializedModesController::SaveCodeSnippet(const CodeSnippet& snippet) {
     
     if (static_cast<int>(code_snippets_.size()) >= max_snippets) {
       // Remove the first snippet (oldest)
-      code_snippets_.erase(code_snippets_.begin());
+      Commit(EraseSnippetRecord(code_snippets_.snippets().front()));
     }
     
     // Add new snippet
-    code_snippets_.push_back(snippet);
+    Commit(PutSnippetRecord(snippet));
     DLOG(INFO) << "Saved new code snippet from: " << snippet.source_url;
   }
-  
-  // Save to disk
-  SaveData();
 }
 
 void SpecializedModesController::GetSavedCodeSnippets(CodeSnippetsCallback callback) {
-  std::move(callback).Run(code_snippets_);
+  Wake();
+  std::move(callback).Run(code_snippets_.snippets());
 }
 
 void SpecializedModesController::GenerateCodeDocumentation(
@@ -607,8 +1147,8 @@ void SpecializedModesController::GenerateCodeDocumentation(
   // Track performance of this operation
   util::ScopedPerformanceTracker tracker("SpecializedModesController_GenerateCodeDocumentation");
   
-  // Detect the language if not specified
-  DetectProgrammingLanguage(base::BindOnce(
+  // Detect the language of the code
+  DetectCodeLanguage(code, base::BindOnce(
       [](SpecializedModesController* controller,
          std::string code,
          base::OnceCallback<void(const std::string&)> callback,
@@ -645,8 +1185,8 @@ void SpecializedModesController::ExplainCode(
   // Track performance of this operation
   util::ScopedPerformanceTracker tracker("SpecializedModesController_ExplainCode");
   
-  // Detect the language if not specified
-  DetectProgrammingLanguage(base::BindOnce(
+  // Detect the language of the code
+  DetectCodeLanguage(code, base::BindOnce(
       [](std::string code,
          base::OnceCallback<void(const std::string&)> callback,
          const std::string& language) {
@@ -682,8 +1222,8 @@ void SpecializedModesController::OptimizeCode(
   // Track performance of this operation
   util::ScopedPerformanceTracker tracker("SpecializedModesController_OptimizeCode");
   
-  // Detect the language if not specified
-  DetectProgrammingLanguage(base::BindOnce(
+  // Detect the language of the code
+  DetectCodeLanguage(code, base::BindOnce(
       [](std::string code,
          base::OnceCallback<void(const std::string&)> callback,
          const std::string& language) {
@@ -720,8 +1260,8 @@ void SpecializedModesController::DebugCode(
   // Track performance of this operation
   util::ScopedPerformanceTracker tracker("SpecializedModesController_DebugCode");
   
-  // Detect the language if not specified
-  DetectProgrammingLanguage(base::BindOnce(
+  // Detect the language of the code
+  DetectCodeLanguage(code, base::BindOnce(
       [](std::string code,
          std::string error_message,
          base::OnceCallback<void(const std::string&)> callback,
@@ -759,6 +1299,7 @@ void SpecializedModesController::DebugCode(
 
 void SpecializedModesController::CreateDocument(
     const std::string& title, const std::string& format) {
+  Wake();
   // Check if a document with this title already exists
   auto it = std::find_if(
       documents_.begin(), documents_.end(),
@@ -777,7 +1318,7 @@ void SpecializedModesController::CreateDocument(
   
   if (static_cast<int>(documents_.size()) >= max_documents) {
     // Remove the first document (oldest)
-    documents_.erase(documents_.begin());
+    Commit(EraseDocumentRecord(documents_.front().title));
   }
   
   // Create a new document
@@ -790,19 +1331,18 @@ void SpecializedModesController::CreateDocument(
     document.url = web_contents()->GetLastCommittedURL().spec();
   }
   
-  documents_.push_back(document);
+  Commit(PutDocumentRecord(document));
   DLOG(INFO) << "Created new document: " << title;
-  
-  // Save to disk
-  SaveData();
 }
 
 void SpecializedModesController::GetAllDocuments(WorkDocumentsCallback callback) {
+  Wake();
   std::move(callback).Run(documents_);
 }
 
 void SpecializedModesController::UpdateDocument(
     const std::string& title, const std::string& content) {
+  Wake();
   auto it = std::find_if(
       documents_.begin(), documents_.end(),
       [&title](const WorkDocument& doc) {
@@ -810,11 +1350,8 @@ void SpecializedModesController::UpdateDocument(
       });
   
   if (it != documents_.end()) {
-    it->content = content;
+    Commit(SetDocumentContentRecord(title, content));
     DLOG(INFO) << "Updated document: " << title;
-    
-    // Save to disk
-    SaveData();
   } else {
     DLOG(WARNING) << "Document not found: " << title;
   }
@@ -826,6 +1363,7 @@ void SpecializedModesController::GenerateDocumentContent(
     base::OnceCallback<void(const std::string&)> callback) {
   // Track performance of this operation
   util::ScopedPerformanceTracker tracker("SpecializedModesController_GenerateDocumentContent");
+  Wake();
   
   // Find the document format
   std::string format = "text";
@@ -1022,6 +1560,7 @@ void SpecializedModesController::DetectGame(
 }
 
 void SpecializedModesController::SaveGameInfo(const GameInfo& game_info) {
+  Wake();
   if (game_info.title.empty()) {
     return;
   }
@@ -1035,19 +1574,21 @@ void SpecializedModesController::SaveGameInfo(const GameInfo& game_info) {
   
   if (it != game_info_.end()) {
     // Update existing game info
+    GameInfo updated = *it;
     if (!game_info.genre.empty()) {
-      it->genre = game_info.genre;
+      updated.genre = game_info.genre;
     }
     if (!game_info.platform.empty()) {
-      it->platform = game_info.platform;
+      updated.platform = game_info.platform;
     }
     if (!game_info.tips.empty()) {
-      it->tips = game_info.tips;
+      updated.tips = game_info.tips;
     }
     if (!game_info.strategies.empty()) {
-      it->strategies = game_info.strategies;
+      updated.strategies = game_info.strategies;
     }
-    it->url = game_info.url;
+    updated.url = game_info.url;
+    Commit(PutGameInfoRecord(updated));
     
     DLOG(INFO) << "Updated existing game info for: " << game_info.title;
   } else {
@@ -1057,19 +1598,17 @@ void SpecializedModesController::SaveGameInfo(const GameInfo& game_info) {
     
     if (static_cast<int>(game_info_.size()) >= max_game_info) {
       // Remove the first entry (oldest)
-      game_info_.erase(game_info_.begin());
+      Commit(EraseGameInfoRecord(game_info_.front().title));
     }
     
     // Add new game info
-    game_info_.push_back(game_info);
+    Commit(PutGameInfoRecord(game_info));
     DLOG(INFO) << "Saved new game info for: " << game_info.title;
   }
-  
-  // Save to disk
-  SaveData();
 }
 
 void SpecializedModesController::GetAllGameInfo(GameInfoCallback callback) {
+  Wake();
   std::move(callback).Run(game_info_);
 }
 
@@ -1078,6 +1617,7 @@ void SpecializedModesController::GetGameTips(
     base::OnceCallback<void(const std::string&)> callback) {
   // Track performance of this operation
   util::ScopedPerformanceTracker tracker("SpecializedModesController_GetGameTips");
+  Wake();
   
   // Check if we already have tips for this game
   auto it = std::find_if(
@@ -1107,6 +1647,7 @@ void SpecializedModesController::GetGameTips(
                       const adapters::ModelResponse& response) {
         if (response.success) {
           // Update the game info with the new tips
+          controller->Wake();
           auto it = std::find_if(
               controller->game_info_.begin(), controller->game_info_.end(),
               [&game_title](const GameInfo& info) {
@@ -1137,6 +1678,7 @@ void SpecializedModesController::GetGameStrategies(
     base::OnceCallback<void(const std::string&)> callback) {
   // Track performance of this operation
   util::ScopedPerformanceTracker tracker("SpecializedModesController_GetGameStrategies");
+  Wake();
   
   // Check if we already have strategies for this game
   auto it = std::find_if(
@@ -1166,6 +1708,7 @@ void SpecializedModesController::GetGameStrategies(
                       const adapters::ModelResponse& response) {
         if (response.success) {
           // Update the game info with the new strategies
+          controller->Wake();
           auto it = std::find_if(
               controller->game_info_.begin(), controller->game_info_.end(),
               [&game_title](const GameInfo& info) {
@@ -1276,34 +1819,13 @@ void SpecializedModesController::DidFinishNavigation(
   }
 }
 
-void SpecializedModesController::WebContentsDestroyed() {
-  // Save data before web contents is destroyed
-  SaveData();
-}
-
-void SpecializedModesController::SaveData() {
-  if (!web_contents()) {
-    return;
-  }
-  
-  content::BrowserContext* browser_context = web_contents()->GetBrowserContext();
-  if (!browser_context) {
-    return;
-  }
-  
-  base::FilePath path = GetDataFilePath();
-  if (path.empty()) {
-    DLOG(ERROR) << "Failed to get specialized mode data file path";
-    return;
-  }
-  
-  // Convert data to JSON
+base::Value::Dict SpecializedModesController::DataToValue() const {
   base::Value::Dict root;
   root.Set("current_mode", static_cast<int>(current_mode_));
   
   // Save code snippets
   base::Value::List snippets_list;
-  for (const auto& snippet : code_snippets_) {
+  for (const auto& snippet : code_snippets_.snippets()) {
     snippets_list.Append(CodeSnippetToValue(snippet));
   }
   root.Set("code_snippets", std::move(snippets_list));
@@ -1321,58 +1843,10 @@ void SpecializedModesController::SaveData() {
     game_info_list.Append(GameInfoToValue(info));
   }
   root.Set("game_info", std::move(game_info_list));
-  
-  std::string json_string;
-  if (!base::JSONWriter::WriteWithOptions(
-          root, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json_string)) {
-    DLOG(ERROR) << "Failed to serialize specialized mode data to JSON";
-    return;
-  }
-  
-  // Write to file
-  if (base::WriteFile(path, json_string.data(), json_string.size()) == -1) {
-    DLOG(ERROR) << "Failed to write specialized mode data to file: " << path.value();
-  }
+  return root;
 }
 
-void SpecializedModesController::LoadData() {
-  if (!web_contents()) {
-    return;
-  }
-  
-  content::BrowserContext* browser_context = web_contents()->GetBrowserContext();
-  if (!browser_context) {
-    return;
-  }
-  
-  base::FilePath path = GetDataFilePath();
-  if (path.empty()) {
-    DLOG(ERROR) << "Failed to get specialized mode data file path";
-    return;
-  }
-  
-  // Check if the file exists
-  if (!base::PathExists(path)) {
-    DLOG(INFO) << "Specialized mode data file does not exist: " << path.value();
-    return;
-  }
-  
-  // Read the file
-  std::string json_string;
-  if (!base::ReadFileToString(path, &json_string)) {
-    DLOG(ERROR) << "Failed to read specialized mode data from file: " << path.value();
-    return;
-  }
-  
-  // Parse the JSON
-  absl::optional<base::Value> value = base::JSONReader::Read(json_string);
-  if (!value || !value->is_dict()) {
-    DLOG(ERROR) << "Failed to parse specialized mode data JSON";
-    return;
-  }
-  
-  const base::Value::Dict& root = value->GetDict();
-  
+void SpecializedModesController::DataFromValue(const base::Value::Dict& root) {
   // Get the current mode
   if (auto mode = root.FindInt("current_mode")) {
     current_mode_ = static_cast<SpecializedMode>(*mode);
@@ -1380,10 +1854,10 @@ void SpecializedModesController::LoadData() {
   
   // Get code snippets
   if (const base::Value::List* snippets_list = root.FindList("code_snippets")) {
-    code_snippets_.clear();
+    code_snippets_.Clear();
     for (const auto& snippet_value : *snippets_list) {
       if (!snippet_value.is_dict()) continue;
-      code_snippets_.push_back(ValueToCodeSnippet(snippet_value.GetDict()));
+      code_snippets_.Put(ValueToCodeSnippet(snippet_value.GetDict()));
     }
   }
   
@@ -1404,6 +1878,62 @@ void SpecializedModesController::LoadData() {
       game_info_.push_back(ValueToGameInfo(info_value.GetDict()));
     }
   }
+}
+
+// static
+scoped_refptr<SpecializedModesController::Journal>
+SpecializedModesController::GetJournal(const base::FilePath& path) {
+  // One per file, so that every tab's appends go through one sequence
+  static base::NoDestructor<std::map<base::FilePath, scoped_refptr<Journal>>>
+      journals;
+  scoped_refptr<Journal>& journal = (*journals)[path];
+  if (!journal) {
+    journal = base::MakeRefCounted<Journal>(path);
+  }
+  return journal;
+}
+
+void SpecializedModesController::LoadData() {
+  base::FilePath path = GetDataFilePath();
+  if (path.empty()) {
+    DLOG(ERROR) << "Failed to get specialized mode data file path";
+    loaded_ = true;
+    return;
+  }
+  
+  if (!journal_) {
+    journal_ = GetJournal(path);
+  }
+  loaded_ = false;
+  journal_->task_runner()->PostTaskAndReplyWithResult(
+      FROM_HERE, base::BindOnce(&Journal::Read, journal_),
+      base::BindOnce(&SpecializedModesController::OnLoaded,
+                     weak_ptr_factory_.GetWeakPtr()));
+}
+
+void SpecializedModesController::OnLoaded(std::vector<std::string> records) {
+  // Changes made meanwhile were applied early; redo them after the loaded
+  // ones
+  hibernated_state_.clear();
+  current_mode_ = SpecializedMode::kNone;
+  code_snippets_.Clear();
+  documents_.clear();
+  game_info_.clear();
+  
+  journal_bytes_ = sizeof(JournalHeader);
+  for (const std::string& record : records) {
+    if (!Apply(record)) {
+      DLOG(WARNING) << "Skipping malformed specialized mode record";
+    }
+    journal_bytes_ += GetFrameSize(record);
+  }
+  for (const std::string& record : early_records_) {
+    Apply(record);
+    journal_bytes_ += GetFrameSize(record);
+  }
+  early_records_.clear();
+  next_compaction_bytes_ = std::max(journal_bytes_, kMinCompactionBytes);
+  loaded_ = true;
   
   DLOG(INFO) << "Loaded specialized mode data: " 
              << code_snippets_.size() << " code snippets, "
@@ -1411,6 +1941,209 @@ void SpecializedModesController::LoadData() {
              << game_info_.size() << " game info entries";
 }
 
+bool SpecializedModesController::Apply(std::string_view record) {
+  const uint8_t* pos = reinterpret_cast<const uint8_t*>(record.data());
+  const uint8_t* end = pos + record.size();
+  uint8_t type = 0;
+  if (!Read(&pos, end, &type)) {
+    return false;
+  }
+  
+  switch (type) {
+    case kSetMode: {
+      int32_t mode = 0;
+      if (!Read(&pos, end, &mode)) {
+        return false;
+      }
+      current_mode_ = static_cast<SpecializedMode>(mode);
+      return true;
+    }
+    case kPutSnippet:
+    case kEraseSnippet: {
+      CodeSnippet snippet;
+      if (!ReadString(&pos, end, &snippet.code) ||
+          !ReadString(&pos, end, &snippet.source_url)) {
+        return false;
+      }
+      if (type == kEraseSnippet) {
+        code_snippets_.Erase(snippet.code, snippet.source_url);
+        return true;
+      }
+      if (!ReadString(&pos, end, &snippet.language) ||
+          !ReadString(&pos, end, &snippet.description)) {
+        return false;
+      }
+      code_snippets_.Put(std::move(snippet));
+      return true;
+    }
+    case kPutDocument:
+    case kEraseDocument:
+    case kSetDocumentContent: {
+      std::string title;
+      if (!ReadString(&pos, end, &title)) {
+        return false;
+      }
+      auto it = std::find_if(
+          documents_.begin(), documents_.end(),
+          [&title](const WorkDocument& doc) { return doc.title == title; });
+      if (type == kEraseDocument) {
+        if (it != documents_.end()) {
+          documents_.erase(it);
+        }
+        return true;
+      }
+      std::string content;
+      if (!ReadString(&pos, end, &content)) {
+        return false;
+      }
+      if (type == kSetDocumentContent) {
+        if (it != documents_.end()) {
+          it->content = std::move(content);
+        }
+        return true;
+      }
+      WorkDocument document;
+      uint8_t is_draft = 1;
+      if (!ReadString(&pos, end, &document.format) ||
+          !ReadString(&pos, end, &document.url) ||
+          !Read(&pos, end, &is_draft)) {
+        return false;
+      }
+      document.title = std::move(title);
+      document.content = std::move(content);
+      document.is_draft = is_draft != 0;
+      if (it != documents_.end()) {
+        *it = std::move(document);
+      } else {
+        documents_.push_back(std::move(document));
+      }
+      return true;
+    }
+    case kPutGameInfo:
+    case kEraseGameInfo: {
+      GameInfo game_info;
+      if (!ReadString(&pos, end, &game_info.title)) {
+        return false;
+      }
+      auto it = std::find_if(
+          game_info_.begin(), game_info_.end(),
+          [&game_info](const GameInfo& existing) {
+            return existing.title == game_info.title;
+          });
+      if (type == kEraseGameInfo) {
+        if (it != game_info_.end()) {
+          game_info_.erase(it);
+        }
+        return true;
+      }
+      if (!ReadString(&pos, end, &game_info.genre) ||
+          !ReadString(&pos, end, &game_info.platform) ||
+          !ReadString(&pos, end, &game_info.tips) ||
+          !ReadString(&pos, end, &game_info.strategies) ||
+          !ReadString(&pos, end, &game_info.url)) {
+        return false;
+      }
+      if (it != game_info_.end()) {
+        *it = std::move(game_info);
+      } else {
+        game_info_.push_back(std::move(game_info));
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void SpecializedModesController::Commit(std::string record) {
+  bool applied = Apply(record);
+  DCHECK(applied);
+  if (!journal_) {
+    return;
+  }
+  
+  std::string frame;
+  AppendFrame(record, &frame);
+  journal_bytes_ += frame.size();
+  // Appends posted before loading finishes land after the loaded records
+  journal_->task_runner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&Journal::AppendFrames, journal_, std::move(frame)));
+  if (!loaded_) {
+    early_records_.push_back(std::move(record));
+    return;
+  }
+  
+  // Sizing a snapshot costs as much as the data, so only do it once the
+  // journal has grown by about that much since the last time
+  if (journal_bytes_ < next_compaction_bytes_) {
+    return;
+  }
+  std::vector<std::string> snapshot = Snapshot();
+  size_t snapshot_bytes = sizeof(JournalHeader);
+  for (const std::string& snapshot_record : snapshot) {
+    snapshot_bytes += GetFrameSize(snapshot_record);
+  }
+  if (journal_bytes_ > 2 * snapshot_bytes) {
+    journal_bytes_ = snapshot_bytes;
+    journal_->task_runner()->PostTask(
+        FROM_HERE, base::BindOnce(&Journal::Rewrite, journal_,
+                                  std::move(snapshot)));
+  }
+  next_compaction_bytes_ =
+      std::max(journal_bytes_ + snapshot_bytes, kMinCompactionBytes);
+}
+
+std::vector<std::string> SpecializedModesController::Snapshot() const {
+  std::vector<std::string> records;
+  records.reserve(1 + code_snippets_.size() + documents_.size() +
+                  game_info_.size());
+  records.push_back(SetModeRecord(current_mode_));
+  for (const auto& snippet : code_snippets_.snippets()) {
+    records.push_back(PutSnippetRecord(snippet));
+  }
+  for (const auto& document : documents_) {
+    records.push_back(PutDocumentRecord(document));
+  }
+  for (const auto& info : game_info_) {
+    records.push_back(PutGameInfoRecord(info));
+  }
+  return records;
+}
+
+void SpecializedModesController::Hibernate() {
+  if (is_hibernated()) {
+    return;
+  }
+  
+  hibernated_state_ = TabHibernationManager::PackState(DataToValue());
+  if (hibernated_state_.empty()) {
+    DLOG(ERROR) << "Failed to pack specialized mode data; keeping it in memory";
+    return;
+  }
+  
+  // Swap rather than clear, to free the capacity as well
+  code_snippets_.Clear();
+  std::vector<WorkDocument>().swap(documents_);
+  std::vector<GameInfo>().swap(game_info_);
+}
+
+void SpecializedModesController::Wake() {
+  if (!is_hibernated()) {
+    return;
+  }
+  
+  std::optional<base::Value::Dict> root =
+      TabHibernationManager::UnpackState(hibernated_state_);
+  hibernated_state_.clear();
+  if (root) {
+    DataFromValue(*root);
+  } else {
+    // Fall back to what was last saved
+    DLOG(ERROR) << "Failed to unpack specialized mode data";
+    LoadData();
+  }
+}
+
 base::FilePath SpecializedModesController::GetDataFilePath() const {
   if (!web_contents()) {
     return base::FilePath();
@@ -5,12 +5,19 @@
 #ifndef ASOL_BROWSER_SPECIALIZED_MODES_H_
 #define ASOL_BROWSER_SPECIALIZED_MODES_H_
 
+#include <stddef.h>
+
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+#include "asol/browser/code_snippet_store.h"
 #include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/values.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
 
@@ -19,6 +26,10 @@ class WebContents;
 }
 
 namespace asol {
+namespace adapters {
+struct ModelResponse;
+}
+
 namespace browser {
 
 // Enum for the different specialized modes
@@ -29,14 +40,6 @@ enum class SpecializedMode {
   kGaming
 };
 
-// Structure to hold code snippet data
-struct CodeSnippet {
-  std::string language;
-  std::string code;
-  std::string description;
-  std::string source_url;
-};
-
 // Structure to hold work document data
 struct WorkDocument {
   std::string title;
@@ -180,6 +183,13 @@ class SpecializedModesController
   void OptimizeGameSettings(const std::string& game_title, const std::string& hardware,
                            base::OnceCallback<void(const std::string&)> callback);
 
+  // Pack the saved snippets, documents and game info into a compressed
+  // blob and free them while the tab is in the background. See
+  // TabHibernationManager. Every method that needs them wakes first.
+  void Hibernate();
+  void Wake();
+  bool is_hibernated() const { return !hibernated_state_.empty(); }
+
  private:
   // Allow WebContentsUserData to create instances of this class
   friend class content::WebContentsUserData<SpecializedModesController>;
@@ -190,22 +200,71 @@ class SpecializedModesController
   // WebContentsObserver implementation
   void DidFinishNavigation(
       content::NavigationHandle* navigation_handle) override;
-  void WebContentsDestroyed() override;
-
-  // Save data to disk
-  void SaveData();
 
-  // Load data from disk
+  void OnCodeSnippetsExtracted(std::string url,
+                               CodeSnippetsCallback callback,
+                               base::Value result);
+  void OnExtractedSnippetsClassified(CodeSnippetsCallback callback,
+                                     std::vector<CodeSnippet> snippets);
+
+  // Fill in the language of those of |snippets| without one from
+  // |snippet_languages_| or CodeLanguageClassifier, asking the AI, in one
+  // request, only about those the classifier cannot tell
+  void DetectSnippetLanguages(
+      std::vector<CodeSnippet> snippets,
+      base::OnceCallback<void(std::vector<CodeSnippet>)> callback);
+  void OnSnippetLanguagesDetected(
+      std::vector<CodeSnippet> snippets,
+      std::vector<size_t> ambiguous,
+      base::OnceCallback<void(std::vector<CodeSnippet>)> callback,
+      const adapters::ModelResponse& response);
+  void CacheSnippetLanguage(size_t content_hash, const std::string& language);
+
+  // The language of |code|, or failing that of the page
+  void DetectCodeLanguage(const std::string& code,
+                          base::OnceCallback<void(const std::string&)> callback);
+
+  // The saved data is persisted as a journal of changes, appended on a
+  // background sequence so a save costs the size of the change, not of all
+  // the data. The journal is shared by every tab's controller and replayed
+  // by LoadData(); once it is mostly superseded records it is rewritten as
+  // a snapshot of this controller's data.
+  class Journal;
+
+  // The journal at |path|, created on first use
+  static scoped_refptr<Journal> GetJournal(const base::FilePath& path);
+
+  // Start replaying the journal. Changes made before it finishes apply
+  // after the replayed ones.
   void LoadData();
+  void OnLoaded(std::vector<std::string> records);
+
+  // Apply the journal record |record|, from this session or a past one.
+  // Returns false if it is malformed.
+  bool Apply(std::string_view record);
+
+  // Apply |record| and append it to the journal
+  void Commit(std::string record);
+
+  // Journal records describing the saved data
+  std::vector<std::string> Snapshot() const;
 
   // Get the file path for storing specialized mode data
   base::FilePath GetDataFilePath() const;
 
+  // The saved data as a value, and back
+  base::Value::Dict DataToValue() const;
+  void DataFromValue(const base::Value::Dict& root);
+
   // The current specialized mode
   SpecializedMode current_mode_ = SpecializedMode::kNone;
 
   // Saved code snippets for developer mode
-  std::vector<CodeSnippet> code_snippets_;
+  CodeSnippetStore code_snippets_;
+
+  // The languages of the snippets seen, by CodeSnippetStore::HashContent(),
+  // so a snippet met again is not classified again
+  std::unordered_map<size_t, std::string> snippet_languages_;
 
   // Saved documents for work mode
   std::vector<WorkDocument> documents_;
@@ -213,6 +272,19 @@ class SpecializedModesController
   // Saved game info for gaming mode
   std::vector<GameInfo> game_info_;
 
+  // The packed data while hibernated, empty otherwise
+  std::string hibernated_state_;
+
+  // Null if there is nowhere to save
+  scoped_refptr<Journal> journal_;
+  bool loaded_ = false;
+  // Records committed before loading finished
+  std::vector<std::string> early_records_;
+  // Bytes this controller knows to be in the journal, and the size at
+  // which to next consider compacting it
+  size_t journal_bytes_ = 0;
+  size_t next_compaction_bytes_ = 0;
+
   // For generating weak pointers to this
   base::WeakPtrFactory<SpecializedModesController> weak_ptr_factory_{this};
 
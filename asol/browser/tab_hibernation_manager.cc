@@ -0,0 +1,150 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/browser/tab_hibernation_manager.h"
+
+#include <string>
+#include <utility>
+
+#include "asol/browser/asol_browser_integration.h"
+#include "asol/browser/browser_features.h"
+#include "asol/browser/research_mode_controller.h"
+#include "asol/browser/side_panel_controller.h"
+#include "asol/browser/specialized_modes.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "content/public/browser/web_contents.h"
+#include "third_party/zlib/google/compression_utils.h"
+
+namespace asol {
+namespace browser {
+
+// static
+WEB_CONTENTS_USER_DATA_KEY_IMPL(TabHibernationManager);
+
+TabHibernationManager::TabHibernationManager(content::WebContents* web_contents)
+    : content::WebContentsObserver(web_contents),
+      content::WebContentsUserData<TabHibernationManager>(*web_contents),
+      idle_time_(base::Seconds(kAsolTabHibernationIdleSecondsParam.Get())) {
+  if (web_contents->GetVisibility() == content::Visibility::HIDDEN) {
+    OnVisibilityChanged(content::Visibility::HIDDEN);
+  }
+}
+
+TabHibernationManager::~TabHibernationManager() = default;
+
+void TabHibernationManager::SetIdleTime(base::TimeDelta idle_time) {
+  idle_time_ = idle_time;
+  if (idle_timer_.IsRunning()) {
+    idle_timer_.Start(FROM_HERE, idle_time_, this,
+                      &TabHibernationManager::OnIdleTimeout);
+  }
+}
+
+void TabHibernationManager::Hibernate() {
+  idle_timer_.Stop();
+  content::WebContents* contents = web_contents();
+  if (!contents) {
+    return;
+  }
+
+  if (auto* research = ResearchModeController::FromWebContents(contents)) {
+    research->Hibernate();
+  }
+  if (auto* modes = SpecializedModesController::FromWebContents(contents)) {
+    modes->Hibernate();
+  }
+  if (auto* integration = AsolBrowserIntegration::FromWebContents(contents)) {
+    integration->Hibernate();
+  }
+  if (auto* side_panel = SidePanelController::FromWebContents(contents)) {
+    side_panel->Hibernate();
+  }
+  is_hibernated_ = true;
+  DLOG(INFO) << "Hibernated AI state of WebContents: " << contents;
+}
+
+void TabHibernationManager::Wake() {
+  content::WebContents* contents = web_contents();
+  if (!is_hibernated_ || !contents) {
+    return;
+  }
+
+  // Controllers that woke themselves meanwhile make this a no-op
+  if (auto* research = ResearchModeController::FromWebContents(contents)) {
+    research->Wake();
+  }
+  if (auto* modes = SpecializedModesController::FromWebContents(contents)) {
+    modes->Wake();
+  }
+  if (auto* integration = AsolBrowserIntegration::FromWebContents(contents)) {
+    integration->Wake();
+  }
+  if (auto* side_panel = SidePanelController::FromWebContents(contents)) {
+    side_panel->Wake();
+  }
+  is_hibernated_ = false;
+  DLOG(INFO) << "Woke AI state of WebContents: " << contents;
+}
+
+// static
+std::string TabHibernationManager::PackState(const base::Value::Dict& state) {
+  std::string json;
+  std::string packed;
+  if (!base::JSONWriter::Write(state, &json) ||
+      !compression::GzipCompress(json, &packed)) {
+    return std::string();
+  }
+  return packed;
+}
+
+// static
+std::optional<base::Value::Dict> TabHibernationManager::UnpackState(
+    std::string_view packed) {
+  std::string json;
+  if (!compression::GzipUncompress(packed, &json)) {
+    return std::nullopt;
+  }
+  absl::optional<base::Value> value = base::JSONReader::Read(json);
+  if (!value || !value->is_dict()) {
+    return std::nullopt;
+  }
+  return std::move(value->GetDict());
+}
+
+void TabHibernationManager::OnVisibilityChanged(
+    content::Visibility visibility) {
+  if (visibility == content::Visibility::VISIBLE) {
+    idle_timer_.Stop();
+    Wake();
+    return;
+  }
+  // Occluded tabs are still on screen and may be looked at any moment
+  if (visibility == content::Visibility::HIDDEN && !is_hibernated_ &&
+      base::FeatureList::IsEnabled(kAsolTabHibernation)) {
+    idle_timer_.Start(FROM_HERE, idle_time_, this,
+                      &TabHibernationManager::OnIdleTimeout);
+  }
+}
+
+void TabHibernationManager::WebContentsDestroyed() {
+  idle_timer_.Stop();
+}
+
+void TabHibernationManager::OnIdleTimeout() {
+  if (!web_contents()) {
+    return;
+  }
+  // A tab playing audio is in use; check again after another idle period
+  if (web_contents()->IsCurrentlyAudible()) {
+    idle_timer_.Start(FROM_HERE, idle_time_, this,
+                      &TabHibernationManager::OnIdleTimeout);
+    return;
+  }
+  Hibernate();
+}
+
+}  // namespace browser
+}  // namespace asol
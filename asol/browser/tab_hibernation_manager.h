@@ -0,0 +1,86 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_BROWSER_TAB_HIBERNATION_MANAGER_H_
+#define ASOL_BROWSER_TAB_HIBERNATION_MANAGER_H_
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "base/values.h"
+#include "content/public/browser/visibility.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "content/public/browser/web_contents_user_data.h"
+
+namespace content {
+class WebContents;
+}
+
+namespace asol {
+namespace browser {
+
+// TabHibernationManager frees the AI state of a tab that has stayed in the
+// background, so that many open tabs do not each hold a full copy.
+//
+// Once the tab has been hidden for the idle time, the tab's
+// ResearchModeController and SpecializedModesController pack their data
+// into a compressed blob and free it, dropping their PageContextExtractor,
+// and AsolBrowserIntegration and SidePanelController release their UI
+// controllers unless their panel is showing. Showing the tab wakes them
+// all. A controller called while hibernated wakes itself first, so
+// hibernation is never visible to callers; it only costs the unpacking.
+//
+// Audible tabs are left alone. Attach with CreateForWebContents(), next to
+// the controllers.
+class TabHibernationManager
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<TabHibernationManager> {
+ public:
+  ~TabHibernationManager() override;
+
+  // Disallow copy and assign
+  TabHibernationManager(const TabHibernationManager&) = delete;
+  TabHibernationManager& operator=(const TabHibernationManager&) = delete;
+
+  // How long the tab must be hidden before hibernating. Defaults to the
+  // kAsolTabHibernation "idle_seconds" param.
+  void SetIdleTime(base::TimeDelta idle_time);
+  base::TimeDelta idle_time() const { return idle_time_; }
+
+  // Hibernate the tab's controllers now, or wake them
+  void Hibernate();
+  void Wake();
+  bool is_hibernated() const { return is_hibernated_; }
+
+  // The compact form a controller keeps its state in while hibernated:
+  // JSON, gzipped. PackState() returns an empty string on failure.
+  static std::string PackState(const base::Value::Dict& state);
+  static std::optional<base::Value::Dict> UnpackState(std::string_view packed);
+
+ private:
+  // Allow WebContentsUserData to create instances of this class
+  friend class content::WebContentsUserData<TabHibernationManager>;
+
+  explicit TabHibernationManager(content::WebContents* web_contents);
+
+  // WebContentsObserver implementation
+  void OnVisibilityChanged(content::Visibility visibility) override;
+  void WebContentsDestroyed() override;
+
+  void OnIdleTimeout();
+
+  base::TimeDelta idle_time_;
+  base::OneShotTimer idle_timer_;
+  bool is_hibernated_ = false;
+
+  WEB_CONTENTS_USER_DATA_KEY_DECL();
+};
+
+}  // namespace browser
+}  // namespace asol
+
+#endif  // ASOL_BROWSER_TAB_HIBERNATION_MANAGER_H_
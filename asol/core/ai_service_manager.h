@@ -11,9 +11,12 @@
 #include <vector>
 
 #include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "asol/core/ai_service_provider.h"
+#include "asol/core/cancellation_token.h"
 #include "asol/core/context_manager.h"
+#include "asol/core/trace_context.h"
 
 namespace asol {
 namespace core {
@@ -41,10 +44,17 @@ class AIServiceManager {
   // AI request parameters
   struct AIRequestParams {
     TaskType task_type = TaskType::TEXT_GENERATION;
-    std::string input_text;
+    // See AIServiceProvider::AIRequestParams::input_text
+    SharedText input_text;
     std::string context_id;  // For maintaining conversation context
     std::string provider_id; // Specific provider to use, or empty for default
     std::unordered_map<std::string, std::string> custom_params;
+    // See AIServiceProvider::AIRequestParams::cancellation_token
+    scoped_refptr<CancellationToken> cancellation_token;
+    // See AIServiceProvider::AIRequestParams::attachments
+    std::vector<AIServiceProvider::Attachment> attachments;
+    // See AIServiceProvider::AIRequestParams::trace
+    TraceContext trace;
   };
 
   AIServiceManager();
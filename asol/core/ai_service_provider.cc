@@ -0,0 +1,29 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/ai_service_provider.h"
+
+#include <utility>
+
+#include "base/functional/bind.h"
+
+namespace asol {
+namespace core {
+
+AIServiceProvider::AIServiceProvider() = default;
+AIServiceProvider::~AIServiceProvider() = default;
+
+void AIServiceProvider::ProcessStreamingRequest(const AIRequestParams& params,
+                                                AIStreamCallback callback) {
+  ProcessRequest(params,
+                 base::BindOnce(
+                     [](AIStreamCallback callback, bool success,
+                        const std::string& response) {
+                       callback.Run(MakeFinalStreamDelta(success, response));
+                     },
+                     std::move(callback)));
+}
+
+}  // namespace core
+}  // namespace asol
@@ -9,7 +9,15 @@
 #include <unordered_map>
 #include <vector>
 
+#include "asol/core/cancellation_token.h"
+#include "asol/core/shared_text.h"
+#include "asol/core/stream_delta.h"
+#include "asol/core/token_counter.h"
+#include "asol/core/trace_context.h"
 #include "base/callback.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/time/time.h"
 
 namespace asol {
 namespace core {
@@ -22,6 +30,9 @@ class AIServiceProvider {
   using AIResponseCallback = 
       base::OnceCallback<void(bool success, const std::string& response)>;
 
+  // Callback for streamed requests; see StreamDelta
+  using AIStreamCallback = StreamDeltaCallback;
+
   // AI task types (same as in AIServiceManager)
   enum class TaskType {
     TEXT_GENERATION,
@@ -34,12 +45,39 @@ class AIServiceProvider {
     CUSTOM
   };
 
+  // Binary input sent with a request, such as an image. The bytes are
+  // shared, not copied, as the request passes through wrapping providers.
+  struct Attachment {
+    // e.g. "image/jpeg"
+    std::string mime_type;
+    scoped_refptr<base::RefCountedMemory> data;
+  };
+
   // AI request parameters
   struct AIRequestParams {
     TaskType task_type;
-    std::string input_text;
+    // Shared, not copied, by every layer and retry the request goes through
+    SharedText input_text;
     std::string context_id;  // For maintaining conversation context
     std::unordered_map<std::string, std::string> custom_params;
+    // When the caller stops waiting; null for no deadline. Wrappers pass it
+    // on unchanged so every layer works against the caller's budget.
+    base::TimeTicks deadline;
+    // Whether sending the request twice is harmless. Plain completions are;
+    // requests that trigger side effects should clear this so they are not
+    // resent after the provider may have seen them.
+    bool idempotent = true;
+    // Cancelled when the caller no longer wants the response, e.g. its tab
+    // closed; null if the request cannot be cancelled. Providers abort the
+    // transfer and complete with kRequestCancelledError.
+    scoped_refptr<CancellationToken> cancellation_token;
+    // Binary inputs the text refers to. Providers that accept binary
+    // content upload them as is, e.g. as multipart or inline parts; others
+    // answer from the text alone.
+    std::vector<Attachment> attachments;
+    // The caller's span; each layer starts its own under it and passes
+    // that on, and HTTP adapters send it upstream as a traceparent
+    TraceContext trace;
   };
 
   // Provider capabilities
@@ -53,6 +91,9 @@ class AIServiceProvider {
     bool supports_translation = false;
     bool supports_streaming = false;
     bool supports_context = false;
+    // Largest prompt the configured model accepts, in its own tokens; 0
+    // when unknown
+    size_t max_input_tokens = 0;
     std::vector<std::string> supported_languages;
     std::unordered_map<std::string, std::string> custom_capabilities;
   };
@@ -73,6 +114,23 @@ class AIServiceProvider {
   virtual void ProcessRequest(const AIRequestParams& params, 
                             AIResponseCallback callback) = 0;
 
+  // Process an AI request, reporting the text as it is generated. Providers
+  // with supports_streaming set override this; the default waits for
+  // ProcessRequest() and delivers the whole response as the final delta.
+  virtual void ProcessStreamingRequest(const AIRequestParams& params,
+                                       AIStreamCallback callback);
+
+  // Counter for the provider's tokenizer, for sizing requests before they
+  // are sent. The default only approximates.
+  virtual const TokenCounter& GetTokenCounter() const {
+    return GetApproximateTokenCounter();
+  }
+
+  // Open connections to the provider's endpoints ahead of the first
+  // request, so it does not pay for DNS, TCP and TLS setup. Called once at
+  // startup; must not block. The default does nothing.
+  virtual void Preconnect() {}
+
   // Configure the provider
   virtual void Configure(const std::unordered_map<std::string, std::string>& config) = 0;
 
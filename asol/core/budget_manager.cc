@@ -0,0 +1,140 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/budget_manager.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/time/default_clock.h"
+
+namespace asol {
+namespace core {
+
+const char kBudgetUserParam[] = "budget_user";
+const char kBudgetFeatureParam[] = "budget_feature";
+
+BudgetManager::BudgetManager(const Limits& limits)
+    : limits_(limits), clock_(base::DefaultClock::GetInstance()) {}
+
+BudgetManager::~BudgetManager() = default;
+
+BudgetManager::Decision BudgetManager::Evaluate(const BudgetScope& scope,
+                                                double estimated_cost,
+                                                RequestPriority priority) {
+  ResetIfNewDay();
+  double remaining = RemainingFractionAfter(scope, estimated_cost);
+
+  if (priority != RequestPriority::INTERACTIVE &&
+      remaining < limits_.background_cutoff_fraction) {
+    stats_.rejected++;
+    DVLOG(1) << "Budget rejects " << RequestPriorityToString(priority)
+             << " request for feature '" << scope.feature << "'";
+    return Decision::REJECT;
+  }
+  if (remaining < 0.0) {
+    stats_.local_only++;
+    return Decision::LOCAL_ONLY;
+  }
+  if (remaining < limits_.downgrade_fraction) {
+    stats_.downgraded++;
+    return Decision::DOWNGRADE;
+  }
+  stats_.allowed++;
+  return Decision::ALLOW;
+}
+
+void BudgetManager::RecordSpend(const BudgetScope& scope, double cost) {
+  if (cost <= 0.0) {
+    return;
+  }
+  ResetIfNewDay();
+  global_spend_ += cost;
+  stats_.spent_today += cost;
+  if (!scope.user_id.empty()) {
+    user_spend_[scope.user_id] += cost;
+  }
+  if (!scope.feature.empty()) {
+    feature_spend_[scope.feature] += cost;
+  }
+}
+
+double BudgetManager::GetRemainingFraction(const BudgetScope& scope) {
+  ResetIfNewDay();
+  return std::max(0.0, RemainingFractionAfter(scope, 0.0));
+}
+
+base::Time BudgetManager::GetResetTime() {
+  ResetIfNewDay();
+  // Midnight of the next local day; the extra hours absorb DST changes
+  return (budget_day_ + base::Hours(36)).LocalMidnight();
+}
+
+BudgetManager::Stats BudgetManager::GetStats() {
+  ResetIfNewDay();
+  return stats_;
+}
+
+// static
+size_t BudgetManager::EstimateTokens(std::string_view text) {
+  return text.size() / 4 + 1;
+}
+
+// static
+double BudgetManager::EstimateCost(size_t tokens, double cost_per_1k_tokens) {
+  return static_cast<double>(tokens) / 1000.0 * cost_per_1k_tokens;
+}
+
+void BudgetManager::ResetIfNewDay() {
+  base::Time today = clock_->Now().LocalMidnight();
+  if (today != budget_day_) {
+    budget_day_ = today;
+    global_spend_ = 0.0;
+    user_spend_.clear();
+    feature_spend_.clear();
+    stats_.spent_today = 0.0;
+  }
+}
+
+// static
+double BudgetManager::RemainingFraction(double limit,
+                                        double spent,
+                                        double extra) {
+  if (limit <= 0.0) {
+    return 1.0;
+  }
+  return (limit - spent - extra) / limit;
+}
+
+double BudgetManager::GetFeatureLimit(const std::string& feature) const {
+  auto it = limits_.feature_daily.find(feature);
+  if (it != limits_.feature_daily.end()) {
+    return it->second;
+  }
+  return limits_.per_feature_daily;
+}
+
+double BudgetManager::RemainingFractionAfter(const BudgetScope& scope,
+                                             double extra) const {
+  double remaining =
+      RemainingFraction(limits_.global_daily, global_spend_, extra);
+
+  if (!scope.user_id.empty()) {
+    auto it = user_spend_.find(scope.user_id);
+    double spent = it != user_spend_.end() ? it->second : 0.0;
+    remaining = std::min(
+        remaining, RemainingFraction(limits_.per_user_daily, spent, extra));
+  }
+  if (!scope.feature.empty()) {
+    auto it = feature_spend_.find(scope.feature);
+    double spent = it != feature_spend_.end() ? it->second : 0.0;
+    remaining = std::min(
+        remaining,
+        RemainingFraction(GetFeatureLimit(scope.feature), spent, extra));
+  }
+  return remaining;
+}
+
+}  // namespace core
+}  // namespace asol
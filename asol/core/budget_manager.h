@@ -0,0 +1,134 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_BUDGET_MANAGER_H_
+#define ASOL_CORE_BUDGET_MANAGER_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "asol/core/request_scheduler.h"
+#include "base/time/clock.h"
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// Request parameters naming who a request is spent on
+extern const char kBudgetUserParam[];
+extern const char kBudgetFeatureParam[];
+
+// Who a request is charged to. Empty fields are not tracked.
+struct BudgetScope {
+  std::string user_id;
+  std::string feature;
+};
+
+// BudgetManager caps estimated AI spend per local day, globally, per user
+// and per feature. Callers estimate a request's cost from its input before
+// dispatch and ask Evaluate() how to proceed: as planned, on a cheaper
+// model, on the local model only, or not at all. Background and prefetch
+// work stops early so the remaining budget is kept for interactive use.
+//
+// Costs are in US dollars. Not thread-safe.
+class BudgetManager {
+ public:
+  struct Limits {
+    // Daily limits; 0 means unlimited
+    double global_daily = 0.0;
+    double per_user_daily = 0.0;
+    double per_feature_daily = 0.0;
+
+    // Per-feature overrides of |per_feature_daily|
+    std::unordered_map<std::string, double> feature_daily;
+
+    // Once less than this fraction of any applicable limit would remain,
+    // requests are routed to cheaper models
+    double downgrade_fraction = 0.25;
+
+    // Once less than this fraction would remain, background and prefetch
+    // work is rejected
+    double background_cutoff_fraction = 0.1;
+
+    // Price used when the caller does not know the provider's
+    double default_cost_per_1k_tokens = 0.002;
+  };
+
+  enum class Decision {
+    ALLOW,       // Send as planned
+    DOWNGRADE,   // Send to the cheapest suitable model
+    LOCAL_ONLY,  // Remote budget exhausted; only local inference may serve
+    REJECT,      // Do not send until the budget resets
+  };
+
+  struct Stats {
+    size_t allowed = 0;
+    size_t downgraded = 0;
+    size_t local_only = 0;
+    size_t rejected = 0;
+    double spent_today = 0.0;
+  };
+
+  explicit BudgetManager(const Limits& limits);
+  ~BudgetManager();
+
+  BudgetManager(const BudgetManager&) = delete;
+  BudgetManager& operator=(const BudgetManager&) = delete;
+
+  // Decide how a request estimated at |estimated_cost| may proceed
+  Decision Evaluate(const BudgetScope& scope,
+                    double estimated_cost,
+                    RequestPriority priority);
+
+  // Charge |cost| to |scope|
+  void RecordSpend(const BudgetScope& scope, double cost);
+
+  // Smallest remaining fraction across the limits |scope| is subject to;
+  // 1 when none apply
+  double GetRemainingFraction(const BudgetScope& scope);
+
+  // When the current budget period ends, i.e. when deferred work may retry
+  base::Time GetResetTime();
+
+  Stats GetStats();
+
+  // Rough token estimate (about four bytes per token)
+  static size_t EstimateTokens(std::string_view text);
+
+  // Cost of |tokens| at |cost_per_1k_tokens|
+  static double EstimateCost(size_t tokens, double cost_per_1k_tokens);
+
+  double default_cost_per_1k_tokens() const {
+    return limits_.default_cost_per_1k_tokens;
+  }
+
+  void SetClockForTesting(const base::Clock* clock) { clock_ = clock; }
+
+ private:
+  // Start a new budget period when the local day has changed
+  void ResetIfNewDay();
+
+  // Remaining fraction of |limit| after |spent| plus |extra|; 1 for no limit
+  static double RemainingFraction(double limit, double spent, double extra);
+
+  double GetFeatureLimit(const std::string& feature) const;
+
+  double RemainingFractionAfter(const BudgetScope& scope, double extra) const;
+
+  const Limits limits_;
+  const base::Clock* clock_;
+
+  base::Time budget_day_;
+  double global_spend_ = 0.0;
+  std::unordered_map<std::string, double> user_spend_;
+  std::unordered_map<std::string, double> feature_spend_;
+  Stats stats_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_BUDGET_MANAGER_H_
@@ -0,0 +1,94 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/budget_manager.h"
+
+#include <string>
+
+#include "base/test/simple_test_clock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+class BudgetManagerTest : public testing::Test {
+ protected:
+  static BudgetManager::Limits MakeLimits() {
+    BudgetManager::Limits limits;
+    limits.global_daily = 10.0;
+    limits.per_user_daily = 4.0;
+    limits.feature_daily["summarization"] = 1.0;
+    limits.downgrade_fraction = 0.5;
+    limits.background_cutoff_fraction = 0.2;
+    return limits;
+  }
+
+  void SetUp() override {
+    clock_.SetNow(base::Time::Now().LocalMidnight() + base::Hours(12));
+    budget_.SetClockForTesting(&clock_);
+  }
+
+  base::SimpleTestClock clock_;
+  BudgetManager budget_{MakeLimits()};
+};
+
+TEST_F(BudgetManagerTest, DowngradesThenFallsBackToLocal) {
+  BudgetScope scope{"alice", ""};
+  EXPECT_EQ(budget_.Evaluate(scope, 1.0, RequestPriority::INTERACTIVE),
+            BudgetManager::Decision::ALLOW);
+
+  budget_.RecordSpend(scope, 2.0);
+  EXPECT_EQ(budget_.Evaluate(scope, 1.0, RequestPriority::INTERACTIVE),
+            BudgetManager::Decision::DOWNGRADE);
+
+  budget_.RecordSpend(scope, 1.5);
+  EXPECT_EQ(budget_.Evaluate(scope, 1.0, RequestPriority::INTERACTIVE),
+            BudgetManager::Decision::LOCAL_ONLY);
+
+  // Other users are unaffected
+  EXPECT_EQ(budget_.Evaluate({"bob", ""}, 1.0, RequestPriority::INTERACTIVE),
+            BudgetManager::Decision::ALLOW);
+}
+
+TEST_F(BudgetManagerTest, RejectsBackgroundWorkBeforeInteractive) {
+  BudgetScope scope{"", "summarization"};
+  budget_.RecordSpend(scope, 0.7);
+
+  EXPECT_EQ(budget_.Evaluate(scope, 0.15, RequestPriority::PREFETCH),
+            BudgetManager::Decision::REJECT);
+  EXPECT_EQ(budget_.Evaluate(scope, 0.15, RequestPriority::INTERACTIVE),
+            BudgetManager::Decision::DOWNGRADE);
+  EXPECT_EQ(budget_.GetStats().rejected, 1u);
+}
+
+TEST_F(BudgetManagerTest, ResetsAtLocalMidnight) {
+  BudgetScope scope{"alice", "summarization"};
+  budget_.RecordSpend(scope, 1.0);
+  EXPECT_DOUBLE_EQ(budget_.GetRemainingFraction(scope), 0.0);
+
+  base::Time reset_time = budget_.GetResetTime();
+  EXPECT_GT(reset_time, clock_.Now());
+  clock_.SetNow(reset_time);
+  EXPECT_DOUBLE_EQ(budget_.GetRemainingFraction(scope), 1.0);
+  EXPECT_DOUBLE_EQ(budget_.GetStats().spent_today, 0.0);
+}
+
+TEST_F(BudgetManagerTest, UnlimitedScopesAlwaysAllow) {
+  BudgetManager budget{BudgetManager::Limits()};
+  budget.RecordSpend({"alice", "chat"}, 1000.0);
+  EXPECT_EQ(budget.Evaluate({"alice", "chat"}, 1000.0,
+                            RequestPriority::BACKGROUND),
+            BudgetManager::Decision::ALLOW);
+}
+
+TEST(BudgetManagerEstimateTest, PricesInputTokens) {
+  std::string text(4000, 'a');
+  EXPECT_EQ(BudgetManager::EstimateTokens(text), 1001u);
+  EXPECT_DOUBLE_EQ(BudgetManager::EstimateCost(2000, 0.5), 1.0);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,39 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/cancellation_token.h"
+
+#include <utility>
+
+#include "base/check.h"
+
+namespace asol {
+namespace core {
+
+const char kRequestCancelledError[] = "Request cancelled";
+
+bool IsCancellationError(std::string_view error) {
+  return error == kRequestCancelledError;
+}
+
+CancellationToken::CancellationToken() = default;
+
+CancellationToken::~CancellationToken() = default;
+
+void CancellationToken::Cancel() {
+  if (cancelled_) {
+    return;
+  }
+  cancelled_ = true;
+  callbacks_.Notify();
+}
+
+base::CallbackListSubscription CancellationToken::AddCancelCallback(
+    base::OnceClosure callback) {
+  DCHECK(!cancelled_);
+  return callbacks_.Add(std::move(callback));
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,62 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_CANCELLATION_TOKEN_H_
+#define ASOL_CORE_CANCELLATION_TOKEN_H_
+
+#include <string_view>
+
+#include "base/callback_list.h"
+#include "base/functional/callback.h"
+#include "base/memory/ref_counted.h"
+
+namespace asol {
+namespace core {
+
+// Error text of a request that stopped because its token was cancelled
+extern const char kRequestCancelledError[];
+
+// Whether |error| reports a cancelled request. Cancellation says nothing
+// about the provider's health, so breakers and retries ignore it.
+bool IsCancellationError(std::string_view error);
+
+// CancellationToken lets a caller abandon a request it no longer needs,
+// e.g. a summary for a tab that was closed. The caller keeps a reference
+// and every layer the request passes through holds another. Layers that
+// queue or wait check IsCancelled() before doing more work; layers that own
+// a transfer register a callback that aborts it. A cancelled request still
+// completes, with kRequestCancelledError, so slots and bookkeeping held by
+// the layers above are released.
+//
+// Must be used on a single sequence.
+class CancellationToken : public base::RefCounted<CancellationToken> {
+ public:
+  CancellationToken();
+
+  CancellationToken(const CancellationToken&) = delete;
+  CancellationToken& operator=(const CancellationToken&) = delete;
+
+  // Cancel the request and run the registered callbacks. Later calls do
+  // nothing.
+  void Cancel();
+
+  bool IsCancelled() const { return cancelled_; }
+
+  // Run |callback| when the token is cancelled, unless the returned
+  // subscription is destroyed first. Must not be called once cancelled.
+  [[nodiscard]] base::CallbackListSubscription AddCancelCallback(
+      base::OnceClosure callback);
+
+ private:
+  friend class base::RefCounted<CancellationToken>;
+  ~CancellationToken();
+
+  bool cancelled_ = false;
+  base::OnceClosureList callbacks_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_CANCELLATION_TOKEN_H_
@@ -0,0 +1,48 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/cancellation_token.h"
+
+#include "base/functional/bind.h"
+#include "base/memory/scoped_refptr.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+TEST(CancellationTokenTest, RunsCallbacksOnce) {
+  auto token = base::MakeRefCounted<CancellationToken>();
+  int runs = 0;
+  base::CallbackListSubscription subscription = token->AddCancelCallback(
+      base::BindOnce([](int* runs) { (*runs)++; }, &runs));
+
+  EXPECT_FALSE(token->IsCancelled());
+  token->Cancel();
+  token->Cancel();
+
+  EXPECT_TRUE(token->IsCancelled());
+  EXPECT_EQ(runs, 1);
+}
+
+TEST(CancellationTokenTest, DroppedSubscriptionIsNotRun) {
+  auto token = base::MakeRefCounted<CancellationToken>();
+  int runs = 0;
+  {
+    base::CallbackListSubscription subscription = token->AddCancelCallback(
+        base::BindOnce([](int* runs) { (*runs)++; }, &runs));
+  }
+
+  token->Cancel();
+  EXPECT_EQ(runs, 0);
+}
+
+TEST(CancellationTokenTest, RecognizesCancellationError) {
+  EXPECT_TRUE(IsCancellationError(kRequestCancelledError));
+  EXPECT_FALSE(IsCancellationError("HTTP error: 503"));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
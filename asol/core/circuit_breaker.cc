@@ -0,0 +1,95 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/circuit_breaker.h"
+
+#include <algorithm>
+
+namespace asol {
+namespace core {
+
+CircuitBreaker::CircuitBreaker(const Config& config)
+    : config_(config), current_open_duration_(config.open_duration) {}
+
+CircuitBreaker::~CircuitBreaker() = default;
+
+bool CircuitBreaker::AllowRequest(base::TimeTicks now) {
+  if (state_ == State::OPEN && now >= open_until_) {
+    state_ = State::HALF_OPEN;
+    probes_in_flight_ = 0;
+  }
+
+  switch (state_) {
+    case State::CLOSED:
+      return true;
+    case State::OPEN:
+      return false;
+    case State::HALF_OPEN:
+      if (probes_in_flight_ >= config_.half_open_max_probes) {
+        return false;
+      }
+      probes_in_flight_++;
+      return true;
+  }
+  return false;
+}
+
+bool CircuitBreaker::IsAvailable(base::TimeTicks now) const {
+  switch (GetState(now)) {
+    case State::CLOSED:
+      return true;
+    case State::OPEN:
+      return false;
+    case State::HALF_OPEN:
+      // Still HALF_OPEN from a previous probe, or just past |open_until_|
+      return state_ == State::OPEN ||
+             probes_in_flight_ < config_.half_open_max_probes;
+  }
+  return false;
+}
+
+void CircuitBreaker::RecordSuccess() {
+  // A late answer to a request sent before the circuit opened says little
+  // about the provider now; only probes may close an open circuit.
+  if (state_ == State::OPEN) {
+    return;
+  }
+  state_ = State::CLOSED;
+  consecutive_failures_ = 0;
+  probes_in_flight_ = 0;
+  current_open_duration_ = config_.open_duration;
+}
+
+void CircuitBreaker::RecordFailure(base::TimeTicks now) {
+  switch (state_) {
+    case State::CLOSED:
+      if (++consecutive_failures_ >= config_.failure_threshold) {
+        Open(now);
+      }
+      return;
+    case State::OPEN:
+      return;
+    case State::HALF_OPEN:
+      current_open_duration_ =
+          std::min(current_open_duration_ * 2, config_.max_open_duration);
+      Open(now);
+      return;
+  }
+}
+
+CircuitBreaker::State CircuitBreaker::GetState(base::TimeTicks now) const {
+  if (state_ == State::OPEN && now >= open_until_) {
+    return State::HALF_OPEN;
+  }
+  return state_;
+}
+
+void CircuitBreaker::Open(base::TimeTicks now) {
+  state_ = State::OPEN;
+  probes_in_flight_ = 0;
+  open_until_ = now + current_open_duration_;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,68 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_CIRCUIT_BREAKER_H_
+#define ASOL_CORE_CIRCUIT_BREAKER_H_
+
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// CircuitBreaker tracks the health of one provider so callers can skip it
+// during an outage instead of waiting out a timeout on every request.
+//
+//   CLOSED     requests flow; |failure_threshold| consecutive failures open
+//              the circuit.
+//   OPEN       requests are refused until |open_duration| has passed.
+//   HALF_OPEN  up to |half_open_max_probes| requests go through as probes.
+//              A successful probe closes the circuit; a failed one reopens
+//              it for twice as long, up to |max_open_duration|.
+//
+// Timeouts are reported as failures. Not thread-safe.
+class CircuitBreaker {
+ public:
+  enum class State {
+    CLOSED,
+    OPEN,
+    HALF_OPEN
+  };
+
+  struct Config {
+    int failure_threshold = 5;
+    base::TimeDelta open_duration = base::Seconds(30);
+    base::TimeDelta max_open_duration = base::Minutes(5);
+    int half_open_max_probes = 1;
+  };
+
+  explicit CircuitBreaker(const Config& config = Config());
+  ~CircuitBreaker();
+
+  // Whether a request may be sent now. In HALF_OPEN this claims a probe
+  // slot, so call it only when the request will actually be sent.
+  bool AllowRequest(base::TimeTicks now);
+
+  // Like AllowRequest() but without claiming a probe slot
+  bool IsAvailable(base::TimeTicks now) const;
+
+  void RecordSuccess();
+  void RecordFailure(base::TimeTicks now);
+
+  State GetState(base::TimeTicks now) const;
+
+ private:
+  void Open(base::TimeTicks now);
+
+  Config config_;
+  State state_ = State::CLOSED;
+  int consecutive_failures_ = 0;
+  int probes_in_flight_ = 0;
+  base::TimeDelta current_open_duration_;
+  base::TimeTicks open_until_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_CIRCUIT_BREAKER_H_
@@ -0,0 +1,89 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/circuit_breaker.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+CircuitBreaker::Config MakeConfig() {
+  CircuitBreaker::Config config;
+  config.failure_threshold = 3;
+  config.open_duration = base::Seconds(10);
+  config.max_open_duration = base::Seconds(25);
+  return config;
+}
+
+TEST(CircuitBreakerTest, OpensAfterConsecutiveFailures) {
+  CircuitBreaker breaker(MakeConfig());
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  breaker.RecordFailure(now);
+  breaker.RecordFailure(now);
+  breaker.RecordSuccess();
+  breaker.RecordFailure(now);
+  breaker.RecordFailure(now);
+  EXPECT_TRUE(breaker.AllowRequest(now));
+
+  breaker.RecordFailure(now);
+  EXPECT_EQ(breaker.GetState(now), CircuitBreaker::State::OPEN);
+  EXPECT_FALSE(breaker.AllowRequest(now));
+  EXPECT_FALSE(breaker.IsAvailable(now));
+}
+
+TEST(CircuitBreakerTest, HalfOpenAllowsOneProbe) {
+  CircuitBreaker breaker(MakeConfig());
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (int i = 0; i < 3; ++i) {
+    breaker.RecordFailure(now);
+  }
+
+  now += base::Seconds(10);
+  EXPECT_EQ(breaker.GetState(now), CircuitBreaker::State::HALF_OPEN);
+  EXPECT_TRUE(breaker.IsAvailable(now));
+  EXPECT_TRUE(breaker.AllowRequest(now));
+  EXPECT_FALSE(breaker.AllowRequest(now));
+
+  breaker.RecordSuccess();
+  EXPECT_EQ(breaker.GetState(now), CircuitBreaker::State::CLOSED);
+  EXPECT_TRUE(breaker.AllowRequest(now));
+}
+
+TEST(CircuitBreakerTest, FailedProbeBacksOff) {
+  CircuitBreaker breaker(MakeConfig());
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (int i = 0; i < 3; ++i) {
+    breaker.RecordFailure(now);
+  }
+
+  now += base::Seconds(10);
+  ASSERT_TRUE(breaker.AllowRequest(now));
+  breaker.RecordFailure(now);
+
+  // Reopened for 20s, then capped at 25s.
+  EXPECT_FALSE(breaker.AllowRequest(now + base::Seconds(19)));
+  now += base::Seconds(20);
+  ASSERT_TRUE(breaker.AllowRequest(now));
+  breaker.RecordFailure(now);
+  EXPECT_FALSE(breaker.AllowRequest(now + base::Seconds(24)));
+  EXPECT_TRUE(breaker.AllowRequest(now + base::Seconds(25)));
+}
+
+TEST(CircuitBreakerTest, LateSuccessDoesNotCloseOpenCircuit) {
+  CircuitBreaker breaker(MakeConfig());
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (int i = 0; i < 3; ++i) {
+    breaker.RecordFailure(now);
+  }
+
+  breaker.RecordSuccess();
+  EXPECT_EQ(breaker.GetState(now), CircuitBreaker::State::OPEN);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
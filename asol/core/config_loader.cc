@@ -4,6 +4,7 @@
 
 #include "asol/core/config_loader.h"
 
+#include "asol/core/startup_trace.h"
 #include "base/files/file_util.h"
 #include "base/logging.h"
 #include "base/path_service.h"
@@ -12,6 +13,7 @@ namespace asol {
 namespace core {
 
 std::string ConfigLoader::LoadFromFile(const base::FilePath& file_path) {
+  ScopedStartupPhase phase("config_load");
   std::string config_json;
   if (!base::ReadFileToString(file_path, &config_json)) {
     LOG(ERROR) << "Failed to read configuration file: " << file_path;
@@ -0,0 +1,958 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/context_manager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+#include "asol/core/ai_service_provider.h"
+#include "asol/core/memory_accountant.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/functional/bind.h"
+#include "base/guid.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/json/values_util.h"
+#include "base/logging.h"
+#include "base/memory/weak_ptr.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/thread_annotations.h"
+#include "base/time/clock.h"
+#include "base/time/default_clock.h"
+#include "base/timer/timer.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Asks the summarizer to fold the oldest messages into the summary. Only
+// the old summary and the folded messages are sent, so the cost of a
+// compaction does not grow with the length of the conversation.
+constexpr char kCompactionInstruction[] =
+    "Update the summary of an ongoing conversation with the messages below. "
+    "Keep facts, decisions, user preferences and open questions; drop "
+    "greetings and repetition. Reply with the updated summary only.";
+
+// A power of two so the shard index is a mask of the ID hash
+constexpr size_t kShardCount = 16;
+
+// Approximate bookkeeping cost of one message and one context
+constexpr size_t kMessageOverheadBytes = 64;
+constexpr size_t kContextOverheadBytes = 256;
+
+// Idle contexts are swept at this interval, or every |idle_ttl| if shorter
+constexpr base::TimeDelta kMaxSweepInterval = base::Minutes(1);
+
+// Spill files are named <context ID>.ctx
+constexpr char kSpillExtension[] = ".ctx";
+constexpr base::FilePath::CharType kSpillFilePattern[] =
+    FILE_PATH_LITERAL("*.ctx");
+
+const char* RoleLabel(ContextMessage::Role role) {
+  switch (role) {
+    case ContextMessage::Role::USER:
+      return "User";
+    case ContextMessage::Role::ASSISTANT:
+      return "Assistant";
+    case ContextMessage::Role::SYSTEM:
+      return "System";
+  }
+  return "User";
+}
+
+}  // namespace
+
+ContextMessage::ContextMessage() = default;
+
+ContextMessage::ContextMessage(Role role,
+                               std::string content,
+                               base::Time timestamp)
+    : role(role),
+      body(base::MakeRefCounted<base::RefCountedString>(std::move(content))),
+      timestamp(timestamp) {}
+
+ContextMessage::ContextMessage(const ContextMessage&) = default;
+ContextMessage& ContextMessage::operator=(const ContextMessage&) = default;
+ContextMessage::ContextMessage(ContextMessage&&) = default;
+ContextMessage& ContextMessage::operator=(ContextMessage&&) = default;
+ContextMessage::~ContextMessage() = default;
+
+std::string_view ContextMessage::content() const {
+  return body ? std::string_view(body->as_string()) : std::string_view();
+}
+
+ContextMessageList::ContextMessageList() = default;
+ContextMessageList::~ContextMessageList() = default;
+
+ConversationContext::ConversationContext()
+    : context_id_(base::GenerateGUID()),
+      messages_(base::MakeRefCounted<ContextMessageList>()),
+      creation_time_(base::Time::Now()),
+      last_update_time_(creation_time_) {}
+
+ConversationContext::~ConversationContext() = default;
+
+void ConversationContext::AddMessage(ContextMessage::Role role,
+                                     const std::string& content) {
+  estimated_tokens_ += ContextManager::EstimateTokens(content);
+  estimated_bytes_ += content.size() + kMessageOverheadBytes;
+  last_update_time_ = base::Time::Now();
+  MutableMessages().emplace_back(role, content, last_update_time_);
+}
+
+const std::vector<ContextMessage>& ConversationContext::GetMessages() const {
+  return messages_->messages();
+}
+
+scoped_refptr<const ContextMessageList> ConversationContext::GetSnapshot()
+    const {
+  return messages_;
+}
+
+const std::string& ConversationContext::GetSummary() const {
+  return summary_;
+}
+
+std::vector<ContextMessage> ConversationContext::GetPromptMessages(
+    size_t token_budget) const {
+  const std::vector<ContextMessage>& messages = messages_->messages();
+  const bool limited = token_budget > 0;
+  size_t remaining = token_budget;
+  auto take = [&](size_t tokens) {
+    if (!limited) {
+      return true;
+    }
+    if (tokens > remaining) {
+      return false;
+    }
+    remaining -= tokens;
+    return true;
+  };
+
+  // The newest message is the one being answered, so it always goes in;
+  // then the summary, then older messages for as long as they fit
+  size_t first_kept = messages.size();
+  if (!messages.empty()) {
+    first_kept--;
+    remaining -= std::min(
+        remaining, ContextManager::EstimateTokens(messages.back().content()));
+  }
+  bool keep_summary =
+      !summary_.empty() && take(ContextManager::EstimateTokens(summary_));
+  while (first_kept > 0 &&
+         take(ContextManager::EstimateTokens(
+             messages[first_kept - 1].content()))) {
+    first_kept--;
+  }
+
+  // Copies share the message text, so this copies no history
+  std::vector<ContextMessage> prompt;
+  prompt.reserve(messages.size() - first_kept + 1);
+  if (keep_summary) {
+    prompt.emplace_back(ContextMessage::Role::SYSTEM,
+                        "Summary of the conversation so far: " + summary_,
+                        creation_time_);
+  }
+  prompt.insert(prompt.end(), messages.begin() + first_kept, messages.end());
+  return prompt;
+}
+
+void ConversationContext::ApplySummary(const std::string& summary,
+                                       size_t folded_message_count) {
+  std::vector<ContextMessage>& messages = MutableMessages();
+  folded_message_count = std::min(folded_message_count, messages.size());
+  for (size_t i = 0; i < folded_message_count; ++i) {
+    estimated_tokens_ -= ContextManager::EstimateTokens(messages[i].content());
+    estimated_bytes_ -= messages[i].content().size() + kMessageOverheadBytes;
+  }
+  messages.erase(messages.begin(), messages.begin() + folded_message_count);
+
+  if (!summary_.empty()) {
+    estimated_tokens_ -= ContextManager::EstimateTokens(summary_);
+  }
+  estimated_bytes_ -= summary_.size();
+  summary_ = summary;
+  estimated_bytes_ += summary_.size();
+  if (!summary_.empty()) {
+    estimated_tokens_ += ContextManager::EstimateTokens(summary_);
+  }
+}
+
+size_t ConversationContext::GetEstimatedTokens() const {
+  return estimated_tokens_;
+}
+
+uint64_t ConversationContext::GetGeneration() const {
+  return generation_;
+}
+
+std::string ConversationContext::GetContextId() const {
+  return context_id_;
+}
+
+base::Time ConversationContext::GetCreationTime() const {
+  return creation_time_;
+}
+
+base::Time ConversationContext::GetLastUpdateTime() const {
+  return last_update_time_;
+}
+
+void ConversationContext::Clear() {
+  // Snapshots keep the old list
+  messages_ = base::MakeRefCounted<ContextMessageList>();
+  summary_.clear();
+  estimated_tokens_ = 0;
+  estimated_bytes_ = 0;
+  generation_++;
+  last_update_time_ = base::Time::Now();
+}
+
+size_t ConversationContext::GetEstimatedBytes() const {
+  return estimated_bytes_ + kContextOverheadBytes;
+}
+
+base::Value::Dict ConversationContext::ToValue() const {
+  base::Value::List messages;
+  for (const ContextMessage& message : messages_->messages()) {
+    base::Value::Dict entry;
+    entry.Set("role", static_cast<int>(message.role));
+    entry.Set("content", message.content());
+    entry.Set("timestamp", base::TimeToValue(message.timestamp));
+    messages.Append(std::move(entry));
+  }
+
+  base::Value::Dict value;
+  value.Set("context_id", context_id_);
+  value.Set("summary", summary_);
+  value.Set("generation", base::NumberToString(generation_));
+  value.Set("creation_time", base::TimeToValue(creation_time_));
+  value.Set("last_update_time", base::TimeToValue(last_update_time_));
+  value.Set("messages", std::move(messages));
+  return value;
+}
+
+// static
+std::unique_ptr<ConversationContext> ConversationContext::FromValue(
+    const base::Value::Dict& value) {
+  const std::string* context_id = value.FindString("context_id");
+  const std::string* summary = value.FindString("summary");
+  const std::string* generation = value.FindString("generation");
+  const base::Value::List* messages = value.FindList("messages");
+  absl::optional<base::Time> creation_time =
+      base::ValueToTime(value.Find("creation_time"));
+  absl::optional<base::Time> last_update_time =
+      base::ValueToTime(value.Find("last_update_time"));
+  auto context = std::make_unique<ConversationContext>();
+  if (!context_id || !summary || !generation || !messages || !creation_time ||
+      !last_update_time ||
+      !base::StringToUint64(*generation, &context->generation_)) {
+    return nullptr;
+  }
+
+  std::vector<ContextMessage>& restored = context->MutableMessages();
+  restored.reserve(messages->size());
+  for (const base::Value& message : *messages) {
+    if (!message.is_dict()) {
+      return nullptr;
+    }
+    absl::optional<int> role = message.GetDict().FindInt("role");
+    const std::string* content = message.GetDict().FindString("content");
+    absl::optional<base::Time> timestamp =
+        base::ValueToTime(message.GetDict().Find("timestamp"));
+    if (!role || *role < static_cast<int>(ContextMessage::Role::USER) ||
+        *role > static_cast<int>(ContextMessage::Role::SYSTEM) || !content ||
+        !timestamp) {
+      return nullptr;
+    }
+    context->estimated_tokens_ += ContextManager::EstimateTokens(*content);
+    context->estimated_bytes_ += content->size() + kMessageOverheadBytes;
+    restored.emplace_back(static_cast<ContextMessage::Role>(*role), *content,
+                          *timestamp);
+  }
+
+  context->context_id_ = *context_id;
+  context->summary_ = *summary;
+  if (!context->summary_.empty()) {
+    context->estimated_tokens_ +=
+        ContextManager::EstimateTokens(context->summary_);
+  }
+  context->estimated_bytes_ += context->summary_.size();
+  context->generation_++;
+  context->creation_time_ = *creation_time;
+  context->last_update_time_ = *last_update_time;
+  return context;
+}
+
+std::vector<ContextMessage>& ConversationContext::MutableMessages() {
+  if (!messages_->HasOneRef()) {
+    // A snapshot holds the list; copy it, sharing the message text
+    auto copy = base::MakeRefCounted<ContextMessageList>();
+    copy->messages_ = messages_->messages_;
+    messages_ = std::move(copy);
+  }
+  return messages_->messages_;
+}
+
+class ContextManager::Impl {
+ public:
+  // Context IDs, most recently used first
+  using LruList = std::list<std::string>;
+
+  struct Entry {
+    std::unique_ptr<ConversationContext> context;
+    LruList::iterator lru_position;
+    base::Time last_access;
+    size_t charge = 0;
+
+    // Nonzero while a summary requested for the context is in flight
+    uint64_t compaction_id = 0;
+  };
+
+  using Index = std::unordered_map<std::string, Entry>;
+
+  struct Shard {
+    base::Lock lock;
+    size_t bytes GUARDED_BY(lock) = 0;
+    LruList lru GUARDED_BY(lock);
+    Index index GUARDED_BY(lock);
+  };
+
+  // A compaction decided under a shard lock and started after releasing it
+  struct PendingCompaction {
+    std::string context_id;
+    uint64_t compaction_id = 0;
+    uint64_t generation = 0;
+    size_t folded_message_count = 0;
+    std::string summary;
+    scoped_refptr<const ContextMessageList> messages;
+  };
+
+  explicit Impl(const Options& options);
+
+  Shard& GetShard(const std::string& context_id);
+
+  // Find a context, restoring it if it was spilled, and mark it used. Null
+  // if unknown or idle past the TTL.
+  Entry* FindLocked(Shard& shard, const std::string& context_id)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.lock);
+  Entry& InsertLocked(Shard& shard,
+                      std::unique_ptr<ConversationContext> context)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.lock);
+  void RemoveLocked(Shard& shard, Index::iterator it)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.lock);
+
+  // Re-measure |entry| after its context changed
+  void UpdateChargeLocked(Shard& shard, Entry& entry)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.lock);
+
+  // Evict the coldest contexts until the shard fits its share of
+  // |max_bytes|, or |byte_capacity|. The most recently used one stays even
+  // if it alone does not.
+  void EvictForSpaceLocked(Shard& shard) EXCLUSIVE_LOCKS_REQUIRED(shard.lock);
+  void EvictForSpaceLocked(Shard& shard, size_t byte_capacity)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.lock);
+
+  // Spill or drop the coldest contexts: down to half of each shard's share
+  // on moderate pressure, to the most recently used one on critical
+  void OnMemoryPressure(MemoryAccount::PressureLevel level);
+
+  // Adjust the totals reported to |memory_account| by a context of
+  // |charge| bytes coming or going
+  void AccountLocked(ptrdiff_t charge, ptrdiff_t count);
+
+  bool IsIdle(const Entry& entry, base::Time now) const;
+
+  // If |entry| outgrew the policy and no compaction of it is running, mark
+  // it compacting and describe the request in |pending|.
+  bool PrepareCompactionLocked(Shard& shard,
+                               Entry& entry,
+                               PendingCompaction* pending)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.lock);
+
+  // Ask the summarizer to fold the messages in |pending|, on the owning
+  // sequence.
+  void StartCompaction(PendingCompaction pending);
+  void SendSummaryRequest(const std::string& context_id,
+                          uint64_t compaction_id,
+                          uint64_t generation,
+                          size_t folded_message_count,
+                          std::string input);
+  void OnSummary(const std::string& context_id,
+                 uint64_t compaction_id,
+                 uint64_t generation,
+                 size_t folded_message_count,
+                 bool success,
+                 const std::string& response);
+
+  // Spill file of |context_id|, or an empty path if spilling is disabled or
+  // the ID is not one this manager could have generated
+  base::FilePath GetSpillPath(const std::string& context_id) const;
+  bool Spill(const ConversationContext& context);
+  std::unique_ptr<ConversationContext> Restore(const std::string& context_id);
+  void DeleteSpillFiles(bool idle_only);
+
+  const Options options;
+  const size_t shard_byte_capacity;
+  const base::Clock* clock;
+  scoped_refptr<base::SequencedTaskRunner> owner_task_runner;
+  Shard shards[kShardCount];
+
+  ContextCompactionPolicy policy;
+  AIServiceProvider* summarizer = nullptr;
+  std::atomic<uint64_t> next_compaction_id{1};
+
+  std::atomic<size_t> compactions{0};
+  std::atomic<size_t> failed_compactions{0};
+  std::atomic<size_t> messages_folded{0};
+  std::atomic<size_t> expired{0};
+  std::atomic<size_t> evicted_for_space{0};
+  std::atomic<size_t> spilled{0};
+  std::atomic<size_t> restored{0};
+
+  base::RepeatingTimer sweep_timer;
+
+  // Across all shards, for |memory_account|
+  std::atomic<size_t> resident_bytes{0};
+  std::atomic<size_t> resident_count{0};
+
+  base::WeakPtrFactory<Impl> weak_ptr_factory{this};
+
+  // Bound on the owning sequence and copied to other threads, which may
+  // post with it but not dereference it
+  base::WeakPtr<Impl> weak_this;
+
+  // Reports "conversation_contexts". Last, so it unregisters before the
+  // shards its pressure callback trims go.
+  MemoryAccount memory_account;
+};
+
+ContextManager::Impl::Impl(const Options& options)
+    : options(options),
+      shard_byte_capacity(options.max_bytes / kShardCount),
+      clock(base::DefaultClock::GetInstance()),
+      owner_task_runner(base::SequencedTaskRunner::GetCurrentDefault()),
+      weak_this(weak_ptr_factory.GetWeakPtr()),
+      memory_account("conversation_contexts",
+                     base::BindRepeating(&Impl::OnMemoryPressure,
+                                         base::Unretained(this))) {}
+
+ContextManager::Impl::Shard& ContextManager::Impl::GetShard(
+    const std::string& context_id) {
+  return shards[std::hash<std::string>()(context_id) & (kShardCount - 1)];
+}
+
+ContextManager::Impl::Entry* ContextManager::Impl::FindLocked(
+    Shard& shard,
+    const std::string& context_id) {
+  auto it = shard.index.find(context_id);
+  if (it == shard.index.end()) {
+    std::unique_ptr<ConversationContext> context = Restore(context_id);
+    if (!context) {
+      return nullptr;
+    }
+    restored.fetch_add(1, std::memory_order_relaxed);
+    Entry& entry = InsertLocked(shard, std::move(context));
+    EvictForSpaceLocked(shard);
+    return &entry;
+  }
+
+  base::Time now = clock->Now();
+  if (IsIdle(it->second, now)) {
+    RemoveLocked(shard, it);
+    expired.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru_position);
+  it->second.last_access = now;
+  return &it->second;
+}
+
+ContextManager::Impl::Entry& ContextManager::Impl::InsertLocked(
+    Shard& shard,
+    std::unique_ptr<ConversationContext> context) {
+  std::string context_id = context->GetContextId();
+  shard.lru.push_front(context_id);
+  Entry& entry = shard.index[std::move(context_id)];
+  entry.lru_position = shard.lru.begin();
+  entry.last_access = clock->Now();
+  entry.charge = context->GetEstimatedBytes();
+  entry.context = std::move(context);
+  shard.bytes += entry.charge;
+  AccountLocked(entry.charge, 1);
+  return entry;
+}
+
+void ContextManager::Impl::RemoveLocked(Shard& shard, Index::iterator it) {
+  shard.bytes -= it->second.charge;
+  AccountLocked(-static_cast<ptrdiff_t>(it->second.charge), -1);
+  shard.lru.erase(it->second.lru_position);
+  shard.index.erase(it);
+}
+
+void ContextManager::Impl::UpdateChargeLocked(Shard& shard, Entry& entry) {
+  size_t old_charge = entry.charge;
+  shard.bytes -= entry.charge;
+  entry.charge = entry.context->GetEstimatedBytes();
+  shard.bytes += entry.charge;
+  AccountLocked(static_cast<ptrdiff_t>(entry.charge) -
+                    static_cast<ptrdiff_t>(old_charge),
+                0);
+}
+
+void ContextManager::Impl::AccountLocked(ptrdiff_t charge, ptrdiff_t count) {
+  // Wraps back on the matching subtraction, so unsigned addition suffices
+  size_t bytes = resident_bytes.fetch_add(static_cast<size_t>(charge),
+                                          std::memory_order_relaxed) +
+                 static_cast<size_t>(charge);
+  size_t contexts = resident_count.fetch_add(static_cast<size_t>(count),
+                                             std::memory_order_relaxed) +
+                    static_cast<size_t>(count);
+  memory_account.Update(bytes, contexts);
+}
+
+void ContextManager::Impl::OnMemoryPressure(
+    MemoryAccount::PressureLevel level) {
+  bool critical =
+      level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL;
+  for (Shard& shard : shards) {
+    base::AutoLock lock(shard.lock);
+    size_t share = shard_byte_capacity ? shard_byte_capacity : shard.bytes;
+    EvictForSpaceLocked(shard, critical ? 0 : share / 2);
+  }
+}
+
+void ContextManager::Impl::EvictForSpaceLocked(Shard& shard) {
+  if (shard_byte_capacity == 0) {
+    return;
+  }
+  EvictForSpaceLocked(shard, shard_byte_capacity);
+}
+
+void ContextManager::Impl::EvictForSpaceLocked(Shard& shard,
+                                               size_t byte_capacity) {
+  while (shard.bytes > byte_capacity && shard.lru.size() > 1) {
+    auto it = shard.index.find(shard.lru.back());
+    if (Spill(*it->second.context)) {
+      spilled.fetch_add(1, std::memory_order_relaxed);
+    }
+    RemoveLocked(shard, it);
+    evicted_for_space.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+bool ContextManager::Impl::IsIdle(const Entry& entry, base::Time now) const {
+  return options.idle_ttl.is_positive() &&
+         now - entry.last_access > options.idle_ttl;
+}
+
+bool ContextManager::Impl::PrepareCompactionLocked(
+    Shard& shard,
+    Entry& entry,
+    PendingCompaction* pending) {
+  if (!summarizer || policy.token_budget == 0) {
+    return false;
+  }
+  if (entry.compaction_id != 0) {
+    return false;  // Messages added meanwhile are folded by the next compaction
+  }
+  const ConversationContext& context = *entry.context;
+  size_t message_count = context.GetMessages().size();
+  if (message_count <= policy.recent_messages ||
+      context.GetEstimatedTokens() <=
+          policy.token_budget * policy.compaction_threshold) {
+    return false;
+  }
+
+  entry.compaction_id =
+      next_compaction_id.fetch_add(1, std::memory_order_relaxed);
+  pending->context_id = context.GetContextId();
+  pending->compaction_id = entry.compaction_id;
+  pending->generation = context.GetGeneration();
+  pending->folded_message_count = message_count - policy.recent_messages;
+  pending->summary = context.GetSummary();
+  pending->messages = context.GetSnapshot();
+  return true;
+}
+
+void ContextManager::Impl::StartCompaction(PendingCompaction pending) {
+  // Built from the snapshot, outside the shard lock
+  const std::vector<ContextMessage>& messages = pending.messages->messages();
+  std::string input = kCompactionInstruction;
+  if (!pending.summary.empty()) {
+    input += "\n\nCurrent summary:\n" + pending.summary;
+  }
+  input += "\n\nMessages:\n";
+  for (size_t i = 0; i < pending.folded_message_count; ++i) {
+    input += RoleLabel(messages[i].role);
+    input += ": ";
+    input += messages[i].content();
+    input += "\n";
+  }
+
+  if (owner_task_runner->RunsTasksInCurrentSequence()) {
+    SendSummaryRequest(pending.context_id, pending.compaction_id,
+                       pending.generation, pending.folded_message_count,
+                       std::move(input));
+    return;
+  }
+  owner_task_runner->PostTask(
+      FROM_HERE,
+      base::BindOnce(&Impl::SendSummaryRequest, weak_this, pending.context_id,
+                     pending.compaction_id, pending.generation,
+                     pending.folded_message_count, std::move(input)));
+}
+
+void ContextManager::Impl::SendSummaryRequest(const std::string& context_id,
+                                              uint64_t compaction_id,
+                                              uint64_t generation,
+                                              size_t folded_message_count,
+                                              std::string input) {
+  AIServiceProvider::AIRequestParams params;
+  params.task_type = AIServiceProvider::TaskType::TEXT_SUMMARIZATION;
+  params.input_text = std::move(input);
+  summarizer->ProcessRequest(
+      params, base::BindOnce(&Impl::OnSummary, weak_this, context_id,
+                             compaction_id, generation, folded_message_count));
+}
+
+void ContextManager::Impl::OnSummary(const std::string& context_id,
+                                     uint64_t compaction_id,
+                                     uint64_t generation,
+                                     size_t folded_message_count,
+                                     bool success,
+                                     const std::string& response) {
+  PendingCompaction next;
+  bool compact_again = false;
+  {
+    Shard& shard = GetShard(context_id);
+    base::AutoLock lock(shard.lock);
+    auto it = shard.index.find(context_id);
+    if (it == shard.index.end() || it->second.compaction_id != compaction_id) {
+      return;  // Deleted, evicted or cleared while the summarizer ran
+    }
+    Entry& entry = it->second;
+    entry.compaction_id = 0;
+    if (entry.context->GetGeneration() != generation) {
+      return;
+    }
+    if (!success || response.empty()) {
+      // Left verbatim; the next message added retries
+      failed_compactions.fetch_add(1, std::memory_order_relaxed);
+      LOG(WARNING) << "Failed to compact context " << context_id << ": "
+                   << response;
+      return;
+    }
+
+    entry.context->ApplySummary(response, folded_message_count);
+    UpdateChargeLocked(shard, entry);
+    compactions.fetch_add(1, std::memory_order_relaxed);
+    messages_folded.fetch_add(folded_message_count, std::memory_order_relaxed);
+    DVLOG(1) << "Folded " << folded_message_count << " messages of context "
+             << context_id << " into its summary";
+
+    // Turns that arrived while the summarizer ran may call for another pass
+    compact_again = PrepareCompactionLocked(shard, entry, &next);
+  }
+  if (compact_again) {
+    StartCompaction(std::move(next));
+  }
+}
+
+base::FilePath ContextManager::Impl::GetSpillPath(
+    const std::string& context_id) const {
+  if (options.spill_directory.empty() || !base::IsValidGUID(context_id)) {
+    return base::FilePath();
+  }
+  return options.spill_directory.AppendASCII(context_id + kSpillExtension);
+}
+
+bool ContextManager::Impl::Spill(const ConversationContext& context) {
+  base::FilePath path = GetSpillPath(context.GetContextId());
+  if (path.empty()) {
+    return false;
+  }
+  std::string json_string;
+  if (!base::CreateDirectory(options.spill_directory) ||
+      !base::JSONWriter::Write(context.ToValue(), &json_string) ||
+      base::WriteFile(path, json_string.data(), json_string.size()) == -1) {
+    LOG(ERROR) << "Failed to spill context " << context.GetContextId();
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<ConversationContext> ContextManager::Impl::Restore(
+    const std::string& context_id) {
+  base::FilePath path = GetSpillPath(context_id);
+  base::File::Info info;
+  if (path.empty() || !base::GetFileInfo(path, &info)) {
+    return nullptr;
+  }
+
+  // Files are only swept periodically; one past the TTL is already gone
+  std::string json_string;
+  std::unique_ptr<ConversationContext> context;
+  if (!options.idle_ttl.is_positive() ||
+      clock->Now() - info.last_modified <= options.idle_ttl) {
+    if (base::ReadFileToString(path, &json_string)) {
+      absl::optional<base::Value> value = base::JSONReader::Read(json_string);
+      if (value && value->is_dict()) {
+        context = ConversationContext::FromValue(value->GetDict());
+      }
+    }
+    if (!context || context->GetContextId() != context_id) {
+      LOG(ERROR) << "Failed to restore spilled context " << context_id;
+      context.reset();
+    }
+  }
+  base::DeleteFile(path);
+  return context;
+}
+
+void ContextManager::Impl::DeleteSpillFiles(bool idle_only) {
+  if (options.spill_directory.empty()) {
+    return;
+  }
+  base::Time now = clock->Now();
+  base::FileEnumerator enumerator(options.spill_directory,
+                                  /*recursive=*/false,
+                                  base::FileEnumerator::FILES,
+                                  kSpillFilePattern);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    if (idle_only &&
+        now - enumerator.GetInfo().GetLastModifiedTime() <= options.idle_ttl) {
+      continue;
+    }
+    base::DeleteFile(path);
+    if (idle_only) {
+      expired.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+ContextManager::ContextManager() : ContextManager(Options()) {}
+
+ContextManager::ContextManager(const Options& options)
+    : impl_(std::make_unique<Impl>(options)) {
+  if (options.idle_ttl.is_positive()) {
+    impl_->sweep_timer.Start(
+        FROM_HERE, std::min(options.idle_ttl, kMaxSweepInterval),
+        base::BindRepeating(&ContextManager::EvictIdleContexts,
+                            base::Unretained(this)));
+  }
+}
+
+ContextManager::~ContextManager() = default;
+
+std::string ContextManager::CreateContext() {
+  auto context = std::make_unique<ConversationContext>();
+  std::string context_id = context->GetContextId();
+  Impl::Shard& shard = impl_->GetShard(context_id);
+  base::AutoLock lock(shard.lock);
+  impl_->InsertLocked(shard, std::move(context));
+  impl_->EvictForSpaceLocked(shard);
+  return context_id;
+}
+
+bool ContextManager::HasContext(const std::string& context_id) {
+  Impl::Shard& shard = impl_->GetShard(context_id);
+  base::AutoLock lock(shard.lock);
+  return impl_->FindLocked(shard, context_id) != nullptr;
+}
+
+void ContextManager::DeleteContext(const std::string& context_id) {
+  Impl::Shard& shard = impl_->GetShard(context_id);
+  base::AutoLock lock(shard.lock);
+  auto it = shard.index.find(context_id);
+  if (it != shard.index.end()) {
+    impl_->RemoveLocked(shard, it);
+    return;
+  }
+  base::FilePath path = impl_->GetSpillPath(context_id);
+  if (!path.empty()) {
+    base::DeleteFile(path);
+  }
+}
+
+void ContextManager::ClearContext(const std::string& context_id) {
+  Impl::Shard& shard = impl_->GetShard(context_id);
+  base::AutoLock lock(shard.lock);
+  Impl::Entry* entry = impl_->FindLocked(shard, context_id);
+  if (!entry) {
+    return;
+  }
+  entry->context->Clear();
+  entry->compaction_id = 0;  // A summary of the old messages is dropped
+  impl_->UpdateChargeLocked(shard, *entry);
+}
+
+void ContextManager::AddMessage(const std::string& context_id,
+                                ContextMessage::Role role,
+                                const std::string& content) {
+  Impl::PendingCompaction pending;
+  bool compact = false;
+  {
+    Impl::Shard& shard = impl_->GetShard(context_id);
+    base::AutoLock lock(shard.lock);
+    Impl::Entry* entry = impl_->FindLocked(shard, context_id);
+    if (!entry) {
+      LOG(ERROR) << "Unknown context: " << context_id;
+      return;
+    }
+    entry->context->AddMessage(role, content);
+    impl_->UpdateChargeLocked(shard, *entry);
+    compact = impl_->PrepareCompactionLocked(shard, *entry, &pending);
+    impl_->EvictForSpaceLocked(shard);
+  }
+  if (compact) {
+    impl_->StartCompaction(std::move(pending));
+  }
+}
+
+scoped_refptr<const ContextMessageList> ContextManager::GetSnapshot(
+    const std::string& context_id) {
+  Impl::Shard& shard = impl_->GetShard(context_id);
+  base::AutoLock lock(shard.lock);
+  Impl::Entry* entry = impl_->FindLocked(shard, context_id);
+  return entry ? entry->context->GetSnapshot() : nullptr;
+}
+
+std::string ContextManager::GetSummary(const std::string& context_id) {
+  Impl::Shard& shard = impl_->GetShard(context_id);
+  base::AutoLock lock(shard.lock);
+  Impl::Entry* entry = impl_->FindLocked(shard, context_id);
+  return entry ? entry->context->GetSummary() : std::string();
+}
+
+void ContextManager::SetCompactionPolicy(const ContextCompactionPolicy& policy,
+                                         AIServiceProvider* summarizer) {
+  impl_->policy = policy;
+  impl_->summarizer = summarizer;
+
+  std::vector<Impl::PendingCompaction> pending;
+  for (Impl::Shard& shard : impl_->shards) {
+    base::AutoLock lock(shard.lock);
+    for (auto& [context_id, entry] : shard.index) {
+      Impl::PendingCompaction compaction;
+      if (impl_->PrepareCompactionLocked(shard, entry, &compaction)) {
+        pending.push_back(std::move(compaction));
+      }
+    }
+  }
+  for (Impl::PendingCompaction& compaction : pending) {
+    impl_->StartCompaction(std::move(compaction));
+  }
+}
+
+std::vector<ContextMessage> ContextManager::GetPromptMessages(
+    const std::string& context_id) {
+  Impl::Shard& shard = impl_->GetShard(context_id);
+  base::AutoLock lock(shard.lock);
+  Impl::Entry* entry = impl_->FindLocked(shard, context_id);
+  if (!entry) {
+    return {};
+  }
+  return entry->context->GetPromptMessages(impl_->policy.token_budget);
+}
+
+void ContextManager::EvictIdleContexts() {
+  if (!impl_->options.idle_ttl.is_positive()) {
+    return;
+  }
+  base::Time now = impl_->clock->Now();
+  for (Impl::Shard& shard : impl_->shards) {
+    base::AutoLock lock(shard.lock);
+    // The list is in order of last use, so idle contexts are at its tail
+    while (!shard.lru.empty()) {
+      auto it = shard.index.find(shard.lru.back());
+      if (!impl_->IsIdle(it->second, now)) {
+        break;
+      }
+      impl_->RemoveLocked(shard, it);
+      impl_->expired.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  impl_->DeleteSpillFiles(/*idle_only=*/true);
+}
+
+ContextManager::CompactionStats ContextManager::GetCompactionStats() const {
+  CompactionStats stats;
+  stats.compactions = impl_->compactions.load(std::memory_order_relaxed);
+  stats.failed = impl_->failed_compactions.load(std::memory_order_relaxed);
+  stats.messages_folded =
+      impl_->messages_folded.load(std::memory_order_relaxed);
+  return stats;
+}
+
+ContextManager::EvictionStats ContextManager::GetEvictionStats() const {
+  EvictionStats stats;
+  stats.expired = impl_->expired.load(std::memory_order_relaxed);
+  stats.evicted_for_space =
+      impl_->evicted_for_space.load(std::memory_order_relaxed);
+  stats.spilled = impl_->spilled.load(std::memory_order_relaxed);
+  stats.restored = impl_->restored.load(std::memory_order_relaxed);
+  return stats;
+}
+
+size_t ContextManager::GetResidentContextCount() const {
+  size_t count = 0;
+  for (Impl::Shard& shard : impl_->shards) {
+    base::AutoLock lock(shard.lock);
+    count += shard.index.size();
+  }
+  return count;
+}
+
+size_t ContextManager::GetResidentBytes() const {
+  size_t bytes = 0;
+  for (Impl::Shard& shard : impl_->shards) {
+    base::AutoLock lock(shard.lock);
+    bytes += shard.bytes;
+  }
+  return bytes;
+}
+
+std::vector<std::string> ContextManager::GetAllContextIds() const {
+  std::vector<std::string> context_ids;
+  for (Impl::Shard& shard : impl_->shards) {
+    base::AutoLock lock(shard.lock);
+    context_ids.insert(context_ids.end(), shard.lru.begin(), shard.lru.end());
+  }
+  return context_ids;
+}
+
+void ContextManager::ClearAllContexts() {
+  for (Impl::Shard& shard : impl_->shards) {
+    base::AutoLock lock(shard.lock);
+    impl_->AccountLocked(-static_cast<ptrdiff_t>(shard.bytes),
+                         -static_cast<ptrdiff_t>(shard.index.size()));
+    shard.index.clear();
+    shard.lru.clear();
+    shard.bytes = 0;
+  }
+  impl_->DeleteSpillFiles(/*idle_only=*/false);
+}
+
+void ContextManager::SetClockForTesting(const base::Clock* clock) {
+  impl_->clock = clock;
+}
+
+// static
+size_t ContextManager::EstimateTokens(std::string_view text) {
+  return text.size() / 4 + 1;
+}
+
+}  // namespace core
+}  // namespace asol
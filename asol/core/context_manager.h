@@ -5,17 +5,33 @@
 #ifndef ASOL_CORE_CONTEXT_MANAGER_H_
 #define ASOL_CORE_CONTEXT_MANAGER_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/time/time.h"
+#include "base/values.h"
+
+namespace base {
+class Clock;
+}
 
 namespace asol {
 namespace core {
 
-// Represents a message in a conversation context
+class AIServiceProvider;
+
+// Represents a message in a conversation context. The text is immutable
+// and shared by every copy, so copying a message, or a list of them,
+// copies a pointer rather than the text.
 struct ContextMessage {
   enum class Role {
     USER,
@@ -23,11 +39,45 @@ struct ContextMessage {
     SYSTEM
   };
 
-  Role role;
-  std::string content;
+  ContextMessage();
+  ContextMessage(Role role, std::string content, base::Time timestamp);
+  ContextMessage(const ContextMessage&);
+  ContextMessage& operator=(const ContextMessage&);
+  ContextMessage(ContextMessage&&);
+  ContextMessage& operator=(ContextMessage&&);
+  ~ContextMessage();
+
+  // The text, valid for as long as any copy of the message is alive
+  std::string_view content() const;
+
+  Role role = Role::USER;
+  scoped_refptr<const base::RefCountedString> body;
   base::Time timestamp;
 };
 
+// The messages of a context at one point in time. A request holds one
+// while in flight instead of copying the history; if the context changes
+// meanwhile, it copies its list of messages, not their text, and leaves
+// the snapshot as it was.
+class ContextMessageList
+    : public base::RefCountedThreadSafe<ContextMessageList> {
+ public:
+  ContextMessageList();
+
+  ContextMessageList(const ContextMessageList&) = delete;
+  ContextMessageList& operator=(const ContextMessageList&) = delete;
+
+  const std::vector<ContextMessage>& messages() const { return messages_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<ContextMessageList>;
+  friend class ConversationContext;
+
+  ~ContextMessageList();
+
+  std::vector<ContextMessage> messages_;
+};
+
 // Represents a conversation context
 class ConversationContext {
  public:
@@ -37,9 +87,33 @@ class ConversationContext {
   // Add a message to the context
   void AddMessage(ContextMessage::Role role, const std::string& content);
 
-  // Get all messages in the context
+  // Get the messages not yet folded into the summary
   const std::vector<ContextMessage>& GetMessages() const;
 
+  // Get the same messages as a snapshot that later changes to the context
+  // do not affect
+  scoped_refptr<const ContextMessageList> GetSnapshot() const;
+
+  // Get the rolling summary of the messages folded out of GetMessages(),
+  // or an empty string if none were
+  const std::string& GetSummary() const;
+
+  // Get what to send with a request: the summary as a SYSTEM message, then
+  // as many of the newest messages as fit in |token_budget| estimated
+  // tokens (0 for no limit). The newest message is always included.
+  std::vector<ContextMessage> GetPromptMessages(size_t token_budget) const;
+
+  // Replace the summary with |summary|, which covers the old one and the
+  // first |folded_message_count| messages, and drop those messages.
+  void ApplySummary(const std::string& summary, size_t folded_message_count);
+
+  // Estimated tokens of the summary and the messages
+  size_t GetEstimatedTokens() const;
+
+  // Incremented by Clear(), so a summary requested before it is not applied
+  // after it
+  uint64_t GetGeneration() const;
+
   // Get the context ID
   std::string GetContextId() const;
 
@@ -52,39 +126,161 @@ class ConversationContext {
   // Clear the context
   void Clear();
 
+  // Rough memory footprint of the summary and messages, used to bound the
+  // contexts a ContextManager keeps resident
+  size_t GetEstimatedBytes() const;
+
+  // Serialize the context for spilling to disk
+  base::Value::Dict ToValue() const;
+
+  // Restore a context written by ToValue(), or null if |value| is malformed.
+  // The generation is advanced, so a summary requested before the context
+  // was spilled is not applied to it.
+  static std::unique_ptr<ConversationContext> FromValue(
+      const base::Value::Dict& value);
+
  private:
+  // The messages for modification, copied first if a snapshot shares them
+  std::vector<ContextMessage>& MutableMessages();
+
   std::string context_id_;
-  std::vector<ContextMessage> messages_;
+  scoped_refptr<ContextMessageList> messages_;
+  std::string summary_;
+  size_t estimated_tokens_ = 0;
+  size_t estimated_bytes_ = 0;
+  uint64_t generation_ = 0;
   base::Time creation_time_;
   base::Time last_update_time_;
 };
 
-// Manages conversation contexts for AI interactions
+// Bounds how much history a context sends with each request. Once a
+// context outgrows |compaction_threshold| of |token_budget|, its oldest
+// messages are folded into a rolling summary by a summarizer provider,
+// ideally a small, cheap model. Compaction runs in the background; until
+// it lands, GetPromptMessages() trims the oldest messages instead, so the
+// prompt never exceeds the budget.
+struct ContextCompactionPolicy {
+  // Estimated tokens (about four bytes per token) the summary and messages
+  // sent with a request may take; 0 for no limit and no compaction
+  size_t token_budget = 0;
+
+  // Newest messages never folded into the summary
+  size_t recent_messages = 8;
+
+  // Share of |token_budget| at which compaction starts, leaving headroom
+  // for the turns that arrive while the summarizer runs
+  double compaction_threshold = 0.75;
+};
+
+// Manages conversation contexts for AI interactions.
+//
+// Contexts are spread over independently locked shards, so requests on
+// different conversations only contend when their IDs land on the same
+// shard. Each shard keeps its contexts in least-recently-used order.
+// Contexts unused for longer than |idle_ttl| are dropped by a periodic
+// sweep, or when a lookup runs into them, and a shard over its share of
+// |max_bytes| evicts its coldest contexts. With a |spill_directory|, those
+// are written to disk instead and read back the next time they are used.
+// Resident contexts are reported to the MemoryAccountant as
+// "conversation_contexts", and memory pressure evicts the coldest the same
+// way.
+//
+// Every method other than the constructor, the destructor and
+// SetCompactionPolicy() is safe to call from any thread. Summaries are
+// requested and applied on the sequence the manager was created on.
 class ContextManager {
  public:
+  struct Options {
+    // Contexts unused for this long are dropped, along with their spill
+    // files; zero keeps them until deleted
+    base::TimeDelta idle_ttl = base::Hours(1);
+
+    // Upper bound on the estimated bytes of resident contexts; zero for no
+    // limit
+    size_t max_bytes = 256 * 1024 * 1024;
+
+    // Where contexts evicted for space are spilled; empty to drop them.
+    // Spilling and restoring perform blocking file IO on the calling thread.
+    base::FilePath spill_directory;
+  };
+
   ContextManager();
+  explicit ContextManager(const Options& options);
   ~ContextManager();
 
+  ContextManager(const ContextManager&) = delete;
+  ContextManager& operator=(const ContextManager&) = delete;
+
   // Create a new context
   std::string CreateContext();
 
-  // Get a context by ID
-  ConversationContext* GetContext(const std::string& context_id);
+  // Whether the context is resident or spilled
+  bool HasContext(const std::string& context_id);
 
   // Delete a context
   void DeleteContext(const std::string& context_id);
 
-  // Add a message to a context
+  // Drop the messages and summary of a context but keep its ID
+  void ClearContext(const std::string& context_id);
+
+  // Add a message to a context, compacting it if it outgrew the policy
   void AddMessage(const std::string& context_id, 
                  ContextMessage::Role role, 
                  const std::string& content);
 
-  // Get all context IDs
+  // Get the messages of a context not yet folded into its summary, or null
+  // for an unknown context
+  scoped_refptr<const ContextMessageList> GetSnapshot(
+      const std::string& context_id);
+
+  // Get the rolling summary of a context, or an empty string
+  std::string GetSummary(const std::string& context_id);
+
+  // Bound every context by |policy|, summarizing with |summarizer|, which
+  // must outlive this manager. Without a summarizer, contexts are only
+  // trimmed when read. Call on the owning sequence while no other thread
+  // uses the manager.
+  void SetCompactionPolicy(const ContextCompactionPolicy& policy,
+                           AIServiceProvider* summarizer);
+
+  // Get the summary and messages to send with a request on a context,
+  // within the policy's token budget. Empty for an unknown context.
+  std::vector<ContextMessage> GetPromptMessages(const std::string& context_id);
+
+  // Drop contexts and spill files idle for longer than |idle_ttl|. Runs
+  // periodically on the owning sequence; exposed for tests.
+  void EvictIdleContexts();
+
+  struct CompactionStats {
+    size_t compactions = 0;
+    size_t failed = 0;
+    size_t messages_folded = 0;
+  };
+  CompactionStats GetCompactionStats() const;
+
+  struct EvictionStats {
+    size_t expired = 0;
+    size_t evicted_for_space = 0;
+    size_t spilled = 0;
+    size_t restored = 0;
+  };
+  EvictionStats GetEvictionStats() const;
+
+  // Number and estimated bytes of the contexts held in memory
+  size_t GetResidentContextCount() const;
+  size_t GetResidentBytes() const;
+
+  // Rough token estimate used for budgeting (about four bytes per token)
+  static size_t EstimateTokens(std::string_view text);
+
+  // Get the IDs of the contexts held in memory
   std::vector<std::string> GetAllContextIds() const;
 
-  // Clear all contexts
+  // Clear all contexts, including spilled ones
   void ClearAllContexts();
 
+  void SetClockForTesting(const base::Clock* clock);
+
  private:
   // Private implementation
   class Impl;
@@ -0,0 +1,329 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/context_manager.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asol/core/ai_service_provider.h"
+#include "base/files/file_util.h"
+#include "base/functional/bind.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/simple_test_clock.h"
+#include "base/test/task_environment.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+// Summarizer that holds requests until the test answers them.
+class FakeSummarizer : public AIServiceProvider {
+ public:
+  std::string GetProviderId() const override { return "summarizer"; }
+  std::string GetProviderName() const override { return "Summarizer"; }
+  std::string GetProviderVersion() const override { return "1.0"; }
+  Capabilities GetCapabilities() const override { return Capabilities(); }
+  bool SupportsTaskType(TaskType task_type) const override { return true; }
+  void ProcessRequest(const AIRequestParams& params,
+                      AIResponseCallback callback) override {
+    inputs_.emplace_back(params.input_text);
+    callbacks_.push_back(std::move(callback));
+  }
+  void Configure(
+      const std::unordered_map<std::string, std::string>& config) override {}
+  std::unordered_map<std::string, std::string> GetConfiguration()
+      const override {
+    return {};
+  }
+
+  size_t pending() const { return callbacks_.size(); }
+  const std::vector<std::string>& inputs() const { return inputs_; }
+
+  void Answer(bool success, const std::string& response) {
+    AIResponseCallback callback = std::move(callbacks_.front());
+    callbacks_.erase(callbacks_.begin());
+    std::move(callback).Run(success, response);
+  }
+
+ private:
+  std::vector<std::string> inputs_;
+  std::vector<AIResponseCallback> callbacks_;
+};
+
+class ContextManagerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ContextCompactionPolicy policy;
+    policy.token_budget = 100;
+    policy.recent_messages = 2;
+    policy.compaction_threshold = 0.5;
+    manager_.SetCompactionPolicy(policy, &summarizer_);
+    context_id_ = manager_.CreateContext();
+  }
+
+  // A message of about |tokens| estimated tokens
+  void AddMessage(char fill, size_t tokens) {
+    manager_.AddMessage(context_id_, ContextMessage::Role::USER,
+                        std::string((tokens - 1) * 4, fill));
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  FakeSummarizer summarizer_;
+  ContextManager manager_;
+  std::string context_id_;
+};
+
+TEST_F(ContextManagerTest, SmallContextIsNotCompacted) {
+  AddMessage('a', 20);
+  AddMessage('b', 20);
+  AddMessage('c', 5);
+
+  EXPECT_EQ(summarizer_.pending(), 0u);
+  EXPECT_EQ(manager_.GetPromptMessages(context_id_).size(), 3u);
+}
+
+TEST_F(ContextManagerTest, FoldsOldMessagesIntoSummary) {
+  AddMessage('a', 20);
+  AddMessage('b', 20);
+  AddMessage('c', 20);
+  ASSERT_EQ(summarizer_.pending(), 1u);
+  EXPECT_NE(summarizer_.inputs()[0].find(std::string(76, 'a')),
+            std::string::npos);
+  EXPECT_EQ(summarizer_.inputs()[0].find(std::string(76, 'b')),
+            std::string::npos);
+
+  // A turn that arrives meanwhile is kept, and does not start another pass
+  AddMessage('d', 5);
+  EXPECT_EQ(summarizer_.pending(), 1u);
+
+  summarizer_.Answer(true, "summary of a");
+  EXPECT_EQ(manager_.GetSummary(context_id_), "summary of a");
+  scoped_refptr<const ContextMessageList> messages =
+      manager_.GetSnapshot(context_id_);
+  ASSERT_EQ(messages->messages().size(), 3u);
+  EXPECT_EQ(messages->messages()[0].content()[0], 'b');
+
+  std::vector<ContextMessage> prompt = manager_.GetPromptMessages(context_id_);
+  ASSERT_EQ(prompt.size(), 4u);
+  EXPECT_EQ(prompt[0].role, ContextMessage::Role::SYSTEM);
+  EXPECT_NE(prompt[0].content().find("summary of a"), std::string::npos);
+  EXPECT_EQ(manager_.GetCompactionStats().messages_folded, 1u);
+}
+
+TEST_F(ContextManagerTest, NextCompactionSendsOnlySummaryAndNewMessages) {
+  AddMessage('a', 20);
+  AddMessage('b', 20);
+  AddMessage('c', 20);
+  summarizer_.Answer(true, "summary of a");
+  AddMessage('d', 20);
+  ASSERT_EQ(summarizer_.pending(), 1u);
+
+  const std::string& input = summarizer_.inputs()[1];
+  EXPECT_NE(input.find("summary of a"), std::string::npos);
+  EXPECT_EQ(input.find(std::string(76, 'a')), std::string::npos);
+  EXPECT_NE(input.find(std::string(76, 'b')), std::string::npos);
+}
+
+TEST_F(ContextManagerTest, PromptStaysWithinBudgetWhileSummarizerFails) {
+  for (char fill = 'a'; fill < 'h'; ++fill) {
+    AddMessage(fill, 30);
+    while (summarizer_.pending() > 0) {
+      summarizer_.Answer(false, "HTTP error: 503");
+    }
+  }
+  EXPECT_EQ(manager_.GetSnapshot(context_id_)->messages().size(), 7u);
+  EXPECT_GT(manager_.GetCompactionStats().failed, 0u);
+
+  std::vector<ContextMessage> prompt = manager_.GetPromptMessages(context_id_);
+  ASSERT_EQ(prompt.size(), 3u);
+  EXPECT_EQ(prompt.back().content()[0], 'g');
+}
+
+TEST_F(ContextManagerTest, SummaryIsDroppedIfContextClearedMeanwhile) {
+  AddMessage('a', 20);
+  AddMessage('b', 20);
+  AddMessage('c', 20);
+  manager_.ClearContext(context_id_);
+  AddMessage('d', 5);
+
+  summarizer_.Answer(true, "summary of a");
+  EXPECT_TRUE(manager_.GetSummary(context_id_).empty());
+  EXPECT_EQ(manager_.GetSnapshot(context_id_)->messages().size(), 1u);
+}
+
+TEST_F(ContextManagerTest, NewestMessageIsAlwaysSent) {
+  AddMessage('a', 500);
+  std::vector<ContextMessage> prompt = manager_.GetPromptMessages(context_id_);
+  ASSERT_EQ(prompt.size(), 1u);
+  EXPECT_EQ(prompt[0].content()[0], 'a');
+}
+
+TEST_F(ContextManagerTest, SnapshotIsUnaffectedByLaterChanges) {
+  AddMessage('a', 5);
+  scoped_refptr<const ContextMessageList> snapshot =
+      manager_.GetSnapshot(context_id_);
+
+  AddMessage('b', 5);
+  scoped_refptr<const ContextMessageList> current =
+      manager_.GetSnapshot(context_id_);
+  ASSERT_EQ(snapshot->messages().size(), 1u);
+  ASSERT_EQ(current->messages().size(), 2u);
+  // The copied list shares the text of the messages it had
+  EXPECT_EQ(snapshot->messages()[0].body, current->messages()[0].body);
+
+  manager_.ClearContext(context_id_);
+  EXPECT_EQ(snapshot->messages().size(), 1u);
+  EXPECT_EQ(snapshot->messages()[0].content()[0], 'a');
+}
+
+TEST_F(ContextManagerTest, PromptSharesMessageText) {
+  AddMessage('a', 5);
+  AddMessage('b', 5);
+  std::vector<ContextMessage> prompt = manager_.GetPromptMessages(context_id_);
+  ASSERT_EQ(prompt.size(), 2u);
+  EXPECT_EQ(prompt[1].content().data(),
+            manager_.GetSnapshot(context_id_)->messages()[1].content().data());
+}
+
+class ContextManagerEvictionTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    clock_.SetNow(base::Time::Now());
+  }
+
+  std::unique_ptr<ContextManager> CreateManager(
+      const ContextManager::Options& options) {
+    auto manager = std::make_unique<ContextManager>(options);
+    manager->SetClockForTesting(&clock_);
+    return manager;
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  base::SimpleTestClock clock_;
+};
+
+TEST_F(ContextManagerEvictionTest, IdleContextsAreSwept) {
+  ContextManager::Options options;
+  options.idle_ttl = base::Minutes(30);
+  std::unique_ptr<ContextManager> manager = CreateManager(options);
+  std::string idle = manager->CreateContext();
+  clock_.Advance(base::Minutes(20));
+  std::string active = manager->CreateContext();
+  clock_.Advance(base::Minutes(20));
+
+  manager->EvictIdleContexts();
+  EXPECT_EQ(manager->GetAllContextIds(), std::vector<std::string>{active});
+  EXPECT_EQ(manager->GetEvictionStats().expired, 1u);
+
+  // A lookup runs into an idle context before the next sweep does
+  clock_.Advance(base::Minutes(31));
+  EXPECT_FALSE(manager->HasContext(active));
+  EXPECT_EQ(manager->GetResidentContextCount(), 0u);
+}
+
+TEST_F(ContextManagerEvictionTest, UseKeepsContextAlive) {
+  ContextManager::Options options;
+  options.idle_ttl = base::Minutes(30);
+  std::unique_ptr<ContextManager> manager = CreateManager(options);
+  std::string context_id = manager->CreateContext();
+  for (int i = 0; i < 4; ++i) {
+    clock_.Advance(base::Minutes(20));
+    manager->AddMessage(context_id, ContextMessage::Role::USER, "hello");
+  }
+  manager->EvictIdleContexts();
+  EXPECT_EQ(manager->GetSnapshot(context_id)->messages().size(), 4u);
+}
+
+TEST_F(ContextManagerEvictionTest, ColdestContextsAreEvictedForSpace) {
+  ContextManager::Options options;
+  options.max_bytes = 16 * 1024;  // 1 KiB per shard
+  std::unique_ptr<ContextManager> manager = CreateManager(options);
+  std::vector<std::string> context_ids;
+  for (int i = 0; i < 200; ++i) {
+    context_ids.push_back(manager->CreateContext());
+    manager->AddMessage(context_ids.back(), ContextMessage::Role::USER,
+                        std::string(200, 'x'));
+  }
+
+  EXPECT_LE(manager->GetResidentBytes(), options.max_bytes);
+  EXPECT_GT(manager->GetEvictionStats().evicted_for_space, 0u);
+  EXPECT_EQ(manager->GetEvictionStats().spilled, 0u);
+  EXPECT_TRUE(manager->HasContext(context_ids.back()));
+  EXPECT_FALSE(manager->HasContext(context_ids.front()));
+}
+
+TEST_F(ContextManagerEvictionTest, ContextsEvictedForSpaceAreSpilled) {
+  ContextManager::Options options;
+  options.max_bytes = 16 * 1024;
+  options.spill_directory = temp_dir_.GetPath().AppendASCII("contexts");
+  std::unique_ptr<ContextManager> manager = CreateManager(options);
+  std::string first = manager->CreateContext();
+  manager->AddMessage(first, ContextMessage::Role::USER, "first question");
+  manager->AddMessage(first, ContextMessage::Role::ASSISTANT, "first answer");
+  for (int i = 0; i < 200; ++i) {
+    manager->AddMessage(manager->CreateContext(), ContextMessage::Role::USER,
+                        std::string(200, 'x'));
+  }
+  ASSERT_GT(manager->GetEvictionStats().spilled, 0u);
+  std::vector<std::string> resident = manager->GetAllContextIds();
+  ASSERT_EQ(std::find(resident.begin(), resident.end(), first),
+            resident.end());
+
+  scoped_refptr<const ContextMessageList> messages = manager->GetSnapshot(first);
+  ASSERT_TRUE(messages);
+  ASSERT_EQ(messages->messages().size(), 2u);
+  EXPECT_EQ(messages->messages()[1].role, ContextMessage::Role::ASSISTANT);
+  EXPECT_EQ(messages->messages()[1].content(), "first answer");
+  EXPECT_EQ(manager->GetEvictionStats().restored, 1u);
+
+  // IDs that are not GUIDs never reach the file system
+  EXPECT_FALSE(manager->HasContext("../contexts/" + first));
+
+  manager->ClearAllContexts();
+  EXPECT_TRUE(base::IsDirectoryEmpty(options.spill_directory));
+}
+
+TEST_F(ContextManagerEvictionTest, ConcurrentUseOfDistinctContexts) {
+  ContextManager::Options options;
+  std::unique_ptr<ContextManager> manager = CreateManager(options);
+  constexpr int kThreads = 4;
+  constexpr int kMessages = 200;
+  std::vector<std::string> context_ids;
+  std::vector<std::unique_ptr<base::Thread>> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    context_ids.push_back(manager->CreateContext());
+    threads.push_back(std::make_unique<base::Thread>("ContextWorker"));
+    ASSERT_TRUE(threads.back()->Start());
+    threads.back()->task_runner()->PostTask(
+        FROM_HERE, base::BindOnce(
+                       [](ContextManager* manager, std::string context_id) {
+                         for (int j = 0; j < kMessages; ++j) {
+                           manager->AddMessage(context_id,
+                                               ContextMessage::Role::USER, "hi");
+                           manager->GetPromptMessages(context_id);
+                         }
+                       },
+                       manager.get(), context_ids.back()));
+  }
+  for (auto& thread : threads) {
+    thread->Stop();
+  }
+  for (const std::string& context_id : context_ids) {
+    EXPECT_EQ(manager->GetSnapshot(context_id)->messages().size(),
+              static_cast<size_t>(kMessages));
+  }
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,231 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/deferred_initializer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/default_tick_clock.h"
+#include "base/trace_event/trace_event.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+const char* PhaseName(DeferredInitializer::Phase phase) {
+  switch (phase) {
+    case DeferredInitializer::Phase::kEager:
+      return "eager";
+    case DeferredInitializer::Phase::kAfterFirstPaint:
+      return "after paint";
+    case DeferredInitializer::Phase::kOnDemand:
+      return "on demand";
+  }
+  return "";
+}
+
+const char* StateName(DeferredInitializer::State state) {
+  switch (state) {
+    case DeferredInitializer::State::kPending:
+      return "pending";
+    case DeferredInitializer::State::kInitializing:
+      return "initializing";
+    case DeferredInitializer::State::kInitialized:
+      return "ok";
+    case DeferredInitializer::State::kFailed:
+      return "failed";
+  }
+  return "";
+}
+
+}  // namespace
+
+DeferredInitializer::DeferredInitializer(
+    scoped_refptr<base::SequencedTaskRunner> task_runner)
+    : task_runner_(task_runner
+                       ? std::move(task_runner)
+                       : base::SequencedTaskRunner::GetCurrentDefault()),
+      clock_(base::DefaultTickClock::GetInstance()),
+      creation_time_(clock_->NowTicks()) {}
+
+DeferredInitializer::~DeferredInitializer() = default;
+
+void DeferredInitializer::Register(const std::string& name,
+                                   Phase phase,
+                                   std::vector<std::string> dependencies,
+                                   Initializer initializer,
+                                   base::TimeDelta budget) {
+  DCHECK(!subsystems_.count(name)) << name << " registered twice";
+  Subsystem& subsystem = subsystems_[name];
+  subsystem.phase = phase;
+  subsystem.dependencies = std::move(dependencies);
+  subsystem.initializer = std::move(initializer);
+  subsystem.budget = budget;
+  if (phase == Phase::kAfterFirstPaint) {
+    deferred_.push_back(name);
+  }
+}
+
+bool DeferredInitializer::RunEager() {
+  TRACE_EVENT0("startup", "DeferredInitializer::RunEager");
+  bool success = true;
+  for (const auto& [name, subsystem] : subsystems_) {
+    if (subsystem.phase == Phase::kEager) {
+      success &= Initialize(name);
+    }
+  }
+  return success;
+}
+
+void DeferredInitializer::OnFirstPaint(base::OnceClosure done) {
+  deferred_done_ = std::move(done);
+  task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&DeferredInitializer::InitializeNextDeferred,
+                                weak_ptr_factory_.GetWeakPtr()));
+}
+
+bool DeferredInitializer::EnsureInitialized(const std::string& name) {
+  auto it = subsystems_.find(name);
+  if (it != subsystems_.end() && it->second.state == State::kInitialized) {
+    return true;
+  }
+  return Initialize(name);
+}
+
+bool DeferredInitializer::IsInitialized(const std::string& name) const {
+  return GetState(name) == State::kInitialized;
+}
+
+DeferredInitializer::State DeferredInitializer::GetState(
+    const std::string& name) const {
+  auto it = subsystems_.find(name);
+  return it == subsystems_.end() ? State::kPending : it->second.state;
+}
+
+std::vector<DeferredInitializer::Record> DeferredInitializer::GetTrace()
+    const {
+  std::vector<std::pair<size_t, Record>> ordered;
+  for (const auto& [name, subsystem] : subsystems_) {
+    Record record;
+    record.name = name;
+    record.phase = subsystem.phase;
+    record.state = subsystem.state;
+    record.start = subsystem.start;
+    record.duration = subsystem.duration;
+    record.budget = subsystem.budget;
+    // Not started sorts last, by name
+    size_t order = subsystem.state == State::kPending ? subsystems_.size()
+                                                      : subsystem.order;
+    ordered.emplace_back(order, std::move(record));
+  }
+  std::stable_sort(ordered.begin(), ordered.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.first < b.first;
+                   });
+
+  std::vector<Record> trace;
+  trace.reserve(ordered.size());
+  for (auto& [order, record] : ordered) {
+    trace.push_back(std::move(record));
+  }
+  return trace;
+}
+
+std::string DeferredInitializer::GetTextDump() const {
+  std::string dump =
+      base::StringPrintf("%-28s %-11s %-12s %10s %10s %10s\n", "subsystem",
+                         "phase", "state", "start ms", "took ms", "budget");
+  for (const Record& record : GetTrace()) {
+    dump += base::StringPrintf(
+        "%-28s %-11s %-12s %10.1f %10.1f %10.1f%s\n", record.name.c_str(),
+        PhaseName(record.phase), StateName(record.state),
+        record.start.InMillisecondsF(), record.duration.InMillisecondsF(),
+        record.budget.InMillisecondsF(),
+        record.over_budget() ? " OVER" : "");
+  }
+  return dump;
+}
+
+bool DeferredInitializer::Initialize(const std::string& name) {
+  auto it = subsystems_.find(name);
+  if (it == subsystems_.end()) {
+    LOG(ERROR) << "Unknown subsystem: " << name;
+    return false;
+  }
+  // |subsystems_| is a map, so the reference survives registrations made
+  // by initializers
+  Subsystem& subsystem = it->second;
+  switch (subsystem.state) {
+    case State::kInitialized:
+      return true;
+    case State::kFailed:
+      return false;
+    case State::kInitializing:
+      LOG(ERROR) << "Dependency cycle through " << name;
+      return false;
+    case State::kPending:
+      break;
+  }
+
+  subsystem.state = State::kInitializing;
+  for (const std::string& dependency : subsystem.dependencies) {
+    if (!Initialize(dependency)) {
+      LOG(ERROR) << "Not initializing " << name << ": " << dependency
+                 << " failed";
+      subsystem.state = State::kFailed;
+      subsystem.order = started_++;
+      return false;
+    }
+  }
+
+  subsystem.order = started_++;
+  base::TimeTicks start = clock_->NowTicks();
+  subsystem.start = start - creation_time_;
+  bool success;
+  {
+    TRACE_EVENT1("startup", "DeferredInitializer::Initialize", "subsystem",
+                 name);
+    success = std::move(subsystem.initializer).Run();
+  }
+  subsystem.duration = clock_->NowTicks() - start;
+  subsystem.state = success ? State::kInitialized : State::kFailed;
+
+  if (!success) {
+    LOG(ERROR) << "Failed to initialize " << name;
+  } else if (subsystem.duration > subsystem.budget) {
+    LOG(WARNING) << "Initializing " << name << " took "
+                 << subsystem.duration.InMillisecondsF() << " ms, over its "
+                 << subsystem.budget.InMillisecondsF() << " ms budget";
+  }
+  return success;
+}
+
+void DeferredInitializer::InitializeNextDeferred() {
+  // Skip the ones already initialized on demand
+  while (next_deferred_ < deferred_.size() &&
+         GetState(deferred_[next_deferred_]) != State::kPending) {
+    ++next_deferred_;
+  }
+  if (next_deferred_ == deferred_.size()) {
+    LOG(INFO) << "Deferred initialization done:\n" << GetTextDump();
+    if (deferred_done_) {
+      std::move(deferred_done_).Run();
+    }
+    return;
+  }
+
+  Initialize(deferred_[next_deferred_++]);
+  task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&DeferredInitializer::InitializeNextDeferred,
+                                weak_ptr_factory_.GetWeakPtr()));
+}
+
+}  // namespace core
+}  // namespace asol
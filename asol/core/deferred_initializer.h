@@ -0,0 +1,155 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_DEFERRED_INITIALIZER_H_
+#define ASOL_CORE_DEFERRED_INITIALIZER_H_
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/tick_clock.h"
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// DeferredInitializer brings subsystems up in dependency order, each when
+// it is first needed rather than all at startup, so that only what the
+// first window needs is on its critical path.
+//
+// Each subsystem is registered with the subsystems it depends on and a
+// phase. kEager ones are initialized by RunEager(), during startup.
+// kAfterFirstPaint ones are initialized by OnFirstPaint(), one per posted
+// task so input handling interleaves with them. kOnDemand ones wait to be
+// used. Any of them is initialized at once, with its dependencies, by
+// EnsureInitialized(), which a subsystem's accessor calls so that callers
+// never see one that is not ready.
+//
+// Every initialization is traced and timed against a budget for its
+// subsystem; overruns are logged, and GetTextDump() shows them all.
+//
+// A subsystem whose initializer fails, or whose dependency fails, is not
+// retried. Must be used on one sequence.
+class DeferredInitializer {
+ public:
+  enum class Phase {
+    kEager,
+    kAfterFirstPaint,
+    kOnDemand,
+  };
+
+  enum class State {
+    kPending,
+    kInitializing,
+    kInitialized,
+    kFailed,
+  };
+
+  // Returns false on failure
+  using Initializer = base::OnceCallback<bool()>;
+
+  struct Record {
+    std::string name;
+    Phase phase = Phase::kOnDemand;
+    State state = State::kPending;
+    // Since the DeferredInitializer was created
+    base::TimeDelta start;
+    // Of the initializer alone, not its dependencies
+    base::TimeDelta duration;
+    base::TimeDelta budget;
+
+    bool over_budget() const { return duration > budget; }
+  };
+
+  static constexpr base::TimeDelta kDefaultBudget = base::Milliseconds(20);
+
+  // |task_runner| runs the kAfterFirstPaint initializers; defaults to the
+  // current sequence's default runner.
+  explicit DeferredInitializer(
+      scoped_refptr<base::SequencedTaskRunner> task_runner = nullptr);
+  ~DeferredInitializer();
+
+  DeferredInitializer(const DeferredInitializer&) = delete;
+  DeferredInitializer& operator=(const DeferredInitializer&) = delete;
+
+  void SetTickClockForTesting(const base::TickClock* clock) {
+    clock_ = clock;
+    creation_time_ = clock_->NowTicks();
+  }
+
+  // Register |name|, to be initialized by |initializer| after its
+  // |dependencies|, which need not be registered yet. Must come before
+  // the phase it is in runs.
+  void Register(const std::string& name,
+                Phase phase,
+                std::vector<std::string> dependencies,
+                Initializer initializer,
+                base::TimeDelta budget = kDefaultBudget);
+
+  // Initialize the kEager subsystems. Returns false if any failed.
+  bool RunEager();
+
+  // Start initializing the kAfterFirstPaint subsystems in the background.
+  // |done| runs once they all have, whether or not they succeeded.
+  void OnFirstPaint(base::OnceClosure done = base::OnceClosure());
+
+  // Initialize |name| and its dependencies now if not already. Returns
+  // whether it is initialized.
+  bool EnsureInitialized(const std::string& name);
+
+  bool IsInitialized(const std::string& name) const;
+  State GetState(const std::string& name) const;
+
+  // Every subsystem, in the order initialization started, then the ones
+  // not started
+  std::vector<Record> GetTrace() const;
+
+  // The trace as a plain text table, as logged after first paint
+  std::string GetTextDump() const;
+
+ private:
+  struct Subsystem {
+    Phase phase = Phase::kOnDemand;
+    std::vector<std::string> dependencies;
+    Initializer initializer;
+    base::TimeDelta budget;
+    State state = State::kPending;
+    base::TimeDelta start;
+    base::TimeDelta duration;
+    // Position in the start order, for the trace
+    size_t order = 0;
+  };
+
+  // Initialize |name| after its dependencies. Returns whether it is
+  // initialized.
+  bool Initialize(const std::string& name);
+
+  // Initialize the next pending kAfterFirstPaint subsystem and post the
+  // one after
+  void InitializeNextDeferred();
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  const base::TickClock* clock_;
+  base::TimeTicks creation_time_;
+
+  std::map<std::string, Subsystem> subsystems_;
+  // kAfterFirstPaint subsystems in registration order
+  std::vector<std::string> deferred_;
+  size_t next_deferred_ = 0;
+  size_t started_ = 0;
+  base::OnceClosure deferred_done_;
+
+  base::WeakPtrFactory<DeferredInitializer> weak_ptr_factory_{this};
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_DEFERRED_INITIALIZER_H_
@@ -0,0 +1,155 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/deferred_initializer.h"
+
+#include <string>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/test/simple_test_tick_clock.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+using Phase = DeferredInitializer::Phase;
+using State = DeferredInitializer::State;
+
+class DeferredInitializerTest : public testing::Test {
+ protected:
+  // An initializer that logs |name| and returns |result|
+  DeferredInitializer::Initializer Log(const std::string& name,
+                                       bool result = true) {
+    return base::BindOnce(
+        [](std::vector<std::string>* log, std::string name, bool result) {
+          log->push_back(name);
+          return result;
+        },
+        &log_, name, result);
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  std::vector<std::string> log_;
+};
+
+TEST_F(DeferredInitializerTest, EagerRunsDependenciesFirst) {
+  DeferredInitializer initializer;
+  initializer.Register("omnibox", Phase::kEager, {"suggestions"},
+                       Log("omnibox"));
+  initializer.Register("suggestions", Phase::kOnDemand, {"service"},
+                       Log("suggestions"));
+  initializer.Register("service", Phase::kOnDemand, {}, Log("service"));
+  initializer.Register("palace", Phase::kAfterFirstPaint, {"service"},
+                       Log("palace"));
+
+  EXPECT_TRUE(initializer.RunEager());
+  EXPECT_EQ(log_,
+            (std::vector<std::string>{"service", "suggestions", "omnibox"}));
+  EXPECT_FALSE(initializer.IsInitialized("palace"));
+}
+
+TEST_F(DeferredInitializerTest, AfterFirstPaintRunsInBackground) {
+  DeferredInitializer initializer;
+  initializer.Register("service", Phase::kEager, {}, Log("service"));
+  initializer.Register("palace", Phase::kAfterFirstPaint, {"service"},
+                       Log("palace"));
+  initializer.Register("contextual", Phase::kAfterFirstPaint, {"service"},
+                       Log("contextual"));
+  initializer.Register("voice", Phase::kOnDemand, {}, Log("voice"));
+  ASSERT_TRUE(initializer.RunEager());
+
+  bool done = false;
+  initializer.OnFirstPaint(
+      base::BindOnce([](bool* done) { *done = true; }, &done));
+  EXPECT_EQ(log_.size(), 1u);
+
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(done);
+  EXPECT_EQ(log_,
+            (std::vector<std::string>{"service", "palace", "contextual"}));
+  EXPECT_EQ(initializer.GetState("voice"), State::kPending);
+}
+
+TEST_F(DeferredInitializerTest, EnsureInitializedRunsOnce) {
+  DeferredInitializer initializer;
+  initializer.Register("service", Phase::kOnDemand, {}, Log("service"));
+  initializer.Register("palace", Phase::kAfterFirstPaint, {"service"},
+                       Log("palace"));
+
+  // Used before the background initialization reached it
+  EXPECT_TRUE(initializer.EnsureInitialized("palace"));
+  EXPECT_TRUE(initializer.EnsureInitialized("palace"));
+  initializer.OnFirstPaint();
+  task_environment_.RunUntilIdle();
+
+  EXPECT_EQ(log_, (std::vector<std::string>{"service", "palace"}));
+}
+
+TEST_F(DeferredInitializerTest, FailuresPropagateToDependents) {
+  DeferredInitializer initializer;
+  initializer.Register("service", Phase::kOnDemand, {},
+                       Log("service", /*result=*/false));
+  initializer.Register("omnibox", Phase::kEager, {"service"}, Log("omnibox"));
+  initializer.Register("settings", Phase::kEager, {}, Log("settings"));
+
+  EXPECT_FALSE(initializer.RunEager());
+  EXPECT_EQ(initializer.GetState("service"), State::kFailed);
+  EXPECT_EQ(initializer.GetState("omnibox"), State::kFailed);
+  EXPECT_TRUE(initializer.IsInitialized("settings"));
+  // Not retried
+  EXPECT_FALSE(initializer.EnsureInitialized("omnibox"));
+  EXPECT_EQ(log_, (std::vector<std::string>{"service", "settings"}));
+}
+
+TEST_F(DeferredInitializerTest, CyclesFail) {
+  DeferredInitializer initializer;
+  initializer.Register("a", Phase::kOnDemand, {"b"}, Log("a"));
+  initializer.Register("b", Phase::kOnDemand, {"a"}, Log("b"));
+  initializer.Register("c", Phase::kOnDemand, {"missing"}, Log("c"));
+
+  EXPECT_FALSE(initializer.EnsureInitialized("a"));
+  EXPECT_FALSE(initializer.EnsureInitialized("c"));
+  EXPECT_TRUE(log_.empty());
+}
+
+TEST_F(DeferredInitializerTest, TracesTimeAgainstBudget) {
+  base::SimpleTestTickClock clock;
+  DeferredInitializer initializer;
+  initializer.SetTickClockForTesting(&clock);
+  auto slow = [](base::SimpleTestTickClock* clock, base::TimeDelta took) {
+    clock->Advance(took);
+    return true;
+  };
+  initializer.Register(
+      "model", Phase::kEager, {},
+      base::BindOnce(slow, &clock, base::Milliseconds(50)),
+      base::Milliseconds(30));
+  initializer.Register(
+      "palace", Phase::kEager, {"model"},
+      base::BindOnce(slow, &clock, base::Milliseconds(5)));
+  initializer.Register("voice", Phase::kOnDemand, {}, Log("voice"));
+  ASSERT_TRUE(initializer.RunEager());
+
+  std::vector<DeferredInitializer::Record> trace = initializer.GetTrace();
+  ASSERT_EQ(trace.size(), 3u);
+  EXPECT_EQ(trace[0].name, "model");
+  EXPECT_EQ(trace[0].duration, base::Milliseconds(50));
+  EXPECT_TRUE(trace[0].over_budget());
+  EXPECT_EQ(trace[1].name, "palace");
+  EXPECT_EQ(trace[1].start, base::Milliseconds(50));
+  EXPECT_FALSE(trace[1].over_budget());
+  EXPECT_EQ(trace[2].name, "voice");
+  EXPECT_EQ(trace[2].state, State::kPending);
+
+  std::string dump = initializer.GetTextDump();
+  EXPECT_NE(dump.find("model"), std::string::npos);
+  EXPECT_NE(dump.find("OVER"), std::string::npos);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
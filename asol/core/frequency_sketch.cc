@@ -0,0 +1,92 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/frequency_sketch.h"
+
+#include <algorithm>
+
+namespace asol {
+namespace core {
+
+namespace {
+
+constexpr int kRows = 4;
+constexpr int kCountersPerWord = 16;
+constexpr uint64_t kMaxCount = 15;
+
+// Odd multipliers that decorrelate the per-row indices
+constexpr uint64_t kRowSeeds[kRows] = {
+    0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull,
+    0xD6E8FEB86659FD93ull};
+
+// Keeps the low three bits of every 4-bit counter after a right shift
+constexpr uint64_t kHalfMask = 0x7777777777777777ull;
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+FrequencySketch::FrequencySketch(size_t expected_entries) {
+  size_t counters = RoundUpToPowerOfTwo(std::max<size_t>(expected_entries, 16));
+  table_.assign(counters / kCountersPerWord * kRows, 0);
+  counter_mask_ = counters - 1;
+  sample_size_ = std::max<size_t>(expected_entries, 1) * 10;
+}
+
+FrequencySketch::~FrequencySketch() = default;
+
+void FrequencySketch::Increment(uint64_t hash) {
+  for (int row = 0; row < kRows; ++row) {
+    size_t index = GetCounterIndex(hash, row);
+    uint64_t& word = table_[index / kCountersPerWord];
+    int shift = (index % kCountersPerWord) * 4;
+    if (((word >> shift) & kMaxCount) < kMaxCount) {
+      word += uint64_t{1} << shift;
+    }
+  }
+
+  if (++additions_ >= sample_size_) {
+    Age();
+  }
+}
+
+int FrequencySketch::Estimate(uint64_t hash) const {
+  uint64_t estimate = kMaxCount;
+  for (int row = 0; row < kRows; ++row) {
+    size_t index = GetCounterIndex(hash, row);
+    uint64_t word = table_[index / kCountersPerWord];
+    int shift = (index % kCountersPerWord) * 4;
+    estimate = std::min(estimate, (word >> shift) & kMaxCount);
+  }
+  return static_cast<int>(estimate);
+}
+
+void FrequencySketch::Clear() {
+  std::fill(table_.begin(), table_.end(), 0);
+  additions_ = 0;
+}
+
+size_t FrequencySketch::GetCounterIndex(uint64_t hash, int row) const {
+  uint64_t mixed = (hash + row) * kRowSeeds[row];
+  mixed ^= mixed >> 32;
+  // Each row owns a contiguous quarter of the table
+  size_t row_counters = counter_mask_ + 1;
+  return row * row_counters + (mixed & counter_mask_);
+}
+
+void FrequencySketch::Age() {
+  for (uint64_t& word : table_) {
+    word = (word >> 1) & kHalfMask;
+  }
+  additions_ /= 2;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,52 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_FREQUENCY_SKETCH_H_
+#define ASOL_CORE_FREQUENCY_SKETCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace asol {
+namespace core {
+
+// FrequencySketch is a count-min sketch of 4-bit counters used as a TinyLFU
+// admission filter: it estimates how often a key has been requested
+// recently, so a cache can refuse to let a one-off key displace a popular
+// one.
+//
+// Counters are packed sixteen to a 64-bit word and each key touches one
+// counter in each of four rows. After 10x |expected_entries| increments every
+// counter is halved, which ages out old popularity. Not thread-safe.
+class FrequencySketch {
+ public:
+  explicit FrequencySketch(size_t expected_entries);
+  ~FrequencySketch();
+
+  // Record one request for the key with |hash|.
+  void Increment(uint64_t hash);
+
+  // Estimated recent request count for |hash|, saturating at 15.
+  int Estimate(uint64_t hash) const;
+
+  void Clear();
+
+ private:
+  // Index of the counter for |hash| in row |row|
+  size_t GetCounterIndex(uint64_t hash, int row) const;
+
+  // Halve every counter
+  void Age();
+
+  std::vector<uint64_t> table_;
+  size_t counter_mask_;
+  size_t sample_size_;
+  size_t additions_ = 0;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_FREQUENCY_SKETCH_H_
@@ -0,0 +1,485 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/hnsw_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <string>
+#include <utility>
+
+#include "asol/core/quantized_matmul.h"
+#include "asol/core/vector_kernels.h"
+#include "base/files/file_util.h"
+#include "base/logging.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+constexpr uint32_t kFileMagic = 0x57534e48;  // "HNSW"
+constexpr uint32_t kFileVersion = 1;
+
+// Layers above this are never drawn; with 16 links the chance of reaching
+// it is 16^-16
+constexpr int kMaxLevel = 16;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t dimension;
+  uint32_t max_links;
+  uint32_t construction_breadth;
+  uint32_t search_breadth;
+  uint32_t seed;
+  uint32_t node_count;
+  uint32_t entry_point;
+  int32_t max_level;
+  uint64_t random_state;
+};
+
+template <typename T>
+void AppendArray(const T* data, size_t count, std::string* out) {
+  out->append(reinterpret_cast<const char*>(data), count * sizeof(T));
+}
+
+// Reads consecutive arrays out of a file's contents, failing past the end
+class Reader {
+ public:
+  explicit Reader(const std::string& data) : data_(data) {}
+
+  template <typename T>
+  bool ReadArray(T* out, size_t count) {
+    size_t size = count * sizeof(T);
+    if (count > (data_.size() - offset_) / sizeof(T)) {
+      return false;
+    }
+    if (size) {
+      std::memcpy(out, data_.data() + offset_, size);
+    }
+    offset_ += size;
+    return true;
+  }
+
+  bool AtEnd() const { return offset_ == data_.size(); }
+
+ private:
+  const std::string& data_;
+  size_t offset_ = 0;
+};
+
+// SplitMix64; small and good enough to draw layers
+uint64_t NextRandom(uint64_t* state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+bool MoreSimilar(float a_similarity, uint32_t a_node,
+                 float b_similarity, uint32_t b_node) {
+  return a_similarity != b_similarity ? a_similarity > b_similarity
+                                      : a_node < b_node;
+}
+
+}  // namespace
+
+HnswIndex::HnswIndex(const Options& options)
+    : options_(options), random_state_(options.seed) {
+  options_.max_links = std::max<size_t>(options_.max_links, 2);
+  options_.construction_breadth =
+      std::max(options_.construction_breadth, options_.max_links);
+  options_.search_breadth = std::max<size_t>(options_.search_breadth, 1);
+}
+
+HnswIndex::~HnswIndex() = default;
+
+// static
+std::unique_ptr<HnswIndex> HnswIndex::Load(const base::FilePath& path) {
+  std::string data;
+  if (!base::ReadFileToString(path, &data)) {
+    return nullptr;
+  }
+  Reader reader(data);
+  FileHeader header;
+  if (!reader.ReadArray(&header, 1) || header.magic != kFileMagic ||
+      header.version != kFileVersion || header.dimension == 0 ||
+      header.max_links < 2 || header.max_level > kMaxLevel ||
+      (header.node_count == 0) != (header.max_level < 0) ||
+      (header.node_count && header.entry_point >= header.node_count)) {
+    LOG(ERROR) << "Malformed vector index: " << path.value();
+    return nullptr;
+  }
+
+  Options options;
+  options.dimension = header.dimension;
+  options.max_links = header.max_links;
+  options.construction_breadth = header.construction_breadth;
+  options.search_breadth = header.search_breadth;
+  options.seed = header.seed;
+  auto index = std::make_unique<HnswIndex>(options);
+  index->random_state_ = header.random_state;
+  index->entry_point_ = header.entry_point;
+  index->max_level_ = header.max_level;
+
+  size_t count = header.node_count;
+  std::vector<uint8_t> removed(count);
+  index->ids_.resize(count);
+  index->scales_.resize(count);
+  index->levels_.resize(count);
+  index->vectors_.resize(count * options.dimension);
+  index->bottom_links_.resize(count * (1 + index->MaxLinks(0)));
+  bool ok = reader.ReadArray(index->ids_.data(), count) &&
+            reader.ReadArray(index->scales_.data(), count) &&
+            reader.ReadArray(index->levels_.data(), count) &&
+            reader.ReadArray(removed.data(), count) &&
+            reader.ReadArray(index->vectors_.data(), index->vectors_.size()) &&
+            reader.ReadArray(index->bottom_links_.data(),
+                             index->bottom_links_.size());
+  index->upper_links_.resize(count);
+  for (size_t node = 0; ok && node < count; ++node) {
+    int level = index->levels_[node];
+    if (level < 0 || level > header.max_level) {
+      ok = false;
+      break;
+    }
+    index->upper_links_[node].resize(level * (1 + index->MaxLinks(1)));
+    ok = reader.ReadArray(index->upper_links_[node].data(),
+                          index->upper_links_[node].size());
+  }
+  if (!ok || !reader.AtEnd()) {
+    LOG(ERROR) << "Malformed vector index: " << path.value();
+    return nullptr;
+  }
+
+  // Every link must name a node the linking node's level allows
+  for (size_t node = 0; node < count; ++node) {
+    for (int level = 0; level <= index->levels_[node]; ++level) {
+      const NodeId* links = index->Links(node, level);
+      bool valid = links[0] <= index->MaxLinks(level);
+      for (NodeId i = 1; valid && i <= links[0]; ++i) {
+        valid = links[i] < count && index->levels_[links[i]] >= level;
+      }
+      if (!valid) {
+        LOG(ERROR) << "Malformed vector index: " << path.value();
+        return nullptr;
+      }
+    }
+  }
+
+  index->removed_.assign(removed.begin(), removed.end());
+  index->visited_.resize(count);
+  for (size_t node = 0; node < count; ++node) {
+    if (!removed[node]) {
+      index->live_nodes_[index->ids_[node]] = node;
+    }
+  }
+  return index;
+}
+
+bool HnswIndex::Save(const base::FilePath& path) const {
+  FileHeader header = {kFileMagic,
+                       kFileVersion,
+                       static_cast<uint32_t>(options_.dimension),
+                       static_cast<uint32_t>(options_.max_links),
+                       static_cast<uint32_t>(options_.construction_breadth),
+                       static_cast<uint32_t>(options_.search_breadth),
+                       options_.seed,
+                       static_cast<uint32_t>(node_count()),
+                       entry_point_,
+                       max_level_,
+                       random_state_};
+  std::vector<uint8_t> removed(removed_.begin(), removed_.end());
+
+  std::string data;
+  AppendArray(&header, 1, &data);
+  AppendArray(ids_.data(), ids_.size(), &data);
+  AppendArray(scales_.data(), scales_.size(), &data);
+  AppendArray(levels_.data(), levels_.size(), &data);
+  AppendArray(removed.data(), removed.size(), &data);
+  AppendArray(vectors_.data(), vectors_.size(), &data);
+  AppendArray(bottom_links_.data(), bottom_links_.size(), &data);
+  for (const std::vector<NodeId>& links : upper_links_) {
+    AppendArray(links.data(), links.size(), &data);
+  }
+
+  base::FilePath temp_path = path.AddExtension(FILE_PATH_LITERAL("tmp"));
+  if (!base::WriteFile(temp_path, data) ||
+      !base::ReplaceFile(temp_path, path, nullptr)) {
+    LOG(ERROR) << "Failed to write vector index: " << path.value();
+    base::DeleteFile(temp_path);
+    return false;
+  }
+  return true;
+}
+
+bool HnswIndex::Add(uint64_t id, const float* embedding) {
+  Quantized query;
+  if (!Quantize(embedding, &query)) {
+    return false;
+  }
+  Remove(id);
+
+  NodeId node = static_cast<NodeId>(ids_.size());
+  int level = DrawLevel();
+  ids_.push_back(id);
+  vectors_.insert(vectors_.end(), query.values.begin(), query.values.end());
+  scales_.push_back(query.scale);
+  levels_.push_back(level);
+  removed_.push_back(false);
+  bottom_links_.resize(bottom_links_.size() + 1 + MaxLinks(0), 0);
+  upper_links_.emplace_back(level * (1 + MaxLinks(1)), 0);
+  visited_.push_back(0);
+  live_nodes_[id] = node;
+
+  if (max_level_ < 0) {
+    entry_point_ = node;
+    max_level_ = level;
+    return true;
+  }
+
+  NodeId entry = entry_point_;
+  for (int l = max_level_; l > level; --l) {
+    entry = Descend(query, entry, l);
+  }
+  for (int l = std::min(level, max_level_); l >= 0; --l) {
+    std::vector<Candidate> candidates =
+        SearchLayer(query, entry, options_.construction_breadth, l);
+    for (NodeId neighbor : SelectNeighbors(candidates, options_.max_links)) {
+      AddLink(node, neighbor, l);
+      AddLink(neighbor, node, l);
+    }
+    entry = candidates.front().node;
+  }
+
+  if (level > max_level_) {
+    max_level_ = level;
+    entry_point_ = node;
+  }
+  return true;
+}
+
+void HnswIndex::Remove(uint64_t id) {
+  auto it = live_nodes_.find(id);
+  if (it == live_nodes_.end()) {
+    return;
+  }
+  removed_[it->second] = true;
+  live_nodes_.erase(it);
+}
+
+std::vector<HnswIndex::Neighbor> HnswIndex::Search(const float* query,
+                                                   size_t count) const {
+  Quantized quantized;
+  if (max_level_ < 0 || count == 0 || !Quantize(query, &quantized)) {
+    return {};
+  }
+
+  NodeId entry = entry_point_;
+  for (int level = max_level_; level > 0; --level) {
+    entry = Descend(quantized, entry, level);
+  }
+  // Removed nodes are found too; look a little wider to make up for them
+  size_t breadth = std::max(options_.search_breadth, count) +
+                   std::min(node_count() - size(), count);
+  std::vector<Neighbor> neighbors;
+  for (const Candidate& candidate :
+       SearchLayer(quantized, entry, breadth, 0)) {
+    if (neighbors.size() == count) {
+      break;
+    }
+    if (!removed_[candidate.node]) {
+      neighbors.push_back({ids_[candidate.node], candidate.similarity});
+    }
+  }
+  return neighbors;
+}
+
+bool HnswIndex::Quantize(const float* embedding, Quantized* out) const {
+  std::vector<float> normalized(options_.dimension);
+  if (!Normalize(embedding, options_.dimension, normalized.data())) {
+    return false;
+  }
+  float max_magnitude = 0;
+  for (float value : normalized) {
+    max_magnitude = std::max(max_magnitude, std::abs(value));
+  }
+  out->scale = max_magnitude / 127.0f;
+  out->values.resize(options_.dimension);
+  for (size_t i = 0; i < options_.dimension; ++i) {
+    out->values[i] =
+        static_cast<int8_t>(std::lround(normalized[i] / out->scale));
+  }
+  return true;
+}
+
+float HnswIndex::Similarity(const Quantized& query, NodeId node) const {
+  const int8_t* row = vectors_.data() + node * options_.dimension;
+  return DotProductInt8(query.values.data(), row, options_.dimension) *
+         query.scale * scales_[node];
+}
+
+float HnswIndex::Similarity(NodeId a, NodeId b) const {
+  return DotProductInt8(vectors_.data() + a * options_.dimension,
+                        vectors_.data() + b * options_.dimension,
+                        options_.dimension) *
+         scales_[a] * scales_[b];
+}
+
+int HnswIndex::DrawLevel() {
+  // Uniform in (0, 1]
+  double uniform =
+      (static_cast<double>(NextRandom(&random_state_) >> 11) + 1.0) /
+      9007199254740992.0;
+  double level = -std::log(uniform) / std::log(options_.max_links);
+  return std::min(static_cast<int>(level), kMaxLevel);
+}
+
+size_t HnswIndex::MaxLinks(int level) const {
+  return level == 0 ? 2 * options_.max_links : options_.max_links;
+}
+
+HnswIndex::NodeId* HnswIndex::Links(NodeId node, int level) {
+  if (level == 0) {
+    return bottom_links_.data() + node * (1 + MaxLinks(0));
+  }
+  return upper_links_[node].data() + (level - 1) * (1 + MaxLinks(1));
+}
+
+const HnswIndex::NodeId* HnswIndex::Links(NodeId node, int level) const {
+  return const_cast<HnswIndex*>(this)->Links(node, level);
+}
+
+HnswIndex::NodeId HnswIndex::Descend(const Quantized& query,
+                                     NodeId entry,
+                                     int level) const {
+  NodeId current = entry;
+  float best = Similarity(query, current);
+  for (bool moved = true; moved;) {
+    moved = false;
+    const NodeId* links = Links(current, level);
+    for (NodeId i = 1; i <= links[0]; ++i) {
+      float similarity = Similarity(query, links[i]);
+      if (similarity > best) {
+        best = similarity;
+        current = links[i];
+        moved = true;
+      }
+    }
+  }
+  return current;
+}
+
+std::vector<HnswIndex::Candidate> HnswIndex::SearchLayer(
+    const Quantized& query,
+    NodeId entry,
+    size_t breadth,
+    int level) const {
+  if (++visit_mark_ == 0) {
+    std::fill(visited_.begin(), visited_.end(), 0);
+    visit_mark_ = 1;
+  }
+  auto closer_first = [](const Candidate& a, const Candidate& b) {
+    return MoreSimilar(b.similarity, b.node, a.similarity, a.node);
+  };
+  auto farther_first = [](const Candidate& a, const Candidate& b) {
+    return MoreSimilar(a.similarity, a.node, b.similarity, b.node);
+  };
+  // Nodes still to expand, best on top; the best found so far, worst on
+  // top so it can be replaced
+  std::priority_queue<Candidate, std::vector<Candidate>,
+                      decltype(closer_first)>
+      pending(closer_first);
+  std::priority_queue<Candidate, std::vector<Candidate>,
+                      decltype(farther_first)>
+      found(farther_first);
+
+  Candidate start = {Similarity(query, entry), entry};
+  visited_[entry] = visit_mark_;
+  pending.push(start);
+  found.push(start);
+  while (!pending.empty()) {
+    Candidate current = pending.top();
+    if (found.size() >= breadth &&
+        current.similarity < found.top().similarity) {
+      break;
+    }
+    pending.pop();
+
+    const NodeId* links = Links(current.node, level);
+    for (NodeId i = 1; i <= links[0]; ++i) {
+      NodeId neighbor = links[i];
+      if (visited_[neighbor] == visit_mark_) {
+        continue;
+      }
+      visited_[neighbor] = visit_mark_;
+      float similarity = Similarity(query, neighbor);
+      if (found.size() < breadth || similarity > found.top().similarity) {
+        pending.push({similarity, neighbor});
+        found.push({similarity, neighbor});
+        if (found.size() > breadth) {
+          found.pop();
+        }
+      }
+    }
+  }
+
+  std::vector<Candidate> result(found.size());
+  for (size_t i = result.size(); i > 0; --i) {
+    result[i - 1] = found.top();
+    found.pop();
+  }
+  return result;
+}
+
+std::vector<HnswIndex::NodeId> HnswIndex::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    size_t max) const {
+  std::vector<NodeId> selected;
+  std::vector<NodeId> skipped;
+  for (const Candidate& candidate : candidates) {
+    if (selected.size() == max) {
+      break;
+    }
+    bool diverse = std::none_of(
+        selected.begin(), selected.end(), [&](NodeId other) {
+          return Similarity(candidate.node, other) > candidate.similarity;
+        });
+    (diverse ? selected : skipped).push_back(candidate.node);
+  }
+  // Fill up with the nearest of the rest, so sparse regions stay linked
+  for (size_t i = 0; i < skipped.size() && selected.size() < max; ++i) {
+    selected.push_back(skipped[i]);
+  }
+  return selected;
+}
+
+void HnswIndex::AddLink(NodeId node, NodeId neighbor, int level) {
+  NodeId* links = Links(node, level);
+  size_t max = MaxLinks(level);
+  if (links[0] < max) {
+    links[++links[0]] = neighbor;
+    return;
+  }
+
+  std::vector<Candidate> candidates;
+  candidates.reserve(max + 1);
+  candidates.push_back({Similarity(node, neighbor), neighbor});
+  for (NodeId i = 1; i <= links[0]; ++i) {
+    candidates.push_back({Similarity(node, links[i]), links[i]});
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+              return MoreSimilar(a.similarity, a.node, b.similarity, b.node);
+            });
+  std::vector<NodeId> kept = SelectNeighbors(candidates, max);
+  links[0] = static_cast<NodeId>(kept.size());
+  std::copy(kept.begin(), kept.end(), links + 1);
+}
+
+}  // namespace core
+}  // namespace asol
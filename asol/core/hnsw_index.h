@@ -0,0 +1,161 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_HNSW_INDEX_H_
+#define ASOL_CORE_HNSW_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "base/files/file_path.h"
+
+namespace asol {
+namespace core {
+
+// HnswIndex finds the stored embeddings most similar to a query without
+// comparing it with all of them, so recall over 100k+ items takes about a
+// millisecond. It is a Hierarchical Navigable Small World graph: every
+// item links to its nearest neighbours, with a few items also on sparser
+// upper layers that let a search cross the graph in a few hops.
+//
+// Embeddings are L2-normalized and stored as int8 with one scale each, a
+// quarter of their float size, and compared by int8 dot product (see
+// DotProductInt8()), so similarities approximate cosine similarity.
+//
+// Items are identified by caller-chosen 64-bit IDs. Adding an ID again
+// replaces its embedding; removed and replaced items stay in the graph,
+// to keep it navigable, but are never returned. The index can be saved
+// to and loaded from a file, and is not thread-safe.
+class HnswIndex {
+ public:
+  struct Options {
+    size_t dimension = 0;
+
+    // Links per item on the upper layers; twice as many on the bottom one
+    size_t max_links = 16;
+
+    // Candidates considered when linking a new item, and when searching.
+    // Larger is more accurate and slower.
+    size_t construction_breadth = 100;
+    size_t search_breadth = 64;
+
+    // Seeds the layer draws, so building the same index twice gives the
+    // same graph
+    uint32_t seed = 1;
+  };
+
+  struct Neighbor {
+    uint64_t id;
+    float similarity;
+  };
+
+  explicit HnswIndex(const Options& options);
+  ~HnswIndex();
+
+  HnswIndex(const HnswIndex&) = delete;
+  HnswIndex& operator=(const HnswIndex&) = delete;
+
+  // Read an index written by Save(). Returns null if the file is missing
+  // or malformed.
+  static std::unique_ptr<HnswIndex> Load(const base::FilePath& path);
+
+  // Write the index to |path|, replacing the file atomically
+  bool Save(const base::FilePath& path) const;
+
+  // Store |embedding| of options().dimension floats under |id|. Returns
+  // false for a zero vector.
+  bool Add(uint64_t id, const float* embedding);
+
+  void Remove(uint64_t id);
+  bool Contains(uint64_t id) const { return live_nodes_.count(id) > 0; }
+
+  // Up to |count| stored items most similar to |query|, most similar first
+  std::vector<Neighbor> Search(const float* query, size_t count) const;
+
+  const Options& options() const { return options_; }
+
+  // Items that can be returned
+  size_t size() const { return live_nodes_.size(); }
+
+  // Nodes in the graph, including removed ones
+  size_t node_count() const { return ids_.size(); }
+
+ private:
+  using NodeId = uint32_t;
+
+  struct Candidate {
+    float similarity;
+    NodeId node;
+  };
+
+  // An embedding quantized for comparison
+  struct Quantized {
+    std::vector<int8_t> values;
+    float scale = 0;
+  };
+
+  bool Quantize(const float* embedding, Quantized* out) const;
+
+  float Similarity(const Quantized& query, NodeId node) const;
+  float Similarity(NodeId a, NodeId b) const;
+
+  int DrawLevel();
+  size_t MaxLinks(int level) const;
+
+  // Links of |node| on |level|: a count followed by MaxLinks(level) slots
+  NodeId* Links(NodeId node, int level);
+  const NodeId* Links(NodeId node, int level) const;
+
+  // Move from |entry| towards |query| on |level| one best neighbour at a
+  // time, as far as it gets closer
+  NodeId Descend(const Quantized& query, NodeId entry, int level) const;
+
+  // The |breadth| nodes nearest |query| on |level| found from |entry|,
+  // most similar first
+  std::vector<Candidate> SearchLayer(const Quantized& query,
+                                     NodeId entry,
+                                     size_t breadth,
+                                     int level) const;
+
+  // Keep up to |max| of |candidates| (most similar first) that are closer
+  // to the base node than to any kept before, so links point in different
+  // directions
+  std::vector<NodeId> SelectNeighbors(const std::vector<Candidate>& candidates,
+                                      size_t max) const;
+
+  // Link |node| to |neighbor| on |level|, pruning its links if full
+  void AddLink(NodeId node, NodeId neighbor, int level);
+
+  Options options_;
+  uint64_t random_state_;
+
+  // Per node
+  std::vector<uint64_t> ids_;
+  std::vector<int8_t> vectors_;  // node_count() rows of dimension values
+  std::vector<float> scales_;
+  std::vector<int> levels_;
+  std::vector<bool> removed_;
+
+  // Bottom-layer links in one array of fixed-size rows; upper-layer links
+  // per node, one row per level above the bottom
+  std::vector<NodeId> bottom_links_;
+  std::vector<std::vector<NodeId>> upper_links_;
+
+  NodeId entry_point_ = 0;
+  int max_level_ = -1;
+
+  std::unordered_map<uint64_t, NodeId> live_nodes_;
+
+  // Visit marks of the search in progress
+  mutable std::vector<uint32_t> visited_;
+  mutable uint32_t visit_mark_ = 0;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_HNSW_INDEX_H_
@@ -0,0 +1,200 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/hnsw_index.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "asol/core/vector_kernels.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+constexpr size_t kDimension = 32;
+
+std::vector<float> RandomVectors(size_t count, uint32_t seed) {
+  std::mt19937 generator(seed);
+  std::normal_distribution<float> distribution;
+  std::vector<float> vectors(count * kDimension);
+  for (float& value : vectors) {
+    value = distribution(generator);
+  }
+  NormalizeRows(vectors.data(), count, kDimension);
+  return vectors;
+}
+
+// IDs of the |count| rows most similar to |query|, by exact search
+std::vector<uint64_t> BruteForce(const std::vector<float>& vectors,
+                                 const float* query,
+                                 size_t count) {
+  std::vector<std::pair<float, uint64_t>> scored;
+  for (size_t row = 0; row < vectors.size() / kDimension; ++row) {
+    scored.emplace_back(
+        -DotProduct(query, vectors.data() + row * kDimension, kDimension),
+        row);
+  }
+  std::partial_sort(scored.begin(), scored.begin() + count, scored.end());
+  std::vector<uint64_t> ids;
+  for (size_t i = 0; i < count; ++i) {
+    ids.push_back(scored[i].second);
+  }
+  return ids;
+}
+
+HnswIndex::Options DefaultOptions() {
+  HnswIndex::Options options;
+  options.dimension = kDimension;
+  return options;
+}
+
+TEST(HnswIndexTest, EmptyIndexFindsNothing) {
+  HnswIndex index(DefaultOptions());
+  std::vector<float> query = RandomVectors(1, 1);
+  EXPECT_TRUE(index.Search(query.data(), 5).empty());
+}
+
+TEST(HnswIndexTest, RejectsZeroVector) {
+  HnswIndex index(DefaultOptions());
+  std::vector<float> zero(kDimension, 0.0f);
+  EXPECT_FALSE(index.Add(1, zero.data()));
+  EXPECT_EQ(index.size(), 0u);
+}
+
+TEST(HnswIndexTest, FindsExactMatchFirst) {
+  HnswIndex index(DefaultOptions());
+  std::vector<float> vectors = RandomVectors(500, 2);
+  for (size_t row = 0; row < 500; ++row) {
+    ASSERT_TRUE(index.Add(row, vectors.data() + row * kDimension));
+  }
+  for (size_t row = 0; row < 500; row += 50) {
+    std::vector<HnswIndex::Neighbor> neighbors =
+        index.Search(vectors.data() + row * kDimension, 1);
+    ASSERT_EQ(neighbors.size(), 1u);
+    EXPECT_EQ(neighbors[0].id, row);
+    EXPECT_NEAR(neighbors[0].similarity, 1.0f, 0.02f);
+  }
+}
+
+TEST(HnswIndexTest, RecallMatchesBruteForce) {
+  constexpr size_t kCount = 5000;
+  constexpr size_t kNeighbors = 10;
+  HnswIndex index(DefaultOptions());
+  std::vector<float> vectors = RandomVectors(kCount, 3);
+  for (size_t row = 0; row < kCount; ++row) {
+    ASSERT_TRUE(index.Add(row, vectors.data() + row * kDimension));
+  }
+
+  std::vector<float> queries = RandomVectors(50, 4);
+  size_t found = 0;
+  for (size_t q = 0; q < 50; ++q) {
+    const float* query = queries.data() + q * kDimension;
+    std::vector<uint64_t> expected = BruteForce(vectors, query, kNeighbors);
+    std::vector<HnswIndex::Neighbor> neighbors =
+        index.Search(query, kNeighbors);
+    ASSERT_EQ(neighbors.size(), kNeighbors);
+    for (size_t i = 1; i < neighbors.size(); ++i) {
+      EXPECT_GE(neighbors[i - 1].similarity, neighbors[i].similarity);
+    }
+    for (const HnswIndex::Neighbor& neighbor : neighbors) {
+      found += std::count(expected.begin(), expected.end(), neighbor.id);
+    }
+  }
+  // Quantization and the approximate search may swap near ties
+  EXPECT_GE(found, 50 * kNeighbors * 9 / 10);
+}
+
+TEST(HnswIndexTest, ReplacesAndRemoves) {
+  HnswIndex index(DefaultOptions());
+  std::vector<float> vectors = RandomVectors(200, 5);
+  for (size_t row = 0; row < 100; ++row) {
+    ASSERT_TRUE(index.Add(row, vectors.data() + row * kDimension));
+  }
+
+  // Item 7 moves to where row 150 is; its old embedding is not found
+  ASSERT_TRUE(index.Add(7, vectors.data() + 150 * kDimension));
+  EXPECT_EQ(index.size(), 100u);
+  EXPECT_EQ(index.node_count(), 101u);
+  EXPECT_EQ(index.Search(vectors.data() + 150 * kDimension, 1)[0].id, 7u);
+  for (const HnswIndex::Neighbor& neighbor :
+       index.Search(vectors.data() + 7 * kDimension, 3)) {
+    EXPECT_NE(neighbor.similarity, 1.0f);
+  }
+
+  index.Remove(7);
+  EXPECT_FALSE(index.Contains(7));
+  for (const HnswIndex::Neighbor& neighbor :
+       index.Search(vectors.data() + 150 * kDimension, 100)) {
+    EXPECT_NE(neighbor.id, 7u);
+  }
+  EXPECT_EQ(index.Search(vectors.data() + 150 * kDimension, 200).size(),
+            99u);
+}
+
+TEST(HnswIndexTest, SaveAndLoadRoundTrip) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().AppendASCII("memory.hnsw");
+
+  HnswIndex index(DefaultOptions());
+  std::vector<float> vectors = RandomVectors(1000, 6);
+  for (size_t row = 0; row < 1000; ++row) {
+    ASSERT_TRUE(index.Add(row * 3, vectors.data() + row * kDimension));
+  }
+  index.Remove(0);
+  ASSERT_TRUE(index.Save(path));
+
+  std::unique_ptr<HnswIndex> loaded = HnswIndex::Load(path);
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(loaded->size(), 999u);
+  EXPECT_EQ(loaded->options().dimension, kDimension);
+  EXPECT_FALSE(loaded->Contains(0));
+  EXPECT_TRUE(loaded->Contains(3));
+
+  std::vector<float> queries = RandomVectors(10, 7);
+  for (size_t q = 0; q < 10; ++q) {
+    const float* query = queries.data() + q * kDimension;
+    std::vector<HnswIndex::Neighbor> before = index.Search(query, 5);
+    std::vector<HnswIndex::Neighbor> after = loaded->Search(query, 5);
+    ASSERT_EQ(before.size(), after.size());
+    for (size_t i = 0; i < before.size(); ++i) {
+      EXPECT_EQ(before[i].id, after[i].id);
+    }
+  }
+
+  // The loaded index keeps growing the same way
+  ASSERT_TRUE(loaded->Add(5000, vectors.data()));
+  EXPECT_EQ(loaded->Search(vectors.data(), 1)[0].id, 5000u);
+}
+
+TEST(HnswIndexTest, LoadRejectsMalformedFiles) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().AppendASCII("memory.hnsw");
+  EXPECT_FALSE(HnswIndex::Load(path));
+
+  ASSERT_TRUE(base::WriteFile(path, "not an index"));
+  EXPECT_FALSE(HnswIndex::Load(path));
+
+  HnswIndex index(DefaultOptions());
+  std::vector<float> vectors = RandomVectors(20, 8);
+  for (size_t row = 0; row < 20; ++row) {
+    ASSERT_TRUE(index.Add(row, vectors.data() + row * kDimension));
+  }
+  ASSERT_TRUE(index.Save(path));
+  std::string data;
+  ASSERT_TRUE(base::ReadFileToString(path, &data));
+  ASSERT_TRUE(base::WriteFile(path, data.substr(0, data.size() - 1)));
+  EXPECT_FALSE(HnswIndex::Load(path));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,154 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/inference_executor.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/location.h"
+#include "base/system/sys_info.h"
+#include "base/task/sequenced_task_runner.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+size_t DefaultThreadCount() {
+  // Assume two hardware threads per core
+  return std::max(1, base::SysInfo::NumberOfProcessors() / 2);
+}
+
+size_t LaneIndex(InferenceExecutor::Lane lane) {
+  return static_cast<size_t>(lane);
+}
+
+}  // namespace
+
+InferenceExecutor::Job::Job() = default;
+InferenceExecutor::Job::Job(Job&&) = default;
+InferenceExecutor::Job& InferenceExecutor::Job::operator=(Job&&) = default;
+InferenceExecutor::Job::~Job() = default;
+
+InferenceExecutor::InferenceExecutor(const Options& options)
+    : job_available_(&lock_) {
+  size_t thread_count =
+      options.thread_count ? options.thread_count : DefaultThreadCount();
+  threads_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads_.push_back(std::make_unique<base::DelegateSimpleThread>(
+        this, "AsolInferenceWorker"));
+    threads_.back()->Start();
+  }
+}
+
+InferenceExecutor::~InferenceExecutor() {
+  std::array<std::deque<Job>, kLaneCount> dropped;
+  {
+    base::AutoLock lock(lock_);
+    shutting_down_ = true;
+    dropped.swap(queues_);
+  }
+  job_available_.Broadcast();
+  for (auto& thread : threads_) {
+    thread->Join();
+  }
+}
+
+// static
+InferenceExecutor::Lane InferenceExecutor::LaneForPriority(
+    RequestPriority priority) {
+  return priority == RequestPriority::INTERACTIVE ? Lane::kInteractive
+                                                  : Lane::kBackground;
+}
+
+void InferenceExecutor::PostJob(Lane lane,
+                                StepCallback step,
+                                base::OnceClosure reply) {
+  Job job;
+  job.lane = lane;
+  job.step = std::move(step);
+  job.reply = std::move(reply);
+  job.reply_task_runner = base::SequencedTaskRunner::GetCurrentDefault();
+  {
+    base::AutoLock lock(lock_);
+    if (shutting_down_) {
+      return;
+    }
+    queues_[LaneIndex(lane)].push_back(std::move(job));
+  }
+  job_available_.Signal();
+}
+
+InferenceExecutor::Metrics InferenceExecutor::GetMetrics() const {
+  base::AutoLock lock(lock_);
+  Metrics metrics = metrics_;
+  for (size_t i = 0; i < kLaneCount; ++i) {
+    metrics.queued[i] = queues_[i].size();
+  }
+  return metrics;
+}
+
+void InferenceExecutor::Run() {
+  Job job;
+  while (TakeJob(&job)) {
+    bool more_steps = true;
+    bool yielded = false;
+    while (more_steps) {
+      more_steps = job.step.Run();
+      if (more_steps && ShouldYield(job.lane)) {
+        yielded = true;
+        break;
+      }
+    }
+
+    const size_t lane = LaneIndex(job.lane);
+    {
+      base::AutoLock lock(lock_);
+      metrics_.running[lane]--;
+      if (yielded) {
+        if (shutting_down_) {
+          continue;  // Dropped with the rest of the queue
+        }
+        // Resume ahead of background work queued later
+        metrics_.yields++;
+        queues_[lane].push_front(std::move(job));
+        continue;
+      }
+      metrics_.completed[lane]++;
+    }
+    job.reply_task_runner->PostTask(FROM_HERE, std::move(job.reply));
+  }
+}
+
+bool InferenceExecutor::TakeJob(Job* job) {
+  base::AutoLock lock(lock_);
+  while (!shutting_down_ && queues_[0].empty() && queues_[1].empty()) {
+    job_available_.Wait();
+  }
+  if (shutting_down_) {
+    return false;
+  }
+  std::deque<Job>& queue =
+      queues_[LaneIndex(Lane::kInteractive)].empty()
+          ? queues_[LaneIndex(Lane::kBackground)]
+          : queues_[LaneIndex(Lane::kInteractive)];
+  *job = std::move(queue.front());
+  queue.pop_front();
+  metrics_.running[LaneIndex(job->lane)]++;
+  return true;
+}
+
+bool InferenceExecutor::ShouldYield(Lane lane) const {
+  base::AutoLock lock(lock_);
+  if (shutting_down_) {
+    return true;
+  }
+  return lane == Lane::kBackground &&
+         !queues_[LaneIndex(Lane::kInteractive)].empty();
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,124 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_INFERENCE_EXECUTOR_H_
+#define ASOL_CORE_INFERENCE_EXECUTOR_H_
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "asol/core/request_scheduler.h"
+#include "base/functional/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/simple_thread.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace asol {
+namespace core {
+
+// InferenceExecutor runs local model inference on its own threads, apart
+// from the general-purpose thread pool, so long forward passes neither
+// queue behind unrelated tasks nor hold up the rest of the browser.
+//
+// Work arrives in two lanes. Interactive jobs are always taken first.
+// A job is a sequence of steps, typically one model layer each; between
+// steps, a background job hands its thread back whenever interactive work
+// is waiting and resumes later from the next step. An urgent request thus
+// waits for at most one layer, not a whole background inference.
+//
+// The number of threads defaults to the number of physical cores (taken
+// as half the logical processors): inference is limited by the vector
+// units that hyper-threads share, and leaving the siblings free keeps the
+// UI responsive.
+//
+// Jobs may be posted from any sequence; replies run on the poster's
+// sequence. Destroying the executor drops queued jobs without replying and
+// waits for running steps to finish.
+class InferenceExecutor : public base::DelegateSimpleThread::Delegate {
+ public:
+  enum class Lane {
+    kInteractive = 0,
+    kBackground = 1,
+  };
+  static constexpr size_t kLaneCount = 2;
+
+  // Runs the next step of a job. Returns true while steps remain.
+  using StepCallback = base::RepeatingCallback<bool()>;
+
+  struct Options {
+    // Worker threads; zero means one per physical core
+    size_t thread_count = 0;
+  };
+
+  // Snapshot of the executor's load, per lane
+  struct Metrics {
+    std::array<size_t, kLaneCount> queued = {};
+    std::array<size_t, kLaneCount> running = {};
+    std::array<size_t, kLaneCount> completed = {};
+
+    // Times a background job gave its thread to interactive work
+    size_t yields = 0;
+  };
+
+  explicit InferenceExecutor(const Options& options);
+  ~InferenceExecutor() override;
+
+  InferenceExecutor(const InferenceExecutor&) = delete;
+  InferenceExecutor& operator=(const InferenceExecutor&) = delete;
+
+  // Lane for work of |priority|: only interactive requests jump the queue
+  static Lane LaneForPriority(RequestPriority priority);
+
+  // Run |step| on a worker until it returns false, then post |reply| to
+  // the current sequence.
+  void PostJob(Lane lane, StepCallback step, base::OnceClosure reply);
+
+  Metrics GetMetrics() const;
+  size_t GetThreadCount() const { return threads_.size(); }
+
+ private:
+  struct Job {
+    Job();
+    Job(Job&&);
+    Job& operator=(Job&&);
+    ~Job();
+
+    Lane lane = Lane::kBackground;
+    StepCallback step;
+    base::OnceClosure reply;
+    scoped_refptr<base::SequencedTaskRunner> reply_task_runner;
+  };
+
+  // base::DelegateSimpleThread::Delegate:
+  void Run() override;
+
+  // Wait for a job, interactive first. Returns false on shutdown.
+  bool TakeJob(Job* job);
+
+  // Whether a job of |lane| should stop between steps: background jobs
+  // when interactive work waits, any job on shutdown
+  bool ShouldYield(Lane lane) const;
+
+  mutable base::Lock lock_;
+  base::ConditionVariable job_available_;
+  std::array<std::deque<Job>, kLaneCount> queues_ GUARDED_BY(lock_);
+  Metrics metrics_ GUARDED_BY(lock_);
+  bool shutting_down_ GUARDED_BY(lock_) = false;
+
+  std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_INFERENCE_EXECUTOR_H_
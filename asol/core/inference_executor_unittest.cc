@@ -0,0 +1,114 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/inference_executor.h"
+
+#include <string>
+#include <vector>
+
+#include "base/barrier_closure.h"
+#include "base/run_loop.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+using Lane = InferenceExecutor::Lane;
+
+class InferenceExecutorTest : public testing::Test {
+ protected:
+  void Record(const std::string& event) {
+    base::AutoLock lock(lock_);
+    events_.push_back(event);
+  }
+
+  std::vector<std::string> GetEvents() {
+    base::AutoLock lock(lock_);
+    return events_;
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::Lock lock_;
+  std::vector<std::string> events_;
+};
+
+TEST_F(InferenceExecutorTest, InteractiveJobPreemptsBackgroundBetweenSteps) {
+  InferenceExecutor executor({/*thread_count=*/1});
+  base::WaitableEvent first_step_running;
+  base::WaitableEvent interactive_posted;
+
+  base::RunLoop run_loop;
+  auto done = base::BarrierClosure(2, run_loop.QuitClosure());
+  int layer = 0;
+  executor.PostJob(Lane::kBackground,
+                   base::BindLambdaForTesting([&]() {
+                     Record("background " + std::to_string(layer));
+                     if (layer == 0) {
+                       first_step_running.Signal();
+                       interactive_posted.Wait();
+                     }
+                     return ++layer < 3;
+                   }),
+                   done);
+
+  first_step_running.Wait();
+  executor.PostJob(Lane::kInteractive, base::BindLambdaForTesting([&]() {
+                     Record("interactive");
+                     return false;
+                   }),
+                   done);
+  interactive_posted.Signal();
+  run_loop.Run();
+
+  EXPECT_EQ(GetEvents(),
+            std::vector<std::string>({"background 0", "interactive",
+                                      "background 1", "background 2"}));
+  InferenceExecutor::Metrics metrics = executor.GetMetrics();
+  EXPECT_EQ(metrics.yields, 1u);
+  EXPECT_EQ(metrics.completed[0], 1u);
+  EXPECT_EQ(metrics.completed[1], 1u);
+  EXPECT_EQ(metrics.queued[1], 0u);
+  EXPECT_EQ(metrics.running[1], 0u);
+}
+
+TEST_F(InferenceExecutorTest, RepliesOnPostingSequence) {
+  InferenceExecutor executor({/*thread_count=*/3});
+  EXPECT_EQ(executor.GetThreadCount(), 3u);
+
+  constexpr int kJobs = 20;
+  base::RunLoop run_loop;
+  auto done = base::BarrierClosure(kJobs, run_loop.QuitClosure());
+  int replies = 0;
+  for (int i = 0; i < kJobs; ++i) {
+    executor.PostJob(
+        i % 2 ? Lane::kInteractive : Lane::kBackground,
+        base::BindRepeating([]() { return false; }),
+        base::BindLambdaForTesting([&]() {
+          EXPECT_TRUE(task_environment_.GetMainThreadTaskRunner()
+                          ->RunsTasksInCurrentSequence());
+          replies++;
+          done.Run();
+        }));
+  }
+  run_loop.Run();
+  EXPECT_EQ(replies, kJobs);
+}
+
+TEST_F(InferenceExecutorTest, LaneForPriority) {
+  EXPECT_EQ(InferenceExecutor::LaneForPriority(RequestPriority::INTERACTIVE),
+            Lane::kInteractive);
+  EXPECT_EQ(InferenceExecutor::LaneForPriority(RequestPriority::PREFETCH),
+            Lane::kBackground);
+  EXPECT_EQ(InferenceExecutor::LaneForPriority(RequestPriority::BACKGROUND),
+            Lane::kBackground);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,144 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/kv_cache_pool.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Approximate bookkeeping cost of one entry (list node, index slots)
+constexpr size_t kEntryOverheadBytes = 128;
+
+}  // namespace
+
+KvCachePool::KvCachePool(size_t max_bytes, size_t block_size)
+    : max_bytes_(max_bytes), block_size_(std::max<size_t>(block_size, 1)) {}
+
+KvCachePool::~KvCachePool() = default;
+
+KvCachePool::Match KvCachePool::Lookup(base::span<const int32_t> tokens) {
+  Match match;
+  if (tokens.size() <= block_size_) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return match;
+  }
+  // Hash outside the lock
+  std::vector<RequestFingerprint> keys =
+      PrefixKeys(tokens, tokens.size() - 1);
+
+  base::AutoLock lock(lock_);
+  for (size_t i = keys.size(); i-- > 0;) {
+    auto it = index_.find(keys[i]);
+    if (it == index_.end()) {
+      continue;
+    }
+    const Entry& entry = *it->second;
+    size_t length = (i + 1) * block_size_;
+    if (entry.tokens.size() < length ||
+        !std::equal(tokens.begin(), tokens.begin() + length,
+                    entry.tokens.begin())) {
+      continue;  // A hash collision
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    match.state = entry.state;
+    match.prefix_length = length;
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    reused_tokens_.fetch_add(length, std::memory_order_relaxed);
+    return match;
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return match;
+}
+
+void KvCachePool::Insert(base::span<const int32_t> tokens,
+                         scoped_refptr<const State> state) {
+  if (!state || tokens.size() < block_size_) {
+    return;
+  }
+  Entry new_entry;
+  new_entry.tokens.assign(tokens.begin(), tokens.end());
+  new_entry.state = std::move(state);
+  new_entry.charge = new_entry.state->GetByteSize() +
+                     tokens.size() * sizeof(int32_t) + kEntryOverheadBytes;
+  if (new_entry.charge > max_bytes_) {
+    return;
+  }
+  std::vector<RequestFingerprint> keys = PrefixKeys(tokens, tokens.size());
+
+  base::AutoLock lock(lock_);
+  lru_.push_front(std::move(new_entry));
+  auto entry = lru_.begin();
+  bytes_ += entry->charge;
+
+  // The newest state takes over every prefix it shares with older ones.
+  // An older state left with no prefix of its own is unreachable.
+  for (const RequestFingerprint& key : keys) {
+    auto [it, inserted] = index_.try_emplace(key, entry);
+    if (!inserted) {
+      auto previous = it->second;
+      it->second = entry;
+      if (--previous->live_keys == 0) {
+        bytes_ -= previous->charge;
+        lru_.erase(previous);
+      }
+    }
+    entry->live_keys++;
+  }
+
+  while (bytes_ > max_bytes_ && std::prev(lru_.end()) != entry) {
+    Erase(std::prev(lru_.end()));
+  }
+}
+
+void KvCachePool::Clear() {
+  base::AutoLock lock(lock_);
+  index_.clear();
+  lru_.clear();
+  bytes_ = 0;
+}
+
+size_t KvCachePool::GetByteSize() const {
+  base::AutoLock lock(lock_);
+  return bytes_;
+}
+
+size_t KvCachePool::GetEntryCount() const {
+  base::AutoLock lock(lock_);
+  return lru_.size();
+}
+
+std::vector<RequestFingerprint> KvCachePool::PrefixKeys(
+    base::span<const int32_t> tokens,
+    size_t max_length) const {
+  std::vector<RequestFingerprint> keys;
+  keys.reserve(max_length / block_size_);
+  Hasher128 hasher(block_size_);
+  for (size_t end = block_size_; end <= max_length; end += block_size_) {
+    hasher.Update(tokens.data() + end - block_size_,
+                  block_size_ * sizeof(int32_t));
+    keys.push_back(hasher.Finish());
+  }
+  return keys;
+}
+
+void KvCachePool::Erase(LruList::iterator entry) {
+  for (const RequestFingerprint& key :
+       PrefixKeys(entry->tokens, entry->tokens.size())) {
+    auto it = index_.find(key);
+    if (it != index_.end() && it->second == entry) {
+      index_.erase(it);
+    }
+  }
+  bytes_ -= entry->charge;
+  lru_.erase(entry);
+}
+
+}  // namespace core
+}  // namespace asol
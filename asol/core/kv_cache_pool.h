@@ -0,0 +1,130 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_KV_CACHE_POOL_H_
+#define ASOL_CORE_KV_CACHE_POOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "asol/core/request_fingerprint.h"
+#include "base/containers/span.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+namespace asol {
+namespace core {
+
+// KvCachePool keeps the attention state (KV cache) the local text model
+// computed for recent prompts, so a prompt that starts the same way, such
+// as a follow-up question about the same page or another request with the
+// same system prompt, only prefills its new suffix.
+//
+// A prompt's tokens are hashed in blocks of |block_size|; the hash of
+// every block-aligned prefix indexes the state that covers it. A lookup
+// walks the blocks of the new prompt and returns the state behind the
+// longest prefix it shares with a cached one, after comparing the tokens.
+// Since the KV cache of a prefix is the leading part of the KV cache of
+// any longer prompt, one state serves every prefix of its prompt, and a
+// state whose prefixes are all covered by a newer, longer one is dropped.
+// Bounded by bytes, least recently used first.
+//
+// Safe to use from any thread.
+class KvCachePool : public base::RefCountedThreadSafe<KvCachePool> {
+ public:
+  // Attention state after a sequence of tokens, in the model's own layout.
+  // Immutable once cached: a model resuming from it copies the positions
+  // it needs.
+  class State : public base::RefCountedThreadSafe<State> {
+   public:
+    virtual size_t GetByteSize() const = 0;
+
+   protected:
+    friend class base::RefCountedThreadSafe<State>;
+    virtual ~State() = default;
+  };
+
+  struct Match {
+    // Null on a miss
+    scoped_refptr<const State> state;
+
+    // Leading tokens whose state can be taken from |state|
+    size_t prefix_length = 0;
+  };
+
+  KvCachePool(size_t max_bytes, size_t block_size = 64);
+
+  KvCachePool(const KvCachePool&) = delete;
+  KvCachePool& operator=(const KvCachePool&) = delete;
+
+  // Find the longest cached block-aligned prefix of |tokens|. At least one
+  // token is always left over, so the model has something to prefill for
+  // the next-token logits.
+  Match Lookup(base::span<const int32_t> tokens);
+
+  // Cache |state|, the attention state after all of |tokens|. Prompts
+  // shorter than one block are not cached.
+  void Insert(base::span<const int32_t> tokens,
+              scoped_refptr<const State> state);
+
+  void Clear();
+
+  size_t GetHitCount() const { return hits_.load(std::memory_order_relaxed); }
+  size_t GetMissCount() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+  // Tokens whose prefill was skipped thanks to hits
+  size_t GetReusedTokenCount() const {
+    return reused_tokens_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetByteSize() const;
+  size_t GetEntryCount() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<KvCachePool>;
+
+  struct Entry {
+    std::vector<int32_t> tokens;
+    scoped_refptr<const State> state;
+    size_t charge = 0;
+
+    // Prefix keys that still point at this entry
+    size_t live_keys = 0;
+  };
+  using LruList = std::list<Entry>;
+
+  ~KvCachePool();
+
+  // Keys of every block-aligned prefix of |tokens| up to |max_length|
+  std::vector<RequestFingerprint> PrefixKeys(base::span<const int32_t> tokens,
+                                             size_t max_length) const;
+
+  void Erase(LruList::iterator entry) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  const size_t max_bytes_;
+  const size_t block_size_;
+
+  mutable base::Lock lock_;
+  size_t bytes_ GUARDED_BY(lock_) = 0;
+  LruList lru_ GUARDED_BY(lock_);
+  std::unordered_map<RequestFingerprint,
+                     LruList::iterator,
+                     RequestFingerprint::Hash>
+      index_ GUARDED_BY(lock_);
+
+  std::atomic<size_t> hits_{0};
+  std::atomic<size_t> misses_{0};
+  std::atomic<size_t> reused_tokens_{0};
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_KV_CACHE_POOL_H_
@@ -0,0 +1,113 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/kv_cache_pool.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+constexpr size_t kBlockSize = 4;
+
+class FakeState : public KvCachePool::State {
+ public:
+  explicit FakeState(size_t bytes) : bytes_(bytes) {}
+  size_t GetByteSize() const override { return bytes_; }
+
+ private:
+  ~FakeState() override = default;
+
+  size_t bytes_;
+};
+
+scoped_refptr<const KvCachePool::State> MakeState(size_t bytes = 1000) {
+  return base::MakeRefCounted<FakeState>(bytes);
+}
+
+std::vector<int32_t> Tokens(int32_t first, size_t count) {
+  std::vector<int32_t> tokens(count);
+  for (size_t i = 0; i < count; ++i) {
+    tokens[i] = first + static_cast<int32_t>(i);
+  }
+  return tokens;
+}
+
+std::vector<int32_t> Concat(std::vector<int32_t> a,
+                            const std::vector<int32_t>& b) {
+  a.insert(a.end(), b.begin(), b.end());
+  return a;
+}
+
+TEST(KvCachePoolTest, FollowUpReusesSharedPrefix) {
+  auto pool = base::MakeRefCounted<KvCachePool>(1 << 20, kBlockSize);
+  std::vector<int32_t> page = Tokens(100, 10);
+  auto state = MakeState();
+  pool->Insert(Concat(page, Tokens(1, 3)), state);
+
+  // Same page, different question: the two whole blocks of the page match
+  KvCachePool::Match match = pool->Lookup(Concat(page, Tokens(50, 5)));
+  EXPECT_EQ(match.state, state);
+  EXPECT_EQ(match.prefix_length, 8u);
+  EXPECT_EQ(pool->GetReusedTokenCount(), 8u);
+
+  EXPECT_FALSE(pool->Lookup(Tokens(7, 20)).state);
+  EXPECT_EQ(pool->GetHitCount(), 1u);
+  EXPECT_EQ(pool->GetMissCount(), 1u);
+}
+
+TEST(KvCachePoolTest, LeavesAtLeastOneTokenToPrefill) {
+  auto pool = base::MakeRefCounted<KvCachePool>(1 << 20, kBlockSize);
+  std::vector<int32_t> prompt = Tokens(0, 8);
+  pool->Insert(prompt, MakeState());
+  EXPECT_EQ(pool->Lookup(prompt).prefix_length, 4u);
+  EXPECT_EQ(pool->Lookup(Tokens(0, 9)).prefix_length, 8u);
+}
+
+TEST(KvCachePoolTest, LongerStateReplacesItsPrefix) {
+  auto pool = base::MakeRefCounted<KvCachePool>(1 << 20, kBlockSize);
+  pool->Insert(Tokens(0, 8), MakeState());
+  auto longer = MakeState();
+  pool->Insert(Tokens(0, 16), longer);
+  EXPECT_EQ(pool->GetEntryCount(), 1u);
+  EXPECT_EQ(pool->Lookup(Tokens(0, 9)).state, longer);
+
+  // A sibling keeps its own tail, so both stay
+  pool->Insert(Concat(Tokens(0, 8), Tokens(500, 8)), MakeState());
+  EXPECT_EQ(pool->GetEntryCount(), 2u);
+  EXPECT_EQ(pool->Lookup(Tokens(0, 17)).state, longer);
+}
+
+TEST(KvCachePoolTest, EvictsLeastRecentlyUsed) {
+  auto pool = base::MakeRefCounted<KvCachePool>(3000, kBlockSize);
+  auto first = MakeState();
+  pool->Insert(Tokens(0, 8), first);
+  pool->Insert(Tokens(100, 8), MakeState());
+  EXPECT_EQ(pool->Lookup(Tokens(0, 9)).state, first);
+
+  pool->Insert(Tokens(200, 8), MakeState());
+  EXPECT_EQ(pool->GetEntryCount(), 2u);
+  EXPECT_LE(pool->GetByteSize(), 3000u);
+  EXPECT_TRUE(pool->Lookup(Tokens(0, 9)).state);
+  EXPECT_FALSE(pool->Lookup(Tokens(100, 9)).state);
+
+  // Larger than the whole pool
+  pool->Insert(Tokens(300, 8), MakeState(4000));
+  EXPECT_FALSE(pool->Lookup(Tokens(300, 9)).state);
+}
+
+TEST(KvCachePoolTest, ShortPromptsAreNotCached) {
+  auto pool = base::MakeRefCounted<KvCachePool>(1 << 20, kBlockSize);
+  pool->Insert(Tokens(0, 3), MakeState());
+  EXPECT_EQ(pool->GetEntryCount(), 0u);
+  pool->Clear();
+  EXPECT_EQ(pool->GetByteSize(), 0u);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,132 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Decay is applied lazily once this fraction of a half-life has passed, so a
+// burst of samples does not pay for a full pass over the buckets each time
+constexpr int kDecayStepsPerHalfLife = 32;
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram(base::TimeDelta half_life)
+    : half_life_(half_life) {
+  buckets_.fill(0.0);
+}
+
+LatencyHistogram::~LatencyHistogram() = default;
+
+LatencyHistogram::LatencyHistogram(const LatencyHistogram&) = default;
+LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram&) =
+    default;
+
+void LatencyHistogram::Record(double latency_ms, base::TimeTicks now) {
+  Decay(now);
+  buckets_[BucketForValue(latency_ms)] += 1.0;
+  total_weight_ += 1.0;
+}
+
+double LatencyHistogram::Percentile(double q) const {
+  if (total_weight_ <= 0.0) {
+    return 0.0;
+  }
+
+  double target = std::clamp(q, 0.0, 1.0) * total_weight_;
+  double cumulative = 0.0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    double weight = buckets_[i];
+    if (weight <= 0.0) {
+      continue;
+    }
+    if (cumulative + weight >= target) {
+      // Interpolate linearly inside the bucket
+      double low, high;
+      GetBucketRange(i, &low, &high);
+      return low + (high - low) * ((target - cumulative) / weight);
+    }
+    cumulative += weight;
+  }
+
+  // Rounding left |target| just past the last bucket
+  for (size_t i = kBucketCount; i > 0; --i) {
+    if (buckets_[i - 1] > 0.0) {
+      double low, high;
+      GetBucketRange(i - 1, &low, &high);
+      return high;
+    }
+  }
+  return 0.0;
+}
+
+void LatencyHistogram::Clear() {
+  buckets_.fill(0.0);
+  total_weight_ = 0.0;
+  last_decay_ = base::TimeTicks();
+}
+
+// static
+size_t LatencyHistogram::BucketForValue(double latency_ms) {
+  if (!(latency_ms > 0.0)) {
+    return 0;
+  }
+  uint64_t value = static_cast<uint64_t>(
+      std::min(latency_ms, static_cast<double>(uint64_t{1} << kMaxExponent)));
+  if (value < kSubBuckets) {
+    return static_cast<size_t>(value);
+  }
+
+  // Index of the highest set bit, at least 4 here
+  size_t exponent = 63 - static_cast<size_t>(__builtin_clzll(value));
+  if (exponent >= kMaxExponent) {
+    return kBucketCount - 1;
+  }
+  size_t shift = exponent - 4;
+  size_t sub_bucket = static_cast<size_t>(value >> shift) - kSubBuckets;
+  return kSubBuckets + shift * kSubBuckets + sub_bucket;
+}
+
+// static
+void LatencyHistogram::GetBucketRange(size_t bucket,
+                                      double* low,
+                                      double* high) {
+  if (bucket < kSubBuckets) {
+    *low = static_cast<double>(bucket);
+    *high = *low + 1.0;
+    return;
+  }
+  size_t shift = (bucket - kSubBuckets) / kSubBuckets;
+  size_t sub_bucket = (bucket - kSubBuckets) % kSubBuckets;
+  *low = static_cast<double>((kSubBuckets + sub_bucket) << shift);
+  *high = *low + static_cast<double>(size_t{1} << shift);
+}
+
+void LatencyHistogram::Decay(base::TimeTicks now) {
+  if (last_decay_.is_null() || half_life_.is_zero()) {
+    last_decay_ = now;
+    return;
+  }
+
+  base::TimeDelta elapsed = now - last_decay_;
+  if (elapsed < half_life_ / kDecayStepsPerHalfLife) {
+    return;
+  }
+
+  double factor = std::exp2(-(elapsed / half_life_));
+  for (double& weight : buckets_) {
+    weight *= factor;
+  }
+  total_weight_ *= factor;
+  last_decay_ = now;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,70 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_LATENCY_HISTOGRAM_H_
+#define ASOL_CORE_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// LatencyHistogram is a fixed-size, log-linear (HDR-style) histogram of
+// latencies in milliseconds with exponential time decay.
+//
+// Values below 16 ms get exact 1 ms buckets; above that every power of two
+// is split into 16 linear sub-buckets, so any reported percentile is within
+// about 3% of the true value. Values above ~17 minutes land in the last
+// bucket. Sample weights halve every |half_life|, so percentiles follow the
+// provider's recent behaviour rather than its lifetime average.
+//
+// Recording and querying are O(number of buckets) at worst and never
+// allocate. Not thread-safe.
+class LatencyHistogram {
+ public:
+  explicit LatencyHistogram(base::TimeDelta half_life = base::Minutes(10));
+  ~LatencyHistogram();
+
+  LatencyHistogram(const LatencyHistogram&);
+  LatencyHistogram& operator=(const LatencyHistogram&);
+
+  // Record one sample taken at |now|
+  void Record(double latency_ms, base::TimeTicks now);
+
+  // Latency at quantile |q| in [0, 1], or 0 with no samples
+  double Percentile(double q) const;
+
+  // Decayed sample weight
+  double weight() const { return total_weight_; }
+
+  void Clear();
+
+ private:
+  // 16 exact buckets, then 16 sub-buckets for each power of two from 2^4
+  // to 2^19
+  static constexpr size_t kSubBuckets = 16;
+  static constexpr size_t kMaxExponent = 20;
+  static constexpr size_t kBucketCount =
+      kSubBuckets + (kMaxExponent - 4) * kSubBuckets;
+
+  static size_t BucketForValue(double latency_ms);
+  static void GetBucketRange(size_t bucket, double* low, double* high);
+
+  // Scale all weights down for the time elapsed since the last decay
+  void Decay(base::TimeTicks now);
+
+  base::TimeDelta half_life_;
+  base::TimeTicks last_decay_;
+  std::array<double, kBucketCount> buckets_;
+  double total_weight_ = 0.0;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_LATENCY_HISTOGRAM_H_
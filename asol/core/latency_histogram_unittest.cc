@@ -0,0 +1,73 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/latency_histogram.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+TEST(LatencyHistogramTest, EmptyHistogramReportsZero) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Percentile(0.5), 0.0);
+  EXPECT_EQ(histogram.weight(), 0.0);
+}
+
+TEST(LatencyHistogramTest, PercentilesAreWithinBucketError) {
+  LatencyHistogram histogram;
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (int latency = 1; latency <= 1000; ++latency) {
+    histogram.Record(latency, now);
+  }
+
+  EXPECT_NEAR(histogram.Percentile(0.50), 500, 500 * 0.03);
+  EXPECT_NEAR(histogram.Percentile(0.95), 950, 950 * 0.03);
+  EXPECT_NEAR(histogram.Percentile(0.99), 990, 990 * 0.03);
+}
+
+TEST(LatencyHistogramTest, TailIsVisibleBehindFastMedian) {
+  LatencyHistogram histogram;
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (int i = 0; i < 97; ++i) {
+    histogram.Record(50, now);
+  }
+  for (int i = 0; i < 3; ++i) {
+    histogram.Record(5000, now);
+  }
+
+  EXPECT_LT(histogram.Percentile(0.50), 60);
+  EXPECT_GT(histogram.Percentile(0.99), 4500);
+}
+
+TEST(LatencyHistogramTest, OldSamplesDecay) {
+  LatencyHistogram histogram(base::Minutes(10));
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (int i = 0; i < 100; ++i) {
+    histogram.Record(2000, now);
+  }
+
+  // Six half-lives later the old samples weigh under two percent.
+  now += base::Minutes(60);
+  for (int i = 0; i < 100; ++i) {
+    histogram.Record(20, now);
+  }
+  EXPECT_LT(histogram.Percentile(0.95), 25);
+  EXPECT_NEAR(histogram.weight(), 100 + 100 / 64.0, 0.01);
+}
+
+TEST(LatencyHistogramTest, ClampsOutOfRangeValues) {
+  LatencyHistogram histogram;
+  base::TimeTicks now = base::TimeTicks::Now();
+  histogram.Record(-5, now);
+  histogram.Record(1e12, now);
+
+  EXPECT_LT(histogram.Percentile(0.0), 1.0);
+  EXPECT_GT(histogram.Percentile(1.0), 1e6);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -7,16 +7,20 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
 #include "base/callback.h"
+#include "base/containers/span.h"
 #include "base/memory/weak_ptr.h"
 #include "asol/core/ai_service_provider.h"
 
 namespace asol {
 namespace core {
 
+class InferenceExecutor;
+
 // LocalAIProcessor provides AI processing capabilities that run locally
 // on the user's device for privacy-sensitive operations.
 class LocalAIProcessor : public AIServiceProvider {
@@ -44,11 +48,25 @@ class LocalAIProcessor : public AIServiceProvider {
     ModelType type;
     std::string name;
     std::string version;
+    // Size of the model file. Weights are memory-mapped (see
+    // MappedModelFile) and paged in on use, so the resident share is
+    // usually smaller and can be reclaimed by the OS.
     size_t size_bytes;
     ModelStatus status;
     std::string error_message;
   };
 
+  // Embeddings of several texts in one contiguous row-major buffer
+  struct EmbeddingBatch {
+    size_t dimension = 0;
+    std::vector<float> values;  // size() rows of |dimension| floats
+
+    size_t size() const { return dimension ? values.size() / dimension : 0; }
+    const float* row(size_t index) const {
+      return values.data() + index * dimension;
+    }
+  };
+
   LocalAIProcessor();
   ~LocalAIProcessor() override;
 
@@ -66,7 +84,9 @@ class LocalAIProcessor : public AIServiceProvider {
   // Local AI specific methods
   bool Initialize();
 
-  // Model management
+  // Model management. Loading maps the model file and prefetches its first
+  // layers; |callback| runs once the model can serve requests, without
+  // waiting for the rest of the weights to be read.
   void LoadModel(ModelType type, 
                base::OnceCallback<void(bool success)> callback);
   
@@ -85,16 +105,28 @@ class LocalAIProcessor : public AIServiceProvider {
                   AIResponseCallback callback);
 
   // Text embedding
-  void GenerateEmbedding(const std::string& text,
+  void GenerateEmbedding(std::string_view text,
                        base::OnceCallback<void(const std::vector<float>&)> callback);
 
+  // Embed |texts| in as few model calls as possible: texts are grouped by
+  // length and padded per batch, and row i of the result, L2-normalized,
+  // belongs to texts[i]. |texts| only needs to live until this returns.
+  void GenerateEmbeddings(
+      base::span<const std::string_view> texts,
+      base::OnceCallback<void(EmbeddingBatch)> callback);
+
   // Content classification
   void ClassifyContent(const std::string& content,
                      base::OnceCallback<void(const std::unordered_map<std::string, float>&)> callback);
 
-  // Set processing priority (0-10, where 10 is highest)
-  void SetProcessingPriority(int priority);
-  int GetProcessingPriority() const;
+  // Run inference on |executor|'s dedicated threads, in the lane
+  // InferenceExecutor::LaneForPriority() picks for the class named by the
+  // request's kRequestPriorityParam, INTERACTIVE if none, so background
+  // inference yields between layers to interactive requests. Not owned;
+  // may be null.
+  void SetInferenceExecutor(InferenceExecutor* executor) {
+    inference_executor_ = executor;
+  }
 
   // Enable/disable local processing
   void Enable(bool enable);
@@ -124,7 +156,7 @@ class LocalAIProcessor : public AIServiceProvider {
   // Configuration
   std::unordered_map<std::string, std::string> config_;
   bool is_enabled_ = true;
-  int processing_priority_ = 5;
+  InferenceExecutor* inference_executor_ = nullptr;
 
   // For weak pointers
   base::WeakPtrFactory<LocalAIProcessor> weak_ptr_factory_{this};
@@ -0,0 +1,231 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/mapped_model_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/files/file.h"
+#include "base/logging.h"
+#include "base/memory/page_size.h"
+#include "build/build_config.h"
+
+#if BUILDFLAG(IS_POSIX)
+#include <sys/mman.h>
+#endif
+
+namespace asol {
+namespace core {
+
+namespace {
+
+constexpr uint32_t kFileMagic = 0x4c444d41;  // "AMDL"
+constexpr uint32_t kFileVersion = 1;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t tensor_count;
+  uint32_t alignment;
+};
+
+// Followed by |name_size| bytes of name
+struct TensorRecord {
+  uint64_t offset;
+  uint64_t size;
+  uint32_t element_type;
+  uint32_t name_size;
+};
+
+size_t AlignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+bool IsKnownElementType(uint32_t type) {
+  return type <= static_cast<uint32_t>(MappedModelFile::ElementType::kInt4);
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<MappedModelFile> MappedModelFile::Open(
+    const base::FilePath& path) {
+  std::unique_ptr<MappedModelFile> model(new MappedModelFile());
+  if (!model->mapping_.Initialize(path)) {
+    LOG(ERROR) << "Failed to map model: " << path.value();
+    return nullptr;
+  }
+  if (!model->ParseTable()) {
+    LOG(ERROR) << "Malformed model file: " << path.value();
+    return nullptr;
+  }
+
+  // Weights are read layer by layer, but not always in file order; let
+  // the explicit prefetches below drive readahead instead of the default
+  // heuristics
+#if BUILDFLAG(IS_POSIX)
+  madvise(const_cast<uint8_t*>(model->mapping_.data()),
+          model->mapping_.length(), MADV_RANDOM);
+#endif
+
+  size_t count = 0;
+  size_t bytes = 0;
+  while (count < model->tensors_.size() && bytes < kInitialPrefetchBytes) {
+    bytes += model->tensors_[count].size;
+    ++count;
+  }
+  model->Prefetch(0, count);
+  return model;
+}
+
+// static
+bool MappedModelFile::Write(const base::FilePath& path,
+                            const std::vector<TensorData>& tensors) {
+  base::File file(path, base::File::FLAG_CREATE_ALWAYS |
+                            base::File::FLAG_WRITE);
+  if (!file.IsValid()) {
+    LOG(ERROR) << "Failed to create model file: " << path.value();
+    return false;
+  }
+
+  // Lay out the data after the table
+  size_t table_size = sizeof(FileHeader);
+  for (const TensorData& tensor : tensors) {
+    table_size += sizeof(TensorRecord) + tensor.name.size();
+  }
+  std::vector<uint64_t> offsets;
+  offsets.reserve(tensors.size());
+  size_t offset = AlignUp(table_size, kAlignment);
+  for (const TensorData& tensor : tensors) {
+    offsets.push_back(offset);
+    offset = AlignUp(offset + tensor.data.size(), kAlignment);
+  }
+
+  std::string table;
+  table.reserve(table_size);
+  FileHeader header = {kFileMagic, kFileVersion,
+                       static_cast<uint32_t>(tensors.size()),
+                       static_cast<uint32_t>(kAlignment)};
+  table.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    TensorRecord record = {offsets[i], tensors[i].data.size(),
+                           static_cast<uint32_t>(tensors[i].element_type),
+                           static_cast<uint32_t>(tensors[i].name.size())};
+    table.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    table += tensors[i].name;
+  }
+
+  if (file.Write(0, table.data(), table.size()) !=
+      static_cast<int>(table.size())) {
+    LOG(ERROR) << "Failed to write model table: " << path.value();
+    return false;
+  }
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const std::string_view data = tensors[i].data;
+    // base::File writes at most INT_MAX bytes at a time
+    for (size_t written = 0; written < data.size();) {
+      int chunk = static_cast<int>(
+          std::min<size_t>(data.size() - written, 1 << 30));
+      if (file.Write(offsets[i] + written, data.data() + written, chunk) !=
+          chunk) {
+        LOG(ERROR) << "Failed to write tensor " << tensors[i].name << ": "
+                   << path.value();
+        return false;
+      }
+      written += chunk;
+    }
+  }
+  // Pad the last tensor so every tensor occupies whole aligned blocks
+  return file.SetLength(static_cast<int64_t>(offset));
+}
+
+MappedModelFile::MappedModelFile() = default;
+MappedModelFile::~MappedModelFile() = default;
+
+const MappedModelFile::Tensor* MappedModelFile::FindTensor(
+    std::string_view name) const {
+  auto it = tensor_index_.find(name);
+  return it == tensor_index_.end() ? nullptr : &tensors_[it->second];
+}
+
+void MappedModelFile::Prefetch(size_t first, size_t count) const {
+  Advise(first, count, /*will_need=*/true);
+}
+
+void MappedModelFile::Release(size_t first, size_t count) const {
+  Advise(first, count, /*will_need=*/false);
+}
+
+bool MappedModelFile::ParseTable() {
+  const uint8_t* data = mapping_.data();
+  const size_t length = mapping_.length();
+
+  FileHeader header;
+  if (length < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (header.magic != kFileMagic || header.version != kFileVersion ||
+      header.alignment == 0 || header.alignment % base::GetPageSize() != 0) {
+    return false;
+  }
+
+  size_t position = sizeof(header);
+  tensors_.reserve(header.tensor_count);
+  for (uint32_t i = 0; i < header.tensor_count; ++i) {
+    TensorRecord record;
+    if (length - position < sizeof(record)) {
+      return false;
+    }
+    memcpy(&record, data + position, sizeof(record));
+    position += sizeof(record);
+    if (length - position < record.name_size ||
+        !IsKnownElementType(record.element_type) ||
+        record.offset % header.alignment != 0 || record.offset > length ||
+        record.size > length - record.offset) {
+      return false;
+    }
+    tensors_.push_back(
+        {std::string(reinterpret_cast<const char*>(data) + position,
+                     record.name_size),
+         static_cast<ElementType>(record.element_type), data + record.offset,
+         static_cast<size_t>(record.size)});
+    position += record.name_size;
+  }
+
+  // Names are only viewed once |tensors_| stops growing
+  for (size_t i = 0; i < tensors_.size(); ++i) {
+    tensor_index_.emplace(tensors_[i].name, i);
+  }
+  return true;
+}
+
+void MappedModelFile::Advise(size_t first,
+                             size_t count,
+                             bool will_need) const {
+  first = std::min(first, tensors_.size());
+  count = std::min(count, tensors_.size() - first);
+  if (count == 0) {
+    return;
+  }
+#if BUILDFLAG(IS_POSIX)
+  const uintptr_t page_mask = base::GetPageSize() - 1;
+  for (size_t i = first; i < first + count; ++i) {
+    const Tensor& tensor = tensors_[i];
+    if (tensor.size == 0) {
+      continue;
+    }
+    // Tensors start on a page boundary; the kernel rounds the length up
+    uintptr_t start = reinterpret_cast<uintptr_t>(tensor.data) & ~page_mask;
+    // MADV_DONTNEED on a read-only file mapping only drops clean pages,
+    // which are read back from the file on the next access
+    madvise(reinterpret_cast<void*>(start), tensor.size,
+            will_need ? MADV_WILLNEED : MADV_DONTNEED);
+  }
+#endif
+}
+
+}  // namespace core
+}  // namespace asol
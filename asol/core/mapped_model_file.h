@@ -0,0 +1,117 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_MAPPED_MODEL_FILE_H_
+#define ASOL_CORE_MAPPED_MODEL_FILE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+
+namespace asol {
+namespace core {
+
+// MappedModelFile gives read-only access to the weights of a local model
+// without reading them into memory.
+//
+// The file holds a small tensor table followed by the tensor data, each
+// tensor starting on a kAlignment boundary:
+//
+//   [FileHeader][TensorRecord name]...[pad][tensor 0][pad][tensor 1]...
+//
+// The file is memory-mapped, so opening a model costs one read of the
+// table; weights are paged in as inference touches them, are shared by
+// every process that maps the same file, and can be dropped by the OS under
+// memory pressure without being written to swap. Open() asks the kernel to
+// start reading the first tensors in the background, so the first layers
+// are usually resident by the time they are needed.
+//
+// Open() and Write() block on file IO. Once open, the file is immutable
+// and may be read from any thread.
+class MappedModelFile {
+ public:
+  // Alignment of tensor data in the file. A multiple of every supported
+  // page size (4 KiB, 16 KiB on Apple silicon) and of the Windows mapping
+  // granularity, so each tensor can be advised on its own.
+  static constexpr size_t kAlignment = 64 * 1024;
+
+  // Bytes of leading tensors prefetched by Open()
+  static constexpr size_t kInitialPrefetchBytes = 16 * 1024 * 1024;
+
+  enum class ElementType : uint32_t {
+    kFloat32 = 0,
+    kFloat16 = 1,
+    kInt8 = 2,
+    kInt4 = 3,  // Two values per byte, low nibble first
+  };
+
+  struct Tensor {
+    std::string name;
+    ElementType element_type;
+    const uint8_t* data;
+    size_t size;
+  };
+
+  // Input to Write(); |data| is copied into the file
+  struct TensorData {
+    std::string name;
+    ElementType element_type;
+    std::string_view data;
+  };
+
+  // Map the model at |path|. Returns null if the file cannot be mapped or
+  // its table is malformed.
+  static std::unique_ptr<MappedModelFile> Open(const base::FilePath& path);
+
+  // Write |tensors| to |path| in this format, replacing any file there.
+  static bool Write(const base::FilePath& path,
+                    const std::vector<TensorData>& tensors);
+
+  ~MappedModelFile();
+
+  MappedModelFile(const MappedModelFile&) = delete;
+  MappedModelFile& operator=(const MappedModelFile&) = delete;
+
+  // Tensors in file order
+  const std::vector<Tensor>& tensors() const { return tensors_; }
+
+  // Null if there is no tensor called |name|
+  const Tensor* FindTensor(std::string_view name) const;
+
+  // Start reading tensors [first, first + count) in the background, e.g.
+  // the next layers while the current one runs.
+  void Prefetch(size_t first, size_t count) const;
+
+  // Tell the OS that tensors [first, first + count) will not be used soon.
+  // Their pages can be reclaimed at once and are read back on next use.
+  void Release(size_t first, size_t count) const;
+
+  // Size of the mapped file
+  size_t GetMappedBytes() const { return mapping_.length(); }
+
+ private:
+  MappedModelFile();
+
+  // Parse the tensor table. Returns false if it is malformed.
+  bool ParseTable();
+
+  // Advise the OS that the pages of tensors [first, first + count) will be
+  // needed soon, or not at all for a while
+  void Advise(size_t first, size_t count, bool will_need) const;
+
+  base::MemoryMappedFile mapping_;
+  std::vector<Tensor> tensors_;
+  std::unordered_map<std::string_view, size_t> tensor_index_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_MAPPED_MODEL_FILE_H_
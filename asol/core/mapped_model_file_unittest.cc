@@ -0,0 +1,94 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/mapped_model_file.h"
+
+#include <memory>
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/page_size.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+using ElementType = MappedModelFile::ElementType;
+
+class MappedModelFileTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  base::FilePath GetPath() const {
+    return temp_dir_.GetPath().AppendASCII("model.amdl");
+  }
+
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(MappedModelFileTest, TensorsRoundTripAligned) {
+  std::string embeddings(100000, 'e');
+  std::string weights = "\x01\x02\x03";
+  ASSERT_TRUE(MappedModelFile::Write(
+      GetPath(), {{"embeddings", ElementType::kFloat32, embeddings},
+                  {"layer0.weights", ElementType::kInt8, weights},
+                  {"empty", ElementType::kInt4, std::string_view()}}));
+
+  std::unique_ptr<MappedModelFile> model = MappedModelFile::Open(GetPath());
+  ASSERT_TRUE(model);
+  ASSERT_EQ(model->tensors().size(), 3u);
+  EXPECT_EQ(model->GetMappedBytes() % MappedModelFile::kAlignment, 0u);
+
+  const MappedModelFile::Tensor* tensor = model->FindTensor("layer0.weights");
+  ASSERT_TRUE(tensor);
+  EXPECT_EQ(tensor->element_type, ElementType::kInt8);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(tensor->data),
+                        tensor->size),
+            weights);
+
+  // Each tensor starts on its own page, so it can be advised alone
+  for (const MappedModelFile::Tensor& each : model->tensors()) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(each.data) % base::GetPageSize(),
+              0u)
+        << each.name;
+  }
+  EXPECT_EQ(model->tensors()[0].size, embeddings.size());
+  EXPECT_EQ(model->tensors()[0].data[99999], 'e');
+  EXPECT_FALSE(model->FindTensor("missing"));
+}
+
+TEST_F(MappedModelFileTest, ReleasedTensorsReadBack) {
+  std::string weights(3 * MappedModelFile::kAlignment, 'w');
+  ASSERT_TRUE(MappedModelFile::Write(
+      GetPath(), {{"w", ElementType::kFloat16, weights}}));
+  std::unique_ptr<MappedModelFile> model = MappedModelFile::Open(GetPath());
+  ASSERT_TRUE(model);
+
+  model->Release(0, 1);
+  EXPECT_EQ(model->tensors()[0].data[weights.size() - 1], 'w');
+  model->Prefetch(0, 10);
+  model->Release(5, 1);
+}
+
+TEST_F(MappedModelFileTest, RejectsMalformedFiles) {
+  ASSERT_TRUE(base::WriteFile(GetPath(), "not a model"));
+  EXPECT_FALSE(MappedModelFile::Open(GetPath()));
+
+  // A table that points past the end of the file
+  ASSERT_TRUE(MappedModelFile::Write(
+      GetPath(), {{"w", ElementType::kFloat32, std::string(4096, 'w')}}));
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(GetPath(), &contents));
+  contents.resize(MappedModelFile::kAlignment + 100);
+  ASSERT_TRUE(base::WriteFile(GetPath(), contents));
+  EXPECT_FALSE(MappedModelFile::Open(GetPath()));
+
+  EXPECT_FALSE(MappedModelFile::Open(GetPath().AddExtensionASCII("missing")));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
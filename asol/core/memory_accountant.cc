@@ -0,0 +1,214 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/memory_accountant.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/no_destructor.h"
+#include "base/strings/escape.h"
+#include "base/strings/stringprintf.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Raise |peak| to at least |value|
+void RaiseTo(std::atomic<size_t>& peak, size_t value) {
+  size_t current = peak.load(std::memory_order_relaxed);
+  while (current < value &&
+         !peak.compare_exchange_weak(current, value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+std::string FormatBytes(size_t bytes) {
+  if (bytes < 1024) {
+    return base::StringPrintf("%zu B", bytes);
+  }
+  if (bytes < 1024 * 1024) {
+    return base::StringPrintf("%.1f KiB", bytes / 1024.0);
+  }
+  if (bytes < size_t{1024} * 1024 * 1024) {
+    return base::StringPrintf("%.1f MiB", bytes / (1024.0 * 1024.0));
+  }
+  return base::StringPrintf("%.2f GiB", bytes / (1024.0 * 1024.0 * 1024.0));
+}
+
+}  // namespace
+
+MemoryAccount::MemoryAccount(std::string_view subsystem,
+                             PressureCallback on_pressure,
+                             MemoryAccountant* accountant)
+    : accountant_(accountant ? accountant : MemoryAccountant::GetInstance()),
+      subsystem_(subsystem),
+      on_pressure_(std::move(on_pressure)) {
+  accountant_->AddAccount(this);
+}
+
+MemoryAccount::~MemoryAccount() {
+  accountant_->RemoveAccount(this);
+}
+
+void MemoryAccount::Update(size_t resident_bytes, size_t element_count) {
+  resident_bytes_.store(resident_bytes, std::memory_order_relaxed);
+  element_count_.store(element_count, std::memory_order_relaxed);
+  RaiseTo(peak_resident_bytes_, resident_bytes);
+  RaiseTo(peak_element_count_, element_count);
+}
+
+// static
+MemoryAccountant* MemoryAccountant::GetInstance() {
+  static base::NoDestructor<MemoryAccountant> instance;
+  return instance.get();
+}
+
+MemoryAccountant::MemoryAccountant() = default;
+
+MemoryAccountant::~MemoryAccountant() {
+  base::AutoLock lock(lock_);
+  DCHECK(accounts_.empty()) << "MemoryAccounts outlived their accountant";
+}
+
+std::vector<MemoryAccountant::SubsystemUsage> MemoryAccountant::GetUsage()
+    const {
+  std::map<std::string, SubsystemUsage> by_subsystem;
+  {
+    base::AutoLock lock(lock_);
+    for (const MemoryAccount* account : accounts_) {
+      SubsystemUsage& usage = by_subsystem[account->subsystem()];
+      usage.accounts++;
+      usage.resident_bytes += account->resident_bytes();
+      usage.element_count += account->element_count();
+      usage.peak_resident_bytes += account->peak_resident_bytes();
+      usage.peak_element_count += account->peak_element_count();
+    }
+  }
+
+  std::vector<SubsystemUsage> result;
+  result.reserve(by_subsystem.size());
+  for (auto& [subsystem, usage] : by_subsystem) {
+    usage.subsystem = subsystem;
+    result.push_back(std::move(usage));
+  }
+  std::stable_sort(result.begin(), result.end(),
+                   [](const SubsystemUsage& a, const SubsystemUsage& b) {
+                     return a.resident_bytes > b.resident_bytes;
+                   });
+  return result;
+}
+
+size_t MemoryAccountant::GetTotalResidentBytes() const {
+  base::AutoLock lock(lock_);
+  size_t total = 0;
+  for (const MemoryAccount* account : accounts_) {
+    total += account->resident_bytes();
+  }
+  return total;
+}
+
+void MemoryAccountant::StartMonitoring(base::TimeDelta dump_interval) {
+  pressure_listener_ = std::make_unique<base::MemoryPressureListener>(
+      FROM_HERE, base::BindRepeating(&MemoryAccountant::NotifyMemoryPressure,
+                                     base::Unretained(this)));
+  dump_timer_.Stop();
+  if (dump_interval.is_positive()) {
+    dump_timer_.Start(FROM_HERE, dump_interval, this,
+                      &MemoryAccountant::DumpToLog);
+  }
+}
+
+void MemoryAccountant::StopMonitoring() {
+  pressure_listener_.reset();
+  dump_timer_.Stop();
+}
+
+void MemoryAccountant::NotifyMemoryPressure(PressureLevel level) {
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE) {
+    return;
+  }
+  LOG(WARNING) << "Memory pressure; AI subsystems hold "
+               << FormatBytes(GetTotalResidentBytes());
+
+  base::AutoLock lock(lock_);
+  for (MemoryAccount* account : accounts_) {
+    if (account->on_pressure_) {
+      account->on_pressure_.Run(level);
+    }
+  }
+}
+
+std::string MemoryAccountant::GetTextDump() const {
+  std::vector<SubsystemUsage> usage = GetUsage();
+  size_t total = 0;
+  std::string dump = base::StringPrintf("%-24s %12s %10s %12s %10s\n",
+                                        "subsystem", "resident", "count",
+                                        "peak", "peak count");
+  for (const SubsystemUsage& entry : usage) {
+    total += entry.resident_bytes;
+    dump += base::StringPrintf(
+        "%-24s %12s %10zu %12s %10zu\n", entry.subsystem.c_str(),
+        FormatBytes(entry.resident_bytes).c_str(), entry.element_count,
+        FormatBytes(entry.peak_resident_bytes).c_str(),
+        entry.peak_element_count);
+  }
+  dump += base::StringPrintf("%-24s %12s\n", "total",
+                             FormatBytes(total).c_str());
+  return dump;
+}
+
+std::string MemoryAccountant::GetDiagnosticsHtml() const {
+  std::vector<SubsystemUsage> usage = GetUsage();
+  size_t total = 0;
+  std::string html =
+      "<!doctype html><html><head><meta charset=\"utf-8\">"
+      "<title>AI memory</title><style>"
+      "body{font-family:system-ui,sans-serif;margin:2em}"
+      "table{border-collapse:collapse}"
+      "th,td{padding:4px 12px;border-bottom:1px solid #ddd}"
+      "td.n{text-align:right;font-variant-numeric:tabular-nums}"
+      "</style></head><body><h1>AI memory</h1><table><tr>"
+      "<th>Subsystem</th><th>Instances</th><th>Resident</th>"
+      "<th>Elements</th><th>Peak resident</th><th>Peak elements</th></tr>";
+  for (const SubsystemUsage& entry : usage) {
+    total += entry.resident_bytes;
+    html += base::StringPrintf(
+        "<tr><td>%s</td><td class=\"n\">%zu</td><td class=\"n\">%s</td>"
+        "<td class=\"n\">%zu</td><td class=\"n\">%s</td>"
+        "<td class=\"n\">%zu</td></tr>",
+        base::EscapeForHTML(entry.subsystem).c_str(), entry.accounts,
+        FormatBytes(entry.resident_bytes).c_str(), entry.element_count,
+        FormatBytes(entry.peak_resident_bytes).c_str(),
+        entry.peak_element_count);
+  }
+  html += base::StringPrintf(
+      "<tr><th>Total</th><td></td><td class=\"n\">%s</td>"
+      "<td></td><td></td><td></td></tr></table></body></html>",
+      FormatBytes(total).c_str());
+  return html;
+}
+
+void MemoryAccountant::AddAccount(MemoryAccount* account) {
+  base::AutoLock lock(lock_);
+  accounts_.push_back(account);
+}
+
+void MemoryAccountant::RemoveAccount(MemoryAccount* account) {
+  base::AutoLock lock(lock_);
+  auto it = std::find(accounts_.begin(), accounts_.end(), account);
+  DCHECK(it != accounts_.end());
+  accounts_.erase(it);
+}
+
+void MemoryAccountant::DumpToLog() const {
+  LOG(INFO) << "AI memory usage:\n" << GetTextDump();
+}
+
+}  // namespace core
+}  // namespace asol
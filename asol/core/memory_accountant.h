@@ -0,0 +1,157 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_MEMORY_ACCOUNTANT_H_
+#define ASOL_CORE_MEMORY_ACCOUNTANT_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace asol {
+namespace core {
+
+class MemoryAccountant;
+
+// MemoryAccount is one subsystem instance's entry in a MemoryAccountant.
+// The subsystem owns it and calls Update() whenever its resident bytes or
+// element count change; the account keeps their high-water marks. Updates
+// are lock free and may come from any thread.
+//
+// |on_pressure| runs, on whatever thread reports memory pressure, for the
+// subsystem to trim its caches. A subsystem bound to a sequence should
+// wrap it with base::BindPostTaskToCurrentDefault() and a WeakPtr.
+class MemoryAccount {
+ public:
+  using PressureLevel = base::MemoryPressureListener::MemoryPressureLevel;
+  using PressureCallback = base::RepeatingCallback<void(PressureLevel)>;
+
+  // Registers with |accountant|, MemoryAccountant::GetInstance() if null,
+  // which must outlive this account.
+  explicit MemoryAccount(std::string_view subsystem,
+                         PressureCallback on_pressure = PressureCallback(),
+                         MemoryAccountant* accountant = nullptr);
+  ~MemoryAccount();
+
+  MemoryAccount(const MemoryAccount&) = delete;
+  MemoryAccount& operator=(const MemoryAccount&) = delete;
+
+  void Update(size_t resident_bytes, size_t element_count);
+
+  const std::string& subsystem() const { return subsystem_; }
+  size_t resident_bytes() const {
+    return resident_bytes_.load(std::memory_order_relaxed);
+  }
+  size_t element_count() const {
+    return element_count_.load(std::memory_order_relaxed);
+  }
+  size_t peak_resident_bytes() const {
+    return peak_resident_bytes_.load(std::memory_order_relaxed);
+  }
+  size_t peak_element_count() const {
+    return peak_element_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  friend class MemoryAccountant;
+
+  MemoryAccountant* const accountant_;
+  const std::string subsystem_;
+  const PressureCallback on_pressure_;
+
+  std::atomic<size_t> resident_bytes_{0};
+  std::atomic<size_t> element_count_{0};
+  std::atomic<size_t> peak_resident_bytes_{0};
+  std::atomic<size_t> peak_element_count_{0};
+};
+
+// MemoryAccountant tells how much memory each AI subsystem holds: the
+// response caches, conversation contexts, local models, the memory palace
+// and so on. Each subsystem instance reports through a MemoryAccount, and
+// the accountant sums them per subsystem, for a periodic log dump and for
+// the diagnostics page at kDiagnosticsUrl.
+//
+// It also passes memory pressure on to the accounts, so subsystems shed
+// what they can rebuild: moderate pressure asks them to trim, critical
+// pressure to free all but what is in use.
+//
+// Accounts register and unregister under a lock, and pressure callbacks
+// run under it, so an account is never called after it is destroyed; the
+// callbacks must not create or destroy accounts. Monitoring starts and
+// stops on one sequence.
+class MemoryAccountant {
+ public:
+  using PressureLevel = MemoryAccount::PressureLevel;
+
+  struct SubsystemUsage {
+    std::string subsystem;
+    // Live MemoryAccounts for the subsystem
+    size_t accounts = 0;
+    size_t resident_bytes = 0;
+    size_t element_count = 0;
+    // The sums of the accounts' high-water marks, an upper bound on the
+    // subsystem's own
+    size_t peak_resident_bytes = 0;
+    size_t peak_element_count = 0;
+  };
+
+  static constexpr char kDiagnosticsUrl[] = "asol://memory";
+  static constexpr base::TimeDelta kDefaultDumpInterval = base::Minutes(10);
+
+  static MemoryAccountant* GetInstance();
+
+  MemoryAccountant();
+  ~MemoryAccountant();
+
+  MemoryAccountant(const MemoryAccountant&) = delete;
+  MemoryAccountant& operator=(const MemoryAccountant&) = delete;
+
+  // Usage per subsystem, largest first
+  std::vector<SubsystemUsage> GetUsage() const;
+  size_t GetTotalResidentBytes() const;
+
+  // Listen for memory pressure and log the usage every |dump_interval|
+  // (never if zero), until StopMonitoring()
+  void StartMonitoring(base::TimeDelta dump_interval = kDefaultDumpInterval);
+  void StopMonitoring();
+
+  // Run every account's pressure callback. Called by the pressure
+  // listener; exposed for tests and for callers with their own signal.
+  void NotifyMemoryPressure(PressureLevel level);
+
+  // The usage as a plain text table, as logged
+  std::string GetTextDump() const;
+
+  // The diagnostics page: an HTML table of the usage
+  std::string GetDiagnosticsHtml() const;
+
+ private:
+  friend class MemoryAccount;
+
+  void AddAccount(MemoryAccount* account);
+  void RemoveAccount(MemoryAccount* account);
+
+  void DumpToLog() const;
+
+  mutable base::Lock lock_;
+  std::vector<MemoryAccount*> accounts_ GUARDED_BY(lock_);
+
+  std::unique_ptr<base::MemoryPressureListener> pressure_listener_;
+  base::RepeatingTimer dump_timer_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_MEMORY_ACCOUNTANT_H_
@@ -0,0 +1,113 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/memory_accountant.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+using PressureLevel = MemoryAccount::PressureLevel;
+
+TEST(MemoryAccountantTest, SumsAccountsPerSubsystem) {
+  MemoryAccountant accountant;
+  MemoryAccount cache_a("response_cache", {}, &accountant);
+  MemoryAccount cache_b("response_cache", {}, &accountant);
+  MemoryAccount models("local_models", {}, &accountant);
+
+  cache_a.Update(1000, 10);
+  cache_b.Update(500, 5);
+  models.Update(4000, 1);
+
+  std::vector<MemoryAccountant::SubsystemUsage> usage = accountant.GetUsage();
+  ASSERT_EQ(usage.size(), 2u);
+  // Largest first
+  EXPECT_EQ(usage[0].subsystem, "local_models");
+  EXPECT_EQ(usage[0].resident_bytes, 4000u);
+  EXPECT_EQ(usage[1].subsystem, "response_cache");
+  EXPECT_EQ(usage[1].accounts, 2u);
+  EXPECT_EQ(usage[1].resident_bytes, 1500u);
+  EXPECT_EQ(usage[1].element_count, 15u);
+  EXPECT_EQ(accountant.GetTotalResidentBytes(), 5500u);
+}
+
+TEST(MemoryAccountantTest, KeepsHighWaterMarks) {
+  MemoryAccountant accountant;
+  MemoryAccount account("conversation_contexts", {}, &accountant);
+
+  account.Update(100, 1);
+  account.Update(900, 7);
+  account.Update(300, 2);
+
+  EXPECT_EQ(account.resident_bytes(), 300u);
+  EXPECT_EQ(account.peak_resident_bytes(), 900u);
+  EXPECT_EQ(account.peak_element_count(), 7u);
+
+  std::vector<MemoryAccountant::SubsystemUsage> usage = accountant.GetUsage();
+  ASSERT_EQ(usage.size(), 1u);
+  EXPECT_EQ(usage[0].peak_resident_bytes, 900u);
+}
+
+TEST(MemoryAccountantTest, DestroyedAccountsStopCounting) {
+  MemoryAccountant accountant;
+  auto account = std::make_unique<MemoryAccount>(
+      "response_cache", MemoryAccount::PressureCallback(), &accountant);
+  account->Update(1000, 10);
+  account.reset();
+
+  EXPECT_TRUE(accountant.GetUsage().empty());
+  EXPECT_EQ(accountant.GetTotalResidentBytes(), 0u);
+}
+
+TEST(MemoryAccountantTest, PassesPressureOn) {
+  MemoryAccountant accountant;
+  std::vector<PressureLevel> levels;
+  MemoryAccount account(
+      "response_cache",
+      base::BindRepeating(
+          [](std::vector<PressureLevel>* levels, PressureLevel level) {
+            levels->push_back(level);
+          },
+          &levels),
+      &accountant);
+  MemoryAccount without_callback("local_models", {}, &accountant);
+
+  accountant.NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  accountant.NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE);
+  accountant.NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+
+  ASSERT_EQ(levels.size(), 2u);
+  EXPECT_EQ(levels[0],
+            base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  EXPECT_EQ(levels[1],
+            base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+}
+
+TEST(MemoryAccountantTest, DiagnosticsListSubsystems) {
+  MemoryAccountant accountant;
+  MemoryAccount account("<palace>", {}, &accountant);
+  account.Update(3 * 1024 * 1024, 42);
+
+  std::string text = accountant.GetTextDump();
+  EXPECT_NE(text.find("<palace>"), std::string::npos);
+  EXPECT_NE(text.find("3.0 MiB"), std::string::npos);
+
+  std::string html = accountant.GetDiagnosticsHtml();
+  EXPECT_NE(html.find("&lt;palace&gt;"), std::string::npos);
+  EXPECT_EQ(html.find("<palace>"), std::string::npos);
+  EXPECT_NE(html.find("<td class=\"n\">42</td>"), std::string::npos);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
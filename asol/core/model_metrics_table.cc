@@ -0,0 +1,106 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/model_metrics_table.h"
+
+#include "base/check_op.h"
+
+namespace asol {
+namespace core {
+
+ModelMetricsTable::ModelMetricsTable() = default;
+
+ModelMetricsTable::~ModelMetricsTable() = default;
+
+size_t ModelMetricsTable::GetOrAddProvider(const std::string& provider_id) {
+  auto [it, inserted] =
+      provider_indices_.try_emplace(provider_id, provider_ids_.size());
+  if (!inserted) {
+    return it->second;
+  }
+
+  provider_ids_.push_back(provider_id);
+  size_t count = provider_ids_.size();
+  cost_.resize(count, 0.0f);
+  for (Columns& columns : columns_) {
+    columns.success_rate.resize(count, 0.0f);
+    columns.average_latency_ms.resize(count, 0.0f);
+    for (auto& percentile : columns.latency_percentiles_ms) {
+      percentile.resize(count, 0.0f);
+    }
+    columns.quality_score.resize(count, 0.0f);
+    columns.request_count.resize(count, 0);
+    columns.last_updated.resize(count);
+  }
+  return it->second;
+}
+
+size_t ModelMetricsTable::FindProvider(const std::string& provider_id) const {
+  auto it = provider_indices_.find(provider_id);
+  return it != provider_indices_.end() ? it->second : kNotFound;
+}
+
+void ModelMetricsTable::RecordRequest(size_t provider,
+                                      TaskType task_type,
+                                      bool success,
+                                      float latency_ms,
+                                      float quality_score,
+                                      base::Time now) {
+  DCHECK_LT(provider, provider_count());
+  Columns& columns = columns_[static_cast<size_t>(task_type)];
+
+  // Running means over the provider's lifetime
+  float n = static_cast<float>(++columns.request_count[provider]);
+  columns.success_rate[provider] +=
+      ((success ? 1.0f : 0.0f) - columns.success_rate[provider]) / n;
+  columns.average_latency_ms[provider] +=
+      (latency_ms - columns.average_latency_ms[provider]) / n;
+  columns.quality_score[provider] +=
+      (quality_score - columns.quality_score[provider]) / n;
+  columns.last_updated[provider] = now;
+}
+
+void ModelMetricsTable::SetLatencyPercentiles(
+    size_t provider,
+    TaskType task_type,
+    const std::array<float, kLatencyPercentileCount>& percentiles_ms) {
+  DCHECK_LT(provider, provider_count());
+  Columns& columns = columns_[static_cast<size_t>(task_type)];
+  for (size_t i = 0; i < kLatencyPercentileCount; ++i) {
+    columns.latency_percentiles_ms[i][provider] = percentiles_ms[i];
+  }
+}
+
+void ModelMetricsTable::SetCostPerRequest(size_t provider, float cost) {
+  DCHECK_LT(provider, provider_count());
+  cost_[provider] = cost;
+}
+
+void ModelMetricsTable::Score(TaskType task_type,
+                              const ScoreWeights& weights,
+                              size_t latency_percentile,
+                              std::vector<float>* scores) const {
+  DCHECK_LT(latency_percentile, kLatencyPercentileCount);
+  const Columns& columns = columns_[static_cast<size_t>(task_type)];
+  size_t count = provider_count();
+  scores->resize(count);
+
+  const float* success_rate = columns.success_rate.data();
+  const float* quality = columns.quality_score.data();
+  const float* latency =
+      columns.latency_percentiles_ms[latency_percentile].data();
+  const float* cost = cost_.data();
+  float* out = scores->data();
+  const float scale = weights.latency_scale_ms;
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = weights.success_rate * success_rate[i] +
+             weights.quality * quality[i] +
+             weights.latency_decay * (scale / (scale + latency[i])) +
+             weights.cost_decay / (1.0f + cost[i]) +
+             weights.latency * latency[i] + weights.cost * cost[i];
+  }
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,129 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_MODEL_METRICS_TABLE_H_
+#define ASOL_CORE_MODEL_METRICS_TABLE_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "asol/core/ai_service_manager.h"
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// ModelMetricsTable holds the per-provider, per-task metrics that model
+// selection scores, laid out for scoring every provider at once.
+//
+// Providers get a dense index when first seen. For each task type, every
+// metric is a column indexed by provider, so scoring a task's providers
+// is one pass over a few contiguous float arrays instead of a hash lookup
+// and a struct copy per provider. Score() has no branches in its loop, so
+// the compiler vectorizes it.
+//
+// Recording updates a row in place and never allocates once the provider
+// is known. Not thread-safe; the orchestrator uses it on its sequence.
+class ModelMetricsTable {
+ public:
+  using TaskType = AIServiceManager::TaskType;
+
+  static constexpr size_t kTaskTypeCount =
+      static_cast<size_t>(TaskType::CUSTOM) + 1;
+  // Latency percentile columns, in this order
+  static constexpr size_t kLatencyPercentileCount = 3;
+
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+  // Metrics of one task type, one entry per provider
+  struct Columns {
+    std::vector<float> success_rate;
+    std::vector<float> average_latency_ms;
+    // p50, p95 and p99
+    std::array<std::vector<float>, kLatencyPercentileCount>
+        latency_percentiles_ms;
+    std::vector<float> quality_score;
+    std::vector<int> request_count;
+    std::vector<base::Time> last_updated;
+  };
+
+  // A provider's score is the weighted sum of
+  //
+  //   success rate, quality score,
+  //   scale / (scale + latency)   (1 when instant, 1/2 at |latency_scale_ms|)
+  //   1 / (1 + cost),
+  //   latency and cost as they are
+  //
+  // where latency is the chosen percentile. Higher is better, so weights
+  // on raw latency and cost are negative.
+  struct ScoreWeights {
+    float success_rate = 0.0f;
+    float quality = 0.0f;
+    float latency_decay = 0.0f;
+    float cost_decay = 0.0f;
+    float latency = 0.0f;
+    float cost = 0.0f;
+    float latency_scale_ms = 1000.0f;
+  };
+
+  ModelMetricsTable();
+  ~ModelMetricsTable();
+
+  ModelMetricsTable(const ModelMetricsTable&) = delete;
+  ModelMetricsTable& operator=(const ModelMetricsTable&) = delete;
+
+  // Index of |provider_id|, adding it with empty metrics if new
+  size_t GetOrAddProvider(const std::string& provider_id);
+
+  // Index of |provider_id|, or kNotFound
+  size_t FindProvider(const std::string& provider_id) const;
+
+  size_t provider_count() const { return provider_ids_.size(); }
+  const std::string& provider_id(size_t provider) const {
+    return provider_ids_[provider];
+  }
+
+  const Columns& columns(TaskType task_type) const {
+    return columns_[static_cast<size_t>(task_type)];
+  }
+  float cost_per_request(size_t provider) const { return cost_[provider]; }
+
+  // Fold one request into the provider's running means
+  void RecordRequest(size_t provider,
+                     TaskType task_type,
+                     bool success,
+                     float latency_ms,
+                     float quality_score,
+                     base::Time now);
+
+  void SetLatencyPercentiles(
+      size_t provider,
+      TaskType task_type,
+      const std::array<float, kLatencyPercentileCount>& percentiles_ms);
+
+  void SetCostPerRequest(size_t provider, float cost);
+
+  // Score every provider for |task_type| into |scores|, indexed like the
+  // providers, using latency percentile column |latency_percentile|
+  void Score(TaskType task_type,
+             const ScoreWeights& weights,
+             size_t latency_percentile,
+             std::vector<float>* scores) const;
+
+ private:
+  std::vector<std::string> provider_ids_;
+  std::unordered_map<std::string, size_t> provider_indices_;
+  // Per provider, shared by all task types
+  std::vector<float> cost_;
+  std::array<Columns, kTaskTypeCount> columns_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_MODEL_METRICS_TABLE_H_
@@ -0,0 +1,84 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/model_metrics_table.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+using TaskType = AIServiceManager::TaskType;
+
+TEST(ModelMetricsTableTest, IndexesProvidersDensely) {
+  ModelMetricsTable table;
+  EXPECT_EQ(table.FindProvider("gemini"), ModelMetricsTable::kNotFound);
+  EXPECT_EQ(table.GetOrAddProvider("gemini"), 0u);
+  EXPECT_EQ(table.GetOrAddProvider("claude"), 1u);
+  EXPECT_EQ(table.GetOrAddProvider("gemini"), 0u);
+  EXPECT_EQ(table.FindProvider("claude"), 1u);
+  EXPECT_EQ(table.provider_count(), 2u);
+  EXPECT_EQ(table.provider_id(1), "claude");
+  EXPECT_EQ(table.columns(TaskType::TRANSLATION).request_count[1], 0);
+}
+
+TEST(ModelMetricsTableTest, KeepsRunningMeansPerTask) {
+  ModelMetricsTable table;
+  size_t provider = table.GetOrAddProvider("gemini");
+  base::Time now = base::Time::Now();
+  table.RecordRequest(provider, TaskType::TEXT_SUMMARIZATION, true, 100.0f,
+                      1.0f, now);
+  table.RecordRequest(provider, TaskType::TEXT_SUMMARIZATION, false, 300.0f,
+                      0.0f, now);
+
+  const ModelMetricsTable::Columns& columns =
+      table.columns(TaskType::TEXT_SUMMARIZATION);
+  EXPECT_EQ(columns.request_count[provider], 2);
+  EXPECT_FLOAT_EQ(columns.success_rate[provider], 0.5f);
+  EXPECT_FLOAT_EQ(columns.average_latency_ms[provider], 200.0f);
+  EXPECT_FLOAT_EQ(columns.quality_score[provider], 0.5f);
+  EXPECT_EQ(columns.last_updated[provider], now);
+  EXPECT_EQ(table.columns(TaskType::TRANSLATION).request_count[provider], 0);
+}
+
+TEST(ModelMetricsTableTest, ScoresEveryProviderWithTheWeights) {
+  ModelMetricsTable table;
+  size_t fast = table.GetOrAddProvider("fast");
+  size_t cheap = table.GetOrAddProvider("cheap");
+  base::Time now = base::Time::Now();
+  table.RecordRequest(fast, TaskType::TEXT_GENERATION, true, 100.0f, 0.8f,
+                      now);
+  table.RecordRequest(cheap, TaskType::TEXT_GENERATION, true, 1000.0f, 0.8f,
+                      now);
+  table.SetLatencyPercentiles(fast, TaskType::TEXT_GENERATION,
+                              {100.0f, 200.0f, 300.0f});
+  table.SetLatencyPercentiles(cheap, TaskType::TEXT_GENERATION,
+                              {1000.0f, 1000.0f, 1000.0f});
+  table.SetCostPerRequest(fast, 3.0f);
+
+  std::vector<float> scores;
+  ModelMetricsTable::ScoreWeights lowest_latency;
+  lowest_latency.latency = -1.0f;
+  table.Score(TaskType::TEXT_GENERATION, lowest_latency, 1, &scores);
+  ASSERT_EQ(scores.size(), 2u);
+  EXPECT_FLOAT_EQ(scores[fast], -200.0f);
+  EXPECT_FLOAT_EQ(scores[cheap], -1000.0f);
+
+  ModelMetricsTable::ScoreWeights balanced;
+  balanced.success_rate = 0.5f;
+  balanced.latency_decay = 1.0f;
+  balanced.cost_decay = 1.0f;
+  balanced.latency_scale_ms = 1000.0f;
+  table.Score(TaskType::TEXT_GENERATION, balanced, 0, &scores);
+  // 0.5 + 1000/1100 + 1/4, and 0.5 + 1/2 + 1
+  EXPECT_FLOAT_EQ(scores[fast], 0.5f + 1000.0f / 1100.0f + 0.25f);
+  EXPECT_FLOAT_EQ(scores[cheap], 2.0f);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,260 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/model_residency_manager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/system/sys_info.h"
+#include "base/task/bind_post_task.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/default_clock.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Pages with at least this many images, or any video, count as media-heavy
+constexpr size_t kMediaHeavyImageCount = 8;
+
+// Pages with at least this much text are likely to be summarized
+constexpr size_t kLongArticleBytes = 16 * 1024;
+
+size_t DefaultMemoryBudget() {
+  return static_cast<size_t>(base::SysInfo::AmountOfPhysicalMemory() / 4);
+}
+
+}  // namespace
+
+ModelResidencyManager::ModelResidencyManager(Delegate* delegate,
+                                             const Options& options)
+    : delegate_(delegate),
+      usage_half_life_(options.usage_half_life),
+      clock_(base::DefaultClock::GetInstance()),
+      memory_budget_(options.memory_budget_bytes
+                         ? options.memory_budget_bytes
+                         : DefaultMemoryBudget()) {
+  // Pressure is reported on another sequence; hop back to this one
+  MemoryAccount::PressureCallback on_pressure;
+  if (base::SequencedTaskRunner::HasCurrentDefault()) {
+    on_pressure = base::BindPostTaskToCurrentDefault(
+        base::BindRepeating(&ModelResidencyManager::OnMemoryPressure,
+                            weak_ptr_factory_.GetWeakPtr()));
+  }
+  memory_account_ =
+      std::make_unique<MemoryAccount>("local_models", std::move(on_pressure));
+}
+
+ModelResidencyManager::~ModelResidencyManager() = default;
+
+void ModelResidencyManager::RegisterModel(ModelType type, size_t size_bytes) {
+  Model& model = models_[type];
+  if (model.state == State::kUnloaded) {
+    model.size_bytes = size_bytes;
+  }
+}
+
+void ModelResidencyManager::Acquire(ModelType type,
+                                    base::OnceCallback<void(bool)> callback) {
+  auto it = models_.find(type);
+  if (it == models_.end()) {
+    std::move(callback).Run(false);
+    return;
+  }
+
+  Model& model = it->second;
+  base::Time now = clock_->Now();
+  model.usage_score = DecayedScore(model, now) + 1.0;
+  model.usage_time = now;
+  model.last_used = now;
+
+  switch (model.state) {
+    case State::kResident:
+      model.pin_count++;
+      std::move(callback).Run(true);
+      return;
+    case State::kLoading:
+      model.waiters.push_back(std::move(callback));
+      return;
+    case State::kUnloaded:
+      model.waiters.push_back(std::move(callback));
+      if (!StartLoad(type, model, std::numeric_limits<double>::infinity())) {
+        LOG(WARNING) << "No room to load local model "
+                     << static_cast<int>(type);
+        OnLoaded(type, false);
+      }
+      return;
+  }
+}
+
+void ModelResidencyManager::Release(ModelType type) {
+  auto it = models_.find(type);
+  if (it == models_.end() || it->second.pin_count == 0) {
+    return;
+  }
+  Model& model = it->second;
+  model.pin_count--;
+  model.last_used = clock_->Now();
+  if (used_bytes_ > memory_budget_) {
+    // The budget shrank while models were in use
+    MakeRoom(0, std::numeric_limits<double>::infinity());
+  }
+}
+
+void ModelResidencyManager::Preload(ModelType type) {
+  auto it = models_.find(type);
+  if (it == models_.end() || it->second.state != State::kUnloaded) {
+    return;
+  }
+  Model& model = it->second;
+  StartLoad(type, model, DecayedScore(model, clock_->Now()));
+}
+
+void ModelResidencyManager::OnPageOpened(const PageSignals& signals) {
+  if (signals.video_count > 0 ||
+      signals.image_count >= kMediaHeavyImageCount) {
+    Preload(ModelType::VISION_SMALL);
+  }
+  if (signals.text_bytes >= kLongArticleBytes) {
+    Preload(ModelType::TEXT_SMALL);
+  }
+}
+
+void ModelResidencyManager::SetMemoryBudget(size_t bytes) {
+  memory_budget_ = bytes;
+  if (used_bytes_ > memory_budget_) {
+    MakeRoom(0, std::numeric_limits<double>::infinity());
+  }
+}
+
+bool ModelResidencyManager::IsResident(ModelType type) const {
+  auto it = models_.find(type);
+  return it != models_.end() && it->second.state == State::kResident;
+}
+
+double ModelResidencyManager::GetUsageScore(ModelType type) const {
+  auto it = models_.find(type);
+  return it == models_.end() ? 0.0 : DecayedScore(it->second, clock_->Now());
+}
+
+bool ModelResidencyManager::StartLoad(ModelType type,
+                                      Model& model,
+                                      double max_victim_score) {
+  if (!MakeRoom(model.size_bytes, max_victim_score)) {
+    return false;
+  }
+  model.state = State::kLoading;
+  used_bytes_ += model.size_bytes;
+  ReportMemoryUsage();
+  delegate_->LoadModel(type,
+                       base::BindOnce(&ModelResidencyManager::OnLoaded,
+                                      weak_ptr_factory_.GetWeakPtr(), type));
+  return true;
+}
+
+void ModelResidencyManager::OnLoaded(ModelType type, bool success) {
+  Model& model = models_[type];
+  if (model.state == State::kLoading) {
+    if (success) {
+      model.state = State::kResident;
+    } else {
+      model.state = State::kUnloaded;
+      used_bytes_ -= model.size_bytes;
+      ReportMemoryUsage();
+    }
+  }
+
+  std::vector<base::OnceCallback<void(bool)>> waiters;
+  waiters.swap(model.waiters);
+  if (success) {
+    model.pin_count += static_cast<int>(waiters.size());
+  }
+  for (auto& waiter : waiters) {
+    std::move(waiter).Run(success);
+  }
+}
+
+bool ModelResidencyManager::MakeRoom(size_t needed, double max_victim_score) {
+  if (needed > memory_budget_) {
+    return false;
+  }
+  if (used_bytes_ + needed <= memory_budget_) {
+    return true;
+  }
+
+  base::Time now = clock_->Now();
+  std::vector<std::pair<ModelType, Model*>> candidates;
+  size_t reclaimable = 0;
+  for (auto& [type, model] : models_) {
+    if (model.state == State::kResident && model.pin_count == 0 &&
+        DecayedScore(model, now) < max_victim_score) {
+      candidates.emplace_back(type, &model);
+      reclaimable += model.size_bytes;
+    }
+  }
+  // Check before unloading anything: a failed load should leave every
+  // model in place. Reclaiming for a smaller budget does what it can.
+  if (needed > 0 && used_bytes_ - reclaimable + needed > memory_budget_) {
+    return false;
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const auto& a, const auto& b) {
+              return a.second->last_used < b.second->last_used;
+            });
+  for (auto& [type, model] : candidates) {
+    if (used_bytes_ + needed <= memory_budget_) {
+      break;
+    }
+    Unload(type, *model);
+  }
+  return used_bytes_ + needed <= memory_budget_;
+}
+
+void ModelResidencyManager::Unload(ModelType type, Model& model) {
+  delegate_->UnloadModel(type);
+  model.state = State::kUnloaded;
+  used_bytes_ -= model.size_bytes;
+  ReportMemoryUsage();
+}
+
+void ModelResidencyManager::OnMemoryPressure(
+    MemoryAccount::PressureLevel level) {
+  // Reclaim as for a smaller budget, without keeping it
+  size_t budget = memory_budget_;
+  memory_budget_ =
+      level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL
+          ? 0
+          : budget / 2;
+  MakeRoom(0, std::numeric_limits<double>::infinity());
+  memory_budget_ = budget;
+}
+
+void ModelResidencyManager::ReportMemoryUsage() {
+  size_t loaded = 0;
+  for (const auto& [type, model] : models_) {
+    if (model.state != State::kUnloaded) {
+      loaded++;
+    }
+  }
+  memory_account_->Update(used_bytes_, loaded);
+}
+
+double ModelResidencyManager::DecayedScore(const Model& model,
+                                           base::Time now) const {
+  if (model.usage_score == 0.0) {
+    return 0.0;
+  }
+  double half_lives = (now - model.usage_time) / usage_half_life_;
+  return model.usage_score * std::exp2(-std::max(half_lives, 0.0));
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,156 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_MODEL_RESIDENCY_MANAGER_H_
+#define ASOL_CORE_MODEL_RESIDENCY_MANAGER_H_
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "asol/core/local_ai_processor.h"
+#include "asol/core/memory_accountant.h"
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/clock.h"
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// ModelResidencyManager decides which local models stay loaded, so that
+// together they fit in a memory budget instead of pushing the machine into
+// swap.
+//
+// Callers Acquire() a model before running it and Release() it afterwards.
+// A model in use is never unloaded. When a load needs room, idle models
+// are unloaded least recently used first. Each model also keeps a usage
+// score (uses, decaying with |usage_half_life|) that guards speculative
+// loads: Preload() and page hints only fill free memory or displace models
+// used less than the one being preloaded, so a guess never evicts
+// something the user relies on.
+//
+// Loaded and loading models are reported to the MemoryAccountant as
+// "local_models". Memory pressure unloads idle models as if the budget were
+// halved, or to nothing when critical; models in use stay.
+//
+// Must be used on one sequence.
+class ModelResidencyManager {
+ public:
+  using ModelType = LocalAIProcessor::ModelType;
+
+  // Does the actual loading; usually the LocalAIProcessor
+  class Delegate {
+   public:
+    virtual ~Delegate() = default;
+
+    virtual void LoadModel(ModelType type,
+                           base::OnceCallback<void(bool success)> callback) = 0;
+    virtual void UnloadModel(ModelType type) = 0;
+  };
+
+  struct Options {
+    // Upper bound on the summed size of loaded and loading models. Zero
+    // means a quarter of physical memory.
+    size_t memory_budget_bytes = 0;
+
+    // Age at which a use counts half in the usage score
+    base::TimeDelta usage_half_life = base::Minutes(30);
+  };
+
+  // What is known about a page as it opens, for predictive preloading
+  struct PageSignals {
+    size_t image_count = 0;
+    size_t video_count = 0;
+    size_t text_bytes = 0;
+  };
+
+  // |delegate| must outlive this object.
+  ModelResidencyManager(Delegate* delegate, const Options& options);
+  ~ModelResidencyManager();
+
+  ModelResidencyManager(const ModelResidencyManager&) = delete;
+  ModelResidencyManager& operator=(const ModelResidencyManager&) = delete;
+
+  // Make |type| known, with the memory it takes once loaded.
+  void RegisterModel(ModelType type, size_t size_bytes);
+
+  // Load |type| if needed and keep it loaded until Release(). |callback|
+  // gets false if the model is unknown, does not fit next to the models in
+  // use, or fails to load. Runs |callback| at once if already loaded.
+  void Acquire(ModelType type, base::OnceCallback<void(bool)> callback);
+  void Release(ModelType type);
+
+  // Load |type| ahead of use if it can be done without evicting a model
+  // used more often.
+  void Preload(ModelType type);
+
+  // Preload the models |signals| suggest will be needed: the vision model
+  // for media-heavy pages, the small text model for long articles.
+  void OnPageOpened(const PageSignals& signals);
+
+  // Change the budget, unloading idle models until it is met.
+  void SetMemoryBudget(size_t bytes);
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+  bool IsResident(ModelType type) const;
+
+  // Summed size of loaded and loading models
+  size_t GetUsedBytes() const { return used_bytes_; }
+
+  // Decayed number of uses of |type|
+  double GetUsageScore(ModelType type) const;
+
+  void SetClockForTesting(const base::Clock* clock) { clock_ = clock; }
+
+ private:
+  enum class State { kUnloaded, kLoading, kResident };
+
+  struct Model {
+    size_t size_bytes = 0;
+    State state = State::kUnloaded;
+    int pin_count = 0;
+    base::Time last_used;
+    double usage_score = 0.0;
+    base::Time usage_time;
+    std::vector<base::OnceCallback<void(bool)>> waiters;
+  };
+
+  // Start loading |type|, unloading idle models to make room. With
+  // |max_victim_score|, only models with a lower usage score may be
+  // unloaded. Returns false if there is not enough room.
+  bool StartLoad(ModelType type, Model& model, double max_victim_score);
+
+  void OnLoaded(ModelType type, bool success);
+
+  // Unload idle models, least recently used first, until |needed| more
+  // bytes fit. Returns false, unloading nothing, if that is impossible.
+  bool MakeRoom(size_t needed, double max_victim_score);
+
+  void Unload(ModelType type, Model& model);
+
+  // |model|'s usage score decayed to now
+  double DecayedScore(const Model& model, base::Time now) const;
+
+  void OnMemoryPressure(MemoryAccount::PressureLevel level);
+  void ReportMemoryUsage();
+
+  Delegate* const delegate_;
+  const base::TimeDelta usage_half_life_;
+  const base::Clock* clock_;
+  size_t memory_budget_;
+  size_t used_bytes_ = 0;
+
+  std::unordered_map<ModelType, Model> models_;
+
+  std::unique_ptr<MemoryAccount> memory_account_;
+
+  base::WeakPtrFactory<ModelResidencyManager> weak_ptr_factory_{this};
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_MODEL_RESIDENCY_MANAGER_H_
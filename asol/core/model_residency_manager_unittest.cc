@@ -0,0 +1,178 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/model_residency_manager.h"
+
+#include <map>
+#include <vector>
+
+#include "base/test/bind.h"
+#include "base/test/simple_test_clock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+using ModelType = ModelResidencyManager::ModelType;
+
+constexpr size_t kMiB = 1024 * 1024;
+
+// Completes loads when told to, and records what is loaded
+class FakeDelegate : public ModelResidencyManager::Delegate {
+ public:
+  void LoadModel(ModelType type,
+                 base::OnceCallback<void(bool)> callback) override {
+    pending_[type] = std::move(callback);
+  }
+  void UnloadModel(ModelType type) override { unloaded.push_back(type); }
+
+  bool IsLoading(ModelType type) const { return pending_.count(type) > 0; }
+
+  void Finish(ModelType type, bool success = true) {
+    auto callback = std::move(pending_[type]);
+    pending_.erase(type);
+    std::move(callback).Run(success);
+  }
+
+  std::vector<ModelType> unloaded;
+
+ private:
+  std::map<ModelType, base::OnceCallback<void(bool)>> pending_;
+};
+
+class ModelResidencyManagerTest : public testing::Test {
+ protected:
+  ModelResidencyManagerTest() : manager_(&delegate_, MakeOptions()) {
+    clock_.SetNow(base::Time::Now());
+    manager_.SetClockForTesting(&clock_);
+    manager_.RegisterModel(ModelType::TEXT_SMALL, 400 * kMiB);
+    manager_.RegisterModel(ModelType::TEXT_MEDIUM, 600 * kMiB);
+    manager_.RegisterModel(ModelType::VISION_SMALL, 500 * kMiB);
+    manager_.RegisterModel(ModelType::EMBEDDING, 100 * kMiB);
+  }
+
+  static ModelResidencyManager::Options MakeOptions() {
+    ModelResidencyManager::Options options;
+    options.memory_budget_bytes = 1024 * kMiB;
+    return options;
+  }
+
+  // Acquire |type|, complete its load if one starts, and report the result
+  bool AcquireNow(ModelType type) {
+    bool result = false;
+    manager_.Acquire(type, base::BindLambdaForTesting(
+                               [&](bool success) { result = success; }));
+    if (delegate_.IsLoading(type)) {
+      delegate_.Finish(type);
+    }
+    return result;
+  }
+
+  base::SimpleTestClock clock_;
+  FakeDelegate delegate_;
+  ModelResidencyManager manager_;
+};
+
+TEST_F(ModelResidencyManagerTest, UnloadsLeastRecentlyUsedIdleModel) {
+  ASSERT_TRUE(AcquireNow(ModelType::TEXT_SMALL));
+  manager_.Release(ModelType::TEXT_SMALL);
+  clock_.Advance(base::Seconds(1));
+  ASSERT_TRUE(AcquireNow(ModelType::EMBEDDING));
+  manager_.Release(ModelType::EMBEDDING);
+  clock_.Advance(base::Seconds(1));
+
+  ASSERT_TRUE(AcquireNow(ModelType::TEXT_MEDIUM));
+  EXPECT_EQ(delegate_.unloaded,
+            std::vector<ModelType>({ModelType::TEXT_SMALL}));
+  EXPECT_FALSE(manager_.IsResident(ModelType::TEXT_SMALL));
+  EXPECT_TRUE(manager_.IsResident(ModelType::EMBEDDING));
+  EXPECT_EQ(manager_.GetUsedBytes(), 700 * kMiB);
+}
+
+TEST_F(ModelResidencyManagerTest, ModelsInUseAreNeverUnloaded) {
+  ASSERT_TRUE(AcquireNow(ModelType::TEXT_SMALL));
+  ASSERT_TRUE(AcquireNow(ModelType::VISION_SMALL));
+
+  // Room only if TEXT_SMALL or VISION_SMALL went, and both are in use
+  EXPECT_FALSE(AcquireNow(ModelType::TEXT_MEDIUM));
+  EXPECT_TRUE(delegate_.unloaded.empty());
+  EXPECT_EQ(manager_.GetUsedBytes(), 900 * kMiB);
+
+  manager_.Release(ModelType::VISION_SMALL);
+  EXPECT_TRUE(AcquireNow(ModelType::TEXT_MEDIUM));
+  EXPECT_TRUE(manager_.IsResident(ModelType::TEXT_SMALL));
+}
+
+TEST_F(ModelResidencyManagerTest, ConcurrentAcquiresShareOneLoad) {
+  int ready = 0;
+  auto count = base::BindLambdaForTesting([&](bool success) {
+    EXPECT_TRUE(success);
+    ready++;
+  });
+  manager_.Acquire(ModelType::EMBEDDING, count);
+  manager_.Acquire(ModelType::EMBEDDING, count);
+  EXPECT_EQ(ready, 0);
+  delegate_.Finish(ModelType::EMBEDDING);
+  EXPECT_EQ(ready, 2);
+
+  // Pinned twice; one release leaves it in use
+  manager_.Release(ModelType::EMBEDDING);
+  manager_.SetMemoryBudget(0);
+  EXPECT_TRUE(manager_.IsResident(ModelType::EMBEDDING));
+  manager_.Release(ModelType::EMBEDDING);
+  EXPECT_FALSE(manager_.IsResident(ModelType::EMBEDDING));
+}
+
+TEST_F(ModelResidencyManagerTest, FailedLoadReleasesItsReservation) {
+  bool result = true;
+  manager_.Acquire(ModelType::VISION_SMALL,
+                   base::BindLambdaForTesting(
+                       [&](bool success) { result = success; }));
+  EXPECT_EQ(manager_.GetUsedBytes(), 500 * kMiB);
+  delegate_.Finish(ModelType::VISION_SMALL, /*success=*/false);
+  EXPECT_FALSE(result);
+  EXPECT_EQ(manager_.GetUsedBytes(), 0u);
+}
+
+TEST_F(ModelResidencyManagerTest, PreloadDoesNotEvictMoreUsedModels) {
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(AcquireNow(ModelType::TEXT_MEDIUM));
+    manager_.Release(ModelType::TEXT_MEDIUM);
+  }
+
+  // A media-heavy page asks for the vision model, but it only fits by
+  // unloading the model the user keeps using
+  manager_.OnPageOpened({/*image_count=*/20, /*video_count=*/0,
+                         /*text_bytes=*/0});
+  EXPECT_FALSE(delegate_.IsLoading(ModelType::VISION_SMALL));
+  EXPECT_TRUE(manager_.IsResident(ModelType::TEXT_MEDIUM));
+
+  // Free room is fair game
+  manager_.OnPageOpened({/*image_count=*/0, /*video_count=*/0,
+                         /*text_bytes=*/64 * 1024});
+  ASSERT_TRUE(delegate_.IsLoading(ModelType::TEXT_SMALL));
+  delegate_.Finish(ModelType::TEXT_SMALL);
+  EXPECT_TRUE(manager_.IsResident(ModelType::TEXT_SMALL));
+}
+
+TEST_F(ModelResidencyManagerTest, UsageScoreDecays) {
+  ASSERT_TRUE(AcquireNow(ModelType::EMBEDDING));
+  ASSERT_TRUE(AcquireNow(ModelType::EMBEDDING));
+  EXPECT_DOUBLE_EQ(manager_.GetUsageScore(ModelType::EMBEDDING), 2.0);
+  clock_.Advance(base::Minutes(30));
+  EXPECT_DOUBLE_EQ(manager_.GetUsageScore(ModelType::EMBEDDING), 1.0);
+  EXPECT_EQ(manager_.GetUsageScore(ModelType::CLASSIFICATION), 0.0);
+}
+
+TEST_F(ModelResidencyManagerTest, UnknownOrOversizedModelsFail) {
+  EXPECT_FALSE(AcquireNow(ModelType::CLASSIFICATION));
+  manager_.RegisterModel(ModelType::CUSTOM, 2048 * kMiB);
+  EXPECT_FALSE(AcquireNow(ModelType::CUSTOM));
+  EXPECT_EQ(manager_.GetUsedBytes(), 0u);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
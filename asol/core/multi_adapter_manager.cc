@@ -4,16 +4,64 @@
 
 #include "asol/core/multi_adapter_manager.h"
 
+#include <algorithm>
 #include <utility>
 #include <functional>
-#include <sstream>
-#include <algorithm>
 
+#include "asol/core/local_ai_processor.h"
+#include "base/functional/callback_helpers.h"
 #include "base/logging.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/trace_event/trace_event.h"
 
 namespace asol {
 namespace core {
 
+namespace {
+
+// Persisted records are the serialized RequestKey, the provider ID and
+// the response; this separates the provider ID from the response
+constexpr char kPersistentRecordSeparator = '\0';
+
+ShardedResponseCache::Limits GetMemoryCacheLimits(
+    const MultiAdapterManager::CacheConfig& config) {
+  ShardedResponseCache::Limits limits;
+  limits.max_entries = config.max_entries;
+  limits.max_bytes = config.max_bytes;
+  limits.max_age_seconds = config.max_age_seconds;
+  limits.stale_while_revalidate_seconds =
+      config.stale_while_revalidate_seconds;
+  limits.compression_threshold_bytes = config.compression_threshold_bytes;
+  limits.frequency_admission = config.frequency_admission_enabled;
+  return limits;
+}
+
+uint32_t TaskTypeBit(AIServiceProvider::TaskType task_type) {
+  return 1u << static_cast<size_t>(task_type);
+}
+
+// Ends |span| when the provider answers
+MultiAdapterManager::AIResponseCallback EndSpanOnResponse(
+    TraceSpan span,
+    MultiAdapterManager::AIResponseCallback callback) {
+  return base::BindOnce(
+      [](TraceSpan span, MultiAdapterManager::AIResponseCallback callback,
+         bool success, const std::string& response) {
+        span.End();
+        std::move(callback).Run(success, response);
+      },
+      std::move(span), std::move(callback));
+}
+
+}  // namespace
+
+MultiAdapterManager::InFlightRequest::InFlightRequest() = default;
+MultiAdapterManager::InFlightRequest::InFlightRequest(InFlightRequest&&) =
+    default;
+MultiAdapterManager::InFlightRequest&
+MultiAdapterManager::InFlightRequest::operator=(InFlightRequest&&) = default;
+MultiAdapterManager::InFlightRequest::~InFlightRequest() = default;
+
 MultiAdapterManager::MultiAdapterManager() {
   LOG(INFO) << "MultiAdapterManager initialized.";
 }
@@ -42,6 +90,8 @@ void MultiAdapterManager::RegisterProvider(std::unique_ptr<AIServiceProvider> pr
     active_provider_id_ = provider_id;
     LOG(INFO) << "Set " << provider_id << " as the active provider.";
   }
+
+  RebuildCapabilityIndex();
 }
 
 std::vector<std::string> MultiAdapterManager::GetRegisteredProviderIds() const {
@@ -74,6 +124,7 @@ bool MultiAdapterManager::SetActiveProvider(const std::string& provider_id) {
   
   active_provider_id_ = provider_id;
   LOG(INFO) << "Set " << provider_id << " as the active provider.";
+  RebuildCapabilityIndex();
   return true;
 }
 
@@ -102,120 +153,606 @@ std::string MultiAdapterManager::GetActiveProviderId() const {
 void MultiAdapterManager::ProcessRequest(
     const AIRequestParams& params,
     AIResponseCallback callback) {
+  ProcessRequestWithMetadata(params, DropMetadata(std::move(callback)));
+}
+
+void MultiAdapterManager::ProcessRequestWithMetadata(
+    const AIRequestParams& params,
+    AIResponseWithMetadataCallback callback) {
+  callback = RecordOnCompletion(params, std::move(callback));
+
   // Check if the response is in the cache
+  RequestFingerprint cache_key;
+  if (cache_config_.enabled || cache_config_.coalesce_in_flight_requests) {
+    cache_key = GenerateCacheKey(params);
+  }
   if (cache_config_.enabled) {
-    std::string cache_key = GenerateCacheKey(params);
     std::string cached_response;
+    ResponseMetadata metadata;
     
-    if (CheckCache(cache_key, &cached_response)) {
-      LOG(INFO) << "Cache hit for request: " << cache_key;
-      std::move(callback).Run(true, cached_response);
+    if (CheckCache(cache_key, params, &cached_response, &metadata)) {
+      LOG(INFO) << "Cache hit for request: " << cache_key.ToString()
+                << (metadata.is_stale ? " (stale)" : "");
+      if (metadata.is_stale) {
+        ScheduleRevalidation(std::string(), params, cache_key);
+      }
+      std::move(callback).Run(true, cached_response, metadata);
       return;
     }
   }
   
   AIServiceProvider* active_provider = GetActiveProvider();
   if (!active_provider) {
-    std::move(callback).Run(false, "No active AI provider available.");
+    std::move(callback).Run(false, "No active AI provider available.",
+                            ResponseMetadata());
     return;
   }
   
   // Check if the active provider supports this task type
-  if (!active_provider->SupportsTaskType(params.task_type)) {
+  if (!ProviderSupportsTask(active_provider_id_, params.task_type)) {
     // Try to find a provider that supports this task type
     std::string best_provider_id = FindBestProviderForTask(params.task_type);
     if (!best_provider_id.empty() && best_provider_id != active_provider_id_) {
       LOG(INFO) << "Active provider doesn't support task type " 
                 << static_cast<int>(params.task_type) 
                 << ", switching to " << best_provider_id;
-      ProcessRequestWithProvider(best_provider_id, params, std::move(callback));
+      ProcessRequestWithProviderAndMetadata(best_provider_id, params,
+                                            std::move(callback));
       return;
     }
     
     // No suitable provider found
-    std::move(callback).Run(false, "Active provider doesn't support this task type.");
+    std::move(callback).Run(false,
+                            "Active provider doesn't support this task type.",
+                            ResponseMetadata());
     return;
   }
   
   // Process the request with the active provider
-  if (cache_config_.enabled) {
-    std::string cache_key = GenerateCacheKey(params);
-    active_provider->ProcessRequest(
-        params,
-        base::BindOnce(
-            [](base::WeakPtr<MultiAdapterManager> self,
-               std::string cache_key,
-               std::string provider_id,
-               AIResponseCallback callback,
-               bool success,
-               const std::string& response) {
-              if (success && self) {
-                // Add the response to the cache
-                self->AddToCache(cache_key, response, provider_id);
-              }
-              std::move(callback).Run(success, response);
-            },
-            weak_ptr_factory_.GetWeakPtr(),
-            cache_key,
-            active_provider_id_,
-            std::move(callback)));
-  } else {
-    active_provider->ProcessRequest(params, std::move(callback));
-  }
+  DispatchRequest(active_provider, active_provider_id_, params,
+                  std::move(cache_key),
+                  BindMetadata(std::move(callback), active_provider_id_));
 }
 
 void MultiAdapterManager::ProcessRequestWithProvider(
     const std::string& provider_id,
     const AIRequestParams& params,
     AIResponseCallback callback) {
+  ProcessRequestWithProviderAndMetadata(
+      provider_id, params,
+      RecordOnCompletion(params, DropMetadata(std::move(callback))));
+}
+
+void MultiAdapterManager::ProcessRequestWithProviderAndMetadata(
+    const std::string& provider_id,
+    const AIRequestParams& params,
+    AIResponseWithMetadataCallback callback) {
   // Check if the response is in the cache
+  RequestFingerprint cache_key;
+  if (cache_config_.enabled || cache_config_.coalesce_in_flight_requests) {
+    cache_key = GenerateCacheKey(params);
+  }
   if (cache_config_.enabled) {
-    std::string cache_key = GenerateCacheKey(params);
     std::string cached_response;
+    ResponseMetadata metadata;
     
-    if (CheckCache(cache_key, &cached_response)) {
-      LOG(INFO) << "Cache hit for request: " << cache_key;
-      std::move(callback).Run(true, cached_response);
+    if (CheckCache(cache_key, params, &cached_response, &metadata)) {
+      LOG(INFO) << "Cache hit for request: " << cache_key.ToString()
+                << (metadata.is_stale ? " (stale)" : "");
+      if (metadata.is_stale) {
+        ScheduleRevalidation(provider_id, params, cache_key);
+      }
+      std::move(callback).Run(true, cached_response, metadata);
       return;
     }
   }
   
   AIServiceProvider* provider = GetProvider(provider_id);
   if (!provider) {
-    std::move(callback).Run(false, "Provider not found: " + provider_id);
+    std::move(callback).Run(false, "Provider not found: " + provider_id,
+                            ResponseMetadata());
     return;
   }
   
   // Check if the provider supports this task type
-  if (!provider->SupportsTaskType(params.task_type)) {
-    std::move(callback).Run(false, "Provider " + provider_id + " doesn't support this task type.");
+  if (!ProviderSupportsTask(provider_id, params.task_type)) {
+    std::move(callback).Run(
+        false, "Provider " + provider_id + " doesn't support this task type.",
+        ResponseMetadata());
     return;
   }
   
   // Process the request with the specified provider
+  DispatchRequest(provider, provider_id, params, std::move(cache_key),
+                  BindMetadata(std::move(callback), provider_id));
+}
+
+void MultiAdapterManager::ProcessStreamingRequest(
+    const AIRequestParams& params,
+    AIStreamCallback callback) {
+  RequestFingerprint cache_key;
   if (cache_config_.enabled) {
-    std::string cache_key = GenerateCacheKey(params);
-    provider->ProcessRequest(
-        params,
-        base::BindOnce(
-            [](base::WeakPtr<MultiAdapterManager> self,
-               std::string cache_key,
-               std::string provider_id,
-               AIResponseCallback callback,
-               bool success,
-               const std::string& response) {
-              if (success && self) {
-                // Add the response to the cache
-                self->AddToCache(cache_key, response, provider_id);
-              }
-              std::move(callback).Run(success, response);
-            },
-            weak_ptr_factory_.GetWeakPtr(),
-            cache_key,
-            provider_id,
-            std::move(callback)));
-  } else {
+    cache_key = GenerateCacheKey(params);
+    std::string cached_response;
+    ResponseMetadata metadata;
+    if (CheckCache(cache_key, params, &cached_response, &metadata)) {
+      if (metadata.is_stale) {
+        ScheduleRevalidation(std::string(), params, cache_key);
+      }
+      callback.Run(MakeFinalStreamDelta(true, cached_response));
+      return;
+    }
+  }
+
+  std::string provider_id = active_provider_id_;
+  if (!ProviderSupportsTask(provider_id, params.task_type)) {
+    provider_id = FindBestProviderForTask(params.task_type);
+  }
+  AIServiceProvider* provider =
+      provider_id.empty() ? nullptr : GetProvider(provider_id);
+  if (provider &&
+      !GetCircuitBreaker(provider_id).AllowRequest(base::TimeTicks::Now())) {
+    std::string fallback_id =
+        FindAvailableProvider(params.task_type, provider_id);
+    LOG(INFO) << "Circuit open for " << provider_id << ", routing stream to "
+              << (fallback_id.empty() ? "nothing" : fallback_id);
+    provider_id = fallback_id;
+    provider = provider_id.empty() ? nullptr : GetProvider(provider_id);
+  }
+  if (!provider) {
+    callback.Run(MakeFinalStreamDelta(
+        false, "No available provider for streaming request."));
+    return;
+  }
+
+  provider->ProcessStreamingRequest(
+      params, base::BindRepeating(&MultiAdapterManager::OnStreamDelta,
+                                  weak_ptr_factory_.GetWeakPtr(), cache_key,
+                                  RequestKey(params), provider_id,
+                                  base::Owned(std::make_unique<std::string>()),
+                                  std::move(callback)));
+}
+
+void MultiAdapterManager::OnStreamDelta(const RequestFingerprint& cache_key,
+                                        const RequestKey& request,
+                                        const std::string& provider_id,
+                                        std::string* text,
+                                        const AIStreamCallback& callback,
+                                        const StreamDelta& delta) {
+  if (!cache_key.IsEmpty()) {
+    text->append(delta.text);
+  }
+  if (!delta.is_final) {
+    callback.Run(delta);
+    return;
+  }
+
+  // A cancelled stream says nothing about the provider's health
+  if (delta.finish_reason != StreamFinishReason::kCancelled) {
+    CircuitBreaker& breaker = GetCircuitBreaker(provider_id);
+    if (delta.success) {
+      breaker.RecordSuccess();
+    } else {
+      breaker.RecordFailure(base::TimeTicks::Now());
+    }
+  }
+  // A response cut short by the token limit or a filter is not one to
+  // serve again
+  if (delta.success && delta.finish_reason == StreamFinishReason::kStop &&
+      !cache_key.IsEmpty()) {
+    AddToCache(cache_key, request, *text, provider_id);
+  }
+  callback.Run(delta);
+}
+
+// static
+MultiAdapterManager::AIResponseCallback MultiAdapterManager::BindMetadata(
+    AIResponseWithMetadataCallback callback,
+    const std::string& provider_id) {
+  ResponseMetadata metadata;
+  metadata.provider_id = provider_id;
+  return base::BindOnce(
+      [](AIResponseWithMetadataCallback callback, ResponseMetadata metadata,
+         bool success, const std::string& response) {
+        std::move(callback).Run(success, response, metadata);
+      },
+      std::move(callback), std::move(metadata));
+}
+
+// static
+MultiAdapterManager::AIResponseWithMetadataCallback
+MultiAdapterManager::DropMetadata(AIResponseCallback callback) {
+  return base::BindOnce(
+      [](AIResponseCallback callback, bool success, const std::string& response,
+         const ResponseMetadata& metadata) {
+        std::move(callback).Run(success, response);
+      },
+      std::move(callback));
+}
+
+MultiAdapterManager::AIResponseWithMetadataCallback
+MultiAdapterManager::RecordOnCompletion(
+    const AIRequestParams& params,
+    AIResponseWithMetadataCallback callback) {
+  if (!trace_recorder_) {
+    return callback;
+  }
+  base::TimeTicks now = base::TimeTicks::Now();
+  RequestTraceRecorder::Event event;
+  event.start = now - trace_recorder_->origin();
+  event.task_type = params.task_type;
+  event.input_bytes = params.input_text.size();
+  event.prompt_hash = GenerateCacheKey(params).ToString();
+  return base::BindOnce(&MultiAdapterManager::RecordRequest,
+                        weak_ptr_factory_.GetWeakPtr(), std::move(event), now,
+                        std::move(callback));
+}
+
+// static
+void MultiAdapterManager::RecordRequest(
+    base::WeakPtr<MultiAdapterManager> manager,
+    RequestTraceRecorder::Event event,
+    base::TimeTicks started,
+    AIResponseWithMetadataCallback callback,
+    bool success,
+    const std::string& response,
+    const ResponseMetadata& metadata) {
+  if (manager && manager->trace_recorder_) {
+    event.provider_id = metadata.provider_id;
+    if (!metadata.from_cache) {
+      event.cache_outcome = RequestTraceRecorder::CacheOutcome::MISS;
+    } else if (metadata.is_stale) {
+      event.cache_outcome = RequestTraceRecorder::CacheOutcome::STALE_HIT;
+    } else {
+      event.cache_outcome = RequestTraceRecorder::CacheOutcome::HIT;
+    }
+    event.latency = base::TimeTicks::Now() - started;
+    event.success = success;
+    event.output_bytes = success ? response.size() : 0;
+    manager->trace_recorder_->Record(event);
+  }
+  std::move(callback).Run(success, response, metadata);
+}
+
+void MultiAdapterManager::ScheduleRevalidation(const std::string& provider_id,
+                                               const AIRequestParams& params,
+                                               const RequestFingerprint& cache_key) {
+  // A refresh, or an ordinary miss for the same key, is already on the
+  // wire. Misses are only tracked while coalescing; refreshes always are.
+  if (in_flight_requests_.count(cache_key) ||
+      !revalidating_keys_.insert(cache_key).second) {
+    return;
+  }
+  
+  revalidations_++;
+  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&MultiAdapterManager::Revalidate,
+                     weak_ptr_factory_.GetWeakPtr(), provider_id, params,
+                     cache_key));
+}
+
+void MultiAdapterManager::Revalidate(const std::string& provider_id,
+                                     const AIRequestParams& params,
+                                     const RequestFingerprint& cache_key) {
+  std::string target_id = provider_id;
+  if (target_id.empty()) {
+    target_id = FindBestProviderForTask(params.task_type);
+  }
+  
+  AIServiceProvider* provider =
+      target_id.empty() ? nullptr : GetProvider(target_id);
+  if (!provider || !ProviderSupportsTask(target_id, params.task_type)) {
+    revalidating_keys_.erase(cache_key);
+    return;
+  }
+  
+  // The stale entry has already been served; the fresh response only needs
+  // to land in the cache, even if the caller that found it goes away.
+  AIRequestParams refresh_params = params;
+  refresh_params.cancellation_token = nullptr;
+  DispatchRequest(provider, target_id, refresh_params, cache_key,
+                  base::BindOnce(&MultiAdapterManager::OnRevalidated,
+                                 weak_ptr_factory_.GetWeakPtr(), cache_key));
+}
+
+void MultiAdapterManager::OnRevalidated(const RequestFingerprint& cache_key,
+                                        bool success,
+                                        const std::string& response) {
+  revalidating_keys_.erase(cache_key);
+}
+
+void MultiAdapterManager::DispatchRequest(AIServiceProvider* provider,
+                                          const std::string& provider_id,
+                                          const AIRequestParams& params,
+                                          RequestFingerprint cache_key,
+                                          AIResponseCallback callback) {
+  // The caller gave up before the request got here; a cancelled token
+  // takes no more cancel callbacks
+  if (params.cancellation_token && params.cancellation_token->IsCancelled()) {
+    std::move(callback).Run(false, kRequestCancelledError);
+    return;
+  }
+
+  if (cache_key.IsEmpty()) {
     provider->ProcessRequest(params, std::move(callback));
+    return;
+  }
+  
+  AIRequestParams upstream_params = params;
+  // A request whose fingerprint only collides with the one on the wire
+  // goes out on its own
+  auto in_flight_it = in_flight_requests_.find(cache_key);
+  if (cache_config_.coalesce_in_flight_requests &&
+      (in_flight_it == in_flight_requests_.end() ||
+       in_flight_it->second.request.Matches(params))) {
+    // Attach to an identical request that is already on the wire
+    auto [it, inserted] = in_flight_requests_.try_emplace(cache_key);
+    InFlightRequest& in_flight = it->second;
+    in_flight.waiters.push_back(std::move(callback));
+    in_flight.waiter_tokens.push_back(params.cancellation_token);
+    if (params.cancellation_token) {
+      in_flight.cancel_subscriptions.push_back(
+          params.cancellation_token->AddCancelCallback(
+              base::BindOnce(&MultiAdapterManager::OnWaiterCancelled,
+                             weak_ptr_factory_.GetWeakPtr(), cache_key)));
+    }
+    if (!inserted) {
+      coalesced_requests_++;
+      LOG(INFO) << "Coalesced request with in-flight request: " << cache_key.ToString();
+      return;
+    }
+    in_flight.request = RequestKey(params);
+    
+    // One caller going away must not abort the others' request, so the
+    // upstream request carries a token of its own
+    if (params.cancellation_token) {
+      in_flight.upstream_token = base::MakeRefCounted<CancellationToken>();
+    }
+    upstream_params.cancellation_token = in_flight.upstream_token;
+    
+    // The waiters live in |in_flight_requests_|, so the provider callback
+    // does not carry one of its own.
+    callback = AIResponseCallback();
+  }
+  
+  if (cache_config_.enabled && cache_config_.semantic_cache_enabled &&
+      embedding_processor_) {
+    embedding_processor_->GenerateEmbedding(
+        upstream_params.input_text,
+        base::BindOnce(&MultiAdapterManager::OnPromptEmbedded,
+                       weak_ptr_factory_.GetWeakPtr(), provider_id,
+                       upstream_params, std::move(cache_key),
+                       std::move(callback)));
+    return;
+  }
+  
+  SendToProvider(provider, provider_id, upstream_params, std::move(cache_key),
+                 std::move(callback), {});
+}
+
+void MultiAdapterManager::OnWaiterCancelled(
+    const RequestFingerprint& cache_key) {
+  auto it = in_flight_requests_.find(cache_key);
+  if (it == in_flight_requests_.end() || !it->second.upstream_token) {
+    return;
+  }
+  for (const auto& token : it->second.waiter_tokens) {
+    if (!token || !token->IsCancelled()) {
+      return;
+    }
+  }
+  // Nobody wants the response any more; the provider completes the request
+  // with kRequestCancelledError, which releases the waiters
+  it->second.upstream_token->Cancel();
+}
+
+void MultiAdapterManager::OnPromptEmbedded(const std::string& provider_id,
+                                           const AIRequestParams& params,
+                                           const RequestFingerprint& cache_key,
+                                           AIResponseCallback callback,
+                                           const std::vector<float>& embedding) {
+  uint64_t scope = GenerateSemanticScope(params);
+  SemanticResponseCache::Match match;
+  if (semantic_cache_.Lookup(params.task_type, scope, embedding,
+                             GetSemanticThreshold(params.task_type),
+                             cache_config_.max_age_seconds, &match)) {
+    LOG(INFO) << "Semantic cache hit for request: " << cache_key.ToString()
+              << " (similarity " << match.similarity << ")";
+    semantic_hits_++;
+    OnProviderResponse(cache_key, match.provider_id, std::move(callback),
+                       RequestKey(params), scope, {}, true, match.response);
+    return;
+  }
+  
+  AIServiceProvider* provider = GetProvider(provider_id);
+  if (!provider) {
+    OnProviderResponse(cache_key, provider_id, std::move(callback),
+                       RequestKey(params), scope, {}, false,
+                       "Provider not found: " + provider_id);
+    return;
+  }
+  
+  SendToProvider(provider, provider_id, params, cache_key,
+                 std::move(callback), embedding);
+}
+
+void MultiAdapterManager::SendToProvider(AIServiceProvider* provider,
+                                         const std::string& provider_id,
+                                         const AIRequestParams& params,
+                                         RequestFingerprint cache_key,
+                                         AIResponseCallback callback,
+                                         std::vector<float> embedding) {
+  uint64_t scope = embedding.empty() ? 0 : GenerateSemanticScope(params);
+
+  // Skip a provider whose circuit is open rather than wait out its timeout
+  std::string target_id = provider_id;
+  if (!GetCircuitBreaker(target_id).AllowRequest(base::TimeTicks::Now())) {
+    target_id = FindAvailableProvider(params.task_type, provider_id);
+    if (target_id.empty()) {
+      OnProviderResponse(cache_key, provider_id, std::move(callback),
+                         RequestKey(params), scope, {}, false,
+                         "Provider " + provider_id +
+                             " is unavailable (circuit open)");
+      return;
+    }
+    LOG(INFO) << "Circuit open for " << provider_id << ", routing to "
+              << target_id;
+    provider = GetProvider(target_id);
+  }
+
+  AIResponseCallback on_response = base::BindOnce(
+      &MultiAdapterManager::OnProviderResponse, weak_ptr_factory_.GetWeakPtr(),
+      std::move(cache_key), target_id, std::move(callback), RequestKey(params),
+      scope, std::move(embedding));
+
+  // Covers the provider's call, retries included; the provider's own spans
+  // nest under it
+  TraceSpan span("MultiAdapterManager::SendToProvider", params.trace);
+  AIRequestParams provider_params = params;
+  provider_params.trace = span.context();
+  provider->ProcessRequest(
+      provider_params,
+      base::BindOnce(&MultiAdapterManager::OnProviderCallCompleted,
+                     weak_ptr_factory_.GetWeakPtr(), target_id,
+                     EndSpanOnResponse(std::move(span),
+                                       std::move(on_response))));
+}
+
+void MultiAdapterManager::OnProviderCallCompleted(
+    const std::string& provider_id,
+    AIResponseCallback callback,
+    bool success,
+    const std::string& response) {
+  // A cancelled request says nothing about the provider's health
+  if (!success && IsCancellationError(response)) {
+    std::move(callback).Run(success, response);
+    return;
+  }
+
+  CircuitBreaker& breaker = GetCircuitBreaker(provider_id);
+  if (success) {
+    breaker.RecordSuccess();
+  } else {
+    breaker.RecordFailure(base::TimeTicks::Now());
+  }
+  std::move(callback).Run(success, response);
+}
+
+CircuitBreaker& MultiAdapterManager::GetCircuitBreaker(
+    const std::string& provider_id) {
+  return circuit_breakers_.try_emplace(provider_id, circuit_breaker_config_)
+      .first->second;
+}
+
+std::string MultiAdapterManager::FindAvailableProvider(
+    AIServiceProvider::TaskType task_type,
+    const std::string& excluded_id) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (const std::string& id :
+       task_candidates_[static_cast<size_t>(task_type)]) {
+    if (id != excluded_id && GetCircuitBreaker(id).AllowRequest(now)) {
+      return id;
+    }
+  }
+  return std::string();
+}
+
+void MultiAdapterManager::RebuildCapabilityIndex() {
+  provider_task_masks_.clear();
+  for (auto& candidates : task_candidates_) {
+    candidates.clear();
+  }
+
+  std::vector<std::string> ids;
+  ids.reserve(providers_.size());
+  for (const auto& [id, provider] : providers_) {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kTaskTypeCount; ++i) {
+      auto task_type = static_cast<AIServiceProvider::TaskType>(i);
+      if (provider->SupportsTaskType(task_type)) {
+        mask |= TaskTypeBit(task_type);
+      }
+    }
+    provider_task_masks_[id] = mask;
+    ids.push_back(id);
+  }
+
+  // Rank the active provider first, then by ID so routing does not depend
+  // on hash order
+  std::sort(ids.begin(), ids.end(),
+            [this](const std::string& a, const std::string& b) {
+              bool a_active = a == active_provider_id_;
+              bool b_active = b == active_provider_id_;
+              return a_active != b_active ? a_active : a < b;
+            });
+  for (const std::string& id : ids) {
+    uint32_t mask = provider_task_masks_[id];
+    for (size_t i = 0; i < kTaskTypeCount; ++i) {
+      if (mask & (1u << i)) {
+        task_candidates_[i].push_back(id);
+      }
+    }
+  }
+}
+
+bool MultiAdapterManager::ProviderSupportsTask(
+    const std::string& provider_id,
+    AIServiceProvider::TaskType task_type) const {
+  auto it = provider_task_masks_.find(provider_id);
+  return it != provider_task_masks_.end() &&
+         (it->second & TaskTypeBit(task_type));
+}
+
+void MultiAdapterManager::SetCircuitBreakerConfig(
+    const CircuitBreaker::Config& config) {
+  circuit_breaker_config_ = config;
+  circuit_breakers_.clear();
+}
+
+CircuitBreaker::State MultiAdapterManager::GetProviderCircuitState(
+    const std::string& provider_id) const {
+  auto it = circuit_breakers_.find(provider_id);
+  if (it == circuit_breakers_.end()) {
+    return CircuitBreaker::State::CLOSED;
+  }
+  return it->second.GetState(base::TimeTicks::Now());
+}
+
+void MultiAdapterManager::OnProviderResponse(
+    const RequestFingerprint& cache_key,
+    const std::string& provider_id,
+    AIResponseCallback callback,
+    const RequestKey& request,
+    uint64_t semantic_scope,
+    const std::vector<float>& embedding,
+    bool success,
+    const std::string& response) {
+  if (success) {
+    // Add the response to the cache
+    AddToCache(cache_key, request, response, provider_id);
+    if (!embedding.empty() && cache_config_.semantic_cache_enabled) {
+      semantic_cache_.Insert(request.task_type, semantic_scope, embedding,
+                             response, provider_id);
+    }
+  }
+  
+  if (callback) {
+    std::move(callback).Run(success, response);
+    return;
+  }
+  
+  // Detach the waiters before running them so that a callback issuing the
+  // same request again starts a fresh upstream call.
+  auto it = in_flight_requests_.find(cache_key);
+  if (it == in_flight_requests_.end()) {
+    return;
+  }
+  std::vector<AIResponseCallback> waiters = std::move(it->second.waiters);
+  in_flight_requests_.erase(it);
+  
+  for (auto& waiter : waiters) {
+    std::move(waiter).Run(success, response);
   }
 }
 
@@ -228,6 +765,9 @@ bool MultiAdapterManager::ConfigureProvider(
   }
   
   provider->Configure(config);
+
+  // A new model may support a different set of tasks
+  RebuildCapabilityIndex();
   return true;
 }
 
@@ -243,163 +783,243 @@ std::unordered_map<std::string, std::string> MultiAdapterManager::GetProviderCon
 
 std::string MultiAdapterManager::FindBestProviderForTask(
     AIServiceProvider::TaskType task_type) const {
-  // First, check if the active provider supports this task
-  AIServiceProvider* active_provider = GetActiveProvider();
-  if (active_provider && active_provider->SupportsTaskType(task_type)) {
-    return active_provider_id_;
+  // The active provider leads every list it appears in
+  const auto& candidates = task_candidates_[static_cast<size_t>(task_type)];
+  if (candidates.empty()) {
+    return "";
   }
-  
-  // Otherwise, find the first provider that supports this task
-  for (const auto& [id, provider] : providers_) {
-    if (provider->SupportsTaskType(task_type)) {
-      return id;
-    }
+  return candidates.front();
+}
+
+void MultiAdapterManager::SetEmbeddingProcessor(LocalAIProcessor* processor) {
+  embedding_processor_ = processor;
+}
+
+void MultiAdapterManager::SetRequestTraceRecorder(
+    RequestTraceRecorder* recorder) {
+  trace_recorder_ = recorder;
+}
+
+void MultiAdapterManager::SetPersistentStore(
+    std::unique_ptr<PersistentResponseStore> store) {
+  base::AutoLock lock(persistent_lock_);
+  persistent_store_ = std::move(store);
+  if (persistent_store_) {
+    persistent_store_->SetTimeToLive(
+        base::Seconds(cache_config_.max_age_seconds +
+                      cache_config_.stale_while_revalidate_seconds));
   }
-  
-  // No provider found that supports this task
-  return "";
 }
 
 void MultiAdapterManager::ConfigureCache(const CacheConfig& config) {
+  if (config.max_semantic_entries != cache_config_.max_semantic_entries) {
+    semantic_cache_.SetMaxEntries(config.max_semantic_entries);
+  }
   cache_config_ = config;
-  
-  // If the cache size is being reduced, clean it up
-  if (response_cache_.size() > cache_config_.max_entries) {
-    CleanCache();
+  response_cache_.Configure(GetMemoryCacheLimits(cache_config_));
+  {
+    base::AutoLock lock(persistent_lock_);
+    if (persistent_store_) {
+      persistent_store_->SetTimeToLive(
+          base::Seconds(cache_config_.max_age_seconds +
+                      cache_config_.stale_while_revalidate_seconds));
+    }
   }
   
   LOG(INFO) << "Cache configured: enabled=" << (cache_config_.enabled ? "true" : "false")
             << ", max_entries=" << cache_config_.max_entries
+            << ", max_bytes=" << cache_config_.max_bytes
             << ", max_age_seconds=" << cache_config_.max_age_seconds;
 }
 
 void MultiAdapterManager::ClearCache() {
-  response_cache_.clear();
+  response_cache_.Clear();
+  semantic_cache_.Clear();
+  base::AutoLock lock(persistent_lock_);
+  if (persistent_store_) {
+    persistent_store_->Clear();
+  }
   LOG(INFO) << "Cache cleared";
 }
 
 MultiAdapterManager::CacheStats MultiAdapterManager::GetCacheStats() const {
   CacheStats stats;
+  size_t hits = cache_hits_.load(std::memory_order_relaxed);
+  size_t misses = cache_misses_.load(std::memory_order_relaxed);
   stats.total_entries = response_cache_.size();
-  stats.hits = cache_hits_;
-  stats.misses = cache_misses_;
-  stats.hit_rate = (cache_hits_ + cache_misses_ > 0) 
-      ? static_cast<double>(cache_hits_) / (cache_hits_ + cache_misses_) 
+  stats.hits = hits;
+  stats.misses = misses;
+  stats.evictions = response_cache_.evictions();
+  stats.expirations = response_cache_.expirations();
+  stats.resident_bytes = response_cache_.resident_bytes();
+  stats.uncompressed_bytes = response_cache_.uncompressed_bytes();
+  stats.compressed_entries = response_cache_.compressed_entries();
+  stats.admission_rejections = response_cache_.admission_rejections();
+  size_t stored_bytes = response_cache_.stored_response_bytes();
+  stats.compression_ratio = stored_bytes > 0
+      ? static_cast<double>(stats.uncompressed_bytes) / stored_bytes
+      : 1.0;
+  stats.coalesced_requests = coalesced_requests_;
+  stats.in_flight_requests = in_flight_requests_.size();
+  stats.semantic_entries = semantic_cache_.size();
+  stats.semantic_hits = semantic_hits_;
+  stats.persistent_hits = persistent_hits_.load(std::memory_order_relaxed);
+  stats.stale_hits = stale_hits_.load(std::memory_order_relaxed);
+  stats.revalidations = revalidations_;
+  stats.hit_rate = (hits + misses > 0) 
+      ? static_cast<double>(hits) / (hits + misses) 
       : 0.0;
   
   return stats;
 }
 
-std::string MultiAdapterManager::GenerateCacheKey(const AIRequestParams& params) const {
-  // Create a hash of the request parameters
-  std::stringstream ss;
-  ss << static_cast<int>(params.task_type) << "|"
-     << params.input_text << "|";
-  
-  // Include any additional parameters that affect the response
-  for (const auto& [key, value] : params.additional_params) {
-    ss << key << "=" << value << "|";
-  }
-  
-  // Use a simple hash function for the key
+RequestFingerprint MultiAdapterManager::GenerateCacheKey(
+    const AIRequestParams& params) const {
+  return ComputeRequestFingerprint(params.task_type, params.input_text,
+                                   params.custom_params);
+}
+
+uint64_t MultiAdapterManager::GenerateSemanticScope(
+    const AIRequestParams& params) const {
+  // Order-independent combination of the parameters, so the scope does not
+  // depend on unordered_map iteration order.
   std::hash<std::string> hasher;
-  return std::to_string(hasher(ss.str()));
+  uint64_t scope = static_cast<uint64_t>(params.task_type) + 1;
+  for (const auto& [key, value] : params.custom_params) {
+    scope += hasher(key) * 31 + hasher(value);
+  }
+  return scope;
+}
+
+float MultiAdapterManager::GetSemanticThreshold(
+    AIServiceProvider::TaskType task_type) const {
+  auto it = cache_config_.semantic_thresholds.find(task_type);
+  if (it != cache_config_.semantic_thresholds.end()) {
+    return it->second;
+  }
+  return cache_config_.default_semantic_threshold;
 }
 
-bool MultiAdapterManager::CheckCache(const std::string& cache_key, std::string* response) const {
+bool MultiAdapterManager::LookupCachedResponse(const AIRequestParams& params,
+                                               std::string* response) {
   if (!cache_config_.enabled) {
     return false;
   }
-  
-  auto it = response_cache_.find(cache_key);
-  if (it == response_cache_.end()) {
-    // Cache miss
-    cache_misses_++;
+  ResponseMetadata metadata;
+  return CheckCache(GenerateCacheKey(params), params, response, &metadata);
+}
+
+bool MultiAdapterManager::CheckCache(const RequestFingerprint& cache_key,
+                                     const AIRequestParams& params,
+                                     std::string* response,
+                                     ResponseMetadata* metadata) {
+  if (!cache_config_.enabled) {
     return false;
   }
+  TRACE_EVENT0("asol", "MultiAdapterManager::CheckCache");
   
-  // Check if the entry is expired
-  auto now = std::chrono::steady_clock::now();
-  auto age = std::chrono::duration_cast<std::chrono::seconds>(
-      now - it->second.timestamp).count();
+  CacheEntry entry;
+  bool is_stale = false;
+  if (response_cache_.Get(cache_key, params, &entry, &is_stale)) {
+    *response = std::move(entry.response);
+    metadata->from_cache = true;
+    metadata->is_stale = is_stale;
+    metadata->provider_id = std::move(entry.provider_id);
+    cache_hits_.fetch_add(1, std::memory_order_relaxed);
+    if (is_stale) {
+      stale_hits_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+  }
   
-  if (age > cache_config_.max_age_seconds) {
-    // Entry is expired
-    cache_misses_++;
-    return false;
+  // Fall back to the on-disk tier before counting a miss
+  if (LoadFromPersistentStore(cache_key, params, response, metadata)) {
+    metadata->from_cache = true;
+    cache_hits_.fetch_add(1, std::memory_order_relaxed);
+    persistent_hits_.fetch_add(1, std::memory_order_relaxed);
+    if (metadata->is_stale) {
+      stale_hits_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
   }
   
-  // Cache hit
-  *response = it->second.response;
-  cache_hits_++;
-  return true;
+  cache_misses_.fetch_add(1, std::memory_order_relaxed);
+  return false;
 }
 
 void MultiAdapterManager::AddToCache(
-    const std::string& cache_key,
+    const RequestFingerprint& cache_key,
+    const RequestKey& request,
     const std::string& response,
     const std::string& provider_id) {
   if (!cache_config_.enabled) {
     return;
   }
   
-  // Clean the cache if it's getting too large
-  if (response_cache_.size() >= cache_config_.max_entries) {
-    CleanCache();
-  }
-  
-  // Add the new entry
-  CacheEntry entry;
-  entry.response = response;
-  entry.timestamp = std::chrono::steady_clock::now();
-  entry.provider_id = provider_id;
+  InsertIntoMemoryCache(cache_key, request, response, provider_id,
+                        base::TimeDelta());
   
-  response_cache_[cache_key] = std::move(entry);
+  base::AutoLock lock(persistent_lock_);
+  if (persistent_store_) {
+    std::string record = request.Serialize();
+    record.append(provider_id);
+    record.push_back(kPersistentRecordSeparator);
+    record.append(response);
+    persistent_store_->Put(cache_key.ToString(), record);
+  }
 }
 
-void MultiAdapterManager::CleanCache() {
-  // If the cache is empty, nothing to do
-  if (response_cache_.empty()) {
-    return;
-  }
-  
-  auto now = std::chrono::steady_clock::now();
-  
-  // First, remove expired entries
-  for (auto it = response_cache_.begin(); it != response_cache_.end();) {
-    auto age = std::chrono::duration_cast<std::chrono::seconds>(
-        now - it->second.timestamp).count();
-    
-    if (age > cache_config_.max_age_seconds) {
-      it = response_cache_.erase(it);
-    } else {
-      ++it;
+bool MultiAdapterManager::LoadFromPersistentStore(const RequestFingerprint& cache_key,
+                                                  const AIRequestParams& params,
+                                                  std::string* response,
+                                                  ResponseMetadata* metadata) {
+  std::string record;
+  base::Time write_time;
+  {
+    base::AutoLock lock(persistent_lock_);
+    if (!persistent_store_ ||
+        !persistent_store_->Get(cache_key.ToString(), &record, &write_time)) {
+      return false;
     }
   }
   
-  // If we're still over the limit, remove the oldest entries
-  if (response_cache_.size() > cache_config_.max_entries) {
-    // Create a vector of pairs (key, timestamp) for sorting
-    std::vector<std::pair<std::string, std::chrono::time_point<std::chrono::steady_clock>>> 
-        entries;
-    entries.reserve(response_cache_.size());
-    
-    for (const auto& [key, entry] : response_cache_) {
-      entries.emplace_back(key, entry.timestamp);
-    }
-    
-    // Sort by timestamp (oldest first)
-    std::sort(entries.begin(), entries.end(),
-              [](const auto& a, const auto& b) {
-                return a.second < b.second;
-              });
-    
-    // Remove oldest entries until we're under the limit
-    size_t to_remove = response_cache_.size() - cache_config_.max_entries;
-    for (size_t i = 0; i < to_remove; ++i) {
-      response_cache_.erase(entries[i].first);
-    }
+  // The record starts with the request it answers
+  RequestKey request(params);
+  std::string serialized_request = request.Serialize();
+  if (record.compare(0, serialized_request.size(), serialized_request) != 0) {
+    return false;
+  }
+  size_t separator =
+      record.find(kPersistentRecordSeparator, serialized_request.size());
+  if (separator == std::string::npos) {
+    return false;
   }
+  
+  // The store drops records past the stale window itself; a record within
+  // it is served stale, and keeps its age once promoted into memory
+  base::TimeDelta age =
+      std::max(base::Time::Now() - write_time, base::TimeDelta());
+  std::string provider_id = record.substr(
+      serialized_request.size(), separator - serialized_request.size());
+  response->assign(record, separator + 1, std::string::npos);
+  metadata->provider_id = provider_id;
+  metadata->is_stale = age > base::Seconds(cache_config_.max_age_seconds);
+  InsertIntoMemoryCache(cache_key, std::move(request), *response, provider_id,
+                        age);
+  return true;
+}
+
+void MultiAdapterManager::InsertIntoMemoryCache(const RequestFingerprint& cache_key,
+                                                RequestKey request,
+                                                const std::string& response,
+                                                const std::string& provider_id,
+                                                base::TimeDelta age) {
+  CacheEntry entry;
+  entry.response = response;
+  entry.timestamp = std::chrono::steady_clock::now() -
+                    std::chrono::microseconds(age.InMicroseconds());
+  entry.provider_id = provider_id;
+  response_cache_.Put(cache_key, std::move(request), std::move(entry));
 }
 
 }  // namespace core
@@ -5,40 +5,92 @@
 #ifndef ASOL_CORE_MULTI_ADAPTER_MANAGER_H_
 #define ASOL_CORE_MULTI_ADAPTER_MANAGER_H_
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
-#include <vector>
-#include <chrono>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "asol/core/ai_service_provider.h"
+#include "asol/core/cancellation_token.h"
+#include "asol/core/circuit_breaker.h"
+#include "asol/core/persistent_response_store.h"
+#include "asol/core/request_fingerprint.h"
+#include "asol/core/request_trace_recorder.h"
+#include "asol/core/semantic_response_cache.h"
+#include "asol/core/sharded_response_cache.h"
+#include "asol/core/trace_context.h"
+#include "base/callback_list.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
 
 namespace asol {
 namespace core {
 
+class LocalAIProcessor;
+
 // MultiAdapterManager manages multiple AI service providers and allows
 // switching between them based on user preferences or task requirements.
+//
+// Request dispatch, configuration and GetCacheStats() run on the owning
+// sequence. Cache lookups are thread-safe so feature workers can probe the
+// cache directly through LookupCachedResponse().
 class MultiAdapterManager {
  public:
   // Cache entry for storing AI responses
-  struct CacheEntry {
-    std::string response;
-    std::chrono::time_point<std::chrono::steady_clock> timestamp;
-    std::string provider_id;
-  };
+  using CacheEntry = ShardedResponseCache::Entry;
 
   // Cache configuration
   struct CacheConfig {
     // Maximum number of entries in the cache
     size_t max_entries = 100;
+
+    // Maximum resident size of the in-memory cache in bytes, after
+    // compression
+    size_t max_bytes = 32 * 1024 * 1024;
+
+    // Responses at least this large are stored compressed; 0 disables
+    // compression
+    size_t compression_threshold_bytes = 4096;
+
+    // Whether a full cache admits a new response only if its key has been
+    // requested more often than the entry it would evict (TinyLFU). Keeps
+    // one-off prompts from flushing frequently repeated ones.
+    bool frequency_admission_enabled = false;
     
     // Maximum age of cache entries in seconds
     int max_age_seconds = 3600;  // 1 hour by default
+
+    // Grace period after |max_age_seconds| during which an entry is still
+    // served, flagged as stale, while a refresh runs in the background.
+    // 0 disables stale-while-revalidate.
+    int stale_while_revalidate_seconds = 0;
     
     // Whether to enable caching
     bool enabled = true;
+
+    // Whether identical requests issued while one is already in flight
+    // attach to the pending upstream call instead of starting their own.
+    bool coalesce_in_flight_requests = true;
+
+    // Whether exact-match misses fall through to the semantic tier, which
+    // serves a cached response for a prompt whose embedding is similar
+    // enough. Requires SetEmbeddingProcessor().
+    bool semantic_cache_enabled = false;
+
+    // Maximum number of entries in the semantic tier
+    size_t max_semantic_entries = 256;
+
+    // Minimum cosine similarity for a semantic hit, per task type. Task
+    // types not listed use |default_semantic_threshold|.
+    float default_semantic_threshold = 0.97f;
+    std::unordered_map<AIServiceProvider::TaskType, float> semantic_thresholds;
   };
 
   MultiAdapterManager();
@@ -69,14 +121,43 @@ class MultiAdapterManager {
   // Get the ID of the currently active provider
   std::string GetActiveProviderId() const;
 
+  // Describes where a response came from
+  struct ResponseMetadata {
+    // Served from the response cache rather than a provider round-trip
+    bool from_cache = false;
+
+    // Served past its max age while a background refresh is in progress
+    bool is_stale = false;
+
+    // Provider that produced the response, if known
+    std::string provider_id;
+  };
+
+  using AIResponseWithMetadataCallback =
+      base::OnceCallback<void(bool success,
+                              const std::string& response,
+                              const ResponseMetadata& metadata)>;
+
   // Process a request using the active provider
   void ProcessRequest(const AIRequestParams& params, AIResponseCallback callback);
 
+  // Same as ProcessRequest(), but the callback also learns whether the
+  // response was cached and whether it was stale.
+  void ProcessRequestWithMetadata(const AIRequestParams& params,
+                                  AIResponseWithMetadataCallback callback);
+
   // Process a request using a specific provider
   void ProcessRequestWithProvider(const std::string& provider_id,
                                 const AIRequestParams& params,
                                 AIResponseCallback callback);
 
+  // Stream a request's response as it is generated (see StreamDelta),
+  // routed like ProcessRequest(). A cache hit arrives as one final delta,
+  // and a completed stream is cached whole. Streams are never coalesced:
+  // each caller gets its own upstream request.
+  void ProcessStreamingRequest(const AIRequestParams& params,
+                               AIStreamCallback callback);
+
   // Configure a specific provider
   bool ConfigureProvider(const std::string& provider_id,
                        const std::unordered_map<std::string, std::string>& config);
@@ -85,13 +166,40 @@ class MultiAdapterManager {
   std::unordered_map<std::string, std::string> GetProviderConfiguration(
       const std::string& provider_id) const;
 
-  // Find the best provider for a specific task type
+  // Find the best provider for a specific task type: the active provider if
+  // it supports the task, otherwise the first supporting provider by ID.
+  // Answered from an index built at registration, without querying
+  // providers.
   std::string FindBestProviderForTask(AIServiceProvider::TaskType task_type) const;
 
-  // Configure the response cache
+  // Set the local processor used to embed prompts for the semantic cache
+  // tier. |processor| must outlive this manager; pass nullptr to detach.
+  void SetEmbeddingProcessor(LocalAIProcessor* processor);
+
+  // Back the in-memory cache with an on-disk store so entries survive
+  // restarts. Memory misses consult the store and successful responses are
+  // written through. Pass nullptr to detach.
+  void SetPersistentStore(std::unique_ptr<PersistentResponseStore> store);
+
+  // Record the shape of each request made through ProcessRequest(),
+  // ProcessRequestWithMetadata() and ProcessRequestWithProvider() in
+  // |recorder|, so the workload can be replayed. |recorder| is not owned
+  // and must outlive this manager; pass nullptr to stop recording.
+  void SetRequestTraceRecorder(RequestTraceRecorder* recorder);
+
+  // Configure the per-provider circuit breakers. Requests for a provider
+  // whose circuit is open go to another healthy provider that supports the
+  // task, or fail immediately if there is none.
+  void SetCircuitBreakerConfig(const CircuitBreaker::Config& config);
+
+  // Circuit state of |provider_id|
+  CircuitBreaker::State GetProviderCircuitState(
+      const std::string& provider_id) const;
+
+  // Configure the response cache. Must not race with cache lookups.
   void ConfigureCache(const CacheConfig& config);
 
-  // Clear the response cache
+  // Clear the response cache. Must not race with cache lookups.
   void ClearCache();
 
   // Get cache statistics
@@ -99,40 +207,260 @@ class MultiAdapterManager {
     size_t total_entries;
     size_t hits;
     size_t misses;
+    size_t evictions;
+    size_t expirations;
+    size_t resident_bytes;
+    size_t uncompressed_bytes;
+    size_t compressed_entries;
+    size_t admission_rejections;
+    // Uncompressed response bytes over the bytes the responses take as
+    // stored; 1.0 when nothing is compressed
+    double compression_ratio;
+    size_t coalesced_requests;
+    size_t in_flight_requests;
+    size_t semantic_entries;
+    size_t semantic_hits;
+    size_t persistent_hits;
+    size_t stale_hits;
+    size_t revalidations;
     double hit_rate;
   };
   CacheStats GetCacheStats() const;
 
+  // Look up a cached response without dispatching. Safe to call from any
+  // thread.
+  bool LookupCachedResponse(const AIRequestParams& params,
+                            std::string* response);
+
  private:
-  // Generate a cache key for a request
-  std::string GenerateCacheKey(const AIRequestParams& params) const;
+  // Adapt |callback| to the plain callback used on the dispatch path,
+  // reporting a fresh response from |provider_id|.
+  static AIResponseCallback BindMetadata(AIResponseWithMetadataCallback callback,
+                                         const std::string& provider_id);
+
+  // |callback|, ignoring where the response came from
+  static AIResponseWithMetadataCallback DropMetadata(
+      AIResponseCallback callback);
+
+  // ProcessRequestWithProvider(), reporting where the response came from
+  void ProcessRequestWithProviderAndMetadata(
+      const std::string& provider_id,
+      const AIRequestParams& params,
+      AIResponseWithMetadataCallback callback);
+
+  // |callback|, made to record the request as it completes when a
+  // recorder is set
+  AIResponseWithMetadataCallback RecordOnCompletion(
+      const AIRequestParams& params,
+      AIResponseWithMetadataCallback callback);
+  static void RecordRequest(base::WeakPtr<MultiAdapterManager> manager,
+                            RequestTraceRecorder::Event event,
+                            base::TimeTicks started,
+                            AIResponseWithMetadataCallback callback,
+                            bool success,
+                            const std::string& response,
+                            const ResponseMetadata& metadata);
+
+  // Refresh a stale entry in the background. |provider_id| may be empty to
+  // use whichever provider the request would normally route to.
+  void ScheduleRevalidation(const std::string& provider_id,
+                            const AIRequestParams& params,
+                            const RequestFingerprint& cache_key);
+  void Revalidate(const std::string& provider_id,
+                  const AIRequestParams& params,
+                  const RequestFingerprint& cache_key);
+  void OnRevalidated(const RequestFingerprint& cache_key,
+                     bool success,
+                     const std::string& response);
+
+  // Send |params| to |provider|. With a non-empty |cache_key| the response is
+  // cached and, when coalescing is enabled, shared with every caller that
+  // asked for the same key while the request was in flight.
+  void DispatchRequest(AIServiceProvider* provider,
+                       const std::string& provider_id,
+                       const AIRequestParams& params,
+                       RequestFingerprint cache_key,
+                       AIResponseCallback callback);
+
+  // Continuation of DispatchRequest() once the prompt has been embedded for
+  // the semantic tier. Serves a semantic hit or forwards to the provider.
+  void OnPromptEmbedded(const std::string& provider_id,
+                        const AIRequestParams& params,
+                        const RequestFingerprint& cache_key,
+                        AIResponseCallback callback,
+                        const std::vector<float>& embedding);
+
+  // Hand the request to the provider. |embedding| is non-empty when the
+  // response should also be stored in the semantic tier.
+  void SendToProvider(AIServiceProvider* provider,
+                      const std::string& provider_id,
+                      const AIRequestParams& params,
+                      RequestFingerprint cache_key,
+                      AIResponseCallback callback,
+                      std::vector<float> embedding);
+
+  // Record the outcome of a provider call in its circuit breaker, then run
+  // |callback|
+  void OnProviderCallCompleted(const std::string& provider_id,
+                               AIResponseCallback callback,
+                               bool success,
+                               const std::string& response);
+
+  // Forward a delta of a stream from |provider_id|, collecting its text in
+  // |text|. The final delta is recorded in the circuit breaker and, on
+  // success, caches the whole response under a non-empty |cache_key|.
+  void OnStreamDelta(const RequestFingerprint& cache_key,
+                     const RequestKey& request,
+                     const std::string& provider_id,
+                     std::string* text,
+                     const AIStreamCallback& callback,
+                     const StreamDelta& delta);
+
+  // Circuit breaker of |provider_id|, created on first use
+  CircuitBreaker& GetCircuitBreaker(const std::string& provider_id);
+
+  // A provider other than |excluded_id| that supports |task_type| and whose
+  // circuit admits a request now, or empty
+  std::string FindAvailableProvider(AIServiceProvider::TaskType task_type,
+                                    const std::string& excluded_id);
+
+  // Rebuild |provider_task_masks_| and |task_candidates_|. Called whenever
+  // the provider set, a provider's configuration or the active provider
+  // changes, so the request path never calls SupportsTaskType().
+  void RebuildCapabilityIndex();
+
+  // Whether |provider_id| supports |task_type|, from the index
+  bool ProviderSupportsTask(const std::string& provider_id,
+                            AIServiceProvider::TaskType task_type) const;
+
+  // Completion handler for SendToProvider(). |callback| is null when the
+  // waiters are tracked in |in_flight_requests_|.
+  void OnProviderResponse(const RequestFingerprint& cache_key,
+                          const std::string& provider_id,
+                          AIResponseCallback callback,
+                          const RequestKey& request,
+                          uint64_t semantic_scope,
+                          const std::vector<float>& embedding,
+                          bool success,
+                          const std::string& response);
+
+  // Fingerprint of everything except the input text that affects a
+  // response, so semantic matches never cross task types or parameters.
+  uint64_t GenerateSemanticScope(const AIRequestParams& params) const;
+
+  // Similarity threshold for |task_type|
+  float GetSemanticThreshold(AIServiceProvider::TaskType task_type) const;
+
+  // Generate a cache key for a request. Hashes the request fields in place
+  // without building an intermediate string.
+  RequestFingerprint GenerateCacheKey(const AIRequestParams& params) const;
   
-  // Check if a response is in the cache
-  bool CheckCache(const std::string& cache_key, std::string* response) const;
+  // Check if a response to |params|, whose fingerprint is |cache_key|, is
+  // in the cache. A hit promotes the entry to the most-recently-used
+  // position; an expired entry is dropped on the spot. |metadata| reports
+  // whether the hit is stale. Thread-safe.
+  bool CheckCache(const RequestFingerprint& cache_key,
+                  const AIRequestParams& params,
+                  std::string* response,
+                  ResponseMetadata* metadata);
   
-  // Add a response to the cache
-  void AddToCache(const std::string& cache_key, 
+  // Add the response to |request| to the cache
+  void AddToCache(const RequestFingerprint& cache_key,
+                 const RequestKey& request,
                  const std::string& response,
                  const std::string& provider_id);
-  
-  // Clean expired entries from the cache
-  void CleanCache();
+
+  // Insert into the in-memory tier only, as a response received |age| ago
+  void InsertIntoMemoryCache(const RequestFingerprint& cache_key,
+                             RequestKey request,
+                             const std::string& response,
+                             const std::string& provider_id,
+                             base::TimeDelta age);
+
+  // Serve |params| from the persistent store and promote it into memory.
+  // Records are keyed by |cache_key| but only match the request they were
+  // written for. Sets |metadata|'s provider and staleness.
+  bool LoadFromPersistentStore(const RequestFingerprint& cache_key,
+                               const AIRequestParams& params,
+                               std::string* response,
+                               ResponseMetadata* metadata);
 
   // Map of provider ID to provider instance
   std::unordered_map<std::string, std::unique_ptr<AIServiceProvider>> providers_;
   
   // Currently active provider ID
   std::string active_provider_id_;
+
+  // Capability index. Each provider maps to a bitmap with one bit per task
+  // type; each task type maps to its supporting providers, ranked with the
+  // active provider first and the rest by ID.
+  static constexpr size_t kTaskTypeCount =
+      static_cast<size_t>(AIServiceProvider::TaskType::CUSTOM) + 1;
+  std::unordered_map<std::string, uint32_t> provider_task_masks_;
+  std::array<std::vector<std::string>, kTaskTypeCount> task_candidates_;
+
+  // Provider health, keyed by provider ID
+  CircuitBreaker::Config circuit_breaker_config_;
+  std::unordered_map<std::string, CircuitBreaker> circuit_breakers_;
+  
+  // In-memory response cache
+  ShardedResponseCache response_cache_{ShardedResponseCache::Limits()};
   
-  // Response cache
-  std::unordered_map<std::string, CacheEntry> response_cache_;
+  // Callers sharing one upstream request
+  struct InFlightRequest {
+    InFlightRequest();
+    InFlightRequest(InFlightRequest&&);
+    InFlightRequest& operator=(InFlightRequest&&);
+    ~InFlightRequest();
+
+    // What the upstream request asks; only identical requests attach
+    RequestKey request;
+    std::vector<AIResponseCallback> waiters;
+    // Each waiter's token, null for waiters that cannot cancel
+    std::vector<scoped_refptr<CancellationToken>> waiter_tokens;
+    std::vector<base::CallbackListSubscription> cancel_subscriptions;
+    // Carried by the upstream request, which is cancelled once every
+    // waiter has cancelled. Null if the first caller could not cancel.
+    scoped_refptr<CancellationToken> upstream_token;
+  };
+
+  // Called when a waiter of the in-flight request for |cache_key| cancels
+  void OnWaiterCancelled(const RequestFingerprint& cache_key);
+
+  // Upstream requests and their waiters, keyed by cache key
+  std::unordered_map<RequestFingerprint,
+                     InFlightRequest,
+                     RequestFingerprint::Hash>
+      in_flight_requests_;
+
+  // Keys whose stale entry is being refreshed
+  std::unordered_set<RequestFingerprint, RequestFingerprint::Hash>
+      revalidating_keys_;
   
   // Cache configuration
   CacheConfig cache_config_;
+
+  // Semantic cache tier and the processor that embeds prompts for it
+  SemanticResponseCache semantic_cache_{CacheConfig().max_semantic_entries};
+  LocalAIProcessor* embedding_processor_ = nullptr;
+
+  // Not owned; null unless requests are being recorded
+  RequestTraceRecorder* trace_recorder_ = nullptr;
+
+  // Optional on-disk tier. The store itself is single-threaded, so lookups
+  // from workers serialize on |persistent_lock_|.
+  base::Lock persistent_lock_;
+  std::unique_ptr<PersistentResponseStore> persistent_store_
+      GUARDED_BY(persistent_lock_);
   
   // Cache statistics
-  size_t cache_hits_ = 0;
-  size_t cache_misses_ = 0;
+  std::atomic<size_t> cache_hits_{0};
+  std::atomic<size_t> cache_misses_{0};
+  std::atomic<size_t> persistent_hits_{0};
+  std::atomic<size_t> stale_hits_{0};
+  size_t revalidations_ = 0;
+  size_t coalesced_requests_ = 0;
+  size_t semantic_hits_ = 0;
   
   // For weak pointers
   base::WeakPtrFactory<MultiAdapterManager> weak_ptr_factory_{this};
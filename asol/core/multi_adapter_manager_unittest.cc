@@ -0,0 +1,459 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/multi_adapter_manager.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asol/core/ai_service_provider.h"
+#include "asol/core/cancellation_token.h"
+#include "asol/core/persistent_response_store.h"
+#include "asol/core/request_trace_recorder.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/functional/bind.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/strings/strcat.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+// Provider that counts upstream calls. It answers synchronously unless
+// deferred, in which case responses are held until CompletePending().
+// Configuring "summarize" to "true" adds summarization to its tasks.
+class FakeProvider : public AIServiceProvider {
+ public:
+  explicit FakeProvider(const std::string& id,
+                        const std::string& prefix = "response")
+      : id_(id), prefix_(prefix) {}
+
+  std::string GetProviderId() const override { return id_; }
+  std::string GetProviderName() const override { return "Fake " + id_; }
+  std::string GetProviderVersion() const override { return "1.0"; }
+  Capabilities GetCapabilities() const override {
+    Capabilities capabilities;
+    capabilities.supports_text_generation = true;
+    return capabilities;
+  }
+  bool SupportsTaskType(TaskType task_type) const override {
+    support_queries_++;
+    return task_type == TaskType::TEXT_GENERATION ||
+           (summarizes_ && task_type == TaskType::TEXT_SUMMARIZATION);
+  }
+  void ProcessRequest(const AIRequestParams& params,
+                      AIResponseCallback callback) override {
+    request_count_++;
+    last_cancellation_token_ = params.cancellation_token;
+    if (fail_) {
+      std::move(callback).Run(false, "unavailable");
+      return;
+    }
+    std::string response = base::StrCat({prefix_, ":", params.input_text});
+    if (defer_) {
+      pending_.emplace_back(std::move(callback), std::move(response));
+      return;
+    }
+    std::move(callback).Run(true, response);
+  }
+  void Configure(
+      const std::unordered_map<std::string, std::string>& config) override {
+    auto it = config.find("summarize");
+    summarizes_ = it != config.end() && it->second == "true";
+  }
+  std::unordered_map<std::string, std::string> GetConfiguration()
+      const override {
+    return {};
+  }
+
+  int request_count() const { return request_count_; }
+  int support_queries() const { return support_queries_; }
+  void set_defer(bool defer) { defer_ = defer; }
+  void set_fail(bool fail) { fail_ = fail; }
+  CancellationToken* last_cancellation_token() const {
+    return last_cancellation_token_.get();
+  }
+
+  void CompletePending() {
+    auto pending = std::move(pending_);
+    for (auto& [callback, response] : pending) {
+      std::move(callback).Run(true, response);
+    }
+  }
+
+ private:
+  std::string id_;
+  std::string prefix_;
+  int request_count_ = 0;
+  bool defer_ = false;
+  bool fail_ = false;
+  bool summarizes_ = false;
+  mutable int support_queries_ = 0;
+  scoped_refptr<CancellationToken> last_cancellation_token_;
+  std::vector<std::pair<AIResponseCallback, std::string>> pending_;
+};
+
+class MultiAdapterManagerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    auto provider = std::make_unique<FakeProvider>("fake");
+    provider_ = provider.get();
+    manager_.RegisterProvider(std::move(provider));
+  }
+
+  void RequestInto(const std::string& input,
+                   std::string* result,
+                   scoped_refptr<CancellationToken> token = nullptr) {
+    AIServiceProvider::AIRequestParams params;
+    params.task_type = AIServiceProvider::TaskType::TEXT_GENERATION;
+    params.input_text = input;
+    params.cancellation_token = std::move(token);
+
+    manager_.ProcessRequest(
+        params, base::BindOnce(
+                    [](std::string* out, bool success,
+                       const std::string& response) { *out = response; },
+                    result));
+  }
+
+  std::string Request(const std::string& input) {
+    std::string result;
+    RequestInto(input, &result);
+    return result;
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  MultiAdapterManager manager_;
+  FakeProvider* provider_ = nullptr;
+};
+
+TEST_F(MultiAdapterManagerTest, RepeatedRequestIsServedFromCache) {
+  EXPECT_EQ(Request("a"), "response:a");
+  EXPECT_EQ(Request("a"), "response:a");
+
+  EXPECT_EQ(provider_->request_count(), 1);
+  MultiAdapterManager::CacheStats stats = manager_.GetCacheStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.total_entries, 1u);
+}
+
+TEST_F(MultiAdapterManagerTest, EvictsLeastRecentlyUsedEntry) {
+  MultiAdapterManager::CacheConfig config;
+  config.max_entries = 2;
+  manager_.ConfigureCache(config);
+
+  Request("a");
+  Request("b");
+  // Touch "a" so that "b" becomes the LRU victim.
+  Request("a");
+  Request("c");
+
+  MultiAdapterManager::CacheStats stats = manager_.GetCacheStats();
+  EXPECT_EQ(stats.total_entries, 2u);
+  EXPECT_EQ(stats.evictions, 1u);
+
+  int calls = provider_->request_count();
+  Request("a");
+  EXPECT_EQ(provider_->request_count(), calls);
+  Request("b");
+  EXPECT_EQ(provider_->request_count(), calls + 1);
+}
+
+TEST_F(MultiAdapterManagerTest, ClearCacheDropsAllEntries) {
+  Request("a");
+  manager_.ClearCache();
+
+  EXPECT_EQ(manager_.GetCacheStats().total_entries, 0u);
+  Request("a");
+  EXPECT_EQ(provider_->request_count(), 2);
+}
+
+TEST_F(MultiAdapterManagerTest, CoalescesIdenticalInFlightRequests) {
+  provider_->set_defer(true);
+
+  std::string first, second, other;
+  RequestInto("a", &first);
+  RequestInto("a", &second);
+  RequestInto("b", &other);
+
+  EXPECT_EQ(provider_->request_count(), 2);
+  EXPECT_EQ(manager_.GetCacheStats().in_flight_requests, 2u);
+
+  provider_->CompletePending();
+  EXPECT_EQ(first, "response:a");
+  EXPECT_EQ(second, "response:a");
+  EXPECT_EQ(other, "response:b");
+
+  MultiAdapterManager::CacheStats stats = manager_.GetCacheStats();
+  EXPECT_EQ(stats.coalesced_requests, 1u);
+  EXPECT_EQ(stats.in_flight_requests, 0u);
+}
+
+TEST_F(MultiAdapterManagerTest, CancelsCoalescedRequestOnceAllWaitersCancel) {
+  provider_->set_defer(true);
+
+  auto first_token = base::MakeRefCounted<CancellationToken>();
+  auto second_token = base::MakeRefCounted<CancellationToken>();
+  std::string first, second;
+  RequestInto("a", &first, first_token);
+  RequestInto("a", &second, second_token);
+
+  // The upstream request has a token of its own
+  CancellationToken* upstream = provider_->last_cancellation_token();
+  ASSERT_TRUE(upstream);
+  EXPECT_NE(upstream, first_token.get());
+
+  first_token->Cancel();
+  EXPECT_FALSE(upstream->IsCancelled());
+  second_token->Cancel();
+  EXPECT_TRUE(upstream->IsCancelled());
+}
+
+TEST_F(MultiAdapterManagerTest, CancelledRequestIsNotSent) {
+  auto token = base::MakeRefCounted<CancellationToken>();
+  token->Cancel();
+  std::string result;
+  RequestInto("a", &result, token);
+
+  EXPECT_EQ(result, kRequestCancelledError);
+  EXPECT_EQ(provider_->request_count(), 0);
+}
+
+TEST_F(MultiAdapterManagerTest, ServesStaleEntryAndRevalidates) {
+  MultiAdapterManager::CacheConfig config;
+  config.max_age_seconds = -1;  // Every entry is immediately past max age
+  config.stale_while_revalidate_seconds = 3600;
+  manager_.ConfigureCache(config);
+
+  Request("a");
+  EXPECT_EQ(provider_->request_count(), 1);
+
+  AIServiceProvider::AIRequestParams params;
+  params.task_type = AIServiceProvider::TaskType::TEXT_GENERATION;
+  params.input_text = "a";
+  MultiAdapterManager::ResponseMetadata metadata;
+  manager_.ProcessRequestWithMetadata(
+      params, base::BindOnce(
+                  [](MultiAdapterManager::ResponseMetadata* out, bool success,
+                     const std::string& response,
+                     const MultiAdapterManager::ResponseMetadata& metadata) {
+                    *out = metadata;
+                  },
+                  &metadata));
+
+  EXPECT_TRUE(metadata.from_cache);
+  EXPECT_TRUE(metadata.is_stale);
+  EXPECT_EQ(provider_->request_count(), 1);
+
+  // The refresh runs asynchronously
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(provider_->request_count(), 2);
+  EXPECT_EQ(manager_.GetCacheStats().revalidations, 1u);
+}
+
+TEST_F(MultiAdapterManagerTest, RevalidatesOnceWithoutCoalescing) {
+  MultiAdapterManager::CacheConfig config;
+  config.max_age_seconds = -1;
+  config.stale_while_revalidate_seconds = 3600;
+  config.coalesce_in_flight_requests = false;
+  manager_.ConfigureCache(config);
+
+  Request("a");
+  provider_->set_defer(true);
+  Request("a");
+  Request("a");
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(provider_->request_count(), 2);
+  EXPECT_EQ(manager_.GetCacheStats().revalidations, 1u);
+
+  // Once the refresh lands, the next stale hit refreshes again
+  provider_->CompletePending();
+  Request("a");
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(provider_->request_count(), 3);
+}
+
+TEST_F(MultiAdapterManagerTest, PersistedStaleEntryKeepsItsAge) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  PersistentResponseStore::Options options;
+  options.path = temp_dir.GetPath().AppendASCII("responses");
+  MultiAdapterManager::CacheConfig config;
+  config.max_age_seconds = -1;
+  config.stale_while_revalidate_seconds = 3600;
+  manager_.ConfigureCache(config);
+  manager_.SetPersistentStore(
+      std::make_unique<PersistentResponseStore>(options));
+  Request("a");
+
+  // A restarted browser finds the response on disk only
+  MultiAdapterManager restarted;
+  auto provider = std::make_unique<FakeProvider>("fake");
+  FakeProvider* restarted_provider = provider.get();
+  restarted.RegisterProvider(std::move(provider));
+  restarted.ConfigureCache(config);
+  restarted.SetPersistentStore(
+      std::make_unique<PersistentResponseStore>(options));
+
+  AIServiceProvider::AIRequestParams params;
+  params.task_type = AIServiceProvider::TaskType::TEXT_GENERATION;
+  params.input_text = "a";
+  MultiAdapterManager::ResponseMetadata metadata;
+  restarted.ProcessRequestWithMetadata(
+      params, base::BindOnce(
+                  [](MultiAdapterManager::ResponseMetadata* out, bool success,
+                     const std::string& response,
+                     const MultiAdapterManager::ResponseMetadata& metadata) {
+                    *out = metadata;
+                  },
+                  &metadata));
+  EXPECT_TRUE(metadata.from_cache);
+  EXPECT_TRUE(metadata.is_stale);
+  EXPECT_EQ(restarted.GetCacheStats().stale_hits, 1u);
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(restarted_provider->request_count(), 1);
+  EXPECT_EQ(restarted.GetCacheStats().revalidations, 1u);
+}
+
+TEST_F(MultiAdapterManagerTest, OpenCircuitSkipsFailingProvider) {
+  CircuitBreaker::Config breaker_config;
+  breaker_config.failure_threshold = 2;
+  manager_.SetCircuitBreakerConfig(breaker_config);
+  MultiAdapterManager::CacheConfig cache_config;
+  cache_config.enabled = false;
+  manager_.ConfigureCache(cache_config);
+
+  auto backup = std::make_unique<FakeProvider>("backup", "backup");
+  FakeProvider* backup_provider = backup.get();
+  manager_.RegisterProvider(std::move(backup));
+  ASSERT_TRUE(manager_.SetActiveProvider("fake"));
+
+  provider_->set_fail(true);
+  Request("a");
+  Request("b");
+  EXPECT_EQ(manager_.GetProviderCircuitState("fake"),
+            CircuitBreaker::State::OPEN);
+
+  // The open circuit routes straight to the healthy provider
+  EXPECT_EQ(Request("c"), "backup:c");
+  EXPECT_EQ(provider_->request_count(), 2);
+  EXPECT_EQ(backup_provider->request_count(), 1);
+}
+
+TEST_F(MultiAdapterManagerTest, RoutesTaskTypesFromCapabilityIndex) {
+  auto other = std::make_unique<FakeProvider>("other", "other");
+  FakeProvider* other_provider = other.get();
+  manager_.RegisterProvider(std::move(other));
+  EXPECT_TRUE(manager_.FindBestProviderForTask(
+                  AIServiceProvider::TaskType::TEXT_SUMMARIZATION)
+                  .empty());
+
+  // Configuration changes are picked up by the index
+  manager_.ConfigureProvider("other", {{"summarize", "true"}});
+  EXPECT_EQ(manager_.FindBestProviderForTask(
+                AIServiceProvider::TaskType::TEXT_SUMMARIZATION),
+            "other");
+
+  // The active provider ranks first for tasks it supports
+  EXPECT_EQ(manager_.FindBestProviderForTask(
+                AIServiceProvider::TaskType::TEXT_GENERATION),
+            "fake");
+  ASSERT_TRUE(manager_.SetActiveProvider("other"));
+  EXPECT_EQ(manager_.FindBestProviderForTask(
+                AIServiceProvider::TaskType::TEXT_GENERATION),
+            "other");
+  ASSERT_TRUE(manager_.SetActiveProvider("fake"));
+
+  // Routing a request does not query the providers again
+  int queries = provider_->support_queries() +
+                other_provider->support_queries();
+  AIServiceProvider::AIRequestParams params;
+  params.task_type = AIServiceProvider::TaskType::TEXT_SUMMARIZATION;
+  params.input_text = "a";
+  std::string result;
+  manager_.ProcessRequest(
+      params, base::BindOnce(
+                  [](std::string* out, bool success,
+                     const std::string& response) { *out = response; },
+                  &result));
+  EXPECT_EQ(result, "other:a");
+  EXPECT_EQ(provider_->support_queries() + other_provider->support_queries(),
+            queries);
+}
+
+TEST_F(MultiAdapterManagerTest, CachesCompletedStream) {
+  AIServiceProvider::AIRequestParams params;
+  params.task_type = AIServiceProvider::TaskType::TEXT_GENERATION;
+  params.input_text = "a";
+  std::vector<StreamDelta> deltas;
+  auto on_delta = base::BindRepeating(
+      [](std::vector<StreamDelta>* deltas, const StreamDelta& delta) {
+        deltas->push_back(delta);
+      },
+      &deltas);
+
+  // The fake answers whole, through the default single final delta
+  manager_.ProcessStreamingRequest(params, on_delta);
+  ASSERT_EQ(deltas.size(), 1u);
+  EXPECT_TRUE(deltas[0].is_final);
+  EXPECT_TRUE(deltas[0].success);
+  EXPECT_EQ(deltas[0].text, "response:a");
+
+  manager_.ProcessStreamingRequest(params, on_delta);
+  ASSERT_EQ(deltas.size(), 2u);
+  EXPECT_EQ(deltas[1].text, "response:a");
+  EXPECT_EQ(provider_->request_count(), 1);
+
+  // and the plain path shares the entry
+  EXPECT_EQ(Request("a"), "response:a");
+  EXPECT_EQ(provider_->request_count(), 1);
+}
+
+TEST_F(MultiAdapterManagerTest, RecordsEachRequestOnce) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().AppendASCII("requests.jsonl");
+  {
+    RequestTraceRecorder recorder(path);
+    manager_.SetRequestTraceRecorder(&recorder);
+    Request("a");
+    Request("a");
+    std::string result;
+    AIServiceProvider::AIRequestParams params;
+    params.task_type = AIServiceProvider::TaskType::TEXT_GENERATION;
+    params.input_text = "bb";
+    manager_.ProcessRequestWithProvider(
+        "fake", params,
+        base::BindOnce([](std::string* out, bool success,
+                          const std::string& response) { *out = response; },
+                       &result));
+    EXPECT_EQ(result, "response:bb");
+    manager_.SetRequestTraceRecorder(nullptr);
+    EXPECT_EQ(recorder.recorded_count(), 3u);
+  }
+  task_environment_.RunUntilIdle();
+
+  std::vector<RequestTraceRecorder::Event> events =
+      RequestTraceRecorder::ReadTrace(path);
+  ASSERT_EQ(events.size(), 3u);
+  EXPECT_EQ(events[0].cache_outcome, RequestTraceRecorder::CacheOutcome::MISS);
+  EXPECT_EQ(events[0].provider_id, "fake");
+  EXPECT_EQ(events[0].output_bytes, std::string("response:a").size());
+  EXPECT_EQ(events[1].cache_outcome, RequestTraceRecorder::CacheOutcome::HIT);
+  // Repeats of a prompt share its hash
+  EXPECT_EQ(events[1].prompt_hash, events[0].prompt_hash);
+  EXPECT_EQ(events[2].input_bytes, 2u);
+  EXPECT_NE(events[2].prompt_hash, events[0].prompt_hash);
+  EXPECT_TRUE(events[2].success);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
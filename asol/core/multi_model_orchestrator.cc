@@ -0,0 +1,1377 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/multi_model_orchestrator.h"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+#include "asol/core/cancellation_token.h"
+#include "asol/core/local_ai_processor.h"
+#include "asol/core/request_scheduler.h"
+#include "asol/core/retry_policy.h"
+#include "base/containers/contains.h"
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/task/sequenced_task_runner.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Weights for the BALANCED strategy
+constexpr float kBalancedSuccessWeight = 0.35f;
+constexpr float kBalancedQualityWeight = 0.3f;
+constexpr float kBalancedLatencyWeight = 0.25f;
+constexpr float kBalancedCostWeight = 0.1f;
+
+// Latency at which the BALANCED latency term drops to one half
+constexpr float kBalancedLatencyScaleMs = 1000.0f;
+
+// How |strategy| weighs the metrics; CUSTOM ranks its fallbacks as BALANCED
+ModelMetricsTable::ScoreWeights GetScoreWeights(
+    MultiModelOrchestrator::SelectionStrategy strategy) {
+  using SelectionStrategy = MultiModelOrchestrator::SelectionStrategy;
+  ModelMetricsTable::ScoreWeights weights;
+  switch (strategy) {
+    case SelectionStrategy::BEST_PERFORMANCE:
+      weights.success_rate = 1.0f;
+      break;
+    case SelectionStrategy::LOWEST_LATENCY:
+      weights.latency = -1.0f;
+      break;
+    case SelectionStrategy::LOWEST_COST:
+      weights.cost = -1.0f;
+      break;
+    case SelectionStrategy::HIGHEST_QUALITY:
+      weights.quality = 1.0f;
+      break;
+    case SelectionStrategy::BALANCED:
+    case SelectionStrategy::LOCAL_FIRST_SPECULATIVE:
+    case SelectionStrategy::CUSTOM:
+      weights.success_rate = kBalancedSuccessWeight;
+      weights.quality = kBalancedQualityWeight;
+      weights.latency_decay = kBalancedLatencyWeight;
+      weights.cost_decay = kBalancedCostWeight;
+      weights.latency_scale_ms = kBalancedLatencyScaleMs;
+      break;
+  }
+  return weights;
+}
+
+// Ordering tiers for candidates. Providers without samples sit between
+// those that meet the latency target and those that miss it, so they get
+// measured without displacing a known-good provider. Providers with an open
+// circuit come last.
+enum class CandidateTier {
+  kWithinTarget = 0,
+  kUnmeasured = 1,
+  kOverTarget = 2,
+  kCircuitOpen = 3,
+};
+
+struct RankedCandidate {
+  std::string provider_id;
+  CandidateTier tier;
+  float score;
+};
+
+AIServiceProvider::AIRequestParams ToProviderParams(
+    const AIServiceManager::AIRequestParams& params) {
+  AIServiceProvider::AIRequestParams provider_params;
+  provider_params.task_type =
+      static_cast<AIServiceProvider::TaskType>(params.task_type);
+  provider_params.input_text = params.input_text;
+  provider_params.context_id = params.context_id;
+  provider_params.custom_params = params.custom_params;
+  provider_params.cancellation_token = params.cancellation_token;
+  provider_params.trace = params.trace;
+  return provider_params;
+}
+
+std::string GetParam(const AIServiceManager::AIRequestParams& params,
+                     const char* name) {
+  auto it = params.custom_params.find(name);
+  return it != params.custom_params.end() ? it->second : std::string();
+}
+
+}  // namespace
+
+struct MultiModelOrchestrator::HedgedRequest
+    : public base::RefCounted<HedgedRequest> {
+  AIServiceManager::AIRequestParams params;
+  std::vector<std::string> providers;
+  AIServiceManager::AIResponseCallback callback;
+
+  // Set once |callback| has run or been handed to the sequential fallback
+  bool done = false;
+  bool hedge_sent = false;
+  int outstanding = 0;
+
+ private:
+  friend class base::RefCounted<HedgedRequest>;
+  ~HedgedRequest() = default;
+};
+
+struct MultiModelOrchestrator::EnsembleRequest
+    : public base::RefCounted<EnsembleRequest> {
+  AIServiceManager::AIRequestParams params;
+  std::vector<std::string> providers;
+  float quality_threshold = 0.0f;
+  AIServiceManager::AIResponseCallback callback;
+
+  // Best successful response so far
+  std::optional<std::string> best_response;
+  float best_score = 0.0f;
+
+  int outstanding = 0;
+  bool deadline_passed = false;
+
+  // Set once |callback| has run
+  bool done = false;
+
+ private:
+  friend class base::RefCounted<EnsembleRequest>;
+  ~EnsembleRequest() = default;
+};
+
+struct MultiModelOrchestrator::SpeculativeRequest
+    : public base::RefCounted<SpeculativeRequest> {
+  AIServiceManager::AIRequestParams params;
+  AIServiceManager::AIResponseCallback draft_callback;
+  AIServiceManager::AIResponseCallback final_callback;
+
+  // Successful local answer, once it lands
+  std::optional<std::string> draft;
+  bool local_done = false;
+  bool remote_failed = false;
+  bool timed_out = false;
+
+  // Set once |final_callback| has run
+  bool done = false;
+
+ private:
+  friend class base::RefCounted<SpeculativeRequest>;
+  ~SpeculativeRequest() = default;
+};
+
+MultiModelOrchestrator::MultiModelOrchestrator() = default;
+
+MultiModelOrchestrator::~MultiModelOrchestrator() = default;
+
+bool MultiModelOrchestrator::Initialize(AIServiceManager* ai_service_manager) {
+  if (!ai_service_manager) {
+    LOG(ERROR) << "MultiModelOrchestrator requires an AI service manager";
+    return false;
+  }
+  ai_service_manager_ = ai_service_manager;
+  return true;
+}
+
+MultiModelOrchestrator::ModelSelectionResult
+MultiModelOrchestrator::SelectModelForTask(
+    AIServiceManager::TaskType task_type) {
+  ModelSelectionResult result;
+  if (!ai_service_manager_) {
+    result.selection_reason = "Orchestrator not initialized";
+    return result;
+  }
+
+  if (!auto_selection_enabled_) {
+    AIServiceProvider* provider =
+        ai_service_manager_->GetDefaultProviderForTask(task_type);
+    if (provider) {
+      result.selected_provider_id = provider->GetProviderId();
+    }
+    result.selection_reason = "Automatic selection disabled; using default";
+    return result;
+  }
+
+  // Indices into |model_metrics_| of the providers that can do the task
+  std::vector<size_t> candidates;
+  for (AIServiceProvider* provider : ai_service_manager_->GetAllProviders()) {
+    if (provider->SupportsTaskType(
+            static_cast<AIServiceProvider::TaskType>(task_type))) {
+      candidates.push_back(
+          model_metrics_.GetOrAddProvider(provider->GetProviderId()));
+    }
+  }
+  if (candidates.empty()) {
+    result.selection_reason = "No provider supports this task";
+    return result;
+  }
+
+  if (selection_strategy_ == SelectionStrategy::CUSTOM &&
+      custom_selection_function_) {
+    std::vector<ModelMetrics> candidate_metrics;
+    for (size_t provider : candidates) {
+      candidate_metrics.push_back(
+          GetModelMetrics(model_metrics_.provider_id(provider), task_type));
+    }
+    result.selected_provider_id =
+        custom_selection_function_.Run(task_type, candidate_metrics);
+    for (const auto& metrics : candidate_metrics) {
+      if (metrics.provider_id != result.selected_provider_id) {
+        result.fallback_provider_ids.push_back(metrics.provider_id);
+      }
+    }
+    result.selection_reason = "Custom selection function";
+    return result;
+  }
+
+  // Score every provider in one pass over the metric columns, then rank the
+  // candidates by tier and score
+  static_assert(static_cast<size_t>(LatencyPercentile::P99) + 1 ==
+                ModelMetricsTable::kLatencyPercentileCount);
+  LatencyTarget target = GetLatencyTarget(task_type);
+  size_t percentile = static_cast<size_t>(target.percentile);
+  model_metrics_.Score(task_type, GetScoreWeights(selection_strategy_),
+                       percentile, &scores_);
+  const ModelMetricsTable::Columns& columns = model_metrics_.columns(task_type);
+  const std::vector<float>& latency =
+      columns.latency_percentiles_ms[percentile];
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  std::vector<RankedCandidate> ranked;
+  ranked.reserve(candidates.size());
+  for (size_t provider : candidates) {
+    const std::string& provider_id = model_metrics_.provider_id(provider);
+    CandidateTier tier = CandidateTier::kWithinTarget;
+    if (!GetCircuitBreaker(provider_id).IsAvailable(now)) {
+      tier = CandidateTier::kCircuitOpen;
+    } else if (columns.request_count[provider] == 0) {
+      tier = CandidateTier::kUnmeasured;
+    } else if (target.max_latency_ms > 0.0f &&
+               latency[provider] > target.max_latency_ms) {
+      tier = CandidateTier::kOverTarget;
+    }
+    ranked.push_back({provider_id, tier, scores_[provider]});
+  }
+  std::stable_sort(ranked.begin(), ranked.end(),
+                   [](const RankedCandidate& a, const RankedCandidate& b) {
+                     if (a.tier != b.tier) {
+                       return a.tier < b.tier;
+                     }
+                     return a.score > b.score;
+                   });
+
+  result.selected_provider_id = ranked.front().provider_id;
+  for (size_t i = 1; i < ranked.size(); ++i) {
+    result.fallback_provider_ids.push_back(ranked[i].provider_id);
+  }
+  switch (ranked.front().tier) {
+    case CandidateTier::kWithinTarget:
+      result.selection_reason = "Best score under the current strategy";
+      break;
+    case CandidateTier::kUnmeasured:
+      result.selection_reason = "No metrics yet; sampling provider";
+      break;
+    case CandidateTier::kOverTarget:
+      result.selection_reason = "All providers over latency target";
+      break;
+    case CandidateTier::kCircuitOpen:
+      result.selection_reason = "All provider circuits open";
+      break;
+  }
+  return result;
+}
+
+void MultiModelOrchestrator::ProcessRequest(
+    const AIServiceManager::AIRequestParams& params,
+    AIServiceManager::AIResponseCallback callback) {
+  if (!ai_service_manager_) {
+    std::move(callback).Run(false, "Orchestrator not initialized");
+    return;
+  }
+
+  if (CanSpeculate(params)) {
+    ProcessRequestSpeculatively(params, AIServiceManager::AIResponseCallback(),
+                                std::move(callback));
+    return;
+  }
+
+  if (!ApplyNetworkQuality(params, &callback)) {
+    return;
+  }
+
+  std::vector<std::string> providers;
+  if (params.provider_id.empty()) {
+    providers = GetRankedProviders(params.task_type);
+  } else {
+    providers.push_back(params.provider_id);
+  }
+  AIServiceManager::AIRequestParams routed_params = params;
+  if (!FitInputToProviders(&routed_params, &providers, &callback) ||
+      !ApplyBudget(routed_params, 1, &providers, &callback)) {
+    return;
+  }
+
+  if (!providers.empty()) {
+    routed_params.provider_id = providers.front();
+  }
+  if (routed_params.provider_id.empty()) {
+    std::move(callback).Run(false, "No provider available for task");
+    return;
+  }
+  if (!GetCircuitBreaker(routed_params.provider_id)
+           .AllowRequest(base::TimeTicks::Now())) {
+    std::move(callback).Run(
+        false, "Provider " + routed_params.provider_id + " is unavailable");
+    return;
+  }
+
+  std::string provider_id = routed_params.provider_id;
+  ai_service_manager_->ProcessRequest(
+      routed_params,
+      base::BindOnce(&MultiModelOrchestrator::OnRequestProcessed,
+                     weak_ptr_factory_.GetWeakPtr(), std::move(callback),
+                     provider_id, params.task_type, base::TimeTicks::Now()));
+}
+
+void MultiModelOrchestrator::ProcessRequestWithFallback(
+    const AIServiceManager::AIRequestParams& params,
+    AIServiceManager::AIResponseCallback callback) {
+  if (!ai_service_manager_) {
+    std::move(callback).Run(false, "Orchestrator not initialized");
+    return;
+  }
+
+  if (CanSpeculate(params)) {
+    ProcessRequestSpeculatively(params, AIServiceManager::AIResponseCallback(),
+                                std::move(callback));
+    return;
+  }
+
+  if (!ApplyNetworkQuality(params, &callback)) {
+    return;
+  }
+
+  std::vector<std::string> providers = GetRankedProviders(params.task_type);
+  AIServiceManager::AIRequestParams fitted_params = params;
+  if (!FitInputToProviders(&fitted_params, &providers, &callback) ||
+      !ApplyBudget(fitted_params, 1, &providers, &callback)) {
+    return;
+  }
+
+  // Hedge only between two healthy providers; otherwise the sequential path
+  // below skips the open circuits
+  base::TimeTicks now = base::TimeTicks::Now();
+  auto policy_it = hedging_policies_.find(params.task_type);
+  if (policy_it != hedging_policies_.end() && policy_it->second.enabled &&
+      providers.size() >= 2 &&
+      GetCircuitBreaker(providers[1]).IsAvailable(now) &&
+      GetCircuitBreaker(providers[0]).AllowRequest(now)) {
+    StartHedgedRequest(fitted_params, std::move(providers), policy_it->second,
+                       std::move(callback));
+    return;
+  }
+
+  TryFallbackProvider(fitted_params, providers, 0, std::move(callback));
+}
+
+void MultiModelOrchestrator::ProcessRequestWithEnsemble(
+    const AIServiceManager::AIRequestParams& params,
+    const EnsemblePolicy& policy,
+    AIServiceManager::AIResponseCallback callback) {
+  if (!ai_service_manager_) {
+    std::move(callback).Run(false, "Orchestrator not initialized");
+    return;
+  }
+
+  // Each provider asked is paid for, so the whole fan-out is weighed
+  // against the budget
+  std::vector<std::string> providers = GetRankedProviders(params.task_type);
+  if (!ApplyBudget(params, std::min(policy.max_providers, providers.size()),
+                   &providers, &callback)) {
+    return;
+  }
+
+  auto request = base::MakeRefCounted<EnsembleRequest>();
+  request->params = params;
+  request->quality_threshold = policy.quality_threshold;
+  request->callback = std::move(callback);
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (const std::string& provider_id : providers) {
+    if (request->providers.size() >= policy.max_providers) {
+      break;
+    }
+    if (GetCircuitBreaker(provider_id).IsAvailable(now)) {
+      request->providers.push_back(provider_id);
+    }
+  }
+  if (request->providers.empty()) {
+    std::move(request->callback).Run(false, "No provider available for task");
+    return;
+  }
+  ensemble_stats_.ensembles++;
+
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&MultiModelOrchestrator::OnEnsembleDeadline,
+                     weak_ptr_factory_.GetWeakPtr(), request),
+      policy.deadline);
+
+  // Count every attempt up front so a synchronous answer cannot look like
+  // the last one out
+  request->outstanding = static_cast<int>(request->providers.size());
+  for (size_t i = 0; i < request->providers.size(); ++i) {
+    if (request->done) {
+      // Never sent, so never answered
+      request->outstanding -= static_cast<int>(request->providers.size() - i);
+      break;
+    }
+    // A half-open circuit's probe slot is claimed only by a request that
+    // is sent; another caller may have taken the last one meanwhile
+    if (!GetCircuitBreaker(request->providers[i])
+             .AllowRequest(base::TimeTicks::Now())) {
+      request->outstanding--;
+      continue;
+    }
+    AIServiceManager::AIRequestParams routed_params = params;
+    routed_params.provider_id = request->providers[i];
+    ai_service_manager_->ProcessRequest(
+        routed_params,
+        base::BindOnce(&MultiModelOrchestrator::OnEnsembleResponse,
+                       weak_ptr_factory_.GetWeakPtr(), request, i,
+                       base::TimeTicks::Now()));
+  }
+
+  // Every attempt sent has answered, or none could be sent
+  if (!request->done && request->outstanding == 0) {
+    SettleEnsembleRequest(std::move(request));
+  }
+}
+
+MultiModelOrchestrator::EnsembleStats
+MultiModelOrchestrator::GetEnsembleStats() const {
+  return ensemble_stats_;
+}
+
+void MultiModelOrchestrator::ProcessRequestSpeculatively(
+    const AIServiceManager::AIRequestParams& params,
+    AIServiceManager::AIResponseCallback draft_callback,
+    AIServiceManager::AIResponseCallback final_callback) {
+  if (!ai_service_manager_) {
+    std::move(final_callback).Run(false, "Orchestrator not initialized");
+    return;
+  }
+
+  if (!CanSpeculate(params)) {
+    ProcessRequestWithFallback(params, std::move(final_callback));
+    return;
+  }
+
+  if (!ApplyNetworkQuality(params, &final_callback)) {
+    return;
+  }
+
+  // The remote side is budgeted like any other request. The final answer is
+  // charged at the remote price even when the draft is kept, since the
+  // remote call was paid for all the same; a spent budget leaves only the
+  // local model, with nothing to speculate against.
+  std::vector<std::string> providers = GetRankedProviders(params.task_type);
+  AIServiceManager::AIRequestParams fitted_params = params;
+  if (!FitInputToProviders(&fitted_params, &providers, &final_callback) ||
+      !ApplyBudget(fitted_params, 1, &providers, &final_callback)) {
+    return;
+  }
+  StartSpeculativeRequest(fitted_params, std::move(providers),
+                          std::move(draft_callback),
+                          std::move(final_callback));
+}
+
+void MultiModelOrchestrator::UpdateModelMetrics(
+    const std::string& provider_id,
+    AIServiceManager::TaskType task_type,
+    bool success,
+    float latency_ms,
+    float quality_score) {
+  size_t provider = model_metrics_.GetOrAddProvider(provider_id);
+  model_metrics_.RecordRequest(provider, task_type, success, latency_ms,
+                               quality_score, base::Time::Now());
+
+  CircuitBreaker& breaker = GetCircuitBreaker(provider_id);
+  if (success) {
+    breaker.RecordSuccess();
+  } else {
+    breaker.RecordFailure(base::TimeTicks::Now());
+  }
+
+  // Tail latency from the decaying histogram
+  LatencyHistogram& histogram = latency_histograms_[task_type][provider_id];
+  histogram.Record(latency_ms, base::TimeTicks::Now());
+  model_metrics_.SetLatencyPercentiles(
+      provider, task_type,
+      {static_cast<float>(histogram.Percentile(0.50)),
+       static_cast<float>(histogram.Percentile(0.95)),
+       static_cast<float>(histogram.Percentile(0.99))});
+}
+
+MultiModelOrchestrator::ModelMetrics MultiModelOrchestrator::GetModelMetrics(
+    const std::string& provider_id,
+    AIServiceManager::TaskType task_type) const {
+  ModelMetrics metrics;
+  metrics.provider_id = provider_id;
+  metrics.task_type = task_type;
+  metrics.success_rate = 0.0f;
+  metrics.average_latency_ms = 0.0f;
+  metrics.cost_per_request = 0.0f;
+  metrics.quality_score = 0.0f;
+  metrics.request_count = 0;
+
+  size_t provider = model_metrics_.FindProvider(provider_id);
+  if (provider == ModelMetricsTable::kNotFound) {
+    return metrics;
+  }
+  const ModelMetricsTable::Columns& columns = model_metrics_.columns(task_type);
+  metrics.success_rate = columns.success_rate[provider];
+  metrics.average_latency_ms = columns.average_latency_ms[provider];
+  metrics.p50_latency_ms = columns.latency_percentiles_ms[0][provider];
+  metrics.p95_latency_ms = columns.latency_percentiles_ms[1][provider];
+  metrics.p99_latency_ms = columns.latency_percentiles_ms[2][provider];
+  metrics.cost_per_request = model_metrics_.cost_per_request(provider);
+  metrics.quality_score = columns.quality_score[provider];
+  metrics.request_count = columns.request_count[provider];
+  metrics.last_updated = columns.last_updated[provider];
+  return metrics;
+}
+
+std::vector<MultiModelOrchestrator::ModelMetrics>
+MultiModelOrchestrator::GetAllModelMetrics() const {
+  std::vector<ModelMetrics> all_metrics;
+  for (size_t provider = 0; provider < model_metrics_.provider_count();
+       ++provider) {
+    for (size_t task = 0; task < ModelMetricsTable::kTaskTypeCount; ++task) {
+      auto task_type = static_cast<AIServiceManager::TaskType>(task);
+      if (model_metrics_.columns(task_type).request_count[provider] > 0) {
+        all_metrics.push_back(
+            GetModelMetrics(model_metrics_.provider_id(provider), task_type));
+      }
+    }
+  }
+  return all_metrics;
+}
+
+void MultiModelOrchestrator::SetSelectionStrategy(SelectionStrategy strategy) {
+  selection_strategy_ = strategy;
+}
+
+MultiModelOrchestrator::SelectionStrategy
+MultiModelOrchestrator::GetSelectionStrategy() const {
+  return selection_strategy_;
+}
+
+void MultiModelOrchestrator::SetLatencyTarget(
+    AIServiceManager::TaskType task_type,
+    const LatencyTarget& target) {
+  latency_targets_[task_type] = target;
+}
+
+MultiModelOrchestrator::LatencyTarget MultiModelOrchestrator::GetLatencyTarget(
+    AIServiceManager::TaskType task_type) const {
+  auto it = latency_targets_.find(task_type);
+  if (it != latency_targets_.end()) {
+    return it->second;
+  }
+  return LatencyTarget();
+}
+
+void MultiModelOrchestrator::SetHedgingPolicy(
+    AIServiceManager::TaskType task_type,
+    const HedgingPolicy& policy) {
+  hedging_policies_[task_type] = policy;
+}
+
+MultiModelOrchestrator::HedgeStats MultiModelOrchestrator::GetHedgeStats()
+    const {
+  return hedge_stats_;
+}
+
+void MultiModelOrchestrator::SetLocalProcessor(LocalAIProcessor* processor) {
+  local_processor_ = processor;
+}
+
+void MultiModelOrchestrator::SetSpeculationPolicy(
+    const SpeculationPolicy& policy) {
+  speculation_policy_ = policy;
+}
+
+MultiModelOrchestrator::SpeculationStats
+MultiModelOrchestrator::GetSpeculationStats() const {
+  return speculation_stats_;
+}
+
+void MultiModelOrchestrator::SetInputOverflowPolicy(
+    AIServiceManager::TaskType task_type,
+    InputOverflow overflow) {
+  overflow_policies_[task_type] = overflow;
+}
+
+void MultiModelOrchestrator::SetBudgetManager(BudgetManager* budget_manager) {
+  budget_manager_ = budget_manager;
+}
+
+void MultiModelOrchestrator::SetNetworkQualityEstimator(
+    NetworkQualityEstimator* estimator) {
+  network_quality_estimator_ = estimator;
+}
+
+void MultiModelOrchestrator::SetDegradedModePolicy(
+    const DegradedModePolicy& policy) {
+  degraded_mode_policy_ = policy;
+}
+
+MultiModelOrchestrator::DegradedModeStats
+MultiModelOrchestrator::GetDegradedModeStats() const {
+  return degraded_mode_stats_;
+}
+
+void MultiModelOrchestrator::SetProviderCost(const std::string& provider_id,
+                                             double cost_per_1k_tokens) {
+  provider_costs_[provider_id] = cost_per_1k_tokens;
+  model_metrics_.SetCostPerRequest(model_metrics_.GetOrAddProvider(provider_id),
+                                   static_cast<float>(cost_per_1k_tokens));
+}
+
+void MultiModelOrchestrator::SetCircuitBreakerConfig(
+    const CircuitBreaker::Config& config) {
+  circuit_breaker_config_ = config;
+  circuit_breakers_.clear();
+}
+
+void MultiModelOrchestrator::SetCustomSelectionFunction(
+    CustomModelSelectionFunction function) {
+  custom_selection_function_ = std::move(function);
+}
+
+void MultiModelOrchestrator::EnableAutoSelection(bool enable) {
+  auto_selection_enabled_ = enable;
+}
+
+bool MultiModelOrchestrator::IsAutoSelectionEnabled() const {
+  return auto_selection_enabled_;
+}
+
+base::WeakPtr<MultiModelOrchestrator> MultiModelOrchestrator::GetWeakPtr() {
+  return weak_ptr_factory_.GetWeakPtr();
+}
+
+void MultiModelOrchestrator::OnRequestProcessed(
+    AIServiceManager::AIResponseCallback callback,
+    const std::string& provider_id,
+    AIServiceManager::TaskType task_type,
+    base::TimeTicks start_time,
+    bool success,
+    const std::string& response) {
+  // A cancelled request says nothing about the provider
+  if (success || !IsCancellationError(response)) {
+    float latency_ms = (base::TimeTicks::Now() - start_time).InMillisecondsF();
+    UpdateModelMetrics(provider_id, task_type, success, latency_ms,
+                       success ? CalculateQualityScore(response) : 0.0f);
+    RecordNetworkSample(success, response);
+  }
+  std::move(callback).Run(success, response);
+}
+
+void MultiModelOrchestrator::TryFallbackProvider(
+    const AIServiceManager::AIRequestParams& params,
+    const std::vector<std::string>& fallback_providers,
+    size_t current_index,
+    AIServiceManager::AIResponseCallback callback) {
+  // Nobody is waiting for the answer any more
+  if (params.cancellation_token && params.cancellation_token->IsCancelled()) {
+    std::move(callback).Run(false, kRequestCancelledError);
+    return;
+  }
+
+  // Skip providers whose circuit is open without sending them anything
+  base::TimeTicks now = base::TimeTicks::Now();
+  while (current_index < fallback_providers.size() &&
+         !GetCircuitBreaker(fallback_providers[current_index])
+              .AllowRequest(now)) {
+    current_index++;
+  }
+  if (current_index >= fallback_providers.size()) {
+    std::move(callback).Run(false, "All providers failed");
+    return;
+  }
+
+  AIServiceManager::AIRequestParams routed_params = params;
+  routed_params.provider_id = fallback_providers[current_index];
+  ai_service_manager_->ProcessRequest(
+      routed_params,
+      base::BindOnce(&MultiModelOrchestrator::OnFallbackResponse,
+                     weak_ptr_factory_.GetWeakPtr(), params,
+                     fallback_providers, current_index, std::move(callback),
+                     base::TimeTicks::Now()));
+}
+
+void MultiModelOrchestrator::StartHedgedRequest(
+    const AIServiceManager::AIRequestParams& params,
+    std::vector<std::string> providers,
+    const HedgingPolicy& policy,
+    AIServiceManager::AIResponseCallback callback) {
+  hedge_credits_ =
+      std::min(policy.max_burst, hedge_credits_ + policy.max_hedge_ratio);
+
+  auto request = base::MakeRefCounted<HedgedRequest>();
+  request->params = params;
+  request->providers = std::move(providers);
+  request->callback = std::move(callback);
+
+  base::TimeDelta delay =
+      GetHedgeDelay(request->providers[0], params.task_type, policy);
+  SendHedgedAttempt(request, 0);
+  if (request->done) {
+    return;
+  }
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&MultiModelOrchestrator::OnHedgeDelayElapsed,
+                     weak_ptr_factory_.GetWeakPtr(), request),
+      delay);
+}
+
+void MultiModelOrchestrator::SendHedgedAttempt(
+    scoped_refptr<HedgedRequest> request,
+    size_t provider_index) {
+  request->outstanding++;
+  AIServiceManager::AIRequestParams routed_params = request->params;
+  routed_params.provider_id = request->providers[provider_index];
+  ai_service_manager_->ProcessRequest(
+      routed_params,
+      base::BindOnce(&MultiModelOrchestrator::OnHedgedResponse,
+                     weak_ptr_factory_.GetWeakPtr(), request, provider_index,
+                     base::TimeTicks::Now()));
+}
+
+void MultiModelOrchestrator::OnHedgeDelayElapsed(
+    scoped_refptr<HedgedRequest> request) {
+  if (request->done || request->hedge_sent) {
+    return;
+  }
+  if (hedge_credits_ < 1.0) {
+    hedge_stats_.budget_denied++;
+    return;
+  }
+
+  if (!GetCircuitBreaker(request->providers[1])
+           .AllowRequest(base::TimeTicks::Now())) {
+    return;
+  }
+
+  hedge_credits_ -= 1.0;
+  request->hedge_sent = true;
+  hedge_stats_.hedges_sent++;
+  LOG(INFO) << "Hedging request to " << request->providers[1]
+            << " while waiting on " << request->providers[0];
+  SendHedgedAttempt(std::move(request), 1);
+}
+
+void MultiModelOrchestrator::OnHedgedResponse(
+    scoped_refptr<HedgedRequest> request,
+    size_t provider_index,
+    base::TimeTicks start_time,
+    bool success,
+    const std::string& response) {
+  request->outstanding--;
+  if (success || !IsCancellationError(response)) {
+    float latency_ms = (base::TimeTicks::Now() - start_time).InMillisecondsF();
+    UpdateModelMetrics(request->providers[provider_index],
+                       request->params.task_type, success, latency_ms,
+                       success ? CalculateQualityScore(response) : 0.0f);
+    RecordNetworkSample(success, response);
+  }
+
+  // The other attempt already answered. AIServiceManager has no way to
+  // abort a request, so the loser is dropped here once it lands.
+  if (request->done) {
+    return;
+  }
+
+  if (success) {
+    request->done = true;
+    if (provider_index == 1) {
+      hedge_stats_.hedge_wins++;
+    }
+    std::move(request->callback).Run(true, response);
+    return;
+  }
+
+  // Keep waiting while the other attempt is still out
+  if (request->outstanding > 0) {
+    return;
+  }
+
+  request->done = true;
+  size_t next_index = request->hedge_sent ? 2 : 1;
+  TryFallbackProvider(request->params, request->providers, next_index,
+                      std::move(request->callback));
+}
+
+void MultiModelOrchestrator::OnEnsembleResponse(
+    scoped_refptr<EnsembleRequest> request,
+    size_t provider_index,
+    base::TimeTicks start_time,
+    bool success,
+    const std::string& response) {
+  request->outstanding--;
+  float quality_score = success ? CalculateQualityScore(response) : 0.0f;
+  float latency_ms = (base::TimeTicks::Now() - start_time).InMillisecondsF();
+  UpdateModelMetrics(request->providers[provider_index],
+                     request->params.task_type, success, latency_ms,
+                     quality_score);
+  if (success || !IsCancellationError(response)) {
+    RecordNetworkSample(success, response);
+  }
+
+  // AIServiceManager has no way to abort a request, so attempts that lose
+  // are dropped here once they land
+  if (request->done) {
+    ensemble_stats_.responses_dropped++;
+    return;
+  }
+
+  if (success &&
+      (!request->best_response || quality_score > request->best_score)) {
+    request->best_response = response;
+    request->best_score = quality_score;
+  }
+
+  if (success && (quality_score >= request->quality_threshold ||
+                  request->deadline_passed)) {
+    if (request->outstanding > 0) {
+      ensemble_stats_.early_terminations++;
+    }
+    FinishEnsembleRequest(std::move(request), true, response);
+    return;
+  }
+
+  if (request->outstanding > 0) {
+    return;
+  }
+  SettleEnsembleRequest(std::move(request));
+}
+
+void MultiModelOrchestrator::OnEnsembleDeadline(
+    scoped_refptr<EnsembleRequest> request) {
+  if (request->done) {
+    return;
+  }
+
+  request->deadline_passed = true;
+  if (request->best_response) {
+    ensemble_stats_.deadline_expirations++;
+    std::string best = *request->best_response;
+    FinishEnsembleRequest(std::move(request), true, best);
+  }
+}
+
+void MultiModelOrchestrator::SettleEnsembleRequest(
+    scoped_refptr<EnsembleRequest> request) {
+  if (request->best_response) {
+    std::string best = *request->best_response;
+    FinishEnsembleRequest(std::move(request), true, best);
+  } else {
+    FinishEnsembleRequest(std::move(request), false, "All providers failed");
+  }
+}
+
+void MultiModelOrchestrator::FinishEnsembleRequest(
+    scoped_refptr<EnsembleRequest> request,
+    bool success,
+    const std::string& response) {
+  request->done = true;
+  std::move(request->callback).Run(success, response);
+}
+
+bool MultiModelOrchestrator::FitInputToProviders(
+    AIServiceManager::AIRequestParams* params,
+    std::vector<std::string>* providers,
+    AIServiceManager::AIResponseCallback* callback) {
+  std::vector<std::string> fitting;
+  std::string widest_provider_id;
+  size_t widest_limit = 0;
+  for (const std::string& provider_id : *providers) {
+    AIServiceProvider* provider =
+        ai_service_manager_->GetProviderById(provider_id);
+    size_t limit = provider ? provider->GetCapabilities().max_input_tokens : 0;
+    if (limit == 0 ||
+        provider->GetTokenCounter().CountTokens(params->input_text) <=
+            limit) {
+      fitting.push_back(provider_id);
+    } else if (limit > widest_limit) {
+      widest_provider_id = provider_id;
+      widest_limit = limit;
+    }
+  }
+  if (!fitting.empty() || providers->empty()) {
+    if (fitting.size() < providers->size()) {
+      DVLOG(1) << "Skipping " << providers->size() - fitting.size()
+               << " provider(s) too small for the input";
+    }
+    *providers = std::move(fitting);
+    return true;
+  }
+
+  auto it = overflow_policies_.find(params->task_type);
+  if (it == overflow_policies_.end() ||
+      it->second != InputOverflow::kTruncate) {
+    std::move(*callback).Run(
+        false, "Input exceeds the context window of every provider");
+    return false;
+  }
+
+  PreflightResult result =
+      PreflightInput(GetTokenCounter(widest_provider_id), params->input_text,
+                     widest_limit, InputOverflow::kTruncate);
+  DVLOG(1) << "Truncating input from " << result.input_tokens << " to "
+           << widest_limit << " tokens for " << widest_provider_id;
+  params->input_text =
+      params->input_text.Substr(0, result.inputs.front().size());
+  *providers = {widest_provider_id};
+  return true;
+}
+
+const TokenCounter& MultiModelOrchestrator::GetTokenCounter(
+    const std::string& provider_id) {
+  AIServiceProvider* provider =
+      ai_service_manager_->GetProviderById(provider_id);
+  return provider ? provider->GetTokenCounter() : GetApproximateTokenCounter();
+}
+
+bool MultiModelOrchestrator::ApplyBudget(
+    const AIServiceManager::AIRequestParams& params,
+    size_t fan_out,
+    std::vector<std::string>* providers,
+    AIServiceManager::AIResponseCallback* callback) {
+  if (!budget_manager_ || providers->empty()) {
+    return true;
+  }
+
+  BudgetScope scope{GetParam(params, kBudgetUserParam),
+                    GetParam(params, kBudgetFeatureParam)};
+  RequestPriority priority = RequestPriority::INTERACTIVE;
+  StringToRequestPriority(GetParam(params, kRequestPriorityParam), &priority);
+  size_t tokens =
+      GetTokenCounter(providers->front()).CountTokens(params.input_text) *
+      fan_out;
+
+  switch (budget_manager_->Evaluate(
+      scope,
+      BudgetManager::EstimateCost(tokens, GetProviderCost(providers->front())),
+      priority)) {
+    case BudgetManager::Decision::ALLOW:
+      break;
+    case BudgetManager::Decision::DOWNGRADE:
+      std::stable_sort(providers->begin(), providers->end(),
+                       [this](const std::string& a, const std::string& b) {
+                         return GetProviderCost(a) < GetProviderCost(b);
+                       });
+      DVLOG(1) << "Budget running low; routing to " << providers->front();
+      break;
+    case BudgetManager::Decision::LOCAL_ONLY:
+      if (local_processor_ && local_processor_->IsEnabled() &&
+          local_processor_->SupportsTaskType(
+              static_cast<AIServiceProvider::TaskType>(params.task_type))) {
+        ProcessLocally(params, std::move(*callback));
+      } else {
+        std::move(*callback).Run(false, "AI budget exhausted for today");
+      }
+      return false;
+    case BudgetManager::Decision::REJECT:
+      std::move(*callback).Run(false,
+                               "AI budget reserved for interactive requests");
+      return false;
+  }
+
+  double cost_per_1k_tokens = GetProviderCost(providers->front());
+  budget_manager_->RecordSpend(
+      scope, BudgetManager::EstimateCost(tokens, cost_per_1k_tokens));
+  *callback = base::BindOnce(&MultiModelOrchestrator::OnBudgetedResponse,
+                             weak_ptr_factory_.GetWeakPtr(), scope,
+                             providers->front(), cost_per_1k_tokens, fan_out,
+                             std::move(*callback));
+  return true;
+}
+
+void MultiModelOrchestrator::OnBudgetedResponse(
+    const BudgetScope& scope,
+    const std::string& provider_id,
+    double cost_per_1k_tokens,
+    size_t fan_out,
+    AIServiceManager::AIResponseCallback callback,
+    bool success,
+    const std::string& response) {
+  // Only the kept response is seen; the others are taken to be as long
+  if (success && budget_manager_) {
+    budget_manager_->RecordSpend(
+        scope, BudgetManager::EstimateCost(
+                   GetTokenCounter(provider_id).CountTokens(response) *
+                       fan_out,
+                   cost_per_1k_tokens));
+  }
+  std::move(callback).Run(success, response);
+}
+
+double MultiModelOrchestrator::GetProviderCost(
+    const std::string& provider_id) const {
+  auto it = provider_costs_.find(provider_id);
+  if (it != provider_costs_.end()) {
+    return it->second;
+  }
+  return budget_manager_ ? budget_manager_->default_cost_per_1k_tokens()
+                         : 0.0;
+}
+
+void MultiModelOrchestrator::ProcessLocally(
+    const AIServiceManager::AIRequestParams& params,
+    AIServiceManager::AIResponseCallback callback) {
+  DVLOG(1) << "Budget exhausted; serving request locally";
+  local_processor_->ProcessRequest(ToProviderParams(params),
+                                   std::move(callback));
+}
+
+bool MultiModelOrchestrator::ApplyNetworkQuality(
+    const AIServiceManager::AIRequestParams& params,
+    AIServiceManager::AIResponseCallback* callback) {
+  if (!network_quality_estimator_ || !params.provider_id.empty()) {
+    return true;
+  }
+  NetworkQualityEstimator::Quality quality =
+      network_quality_estimator_->GetQuality();
+  if (quality == NetworkQualityEstimator::Quality::GOOD) {
+    return true;
+  }
+
+  bool local = CanServeLocallyWhenDegraded(params);
+  RequestPriority priority = RequestPriority::INTERACTIVE;
+  StringToRequestPriority(GetParam(params, kRequestPriorityParam), &priority);
+  // Probing costs a full timeout when the network is really down, so only
+  // requests that would not go remote anyway are worth probing with
+  if ((local || priority != RequestPriority::INTERACTIVE ||
+       quality == NetworkQualityEstimator::Quality::OFFLINE) &&
+      network_quality_estimator_->AllowProbe(base::TimeTicks::Now())) {
+    degraded_mode_stats_.probes++;
+    if (local) {
+      *callback = base::BindOnce(&MultiModelOrchestrator::OnProbeResponse,
+                                 weak_ptr_factory_.GetWeakPtr(), params,
+                                 std::move(*callback));
+    }
+    return true;
+  }
+
+  if (local) {
+    DVLOG(1) << "Network "
+             << NetworkQualityEstimator::QualityToString(quality)
+             << "; serving request locally";
+    degraded_mode_stats_.served_locally++;
+    local_processor_->ProcessRequest(ToProviderParams(params),
+                                     std::move(*callback));
+    return false;
+  }
+
+  if (priority != RequestPriority::INTERACTIVE) {
+    if (deferred_requests_.size() >=
+        degraded_mode_policy_.max_deferred_requests) {
+      degraded_mode_stats_.rejected++;
+      std::move(*callback).Run(false, "Network unavailable");
+      return false;
+    }
+    degraded_mode_stats_.deferred++;
+    deferred_requests_.emplace_back(params, std::move(*callback));
+    return false;
+  }
+
+  if (quality == NetworkQualityEstimator::Quality::OFFLINE) {
+    degraded_mode_stats_.rejected++;
+    std::move(*callback).Run(false, "Network unavailable");
+    return false;
+  }
+  return true;
+}
+
+bool MultiModelOrchestrator::CanServeLocallyWhenDegraded(
+    const AIServiceManager::AIRequestParams& params) const {
+  if (!local_processor_ || !local_processor_->IsEnabled() ||
+      !base::Contains(degraded_mode_policy_.local_task_types,
+                      params.task_type)) {
+    return false;
+  }
+  return local_processor_->SupportsTaskType(
+      static_cast<AIServiceProvider::TaskType>(params.task_type));
+}
+
+void MultiModelOrchestrator::OnProbeResponse(
+    const AIServiceManager::AIRequestParams& params,
+    AIServiceManager::AIResponseCallback callback,
+    bool success,
+    const std::string& response) {
+  if (success || IsCancellationError(response) || !local_processor_ ||
+      !local_processor_->IsEnabled()) {
+    std::move(callback).Run(success, response);
+    return;
+  }
+  degraded_mode_stats_.served_locally++;
+  local_processor_->ProcessRequest(ToProviderParams(params),
+                                   std::move(callback));
+}
+
+void MultiModelOrchestrator::RecordNetworkSample(bool success,
+                                                 const std::string& response) {
+  if (!network_quality_estimator_) {
+    return;
+  }
+  NetworkQualityEstimator::Quality previous =
+      network_quality_estimator_->GetQuality();
+  // The call's latency includes generation, so it is no RTT sample; the
+  // transport reports those. An HTTP error still means the provider was
+  // reached, and errors of our own making say nothing about the network.
+  if (IsTransportFailure(response)) {
+    network_quality_estimator_->RecordFailure();
+  } else if (success || IsHttpError(response)) {
+    network_quality_estimator_->RecordSuccess();
+  } else {
+    return;
+  }
+
+  NetworkQualityEstimator::Quality quality =
+      network_quality_estimator_->GetQuality();
+  if (quality == previous) {
+    return;
+  }
+  LOG(INFO) << "Network quality "
+            << NetworkQualityEstimator::QualityToString(previous) << " -> "
+            << NetworkQualityEstimator::QualityToString(quality);
+  if (quality == NetworkQualityEstimator::Quality::GOOD &&
+      !deferred_requests_.empty()) {
+    // Not from inside the callback of the call that showed the recovery
+    base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&MultiModelOrchestrator::SendDeferredRequests,
+                       weak_ptr_factory_.GetWeakPtr()));
+  }
+}
+
+void MultiModelOrchestrator::SendDeferredRequests() {
+  auto deferred = std::move(deferred_requests_);
+  deferred_requests_.clear();
+  for (auto& [params, callback] : deferred) {
+    degraded_mode_stats_.deferred_sent++;
+    // Requests that find the network bad again are deferred again
+    ProcessRequestWithFallback(params, std::move(callback));
+  }
+}
+
+bool MultiModelOrchestrator::CanSpeculate(
+    const AIServiceManager::AIRequestParams& params) const {
+  if (selection_strategy_ != SelectionStrategy::LOCAL_FIRST_SPECULATIVE ||
+      !local_processor_ || !local_processor_->IsEnabled() ||
+      !params.provider_id.empty()) {
+    return false;
+  }
+
+  // Drafts are only good enough where the UI can show a rough answer first
+  if (params.task_type != AIServiceManager::TaskType::TEXT_SUMMARIZATION &&
+      params.task_type != AIServiceManager::TaskType::CONTENT_ANALYSIS) {
+    return false;
+  }
+  return local_processor_->SupportsTaskType(
+      static_cast<AIServiceProvider::TaskType>(params.task_type));
+}
+
+std::vector<std::string> MultiModelOrchestrator::GetRankedProviders(
+    AIServiceManager::TaskType task_type) {
+  ModelSelectionResult selection = SelectModelForTask(task_type);
+  std::vector<std::string> providers;
+  if (!selection.selected_provider_id.empty()) {
+    providers.push_back(selection.selected_provider_id);
+  }
+  providers.insert(providers.end(), selection.fallback_provider_ids.begin(),
+                   selection.fallback_provider_ids.end());
+  return providers;
+}
+
+void MultiModelOrchestrator::StartSpeculativeRequest(
+    const AIServiceManager::AIRequestParams& params,
+    std::vector<std::string> providers,
+    AIServiceManager::AIResponseCallback draft_callback,
+    AIServiceManager::AIResponseCallback final_callback) {
+  auto request = base::MakeRefCounted<SpeculativeRequest>();
+  request->params = params;
+  request->draft_callback = std::move(draft_callback);
+  request->final_callback = std::move(final_callback);
+
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&MultiModelOrchestrator::OnSpeculationTimeout,
+                     weak_ptr_factory_.GetWeakPtr(), request),
+      speculation_policy_.remote_timeout);
+
+  // Remote first, so a slow local model does not delay the upstream call
+  TryFallbackProvider(
+      params, providers, 0,
+      base::BindOnce(&MultiModelOrchestrator::OnSpeculativeRemoteResponse,
+                     weak_ptr_factory_.GetWeakPtr(), request));
+  if (request->done) {
+    return;
+  }
+
+  local_processor_->ProcessRequest(
+      ToProviderParams(params),
+      base::BindOnce(&MultiModelOrchestrator::OnSpeculativeLocalResponse,
+                     weak_ptr_factory_.GetWeakPtr(), request));
+}
+
+void MultiModelOrchestrator::OnSpeculativeLocalResponse(
+    scoped_refptr<SpeculativeRequest> request,
+    bool success,
+    const std::string& response) {
+  request->local_done = true;
+  if (request->done) {
+    return;
+  }
+
+  if (!success) {
+    if (request->remote_failed) {
+      FinishSpeculativeRequest(std::move(request), false, response);
+    }
+    return;
+  }
+
+  request->draft = response;
+  if (request->draft_callback) {
+    speculation_stats_.drafts_served++;
+    std::move(request->draft_callback).Run(true, response);
+  }
+
+  // Nothing better is coming in time
+  if (request->remote_failed || request->timed_out) {
+    speculation_stats_.drafts_kept++;
+    FinishSpeculativeRequest(std::move(request), true, response);
+  }
+}
+
+void MultiModelOrchestrator::OnSpeculativeRemoteResponse(
+    scoped_refptr<SpeculativeRequest> request,
+    bool success,
+    const std::string& response) {
+  if (request->done) {
+    return;
+  }
+
+  if (success) {
+    if (request->draft) {
+      speculation_stats_.remote_replacements++;
+    }
+    FinishSpeculativeRequest(std::move(request), true, response);
+    return;
+  }
+
+  request->remote_failed = true;
+  if (request->draft) {
+    speculation_stats_.drafts_kept++;
+    std::string draft = *request->draft;
+    FinishSpeculativeRequest(std::move(request), true, draft);
+  } else if (request->local_done) {
+    FinishSpeculativeRequest(std::move(request), false, response);
+  }
+}
+
+void MultiModelOrchestrator::OnSpeculationTimeout(
+    scoped_refptr<SpeculativeRequest> request) {
+  if (request->done) {
+    return;
+  }
+
+  // Without a draft, keep waiting for whichever side answers first.
+  // Otherwise settle on the draft; a late remote answer is dropped when it
+  // lands.
+  request->timed_out = true;
+  if (request->draft) {
+    speculation_stats_.drafts_kept++;
+    std::string draft = *request->draft;
+    FinishSpeculativeRequest(std::move(request), true, draft);
+  }
+}
+
+void MultiModelOrchestrator::FinishSpeculativeRequest(
+    scoped_refptr<SpeculativeRequest> request,
+    bool success,
+    const std::string& response) {
+  request->done = true;
+  request->draft_callback.Reset();
+  std::move(request->final_callback).Run(success, response);
+}
+
+base::TimeDelta MultiModelOrchestrator::GetHedgeDelay(
+    const std::string& provider_id,
+    AIServiceManager::TaskType task_type,
+    const HedgingPolicy& policy) const {
+  auto task_it = latency_histograms_.find(task_type);
+  if (task_it == latency_histograms_.end()) {
+    return policy.max_delay;
+  }
+  auto provider_it = task_it->second.find(provider_id);
+  if (provider_it == task_it->second.end() ||
+      provider_it->second.weight() <= 0.0) {
+    return policy.max_delay;
+  }
+
+  base::TimeDelta observed = base::Milliseconds(
+      provider_it->second.Percentile(policy.percentile));
+  return std::clamp(observed, policy.min_delay, policy.max_delay);
+}
+
+void MultiModelOrchestrator::OnFallbackResponse(
+    const AIServiceManager::AIRequestParams& params,
+    const std::vector<std::string>& fallback_providers,
+    size_t current_index,
+    AIServiceManager::AIResponseCallback callback,
+    base::TimeTicks start_time,
+    bool success,
+    const std::string& response) {
+  const std::string& provider_id = fallback_providers[current_index];
+  if (IsCancellationError(response)) {
+    std::move(callback).Run(false, response);
+    return;
+  }
+
+  float latency_ms = (base::TimeTicks::Now() - start_time).InMillisecondsF();
+  UpdateModelMetrics(provider_id, params.task_type, success, latency_ms,
+                     success ? CalculateQualityScore(response) : 0.0f);
+  RecordNetworkSample(success, response);
+
+  if (success) {
+    std::move(callback).Run(true, response);
+    return;
+  }
+
+  LOG(WARNING) << "Provider " << provider_id << " failed, trying fallback";
+  TryFallbackProvider(params, fallback_providers, current_index + 1,
+                      std::move(callback));
+}
+
+float MultiModelOrchestrator::CalculateQualityScore(
+    const std::string& response) {
+  // Without a reference answer, the best cheap signal is whether the
+  // response has substance. Saturates at a few hundred characters.
+  if (response.empty()) {
+    return 0.0f;
+  }
+  return std::min(1.0f, 0.5f + static_cast<float>(response.size()) / 1000.0f);
+}
+
+CircuitBreaker& MultiModelOrchestrator::GetCircuitBreaker(
+    const std::string& provider_id) {
+  return circuit_breakers_.try_emplace(provider_id, circuit_breaker_config_)
+      .first->second;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -5,19 +5,30 @@
 #ifndef ASOL_CORE_MULTI_MODEL_ORCHESTRATOR_H_
 #define ASOL_CORE_MULTI_MODEL_ORCHESTRATOR_H_
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
 #include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "asol/core/ai_service_manager.h"
 #include "asol/core/ai_service_provider.h"
+#include "asol/core/budget_manager.h"
+#include "asol/core/circuit_breaker.h"
+#include "asol/core/latency_histogram.h"
+#include "asol/core/model_metrics_table.h"
+#include "asol/core/network_quality_estimator.h"
+#include "asol/core/request_preflight.h"
 
 namespace asol {
 namespace core {
 
+class LocalAIProcessor;
+
 // MultiModelOrchestrator manages multiple AI models and selects the best one for each task.
 class MultiModelOrchestrator {
  public:
@@ -28,21 +39,130 @@ class MultiModelOrchestrator {
     LOWEST_COST,       // Select the model with the lowest cost
     HIGHEST_QUALITY,   // Select the model with the highest quality results
     BALANCED,          // Balance performance, latency, cost, and quality
+    // Answer summarization and content analysis with a local draft while
+    // the remote provider (ranked as BALANCED) runs in parallel. Every such
+    // request runs on both, so use it only where callers show the draft
+    // through ProcessRequestSpeculatively().
+    LOCAL_FIRST_SPECULATIVE,
     CUSTOM            // Custom selection logic
   };
 
-  // Model performance metrics
+  // Latency percentile used for latency-based routing
+  enum class LatencyPercentile {
+    P50,
+    P95,
+    P99
+  };
+
+  // Per-task latency routing target. LOWEST_LATENCY ranks providers by
+  // |percentile|; under every strategy, providers whose |percentile| exceeds
+  // |max_latency_ms| are only used as fallbacks. 0 means no limit.
+  struct LatencyTarget {
+    LatencyPercentile percentile = LatencyPercentile::P95;
+    float max_latency_ms = 0.0f;
+  };
+
+  // Model performance metrics. Latency percentiles come from a decaying
+  // histogram whose samples lose half their weight every 10 minutes, the
+  // LatencyHistogram default.
   struct ModelMetrics {
     std::string provider_id;
     AIServiceManager::TaskType task_type;
     float success_rate;
     float average_latency_ms;
+    float p50_latency_ms = 0.0f;
+    float p95_latency_ms = 0.0f;
+    float p99_latency_ms = 0.0f;
     float cost_per_request;
     float quality_score;
     int request_count;
     base::Time last_updated;
   };
 
+  // Hedging for latency-critical tasks. When enabled, if the primary has not
+  // answered by its observed |percentile| latency (clamped to |min_delay|,
+  // |max_delay|; |max_delay| alone while there is no data), the same request
+  // also goes to the first fallback and the first success wins.
+  //
+  // Hedges are paid for from a budget: every hedge-eligible request earns
+  // |max_hedge_ratio| credits up to |max_burst|, and a hedge costs one, so
+  // at most that fraction of requests is duplicated over time.
+  struct HedgingPolicy {
+    bool enabled = false;
+    double percentile = 0.90;
+    base::TimeDelta min_delay = base::Milliseconds(50);
+    base::TimeDelta max_delay = base::Seconds(2);
+    double max_hedge_ratio = 0.1;
+    double max_burst = 10.0;
+  };
+
+  // Hedging counters
+  struct HedgeStats {
+    size_t hedges_sent = 0;
+    size_t hedge_wins = 0;
+    size_t budget_denied = 0;
+  };
+
+  // Local-first speculation. The remote answer replaces the draft if it
+  // arrives within |remote_timeout| of the request starting; after that the
+  // draft is kept. Without a draft the request waits for whichever answers
+  // first.
+  struct SpeculationPolicy {
+    base::TimeDelta remote_timeout = base::Seconds(5);
+  };
+
+  // Speculation counters
+  struct SpeculationStats {
+    size_t drafts_served = 0;
+    size_t remote_replacements = 0;
+    size_t drafts_kept = 0;
+  };
+
+  // Ensemble fan-out. The request goes to the |max_providers| best-ranked
+  // healthy providers at once, and the first response whose quality score
+  // reaches |quality_threshold| wins. At |deadline| the best response so
+  // far is returned; with none yet, the next success is.
+  struct EnsemblePolicy {
+    size_t max_providers = 3;
+    float quality_threshold = 0.8f;
+    base::TimeDelta deadline = base::Seconds(10);
+  };
+
+  // Ensemble counters
+  struct EnsembleStats {
+    size_t ensembles = 0;
+    size_t early_terminations = 0;
+    size_t deadline_expirations = 0;
+    size_t responses_dropped = 0;
+  };
+
+  // What ProcessRequest() and ProcessRequestWithFallback() do while the
+  // network quality estimator reports a degraded or offline connection.
+  // Requests of |local_task_types| go to the local processor, except for a
+  // periodic probe that tries the remote provider first and falls back to
+  // the local answer. Other requests of PREFETCH or BACKGROUND priority wait,
+  // up to |max_deferred_requests| of them, and are sent once quality is
+  // GOOD again. The rest still go remote while DEGRADED, and fail at once
+  // while OFFLINE unless they are the probe.
+  struct DegradedModePolicy {
+    std::vector<AIServiceManager::TaskType> local_task_types = {
+        AIServiceManager::TaskType::TEXT_SUMMARIZATION,
+        AIServiceManager::TaskType::CONTENT_ANALYSIS,
+        AIServiceManager::TaskType::TEXT_GENERATION};
+    size_t max_deferred_requests = 64;
+  };
+
+  // Degraded mode counters
+  struct DegradedModeStats {
+    size_t served_locally = 0;
+    size_t deferred = 0;
+    size_t deferred_sent = 0;
+    // Failed at once while offline, or not deferred because the queue was
+    // full
+    size_t rejected = 0;
+    size_t probes = 0;
+  };
+
   // Model selection result
   struct ModelSelectionResult {
     std::string selected_provider_id;
@@ -71,6 +191,27 @@ class MultiModelOrchestrator {
   void ProcessRequestWithFallback(const AIServiceManager::AIRequestParams& params,
                                 AIServiceManager::AIResponseCallback callback);
 
+  // Process a request by fanning it out under |policy|. Meant for
+  // high-value tasks where quality is worth N concurrent calls.
+  void ProcessRequestWithEnsemble(
+      const AIServiceManager::AIRequestParams& params,
+      const EnsemblePolicy& policy,
+      AIServiceManager::AIResponseCallback callback);
+  EnsembleStats GetEnsembleStats() const;
+
+  // Process a request under LOCAL_FIRST_SPECULATIVE. |draft_callback| runs
+  // with the local result as soon as it is ready, unless the remote answer
+  // beats it; |final_callback| runs once with the answer to keep, remote or
+  // local. Requests that cannot speculate go through
+  // ProcessRequestWithFallback() and never run |draft_callback|.
+  //
+  // ProcessRequest() and ProcessRequestWithFallback() speculate too under
+  // this strategy, reporting only the final answer.
+  void ProcessRequestSpeculatively(
+      const AIServiceManager::AIRequestParams& params,
+      AIServiceManager::AIResponseCallback draft_callback,
+      AIServiceManager::AIResponseCallback final_callback);
+
   // Update model metrics
   void UpdateModelMetrics(const std::string& provider_id,
                         AIServiceManager::TaskType task_type,
@@ -89,6 +230,60 @@ class MultiModelOrchestrator {
   void SetSelectionStrategy(SelectionStrategy strategy);
   SelectionStrategy GetSelectionStrategy() const;
 
+  // Set the latency target for a task type
+  void SetLatencyTarget(AIServiceManager::TaskType task_type,
+                        const LatencyTarget& target);
+  LatencyTarget GetLatencyTarget(AIServiceManager::TaskType task_type) const;
+
+  // Set the hedging policy used by ProcessRequestWithFallback() for a task
+  // type. Hedging is off unless a policy enables it.
+  void SetHedgingPolicy(AIServiceManager::TaskType task_type,
+                        const HedgingPolicy& policy);
+  HedgeStats GetHedgeStats() const;
+
+  // Set the processor that drafts answers under LOCAL_FIRST_SPECULATIVE.
+  // |processor| must outlive this orchestrator; pass nullptr to detach.
+  void SetLocalProcessor(LocalAIProcessor* processor);
+
+  void SetSpeculationPolicy(const SpeculationPolicy& policy);
+  SpeculationStats GetSpeculationStats() const;
+
+  // Enforce |budget_manager|'s limits on every request, speculative and
+  // ensemble ones included. Requests are charged to the scope named by
+  // their kBudgetUserParam and kBudgetFeatureParam parameters; as the budget
+  // runs low they move to the cheapest provider, then to the local
+  // processor, and background work is rejected. |budget_manager| must
+  // outlive this orchestrator; pass nullptr to detach.
+  void SetBudgetManager(BudgetManager* budget_manager);
+
+  // Route around a bad connection as |estimator| judges it, under the
+  // DegradedModePolicy. Every call to a remote provider is reported to
+  // |estimator|. |estimator| must outlive this orchestrator; pass nullptr to
+  // detach.
+  void SetNetworkQualityEstimator(NetworkQualityEstimator* estimator);
+  void SetDegradedModePolicy(const DegradedModePolicy& policy);
+  DegradedModeStats GetDegradedModeStats() const;
+
+  // Price of |provider_id| per thousand tokens, used for budgeting and
+  // reported as ModelMetrics::cost_per_request so cost-aware strategies
+  // rank by it
+  void SetProviderCost(const std::string& provider_id,
+                       double cost_per_1k_tokens);
+
+  // What ProcessRequest() and ProcessRequestWithFallback() do with input of
+  // |task_type| that no candidate provider's context window holds: kReject
+  // (the default) fails the request locally, kTruncate sends the longest
+  // prefix that fits to the provider with the largest window. Candidates too
+  // small for the input are always skipped when another one fits. kChunk is
+  // treated as kReject, since only the caller knows how to merge the
+  // answers; use PreflightInput() for that.
+  void SetInputOverflowPolicy(AIServiceManager::TaskType task_type,
+                              InputOverflow overflow);
+
+  // Configure the per-provider circuit breakers. Providers whose circuit is
+  // open are ranked last and skipped without being sent a request.
+  void SetCircuitBreakerConfig(const CircuitBreaker::Config& config);
+
   // Set custom model selection function
   using CustomModelSelectionFunction = 
       base::RepeatingCallback<std::string(AIServiceManager::TaskType,
@@ -104,9 +299,13 @@ class MultiModelOrchestrator {
   base::WeakPtr<MultiModelOrchestrator> GetWeakPtr();
 
  private:
+  // Per-provider latency histograms for one task type
+  using LatencyHistogramMap = std::unordered_map<std::string, LatencyHistogram>;
+
   // Helper methods
   void OnRequestProcessed(AIServiceManager::AIResponseCallback callback,
                         const std::string& provider_id,
+                        AIServiceManager::TaskType task_type,
                         base::TimeTicks start_time,
                         bool success,
                         const std::string& response);
@@ -115,14 +314,200 @@ class MultiModelOrchestrator {
                          const std::vector<std::string>& fallback_providers,
                          size_t current_index,
                          AIServiceManager::AIResponseCallback callback);
+
+  // State shared by the primary and hedge attempts of one request
+  struct HedgedRequest;
+
+  // Send to providers[0], hedging to providers[1] after a delay
+  void StartHedgedRequest(const AIServiceManager::AIRequestParams& params,
+                          std::vector<std::string> providers,
+                          const HedgingPolicy& policy,
+                          AIServiceManager::AIResponseCallback callback);
+
+  void SendHedgedAttempt(scoped_refptr<HedgedRequest> request,
+                         size_t provider_index);
+
+  void OnHedgeDelayElapsed(scoped_refptr<HedgedRequest> request);
+
+  void OnHedgedResponse(scoped_refptr<HedgedRequest> request,
+                        size_t provider_index,
+                        base::TimeTicks start_time,
+                        bool success,
+                        const std::string& response);
+
+  // Drop the |providers| whose context window cannot hold |params|'s input,
+  // counted with each provider's own tokenizer. If none can, truncates the
+  // input under kTruncate, or returns false having consumed |callback|.
+  bool FitInputToProviders(AIServiceManager::AIRequestParams* params,
+                           std::vector<std::string>* providers,
+                           AIServiceManager::AIResponseCallback* callback);
+
+  // Tokenizer of |provider_id|, or the approximate one if it is unknown
+  const TokenCounter& GetTokenCounter(const std::string& provider_id);
+
+  // Apply the budget to a request about to go to |fan_out| of |providers|,
+  // each charged at the price of the first, reordering them on a downgrade.
+  // Returns false if the request was served locally or rejected, having
+  // consumed |callback|; otherwise charges the estimate and wraps |callback|
+  // to charge the response.
+  bool ApplyBudget(const AIServiceManager::AIRequestParams& params,
+                   size_t fan_out,
+                   std::vector<std::string>* providers,
+                   AIServiceManager::AIResponseCallback* callback);
+
+  void OnBudgetedResponse(const BudgetScope& scope,
+                          const std::string& provider_id,
+                          double cost_per_1k_tokens,
+                          size_t fan_out,
+                          AIServiceManager::AIResponseCallback callback,
+                          bool success,
+                          const std::string& response);
+
+  // Price of |provider_id|, or the budget manager's default if unknown
+  double GetProviderCost(const std::string& provider_id) const;
+
+  // Serve |params| with the local processor alone
+  void ProcessLocally(const AIServiceManager::AIRequestParams& params,
+                      AIServiceManager::AIResponseCallback callback);
+
+  // Apply the DegradedModePolicy to a request while the network is not
+  // GOOD. Returns false if the request was served locally, deferred or
+  // failed, having consumed |callback|.
+  bool ApplyNetworkQuality(const AIServiceManager::AIRequestParams& params,
+                           AIServiceManager::AIResponseCallback* callback);
+
+  // Whether the local processor can answer |params| in degraded mode
+  bool CanServeLocallyWhenDegraded(
+      const AIServiceManager::AIRequestParams& params) const;
+
+  // Answer a failed probe locally
+  void OnProbeResponse(const AIServiceManager::AIRequestParams& params,
+                       AIServiceManager::AIResponseCallback callback,
+                       bool success,
+                       const std::string& response);
+
+  // Report how a remote call went to the estimator, sending the deferred
+  // requests if the network has recovered
+  void RecordNetworkSample(bool success, const std::string& response);
+
+  void SendDeferredRequests();
+
+  // State shared by the attempts of one ensemble request
+  struct EnsembleRequest;
+
+  void OnEnsembleResponse(scoped_refptr<EnsembleRequest> request,
+                          size_t provider_index,
+                          base::TimeTicks start_time,
+                          bool success,
+                          const std::string& response);
+
+  void OnEnsembleDeadline(scoped_refptr<EnsembleRequest> request);
+
+  // Every attempt is in; finish with the best of them
+  void SettleEnsembleRequest(scoped_refptr<EnsembleRequest> request);
+
+  // Run |request|'s callback; responses still out are dropped on arrival
+  void FinishEnsembleRequest(scoped_refptr<EnsembleRequest> request,
+                             bool success,
+                             const std::string& response);
+
+  // State shared by the local and remote halves of a speculative request
+  struct SpeculativeRequest;
+
+  // Whether |params| can get a local draft under the current strategy
+  bool CanSpeculate(const AIServiceManager::AIRequestParams& params) const;
+
+  // Primary provider followed by the fallbacks for |task_type|
+  std::vector<std::string> GetRankedProviders(
+      AIServiceManager::TaskType task_type);
+
+  // Race the local processor against |providers|, tried in order
+  void StartSpeculativeRequest(
+      const AIServiceManager::AIRequestParams& params,
+      std::vector<std::string> providers,
+      AIServiceManager::AIResponseCallback draft_callback,
+      AIServiceManager::AIResponseCallback final_callback);
+
+  void OnSpeculativeLocalResponse(scoped_refptr<SpeculativeRequest> request,
+                                  bool success,
+                                  const std::string& response);
+
+  void OnSpeculativeRemoteResponse(scoped_refptr<SpeculativeRequest> request,
+                                   bool success,
+                                   const std::string& response);
+
+  void OnSpeculationTimeout(scoped_refptr<SpeculativeRequest> request);
+
+  // Run |request|'s final callback, dropping a draft not yet delivered
+  void FinishSpeculativeRequest(scoped_refptr<SpeculativeRequest> request,
+                                bool success,
+                                const std::string& response);
+
+  // How long to wait on |provider_id| before hedging
+  base::TimeDelta GetHedgeDelay(const std::string& provider_id,
+                                AIServiceManager::TaskType task_type,
+                                const HedgingPolicy& policy) const;
+
+  void OnFallbackResponse(const AIServiceManager::AIRequestParams& params,
+                          const std::vector<std::string>& fallback_providers,
+                          size_t current_index,
+                          AIServiceManager::AIResponseCallback callback,
+                          base::TimeTicks start_time,
+                          bool success,
+                          const std::string& response);
   
   float CalculateQualityScore(const std::string& response);
 
+  // Circuit breaker of |provider_id|, created on first use
+  CircuitBreaker& GetCircuitBreaker(const std::string& provider_id);
+
   // AI service manager
   AIServiceManager* ai_service_manager_ = nullptr;
 
-  // Model metrics
-  std::unordered_map<std::string, std::unordered_map<AIServiceManager::TaskType, ModelMetrics>> model_metrics_;
+  // Model metrics, and a scratch buffer for scoring them
+  ModelMetricsTable model_metrics_;
+  std::vector<float> scores_;
+
+  // Streaming latency distributions, by task type then provider
+  std::unordered_map<AIServiceManager::TaskType, LatencyHistogramMap>
+      latency_histograms_;
+
+  // Latency targets by task type
+  std::unordered_map<AIServiceManager::TaskType, LatencyTarget>
+      latency_targets_;
+
+  // Hedging policies by task type, and the shared hedge budget
+  std::unordered_map<AIServiceManager::TaskType, HedgingPolicy>
+      hedging_policies_;
+  double hedge_credits_ = 0.0;
+  HedgeStats hedge_stats_;
+
+  EnsembleStats ensemble_stats_;
+
+  // Context window overflow policies by task type
+  std::unordered_map<AIServiceManager::TaskType, InputOverflow>
+      overflow_policies_;
+
+  // Spend limits and provider prices per thousand tokens
+  BudgetManager* budget_manager_ = nullptr;
+  std::unordered_map<std::string, double> provider_costs_;
+
+  // Local drafts for LOCAL_FIRST_SPECULATIVE
+  LocalAIProcessor* local_processor_ = nullptr;
+  SpeculationPolicy speculation_policy_;
+  SpeculationStats speculation_stats_;
+
+  // Degraded mode, and the requests waiting for the network to recover
+  NetworkQualityEstimator* network_quality_estimator_ = nullptr;
+  DegradedModePolicy degraded_mode_policy_;
+  DegradedModeStats degraded_mode_stats_;
+  std::deque<std::pair<AIServiceManager::AIRequestParams,
+                       AIServiceManager::AIResponseCallback>>
+      deferred_requests_;
+
+  // Provider health, keyed by provider ID
+  CircuitBreaker::Config circuit_breaker_config_;
+  std::unordered_map<std::string, CircuitBreaker> circuit_breakers_;
 
   // Selection strategy
   SelectionStrategy selection_strategy_ = SelectionStrategy::BALANCED;
@@ -0,0 +1,446 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/multi_model_orchestrator.h"
+
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "asol/core/ai_service_manager.h"
+#include "asol/core/ai_service_provider.h"
+#include "asol/core/circuit_breaker.h"
+#include "asol/core/local_ai_processor.h"
+#include "base/functional/bind.h"
+#include "base/strings/strcat.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+// Remote provider that summarizes and counts its calls. Answers at once
+// unless told to hold its answers until Respond().
+class FakeProvider : public AIServiceProvider {
+ public:
+  explicit FakeProvider(const std::string& id) : id_(id) {}
+
+  std::string GetProviderId() const override { return id_; }
+  std::string GetProviderName() const override { return "Fake " + id_; }
+  std::string GetProviderVersion() const override { return "1.0"; }
+  Capabilities GetCapabilities() const override {
+    Capabilities capabilities;
+    capabilities.supports_text_summarization = true;
+    return capabilities;
+  }
+  bool SupportsTaskType(TaskType task_type) const override {
+    return task_type == TaskType::TEXT_SUMMARIZATION;
+  }
+  void ProcessRequest(const AIRequestParams& params,
+                      AIResponseCallback callback) override {
+    request_count_++;
+    if (hold_responses_) {
+      held_callbacks_.push_back(std::move(callback));
+      return;
+    }
+    std::move(callback).Run(true, base::StrCat({id_, ":", params.input_text}));
+  }
+  void Configure(
+      const std::unordered_map<std::string, std::string>& config) override {}
+  std::unordered_map<std::string, std::string> GetConfiguration()
+      const override {
+    return {};
+  }
+
+  int request_count() const { return request_count_; }
+
+  void set_hold_responses(bool hold) { hold_responses_ = hold; }
+
+  // Answer the oldest held request
+  void Respond(bool success, const std::string& response) {
+    ASSERT_FALSE(held_callbacks_.empty());
+    AIResponseCallback callback = std::move(held_callbacks_.front());
+    held_callbacks_.pop_front();
+    std::move(callback).Run(success, response);
+  }
+
+ private:
+  std::string id_;
+  int request_count_ = 0;
+  bool hold_responses_ = false;
+  std::deque<AIResponseCallback> held_callbacks_;
+};
+
+// Local processor that summarizes, holding its drafts until Respond()
+class FakeLocalProcessor : public LocalAIProcessor {
+ public:
+  bool SupportsTaskType(TaskType task_type) const override {
+    return task_type == TaskType::TEXT_SUMMARIZATION;
+  }
+  void ProcessRequest(const AIRequestParams& params,
+                      AIResponseCallback callback) override {
+    held_callbacks_.push_back(std::move(callback));
+  }
+
+  void Respond(bool success, const std::string& response) {
+    ASSERT_FALSE(held_callbacks_.empty());
+    AIResponseCallback callback = std::move(held_callbacks_.front());
+    held_callbacks_.pop_front();
+    std::move(callback).Run(success, response);
+  }
+
+ private:
+  std::deque<AIResponseCallback> held_callbacks_;
+};
+
+class MultiModelOrchestratorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    auto provider = std::make_unique<FakeProvider>("remote");
+    provider_ = provider.get();
+    ai_service_manager_.RegisterProvider(std::move(provider));
+    ASSERT_TRUE(orchestrator_.Initialize(&ai_service_manager_));
+  }
+
+  FakeProvider* AddProvider(const std::string& id) {
+    auto provider = std::make_unique<FakeProvider>(id);
+    FakeProvider* raw_provider = provider.get();
+    ai_service_manager_.RegisterProvider(std::move(provider));
+    return raw_provider;
+  }
+
+  // Register "backup" and rank it after "remote", both having answered
+  // summaries in |latency_ms|, and hedge summaries under |policy|. Both hold
+  // their answers.
+  FakeProvider* SetUpHedging(
+      float latency_ms,
+      const MultiModelOrchestrator::HedgingPolicy& policy) {
+    FakeProvider* backup = AddProvider("backup");
+    auto task = AIServiceManager::TaskType::TEXT_SUMMARIZATION;
+    for (int i = 0; i < 20; ++i) {
+      orchestrator_.UpdateModelMetrics("remote", task, true, latency_ms, 1.0f);
+      orchestrator_.UpdateModelMetrics("backup", task, true, latency_ms, 0.5f);
+    }
+    orchestrator_.SetHedgingPolicy(task, policy);
+    provider_->set_hold_responses(true);
+    backup->set_hold_responses(true);
+    return backup;
+  }
+
+  static MultiModelOrchestrator::HedgingPolicy HedgeEveryRequest() {
+    MultiModelOrchestrator::HedgingPolicy policy;
+    policy.enabled = true;
+    policy.max_hedge_ratio = 1.0;
+    return policy;
+  }
+
+  static AIServiceManager::AIRequestParams SummaryParams() {
+    AIServiceManager::AIRequestParams params;
+    params.task_type = AIServiceManager::TaskType::TEXT_SUMMARIZATION;
+    params.input_text = "page";
+    return params;
+  }
+
+  static AIServiceManager::AIResponseCallback StoreResponse(
+      std::string* out) {
+    return base::BindOnce(
+        [](std::string* out, bool success, const std::string& response) {
+          *out = response;
+        },
+        out);
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  AIServiceManager ai_service_manager_;
+  FakeLocalProcessor local_processor_;
+  MultiModelOrchestrator orchestrator_;
+  FakeProvider* provider_ = nullptr;
+};
+
+TEST_F(MultiModelOrchestratorTest, DoesNotSpeculateByDefault) {
+  EXPECT_EQ(orchestrator_.GetSelectionStrategy(),
+            MultiModelOrchestrator::SelectionStrategy::BALANCED);
+
+  std::string draft, final_response;
+  orchestrator_.ProcessRequestSpeculatively(
+      SummaryParams(), StoreResponse(&draft), StoreResponse(&final_response));
+
+  EXPECT_TRUE(draft.empty());
+  EXPECT_EQ(final_response, "remote:page");
+  EXPECT_EQ(provider_->request_count(), 1);
+  EXPECT_EQ(orchestrator_.GetSpeculationStats().drafts_served, 0u);
+}
+
+TEST_F(MultiModelOrchestratorTest, SpeculationNeedsLocalProcessor) {
+  orchestrator_.SetSelectionStrategy(
+      MultiModelOrchestrator::SelectionStrategy::LOCAL_FIRST_SPECULATIVE);
+
+  // Without a local model there is no draft; the remote answer is final
+  std::string draft, final_response;
+  orchestrator_.ProcessRequestSpeculatively(
+      SummaryParams(), StoreResponse(&draft), StoreResponse(&final_response));
+  EXPECT_TRUE(draft.empty());
+  EXPECT_EQ(final_response, "remote:page");
+
+  std::string response;
+  orchestrator_.ProcessRequest(SummaryParams(), StoreResponse(&response));
+  EXPECT_EQ(response, "remote:page");
+  EXPECT_EQ(provider_->request_count(), 2);
+}
+
+TEST_F(MultiModelOrchestratorTest, EnsembleClaimsProbesOnlyWhenSending) {
+  auto backup = std::make_unique<FakeProvider>("backup");
+  FakeProvider* backup_provider = backup.get();
+  ai_service_manager_.RegisterProvider(std::move(backup));
+  CircuitBreaker::Config config;
+  config.failure_threshold = 1;
+  config.open_duration = base::Seconds(1);
+  orchestrator_.SetCircuitBreakerConfig(config);
+
+  // "remote" ranks first; "backup" fails once and is half-open a bit later
+  auto task = AIServiceManager::TaskType::TEXT_SUMMARIZATION;
+  orchestrator_.UpdateModelMetrics("remote", task, true, 10.0f, 1.0f);
+  orchestrator_.UpdateModelMetrics("backup", task, false, 10.0f, 0.0f);
+  task_environment_.FastForwardBy(base::Seconds(2));
+
+  // The first answer is good enough, so "backup" is never sent to
+  MultiModelOrchestrator::EnsemblePolicy policy;
+  policy.quality_threshold = 0.0f;
+  std::string response;
+  orchestrator_.ProcessRequestWithEnsemble(SummaryParams(), policy,
+                                           StoreResponse(&response));
+  EXPECT_EQ(response, "remote:page");
+  EXPECT_EQ(backup_provider->request_count(), 0);
+
+  // and its probe slot is still free
+  AIServiceManager::AIRequestParams params = SummaryParams();
+  params.provider_id = "backup";
+  orchestrator_.ProcessRequest(params, StoreResponse(&response));
+  EXPECT_EQ(response, "backup:page");
+}
+
+TEST_F(MultiModelOrchestratorTest, HedgesAtObservedLatency) {
+  FakeProvider* backup = SetUpHedging(300.0f, HedgeEveryRequest());
+
+  std::string response;
+  orchestrator_.ProcessRequestWithFallback(SummaryParams(),
+                                           StoreResponse(&response));
+  EXPECT_EQ(provider_->request_count(), 1);
+
+  // The 90th percentile of "remote" is about 300 ms, well short of the
+  // 2 s used without samples
+  task_environment_.FastForwardBy(base::Milliseconds(250));
+  EXPECT_EQ(backup->request_count(), 0);
+  task_environment_.FastForwardBy(base::Milliseconds(100));
+  EXPECT_EQ(backup->request_count(), 1);
+  EXPECT_EQ(orchestrator_.GetHedgeStats().hedges_sent, 1u);
+
+  provider_->Respond(true, "remote:page");
+  EXPECT_EQ(response, "remote:page");
+  EXPECT_EQ(orchestrator_.GetHedgeStats().hedge_wins, 0u);
+  backup->Respond(true, "backup:page");
+}
+
+TEST_F(MultiModelOrchestratorTest, HedgeNeedsBudget) {
+  MultiModelOrchestrator::HedgingPolicy policy = HedgeEveryRequest();
+  policy.max_hedge_ratio = 0.5;
+  policy.max_burst = 1.0;
+  FakeProvider* backup = SetUpHedging(300.0f, policy);
+
+  // Every request earns half a hedge, so only every other one may hedge
+  for (int i = 0; i < 3; ++i) {
+    std::string response;
+    orchestrator_.ProcessRequestWithFallback(SummaryParams(),
+                                             StoreResponse(&response));
+    task_environment_.FastForwardBy(base::Seconds(1));
+    provider_->Respond(true, "remote:page");
+    EXPECT_EQ(response, "remote:page");
+    if (i == 1) {
+      backup->Respond(true, "backup:page");
+    }
+  }
+  EXPECT_EQ(provider_->request_count(), 3);
+  EXPECT_EQ(backup->request_count(), 1);
+  MultiModelOrchestrator::HedgeStats stats = orchestrator_.GetHedgeStats();
+  EXPECT_EQ(stats.hedges_sent, 1u);
+  EXPECT_EQ(stats.budget_denied, 2u);
+}
+
+TEST_F(MultiModelOrchestratorTest, HedgeWinsAndLoserIsDropped) {
+  FakeProvider* backup = SetUpHedging(300.0f, HedgeEveryRequest());
+
+  int responses = 0;
+  std::string response;
+  orchestrator_.ProcessRequestWithFallback(
+      SummaryParams(),
+      base::BindOnce(
+          [](int* responses, std::string* out, bool success,
+             const std::string& response) {
+            ++*responses;
+            *out = response;
+          },
+          &responses, &response));
+  task_environment_.FastForwardBy(base::Seconds(1));
+  ASSERT_EQ(backup->request_count(), 1);
+
+  backup->Respond(true, "backup:page");
+  EXPECT_EQ(response, "backup:page");
+  EXPECT_EQ(orchestrator_.GetHedgeStats().hedge_wins, 1u);
+
+  // The primary's late answer goes nowhere
+  provider_->Respond(true, "remote:page");
+  EXPECT_EQ(responses, 1);
+  EXPECT_EQ(response, "backup:page");
+}
+
+TEST_F(MultiModelOrchestratorTest, FallsBackWhenBothHedgedAttemptsFail) {
+  FakeProvider* backup = SetUpHedging(300.0f, HedgeEveryRequest());
+  FakeProvider* third = AddProvider("third");
+  orchestrator_.UpdateModelMetrics(
+      "third", AIServiceManager::TaskType::TEXT_SUMMARIZATION, true, 300.0f,
+      0.0f);
+
+  std::string response;
+  orchestrator_.ProcessRequestWithFallback(SummaryParams(),
+                                           StoreResponse(&response));
+  task_environment_.FastForwardBy(base::Seconds(1));
+  ASSERT_EQ(backup->request_count(), 1);
+
+  // One failure waits for the other attempt
+  provider_->Respond(false, "remote failed");
+  EXPECT_TRUE(response.empty());
+  EXPECT_EQ(third->request_count(), 0);
+
+  // then the next provider in line is tried
+  backup->Respond(false, "backup failed");
+  EXPECT_EQ(third->request_count(), 1);
+  EXPECT_EQ(response, "third:page");
+}
+
+TEST_F(MultiModelOrchestratorTest, EnsembleSettlesForBestAtDeadline) {
+  FakeProvider* backup = AddProvider("backup");
+  FakeProvider* third = AddProvider("third");
+  for (FakeProvider* provider : {provider_, backup, third}) {
+    provider->set_hold_responses(true);
+  }
+
+  // Nothing short is good enough
+  MultiModelOrchestrator::EnsemblePolicy policy;
+  policy.quality_threshold = 0.9f;
+  policy.deadline = base::Seconds(1);
+  std::string response;
+  orchestrator_.ProcessRequestWithEnsemble(SummaryParams(), policy,
+                                           StoreResponse(&response));
+  ASSERT_EQ(provider_->request_count() + backup->request_count() +
+                third->request_count(),
+            3);
+
+  backup->Respond(true, "a longer backup answer");
+  third->Respond(true, "short");
+  task_environment_.FastForwardBy(base::Milliseconds(999));
+  EXPECT_TRUE(response.empty());
+
+  // Two of three in, so the better one is returned
+  task_environment_.FastForwardBy(base::Milliseconds(1));
+  EXPECT_EQ(response, "a longer backup answer");
+
+  provider_->Respond(true, "late remote answer");
+  EXPECT_EQ(response, "a longer backup answer");
+  MultiModelOrchestrator::EnsembleStats stats =
+      orchestrator_.GetEnsembleStats();
+  EXPECT_EQ(stats.deadline_expirations, 1u);
+  EXPECT_EQ(stats.early_terminations, 0u);
+  EXPECT_EQ(stats.responses_dropped, 1u);
+}
+
+TEST_F(MultiModelOrchestratorTest, EnsembleEndsAtFirstGoodAnswer) {
+  FakeProvider* backup = AddProvider("backup");
+  FakeProvider* third = AddProvider("third");
+  for (FakeProvider* provider : {provider_, backup, third}) {
+    provider->set_hold_responses(true);
+  }
+
+  MultiModelOrchestrator::EnsemblePolicy policy;
+  policy.quality_threshold = 0.6f;
+  std::string response;
+  orchestrator_.ProcessRequestWithEnsemble(SummaryParams(), policy,
+                                           StoreResponse(&response));
+
+  third->Respond(true, "short");
+  EXPECT_TRUE(response.empty());
+
+  // Scores 0.7, past the threshold with one attempt still out
+  const std::string good(200, 'a');
+  backup->Respond(true, good);
+  EXPECT_EQ(response, good);
+  EXPECT_EQ(orchestrator_.GetEnsembleStats().early_terminations, 1u);
+
+  provider_->Respond(true, std::string(500, 'b'));
+  task_environment_.FastForwardBy(policy.deadline);
+  EXPECT_EQ(response, good);
+  EXPECT_EQ(orchestrator_.GetEnsembleStats().responses_dropped, 1u);
+  EXPECT_EQ(orchestrator_.GetEnsembleStats().deadline_expirations, 0u);
+}
+
+TEST_F(MultiModelOrchestratorTest, RemoteAnswerReplacesDraft) {
+  orchestrator_.SetLocalProcessor(&local_processor_);
+  orchestrator_.SetSelectionStrategy(
+      MultiModelOrchestrator::SelectionStrategy::LOCAL_FIRST_SPECULATIVE);
+  provider_->set_hold_responses(true);
+
+  std::string draft, final_response;
+  orchestrator_.ProcessRequestSpeculatively(
+      SummaryParams(), StoreResponse(&draft), StoreResponse(&final_response));
+  EXPECT_EQ(provider_->request_count(), 1);
+
+  local_processor_.Respond(true, "local draft");
+  EXPECT_EQ(draft, "local draft");
+  EXPECT_TRUE(final_response.empty());
+
+  provider_->Respond(true, "remote:page");
+  EXPECT_EQ(final_response, "remote:page");
+  MultiModelOrchestrator::SpeculationStats stats =
+      orchestrator_.GetSpeculationStats();
+  EXPECT_EQ(stats.drafts_served, 1u);
+  EXPECT_EQ(stats.remote_replacements, 1u);
+  EXPECT_EQ(stats.drafts_kept, 0u);
+}
+
+TEST_F(MultiModelOrchestratorTest, DraftIsKeptWhenRemoteIsSlow) {
+  orchestrator_.SetLocalProcessor(&local_processor_);
+  orchestrator_.SetSelectionStrategy(
+      MultiModelOrchestrator::SelectionStrategy::LOCAL_FIRST_SPECULATIVE);
+  MultiModelOrchestrator::SpeculationPolicy policy;
+  policy.remote_timeout = base::Seconds(2);
+  orchestrator_.SetSpeculationPolicy(policy);
+  provider_->set_hold_responses(true);
+
+  std::string draft, final_response;
+  orchestrator_.ProcessRequestSpeculatively(
+      SummaryParams(), StoreResponse(&draft), StoreResponse(&final_response));
+  local_processor_.Respond(true, "local draft");
+  EXPECT_EQ(draft, "local draft");
+
+  // The remote side misses its window, so the draft becomes final
+  task_environment_.FastForwardBy(policy.remote_timeout);
+  EXPECT_EQ(final_response, "local draft");
+
+  provider_->Respond(true, "remote:page");
+  EXPECT_EQ(final_response, "local draft");
+  MultiModelOrchestrator::SpeculationStats stats =
+      orchestrator_.GetSpeculationStats();
+  EXPECT_EQ(stats.drafts_served, 1u);
+  EXPECT_EQ(stats.drafts_kept, 1u);
+  EXPECT_EQ(stats.remote_replacements, 0u);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
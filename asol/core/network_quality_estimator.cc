@@ -0,0 +1,106 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/network_quality_estimator.h"
+
+namespace asol {
+namespace core {
+
+NetworkQualityEstimator::NetworkQualityEstimator(const Config& config)
+    : config_(config) {}
+
+NetworkQualityEstimator::~NetworkQualityEstimator() = default;
+
+void NetworkQualityEstimator::RecordSuccess() {
+  consecutive_failures_ = 0;
+  AddSample(&failure_rate_, 0.0, outcome_count_++ == 0);
+  sample_count_++;
+  UpdateQuality();
+}
+
+void NetworkQualityEstimator::RecordFailure() {
+  ++consecutive_failures_;
+  AddSample(&failure_rate_, 1.0, outcome_count_++ == 0);
+  sample_count_++;
+  UpdateQuality();
+}
+
+void NetworkQualityEstimator::RecordRtt(base::TimeDelta rtt) {
+  rtt_ = rtt_count_++ == 0 ? rtt : rtt_ + (rtt - rtt_) * config_.sample_weight;
+  sample_count_++;
+  UpdateQuality();
+}
+
+void NetworkQualityEstimator::RecordThroughput(size_t bytes,
+                                               base::TimeDelta transfer_time) {
+  // A body that arrived in one read says nothing about the bandwidth
+  if (!transfer_time.is_positive()) {
+    return;
+  }
+  AddSample(&throughput_,
+            static_cast<double>(bytes) / transfer_time.InSecondsF(),
+            throughput_count_++ == 0);
+  sample_count_++;
+  UpdateQuality();
+}
+
+bool NetworkQualityEstimator::AllowProbe(base::TimeTicks now) {
+  if (quality_ == Quality::GOOD || now < next_probe_) {
+    return false;
+  }
+  next_probe_ = now + config_.probe_interval;
+  return true;
+}
+
+// static
+const char* NetworkQualityEstimator::QualityToString(Quality quality) {
+  switch (quality) {
+    case Quality::GOOD:
+      return "good";
+    case Quality::DEGRADED:
+      return "degraded";
+    case Quality::OFFLINE:
+      return "offline";
+  }
+  return "unknown";
+}
+
+void NetworkQualityEstimator::AddSample(double* average,
+                                        double value,
+                                        bool first) const {
+  // The first sample seeds the average rather than being pulled toward 0
+  *average =
+      first ? value : *average + (value - *average) * config_.sample_weight;
+}
+
+bool NetworkQualityEstimator::IsDegraded(double margin) const {
+  if (failure_rate_ > config_.max_failure_rate * margin) {
+    return true;
+  }
+  if (rtt_count_ > 0 && rtt_ > config_.max_rtt * margin) {
+    return true;
+  }
+  return throughput_count_ > 0 && config_.min_throughput_bytes_per_second > 0 &&
+         throughput_ < config_.min_throughput_bytes_per_second / margin;
+}
+
+void NetworkQualityEstimator::UpdateQuality() {
+  if (consecutive_failures_ >= config_.offline_failure_count) {
+    quality_ = Quality::OFFLINE;
+    return;
+  }
+  if (sample_count_ < config_.min_samples) {
+    return;
+  }
+  bool degraded = quality_ == Quality::GOOD
+                      ? IsDegraded(1.0)
+                      : IsDegraded(config_.recovery_margin);
+  quality_ = degraded ? Quality::DEGRADED : Quality::GOOD;
+  if (quality_ == Quality::GOOD) {
+    next_probe_ = base::TimeTicks();
+  }
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,110 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_NETWORK_QUALITY_ESTIMATOR_H_
+#define ASOL_CORE_NETWORK_QUALITY_ESTIMATOR_H_
+
+#include <stddef.h>
+
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// NetworkQualityEstimator judges the connection to the remote providers from
+// the calls made to them, so callers can stop waiting out HTTP timeouts on a
+// flaky connection and use the local model instead.
+//
+// It keeps moving averages of round-trip time, throughput and failure rate.
+// Only the network is judged, not the providers: the RTT is a connection
+// round trip or time to first byte, never a whole call, which includes
+// generation; throughput is measured over the body transfer alone; and
+// only transport errors and timeouts are failures. A provider answering
+// with an HTTP error is reachable.
+//
+//   GOOD      the averages are within their thresholds.
+//   DEGRADED  an average is past its threshold. Quality only returns to
+//             GOOD once every average is back within |recovery_margin| of
+//             its threshold, so it does not flap at the boundary.
+//   OFFLINE   |offline_failure_count| calls in a row failed. The next
+//             success leaves it.
+//
+// While not GOOD, AllowProbe() lets a call through every |probe_interval|,
+// so recovery is noticed even when everything else is served locally.
+// Not thread-safe.
+class NetworkQualityEstimator {
+ public:
+  enum class Quality {
+    GOOD,
+    DEGRADED,
+    OFFLINE
+  };
+
+  struct Config {
+    // Weight of the newest sample in the moving averages
+    double sample_weight = 0.2;
+    // Samples needed before quality can leave GOOD for DEGRADED
+    int min_samples = 3;
+    // Roughly a 2G connection's round trip
+    base::TimeDelta max_rtt = base::Milliseconds(1500);
+    // 0 disables the throughput check
+    double min_throughput_bytes_per_second = 200.0;
+    double max_failure_rate = 0.3;
+    int offline_failure_count = 3;
+    double recovery_margin = 0.8;
+    base::TimeDelta probe_interval = base::Seconds(15);
+  };
+
+  explicit NetworkQualityEstimator(const Config& config = Config());
+  ~NetworkQualityEstimator();
+
+  // A call that reached its provider, whatever the provider answered
+  void RecordSuccess();
+  // A call that failed in transport (DNS, connect, reset) or timed out.
+  // Cancelled calls say nothing about the network and should not be
+  // reported.
+  void RecordFailure();
+
+  // A connection round trip, or a time to first byte
+  void RecordRtt(base::TimeDelta rtt);
+  // |bytes| of response body received over |transfer_time|, from the first
+  // byte to the last
+  void RecordThroughput(size_t bytes, base::TimeDelta transfer_time);
+
+  Quality GetQuality() const { return quality_; }
+
+  // Whether a call may go to a remote provider as a probe while quality is
+  // not GOOD. Claims the probe slot until |probe_interval| has passed.
+  bool AllowProbe(base::TimeTicks now);
+
+  // The moving averages; zero before the first sample
+  base::TimeDelta rtt() const { return rtt_; }
+  double throughput_bytes_per_second() const { return throughput_; }
+  double failure_rate() const { return failure_rate_; }
+
+  static const char* QualityToString(Quality quality);
+
+ private:
+  void AddSample(double* average, double value, bool first) const;
+  // Whether any average is past its threshold scaled by |margin|
+  bool IsDegraded(double margin) const;
+  void UpdateQuality();
+
+  Config config_;
+  Quality quality_ = Quality::GOOD;
+  int sample_count_ = 0;
+  int outcome_count_ = 0;
+  int rtt_count_ = 0;
+  int throughput_count_ = 0;
+  int consecutive_failures_ = 0;
+  base::TimeDelta rtt_;
+  double throughput_ = 0.0;
+  double failure_rate_ = 0.0;
+  base::TimeTicks next_probe_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_NETWORK_QUALITY_ESTIMATOR_H_
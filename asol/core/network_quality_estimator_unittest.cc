@@ -0,0 +1,108 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/network_quality_estimator.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+using Quality = NetworkQualityEstimator::Quality;
+
+NetworkQualityEstimator::Config MakeConfig() {
+  NetworkQualityEstimator::Config config;
+  config.sample_weight = 0.5;
+  config.min_samples = 2;
+  config.max_rtt = base::Seconds(2);
+  config.min_throughput_bytes_per_second = 100.0;
+  config.max_failure_rate = 0.5;
+  config.offline_failure_count = 3;
+  config.recovery_margin = 0.5;
+  config.probe_interval = base::Seconds(10);
+  return config;
+}
+
+TEST(NetworkQualityEstimatorTest, StaysGoodOnFastCalls) {
+  NetworkQualityEstimator estimator(MakeConfig());
+  for (int i = 0; i < 5; ++i) {
+    estimator.RecordRtt(base::Milliseconds(300));
+    estimator.RecordThroughput(600, base::Milliseconds(300));
+    estimator.RecordSuccess();
+  }
+  EXPECT_EQ(estimator.GetQuality(), Quality::GOOD);
+  EXPECT_EQ(estimator.rtt(), base::Milliseconds(300));
+  EXPECT_DOUBLE_EQ(estimator.throughput_bytes_per_second(), 2000.0);
+  EXPECT_DOUBLE_EQ(estimator.failure_rate(), 0.0);
+}
+
+TEST(NetworkQualityEstimatorTest, SlowRoundTripsDegradeAndRecoverWithMargin) {
+  NetworkQualityEstimator estimator(MakeConfig());
+  estimator.RecordRtt(base::Seconds(3));
+  // Too few samples to judge
+  EXPECT_EQ(estimator.GetQuality(), Quality::GOOD);
+  estimator.RecordRtt(base::Seconds(3));
+  EXPECT_EQ(estimator.GetQuality(), Quality::DEGRADED);
+
+  // 1.75s is within the threshold but not within the recovery margin
+  estimator.RecordRtt(base::Milliseconds(500));
+  EXPECT_EQ(estimator.rtt(), base::Milliseconds(1750));
+  EXPECT_EQ(estimator.GetQuality(), Quality::DEGRADED);
+
+  estimator.RecordRtt(base::Milliseconds(100));
+  estimator.RecordRtt(base::Milliseconds(100));
+  EXPECT_LT(estimator.rtt(), base::Seconds(1));
+  EXPECT_EQ(estimator.GetQuality(), Quality::GOOD);
+}
+
+TEST(NetworkQualityEstimatorTest, LowThroughputDegrades) {
+  NetworkQualityEstimator estimator(MakeConfig());
+  estimator.RecordThroughput(50, base::Seconds(1));
+  estimator.RecordThroughput(50, base::Seconds(1));
+  EXPECT_EQ(estimator.GetQuality(), Quality::DEGRADED);
+}
+
+TEST(NetworkQualityEstimatorTest, InstantBodiesAreNotThroughputSamples) {
+  NetworkQualityEstimator estimator(MakeConfig());
+  estimator.RecordThroughput(10, base::TimeDelta());
+  estimator.RecordThroughput(10, base::TimeDelta());
+  EXPECT_DOUBLE_EQ(estimator.throughput_bytes_per_second(), 0.0);
+  EXPECT_EQ(estimator.GetQuality(), Quality::GOOD);
+}
+
+TEST(NetworkQualityEstimatorTest, ConsecutiveFailuresGoOffline) {
+  NetworkQualityEstimator estimator(MakeConfig());
+  estimator.RecordSuccess();
+  estimator.RecordFailure();
+  estimator.RecordFailure();
+  EXPECT_NE(estimator.GetQuality(), Quality::OFFLINE);
+  estimator.RecordFailure();
+  EXPECT_EQ(estimator.GetQuality(), Quality::OFFLINE);
+
+  // A success shows the network is back, but the failure rate is still high
+  estimator.RecordSuccess();
+  EXPECT_EQ(estimator.GetQuality(), Quality::DEGRADED);
+  for (int i = 0; i < 4; ++i) {
+    estimator.RecordSuccess();
+  }
+  EXPECT_EQ(estimator.GetQuality(), Quality::GOOD);
+}
+
+TEST(NetworkQualityEstimatorTest, ProbesOncePerInterval) {
+  NetworkQualityEstimator estimator(MakeConfig());
+  base::TimeTicks now = base::TimeTicks::Now();
+  EXPECT_FALSE(estimator.AllowProbe(now));
+
+  for (int i = 0; i < 3; ++i) {
+    estimator.RecordFailure();
+  }
+  EXPECT_TRUE(estimator.AllowProbe(now));
+  EXPECT_FALSE(estimator.AllowProbe(now + base::Seconds(5)));
+  EXPECT_TRUE(estimator.AllowProbe(now + base::Seconds(10)));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,313 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Microbenchmarks of the ASOL core hot paths: PII redaction at every
+// privacy level, the response cache of MultiAdapterManager and decoding of
+// provider responses. Runs are
+// repeatable, so results can be tracked from build to build:
+//
+//   asol_perf_benchmarks --benchmark_out=asol_perf.json
+//
+// writes the results as JSON. Any other Google Benchmark flag applies,
+// e.g. --benchmark_filter=PrivacyProxy or --benchmark_repetitions=5.
+
+#include <stddef.h>
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asol/adapters/json_field_reader.h"
+#include "asol/core/ai_service_provider.h"
+#include "asol/core/multi_adapter_manager.h"
+#include "asol/core/privacy_proxy.h"
+#include "asol/core/shared_text.h"
+#include "base/at_exit.h"
+#include "base/functional/bind.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task/single_thread_task_executor.h"
+#include "third_party/google_benchmark/src/include/benchmark/benchmark.h"
+#include "third_party/nlohmann_json/json.hpp"
+
+namespace asol {
+namespace core {
+namespace {
+
+constexpr PrivacyProxy::PrivacyLevel kPrivacyLevels[] = {
+    PrivacyProxy::PrivacyLevel::MINIMAL,
+    PrivacyProxy::PrivacyLevel::STANDARD,
+    PrivacyProxy::PrivacyLevel::STRICT,
+    PrivacyProxy::PrivacyLevel::MAXIMUM,
+};
+
+// Paragraphs of page text with the kinds of PII each level redacts: names,
+// contact details, places, dates, card numbers and device identifiers.
+// |variant| changes every paragraph, so texts of different variants share
+// nothing in the redaction cache.
+std::string MakePiiText(size_t size, int variant) {
+  static const char* const kParagraphs[] = {
+      "Please contact Jane Miller at jane.miller@example.com or call "
+      "+1 (415) 555-0134 before the end of the week to confirm the order.",
+      "The delivery goes to 221 Baker Street, London NW1 6XE on 12/03/2025; "
+      "the courier will ring the bell twice and wait for a signature.",
+      "Payment was made with card 4111 1111 1111 1111, expiring 09/27, and "
+      "the receipt was sent to billing@example.org the same afternoon.",
+      "Our servers logged the visit from 192.168.10.42 with device ID "
+      "a1b2c3d4-e5f6-7890-abcd-ef1234567890 at 14:32 on March 3rd.",
+      "The committee reviewed the proposal in detail and agreed that the "
+      "second phase should start once the survey results are published.",
+      "Dr. Robert Chen of Springfield General Hospital will present the "
+      "study results; questions can go to r.chen@hospital.example.net.",
+  };
+  std::string text;
+  text.reserve(size + 256);
+  for (size_t i = 0; text.size() < size; ++i) {
+    base::StrAppend(&text, {kParagraphs[i % std::size(kParagraphs)],
+                            " Reference ", base::NumberToString(variant), "-",
+                            base::NumberToString(i), ".\n\n"});
+  }
+  return text;
+}
+
+// Redaction of a text none of whose paragraphs were redacted before, as
+// for a page seen the first time. Args: privacy level, text size.
+void BM_PrivacyProxyProcessTextSync(benchmark::State& state) {
+  PrivacyProxy::PrivacyLevel level = kPrivacyLevels[state.range(0)];
+  size_t size = static_cast<size_t>(state.range(1));
+
+  // Fresh variants defeat the redaction cache; they are made up front so
+  // only redaction is timed
+  constexpr int kVariants = 64;
+  std::vector<SharedText> texts;
+  for (int i = 0; i < kVariants; ++i) {
+    texts.emplace_back(MakePiiText(size, i));
+  }
+
+  std::unique_ptr<PrivacyProxy> proxy;
+  int next = kVariants;
+  int redactions = 0;
+  for (auto _ : state) {
+    if (next == kVariants) {
+      state.PauseTiming();
+      proxy = std::make_unique<PrivacyProxy>();
+      proxy->Initialize();
+      proxy->SetPrivacyLevel(level);
+      next = 0;
+      state.ResumeTiming();
+    }
+    PrivacyProxy::ProcessingResult result =
+        proxy->ProcessTextSync(texts[next++]);
+    redactions = result.num_redactions;
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+  state.counters["redactions"] = redactions;
+}
+BENCHMARK(BM_PrivacyProxyProcessTextSync)
+    ->ArgNames({"level", "bytes"})
+    ->ArgsProduct({{0, 1, 2, 3}, {4 << 10, 64 << 10}});
+
+// Redaction of a text whose paragraphs are all in the redaction cache, as
+// for a page summarized again in another format
+void BM_PrivacyProxyProcessTextSyncCached(benchmark::State& state) {
+  PrivacyProxy proxy;
+  proxy.Initialize();
+  proxy.SetPrivacyLevel(kPrivacyLevels[state.range(0)]);
+  size_t size = static_cast<size_t>(state.range(1));
+  SharedText text(MakePiiText(size, 0));
+  proxy.ProcessTextSync(text);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(proxy.ProcessTextSync(text));
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_PrivacyProxyProcessTextSyncCached)
+    ->ArgNames({"level", "bytes"})
+    ->ArgsProduct({{0, 1, 2, 3}, {4 << 10, 64 << 10}});
+
+// Answers at once with a response the size of a short summary, so cache
+// misses cost only the manager's own work
+class EchoProvider : public AIServiceProvider {
+ public:
+  std::string GetProviderId() const override { return "echo"; }
+  std::string GetProviderName() const override { return "Echo"; }
+  std::string GetProviderVersion() const override { return "1.0"; }
+  Capabilities GetCapabilities() const override {
+    Capabilities capabilities;
+    capabilities.supports_text_generation = true;
+    return capabilities;
+  }
+  bool SupportsTaskType(TaskType task_type) const override {
+    return task_type == TaskType::TEXT_GENERATION;
+  }
+  void ProcessRequest(const AIRequestParams& params,
+                      AIResponseCallback callback) override {
+    std::move(callback).Run(true, base::StrCat({params.input_text, " ",
+                                                std::string(512, 'r')}));
+  }
+  void Configure(
+      const std::unordered_map<std::string, std::string>& config) override {}
+  std::unordered_map<std::string, std::string> GetConfiguration()
+      const override {
+    return {};
+  }
+};
+
+// Requests with distinct prompts, each about the size of a summary prompt
+std::vector<AIServiceProvider::AIRequestParams> MakeRequests(size_t count,
+                                                             size_t first) {
+  std::vector<AIServiceProvider::AIRequestParams> requests(count);
+  for (size_t i = 0; i < count; ++i) {
+    requests[i].task_type = AIServiceProvider::TaskType::TEXT_GENERATION;
+    requests[i].input_text =
+        base::StrCat({"Summarize the following page in three bullet points. "
+                      "Page ",
+                      base::NumberToString(first + i), ": ",
+                      std::string(1024, 'p')});
+  }
+  return requests;
+}
+
+// A manager whose cache holds the responses to |requests| and has room
+// for no more
+std::unique_ptr<MultiAdapterManager> MakeFullManager(
+    const std::vector<AIServiceProvider::AIRequestParams>& requests) {
+  auto manager = std::make_unique<MultiAdapterManager>();
+  manager->RegisterProvider(std::make_unique<EchoProvider>());
+  manager->SetActiveProvider("echo");
+  MultiAdapterManager::CacheConfig config;
+  config.max_entries = requests.size();
+  config.max_bytes = 1024 * 1024 * 1024;
+  manager->ConfigureCache(config);
+  for (const auto& request : requests) {
+    manager->ProcessRequest(request, base::DoNothing());
+  }
+  return manager;
+}
+
+// Lookup of a cached response. Arg: entries in the cache.
+void BM_MultiAdapterManagerCacheHit(benchmark::State& state) {
+  std::vector<AIServiceProvider::AIRequestParams> requests =
+      MakeRequests(static_cast<size_t>(state.range(0)), 0);
+  std::unique_ptr<MultiAdapterManager> manager = MakeFullManager(requests);
+
+  size_t next = 0;
+  std::string response;
+  for (auto _ : state) {
+    bool hit = manager->LookupCachedResponse(requests[next], &response);
+    benchmark::DoNotOptimize(hit);
+    next = (next + 1) % requests.size();
+  }
+  state.counters["hit_rate"] = manager->GetCacheStats().hit_rate;
+}
+BENCHMARK(BM_MultiAdapterManagerCacheHit)->Arg(100)->Arg(1000)->Arg(10000);
+
+// Lookup of a prompt that is not cached. Arg: entries in the cache.
+void BM_MultiAdapterManagerCacheMiss(benchmark::State& state) {
+  size_t entries = static_cast<size_t>(state.range(0));
+  std::unique_ptr<MultiAdapterManager> manager =
+      MakeFullManager(MakeRequests(entries, 0));
+  std::vector<AIServiceProvider::AIRequestParams> misses =
+      MakeRequests(entries, entries);
+
+  size_t next = 0;
+  std::string response;
+  for (auto _ : state) {
+    bool hit = manager->LookupCachedResponse(misses[next], &response);
+    benchmark::DoNotOptimize(hit);
+    next = (next + 1) % misses.size();
+  }
+}
+BENCHMARK(BM_MultiAdapterManagerCacheMiss)->Arg(100)->Arg(1000)->Arg(10000);
+
+// A request that misses a full cache: dispatch to the provider, then
+// caching the response in place of the least recently used entry. Arg:
+// entries in the cache.
+void BM_MultiAdapterManagerCacheEvict(benchmark::State& state) {
+  size_t entries = static_cast<size_t>(state.range(0));
+  // Cycling through twice as many prompts as fit keeps every request a
+  // miss under LRU
+  std::vector<AIServiceProvider::AIRequestParams> requests =
+      MakeRequests(2 * entries, 0);
+  std::unique_ptr<MultiAdapterManager> manager = MakeFullManager(
+      std::vector<AIServiceProvider::AIRequestParams>(
+          requests.begin() + entries, requests.end()));
+
+  size_t next = 0;
+  for (auto _ : state) {
+    manager->ProcessRequest(requests[next], base::DoNothing());
+    next = (next + 1) % requests.size();
+  }
+  state.counters["evictions"] = manager->GetCacheStats().evictions;
+}
+BENCHMARK(BM_MultiAdapterManagerCacheEvict)->Arg(100)->Arg(1000)->Arg(10000);
+
+// A Gemini response with a long completion and bulky safety metadata the
+// adapters never read
+std::string MakeGeminiResponse(size_t completion_size) {
+  std::string ratings;
+  for (int i = 0; i < 2000; ++i) {
+    base::StrAppend(
+        &ratings,
+        {i ? "," : "",
+         R"({"category": "HARM_CATEGORY", "probability": "NEGLIGIBLE"})"});
+  }
+  return base::StrCat(
+      {R"({"candidates": [{"safetyRatings": [)", ratings,
+       R"(], "content": {"parts": [{"text": ")",
+       std::string(completion_size, 'a'),
+       R"("}]}}], "usage": {"totalTokenCount": 65536}})"});
+}
+
+// Extracting the completion by parsing the whole response into a DOM.
+// Arg: completion size.
+void BM_JsonDomDecodeCompletion(benchmark::State& state) {
+  std::string body = MakeGeminiResponse(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    nlohmann::json json = nlohmann::json::parse(body);
+    std::string text = json["candidates"][0]["content"]["parts"][0]["text"];
+    benchmark::DoNotOptimize(text);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(body.size()));
+}
+BENCHMARK(BM_JsonDomDecodeCompletion)->Arg(4 * 1024)->Arg(256 * 1024);
+
+// The same with JsonFieldReader, which skips what it does not need. Arg:
+// completion size.
+void BM_JsonFieldReaderDecodeCompletion(benchmark::State& state) {
+  std::string body = MakeGeminiResponse(static_cast<size_t>(state.range(0)));
+  std::string text;
+  for (auto _ : state) {
+    adapters::JsonFieldReader reader(body);
+    bool found = reader.GetString(
+        {"candidates", 0, "content", "parts", 0, "text"}, &text);
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(body.size()));
+}
+BENCHMARK(BM_JsonFieldReaderDecodeCompletion)->Arg(4 * 1024)->Arg(256 * 1024);
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
+
+int main(int argc, char** argv) {
+  base::AtExitManager at_exit_manager;
+  base::SingleThreadTaskExecutor main_task_executor;
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,355 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/persistent_response_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "asol/core/startup_trace.h"
+#include "base/files/file_util.h"
+#include "base/hash/hash.h"
+#include "base/logging.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+constexpr uint32_t kFileMagic = 0x43524144;  // "DARC"
+constexpr uint32_t kFileVersion = 1;
+constexpr uint32_t kRecordMagic = 0x52454344;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+};
+
+struct RecordHeader {
+  uint32_t magic;
+  uint32_t key_size;
+  uint32_t value_size;
+  uint32_t checksum;
+  int64_t write_time_us;
+};
+
+int64_t ToMicroseconds(base::Time time) {
+  return time.ToDeltaSinceWindowsEpoch().InMicroseconds();
+}
+
+}  // namespace
+
+PersistentResponseStore::PersistentResponseStore(const Options& options)
+    : options_(options) {}
+
+PersistentResponseStore::~PersistentResponseStore() = default;
+
+bool PersistentResponseStore::Get(const std::string& key,
+                                  std::string* value,
+                                  base::Time* write_time) {
+  if (!EnsureLoaded()) {
+    return false;
+  }
+
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return false;
+  }
+
+  const IndexEntry& entry = it->second;
+  if (IsExpired(entry, base::Time::Now())) {
+    index_.erase(it);
+    return false;
+  }
+
+  // Records appended since the last mapping are not visible through it yet.
+  if (entry.offset + entry.value_size > mapping_->length() && !Remap()) {
+    return false;
+  }
+
+  const char* data =
+      reinterpret_cast<const char*>(mapping_->data()) + entry.offset;
+  std::string_view bytes(data, entry.value_size);
+  if (base::PersistentHash(bytes) != entry.checksum) {
+    LOG(WARNING) << "Dropping corrupt persistent cache record for key " << key;
+    index_.erase(it);
+    return false;
+  }
+
+  value->assign(bytes);
+  if (write_time) {
+    *write_time = base::Time::FromDeltaSinceWindowsEpoch(
+        base::Microseconds(entry.write_time_us));
+  }
+  return true;
+}
+
+bool PersistentResponseStore::Put(const std::string& key,
+                                  const std::string& value) {
+  if (!EnsureLoaded()) {
+    return false;
+  }
+
+  size_t record_size = sizeof(RecordHeader) + key.size() + value.size();
+  if (record_size > options_.max_bytes / 2) {
+    // Never worth evicting half the store for a single record
+    return false;
+  }
+
+  if (file_size_ + record_size > options_.max_bytes &&
+      !Compact(options_.max_bytes / 2)) {
+    return false;
+  }
+
+  int64_t now = ToMicroseconds(base::Time::Now());
+  uint32_t checksum = base::PersistentHash(value);
+  if (!WriteRecord(&file_, file_size_, key, value.data(),
+                   static_cast<uint32_t>(value.size()), checksum, now)) {
+    LOG(ERROR) << "Failed to append to persistent cache: "
+               << options_.path.value();
+    return false;
+  }
+
+  IndexEntry entry;
+  entry.offset = file_size_ + sizeof(RecordHeader) + key.size();
+  entry.value_size = static_cast<uint32_t>(value.size());
+  entry.checksum = checksum;
+  entry.write_time_us = now;
+  index_[key] = entry;
+
+  file_size_ += record_size;
+  return true;
+}
+
+void PersistentResponseStore::Clear() {
+  if (!EnsureLoaded()) {
+    return;
+  }
+
+  index_.clear();
+  mapping_.reset();
+  file_.SetLength(0);
+  if (!WriteFileHeader(&file_)) {
+    load_failed_ = true;
+    return;
+  }
+  file_size_ = sizeof(FileHeader);
+  Remap();
+}
+
+void PersistentResponseStore::SetTimeToLive(base::TimeDelta time_to_live) {
+  options_.time_to_live = time_to_live;
+}
+
+size_t PersistentResponseStore::GetEntryCount() {
+  if (!EnsureLoaded()) {
+    return 0;
+  }
+  return index_.size();
+}
+
+bool PersistentResponseStore::EnsureLoaded() {
+  if (loaded_) {
+    return !load_failed_;
+  }
+  loaded_ = true;
+  ScopedStartupPhase phase("cache_load");
+
+  if (!base::CreateDirectory(options_.path.DirName())) {
+    LOG(ERROR) << "Failed to create persistent cache directory: "
+               << options_.path.DirName().value();
+    load_failed_ = true;
+    return false;
+  }
+
+  file_.Initialize(options_.path, base::File::FLAG_OPEN_ALWAYS |
+                                      base::File::FLAG_READ |
+                                      base::File::FLAG_WRITE);
+  if (!file_.IsValid()) {
+    LOG(ERROR) << "Failed to open persistent cache: " << options_.path.value();
+    load_failed_ = true;
+    return false;
+  }
+
+  int64_t length = file_.GetLength();
+  FileHeader header = {};
+  bool valid_header =
+      length >= static_cast<int64_t>(sizeof(FileHeader)) &&
+      file_.Read(0, reinterpret_cast<char*>(&header), sizeof(header)) ==
+          static_cast<int>(sizeof(header)) &&
+      header.magic == kFileMagic && header.version == kFileVersion;
+
+  if (!valid_header) {
+    // Missing, foreign or older-format segment: start over.
+    file_.SetLength(0);
+    if (!WriteFileHeader(&file_)) {
+      load_failed_ = true;
+      return false;
+    }
+    file_size_ = sizeof(FileHeader);
+    return Remap();
+  }
+
+  file_size_ = static_cast<uint64_t>(length);
+  if (!Remap()) {
+    return false;
+  }
+
+  // Walk the record headers. Values are left in the mapping.
+  const uint8_t* data = mapping_->data();
+  uint64_t offset = sizeof(FileHeader);
+  while (offset + sizeof(RecordHeader) <= file_size_) {
+    RecordHeader record;
+    memcpy(&record, data + offset, sizeof(record));
+    uint64_t end = offset + sizeof(RecordHeader) + record.key_size +
+                   record.value_size;
+    if (record.magic != kRecordMagic || end > file_size_) {
+      break;
+    }
+
+    std::string key(reinterpret_cast<const char*>(data) + offset +
+                        sizeof(RecordHeader),
+                    record.key_size);
+    IndexEntry entry;
+    entry.offset = offset + sizeof(RecordHeader) + record.key_size;
+    entry.value_size = record.value_size;
+    entry.checksum = record.checksum;
+    entry.write_time_us = record.write_time_us;
+    index_[std::move(key)] = entry;
+
+    offset = end;
+  }
+
+  if (offset < file_size_) {
+    // A torn write from a previous session; drop the partial tail.
+    LOG(WARNING) << "Truncating persistent cache at offset " << offset
+                 << " of " << file_size_;
+    mapping_.reset();
+    file_.SetLength(static_cast<int64_t>(offset));
+    file_size_ = offset;
+    return Remap();
+  }
+
+  return true;
+}
+
+bool PersistentResponseStore::Remap() {
+  mapping_ = std::make_unique<base::MemoryMappedFile>();
+  if (!mapping_->Initialize(file_.Duplicate())) {
+    LOG(ERROR) << "Failed to map persistent cache: " << options_.path.value();
+    mapping_.reset();
+    load_failed_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool PersistentResponseStore::Compact(size_t target_bytes) {
+  if (!Remap()) {
+    return false;
+  }
+
+  base::Time now = base::Time::Now();
+  std::vector<std::pair<const std::string*, const IndexEntry*>> live;
+  live.reserve(index_.size());
+  for (const auto& [key, entry] : index_) {
+    if (!IsExpired(entry, now)) {
+      live.emplace_back(&key, &entry);
+    }
+  }
+
+  // Keep the most recently written records
+  std::sort(live.begin(), live.end(), [](const auto& a, const auto& b) {
+    return a.second->write_time_us > b.second->write_time_us;
+  });
+
+  base::FilePath temp_path = options_.path.AddExtension(FILE_PATH_LITERAL("tmp"));
+  base::File temp_file(temp_path, base::File::FLAG_CREATE_ALWAYS |
+                                      base::File::FLAG_READ |
+                                      base::File::FLAG_WRITE);
+  if (!temp_file.IsValid() || !WriteFileHeader(&temp_file)) {
+    LOG(ERROR) << "Failed to create compacted cache: " << temp_path.value();
+    return false;
+  }
+
+  const char* data = reinterpret_cast<const char*>(mapping_->data());
+  uint64_t offset = sizeof(FileHeader);
+  for (const auto& [key, entry] : live) {
+    size_t record_size = sizeof(RecordHeader) + key->size() + entry->value_size;
+    if (offset + record_size > target_bytes) {
+      break;
+    }
+    if (!WriteRecord(&temp_file, offset, *key, data + entry->offset,
+                     entry->value_size, entry->checksum,
+                     entry->write_time_us)) {
+      LOG(ERROR) << "Failed to write compacted cache: " << temp_path.value();
+      return false;
+    }
+    offset += record_size;
+  }
+
+  mapping_.reset();
+  file_.Close();
+  temp_file.Close();
+
+  if (!base::ReplaceFile(temp_path, options_.path, nullptr)) {
+    LOG(ERROR) << "Failed to replace persistent cache: "
+               << options_.path.value();
+    base::DeleteFile(temp_path);
+  }
+
+  // Reload from whichever segment is now in place. The compacted one is at
+  // most half the budget, so walking its headers again is cheap.
+  index_.clear();
+  file_size_ = 0;
+  loaded_ = false;
+  load_failed_ = false;
+  return EnsureLoaded();
+}
+
+// static
+bool PersistentResponseStore::WriteFileHeader(base::File* file) {
+  FileHeader header = {kFileMagic, kFileVersion};
+  return file->Write(0, reinterpret_cast<const char*>(&header),
+                     sizeof(header)) == static_cast<int>(sizeof(header));
+}
+
+// static
+bool PersistentResponseStore::WriteRecord(base::File* file,
+                                          uint64_t offset,
+                                          const std::string& key,
+                                          const char* value,
+                                          uint32_t value_size,
+                                          uint32_t checksum,
+                                          int64_t write_time_us) {
+  RecordHeader header;
+  header.magic = kRecordMagic;
+  header.key_size = static_cast<uint32_t>(key.size());
+  header.value_size = value_size;
+  header.checksum = checksum;
+  header.write_time_us = write_time_us;
+
+  // One write per record keeps a crash from interleaving partial fields
+  std::string buffer;
+  buffer.reserve(sizeof(header) + key.size() + value_size);
+  buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  buffer.append(key);
+  buffer.append(value, value_size);
+
+  return file->Write(static_cast<int64_t>(offset), buffer.data(),
+                     static_cast<int>(buffer.size())) ==
+         static_cast<int>(buffer.size());
+}
+
+bool PersistentResponseStore::IsExpired(const IndexEntry& entry,
+                                        base::Time now) const {
+  return ToMicroseconds(now) - entry.write_time_us >
+         options_.time_to_live.InMicroseconds();
+}
+
+}  // namespace core
+}  // namespace asol
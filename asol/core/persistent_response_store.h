@@ -0,0 +1,125 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_PERSISTENT_RESPONSE_STORE_H_
+#define ASOL_CORE_PERSISTENT_RESPONSE_STORE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// PersistentResponseStore keeps AI responses on disk so that a browser
+// restart does not start with a cold cache.
+//
+// The store is a single append-only segment file:
+//
+//   [file header][record][record]...
+//   record = [RecordHeader][key bytes][value bytes]
+//
+// The file is memory-mapped for reads. The index (key -> record offset) is
+// built lazily on first use by walking record headers only; values stay in
+// the mapping and are copied out on a hit. A later record for the same key
+// supersedes earlier ones. When an append would push the file past
+// |max_bytes|, the live records are rewritten newest-first into a fresh
+// segment at half the budget and the old one is replaced.
+//
+// The store performs blocking file IO and is not thread-safe; use it from a
+// single sequence that allows blocking.
+class PersistentResponseStore {
+ public:
+  struct Options {
+    // Path of the segment file
+    base::FilePath path;
+
+    // Upper bound on the segment file size
+    size_t max_bytes = 64 * 1024 * 1024;
+
+    // Records older than this are treated as absent and dropped on
+    // compaction
+    base::TimeDelta time_to_live = base::Days(7);
+  };
+
+  explicit PersistentResponseStore(const Options& options);
+  ~PersistentResponseStore();
+
+  PersistentResponseStore(const PersistentResponseStore&) = delete;
+  PersistentResponseStore& operator=(const PersistentResponseStore&) = delete;
+
+  // Look up |key|. Returns false if absent, expired or unreadable. On a hit
+  // |write_time|, if given, is set to when the record was stored.
+  bool Get(const std::string& key,
+           std::string* value,
+           base::Time* write_time = nullptr);
+
+  // Append |value| under |key|.
+  bool Put(const std::string& key, const std::string& value);
+
+  // Drop every record and truncate the segment file.
+  void Clear();
+
+  // Change the TTL applied to lookups and compaction.
+  void SetTimeToLive(base::TimeDelta time_to_live);
+
+  // Number of live keys in the index
+  size_t GetEntryCount();
+
+  // Current size of the segment file in bytes
+  size_t GetFileSize() const { return file_size_; }
+
+ private:
+  struct IndexEntry {
+    uint64_t offset;  // Offset of the value bytes
+    uint32_t value_size;
+    uint32_t checksum;  // base::PersistentHash() of the value bytes
+    int64_t write_time_us;  // base::Time in microseconds since Windows epoch
+  };
+
+  // Open the segment and build |index_| from record headers.
+  bool EnsureLoaded();
+
+  // Rebuild the read mapping so it covers the whole file.
+  bool Remap();
+
+  // Rewrite live, unexpired records into a fresh segment of at most
+  // |target_bytes|.
+  bool Compact(size_t target_bytes);
+
+  // Write the header of an empty segment to |file|.
+  static bool WriteFileHeader(base::File* file);
+
+  // Append one record to |file| at |offset|.
+  static bool WriteRecord(base::File* file,
+                          uint64_t offset,
+                          const std::string& key,
+                          const char* value,
+                          uint32_t value_size,
+                          uint32_t checksum,
+                          int64_t write_time_us);
+
+  bool IsExpired(const IndexEntry& entry, base::Time now) const;
+
+  Options options_;
+  bool loaded_ = false;
+  bool load_failed_ = false;
+
+  base::File file_;
+  std::unique_ptr<base::MemoryMappedFile> mapping_;
+  uint64_t file_size_ = 0;
+
+  std::unordered_map<std::string, IndexEntry> index_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_PERSISTENT_RESPONSE_STORE_H_
@@ -0,0 +1,98 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/persistent_response_store.h"
+
+#include <memory>
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/string_number_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+class PersistentResponseStoreTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  std::unique_ptr<PersistentResponseStore> CreateStore(
+      size_t max_bytes = 64 * 1024) {
+    PersistentResponseStore::Options options;
+    options.path = GetPath();
+    options.max_bytes = max_bytes;
+    return std::make_unique<PersistentResponseStore>(options);
+  }
+
+  base::FilePath GetPath() const {
+    return temp_dir_.GetPath().AppendASCII("responses.cache");
+  }
+
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(PersistentResponseStoreTest, ValuesSurviveReopen) {
+  {
+    auto store = CreateStore();
+    EXPECT_TRUE(store->Put("key1", "first"));
+    EXPECT_TRUE(store->Put("key2", "second"));
+    EXPECT_TRUE(store->Put("key1", "updated"));
+  }
+
+  auto store = CreateStore();
+  std::string value;
+  ASSERT_TRUE(store->Get("key1", &value));
+  EXPECT_EQ(value, "updated");
+  ASSERT_TRUE(store->Get("key2", &value));
+  EXPECT_EQ(value, "second");
+  EXPECT_FALSE(store->Get("missing", &value));
+  EXPECT_EQ(store->GetEntryCount(), 2u);
+}
+
+TEST_F(PersistentResponseStoreTest, ExpiredValuesAreIgnored) {
+  auto store = CreateStore();
+  ASSERT_TRUE(store->Put("key", "value"));
+  store->SetTimeToLive(base::Seconds(-1));
+
+  std::string value;
+  EXPECT_FALSE(store->Get("key", &value));
+}
+
+TEST_F(PersistentResponseStoreTest, CompactionKeepsFileWithinBudget) {
+  constexpr size_t kMaxBytes = 4096;
+  auto store = CreateStore(kMaxBytes);
+  std::string payload(100, 'x');
+  for (int i = 0; i < 200; ++i) {
+    ASSERT_TRUE(store->Put("key" + base::NumberToString(i), payload));
+    EXPECT_LE(store->GetFileSize(), kMaxBytes);
+  }
+
+  // The newest record always survives compaction
+  std::string value;
+  EXPECT_TRUE(store->Get("key199", &value));
+  EXPECT_FALSE(store->Get("key0", &value));
+}
+
+TEST_F(PersistentResponseStoreTest, RecoversFromTornTail) {
+  {
+    auto store = CreateStore();
+    ASSERT_TRUE(store->Put("key", "value"));
+  }
+  ASSERT_TRUE(base::AppendToFile(GetPath(), "garbage"));
+
+  auto store = CreateStore();
+  std::string value;
+  ASSERT_TRUE(store->Get("key", &value));
+  EXPECT_EQ(value, "value");
+  EXPECT_TRUE(store->Put("other", "value2"));
+  ASSERT_TRUE(store->Get("other", &value));
+  EXPECT_EQ(value, "value2");
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,120 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/pii_placeholder_map.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "base/strings/string_number_conversions.h"
+
+namespace asol {
+namespace core {
+
+PiiPlaceholderMap::PiiPlaceholderMap() = default;
+PiiPlaceholderMap::~PiiPlaceholderMap() = default;
+
+const std::string& PiiPlaceholderMap::Add(std::string_view label,
+                                          std::string_view entity) {
+  std::string key(label);
+  key += '\0';
+  key += entity;
+  auto [it, inserted] = placeholders_.try_emplace(std::move(key));
+  if (!inserted) {
+    return it->second;
+  }
+
+  // "[EMAIL]" becomes "[EMAIL_1]", "[EMAIL_2]", ...
+  std::string_view stem = label;
+  if (stem.size() >= 2 && stem.front() == '[' && stem.back() == ']') {
+    stem = stem.substr(1, stem.size() - 2);
+  }
+  std::string suffix = "_" + base::NumberToString(++label_counts_[label]) + "]";
+  stem = stem.substr(0, kMaxPlaceholderLength - 1 - suffix.size());
+  std::string placeholder = "[";
+  placeholder += stem;
+  placeholder += suffix;
+
+  entities_.emplace(placeholder, entity);
+  it->second = std::move(placeholder);
+  return it->second;
+}
+
+std::string PiiPlaceholderMap::Rehydrate(std::string_view text) const {
+  std::string output;
+  output.reserve(text.size());
+  RehydrateTo(text, /*at_end=*/true, &output);
+  return output;
+}
+
+size_t PiiPlaceholderMap::RehydrateTo(std::string_view text,
+                                      bool at_end,
+                                      std::string* output) const {
+  size_t copied = 0;
+  size_t position = 0;
+  while (position < text.size()) {
+    const void* found =
+        memchr(text.data() + position, '[', text.size() - position);
+    if (!found) {
+      break;
+    }
+    size_t open = static_cast<const char*>(found) - text.data();
+    // Only look as far as the longest placeholder, so the scan stays
+    // linear whatever the text
+    size_t limit = std::min(text.size(), open + kMaxPlaceholderLength);
+    std::string_view window = text.substr(open, limit - open);
+    size_t close = window.find(']', 1);
+    if (close == std::string_view::npos) {
+      if (!at_end && limit == text.size() &&
+          window.find('[', 1) == std::string_view::npos) {
+        // May be a placeholder the next chunk completes
+        output->append(text.substr(copied, open - copied));
+        return text.size() - open;
+      }
+      position = open + 1;
+      continue;
+    }
+
+    auto it = entities_.find(std::string(window.substr(0, close + 1)));
+    if (it == entities_.end()) {
+      // A placeholder may still start inside, as in "[[EMAIL_1]"
+      position = open + 1;
+      continue;
+    }
+    output->append(text.substr(copied, open - copied));
+    output->append(it->second);
+    copied = open + close + 1;
+    position = copied;
+  }
+  output->append(text.substr(copied));
+  return 0;
+}
+
+PiiPlaceholderMap::StreamRehydrator::StreamRehydrator(
+    scoped_refptr<const PiiPlaceholderMap> map)
+    : map_(std::move(map)) {}
+
+PiiPlaceholderMap::StreamRehydrator::~StreamRehydrator() = default;
+
+void PiiPlaceholderMap::StreamRehydrator::Append(std::string_view chunk,
+                                                 std::string* output) {
+  std::string_view text = chunk;
+  std::string joined;
+  if (!pending_.empty()) {
+    joined = std::move(pending_);
+    joined.append(chunk);
+    text = joined;
+  }
+  size_t held_back = map_->RehydrateTo(text, /*at_end=*/false, output);
+  pending_.assign(text.substr(text.size() - held_back));
+}
+
+void PiiPlaceholderMap::StreamRehydrator::Finish(std::string* output) {
+  map_->RehydrateTo(pending_, /*at_end=*/true, output);
+  pending_.clear();
+}
+
+}  // namespace core
+}  // namespace asol
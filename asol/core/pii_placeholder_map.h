@@ -0,0 +1,92 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_PII_PLACEHOLDER_MAP_H_
+#define ASOL_CORE_PII_PLACEHOLDER_MAP_H_
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "base/memory/ref_counted.h"
+
+namespace asol {
+namespace core {
+
+// PiiPlaceholderMap records the entities a reversible redaction swapped for
+// placeholders, so the model's answer can be given back with the real
+// values. Placeholders are short and stable within one request: the same
+// entity always becomes the same "[EMAIL_1]", which lets the model refer
+// to it consistently.
+//
+// One map belongs to one request. It is filled on the redaction worker and
+// only read afterwards, from any thread.
+class PiiPlaceholderMap : public base::RefCountedThreadSafe<PiiPlaceholderMap> {
+ public:
+  // Placeholders are never longer than this
+  static constexpr size_t kMaxPlaceholderLength = 48;
+
+  PiiPlaceholderMap();
+
+  PiiPlaceholderMap(const PiiPlaceholderMap&) = delete;
+  PiiPlaceholderMap& operator=(const PiiPlaceholderMap&) = delete;
+
+  // Return the placeholder for |entity|, creating one from |label| (a
+  // redaction replacement such as "[EMAIL]") on first sight.
+  const std::string& Add(std::string_view label, std::string_view entity);
+
+  // Replace every known placeholder in |text| with its entity, in one scan.
+  std::string Rehydrate(std::string_view text) const;
+
+  size_t size() const { return entities_.size(); }
+
+  // Rehydrates output that arrives in pieces. A placeholder split across
+  // pieces is held back until the piece that completes it.
+  class StreamRehydrator {
+   public:
+    explicit StreamRehydrator(scoped_refptr<const PiiPlaceholderMap> map);
+    ~StreamRehydrator();
+
+    StreamRehydrator(const StreamRehydrator&) = delete;
+    StreamRehydrator& operator=(const StreamRehydrator&) = delete;
+
+    // Append the rehydrated form of |chunk| to |output|, minus any trailing
+    // text that may be the start of a placeholder.
+    void Append(std::string_view chunk, std::string* output);
+
+    // Append whatever was held back.
+    void Finish(std::string* output);
+
+   private:
+    scoped_refptr<const PiiPlaceholderMap> map_;
+    std::string pending_;
+  };
+
+ private:
+  friend class base::RefCountedThreadSafe<PiiPlaceholderMap>;
+
+  ~PiiPlaceholderMap();
+
+  // Rehydrate |text| into |output|. Returns the length of a trailing
+  // prefix that may be a placeholder cut short and was not written, which
+  // is always zero when |at_end| is true.
+  size_t RehydrateTo(std::string_view text,
+                     bool at_end,
+                     std::string* output) const;
+
+  // Entity -> placeholder, keyed by label and entity so equal text in two
+  // categories stays distinct
+  std::unordered_map<std::string, std::string> placeholders_;
+
+  // Placeholder -> entity
+  std::unordered_map<std::string, std::string> entities_;
+
+  // Placeholders issued per label
+  std::unordered_map<std::string, int> label_counts_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_PII_PLACEHOLDER_MAP_H_
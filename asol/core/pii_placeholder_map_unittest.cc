@@ -0,0 +1,66 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/pii_placeholder_map.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+TEST(PiiPlaceholderMapTest, SameEntityGetsSamePlaceholder) {
+  auto map = base::MakeRefCounted<PiiPlaceholderMap>();
+  EXPECT_EQ(map->Add("[EMAIL]", "a@b.io"), "[EMAIL_1]");
+  EXPECT_EQ(map->Add("[EMAIL]", "c@d.io"), "[EMAIL_2]");
+  EXPECT_EQ(map->Add("[EMAIL]", "a@b.io"), "[EMAIL_1]");
+  EXPECT_EQ(map->Add("[PHONE]", "555-1234"), "[PHONE_1]");
+  EXPECT_EQ(map->size(), 3u);
+}
+
+TEST(PiiPlaceholderMapTest, RehydratesKnownPlaceholdersOnly) {
+  auto map = base::MakeRefCounted<PiiPlaceholderMap>();
+  map->Add("[EMAIL]", "a@b.io");
+  map->Add("[NAME]", "Dr. Jane Smith");
+  EXPECT_EQ(map->Rehydrate("[NAME_1] wrote from [EMAIL_1]; [EMAIL_9] and "
+                           "[note] stay, [[EMAIL_1]] too ["),
+            "Dr. Jane Smith wrote from a@b.io; [EMAIL_9] and [note] stay, "
+            "[a@b.io] too [");
+}
+
+TEST(PiiPlaceholderMapTest, StreamRehydratesPlaceholdersSplitAcrossChunks) {
+  auto map = base::MakeRefCounted<PiiPlaceholderMap>();
+  map->Add("[EMAIL]", "a@b.io");
+  std::string text = "Reply to [EMAIL_1] or [x] [EMAIL_1], [EMAIL_1";
+  std::string expected = "Reply to a@b.io or [x] a@b.io, [EMAIL_1";
+
+  // Every way of cutting the text in two gives the same output
+  for (size_t cut = 0; cut <= text.size(); ++cut) {
+    PiiPlaceholderMap::StreamRehydrator rehydrator(map);
+    std::string output;
+    rehydrator.Append(std::string_view(text).substr(0, cut), &output);
+    rehydrator.Append(std::string_view(text).substr(cut), &output);
+    rehydrator.Finish(&output);
+    EXPECT_EQ(output, expected) << "cut at " << cut;
+  }
+}
+
+TEST(PiiPlaceholderMapTest, StreamHoldsBackOnlyPossiblePlaceholders) {
+  auto map = base::MakeRefCounted<PiiPlaceholderMap>();
+  map->Add("[EMAIL]", "a@b.io");
+  PiiPlaceholderMap::StreamRehydrator rehydrator(map);
+  std::string output;
+  rehydrator.Append("plain text, then [EMA", &output);
+  EXPECT_EQ(output, "plain text, then ");
+  rehydrator.Append("IL_1] and more", &output);
+  EXPECT_EQ(output, "plain text, then a@b.io and more");
+  rehydrator.Finish(&output);
+  EXPECT_EQ(output, "plain text, then a@b.io and more");
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
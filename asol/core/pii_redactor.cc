@@ -0,0 +1,160 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/pii_redactor.h"
+
+#include <utility>
+
+#include "asol/core/pii_placeholder_map.h"
+#include "base/logging.h"
+#include "third_party/re2/src/re2/re2.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// The combined automaton grows with the rules; the RE2 default of 8 MiB
+// runs out with large dictionaries and falls back to the slow NFA
+constexpr int64_t kMatcherMaxMemory = 32 * 1024 * 1024;
+
+re2::RE2::Options MatcherOptions() {
+  re2::RE2::Options options;
+  options.set_max_mem(kMatcherMaxMemory);
+  options.set_log_errors(false);
+  return options;
+}
+
+}  // namespace
+
+// static
+scoped_refptr<PiiRedactor> PiiRedactor::Create(std::vector<Rule> rules) {
+  scoped_refptr<PiiRedactor> redactor =
+      base::WrapRefCounted(new PiiRedactor());
+
+  std::string combined;
+  int next_group = 1;
+  for (Rule& rule : rules) {
+    // Validate on its own first, so one bad custom pattern cannot disable
+    // every other rule
+    re2::RE2 single(rule.pattern, MatcherOptions());
+    if (!single.ok()) {
+      LOG(ERROR) << "Skipping redaction rule " << rule.category << ": "
+                 << single.error();
+      continue;
+    }
+    if (!combined.empty()) {
+      combined += '|';
+    }
+    combined += '(';
+    combined += rule.pattern;
+    combined += ')';
+    redactor->rule_groups_.push_back(next_group);
+    next_group += 1 + single.NumberOfCapturingGroups();
+    redactor->rules_.push_back(std::move(rule));
+  }
+  if (redactor->rules_.empty()) {
+    return redactor;
+  }
+
+  auto matcher = std::make_unique<re2::RE2>(combined, MatcherOptions());
+  if (!matcher->ok()) {
+    LOG(ERROR) << "Failed to compile redaction rules: " << matcher->error();
+    redactor->rules_.clear();
+    redactor->rule_groups_.clear();
+    return redactor;
+  }
+  redactor->group_count_ = matcher->NumberOfCapturingGroups();
+  redactor->matcher_ = std::move(matcher);
+  return redactor;
+}
+
+PiiRedactor::PiiRedactor() = default;
+PiiRedactor::~PiiRedactor() = default;
+
+PiiRedactor::Result PiiRedactor::Redact(std::string_view text) const {
+  Result result;
+  result.text.reserve(text.size());
+  RedactTo(text, &result);
+  return result;
+}
+
+void PiiRedactor::RedactTo(std::string_view text, Result* result) const {
+  RedactToImpl(text, nullptr, result);
+}
+
+void PiiRedactor::RedactReversiblyTo(std::string_view text,
+                                     PiiPlaceholderMap* placeholders,
+                                     Result* result) const {
+  RedactToImpl(text, placeholders, result);
+}
+
+void PiiRedactor::RedactToImpl(std::string_view text,
+                               PiiPlaceholderMap* placeholders,
+                               Result* result) const {
+  if (!matcher_) {
+    result->text.append(text);
+    return;
+  }
+
+  std::vector<std::string_view> groups(group_count_ + 1);
+  size_t position = 0;
+  size_t copied = 0;
+  Match match;
+  while (FindNext(text, &position, text.size(), &groups, &match)) {
+    result->text.append(text.substr(copied, match.start - copied));
+    AppendReplacement(text, match, placeholders, result);
+    copied = match.end;
+  }
+  result->text.append(text.substr(copied));
+}
+
+void PiiRedactor::AppendReplacement(std::string_view text,
+                                    const Match& match,
+                                    PiiPlaceholderMap* placeholders,
+                                    Result* result) const {
+  const Rule& rule = rules_[match.rule];
+  if (placeholders) {
+    result->text += placeholders->Add(
+        rule.replacement, text.substr(match.start, match.end - match.start));
+  } else {
+    result->text += rule.replacement;
+  }
+  result->redaction_categories[rule.category]++;
+  result->num_redactions++;
+}
+
+bool PiiRedactor::FindNext(std::string_view text,
+                           size_t* position,
+                           size_t end,
+                           std::vector<std::string_view>* groups,
+                           Match* match) const {
+  // Group 0 is the whole match
+  while (*position < end &&
+         matcher_->Match(text, *position, end, re2::RE2::UNANCHORED,
+                         groups->data(), static_cast<int>(groups->size()))) {
+    size_t match_start = (*groups)[0].data() - text.data();
+    size_t match_end = match_start + (*groups)[0].size();
+    if (match_end == match_start) {
+      // A rule matched the empty string; step past it
+      *position = match_start + 1;
+      continue;
+    }
+
+    size_t rule = 0;
+    while (rule + 1 < rules_.size() &&
+           (*groups)[rule_groups_[rule]].data() == nullptr) {
+      ++rule;
+    }
+    match->start = match_start;
+    match->end = match_end;
+    match->rule = rule;
+    *position = match_end;
+    return true;
+  }
+  return false;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,125 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_PII_REDACTOR_H_
+#define ASOL_CORE_PII_REDACTOR_H_
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
+
+namespace re2 {
+class RE2;
+}
+
+namespace asol {
+namespace core {
+
+class PiiPlaceholderMap;
+
+// PiiRedactor finds the matches of every redaction rule in one pass over
+// the text and writes the redacted output once.
+//
+// The rules are compiled into a single RE2 alternation with one capturing
+// group per rule, so the scan runs on one DFA whatever the number of rules,
+// and the group that took part in a match names its rule. Dictionary rules
+// (lists of literal terms) are plain alternations, which RE2 compiles into
+// the same automaton. Where rules overlap, the match that starts first
+// wins; at the same position, the rule listed first does.
+//
+// A redactor is immutable once created and may be used from any thread.
+class PiiRedactor : public base::RefCountedThreadSafe<PiiRedactor> {
+ public:
+  struct Rule {
+    // Key counted in Result::redaction_categories
+    std::string category;
+
+    // RE2 syntax. Capturing groups are allowed.
+    std::string pattern;
+
+    // Written in place of each match
+    std::string replacement;
+  };
+
+  struct Result {
+    std::string text;
+    int num_redactions = 0;
+    std::unordered_map<std::string, int> redaction_categories;
+  };
+
+  // Compile |rules| into one matcher. Rules that do not compile are logged
+  // and skipped.
+  static scoped_refptr<PiiRedactor> Create(std::vector<Rule> rules);
+
+  PiiRedactor(const PiiRedactor&) = delete;
+  PiiRedactor& operator=(const PiiRedactor&) = delete;
+
+  // Replace every match in |text|.
+  Result Redact(std::string_view text) const;
+
+  // Like Redact(), but appends to |result| instead of replacing it, for
+  // callers that redact a document piecewise.
+  void RedactTo(std::string_view text, Result* result) const;
+
+  // Like RedactTo(), but each match becomes a numbered placeholder recorded
+  // in |placeholders|, so the text can be restored later.
+  void RedactReversiblyTo(std::string_view text,
+                          PiiPlaceholderMap* placeholders,
+                          Result* result) const;
+
+  size_t rule_count() const { return rules_.size(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<PiiRedactor>;
+
+  struct Match {
+    size_t start = 0;
+    size_t end = 0;
+    size_t rule = 0;  // Index into |rules_|
+  };
+
+  PiiRedactor();
+  ~PiiRedactor();
+
+  // Shared by RedactTo() and RedactReversiblyTo(); |placeholders| may be
+  // null.
+  void RedactToImpl(std::string_view text,
+                    PiiPlaceholderMap* placeholders,
+                    Result* result) const;
+
+  // Append the replacement for |match| to |result| and count it. With
+  // |placeholders|, the replacement is the entity's placeholder.
+  void AppendReplacement(std::string_view text,
+                         const Match& match,
+                         PiiPlaceholderMap* placeholders,
+                         Result* result) const;
+
+  // Find the next non-empty match in text[*position, end) and advance
+  // |position| past it. |groups| is scratch space for the submatches.
+  bool FindNext(std::string_view text,
+                size_t* position,
+                size_t end,
+                std::vector<std::string_view>* groups,
+                Match* match) const;
+
+  // Rules that compiled, in priority order
+  std::vector<Rule> rules_;
+
+  // Index of the capturing group that wraps each rule in |matcher_|
+  std::vector<int> rule_groups_;
+  int group_count_ = 0;
+
+  // Null if no rule compiled
+  std::unique_ptr<re2::RE2> matcher_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_PII_REDACTOR_H_
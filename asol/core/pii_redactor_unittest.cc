@@ -0,0 +1,83 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/pii_redactor.h"
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+scoped_refptr<PiiRedactor> CreateRedactor() {
+  return PiiRedactor::Create({
+      {"email", R"([a-z]+@[a-z]+\.com)", "[EMAIL]"},
+      {"digits", R"((\d)(\d)+)", "[DIGITS]"},
+      {"word", R"(\b(?i:secret|hidden)\b)", "[WORD]"},
+  });
+}
+
+TEST(PiiRedactorTest, RedactsEveryRuleInOnePass) {
+  PiiRedactor::Result result =
+      CreateRedactor()->Redact("Mail bob@example.com the SECRET code 1234.");
+  EXPECT_EQ(result.text, "Mail [EMAIL] the [WORD] code [DIGITS].");
+  EXPECT_EQ(result.num_redactions, 3);
+  EXPECT_EQ(result.redaction_categories["email"], 1);
+  EXPECT_EQ(result.redaction_categories["digits"], 1);
+  EXPECT_EQ(result.redaction_categories["word"], 1);
+}
+
+TEST(PiiRedactorTest, CapturingGroupsInRulesDoNotShiftLaterRules) {
+  // "digits" has two groups of its own; "word" must still be identified
+  PiiRedactor::Result result = CreateRedactor()->Redact("hidden 42 hidden");
+  EXPECT_EQ(result.text, "[WORD] [DIGITS] [WORD]");
+  EXPECT_EQ(result.redaction_categories["word"], 2);
+}
+
+TEST(PiiRedactorTest, FirstRuleWinsAtTheSamePosition) {
+  scoped_refptr<PiiRedactor> redactor = PiiRedactor::Create({
+      {"card", R"(\d{4} \d{4})", "[CARD]"},
+      {"number", R"(\d+)", "[NUMBER]"},
+  });
+  EXPECT_EQ(redactor->Redact("1234 5678 and 99").text,
+            "[CARD] and [NUMBER]");
+}
+
+TEST(PiiRedactorTest, InvalidRuleIsSkipped) {
+  scoped_refptr<PiiRedactor> redactor = PiiRedactor::Create({
+      {"broken", "(unclosed", "[X]"},
+      {"word", "secret", "[WORD]"},
+  });
+  EXPECT_EQ(redactor->rule_count(), 1u);
+  EXPECT_EQ(redactor->Redact("a secret").text, "a [WORD]");
+}
+
+TEST(PiiRedactorTest, EmptyMatchesAreSkipped) {
+  scoped_refptr<PiiRedactor> redactor =
+      PiiRedactor::Create({{"maybe", "x*", "[X]"}});
+  EXPECT_EQ(redactor->Redact("abxxc").text, "ab[X]c");
+}
+
+TEST(PiiRedactorTest, RedactToAppends) {
+  scoped_refptr<PiiRedactor> redactor = CreateRedactor();
+  PiiRedactor::Result result;
+  redactor->RedactTo("secret ", &result);
+  redactor->RedactTo("and 12", &result);
+  EXPECT_EQ(result.text, "[WORD] and [DIGITS]");
+  EXPECT_EQ(result.num_redactions, 2);
+}
+
+TEST(PiiRedactorTest, NoRules) {
+  scoped_refptr<PiiRedactor> redactor = PiiRedactor::Create({});
+  PiiRedactor::Result result = redactor->Redact("bob@example.com");
+  EXPECT_EQ(result.text, "bob@example.com");
+  EXPECT_EQ(result.num_redactions, 0);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
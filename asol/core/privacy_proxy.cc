@@ -0,0 +1,529 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/privacy_proxy.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/task/thread_pool.h"
+#include "base/trace_event/trace_event.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Terms that reveal a health condition. Matched case-insensitively on word
+// boundaries; the alternation compiles into the shared automaton.
+constexpr const char* kHealthTerms[] = {
+    "diabetes",   "diabetic",      "cancer",       "chemotherapy",
+    "hiv",        "aids",          "depression",   "anxiety disorder",
+    "bipolar",    "schizophrenia", "pregnant",     "pregnancy",
+    "asthma",     "epilepsy",      "dementia",     "alzheimer's",
+    "prescription", "diagnosis",   "diagnosed",    "insulin",
+    "antidepressant", "therapy session", "rehab",  "hepatitis",
+};
+
+std::string JoinAlternatives(const char* const* terms, size_t count) {
+  std::string alternatives;
+  for (size_t i = 0; i < count; ++i) {
+    if (i > 0) {
+      alternatives += '|';
+    }
+    alternatives += terms[i];
+  }
+  return alternatives;
+}
+
+// Large inputs are split into chunks of about this size, at paragraph
+// breaks, and redacted on several workers
+constexpr size_t kRedactionChunkBytes = 32 * 1024;
+
+// Paragraphs shorter than this are redacted directly; hashing and locking
+// would cost about as much as redacting them
+constexpr size_t kMinCachedParagraphBytes = 64;
+
+// Upper bound on the redacted paragraphs kept for reuse
+constexpr size_t kRedactionCacheBytes = 8 * 1024 * 1024;
+
+// End of the paragraph that starts at |begin|: just past the blank line
+// that closes it, or the end of the text. Matches never span a paragraph
+// break, so each paragraph redacts the same wherever it appears.
+size_t ParagraphEnd(std::string_view text, size_t begin) {
+  size_t separator = text.find("\n\n", begin);
+  if (separator == std::string_view::npos) {
+    return text.size();
+  }
+  size_t end = separator + 2;
+  while (end < text.size() && text[end] == '\n') {
+    ++end;
+  }
+  return end;
+}
+
+void AppendResult(const PiiRedactor::Result& from, PiiRedactor::Result* to) {
+  to->text += from.text;
+  to->num_redactions += from.num_redactions;
+  for (const auto& [category, count] : from.redaction_categories) {
+    to->redaction_categories[category] += count;
+  }
+}
+
+// Redact |text| paragraph by paragraph, reusing and filling |cache|
+void RedactParagraphs(const PiiRedactor& redactor,
+                      RedactionCache* cache,
+                      uint64_t rules_version,
+                      std::string_view text,
+                      PiiRedactor::Result* result) {
+  for (size_t begin = 0; begin < text.size();) {
+    size_t end = ParagraphEnd(text, begin);
+    std::string_view paragraph = text.substr(begin, end - begin);
+    begin = end;
+    if (paragraph.size() < kMinCachedParagraphBytes) {
+      redactor.RedactTo(paragraph, result);
+      continue;
+    }
+
+    RequestFingerprint key =
+        RedactionCache::ComputeKey(rules_version, paragraph);
+    if (cache->AppendTo(key, rules_version, paragraph, result)) {
+      continue;
+    }
+    PiiRedactor::Result redacted;
+    redactor.RedactTo(paragraph, &redacted);
+    cache->Put(key, rules_version, paragraph, redacted);
+    AppendResult(redacted, result);
+  }
+}
+
+// Chunk i spans [boundaries[i], boundaries[i + 1]); every boundary is a
+// paragraph break, so chunks redact independently
+std::vector<size_t> ChunkBoundaries(std::string_view text) {
+  std::vector<size_t> boundaries = {0};
+  for (size_t position = 0; position < text.size();) {
+    position = ParagraphEnd(text, position);
+    if (position - boundaries.back() >= kRedactionChunkBytes ||
+        position == text.size()) {
+      boundaries.push_back(position);
+    }
+  }
+  if (boundaries.size() == 1) {
+    boundaries.push_back(text.size());
+  }
+  return boundaries;
+}
+
+// Runs on a worker
+PiiRedactor::Result RedactChunk(scoped_refptr<PiiRedactor> redactor,
+                                scoped_refptr<RedactionCache> cache,
+                                uint64_t rules_version,
+                                SharedText text,
+                                size_t begin,
+                                size_t end) {
+  TRACE_EVENT1("asol", "PrivacyProxy::RedactChunk", "bytes", end - begin);
+  PiiRedactor::Result result;
+  result.text.reserve(end - begin);
+  RedactParagraphs(*redactor, cache.get(), rules_version,
+                   text.view().substr(begin, end - begin),
+                   &result);
+  return result;
+}
+
+// Text without PII comes back as |input| itself rather than as the
+// redactor's copy of it
+PrivacyProxy::ProcessingResult ToProcessingResult(PiiRedactor::Result redacted,
+                                                  const SharedText& input) {
+  PrivacyProxy::ProcessingResult result;
+  result.was_modified = redacted.num_redactions > 0;
+  result.num_redactions = redacted.num_redactions;
+  result.redaction_categories = std::move(redacted.redaction_categories);
+  if (result.was_modified || redacted.text.empty()) {
+    result.processed_text = std::move(redacted.text);
+  } else {
+    DCHECK_EQ(redacted.text, input.view());
+    result.processed_text = input;
+  }
+  return result;
+}
+
+PrivacyProxy::ProcessingResult RedactWith(scoped_refptr<PiiRedactor> redactor,
+                                          scoped_refptr<RedactionCache> cache,
+                                          uint64_t rules_version,
+                                          const SharedText& input_text) {
+  TRACE_EVENT1("asol", "PrivacyProxy::Redact", "bytes", input_text.size());
+  PiiRedactor::Result redacted;
+  redacted.text.reserve(input_text.size());
+  RedactParagraphs(*redactor, cache.get(), rules_version, input_text,
+                   &redacted);
+  return ToProcessingResult(std::move(redacted), input_text);
+}
+
+// Placeholders are numbered in document order, so the input is redacted
+// in one piece
+PrivacyProxy::ProcessingResult RedactReversibly(
+    scoped_refptr<PiiRedactor> redactor,
+    const SharedText& input_text) {
+  TRACE_EVENT1("asol", "PrivacyProxy::RedactReversibly", "bytes",
+               input_text.size());
+  auto placeholders = base::MakeRefCounted<PiiPlaceholderMap>();
+  PiiRedactor::Result redacted;
+  redacted.text.reserve(input_text.size());
+  redactor->RedactReversiblyTo(input_text, placeholders.get(), &redacted);
+  PrivacyProxy::ProcessingResult result =
+      ToProcessingResult(std::move(redacted), input_text);
+  result.placeholders = std::move(placeholders);
+  return result;
+}
+
+// Ends |span| when the result is delivered, so the span covers the time
+// spent queued for a worker as well as redacting
+PrivacyProxy::ProcessingCallback EndSpanOnReply(
+    TraceSpan span,
+    PrivacyProxy::ProcessingCallback callback) {
+  return base::BindOnce(
+      [](TraceSpan span, PrivacyProxy::ProcessingCallback callback,
+         const PrivacyProxy::ProcessingResult& result) {
+        span.End();
+        std::move(callback).Run(result);
+      },
+      std::move(span), std::move(callback));
+}
+
+// Hands a reversible result to a streaming consumer: the output is one
+// chunk, followed by the counts
+void DeliverAsStream(PrivacyProxy::ChunkCallback chunk_callback,
+                     PrivacyProxy::ProcessingCallback callback,
+                     PrivacyProxy::ProcessingResult result) {
+  if (!result.processed_text.empty()) {
+    chunk_callback.Run(result.processed_text);
+  }
+  result.processed_text = SharedText();
+  std::move(callback).Run(result);
+}
+
+// Redacts one input in chunks on the thread pool and passes the chunks on
+// in order on the sequence that started it.
+class ChunkedRedaction : public base::RefCounted<ChunkedRedaction> {
+ public:
+  // Without a |chunk_callback|, the output is collected into the result
+  ChunkedRedaction(scoped_refptr<PiiRedactor> redactor,
+                   scoped_refptr<RedactionCache> cache,
+                   uint64_t rules_version,
+                   SharedText text,
+                   PrivacyProxy::ChunkCallback chunk_callback,
+                   PrivacyProxy::ProcessingCallback callback)
+      : redactor_(std::move(redactor)),
+        cache_(std::move(cache)),
+        rules_version_(rules_version),
+        text_(std::move(text)),
+        boundaries_(ChunkBoundaries(text_)),
+        chunk_results_(boundaries_.size() - 1),
+        chunk_callback_(std::move(chunk_callback)),
+        callback_(std::move(callback)) {}
+
+  ChunkedRedaction(const ChunkedRedaction&) = delete;
+  ChunkedRedaction& operator=(const ChunkedRedaction&) = delete;
+
+  void Start() {
+    if (!chunk_callback_) {
+      result_.text.reserve(text_->size());
+    }
+    for (size_t i = 0; i < chunk_results_.size(); ++i) {
+      base::ThreadPool::PostTaskAndReplyWithResult(
+          FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+          base::BindOnce(&RedactChunk, redactor_, cache_, rules_version_,
+                         text_, boundaries_[i], boundaries_[i + 1]),
+          base::BindOnce(&ChunkedRedaction::OnChunkRedacted,
+                         base::WrapRefCounted(this), i));
+    }
+  }
+
+ private:
+  friend class base::RefCounted<ChunkedRedaction>;
+
+  ~ChunkedRedaction() = default;
+
+  void OnChunkRedacted(size_t index, PiiRedactor::Result chunk) {
+    chunk_results_[index] = std::move(chunk);
+    while (next_chunk_ < chunk_results_.size() &&
+           chunk_results_[next_chunk_]) {
+      PiiRedactor::Result& ready = *chunk_results_[next_chunk_];
+      if (chunk_callback_) {
+        if (!ready.text.empty()) {
+          chunk_callback_.Run(ready.text);
+        }
+        ready.text.clear();
+      }
+      AppendResult(ready, &result_);
+      chunk_results_[next_chunk_].reset();
+      next_chunk_++;
+    }
+    if (next_chunk_ == chunk_results_.size()) {
+      // Streamed output was never collected, so there is nothing to share
+      std::move(callback_).Run(ToProcessingResult(
+          std::move(result_), chunk_callback_ ? SharedText() : text_));
+    }
+  }
+
+  const scoped_refptr<PiiRedactor> redactor_;
+  const scoped_refptr<RedactionCache> cache_;
+  const uint64_t rules_version_;
+  const SharedText text_;
+  const std::vector<size_t> boundaries_;
+
+  // Results of the chunks that finished out of order
+  std::vector<absl::optional<PiiRedactor::Result>> chunk_results_;
+  size_t next_chunk_ = 0;
+
+  PiiRedactor::Result result_;
+  PrivacyProxy::ChunkCallback chunk_callback_;
+  PrivacyProxy::ProcessingCallback callback_;
+};
+
+}  // namespace
+
+PrivacyProxy::PrivacyProxy()
+    : redaction_cache_(
+          base::MakeRefCounted<RedactionCache>(kRedactionCacheBytes)) {
+  UpdateRedactor();
+}
+
+PrivacyProxy::~PrivacyProxy() = default;
+
+bool PrivacyProxy::Initialize() {
+  UpdateRedactor();
+  return redactor_->rule_count() > 0;
+}
+
+void PrivacyProxy::ProcessText(SharedText input_text,
+                               ProcessingCallback callback,
+                               const TraceContext& trace) {
+  callback = EndSpanOnReply(TraceSpan("PrivacyProxy::ProcessText", trace),
+                            std::move(callback));
+  if (reversible_) {
+    base::ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+        base::BindOnce(&RedactReversibly, redactor_, std::move(input_text)),
+        std::move(callback));
+    return;
+  }
+  if (input_text.size() > 2 * kRedactionChunkBytes) {
+    base::MakeRefCounted<ChunkedRedaction>(
+        redactor_, redaction_cache_, GetRulesVersion(), std::move(input_text),
+        ChunkCallback(), std::move(callback))
+        ->Start();
+    return;
+  }
+
+  // The redactor is immutable, so the worker can use it while settings
+  // change here
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&RedactWith, redactor_, redaction_cache_,
+                     GetRulesVersion(), std::move(input_text)),
+      std::move(callback));
+}
+
+void PrivacyProxy::ProcessTextStreaming(SharedText input_text,
+                                        ChunkCallback chunk_callback,
+                                        ProcessingCallback callback,
+                                        const TraceContext& trace) {
+  DCHECK(chunk_callback);
+  callback =
+      EndSpanOnReply(TraceSpan("PrivacyProxy::ProcessTextStreaming", trace),
+                     std::move(callback));
+  if (reversible_) {
+    base::ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+        base::BindOnce(&RedactReversibly, redactor_, std::move(input_text)),
+        base::BindOnce(&DeliverAsStream, std::move(chunk_callback),
+                       std::move(callback)));
+    return;
+  }
+  base::MakeRefCounted<ChunkedRedaction>(
+      redactor_, redaction_cache_, GetRulesVersion(), std::move(input_text),
+      std::move(chunk_callback), std::move(callback))
+      ->Start();
+}
+
+PrivacyProxy::ProcessingResult PrivacyProxy::ProcessTextSync(
+    const SharedText& input_text) {
+  if (reversible_) {
+    return RedactReversibly(redactor_, input_text);
+  }
+  return RedactWith(redactor_, redaction_cache_, GetRulesVersion(),
+                    input_text);
+}
+
+void PrivacyProxy::SetPrivacyLevel(PrivacyLevel level) {
+  privacy_level_ = level;
+  UpdateRedactor();
+}
+
+PrivacyProxy::PrivacyLevel PrivacyProxy::GetPrivacyLevel() const {
+  return privacy_level_;
+}
+
+void PrivacyProxy::SetConsentSetting(const ConsentSetting& setting) {
+  consent_settings_[setting.category] = setting;
+  consent_version_++;
+  UpdateRedactor();
+}
+
+void PrivacyProxy::SetConsentSettings(
+    const std::vector<ConsentSetting>& settings) {
+  for (const auto& setting : settings) {
+    consent_settings_[setting.category] = setting;
+  }
+  consent_version_++;
+  UpdateRedactor();
+}
+
+PrivacyProxy::ConsentSetting PrivacyProxy::GetConsentSetting(
+    DataCategory category) const {
+  auto it = consent_settings_.find(category);
+  if (it != consent_settings_.end()) {
+    return it->second;
+  }
+  return ConsentSetting{category, false, std::string()};
+}
+
+std::vector<PrivacyProxy::ConsentSetting> PrivacyProxy::GetAllConsentSettings()
+    const {
+  std::vector<ConsentSetting> settings;
+  settings.reserve(consent_settings_.size());
+  for (const auto& [category, setting] : consent_settings_) {
+    settings.push_back(setting);
+  }
+  return settings;
+}
+
+void PrivacyProxy::AddCustomPattern(const std::string& pattern_name,
+                                    const std::string& regex_pattern) {
+  custom_patterns_[pattern_name] = regex_pattern;
+  consent_version_++;
+  UpdateRedactor();
+}
+
+void PrivacyProxy::RemoveCustomPattern(const std::string& pattern_name) {
+  if (custom_patterns_.erase(pattern_name) > 0) {
+    consent_version_++;
+    UpdateRedactor();
+  }
+}
+
+base::WeakPtr<PrivacyProxy> PrivacyProxy::GetWeakPtr() {
+  return weak_ptr_factory_.GetWeakPtr();
+}
+
+bool PrivacyProxy::ShouldRedactCategory(DataCategory category) const {
+  // Without consent, data of every category is redacted
+  auto it = consent_settings_.find(category);
+  return it == consent_settings_.end() || !it->second.allowed;
+}
+
+std::string PrivacyProxy::RedactPII(
+    const std::string& text,
+    std::unordered_map<std::string, int>* redaction_categories) {
+  ProcessingResult result =
+      RedactWith(redactor_, redaction_cache_, GetRulesVersion(), text);
+  for (const auto& [category, count] : result.redaction_categories) {
+    (*redaction_categories)[category] += count;
+  }
+  return std::move(result.processed_text);
+}
+
+uint64_t PrivacyProxy::GetRulesVersion() const {
+  // Switching back to an earlier level reuses what was cached under it
+  return consent_version_ * 4 + static_cast<uint64_t>(privacy_level_);
+}
+
+void PrivacyProxy::UpdateRedactor() {
+  redactor_ = PiiRedactor::Create(BuildRedactionRules());
+}
+
+std::vector<PiiRedactor::Rule> PrivacyProxy::BuildRedactionRules() const {
+  const bool standard = privacy_level_ != PrivacyLevel::MINIMAL;
+  const bool strict = privacy_level_ == PrivacyLevel::STRICT ||
+                      privacy_level_ == PrivacyLevel::MAXIMUM;
+  const bool maximum = privacy_level_ == PrivacyLevel::MAXIMUM;
+
+  // More specific rules come first: at the same position, the first rule
+  // listed wins
+  std::vector<PiiRedactor::Rule> rules;
+  if (ShouldRedactCategory(DataCategory::PERSONAL_INFO)) {
+    rules.push_back({"email",
+                     R"([A-Za-z0-9._%+-]+@[A-Za-z0-9.-]+\.[A-Za-z]{2,})",
+                     "[EMAIL]"});
+  }
+  if (standard && ShouldRedactCategory(DataCategory::FINANCIAL_DATA)) {
+    rules.push_back({"financial",
+                     R"(\b(?:\d{4}[ -]?){3}\d{4}\b|\b\d{3}-\d{2}-\d{4}\b|)"
+                     R"(\b[A-Z]{2}\d{2}(?: ?[A-Z0-9]{4}){3,7}\b)",
+                     "[FINANCIAL]"});
+  }
+  if (strict && ShouldRedactCategory(DataCategory::DEVICE_INFO)) {
+    rules.push_back({"device",
+                     R"(\b(?:\d{1,3}\.){3}\d{1,3}\b|)"
+                     R"(\b(?:[0-9A-Fa-f]{2}[:-]){5}[0-9A-Fa-f]{2}\b)",
+                     "[DEVICE]"});
+  }
+  if (standard && ShouldRedactCategory(DataCategory::LOCATION_DATA)) {
+    rules.push_back({"location",
+                     R"(-?\b\d{1,2}\.\d{3,},\s*-?\d{1,3}\.\d{3,}\b)",
+                     "[LOCATION]"});
+  }
+  if (ShouldRedactCategory(DataCategory::PERSONAL_INFO)) {
+    rules.push_back({"phone",
+                     R"((?:\+\d{1,3}[\s.-]?)?(?:\(\d{3}\)|\b\d{3})[\s.-]?)"
+                     R"(\d{3}[\s.-]?\d{4}\b)",
+                     "[PHONE]"});
+    if (standard) {
+      rules.push_back({"date",
+                       R"(\b\d{1,2}/\d{1,2}/\d{2,4}\b|\b\d{4}-\d{2}-\d{2}\b)",
+                       "[DATE]"});
+      rules.push_back({"address",
+                       R"(\b\d{1,5}\s+(?:[A-Z][a-z]+\s+){1,3})"
+                       R"((?:Street|St|Avenue|Ave|Road|Rd|Boulevard|Blvd|)"
+                       R"(Lane|Ln|Drive|Dr|Court|Ct|Way|Place|Pl)\b\.?)",
+                       "[ADDRESS]"});
+    }
+    rules.push_back({"name",
+                     maximum ? R"(\b(?:(?:Mr|Mrs|Ms|Miss|Dr|Prof)\.?\s+)?)"
+                               R"([A-Z][a-z]+\s+[A-Z][a-z]+\b)"
+                             : R"(\b(?:Mr|Mrs|Ms|Miss|Dr|Prof)\.?\s+)"
+                               R"([A-Z][a-z]+(?:\s+[A-Z][a-z]+)?\b)",
+                     "[NAME]"});
+  }
+  if (standard && ShouldRedactCategory(DataCategory::HEALTH_DATA)) {
+    rules.push_back({"health",
+                     "\\b(?i:" +
+                         JoinAlternatives(kHealthTerms,
+                                          std::size(kHealthTerms)) +
+                         ")\\b",
+                     "[HEALTH]"});
+  }
+
+  // Custom patterns go last and in name order, so overlaps resolve the
+  // same way every time
+  std::vector<std::string> names;
+  names.reserve(custom_patterns_.size());
+  for (const auto& [name, pattern] : custom_patterns_) {
+    names.push_back(name);
+  }
+  std::sort(names.begin(), names.end());
+  for (const std::string& name : names) {
+    rules.push_back({name, custom_patterns_.at(name), "[REDACTED]"});
+  }
+  return rules;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -7,11 +7,18 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "asol/core/pii_placeholder_map.h"
+#include "asol/core/pii_redactor.h"
+#include "asol/core/redaction_cache.h"
+#include "asol/core/shared_text.h"
+#include "asol/core/trace_context.h"
 #include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 
 namespace asol {
@@ -51,16 +58,25 @@ class PrivacyProxy {
 
   // Result of privacy processing
   struct ProcessingResult {
-    std::string processed_text;
+    // The input itself, shared rather than copied, when nothing was redacted
+    SharedText processed_text;
     bool was_modified;
     int num_redactions;
     std::unordered_map<std::string, int> redaction_categories;
+
+    // In reversible mode, the entities behind the placeholders in
+    // |processed_text|; use it to rehydrate the model's answer. Null
+    // otherwise.
+    scoped_refptr<PiiPlaceholderMap> placeholders;
   };
 
   // Callback for privacy processing
   using ProcessingCallback = 
       base::OnceCallback<void(const ProcessingResult& result)>;
 
+  // Receives the redacted text of a streamed input piece by piece, in order
+  using ChunkCallback = base::RepeatingCallback<void(std::string_view chunk)>;
+
   PrivacyProxy();
   ~PrivacyProxy();
 
@@ -71,16 +87,41 @@ class PrivacyProxy {
   // Initialize the privacy proxy
   bool Initialize();
 
-  // Process text to remove/redact PII based on privacy settings
-  void ProcessText(const std::string& input_text, ProcessingCallback callback);
+  // Process text to remove/redact PII based on privacy settings. Text is
+  // redacted paragraph by paragraph, reusing the result for any paragraph
+  // seen before under the same settings; large inputs are split at
+  // paragraph breaks and redacted on several worker threads. The work is
+  // traced as a span under |trace|.
+  void ProcessText(SharedText input_text,
+                   ProcessingCallback callback,
+                   const TraceContext& trace = TraceContext());
+
+  // Redact |input_text| in chunks on the thread pool and hand each chunk's
+  // output to |chunk_callback| on this sequence as soon as it and every
+  // chunk before it are done, so consumers can start on the beginning of a
+  // large document while the rest is still being redacted. |callback| runs
+  // last with the counts; its |processed_text| is empty.
+  void ProcessTextStreaming(SharedText input_text,
+                            ChunkCallback chunk_callback,
+                            ProcessingCallback callback,
+                            const TraceContext& trace = TraceContext());
 
   // Process text synchronously (for simpler use cases)
-  ProcessingResult ProcessTextSync(const std::string& input_text);
+  ProcessingResult ProcessTextSync(const SharedText& input_text);
 
   // Set the privacy level
   void SetPrivacyLevel(PrivacyLevel level);
   PrivacyLevel GetPrivacyLevel() const;
 
+  // In reversible mode, each redacted entity becomes a numbered placeholder
+  // such as "[EMAIL_1]" instead of a bare category marker, and results
+  // carry the mapping back. The model can then tell entities apart, and
+  // its answer can be rehydrated. Placeholders are numbered per request,
+  // so reversible requests skip the paragraph cache and are redacted on a
+  // single worker.
+  void SetReversibleRedaction(bool enabled) { reversible_ = enabled; }
+  bool IsReversibleRedaction() const { return reversible_; }
+
   // Manage consent settings
   void SetConsentSetting(const ConsentSetting& setting);
   void SetConsentSettings(const std::vector<ConsentSetting>& settings);
@@ -92,6 +133,11 @@ class PrivacyProxy {
                        const std::string& regex_pattern);
   void RemoveCustomPattern(const std::string& pattern_name);
 
+  // Paragraphs served from the redaction cache so far
+  size_t GetRedactionCacheHitCount() const {
+    return redaction_cache_->GetHitCount();
+  }
+
   // Get a weak pointer to this instance
   base::WeakPtr<PrivacyProxy> GetWeakPtr();
 
@@ -100,18 +146,14 @@ class PrivacyProxy {
   bool ShouldRedactCategory(DataCategory category) const;
   std::string RedactPII(const std::string& text, 
                       std::unordered_map<std::string, int>* redaction_categories);
-  
-  // Apply specific redaction techniques
-  std::string RedactNames(const std::string& text, int* count);
-  std::string RedactEmailAddresses(const std::string& text, int* count);
-  std::string RedactPhoneNumbers(const std::string& text, int* count);
-  std::string RedactAddresses(const std::string& text, int* count);
-  std::string RedactFinancialInfo(const std::string& text, int* count);
-  std::string RedactHealthInfo(const std::string& text, int* count);
-  std::string RedactLocationData(const std::string& text, int* count);
-  std::string RedactDeviceInfo(const std::string& text, int* count);
-  std::string RedactCustomPatterns(const std::string& text, 
-                                 std::unordered_map<std::string, int>* pattern_counts);
+
+  // Recompile |redactor_| for the current level, consent and custom
+  // patterns. Every category is matched by one engine in a single pass.
+  void UpdateRedactor();
+  std::vector<PiiRedactor::Rule> BuildRedactionRules() const;
+
+  // Identifies the rules |redactor_| was built from in cache keys
+  uint64_t GetRulesVersion() const;
 
   // Current privacy level
   PrivacyLevel privacy_level_ = PrivacyLevel::STANDARD;
@@ -119,9 +161,21 @@ class PrivacyProxy {
   // Consent settings for different data categories
   std::unordered_map<DataCategory, ConsentSetting> consent_settings_;
 
+  // Whether results carry placeholders that can be rehydrated
+  bool reversible_ = false;
+
   // Custom patterns for PII detection
   std::unordered_map<std::string, std::string> custom_patterns_;
 
+  // Bumped by every consent or custom pattern change
+  uint64_t consent_version_ = 0;
+
+  // Compiled from the settings above; shared with redaction tasks
+  scoped_refptr<PiiRedactor> redactor_;
+
+  // Redacted paragraphs, keyed by content and rules version
+  scoped_refptr<RedactionCache> redaction_cache_;
+
   // For weak pointers
   base::WeakPtrFactory<PrivacyProxy> weak_ptr_factory_{this};
 };
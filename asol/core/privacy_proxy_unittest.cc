@@ -0,0 +1,225 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/privacy_proxy.h"
+
+#include <string>
+
+#include "base/functional/bind.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+class PrivacyProxyTest : public testing::Test {
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  PrivacyProxy proxy_;
+};
+
+TEST_F(PrivacyProxyTest, MinimalRedactsContactDetails) {
+  proxy_.SetPrivacyLevel(PrivacyProxy::PrivacyLevel::MINIMAL);
+  PrivacyProxy::ProcessingResult result = proxy_.ProcessTextSync(
+      "Ask Dr. Jane Smith at jane@clinic.org or (555) 123-4567 about "
+      "diabetes.");
+  EXPECT_EQ(result.processed_text,
+            "Ask [NAME] at [EMAIL] or [PHONE] about diabetes.");
+  EXPECT_TRUE(result.was_modified);
+  EXPECT_EQ(result.num_redactions, 3);
+}
+
+TEST_F(PrivacyProxyTest, StandardAddsSensitiveCategories) {
+  PrivacyProxy::ProcessingResult result = proxy_.ProcessTextSync(
+      "Card 4111 1111 1111 1111, lives at 42 Elm Street, diagnosed with "
+      "Diabetes on 2024-03-01 near 48.8584, 2.2945.");
+  EXPECT_EQ(result.processed_text,
+            "Card [FINANCIAL], lives at [ADDRESS], [HEALTH] with [HEALTH] on "
+            "[DATE] near [LOCATION].");
+  EXPECT_EQ(result.redaction_categories["health"], 2);
+}
+
+TEST_F(PrivacyProxyTest, StrictAddsDeviceInfo) {
+  std::string text = "Client 192.168.0.12 with MAC 00:1a:2b:3c:4d:5e";
+  EXPECT_EQ(proxy_.ProcessTextSync(text).processed_text, text);
+  proxy_.SetPrivacyLevel(PrivacyProxy::PrivacyLevel::STRICT);
+  EXPECT_EQ(proxy_.ProcessTextSync(text).processed_text,
+            "Client [DEVICE] with MAC [DEVICE]");
+}
+
+TEST_F(PrivacyProxyTest, ConsentDisablesCategory) {
+  proxy_.SetConsentSetting(
+      {PrivacyProxy::DataCategory::HEALTH_DATA, true, std::string()});
+  PrivacyProxy::ProcessingResult result =
+      proxy_.ProcessTextSync("Asthma, mail me at a@b.io");
+  EXPECT_EQ(result.processed_text, "Asthma, mail me at [EMAIL]");
+}
+
+TEST_F(PrivacyProxyTest, CustomPatterns) {
+  proxy_.AddCustomPattern("ticket", R"(\bTCK-\d+\b)");
+  EXPECT_EQ(proxy_.ProcessTextSync("See TCK-1234").processed_text,
+            "See [REDACTED]");
+  proxy_.RemoveCustomPattern("ticket");
+  EXPECT_EQ(proxy_.ProcessTextSync("See TCK-1234").processed_text,
+            "See TCK-1234");
+}
+
+TEST_F(PrivacyProxyTest, ProcessTextRunsOffThread) {
+  base::RunLoop run_loop;
+  PrivacyProxy::ProcessingResult result;
+  proxy_.ProcessText("Write to a@b.io",
+                     base::BindOnce(
+                         [](PrivacyProxy::ProcessingResult* out,
+                            base::OnceClosure quit,
+                            const PrivacyProxy::ProcessingResult& result) {
+                           *out = result;
+                           std::move(quit).Run();
+                         },
+                         &result, run_loop.QuitClosure()));
+  run_loop.Run();
+  EXPECT_EQ(result.processed_text, "Write to [EMAIL]");
+}
+
+// About 300 KiB of text with PII spread throughout
+std::string LargeDocument() {
+  std::string text;
+  for (int i = 0; text.size() < 300 * 1024; ++i) {
+    text += "Paragraph " + base::NumberToString(i) +
+            ": write to user" + base::NumberToString(i) +
+            "@example.com or call (555) 123-4567 about the diabetes study.\n\n";
+  }
+  return text;
+}
+
+TEST_F(PrivacyProxyTest, StreamingMatchesSerialRedaction) {
+  std::string text = LargeDocument();
+  PrivacyProxy::ProcessingResult expected = proxy_.ProcessTextSync(text);
+
+  base::RunLoop run_loop;
+  std::string streamed;
+  int chunk_count = 0;
+  PrivacyProxy::ProcessingResult result;
+  proxy_.ProcessTextStreaming(
+      text,
+      base::BindLambdaForTesting([&](std::string_view chunk) {
+        streamed.append(chunk);
+        chunk_count++;
+      }),
+      base::BindLambdaForTesting(
+          [&](const PrivacyProxy::ProcessingResult& streaming_result) {
+            result = streaming_result;
+            run_loop.Quit();
+          }));
+  run_loop.Run();
+
+  EXPECT_GT(chunk_count, 1);
+  EXPECT_EQ(streamed, expected.processed_text);
+  EXPECT_TRUE(result.processed_text.empty());
+  EXPECT_EQ(result.num_redactions, expected.num_redactions);
+  EXPECT_EQ(result.redaction_categories, expected.redaction_categories);
+}
+
+TEST_F(PrivacyProxyTest, LongParagraphIsNotSplit) {
+  // Chunks only end at paragraph breaks, so the address stays whole
+  std::string text(32 * 1024 - 5, ' ');
+  text += "bob@example.com";
+  text += std::string(400, ';');
+  text += std::string(64 * 1024, ' ');
+
+  base::RunLoop run_loop;
+  PrivacyProxy::ProcessingResult result;
+  proxy_.ProcessText(
+      text, base::BindLambdaForTesting(
+                [&](const PrivacyProxy::ProcessingResult& chunked_result) {
+                  result = chunked_result;
+                  run_loop.Quit();
+                }));
+  run_loop.Run();
+
+  EXPECT_EQ(result.processed_text, proxy_.ProcessTextSync(text).processed_text);
+  EXPECT_EQ(result.num_redactions, 1);
+}
+
+TEST_F(PrivacyProxyTest, SharesTextWithoutPii) {
+  SharedText text(std::string(64 * 1024, 'a') + "\n\n" +
+                  std::string(64 * 1024, 'b'));
+  EXPECT_TRUE(proxy_.ProcessTextSync(text).processed_text.SharesBufferWith(
+      text));
+
+  // The chunked path too
+  base::RunLoop run_loop;
+  PrivacyProxy::ProcessingResult result;
+  proxy_.ProcessText(
+      text, base::BindLambdaForTesting(
+                [&](const PrivacyProxy::ProcessingResult& chunked_result) {
+                  result = chunked_result;
+                  run_loop.Quit();
+                }));
+  run_loop.Run();
+
+  EXPECT_FALSE(result.was_modified);
+  EXPECT_TRUE(result.processed_text.SharesBufferWith(text));
+}
+
+TEST_F(PrivacyProxyTest, ReusesUnchangedParagraphs) {
+  std::string intro(100, 'a');
+  std::string body = "Contact bob@example.com for the report. " + intro;
+  std::string footer = "Call (555) 123-4567 with questions. " + intro;
+  PrivacyProxy::ProcessingResult first = proxy_.ProcessTextSync(
+      intro + "\n\n" + body + "\n\nViews: 1041 " + intro + "\n\n" + footer);
+  EXPECT_EQ(proxy_.GetRedactionCacheHitCount(), 0u);
+
+  // Only the counter changed
+  std::string changed =
+      intro + "\n\n" + body + "\n\nViews: 1042 " + intro + "\n\n" + footer;
+  PrivacyProxy::ProcessingResult second = proxy_.ProcessTextSync(changed);
+  EXPECT_EQ(proxy_.GetRedactionCacheHitCount(), 3u);
+  EXPECT_EQ(second.num_redactions, first.num_redactions);
+
+  PrivacyProxy uncached;
+  EXPECT_EQ(second.processed_text,
+            uncached.ProcessTextSync(changed).processed_text);
+}
+
+TEST_F(PrivacyProxyTest, SettingsChangeIsNotServedFromCache) {
+  std::string text = "Server at 10.0.0.1 went down. " + std::string(100, 'a');
+  EXPECT_EQ(proxy_.ProcessTextSync(text).num_redactions, 0);
+  proxy_.SetPrivacyLevel(PrivacyProxy::PrivacyLevel::STRICT);
+  EXPECT_EQ(proxy_.ProcessTextSync(text).num_redactions, 1);
+  proxy_.AddCustomPattern("outage", "went down");
+  EXPECT_EQ(proxy_.ProcessTextSync(text).num_redactions, 2);
+  EXPECT_EQ(proxy_.GetRedactionCacheHitCount(), 0u);
+
+  proxy_.RemoveCustomPattern("outage");
+  proxy_.SetPrivacyLevel(PrivacyProxy::PrivacyLevel::STANDARD);
+  EXPECT_EQ(proxy_.ProcessTextSync(text).num_redactions, 0);
+}
+
+TEST_F(PrivacyProxyTest, ReversibleModeRoundTrips) {
+  proxy_.SetReversibleRedaction(true);
+  std::string text =
+      "Forward a@b.io to c@d.io, then cc a@b.io. Call (555) 123-4567.";
+  PrivacyProxy::ProcessingResult result = proxy_.ProcessTextSync(text);
+  EXPECT_EQ(result.processed_text,
+            "Forward [EMAIL_1] to [EMAIL_2], then cc [EMAIL_1]. Call "
+            "[PHONE_1].");
+  EXPECT_EQ(result.num_redactions, 4);
+  ASSERT_TRUE(result.placeholders);
+  EXPECT_EQ(result.placeholders->Rehydrate(result.processed_text), text);
+
+  // A model answer that refers to the placeholders
+  EXPECT_EQ(result.placeholders->Rehydrate("Sent to [EMAIL_2]."),
+            "Sent to c@d.io.");
+
+  proxy_.SetReversibleRedaction(false);
+  EXPECT_FALSE(proxy_.ProcessTextSync(text).placeholders);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,46 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/prompt_cache.h"
+
+#include <algorithm>
+
+#include "base/strings/string_number_conversions.h"
+
+namespace asol {
+namespace core {
+
+const char kPromptPrefixLengthParam[] = "prompt_prefix_length";
+
+size_t GetPromptPrefixLength(
+    const std::unordered_map<std::string, std::string>& custom_params,
+    size_t input_size) {
+  auto it = custom_params.find(kPromptPrefixLengthParam);
+  size_t prefix_length = 0;
+  if (it == custom_params.end() ||
+      !base::StringToSizeT(it->second, &prefix_length)) {
+    return 0;
+  }
+  return std::min(prefix_length, input_size);
+}
+
+void PromptCacheStats::Record(int64_t response_input_tokens,
+                              int64_t response_cached_tokens) {
+  responses++;
+  if (response_cached_tokens > 0) {
+    cache_hits++;
+  }
+  input_tokens += response_input_tokens;
+  cached_input_tokens += response_cached_tokens;
+}
+
+double PromptCacheStats::GetTokenHitRate() const {
+  if (input_tokens <= 0) {
+    return 0.0;
+  }
+  return static_cast<double>(cached_input_tokens) / input_tokens;
+}
+
+}  // namespace core
+}  // namespace asol
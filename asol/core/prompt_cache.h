@@ -0,0 +1,52 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_PROMPT_CACHE_H_
+#define ASOL_CORE_PROMPT_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace asol {
+namespace core {
+
+// Key in AIRequestParams::custom_params with the length in bytes of the
+// start of |input_text| that is the same on every request of its kind,
+// such as a feature's instructions. Providers cache the processed prefix
+// and bill repeats of it at a fraction of the input price, so callers
+// should put stable text first and variable text, such as page content,
+// last. Adapters whose API takes explicit cache breakpoints place one at
+// the end of the prefix; the others rely on the provider matching it.
+extern const char kPromptPrefixLengthParam[];
+
+// The prefix length in |custom_params|, clamped to |input_size|; 0 when
+// absent or invalid.
+size_t GetPromptPrefixLength(
+    const std::unordered_map<std::string, std::string>& custom_params,
+    size_t input_size);
+
+// Input tokens a provider read from its prompt cache, as reported in the
+// usage of its responses.
+struct PromptCacheStats {
+  // Responses that reported usage, and those served partly from the cache
+  size_t responses = 0;
+  size_t cache_hits = 0;
+
+  // Input tokens billed, and how many of those were read from the cache
+  int64_t input_tokens = 0;
+  int64_t cached_input_tokens = 0;
+
+  // Record the usage of one response.
+  void Record(int64_t response_input_tokens, int64_t response_cached_tokens);
+
+  // Share of input tokens read from the cache, 0 before any response
+  double GetTokenHitRate() const;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_PROMPT_CACHE_H_
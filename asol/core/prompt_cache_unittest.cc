@@ -0,0 +1,39 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/prompt_cache.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+TEST(PromptCacheTest, PrefixLengthIsClampedToInput) {
+  std::unordered_map<std::string, std::string> params;
+  EXPECT_EQ(GetPromptPrefixLength(params, 100), 0u);
+
+  params[kPromptPrefixLengthParam] = "40";
+  EXPECT_EQ(GetPromptPrefixLength(params, 100), 40u);
+  EXPECT_EQ(GetPromptPrefixLength(params, 10), 10u);
+
+  params[kPromptPrefixLengthParam] = "forty";
+  EXPECT_EQ(GetPromptPrefixLength(params, 100), 0u);
+}
+
+TEST(PromptCacheTest, StatsTrackTokenHitRate) {
+  PromptCacheStats stats;
+  EXPECT_EQ(stats.GetTokenHitRate(), 0.0);
+
+  stats.Record(1000, 0);
+  stats.Record(1000, 800);
+  stats.Record(2000, 1600);
+  EXPECT_EQ(stats.responses, 3u);
+  EXPECT_EQ(stats.cache_hits, 2u);
+  EXPECT_DOUBLE_EQ(stats.GetTokenHitRate(), 0.6);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,48 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/prompt_template.h"
+
+#include "base/check_op.h"
+
+namespace asol {
+namespace core {
+
+std::string PromptTemplate::Render(std::initializer_list<Value> values,
+                                   size_t* prefix_length) const {
+  // Resolve every placeholder first, so the size is known before writing
+  std::array<std::string_view, kMaxPlaceholders> inserted;
+  size_t size = literal_size_;
+  for (size_t i = 0; i < placeholder_count_; ++i) {
+    bool found = false;
+    for (const Value& value : values) {
+      if (value.name == names_[i]) {
+        inserted[i] = value.text;
+        found = true;
+        break;
+      }
+    }
+    DCHECK(found) << "No value for {" << names_[i] << "}";
+    size += inserted[i].size();
+  }
+
+  if (prefix_length) {
+    *prefix_length = 0;
+  }
+  std::string prompt;
+  prompt.reserve(size);
+  for (size_t i = 0; i < placeholder_count_; ++i) {
+    prompt.append(literals_[i]);
+    if (prefix_length && i == variable_from_) {
+      *prefix_length = prompt.size();
+    }
+    prompt.append(inserted[i]);
+  }
+  prompt.append(literals_[placeholder_count_]);
+  DCHECK_EQ(prompt.size(), size);
+  return prompt;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,115 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_PROMPT_TEMPLATE_H_
+#define ASOL_CORE_PROMPT_TEMPLATE_H_
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+#include "base/check.h"
+
+namespace asol {
+namespace core {
+
+// PromptTemplate is prompt text with named {placeholders}, split into
+// literal segments once. Declared constexpr, the split happens at compile
+// time and a malformed template fails the build. Render() adds up the
+// segment and value sizes, reserves exactly that, and appends each piece
+// once, so a prompt around a page of text costs one allocation and one
+// copy of the page. Values are inserted as written: placeholders inside
+// them are not expanded.
+//
+// A placeholder is a name of lowercase letters, digits and underscores
+// in braces; any other brace, such as in a JSON example, is literal.
+//
+//   constexpr PromptTemplate kPrompt(
+//       "Summarize as {format}:\n\n{content}", "content");
+//   size_t prefix_length = 0;
+//   std::string prompt = kPrompt.Render(
+//       {{"format", "bullet points"}, {"content", page}}, &prefix_length);
+//   // prefix_length covers "Summarize as bullet points:\n\n"
+class PromptTemplate {
+ public:
+  static constexpr size_t kMaxPlaceholders = 8;
+
+  struct Value {
+    std::string_view name;
+    std::string_view text;
+  };
+
+  // |text| must outlive the template, as a string literal does.
+  // |variable_from| names the placeholder where the text that changes from
+  // request to request begins; everything rendered before it is the
+  // stable prefix providers can cache (see kPromptPrefixLengthParam).
+  constexpr explicit PromptTemplate(std::string_view text,
+                                    std::string_view variable_from = {}) {
+    size_t literal_start = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+      size_t end = pos + 1;
+      if (text[pos] == '{') {
+        while (end < text.size() && IsNameChar(text[end])) {
+          ++end;
+        }
+      }
+      if (text[pos] != '{' || end == pos + 1 || end == text.size() ||
+          text[end] != '}') {
+        ++pos;
+        continue;
+      }
+      CHECK(placeholder_count_ < kMaxPlaceholders);
+      literals_[placeholder_count_] =
+          text.substr(literal_start, pos - literal_start);
+      literal_size_ += pos - literal_start;
+      names_[placeholder_count_] = text.substr(pos + 1, end - pos - 1);
+      if (variable_from_ == kNone && !variable_from.empty() &&
+          names_[placeholder_count_] == variable_from) {
+        variable_from_ = placeholder_count_;
+      }
+      ++placeholder_count_;
+      pos = end + 1;
+      literal_start = pos;
+    }
+    literals_[placeholder_count_] = text.substr(literal_start);
+    literal_size_ += text.size() - literal_start;
+    CHECK(variable_from.empty() || variable_from_ != kNone);
+  }
+
+  // The prompt with each placeholder replaced by the value of that name.
+  // If |prefix_length| is given, it receives the length of the stable
+  // prefix, or 0 when the template has no |variable_from|.
+  std::string Render(std::initializer_list<Value> values,
+                     size_t* prefix_length = nullptr) const;
+
+  constexpr size_t placeholder_count() const { return placeholder_count_; }
+  constexpr std::string_view placeholder_name(size_t index) const {
+    return names_[index];
+  }
+  // Bytes of the template outside its placeholders
+  constexpr size_t literal_size() const { return literal_size_; }
+
+ private:
+  static constexpr size_t kNone = kMaxPlaceholders;
+
+  static constexpr bool IsNameChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+  }
+
+  // literals_[i] precedes placeholder i; one more literal than placeholders
+  std::array<std::string_view, kMaxPlaceholders + 1> literals_{};
+  std::array<std::string_view, kMaxPlaceholders> names_{};
+  size_t placeholder_count_ = 0;
+  size_t literal_size_ = 0;
+  // Index of the first placeholder of the variable suffix
+  size_t variable_from_ = kNone;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_PROMPT_TEMPLATE_H_
@@ -0,0 +1,67 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/prompt_template.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+constexpr PromptTemplate kSummaryTemplate(
+    "Summarize as {format} in {length}.\n\nContent:\n{content}\n",
+    "content");
+
+// Parsed by the compiler
+static_assert(kSummaryTemplate.placeholder_count() == 3);
+static_assert(kSummaryTemplate.placeholder_name(2) == "content");
+static_assert(kSummaryTemplate.literal_size() == 30);
+
+TEST(PromptTemplateTest, RendersValues) {
+  size_t prefix_length = 0;
+  std::string prompt = kSummaryTemplate.Render(
+      {{"content", "Page text"}, {"format", "bullets"}, {"length", "1 line"}},
+      &prefix_length);
+  EXPECT_EQ(prompt,
+            "Summarize as bullets in 1 line.\n\nContent:\nPage text\n");
+  // Everything up to the content is the same on every request
+  EXPECT_EQ(prompt.substr(0, prefix_length),
+            "Summarize as bullets in 1 line.\n\nContent:\n");
+}
+
+TEST(PromptTemplateTest, LeavesOtherBracesAlone) {
+  constexpr PromptTemplate kTemplate(
+      "Reply as {\"items\": []} or {Not a slot} {} {x y} {{name}} {");
+  static_assert(kTemplate.placeholder_count() == 1);
+  EXPECT_EQ(kTemplate.Render({{"name", "value"}}),
+            "Reply as {\"items\": []} or {Not a slot} {} {x y} {value} {");
+}
+
+TEST(PromptTemplateTest, DoesNotExpandValues) {
+  constexpr PromptTemplate kTemplate("{query} then {page}");
+  EXPECT_EQ(kTemplate.Render({{"query", "{page}"}, {"page", "{query}"}}),
+            "{page} then {query}");
+}
+
+TEST(PromptTemplateTest, RepeatsPlaceholders) {
+  constexpr PromptTemplate kTemplate("{a}-{b}-{a}", "b");
+  size_t prefix_length = 100;
+  EXPECT_EQ(kTemplate.Render({{"a", "x"}, {"b", "yy"}}, &prefix_length),
+            "x-yy-x");
+  EXPECT_EQ(prefix_length, 2u);
+}
+
+TEST(PromptTemplateTest, NoPrefixWithoutVariablePart) {
+  constexpr PromptTemplate kTemplate("Plain text");
+  size_t prefix_length = 100;
+  EXPECT_EQ(kTemplate.Render({}, &prefix_length), "Plain text");
+  EXPECT_EQ(prefix_length, 0u);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,228 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/quantized_matmul.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/check.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+
+#include "base/cpu.h"
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace asol {
+namespace core {
+
+namespace {
+
+constexpr float kInt8Max = 127.0f;
+constexpr float kInt4Max = 7.0f;
+
+// Quantize |size| floats to [-limit, limit] with one scale, returned
+template <typename Store>
+float QuantizeSymmetric(const float* in, size_t size, float limit,
+                        Store store) {
+  float max_abs = 0.0f;
+  for (size_t i = 0; i < size; ++i) {
+    max_abs = std::max(max_abs, std::fabs(in[i]));
+  }
+  float scale = max_abs / limit;
+  float inverse = scale > 0.0f ? 1.0f / scale : 0.0f;
+  for (size_t i = 0; i < size; ++i) {
+    store(i, static_cast<int>(std::clamp(std::round(in[i] * inverse),
+                                         -limit, limit)));
+  }
+  return scale;
+}
+
+float QuantizeRow(const float* in, size_t size, int8_t* out) {
+  return QuantizeSymmetric(in, size, kInt8Max, [out](size_t i, int value) {
+    out[i] = static_cast<int8_t>(value);
+  });
+}
+
+// Expand one packed int4 row to int8
+void UnpackInt4Row(const uint8_t* packed, size_t cols, int8_t* out) {
+  for (size_t i = 0; i < cols / 2; ++i) {
+    // Shifting through int8_t sign-extends each nibble
+    out[2 * i] = static_cast<int8_t>(static_cast<uint8_t>(packed[i] << 4)) >> 4;
+    out[2 * i + 1] = static_cast<int8_t>(packed[i]) >> 4;
+  }
+}
+
+#if !defined(ARCH_CPU_ARM64)
+int32_t DotProductInt8Portable(const int8_t* a, const int8_t* b, size_t size) {
+  int32_t sum = 0;
+  for (size_t i = 0; i < size; ++i) {
+    sum += static_cast<int32_t>(a[i]) * b[i];
+  }
+  return sum;
+}
+#endif
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+__attribute__((target("avx2"))) int32_t DotProductInt8Avx2(const int8_t* a,
+                                                          const int8_t* b,
+                                                          size_t size) {
+  // Widen to int16 and multiply-add pairs into int32 lanes. Products of
+  // values in [-127, 127] cannot overflow the pairwise sums.
+  __m256i sum = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    __m256i a_low = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(va));
+    __m256i b_low = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(vb));
+    __m256i a_high = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(va, 1));
+    __m256i b_high = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(vb, 1));
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a_low, b_low));
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a_high, b_high));
+  }
+  __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                               _mm256_extracti128_si256(sum, 1));
+  half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+  half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+  int32_t total = _mm_cvtsi128_si32(half);
+  for (; i < size; ++i) {
+    total += static_cast<int32_t>(a[i]) * b[i];
+  }
+  return total;
+}
+
+bool HasAvx2() {
+  static const bool has_avx2 = base::CPU().has_avx2();
+  return has_avx2;
+}
+
+#elif defined(ARCH_CPU_ARM64)
+
+int32_t DotProductInt8Neon(const int8_t* a, const int8_t* b, size_t size) {
+  int32x4_t sum = vdupq_n_s32(0);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    int8x16_t va = vld1q_s8(a + i);
+    int8x16_t vb = vld1q_s8(b + i);
+    // Two products of values in [-127, 127] fit in int16
+    int16x8_t products = vmull_s8(vget_low_s8(va), vget_low_s8(vb));
+    products = vmlal_s8(products, vget_high_s8(va), vget_high_s8(vb));
+    sum = vpadalq_s16(sum, products);
+  }
+  int32_t total = vaddvq_s32(sum);
+  for (; i < size; ++i) {
+    total += static_cast<int32_t>(a[i]) * b[i];
+  }
+  return total;
+}
+
+#endif
+
+}  // namespace
+
+int32_t DotProductInt8(const int8_t* a, const int8_t* b, size_t size) {
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (HasAvx2()) {
+    return DotProductInt8Avx2(a, b, size);
+  }
+  return DotProductInt8Portable(a, b, size);
+#elif defined(ARCH_CPU_ARM64)
+  return DotProductInt8Neon(a, b, size);
+#else
+  return DotProductInt8Portable(a, b, size);
+#endif
+}
+
+Int8Matrix QuantizeInt8(const float* weights, size_t rows, size_t cols) {
+  Int8Matrix matrix;
+  matrix.rows = rows;
+  matrix.cols = cols;
+  matrix.values.resize(rows * cols);
+  matrix.scales.resize(rows);
+  for (size_t r = 0; r < rows; ++r) {
+    matrix.scales[r] =
+        QuantizeRow(weights + r * cols, cols, &matrix.values[r * cols]);
+  }
+  return matrix;
+}
+
+Int4Matrix QuantizeInt4(const float* weights, size_t rows, size_t cols) {
+  DCHECK_EQ(cols % kInt4BlockSize, 0u);
+  Int4Matrix matrix;
+  matrix.rows = rows;
+  matrix.cols = cols;
+  matrix.packed.assign(rows * cols / 2, 0);
+  matrix.scales.resize(rows * cols / kInt4BlockSize);
+  for (size_t block = 0; block < matrix.scales.size(); ++block) {
+    uint8_t* packed = &matrix.packed[block * kInt4BlockSize / 2];
+    matrix.scales[block] = QuantizeSymmetric(
+        weights + block * kInt4BlockSize, kInt4BlockSize, kInt4Max,
+        [packed](size_t i, int value) {
+          uint8_t nibble = static_cast<uint8_t>(value) & 0x0f;
+          packed[i / 2] |= (i % 2 == 0) ? nibble : nibble << 4;
+        });
+  }
+  return matrix;
+}
+
+void MatMulInt8(const Int8Weights& weights,
+                const float* input,
+                size_t batch,
+                float* output) {
+  std::vector<int8_t> quantized(weights.cols);
+  for (size_t b = 0; b < batch; ++b) {
+    float input_scale =
+        QuantizeRow(input + b * weights.cols, weights.cols, quantized.data());
+    float* out = output + b * weights.rows;
+    for (size_t r = 0; r < weights.rows; ++r) {
+      int32_t sum = DotProductInt8(weights.values + r * weights.cols,
+                                   quantized.data(), weights.cols);
+      out[r] = static_cast<float>(sum) * input_scale * weights.scales[r];
+    }
+  }
+}
+
+void MatMulInt4(const Int4Weights& weights,
+                const float* input,
+                size_t batch,
+                float* output) {
+  DCHECK_EQ(weights.cols % kInt4BlockSize, 0u);
+  const size_t blocks_per_row = weights.cols / kInt4BlockSize;
+
+  // Quantize the inputs once, then unpack each weight row once for the
+  // whole batch
+  std::vector<int8_t> quantized(batch * weights.cols);
+  std::vector<float> input_scales(batch);
+  for (size_t b = 0; b < batch; ++b) {
+    input_scales[b] = QuantizeRow(input + b * weights.cols, weights.cols,
+                                  &quantized[b * weights.cols]);
+  }
+
+  std::vector<int8_t> row(weights.cols);
+  for (size_t r = 0; r < weights.rows; ++r) {
+    UnpackInt4Row(weights.packed + r * weights.cols / 2, weights.cols,
+                  row.data());
+    const float* scales = weights.scales + r * blocks_per_row;
+    for (size_t b = 0; b < batch; ++b) {
+      const int8_t* x = &quantized[b * weights.cols];
+      float sum = 0.0f;
+      for (size_t block = 0; block < blocks_per_row; ++block) {
+        size_t offset = block * kInt4BlockSize;
+        sum += static_cast<float>(DotProductInt8(
+                   row.data() + offset, x + offset, kInt4BlockSize)) *
+               scales[block];
+      }
+      output[b * weights.rows + r] = sum * input_scales[b];
+    }
+  }
+}
+
+}  // namespace core
+}  // namespace asol
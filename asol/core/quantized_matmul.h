@@ -0,0 +1,95 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_QUANTIZED_MATMUL_H_
+#define ASOL_CORE_QUANTIZED_MATMUL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace asol {
+namespace core {
+
+// Quantized weights and matrix multiplication for running small local
+// models on CPUs without a GPU.
+//
+// Weights are rows x cols (one row per output channel) in one of two
+// formats:
+//  - int8 with one float scale per row: w[r][c] ~= values[r][c] * scales[r]
+//  - int4 in blocks of kInt4BlockSize along each row, one scale per block,
+//    two values per byte with the low nibble first, as stored in
+//    MappedModelFile::ElementType::kInt4 tensors.
+// Both are symmetric (no zero point). The views below do not own their
+// memory, so weights can be used straight from a mapped model file.
+//
+// MatMul*() quantizes each input row to int8 on the fly, accumulates in
+// int32 and rescales once per row (per block for int4). The integer dot
+// product runs on AVX2 where the CPU has it (checked at runtime), on NEON
+// on ARM64, and in portable code otherwise.
+
+constexpr size_t kInt4BlockSize = 32;
+
+struct Int8Weights {
+  size_t rows = 0;
+  size_t cols = 0;
+  const int8_t* values = nullptr;  // rows * cols
+  const float* scales = nullptr;   // rows
+};
+
+struct Int4Weights {
+  size_t rows = 0;
+  size_t cols = 0;                 // A multiple of kInt4BlockSize
+  const uint8_t* packed = nullptr; // rows * cols / 2
+  const float* scales = nullptr;   // rows * cols / kInt4BlockSize
+};
+
+// Storage for weights quantized at load time, e.g. from a float model
+struct Int8Matrix {
+  size_t rows = 0;
+  size_t cols = 0;
+  std::vector<int8_t> values;
+  std::vector<float> scales;
+
+  Int8Weights view() const {
+    return {rows, cols, values.data(), scales.data()};
+  }
+};
+
+struct Int4Matrix {
+  size_t rows = 0;
+  size_t cols = 0;
+  std::vector<uint8_t> packed;
+  std::vector<float> scales;
+
+  Int4Weights view() const {
+    return {rows, cols, packed.data(), scales.data()};
+  }
+};
+
+// Quantize row-major float |weights|
+Int8Matrix QuantizeInt8(const float* weights, size_t rows, size_t cols);
+
+// |cols| must be a multiple of kInt4BlockSize
+Int4Matrix QuantizeInt4(const float* weights, size_t rows, size_t cols);
+
+// output[b][r] = sum over c of input[b][c] * w[r][c], for |batch| input
+// rows of weights.cols floats. |output| holds batch * weights.rows floats.
+// A batch of one is a matrix-vector product.
+void MatMulInt8(const Int8Weights& weights,
+                const float* input,
+                size_t batch,
+                float* output);
+void MatMulInt4(const Int4Weights& weights,
+                const float* input,
+                size_t batch,
+                float* output);
+
+// Sum of a[i] * b[i], for values in [-127, 127]
+int32_t DotProductInt8(const int8_t* a, const int8_t* b, size_t size);
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_QUANTIZED_MATMUL_H_
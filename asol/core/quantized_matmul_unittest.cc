@@ -0,0 +1,125 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/quantized_matmul.h"
+
+#include <cmath>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+std::vector<float> MakeMatrix(size_t rows, size_t cols, float phase) {
+  std::vector<float> values(rows * cols);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = std::sin(static_cast<float>(i) * 0.37f + phase) *
+                (1.0f + static_cast<float>(i / cols));
+  }
+  return values;
+}
+
+// output[b][r] in float, for comparison
+std::vector<float> ReferenceMatMul(const std::vector<float>& weights,
+                                   const std::vector<float>& input,
+                                   size_t rows,
+                                   size_t cols,
+                                   size_t batch) {
+  std::vector<float> output(batch * rows);
+  for (size_t b = 0; b < batch; ++b) {
+    for (size_t r = 0; r < rows; ++r) {
+      double sum = 0.0;
+      for (size_t c = 0; c < cols; ++c) {
+        sum += weights[r * cols + c] * input[b * cols + c];
+      }
+      output[b * rows + r] = static_cast<float>(sum);
+    }
+  }
+  return output;
+}
+
+// Largest error relative to the largest reference magnitude
+float RelativeError(const std::vector<float>& actual,
+                    const std::vector<float>& expected) {
+  float max_error = 0.0f;
+  float max_value = 0.0f;
+  for (size_t i = 0; i < expected.size(); ++i) {
+    max_error = std::max(max_error, std::fabs(actual[i] - expected[i]));
+    max_value = std::max(max_value, std::fabs(expected[i]));
+  }
+  return max_error / max_value;
+}
+
+TEST(QuantizedMatMulTest, DotProductInt8IsExactForAllTailLengths) {
+  for (size_t size = 0; size <= 70; ++size) {
+    std::vector<int8_t> a(size);
+    std::vector<int8_t> b(size);
+    int32_t expected = 0;
+    for (size_t i = 0; i < size; ++i) {
+      a[i] = static_cast<int8_t>((i % 2 ? 127 : -127) - i % 5);
+      b[i] = static_cast<int8_t>(127 - (i * 7) % 255);
+      expected += a[i] * b[i];
+    }
+    EXPECT_EQ(DotProductInt8(a.data(), b.data(), size), expected)
+        << "size " << size;
+  }
+}
+
+TEST(QuantizedMatMulTest, Int8MatchesFloatWithinQuantizationError) {
+  constexpr size_t kRows = 24;
+  constexpr size_t kCols = 200;
+  constexpr size_t kBatch = 3;
+  std::vector<float> weights = MakeMatrix(kRows, kCols, 0.0f);
+  std::vector<float> input = MakeMatrix(kBatch, kCols, 1.0f);
+
+  Int8Matrix quantized = QuantizeInt8(weights.data(), kRows, kCols);
+  std::vector<float> output(kBatch * kRows);
+  MatMulInt8(quantized.view(), input.data(), kBatch, output.data());
+  EXPECT_LT(RelativeError(output, ReferenceMatMul(weights, input, kRows,
+                                                  kCols, kBatch)),
+            0.02f);
+}
+
+TEST(QuantizedMatMulTest, Int4MatchesFloatWithinQuantizationError) {
+  constexpr size_t kRows = 16;
+  constexpr size_t kCols = 4 * kInt4BlockSize;
+  std::vector<float> weights = MakeMatrix(kRows, kCols, 0.5f);
+  std::vector<float> input = MakeMatrix(2, kCols, 2.0f);
+
+  Int4Matrix quantized = QuantizeInt4(weights.data(), kRows, kCols);
+  EXPECT_EQ(quantized.packed.size(), kRows * kCols / 2);
+  EXPECT_EQ(quantized.scales.size(), kRows * 4);
+
+  std::vector<float> output(2 * kRows);
+  MatMulInt4(quantized.view(), input.data(), 2, output.data());
+  EXPECT_LT(RelativeError(output,
+                          ReferenceMatMul(weights, input, kRows, kCols, 2)),
+            0.15f);
+}
+
+TEST(QuantizedMatMulTest, Int4PacksLowNibbleFirst) {
+  std::vector<float> weights(kInt4BlockSize, 0.0f);
+  weights[0] = -7.0f;
+  weights[1] = 7.0f;
+  weights[2] = 1.0f;
+  Int4Matrix quantized = QuantizeInt4(weights.data(), 1, kInt4BlockSize);
+  EXPECT_FLOAT_EQ(quantized.scales[0], 1.0f);
+  EXPECT_EQ(quantized.packed[0], 0x79);  // 7 << 4 | (-7 & 0xf)
+  EXPECT_EQ(quantized.packed[1], 0x01);
+}
+
+TEST(QuantizedMatMulTest, ZeroInputGivesZeroOutput) {
+  std::vector<float> weights = MakeMatrix(4, 64, 0.0f);
+  std::vector<float> input(64, 0.0f);
+  std::vector<float> output(4, 1.0f);
+  MatMulInt8(QuantizeInt8(weights.data(), 4, 64).view(), input.data(), 1,
+             output.data());
+  EXPECT_EQ(output, std::vector<float>(4, 0.0f));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
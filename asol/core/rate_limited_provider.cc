@@ -0,0 +1,304 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/rate_limited_provider.h"
+
+#include <utility>
+
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/task/sequenced_task_runner.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+constexpr char kConfigKeyApiKey[] = "api_key";
+
+}  // namespace
+
+RateLimitedProvider::PendingRequest::PendingRequest() = default;
+RateLimitedProvider::PendingRequest::PendingRequest(PendingRequest&&) =
+    default;
+RateLimitedProvider::PendingRequest&
+RateLimitedProvider::PendingRequest::operator=(PendingRequest&&) = default;
+RateLimitedProvider::PendingRequest::~PendingRequest() = default;
+
+RateLimitedProvider::RateLimitedProvider(
+    std::unique_ptr<AIServiceProvider> provider,
+    const Options& options)
+    : provider_(std::move(provider)), options_(options) {
+  auto config = provider_->GetConfiguration();
+  auto it = config.find(kConfigKeyApiKey);
+  if (it != config.end()) {
+    api_key_ = it->second;
+  }
+}
+
+RateLimitedProvider::~RateLimitedProvider() = default;
+
+std::string RateLimitedProvider::GetProviderId() const {
+  return provider_->GetProviderId();
+}
+
+std::string RateLimitedProvider::GetProviderName() const {
+  return provider_->GetProviderName();
+}
+
+std::string RateLimitedProvider::GetProviderVersion() const {
+  return provider_->GetProviderVersion();
+}
+
+AIServiceProvider::Capabilities RateLimitedProvider::GetCapabilities() const {
+  return provider_->GetCapabilities();
+}
+
+const TokenCounter& RateLimitedProvider::GetTokenCounter() const {
+  return provider_->GetTokenCounter();
+}
+
+size_t RateLimitedProvider::CountTokens(std::string_view text) const {
+  return provider_->GetTokenCounter().CountTokens(text);
+}
+
+bool RateLimitedProvider::SupportsTaskType(TaskType task_type) const {
+  return provider_->SupportsTaskType(task_type);
+}
+
+void RateLimitedProvider::ProcessRequest(const AIRequestParams& params,
+                                         AIResponseCallback callback) {
+  Enqueue(params, std::move(callback), AIStreamCallback());
+}
+
+void RateLimitedProvider::ProcessStreamingRequest(const AIRequestParams& params,
+                                                  AIStreamCallback callback) {
+  // A request rejected or cancelled while queued ends through the plain
+  // callback like any other
+  AIResponseCallback final_callback = base::BindOnce(
+      [](AIStreamCallback callback, bool success,
+         const std::string& response) {
+        callback.Run(MakeFinalStreamDelta(success, response));
+      },
+      callback);
+  Enqueue(params, std::move(final_callback), std::move(callback));
+}
+
+void RateLimitedProvider::Enqueue(const AIRequestParams& params,
+                                  AIResponseCallback callback,
+                                  AIStreamCallback stream_callback) {
+  if (params.cancellation_token && params.cancellation_token->IsCancelled()) {
+    std::move(callback).Run(false, kRequestCancelledError);
+    return;
+  }
+
+  PendingRequest request;
+  request.params = params;
+  request.callback = std::move(callback);
+  request.stream_callback = std::move(stream_callback);
+  request.estimated_tokens = CountTokens(params.input_text);
+  request.enqueue_time = base::TimeTicks::Now();
+  if (params.cancellation_token) {
+    request.cancel_subscription =
+        params.cancellation_token->AddCancelCallback(
+            base::BindOnce(&RateLimitedProvider::OnRequestCancelled,
+                           weak_ptr_factory_.GetWeakPtr()));
+  }
+  queue_.push_back(std::move(request));
+  PumpQueue();
+}
+
+void RateLimitedProvider::Configure(
+    const std::unordered_map<std::string, std::string>& config) {
+  provider_->Configure(config);
+  auto it = config.find(kConfigKeyApiKey);
+  if (it != config.end()) {
+    api_key_ = it->second;
+  }
+  // A new key may have quota to spare
+  PumpQueue();
+}
+
+std::unordered_map<std::string, std::string>
+RateLimitedProvider::GetConfiguration() const {
+  return provider_->GetConfiguration();
+}
+
+RateLimiter& RateLimitedProvider::GetLimiter() {
+  return limiters_.try_emplace(api_key_, options_.limits).first->second;
+}
+
+void RateLimitedProvider::PumpQueue() {
+  // Callbacks run from inside the loop may queue more requests; the outer
+  // loop picks those up
+  if (pumping_) {
+    return;
+  }
+  pumping_ = true;
+
+  while (!queue_.empty()) {
+    base::TimeTicks now = base::TimeTicks::Now();
+    RateLimiter& limiter = GetLimiter();
+    PendingRequest& front = queue_.front();
+    base::TimeDelta delay = limiter.GetDelay(front.estimated_tokens, now);
+
+    if (delay.is_zero()) {
+      PendingRequest request = std::move(front);
+      queue_.pop_front();
+      // The provider handles cancellation from here on
+      request.cancel_subscription = base::CallbackListSubscription();
+      limiter.Acquire(request.estimated_tokens, now);
+      AIRequestParams params = request.params;
+      if (request.stream_callback) {
+        provider_->ProcessStreamingRequest(
+            params, base::BindRepeating(
+                        &RateLimitedProvider::OnStreamDelta,
+                        weak_ptr_factory_.GetWeakPtr(),
+                        base::Owned(std::make_unique<PendingRequest>(
+                            std::move(request)))));
+      } else {
+        provider_->ProcessRequest(
+            params, base::BindOnce(&RateLimitedProvider::OnResponse,
+                                   weak_ptr_factory_.GetWeakPtr(),
+                                   std::move(request)));
+      }
+      continue;
+    }
+
+    // Waiting past the caller's own deadline is pointless too
+    bool misses_deadline = !front.params.deadline.is_null() &&
+                           now + delay > front.params.deadline;
+    if ((now - front.enqueue_time) + delay > options_.max_queue_delay ||
+        misses_deadline) {
+      AIResponseCallback callback = std::move(front.callback);
+      queue_.pop_front();
+      LOG(WARNING) << "Rate limit for " << GetProviderId()
+                   << " exceeded; rejecting queued request";
+      std::move(callback).Run(false,
+                              "Rate limit exceeded for " + GetProviderId());
+      continue;
+    }
+
+    SchedulePump(delay);
+    break;
+  }
+
+  pumping_ = false;
+}
+
+void RateLimitedProvider::OnRequestCancelled() {
+  // Detach the callbacks first; running them may queue more requests
+  std::vector<AIResponseCallback> cancelled;
+  for (auto it = queue_.begin(); it != queue_.end();) {
+    const scoped_refptr<CancellationToken>& token =
+        it->params.cancellation_token;
+    if (token && token->IsCancelled()) {
+      cancelled.push_back(std::move(it->callback));
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto& callback : cancelled) {
+    std::move(callback).Run(false, kRequestCancelledError);
+  }
+
+  // A smaller request may fit now that the head is gone
+  PumpQueue();
+}
+
+void RateLimitedProvider::SchedulePump(base::TimeDelta delay) {
+  if (pump_scheduled_) {
+    return;
+  }
+  pump_scheduled_ = true;
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](base::WeakPtr<RateLimitedProvider> self) {
+            if (!self) {
+              return;
+            }
+            self->pump_scheduled_ = false;
+            self->PumpQueue();
+          },
+          weak_ptr_factory_.GetWeakPtr()),
+      delay);
+}
+
+void RateLimitedProvider::OnResponse(PendingRequest request,
+                                     bool success,
+                                     const std::string& response) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  RateLimiter& limiter = GetLimiter();
+
+  if (success) {
+    limiter.OnSuccess();
+    limiter.AddTokenUsage(CountTokens(response), now);
+    std::move(request.callback).Run(true, response);
+    return;
+  }
+
+  if (MaybeRequeue(&request, response, now)) {
+    return;
+  }
+  std::move(request.callback).Run(false, response);
+}
+
+void RateLimitedProvider::OnStreamDelta(PendingRequest* request,
+                                        const StreamDelta& delta) {
+  if (!delta.is_final) {
+    request->delta_delivered = true;
+    request->streamed_tokens += CountTokens(delta.text);
+    request->stream_callback.Run(delta);
+    return;
+  }
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  RateLimiter& limiter = GetLimiter();
+  if (delta.success) {
+    limiter.OnSuccess();
+    size_t tokens = delta.usage
+                        ? static_cast<size_t>(delta.usage->completion_tokens)
+                        : request->streamed_tokens + CountTokens(delta.text);
+    limiter.AddTokenUsage(tokens, now);
+  } else if (!request->delta_delivered &&
+             MaybeRequeue(request, delta.error_message, now)) {
+    // |request| is owned by the callback running now; its state moved into
+    // the queue
+    return;
+  }
+  request->stream_callback.Run(delta);
+}
+
+bool RateLimitedProvider::MaybeRequeue(PendingRequest* request,
+                                       const std::string& error,
+                                       base::TimeTicks now) {
+  base::TimeDelta retry_after;
+  if (!IsRateLimitError(error, base::Time::Now(), &retry_after)) {
+    return false;
+  }
+  GetLimiter().OnRateLimited(retry_after, now);
+
+  const scoped_refptr<CancellationToken>& token =
+      request->params.cancellation_token;
+  if (request->rate_limit_retries >= options_.max_rate_limit_retries ||
+      (token && token->IsCancelled())) {
+    return false;
+  }
+  LOG(INFO) << GetProviderId() << " rate limited; requeueing request";
+  request->rate_limit_retries++;
+  request->enqueue_time = now;
+  if (token) {
+    request->cancel_subscription = token->AddCancelCallback(
+        base::BindOnce(&RateLimitedProvider::OnRequestCancelled,
+                       weak_ptr_factory_.GetWeakPtr()));
+  }
+  queue_.push_front(std::move(*request));
+  SchedulePump(base::TimeDelta());
+  return true;
+}
+
+}  // namespace core
+}  // namespace asol
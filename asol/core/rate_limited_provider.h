@@ -0,0 +1,140 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_RATE_LIMITED_PROVIDER_H_
+#define ASOL_CORE_RATE_LIMITED_PROVIDER_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "asol/core/ai_service_provider.h"
+#include "asol/core/rate_limiter.h"
+#include "base/callback_list.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// RateLimitedProvider wraps a provider and paces the requests sent to it.
+// Each API key gets its own RateLimiter, so switching keys via Configure()
+// does not inherit the old key's quota.
+//
+// Requests that cannot go out yet are queued in order and released as the
+// buckets refill. A 429 from the provider blocks the key for the server's
+// Retry-After and puts the request back at the head of the queue. A request
+// that would wait longer than |max_queue_delay|, or past its deadline,
+// fails with a rate-limit error instead, so callers with fallbacks can
+// route elsewhere. A queued request whose token is cancelled leaves the
+// queue at once. A stream's 429 is only requeued before any of its text
+// has been delivered.
+//
+// Must be used on a single sequence.
+class RateLimitedProvider : public AIServiceProvider {
+ public:
+  struct Options {
+    RateLimiter::Limits limits;
+    base::TimeDelta max_queue_delay = base::Seconds(10);
+    int max_rate_limit_retries = 2;
+  };
+
+  RateLimitedProvider(std::unique_ptr<AIServiceProvider> provider,
+                      const Options& options);
+  ~RateLimitedProvider() override;
+
+  RateLimitedProvider(const RateLimitedProvider&) = delete;
+  RateLimitedProvider& operator=(const RateLimitedProvider&) = delete;
+
+  // AIServiceProvider implementation
+  std::string GetProviderId() const override;
+  std::string GetProviderName() const override;
+  std::string GetProviderVersion() const override;
+  Capabilities GetCapabilities() const override;
+  const TokenCounter& GetTokenCounter() const override;
+  bool SupportsTaskType(TaskType task_type) const override;
+  void ProcessRequest(const AIRequestParams& params,
+                      AIResponseCallback callback) override;
+  void ProcessStreamingRequest(const AIRequestParams& params,
+                               AIStreamCallback callback) override;
+  void Configure(
+      const std::unordered_map<std::string, std::string>& config) override;
+  std::unordered_map<std::string, std::string> GetConfiguration()
+      const override;
+
+  // Number of requests waiting for quota
+  size_t queued_requests() const { return queue_.size(); }
+
+ private:
+  struct PendingRequest {
+    PendingRequest();
+    PendingRequest(PendingRequest&&);
+    PendingRequest& operator=(PendingRequest&&);
+    ~PendingRequest();
+
+    AIRequestParams params;
+    // Ends the request when it is rejected or cancelled while queued, and
+    // when it is not a stream
+    AIResponseCallback callback;
+    // Set for streams; receives every delta once the request is sent
+    AIStreamCallback stream_callback;
+    size_t estimated_tokens = 0;
+    base::TimeTicks enqueue_time;
+    int rate_limit_retries = 0;
+    // Held while queued
+    base::CallbackListSubscription cancel_subscription;
+    // Whether the stream has passed text on to the caller, after which a
+    // 429 is no longer requeued
+    bool delta_delivered = false;
+    size_t streamed_tokens = 0;
+  };
+
+  void Enqueue(const AIRequestParams& params,
+               AIResponseCallback callback,
+               AIStreamCallback stream_callback);
+
+  // Tokens |text| costs in the provider's tokenizer
+  size_t CountTokens(std::string_view text) const;
+
+  // Limiter for the API key currently configured
+  RateLimiter& GetLimiter();
+
+  // Send queued requests while quota allows, then schedule the next pump
+  void PumpQueue();
+  void SchedulePump(base::TimeDelta delay);
+
+  // Fail the queued requests whose tokens were cancelled
+  void OnRequestCancelled();
+
+  void OnResponse(PendingRequest request,
+                  bool success,
+                  const std::string& response);
+  void OnStreamDelta(PendingRequest* request, const StreamDelta& delta);
+
+  // On a 429, block the key and put |request| back at the head of the queue
+  // unless it is out of retries or cancelled. Returns whether it was
+  // requeued, in which case |request| has been moved from.
+  bool MaybeRequeue(PendingRequest* request,
+                    const std::string& error,
+                    base::TimeTicks now);
+
+  std::unique_ptr<AIServiceProvider> provider_;
+  const Options options_;
+
+  std::string api_key_;
+  std::unordered_map<std::string, RateLimiter> limiters_;
+
+  std::deque<PendingRequest> queue_;
+  bool pumping_ = false;
+  bool pump_scheduled_ = false;
+
+  base::WeakPtrFactory<RateLimitedProvider> weak_ptr_factory_{this};
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_RATE_LIMITED_PROVIDER_H_
@@ -0,0 +1,142 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/rate_limited_provider.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/strings/strcat.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+// Provider that answers synchronously and can reject the next few requests
+// with a 429.
+class FakeProvider : public AIServiceProvider {
+ public:
+  std::string GetProviderId() const override { return "fake"; }
+  std::string GetProviderName() const override { return "Fake"; }
+  std::string GetProviderVersion() const override { return "1.0"; }
+  Capabilities GetCapabilities() const override { return Capabilities(); }
+  bool SupportsTaskType(TaskType task_type) const override { return true; }
+  void ProcessRequest(const AIRequestParams& params,
+                      AIResponseCallback callback) override {
+    request_count_++;
+    if (rate_limited_responses_ > 0) {
+      rate_limited_responses_--;
+      std::move(callback).Run(false, "HTTP error: 429 (Retry-After: 5)");
+      return;
+    }
+    std::move(callback).Run(true,
+                            base::StrCat({"response:", params.input_text}));
+  }
+  void Configure(
+      const std::unordered_map<std::string, std::string>& config) override {}
+  std::unordered_map<std::string, std::string> GetConfiguration()
+      const override {
+    return {};
+  }
+
+  int request_count() const { return request_count_; }
+  void set_rate_limited_responses(int count) {
+    rate_limited_responses_ = count;
+  }
+
+ private:
+  int request_count_ = 0;
+  int rate_limited_responses_ = 0;
+};
+
+class RateLimitedProviderTest : public testing::Test {
+ protected:
+  void CreateProvider(const RateLimitedProvider::Options& options) {
+    auto provider = std::make_unique<FakeProvider>();
+    fake_ = provider.get();
+    provider_ =
+        std::make_unique<RateLimitedProvider>(std::move(provider), options);
+  }
+
+  void Send(const std::string& input) {
+    AIServiceProvider::AIRequestParams params;
+    params.input_text = input;
+    provider_->ProcessRequest(
+        params, base::BindOnce(
+                    [](std::vector<std::pair<bool, std::string>>* results,
+                       bool success, const std::string& response) {
+                      results->emplace_back(success, response);
+                    },
+                    &results_));
+  }
+
+  static RateLimitedProvider::Options OneRequestPerSecond() {
+    RateLimitedProvider::Options options;
+    options.limits.requests_per_second = 1.0;
+    options.limits.request_burst = 1.0;
+    return options;
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  FakeProvider* fake_ = nullptr;
+  std::unique_ptr<RateLimitedProvider> provider_;
+  std::vector<std::pair<bool, std::string>> results_;
+};
+
+TEST_F(RateLimitedProviderTest, QueuesRequestsOverTheLimit) {
+  CreateProvider(OneRequestPerSecond());
+
+  Send("a");
+  Send("b");
+  EXPECT_EQ(fake_->request_count(), 1);
+  EXPECT_EQ(provider_->queued_requests(), 1u);
+
+  task_environment_.FastForwardBy(base::Seconds(1));
+  EXPECT_EQ(fake_->request_count(), 2);
+  ASSERT_EQ(results_.size(), 2u);
+  EXPECT_EQ(results_[1].second, "response:b");
+}
+
+TEST_F(RateLimitedProviderTest, RetriesAfterServerRetryAfter) {
+  CreateProvider(OneRequestPerSecond());
+  fake_->set_rate_limited_responses(1);
+
+  Send("a");
+  EXPECT_EQ(fake_->request_count(), 1);
+  EXPECT_TRUE(results_.empty());
+
+  task_environment_.FastForwardBy(base::Seconds(4));
+  EXPECT_EQ(fake_->request_count(), 1);
+
+  task_environment_.FastForwardBy(base::Seconds(1));
+  EXPECT_EQ(fake_->request_count(), 2);
+  ASSERT_EQ(results_.size(), 1u);
+  EXPECT_TRUE(results_[0].first);
+}
+
+TEST_F(RateLimitedProviderTest, RejectsRequestsThatWouldWaitTooLong) {
+  RateLimitedProvider::Options options = OneRequestPerSecond();
+  options.max_queue_delay = base::Seconds(2);
+  CreateProvider(options);
+  fake_->set_rate_limited_responses(1);
+
+  Send("a");
+  task_environment_.RunUntilIdle();
+
+  EXPECT_EQ(fake_->request_count(), 1);
+  ASSERT_EQ(results_.size(), 1u);
+  EXPECT_FALSE(results_[0].first);
+  EXPECT_EQ(results_[0].second, "Rate limit exceeded for fake");
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
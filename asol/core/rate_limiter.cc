@@ -0,0 +1,144 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/rate_limiter.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// How adapters format a 429 failure, and the marker for the server's hint
+constexpr char kRateLimitErrorPrefix[] = "HTTP error: 429";
+constexpr char kRetryAfterMarker[] = "Retry-After: ";
+
+// Back-off after 429s without a Retry-After: 1s, 2s, 4s... capped at 64s
+constexpr int kMaxBackoffShift = 6;
+
+}  // namespace
+
+TokenBucket::TokenBucket(double capacity, double refill_per_second)
+    : capacity_(capacity),
+      refill_per_second_(refill_per_second),
+      level_(capacity) {}
+
+base::TimeDelta TokenBucket::TimeUntilAvailable(double amount,
+                                                base::TimeTicks now) {
+  Refill(now);
+  amount = std::min(amount, capacity_);
+  if (level_ >= amount) {
+    return base::TimeDelta();
+  }
+  if (refill_per_second_ <= 0.0) {
+    return base::TimeDelta::Max();
+  }
+  return base::Seconds((amount - level_) / refill_per_second_);
+}
+
+void TokenBucket::Consume(double amount, base::TimeTicks now) {
+  Refill(now);
+  level_ -= amount;
+}
+
+void TokenBucket::Refill(base::TimeTicks now) {
+  if (!last_refill_.is_null() && now > last_refill_) {
+    level_ = std::min(capacity_, level_ + (now - last_refill_).InSecondsF() *
+                                              refill_per_second_);
+  }
+  if (last_refill_.is_null() || now > last_refill_) {
+    last_refill_ = now;
+  }
+}
+
+RateLimiter::RateLimiter(const Limits& limits)
+    : requests_(limits.request_burst, limits.requests_per_second),
+      tokens_(limits.tokens_per_minute, limits.tokens_per_minute / 60.0) {}
+
+RateLimiter::~RateLimiter() = default;
+
+base::TimeDelta RateLimiter::GetDelay(size_t tokens, base::TimeTicks now) {
+  base::TimeDelta delay;
+  if (blocked_until_ > now) {
+    delay = blocked_until_ - now;
+  }
+  delay = std::max(delay, requests_.TimeUntilAvailable(1.0, now));
+  delay = std::max(delay, tokens_.TimeUntilAvailable(
+                              static_cast<double>(tokens), now));
+  return delay;
+}
+
+void RateLimiter::Acquire(size_t tokens, base::TimeTicks now) {
+  requests_.Consume(1.0, now);
+  tokens_.Consume(static_cast<double>(tokens), now);
+}
+
+void RateLimiter::AddTokenUsage(size_t tokens, base::TimeTicks now) {
+  tokens_.Consume(static_cast<double>(tokens), now);
+}
+
+void RateLimiter::OnRateLimited(base::TimeDelta retry_after,
+                                base::TimeTicks now) {
+  if (retry_after <= base::TimeDelta()) {
+    retry_after = base::Seconds(
+        int64_t{1} << std::min(consecutive_rate_limits_, kMaxBackoffShift));
+  }
+  consecutive_rate_limits_++;
+  blocked_until_ = std::max(blocked_until_, now + retry_after);
+}
+
+void RateLimiter::OnSuccess() {
+  consecutive_rate_limits_ = 0;
+}
+
+bool ParseRetryAfter(std::string_view value,
+                     base::Time now,
+                     base::TimeDelta* delay) {
+  value = base::TrimWhitespaceASCII(value, base::TRIM_ALL);
+  if (value.empty()) {
+    return false;
+  }
+
+  int64_t seconds = 0;
+  if (base::StringToInt64(value, &seconds)) {
+    if (seconds < 0) {
+      return false;
+    }
+    *delay = base::Seconds(seconds);
+    return true;
+  }
+
+  base::Time retry_time;
+  if (!base::Time::FromUTCString(std::string(value).c_str(), &retry_time)) {
+    return false;
+  }
+  *delay = std::max(base::TimeDelta(), retry_time - now);
+  return true;
+}
+
+bool IsRateLimitError(std::string_view error,
+                      base::Time now,
+                      base::TimeDelta* retry_after) {
+  if (!base::StartsWith(error, kRateLimitErrorPrefix)) {
+    return false;
+  }
+
+  *retry_after = base::TimeDelta();
+  size_t marker = error.find(kRetryAfterMarker);
+  if (marker != std::string_view::npos) {
+    std::string_view value =
+        error.substr(marker + sizeof(kRetryAfterMarker) - 1);
+    value = value.substr(0, value.find(')'));
+    ParseRetryAfter(value, now, retry_after);
+  }
+  return true;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,97 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_RATE_LIMITER_H_
+#define ASOL_CORE_RATE_LIMITER_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// Classic token bucket: holds up to |capacity| tokens and refills
+// continuously at |refill_per_second|. Not thread-safe.
+class TokenBucket {
+ public:
+  TokenBucket(double capacity, double refill_per_second);
+
+  // Time until |amount| tokens are available; zero if they are now.
+  // Amounts above capacity are treated as a full bucket.
+  base::TimeDelta TimeUntilAvailable(double amount, base::TimeTicks now);
+
+  // Take |amount| tokens. The level may go negative, which delays later
+  // callers until the debt is repaid.
+  void Consume(double amount, base::TimeTicks now);
+
+  double capacity() const { return capacity_; }
+
+ private:
+  void Refill(base::TimeTicks now);
+
+  double capacity_;
+  double refill_per_second_;
+  double level_;
+  base::TimeTicks last_refill_;
+};
+
+// RateLimiter paces requests to one provider account. It combines a
+// requests-per-second bucket, a tokens-per-minute bucket, and a hard stop
+// learned from the server's 429 responses.
+// Not thread-safe.
+class RateLimiter {
+ public:
+  struct Limits {
+    double requests_per_second = 2.0;
+    double request_burst = 5.0;
+    double tokens_per_minute = 60000.0;
+  };
+
+  explicit RateLimiter(const Limits& limits);
+  ~RateLimiter();
+
+  // Delay before a request estimated at |tokens| may be sent; zero means
+  // it may go now
+  base::TimeDelta GetDelay(size_t tokens, base::TimeTicks now);
+
+  // Charge a request that is being sent now
+  void Acquire(size_t tokens, base::TimeTicks now);
+
+  // Charge additional tokens once the actual usage is known
+  void AddTokenUsage(size_t tokens, base::TimeTicks now);
+
+  // The server rejected a request with 429. |retry_after| is zero when the
+  // server did not say; the limiter then backs off exponentially.
+  void OnRateLimited(base::TimeDelta retry_after, base::TimeTicks now);
+
+  // The server accepted a request; resets the 429 back-off
+  void OnSuccess();
+
+ private:
+  TokenBucket requests_;
+  TokenBucket tokens_;
+  base::TimeTicks blocked_until_;
+  int consecutive_rate_limits_ = 0;
+};
+
+// Parse a Retry-After header value, either delta-seconds or an HTTP-date
+// relative to |now|
+bool ParseRetryAfter(std::string_view value,
+                     base::Time now,
+                     base::TimeDelta* delay);
+
+// Whether |error| is a provider rate-limit rejection. Adapters report HTTP
+// failures as "HTTP error: <code>..." and append "Retry-After: <value>" when
+// the server sent one; |retry_after| is set from it, or to zero.
+bool IsRateLimitError(std::string_view error,
+                      base::Time now,
+                      base::TimeDelta* retry_after);
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_RATE_LIMITER_H_
@@ -0,0 +1,92 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/rate_limiter.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+RateLimiter::Limits MakeLimits() {
+  RateLimiter::Limits limits;
+  limits.requests_per_second = 1.0;
+  limits.request_burst = 2.0;
+  limits.tokens_per_minute = 600.0;  // 10 tokens a second
+  return limits;
+}
+
+TEST(TokenBucketTest, RefillsOverTime) {
+  TokenBucket bucket(2.0, 1.0);
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  bucket.Consume(2.0, now);
+  EXPECT_EQ(bucket.TimeUntilAvailable(1.0, now), base::Seconds(1));
+  EXPECT_TRUE(bucket.TimeUntilAvailable(1.0, now + base::Seconds(1)).is_zero());
+}
+
+TEST(RateLimiterTest, AllowsBurstThenPaces) {
+  RateLimiter limiter(MakeLimits());
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(limiter.GetDelay(1, now).is_zero());
+    limiter.Acquire(1, now);
+  }
+  EXPECT_EQ(limiter.GetDelay(1, now), base::Seconds(1));
+}
+
+TEST(RateLimiterTest, PacesOnTokensPerMinute) {
+  RateLimiter limiter(MakeLimits());
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  limiter.Acquire(600, now);
+  EXPECT_EQ(limiter.GetDelay(100, now), base::Seconds(10));
+}
+
+TEST(RateLimiterTest, HonorsRetryAfterAndBacksOffWithoutIt) {
+  RateLimiter limiter(MakeLimits());
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  limiter.OnRateLimited(base::Seconds(30), now);
+  EXPECT_EQ(limiter.GetDelay(1, now), base::Seconds(30));
+
+  now += base::Seconds(30);
+  limiter.OnRateLimited(base::TimeDelta(), now);
+  EXPECT_EQ(limiter.GetDelay(1, now), base::Seconds(2));
+
+  limiter.OnSuccess();
+  now += base::Seconds(2);
+  limiter.OnRateLimited(base::TimeDelta(), now);
+  EXPECT_EQ(limiter.GetDelay(1, now), base::Seconds(1));
+}
+
+TEST(RateLimiterTest, ParsesRetryAfter) {
+  base::Time now;
+  ASSERT_TRUE(base::Time::FromUTCString("Wed, 21 Oct 2015 07:28:00 GMT", &now));
+
+  base::TimeDelta delay;
+  EXPECT_TRUE(ParseRetryAfter(" 120 ", now, &delay));
+  EXPECT_EQ(delay, base::Seconds(120));
+  EXPECT_TRUE(ParseRetryAfter("Wed, 21 Oct 2015 07:28:45 GMT", now, &delay));
+  EXPECT_EQ(delay, base::Seconds(45));
+  EXPECT_FALSE(ParseRetryAfter("soon", now, &delay));
+}
+
+TEST(RateLimiterTest, RecognizesRateLimitErrors) {
+  base::TimeDelta retry_after;
+  EXPECT_TRUE(IsRateLimitError("HTTP error: 429 (Retry-After: 7): slow down",
+                               base::Time::Now(), &retry_after));
+  EXPECT_EQ(retry_after, base::Seconds(7));
+  EXPECT_TRUE(IsRateLimitError("HTTP error: 429: quota", base::Time::Now(),
+                               &retry_after));
+  EXPECT_TRUE(retry_after.is_zero());
+  EXPECT_FALSE(IsRateLimitError("HTTP error: 500", base::Time::Now(),
+                                &retry_after));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
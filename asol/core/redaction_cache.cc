@@ -0,0 +1,103 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/redaction_cache.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Approximate bookkeeping cost of one entry (list node, index slot)
+constexpr size_t kEntryOverheadBytes = 96;
+
+}  // namespace
+
+RedactionCache::RedactionCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+RedactionCache::~RedactionCache() = default;
+
+// static
+RequestFingerprint RedactionCache::ComputeKey(uint64_t rules_version,
+                                              std::string_view paragraph) {
+  Hasher128 hasher(rules_version);
+  hasher.Update(paragraph);
+  return hasher.Finish();
+}
+
+bool RedactionCache::AppendTo(const RequestFingerprint& key,
+                              uint64_t rules_version,
+                              std::string_view paragraph,
+                              PiiRedactor::Result* result) {
+  base::AutoLock lock(lock_);
+  auto it = index_.find(key);
+  if (it == index_.end() ||
+      it->second->second.rules_version != rules_version ||
+      it->second->second.paragraph != paragraph) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  lru_.splice(lru_.begin(), lru_, it->second);
+
+  const Entry& entry = it->second->second;
+  result->text += entry.text;
+  result->num_redactions += entry.num_redactions;
+  for (const auto& [category, count] : entry.redaction_categories) {
+    result->redaction_categories[category] += count;
+  }
+  return true;
+}
+
+void RedactionCache::Put(const RequestFingerprint& key,
+                         uint64_t rules_version,
+                         std::string_view paragraph,
+                         const PiiRedactor::Result& redacted) {
+  Entry entry;
+  entry.rules_version = rules_version;
+  entry.paragraph = std::string(paragraph);
+  entry.text = redacted.text;
+  entry.num_redactions = redacted.num_redactions;
+  entry.redaction_categories.assign(redacted.redaction_categories.begin(),
+                                    redacted.redaction_categories.end());
+  entry.charge =
+      entry.paragraph.size() + entry.text.size() + kEntryOverheadBytes;
+  for (const auto& [category, count] : entry.redaction_categories) {
+    entry.charge += category.size();
+  }
+  if (entry.charge > max_bytes_) {
+    return;
+  }
+
+  base::AutoLock lock(lock_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    // Another worker redacted the same paragraph meanwhile, or a colliding
+    // one holds the slot
+    return;
+  }
+  while (!lru_.empty() && bytes_ + entry.charge > max_bytes_) {
+    bytes_ -= lru_.back().second.charge;
+    index_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+  bytes_ += entry.charge;
+  lru_.emplace_front(key, std::move(entry));
+  index_[key] = lru_.begin();
+}
+
+void RedactionCache::Clear() {
+  base::AutoLock lock(lock_);
+  index_.clear();
+  lru_.clear();
+  bytes_ = 0;
+}
+
+size_t RedactionCache::GetByteSize() const {
+  base::AutoLock lock(lock_);
+  return bytes_;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,102 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_REDACTION_CACHE_H_
+#define ASOL_CORE_REDACTION_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asol/core/pii_redactor.h"
+#include "asol/core/request_fingerprint.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+namespace asol {
+namespace core {
+
+// RedactionCache remembers how recently seen paragraphs were redacted, so
+// a page that is summarized, searched and queried by several features, or
+// re-read after a small change, only has its new paragraphs redacted.
+//
+// Entries are keyed by a 128-bit hash of the paragraph together with a
+// version of the rules it was redacted under; whoever changes the rules
+// (privacy level, consent, custom patterns) moves to a new version and the
+// old entries age out of the LRU. The hash is not keyed, so entries also
+// keep their paragraph and version and a hit must match both: a paragraph
+// crafted to collide with another is never given its redaction. Bounded by
+// bytes of original and redacted text.
+//
+// Safe to use from any thread.
+class RedactionCache : public base::RefCountedThreadSafe<RedactionCache> {
+ public:
+  explicit RedactionCache(size_t max_bytes);
+
+  RedactionCache(const RedactionCache&) = delete;
+  RedactionCache& operator=(const RedactionCache&) = delete;
+
+  static RequestFingerprint ComputeKey(uint64_t rules_version,
+                                       std::string_view paragraph);
+
+  // Append the cached redaction of |paragraph| under |rules_version|, whose
+  // key is |key|, to |result| and return true, or return false on a miss.
+  bool AppendTo(const RequestFingerprint& key,
+                uint64_t rules_version,
+                std::string_view paragraph,
+                PiiRedactor::Result* result);
+
+  // Remember |redacted|, the redaction of |paragraph|.
+  void Put(const RequestFingerprint& key,
+           uint64_t rules_version,
+           std::string_view paragraph,
+           const PiiRedactor::Result& redacted);
+
+  void Clear();
+
+  size_t GetHitCount() const { return hits_.load(std::memory_order_relaxed); }
+  size_t GetMissCount() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+  size_t GetByteSize() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<RedactionCache>;
+
+  struct Entry {
+    uint64_t rules_version = 0;
+    std::string paragraph;
+    std::string text;
+    int num_redactions = 0;
+    std::vector<std::pair<std::string, int>> redaction_categories;
+    size_t charge = 0;
+  };
+  using LruList = std::list<std::pair<RequestFingerprint, Entry>>;
+
+  ~RedactionCache();
+
+  const size_t max_bytes_;
+
+  mutable base::Lock lock_;
+  size_t bytes_ GUARDED_BY(lock_) = 0;
+  LruList lru_ GUARDED_BY(lock_);
+  std::unordered_map<RequestFingerprint,
+                     LruList::iterator,
+                     RequestFingerprint::Hash>
+      index_ GUARDED_BY(lock_);
+
+  std::atomic<size_t> hits_{0};
+  std::atomic<size_t> misses_{0};
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_REDACTION_CACHE_H_
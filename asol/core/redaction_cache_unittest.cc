@@ -0,0 +1,99 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/redaction_cache.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+PiiRedactor::Result MakeRedacted(const std::string& text, int redactions) {
+  PiiRedactor::Result result;
+  result.text = text;
+  result.num_redactions = redactions;
+  if (redactions > 0) {
+    result.redaction_categories["email"] = redactions;
+  }
+  return result;
+}
+
+TEST(RedactionCacheTest, AppendsCachedParagraph) {
+  auto cache = base::MakeRefCounted<RedactionCache>(1024);
+  RequestFingerprint key = RedactionCache::ComputeKey(1, "mail a@b.io");
+  cache->Put(key, 1, "mail a@b.io", MakeRedacted("mail [EMAIL]", 1));
+
+  PiiRedactor::Result result = MakeRedacted("before ", 1);
+  ASSERT_TRUE(cache->AppendTo(key, 1, "mail a@b.io", &result));
+  EXPECT_EQ(result.text, "before mail [EMAIL]");
+  EXPECT_EQ(result.num_redactions, 2);
+  EXPECT_EQ(result.redaction_categories["email"], 2);
+  EXPECT_EQ(cache->GetHitCount(), 1u);
+}
+
+TEST(RedactionCacheTest, RulesVersionIsPartOfTheKey) {
+  auto cache = base::MakeRefCounted<RedactionCache>(1024);
+  cache->Put(RedactionCache::ComputeKey(1, "text"), 1, "text",
+             MakeRedacted("text", 0));
+
+  PiiRedactor::Result result;
+  EXPECT_FALSE(cache->AppendTo(RedactionCache::ComputeKey(2, "text"), 2,
+                               "text", &result));
+  EXPECT_FALSE(cache->AppendTo(RedactionCache::ComputeKey(1, "text2"), 1,
+                               "text2", &result));
+  EXPECT_EQ(cache->GetMissCount(), 2u);
+}
+
+TEST(RedactionCacheTest, HitMustMatchParagraphAndVersion) {
+  auto cache = base::MakeRefCounted<RedactionCache>(1024);
+  RequestFingerprint key = RedactionCache::ComputeKey(1, "mail a@b.io");
+  cache->Put(key, 1, "mail a@b.io", MakeRedacted("mail [EMAIL]", 1));
+
+  // As if other input hashed to the same key
+  PiiRedactor::Result result;
+  EXPECT_FALSE(cache->AppendTo(key, 1, "mail c@d.io", &result));
+  EXPECT_FALSE(cache->AppendTo(key, 2, "mail a@b.io", &result));
+  EXPECT_TRUE(result.text.empty());
+
+  // and it does not displace the entry it collides with
+  cache->Put(key, 1, "mail c@d.io", MakeRedacted("mail [EMAIL]", 1));
+  EXPECT_TRUE(cache->AppendTo(key, 1, "mail a@b.io", &result));
+  EXPECT_EQ(cache->GetMissCount(), 2u);
+}
+
+TEST(RedactionCacheTest, EvictsLeastRecentlyUsedBeyondByteLimit) {
+  // Room for two entries of this size with their overhead
+  auto cache = base::MakeRefCounted<RedactionCache>(500);
+  std::string text(100, 'x');
+  RequestFingerprint a = RedactionCache::ComputeKey(1, "a");
+  RequestFingerprint b = RedactionCache::ComputeKey(1, "b");
+  RequestFingerprint c = RedactionCache::ComputeKey(1, "c");
+  cache->Put(a, 1, "a", MakeRedacted(text, 0));
+  cache->Put(b, 1, "b", MakeRedacted(text, 0));
+
+  PiiRedactor::Result result;
+  ASSERT_TRUE(cache->AppendTo(a, 1, "a", &result));
+  cache->Put(c, 1, "c", MakeRedacted(text, 0));
+
+  EXPECT_TRUE(cache->AppendTo(a, 1, "a", &result));
+  EXPECT_FALSE(cache->AppendTo(b, 1, "b", &result));
+  EXPECT_TRUE(cache->AppendTo(c, 1, "c", &result));
+  EXPECT_LE(cache->GetByteSize(), 500u);
+}
+
+TEST(RedactionCacheTest, OversizedParagraphIsNotCached) {
+  auto cache = base::MakeRefCounted<RedactionCache>(100);
+  RequestFingerprint key = RedactionCache::ComputeKey(1, "long");
+  cache->Put(key, 1, "long", MakeRedacted(std::string(200, 'x'), 0));
+  PiiRedactor::Result result;
+  EXPECT_FALSE(cache->AppendTo(key, 1, "long", &result));
+  EXPECT_EQ(cache->GetByteSize(), 0u);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
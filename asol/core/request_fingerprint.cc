@@ -0,0 +1,228 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/request_fingerprint.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+constexpr uint64_t kC1 = 0x87c37b91114253d5ull;
+constexpr uint64_t kC2 = 0x4cf5ad432745937full;
+
+// Seed for the per-parameter hashes, distinct from the request hash
+constexpr uint64_t kParamSeed = 0x5ab1e5eedull;
+
+inline uint64_t RotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t Mix(uint64_t k) {
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdull;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ull;
+  k ^= k >> 33;
+  return k;
+}
+
+// Length-prefixed, so no field can run into the next
+void AppendField(std::string_view field, std::string* out) {
+  out->append(base::NumberToString(field.size()));
+  out->push_back(':');
+  out->append(field);
+}
+
+}  // namespace
+
+std::string RequestFingerprint::ToString() const {
+  return base::StringPrintf("%016llx%016llx-%08x-%04x-%04x",
+                            static_cast<unsigned long long>(high),
+                            static_cast<unsigned long long>(low), input_size,
+                            param_count, task_type);
+}
+
+Hasher128::Hasher128(uint64_t seed) : h1_(seed), h2_(seed) {}
+
+void Hasher128::Update(const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  total_size_ += size;
+
+  // Top up a partially filled block first
+  if (buffer_size_ > 0) {
+    size_t take = std::min(size, sizeof(buffer_) - buffer_size_);
+    memcpy(buffer_ + buffer_size_, bytes, take);
+    buffer_size_ += take;
+    bytes += take;
+    size -= take;
+    if (buffer_size_ < sizeof(buffer_)) {
+      return;
+    }
+    ProcessBlock(buffer_);
+    buffer_size_ = 0;
+  }
+
+  // Whole blocks straight from the caller's memory
+  while (size >= sizeof(buffer_)) {
+    ProcessBlock(bytes);
+    bytes += sizeof(buffer_);
+    size -= sizeof(buffer_);
+  }
+
+  memcpy(buffer_, bytes, size);
+  buffer_size_ = size;
+}
+
+RequestFingerprint Hasher128::Finish() const {
+  uint64_t h1 = h1_;
+  uint64_t h2 = h2_;
+
+  // Tail bytes, as in the reference implementation
+  uint64_t k1 = 0;
+  uint64_t k2 = 0;
+  for (size_t i = buffer_size_; i > 8; --i) {
+    k2 ^= static_cast<uint64_t>(buffer_[i - 1]) << ((i - 9) * 8);
+  }
+  for (size_t i = std::min<size_t>(buffer_size_, 8); i > 0; --i) {
+    k1 ^= static_cast<uint64_t>(buffer_[i - 1]) << ((i - 1) * 8);
+  }
+  if (buffer_size_ > 8) {
+    k2 *= kC2;
+    k2 = RotateLeft(k2, 33);
+    k2 *= kC1;
+    h2 ^= k2;
+  }
+  if (buffer_size_ > 0) {
+    k1 *= kC1;
+    k1 = RotateLeft(k1, 31);
+    k1 *= kC2;
+    h1 ^= k1;
+  }
+
+  h1 ^= total_size_;
+  h2 ^= total_size_;
+  h1 += h2;
+  h2 += h1;
+  h1 = Mix(h1);
+  h2 = Mix(h2);
+  h1 += h2;
+  h2 += h1;
+
+  RequestFingerprint fingerprint;
+  fingerprint.high = h1;
+  // Reserve all-zero for "no fingerprint"
+  fingerprint.low = (h1 == 0 && h2 == 0) ? 1 : h2;
+  return fingerprint;
+}
+
+void Hasher128::ProcessBlock(const uint8_t* block) {
+  uint64_t k1;
+  uint64_t k2;
+  memcpy(&k1, block, sizeof(k1));
+  memcpy(&k2, block + sizeof(k1), sizeof(k2));
+
+  k1 *= kC1;
+  k1 = RotateLeft(k1, 31);
+  k1 *= kC2;
+  h1_ ^= k1;
+  h1_ = RotateLeft(h1_, 27);
+  h1_ += h2_;
+  h1_ = h1_ * 5 + 0x52dce729;
+
+  k2 *= kC2;
+  k2 = RotateLeft(k2, 33);
+  k2 *= kC1;
+  h2_ ^= k2;
+  h2_ = RotateLeft(h2_, 31);
+  h2_ += h1_;
+  h2_ = h2_ * 5 + 0x38495ab5;
+}
+
+RequestFingerprint ComputeRequestFingerprint(
+    AIServiceProvider::TaskType task_type,
+    std::string_view input_text,
+    const std::unordered_map<std::string, std::string>& params) {
+  // Sum the per-parameter digests: addition commutes, so iteration order
+  // does not matter and nothing needs sorting.
+  uint64_t params_high = 0;
+  uint64_t params_low = 0;
+  for (const auto& [key, value] : params) {
+    Hasher128 param_hasher(kParamSeed);
+    param_hasher.UpdateUint64(key.size());
+    param_hasher.Update(key);
+    param_hasher.Update(value);
+    RequestFingerprint param = param_hasher.Finish();
+    params_high += param.high;
+    params_low += param.low;
+  }
+
+  Hasher128 hasher;
+  hasher.UpdateUint64(static_cast<uint64_t>(task_type));
+  hasher.UpdateUint64(params_high);
+  hasher.UpdateUint64(params_low);
+  hasher.Update(input_text);
+
+  RequestFingerprint fingerprint = hasher.Finish();
+  fingerprint.input_size = static_cast<uint32_t>(input_text.size());
+  fingerprint.param_count = static_cast<uint16_t>(params.size());
+  fingerprint.task_type = static_cast<uint16_t>(task_type);
+  return fingerprint;
+}
+
+RequestKey::RequestKey() = default;
+
+RequestKey::RequestKey(const AIServiceProvider::AIRequestParams& request)
+    : task_type(request.task_type),
+      input_text(request.input_text),
+      params(request.custom_params) {}
+
+RequestKey::RequestKey(const RequestKey&) = default;
+RequestKey& RequestKey::operator=(const RequestKey&) = default;
+RequestKey::RequestKey(RequestKey&&) = default;
+RequestKey& RequestKey::operator=(RequestKey&&) = default;
+RequestKey::~RequestKey() = default;
+
+bool RequestKey::Matches(
+    const AIServiceProvider::AIRequestParams& request) const {
+  return task_type == request.task_type &&
+         input_text.view() == request.input_text.view() &&
+         params == request.custom_params;
+}
+
+size_t RequestKey::EstimateSize() const {
+  size_t size = input_text.size();
+  for (const auto& [key, value] : params) {
+    size += key.size() + value.size();
+  }
+  return size;
+}
+
+std::string RequestKey::Serialize() const {
+  std::vector<std::pair<std::string_view, std::string_view>> sorted(
+      params.begin(), params.end());
+  std::sort(sorted.begin(), sorted.end());
+
+  std::string serialized;
+  serialized.reserve(EstimateSize() + 16 * (sorted.size() + 1));
+  AppendField(base::NumberToString(static_cast<int>(task_type)), &serialized);
+  AppendField(input_text.view(), &serialized);
+  AppendField(base::NumberToString(sorted.size()), &serialized);
+  for (const auto& [key, value] : sorted) {
+    AppendField(key, &serialized);
+    AppendField(value, &serialized);
+  }
+  return serialized;
+}
+
+}  // namespace core
+}  // namespace asol
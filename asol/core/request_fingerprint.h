@@ -0,0 +1,118 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_REQUEST_FINGERPRINT_H_
+#define ASOL_CORE_REQUEST_FINGERPRINT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "asol/core/ai_service_provider.h"
+#include "asol/core/shared_text.h"
+
+namespace asol {
+namespace core {
+
+// RequestFingerprint is the fixed-width cache key for an AI request: a
+// 128-bit hash of the request plus a few structural fields (task type, input
+// length, parameter count). Equality compares all of them, so two requests
+// only share a key if their 128-bit hashes collide *and* their shapes match.
+struct RequestFingerprint {
+  uint64_t high = 0;
+  uint64_t low = 0;
+  uint32_t input_size = 0;
+  uint16_t param_count = 0;
+  uint16_t task_type = 0;
+
+  // A default-constructed fingerprint is empty. Computed fingerprints never
+  // are.
+  bool IsEmpty() const { return high == 0 && low == 0; }
+
+  // Fixed-length hex form, for logs and on-disk keys
+  std::string ToString() const;
+
+  bool operator==(const RequestFingerprint& other) const {
+    return high == other.high && low == other.low &&
+           input_size == other.input_size &&
+           param_count == other.param_count && task_type == other.task_type;
+  }
+  bool operator!=(const RequestFingerprint& other) const {
+    return !(*this == other);
+  }
+
+  struct Hash {
+    size_t operator()(const RequestFingerprint& fingerprint) const {
+      return static_cast<size_t>(fingerprint.low);
+    }
+  };
+};
+
+// Streaming 128-bit hasher (MurmurHash3 x64/128 block function). Update()
+// never allocates, so hashing a multi-hundred-KB page is one pass over the
+// bytes in place.
+class Hasher128 {
+ public:
+  explicit Hasher128(uint64_t seed = 0);
+
+  void Update(const void* data, size_t size);
+  void Update(std::string_view data) { Update(data.data(), data.size()); }
+  void UpdateUint64(uint64_t value) { Update(&value, sizeof(value)); }
+
+  // Digest of everything fed so far. Does not reset the hasher.
+  RequestFingerprint Finish() const;
+
+ private:
+  void ProcessBlock(const uint8_t* block);
+
+  uint64_t h1_;
+  uint64_t h2_;
+  uint64_t total_size_ = 0;
+  uint8_t buffer_[16];
+  size_t buffer_size_ = 0;
+};
+
+// Fingerprint of a request. Parameters are combined order-independently, so
+// the result does not depend on unordered_map iteration order.
+RequestFingerprint ComputeRequestFingerprint(
+    AIServiceProvider::TaskType task_type,
+    std::string_view input_text,
+    const std::unordered_map<std::string, std::string>& params);
+
+// The request a fingerprint stands for. Cache entries keep it next to the
+// fingerprint they are indexed by, and a lookup is a hit only if it is the
+// same request: two requests whose fingerprints collide never get each
+// other's response. The input text is shared with the request, not copied.
+struct RequestKey {
+  RequestKey();
+  explicit RequestKey(const AIServiceProvider::AIRequestParams& request);
+  RequestKey(const RequestKey&);
+  RequestKey& operator=(const RequestKey&);
+  RequestKey(RequestKey&&);
+  RequestKey& operator=(RequestKey&&);
+  ~RequestKey();
+
+  // Whether |request| is the request this key was made from. Does not
+  // allocate.
+  bool Matches(const AIServiceProvider::AIRequestParams& request) const;
+
+  // Approximate bytes held, for cache budgets
+  size_t EstimateSize() const;
+
+  // Self-delimiting encoding, with the parameters sorted, for the on-disk
+  // tier: equal requests give equal strings.
+  std::string Serialize() const;
+
+  AIServiceProvider::TaskType task_type =
+      AIServiceProvider::TaskType::TEXT_GENERATION;
+  SharedText input_text;
+  std::unordered_map<std::string, std::string> params;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_REQUEST_FINGERPRINT_H_
@@ -0,0 +1,112 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/request_fingerprint.h"
+
+#include <string>
+#include <unordered_map>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+using TaskType = AIServiceProvider::TaskType;
+
+TEST(RequestFingerprintTest, StreamingMatchesOneShot) {
+  const std::string input(1000, 'x');
+  Hasher128 one_shot;
+  one_shot.Update(input);
+
+  Hasher128 streaming;
+  for (size_t i = 0; i < input.size(); i += 7) {
+    streaming.Update(input.substr(i, 7));
+  }
+  EXPECT_EQ(one_shot.Finish(), streaming.Finish());
+}
+
+TEST(RequestFingerprintTest, ParamOrderDoesNotMatter) {
+  std::unordered_map<std::string, std::string> params;
+  params["temperature"] = "0.2";
+  params["model"] = "small";
+  std::unordered_map<std::string, std::string> reordered(params.begin(),
+                                                         params.end());
+  reordered.rehash(64);
+
+  EXPECT_EQ(ComputeRequestFingerprint(TaskType::TRANSLATION, "hi", params),
+            ComputeRequestFingerprint(TaskType::TRANSLATION, "hi", reordered));
+}
+
+TEST(RequestFingerprintTest, DistinguishesRequests) {
+  std::unordered_map<std::string, std::string> params;
+  RequestFingerprint base =
+      ComputeRequestFingerprint(TaskType::TEXT_GENERATION, "hello", params);
+  EXPECT_FALSE(base.IsEmpty());
+  EXPECT_NE(base, ComputeRequestFingerprint(TaskType::TRANSLATION, "hello",
+                                            params));
+  EXPECT_NE(base, ComputeRequestFingerprint(TaskType::TEXT_GENERATION,
+                                            "hello!", params));
+
+  params["k"] = "v";
+  EXPECT_NE(base, ComputeRequestFingerprint(TaskType::TEXT_GENERATION,
+                                            "hello", params));
+  // Swapping key and value must not collide.
+  std::unordered_map<std::string, std::string> swapped;
+  swapped["v"] = "k";
+  EXPECT_NE(
+      ComputeRequestFingerprint(TaskType::TEXT_GENERATION, "hello", params),
+      ComputeRequestFingerprint(TaskType::TEXT_GENERATION, "hello", swapped));
+}
+
+TEST(RequestFingerprintTest, ToStringIsFixedLength) {
+  RequestFingerprint a =
+      ComputeRequestFingerprint(TaskType::CUSTOM, "", {});
+  RequestFingerprint b =
+      ComputeRequestFingerprint(TaskType::CUSTOM, std::string(500, 'a'), {});
+  EXPECT_EQ(a.ToString().size(), b.ToString().size());
+  EXPECT_NE(a.ToString(), b.ToString());
+}
+
+TEST(RequestKeyTest, MatchesOnlyItsRequest) {
+  AIServiceProvider::AIRequestParams params;
+  params.task_type = TaskType::TRANSLATION;
+  params.input_text = "hello";
+  params.custom_params["to"] = "fr";
+  RequestKey key(params);
+  EXPECT_TRUE(key.Matches(params));
+  EXPECT_TRUE(key.input_text.SharesBufferWith(params.input_text));
+
+  AIServiceProvider::AIRequestParams other = params;
+  other.input_text = "hello!";
+  EXPECT_FALSE(key.Matches(other));
+  other = params;
+  other.custom_params["to"] = "de";
+  EXPECT_FALSE(key.Matches(other));
+  other = params;
+  other.task_type = TaskType::TEXT_GENERATION;
+  EXPECT_FALSE(key.Matches(other));
+}
+
+TEST(RequestKeyTest, SerializeIsCanonicalAndUnambiguous) {
+  AIServiceProvider::AIRequestParams params;
+  params.task_type = TaskType::CUSTOM;
+  params.input_text = "ab";
+  params.custom_params["model"] = "small";
+  params.custom_params["temperature"] = "0.2";
+  AIServiceProvider::AIRequestParams reordered = params;
+  reordered.custom_params.rehash(64);
+  EXPECT_EQ(RequestKey(params).Serialize(), RequestKey(reordered).Serialize());
+
+  // Moving bytes between fields must change the encoding
+  AIServiceProvider::AIRequestParams shifted = params;
+  shifted.custom_params.clear();
+  shifted.custom_params["mode"] = "lsmall";
+  shifted.custom_params["temperature"] = "0.2";
+  EXPECT_NE(RequestKey(params).Serialize(), RequestKey(shifted).Serialize());
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
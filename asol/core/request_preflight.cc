@@ -0,0 +1,81 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/request_preflight.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Where to end a chunk of |piece|, which fits: after its last line break,
+// else its last space, if that keeps at least half of it
+size_t FindChunkEnd(std::string_view piece) {
+  size_t half = piece.size() / 2;
+  size_t end = piece.rfind('\n');
+  if (end == std::string_view::npos || end < half) {
+    end = piece.rfind(' ');
+  }
+  if (end == std::string_view::npos || end < half) {
+    return piece.size();
+  }
+  return end + 1;
+}
+
+// Length of the UTF-8 sequence |text| starts with
+size_t SequenceLength(std::string_view text) {
+  size_t length = 1;
+  while (length < text.size() &&
+         (static_cast<unsigned char>(text[length]) & 0xC0) == 0x80) {
+    length++;
+  }
+  return length;
+}
+
+}  // namespace
+
+PreflightResult::PreflightResult() = default;
+PreflightResult::PreflightResult(const PreflightResult&) = default;
+PreflightResult& PreflightResult::operator=(const PreflightResult&) = default;
+PreflightResult::~PreflightResult() = default;
+
+PreflightResult PreflightInput(const TokenCounter& counter,
+                               std::string_view input,
+                               size_t max_input_tokens,
+                               InputOverflow overflow) {
+  PreflightResult result;
+  result.input_tokens = counter.CountTokens(input);
+  result.fits =
+      max_input_tokens == 0 || result.input_tokens <= max_input_tokens;
+  if (result.fits) {
+    result.inputs.push_back(input);
+    return result;
+  }
+
+  switch (overflow) {
+    case InputOverflow::kReject:
+      break;
+    case InputOverflow::kTruncate:
+      result.inputs.push_back(
+          input.substr(0, counter.FitPrefix(input, max_input_tokens)));
+      break;
+    case InputOverflow::kChunk: {
+      std::string_view rest = input;
+      while (!rest.empty()) {
+        size_t length = counter.FitPrefix(rest, max_input_tokens);
+        if (length < rest.size()) {
+          length = length == 0 ? SequenceLength(rest)
+                               : FindChunkEnd(rest.substr(0, length));
+        }
+        result.inputs.push_back(rest.substr(0, length));
+        rest.remove_prefix(length);
+      }
+      break;
+    }
+  }
+  return result;
+}
+
+}  // namespace core
+}  // namespace asol
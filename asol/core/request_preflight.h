@@ -0,0 +1,58 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_REQUEST_PREFLIGHT_H_
+#define ASOL_CORE_REQUEST_PREFLIGHT_H_
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "asol/core/token_counter.h"
+
+namespace asol {
+namespace core {
+
+// What to do with input longer than the model accepts
+enum class InputOverflow {
+  // Fail locally instead of uploading a request the provider will reject
+  kReject,
+  // Keep the longest prefix that fits
+  kTruncate,
+  // Split into consecutive pieces that each fit, for callers that combine
+  // partial answers, e.g. map-reduce summarization
+  kChunk,
+};
+
+struct PreflightResult {
+  PreflightResult();
+  PreflightResult(const PreflightResult&);
+  PreflightResult& operator=(const PreflightResult&);
+  ~PreflightResult();
+
+  // Tokens of the whole input
+  size_t input_tokens = 0;
+
+  // Whether the input fits as it is
+  bool fits = false;
+
+  // What to send, viewing the input: the input itself when it fits, its
+  // longest fitting prefix when truncated, the pieces in order when
+  // chunked. Empty when rejected.
+  std::vector<std::string_view> inputs;
+};
+
+// Size |input| with |counter| against |max_input_tokens|, 0 meaning no
+// limit, and apply |overflow| when it does not fit. Chunks end after a
+// line break or space where one falls in the second half of the piece, so
+// words and paragraphs stay whole.
+PreflightResult PreflightInput(const TokenCounter& counter,
+                               std::string_view input,
+                               size_t max_input_tokens,
+                               InputOverflow overflow);
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_REQUEST_PREFLIGHT_H_
@@ -0,0 +1,83 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/request_preflight.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+// The approximate counter charges one token per four bytes, plus one
+const TokenCounter& Counter() {
+  return GetApproximateTokenCounter();
+}
+
+TEST(RequestPreflightTest, PassesInputThatFits) {
+  std::string input = "hello world";
+  PreflightResult result =
+      PreflightInput(Counter(), input, 100, InputOverflow::kReject);
+
+  EXPECT_TRUE(result.fits);
+  EXPECT_EQ(result.input_tokens, 3u);
+  ASSERT_EQ(result.inputs.size(), 1u);
+  EXPECT_EQ(result.inputs[0], input);
+}
+
+TEST(RequestPreflightTest, RejectsOversizedInput) {
+  std::string input(100, 'a');
+  PreflightResult result =
+      PreflightInput(Counter(), input, 10, InputOverflow::kReject);
+
+  EXPECT_FALSE(result.fits);
+  EXPECT_EQ(result.input_tokens, 26u);
+  EXPECT_TRUE(result.inputs.empty());
+}
+
+TEST(RequestPreflightTest, TruncatesToLimit) {
+  std::string input(100, 'a');
+  PreflightResult result =
+      PreflightInput(Counter(), input, 10, InputOverflow::kTruncate);
+
+  EXPECT_FALSE(result.fits);
+  ASSERT_EQ(result.inputs.size(), 1u);
+  EXPECT_EQ(result.inputs[0].size(), 39u);
+  EXPECT_LE(Counter().CountTokens(result.inputs[0]), 10u);
+}
+
+TEST(RequestPreflightTest, ChunksAtWordBoundaries) {
+  std::string input;
+  for (int i = 0; i < 40; ++i) {
+    input += "word ";
+  }
+  PreflightResult result =
+      PreflightInput(Counter(), input, 10, InputOverflow::kChunk);
+
+  ASSERT_GT(result.inputs.size(), 1u);
+  std::string joined;
+  for (std::string_view chunk : result.inputs) {
+    EXPECT_LE(Counter().CountTokens(chunk), 10u);
+    EXPECT_EQ(chunk.back(), ' ');
+    joined += chunk;
+  }
+  EXPECT_EQ(joined, input);
+}
+
+TEST(RequestPreflightTest, ApproximateCounterKeepsSequencesWhole) {
+  // Two bytes per character, so odd limits land mid-character
+  std::string input;
+  for (int i = 0; i < 20; ++i) {
+    input += "\xC3\xA9";
+  }
+  size_t length = Counter().FitPrefix(input, 5);
+  EXPECT_EQ(length, 18u);
+  EXPECT_NE(static_cast<unsigned char>(input[length]) & 0xC0, 0x80);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
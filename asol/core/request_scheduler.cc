@@ -0,0 +1,190 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/request_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/logging.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+size_t Index(RequestPriority priority) {
+  return static_cast<size_t>(priority);
+}
+
+}  // namespace
+
+const char kRequestPriorityParam[] = "priority";
+
+const char* RequestPriorityToString(RequestPriority priority) {
+  switch (priority) {
+    case RequestPriority::INTERACTIVE:
+      return "interactive";
+    case RequestPriority::PREFETCH:
+      return "prefetch";
+    case RequestPriority::BACKGROUND:
+      return "background";
+  }
+  return "interactive";
+}
+
+bool StringToRequestPriority(std::string_view value,
+                             RequestPriority* priority) {
+  for (size_t i = 0; i < kRequestPriorityCount; ++i) {
+    auto candidate = static_cast<RequestPriority>(i);
+    if (value == RequestPriorityToString(candidate)) {
+      *priority = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+RequestScheduler::QueuedRequest::QueuedRequest() = default;
+RequestScheduler::QueuedRequest::QueuedRequest(QueuedRequest&&) = default;
+RequestScheduler::QueuedRequest& RequestScheduler::QueuedRequest::operator=(
+    QueuedRequest&&) = default;
+RequestScheduler::QueuedRequest::~QueuedRequest() = default;
+
+RequestScheduler::RequestScheduler() : RequestScheduler(Options()) {}
+
+RequestScheduler::RequestScheduler(const Options& options)
+    : options_(options) {}
+
+RequestScheduler::~RequestScheduler() = default;
+
+RequestScheduler::RequestId RequestScheduler::Schedule(
+    RequestPriority priority,
+    StartCallback start,
+    base::OnceClosure on_preempted) {
+  RequestId id = next_id_++;
+  auto& queue = queues_[Index(priority)];
+
+  size_t max_queued = options_.max_queued_per_priority[Index(priority)];
+  if (max_queued > 0 && queue.size() >= max_queued) {
+    PreemptOldest(priority);
+  }
+
+  QueuedRequest request;
+  request.id = id;
+  request.start = std::move(start);
+  request.on_preempted = std::move(on_preempted);
+  queue.push_back(std::move(request));
+
+  PumpQueues();
+
+  // An interactive request still waiting means the slots are contended;
+  // background work queued behind it would only add to the backlog
+  if (priority == RequestPriority::INTERACTIVE &&
+      options_.preempt_background_for_interactive &&
+      !queues_[Index(RequestPriority::INTERACTIVE)].empty()) {
+    while (!queues_[Index(RequestPriority::BACKGROUND)].empty()) {
+      PreemptOldest(RequestPriority::BACKGROUND);
+    }
+  }
+
+  return id;
+}
+
+bool RequestScheduler::Cancel(RequestId id) {
+  for (auto& queue : queues_) {
+    auto it = std::find_if(
+        queue.begin(), queue.end(),
+        [id](const QueuedRequest& request) { return request.id == id; });
+    if (it != queue.end()) {
+      queue.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t RequestScheduler::GetRunningCount(RequestPriority priority) const {
+  return running_[Index(priority)];
+}
+
+size_t RequestScheduler::GetQueuedCount(RequestPriority priority) const {
+  return queues_[Index(priority)].size();
+}
+
+bool RequestScheduler::HasCapacity(RequestPriority priority) const {
+  return total_running_ < options_.max_concurrent_requests &&
+         running_[Index(priority)] <
+             options_.max_concurrent_per_priority[Index(priority)];
+}
+
+void RequestScheduler::PumpQueues() {
+  // Work started from inside the loop may finish synchronously and pump
+  // again; the outer loop picks up whatever it frees
+  if (pumping_) {
+    return;
+  }
+  pumping_ = true;
+
+  bool started = true;
+  while (started) {
+    started = false;
+    for (size_t i = 0; i < kRequestPriorityCount; ++i) {
+      auto priority = static_cast<RequestPriority>(i);
+      auto& queue = queues_[i];
+      if (queue.empty() || !HasCapacity(priority)) {
+        continue;
+      }
+
+      QueuedRequest request = std::move(queue.front());
+      queue.pop_front();
+      running_[i]++;
+      total_running_++;
+      stats_.started[i]++;
+
+      // |done| frees the slot when run or when dropped unrun, so a caller
+      // that loses its callback cannot leak capacity
+      base::OnceClosure done = base::BindOnce(
+          [](base::ScopedClosureRunner runner) { runner.RunAndReset(); },
+          base::ScopedClosureRunner(
+              base::BindOnce(&RequestScheduler::OnRequestFinished,
+                             weak_ptr_factory_.GetWeakPtr(), priority)));
+      std::move(request.start).Run(std::move(done));
+
+      // Re-scan from the top so higher classes go first
+      started = true;
+      break;
+    }
+  }
+
+  pumping_ = false;
+}
+
+void RequestScheduler::PreemptOldest(RequestPriority priority) {
+  auto& queue = queues_[Index(priority)];
+  if (queue.empty()) {
+    return;
+  }
+
+  QueuedRequest request = std::move(queue.front());
+  queue.pop_front();
+  stats_.preempted[Index(priority)]++;
+  DVLOG(1) << "Preempted queued " << RequestPriorityToString(priority)
+           << " request " << request.id;
+  if (request.on_preempted) {
+    std::move(request.on_preempted).Run();
+  }
+}
+
+void RequestScheduler::OnRequestFinished(RequestPriority priority) {
+  DCHECK_GT(running_[Index(priority)], 0u);
+  running_[Index(priority)]--;
+  total_running_--;
+  PumpQueues();
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,137 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_REQUEST_SCHEDULER_H_
+#define ASOL_CORE_REQUEST_SCHEDULER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string_view>
+
+#include "base/functional/callback.h"
+#include "base/memory/weak_ptr.h"
+
+namespace asol {
+namespace core {
+
+// Priority classes for AI work, highest first
+enum class RequestPriority {
+  INTERACTIVE = 0,  // The user is waiting on the result
+  PREFETCH = 1,     // Likely to be shown soon, e.g. auto-summaries
+  BACKGROUND = 2,   // Analysis nobody is waiting for
+};
+
+constexpr size_t kRequestPriorityCount = 3;
+
+// Key in AIRequestParams::custom_params that carries the priority class
+extern const char kRequestPriorityParam[];
+
+const char* RequestPriorityToString(RequestPriority priority);
+bool StringToRequestPriority(std::string_view value,
+                             RequestPriority* priority);
+
+// RequestScheduler decides when AI work may start, so background analysis
+// and prefetching cannot starve user-initiated requests of provider
+// concurrency and rate-limit budget.
+//
+// Work is dispatched in strict priority order, FIFO within a class, subject
+// to a global concurrency cap and a cap per class. Queued work of lower
+// classes is preemptible: when an interactive request has to wait, queued
+// background work is shed, and any class sheds its oldest entry once its
+// queue is full. Work that has started is never interrupted.
+//
+// Must be used on a single sequence.
+class RequestScheduler {
+ public:
+  using RequestId = uint64_t;
+
+  // Invoked when the request may start. |done| must be run, or destroyed,
+  // once the work has finished; either frees the slot.
+  using StartCallback = base::OnceCallback<void(base::OnceClosure done)>;
+
+  struct Options {
+    // Requests running at once across all classes
+    size_t max_concurrent_requests = 4;
+
+    // Requests running at once per class, indexed by RequestPriority
+    std::array<size_t, kRequestPriorityCount> max_concurrent_per_priority = {
+        4, 2, 1};
+
+    // Queue length per class before the oldest entry is shed; zero means
+    // unbounded
+    std::array<size_t, kRequestPriorityCount> max_queued_per_priority = {0, 16,
+                                                                         32};
+
+    // Shed queued background work whenever an interactive request waits
+    bool preempt_background_for_interactive = true;
+  };
+
+  struct Stats {
+    std::array<size_t, kRequestPriorityCount> started = {};
+    std::array<size_t, kRequestPriorityCount> preempted = {};
+  };
+
+  RequestScheduler();
+  explicit RequestScheduler(const Options& options);
+  ~RequestScheduler();
+
+  RequestScheduler(const RequestScheduler&) = delete;
+  RequestScheduler& operator=(const RequestScheduler&) = delete;
+
+  // Queue |start| at |priority|. It may run before this returns. If the
+  // request is shed before starting, |on_preempted| runs instead.
+  RequestId Schedule(RequestPriority priority,
+                     StartCallback start,
+                     base::OnceClosure on_preempted = base::OnceClosure());
+
+  // Drop a request that has not started. Returns false if it has already
+  // started or is unknown. |on_preempted| is not run.
+  bool Cancel(RequestId id);
+
+  size_t GetRunningCount(RequestPriority priority) const;
+  size_t GetQueuedCount(RequestPriority priority) const;
+  Stats GetStats() const { return stats_; }
+
+ private:
+  struct QueuedRequest {
+    QueuedRequest();
+    QueuedRequest(QueuedRequest&&);
+    QueuedRequest& operator=(QueuedRequest&&);
+    ~QueuedRequest();
+
+    RequestId id = 0;
+    StartCallback start;
+    base::OnceClosure on_preempted;
+  };
+
+  // Whether another request of |priority| may start now
+  bool HasCapacity(RequestPriority priority) const;
+
+  // Start queued requests while capacity allows
+  void PumpQueues();
+
+  // Shed the oldest queued request of |priority|
+  void PreemptOldest(RequestPriority priority);
+
+  void OnRequestFinished(RequestPriority priority);
+
+  const Options options_;
+
+  std::array<std::deque<QueuedRequest>, kRequestPriorityCount> queues_;
+  std::array<size_t, kRequestPriorityCount> running_ = {};
+  size_t total_running_ = 0;
+
+  RequestId next_id_ = 1;
+  bool pumping_ = false;
+  Stats stats_;
+
+  base::WeakPtrFactory<RequestScheduler> weak_ptr_factory_{this};
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_REQUEST_SCHEDULER_H_
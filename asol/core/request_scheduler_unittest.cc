@@ -0,0 +1,147 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/request_scheduler.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+class RequestSchedulerTest : public testing::Test {
+ protected:
+  static RequestScheduler::Options MakeOptions() {
+    RequestScheduler::Options options;
+    options.max_concurrent_requests = 2;
+    options.max_concurrent_per_priority = {2, 1, 1};
+    options.max_queued_per_priority = {0, 2, 2};
+    return options;
+  }
+
+  // Schedule work named |name|; its |done| closure is held until Finish()
+  RequestScheduler::RequestId Add(RequestPriority priority,
+                                  const std::string& name) {
+    return scheduler_.Schedule(
+        priority,
+        base::BindOnce(
+            [](RequestSchedulerTest* self, std::string name,
+               base::OnceClosure done) {
+              self->started_.push_back(name);
+              self->running_.emplace_back(name, std::move(done));
+            },
+            base::Unretained(this), name),
+        base::BindOnce(
+            [](RequestSchedulerTest* self, std::string name) {
+              self->preempted_.push_back(name);
+            },
+            base::Unretained(this), name));
+  }
+
+  void Finish(const std::string& name) {
+    for (auto it = running_.begin(); it != running_.end(); ++it) {
+      if (it->first == name) {
+        base::OnceClosure done = std::move(it->second);
+        running_.erase(it);
+        std::move(done).Run();
+        return;
+      }
+    }
+    ADD_FAILURE() << name << " is not running";
+  }
+
+  RequestScheduler scheduler_{MakeOptions()};
+  std::vector<std::string> started_;
+  std::vector<std::string> preempted_;
+  std::vector<std::pair<std::string, base::OnceClosure>> running_;
+};
+
+TEST_F(RequestSchedulerTest, EnforcesPerClassCaps) {
+  Add(RequestPriority::BACKGROUND, "bg1");
+  Add(RequestPriority::BACKGROUND, "bg2");
+
+  EXPECT_EQ(started_, std::vector<std::string>({"bg1"}));
+  EXPECT_EQ(scheduler_.GetQueuedCount(RequestPriority::BACKGROUND), 1u);
+
+  // The second slot is still free for interactive work
+  Add(RequestPriority::INTERACTIVE, "ui1");
+  EXPECT_EQ(started_, std::vector<std::string>({"bg1", "ui1"}));
+
+  Finish("bg1");
+  EXPECT_EQ(started_, std::vector<std::string>({"bg1", "ui1", "bg2"}));
+}
+
+TEST_F(RequestSchedulerTest, DispatchesHigherClassesFirst) {
+  Add(RequestPriority::INTERACTIVE, "ui1");
+  Add(RequestPriority::INTERACTIVE, "ui2");
+  Add(RequestPriority::PREFETCH, "pf1");
+  Add(RequestPriority::INTERACTIVE, "ui3");
+
+  Finish("ui1");
+  EXPECT_EQ(started_, std::vector<std::string>({"ui1", "ui2", "ui3"}));
+
+  Finish("ui2");
+  EXPECT_EQ(started_.back(), "pf1");
+}
+
+TEST_F(RequestSchedulerTest, InteractiveWaitPreemptsQueuedBackground) {
+  Add(RequestPriority::INTERACTIVE, "ui1");
+  Add(RequestPriority::BACKGROUND, "bg1");
+  Add(RequestPriority::BACKGROUND, "bg2");
+  EXPECT_EQ(started_, std::vector<std::string>({"ui1", "bg1"}));
+
+  Add(RequestPriority::INTERACTIVE, "ui2");
+  EXPECT_EQ(preempted_, std::vector<std::string>({"bg2"}));
+  EXPECT_EQ(scheduler_.GetStats().preempted[2], 1u);
+
+  // Running background work is left alone
+  Finish("bg1");
+  EXPECT_EQ(started_.back(), "ui2");
+}
+
+TEST_F(RequestSchedulerTest, FullQueueShedsOldest) {
+  Add(RequestPriority::PREFETCH, "pf1");
+  Add(RequestPriority::PREFETCH, "pf2");
+  Add(RequestPriority::PREFETCH, "pf3");
+  Add(RequestPriority::PREFETCH, "pf4");
+
+  EXPECT_EQ(preempted_, std::vector<std::string>({"pf2"}));
+  EXPECT_EQ(scheduler_.GetQueuedCount(RequestPriority::PREFETCH), 2u);
+}
+
+TEST_F(RequestSchedulerTest, DroppedDoneFreesSlot) {
+  scheduler_.Schedule(RequestPriority::BACKGROUND,
+                      base::BindOnce([](base::OnceClosure done) {}));
+  EXPECT_EQ(scheduler_.GetRunningCount(RequestPriority::BACKGROUND), 0u);
+
+  Add(RequestPriority::BACKGROUND, "bg1");
+  EXPECT_EQ(started_, std::vector<std::string>({"bg1"}));
+}
+
+TEST_F(RequestSchedulerTest, CancelRemovesQueuedRequest) {
+  Add(RequestPriority::BACKGROUND, "bg1");
+  RequestScheduler::RequestId id = Add(RequestPriority::BACKGROUND, "bg2");
+
+  EXPECT_TRUE(scheduler_.Cancel(id));
+  EXPECT_FALSE(scheduler_.Cancel(id));
+  Finish("bg1");
+  EXPECT_EQ(started_, std::vector<std::string>({"bg1"}));
+  EXPECT_TRUE(preempted_.empty());
+}
+
+TEST(RequestPriorityTest, ConvertsStrings) {
+  RequestPriority priority;
+  ASSERT_TRUE(StringToRequestPriority("background", &priority));
+  EXPECT_EQ(priority, RequestPriority::BACKGROUND);
+  EXPECT_FALSE(StringToRequestPriority("urgent", &priority));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,206 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/request_trace_recorder.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/files/file_util.h"
+#include "base/functional/bind.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/strings/string_split.h"
+#include "base/task/thread_pool.h"
+#include "base/values.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+using TaskType = AIServiceProvider::TaskType;
+
+constexpr struct {
+  TaskType task_type;
+  const char* name;
+} kTaskTypeNames[] = {
+    {TaskType::TEXT_GENERATION, "text_generation"},
+    {TaskType::TEXT_SUMMARIZATION, "text_summarization"},
+    {TaskType::CONTENT_ANALYSIS, "content_analysis"},
+    {TaskType::IMAGE_ANALYSIS, "image_analysis"},
+    {TaskType::CODE_GENERATION, "code_generation"},
+    {TaskType::QUESTION_ANSWERING, "question_answering"},
+    {TaskType::TRANSLATION, "translation"},
+    {TaskType::CUSTOM, "custom"},
+};
+
+constexpr struct {
+  RequestTraceRecorder::CacheOutcome outcome;
+  const char* name;
+} kCacheOutcomeNames[] = {
+    {RequestTraceRecorder::CacheOutcome::MISS, "miss"},
+    {RequestTraceRecorder::CacheOutcome::HIT, "hit"},
+    {RequestTraceRecorder::CacheOutcome::STALE_HIT, "stale"},
+};
+
+void TruncateFile(const base::FilePath& path) {
+  if (!base::WriteFile(path, "")) {
+    LOG(ERROR) << "Cannot create request trace " << path.value();
+  }
+}
+
+void AppendLines(const base::FilePath& path, const std::string& lines) {
+  if (!base::AppendToFile(path, lines)) {
+    LOG(ERROR) << "Cannot append to request trace " << path.value();
+  }
+}
+
+}  // namespace
+
+RequestTraceRecorder::RequestTraceRecorder(const base::FilePath& path)
+    : path_(path),
+      origin_(base::TimeTicks::Now()),
+      file_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
+           base::TaskShutdownBehavior::BLOCK_SHUTDOWN})) {
+  file_task_runner_->PostTask(FROM_HERE, base::BindOnce(&TruncateFile, path_));
+}
+
+RequestTraceRecorder::~RequestTraceRecorder() {
+  Flush();
+}
+
+void RequestTraceRecorder::Record(const Event& event) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  pending_lines_ += SerializeEvent(event);
+  pending_lines_ += '\n';
+  ++recorded_count_;
+  if (++pending_count_ >= kLinesPerWrite) {
+    Flush();
+  }
+}
+
+void RequestTraceRecorder::Flush() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (pending_lines_.empty()) {
+    return;
+  }
+  file_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(&AppendLines, path_, std::exchange(pending_lines_, {})));
+  pending_count_ = 0;
+}
+
+// static
+std::string RequestTraceRecorder::SerializeEvent(const Event& event) {
+  base::Value::Dict value;
+  value.Set("t_ms", event.start.InMillisecondsF());
+  value.Set("task", TaskTypeName(event.task_type));
+  value.Set("input_bytes", static_cast<int>(event.input_bytes));
+  value.Set("prompt_hash", event.prompt_hash);
+  value.Set("provider", event.provider_id);
+  for (const auto& entry : kCacheOutcomeNames) {
+    if (entry.outcome == event.cache_outcome) {
+      value.Set("cache", entry.name);
+    }
+  }
+  value.Set("latency_ms", event.latency.InMillisecondsF());
+  value.Set("success", event.success);
+  value.Set("output_bytes", static_cast<int>(event.output_bytes));
+
+  std::string line;
+  base::JSONWriter::Write(value, &line);
+  return line;
+}
+
+// static
+std::optional<RequestTraceRecorder::Event> RequestTraceRecorder::ParseEvent(
+    std::string_view line) {
+  absl::optional<base::Value> value = base::JSONReader::Read(line);
+  if (!value || !value->is_dict()) {
+    return std::nullopt;
+  }
+  const base::Value::Dict& dict = value->GetDict();
+  absl::optional<double> start_ms = dict.FindDouble("t_ms");
+  const std::string* task = dict.FindString("task");
+  absl::optional<int> input_bytes = dict.FindInt("input_bytes");
+  if (!start_ms || !task || !input_bytes || *input_bytes < 0) {
+    return std::nullopt;
+  }
+  std::optional<TaskType> task_type = TaskTypeFromName(*task);
+  if (!task_type) {
+    return std::nullopt;
+  }
+
+  Event event;
+  event.start = base::Milliseconds(*start_ms);
+  event.task_type = *task_type;
+  event.input_bytes = static_cast<size_t>(*input_bytes);
+  if (const std::string* prompt_hash = dict.FindString("prompt_hash")) {
+    event.prompt_hash = *prompt_hash;
+  }
+  if (const std::string* provider = dict.FindString("provider")) {
+    event.provider_id = *provider;
+  }
+  if (const std::string* cache = dict.FindString("cache")) {
+    for (const auto& entry : kCacheOutcomeNames) {
+      if (*cache == entry.name) {
+        event.cache_outcome = entry.outcome;
+      }
+    }
+  }
+  event.latency = base::Milliseconds(dict.FindDouble("latency_ms").value_or(0));
+  event.success = dict.FindBool("success").value_or(false);
+  event.output_bytes = static_cast<size_t>(
+      std::max(0, dict.FindInt("output_bytes").value_or(0)));
+  return event;
+}
+
+// static
+std::vector<RequestTraceRecorder::Event> RequestTraceRecorder::ReadTrace(
+    const base::FilePath& path) {
+  std::vector<Event> events;
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents)) {
+    LOG(ERROR) << "Cannot read request trace " << path.value();
+    return events;
+  }
+  for (std::string_view line :
+       base::SplitStringPiece(contents, "\n", base::TRIM_WHITESPACE,
+                              base::SPLIT_WANT_NONEMPTY)) {
+    std::optional<Event> event = ParseEvent(line);
+    if (event) {
+      events.push_back(std::move(*event));
+    } else {
+      LOG(WARNING) << "Skipping malformed request trace line: " << line;
+    }
+  }
+  return events;
+}
+
+// static
+const char* RequestTraceRecorder::TaskTypeName(TaskType task_type) {
+  for (const auto& entry : kTaskTypeNames) {
+    if (entry.task_type == task_type) {
+      return entry.name;
+    }
+  }
+  return "custom";
+}
+
+// static
+std::optional<AIServiceProvider::TaskType>
+RequestTraceRecorder::TaskTypeFromName(std::string_view name) {
+  for (const auto& entry : kTaskTypeNames) {
+    if (name == entry.name) {
+      return entry.task_type;
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,115 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_REQUEST_TRACE_RECORDER_H_
+#define ASOL_CORE_REQUEST_TRACE_RECORDER_H_
+
+#include <stddef.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "asol/core/ai_service_provider.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/sequence_checker.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// RequestTraceRecorder writes the shape of each AI request to a trace file,
+// so the production workload can be replayed later against a changed cache
+// policy, router or scheduler (see cmd/replay_request_trace). Nothing of
+// the request's text is kept: only its task, size, timing, provider, cache
+// outcome and its cache key, so repeated prompts can be told apart from new
+// ones. MultiAdapterManager::SetRequestTraceRecorder() records its requests.
+//
+// The file has one JSON object per line:
+//
+//   {"t_ms":1520,"task":"text_summarization","input_bytes":5120,
+//    "prompt_hash":"...","provider":"gemini","cache":"miss",
+//    "latency_ms":812,"success":true,"output_bytes":640}
+//
+// |t_ms| is the request's start since recording began. The gateway writes
+// the same format. Lines are buffered and appended on a background
+// sequence, so recording never blocks the caller on IO.
+//
+// Must be used on one sequence.
+class RequestTraceRecorder {
+ public:
+  enum class CacheOutcome {
+    MISS,       // Answered by a provider
+    HIT,        // Served from the response cache
+    STALE_HIT,  // Served stale from the cache while it was refreshed
+  };
+
+  struct Event {
+    // Since recording began
+    base::TimeDelta start;
+    AIServiceProvider::TaskType task_type =
+        AIServiceProvider::TaskType::TEXT_GENERATION;
+    size_t input_bytes = 0;
+    std::string prompt_hash;
+    std::string provider_id;
+    CacheOutcome cache_outcome = CacheOutcome::MISS;
+    base::TimeDelta latency;
+    bool success = false;
+    size_t output_bytes = 0;
+  };
+
+  // Lines buffered before they are appended to the file
+  static constexpr size_t kLinesPerWrite = 64;
+
+  // Record to |path|, replacing any file there. Needs the thread pool.
+  explicit RequestTraceRecorder(const base::FilePath& path);
+  // Writes the buffered lines
+  ~RequestTraceRecorder();
+
+  RequestTraceRecorder(const RequestTraceRecorder&) = delete;
+  RequestTraceRecorder& operator=(const RequestTraceRecorder&) = delete;
+
+  // When recording began; Event::start is measured from it
+  base::TimeTicks origin() const { return origin_; }
+
+  void Record(const Event& event);
+
+  // Append the buffered lines now
+  void Flush();
+
+  size_t recorded_count() const { return recorded_count_; }
+
+  // One line of the trace file, without the newline
+  static std::string SerializeEvent(const Event& event);
+  static std::optional<Event> ParseEvent(std::string_view line);
+
+  // The events of the trace at |path|, skipping lines that do not parse.
+  // Blocks on IO.
+  static std::vector<Event> ReadTrace(const base::FilePath& path);
+
+  // "text_generation", "text_summarization" and so on
+  static const char* TaskTypeName(AIServiceProvider::TaskType task_type);
+  static std::optional<AIServiceProvider::TaskType> TaskTypeFromName(
+      std::string_view name);
+
+ private:
+  const base::FilePath path_;
+  const base::TimeTicks origin_;
+  // Appends in order, with IO allowed
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+
+  std::string pending_lines_;
+  size_t pending_count_ = 0;
+  size_t recorded_count_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_REQUEST_TRACE_RECORDER_H_
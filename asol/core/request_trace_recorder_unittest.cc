@@ -0,0 +1,105 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/request_trace_recorder.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+using TaskType = AIServiceProvider::TaskType;
+
+RequestTraceRecorder::Event MakeEvent(int start_ms) {
+  RequestTraceRecorder::Event event;
+  event.start = base::Milliseconds(start_ms);
+  event.task_type = TaskType::TEXT_SUMMARIZATION;
+  event.input_bytes = 5120;
+  event.prompt_hash = "0123456789abcdef";
+  event.provider_id = "gemini";
+  event.cache_outcome = RequestTraceRecorder::CacheOutcome::STALE_HIT;
+  event.latency = base::Milliseconds(812);
+  event.success = true;
+  event.output_bytes = 640;
+  return event;
+}
+
+TEST(RequestTraceRecorderTest, EventRoundTrips) {
+  std::optional<RequestTraceRecorder::Event> event =
+      RequestTraceRecorder::ParseEvent(
+          RequestTraceRecorder::SerializeEvent(MakeEvent(1520)));
+  ASSERT_TRUE(event);
+  EXPECT_EQ(event->start, base::Milliseconds(1520));
+  EXPECT_EQ(event->task_type, TaskType::TEXT_SUMMARIZATION);
+  EXPECT_EQ(event->input_bytes, 5120u);
+  EXPECT_EQ(event->prompt_hash, "0123456789abcdef");
+  EXPECT_EQ(event->provider_id, "gemini");
+  EXPECT_EQ(event->cache_outcome,
+            RequestTraceRecorder::CacheOutcome::STALE_HIT);
+  EXPECT_EQ(event->latency, base::Milliseconds(812));
+  EXPECT_TRUE(event->success);
+  EXPECT_EQ(event->output_bytes, 640u);
+}
+
+TEST(RequestTraceRecorderTest, RejectsMalformedLines) {
+  EXPECT_FALSE(RequestTraceRecorder::ParseEvent("not json"));
+  EXPECT_FALSE(RequestTraceRecorder::ParseEvent(
+      R"({"task":"translation","input_bytes":10})"));
+  EXPECT_FALSE(RequestTraceRecorder::ParseEvent(
+      R"({"t_ms":1,"task":"juggling","input_bytes":10})"));
+  // The fields beyond the request's shape are optional
+  EXPECT_TRUE(RequestTraceRecorder::ParseEvent(
+      R"({"t_ms":1,"task":"translation","input_bytes":10})"));
+}
+
+TEST(RequestTraceRecorderTest, TaskTypeNamesRoundTrip) {
+  for (TaskType task_type :
+       {TaskType::TEXT_GENERATION, TaskType::TEXT_SUMMARIZATION,
+        TaskType::CONTENT_ANALYSIS, TaskType::IMAGE_ANALYSIS,
+        TaskType::CODE_GENERATION, TaskType::QUESTION_ANSWERING,
+        TaskType::TRANSLATION, TaskType::CUSTOM}) {
+    EXPECT_EQ(RequestTraceRecorder::TaskTypeFromName(
+                  RequestTraceRecorder::TaskTypeName(task_type)),
+              task_type);
+  }
+}
+
+TEST(RequestTraceRecorderTest, WritesEventsInOrder) {
+  base::test::TaskEnvironment task_environment;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().AppendASCII("requests.jsonl");
+  ASSERT_TRUE(base::WriteFile(path, "left over from an earlier run\n"));
+
+  {
+    RequestTraceRecorder recorder(path);
+    // More than one write's worth
+    for (size_t i = 0; i < RequestTraceRecorder::kLinesPerWrite + 3; ++i) {
+      recorder.Record(MakeEvent(static_cast<int>(i)));
+    }
+    EXPECT_EQ(recorder.recorded_count(),
+              RequestTraceRecorder::kLinesPerWrite + 3);
+  }
+  task_environment.RunUntilIdle();
+
+  std::vector<RequestTraceRecorder::Event> events =
+      RequestTraceRecorder::ReadTrace(path);
+  ASSERT_EQ(events.size(), RequestTraceRecorder::kLinesPerWrite + 3);
+  for (size_t i = 0; i < events.size(); ++i) {
+    EXPECT_EQ(events[i].start, base::Milliseconds(static_cast<int>(i)));
+  }
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
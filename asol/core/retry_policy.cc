@@ -0,0 +1,175 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/retry_policy.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Error prefixes used by the Chromium-backed and curl-backed clients
+constexpr char kHttpErrorPrefix[] = "HTTP error: ";
+constexpr char kNetworkErrorPrefix[] = "Network error: ";
+constexpr char kTransferFailedPrefix[] = "HTTP transfer failed: ";
+
+// Failures that happen before any byte of the request is sent
+constexpr const char* kConnectFailures[] = {
+    // net::Error names
+    "ERR_NAME_NOT_RESOLVED",
+    "ERR_NAME_RESOLUTION_FAILED",
+    "ERR_CONNECTION_REFUSED",
+    "ERR_ADDRESS_UNREACHABLE",
+    "ERR_INTERNET_DISCONNECTED",
+    // curl_easy_strerror() texts
+    "Couldn't resolve host name",
+    "Couldn't resolve proxy name",
+    "Couldn't connect to server",
+};
+
+// Failures caused by the caller giving up, not by the network
+constexpr const char* kAbortedFailures[] = {
+    "ERR_ABORTED",
+    "aborted by an application callback",
+};
+
+template <size_t N>
+bool ContainsAny(std::string_view text, const char* const (&markers)[N]) {
+  return std::any_of(markers, markers + N, [text](const char* marker) {
+    return text.find(marker) != std::string_view::npos;
+  });
+}
+
+FailureType ClassifyHttpStatus(int status) {
+  switch (status) {
+    case 408:  // Request Timeout
+    case 429:  // Too Many Requests
+    case 500:
+    case 502:
+    case 503:
+    case 504:
+      return FailureType::TRANSIENT;
+    default:
+      return FailureType::PERMANENT;
+  }
+}
+
+}  // namespace
+
+FailureType ClassifyFailure(std::string_view error) {
+  if (base::StartsWith(error, kHttpErrorPrefix)) {
+    std::string_view rest = error.substr(sizeof(kHttpErrorPrefix) - 1);
+    size_t digits = 0;
+    while (digits < rest.size() && base::IsAsciiDigit(rest[digits])) {
+      digits++;
+    }
+    int status = 0;
+    if (!base::StringToInt(rest.substr(0, digits), &status)) {
+      return FailureType::PERMANENT;
+    }
+    return ClassifyHttpStatus(status);
+  }
+
+  if (base::StartsWith(error, kNetworkErrorPrefix) ||
+      base::StartsWith(error, kTransferFailedPrefix)) {
+    if (ContainsAny(error, kAbortedFailures)) {
+      return FailureType::PERMANENT;
+    }
+    if (ContainsAny(error, kConnectFailures)) {
+      return FailureType::CONNECT_FAILED;
+    }
+    // Resets, timeouts and truncated responses
+    return FailureType::TRANSIENT;
+  }
+
+  return FailureType::PERMANENT;
+}
+
+bool IsTransportFailure(std::string_view error) {
+  return (base::StartsWith(error, kNetworkErrorPrefix) ||
+          base::StartsWith(error, kTransferFailedPrefix)) &&
+         !ContainsAny(error, kAbortedFailures);
+}
+
+bool IsHttpError(std::string_view error) {
+  return base::StartsWith(error, kHttpErrorPrefix);
+}
+
+RetryPolicy::RetryPolicy() : RetryPolicy(Config()) {}
+
+RetryPolicy::RetryPolicy(const Config& config) : config_(config) {}
+
+RetryPolicy::~RetryPolicy() = default;
+
+bool RetryPolicy::ShouldRetry(std::string_view error,
+                              int attempts_made,
+                              bool idempotent,
+                              base::TimeDelta time_left,
+                              base::TimeDelta* delay) const {
+  if (attempts_made >= config_.max_attempts) {
+    return false;
+  }
+
+  FailureType type = ClassifyFailure(error);
+  if (type == FailureType::PERMANENT ||
+      (type == FailureType::TRANSIENT && !idempotent)) {
+    return false;
+  }
+
+  base::TimeDelta wait = GetBackoff(attempts_made);
+  base::TimeDelta retry_after;
+  if (IsRateLimitError(error, base::Time::Now(), &retry_after)) {
+    wait = std::max(wait, retry_after);
+  }
+
+  // An attempt that cannot start before the deadline would only waste quota
+  if (wait >= time_left) {
+    return false;
+  }
+  *delay = wait;
+  return true;
+}
+
+base::TimeDelta RetryPolicy::GetBackoff(int retry) const {
+  double ceiling = config_.initial_backoff.InSecondsF() *
+                   std::pow(config_.backoff_multiplier, std::max(0, retry - 1));
+  ceiling = std::min(ceiling, config_.max_backoff.InSecondsF());
+  return base::Seconds(ceiling * base::RandDouble());
+}
+
+RetryBudget::RetryBudget() : RetryBudget(Config()) {}
+
+RetryBudget::RetryBudget(const Config& config)
+    : config_(config),
+      min_retries_(config.min_retries_per_second,
+                   config.min_retries_per_second) {}
+
+RetryBudget::~RetryBudget() = default;
+
+void RetryBudget::RecordRequest() {
+  balance_ = std::min(config_.max_balance, balance_ + config_.retry_ratio);
+}
+
+bool RetryBudget::TryAcquireRetry(base::TimeTicks now) {
+  if (balance_ >= 1.0) {
+    balance_ -= 1.0;
+    return true;
+  }
+  if (config_.min_retries_per_second > 0.0 &&
+      min_retries_.TimeUntilAvailable(1.0, now).is_zero()) {
+    min_retries_.Consume(1.0, now);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,118 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_RETRY_POLICY_H_
+#define ASOL_CORE_RETRY_POLICY_H_
+
+#include <string_view>
+
+#include "asol/core/rate_limiter.h"
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// How a failed request may be retried, judged from the error text the
+// adapters report ("HTTP error: <code>...", "Network error: ..." from the
+// Chromium stack, "HTTP transfer failed: ..." from curl).
+enum class FailureType {
+  // Client errors, parse failures, cancellation: retrying cannot help
+  PERMANENT,
+  // The request never reached the server (DNS, refused connection), so
+  // resending is always safe
+  CONNECT_FAILED,
+  // 5xx, 408, 429, resets and timeouts: worth retrying, but the server may
+  // already have acted on the request
+  TRANSIENT
+};
+
+FailureType ClassifyFailure(std::string_view error);
+
+// Whether |error| is a failure of the connection itself (DNS, connect,
+// reset, timeout) rather than an answer from the server or a cancellation
+bool IsTransportFailure(std::string_view error);
+
+// Whether |error| is an HTTP error status, which the server did send
+bool IsHttpError(std::string_view error);
+
+// RetryPolicy decides whether and when to resend a failed request.
+// Backoff is exponential with full jitter: retry n waits a uniformly random
+// time in [0, min(max_backoff, initial_backoff * multiplier^(n-1))], which
+// spreads out clients that failed together. A 429's Retry-After is a lower
+// bound on the wait. Retries never start past the request's deadline.
+class RetryPolicy {
+ public:
+  struct Config {
+    // Total attempts, including the first
+    int max_attempts = 3;
+    base::TimeDelta initial_backoff = base::Milliseconds(250);
+    base::TimeDelta max_backoff = base::Seconds(8);
+    double backoff_multiplier = 2.0;
+  };
+
+  RetryPolicy();
+  explicit RetryPolicy(const Config& config);
+  ~RetryPolicy();
+
+  // Whether to retry after |attempts_made| attempts, the last of which
+  // failed with |error|. TRANSIENT failures are only retried for
+  // |idempotent| requests. |time_left| is the time until the caller's
+  // deadline, or TimeDelta::Max(). On true, |delay| is the wait before the
+  // next attempt.
+  bool ShouldRetry(std::string_view error,
+                   int attempts_made,
+                   bool idempotent,
+                   base::TimeDelta time_left,
+                   base::TimeDelta* delay) const;
+
+  // Jittered wait before retry number |retry| (1-based)
+  base::TimeDelta GetBackoff(int retry) const;
+
+  const Config& config() const { return config_; }
+
+ private:
+  Config config_;
+};
+
+// RetryBudget caps retries at a fraction of traffic, so an outage at a
+// provider does not turn every request into |max_attempts| requests. Each
+// first attempt deposits |retry_ratio| tokens and each retry spends one. A
+// small per-second allowance lets low-traffic clients retry at all.
+//
+// Share one budget across all providers so the cap applies to the browser
+// as a whole. Not thread-safe.
+class RetryBudget {
+ public:
+  struct Config {
+    // Retries allowed per first attempt, e.g. 0.1 for 10%
+    double retry_ratio = 0.1;
+    // Deposits saved up during quiet periods, in retries
+    double max_balance = 10.0;
+    // Retries allowed regardless of traffic
+    double min_retries_per_second = 1.0;
+  };
+
+  RetryBudget();
+  explicit RetryBudget(const Config& config);
+  ~RetryBudget();
+
+  RetryBudget(const RetryBudget&) = delete;
+  RetryBudget& operator=(const RetryBudget&) = delete;
+
+  // A first attempt is being sent
+  void RecordRequest();
+
+  // Spend budget for one retry; false when it is exhausted
+  bool TryAcquireRetry(base::TimeTicks now);
+
+ private:
+  Config config_;
+  double balance_ = 0.0;
+  TokenBucket min_retries_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_RETRY_POLICY_H_
@@ -0,0 +1,114 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/retry_policy.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+TEST(RetryPolicyTest, ClassifiesFailures) {
+  EXPECT_EQ(ClassifyFailure("HTTP error: 503: overloaded"),
+            FailureType::TRANSIENT);
+  EXPECT_EQ(ClassifyFailure("HTTP error: 429 (Retry-After: 5)"),
+            FailureType::TRANSIENT);
+  EXPECT_EQ(ClassifyFailure("HTTP error: 400: bad request"),
+            FailureType::PERMANENT);
+  EXPECT_EQ(ClassifyFailure("Network error: net::ERR_CONNECTION_RESET"),
+            FailureType::TRANSIENT);
+  EXPECT_EQ(ClassifyFailure("Network error: net::ERR_NAME_NOT_RESOLVED"),
+            FailureType::CONNECT_FAILED);
+  EXPECT_EQ(ClassifyFailure("HTTP transfer failed: Couldn't connect to server"),
+            FailureType::CONNECT_FAILED);
+  EXPECT_EQ(ClassifyFailure("Network error: net::ERR_ABORTED"),
+            FailureType::PERMANENT);
+  EXPECT_EQ(ClassifyFailure("Failed to parse response: unexpected format"),
+            FailureType::PERMANENT);
+}
+
+TEST(RetryPolicyTest, RecognizesTransportFailures) {
+  EXPECT_TRUE(IsTransportFailure("Network error: net::ERR_TIMED_OUT"));
+  EXPECT_TRUE(IsTransportFailure("Network error: net::ERR_CONNECTION_RESET"));
+  EXPECT_TRUE(
+      IsTransportFailure("HTTP transfer failed: Couldn't connect to server"));
+  EXPECT_FALSE(IsTransportFailure("Network error: net::ERR_ABORTED"));
+  EXPECT_FALSE(IsTransportFailure("HTTP error: 401: unauthorized"));
+  EXPECT_FALSE(IsTransportFailure("HTTP error: 429 (Retry-After: 5)"));
+  EXPECT_FALSE(IsTransportFailure("All providers failed"));
+
+  EXPECT_TRUE(IsHttpError("HTTP error: 401: unauthorized"));
+  EXPECT_FALSE(IsHttpError("Network error: net::ERR_TIMED_OUT"));
+}
+
+TEST(RetryPolicyTest, BackoffIsJitteredAndCapped) {
+  RetryPolicy::Config config;
+  config.initial_backoff = base::Milliseconds(100);
+  config.max_backoff = base::Milliseconds(300);
+  RetryPolicy policy(config);
+
+  for (int i = 0; i < 100; ++i) {
+    base::TimeDelta first = policy.GetBackoff(1);
+    EXPECT_GE(first, base::TimeDelta());
+    EXPECT_LE(first, base::Milliseconds(100));
+    EXPECT_LE(policy.GetBackoff(5), base::Milliseconds(300));
+  }
+}
+
+TEST(RetryPolicyTest, RespectsAttemptsIdempotencyAndDeadline) {
+  RetryPolicy::Config config;
+  config.max_attempts = 2;
+  RetryPolicy policy(config);
+  base::TimeDelta delay;
+
+  EXPECT_TRUE(policy.ShouldRetry("HTTP error: 502", 1, true,
+                                 base::TimeDelta::Max(), &delay));
+  EXPECT_FALSE(policy.ShouldRetry("HTTP error: 502", 2, true,
+                                  base::TimeDelta::Max(), &delay));
+
+  // The server may have acted on a 502, but never saw a refused connection
+  EXPECT_FALSE(policy.ShouldRetry("HTTP error: 502", 1, false,
+                                  base::TimeDelta::Max(), &delay));
+  EXPECT_TRUE(policy.ShouldRetry("Network error: ERR_CONNECTION_REFUSED", 1,
+                                 false, base::TimeDelta::Max(), &delay));
+
+  // A Retry-After beyond the deadline means giving up now
+  EXPECT_FALSE(policy.ShouldRetry("HTTP error: 429 (Retry-After: 30)", 1,
+                                  true, base::Seconds(5), &delay));
+  ASSERT_TRUE(policy.ShouldRetry("HTTP error: 429 (Retry-After: 3)", 1, true,
+                                 base::Seconds(5), &delay));
+  EXPECT_GE(delay, base::Seconds(3));
+}
+
+TEST(RetryBudgetTest, CapsRetriesAtRatioOfTraffic) {
+  RetryBudget::Config config;
+  config.retry_ratio = 0.1;
+  config.min_retries_per_second = 0.0;
+  RetryBudget budget(config);
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  EXPECT_FALSE(budget.TryAcquireRetry(now));
+  for (int i = 0; i < 20; ++i) {
+    budget.RecordRequest();
+  }
+  EXPECT_TRUE(budget.TryAcquireRetry(now));
+  EXPECT_TRUE(budget.TryAcquireRetry(now));
+  EXPECT_FALSE(budget.TryAcquireRetry(now));
+}
+
+TEST(RetryBudgetTest, AllowsMinimumRetryRate) {
+  RetryBudget::Config config;
+  config.min_retries_per_second = 1.0;
+  RetryBudget budget(config);
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  EXPECT_TRUE(budget.TryAcquireRetry(now));
+  EXPECT_FALSE(budget.TryAcquireRetry(now));
+  EXPECT_TRUE(budget.TryAcquireRetry(now + base::Seconds(1)));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
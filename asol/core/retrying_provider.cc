@@ -0,0 +1,190 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/retrying_provider.h"
+
+#include <utility>
+
+#include "base/check.h"
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/task/sequenced_task_runner.h"
+
+namespace asol {
+namespace core {
+
+RetryingProvider::Attempt::Attempt() = default;
+RetryingProvider::Attempt::Attempt(Attempt&&) = default;
+RetryingProvider::Attempt& RetryingProvider::Attempt::operator=(Attempt&&) =
+    default;
+RetryingProvider::Attempt::~Attempt() = default;
+
+RetryingProvider::RetryingProvider(std::unique_ptr<AIServiceProvider> provider,
+                                   const RetryPolicy::Config& policy,
+                                   RetryBudget* budget)
+    : provider_(std::move(provider)), policy_(policy), budget_(budget) {
+  DCHECK(budget_);
+}
+
+RetryingProvider::~RetryingProvider() = default;
+
+std::string RetryingProvider::GetProviderId() const {
+  return provider_->GetProviderId();
+}
+
+std::string RetryingProvider::GetProviderName() const {
+  return provider_->GetProviderName();
+}
+
+std::string RetryingProvider::GetProviderVersion() const {
+  return provider_->GetProviderVersion();
+}
+
+AIServiceProvider::Capabilities RetryingProvider::GetCapabilities() const {
+  return provider_->GetCapabilities();
+}
+
+const TokenCounter& RetryingProvider::GetTokenCounter() const {
+  return provider_->GetTokenCounter();
+}
+
+bool RetryingProvider::SupportsTaskType(TaskType task_type) const {
+  return provider_->SupportsTaskType(task_type);
+}
+
+void RetryingProvider::ProcessRequest(const AIRequestParams& params,
+                                      AIResponseCallback callback) {
+  budget_->RecordRequest();
+  Attempt attempt;
+  attempt.params = params;
+  attempt.callback = std::move(callback);
+  Send(std::move(attempt));
+}
+
+void RetryingProvider::ProcessStreamingRequest(const AIRequestParams& params,
+                                               AIStreamCallback callback) {
+  budget_->RecordRequest();
+  Attempt attempt;
+  attempt.params = params;
+  attempt.stream_callback = std::move(callback);
+  SendStream(std::move(attempt));
+}
+
+void RetryingProvider::Preconnect() {
+  provider_->Preconnect();
+}
+
+void RetryingProvider::Configure(
+    const std::unordered_map<std::string, std::string>& config) {
+  provider_->Configure(config);
+}
+
+std::unordered_map<std::string, std::string>
+RetryingProvider::GetConfiguration() const {
+  return provider_->GetConfiguration();
+}
+
+void RetryingProvider::Send(Attempt attempt) {
+  // Cancelled while waiting out the backoff
+  if (attempt.params.cancellation_token &&
+      attempt.params.cancellation_token->IsCancelled()) {
+    std::move(attempt.callback).Run(false, kRequestCancelledError);
+    return;
+  }
+
+  attempt.attempts_made++;
+  AIRequestParams params = attempt.params;
+  provider_->ProcessRequest(
+      params, base::BindOnce(&RetryingProvider::OnResponse,
+                             weak_ptr_factory_.GetWeakPtr(),
+                             std::move(attempt)));
+}
+
+void RetryingProvider::SendStream(Attempt attempt) {
+  if (attempt.params.cancellation_token &&
+      attempt.params.cancellation_token->IsCancelled()) {
+    attempt.stream_callback.Run(
+        MakeFinalStreamDelta(false, kRequestCancelledError));
+    return;
+  }
+
+  attempt.attempts_made++;
+  attempt.delta_delivered = false;
+  AIRequestParams params = attempt.params;
+  provider_->ProcessStreamingRequest(
+      params,
+      base::BindRepeating(&RetryingProvider::OnStreamDelta,
+                          weak_ptr_factory_.GetWeakPtr(),
+                          base::Owned(std::make_unique<Attempt>(
+                              std::move(attempt)))));
+}
+
+void RetryingProvider::OnResponse(Attempt attempt,
+                                  bool success,
+                                  const std::string& response) {
+  base::TimeDelta delay;
+  if (success || !ShouldRetry(attempt, response, &delay)) {
+    std::move(attempt.callback).Run(success, response);
+    return;
+  }
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&RetryingProvider::Send, weak_ptr_factory_.GetWeakPtr(),
+                     std::move(attempt)),
+      delay);
+}
+
+void RetryingProvider::OnStreamDelta(Attempt* attempt,
+                                     const StreamDelta& delta) {
+  if (!delta.is_final) {
+    attempt->delta_delivered = true;
+    attempt->stream_callback.Run(delta);
+    return;
+  }
+
+  // Text the caller has already shown cannot be taken back, so only a
+  // stream that failed before its first delta is resent
+  base::TimeDelta delay;
+  if (delta.success || attempt->delta_delivered ||
+      !ShouldRetry(*attempt, delta.error_message, &delay)) {
+    attempt->stream_callback.Run(delta);
+    return;
+  }
+  // |attempt| is owned by the callback running now, so its state moves
+  // into the next one
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&RetryingProvider::SendStream,
+                     weak_ptr_factory_.GetWeakPtr(), std::move(*attempt)),
+      delay);
+}
+
+bool RetryingProvider::ShouldRetry(const Attempt& attempt,
+                                   const std::string& error,
+                                   base::TimeDelta* delay) {
+  if (IsCancellationError(error)) {
+    return false;
+  }
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::TimeDelta time_left = attempt.params.deadline.is_null()
+                                  ? base::TimeDelta::Max()
+                                  : attempt.params.deadline - now;
+  if (!policy_.ShouldRetry(error, attempt.attempts_made,
+                           attempt.params.idempotent, time_left, delay)) {
+    return false;
+  }
+  if (!budget_->TryAcquireRetry(now)) {
+    DVLOG(1) << "Retry budget exhausted; not retrying " << GetProviderId();
+    return false;
+  }
+
+  DVLOG(1) << "Retrying " << GetProviderId() << " request in " << *delay
+           << " after: " << error;
+  retries_sent_++;
+  return true;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,102 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_RETRYING_PROVIDER_H_
+#define ASOL_CORE_RETRYING_PROVIDER_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "asol/core/ai_service_provider.h"
+#include "asol/core/retry_policy.h"
+#include "base/memory/weak_ptr.h"
+
+namespace asol {
+namespace core {
+
+// RetryingProvider wraps a provider and resends requests that failed for
+// transient reasons: connection failures, resets, 5xx, 408 and 429. Waits
+// follow |policy| (jittered exponential backoff, at least the server's
+// Retry-After). Every retry must also be paid for from |budget|, which
+// callers share across providers so retries stay a small fraction of total
+// traffic during an incident.
+//
+// A request's deadline bounds its retries: none starts after it. Requests
+// not marked idempotent are only resent when the first attempt never
+// reached the server. Streams are only resent while no text has been
+// delivered.
+//
+// Wrap outside a RateLimitedProvider, which already requeues 429s itself.
+// Must be used on a single sequence.
+class RetryingProvider : public AIServiceProvider {
+ public:
+  // |budget| is not owned and must outlive this provider
+  RetryingProvider(std::unique_ptr<AIServiceProvider> provider,
+                   const RetryPolicy::Config& policy,
+                   RetryBudget* budget);
+  ~RetryingProvider() override;
+
+  RetryingProvider(const RetryingProvider&) = delete;
+  RetryingProvider& operator=(const RetryingProvider&) = delete;
+
+  // AIServiceProvider implementation
+  std::string GetProviderId() const override;
+  std::string GetProviderName() const override;
+  std::string GetProviderVersion() const override;
+  Capabilities GetCapabilities() const override;
+  const TokenCounter& GetTokenCounter() const override;
+  bool SupportsTaskType(TaskType task_type) const override;
+  void ProcessRequest(const AIRequestParams& params,
+                      AIResponseCallback callback) override;
+  void ProcessStreamingRequest(const AIRequestParams& params,
+                               AIStreamCallback callback) override;
+  void Preconnect() override;
+  void Configure(
+      const std::unordered_map<std::string, std::string>& config) override;
+  std::unordered_map<std::string, std::string> GetConfiguration()
+      const override;
+
+  // Retries sent so far
+  int retries_sent() const { return retries_sent_; }
+
+ private:
+  struct Attempt {
+    Attempt();
+    Attempt(Attempt&&);
+    Attempt& operator=(Attempt&&);
+    ~Attempt();
+
+    AIRequestParams params;
+    // Exactly one of the two is set
+    AIResponseCallback callback;
+    AIStreamCallback stream_callback;
+    int attempts_made = 0;
+    // Whether the current attempt has passed text on to the caller
+    bool delta_delivered = false;
+  };
+
+  void Send(Attempt attempt);
+  void SendStream(Attempt attempt);
+  void OnResponse(Attempt attempt, bool success, const std::string& response);
+  void OnStreamDelta(Attempt* attempt, const StreamDelta& delta);
+
+  // Whether |error| is worth another attempt, paying for it from the budget
+  // and setting |delay| if so
+  bool ShouldRetry(const Attempt& attempt,
+                   const std::string& error,
+                   base::TimeDelta* delay);
+
+  std::unique_ptr<AIServiceProvider> provider_;
+  const RetryPolicy policy_;
+  RetryBudget* const budget_;
+  int retries_sent_ = 0;
+
+  base::WeakPtrFactory<RetryingProvider> weak_ptr_factory_{this};
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_RETRYING_PROVIDER_H_
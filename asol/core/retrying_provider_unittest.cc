@@ -0,0 +1,203 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/retrying_provider.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/strings/strcat.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+// Provider that answers synchronously and fails the next few requests with
+// a configurable error.
+class FakeProvider : public AIServiceProvider {
+ public:
+  std::string GetProviderId() const override { return "fake"; }
+  std::string GetProviderName() const override { return "Fake"; }
+  std::string GetProviderVersion() const override { return "1.0"; }
+  Capabilities GetCapabilities() const override { return Capabilities(); }
+  bool SupportsTaskType(TaskType task_type) const override { return true; }
+  void ProcessRequest(const AIRequestParams& params,
+                      AIResponseCallback callback) override {
+    request_count_++;
+    if (failures_ > 0) {
+      failures_--;
+      std::move(callback).Run(false, error_);
+      return;
+    }
+    std::move(callback).Run(true,
+                            base::StrCat({"response:", params.input_text}));
+  }
+  void Configure(
+      const std::unordered_map<std::string, std::string>& config) override {}
+  std::unordered_map<std::string, std::string> GetConfiguration()
+      const override {
+    return {};
+  }
+
+  int request_count() const { return request_count_; }
+  void Fail(int count, const std::string& error) {
+    failures_ = count;
+    error_ = error;
+  }
+
+ private:
+  int request_count_ = 0;
+  int failures_ = 0;
+  std::string error_;
+};
+
+class RetryingProviderTest : public testing::Test {
+ protected:
+  void CreateProvider(const RetryBudget::Config& budget_config) {
+    budget_ = std::make_unique<RetryBudget>(budget_config);
+    auto provider = std::make_unique<FakeProvider>();
+    fake_ = provider.get();
+    RetryPolicy::Config policy;
+    policy.max_attempts = 3;
+    policy.initial_backoff = base::Milliseconds(100);
+    provider_ = std::make_unique<RetryingProvider>(std::move(provider), policy,
+                                                   budget_.get());
+  }
+
+  void Send(AIServiceProvider::AIRequestParams params) {
+    provider_->ProcessRequest(
+        params, base::BindOnce(
+                    [](std::vector<std::pair<bool, std::string>>* results,
+                       bool success, const std::string& response) {
+                      results->emplace_back(success, response);
+                    },
+                    &results_));
+  }
+
+  void Send(const std::string& input) {
+    AIServiceProvider::AIRequestParams params;
+    params.input_text = input;
+    Send(params);
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  std::unique_ptr<RetryBudget> budget_;
+  FakeProvider* fake_ = nullptr;
+  std::unique_ptr<RetryingProvider> provider_;
+  std::vector<std::pair<bool, std::string>> results_;
+};
+
+TEST_F(RetryingProviderTest, RetriesTransientFailures) {
+  RetryBudget::Config budget;
+  budget.retry_ratio = 1.0;
+  CreateProvider(budget);
+  fake_->Fail(2, "HTTP error: 503");
+
+  Send("a");
+  EXPECT_TRUE(results_.empty());
+  task_environment_.FastForwardBy(base::Seconds(1));
+
+  EXPECT_EQ(fake_->request_count(), 3);
+  EXPECT_EQ(provider_->retries_sent(), 2);
+  ASSERT_EQ(results_.size(), 1u);
+  EXPECT_TRUE(results_[0].first);
+}
+
+TEST_F(RetryingProviderTest, DoesNotRetryPermanentFailures) {
+  CreateProvider(RetryBudget::Config());
+  fake_->Fail(1, "HTTP error: 401: bad key");
+
+  Send("a");
+  task_environment_.RunUntilIdle();
+
+  EXPECT_EQ(fake_->request_count(), 1);
+  ASSERT_EQ(results_.size(), 1u);
+  EXPECT_FALSE(results_[0].first);
+}
+
+TEST_F(RetryingProviderTest, StopsAtDeadline) {
+  CreateProvider(RetryBudget::Config());
+  fake_->Fail(1, "HTTP error: 429 (Retry-After: 10)");
+
+  AIServiceProvider::AIRequestParams params;
+  params.deadline = base::TimeTicks::Now() + base::Seconds(2);
+  Send(params);
+  task_environment_.RunUntilIdle();
+
+  EXPECT_EQ(fake_->request_count(), 1);
+  ASSERT_EQ(results_.size(), 1u);
+  EXPECT_FALSE(results_[0].first);
+}
+
+TEST_F(RetryingProviderTest, DropsRetryOfCancelledRequest) {
+  RetryBudget::Config budget;
+  budget.retry_ratio = 1.0;
+  CreateProvider(budget);
+  fake_->Fail(1, "HTTP error: 503");
+
+  AIServiceProvider::AIRequestParams params;
+  params.cancellation_token = base::MakeRefCounted<CancellationToken>();
+  Send(params);
+  params.cancellation_token->Cancel();
+  task_environment_.FastForwardBy(base::Seconds(1));
+
+  EXPECT_EQ(fake_->request_count(), 1);
+  ASSERT_EQ(results_.size(), 1u);
+  EXPECT_FALSE(results_[0].first);
+  EXPECT_EQ(results_[0].second, kRequestCancelledError);
+}
+
+TEST_F(RetryingProviderTest, StopsWhenBudgetIsSpent) {
+  RetryBudget::Config budget;
+  budget.retry_ratio = 0.0;
+  budget.min_retries_per_second = 1.0;
+  CreateProvider(budget);
+  fake_->Fail(4, "HTTP error: 500");
+
+  // The first request's retry uses the allowance; the second gets none
+  Send("a");
+  Send("b");
+  task_environment_.FastForwardBy(base::Milliseconds(500));
+
+  EXPECT_EQ(provider_->retries_sent(), 1);
+  ASSERT_EQ(results_.size(), 2u);
+  EXPECT_FALSE(results_[0].first);
+  EXPECT_FALSE(results_[1].first);
+}
+
+TEST_F(RetryingProviderTest, RetriesStreamBeforeFirstDelta) {
+  RetryBudget::Config budget;
+  budget.retry_ratio = 1.0;
+  CreateProvider(budget);
+  fake_->Fail(1, "HTTP error: 503");
+
+  // The fake streams through the default, one final delta per attempt, so
+  // the failed attempt delivered nothing and may be resent
+  std::vector<StreamDelta> deltas;
+  AIServiceProvider::AIRequestParams params;
+  params.input_text = "a";
+  provider_->ProcessStreamingRequest(
+      params, base::BindRepeating(
+                  [](std::vector<StreamDelta>* deltas,
+                     const StreamDelta& delta) { deltas->push_back(delta); },
+                  &deltas));
+  task_environment_.FastForwardBy(base::Seconds(1));
+
+  EXPECT_EQ(fake_->request_count(), 2);
+  ASSERT_EQ(deltas.size(), 1u);
+  EXPECT_TRUE(deltas[0].is_final);
+  EXPECT_TRUE(deltas[0].success);
+  EXPECT_EQ(deltas[0].text, "response:a");
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,121 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/semantic_response_cache.h"
+
+#include "asol/core/vector_kernels.h"
+#include "base/logging.h"
+
+namespace asol {
+namespace core {
+
+SemanticResponseCache::SemanticResponseCache(size_t max_entries)
+    : max_entries_(max_entries) {}
+
+SemanticResponseCache::~SemanticResponseCache() = default;
+
+bool SemanticResponseCache::Lookup(AIServiceProvider::TaskType task_type,
+                                   uint64_t scope,
+                                   const std::vector<float>& embedding,
+                                   float threshold,
+                                   int max_age_seconds,
+                                   Match* match) const {
+  if (size_ == 0 || embedding.size() != dimension_) {
+    return false;
+  }
+
+  // A zero vector has no direction to compare
+  std::vector<float> query(dimension_);
+  if (!Normalize(embedding.data(), dimension_, query.data())) {
+    return false;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  const Slot* best_slot = nullptr;
+  float best_similarity = threshold;
+
+  for (size_t i = 0; i < size_; ++i) {
+    const Slot& slot = slots_[i];
+    if (slot.task_type != task_type || slot.scope != scope) {
+      continue;
+    }
+
+    auto age = std::chrono::duration_cast<std::chrono::seconds>(
+        now - slot.timestamp).count();
+    if (age > max_age_seconds) {
+      continue;
+    }
+
+    float similarity =
+        DotProduct(&vectors_[i * dimension_], query.data(), dimension_);
+
+    if (similarity >= best_similarity) {
+      best_similarity = similarity;
+      best_slot = &slot;
+    }
+  }
+
+  if (!best_slot) {
+    return false;
+  }
+
+  match->response = best_slot->response;
+  match->provider_id = best_slot->provider_id;
+  match->similarity = best_similarity;
+  return true;
+}
+
+void SemanticResponseCache::Insert(AIServiceProvider::TaskType task_type,
+                                   uint64_t scope,
+                                   const std::vector<float>& embedding,
+                                   const std::string& response,
+                                   const std::string& provider_id) {
+  if (max_entries_ == 0 || embedding.empty()) {
+    return;
+  }
+
+  if (dimension_ == 0) {
+    dimension_ = embedding.size();
+    vectors_.assign(max_entries_ * dimension_, 0.0f);
+    slots_.resize(max_entries_);
+  } else if (embedding.size() != dimension_) {
+    LOG(WARNING) << "Rejecting embedding of dimension " << embedding.size()
+                 << ", semantic cache uses " << dimension_;
+    return;
+  }
+
+  size_t index = next_slot_;
+  if (!Normalize(embedding.data(), dimension_,
+                 &vectors_[index * dimension_])) {
+    return;
+  }
+
+  Slot& slot = slots_[index];
+  slot.task_type = task_type;
+  slot.scope = scope;
+  slot.response = response;
+  slot.provider_id = provider_id;
+  slot.timestamp = std::chrono::steady_clock::now();
+
+  next_slot_ = (next_slot_ + 1) % max_entries_;
+  if (size_ < max_entries_) {
+    size_++;
+  }
+}
+
+void SemanticResponseCache::SetMaxEntries(size_t max_entries) {
+  max_entries_ = max_entries;
+  Clear();
+}
+
+void SemanticResponseCache::Clear() {
+  dimension_ = 0;
+  size_ = 0;
+  next_slot_ = 0;
+  vectors_.clear();
+  slots_.clear();
+}
+
+}  // namespace core
+}  // namespace asol
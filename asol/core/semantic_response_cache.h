@@ -0,0 +1,86 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_SEMANTIC_RESPONSE_CACHE_H_
+#define ASOL_CORE_SEMANTIC_RESPONSE_CACHE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "asol/core/ai_service_provider.h"
+
+namespace asol {
+namespace core {
+
+// SemanticResponseCache is the similarity tier behind the exact-match response
+// cache. It keys responses by prompt embedding and answers a lookup when a
+// stored prompt of the same task and parameter scope is close enough in
+// cosine similarity, so near-identical prompts can share one response.
+//
+// Embeddings are L2-normalized on insert and kept in one contiguous float
+// array, so a lookup is a single linear pass of SIMD dot products over at
+// most |max_entries| rows. Slots are recycled in insertion order once full.
+class SemanticResponseCache {
+ public:
+  struct Match {
+    std::string response;
+    std::string provider_id;
+    float similarity = 0.0f;
+  };
+
+  explicit SemanticResponseCache(size_t max_entries);
+  ~SemanticResponseCache();
+
+  SemanticResponseCache(const SemanticResponseCache&) = delete;
+  SemanticResponseCache& operator=(const SemanticResponseCache&) = delete;
+
+  // Find the most similar live entry with the same |task_type| and |scope|
+  // whose similarity is at least |threshold|. Entries older than
+  // |max_age_seconds| are ignored.
+  bool Lookup(AIServiceProvider::TaskType task_type,
+              uint64_t scope,
+              const std::vector<float>& embedding,
+              float threshold,
+              int max_age_seconds,
+              Match* match) const;
+
+  // Store |response| under |embedding|. Embeddings whose dimension differs
+  // from the first one inserted are rejected.
+  void Insert(AIServiceProvider::TaskType task_type,
+              uint64_t scope,
+              const std::vector<float>& embedding,
+              const std::string& response,
+              const std::string& provider_id);
+
+  // Change the capacity. Existing entries are dropped.
+  void SetMaxEntries(size_t max_entries);
+
+  void Clear();
+  size_t size() const { return size_; }
+
+ private:
+  struct Slot {
+    AIServiceProvider::TaskType task_type;
+    uint64_t scope = 0;
+    std::string response;
+    std::string provider_id;
+    std::chrono::steady_clock::time_point timestamp;
+  };
+
+  size_t max_entries_;
+  size_t dimension_ = 0;
+  size_t size_ = 0;
+  size_t next_slot_ = 0;
+
+  // |max_entries_| rows of |dimension_| floats each
+  std::vector<float> vectors_;
+  std::vector<Slot> slots_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_SEMANTIC_RESPONSE_CACHE_H_
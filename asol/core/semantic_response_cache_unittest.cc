@@ -0,0 +1,80 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/semantic_response_cache.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+using TaskType = AIServiceProvider::TaskType;
+
+constexpr int kMaxAge = 3600;
+
+TEST(SemanticResponseCacheTest, ServesSimilarPrompt) {
+  SemanticResponseCache cache(8);
+  cache.Insert(TaskType::TEXT_SUMMARIZATION, 1, {1.0f, 0.0f, 0.1f},
+               "summary", "gemini");
+
+  SemanticResponseCache::Match match;
+  ASSERT_TRUE(cache.Lookup(TaskType::TEXT_SUMMARIZATION, 1,
+                           {2.0f, 0.0f, 0.21f}, 0.99f, kMaxAge, &match));
+  EXPECT_EQ(match.response, "summary");
+  EXPECT_EQ(match.provider_id, "gemini");
+  EXPECT_GT(match.similarity, 0.99f);
+}
+
+TEST(SemanticResponseCacheTest, RejectsDissimilarPrompt) {
+  SemanticResponseCache cache(8);
+  cache.Insert(TaskType::TEXT_SUMMARIZATION, 1, {1.0f, 0.0f}, "summary", "a");
+
+  SemanticResponseCache::Match match;
+  EXPECT_FALSE(cache.Lookup(TaskType::TEXT_SUMMARIZATION, 1, {0.0f, 1.0f},
+                            0.9f, kMaxAge, &match));
+}
+
+TEST(SemanticResponseCacheTest, DoesNotCrossTaskOrScope) {
+  SemanticResponseCache cache(8);
+  cache.Insert(TaskType::TEXT_SUMMARIZATION, 1, {1.0f, 0.0f}, "summary", "a");
+
+  SemanticResponseCache::Match match;
+  EXPECT_FALSE(cache.Lookup(TaskType::TRANSLATION, 1, {1.0f, 0.0f}, 0.9f,
+                            kMaxAge, &match));
+  EXPECT_FALSE(cache.Lookup(TaskType::TEXT_SUMMARIZATION, 2, {1.0f, 0.0f},
+                            0.9f, kMaxAge, &match));
+}
+
+TEST(SemanticResponseCacheTest, RecyclesOldestSlotWhenFull) {
+  SemanticResponseCache cache(2);
+  cache.Insert(TaskType::CUSTOM, 0, {1.0f, 0.0f}, "first", "a");
+  cache.Insert(TaskType::CUSTOM, 0, {0.0f, 1.0f}, "second", "a");
+  cache.Insert(TaskType::CUSTOM, 0, {-1.0f, 0.0f}, "third", "a");
+
+  EXPECT_EQ(cache.size(), 2u);
+  SemanticResponseCache::Match match;
+  EXPECT_FALSE(cache.Lookup(TaskType::CUSTOM, 0, {1.0f, 0.0f}, 0.9f, kMaxAge,
+                            &match));
+  EXPECT_TRUE(cache.Lookup(TaskType::CUSTOM, 0, {0.0f, 1.0f}, 0.9f, kMaxAge,
+                           &match));
+  EXPECT_EQ(match.response, "second");
+}
+
+TEST(SemanticResponseCacheTest, IgnoresMismatchedDimension) {
+  SemanticResponseCache cache(4);
+  cache.Insert(TaskType::CUSTOM, 0, {1.0f, 0.0f}, "first", "a");
+  cache.Insert(TaskType::CUSTOM, 0, {1.0f, 0.0f, 0.0f}, "second", "a");
+
+  EXPECT_EQ(cache.size(), 1u);
+  SemanticResponseCache::Match match;
+  EXPECT_FALSE(cache.Lookup(TaskType::CUSTOM, 0, {1.0f, 0.0f, 0.0f}, 0.5f,
+                            kMaxAge, &match));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -5,28 +5,50 @@
 #include "asol/core/service_manager.h"
 
 #include <algorithm>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "asol/util/performance_tracker.h"
+#include "base/hash/sha1.h"
 #include "base/logging.h"
+#include "base/no_destructor.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "third_party/nlohmann_json/json.hpp"
 
 namespace asol {
 namespace core {
 
-// Initialize static instance
-ServiceManager* ServiceManager::instance_ = nullptr;
+namespace {
+
+// Size of the chunks a cached response is replayed to a stream in. Cut
+// longer so as not to split a UTF-8 character.
+constexpr size_t kReplayChunkBytes = 256;
+
+}  // namespace
+
+ServiceManager::Registry::Registry() = default;
+ServiceManager::Registry::Registry(const Registry&) = default;
+ServiceManager::Registry::~Registry() = default;
+
+ServiceManager::Waiter::Waiter() = default;
+ServiceManager::Waiter::Waiter(const Waiter&) = default;
+ServiceManager::Waiter::~Waiter() = default;
 
 ServiceManager* ServiceManager::GetInstance() {
-  if (!instance_) {
-    instance_ = new ServiceManager();
-  }
-  return instance_;
+  static base::NoDestructor<ServiceManager> instance;
+  return instance.get();
 }
 
 ServiceManager::ServiceManager() {
   LOG(INFO) << "ASOL ServiceManager created.";
+
+  {
+    base::AutoLock lock(registry_lock_);
+    PublishLocked(std::make_unique<Registry>());
+  }
   
   // Enable response caching by default
   EnableResponseCache(true);
@@ -44,36 +66,60 @@ bool ServiceManager::RegisterAdapter(
     return false;
   }
 
-  if (adapters_.find(adapter_id) != adapters_.end()) {
+  base::AutoLock lock(registry_lock_);
+  if (registry().adapters.count(adapter_id)) {
     LOG(WARNING) << "Adapter with ID '" << adapter_id << "' already registered. Replacing.";
   }
 
   LOG(INFO) << "Registering adapter: " << adapter_id << " (" << adapter->GetName() << ")";
-  adapters_[adapter_id] = std::move(adapter);
+  auto registry = std::make_unique<Registry>(this->registry());
+  registry->adapters[adapter_id] = adapter.get();
+  // The adapter it replaces may still be in use by a reader, so is kept
+  owned_adapters_.push_back(std::move(adapter));
+  PublishLocked(std::move(registry));
   return true;
 }
 
 adapters::AdapterInterface* ServiceManager::GetAdapter(const std::string& adapter_id) {
-  auto it = adapters_.find(adapter_id);
-  if (it == adapters_.end()) {
+  const Registry& registry = this->registry();
+  auto it = registry.adapters.find(adapter_id);
+  if (it == registry.adapters.end()) {
     LOG(ERROR) << "Adapter not found: " << adapter_id;
     return nullptr;
   }
-  return it->second.get();
+  return it->second;
 }
 
-std::vector<std::string> ServiceManager::FindAdaptersByCapability(
-    const std::string& capability) {
-  std::vector<std::string> matching_adapters;
+const std::vector<std::string>& ServiceManager::FindAdaptersByCapability(
+    const std::string& capability) const {
+  static const base::NoDestructor<std::vector<std::string>> kNoAdapters;
+  const Registry& registry = this->registry();
+  auto it = registry.capability_index.find(capability);
+  if (it == registry.capability_index.end()) {
+    return *kNoAdapters;
+  }
+  return it->second;
+}
 
-  for (const auto& adapter_pair : adapters_) {
-    const auto& capabilities = adapter_pair.second->GetCapabilities();
-    if (std::find(capabilities.begin(), capabilities.end(), capability) != capabilities.end()) {
-      matching_adapters.push_back(adapter_pair.first);
+void ServiceManager::PublishLocked(std::unique_ptr<Registry> registry) {
+  registry->capability_index.clear();
+  for (const auto& [adapter_id, adapter] : registry->adapters) {
+    for (const auto& capability : adapter->GetCapabilities()) {
+      auto& adapter_ids = registry->capability_index[capability];
+      if (std::find(adapter_ids.begin(), adapter_ids.end(), adapter_id) ==
+          adapter_ids.end()) {
+        adapter_ids.push_back(adapter_id);
+      }
     }
   }
 
-  return matching_adapters;
+  // Order by ID so the best adapter does not depend on hash order
+  for (auto& [capability, adapter_ids] : registry->capability_index) {
+    std::sort(adapter_ids.begin(), adapter_ids.end());
+  }
+
+  registry_.store(registry.get(), std::memory_order_release);
+  registries_.push_back(std::move(registry));
 }
 
 adapters::ModelResponse ServiceManager::ProcessText(
@@ -82,11 +128,14 @@ adapters::ModelResponse ServiceManager::ProcessText(
   // Track performance of this operation
   util::ScopedPerformanceTracker tracker("ServiceManager_ProcessText");
   
-  // Check if we have a cached response
-  if (response_cache_) {
-    const auto* cached_entry = response_cache_->Get(text_input, adapter_id, "");
-    if (cached_entry) {
-      return cached_entry->response;
+  // Check if we have a cached response, then the on-disk tier
+  std::string persistent_key;
+  {
+    base::AutoLock lock(cache_lock_);
+    adapters::ModelResponse response;
+    if (GetCachedResponseLocked(adapter_id, text_input, &response,
+                                &persistent_key)) {
+      return response;
     }
   }
   
@@ -98,12 +147,14 @@ adapters::ModelResponse ServiceManager::ProcessText(
     return response;
   }
 
-  // Get the response from the adapter
+  // Get the response from the adapter, without holding the cache lock
   adapters::ModelResponse response = adapter->ProcessText(text_input);
   
   // Cache the successful response
-  if (response.success && response_cache_) {
-    response_cache_->Put(text_input, response, adapter_id, "");
+  if (response.success) {
+    base::AutoLock lock(cache_lock_);
+    PutCachedResponseLocked(adapter_id, text_input, response,
+                            std::move(persistent_key));
   }
   
   return response;
@@ -122,7 +173,18 @@ void ServiceManager::ProcessTextAsync(
     return;
   }
 
-  adapter->ProcessTextAsync(text_input, callback);
+  Waiter waiter;
+  waiter.callback = callback;
+  std::string key;
+  if (!StartRequest(adapter_id, text_input, waiter, &key)) {
+    return;
+  }
+  adapter->ProcessTextAsync(
+      text_input, [this, adapter_id, text_input, key,
+                   callback](const adapters::ModelResponse& response) {
+        callback(response);
+        CompleteRequest(adapter_id, text_input, key, response);
+      });
 }
 
 void ServiceManager::ProcessTextStream(
@@ -146,7 +208,30 @@ void ServiceManager::ProcessTextStream(
     return;
   }
 
-  adapter->ProcessTextStream(text_input, callback);
+  Waiter waiter;
+  waiter.stream_callback = callback;
+  std::string key;
+  if (!StartRequest(adapter_id, text_input, waiter, &key)) {
+    return;
+  }
+  // This caller gets the chunks as they come; the text is collected for
+  // the cache and the callers that joined
+  auto streamed_text = std::make_shared<std::string>();
+  adapter->ProcessTextStream(
+      text_input,
+      [this, adapter_id, text_input, key, callback, streamed_text](
+          const adapters::ModelResponse& response, bool is_done) {
+        if (response.success) {
+          streamed_text->append(response.text);
+        }
+        callback(response, is_done);
+        if (is_done) {
+          adapters::ModelResponse complete = response;
+          complete.text = std::move(*streamed_text);
+          complete.is_partial = false;
+          CompleteRequest(adapter_id, text_input, key, complete);
+        }
+      });
 }
 
 adapters::ModelResponse ServiceManager::ProcessTextWithCapability(
@@ -215,6 +300,10 @@ bool ServiceManager::InitializeAdapters(const std::string& config_json) {
     }
     
     bool all_success = true;
+
+    // Held throughout so a concurrent registration is not lost when the
+    // new registry is published
+    base::AutoLock lock(registry_lock_);
     
     // Initialize each adapter with its configuration
     for (auto& [adapter_id, adapter_config] : config["adapters"].items()) {
@@ -233,6 +322,8 @@ bool ServiceManager::InitializeAdapters(const std::string& config_json) {
       }
     }
     
+    // Initialization may have changed what the adapters can do
+    PublishLocked(std::make_unique<Registry>(registry()));
     return all_success;
   } catch (const std::exception& e) {
     LOG(ERROR) << "Failed to parse configuration: " << e.what();
@@ -240,8 +331,10 @@ bool ServiceManager::InitializeAdapters(const std::string& config_json) {
   }
 }
 
-std::string ServiceManager::FindBestAdapter(const std::string& capability) {
-  std::vector<std::string> matching_adapters = FindAdaptersByCapability(capability);
+std::string ServiceManager::FindBestAdapter(
+    const std::string& capability) const {
+  const std::vector<std::string>& matching_adapters =
+      FindAdaptersByCapability(capability);
   
   if (matching_adapters.empty()) {
     return "";
@@ -257,10 +350,11 @@ std::string ServiceManager::FindBestAdapter(const std::string& capability) {
 }
 
 std::vector<std::string> ServiceManager::GetRegisteredAdapters() const {
+  const Registry& registry = this->registry();
   std::vector<std::string> adapter_ids;
-  adapter_ids.reserve(adapters_.size());
+  adapter_ids.reserve(registry.adapters.size());
   
-  for (const auto& adapter_pair : adapters_) {
+  for (const auto& adapter_pair : registry.adapters) {
     adapter_ids.push_back(adapter_pair.first);
   }
   
@@ -268,26 +362,22 @@ std::vector<std::string> ServiceManager::GetRegisteredAdapters() const {
 }
 
 std::vector<std::string> ServiceManager::GetAvailableCapabilities() const {
+  const Registry& registry = this->registry();
   std::vector<std::string> all_capabilities;
+  all_capabilities.reserve(registry.capability_index.size());
   
-  for (const auto& adapter_pair : adapters_) {
-    const auto& capabilities = adapter_pair.second->GetCapabilities();
-    all_capabilities.insert(all_capabilities.end(), 
-                           capabilities.begin(), capabilities.end());
+  for (const auto& [capability, adapter_ids] : registry.capability_index) {
+    all_capabilities.push_back(capability);
   }
   
-  // Remove duplicates
   std::sort(all_capabilities.begin(), all_capabilities.end());
-  all_capabilities.erase(
-      std::unique(all_capabilities.begin(), all_capabilities.end()),
-      all_capabilities.end());
-  
   return all_capabilities;
 }
 
 bool ServiceManager::AdapterSupportsStreaming(const std::string& adapter_id) const {
-  auto it = adapters_.find(adapter_id);
-  if (it == adapters_.end()) {
+  const Registry& registry = this->registry();
+  auto it = registry.adapters.find(adapter_id);
+  if (it == registry.adapters.end()) {
     return false;
   }
   
@@ -295,6 +385,7 @@ bool ServiceManager::AdapterSupportsStreaming(const std::string& adapter_id) con
 }
 
 void ServiceManager::EnableResponseCache(bool enable, size_t capacity) {
+  base::AutoLock lock(cache_lock_);
   if (enable) {
     if (!response_cache_) {
       response_cache_ = std::make_unique<util::ResponseCache>(capacity);
@@ -312,11 +403,168 @@ void ServiceManager::EnableResponseCache(bool enable, size_t capacity) {
 }
 
 void ServiceManager::ClearResponseCache() {
+  base::AutoLock lock(cache_lock_);
   if (response_cache_) {
     response_cache_->Clear();
     LOG(INFO) << "Response cache cleared";
   }
+  if (persistent_cache_) {
+    persistent_cache_->Clear();
+  }
+}
+
+void ServiceManager::EnableRequestDeduplication(bool enable) {
+  base::AutoLock lock(cache_lock_);
+  deduplicate_requests_ = enable;
+}
+
+void ServiceManager::EnablePersistentCache(const base::FilePath& path,
+                                           size_t max_bytes,
+                                           base::TimeDelta time_to_live) {
+  PersistentResponseStore::Options options;
+  options.path = path;
+  options.max_bytes = max_bytes;
+  options.time_to_live = time_to_live;
+  base::AutoLock lock(cache_lock_);
+  persistent_cache_ = std::make_unique<PersistentResponseStore>(options);
+  LOG(INFO) << "Persistent response cache enabled at " << path.value();
+}
+
+// static
+std::string ServiceManager::GetPersistentCacheKey(
+    const std::string& adapter_id,
+    const std::string& text_input) {
+  // Inputs can be whole pages, so the index stores a digest rather than the
+  // text itself.
+  std::string digest = base::SHA1HashString(text_input);
+  return adapter_id + ":" + base::HexEncode(digest.data(), digest.size());
+}
+
+bool ServiceManager::GetCachedResponseLocked(
+    const std::string& adapter_id,
+    const std::string& text_input,
+    adapters::ModelResponse* response,
+    std::string* persistent_key) {
+  if (response_cache_) {
+    const auto* cached_entry =
+        response_cache_->Get(text_input, adapter_id, "");
+    if (cached_entry) {
+      *response = cached_entry->response;
+      return true;
+    }
+  }
+
+  if (persistent_cache_) {
+    *persistent_key = GetPersistentCacheKey(adapter_id, text_input);
+    if (persistent_cache_->Get(*persistent_key, &response->text)) {
+      response->success = true;
+      if (response_cache_) {
+        response_cache_->Put(text_input, *response, adapter_id, "");
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void ServiceManager::PutCachedResponseLocked(
+    const std::string& adapter_id,
+    const std::string& text_input,
+    const adapters::ModelResponse& response,
+    std::string persistent_key) {
+  if (response_cache_) {
+    response_cache_->Put(text_input, response, adapter_id, "");
+  }
+  if (persistent_cache_) {
+    // The persistent cache may have been enabled since the lookup
+    if (persistent_key.empty()) {
+      persistent_key = GetPersistentCacheKey(adapter_id, text_input);
+    }
+    persistent_cache_->Put(persistent_key, response.text);
+  }
+}
+
+bool ServiceManager::StartRequest(const std::string& adapter_id,
+                                  const std::string& text_input,
+                                  const Waiter& waiter,
+                                  std::string* key) {
+  adapters::ModelResponse response;
+  {
+    base::AutoLock lock(cache_lock_);
+    if (!GetCachedResponseLocked(adapter_id, text_input, &response, key)) {
+      if (key->empty()) {
+        *key = GetPersistentCacheKey(adapter_id, text_input);
+      }
+      if (!deduplicate_requests_) {
+        return true;
+      }
+      auto [it, inserted] = in_flight_.try_emplace(*key);
+      if (!inserted) {
+        it->second.push_back(waiter);
+      }
+      return inserted;
+    }
+  }
+  Deliver(waiter, response);
+  return false;
+}
+
+void ServiceManager::CompleteRequest(const std::string& adapter_id,
+                                     const std::string& text_input,
+                                     const std::string& key,
+                                     const adapters::ModelResponse& response) {
+  std::vector<Waiter> waiters;
+  {
+    base::AutoLock lock(cache_lock_);
+    if (response.success) {
+      PutCachedResponseLocked(adapter_id, text_input, response, key);
+    }
+    auto it = in_flight_.find(key);
+    if (it != in_flight_.end()) {
+      waiters = std::move(it->second);
+      in_flight_.erase(it);
+    }
+  }
+  // Outside the lock, as a callback may make another request
+  for (const Waiter& waiter : waiters) {
+    Deliver(waiter, response);
+  }
+}
+
+// static
+void ServiceManager::Deliver(const Waiter& waiter,
+                             const adapters::ModelResponse& response) {
+  if (waiter.stream_callback) {
+    ReplayAsStream(response, waiter.stream_callback);
+  } else {
+    waiter.callback(response);
+  }
+}
+
+// static
+void ServiceManager::ReplayAsStream(
+    const adapters::ModelResponse& response,
+    const adapters::StreamingResponseCallback& callback) {
+  const std::string& text = response.text;
+  if (!response.success || text.size() <= kReplayChunkBytes) {
+    callback(response, true);
+    return;
+  }
+  adapters::ModelResponse chunk = response;
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = std::min(start + kReplayChunkBytes, text.size());
+    while (end < text.size() &&
+           (static_cast<unsigned char>(text[end]) & 0xC0) == 0x80) {
+      ++end;
+    }
+    chunk.text.assign(text, start, end - start);
+    bool is_done = end == text.size();
+    chunk.is_partial = !is_done;
+    callback(chunk, is_done);
+    start = end;
+  }
 }
 
 }  // namespace core
-}  // namespace asol
\ No newline at end of file
+}  // namespace asol
@@ -5,20 +5,33 @@
 #ifndef ASOL_CORE_SERVICE_MANAGER_H_
 #define ASOL_CORE_SERVICE_MANAGER_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "asol/adapters/adapter_interface.h"
+#include "asol/core/persistent_response_store.h"
 #include "asol/util/performance_tracker.h"
 #include "asol/util/response_cache.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
 
 namespace asol {
 namespace core {
 
 // ServiceManager is the central component that manages AI service adapters
 // and routes requests to the appropriate adapter based on capabilities.
+//
+// It may be used from any thread. The adapters and the capability index
+// form an immutable registry snapshot: RegisterAdapter() and
+// InitializeAdapters() build a new one under a lock and publish it with a
+// single atomic store, so routing a request reads the current snapshot
+// with one atomic load and takes no lock. Snapshots, and the adapters in
+// them, are kept for the life of the manager, so whatever a reader got
+// from one stays valid; registration is rare enough for that to be cheap.
 class ServiceManager {
  public:
   // Get the singleton instance
@@ -28,22 +41,31 @@ class ServiceManager {
   bool RegisterAdapter(const std::string& adapter_id,
                       std::unique_ptr<adapters::AdapterInterface> adapter);
 
-  // Get an adapter by ID
+  // Get an adapter by ID. A replaced adapter stays alive, so the pointer
+  // never dangles.
   adapters::AdapterInterface* GetAdapter(const std::string& adapter_id);
 
-  // Find adapters that support a specific capability
-  std::vector<std::string> FindAdaptersByCapability(const std::string& capability);
+  // Find adapters that support a specific capability, ordered by ID. The
+  // list comes from an index built at registration and configuration time
+  // and reflects the registry as of the call.
+  const std::vector<std::string>& FindAdaptersByCapability(
+      const std::string& capability) const;
 
   // Process text with the specified adapter
   adapters::ModelResponse ProcessText(const std::string& adapter_id,
                                      const std::string& text_input);
 
-  // Process text asynchronously with the specified adapter
+  // Process text asynchronously with the specified adapter. Like
+  // ProcessText(), answered from the response cache when possible; a miss
+  // that matches a request already in flight waits for it rather than
+  // calling the adapter again.
   void ProcessTextAsync(const std::string& adapter_id,
                        const std::string& text_input,
                        adapters::ResponseCallback callback);
                        
-  // Process text with streaming response from the specified adapter
+  // Process text with streaming response from the specified adapter. A
+  // cached response, or that of a matching request in flight, is replayed
+  // as chunks, the last one flagged done.
   void ProcessTextStream(const std::string& adapter_id,
                         const std::string& text_input,
                         adapters::StreamingResponseCallback callback);
@@ -83,21 +105,134 @@ class ServiceManager {
   // Clear the response cache
   void ClearResponseCache();
 
+  // Enable or disable sharing one adapter call between matching
+  // ProcessTextAsync() and ProcessTextStream() requests in flight. On by
+  // default.
+  void EnableRequestDeduplication(bool enable);
+
+  // Back the response cache with an on-disk store at |path| so responses
+  // survive restarts. Memory misses consult the store and successful
+  // responses are written through.
+  void EnablePersistentCache(const base::FilePath& path,
+                             size_t max_bytes,
+                             base::TimeDelta time_to_live);
+
  private:
+  friend class base::NoDestructor<ServiceManager>;
+
+  // The adapters and their index at one point in time. Never changed once
+  // published.
+  struct Registry {
+    Registry();
+    Registry(const Registry&);
+    ~Registry();
+
+    // Adapter ID to adapter, owned by |owned_adapters_|
+    std::unordered_map<std::string, adapters::AdapterInterface*> adapters;
+
+    // Capability to the IDs of the adapters that have it, ordered by ID,
+    // so routing never calls GetCapabilities()
+    std::unordered_map<std::string, std::vector<std::string>>
+        capability_index;
+  };
+
   ServiceManager();
   ~ServiceManager();
 
+  // The current registry; never null
+  const Registry& registry() const {
+    return *registry_.load(std::memory_order_acquire);
+  }
+
   // Find the best adapter for a given capability
-  std::string FindBestAdapter(const std::string& capability);
+  std::string FindBestAdapter(const std::string& capability) const;
+
+  // Index the capabilities of |registry|'s adapters as they are now, and
+  // make it the current registry
+  void PublishLocked(std::unique_ptr<Registry> registry)
+      EXCLUSIVE_LOCKS_REQUIRED(registry_lock_);
+
+  // Key for |text_input| sent to |adapter_id| in the persistent store
+  static std::string GetPersistentCacheKey(const std::string& adapter_id,
+                                           const std::string& text_input);
+
+  // A caller waiting for a response
+  struct Waiter {
+    Waiter();
+    Waiter(const Waiter&);
+    ~Waiter();
+
+    adapters::ResponseCallback callback;
+    // Set instead of |callback| for streaming callers
+    adapters::StreamingResponseCallback stream_callback;
+  };
+
+  // Look |text_input| sent to |adapter_id| up in the response cache, then
+  // the persistent store. Sets |persistent_key| if the store was consulted.
+  bool GetCachedResponseLocked(const std::string& adapter_id,
+                               const std::string& text_input,
+                               adapters::ModelResponse* response,
+                               std::string* persistent_key)
+      EXCLUSIVE_LOCKS_REQUIRED(cache_lock_);
+  void PutCachedResponseLocked(const std::string& adapter_id,
+                               const std::string& text_input,
+                               const adapters::ModelResponse& response,
+                               std::string persistent_key)
+      EXCLUSIVE_LOCKS_REQUIRED(cache_lock_);
+
+  // Answer |waiter| from the cache, or add it to the matching request in
+  // flight, and return false. Otherwise return true with |key| set: the
+  // caller must send the request and pass its response to
+  // CompleteRequest().
+  bool StartRequest(const std::string& adapter_id,
+                    const std::string& text_input,
+                    const Waiter& waiter,
+                    std::string* key);
+
+  // Cache |response| if it succeeded, and deliver it to every caller
+  // waiting on the request for |key|
+  void CompleteRequest(const std::string& adapter_id,
+                       const std::string& text_input,
+                       const std::string& key,
+                       const adapters::ModelResponse& response);
 
-  // Map of adapter ID to adapter instance
-  std::unordered_map<std::string, std::unique_ptr<adapters::AdapterInterface>> adapters_;
+  static void Deliver(const Waiter& waiter,
+                      const adapters::ModelResponse& response);
 
-  // Response cache for improved performance
-  std::unique_ptr<util::ResponseCache> response_cache_;
+  // Deliver |response| to |callback| as if streamed: its text in chunks,
+  // then done
+  static void ReplayAsStream(
+      const adapters::ModelResponse& response,
+      const adapters::StreamingResponseCallback& callback);
+
+  // Serializes changes to the registry; reads do not take it
+  base::Lock registry_lock_;
+
+  // Every adapter ever registered, including those since replaced
+  std::vector<std::unique_ptr<adapters::AdapterInterface>> owned_adapters_
+      GUARDED_BY(registry_lock_);
 
-  // Singleton instance
-  static ServiceManager* instance_;
+  // Every registry published, the last being current
+  std::vector<std::unique_ptr<const Registry>> registries_
+      GUARDED_BY(registry_lock_);
+  std::atomic<const Registry*> registry_{nullptr};
+
+  // Guards the caches, which are not thread-safe themselves
+  base::Lock cache_lock_;
+
+  // Response cache for improved performance
+  std::unique_ptr<util::ResponseCache> response_cache_ GUARDED_BY(cache_lock_);
+
+  // Optional on-disk tier behind |response_cache_|
+  std::unique_ptr<PersistentResponseStore> persistent_cache_
+      GUARDED_BY(cache_lock_);
+
+  // Requests sent to an adapter and not yet answered, by persistent cache
+  // key, with the callers that joined them. The caller that sent one is
+  // not among them.
+  std::unordered_map<std::string, std::vector<Waiter>> in_flight_
+      GUARDED_BY(cache_lock_);
+  bool deduplicate_requests_ GUARDED_BY(cache_lock_) = true;
 };
 
 }  // namespace core
@@ -6,9 +6,14 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "asol/adapters/adapter_interface.h"
 #include "asol/adapters/gemini/gemini_text_adapter.h"
+#include "base/functional/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/synchronization/atomic_flag.h"
+#include "base/threading/thread.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/nlohmann_json/json.hpp"
 
@@ -16,6 +21,47 @@ namespace asol {
 namespace core {
 namespace {
 
+// Holds its async and streaming calls until the test answers them
+class HeldAdapter : public adapters::AdapterInterface {
+ public:
+  adapters::ModelResponse ProcessText(const std::string& text_input) override {
+    ++calls;
+    adapters::ModelResponse response;
+    response.success = true;
+    response.text = "sync " + text_input;
+    return response;
+  }
+  void ProcessTextAsync(const std::string& text_input,
+                        adapters::ResponseCallback callback) override {
+    ++calls;
+    async_callbacks.push_back(std::move(callback));
+  }
+  void ProcessTextStream(
+      const std::string& text_input,
+      adapters::StreamingResponseCallback callback) override {
+    ++calls;
+    stream_callbacks.push_back(std::move(callback));
+  }
+  std::string GetName() const override { return "Held"; }
+  std::vector<std::string> GetCapabilities() const override {
+    return {"held-generation"};
+  }
+  bool IsReady() const override { return true; }
+  bool Initialize(const std::string& config_json) override { return true; }
+  bool SupportsStreaming() const override { return true; }
+
+  int calls = 0;
+  std::vector<adapters::ResponseCallback> async_callbacks;
+  std::vector<adapters::StreamingResponseCallback> stream_callbacks;
+};
+
+adapters::ModelResponse MakeResponse(const std::string& text) {
+  adapters::ModelResponse response;
+  response.success = true;
+  response.text = text;
+  return response;
+}
+
 class ServiceManagerTest : public testing::Test {
  protected:
   void SetUp() override {
@@ -89,6 +135,111 @@ TEST_F(ServiceManagerTest, ProcessTextWithCapability) {
   EXPECT_FALSE(response.error_message.empty());
 }
 
+TEST_F(ServiceManagerTest, ReadsDuringRegistration) {
+  base::AtomicFlag done;
+  std::vector<std::unique_ptr<base::Thread>> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.push_back(
+        std::make_unique<base::Thread>("Reader" + base::NumberToString(i)));
+    ASSERT_TRUE(readers.back()->Start());
+    readers.back()->task_runner()->PostTask(
+        FROM_HERE, base::BindOnce(
+                       [](ServiceManager* service_manager,
+                          base::AtomicFlag* done) {
+                         while (!done->IsSet()) {
+                           // Registered in SetUp, and replaced but never
+                           // removed below
+                           const std::vector<std::string>& adapters =
+                               service_manager->FindAdaptersByCapability(
+                                   "text-generation");
+                           EXPECT_FALSE(adapters.empty());
+                           EXPECT_NE(service_manager->GetAdapter("gemini"),
+                                     nullptr);
+                         }
+                       },
+                       service_manager_, &done));
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    service_manager_->RegisterAdapter(
+        i % 2 ? "gemini" : "gemini-" + base::NumberToString(i),
+        std::make_unique<adapters::gemini::GeminiTextAdapter>());
+  }
+  done.Set();
+  for (auto& reader : readers) {
+    reader->Stop();
+  }
+
+  EXPECT_NE(service_manager_->GetAdapter("gemini-98"), nullptr);
+}
+
+TEST_F(ServiceManagerTest, AsyncRequestsShareOneCallAndTheCache) {
+  auto owned_adapter = std::make_unique<HeldAdapter>();
+  HeldAdapter* adapter = owned_adapter.get();
+  service_manager_->RegisterAdapter("held-async", std::move(owned_adapter));
+  service_manager_->ClearResponseCache();
+
+  std::vector<std::string> answers;
+  auto record = [&answers](const adapters::ModelResponse& response) {
+    answers.push_back(response.text);
+  };
+  service_manager_->ProcessTextAsync("held-async", "question", record);
+  service_manager_->ProcessTextAsync("held-async", "question", record);
+  EXPECT_EQ(adapter->calls, 1);
+
+  adapter->async_callbacks[0](MakeResponse("answer"));
+  EXPECT_EQ(answers, std::vector<std::string>({"answer", "answer"}));
+
+  // Cached now, for the async and sync paths alike
+  service_manager_->ProcessTextAsync("held-async", "question", record);
+  EXPECT_EQ(service_manager_->ProcessText("held-async", "question").text,
+            "answer");
+  EXPECT_EQ(adapter->calls, 1);
+  EXPECT_EQ(answers.size(), 3u);
+}
+
+TEST_F(ServiceManagerTest, StreamsReplayCachedAndJoinedResponses) {
+  auto owned_adapter = std::make_unique<HeldAdapter>();
+  HeldAdapter* adapter = owned_adapter.get();
+  service_manager_->RegisterAdapter("held-stream", std::move(owned_adapter));
+  service_manager_->ClearResponseCache();
+
+  struct Stream {
+    std::string text;
+    int chunks = 0;
+    bool done = false;
+  };
+  auto record = [](Stream* stream) {
+    return [stream](const adapters::ModelResponse& response, bool is_done) {
+      EXPECT_FALSE(stream->done);
+      stream->text += response.text;
+      ++stream->chunks;
+      stream->done = is_done;
+    };
+  };
+  Stream first;
+  Stream joined;
+  service_manager_->ProcessTextStream("held-stream", "story", record(&first));
+  service_manager_->ProcessTextStream("held-stream", "story", record(&joined));
+  ASSERT_EQ(adapter->calls, 1);
+
+  std::string long_text(600, 'x');
+  adapter->stream_callbacks[0](MakeResponse(long_text.substr(0, 300)), false);
+  EXPECT_EQ(first.text.size(), 300u);
+  EXPECT_EQ(joined.chunks, 0);
+  adapter->stream_callbacks[0](MakeResponse(long_text.substr(300)), true);
+  EXPECT_TRUE(first.done);
+  EXPECT_EQ(joined.text, long_text);
+  EXPECT_TRUE(joined.done);
+  EXPECT_GT(joined.chunks, 1);
+
+  Stream cached;
+  service_manager_->ProcessTextStream("held-stream", "story", record(&cached));
+  EXPECT_EQ(cached.text, long_text);
+  EXPECT_TRUE(cached.done);
+  EXPECT_EQ(adapter->calls, 1);
+}
+
 }  // namespace
 }  // namespace core
 }  // namespace asol
\ No newline at end of file
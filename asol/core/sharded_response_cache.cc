@@ -0,0 +1,290 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/sharded_response_cache.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "third_party/zlib/google/compression_utils.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Upper bound on the number of shards; a power of two so the shard index is
+// a mask of the key hash.
+constexpr size_t kMaxShards = 16;
+
+// Shards below this size would make per-shard LRU order noticeably worse
+// than a global one.
+constexpr size_t kMinEntriesPerShard = 32;
+
+// Approximate bookkeeping cost of one entry (list node, index slot, strings)
+constexpr size_t kEntryOverheadBytes = 128;
+
+}  // namespace
+
+ShardedResponseCache::ShardedResponseCache(const Limits& limits)
+    : limits_(limits),
+      memory_account_(
+          "response_cache",
+          base::BindRepeating(&ShardedResponseCache::OnMemoryPressure,
+                              base::Unretained(this))) {
+  ResetShards();
+}
+
+ShardedResponseCache::~ShardedResponseCache() = default;
+
+bool ShardedResponseCache::Get(
+    const RequestFingerprint& key,
+    const AIServiceProvider::AIRequestParams& request,
+    Entry* entry,
+    bool* is_stale) {
+  bool compressed = false;
+  {
+    uint64_t hash = HashKey(key);
+    Shard& shard = GetShard(hash);
+    base::AutoLock lock(shard.lock);
+
+    // Misses count too: a key that keeps missing is worth admitting
+    if (shard.sketch) {
+      shard.sketch->Increment(hash);
+    }
+
+    auto it = shard.index.find(key);
+    if (it == shard.index.end() ||
+        !it->second->second.request.Matches(request)) {
+      return false;
+    }
+
+    // Expired entries are reclaimed lazily, when a lookup runs into them or
+    // when they drift to the cold end of the list.
+    auto now = std::chrono::steady_clock::now();
+    if (IsExpired(it->second->second.entry, now)) {
+      RemoveLocked(shard, it->second);
+      expirations_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (is_stale) {
+      *is_stale = GetAgeSeconds(it->second->second.entry, now) >
+                  limits_.max_age_seconds;
+    }
+
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    *entry = it->second->second.entry;
+    compressed = it->second->second.compressed;
+  }
+
+  if (compressed) {
+    std::string uncompressed;
+    if (!compression::GzipUncompress(entry->response, &uncompressed)) {
+      LOG(ERROR) << "Failed to decompress cached response for key "
+                 << key.ToString();
+      return false;
+    }
+    entry->response = std::move(uncompressed);
+  }
+  return true;
+}
+
+void ShardedResponseCache::Put(const RequestFingerprint& key,
+                               RequestKey request,
+                               Entry entry) {
+  StoredEntry stored;
+  stored.uncompressed_size = entry.response.size();
+
+  size_t threshold = limits_.compression_threshold_bytes;
+  if (threshold > 0 && entry.response.size() >= threshold) {
+    std::string compressed;
+    if (compression::GzipCompress(entry.response, &compressed) &&
+        compressed.size() < entry.response.size()) {
+      entry.response = std::move(compressed);
+      stored.compressed = true;
+    }
+  }
+
+  // The request's text is usually shared with the caller, but may end up
+  // held by the cache alone
+  stored.charge = sizeof(key) + request.EstimateSize() +
+                  entry.response.size() + entry.provider_id.size() +
+                  kEntryOverheadBytes;
+  stored.entry = std::move(entry);
+  stored.request = std::move(request);
+  PutStored(key, std::move(stored), /*check_admission=*/true);
+}
+
+void ShardedResponseCache::PutStored(const RequestFingerprint& key,
+                                     StoredEntry stored,
+                                     bool check_admission) {
+  uint64_t hash = HashKey(key);
+  Shard& shard = GetShard(hash);
+  if (shard.capacity == 0 || stored.charge > shard.byte_capacity) {
+    return;
+  }
+
+  base::AutoLock lock(shard.lock);
+
+  auto it = shard.index.find(key);
+  if (it != shard.index.end()) {
+    RemoveLocked(shard, it->second);
+  } else if (check_admission && shard.sketch && !shard.lru.empty() &&
+             (shard.lru.size() >= shard.capacity ||
+              shard.bytes + stored.charge > shard.byte_capacity) &&
+             !ShouldAdmitLocked(shard, hash)) {
+    admission_rejections_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  shard.bytes += stored.charge;
+  resident_bytes_.fetch_add(stored.charge, std::memory_order_relaxed);
+  uncompressed_bytes_.fetch_add(stored.uncompressed_size,
+                                std::memory_order_relaxed);
+  stored_response_bytes_.fetch_add(stored.entry.response.size(),
+                                   std::memory_order_relaxed);
+  if (stored.compressed) {
+    compressed_entries_.fetch_add(1, std::memory_order_relaxed);
+  }
+  size_.fetch_add(1, std::memory_order_relaxed);
+  ReportMemoryUsage();
+
+  shard.lru.emplace_front(key, std::move(stored));
+  shard.index[key] = shard.lru.begin();
+
+  // Expired entries sitting at the cold end go first; they would be the next
+  // LRU victims anyway.
+  auto now = std::chrono::steady_clock::now();
+  while (shard.lru.size() > 1 && IsExpired(shard.lru.back().second.entry, now)) {
+    RemoveLocked(shard, std::prev(shard.lru.end()));
+    expirations_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  while (shard.lru.size() > shard.capacity ||
+         shard.bytes > shard.byte_capacity) {
+    RemoveLocked(shard, std::prev(shard.lru.end()));
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+bool ShardedResponseCache::ShouldAdmitLocked(Shard& shard, uint64_t hash) {
+  uint64_t victim_hash = HashKey(shard.lru.back().first);
+  return shard.sketch->Estimate(hash) > shard.sketch->Estimate(victim_hash);
+}
+
+void ShardedResponseCache::RemoveLocked(Shard& shard, LruList::iterator it) {
+  const StoredEntry& stored = it->second;
+  shard.bytes -= stored.charge;
+  resident_bytes_.fetch_sub(stored.charge, std::memory_order_relaxed);
+  uncompressed_bytes_.fetch_sub(stored.uncompressed_size,
+                                std::memory_order_relaxed);
+  stored_response_bytes_.fetch_sub(stored.entry.response.size(),
+                                   std::memory_order_relaxed);
+  if (stored.compressed) {
+    compressed_entries_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  size_.fetch_sub(1, std::memory_order_relaxed);
+  ReportMemoryUsage();
+
+  shard.index.erase(it->first);
+  shard.lru.erase(it);
+}
+
+void ShardedResponseCache::Configure(const Limits& limits) {
+  limits_ = limits;
+  std::vector<std::unique_ptr<Shard>> old_shards = ResetShards();
+
+  // Migrate coldest first so each shard's LRU order is preserved. Entries
+  // keep their current encoding.
+  for (auto& old_shard : old_shards) {
+    base::AutoLock lock(old_shard->lock);
+    for (auto it = old_shard->lru.rbegin(); it != old_shard->lru.rend(); ++it) {
+      PutStored(it->first, std::move(it->second), /*check_admission=*/false);
+    }
+  }
+}
+
+void ShardedResponseCache::Clear() {
+  ResetShards();
+}
+
+void ShardedResponseCache::Shrink(double fraction) {
+  for (auto& shard : shards_) {
+    size_t target = static_cast<size_t>(shard->byte_capacity * fraction);
+    base::AutoLock lock(shard->lock);
+    while (!shard->lru.empty() && shard->bytes > target) {
+      RemoveLocked(*shard, std::prev(shard->lru.end()));
+      evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+std::vector<std::unique_ptr<ShardedResponseCache::Shard>>
+ShardedResponseCache::ResetShards() {
+  size_t max_entries = limits_.max_entries;
+  size_t shard_count = 1;
+  while (shard_count < kMaxShards &&
+         max_entries / (shard_count * 2) >= kMinEntriesPerShard) {
+    shard_count *= 2;
+  }
+
+  std::vector<std::unique_ptr<Shard>> new_shards(shard_count);
+  for (size_t i = 0; i < shard_count; ++i) {
+    new_shards[i] = std::make_unique<Shard>();
+    // Spread the remainder so total capacity matches |max_entries|
+    new_shards[i]->capacity =
+        max_entries / shard_count + (i < max_entries % shard_count ? 1 : 0);
+    new_shards[i]->byte_capacity = limits_.max_bytes / shard_count;
+    if (limits_.frequency_admission) {
+      base::AutoLock lock(new_shards[i]->lock);
+      new_shards[i]->sketch =
+          std::make_unique<FrequencySketch>(new_shards[i]->capacity);
+    }
+  }
+
+  shards_.swap(new_shards);
+  size_.store(0, std::memory_order_relaxed);
+  resident_bytes_.store(0, std::memory_order_relaxed);
+  uncompressed_bytes_.store(0, std::memory_order_relaxed);
+  stored_response_bytes_.store(0, std::memory_order_relaxed);
+  compressed_entries_.store(0, std::memory_order_relaxed);
+  ReportMemoryUsage();
+  return new_shards;
+}
+
+void ShardedResponseCache::OnMemoryPressure(
+    MemoryAccount::PressureLevel level) {
+  Shrink(level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL
+             ? 0.0
+             : 0.5);
+}
+
+void ShardedResponseCache::ReportMemoryUsage() {
+  memory_account_.Update(resident_bytes(), size());
+}
+
+ShardedResponseCache::Shard& ShardedResponseCache::GetShard(uint64_t hash) {
+  return *shards_[hash & (shards_.size() - 1)];
+}
+
+// static
+int64_t ShardedResponseCache::GetAgeSeconds(
+    const Entry& entry,
+    std::chrono::steady_clock::time_point now) {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+      now - entry.timestamp).count();
+}
+
+bool ShardedResponseCache::IsExpired(
+    const Entry& entry,
+    std::chrono::steady_clock::time_point now) const {
+  return GetAgeSeconds(entry, now) >
+         limits_.max_age_seconds +
+             std::max(limits_.stale_while_revalidate_seconds, 0);
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,214 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_SHARDED_RESPONSE_CACHE_H_
+#define ASOL_CORE_SHARDED_RESPONSE_CACHE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asol/core/frequency_sketch.h"
+#include "asol/core/memory_accountant.h"
+#include "asol/core/request_fingerprint.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+namespace asol {
+namespace core {
+
+// ShardedResponseCache is the in-memory tier of the AI response cache. Keys
+// are spread over independently locked shards, each an O(1) LRU (list plus
+// hash index), so concurrent lookups from feature workers only contend when
+// they land on the same shard. Counters are atomics and never take a lock.
+//
+// With the frequency admission filter enabled, every lookup is recorded in a
+// per-shard TinyLFU sketch and a new key that would force an eviction is only
+// admitted if it has been requested more often than the LRU victim. One-off
+// prompts then cannot flush entries that keep getting hit.
+//
+// The cache is bounded both by entry count and by resident bytes. Responses
+// at or above the compression threshold are stored gzip-compressed when that
+// makes them smaller; compression and decompression run outside the shard
+// lock.
+//
+// Resident bytes and entries are reported to the MemoryAccountant as
+// "response_cache". Under memory pressure the shards shrink: to half their
+// byte budget when moderate, to nothing when critical.
+//
+// Get(), Put() and Shrink() are safe to call from any thread.
+// Configure() and Clear() rebuild the shards and must not race with other
+// calls; make them during setup or on the owning sequence while no workers
+// are active.
+class ShardedResponseCache {
+ public:
+  struct Entry {
+    std::string response;
+    std::chrono::time_point<std::chrono::steady_clock> timestamp;
+    std::string provider_id;
+  };
+
+  struct Limits {
+    size_t max_entries = 100;
+    size_t max_bytes = 32 * 1024 * 1024;
+    int max_age_seconds = 3600;
+
+    // Entries past |max_age_seconds| but within this window are still
+    // returned, flagged as stale
+    int stale_while_revalidate_seconds = 0;
+
+    // Responses at least this large are compressed; 0 disables compression
+    size_t compression_threshold_bytes = 4096;
+
+    // Whether a full shard consults the TinyLFU sketch before admitting
+    bool frequency_admission = false;
+  };
+
+  explicit ShardedResponseCache(const Limits& limits);
+  ~ShardedResponseCache();
+
+  ShardedResponseCache(const ShardedResponseCache&) = delete;
+  ShardedResponseCache& operator=(const ShardedResponseCache&) = delete;
+
+  // Copy the live entry for |key| into |entry| and promote it. Only an
+  // entry put for |request| itself is a hit; one whose fingerprint merely
+  // collides is a miss. Entries in the stale-while-revalidate window set
+  // |is_stale|; entries beyond it are dropped and reported as misses.
+  bool Get(const RequestFingerprint& key,
+           const AIServiceProvider::AIRequestParams& request,
+           Entry* entry,
+           bool* is_stale = nullptr);
+
+  // Insert or refresh |key|, the fingerprint of |request|, evicting the
+  // shard's LRU entries until both the entry and byte budgets hold. Entries
+  // larger than a shard's byte budget are not cached.
+  void Put(const RequestFingerprint& key, RequestKey request, Entry entry);
+
+  // Change limits. The shard count follows |max_entries| so small caches
+  // keep exact LRU order; surviving entries are migrated.
+  void Configure(const Limits& limits);
+
+  void Clear();
+
+  // Evict each shard's LRU entries until it holds at most |fraction| of its
+  // byte budget
+  void Shrink(double fraction);
+
+  size_t size() const { return size_.load(std::memory_order_relaxed); }
+  size_t evictions() const {
+    return evictions_.load(std::memory_order_relaxed);
+  }
+  size_t expirations() const {
+    return expirations_.load(std::memory_order_relaxed);
+  }
+
+  // Bytes charged against |max_bytes|, after compression
+  size_t resident_bytes() const {
+    return resident_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Bytes the resident responses would take uncompressed
+  size_t uncompressed_bytes() const {
+    return uncompressed_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Bytes the resident responses take as stored, compressed or not. Unlike
+  // resident_bytes() this leaves out keys and bookkeeping.
+  size_t stored_response_bytes() const {
+    return stored_response_bytes_.load(std::memory_order_relaxed);
+  }
+
+  size_t compressed_entries() const {
+    return compressed_entries_.load(std::memory_order_relaxed);
+  }
+
+  // New keys refused by the admission filter
+  size_t admission_rejections() const {
+    return admission_rejections_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct StoredEntry {
+    Entry entry;              // |entry.response| is compressed if |compressed|
+    RequestKey request;       // What |entry| answers
+    bool compressed = false;
+    size_t uncompressed_size = 0;
+    size_t charge = 0;        // Bytes charged against the budget
+  };
+
+  using LruList = std::list<std::pair<RequestFingerprint, StoredEntry>>;
+
+  struct Shard {
+    base::Lock lock;
+    size_t capacity = 0;
+    size_t byte_capacity = 0;
+    size_t bytes GUARDED_BY(lock) = 0;
+    LruList lru GUARDED_BY(lock);
+    std::unordered_map<RequestFingerprint, LruList::iterator,
+                       RequestFingerprint::Hash>
+        index GUARDED_BY(lock);
+
+    // Null unless frequency admission is enabled
+    std::unique_ptr<FrequencySketch> sketch GUARDED_BY(lock);
+  };
+
+  // Allocate shards for |limits_|, returning the old ones.
+  std::vector<std::unique_ptr<Shard>> ResetShards();
+
+  // Shard selection and the admission sketch use the high half of the
+  // fingerprint; the index hashes on the low half.
+  static uint64_t HashKey(const RequestFingerprint& key) { return key.high; }
+  Shard& GetShard(uint64_t hash);
+
+  // Insert an already prepared entry. |check_admission| is false when
+  // migrating entries that were already admitted.
+  void PutStored(const RequestFingerprint& key,
+                 StoredEntry stored,
+                 bool check_admission);
+
+  // Whether the sketch prefers |hash| over the shard's LRU victim
+  bool ShouldAdmitLocked(Shard& shard, uint64_t hash)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.lock);
+
+  // Unlink the entry at |it| and release its accounting.
+  void RemoveLocked(Shard& shard, LruList::iterator it)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.lock);
+
+  // Age of |entry| in seconds
+  static int64_t GetAgeSeconds(const Entry& entry,
+                               std::chrono::steady_clock::time_point now);
+
+  // Past the stale-while-revalidate window, so no longer servable
+  bool IsExpired(const Entry& entry,
+                 std::chrono::steady_clock::time_point now) const;
+
+  void OnMemoryPressure(MemoryAccount::PressureLevel level);
+  void ReportMemoryUsage();
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  Limits limits_;
+
+  std::atomic<size_t> size_{0};
+  std::atomic<size_t> evictions_{0};
+  std::atomic<size_t> expirations_{0};
+  std::atomic<size_t> resident_bytes_{0};
+  std::atomic<size_t> uncompressed_bytes_{0};
+  std::atomic<size_t> stored_response_bytes_{0};
+  std::atomic<size_t> compressed_entries_{0};
+  std::atomic<size_t> admission_rejections_{0};
+
+  // Last, so it unregisters before anything its callback touches goes
+  MemoryAccount memory_account_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_SHARDED_RESPONSE_CACHE_H_
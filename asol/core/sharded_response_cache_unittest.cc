@@ -0,0 +1,222 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/sharded_response_cache.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+ShardedResponseCache::Limits MakeLimits(size_t max_entries,
+                                        int max_age_seconds = 3600) {
+  ShardedResponseCache::Limits limits;
+  limits.max_entries = max_entries;
+  limits.max_age_seconds = max_age_seconds;
+  return limits;
+}
+
+ShardedResponseCache::Entry MakeEntry(const std::string& response) {
+  ShardedResponseCache::Entry entry;
+  entry.response = response;
+  entry.timestamp = std::chrono::steady_clock::now();
+  entry.provider_id = "test";
+  return entry;
+}
+
+AIServiceProvider::AIRequestParams Request(const std::string& text) {
+  AIServiceProvider::AIRequestParams params;
+  params.task_type = AIServiceProvider::TaskType::CUSTOM;
+  params.input_text = text;
+  return params;
+}
+
+RequestFingerprint Key(const std::string& text) {
+  return ComputeRequestFingerprint(AIServiceProvider::TaskType::CUSTOM, text,
+                                   {});
+}
+
+// Put |response| for the request with input |text|
+void Put(ShardedResponseCache& cache,
+         const std::string& text,
+         const std::string& response) {
+  cache.Put(Key(text), RequestKey(Request(text)), MakeEntry(response));
+}
+
+TEST(ShardedResponseCacheTest, SmallCacheKeepsExactLruOrder) {
+  ShardedResponseCache cache(MakeLimits(2));
+  Put(cache, "a", "1");
+  Put(cache, "b", "2");
+
+  ShardedResponseCache::Entry entry;
+  ASSERT_TRUE(cache.Get(Key("a"), Request("a"), &entry));
+  Put(cache, "c", "3");
+
+  EXPECT_TRUE(cache.Get(Key("a"), Request("a"), &entry));
+  EXPECT_FALSE(cache.Get(Key("b"), Request("b"), &entry));
+  EXPECT_TRUE(cache.Get(Key("c"), Request("c"), &entry));
+  EXPECT_EQ(cache.evictions(), 1u);
+}
+
+TEST(ShardedResponseCacheTest, CollidingFingerprintIsAMiss) {
+  ShardedResponseCache cache(MakeLimits(8));
+  // As if "b" hashed to the fingerprint of "a"
+  cache.Put(Key("a"), RequestKey(Request("b")), MakeEntry("for b"));
+
+  ShardedResponseCache::Entry entry;
+  EXPECT_FALSE(cache.Get(Key("a"), Request("a"), &entry));
+  ASSERT_TRUE(cache.Get(Key("a"), Request("b"), &entry));
+  EXPECT_EQ(entry.response, "for b");
+}
+
+TEST(ShardedResponseCacheTest, ExpiredEntriesAreMisses) {
+  ShardedResponseCache cache(MakeLimits(8, -1));
+  Put(cache, "a", "1");
+
+  ShardedResponseCache::Entry entry;
+  EXPECT_FALSE(cache.Get(Key("a"), Request("a"), &entry));
+  EXPECT_EQ(cache.expirations(), 1u);
+  EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(ShardedResponseCacheTest, StaleWindowServesFlaggedEntries) {
+  ShardedResponseCache::Limits limits = MakeLimits(8, -1);
+  limits.stale_while_revalidate_seconds = 60;
+  ShardedResponseCache cache(limits);
+  Put(cache, "a", "1");
+
+  ShardedResponseCache::Entry entry;
+  bool is_stale = false;
+  ASSERT_TRUE(cache.Get(Key("a"), Request("a"), &entry, &is_stale));
+  EXPECT_TRUE(is_stale);
+  EXPECT_EQ(entry.response, "1");
+}
+
+TEST(ShardedResponseCacheTest, AdmissionFilterProtectsPopularEntries) {
+  ShardedResponseCache::Limits limits = MakeLimits(2);
+  limits.frequency_admission = true;
+  ShardedResponseCache cache(limits);
+
+  ShardedResponseCache::Entry entry;
+  for (const std::string key : {"hot1", "hot2"}) {
+    for (int i = 0; i < 5; ++i) {
+      cache.Get(Key(key), Request(key), &entry);
+    }
+    Put(cache, key, key);
+  }
+
+  // A key seen once must not displace either popular entry
+  cache.Get(Key("once"), Request("once"), &entry);
+  Put(cache, "once", "once");
+  EXPECT_FALSE(cache.Get(Key("once"), Request("once"), &entry));
+  EXPECT_TRUE(cache.Get(Key("hot1"), Request("hot1"), &entry));
+  EXPECT_TRUE(cache.Get(Key("hot2"), Request("hot2"), &entry));
+  EXPECT_EQ(cache.admission_rejections(), 1u);
+
+  // Once it has been asked for often enough it gets in
+  for (int i = 0; i < 10; ++i) {
+    cache.Get(Key("once"), Request("once"), &entry);
+  }
+  Put(cache, "once", "once");
+  EXPECT_TRUE(cache.Get(Key("once"), Request("once"), &entry));
+}
+
+TEST(ShardedResponseCacheTest, ConfigureMigratesEntries) {
+  ShardedResponseCache cache(MakeLimits(4));
+  Put(cache, "a", "1");
+  Put(cache, "b", "2");
+
+  cache.Configure(MakeLimits(1024));
+
+  ShardedResponseCache::Entry entry;
+  ASSERT_TRUE(cache.Get(Key("a"), Request("a"), &entry));
+  EXPECT_EQ(entry.response, "1");
+  EXPECT_TRUE(cache.Get(Key("b"), Request("b"), &entry));
+  EXPECT_EQ(cache.size(), 2u);
+}
+
+TEST(ShardedResponseCacheTest, ConcurrentAccessStaysWithinCapacity) {
+  constexpr size_t kCapacity = 512;
+  ShardedResponseCache cache(MakeLimits(kCapacity));
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&cache, t] {
+      ShardedResponseCache::Entry entry;
+      for (int i = 0; i < 2000; ++i) {
+        std::string key = base::NumberToString((i * 7 + t) % 1500);
+        if (!cache.Get(Key(key), Request(key), &entry)) {
+          Put(cache, key, key);
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  EXPECT_LE(cache.size(), kCapacity);
+  EXPECT_GT(cache.evictions(), 0u);
+}
+
+TEST(ShardedResponseCacheTest, ByteBudgetEvictsLargeEntries) {
+  ShardedResponseCache::Limits limits = MakeLimits(100);
+  limits.max_bytes = 4096;
+  limits.compression_threshold_bytes = 0;
+  ShardedResponseCache cache(limits);
+
+  Put(cache, "small", "x");
+  Put(cache, "large1", std::string(1500, 'a'));
+  Put(cache, "large2", std::string(1500, 'b'));
+  Put(cache, "large3", std::string(1500, 'c'));
+
+  EXPECT_LE(cache.resident_bytes(), limits.max_bytes);
+  EXPECT_GT(cache.evictions(), 0u);
+
+  // Larger than the whole budget: never admitted
+  Put(cache, "huge", std::string(8192, 'd'));
+  ShardedResponseCache::Entry entry;
+  EXPECT_FALSE(cache.Get(Key("huge"), Request("huge"), &entry));
+}
+
+TEST(ShardedResponseCacheTest, StoredBytesMatchUncompressedBelowThreshold) {
+  ShardedResponseCache::Limits limits = MakeLimits(10);
+  limits.compression_threshold_bytes = 256;
+  ShardedResponseCache cache(limits);
+
+  Put(cache, "a", "short");
+  Put(cache, "b", "shorter");
+  EXPECT_EQ(cache.stored_response_bytes(), cache.uncompressed_bytes());
+
+  cache.Clear();
+  EXPECT_EQ(cache.stored_response_bytes(), 0u);
+}
+
+TEST(ShardedResponseCacheTest, CompressesLargeResponsesTransparently) {
+  ShardedResponseCache::Limits limits = MakeLimits(10);
+  limits.compression_threshold_bytes = 256;
+  ShardedResponseCache cache(limits);
+
+  std::string response(10000, 'z');
+  Put(cache, "key", response);
+
+  EXPECT_EQ(cache.compressed_entries(), 1u);
+  EXPECT_EQ(cache.uncompressed_bytes(), response.size());
+  EXPECT_LT(cache.resident_bytes(), response.size());
+  EXPECT_LT(cache.stored_response_bytes(), cache.resident_bytes());
+
+  ShardedResponseCache::Entry entry;
+  ASSERT_TRUE(cache.Get(Key("key"), Request("key"), &entry));
+  EXPECT_EQ(entry.response, response);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
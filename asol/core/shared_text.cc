@@ -0,0 +1,79 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/shared_text.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace asol {
+namespace core {
+
+SharedText::SharedText() = default;
+
+SharedText::SharedText(std::string text)
+    : size_(text.size()) {
+  if (!text.empty()) {
+    buffer_ = base::MakeRefCounted<base::RefCountedString>(std::move(text));
+  }
+}
+
+SharedText::SharedText(const char* text) : SharedText(std::string(text)) {}
+
+SharedText::SharedText(std::string_view text)
+    : SharedText(std::string(text)) {}
+
+SharedText::SharedText(const SharedText&) = default;
+SharedText& SharedText::operator=(const SharedText&) = default;
+
+SharedText::SharedText(SharedText&& other)
+    : buffer_(std::move(other.buffer_)),
+      offset_(std::exchange(other.offset_, 0)),
+      size_(std::exchange(other.size_, 0)) {}
+
+SharedText& SharedText::operator=(SharedText&& other) {
+  buffer_ = std::move(other.buffer_);
+  offset_ = std::exchange(other.offset_, 0);
+  size_ = std::exchange(other.size_, 0);
+  return *this;
+}
+
+SharedText::~SharedText() = default;
+
+std::string_view SharedText::view() const {
+  if (!buffer_) {
+    return std::string_view();
+  }
+  return std::string_view(buffer_->as_string()).substr(offset_, size_);
+}
+
+SharedText SharedText::Substr(size_t pos, size_t count) const {
+  SharedText slice;
+  if (pos >= size_) {
+    return slice;
+  }
+  slice.buffer_ = buffer_;
+  slice.offset_ = offset_ + pos;
+  slice.size_ = std::min(count, size_ - pos);
+  return slice;
+}
+
+bool SharedText::SharesBufferWith(const SharedText& other) const {
+  return buffer_ && buffer_ == other.buffer_;
+}
+
+bool operator==(const SharedText& a, const SharedText& b) {
+  return a.view() == b.view();
+}
+
+bool operator!=(const SharedText& a, const SharedText& b) {
+  return !(a == b);
+}
+
+std::ostream& operator<<(std::ostream& out, const SharedText& text) {
+  return out << text.view();
+}
+
+}  // namespace core
+}  // namespace asol
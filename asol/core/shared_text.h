@@ -0,0 +1,69 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_SHARED_TEXT_H_
+#define ASOL_CORE_SHARED_TEXT_H_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_refptr.h"
+
+namespace asol {
+namespace core {
+
+// SharedText is an immutable, reference-counted string, or a slice of one.
+// Copying or slicing it copies a pointer, so a page's text can go through
+// every stage of a request, including its retries, fallbacks and queues,
+// while existing once in memory. The count is thread-safe, so copies may
+// be handed to other sequences.
+class SharedText {
+ public:
+  SharedText();
+  // Implicit so that code filling in a std::string keeps working; the
+  // string is moved in, not copied, when passed as an rvalue.
+  SharedText(std::string text);  // NOLINT(google-explicit-constructor)
+  SharedText(const char* text);  // NOLINT(google-explicit-constructor)
+  // Copies |text|
+  explicit SharedText(std::string_view text);
+
+  SharedText(const SharedText&);
+  SharedText& operator=(const SharedText&);
+  SharedText(SharedText&& other);
+  SharedText& operator=(SharedText&& other);
+  ~SharedText();
+
+  // Valid for as long as this or any copy sharing its buffer is alive
+  std::string_view view() const;
+  operator std::string_view() const { return view(); }  // NOLINT
+
+  const char* data() const { return view().data(); }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // At most |count| bytes from |pos| on, sharing this text's buffer.
+  // |pos| past the end gives an empty text.
+  SharedText Substr(size_t pos,
+                    size_t count = std::string_view::npos) const;
+
+  // Whether this and |other| are views into the same buffer
+  bool SharesBufferWith(const SharedText& other) const;
+
+ private:
+  scoped_refptr<const base::RefCountedString> buffer_;
+  size_t offset_ = 0;
+  size_t size_ = 0;
+};
+
+bool operator==(const SharedText& a, const SharedText& b);
+bool operator!=(const SharedText& a, const SharedText& b);
+std::ostream& operator<<(std::ostream& out, const SharedText& text);
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_SHARED_TEXT_H_
@@ -0,0 +1,58 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/shared_text.h"
+
+#include <string>
+#include <utility>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+TEST(SharedTextTest, CopiesShareTheBuffer) {
+  std::string page(100000, 'x');
+  const char* bytes = page.data();
+  SharedText text(std::move(page));
+  // Moved in, not copied
+  EXPECT_EQ(text.data(), bytes);
+
+  SharedText copy = text;
+  EXPECT_EQ(copy.data(), text.data());
+  EXPECT_TRUE(copy.SharesBufferWith(text));
+  EXPECT_EQ(copy.size(), 100000u);
+}
+
+TEST(SharedTextTest, SlicesShareTheBuffer) {
+  SharedText text("hello world");
+  SharedText world = text.Substr(6);
+  EXPECT_EQ(world, "world");
+  EXPECT_EQ(world.data(), text.data() + 6);
+  EXPECT_TRUE(world.SharesBufferWith(text));
+
+  EXPECT_EQ(text.Substr(0, 5), "hello");
+  EXPECT_EQ(world.Substr(1, 100), "orld");
+  EXPECT_TRUE(text.Substr(50).empty());
+}
+
+TEST(SharedTextTest, MovedFromIsEmpty) {
+  SharedText text("hello");
+  SharedText moved = std::move(text);
+  EXPECT_EQ(moved, "hello");
+  EXPECT_TRUE(text.empty());
+  EXPECT_EQ(text.view(), "");
+}
+
+TEST(SharedTextTest, ComparesByContent) {
+  EXPECT_EQ(SharedText("abc"), SharedText(std::string("abc")));
+  EXPECT_NE(SharedText("abc"), SharedText("abd"));
+  EXPECT_EQ(SharedText(), SharedText(""));
+  EXPECT_FALSE(SharedText("abc").SharesBufferWith(SharedText("abc")));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,149 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/startup_trace.h"
+
+#include <memory>
+
+#include "base/environment.h"
+#include "base/files/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/values.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Set once by StartupTrace::Start() and kept for the life of the process
+StartupTrace* g_startup_trace = nullptr;
+
+double ToMilliseconds(base::TimeTicks time) {
+  return (time - base::TimeTicks()).InMillisecondsF();
+}
+
+base::TimeTicks FromMilliseconds(double milliseconds) {
+  return base::TimeTicks() + base::Milliseconds(milliseconds);
+}
+
+}  // namespace
+
+// static
+void StartupTrace::Start(std::string_view process_name) {
+  if (g_startup_trace) {
+    return;
+  }
+  std::string path;
+  if (!base::Environment::Create()->GetVar(kPathVariable, &path) ||
+      path.empty()) {
+    return;
+  }
+  // Leaked: phases may be reported until the process exits
+  g_startup_trace =
+      new StartupTrace(base::FilePath::FromUTF8Unsafe(path), process_name);
+  g_startup_trace->AddMarkOnce("main");
+}
+
+// static
+StartupTrace* StartupTrace::Get() {
+  return g_startup_trace;
+}
+
+StartupTrace::StartupTrace(const base::FilePath& path,
+                           std::string_view process_name)
+    : path_(path), process_name_(process_name) {}
+
+StartupTrace::~StartupTrace() = default;
+
+void StartupTrace::AddPhase(std::string_view phase,
+                            base::TimeTicks start,
+                            base::TimeTicks end) {
+  Phase entry;
+  entry.process = process_name_;
+  entry.phase = std::string(phase);
+  entry.start = start;
+  entry.end = end;
+  std::string line = SerializePhase(entry);
+  line += '\n';
+
+  // One append per line, so lines from several threads or processes
+  // sharing the file never interleave
+  base::AutoLock lock(lock_);
+  if (!base::AppendToFile(path_, line)) {
+    LOG(ERROR) << "Cannot append to startup trace " << path_.value();
+  }
+}
+
+void StartupTrace::AddMark(std::string_view phase) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  AddPhase(phase, now, now);
+}
+
+void StartupTrace::AddMarkOnce(std::string_view phase) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  AddPhaseOnce(phase, now, now);
+}
+
+void StartupTrace::AddPhaseOnce(std::string_view phase,
+                                base::TimeTicks start,
+                                base::TimeTicks end) {
+  {
+    base::AutoLock lock(lock_);
+    if (!reported_.emplace(phase).second) {
+      return;
+    }
+  }
+  AddPhase(phase, start, end);
+}
+
+// static
+std::string StartupTrace::SerializePhase(const Phase& phase) {
+  base::Value::Dict value;
+  value.Set("process", phase.process);
+  value.Set("phase", phase.phase);
+  value.Set("start_ms", ToMilliseconds(phase.start));
+  value.Set("end_ms", ToMilliseconds(phase.end));
+
+  std::string line;
+  base::JSONWriter::Write(value, &line);
+  return line;
+}
+
+// static
+std::optional<StartupTrace::Phase> StartupTrace::ParsePhase(
+    std::string_view line) {
+  absl::optional<base::Value> value = base::JSONReader::Read(line);
+  if (!value || !value->is_dict()) {
+    return std::nullopt;
+  }
+  const base::Value::Dict& dict = value->GetDict();
+  const std::string* process = dict.FindString("process");
+  const std::string* phase = dict.FindString("phase");
+  absl::optional<double> start_ms = dict.FindDouble("start_ms");
+  absl::optional<double> end_ms = dict.FindDouble("end_ms");
+  if (!process || !phase || !start_ms || !end_ms || *end_ms < *start_ms) {
+    return std::nullopt;
+  }
+
+  Phase entry;
+  entry.process = *process;
+  entry.phase = *phase;
+  entry.start = FromMilliseconds(*start_ms);
+  entry.end = FromMilliseconds(*end_ms);
+  return entry;
+}
+
+ScopedStartupPhase::ScopedStartupPhase(const char* phase)
+    : phase_(phase), start_(base::TimeTicks::Now()) {}
+
+ScopedStartupPhase::~ScopedStartupPhase() {
+  if (StartupTrace* trace = StartupTrace::Get()) {
+    trace->AddPhaseOnce(phase_, start_, base::TimeTicks::Now());
+  }
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,111 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_STARTUP_TRACE_H_
+#define ASOL_CORE_STARTUP_TRACE_H_
+
+#include <functional>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// StartupTrace reports how long each phase of a process's startup took, for
+// browser_core/benchmarks/startup_benchmark.cc, which launches the process
+// with $DASHAI_STARTUP_TRACE naming a file. Without the variable nothing is
+// traced and Get() returns null, so the calls cost a null check.
+//
+// The file has one JSON object per phase:
+//
+//   {"process":"browser","phase":"config_load","start_ms":81234.5,
+//    "end_ms":81236.1}
+//
+// Times are base::TimeTicks in milliseconds. On Linux that is
+// CLOCK_MONOTONIC, which every process shares, so the benchmark can measure
+// them from the moment it launched the process. A mark is a phase that
+// starts and ends at once, e.g. "first_paint". The gateway writes the same
+// format (asol/cpp/utils/startup_trace.h), so both may share one file.
+//
+// Each phase is appended to the file as it ends, with a single write, so
+// nothing is lost if the process is killed. That blocks on IO, but only
+// when tracing, a dozen times per process. Thread-safe.
+class StartupTrace {
+ public:
+  // Names the file to append to
+  static constexpr char kPathVariable[] = "DASHAI_STARTUP_TRACE";
+
+  struct Phase {
+    std::string process;
+    std::string phase;
+    base::TimeTicks start;
+    base::TimeTicks end;
+  };
+
+  // Trace this process as |process_name| if $DASHAI_STARTUP_TRACE is set.
+  // Call first thing in main(); the "main" mark is added.
+  static void Start(std::string_view process_name);
+
+  // The process's trace, or null when not tracing
+  static StartupTrace* Get();
+
+  StartupTrace(const base::FilePath& path, std::string_view process_name);
+  ~StartupTrace();
+
+  StartupTrace(const StartupTrace&) = delete;
+  StartupTrace& operator=(const StartupTrace&) = delete;
+
+  void AddPhase(std::string_view phase,
+                base::TimeTicks start,
+                base::TimeTicks end);
+
+  // Add a mark at the current time
+  void AddMark(std::string_view phase);
+
+  // Add |phase| the first time it is reported in this process only, e.g.
+  // for the first summary
+  void AddMarkOnce(std::string_view phase);
+  void AddPhaseOnce(std::string_view phase,
+                    base::TimeTicks start,
+                    base::TimeTicks end);
+
+  static std::string SerializePhase(const Phase& phase);
+  static std::optional<Phase> ParsePhase(std::string_view line);
+
+ private:
+  const base::FilePath path_;
+  const std::string process_name_;
+
+  base::Lock lock_;
+  std::set<std::string, std::less<>> reported_ GUARDED_BY(lock_);
+};
+
+// Adds the phase from its construction to its destruction to the
+// process's trace, if tracing. Only the first occurrence of a phase is
+// added, so one that recurs after startup, e.g. a config reload, is not.
+class ScopedStartupPhase {
+ public:
+  // |phase| must outlive this
+  explicit ScopedStartupPhase(const char* phase);
+  ~ScopedStartupPhase();
+
+  ScopedStartupPhase(const ScopedStartupPhase&) = delete;
+  ScopedStartupPhase& operator=(const ScopedStartupPhase&) = delete;
+
+ private:
+  const char* const phase_;
+  const base::TimeTicks start_;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_STARTUP_TRACE_H_
@@ -0,0 +1,88 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/startup_trace.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/string_split.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+std::vector<StartupTrace::Phase> ReadPhases(const base::FilePath& path) {
+  std::string contents;
+  EXPECT_TRUE(base::ReadFileToString(path, &contents));
+  std::vector<StartupTrace::Phase> phases;
+  for (const std::string& line : base::SplitString(
+           contents, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    std::optional<StartupTrace::Phase> phase = StartupTrace::ParsePhase(line);
+    EXPECT_TRUE(phase) << line;
+    if (phase) {
+      phases.push_back(*phase);
+    }
+  }
+  return phases;
+}
+
+TEST(StartupTraceTest, PhaseRoundTrips) {
+  StartupTrace::Phase phase;
+  phase.process = "browser";
+  phase.phase = "config_load";
+  phase.start = base::TimeTicks() + base::Milliseconds(81234.5);
+  phase.end = base::TimeTicks() + base::Milliseconds(81236);
+
+  std::optional<StartupTrace::Phase> parsed =
+      StartupTrace::ParsePhase(StartupTrace::SerializePhase(phase));
+  ASSERT_TRUE(parsed);
+  EXPECT_EQ(parsed->process, "browser");
+  EXPECT_EQ(parsed->phase, "config_load");
+  EXPECT_EQ(parsed->start, phase.start);
+  EXPECT_EQ(parsed->end, phase.end);
+}
+
+TEST(StartupTraceTest, RejectsMalformedLines) {
+  EXPECT_FALSE(StartupTrace::ParsePhase("not json"));
+  EXPECT_FALSE(StartupTrace::ParsePhase(R"({"process":"browser"})"));
+  EXPECT_FALSE(StartupTrace::ParsePhase(
+      R"({"process":"browser","phase":"main","start_ms":2,"end_ms":1})"));
+}
+
+TEST(StartupTraceTest, AppendsPhasesAndReportsOnceOnlyTheFirst) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().AppendASCII("startup.jsonl");
+
+  StartupTrace trace(path, "gateway");
+  base::TimeTicks start = base::TimeTicks::Now();
+  trace.AddPhase("provider_init", start, start + base::Milliseconds(3));
+  trace.AddMarkOnce("first_rpc");
+  trace.AddMarkOnce("first_rpc");
+  trace.AddMark("listening");
+
+  std::vector<StartupTrace::Phase> phases = ReadPhases(path);
+  ASSERT_EQ(phases.size(), 3u);
+  EXPECT_EQ(phases[0].process, "gateway");
+  EXPECT_EQ(phases[0].phase, "provider_init");
+  EXPECT_EQ(phases[0].end - phases[0].start, base::Milliseconds(3));
+  EXPECT_EQ(phases[1].phase, "first_rpc");
+  EXPECT_EQ(phases[1].start, phases[1].end);
+  EXPECT_EQ(phases[2].phase, "listening");
+}
+
+TEST(StartupTraceTest, NotTracingWithoutStart) {
+  EXPECT_EQ(StartupTrace::Get(), nullptr);
+  // Scoped phases are no-ops then
+  ScopedStartupPhase phase("config_load");
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
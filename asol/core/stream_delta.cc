@@ -0,0 +1,75 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/stream_delta.h"
+
+#include "asol/core/cancellation_token.h"
+
+namespace asol {
+namespace core {
+
+StreamFinishReason ParseStreamFinishReason(std::string_view reason) {
+  // OpenAI and compatible APIs first, then Anthropic, then Gemini
+  if (reason == "stop" || reason == "end_turn" || reason == "stop_sequence" ||
+      reason == "STOP") {
+    return StreamFinishReason::kStop;
+  }
+  if (reason == "length" || reason == "max_tokens" ||
+      reason == "MAX_TOKENS") {
+    return StreamFinishReason::kLength;
+  }
+  if (reason == "content_filter" || reason == "refusal" ||
+      reason == "SAFETY" || reason == "RECITATION") {
+    return StreamFinishReason::kContentFilter;
+  }
+  if (reason == "tool_calls" || reason == "function_call" ||
+      reason == "tool_use") {
+    return StreamFinishReason::kToolUse;
+  }
+  return StreamFinishReason::kNone;
+}
+
+const char* StreamFinishReasonToString(StreamFinishReason reason) {
+  switch (reason) {
+    case StreamFinishReason::kNone:
+      return "none";
+    case StreamFinishReason::kStop:
+      return "stop";
+    case StreamFinishReason::kLength:
+      return "length";
+    case StreamFinishReason::kContentFilter:
+      return "content_filter";
+    case StreamFinishReason::kToolUse:
+      return "tool_use";
+    case StreamFinishReason::kCancelled:
+      return "cancelled";
+    case StreamFinishReason::kError:
+      return "error";
+  }
+  return "none";
+}
+
+StreamDelta::StreamDelta() = default;
+StreamDelta::StreamDelta(const StreamDelta&) = default;
+StreamDelta& StreamDelta::operator=(const StreamDelta&) = default;
+StreamDelta::~StreamDelta() = default;
+
+StreamDelta MakeFinalStreamDelta(bool success, const std::string& response) {
+  StreamDelta delta;
+  delta.is_final = true;
+  delta.success = success;
+  if (success) {
+    delta.text = response;
+    delta.finish_reason = StreamFinishReason::kStop;
+  } else {
+    delta.error_message = response;
+    delta.finish_reason = IsCancellationError(response)
+                              ? StreamFinishReason::kCancelled
+                              : StreamFinishReason::kError;
+  }
+  return delta;
+}
+
+}  // namespace core
+}  // namespace asol
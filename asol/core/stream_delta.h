@@ -0,0 +1,85 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_STREAM_DELTA_H_
+#define ASOL_CORE_STREAM_DELTA_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "base/functional/callback.h"
+
+namespace asol {
+namespace core {
+
+// Why a streamed completion ended, the same for every provider
+enum class StreamFinishReason {
+  // Not known, or the stream has not ended
+  kNone,
+  // The model finished its answer or hit a stop sequence
+  kStop,
+  // The output token limit was reached; the text is truncated
+  kLength,
+  // The provider withheld the rest of the output
+  kContentFilter,
+  // The model stopped to call a tool
+  kToolUse,
+  // The caller cancelled the request
+  kCancelled,
+  // The request or the transfer failed
+  kError,
+};
+
+// Map a provider's own finish reason, e.g. OpenAI "length" or Anthropic
+// "max_tokens", to a StreamFinishReason
+StreamFinishReason ParseStreamFinishReason(std::string_view reason);
+
+// Lowercase name of |reason|, for logs and metadata
+const char* StreamFinishReasonToString(StreamFinishReason reason);
+
+// Token counts of a completion as the provider reported them
+struct StreamTokenUsage {
+  // Every input token, including those read from the prompt cache
+  int64_t prompt_tokens = 0;
+  int64_t cached_prompt_tokens = 0;
+  int64_t completion_tokens = 0;
+};
+
+// One increment of a streamed completion. A stream is any number of deltas
+// carrying text as it is generated, then exactly one with |is_final| set
+// that says how it ended. The final delta may carry text too, e.g. when a
+// provider that cannot stream answers in one piece.
+struct StreamDelta {
+  StreamDelta();
+  StreamDelta(const StreamDelta&);
+  StreamDelta& operator=(const StreamDelta&);
+  ~StreamDelta();
+
+  // Text generated since the previous delta
+  std::string text;
+
+  bool is_final = false;
+
+  // The fields below are only set on the final delta.
+  bool success = false;
+  std::string error_message;
+  StreamFinishReason finish_reason = StreamFinishReason::kNone;
+  // Absent when the provider did not report usage
+  std::optional<StreamTokenUsage> usage;
+};
+
+// Receives every delta of one stream, in order. Runs on the sequence the
+// stream was started on.
+using StreamDeltaCallback = base::RepeatingCallback<void(const StreamDelta&)>;
+
+// The final delta for a completion delivered whole, as the plain response
+// callbacks report it: all of the text on success, the error otherwise
+StreamDelta MakeFinalStreamDelta(bool success, const std::string& response);
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_STREAM_DELTA_H_
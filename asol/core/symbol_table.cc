@@ -0,0 +1,135 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/symbol_table.h"
+
+#include <cstring>
+#include <string>
+
+#include "base/check.h"
+#include "base/no_destructor.h"
+#include "base/strings/string_util.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+// Arena block for symbol text; longer strings get a block of their own
+constexpr size_t kTextBlockSize = 16 * 1024;
+constexpr size_t kMaxPackedTextSize = kTextBlockSize / 4;
+
+}  // namespace
+
+SymbolTable::SymbolTable() {
+  base::AutoLock lock(lock_);
+  Id empty = AddLocked(std::string_view(), kEmptyId);
+  DCHECK_EQ(empty, kEmptyId);
+}
+
+SymbolTable::~SymbolTable() = default;
+
+// static
+SymbolTable* SymbolTable::GetInstance() {
+  static base::NoDestructor<SymbolTable> instance;
+  return instance.get();
+}
+
+SymbolTable::Id SymbolTable::Intern(std::string_view text) {
+  base::AutoLock lock(lock_);
+  auto it = index_.find(text);
+  if (it != index_.end()) {
+    return it->second;
+  }
+
+  std::string lowercase = base::ToLowerASCII(text);
+  if (lowercase == text) {
+    // Its own folded form
+    return AddLocked(text, static_cast<Id>(size_.load()));
+  }
+  Id folded;
+  auto folded_it = index_.find(lowercase);
+  if (folded_it != index_.end()) {
+    folded = folded_it->second;
+  } else {
+    folded = AddLocked(lowercase, static_cast<Id>(size_.load()));
+  }
+  return AddLocked(text, folded);
+}
+
+bool SymbolTable::Find(std::string_view text, Id* id) const {
+  base::AutoLock lock(lock_);
+  auto it = index_.find(text);
+  if (it == index_.end()) {
+    return false;
+  }
+  *id = it->second;
+  return true;
+}
+
+std::string_view SymbolTable::GetString(Id id) const {
+  DCHECK_LT(id, size());
+  return GetRecord(id).text;
+}
+
+SymbolTable::Id SymbolTable::GetFolded(Id id) const {
+  DCHECK_LT(id, size());
+  return GetRecord(id).folded;
+}
+
+size_t SymbolTable::GetTextBytes() const {
+  base::AutoLock lock(lock_);
+  return text_bytes_;
+}
+
+SymbolTable::Id SymbolTable::AddLocked(std::string_view text, Id folded) {
+  size_t id = size_.load(std::memory_order_relaxed);
+  size_t chunk = id >> kChunkBits;
+  CHECK_LT(chunk, kMaxChunks) << "Symbol table is full";
+  if (!chunks_[chunk]) {
+    chunks_[chunk] = std::make_unique<Record[]>(kChunkSize);
+  }
+
+  Record& record = chunks_[chunk][id & (kChunkSize - 1)];
+  record.text = CopyTextLocked(text);
+  record.folded = folded;
+  index_.emplace(record.text, static_cast<Id>(id));
+  size_.store(id + 1, std::memory_order_release);
+  return static_cast<Id>(id);
+}
+
+std::string_view SymbolTable::CopyTextLocked(std::string_view text) {
+  if (text.empty()) {
+    return std::string_view();
+  }
+  text_bytes_ += text.size();
+  if (text.size() > kMaxPackedTextSize) {
+    text_blocks_.push_back(std::make_unique<char[]>(text.size()));
+    std::memcpy(text_blocks_.back().get(), text.data(), text.size());
+    return std::string_view(text_blocks_.back().get(), text.size());
+  }
+  if (text.size() > block_remaining_) {
+    text_blocks_.push_back(std::make_unique<char[]>(kTextBlockSize));
+    block_cursor_ = text_blocks_.back().get();
+    block_remaining_ = kTextBlockSize;
+  }
+  char* copy = block_cursor_;
+  std::memcpy(copy, text.data(), text.size());
+  block_cursor_ += text.size();
+  block_remaining_ -= text.size();
+  return std::string_view(copy, text.size());
+}
+
+std::vector<std::string_view> GetSymbolStrings(
+    const std::vector<Symbol>& symbols) {
+  std::vector<std::string_view> strings;
+  strings.reserve(symbols.size());
+  for (Symbol symbol : symbols) {
+    strings.push_back(symbol.str());
+  }
+  return strings;
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,150 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_SYMBOL_TABLE_H_
+#define ASOL_CORE_SYMBOL_TABLE_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+namespace asol {
+namespace core {
+
+// SymbolTable interns strings that repeat across features, such as topic
+// and entity names, into 32-bit IDs. Each distinct string is stored once
+// and compared by ID. Every symbol also records the symbol of its ASCII
+// lowercase form, so a case-insensitive comparison compares two IDs.
+//
+// Intern() and Find() take a lock. Reading a symbol's string or folded form
+// does not, since records never move once written; an ID handed to another
+// thread carries the ordering its handoff provides. Symbols live as long as
+// the table, so only intern strings from a bounded vocabulary.
+class SymbolTable {
+ public:
+  using Id = uint32_t;
+
+  // The empty string, interned at construction
+  static constexpr Id kEmptyId = 0;
+
+  SymbolTable();
+  ~SymbolTable();
+
+  SymbolTable(const SymbolTable&) = delete;
+  SymbolTable& operator=(const SymbolTable&) = delete;
+
+  // The table behind Symbol, shared by the whole process
+  static SymbolTable* GetInstance();
+
+  // ID of |text|, interning it and its lowercase form if new
+  Id Intern(std::string_view text);
+
+  // Look up |text| without interning it
+  bool Find(std::string_view text, Id* id) const;
+
+  // |id| must have come from this table
+  std::string_view GetString(Id id) const;
+  Id GetFolded(Id id) const;
+
+  size_t size() const { return size_.load(std::memory_order_acquire); }
+
+  // Bytes held for string text, excluding the index
+  size_t GetTextBytes() const;
+
+ private:
+  struct Record {
+    std::string_view text;
+    Id folded = kEmptyId;
+  };
+
+  static constexpr size_t kChunkBits = 12;
+  static constexpr size_t kChunkSize = size_t{1} << kChunkBits;
+  static constexpr size_t kMaxChunks = 4096;
+
+  const Record& GetRecord(Id id) const {
+    return chunks_[id >> kChunkBits][id & (kChunkSize - 1)];
+  }
+
+  // Append a record for |text|, which must not be interned yet
+  Id AddLocked(std::string_view text, Id folded)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Copy |text| into the arena, where it stays put
+  std::string_view CopyTextLocked(std::string_view text)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  mutable base::Lock lock_;
+  std::unordered_map<std::string_view, Id> index_ GUARDED_BY(lock_);
+  std::vector<std::unique_ptr<char[]>> text_blocks_ GUARDED_BY(lock_);
+  size_t block_remaining_ GUARDED_BY(lock_) = 0;
+  char* block_cursor_ GUARDED_BY(lock_) = nullptr;
+  size_t text_bytes_ GUARDED_BY(lock_) = 0;
+
+  // Records in fixed chunks, allocated as the table grows and never moved
+  std::array<std::unique_ptr<Record[]>, kMaxChunks> chunks_;
+  std::atomic<size_t> size_{0};
+};
+
+// Symbol is a string interned in the process-wide SymbolTable, held as its
+// four-byte ID. Copies and equality are integer operations.
+class Symbol {
+ public:
+  // The empty string
+  Symbol() = default;
+  explicit Symbol(std::string_view text)
+      : id_(SymbolTable::GetInstance()->Intern(text)) {}
+
+  static Symbol FromId(SymbolTable::Id id) { return Symbol(id, 0); }
+
+  SymbolTable::Id id() const { return id_; }
+  bool empty() const { return id_ == SymbolTable::kEmptyId; }
+
+  std::string_view str() const {
+    return SymbolTable::GetInstance()->GetString(id_);
+  }
+
+  // The symbol of this string in ASCII lowercase
+  Symbol Folded() const {
+    return FromId(SymbolTable::GetInstance()->GetFolded(id_));
+  }
+
+  bool EqualsIgnoreCase(Symbol other) const {
+    return Folded() == other.Folded();
+  }
+
+  bool operator==(Symbol other) const { return id_ == other.id_; }
+  bool operator!=(Symbol other) const { return id_ != other.id_; }
+  bool operator<(Symbol other) const { return id_ < other.id_; }
+
+  struct Hash {
+    size_t operator()(Symbol symbol) const { return symbol.id_; }
+  };
+
+ private:
+  Symbol(SymbolTable::Id id, int) : id_(id) {}
+
+  SymbolTable::Id id_ = SymbolTable::kEmptyId;
+};
+
+inline std::ostream& operator<<(std::ostream& out, Symbol symbol) {
+  return out << symbol.str();
+}
+
+// Strings of |symbols|, which stay valid for the life of the process
+std::vector<std::string_view> GetSymbolStrings(
+    const std::vector<Symbol>& symbols);
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_SYMBOL_TABLE_H_
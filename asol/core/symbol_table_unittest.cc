@@ -0,0 +1,112 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/symbol_table.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+TEST(SymbolTableTest, InternsEachStringOnce) {
+  SymbolTable table;
+  SymbolTable::Id google = table.Intern("google");
+  EXPECT_EQ(table.Intern(std::string("goo") + "gle"), google);
+  EXPECT_NE(table.Intern("machine learning"), google);
+  EXPECT_EQ(table.GetString(google), "google");
+  EXPECT_EQ(table.size(), 3u);  // with the empty string
+}
+
+TEST(SymbolTableTest, EmptyStringIsPreinterned) {
+  SymbolTable table;
+  SymbolTable::Id id = 1;
+  ASSERT_TRUE(table.Find("", &id));
+  EXPECT_EQ(id, SymbolTable::kEmptyId);
+  EXPECT_EQ(table.Intern(""), SymbolTable::kEmptyId);
+}
+
+TEST(SymbolTableTest, FoldsToLowercaseSymbol) {
+  SymbolTable table;
+  SymbolTable::Id mixed = table.Intern("Machine Learning");
+  SymbolTable::Id upper = table.Intern("MACHINE LEARNING");
+  SymbolTable::Id lower;
+  ASSERT_TRUE(table.Find("machine learning", &lower));
+
+  EXPECT_NE(mixed, upper);
+  EXPECT_EQ(table.GetFolded(mixed), lower);
+  EXPECT_EQ(table.GetFolded(upper), lower);
+  EXPECT_EQ(table.GetFolded(lower), lower);
+  EXPECT_EQ(table.GetString(table.GetFolded(mixed)), "machine learning");
+}
+
+TEST(SymbolTableTest, FindDoesNotIntern) {
+  SymbolTable table;
+  SymbolTable::Id id;
+  EXPECT_FALSE(table.Find("Rust", &id));
+  EXPECT_EQ(table.size(), 1u);
+}
+
+TEST(SymbolTableTest, StringsStayPutAsTableGrows) {
+  SymbolTable table;
+  SymbolTable::Id first = table.Intern("first");
+  std::string_view text = table.GetString(first);
+  std::string long_text(10000, 'x');
+  for (int i = 0; i < 10000; ++i) {
+    table.Intern("topic " + std::to_string(i));
+  }
+  table.Intern(long_text);
+
+  EXPECT_EQ(text.data(), table.GetString(first).data());
+  EXPECT_EQ(text, "first");
+  SymbolTable::Id id;
+  ASSERT_TRUE(table.Find(long_text, &id));
+  EXPECT_EQ(table.GetString(id), long_text);
+  ASSERT_TRUE(table.Find("topic 9999", &id));
+  EXPECT_EQ(table.GetString(id), "topic 9999");
+}
+
+TEST(SymbolTableTest, ConcurrentInternsAgree) {
+  SymbolTable table;
+  std::vector<std::vector<SymbolTable::Id>> results(4);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < results.size(); ++t) {
+    threads.emplace_back([&table, &results, t] {
+      for (int i = 0; i < 1000; ++i) {
+        results[t].push_back(table.Intern("Entity " + std::to_string(i)));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t t = 1; t < results.size(); ++t) {
+    EXPECT_EQ(results[t], results[0]);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(table.GetString(results[0][i]), "Entity " + std::to_string(i));
+  }
+}
+
+TEST(SymbolTest, ComparesByIdAndIgnoringCase) {
+  Symbol a("Google");
+  Symbol b("Google");
+  Symbol c("GOOGLE");
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_TRUE(a.EqualsIgnoreCase(c));
+  EXPECT_FALSE(a.EqualsIgnoreCase(Symbol("Alphabet")));
+  EXPECT_EQ(c.Folded().str(), "google");
+  EXPECT_TRUE(Symbol().empty());
+  EXPECT_EQ(sizeof(Symbol), 4u);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
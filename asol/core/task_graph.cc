@@ -0,0 +1,202 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/task_graph.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/functional/bind.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+
+namespace asol {
+namespace core {
+
+TaskGraph::Report::Report() = default;
+TaskGraph::Report::Report(const Report&) = default;
+TaskGraph::Report& TaskGraph::Report::operator=(const Report&) = default;
+TaskGraph::Report::~Report() = default;
+
+TaskGraph::Node::Node() = default;
+TaskGraph::Node::Node(Node&&) = default;
+TaskGraph::Node& TaskGraph::Node::operator=(Node&&) = default;
+TaskGraph::Node::~Node() = default;
+
+TaskGraph::TaskGraph(base::TaskPriority priority) : priority_(priority) {}
+
+TaskGraph::~TaskGraph() = default;
+
+TaskGraph::NodeId TaskGraph::AddTask(std::string name,
+                                     std::vector<NodeId> dependencies,
+                                     Task task) {
+  DCHECK(task);
+  Node node;
+  node.name = std::move(name);
+  node.dependencies = std::move(dependencies);
+  node.task = std::move(task);
+  return AddNode(std::move(node));
+}
+
+TaskGraph::NodeId TaskGraph::AddBlockingTask(std::string name,
+                                             std::vector<NodeId> dependencies,
+                                             base::OnceClosure work) {
+  DCHECK(work);
+  Node node;
+  node.name = std::move(name);
+  node.dependencies = std::move(dependencies);
+  node.blocking_work = std::move(work);
+  return AddNode(std::move(node));
+}
+
+TaskGraph::NodeId TaskGraph::AddNode(Node node) {
+  DCHECK(!started_);
+  NodeId id = nodes_.size();
+  for (NodeId dependency : node.dependencies) {
+    // Only earlier nodes, so the graph cannot have a cycle
+    CHECK_LT(dependency, id);
+    nodes_[dependency].dependents.push_back(id);
+  }
+  node.pending_dependencies = node.dependencies.size();
+  nodes_.push_back(std::move(node));
+  return id;
+}
+
+void TaskGraph::Run(DoneCallback done) {
+  DCHECK(!started_);
+  DCHECK(done);
+  started_ = true;
+  done_ = std::move(done);
+  run_start_ = base::TimeTicks::Now();
+
+  for (NodeId id = 0; id < nodes_.size(); ++id) {
+    // A task that finishes straight away may already have started the
+    // nodes after it, or cancelled the graph
+    if (nodes_[id].state == State::kWaiting &&
+        nodes_[id].pending_dependencies == 0 && !cancelled_) {
+      StartNode(id);
+    }
+  }
+  MaybeFinish();
+}
+
+void TaskGraph::Cancel() {
+  if (cancelled_) {
+    return;
+  }
+  cancelled_ = true;
+  for (Node& node : nodes_) {
+    if (node.state == State::kWaiting) {
+      node.state = State::kSkipped;
+      node.task.Reset();
+      node.blocking_work.Reset();
+      ++finished_;
+    }
+  }
+  if (started_) {
+    MaybeFinish();
+  }
+}
+
+void TaskGraph::StartNode(NodeId id) {
+  Node& node = nodes_[id];
+  DCHECK_EQ(node.state, State::kWaiting);
+  node.state = State::kRunning;
+  node.started = base::TimeTicks::Now();
+  ++running_;
+
+  base::OnceClosure done = base::BindOnce(
+      &TaskGraph::OnNodeDone, weak_ptr_factory_.GetWeakPtr(), id);
+  if (node.blocking_work) {
+    base::ThreadPool::PostTaskAndReply(
+        FROM_HERE, {priority_, base::MayBlock()},
+        std::move(node.blocking_work), std::move(done));
+    return;
+  }
+  // May run |done| before returning
+  std::move(node.task).Run(std::move(done));
+}
+
+void TaskGraph::OnNodeDone(NodeId id) {
+  Node& node = nodes_[id];
+  DCHECK_EQ(node.state, State::kRunning);
+  node.state = State::kDone;
+  node.finished = base::TimeTicks::Now();
+  --running_;
+  ++finished_;
+
+  // |nodes_| does not change once running, so |node| stays valid while
+  // its dependents start
+  for (NodeId dependent : node.dependents) {
+    Node& next = nodes_[dependent];
+    DCHECK_GT(next.pending_dependencies, 0u);
+    if (--next.pending_dependencies == 0 && next.state == State::kWaiting &&
+        !cancelled_) {
+      StartNode(dependent);
+    }
+  }
+  MaybeFinish();
+}
+
+void TaskGraph::MaybeFinish() {
+  if (!done_ || running_ > 0 || finished_ < nodes_.size()) {
+    return;
+  }
+  // Posted, so the callback may destroy the graph, and never runs inside a
+  // task that finished synchronously
+  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+      FROM_HERE, base::BindOnce(std::move(done_), BuildReport()));
+}
+
+TaskGraph::Report TaskGraph::BuildReport() const {
+  Report report;
+  report.cancelled = cancelled_;
+  report.nodes.reserve(nodes_.size());
+
+  // Longest chain ending at each node. Dependencies come first, so one
+  // pass in order sees them before their dependents.
+  std::vector<base::TimeDelta> chain(nodes_.size());
+  std::vector<NodeId> previous(nodes_.size(), nodes_.size());
+  NodeId last = nodes_.size();
+  base::TimeTicks last_finished = run_start_;
+
+  for (NodeId id = 0; id < nodes_.size(); ++id) {
+    const Node& node = nodes_[id];
+    NodeTiming timing;
+    timing.name = node.name;
+    timing.skipped = node.state == State::kSkipped;
+    if (!timing.skipped) {
+      timing.start_offset = node.started - run_start_;
+      timing.duration = node.finished - node.started;
+      last_finished = std::max(last_finished, node.finished);
+    }
+
+    for (NodeId dependency : node.dependencies) {
+      if (previous[id] == nodes_.size() || chain[dependency] > chain[id]) {
+        chain[id] = chain[dependency];
+        previous[id] = dependency;
+      }
+    }
+    chain[id] += timing.duration;
+    if (last == nodes_.size() || chain[id] > chain[last]) {
+      last = id;
+    }
+    report.nodes.push_back(std::move(timing));
+  }
+
+  report.elapsed = last_finished - run_start_;
+  if (last < nodes_.size()) {
+    report.critical_path = chain[last];
+    for (NodeId id = last; id < nodes_.size(); id = previous[id]) {
+      report.critical_path_nodes.push_back(nodes_[id].name);
+    }
+    std::reverse(report.critical_path_nodes.begin(),
+                 report.critical_path_nodes.end());
+  }
+  return report;
+}
+
+}  // namespace core
+}  // namespace asol
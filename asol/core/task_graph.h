@@ -0,0 +1,152 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_TASK_GRAPH_H_
+#define ASOL_CORE_TASK_GRAPH_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/task/task_traits.h"
+#include "base/time/time.h"
+
+namespace asol {
+namespace core {
+
+// TaskGraph runs the steps of one job, such as processing a page, as soon
+// as the steps they depend on are done, so independent steps overlap and
+// the job takes as long as its longest chain of dependent steps rather
+// than the sum of all of them.
+//
+// The graph is declared up front: each node names the nodes it depends on,
+// which must have been added before it, so there are no cycles. A node is
+// either a task on the graph's sequence that finishes by running its
+// |done| closure, e.g. once an AI call answers, or blocking work run on
+// the thread pool. Every node is timed, and the report names the critical
+// path. Cancel() skips the nodes that have not started; those running
+// finish first.
+//
+//   TaskGraph graph;
+//   TaskGraph::NodeId extract = graph.AddBlockingTask("extract", {}, ...);
+//   graph.AddTask("summarize", {extract}, ...);
+//   graph.AddTask("index", {extract}, ...);  // Alongside "summarize"
+//   graph.Run(base::BindOnce(&OnPageProcessed));
+//
+// Must be used on one sequence; tasks and the done callback run on it.
+class TaskGraph {
+ public:
+  using NodeId = size_t;
+
+  // A step on the graph's sequence; runs |done| when finished
+  using Task = base::OnceCallback<void(base::OnceClosure done)>;
+
+  struct NodeTiming {
+    std::string name;
+    // From Run() to the node starting, and how long it took to finish;
+    // zero for skipped nodes
+    base::TimeDelta start_offset;
+    base::TimeDelta duration;
+    bool skipped = false;
+  };
+
+  struct Report {
+    Report();
+    Report(const Report&);
+    Report& operator=(const Report&);
+    ~Report();
+
+    // In the order the nodes were added
+    std::vector<NodeTiming> nodes;
+    // From Run() to the last node finishing
+    base::TimeDelta elapsed;
+    // The longest chain of dependent nodes, by duration: what the graph
+    // would take with unlimited parallelism
+    base::TimeDelta critical_path;
+    std::vector<std::string> critical_path_nodes;
+    bool cancelled = false;
+  };
+
+  using DoneCallback = base::OnceCallback<void(const Report& report)>;
+
+  explicit TaskGraph(
+      base::TaskPriority priority = base::TaskPriority::USER_VISIBLE);
+  ~TaskGraph();
+
+  TaskGraph(const TaskGraph&) = delete;
+  TaskGraph& operator=(const TaskGraph&) = delete;
+
+  // Add a node that starts once every node in |dependencies| is done.
+  // Must be called before Run().
+  NodeId AddTask(std::string name,
+                 std::vector<NodeId> dependencies,
+                 Task task);
+
+  // Like AddTask(), for |work| that blocks; it runs on the thread pool,
+  // at the graph's priority
+  NodeId AddBlockingTask(std::string name,
+                         std::vector<NodeId> dependencies,
+                         base::OnceClosure work);
+
+  // Start the nodes without dependencies. |done| is posted once every
+  // node is done or skipped, and may destroy the graph. Destroying the
+  // graph before then drops the results of nodes still running.
+  void Run(DoneCallback done);
+
+  // Skip the nodes that have not started
+  void Cancel();
+  bool is_cancelled() const { return cancelled_; }
+
+  size_t size() const { return nodes_.size(); }
+
+ private:
+  enum class State { kWaiting, kRunning, kDone, kSkipped };
+
+  struct Node {
+    Node();
+    Node(Node&&);
+    Node& operator=(Node&&);
+    ~Node();
+
+    std::string name;
+    std::vector<NodeId> dependencies;
+    std::vector<NodeId> dependents;
+    size_t pending_dependencies = 0;
+
+    // One of the two is set
+    Task task;
+    base::OnceClosure blocking_work;
+
+    State state = State::kWaiting;
+    base::TimeTicks started;
+    base::TimeTicks finished;
+  };
+
+  NodeId AddNode(Node node);
+  void StartNode(NodeId id);
+  void OnNodeDone(NodeId id);
+
+  // Post |done_| once nothing is left to run
+  void MaybeFinish();
+  Report BuildReport() const;
+
+  const base::TaskPriority priority_;
+  std::vector<Node> nodes_;
+  size_t running_ = 0;
+  size_t finished_ = 0;
+  bool started_ = false;
+  bool cancelled_ = false;
+  base::TimeTicks run_start_;
+  DoneCallback done_;
+
+  base::WeakPtrFactory<TaskGraph> weak_ptr_factory_{this};
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_TASK_GRAPH_H_
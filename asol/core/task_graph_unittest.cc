@@ -0,0 +1,185 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/task_graph.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/run_loop.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+class TaskGraphTest : public testing::Test {
+ protected:
+  // A task that logs its name and finishes after |delay|
+  TaskGraph::Task Step(const std::string& name,
+                       base::TimeDelta delay = base::TimeDelta()) {
+    return base::BindOnce(
+        [](std::vector<std::string>* log, std::string name,
+           base::TimeDelta delay, base::OnceClosure done) {
+          log->push_back(name);
+          base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+              FROM_HERE, std::move(done), delay);
+        },
+        &log_, name, delay);
+  }
+
+  // A task that logs its name and waits for the test to finish it
+  TaskGraph::Task HeldStep(const std::string& name) {
+    return base::BindOnce(
+        [](std::vector<std::string>* log,
+           std::vector<base::OnceClosure>* held, std::string name,
+           base::OnceClosure done) {
+          log->push_back(name);
+          held->push_back(std::move(done));
+        },
+        &log_, &held_, name);
+  }
+
+  TaskGraph::Report RunGraph(TaskGraph& graph) {
+    TaskGraph::Report report;
+    base::RunLoop run_loop;
+    graph.Run(base::BindOnce(
+        [](TaskGraph::Report* out, base::OnceClosure quit,
+           const TaskGraph::Report& report) {
+          *out = report;
+          std::move(quit).Run();
+        },
+        &report, run_loop.QuitClosure()));
+    run_loop.Run();
+    return report;
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  std::vector<std::string> log_;
+  std::vector<base::OnceClosure> held_;
+};
+
+TEST_F(TaskGraphTest, RunsNodesAfterTheirDependencies) {
+  TaskGraph graph;
+  TaskGraph::NodeId extract = graph.AddTask("extract", {}, Step("extract"));
+  TaskGraph::NodeId classify =
+      graph.AddTask("classify", {extract}, Step("classify"));
+  graph.AddTask("summarize", {classify}, Step("summarize"));
+  graph.AddTask("index", {extract, classify}, Step("index"));
+
+  TaskGraph::Report report = RunGraph(graph);
+  ASSERT_EQ(log_.size(), 4u);
+  EXPECT_EQ(log_[0], "extract");
+  EXPECT_EQ(log_[1], "classify");
+  EXPECT_FALSE(report.cancelled);
+  ASSERT_EQ(report.nodes.size(), 4u);
+  EXPECT_EQ(report.nodes[3].name, "index");
+  EXPECT_FALSE(report.nodes[3].skipped);
+}
+
+TEST_F(TaskGraphTest, StartsIndependentNodesTogether) {
+  TaskGraph graph;
+  TaskGraph::NodeId extract = graph.AddTask("extract", {}, Step("extract"));
+  graph.AddTask("summarize", {extract}, HeldStep("summarize"));
+  graph.AddTask("index", {extract}, HeldStep("index"));
+
+  bool done = false;
+  graph.Run(base::BindOnce([](bool* done, const TaskGraph::Report&) {
+    *done = true;
+  }, &done));
+  task_environment_.RunUntilIdle();
+
+  // Both started while neither has finished
+  EXPECT_EQ(log_, (std::vector<std::string>{"extract", "summarize", "index"}));
+  ASSERT_EQ(held_.size(), 2u);
+  std::move(held_[1]).Run();
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(done);
+  std::move(held_[0]).Run();
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(done);
+}
+
+TEST_F(TaskGraphTest, RunsBlockingTasksOnThreadPool) {
+  TaskGraph graph;
+  std::string text;
+  TaskGraph::NodeId extract = graph.AddBlockingTask(
+      "extract", {},
+      base::BindOnce([](std::string* text) { *text = "page"; }, &text));
+  std::string seen;
+  graph.AddTask("classify", {extract},
+                base::BindOnce(
+                    [](const std::string* text, std::string* seen,
+                       base::OnceClosure done) {
+                      *seen = *text;
+                      std::move(done).Run();
+                    },
+                    &text, &seen));
+
+  RunGraph(graph);
+  EXPECT_EQ(seen, "page");
+}
+
+TEST_F(TaskGraphTest, CancelSkipsNodesNotStarted) {
+  TaskGraph graph;
+  TaskGraph::NodeId extract = graph.AddTask("extract", {}, HeldStep("extract"));
+  graph.AddTask("summarize", {extract}, Step("summarize"));
+
+  TaskGraph::Report report;
+  bool done = false;
+  graph.Run(base::BindOnce(
+      [](TaskGraph::Report* out, bool* done, const TaskGraph::Report& report) {
+        *out = report;
+        *done = true;
+      },
+      &report, &done));
+  graph.Cancel();
+  task_environment_.RunUntilIdle();
+  // The running node finishes first
+  EXPECT_FALSE(done);
+
+  ASSERT_EQ(held_.size(), 1u);
+  std::move(held_[0]).Run();
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(done);
+  EXPECT_EQ(log_, std::vector<std::string>{"extract"});
+  EXPECT_TRUE(report.cancelled);
+  EXPECT_FALSE(report.nodes[0].skipped);
+  EXPECT_TRUE(report.nodes[1].skipped);
+}
+
+TEST_F(TaskGraphTest, ReportsCriticalPath) {
+  TaskGraph graph;
+  TaskGraph::NodeId extract =
+      graph.AddTask("extract", {}, Step("extract", base::Milliseconds(10)));
+  TaskGraph::NodeId classify = graph.AddTask(
+      "classify", {extract}, Step("classify", base::Milliseconds(5)));
+  graph.AddTask("summarize", {classify},
+                Step("summarize", base::Milliseconds(40)));
+  graph.AddTask("index", {extract}, Step("index", base::Milliseconds(20)));
+
+  TaskGraph::Report report = RunGraph(graph);
+  EXPECT_EQ(report.elapsed, base::Milliseconds(55));
+  EXPECT_EQ(report.critical_path, base::Milliseconds(55));
+  EXPECT_EQ(report.critical_path_nodes,
+            (std::vector<std::string>{"extract", "classify", "summarize"}));
+  EXPECT_EQ(report.nodes[3].start_offset, base::Milliseconds(10));
+  EXPECT_EQ(report.nodes[3].duration, base::Milliseconds(20));
+}
+
+TEST_F(TaskGraphTest, FinishesEmptyGraph) {
+  TaskGraph graph;
+  TaskGraph::Report report = RunGraph(graph);
+  EXPECT_TRUE(report.nodes.empty());
+  EXPECT_TRUE(report.critical_path_nodes.empty());
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
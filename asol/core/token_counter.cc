@@ -0,0 +1,44 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/token_counter.h"
+
+#include <algorithm>
+
+#include "base/no_destructor.h"
+
+namespace asol {
+namespace core {
+
+namespace {
+
+class ApproximateTokenCounter : public TokenCounter {
+ public:
+  size_t CountTokens(std::string_view text) const override {
+    return text.empty() ? 0 : text.size() / 4 + 1;
+  }
+
+  size_t FitPrefix(std::string_view text, size_t max_tokens) const override {
+    if (max_tokens == 0) {
+      return 0;
+    }
+    size_t length = std::min(text.size(), max_tokens * 4 - 1);
+    // Back off to the start of a UTF-8 sequence
+    while (length > 0 && length < text.size() &&
+           (static_cast<unsigned char>(text[length]) & 0xC0) == 0x80) {
+      length--;
+    }
+    return length;
+  }
+};
+
+}  // namespace
+
+const TokenCounter& GetApproximateTokenCounter() {
+  static const base::NoDestructor<ApproximateTokenCounter> counter;
+  return *counter;
+}
+
+}  // namespace core
+}  // namespace asol
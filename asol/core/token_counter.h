@@ -0,0 +1,38 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_TOKEN_COUNTER_H_
+#define ASOL_CORE_TOKEN_COUNTER_H_
+
+#include <cstddef>
+#include <string_view>
+
+namespace asol {
+namespace core {
+
+// TokenCounter tells, before a request is sent, how many tokens a provider
+// will bill for a piece of text. Providers expose the counter for their
+// tokenizer family through AIServiceProvider::GetTokenCounter(); counters
+// are stateless, thread-safe and live for the whole process.
+class TokenCounter {
+ public:
+  virtual ~TokenCounter() = default;
+
+  // Tokens |text| encodes to
+  virtual size_t CountTokens(std::string_view text) const = 0;
+
+  // Length in bytes of the longest prefix of |text| that encodes to at most
+  // |max_tokens| tokens. The prefix ends on a token boundary, and so never
+  // splits a UTF-8 sequence.
+  virtual size_t FitPrefix(std::string_view text, size_t max_tokens) const = 0;
+};
+
+// Counter used when a provider's tokenizer is unknown: about four bytes per
+// token, the rule the rest of the tree estimates with
+const TokenCounter& GetApproximateTokenCounter();
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_TOKEN_COUNTER_H_
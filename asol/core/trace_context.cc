@@ -0,0 +1,153 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/trace_context.h"
+
+#include <inttypes.h>
+
+#include <utility>
+
+#include "base/rand_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/trace_event/trace_event.h"
+
+namespace asol {
+namespace core {
+
+const char kTraceparentHeader[] = "traceparent";
+
+namespace {
+
+// "00-" + 32 + "-" + 16 + "-" + 2
+constexpr size_t kTraceparentLength = 55;
+
+// Random and never 0, which W3C reserves for "no ID"
+uint64_t RandomId() {
+  uint64_t id;
+  do {
+    id = base::RandUint64();
+  } while (id == 0);
+  return id;
+}
+
+// Lowercase hex only, as W3C requires
+bool ParseHex(std::string_view text, uint64_t* value) {
+  *value = 0;
+  for (char c : text) {
+    uint64_t digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else {
+      return false;
+    }
+    *value = (*value << 4) | digit;
+  }
+  return true;
+}
+
+}  // namespace
+
+TraceContext::TraceContext() = default;
+TraceContext::TraceContext(const TraceContext&) = default;
+TraceContext& TraceContext::operator=(const TraceContext&) = default;
+TraceContext::~TraceContext() = default;
+
+// static
+TraceContext TraceContext::CreateRoot() {
+  TraceContext context;
+  context.trace_id_high_ = base::RandUint64();
+  context.trace_id_low_ = RandomId();
+  context.span_id_ = RandomId();
+  return context;
+}
+
+// static
+TraceContext TraceContext::FromTraceparent(std::string_view traceparent) {
+  TraceContext context;
+  if (traceparent.size() != kTraceparentLength ||
+      traceparent.substr(0, 3) != "00-" || traceparent[35] != '-' ||
+      traceparent[52] != '-') {
+    return TraceContext();
+  }
+  uint64_t flags;
+  if (!ParseHex(traceparent.substr(3, 16), &context.trace_id_high_) ||
+      !ParseHex(traceparent.substr(19, 16), &context.trace_id_low_) ||
+      !ParseHex(traceparent.substr(36, 16), &context.span_id_) ||
+      !ParseHex(traceparent.substr(53, 2), &flags) ||
+      context.span_id_ == 0) {
+    return TraceContext();
+  }
+  return context;
+}
+
+TraceContext TraceContext::CreateChild() const {
+  if (!is_valid()) {
+    return CreateRoot();
+  }
+  TraceContext child = *this;
+  child.span_id_ = RandomId();
+  return child;
+}
+
+std::string TraceContext::ToTraceparent() const {
+  if (!is_valid()) {
+    return std::string();
+  }
+  // Always sampled; the trace backends decide what to keep
+  return "00-" + TraceIdHex() + "-" + SpanIdHex() + "-01";
+}
+
+std::string TraceContext::TraceIdHex() const {
+  return base::StringPrintf("%016" PRIx64 "%016" PRIx64, trace_id_high_,
+                            trace_id_low_);
+}
+
+std::string TraceContext::SpanIdHex() const {
+  return base::StringPrintf("%016" PRIx64, span_id_);
+}
+
+bool TraceContext::operator==(const TraceContext& other) const {
+  return trace_id_high_ == other.trace_id_high_ &&
+         trace_id_low_ == other.trace_id_low_ && span_id_ == other.span_id_;
+}
+
+TraceSpan::TraceSpan(const char* name, const TraceContext& parent)
+    : name_(name), context_(parent.CreateChild()) {
+  TRACE_EVENT_NESTABLE_ASYNC_BEGIN2(
+      "asol", name_, TRACE_ID_GLOBAL(context_.span_id()), "trace_id",
+      context_.TraceIdHex(), "parent_span_id", parent.SpanIdHex());
+}
+
+TraceSpan::TraceSpan(TraceSpan&& other)
+    : name_(other.name_),
+      context_(other.context_),
+      ended_(std::exchange(other.ended_, true)) {}
+
+TraceSpan& TraceSpan::operator=(TraceSpan&& other) {
+  if (this != &other) {
+    End();
+    name_ = other.name_;
+    context_ = other.context_;
+    ended_ = std::exchange(other.ended_, true);
+  }
+  return *this;
+}
+
+TraceSpan::~TraceSpan() {
+  End();
+}
+
+void TraceSpan::End() {
+  if (ended_) {
+    return;
+  }
+  ended_ = true;
+  TRACE_EVENT_NESTABLE_ASYNC_END0("asol", name_,
+                                  TRACE_ID_GLOBAL(context_.span_id()));
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,95 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_TRACE_CONTEXT_H_
+#define ASOL_CORE_TRACE_CONTEXT_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+namespace asol {
+namespace core {
+
+// Name of the header, and gRPC metadata key, that carries a TraceContext
+// to the gateway
+extern const char kTraceparentHeader[];
+
+// TraceContext identifies one request across the browser, ASOL and the
+// gateway: a 128-bit trace ID shared by every span of the request, and the
+// 64-bit ID of the span that is the parent of the next one. It crosses
+// process boundaries as a W3C traceparent, e.g.
+//
+//   00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01
+//
+// A default-constructed context is invalid and means "not traced".
+class TraceContext {
+ public:
+  TraceContext();
+  TraceContext(const TraceContext&);
+  TraceContext& operator=(const TraceContext&);
+  ~TraceContext();
+
+  // A new trace with a random trace ID
+  static TraceContext CreateRoot();
+
+  // Parse a traceparent; invalid if |traceparent| is malformed
+  static TraceContext FromTraceparent(std::string_view traceparent);
+
+  bool is_valid() const { return trace_id_high_ != 0 || trace_id_low_ != 0; }
+
+  // A context in the same trace with a new span ID, for a span started
+  // under this one. A new root if this context is invalid.
+  TraceContext CreateChild() const;
+
+  // The traceparent of this context; empty if invalid
+  std::string ToTraceparent() const;
+
+  // The 32 hex digit trace ID, as trace viewers and exporters expect it
+  std::string TraceIdHex() const;
+  std::string SpanIdHex() const;
+
+  uint64_t span_id() const { return span_id_; }
+
+  bool operator==(const TraceContext& other) const;
+
+ private:
+  uint64_t trace_id_high_ = 0;
+  uint64_t trace_id_low_ = 0;
+  uint64_t span_id_ = 0;
+};
+
+// TraceSpan times one stage of a request, such as redaction or an upstream
+// call, as a nestable async trace event in the "asol" category, so the
+// stages of one request line up in Perfetto even as they hop threads. The
+// span's context() is the parent to pass on to the next stage.
+//
+//   TraceSpan span("PrivacyProxy::ProcessText", params.trace);
+//   params.trace = span.context();
+//   ... // the span ends when it is destroyed, or at End()
+//
+// |name| must outlive the span, as a string literal does.
+class TraceSpan {
+ public:
+  TraceSpan(const char* name, const TraceContext& parent);
+  TraceSpan(TraceSpan&& other);
+  TraceSpan& operator=(TraceSpan&& other);
+  ~TraceSpan();
+
+  const TraceContext& context() const { return context_; }
+
+  // End the span now; later calls, and the destructor, do nothing
+  void End();
+
+ private:
+  const char* name_;
+  TraceContext context_;
+  bool ended_ = false;
+};
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_TRACE_CONTEXT_H_
@@ -0,0 +1,77 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/trace_context.h"
+
+#include <string>
+#include <utility>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+constexpr char kTraceparent[] =
+    "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01";
+
+TEST(TraceContextTest, RoundTripsTraceparent) {
+  TraceContext context = TraceContext::FromTraceparent(kTraceparent);
+  ASSERT_TRUE(context.is_valid());
+  EXPECT_EQ(context.TraceIdHex(), "4bf92f3577b34da6a3ce929d0e0e4736");
+  EXPECT_EQ(context.SpanIdHex(), "00f067aa0ba902b7");
+  EXPECT_EQ(context.ToTraceparent(), kTraceparent);
+}
+
+TEST(TraceContextTest, RejectsMalformedTraceparent) {
+  EXPECT_FALSE(TraceContext::FromTraceparent("").is_valid());
+  // Uppercase
+  EXPECT_FALSE(TraceContext::FromTraceparent(
+                   "00-4BF92F3577B34DA6A3CE929D0E0E4736-00f067aa0ba902b7-01")
+                   .is_valid());
+  // Zero trace ID, zero span ID
+  EXPECT_FALSE(TraceContext::FromTraceparent(
+                   "00-00000000000000000000000000000000-00f067aa0ba902b7-01")
+                   .is_valid());
+  EXPECT_FALSE(TraceContext::FromTraceparent(
+                   "00-4bf92f3577b34da6a3ce929d0e0e4736-0000000000000000-01")
+                   .is_valid());
+  // Unknown version, short
+  EXPECT_FALSE(TraceContext::FromTraceparent(
+                   "01-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01")
+                   .is_valid());
+  EXPECT_FALSE(TraceContext::FromTraceparent(
+                   "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7")
+                   .is_valid());
+  EXPECT_EQ(TraceContext().ToTraceparent(), "");
+}
+
+TEST(TraceContextTest, ChildKeepsTheTrace) {
+  TraceContext root = TraceContext::CreateRoot();
+  ASSERT_TRUE(root.is_valid());
+  TraceContext child = root.CreateChild();
+  EXPECT_EQ(child.TraceIdHex(), root.TraceIdHex());
+  EXPECT_NE(child.span_id(), root.span_id());
+  EXPECT_NE(TraceContext::CreateRoot().TraceIdHex(), root.TraceIdHex());
+}
+
+TEST(TraceContextTest, ChildOfInvalidStartsATrace) {
+  EXPECT_TRUE(TraceContext().CreateChild().is_valid());
+}
+
+TEST(TraceSpanTest, ContextIsAChildOfTheParent) {
+  TraceContext parent = TraceContext::CreateRoot();
+  TraceSpan span("Test", parent);
+  EXPECT_EQ(span.context().TraceIdHex(), parent.TraceIdHex());
+  EXPECT_NE(span.context().span_id(), parent.span_id());
+
+  TraceSpan moved = std::move(span);
+  EXPECT_EQ(moved.context().TraceIdHex(), parent.TraceIdHex());
+  moved.End();
+  moved.End();
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
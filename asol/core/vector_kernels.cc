@@ -0,0 +1,195 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/vector_kernels.h"
+
+#include <cmath>
+
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+
+#include "base/cpu.h"
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace asol {
+namespace core {
+
+namespace {
+
+#if !defined(ARCH_CPU_ARM64)
+float DotProductPortable(const float* a, const float* b, size_t size) {
+  // Four partial sums let the compiler keep several multiplies in flight
+  float sums[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    sums[0] += a[i] * b[i];
+    sums[1] += a[i + 1] * b[i + 1];
+    sums[2] += a[i + 2] * b[i + 2];
+    sums[3] += a[i + 3] * b[i + 3];
+  }
+  float sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+  for (; i < size; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+void ScalePortable(const float* in, size_t size, float scale, float* out) {
+  for (size_t i = 0; i < size; ++i) {
+    out[i] = in[i] * scale;
+  }
+}
+#endif
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+__attribute__((target("avx2,fma"))) float HorizontalSum(__m256 v) {
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v),
+                          _mm256_extractf128_ps(v, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum);
+}
+
+__attribute__((target("avx2,fma"))) float DotProductAvx2(const float* a,
+                                                        const float* b,
+                                                        size_t size) {
+  // Two accumulators hide the FMA latency
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i),
+                           sum0);
+    sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8),
+                           _mm256_loadu_ps(b + i + 8), sum1);
+  }
+  if (i + 8 <= size) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i),
+                           sum0);
+    i += 8;
+  }
+  float sum = HorizontalSum(_mm256_add_ps(sum0, sum1));
+  for (; i < size; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+__attribute__((target("avx2,fma"))) void ScaleAvx2(const float* in,
+                                                  size_t size,
+                                                  float scale,
+                                                  float* out) {
+  __m256 factor = _mm256_set1_ps(scale);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(in + i), factor));
+  }
+  for (; i < size; ++i) {
+    out[i] = in[i] * scale;
+  }
+}
+
+bool HasAvx2() {
+  static const bool has_avx2 = [] {
+    base::CPU cpu;
+    return cpu.has_avx2() && cpu.has_fma3();
+  }();
+  return has_avx2;
+}
+
+#elif defined(ARCH_CPU_ARM64)
+
+float DotProductNeon(const float* a, const float* b, size_t size) {
+  float32x4_t sum0 = vdupq_n_f32(0.0f);
+  float32x4_t sum1 = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+    sum1 = vfmaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  if (i + 4 <= size) {
+    sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+    i += 4;
+  }
+  float sum = vaddvq_f32(vaddq_f32(sum0, sum1));
+  for (; i < size; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+void ScaleNeon(const float* in, size_t size, float scale, float* out) {
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    vst1q_f32(out + i, vmulq_n_f32(vld1q_f32(in + i), scale));
+  }
+  for (; i < size; ++i) {
+    out[i] = in[i] * scale;
+  }
+}
+
+#endif
+
+void Scale(const float* in, size_t size, float scale, float* out) {
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (HasAvx2()) {
+    ScaleAvx2(in, size, scale, out);
+    return;
+  }
+  ScalePortable(in, size, scale, out);
+#elif defined(ARCH_CPU_ARM64)
+  ScaleNeon(in, size, scale, out);
+#else
+  ScalePortable(in, size, scale, out);
+#endif
+}
+
+}  // namespace
+
+float DotProduct(const float* a, const float* b, size_t size) {
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (HasAvx2()) {
+    return DotProductAvx2(a, b, size);
+  }
+  return DotProductPortable(a, b, size);
+#elif defined(ARCH_CPU_ARM64)
+  return DotProductNeon(a, b, size);
+#else
+  return DotProductPortable(a, b, size);
+#endif
+}
+
+bool Normalize(const float* in, size_t size, float* out) {
+  float norm = DotProduct(in, in, size);
+  if (!(norm > 0.0f)) {
+    return false;
+  }
+  Scale(in, size, 1.0f / std::sqrt(norm), out);
+  return true;
+}
+
+void NormalizeRows(float* rows, size_t count, size_t dimension) {
+  for (size_t i = 0; i < count; ++i) {
+    float* row = rows + i * dimension;
+    Normalize(row, dimension, row);
+  }
+}
+
+void DotProductRows(const float* rows,
+                    size_t count,
+                    size_t dimension,
+                    const float* query,
+                    float* scores) {
+  for (size_t i = 0; i < count; ++i) {
+    scores[i] = DotProduct(rows + i * dimension, query, dimension);
+  }
+}
+
+}  // namespace core
+}  // namespace asol
@@ -0,0 +1,41 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_CORE_VECTOR_KERNELS_H_
+#define ASOL_CORE_VECTOR_KERNELS_H_
+
+#include <cstddef>
+
+namespace asol {
+namespace core {
+
+// Float kernels for embedding math. Rows are contiguous and row-major.
+//
+// Each kernel has a portable implementation, an AVX2/FMA one picked at
+// runtime on x86 CPUs that support it, and a NEON one on ARM64. Results
+// may differ from the portable version in the last bits, since the vector
+// versions sum in a different order.
+
+// Sum of a[i] * b[i]
+float DotProduct(const float* a, const float* b, size_t size);
+
+// Write |in| scaled to unit length into |out|, which may equal |in|.
+// Returns false, leaving |out| untouched, for a zero vector.
+bool Normalize(const float* in, size_t size, float* out);
+
+// Normalize each of |count| rows of |dimension| floats in place. Zero rows
+// stay zero.
+void NormalizeRows(float* rows, size_t count, size_t dimension);
+
+// scores[i] = DotProduct(row i, query) for each of |count| rows
+void DotProductRows(const float* rows,
+                    size_t count,
+                    size_t dimension,
+                    const float* query,
+                    float* scores);
+
+}  // namespace core
+}  // namespace asol
+
+#endif  // ASOL_CORE_VECTOR_KERNELS_H_
@@ -0,0 +1,70 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/core/vector_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace core {
+namespace {
+
+std::vector<float> MakeVector(size_t size, float phase) {
+  std::vector<float> values(size);
+  for (size_t i = 0; i < size; ++i) {
+    values[i] = std::sin(static_cast<float>(i) * 0.7f + phase);
+  }
+  return values;
+}
+
+TEST(VectorKernelsTest, DotProductMatchesScalarForAllTailLengths) {
+  // Covers every remainder of the 4-, 8- and 16-wide loops
+  for (size_t size = 0; size <= 40; ++size) {
+    std::vector<float> a = MakeVector(size, 0.0f);
+    std::vector<float> b = MakeVector(size, 1.3f);
+    double expected = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+      expected += a[i] * b[i];
+    }
+    EXPECT_NEAR(DotProduct(a.data(), b.data(), size), expected, 1e-5)
+        << "size " << size;
+  }
+}
+
+TEST(VectorKernelsTest, NormalizeProducesUnitVectors) {
+  std::vector<float> values = MakeVector(385, 0.2f);
+  std::vector<float> normalized(values.size());
+  ASSERT_TRUE(Normalize(values.data(), values.size(), normalized.data()));
+  EXPECT_NEAR(DotProduct(normalized.data(), normalized.data(),
+                         normalized.size()),
+              1.0f, 1e-5);
+
+  std::vector<float> zero(16, 0.0f);
+  std::vector<float> untouched(16, 7.0f);
+  EXPECT_FALSE(Normalize(zero.data(), zero.size(), untouched.data()));
+  EXPECT_EQ(untouched[0], 7.0f);
+}
+
+TEST(VectorKernelsTest, RowKernels) {
+  constexpr size_t kDimension = 19;
+  std::vector<float> rows = MakeVector(3 * kDimension, 0.5f);
+  std::fill(rows.begin() + kDimension, rows.begin() + 2 * kDimension, 0.0f);
+  NormalizeRows(rows.data(), 3, kDimension);
+
+  std::vector<float> scores(3);
+  DotProductRows(rows.data(), 3, kDimension, rows.data(), scores.data());
+  EXPECT_NEAR(scores[0], 1.0f, 1e-5);
+  EXPECT_EQ(scores[1], 0.0f);
+  EXPECT_NEAR(scores[2], DotProduct(rows.data() + 2 * kDimension,
+                                    rows.data(), kDimension),
+              1e-6);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace asol
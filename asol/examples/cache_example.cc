@@ -47,6 +47,8 @@ int main(int argc, char* argv[]) {
   cache_config.enabled = true;
   cache_config.max_entries = 50;
   cache_config.max_age_seconds = 3600;  // 1 hour
+  // With only 50 slots, keep one-off prompts from evicting repeated ones
+  cache_config.frequency_admission_enabled = true;
   adapter_manager->ConfigureCache(cache_config);
   
   // Print available providers
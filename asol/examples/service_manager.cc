@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "asol/util/performance_tracker.h"
 #include "base/logging.h"
 #include "base/strings/string_util.h"
 #include "third_party/nlohmann_json/json.hpp"
@@ -0,0 +1,350 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/util/performance_tracker.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <utility>
+
+#include "base/bits.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/no_destructor.h"
+#include "base/strings/escape.h"
+#include "base/strings/stringprintf.h"
+#include "base/values.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
+
+namespace asol {
+namespace util {
+
+namespace {
+
+// 16 exact buckets, then 16 sub-buckets for each power of two from 2^4 to
+// 2^31 us (about 36 minutes), which takes everything longer
+constexpr size_t kSubBuckets = 16;
+constexpr uint32_t kSubBucketBits = 4;
+constexpr uint32_t kMaxExponent = 32;
+constexpr size_t kBucketCount =
+    kSubBuckets + (kMaxExponent - kSubBucketBits) * kSubBuckets;
+
+std::atomic<uint64_t> g_next_tracker_id{1};
+
+size_t BucketForValue(uint64_t microseconds) {
+  if (microseconds < kSubBuckets) {
+    return microseconds;
+  }
+  if (microseconds > UINT32_MAX) {
+    return kBucketCount - 1;
+  }
+  uint32_t exponent =
+      base::bits::Log2Floor(static_cast<uint32_t>(microseconds));
+  size_t sub_bucket =
+      (microseconds >> (exponent - kSubBucketBits)) - kSubBuckets;
+  return kSubBuckets + (exponent - kSubBucketBits) * kSubBuckets + sub_bucket;
+}
+
+// The middle of the values in |bucket|, in microseconds
+uint64_t BucketMidpoint(size_t bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  uint32_t shift = (bucket - kSubBuckets) / kSubBuckets;
+  uint64_t sub_bucket = (bucket - kSubBuckets) % kSubBuckets;
+  uint64_t low = (kSubBuckets + sub_bucket) << shift;
+  return low + ((uint64_t{1} << shift) >> 1);
+}
+
+double ToMilliseconds(base::TimeDelta duration) {
+  return duration.InMicrosecondsF() / 1000.0;
+}
+
+}  // namespace
+
+class PerformanceTracker::Histogram {
+ public:
+  Histogram() {
+    for (std::atomic<uint64_t>& bucket : buckets_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  Histogram(const Histogram&) = delete;
+  Histogram& operator=(const Histogram&) = delete;
+
+  // Only the owning thread writes, so a load and a store suffice
+  void Record(uint64_t microseconds) {
+    Increment(buckets_[BucketForValue(microseconds)], 1);
+    Increment(count_, 1);
+    Increment(sum_, microseconds);
+    if (microseconds < min_.load(std::memory_order_relaxed)) {
+      min_.store(microseconds, std::memory_order_relaxed);
+    }
+    if (microseconds > max_.load(std::memory_order_relaxed)) {
+      max_.store(microseconds, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  friend struct PerformanceTracker::Merged;
+
+  static void Increment(std::atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount,
+                  std::memory_order_relaxed);
+  }
+
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_;
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> min_{UINT64_MAX};
+  std::atomic<uint64_t> max_{0};
+};
+
+struct PerformanceTracker::ThreadRecorder {
+  base::Lock lock;
+  // Only the recording thread adds to it, under |lock|, so that thread
+  // finds its histograms without the lock
+  std::unordered_map<const char*, std::unique_ptr<Histogram>> histograms;
+};
+
+struct PerformanceTracker::Merged {
+  void Add(const Histogram& histogram) {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      buckets[i] += histogram.buckets_[i].load(std::memory_order_relaxed);
+    }
+    count += histogram.count_.load(std::memory_order_relaxed);
+    sum += histogram.sum_.load(std::memory_order_relaxed);
+    min = std::min(min, histogram.min_.load(std::memory_order_relaxed));
+    max = std::max(max, histogram.max_.load(std::memory_order_relaxed));
+  }
+
+  // Within the range seen, so a single sample reports exactly
+  uint64_t Percentile(double q) const {
+    uint64_t total = 0;
+    for (uint64_t bucket : buckets) {
+      total += bucket;
+    }
+    if (total == 0) {
+      return 0;
+    }
+    uint64_t rank =
+        std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      seen += buckets[i];
+      if (seen >= rank) {
+        return std::clamp(BucketMidpoint(i), min, max);
+      }
+    }
+    return max;
+  }
+
+  std::array<uint64_t, kBucketCount> buckets{};
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t min = UINT64_MAX;
+  uint64_t max = 0;
+};
+
+// static
+PerformanceTracker* PerformanceTracker::GetInstance() {
+  static base::NoDestructor<PerformanceTracker> instance;
+  return instance.get();
+}
+
+PerformanceTracker::PerformanceTracker()
+    : id_(g_next_tracker_id.fetch_add(1, std::memory_order_relaxed)),
+      created_(base::TimeTicks::Now()) {}
+
+PerformanceTracker::~PerformanceTracker() = default;
+
+void PerformanceTracker::RecordDuration(const char* name,
+                                        base::TimeDelta duration) {
+  GetHistogram(GetThreadRecorder(), name)
+      ->Record(std::max<int64_t>(0, duration.InMicroseconds()));
+}
+
+PerformanceTracker::Stats PerformanceTracker::GetStats(
+    std::string_view name) const {
+  std::vector<Stats> stats = Collect(name);
+  if (stats.empty()) {
+    Stats empty;
+    empty.name = std::string(name);
+    return empty;
+  }
+  return std::move(stats.front());
+}
+
+std::vector<PerformanceTracker::Stats> PerformanceTracker::GetAllStats()
+    const {
+  return Collect(std::string_view());
+}
+
+void PerformanceTracker::StartDumping(base::TimeDelta dump_interval) {
+  dump_timer_.Stop();
+  if (dump_interval.is_positive()) {
+    dump_timer_.Start(FROM_HERE, dump_interval, this,
+                      &PerformanceTracker::DumpToLog);
+  }
+}
+
+void PerformanceTracker::StopDumping() {
+  dump_timer_.Stop();
+}
+
+std::string PerformanceTracker::GetJsonDump() const {
+  base::Value::Dict dump;
+  for (const Stats& stats : GetAllStats()) {
+    base::Value::Dict entry;
+    entry.Set("count", static_cast<double>(stats.count));
+    entry.Set("total_ms", ToMilliseconds(stats.total));
+    entry.Set("mean_ms", ToMilliseconds(stats.mean));
+    entry.Set("min_ms", ToMilliseconds(stats.min));
+    entry.Set("max_ms", ToMilliseconds(stats.max));
+    entry.Set("p50_ms", ToMilliseconds(stats.p50));
+    entry.Set("p90_ms", ToMilliseconds(stats.p90));
+    entry.Set("p99_ms", ToMilliseconds(stats.p99));
+    entry.Set("p999_ms", ToMilliseconds(stats.p999));
+    entry.Set("per_second", stats.per_second);
+    dump.Set(stats.name, std::move(entry));
+  }
+  std::string json;
+  base::JSONWriter::Write(dump, &json);
+  return json;
+}
+
+std::string PerformanceTracker::GetDiagnosticsHtml() const {
+  std::string html =
+      "<!doctype html><html><head><meta charset=\"utf-8\">"
+      "<title>AI performance</title><style>"
+      "body{font-family:system-ui,sans-serif;margin:2em}"
+      "table{border-collapse:collapse}"
+      "th,td{padding:4px 12px;border-bottom:1px solid #ddd}"
+      "td.n{text-align:right;font-variant-numeric:tabular-nums}"
+      "</style></head><body><h1>AI performance</h1><table><tr>"
+      "<th>Operation</th><th>Count</th><th>Per second</th><th>Mean</th>"
+      "<th>p50</th><th>p90</th><th>p99</th><th>p99.9</th><th>Max</th>"
+      "<th>Total</th></tr>";
+  for (const Stats& stats : GetAllStats()) {
+    html += base::StringPrintf(
+        "<tr><td>%s</td><td class=\"n\">%llu</td><td class=\"n\">%.2f</td>"
+        "<td class=\"n\">%.2f ms</td><td class=\"n\">%.2f ms</td>"
+        "<td class=\"n\">%.2f ms</td><td class=\"n\">%.2f ms</td>"
+        "<td class=\"n\">%.2f ms</td><td class=\"n\">%.2f ms</td>"
+        "<td class=\"n\">%.0f ms</td></tr>",
+        base::EscapeForHTML(stats.name).c_str(),
+        static_cast<unsigned long long>(stats.count), stats.per_second,
+        ToMilliseconds(stats.mean), ToMilliseconds(stats.p50),
+        ToMilliseconds(stats.p90), ToMilliseconds(stats.p99),
+        ToMilliseconds(stats.p999), ToMilliseconds(stats.max),
+        ToMilliseconds(stats.total));
+  }
+  html += "</table></body></html>";
+  return html;
+}
+
+PerformanceTracker::ThreadRecorder* PerformanceTracker::GetThreadRecorder() {
+  // The recorder of the tracker this thread recorded into last, normally
+  // the only one
+  struct Cache {
+    uint64_t tracker_id;
+    ThreadRecorder* recorder;
+  };
+  ABSL_CONST_INIT thread_local Cache cache = {0, nullptr};
+  if (cache.tracker_id == id_) {
+    return cache.recorder;
+  }
+
+  base::AutoLock lock(lock_);
+  std::unique_ptr<ThreadRecorder>& recorder =
+      recorders_[base::PlatformThread::CurrentId()];
+  if (!recorder) {
+    recorder = std::make_unique<ThreadRecorder>();
+  }
+  cache = {id_, recorder.get()};
+  return recorder.get();
+}
+
+PerformanceTracker::Histogram* PerformanceTracker::GetHistogram(
+    ThreadRecorder* recorder,
+    const char* name) {
+  // No other thread adds to |recorder|, so looking up needs no lock
+  auto it = recorder->histograms.find(name);
+  if (it != recorder->histograms.end()) {
+    return it->second.get();
+  }
+  base::AutoLock lock(recorder->lock);
+  return recorder->histograms.emplace(name, std::make_unique<Histogram>())
+      .first->second.get();
+}
+
+std::vector<PerformanceTracker::Stats> PerformanceTracker::Collect(
+    std::string_view only_name) const {
+  // The same name may come from several threads, and several literals
+  std::map<std::string, Merged, std::less<>> by_name;
+  {
+    base::AutoLock lock(lock_);
+    for (const auto& [thread_id, recorder] : recorders_) {
+      base::AutoLock recorder_lock(recorder->lock);
+      for (const auto& [name, histogram] : recorder->histograms) {
+        if (!only_name.empty() && only_name != name) {
+          continue;
+        }
+        auto it = by_name.find(std::string_view(name));
+        if (it == by_name.end()) {
+          it = by_name.emplace(name, Merged()).first;
+        }
+        it->second.Add(*histogram);
+      }
+    }
+  }
+
+  double seconds = (base::TimeTicks::Now() - created_).InSecondsF();
+  std::vector<Stats> result;
+  result.reserve(by_name.size());
+  for (const auto& [name, merged] : by_name) {
+    if (merged.count == 0) {
+      continue;
+    }
+    Stats stats;
+    stats.name = name;
+    stats.count = merged.count;
+    stats.total = base::Microseconds(merged.sum);
+    stats.mean = base::Microseconds(merged.sum / merged.count);
+    stats.min = base::Microseconds(merged.min);
+    stats.max = base::Microseconds(merged.max);
+    stats.p50 = base::Microseconds(merged.Percentile(0.5));
+    stats.p90 = base::Microseconds(merged.Percentile(0.9));
+    stats.p99 = base::Microseconds(merged.Percentile(0.99));
+    stats.p999 = base::Microseconds(merged.Percentile(0.999));
+    stats.per_second = seconds > 0 ? merged.count / seconds : 0.0;
+    result.push_back(std::move(stats));
+  }
+  std::stable_sort(result.begin(), result.end(),
+                   [](const Stats& a, const Stats& b) {
+                     return a.total > b.total;
+                   });
+  return result;
+}
+
+void PerformanceTracker::DumpToLog() const {
+  LOG(INFO) << "AI performance: " << GetJsonDump();
+}
+
+ScopedPerformanceTracker::ScopedPerformanceTracker(const char* name,
+                                                   PerformanceTracker* tracker)
+    : tracker_(tracker ? tracker : PerformanceTracker::GetInstance()),
+      name_(name),
+      start_(base::TimeTicks::Now()) {}
+
+ScopedPerformanceTracker::~ScopedPerformanceTracker() {
+  tracker_->RecordDuration(name_, base::TimeTicks::Now() - start_);
+}
+
+}  // namespace util
+}  // namespace asol
@@ -0,0 +1,156 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ASOL_UTIL_PERFORMANCE_TRACKER_H_
+#define ASOL_UTIL_PERFORMANCE_TRACKER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace asol {
+namespace util {
+
+// PerformanceTracker collects how long named operations take, as timed by
+// ScopedPerformanceTracker, into log-linear (HDR-style) histograms:
+// durations below 16 us get exact buckets, and above that every power of
+// two is split into 16, so percentiles are within about 3%.
+//
+// Recording is cheap enough for hot paths. Each thread records into
+// histograms of its own, looked up by the address of the name, with no
+// lock and no atomic read-modify-write; only a thread's first sample of a
+// name takes a lock. Readers merge the threads' histograms by name.
+//
+// Statistics are available through GetStats(), as a periodic JSON dump to
+// the log, and as the diagnostics page at kDiagnosticsUrl.
+class PerformanceTracker {
+ public:
+  struct Stats {
+    std::string name;
+    uint64_t count = 0;
+    base::TimeDelta total;
+    base::TimeDelta mean;
+    base::TimeDelta min;
+    base::TimeDelta max;
+    base::TimeDelta p50;
+    base::TimeDelta p90;
+    base::TimeDelta p99;
+    base::TimeDelta p999;
+    // Operations per second since the tracker was created
+    double per_second = 0.0;
+  };
+
+  static constexpr char kDiagnosticsUrl[] = "asol://performance";
+  static constexpr base::TimeDelta kDefaultDumpInterval = base::Minutes(10);
+
+  static PerformanceTracker* GetInstance();
+
+  PerformanceTracker();
+  ~PerformanceTracker();
+
+  PerformanceTracker(const PerformanceTracker&) = delete;
+  PerformanceTracker& operator=(const PerformanceTracker&) = delete;
+
+  // Record one run of |name|, from any thread. |name| must outlive the
+  // tracker, as a string literal does.
+  void RecordDuration(const char* name, base::TimeDelta duration);
+
+  // Statistics of |name| across threads; a count of 0 if never recorded
+  Stats GetStats(std::string_view name) const;
+
+  // Statistics of every name, most total time first
+  std::vector<Stats> GetAllStats() const;
+
+  base::TimeDelta GetAverageDuration(std::string_view name) const {
+    return GetStats(name).mean;
+  }
+
+  // Log the statistics as JSON every |dump_interval|, until StopDumping().
+  // Must be called on a sequence, which the dumps run on.
+  void StartDumping(base::TimeDelta dump_interval = kDefaultDumpInterval);
+  void StopDumping();
+
+  // The statistics as JSON: an object keyed by name, with durations in
+  // milliseconds
+  std::string GetJsonDump() const;
+
+  // The diagnostics page: an HTML table of the statistics
+  std::string GetDiagnosticsHtml() const;
+
+ private:
+  // One thread's histogram of one name, and the histograms recorded by one
+  // thread
+  class Histogram;
+  struct ThreadRecorder;
+  // Sum of the threads' histograms of one name
+  struct Merged;
+
+  ThreadRecorder* GetThreadRecorder();
+  Histogram* GetHistogram(ThreadRecorder* recorder, const char* name);
+
+  std::vector<Stats> Collect(std::string_view only_name) const;
+
+  void DumpToLog() const;
+
+  // Distinguishes trackers in the threads' cached recorders
+  const uint64_t id_;
+  const base::TimeTicks created_;
+
+  mutable base::Lock lock_;
+  // A thread that exits leaves its recorder, and samples, to the next
+  // thread given the same ID
+  std::unordered_map<base::PlatformThreadId, std::unique_ptr<ThreadRecorder>>
+      recorders_ GUARDED_BY(lock_);
+
+  base::RepeatingTimer dump_timer_;
+};
+
+// ScopedPerformanceTracker records how long the scope it lives in takes,
+// under |name|, which must outlive the tracker, as a string literal does.
+//
+//   void ServiceManager::ProcessText(...) {
+//     util::ScopedPerformanceTracker tracker("ServiceManager_ProcessText");
+//     ...
+//   }
+class ScopedPerformanceTracker {
+ public:
+  // Records into |tracker|, PerformanceTracker::GetInstance() if null
+  explicit ScopedPerformanceTracker(const char* name,
+                                    PerformanceTracker* tracker = nullptr);
+  ~ScopedPerformanceTracker();
+
+  ScopedPerformanceTracker(const ScopedPerformanceTracker&) = delete;
+  ScopedPerformanceTracker& operator=(const ScopedPerformanceTracker&) =
+      delete;
+
+ private:
+  PerformanceTracker* const tracker_;
+  const char* const name_;
+  const base::TimeTicks start_;
+};
+
+#define ASOL_PERFORMANCE_TRACKER_NAME2(line) asol_performance_tracker_##line
+#define ASOL_PERFORMANCE_TRACKER_NAME(line) \
+  ASOL_PERFORMANCE_TRACKER_NAME2(line)
+
+// Track the rest of the enclosing scope as |name|
+#define ASOL_TRACK_PERFORMANCE(name)             \
+  ::asol::util::ScopedPerformanceTracker         \
+  ASOL_PERFORMANCE_TRACKER_NAME(__LINE__)(name)
+
+}  // namespace util
+}  // namespace asol
+
+#endif  // ASOL_UTIL_PERFORMANCE_TRACKER_H_
@@ -0,0 +1,118 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asol/util/performance_tracker.h"
+
+#include <string>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/json/json_reader.h"
+#include "base/test/task_environment.h"
+#include "base/threading/thread.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace util {
+namespace {
+
+class PerformanceTrackerTest : public testing::Test {
+ protected:
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  PerformanceTracker tracker_;
+};
+
+TEST_F(PerformanceTrackerTest, ReportsPercentiles) {
+  for (int i = 1; i <= 1000; ++i) {
+    tracker_.RecordDuration("Op", base::Milliseconds(i));
+  }
+
+  PerformanceTracker::Stats stats = tracker_.GetStats("Op");
+  EXPECT_EQ(stats.count, 1000u);
+  EXPECT_EQ(stats.min, base::Milliseconds(1));
+  EXPECT_EQ(stats.max, base::Milliseconds(1000));
+  EXPECT_EQ(stats.mean, base::Microseconds(500500));
+  // Within the histogram's precision
+  EXPECT_NEAR(stats.p50.InMillisecondsF(), 500, 500 * 0.035);
+  EXPECT_NEAR(stats.p90.InMillisecondsF(), 900, 900 * 0.035);
+  EXPECT_NEAR(stats.p99.InMillisecondsF(), 990, 990 * 0.035);
+  EXPECT_LE(stats.p999, stats.max);
+}
+
+TEST_F(PerformanceTrackerTest, ReportsUnknownNameAsEmpty) {
+  PerformanceTracker::Stats stats = tracker_.GetStats("Never");
+  EXPECT_EQ(stats.name, "Never");
+  EXPECT_EQ(stats.count, 0u);
+  EXPECT_TRUE(tracker_.GetAllStats().empty());
+}
+
+TEST_F(PerformanceTrackerTest, MergesThreads) {
+  base::Thread thread("Recorder");
+  ASSERT_TRUE(thread.Start());
+  thread.task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(
+                     [](PerformanceTracker* tracker) {
+                       for (int i = 0; i < 10; ++i) {
+                         tracker->RecordDuration("Op", base::Milliseconds(20));
+                       }
+                     },
+                     &tracker_));
+  thread.FlushForTesting();
+  tracker_.RecordDuration("Op", base::Milliseconds(10));
+
+  PerformanceTracker::Stats stats = tracker_.GetStats("Op");
+  EXPECT_EQ(stats.count, 11u);
+  EXPECT_EQ(stats.min, base::Milliseconds(10));
+  EXPECT_EQ(stats.max, base::Milliseconds(20));
+  EXPECT_EQ(stats.total, base::Milliseconds(210));
+}
+
+TEST_F(PerformanceTrackerTest, MergesNamesByText) {
+  // Two arrays, so two addresses
+  static const char kName[] = "Op";
+  static const char kSameName[] = "Op";
+  tracker_.RecordDuration(kName, base::Milliseconds(1));
+  tracker_.RecordDuration(kSameName, base::Milliseconds(3));
+
+  std::vector<PerformanceTracker::Stats> stats = tracker_.GetAllStats();
+  ASSERT_EQ(stats.size(), 1u);
+  EXPECT_EQ(stats[0].count, 2u);
+  EXPECT_EQ(stats[0].mean, base::Milliseconds(2));
+}
+
+TEST_F(PerformanceTrackerTest, ScopedTrackerRecordsItsScope) {
+  {
+    ScopedPerformanceTracker scoped("Scope", &tracker_);
+    task_environment_.FastForwardBy(base::Milliseconds(40));
+  }
+  task_environment_.FastForwardBy(base::Seconds(1));
+
+  PerformanceTracker::Stats stats = tracker_.GetStats("Scope");
+  EXPECT_EQ(stats.count, 1u);
+  EXPECT_EQ(stats.p50, base::Milliseconds(40));
+  EXPECT_GT(stats.per_second, 0.0);
+}
+
+TEST_F(PerformanceTrackerTest, DumpsJson) {
+  tracker_.RecordDuration("Slow", base::Milliseconds(100));
+  tracker_.RecordDuration("Fast", base::Milliseconds(1));
+
+  absl::optional<base::Value> dump =
+      base::JSONReader::Read(tracker_.GetJsonDump());
+  ASSERT_TRUE(dump && dump->is_dict());
+  const base::Value::Dict* slow = dump->GetDict().FindDict("Slow");
+  ASSERT_TRUE(slow);
+  EXPECT_EQ(slow->FindDouble("count"), 1.0);
+  EXPECT_EQ(slow->FindDouble("p50_ms"), 100.0);
+  EXPECT_TRUE(dump->GetDict().FindDict("Fast"));
+
+  EXPECT_NE(tracker_.GetDiagnosticsHtml().find("<td>Slow</td>"),
+            std::string::npos);
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace asol
@@ -38,11 +38,19 @@ bool BrowserAIIntegration::Initialize(
   
   browser_engine_ = browser_engine;
   ai_service_manager_ = ai_service_manager;
+  if (!snapshot_service_) {
+    snapshot_service_ = base::MakeRefCounted<content::PageSnapshotService>();
+  }
   
   LOG(INFO) << "BrowserAIIntegration initialized successfully";
   return true;
 }
 
+void BrowserAIIntegration::SetPageSnapshotService(
+    scoped_refptr<content::PageSnapshotService> snapshot_service) {
+  snapshot_service_ = std::move(snapshot_service);
+}
+
 void BrowserAIIntegration::SummarizePage(
     int tab_id, 
     FeatureResultCallback callback) {
@@ -363,8 +371,15 @@ void BrowserAIIntegration::ExtractPageContent(
     return;
   }
   
-  // Extract the main text from the page
-  web_contents->ExtractMainText(std::move(callback));
+  // The page's main text, from the snapshot other features share
+  snapshot_service_->GetSnapshot(
+      web_contents,
+      base::BindOnce(
+          [](base::OnceCallback<void(const std::string&)> callback,
+             scoped_refptr<const content::PageSnapshot> snapshot) {
+            std::move(callback).Run(snapshot->content.main_text);
+          },
+          std::move(callback)));
 }
 
 void BrowserAIIntegration::OnAIResponse(
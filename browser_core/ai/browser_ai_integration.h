@@ -10,8 +10,10 @@
 #include <vector>
 
 #include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "asol/core/ai_service_manager.h"
+#include "browser_core/content/page_snapshot_service.h"
 #include "browser_core/engine/browser_engine.h"
 #include "browser_core/engine/tab.h"
 #include "browser_core/engine/web_contents.h"
@@ -56,6 +58,12 @@ class BrowserAIIntegration {
   bool Initialize(BrowserEngine* browser_engine, 
                 asol::core::AIServiceManager* ai_service_manager);
 
+  // Read pages through |snapshot_service|, shared with the other features
+  // that read them, so features asking about the same page version share
+  // one extraction. Initialize() creates a service of its own otherwise.
+  void SetPageSnapshotService(
+      scoped_refptr<content::PageSnapshotService> snapshot_service);
+
   // Page summarization
   void SummarizePage(int tab_id, FeatureResultCallback callback);
 
@@ -110,6 +118,9 @@ class BrowserAIIntegration {
   BrowserEngine* browser_engine_ = nullptr;
   asol::core::AIServiceManager* ai_service_manager_ = nullptr;
 
+  // Page extraction shared with other features
+  scoped_refptr<content::PageSnapshotService> snapshot_service_;
+
   // Enabled features
   std::unordered_map<FeatureType, bool> enabled_features_;
 
@@ -0,0 +1,475 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ai/content_understanding.h"
+
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+#include "asol/core/prompt_cache.h"
+#include "asol/core/prompt_template.h"
+#include "base/functional/bind.h"
+#include "base/json/json_reader.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+#include "browser_core/ai/language_detector.h"
+
+namespace browser_core {
+namespace ai {
+
+namespace {
+
+using ContentAnalysisResult = ContentUnderstanding::ContentAnalysisResult;
+using ContentSummary = ContentUnderstanding::ContentSummary;
+using Entity = ContentUnderstanding::Entity;
+using EntityType = ContentUnderstanding::EntityType;
+using SentimentAnalysis = ContentUnderstanding::SentimentAnalysis;
+using Topic = ContentUnderstanding::Topic;
+
+// The fields asked for depend on the facets; the instructions before them
+// are the same for every analysis
+constexpr asol::core::PromptTemplate kAnalysisPrompt(
+    "Analyze the following web page content. Respond with only a JSON "
+    "object with these fields:\n{fields}\nContent:\n{content}",
+    "fields");
+
+struct FacetField {
+  uint32_t facet;
+  const char* description;
+};
+
+constexpr FacetField kFacetFields[] = {
+    {ContentUnderstanding::kSummaryFacet,
+     "summary: object with brief (1-2 sentences), detailed (a paragraph), "
+     "key_points (array of strings), title, author, published_date"},
+    {ContentUnderstanding::kEntitiesFacet,
+     "entities: array of objects with name, type (one of person, "
+     "organization, location, date, event, product, concept, other), "
+     "description, confidence (0 to 1)"},
+    {ContentUnderstanding::kTopicsFacet,
+     "topics: array of objects with name, relevance (0 to 1), "
+     "related_topics (array of strings)"},
+    {ContentUnderstanding::kSentimentFacet,
+     "sentiment: object with overall (one of very_negative, negative, "
+     "neutral, positive, very_positive), score (-1 to 1), aspects (object "
+     "mapping each aspect discussed to its score)"},
+    {ContentUnderstanding::kContentTypeFacet,
+     "content_type: string such as article, product page, news, forum, "
+     "documentation"},
+};
+
+asol::core::RequestFingerprint ComputeKey(std::string_view content) {
+  asol::core::Hasher128 hasher;
+  hasher.Update(content);
+  return hasher.Finish();
+}
+
+EntityType ParseEntityType(const std::string* type) {
+  static constexpr std::pair<const char*, EntityType> kTypes[] = {
+      {"person", EntityType::PERSON},
+      {"organization", EntityType::ORGANIZATION},
+      {"location", EntityType::LOCATION},
+      {"date", EntityType::DATE},
+      {"event", EntityType::EVENT},
+      {"product", EntityType::PRODUCT},
+      {"concept", EntityType::CONCEPT},
+  };
+  if (type) {
+    for (const auto& [name, value] : kTypes) {
+      if (*type == name) {
+        return value;
+      }
+    }
+  }
+  return EntityType::OTHER;
+}
+
+void ParseSummary(const base::Value::Dict& dict, ContentSummary* summary) {
+  auto find_string = [&dict](const char* key) {
+    const std::string* value = dict.FindString(key);
+    return value ? *value : std::string();
+  };
+  summary->brief_summary = find_string("brief");
+  summary->detailed_summary = find_string("detailed");
+  summary->title = find_string("title");
+  summary->author = find_string("author");
+  summary->published_date = find_string("published_date");
+  if (const base::Value::List* key_points = dict.FindList("key_points")) {
+    for (const base::Value& point : *key_points) {
+      if (point.is_string()) {
+        summary->key_points.push_back(point.GetString());
+      }
+    }
+  }
+}
+
+void ParseEntities(const base::Value::List& list,
+                   std::vector<Entity>* entities) {
+  for (const base::Value& item : list) {
+    const base::Value::Dict* dict = item.GetIfDict();
+    const std::string* name = dict ? dict->FindString("name") : nullptr;
+    if (!name || name->empty()) {
+      continue;
+    }
+    Entity entity;
+    entity.name = *name;
+    entity.type = ParseEntityType(dict->FindString("type"));
+    if (const std::string* description = dict->FindString("description")) {
+      entity.description = *description;
+    }
+    entity.confidence =
+        static_cast<float>(dict->FindDouble("confidence").value_or(0.0));
+    entities->push_back(std::move(entity));
+  }
+}
+
+void ParseTopics(const base::Value::List& list, std::vector<Topic>* topics) {
+  for (const base::Value& item : list) {
+    const base::Value::Dict* dict = item.GetIfDict();
+    const std::string* name = dict ? dict->FindString("name") : nullptr;
+    if (!name || name->empty()) {
+      continue;
+    }
+    Topic topic;
+    topic.name = *name;
+    topic.relevance =
+        static_cast<float>(dict->FindDouble("relevance").value_or(0.0));
+    if (const base::Value::List* related = dict->FindList("related_topics")) {
+      for (const base::Value& related_topic : *related) {
+        if (related_topic.is_string()) {
+          topic.related_topics.push_back(related_topic.GetString());
+        }
+      }
+    }
+    topics->push_back(std::move(topic));
+  }
+}
+
+void ParseSentiment(const base::Value::Dict& dict,
+                    SentimentAnalysis* sentiment) {
+  using Sentiment = SentimentAnalysis::Sentiment;
+  static constexpr std::pair<const char*, Sentiment> kSentiments[] = {
+      {"very_negative", Sentiment::VERY_NEGATIVE},
+      {"negative", Sentiment::NEGATIVE},
+      {"neutral", Sentiment::NEUTRAL},
+      {"positive", Sentiment::POSITIVE},
+      {"very_positive", Sentiment::VERY_POSITIVE},
+  };
+  sentiment->score = static_cast<float>(dict.FindDouble("score").value_or(0.0));
+  // Without a label, the score decides
+  sentiment->overall_sentiment =
+      sentiment->score <= -0.6f  ? Sentiment::VERY_NEGATIVE
+      : sentiment->score <= -0.2f ? Sentiment::NEGATIVE
+      : sentiment->score < 0.2f   ? Sentiment::NEUTRAL
+      : sentiment->score < 0.6f   ? Sentiment::POSITIVE
+                                  : Sentiment::VERY_POSITIVE;
+  if (const std::string* overall = dict.FindString("overall")) {
+    for (const auto& [name, value] : kSentiments) {
+      if (*overall == name) {
+        sentiment->overall_sentiment = value;
+      }
+    }
+  }
+  if (const base::Value::Dict* aspects = dict.FindDict("aspects")) {
+    for (const auto [aspect, score] : *aspects) {
+      if (auto value = score.GetIfDouble()) {
+        sentiment->aspect_sentiments[aspect] = static_cast<float>(*value);
+      }
+    }
+  }
+}
+
+// Copy |facets| of the JSON object the model answered with to |result|.
+// Returns false, leaving |result| as it was, if |response| holds none.
+bool ParseAnalysisResponse(const std::string& response,
+                           uint32_t facets,
+                           ContentAnalysisResult* result) {
+  // Models sometimes wrap the object in a code fence or a sentence
+  size_t begin = response.find('{');
+  size_t end = response.rfind('}');
+  if (begin == std::string::npos || end == std::string::npos || end < begin) {
+    return false;
+  }
+  absl::optional<base::Value> json = base::JSONReader::Read(
+      std::string_view(response).substr(begin, end - begin + 1));
+  if (!json || !json->is_dict()) {
+    return false;
+  }
+  const base::Value::Dict& dict = json->GetDict();
+
+  if (facets & ContentUnderstanding::kSummaryFacet) {
+    result->summary = ContentSummary();
+    if (const base::Value::Dict* summary = dict.FindDict("summary")) {
+      ParseSummary(*summary, &result->summary);
+    }
+  }
+  if (facets & ContentUnderstanding::kEntitiesFacet) {
+    result->entities.clear();
+    if (const base::Value::List* entities = dict.FindList("entities")) {
+      ParseEntities(*entities, &result->entities);
+    }
+  }
+  if (facets & ContentUnderstanding::kTopicsFacet) {
+    result->topics.clear();
+    if (const base::Value::List* topics = dict.FindList("topics")) {
+      ParseTopics(*topics, &result->topics);
+    }
+  }
+  if (facets & ContentUnderstanding::kSentimentFacet) {
+    result->sentiment = SentimentAnalysis();
+    if (const base::Value::Dict* sentiment = dict.FindDict("sentiment")) {
+      ParseSentiment(*sentiment, &result->sentiment);
+    }
+  }
+  if (facets & ContentUnderstanding::kContentTypeFacet) {
+    const std::string* content_type = dict.FindString("content_type");
+    result->content_type = content_type ? *content_type : std::string();
+  }
+  return true;
+}
+
+// |result| with only |facets| filled in
+ContentAnalysisResult SelectFacets(const ContentAnalysisResult& result,
+                                   uint32_t facets) {
+  ContentAnalysisResult selected;
+  selected.success = result.success;
+  selected.language = result.language;
+  if (facets & ContentUnderstanding::kSummaryFacet) {
+    selected.summary = result.summary;
+  }
+  if (facets & ContentUnderstanding::kEntitiesFacet) {
+    selected.entities = result.entities;
+  }
+  if (facets & ContentUnderstanding::kTopicsFacet) {
+    selected.topics = result.topics;
+  }
+  if (facets & ContentUnderstanding::kSentimentFacet) {
+    selected.sentiment = result.sentiment;
+  }
+  if (facets & ContentUnderstanding::kContentTypeFacet) {
+    selected.content_type = result.content_type;
+  }
+  return selected;
+}
+
+}  // namespace
+
+ContentUnderstanding::ContentUnderstanding() = default;
+ContentUnderstanding::~ContentUnderstanding() = default;
+
+bool ContentUnderstanding::Initialize(
+    asol::core::AIServiceManager* ai_service_manager) {
+  if (!ai_service_manager) {
+    return false;
+  }
+  ai_service_manager_ = ai_service_manager;
+  return true;
+}
+
+void ContentUnderstanding::AnalyzeContent(const std::string& content,
+                                          ContentAnalysisCallback callback) {
+  AnalyzeFacets(content, kAllFacets, std::move(callback));
+}
+
+void ContentUnderstanding::AnalyzeFacets(const std::string& content,
+                                         uint32_t facets,
+                                         ContentAnalysisCallback callback) {
+  facets &= kAllFacets;
+  Analysis& analysis = GetAnalysis(content);
+  uint32_t missing = facets & ~analysis.facets;
+  if (!missing) {
+    ++cache_hit_count_;
+    std::move(callback).Run(SelectFacets(analysis.result, facets));
+    return;
+  }
+  if (!ai_service_manager_) {
+    ContentAnalysisResult error_result;
+    error_result.error_message = "Content understanding is not initialized";
+    std::move(callback).Run(error_result);
+    return;
+  }
+
+  analysis.waiters.emplace_back(facets, std::move(callback));
+  // With a request in flight, whatever it does not cover is requested once
+  // it completes
+  if (!analysis.pending_facets) {
+    analysis.content = content;
+    RequestFacets(analysis, missing);
+  }
+}
+
+void ContentUnderstanding::ExtractEntities(
+    const std::string& content,
+    base::OnceCallback<void(const std::vector<Entity>&)> callback) {
+  AnalyzeFacets(content, kEntitiesFacet,
+                base::BindOnce(
+                    [](base::OnceCallback<void(const std::vector<Entity>&)>
+                           callback,
+                       const ContentAnalysisResult& result) {
+                      std::move(callback).Run(result.entities);
+                    },
+                    std::move(callback)));
+}
+
+void ContentUnderstanding::AnalyzeSentiment(
+    const std::string& content,
+    base::OnceCallback<void(const SentimentAnalysis&)> callback) {
+  AnalyzeFacets(
+      content, kSentimentFacet,
+      base::BindOnce(
+          [](base::OnceCallback<void(const SentimentAnalysis&)> callback,
+             const ContentAnalysisResult& result) {
+            std::move(callback).Run(result.sentiment);
+          },
+          std::move(callback)));
+}
+
+void ContentUnderstanding::IdentifyTopics(
+    const std::string& content,
+    base::OnceCallback<void(const std::vector<Topic>&)> callback) {
+  AnalyzeFacets(
+      content, kTopicsFacet,
+      base::BindOnce(
+          [](base::OnceCallback<void(const std::vector<Topic>&)> callback,
+             const ContentAnalysisResult& result) {
+            std::move(callback).Run(result.topics);
+          },
+          std::move(callback)));
+}
+
+void ContentUnderstanding::SummarizeContent(
+    const std::string& content,
+    base::OnceCallback<void(const ContentSummary&)> callback) {
+  AnalyzeFacets(
+      content, kSummaryFacet,
+      base::BindOnce(
+          [](base::OnceCallback<void(const ContentSummary&)> callback,
+             const ContentAnalysisResult& result) {
+            std::move(callback).Run(result.summary);
+          },
+          std::move(callback)));
+}
+
+void ContentUnderstanding::DetectLanguage(
+    const std::string& content,
+    base::OnceCallback<void(const std::string&)> callback) {
+  std::move(callback).Run(LanguageDetector::Detect(content));
+}
+
+base::WeakPtr<ContentUnderstanding> ContentUnderstanding::GetWeakPtr() {
+  return weak_ptr_factory_.GetWeakPtr();
+}
+
+ContentUnderstanding::Analysis& ContentUnderstanding::GetAnalysis(
+    const std::string& content) {
+  Key key = ComputeKey(content);
+  auto it = analysis_index_.find(key);
+  if (it != analysis_index_.end()) {
+    analyses_.splice(analyses_.begin(), analyses_, it->second);
+    return *it->second;
+  }
+
+  analyses_.emplace_front();
+  Analysis& analysis = analyses_.front();
+  analysis.key = key;
+  analysis.result.success = true;
+  analysis.result.language = LanguageDetector::Detect(content);
+  analysis_index_[key] = analyses_.begin();
+  EvictAnalyses();
+  return analysis;
+}
+
+void ContentUnderstanding::RequestFacets(Analysis& analysis, uint32_t facets) {
+  analysis.pending_facets = facets;
+  ++request_count_;
+
+  std::string fields;
+  for (const FacetField& field : kFacetFields) {
+    if (facets & field.facet) {
+      fields.append("- ").append(field.description).append("\n");
+    }
+  }
+
+  asol::core::AIServiceManager::AIRequestParams params;
+  params.task_type = asol::core::AIServiceManager::TaskType::CONTENT_ANALYSIS;
+  size_t prefix_length = 0;
+  params.input_text = kAnalysisPrompt.Render(
+      {{"fields", fields}, {"content", analysis.content}}, &prefix_length);
+  params.custom_params[asol::core::kPromptPrefixLengthParam] =
+      base::NumberToString(prefix_length);
+
+  ai_service_manager_->ProcessRequest(
+      params, base::BindOnce(&ContentUnderstanding::OnFacetsAnalyzed,
+                             weak_ptr_factory_.GetWeakPtr(), analysis.key,
+                             facets));
+}
+
+void ContentUnderstanding::OnFacetsAnalyzed(const Key& key,
+                                            uint32_t facets,
+                                            bool success,
+                                            const std::string& response) {
+  // Analyses with a request in flight are never evicted
+  auto it = analysis_index_.find(key);
+  if (it == analysis_index_.end()) {
+    return;
+  }
+  Analysis& analysis = *it->second;
+  analysis.pending_facets = 0;
+
+  std::string error_message;
+  if (!success) {
+    error_message = "Failed to analyze content: " + response;
+  } else if (!ParseAnalysisResponse(response, facets, &analysis.result)) {
+    error_message = "Failed to parse AI response as JSON";
+  } else {
+    analysis.facets |= facets;
+  }
+
+  // Answer every waiter this request completed; a failure fails them all
+  std::vector<Waiter> waiters = std::move(analysis.waiters);
+  analysis.waiters.clear();
+  std::vector<std::pair<ContentAnalysisCallback, ContentAnalysisResult>>
+      answers;
+  uint32_t missing = 0;
+  for (auto& [wanted, callback] : waiters) {
+    if (!error_message.empty()) {
+      ContentAnalysisResult error_result;
+      error_result.error_message = error_message;
+      answers.emplace_back(std::move(callback), std::move(error_result));
+    } else if (wanted & ~analysis.facets) {
+      missing |= wanted & ~analysis.facets;
+      analysis.waiters.emplace_back(wanted, std::move(callback));
+    } else {
+      answers.emplace_back(std::move(callback),
+                           SelectFacets(analysis.result, wanted));
+    }
+  }
+  if (missing) {
+    RequestFacets(analysis, missing);
+  } else {
+    analysis.content.clear();
+  }
+
+  // |analysis| may be gone once callers run
+  for (auto& [callback, result] : answers) {
+    std::move(callback).Run(result);
+  }
+}
+
+void ContentUnderstanding::EvictAnalyses() {
+  // The front one was just asked for
+  auto it = std::prev(analyses_.end());
+  while (analyses_.size() > kMaxCachedAnalyses && it != analyses_.begin()) {
+    if (it->pending_facets) {
+      --it;
+      continue;
+    }
+    analysis_index_.erase(it->key);
+    it = std::prev(analyses_.erase(it));
+  }
+}
+
+}  // namespace ai
+}  // namespace browser_core
@@ -5,21 +5,46 @@
 #ifndef BROWSER_CORE_AI_CONTENT_UNDERSTANDING_H_
 #define BROWSER_CORE_AI_CONTENT_UNDERSTANDING_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "asol/core/ai_service_manager.h"
+#include "asol/core/request_fingerprint.h"
 
 namespace browser_core {
 namespace ai {
 
 // ContentUnderstanding provides advanced content analysis capabilities.
+//
+// Every facet of an analysis the model provides comes from one fused
+// request that asks for the facets wanted as fields of one JSON object, so
+// a page costs one model call however many of ExtractEntities(),
+// IdentifyTopics() and the rest are asked about it. Facets are cached per
+// content: asking again for a facet already analyzed is answered without a
+// request, and asking for more only requests the missing ones. Requests
+// for content whose analysis is in flight wait for it instead of sending
+// their own. The language is detected locally by LanguageDetector.
 class ContentUnderstanding {
  public:
+  // Parts of an analysis that come from the model, combined as a mask
+  enum Facet : uint32_t {
+    kSummaryFacet = 1 << 0,
+    kEntitiesFacet = 1 << 1,
+    kTopicsFacet = 1 << 2,
+    kSentimentFacet = 1 << 3,
+    kContentTypeFacet = 1 << 4,
+    kAllFacets = (1 << 5) - 1,
+  };
+
   // Entity types
   enum class EntityType {
     PERSON,
@@ -35,16 +60,16 @@ class ContentUnderstanding {
   // Entity information
   struct Entity {
     std::string name;
-    EntityType type;
+    EntityType type = EntityType::OTHER;
     std::string description;
-    float confidence;
+    float confidence = 0.0f;
     std::vector<std::pair<int, int>> positions; // Start and end positions in text
   };
 
   // Topic information
   struct Topic {
     std::string name;
-    float relevance;
+    float relevance = 0.0f;
     std::vector<std::string> related_topics;
   };
 
@@ -58,8 +83,8 @@ class ContentUnderstanding {
       VERY_POSITIVE
     };
 
-    Sentiment overall_sentiment;
-    float score; // -1.0 to 1.0
+    Sentiment overall_sentiment = Sentiment::NEUTRAL;
+    float score = 0.0f; // -1.0 to 1.0
     std::unordered_map<std::string, float> aspect_sentiments;
   };
 
@@ -75,7 +100,7 @@ class ContentUnderstanding {
 
   // Content analysis result
   struct ContentAnalysisResult {
-    bool success;
+    bool success = false;
     ContentSummary summary;
     std::vector<Entity> entities;
     std::vector<Topic> topics;
@@ -91,20 +116,27 @@ class ContentUnderstanding {
       base::OnceCallback<void(const ContentAnalysisResult&)>;
 
   ContentUnderstanding();
-  ~ContentUnderstanding();
+  virtual ~ContentUnderstanding();
 
   // Disallow copy and assign
   ContentUnderstanding(const ContentUnderstanding&) = delete;
   ContentUnderstanding& operator=(const ContentUnderstanding&) = delete;
 
   // Initialize with AI service manager
-  bool Initialize(asol::core::AIServiceManager* ai_service_manager);
+  virtual bool Initialize(asol::core::AIServiceManager* ai_service_manager);
 
-  // Analyze content
+  // Analyze content: every facet, in at most one request
   void AnalyzeContent(const std::string& content, 
                     ContentAnalysisCallback callback);
 
-  // Extract entities
+  // Analyze only |facets| of content; the result leaves the others empty.
+  // Answered before returning when every facet is cached.
+  void AnalyzeFacets(const std::string& content,
+                     uint32_t facets,
+                     ContentAnalysisCallback callback);
+
+  // Extract entities. This and the three below are AnalyzeFacets() for
+  // their facet and share its cache.
   void ExtractEntities(const std::string& content,
                      base::OnceCallback<void(const std::vector<Entity>&)> callback);
 
@@ -120,30 +152,65 @@ class ContentUnderstanding {
   void SummarizeContent(const std::string& content,
                       base::OnceCallback<void(const ContentSummary&)> callback);
 
-  // Detect language
+  // Detect language locally; |callback| runs before this returns
   void DetectLanguage(const std::string& content,
                     base::OnceCallback<void(const std::string&)> callback);
 
+  // Model requests sent, and facet requests answered from the cache alone
+  size_t GetRequestCount() const { return request_count_; }
+  size_t GetCacheHitCount() const { return cache_hit_count_; }
+
   // Get a weak pointer to this instance
   base::WeakPtr<ContentUnderstanding> GetWeakPtr();
 
- private:
-  // Helper methods
-  void ParseEntityResponse(const std::string& response, 
-                         std::vector<Entity>* entities);
-  
-  void ParseSentimentResponse(const std::string& response, 
-                            SentimentAnalysis* sentiment);
-  
-  void ParseTopicsResponse(const std::string& response, 
-                         std::vector<Topic>* topics);
-  
-  void ParseSummaryResponse(const std::string& response, 
-                          ContentSummary* summary);
-
+ protected:
   // AI service manager
   asol::core::AIServiceManager* ai_service_manager_ = nullptr;
 
+ private:
+  using Key = asol::core::RequestFingerprint;
+  using Waiter = std::pair<uint32_t, ContentAnalysisCallback>;
+
+  // What is known of one content
+  struct Analysis {
+    Key key;
+    // |success| is set and the language detected; holds |facets|
+    ContentAnalysisResult result;
+    uint32_t facets = 0;
+    // Facets of the request in flight, 0 when none is
+    uint32_t pending_facets = 0;
+    // Callers waiting for facets not yet analyzed, and the content to
+    // request them for; empty when none are
+    std::vector<Waiter> waiters;
+    std::string content;
+  };
+  using AnalysisList = std::list<Analysis>;
+
+  // Analyses kept, in-flight ones beyond it included
+  static constexpr size_t kMaxCachedAnalyses = 32;
+
+  // The analysis of |content|, created if there is none, and moved to the
+  // front of the LRU list
+  Analysis& GetAnalysis(const std::string& content);
+
+  // Ask the model for |facets| of |analysis|'s content
+  void RequestFacets(Analysis& analysis, uint32_t facets);
+  void OnFacetsAnalyzed(const Key& key,
+                        uint32_t facets,
+                        bool success,
+                        const std::string& response);
+
+  // Drop least recently used analyses with nothing in flight beyond
+  // kMaxCachedAnalyses
+  void EvictAnalyses();
+
+  // Analyses, most recently used first, and indexed by content hash
+  AnalysisList analyses_;
+  std::unordered_map<Key, AnalysisList::iterator, Key::Hash> analysis_index_;
+
+  size_t request_count_ = 0;
+  size_t cache_hit_count_ = 0;
+
   // For weak pointers
   base::WeakPtrFactory<ContentUnderstanding> weak_ptr_factory_{this};
 };
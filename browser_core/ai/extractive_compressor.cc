@@ -0,0 +1,274 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ai/extractive_compressor.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+
+namespace browser_core {
+namespace ai {
+
+namespace {
+
+// Same ratio as BudgetManager::EstimateTokens()
+constexpr size_t kBytesPerToken = 4;
+
+// PageRank damping factor and stopping rule
+constexpr double kDamping = 0.85;
+constexpr int kMaxIterations = 50;
+constexpr double kConvergence = 1e-4;
+
+// A sentence sharing more than this fraction of its words with one already
+// kept adds little and is skipped
+constexpr double kMaxRedundancy = 0.6;
+
+// Shorter words are mostly function words and say little about the topic
+constexpr size_t kMinWordLength = 3;
+
+struct Sentence {
+  std::string_view text;
+  size_t paragraph = 0;
+
+  // Sorted distinct IDs of its words
+  std::vector<uint32_t> words;
+};
+
+std::vector<Sentence> SplitSentences(std::string_view text) {
+  std::vector<Sentence> sentences;
+  std::vector<std::string_view> paragraphs = base::SplitStringPieceUsingSubstr(
+      text, "\n\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  for (size_t p = 0; p < paragraphs.size(); ++p) {
+    std::string_view paragraph = paragraphs[p];
+    for (std::string_view sentence : base::SplitStringPieceUsingSubstr(
+             paragraph, ". ", base::TRIM_WHITESPACE,
+             base::SPLIT_WANT_NONEMPTY)) {
+      // Keep the period the split removed
+      size_t end = sentence.data() + sentence.size() - paragraph.data();
+      if (end < paragraph.size() && paragraph[end] == '.') {
+        sentence = paragraph.substr(sentence.data() - paragraph.data(),
+                                    sentence.size() + 1);
+      }
+      sentences.push_back({sentence, p, {}});
+    }
+  }
+  return sentences;
+}
+
+// Fill in the word IDs of |sentences|; returns the vocabulary size
+size_t IndexWords(std::vector<Sentence>* sentences) {
+  std::unordered_map<std::string, uint32_t> vocabulary;
+  std::string word;
+  for (Sentence& sentence : *sentences) {
+    auto flush = [&] {
+      if (word.size() >= kMinWordLength) {
+        auto [it, inserted] = vocabulary.try_emplace(
+            word, static_cast<uint32_t>(vocabulary.size()));
+        sentence.words.push_back(it->second);
+      }
+      word.clear();
+    };
+    for (char c : sentence.text) {
+      if (base::IsAsciiAlphaNumeric(c) || (c & 0x80)) {
+        word.push_back(base::ToLowerASCII(c));
+      } else {
+        flush();
+      }
+    }
+    flush();
+    std::sort(sentence.words.begin(), sentence.words.end());
+    sentence.words.erase(
+        std::unique(sentence.words.begin(), sentence.words.end()),
+        sentence.words.end());
+  }
+  return vocabulary.size();
+}
+
+struct Edge {
+  uint32_t to;
+  double weight;
+};
+
+// TextRank edges: sentences sharing words, weighted by the shared count
+// over the log of their lengths. Pairs are found through the sentences
+// each word occurs in, so unrelated pairs cost nothing.
+std::vector<std::vector<Edge>> BuildGraph(const std::vector<Sentence>& sentences,
+                                          size_t vocabulary_size) {
+  std::vector<std::vector<uint32_t>> postings(vocabulary_size);
+  for (size_t i = 0; i < sentences.size(); ++i) {
+    for (uint32_t word : sentences[i].words) {
+      postings[word].push_back(static_cast<uint32_t>(i));
+    }
+  }
+
+  std::vector<std::vector<Edge>> graph(sentences.size());
+  std::vector<uint32_t> shared(sentences.size(), 0);
+  std::vector<uint32_t> touched;
+  for (size_t i = 0; i < sentences.size(); ++i) {
+    touched.clear();
+    for (uint32_t word : sentences[i].words) {
+      for (uint32_t j : postings[word]) {
+        if (j <= i) {
+          continue;
+        }
+        if (shared[j]++ == 0) {
+          touched.push_back(j);
+        }
+      }
+    }
+    for (uint32_t j : touched) {
+      double norm = std::log(1.0 + sentences[i].words.size()) +
+                    std::log(1.0 + sentences[j].words.size());
+      double weight = shared[j] / norm;
+      graph[i].push_back({j, weight});
+      graph[j].push_back({static_cast<uint32_t>(i), weight});
+      shared[j] = 0;
+    }
+  }
+  return graph;
+}
+
+std::vector<double> RankSentences(const std::vector<std::vector<Edge>>& graph) {
+  size_t count = graph.size();
+  std::vector<double> out_weight(count, 0.0);
+  for (size_t i = 0; i < count; ++i) {
+    for (const Edge& edge : graph[i]) {
+      out_weight[i] += edge.weight;
+    }
+  }
+
+  std::vector<double> scores(count, 1.0);
+  std::vector<double> next(count);
+  for (int iteration = 0; iteration < kMaxIterations; ++iteration) {
+    double change = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+      double sum = 0.0;
+      for (const Edge& edge : graph[i]) {
+        sum += edge.weight / out_weight[edge.to] * scores[edge.to];
+      }
+      next[i] = (1.0 - kDamping) + kDamping * sum;
+      change = std::max(change, std::abs(next[i] - scores[i]));
+    }
+    scores.swap(next);
+    if (change < kConvergence) {
+      break;
+    }
+  }
+  return scores;
+}
+
+// Fraction of the shorter sentence's words the two share
+double Overlap(const Sentence& a, const Sentence& b) {
+  if (a.words.empty() || b.words.empty()) {
+    return 0.0;
+  }
+  size_t shared = 0;
+  auto i = a.words.begin();
+  auto j = b.words.begin();
+  while (i != a.words.end() && j != b.words.end()) {
+    if (*i < *j) {
+      ++i;
+    } else if (*j < *i) {
+      ++j;
+    } else {
+      ++shared;
+      ++i;
+      ++j;
+    }
+  }
+  return static_cast<double>(shared) /
+         std::min(a.words.size(), b.words.size());
+}
+
+}  // namespace
+
+// static
+size_t ExtractiveCompressor::EstimateTokens(std::string_view text) {
+  return text.size() / kBytesPerToken + 1;
+}
+
+// static
+ExtractiveCompressor::Result ExtractiveCompressor::Compress(
+    std::string_view text,
+    size_t max_tokens) {
+  Result result;
+  result.original_tokens = EstimateTokens(text);
+
+  std::vector<Sentence> sentences = SplitSentences(text);
+  result.sentence_count = sentences.size();
+  if (result.original_tokens <= max_tokens || sentences.size() < 2) {
+    result.text = std::string(text);
+    result.tokens = result.original_tokens;
+    result.kept_sentence_count = sentences.size();
+    return result;
+  }
+
+  size_t vocabulary_size = IndexWords(&sentences);
+  std::vector<double> scores =
+      RankSentences(BuildGraph(sentences, vocabulary_size));
+
+  std::vector<size_t> order(sentences.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return scores[a] > scores[b];
+  });
+
+  // Take the best sentences that fit; a long one that does not fit may
+  // leave room for shorter ones further down. Sentences that repeat one
+  // already taken only fill what room is left at the end.
+  size_t max_bytes = max_tokens * kBytesPerToken;
+  size_t bytes = 0;
+  std::vector<size_t> kept;
+  std::vector<size_t> redundant;
+  for (size_t index : order) {
+    const Sentence& sentence = sentences[index];
+    if (bytes + sentence.text.size() + 1 > max_bytes) {
+      continue;
+    }
+    bool repeats = std::any_of(kept.begin(), kept.end(), [&](size_t other) {
+      return Overlap(sentence, sentences[other]) > kMaxRedundancy;
+    });
+    if (repeats) {
+      redundant.push_back(index);
+      continue;
+    }
+    kept.push_back(index);
+    bytes += sentence.text.size() + 1;
+  }
+  for (size_t index : redundant) {
+    size_t size = sentences[index].text.size() + 1;
+    if (bytes + size <= max_bytes) {
+      kept.push_back(index);
+      bytes += size;
+    }
+  }
+
+  // Back in reading order, in their paragraphs
+  std::sort(kept.begin(), kept.end());
+  result.text.reserve(bytes + kept.size());
+  for (size_t k = 0; k < kept.size(); ++k) {
+    const Sentence& sentence = sentences[kept[k]];
+    if (k > 0) {
+      result.text += sentences[kept[k - 1]].paragraph == sentence.paragraph
+                         ? " "
+                         : "\n\n";
+    }
+    result.text.append(sentence.text);
+  }
+  result.tokens = EstimateTokens(result.text);
+  result.kept_sentence_count = kept.size();
+  return result;
+}
+
+}  // namespace ai
+}  // namespace browser_core
@@ -0,0 +1,57 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_AI_EXTRACTIVE_COMPRESSOR_H_
+#define BROWSER_CORE_AI_EXTRACTIVE_COMPRESSOR_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+
+namespace browser_core {
+namespace ai {
+
+// ExtractiveCompressor shortens text before it is sent for summarization
+// by keeping its most central sentences, so a remote provider reads fewer
+// input tokens and answers sooner.
+//
+// Sentences are ranked with TextRank: a graph with an edge between every
+// two sentences that share words, weighted by the overlap, and scored by
+// PageRank over it. The best-ranked sentences are taken until the token
+// budget is spent, leaving any that mostly repeat one already taken for
+// whatever room remains, and are put back in their original order and
+// paragraphs.
+//
+// Runs locally and synchronously; the cost grows with the number of
+// sentence pairs that share a word.
+class ExtractiveCompressor {
+ public:
+  struct Result {
+    // |text| itself when it was within the budget
+    std::string text;
+
+    size_t original_tokens = 0;
+    size_t tokens = 0;
+
+    size_t sentence_count = 0;
+    size_t kept_sentence_count = 0;
+
+    bool compressed() const { return kept_sentence_count < sentence_count; }
+  };
+
+  ExtractiveCompressor() = delete;
+
+  // Rough token estimate, as BudgetManager makes it
+  static size_t EstimateTokens(std::string_view text);
+
+  // Keep the sentences of |text| that best represent it within about
+  // |max_tokens|. Text within the budget is returned unchanged.
+  static Result Compress(std::string_view text, size_t max_tokens);
+};
+
+}  // namespace ai
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_AI_EXTRACTIVE_COMPRESSOR_H_
@@ -0,0 +1,224 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ai/language_detector.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/no_destructor.h"
+#include "base/strings/string_util.h"
+#include "base/strings/utf_string_conversions.h"
+
+namespace browser_core {
+namespace ai {
+
+namespace {
+
+// Enough text to tell the language; the rest of a page adds nothing
+constexpr size_t kMaxSampleBytes = 4096;
+
+// Fewer profile trigrams than this in the text is too little to judge
+constexpr int kMinMatchedTrigrams = 8;
+
+// Most frequent trigrams of each language, most frequent first. Words are
+// lowercased and padded with a space on each side.
+struct LanguageProfile {
+  const char* language;
+  std::array<std::u16string_view, 20> trigrams;
+};
+
+constexpr LanguageProfile kProfiles[] = {
+    {"en", {u" th", u"the", u"he ", u"nd ", u" an", u"and", u" of", u"of ",
+            u"ed ", u" to", u"to ", u" in", u"ing", u"ng ", u"ion", u"er ",
+            u"is ", u"tio", u"at ", u"hat"}},
+    {"es", {u" de", u"de ", u"os ", u" la", u"la ", u"el ", u" qu", u"que",
+            u"ue ", u" el", u" en", u"en ", u"ent", u"as ", u"ión", u"ció",
+            u" co", u"nte", u"do ", u"ado"}},
+    {"fr", {u" de", u"es ", u"de ", u"le ", u" le", u"ent", u"nt ", u" la",
+            u"la ", u"les", u"ion", u" et", u"et ", u"des", u" qu", u"que",
+            u"ue ", u" pa", u" d ", u"ait"}},
+    {"de", {u"en ", u"er ", u" de", u"der", u"ie ", u"ein", u" di", u"die",
+            u"ich", u"sch", u"che", u"und", u" un", u"cht", u"den", u"ten",
+            u" ei", u"gen", u"ung", u"nde"}},
+    {"it", {u" di", u"di ", u"la ", u" la", u"to ", u"re ", u"ne ", u"che",
+            u" ch", u"ell", u"lla", u" de", u"del", u"one", u"zio", u" il",
+            u"il ", u"no ", u"per", u" pe"}},
+    {"pt", {u" de", u"de ", u"os ", u"do ", u" qu", u"que", u"da ", u" da",
+            u"ão ", u"ção", u"nte", u" co", u"com", u"em ", u" em", u" do",
+            u"ra ", u"ara", u"ue ", u"ent"}},
+    {"nl", {u"en ", u" de", u"de ", u"an ", u"van", u" va", u"et ", u"een",
+            u" ee", u"het", u" he", u"er ", u"ijk", u" in", u"ing", u"ver",
+            u"aar", u"oor", u"sch", u" ge"}},
+};
+
+// Scripts whose text is taken to be in one language
+enum class Script {
+  kLatin,
+  kCyrillic,
+  kGreek,
+  kHebrew,
+  kArabic,
+  kDevanagari,
+  kThai,
+  kHangul,
+  kKana,
+  kHan,
+  kOther,
+  kCount
+};
+
+constexpr const char* kScriptLanguages[] = {
+    nullptr, "ru", "el", "he", "ar", "hi", "th", "ko", "ja", "zh", nullptr};
+static_assert(std::size(kScriptLanguages) ==
+              static_cast<size_t>(Script::kCount));
+
+// The script of letter |c|, or kOther for anything that is not a letter
+Script GetScript(char16_t c) {
+  if (base::IsAsciiAlpha(c) ||
+      (c >= 0xC0 && c <= 0x24F && c != 0xD7 && c != 0xF7)) {
+    return Script::kLatin;
+  }
+  if (c >= 0x400 && c <= 0x4FF) {
+    return Script::kCyrillic;
+  }
+  if (c >= 0x370 && c <= 0x3FF) {
+    return Script::kGreek;
+  }
+  if (c >= 0x5D0 && c <= 0x5EA) {
+    return Script::kHebrew;
+  }
+  if (c >= 0x620 && c <= 0x64A) {
+    return Script::kArabic;
+  }
+  if (c >= 0x900 && c <= 0x97F) {
+    return Script::kDevanagari;
+  }
+  if (c >= 0xE00 && c <= 0xE7F) {
+    return Script::kThai;
+  }
+  if ((c >= 0xAC00 && c <= 0xD7AF) || (c >= 0x1100 && c <= 0x11FF)) {
+    return Script::kHangul;
+  }
+  if (c >= 0x3040 && c <= 0x30FF) {
+    return Script::kKana;
+  }
+  if (c >= 0x4E00 && c <= 0x9FFF) {
+    return Script::kHan;
+  }
+  return Script::kOther;
+}
+
+char16_t ToLower(char16_t c) {
+  // Latin-1 capitals are 0x20 below their small letters, as in ASCII
+  if (c >= 0xC0 && c <= 0xDE && c != 0xD7) {
+    return c + 0x20;
+  }
+  return base::ToLowerASCII(c);
+}
+
+uint64_t PackTrigram(char16_t a, char16_t b, char16_t c) {
+  return (static_cast<uint64_t>(a) << 32) | (static_cast<uint64_t>(b) << 16) |
+         c;
+}
+
+// For each profile trigram, the profiles it is in and its weight there:
+// highest for the most frequent
+using TrigramIndex =
+    std::unordered_map<uint64_t, std::vector<std::pair<size_t, int>>>;
+
+const TrigramIndex& GetTrigramIndex() {
+  static const base::NoDestructor<TrigramIndex> index([] {
+    TrigramIndex index;
+    for (size_t i = 0; i < std::size(kProfiles); ++i) {
+      const auto& trigrams = kProfiles[i].trigrams;
+      for (size_t rank = 0; rank < trigrams.size(); ++rank) {
+        std::u16string_view trigram = trigrams[rank];
+        index[PackTrigram(trigram[0], trigram[1], trigram[2])].emplace_back(
+            i, static_cast<int>(trigrams.size() - rank));
+      }
+    }
+    return index;
+  }());
+  return *index;
+}
+
+}  // namespace
+
+// static
+std::string LanguageDetector::Detect(std::string_view text) {
+  // A character cut in half at the end decodes as a replacement character
+  std::u16string sample = base::UTF8ToUTF16(text.substr(0, kMaxSampleBytes));
+
+  std::array<int, static_cast<size_t>(Script::kCount)> script_counts = {};
+  // Lowercased Latin words, each followed by one space
+  std::u16string words = u" ";
+  for (char16_t c : sample) {
+    Script script = GetScript(c);
+    ++script_counts[static_cast<size_t>(script)];
+    if (script == Script::kLatin) {
+      words.push_back(ToLower(c));
+    } else if (words.back() != u' ') {
+      words.push_back(u' ');
+    }
+  }
+  if (words.back() != u' ') {
+    words.push_back(u' ');
+  }
+
+  // Mostly another script: judge by the script alone
+  size_t top_script = static_cast<size_t>(Script::kLatin);
+  for (size_t i = 0; i < script_counts.size(); ++i) {
+    if (kScriptLanguages[i] && script_counts[i] > script_counts[top_script]) {
+      top_script = i;
+    }
+  }
+  if (top_script != static_cast<size_t>(Script::kLatin)) {
+    // Japanese mixes kana with Han
+    if (static_cast<Script>(top_script) == Script::kHan &&
+        script_counts[static_cast<size_t>(Script::kKana)] > 0) {
+      return kScriptLanguages[static_cast<size_t>(Script::kKana)];
+    }
+    return kScriptLanguages[top_script];
+  }
+
+  const TrigramIndex& index = GetTrigramIndex();
+  std::array<int, std::size(kProfiles)> scores = {};
+  int matched = 0;
+  for (size_t i = 0; i + 2 < words.size(); ++i) {
+    // Trigrams across a word boundary say nothing about the language
+    if (words[i + 1] == u' ') {
+      continue;
+    }
+    auto it = index.find(PackTrigram(words[i], words[i + 1], words[i + 2]));
+    if (it == index.end()) {
+      continue;
+    }
+    ++matched;
+    for (const auto& [profile, weight] : it->second) {
+      scores[profile] += weight;
+    }
+  }
+  if (matched < kMinMatchedTrigrams) {
+    return kUnknownLanguage;
+  }
+
+  size_t best = 0;
+  for (size_t i = 1; i < scores.size(); ++i) {
+    if (scores[i] > scores[best]) {
+      best = i;
+    }
+  }
+  return kProfiles[best].language;
+}
+
+}  // namespace ai
+}  // namespace browser_core
@@ -0,0 +1,41 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_AI_LANGUAGE_DETECTOR_H_
+#define BROWSER_CORE_AI_LANGUAGE_DETECTOR_H_
+
+#include <string>
+#include <string_view>
+
+namespace browser_core {
+namespace ai {
+
+// LanguageDetector tells which language a page is in without asking a
+// model, so content analysis does not spend a request on it.
+//
+// Text mostly in a non-Latin script is judged by the script: Cyrillic is
+// taken as Russian, Han without kana as Chinese, and so on. Latin text is
+// matched against profiles of the most frequent character trigrams of
+// English, Spanish, French, German, Italian, Portuguese and Dutch; each
+// trigram of the text that is in a profile scores by how high it ranks
+// there, and the best scoring language wins if enough of the text matched.
+//
+// Runs locally and synchronously on at most the first few thousand
+// characters.
+class LanguageDetector {
+ public:
+  // Returned when the text is too short or matches no profile well enough
+  static constexpr char kUnknownLanguage[] = "und";
+
+  LanguageDetector() = delete;
+
+  // ISO 639-1 code of the language |text| is most likely in, or
+  // kUnknownLanguage. |text| is UTF-8.
+  static std::string Detect(std::string_view text);
+};
+
+}  // namespace ai
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_AI_LANGUAGE_DETECTOR_H_
@@ -6,12 +6,18 @@
 
 #include <sstream>
 #include <algorithm>
+#include <bitset>
+#include <cmath>
 #include <utility>
 
+#include "base/base64.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/values.h"
+#include "asol/core/prompt_cache.h"
+#include "asol/core/prompt_template.h"
 
 namespace browser_core {
 namespace ai {
@@ -19,89 +25,188 @@ namespace ai {
 namespace {
 
 // Constants for AI prompts
-constexpr char kVideoAnalysisPrompt[] = 
+constexpr asol::core::PromptTemplate kVideoAnalysisPrompt(
     "Analyze the following video frames and provide a comprehensive understanding of the video content. "
     "Identify objects, scenes, actions, and topics. Generate a summary of the video content. "
-    "\n\nVideo frames (base64 encoded images with timestamps):\n{frames}\n\n"
+    "\n\nVideo frames (attached images with timestamps):\n{frames}\n\n"
     "Format response as JSON with the following fields: "
     "title, description, objects (array of objects with name, description, confidence, bounding_box, start_time, end_time), "
     "scenes (array of objects with description, objects, actions, setting, start_time, end_time), "
-    "topics (array of strings), summary (string).";
+    "topics (array of strings), summary (string).",
+    "frames");
 
-constexpr char kAudioAnalysisPrompt[] = 
+constexpr asol::core::PromptTemplate kAudioAnalysisPrompt(
     "Analyze the following audio data and provide a comprehensive understanding of the content. "
     "Generate a transcript, identify speakers if possible, and create a summary. "
     "\n\nAudio data:\n{audio_data}\n\n"
     "Format response as JSON with the following fields: "
     "title, description, segments (array of objects with speaker, transcript, start_time, end_time, confidence), "
-    "summary (string).";
+    "summary (string).",
+    "audio_data");
 
-// JavaScript for extracting video frames
+constexpr char kTranscriptionPrompt[] =
+    "Transcribe the attached audio clip and identify speakers if possible. "
+    "Format response as JSON with one field: "
+    "segments (array of objects with speaker, transcript, start_time, end_time, confidence), "
+    "times in seconds from the start of the clip.";
+
+// JavaScript for extracting video frames. The video is probed at
+// |probeSeconds| steps on a tiny canvas for a luminance histogram, and a
+// frame is captured only where the histogram differs enough from the last
+// captured one, i.e. at scene changes, or after |maxGapSeconds| without
+// one. Captures are capped per minute of video and downscaled to
+// |maxDimension| before JPEG encoding. Each capture carries a 64-bit
+// difference hash, as 16 hex digits: one bit per pair of horizontally
+// adjacent pixels of a 9x8 grayscale thumbnail, set where the left one is
+// brighter.
 constexpr char kExtractVideoFramesScript[] = R"(
-  (function(videoSelector, intervalSeconds) {
-    return new Promise((resolve, reject) => {
-      const video = document.querySelector(videoSelector);
-      if (!video) {
-        reject('Video element not found');
-        return;
-      }
-      
-      const frames = [];
-      const canvas = document.createElement('canvas');
-      const context = canvas.getContext('2d');
-      
-      // Set canvas size to match video
-      canvas.width = video.videoWidth;
-      canvas.height = video.videoHeight;
-      
-      // Function to capture a frame
-      const captureFrame = (time) => {
+  (async function() {
+    const options = $OPTIONS;
+    const kBins = 32;
+
+    const video = document.querySelector(options.selector);
+    if (!video) {
+      throw new Error('Video element not found');
+    }
+    if (video.readyState < 1) {
+      await new Promise((resolve, reject) => {
+        video.addEventListener('loadedmetadata', resolve, {once: true});
+        video.addEventListener('error', () => reject(
+            new Error('Video failed to load')), {once: true});
+        video.load();
+      });
+    }
+    const duration = video.duration;
+    if (!isFinite(duration) || duration <= 0) {
+      return JSON.stringify([]);
+    }
+
+    const probe = document.createElement('canvas');
+    probe.width = 64;
+    probe.height = 36;
+    const probeContext = probe.getContext('2d', {willReadFrequently: true});
+
+    const thumbnail = document.createElement('canvas');
+    thumbnail.width = 9;
+    thumbnail.height = 8;
+    const thumbnailContext =
+        thumbnail.getContext('2d', {willReadFrequently: true});
+
+    const scale = Math.min(1, options.maxDimension /
+        Math.max(video.videoWidth, video.videoHeight, 1));
+    const output = document.createElement('canvas');
+    output.width = Math.max(1, Math.round(video.videoWidth * scale));
+    output.height = Math.max(1, Math.round(video.videoHeight * scale));
+    const outputContext = output.getContext('2d');
+
+    function seek(time) {
+      return new Promise(resolve => {
+        video.addEventListener('seeked', resolve, {once: true});
         video.currentTime = time;
-        
-        // Wait for the currentTime to actually change
-        const checkTime = () => {
-          if (Math.abs(video.currentTime - time) < 0.1) {
-            // Draw the video frame to the canvas
-            context.drawImage(video, 0, 0, canvas.width, canvas.height);
-            
-            // Convert the canvas to a data URL
-            const dataURL = canvas.toDataURL('image/jpeg', 0.8);
-            
-            frames.push({
-              time: time,
-              data: dataURL.split(',')[1]  // Remove the data URL prefix
-            });
-            
-            // Check if we've captured all frames
-            if (time + intervalSeconds < video.duration) {
-              captureFrame(time + intervalSeconds);
-            } else {
-              resolve(JSON.stringify(frames));
-            }
-          } else {
-            // Check again in a moment
-            setTimeout(checkTime, 100);
-          }
-        };
-        
-        checkTime();
-      };
-      
-      // Start capturing frames
-      video.addEventListener('loadedmetadata', () => {
-        captureFrame(0);
       });
-      
-      // Load the video if it hasn't started loading yet
-      if (video.readyState >= 1) {
-        captureFrame(0);
-      } else {
-        video.load();
+    }
+
+    // Share of pixels per luminance bin
+    function histogram() {
+      probeContext.drawImage(video, 0, 0, probe.width, probe.height);
+      const pixels =
+          probeContext.getImageData(0, 0, probe.width, probe.height).data;
+      const bins = new Float32Array(kBins);
+      for (let i = 0; i < pixels.length; i += 4) {
+        const luma = 0.299 * pixels[i] + 0.587 * pixels[i + 1] +
+                     0.114 * pixels[i + 2];
+        bins[Math.min(kBins - 1, Math.floor(luma * kBins / 256))]++;
       }
-    });
-  })(arguments[0], arguments[1]);
+      const count = pixels.length / 4;
+      for (let b = 0; b < kBins; b++) {
+        bins[b] /= count;
+      }
+      return bins;
+    }
+
+    function differenceHash() {
+      thumbnailContext.drawImage(video, 0, 0, 9, 8);
+      const pixels = thumbnailContext.getImageData(0, 0, 9, 8).data;
+      const luma = i => 0.299 * pixels[i] + 0.587 * pixels[i + 1] +
+                        0.114 * pixels[i + 2];
+      const words = [0, 0];
+      for (let y = 0; y < 8; y++) {
+        for (let x = 0; x < 8; x++) {
+          const i = (y * 9 + x) * 4;
+          const bit = luma(i) > luma(i + 4) ? 1 : 0;
+          words[y >> 2] = ((words[y >> 2] << 1) | bit) >>> 0;
+        }
+      }
+      return words.map(w => w.toString(16).padStart(8, '0')).join('');
+    }
+
+    // 0 for the same histogram, 1 for disjoint ones
+    function difference(a, b) {
+      let sum = 0;
+      for (let i = 0; i < kBins; i++) {
+        sum += Math.abs(a[i] - b[i]);
+      }
+      return sum / 2;
+    }
+
+    const wasPaused = video.paused;
+    const resumeTime = video.currentTime;
+    video.pause();
+
+    const frames = [];
+    const capturedPerMinute = new Map();
+    const step = Math.max(options.probeSeconds, duration / options.maxProbes);
+    let lastBins = null;
+    let lastTime = -Infinity;
+    for (let time = 0; time < duration; time += step) {
+      const minute = Math.floor(time / 60);
+      const captured = capturedPerMinute.get(minute) || 0;
+      if (captured >= options.maxPerMinute) {
+        continue;
+      }
+      await seek(time);
+      const bins = histogram();
+      if (lastBins && time - lastTime < options.maxGapSeconds &&
+          difference(bins, lastBins) < options.sceneThreshold) {
+        continue;
+      }
+      outputContext.drawImage(video, 0, 0, output.width, output.height);
+      frames.push({
+        time: time,
+        hash: differenceHash(),
+        data: output.toDataURL('image/jpeg', options.quality).split(',')[1]
+      });
+      capturedPerMinute.set(minute, captured + 1);
+      lastBins = bins;
+      lastTime = time;
+    }
+
+    video.currentTime = resumeTime;
+    if (!wasPaused) {
+      video.play();
+    }
+    return JSON.stringify(frames);
+  })();
 )";
 
+// Frame sampling: probe step, probes at most per video, histogram
+// difference that marks a scene change, longest stretch without a frame,
+// frames per minute of video, and the longest side and JPEG quality of
+// frames, matching what vision models take in
+constexpr float kFrameProbeSeconds = 0.5f;
+constexpr int kMaxFrameProbes = 600;
+constexpr double kSceneChangeThreshold = 0.3;
+constexpr double kMaxFrameGapSeconds = 30.0;
+constexpr int kMaxFramesPerMinute = 6;
+constexpr int kFrameMaxDimension = 512;
+constexpr double kFrameJpegQuality = 0.7;
+
+// Frames whose difference hashes are this many bits apart or fewer look
+// the same, e.g. a slide with a moving cursor; compared against the last
+// few frames kept so a cut back to an earlier shot is caught too
+constexpr int kMaxDuplicateHashDistance = 6;
+constexpr size_t kDuplicateFrameWindow = 4;
+
 // JavaScript for extracting audio data
 constexpr char kExtractAudioDataScript[] = R"(
   (function(audioSelector) {
@@ -127,9 +232,103 @@ constexpr char kExtractAudioDataScript[] = R"(
       
       resolve(JSON.stringify(audioInfo));
     });
-  })(arguments[0]);
+  })($SELECTOR);
 )";
 
+// JavaScript for extracting one window of audio as 16-bit mono WAV at
+// |sampleRate|, base64 encoded. The media is fetched and decoded, already
+// resampled, once per source; the windows of a transcription share it.
+constexpr char kExtractAudioWindowScript[] = R"(
+  (async function() {
+    const options = $OPTIONS;
+    const media = document.querySelector(options.selector);
+    if (!media) {
+      throw new Error('Media element not found');
+    }
+    const src = media.currentSrc || media.src;
+    const cache = window.__dashaiDecodedAudio ||
+        (window.__dashaiDecodedAudio = {src: null, buffer: null});
+    if (cache.src !== src) {
+      cache.src = src;
+      cache.buffer = fetch(src)
+          .then(response => response.arrayBuffer())
+          .then(bytes => new OfflineAudioContext(1, 1, options.sampleRate)
+              .decodeAudioData(bytes));
+    }
+    const buffer = await cache.buffer;
+
+    const start = Math.min(options.start, buffer.duration);
+    const length = Math.max(1, Math.round(
+        Math.min(options.duration, buffer.duration - start) *
+        options.sampleRate));
+    const context = new OfflineAudioContext(1, length, options.sampleRate);
+    const source = context.createBufferSource();
+    source.buffer = buffer;
+    source.connect(context.destination);
+    source.start(0, start, length / options.sampleRate);
+    const samples = (await context.startRendering()).getChannelData(0);
+
+    const view = new DataView(new ArrayBuffer(44 + samples.length * 2));
+    const writeTag = (offset, tag) => {
+      for (let i = 0; i < 4; i++) {
+        view.setUint8(offset + i, tag.charCodeAt(i));
+      }
+    };
+    writeTag(0, 'RIFF');
+    view.setUint32(4, 36 + samples.length * 2, true);
+    writeTag(8, 'WAVE');
+    writeTag(12, 'fmt ');
+    view.setUint32(16, 16, true);
+    view.setUint16(20, 1, true);
+    view.setUint16(22, 1, true);
+    view.setUint32(24, options.sampleRate, true);
+    view.setUint32(28, options.sampleRate * 2, true);
+    view.setUint16(32, 2, true);
+    view.setUint16(34, 16, true);
+    writeTag(36, 'data');
+    view.setUint32(40, samples.length * 2, true);
+    for (let i = 0; i < samples.length; i++) {
+      const sample = Math.max(-1, Math.min(1, samples[i]));
+      view.setInt16(44 + i * 2, sample < 0 ? sample * 0x8000 : sample * 0x7fff,
+                    true);
+    }
+
+    const bytes = new Uint8Array(view.buffer);
+    let binary = '';
+    for (let i = 0; i < bytes.length; i += 0x8000) {
+      binary += String.fromCharCode.apply(null, bytes.subarray(i, i + 0x8000));
+    }
+    return JSON.stringify({data: btoa(binary)});
+  })();
+)";
+
+// Streaming transcription: window length, overlap with the next window so
+// words cut at a boundary are heard whole by one of them, windows worked
+// on at once, and the sample rate speech models take in
+constexpr double kTranscriptionWindowSeconds = 30.0;
+constexpr double kTranscriptionOverlapSeconds = 2.0;
+constexpr size_t kMaxConcurrentTranscriptionWindows = 4;
+constexpr int kTranscriptionSampleRate = 16000;
+
+using AudioSegment = MultimediaUnderstanding::AudioSegment;
+
+AudioSegment ParseAudioSegment(const base::Value::Dict& dict) {
+  AudioSegment segment;
+  segment.speaker = dict.FindString("speaker").value_or("");
+  segment.transcript = dict.FindString("transcript").value_or("");
+  segment.start_time = dict.FindDouble("start_time").value_or(0.0);
+  segment.end_time = dict.FindDouble("end_time").value_or(0.0);
+  segment.confidence = dict.FindDouble("confidence").value_or(0.0);
+  return segment;
+}
+
+// Line of a full transcript for |segment|
+void AppendTranscriptLine(const AudioSegment& segment,
+                          std::stringstream* transcript) {
+  *transcript << "[" << segment.speaker << " " << segment.start_time << "-"
+              << segment.end_time << "s]: " << segment.transcript << "\n";
+}
+
 }  // namespace
 
 MultimediaUnderstanding::MultimediaUnderstanding() = default;
@@ -159,12 +358,12 @@ void MultimediaUnderstanding::AnalyzeVideoElement(
     return;
   }
   
-  // Extract frames from the video
-  ExtractVideoFrames(web_contents, video_selector, 1.0f,  // Extract a frame every second
+  // Extract frames at scene changes
+  ExtractVideoFrames(web_contents, video_selector, kFrameProbeSeconds,
       base::BindOnce([](
           MultimediaUnderstanding* self,
           VideoAnalysisCallback callback,
-          const std::vector<std::string>& frames) {
+          const std::vector<VideoFrame>& frames) {
         // Analyze the extracted frames
         self->AnalyzeVideoFrames(frames, std::move(callback));
       }, this, std::move(callback)));
@@ -173,15 +372,15 @@ void MultimediaUnderstanding::AnalyzeVideoElement(
 void MultimediaUnderstanding::ExtractVideoFrames(
     WebContents* web_contents,
     const std::string& video_selector,
-    float interval_seconds,
-    base::OnceCallback<void(const std::vector<std::string>&)> callback) {
+    float probe_interval_seconds,
+    base::OnceCallback<void(const std::vector<VideoFrame>&)> callback) {
   // Execute JavaScript to extract video frames
   web_contents->ExecuteJavaScript(
-      GetVideoFrameExtractionScript(),
+      GetVideoFrameExtractionScript(video_selector, probe_interval_seconds),
       base::BindOnce([](
-          base::OnceCallback<void(const std::vector<std::string>&)> callback,
+          base::OnceCallback<void(const std::vector<VideoFrame>&)> callback,
           const WebContents::JavaScriptResult& result) {
-        std::vector<std::string> frames;
+        std::vector<VideoFrame> frames;
         
         if (!result.success) {
           std::move(callback).Run(frames);
@@ -200,11 +399,22 @@ void MultimediaUnderstanding::ExtractVideoFrames(
           if (!item.is_dict()) continue;
           
           const base::Value::Dict& dict = item.GetDict();
-          std::string frame_data = dict.FindString("data").value_or("");
-          
-          if (!frame_data.empty()) {
-            frames.push_back(frame_data);
+          // Base64 only carries the frame across the script boundary;
+          // from here on it is the encoded image itself
+          const std::string* encoded = dict.FindString("data");
+          std::string bytes;
+          if (!encoded || !base::Base64Decode(*encoded, &bytes) ||
+              bytes.empty()) {
+            continue;
           }
+          VideoFrame frame;
+          frame.time_seconds = dict.FindDouble("time").value_or(0.0);
+          frame.data =
+              base::MakeRefCounted<base::RefCountedString>(std::move(bytes));
+          const std::string* hash = dict.FindString("hash");
+          frame.has_perceptual_hash =
+              hash && base::HexStringToUInt64(*hash, &frame.perceptual_hash);
+          frames.push_back(std::move(frame));
         }
         
         std::move(callback).Run(frames);
@@ -212,7 +422,7 @@ void MultimediaUnderstanding::ExtractVideoFrames(
 }
 
 void MultimediaUnderstanding::AnalyzeVideoFrames(
-    const std::vector<std::string>& frame_data,
+    const std::vector<VideoFrame>& frame_data,
     VideoAnalysisCallback callback) {
   // If no frames were provided, return an error
   if (frame_data.empty()) {
@@ -223,28 +433,43 @@ void MultimediaUnderstanding::AnalyzeVideoFrames(
     return;
   }
   
-  // Format the frames for the AI prompt
+  // Only frames that show something new are worth image tokens
+  std::vector<VideoFrame> frames = frame_data;
+  size_t frames_dropped = DropNearDuplicateFrames(
+      &frames, kMaxDuplicateHashDistance, kDuplicateFrameWindow);
+
+  // The frames go as attachments; the prompt only says which is when
+  asol::core::AIServiceManager::AIRequestParams params;
+  params.task_type = asol::core::AIServiceManager::TaskType::IMAGE_ANALYSIS;
+  params.attachments.reserve(frames.size());
   std::stringstream frames_stream;
-  for (size_t i = 0; i < frame_data.size(); ++i) {
-    frames_stream << "Frame " << i << " (time: " << (i * 1.0f) << "s): " 
-                 << frame_data[i].substr(0, 100) << "...\n";
+  for (size_t i = 0; i < frames.size(); ++i) {
+    frames_stream << "Frame " << i << " (time: " << frames[i].time_seconds
+                 << "s): image " << i + 1 << "\n";
+    params.attachments.push_back({frames[i].mime_type, frames[i].data});
   }
-  std::string frames_str = frames_stream.str();
   
   // Prepare the AI prompt
-  std::string prompt = kVideoAnalysisPrompt;
-  base::ReplaceSubstringsAfterOffset(&prompt, 0, "{frames}", frames_str);
+  size_t prefix_length = 0;
+  params.input_text =
+      kVideoAnalysisPrompt.Render({{"frames", frames_stream.str()}},
+                                  &prefix_length);
+  params.custom_params[asol::core::kPromptPrefixLengthParam] =
+      base::NumberToString(prefix_length);
   
   // Request AI analysis
-  ai_service_manager_->GetTextAdapter()->GenerateText(
-      prompt,
+  ai_service_manager_->ProcessRequest(
+      params,
       base::BindOnce([](
           VideoAnalysisCallback callback,
-          const asol::core::TextAdapter::GenerateTextResult& result) {
-        if (!result.success) {
+          size_t frames_analyzed,
+          size_t frames_dropped,
+          bool success,
+          const std::string& response) {
+        if (!success) {
           VideoAnalysisResult error_result;
           error_result.success = false;
-          error_result.error_message = "Failed to generate AI analysis: " + result.error_message;
+          error_result.error_message = "Failed to generate AI analysis: " + response;
           std::move(callback).Run(error_result);
           return;
         }
@@ -252,9 +477,13 @@ void MultimediaUnderstanding::AnalyzeVideoFrames(
         // Parse the AI response
         VideoAnalysisResult analysis_result;
         analysis_result.success = true;
+        analysis_result.metadata["frames_analyzed"] =
+            base::NumberToString(frames_analyzed);
+        analysis_result.metadata["frames_dropped"] =
+            base::NumberToString(frames_dropped);
         
         // Parse JSON response
-        absl::optional<base::Value> json = base::JSONReader::Read(result.text);
+        absl::optional<base::Value> json = base::JSONReader::Read(response);
         if (!json || !json->is_dict()) {
           analysis_result.success = false;
           analysis_result.error_message = "Failed to parse AI response as JSON";
@@ -348,7 +577,44 @@ void MultimediaUnderstanding::AnalyzeVideoFrames(
         }
         
         std::move(callback).Run(analysis_result);
-      }, std::move(callback)));
+      }, std::move(callback), frames.size(), frames_dropped));
+}
+
+// static
+size_t MultimediaUnderstanding::DropNearDuplicateFrames(
+    std::vector<VideoFrame>* frames,
+    int max_distance,
+    size_t window) {
+  size_t kept = 0;
+  for (size_t i = 0; i < frames->size(); ++i) {
+    VideoFrame& frame = (*frames)[i];
+    bool duplicate = false;
+    if (frame.has_perceptual_hash) {
+      size_t recent = 0;
+      for (size_t j = kept; j > 0 && recent < window; --j) {
+        const VideoFrame& previous = (*frames)[j - 1];
+        if (!previous.has_perceptual_hash) {
+          continue;
+        }
+        ++recent;
+        std::bitset<64> differing(frame.perceptual_hash ^
+                                  previous.perceptual_hash);
+        if (static_cast<int>(differing.count()) <= max_distance) {
+          duplicate = true;
+          break;
+        }
+      }
+    }
+    if (!duplicate) {
+      if (kept != i) {
+        (*frames)[kept] = std::move(frame);
+      }
+      ++kept;
+    }
+  }
+  size_t dropped = frames->size() - kept;
+  frames->resize(kept);
+  return dropped;
 }
 
 void MultimediaUnderstanding::AnalyzeAudioElement(
@@ -380,7 +646,7 @@ void MultimediaUnderstanding::ExtractAudioData(
     base::OnceCallback<void(const std::string&)> callback) {
   // Execute JavaScript to extract audio data
   web_contents->ExecuteJavaScript(
-      GetAudioDataExtractionScript(),
+      GetAudioDataExtractionScript(audio_selector),
       base::BindOnce([](
           base::OnceCallback<void(const std::string&)> callback,
           const WebContents::JavaScriptResult& result) {
@@ -402,18 +668,187 @@ void MultimediaUnderstanding::TranscribeAudio(
     return;
   }
   
-  // Extract audio data
+  StreamTranscription(web_contents, audio_selector,
+                      TranscriptSegmentsCallback(), std::move(callback));
+}
+
+MultimediaUnderstanding::Transcription::Transcription() = default;
+MultimediaUnderstanding::Transcription::~Transcription() = default;
+
+void MultimediaUnderstanding::StreamTranscription(
+    WebContents* web_contents,
+    const std::string& audio_selector,
+    TranscriptSegmentsCallback on_segments,
+    base::OnceCallback<void(const std::string&)> callback) {
+  if (!web_contents) {
+    std::move(callback).Run("");
+    return;
+  }
+
+  int id = next_transcription_id_++;
+  auto transcription = std::make_unique<Transcription>();
+  transcription->web_contents = web_contents;
+  transcription->audio_selector = audio_selector;
+  transcription->on_segments = std::move(on_segments);
+  transcription->callback = std::move(callback);
+  transcriptions_[id] = std::move(transcription);
+
+  // The duration decides the windows
   ExtractAudioData(web_contents, audio_selector,
-      base::BindOnce([](
-          MultimediaUnderstanding* self,
-          base::OnceCallback<void(const std::string&)> callback,
-          const std::string& audio_data) {
-        // In a real implementation, this would use speech recognition AI to transcribe
-        // the audio. For now, we'll just return a placeholder.
-        std::string transcript = "This is a placeholder transcript. In a real implementation, "
-                               "this would be generated by a speech recognition AI model.";
-        std::move(callback).Run(transcript);
-      }, this, std::move(callback)));
+      base::BindOnce(&MultimediaUnderstanding::OnTranscriptionMetadata,
+                     weak_ptr_factory_.GetWeakPtr(), id));
+}
+
+void MultimediaUnderstanding::OnTranscriptionMetadata(
+    int transcription_id,
+    const std::string& metadata) {
+  auto it = transcriptions_.find(transcription_id);
+  if (it == transcriptions_.end()) {
+    return;
+  }
+  Transcription* transcription = it->second.get();
+
+  // Non-finite durations, e.g. of live streams, come back as null
+  absl::optional<base::Value> json = base::JSONReader::Read(metadata);
+  double duration = 0.0;
+  if (json && json->is_dict()) {
+    duration = json->GetDict().FindDouble("duration").value_or(0.0);
+  }
+  if (duration <= 0.0) {
+    base::OnceCallback<void(const std::string&)> callback =
+        std::move(transcription->callback);
+    transcriptions_.erase(it);
+    std::move(callback).Run("");
+    return;
+  }
+
+  transcription->window_count = std::max<size_t>(
+      1, static_cast<size_t>(std::ceil(duration / kTranscriptionWindowSeconds)));
+  transcription->segments.resize(transcription->window_count);
+  transcription->done.resize(transcription->window_count);
+  TranscribeNextWindows(transcription_id);
+}
+
+void MultimediaUnderstanding::TranscribeNextWindows(int transcription_id) {
+  Transcription* transcription = transcriptions_[transcription_id].get();
+  while (transcription->in_flight < kMaxConcurrentTranscriptionWindows &&
+         transcription->next_window < transcription->window_count) {
+    size_t window = transcription->next_window++;
+    ++transcription->in_flight;
+    transcription->web_contents->ExecuteJavaScript(
+        GetAudioWindowExtractionScript(
+            transcription->audio_selector,
+            window * kTranscriptionWindowSeconds,
+            kTranscriptionWindowSeconds + kTranscriptionOverlapSeconds),
+        base::BindOnce(&MultimediaUnderstanding::OnWindowAudio,
+                       weak_ptr_factory_.GetWeakPtr(), transcription_id,
+                       window));
+  }
+}
+
+void MultimediaUnderstanding::OnWindowAudio(
+    int transcription_id,
+    size_t window,
+    const WebContents::JavaScriptResult& result) {
+  if (!transcriptions_.count(transcription_id)) {
+    return;
+  }
+  std::string bytes;
+  absl::optional<base::Value> json;
+  if (result.success) {
+    json = base::JSONReader::Read(result.result);
+  }
+  const std::string* encoded =
+      json && json->is_dict() ? json->GetDict().FindString("data") : nullptr;
+  if (!encoded || !base::Base64Decode(*encoded, &bytes)) {
+    CompleteWindow(transcription_id, window, {});
+    return;
+  }
+
+  asol::core::AIServiceManager::AIRequestParams params;
+  params.task_type = asol::core::AIServiceManager::TaskType::CUSTOM;
+  params.input_text = kTranscriptionPrompt;
+  params.attachments.push_back(
+      {"audio/wav",
+       base::MakeRefCounted<base::RefCountedString>(std::move(bytes))});
+  ai_service_manager_->ProcessRequest(
+      params,
+      base::BindOnce(&MultimediaUnderstanding::OnWindowTranscribed,
+                     weak_ptr_factory_.GetWeakPtr(), transcription_id,
+                     window));
+}
+
+void MultimediaUnderstanding::OnWindowTranscribed(
+    int transcription_id,
+    size_t window,
+    bool success,
+    const std::string& response) {
+  std::vector<AudioSegment> segments;
+  absl::optional<base::Value> json;
+  if (success) {
+    json = base::JSONReader::Read(response);
+  }
+  const base::Value::List* segments_list =
+      json && json->is_dict() ? json->GetDict().FindList("segments") : nullptr;
+  if (segments_list) {
+    // Each overlap is heard by two windows; the earlier one keeps what
+    // starts in its first half and the later one the rest
+    double offset = window * kTranscriptionWindowSeconds;
+    double keep_from = window == 0 ? 0.0 : kTranscriptionOverlapSeconds / 2;
+    double keep_until =
+        kTranscriptionWindowSeconds + kTranscriptionOverlapSeconds / 2;
+    for (const auto& item : *segments_list) {
+      if (!item.is_dict()) {
+        continue;
+      }
+      AudioSegment segment = ParseAudioSegment(item.GetDict());
+      if (segment.start_time < keep_from || segment.start_time >= keep_until) {
+        continue;
+      }
+      segment.start_time += offset;
+      segment.end_time += offset;
+      segments.push_back(std::move(segment));
+    }
+  }
+  CompleteWindow(transcription_id, window, std::move(segments));
+}
+
+void MultimediaUnderstanding::CompleteWindow(
+    int transcription_id,
+    size_t window,
+    std::vector<AudioSegment> segments) {
+  auto it = transcriptions_.find(transcription_id);
+  if (it == transcriptions_.end()) {
+    return;
+  }
+  Transcription* transcription = it->second.get();
+  --transcription->in_flight;
+  transcription->segments[window] = std::move(segments);
+  transcription->done[window] = true;
+
+  std::stringstream lines;
+  while (transcription->next_to_emit < transcription->window_count &&
+         transcription->done[transcription->next_to_emit]) {
+    std::vector<AudioSegment> ready =
+        std::move(transcription->segments[transcription->next_to_emit++]);
+    for (const AudioSegment& segment : ready) {
+      AppendTranscriptLine(segment, &lines);
+    }
+    if (!ready.empty() && transcription->on_segments) {
+      transcription->on_segments.Run(ready);
+    }
+  }
+  transcription->transcript += lines.str();
+
+  if (transcription->next_to_emit == transcription->window_count) {
+    std::string transcript = std::move(transcription->transcript);
+    base::OnceCallback<void(const std::string&)> callback =
+        std::move(transcription->callback);
+    transcriptions_.erase(it);
+    std::move(callback).Run(transcript);
+    return;
+  }
+  TranscribeNextWindows(transcription_id);
 }
 
 void MultimediaUnderstanding::ProcessAudioTranscription(
@@ -429,8 +864,8 @@ void MultimediaUnderstanding::ProcessAudioTranscription(
   }
   
   // Prepare the AI prompt
-  std::string prompt = kAudioAnalysisPrompt;
-  base::ReplaceSubstringsAfterOffset(&prompt, 0, "{audio_data}", audio_data);
+  std::string prompt =
+      kAudioAnalysisPrompt.Render({{"audio_data", audio_data}});
   
   // Request AI analysis
   ai_service_manager_->GetTextAdapter()->GenerateText(
@@ -472,25 +907,15 @@ void MultimediaUnderstanding::ProcessAudioTranscription(
           for (const auto& segment : *segments_list) {
             if (!segment.is_dict()) continue;
             
-            const base::Value::Dict& segment_dict = segment.GetDict();
-            
-            AudioSegment audio_segment;
-            audio_segment.speaker = segment_dict.FindString("speaker").value_or("");
-            audio_segment.transcript = segment_dict.FindString("transcript").value_or("");
-            audio_segment.start_time = segment_dict.FindDouble("start_time").value_or(0.0);
-            audio_segment.end_time = segment_dict.FindDouble("end_time").value_or(0.0);
-            audio_segment.confidence = segment_dict.FindDouble("confidence").value_or(0.0);
-            
-            analysis_result.segments.push_back(audio_segment);
+            analysis_result.segments.push_back(
+                ParseAudioSegment(segment.GetDict()));
           }
         }
         
         // Combine all segments into full transcript
         std::stringstream full_transcript;
         for (const auto& segment : analysis_result.segments) {
-          full_transcript << "[" << segment.speaker << " " 
-                         << segment.start_time << "-" << segment.end_time << "s]: "
-                         << segment.transcript << "\n";
+          AppendTranscriptLine(segment, &full_transcript);
         }
         analysis_result.full_transcript = full_transcript.str();
         
@@ -498,12 +923,50 @@ void MultimediaUnderstanding::ProcessAudioTranscription(
       }, std::move(callback)));
 }
 
-const char* MultimediaUnderstanding::GetVideoFrameExtractionScript() {
-  return kExtractVideoFramesScript;
+std::string MultimediaUnderstanding::GetVideoFrameExtractionScript(
+    const std::string& video_selector,
+    float probe_interval_seconds) {
+  base::Value::Dict options;
+  options.Set("selector", video_selector);
+  options.Set("probeSeconds", probe_interval_seconds);
+  options.Set("maxProbes", kMaxFrameProbes);
+  options.Set("sceneThreshold", kSceneChangeThreshold);
+  options.Set("maxGapSeconds", kMaxFrameGapSeconds);
+  options.Set("maxPerMinute", kMaxFramesPerMinute);
+  options.Set("maxDimension", kFrameMaxDimension);
+  options.Set("quality", kFrameJpegQuality);
+  std::string options_json;
+  base::JSONWriter::Write(options, &options_json);
+
+  std::string script = kExtractVideoFramesScript;
+  base::ReplaceSubstringsAfterOffset(&script, 0, "$OPTIONS", options_json);
+  return script;
+}
+
+std::string MultimediaUnderstanding::GetAudioDataExtractionScript(
+    const std::string& audio_selector) {
+  std::string selector_json;
+  base::JSONWriter::Write(base::Value(audio_selector), &selector_json);
+  std::string script = kExtractAudioDataScript;
+  base::ReplaceSubstringsAfterOffset(&script, 0, "$SELECTOR", selector_json);
+  return script;
 }
 
-const char* MultimediaUnderstanding::GetAudioDataExtractionScript() {
-  return kExtractAudioDataScript;
+std::string MultimediaUnderstanding::GetAudioWindowExtractionScript(
+    const std::string& audio_selector,
+    double start_seconds,
+    double duration_seconds) {
+  base::Value::Dict options;
+  options.Set("selector", audio_selector);
+  options.Set("start", start_seconds);
+  options.Set("duration", duration_seconds);
+  options.Set("sampleRate", kTranscriptionSampleRate);
+  std::string options_json;
+  base::JSONWriter::Write(options, &options_json);
+
+  std::string script = kExtractAudioWindowScript;
+  base::ReplaceSubstringsAfterOffset(&script, 0, "$OPTIONS", options_json);
+  return script;
 }
 
 base::WeakPtr<MultimediaUnderstanding> MultimediaUnderstanding::GetWeakPtr() {
@@ -5,12 +5,17 @@
 #ifndef BROWSER_CORE_AI_MULTIMEDIA_UNDERSTANDING_H_
 #define BROWSER_CORE_AI_MULTIMEDIA_UNDERSTANDING_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
 #include "base/callback.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/weak_ptr.h"
 #include "browser_core/ai/content_understanding.h"
 #include "browser_core/engine/web_contents.h"
@@ -34,6 +39,18 @@ class MultimediaUnderstanding : public ContentUnderstanding {
     float end_time;    // Seconds from start of video
   };
 
+  // Frame captured from a video. The encoded image is shared, so frames
+  // are passed on to the AI service without copying.
+  struct VideoFrame {
+    double time_seconds = 0.0;
+    std::string mime_type = "image/jpeg";
+    scoped_refptr<base::RefCountedMemory> data;
+    // 64-bit difference hash of the frame; near-identical frames differ in
+    // few bits
+    uint64_t perceptual_hash = 0;
+    bool has_perceptual_hash = false;
+  };
+
   // Video scene information
   struct VideoScene {
     std::string description;
@@ -85,6 +102,8 @@ class MultimediaUnderstanding : public ContentUnderstanding {
       base::OnceCallback<void(const VideoAnalysisResult&)>;
   using AudioAnalysisCallback = 
       base::OnceCallback<void(const AudioAnalysisResult&)>;
+  using TranscriptSegmentsCallback =
+      base::RepeatingCallback<void(const std::vector<AudioSegment>&)>;
 
   MultimediaUnderstanding();
   ~MultimediaUnderstanding() override;
@@ -111,19 +130,43 @@ class MultimediaUnderstanding : public ContentUnderstanding {
                      const std::string& audio_selector,
                      base::OnceCallback<void(const std::string&)> callback);
 
+  // Transcribe the media at |audio_selector| in short overlapping windows,
+  // several at a time. |on_segments|, if set, receives the segments of
+  // each window, timed from the start of the media, as soon as that window
+  // and all earlier ones are done, so captions start after the first
+  // window rather than the whole media. |callback| gets the full
+  // transcript, or an empty one if the media could not be read.
+  void StreamTranscription(
+      WebContents* web_contents,
+      const std::string& audio_selector,
+      TranscriptSegmentsCallback on_segments,
+      base::OnceCallback<void(const std::string&)> callback);
+
   // Get a weak pointer to this instance
   base::WeakPtr<MultimediaUnderstanding> GetWeakPtr();
 
  private:
   // Helper methods for video analysis
+  // Capture frames at scene changes, probing every
+  // |probe_interval_seconds|, capped per minute and downscaled
   void ExtractVideoFrames(WebContents* web_contents,
                         const std::string& video_selector,
-                        float interval_seconds,
-                        base::OnceCallback<void(const std::vector<std::string>&)> callback);
+                        float probe_interval_seconds,
+                        base::OnceCallback<void(const std::vector<VideoFrame>&)> callback);
 
-  void AnalyzeVideoFrames(const std::vector<std::string>& frame_data,
+  // Analyze the frames of |frame_data| that are not near duplicates of
+  // recent ones. The numbers of frames analyzed and dropped are reported
+  // in the result metadata as "frames_analyzed" and "frames_dropped".
+  void AnalyzeVideoFrames(const std::vector<VideoFrame>& frame_data,
                         VideoAnalysisCallback callback);
 
+  // Remove from |frames| each frame whose perceptual hash is within
+  // |max_distance| bits of one of the last |window| frames kept. Returns
+  // the number of frames removed.
+  static size_t DropNearDuplicateFrames(std::vector<VideoFrame>* frames,
+                                        int max_distance,
+                                        size_t window);
+
   // Helper methods for audio analysis
   void ExtractAudioData(WebContents* web_contents,
                       const std::string& audio_selector,
@@ -132,11 +175,68 @@ class MultimediaUnderstanding : public ContentUnderstanding {
   void ProcessAudioTranscription(const std::string& audio_data,
                                AudioAnalysisCallback callback);
 
-  // JavaScript for extracting video frames
-  static const char* GetVideoFrameExtractionScript();
+  // A StreamTranscription in progress
+  struct Transcription {
+    Transcription();
+    ~Transcription();
+
+    WebContents* web_contents = nullptr;
+    std::string audio_selector;
+    size_t window_count = 0;
+    // Next window to extract, windows extracting or transcribing, and next
+    // window to hand out
+    size_t next_window = 0;
+    size_t in_flight = 0;
+    size_t next_to_emit = 0;
+    // Segments of windows done ahead of an earlier one
+    std::vector<std::vector<AudioSegment>> segments;
+    std::vector<bool> done;
+    std::string transcript;
+    TranscriptSegmentsCallback on_segments;
+    base::OnceCallback<void(const std::string&)> callback;
+  };
 
-  // JavaScript for extracting audio data
-  static const char* GetAudioDataExtractionScript();
+  void OnTranscriptionMetadata(int transcription_id,
+                               const std::string& metadata);
+
+  // Start windows of transcription |transcription_id| up to the
+  // concurrency limit
+  void TranscribeNextWindows(int transcription_id);
+
+  void OnWindowAudio(int transcription_id,
+                     size_t window,
+                     const WebContents::JavaScriptResult& result);
+
+  void OnWindowTranscribed(int transcription_id,
+                           size_t window,
+                           bool success,
+                           const std::string& response);
+
+  // Record |segments| for |window| and hand out the windows now in order.
+  // Finishes the transcription after its last window.
+  void CompleteWindow(int transcription_id,
+                      size_t window,
+                      std::vector<AudioSegment> segments);
+
+  // JavaScript for extracting frames of the video at |video_selector|
+  static std::string GetVideoFrameExtractionScript(
+      const std::string& video_selector,
+      float probe_interval_seconds);
+
+  // JavaScript for extracting metadata of the media at |audio_selector|
+  static std::string GetAudioDataExtractionScript(
+      const std::string& audio_selector);
+
+  // JavaScript for extracting |duration_seconds| of audio from
+  // |start_seconds| of the media at |audio_selector|, as base64 WAV
+  static std::string GetAudioWindowExtractionScript(
+      const std::string& audio_selector,
+      double start_seconds,
+      double duration_seconds);
+
+  // Transcriptions in progress, by id
+  std::map<int, std::unique_ptr<Transcription>> transcriptions_;
+  int next_transcription_id_ = 0;
 
   // For weak pointers
   base::WeakPtrFactory<MultimediaUnderstanding> weak_ptr_factory_{this};
@@ -0,0 +1,225 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ai/page_analysis_queue.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "asol/core/request_scheduler.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/location.h"
+#include "base/power_monitor/power_monitor.h"
+#include "base/time/default_tick_clock.h"
+
+namespace browser_core {
+namespace ai {
+
+PageAnalysisQueue::PageAnalysisQueue(
+    ContentUnderstanding* content_understanding,
+    const Options& options,
+    scoped_refptr<base::SequencedTaskRunner> task_runner)
+    : content_understanding_(content_understanding),
+      options_(options),
+      task_runner_(task_runner
+                       ? std::move(task_runner)
+                       : base::SequencedTaskRunner::GetCurrentDefault()),
+      clock_(base::DefaultTickClock::GetInstance()),
+      interval_(options.min_interval) {
+  on_battery_power_ =
+      base::PowerMonitor::AddPowerStateObserverAndReturnOnBatteryState(this);
+}
+
+PageAnalysisQueue::~PageAnalysisQueue() {
+  base::PowerMonitor::RemovePowerStateObserver(this);
+}
+
+void PageAnalysisQueue::SetRequestScheduler(
+    asol::core::RequestScheduler* scheduler) {
+  request_scheduler_ = scheduler;
+}
+
+void PageAnalysisQueue::AddObserver(Observer* observer) {
+  observers_.AddObserver(observer);
+}
+
+void PageAnalysisQueue::RemoveObserver(Observer* observer) {
+  observers_.RemoveObserver(observer);
+}
+
+void PageAnalysisQueue::Enqueue(const std::string& url,
+                                const std::string& content) {
+  if (url.empty()) {
+    return;
+  }
+  if (const RecentResult* recent = FindRecentResult(url)) {
+    // Observers may enqueue again; hand them a copy
+    ContentUnderstanding::ContentAnalysisResult result = recent->result;
+    NotifyObservers(url, result);
+    return;
+  }
+  if (url == running_url_) {
+    // Its observers hear when the running analysis completes
+    return;
+  }
+
+  auto [it, inserted] = pending_content_.insert_or_assign(url, content);
+  if (inserted) {
+    pending_order_.push_back(url);
+  }
+  if (pending_order_.size() > options_.max_pending) {
+    pending_content_.erase(pending_order_.front());
+    pending_order_.pop_front();
+  }
+  ScheduleNext();
+}
+
+base::TimeDelta PageAnalysisQueue::GetCurrentInterval() const {
+  return on_battery_power_ ? interval_ * options_.battery_interval_factor
+                           : interval_;
+}
+
+void PageAnalysisQueue::OnPowerStateChange(bool on_battery_power) {
+  on_battery_power_ = on_battery_power;
+}
+
+void PageAnalysisQueue::ScheduleNext() {
+  if (!running_url_.empty() || next_armed_ || pending_order_.empty()) {
+    return;
+  }
+  base::TimeDelta delay;
+  if (!last_finish_time_.is_null()) {
+    delay = std::max(base::TimeDelta(), last_finish_time_ +
+                                            GetCurrentInterval() -
+                                            clock_->NowTicks());
+  }
+  next_armed_ = true;
+  task_runner_->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&PageAnalysisQueue::StartNext,
+                     weak_ptr_factory_.GetWeakPtr()),
+      delay);
+}
+
+void PageAnalysisQueue::StartNext() {
+  next_armed_ = false;
+  if (!running_url_.empty() || pending_order_.empty()) {
+    return;
+  }
+  std::string url = std::move(pending_order_.front());
+  pending_order_.pop_front();
+  auto it = pending_content_.find(url);
+  std::string content = std::move(it->second);
+  pending_content_.erase(it);
+  running_url_ = url;
+
+  if (!request_scheduler_) {
+    RunAnalysis(url, content, base::DoNothing());
+    return;
+  }
+  request_scheduler_->Schedule(
+      asol::core::RequestPriority::BACKGROUND,
+      base::BindOnce(&PageAnalysisQueue::RunAnalysis,
+                     weak_ptr_factory_.GetWeakPtr(), url, content),
+      base::BindOnce(&PageAnalysisQueue::OnAnalysisShed,
+                     weak_ptr_factory_.GetWeakPtr(), url, content));
+}
+
+void PageAnalysisQueue::RunAnalysis(const std::string& url,
+                                    const std::string& content,
+                                    base::OnceClosure done) {
+  content_understanding_->AnalyzeContent(
+      content, base::BindOnce(&PageAnalysisQueue::OnAnalysisComplete,
+                              weak_ptr_factory_.GetWeakPtr(), url,
+                              std::move(done)));
+}
+
+void PageAnalysisQueue::OnAnalysisShed(const std::string& url,
+                                       const std::string& content) {
+  // Back to the front, unless a newer visit has queued it already
+  if (pending_content_.emplace(url, content).second) {
+    pending_order_.push_front(url);
+  }
+  FinishAnalysis(/*backed_off=*/true);
+}
+
+void PageAnalysisQueue::OnAnalysisComplete(
+    const std::string& url,
+    base::OnceClosure done,
+    const ContentUnderstanding::ContentAnalysisResult& result) {
+  std::move(done).Run();
+  if (!result.success) {
+    FinishAnalysis(/*backed_off=*/true);
+    return;
+  }
+  AddRecentResult(url, result);
+  FinishAnalysis(/*backed_off=*/IsSchedulerBusy());
+  NotifyObservers(url, result);
+}
+
+void PageAnalysisQueue::FinishAnalysis(bool backed_off) {
+  running_url_.clear();
+  last_finish_time_ = clock_->NowTicks();
+  interval_ = backed_off ? std::min(interval_ * 2, options_.max_interval)
+                         : std::max(interval_ / 2, options_.min_interval);
+  ScheduleNext();
+}
+
+bool PageAnalysisQueue::IsSchedulerBusy() const {
+  if (!request_scheduler_) {
+    return false;
+  }
+  for (asol::core::RequestPriority priority :
+       {asol::core::RequestPriority::INTERACTIVE,
+        asol::core::RequestPriority::PREFETCH}) {
+    if (request_scheduler_->GetRunningCount(priority) > 0 ||
+        request_scheduler_->GetQueuedCount(priority) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const PageAnalysisQueue::RecentResult* PageAnalysisQueue::FindRecentResult(
+    const std::string& url) const {
+  auto it = recent_results_.find(url);
+  if (it == recent_results_.end() ||
+      clock_->NowTicks() - it->second.time > options_.dedup_window) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+void PageAnalysisQueue::AddRecentResult(
+    const std::string& url,
+    const ContentUnderstanding::ContentAnalysisResult& result) {
+  base::TimeTicks now = clock_->NowTicks();
+  recent_results_[url] = {result, now};
+  recent_order_.emplace_back(url, now);
+
+  while (!recent_order_.empty()) {
+    const auto& [oldest_url, time] = recent_order_.front();
+    auto it = recent_results_.find(oldest_url);
+    bool current = it != recent_results_.end() && it->second.time == time;
+    if (current && recent_results_.size() <= options_.max_recent_results) {
+      break;
+    }
+    if (current) {
+      recent_results_.erase(it);
+    }
+    recent_order_.pop_front();
+  }
+}
+
+void PageAnalysisQueue::NotifyObservers(
+    const std::string& url,
+    const ContentUnderstanding::ContentAnalysisResult& result) {
+  for (Observer& observer : observers_) {
+    observer.OnPageAnalyzed(url, result);
+  }
+}
+
+}  // namespace ai
+}  // namespace browser_core
@@ -0,0 +1,178 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_AI_PAGE_ANALYSIS_QUEUE_H_
+#define BROWSER_CORE_AI_PAGE_ANALYSIS_QUEUE_H_
+
+#include <stddef.h>
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/observer_list.h"
+#include "base/observer_list_types.h"
+#include "base/power_monitor/power_observer.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/tick_clock.h"
+#include "base/time/time.h"
+#include "browser_core/ai/content_understanding.h"
+
+namespace asol {
+namespace core {
+class RequestScheduler;
+}  // namespace core
+}  // namespace asol
+
+namespace browser_core {
+namespace ai {
+
+// PageAnalysisQueue runs one content analysis per visited page, topics,
+// entities and summary together, and hands the result to every feature
+// that wants it, so a visit costs one AI analysis however many features
+// observe it.
+//
+// Visits are deduplicated: a page visited again while still queued only has
+// its content replaced, and one analyzed within |dedup_window| is answered
+// from the result kept for it, without new AI work.
+//
+// Analyses run one at a time as background work on the request scheduler,
+// spaced by an interval that adapts: it doubles, up to |max_interval|,
+// whenever an analysis fails or is shed, or user-facing AI work is running
+// or waiting, and halves back toward |min_interval| otherwise. On battery
+// power the interval is multiplied by |battery_interval_factor|. Queued
+// pages beyond |max_pending| are dropped oldest first; they are analyzed on
+// their next visit.
+//
+// Must be used on one sequence.
+class PageAnalysisQueue : public base::PowerStateObserver {
+ public:
+  class Observer : public base::CheckedObserver {
+   public:
+    // |result| was analyzed from the page at |url|. Runs for every visit,
+    // including ones answered from a recent result.
+    virtual void OnPageAnalyzed(
+        const std::string& url,
+        const ContentUnderstanding::ContentAnalysisResult& result) = 0;
+  };
+
+  struct Options {
+    // How long an analysis answers further visits of its page
+    base::TimeDelta dedup_window = base::Minutes(10);
+
+    // Bounds of the spacing between analyses
+    base::TimeDelta min_interval = base::Seconds(1);
+    base::TimeDelta max_interval = base::Minutes(2);
+
+    // Spacing multiplier while on battery power
+    int battery_interval_factor = 4;
+
+    // Pages waiting for analysis
+    size_t max_pending = 32;
+
+    // Recent results kept for deduplication
+    size_t max_recent_results = 64;
+  };
+
+  // |task_runner| defaults to the current sequence's default runner.
+  PageAnalysisQueue(
+      ContentUnderstanding* content_understanding,
+      const Options& options,
+      scoped_refptr<base::SequencedTaskRunner> task_runner = nullptr);
+  ~PageAnalysisQueue() override;
+
+  PageAnalysisQueue(const PageAnalysisQueue&) = delete;
+  PageAnalysisQueue& operator=(const PageAnalysisQueue&) = delete;
+
+  // Run analyses as background work on |scheduler|, and back off while it
+  // has user-facing work. Without a scheduler they run directly.
+  void SetRequestScheduler(asol::core::RequestScheduler* scheduler);
+
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+
+  // Record a visit of |url| with page |content|
+  void Enqueue(const std::string& url, const std::string& content);
+
+  size_t GetPendingCount() const { return pending_order_.size(); }
+
+  // Spacing before the next analysis, battery factor included
+  base::TimeDelta GetCurrentInterval() const;
+
+  // base::PowerStateObserver:
+  void OnPowerStateChange(bool on_battery_power) override;
+
+  void SetTickClockForTesting(const base::TickClock* clock) { clock_ = clock; }
+
+ private:
+  struct RecentResult {
+    ContentUnderstanding::ContentAnalysisResult result;
+    base::TimeTicks time;
+  };
+
+  // Arm the timer for the next queued page, unless one is running or armed
+  void ScheduleNext();
+
+  // Take the oldest queued page and run its analysis
+  void StartNext();
+
+  void RunAnalysis(const std::string& url,
+                   const std::string& content,
+                   base::OnceClosure done);
+  void OnAnalysisShed(const std::string& url, const std::string& content);
+  void OnAnalysisComplete(
+      const std::string& url,
+      base::OnceClosure done,
+      const ContentUnderstanding::ContentAnalysisResult& result);
+
+  // Finish the running analysis and adapt the interval to how it went
+  void FinishAnalysis(bool backed_off);
+
+  // Whether user-facing AI work is running or waiting on the scheduler
+  bool IsSchedulerBusy() const;
+
+  // The recent result for |url| if still within the window
+  const RecentResult* FindRecentResult(const std::string& url) const;
+  void AddRecentResult(
+      const std::string& url,
+      const ContentUnderstanding::ContentAnalysisResult& result);
+
+  void NotifyObservers(
+      const std::string& url,
+      const ContentUnderstanding::ContentAnalysisResult& result);
+
+  ContentUnderstanding* const content_understanding_;
+  const Options options_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  const base::TickClock* clock_;
+  asol::core::RequestScheduler* request_scheduler_ = nullptr;
+
+  // Queued pages by URL, oldest first, with their latest content
+  std::deque<std::string> pending_order_;
+  std::unordered_map<std::string, std::string> pending_content_;
+
+  // Results by URL, and when each was added, oldest first. An order entry
+  // whose time differs from its result's is stale.
+  std::unordered_map<std::string, RecentResult> recent_results_;
+  std::deque<std::pair<std::string, base::TimeTicks>> recent_order_;
+
+  // The page being analyzed, empty when none is
+  std::string running_url_;
+  bool next_armed_ = false;
+  bool on_battery_power_ = false;
+  base::TimeDelta interval_;
+  base::TimeTicks last_finish_time_;
+
+  base::ObserverList<Observer> observers_;
+
+  base::WeakPtrFactory<PageAnalysisQueue> weak_ptr_factory_{this};
+};
+
+}  // namespace ai
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_AI_PAGE_ANALYSIS_QUEUE_H_
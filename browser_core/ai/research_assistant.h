@@ -16,6 +16,7 @@
 #include "asol/core/ai_service_manager.h"
 #include "browser_core/engine/browser_engine.h"
 #include "browser_core/ai/content_understanding.h"
+#include "browser_core/ai/research_synthesis_engine.h"
 
 namespace browser_core {
 namespace ai {
@@ -154,6 +155,19 @@ class ResearchAssistant {
   void DeleteNote(const std::string& note_id,
                 ResearchResultCallback callback);
 
+  // Index sources for synthesis with |processor|'s embedding model. With
+  // it, GenerateSynthesis(), AnswerResearchQuestion() and GenerateOutline()
+  // work from the source chunks relevant to each request, summarized in
+  // parallel, instead of from every source at once; see
+  // ResearchSynthesisEngine. Call after Initialize().
+  void SetLocalAIProcessor(asol::core::LocalAIProcessor* processor) {
+    synthesis_engine_ =
+        processor ? std::make_unique<ResearchSynthesisEngine>(
+                        processor, ai_service_manager_,
+                        ResearchSynthesisEngine::Options())
+                  : nullptr;
+  }
+
   // Research synthesis
   void GenerateSynthesis(const std::string& project_id,
                        SynthesisCallback callback);
@@ -211,6 +225,9 @@ class ResearchAssistant {
   // State
   bool is_enabled_ = true;
 
+  // Retrieves and summarizes source chunks; null without a local processor
+  std::unique_ptr<ResearchSynthesisEngine> synthesis_engine_;
+
   // Private implementation
   class Impl;
   std::unique_ptr<Impl> impl_;
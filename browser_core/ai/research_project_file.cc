@@ -0,0 +1,428 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ai/research_project_file.h"
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "base/files/important_file_writer.h"
+#include "base/logging.h"
+#include "base/memory/page_size.h"
+#include "build/build_config.h"
+
+#if BUILDFLAG(IS_POSIX)
+#include <sys/mman.h>
+#endif
+
+namespace browser_core {
+namespace ai {
+
+namespace {
+
+constexpr uint32_t kFileMagic = 0x4a505241;  // "ARPJ"
+constexpr uint32_t kFileVersion = 1;
+
+// Source bodies start on this boundary, so the pages holding metadata never
+// hold body text
+constexpr size_t kBodyAlignment = 4096;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t source_count;
+  uint32_t note_count;
+  uint64_t list_entry_count;
+  uint64_t bodies_offset;
+};
+
+size_t AlignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+int64_t ToMicroseconds(base::Time time) {
+  return time.ToDeltaSinceWindowsEpoch().InMicroseconds();
+}
+
+base::Time FromMicroseconds(int64_t microseconds) {
+  return base::Time::FromDeltaSinceWindowsEpoch(
+      base::Microseconds(microseconds));
+}
+
+template <typename T>
+void AppendRecord(std::string* data, const T& record) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  data->append(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+}  // namespace
+
+// Bytes [offset, offset + size) of the file
+struct ResearchProjectFile::StringRef {
+  uint64_t offset;
+  uint64_t size;
+};
+
+// Entries [first, first + count) of the string lists
+struct ResearchProjectFile::ListRef {
+  uint32_t first;
+  uint32_t count;
+};
+
+struct ResearchProjectFile::ProjectRecord {
+  StringRef id;
+  StringRef name;
+  StringRef description;
+  int64_t created_time;
+  int64_t last_modified_time;
+};
+
+struct ResearchProjectFile::SourceRecord {
+  StringRef url;
+  StringRef title;
+  StringRef summary;
+  StringRef author;
+  StringRef published_date;
+  StringRef body;
+  ListRef key_points;
+  float relevance_score;
+  uint32_t is_verified;
+  int64_t added_time;
+};
+
+struct ResearchProjectFile::NoteRecord {
+  StringRef id;
+  StringRef project_id;
+  StringRef title;
+  StringRef content;
+  ListRef tags;
+  ListRef related_source_urls;
+  int64_t created_time;
+  int64_t last_modified_time;
+};
+
+// static
+std::unique_ptr<ResearchProjectFile> ResearchProjectFile::Open(
+    const base::FilePath& path) {
+  std::unique_ptr<ResearchProjectFile> file(new ResearchProjectFile());
+  if (!file->mapping_.Initialize(path)) {
+    LOG(ERROR) << "Failed to map research project: " << path.value();
+    return nullptr;
+  }
+  if (!file->Validate()) {
+    LOG(ERROR) << "Malformed research project file: " << path.value();
+    return nullptr;
+  }
+
+  // Bodies are read one at a time, in no particular order; keep readahead
+  // from pulling in neighbours nobody asked for
+#if BUILDFLAG(IS_POSIX)
+  FileHeader header;
+  memcpy(&header, file->mapping_.data(), sizeof(header));
+  size_t bodies_start = AlignUp(header.bodies_offset, base::GetPageSize());
+  if (bodies_start < file->mapping_.length()) {
+    madvise(const_cast<uint8_t*>(file->mapping_.data()) + bodies_start,
+            file->mapping_.length() - bodies_start, MADV_RANDOM);
+  }
+#endif
+  return file;
+}
+
+// static
+bool ResearchProjectFile::Write(const base::FilePath& path,
+                                const ResearchProject& project,
+                                const std::vector<SourceData>& sources,
+                                const std::vector<ResearchNote>& notes) {
+  // Everything before the strings has a known size, so strings can be
+  // given their final offsets as they are added
+  size_t list_entry_count = 0;
+  for (const SourceData& source : sources) {
+    list_entry_count += source.source.key_points.size();
+  }
+  for (const ResearchNote& note : notes) {
+    list_entry_count += note.tags.size() + note.related_source_urls.size();
+  }
+  const size_t strings_offset =
+      sizeof(FileHeader) + sizeof(ProjectRecord) +
+      sources.size() * sizeof(SourceRecord) +
+      notes.size() * sizeof(NoteRecord) + list_entry_count * sizeof(StringRef);
+
+  std::string strings;
+  auto add_string = [&](std::string_view value) {
+    StringRef ref = {strings_offset + strings.size(), value.size()};
+    strings.append(value);
+    return ref;
+  };
+  std::vector<StringRef> lists;
+  lists.reserve(list_entry_count);
+  auto add_list = [&](const std::vector<std::string>& values) {
+    ListRef ref = {static_cast<uint32_t>(lists.size()),
+                   static_cast<uint32_t>(values.size())};
+    for (const std::string& value : values) {
+      lists.push_back(add_string(value));
+    }
+    return ref;
+  };
+
+  ProjectRecord project_record = {};
+  project_record.id = add_string(project.id);
+  project_record.name = add_string(project.name);
+  project_record.description = add_string(project.description);
+  project_record.created_time = ToMicroseconds(project.created_time);
+  project_record.last_modified_time =
+      ToMicroseconds(project.last_modified_time);
+
+  std::vector<SourceRecord> source_records;
+  source_records.reserve(sources.size());
+  for (const SourceData& data : sources) {
+    const ResearchSource& source = data.source;
+    SourceRecord& record = source_records.emplace_back();
+    record.url = add_string(source.url);
+    record.title = add_string(source.title);
+    record.summary = add_string(source.summary);
+    record.author = add_string(source.author);
+    record.published_date = add_string(source.published_date);
+    record.key_points = add_list(source.key_points);
+    record.relevance_score = source.relevance_score;
+    record.is_verified = source.is_verified ? 1 : 0;
+    record.added_time = ToMicroseconds(source.added_time);
+  }
+
+  std::vector<NoteRecord> note_records;
+  note_records.reserve(notes.size());
+  for (const ResearchNote& note : notes) {
+    NoteRecord& record = note_records.emplace_back();
+    record.id = add_string(note.id);
+    record.project_id = add_string(note.project_id);
+    record.title = add_string(note.title);
+    record.content = add_string(note.content);
+    record.tags = add_list(note.tags);
+    record.related_source_urls = add_list(note.related_source_urls);
+    record.created_time = ToMicroseconds(note.created_time);
+    record.last_modified_time = ToMicroseconds(note.last_modified_time);
+  }
+
+  const size_t bodies_offset =
+      AlignUp(strings_offset + strings.size(), kBodyAlignment);
+  size_t end = bodies_offset;
+  for (size_t i = 0; i < sources.size(); ++i) {
+    source_records[i].body = {end, sources[i].body.size()};
+    end += sources[i].body.size();
+  }
+
+  std::string data;
+  data.reserve(end);
+  FileHeader header = {kFileMagic,
+                       kFileVersion,
+                       static_cast<uint32_t>(sources.size()),
+                       static_cast<uint32_t>(notes.size()),
+                       list_entry_count,
+                       bodies_offset};
+  AppendRecord(&data, header);
+  AppendRecord(&data, project_record);
+  for (const SourceRecord& record : source_records) {
+    AppendRecord(&data, record);
+  }
+  for (const NoteRecord& record : note_records) {
+    AppendRecord(&data, record);
+  }
+  for (const StringRef& ref : lists) {
+    AppendRecord(&data, ref);
+  }
+  DCHECK_EQ(data.size(), strings_offset);
+  data += strings;
+  data.resize(bodies_offset, '\0');
+  for (const SourceData& source : sources) {
+    data.append(source.body);
+  }
+  DCHECK_EQ(data.size(), end);
+
+  if (!base::ImportantFileWriter::WriteFileAtomically(path, data)) {
+    LOG(ERROR) << "Failed to write research project: " << path.value();
+    return false;
+  }
+  return true;
+}
+
+ResearchProjectFile::ResearchProjectFile() = default;
+ResearchProjectFile::~ResearchProjectFile() = default;
+
+ResearchProjectFile::ResearchProject ResearchProjectFile::GetProject() const {
+  ProjectRecord record;
+  memcpy(&record, mapping_.data() + sizeof(FileHeader), sizeof(record));
+  ResearchProject project;
+  project.id = std::string(GetString(record.id));
+  project.name = std::string(GetString(record.name));
+  project.description = std::string(GetString(record.description));
+  project.created_time = FromMicroseconds(record.created_time);
+  project.last_modified_time = FromMicroseconds(record.last_modified_time);
+  return project;
+}
+
+std::string_view ResearchProjectFile::GetSourceUrl(size_t index) const {
+  return GetString(GetSourceRecord(index).url);
+}
+
+std::string_view ResearchProjectFile::GetSourceTitle(size_t index) const {
+  return GetString(GetSourceRecord(index).title);
+}
+
+std::string_view ResearchProjectFile::GetSourceBody(size_t index) const {
+  return GetString(GetSourceRecord(index).body);
+}
+
+size_t ResearchProjectFile::FindSource(std::string_view url) const {
+  for (size_t i = 0; i < source_count_; ++i) {
+    if (GetSourceUrl(i) == url) {
+      return i;
+    }
+  }
+  return source_count_;
+}
+
+ResearchProjectFile::ResearchSource ResearchProjectFile::GetSource(
+    size_t index) const {
+  SourceRecord record = GetSourceRecord(index);
+  ResearchSource source;
+  source.url = std::string(GetString(record.url));
+  source.title = std::string(GetString(record.title));
+  source.summary = std::string(GetString(record.summary));
+  source.key_points = GetStringList(record.key_points);
+  source.author = std::string(GetString(record.author));
+  source.published_date = std::string(GetString(record.published_date));
+  source.relevance_score = record.relevance_score;
+  source.is_verified = record.is_verified != 0;
+  source.added_time = FromMicroseconds(record.added_time);
+  return source;
+}
+
+ResearchProjectFile::ResearchNote ResearchProjectFile::GetNote(
+    size_t index) const {
+  NoteRecord record = GetNoteRecord(index);
+  ResearchNote note;
+  note.id = std::string(GetString(record.id));
+  note.project_id = std::string(GetString(record.project_id));
+  note.title = std::string(GetString(record.title));
+  note.content = std::string(GetString(record.content));
+  note.tags = GetStringList(record.tags);
+  note.related_source_urls = GetStringList(record.related_source_urls);
+  note.created_time = FromMicroseconds(record.created_time);
+  note.last_modified_time = FromMicroseconds(record.last_modified_time);
+  return note;
+}
+
+bool ResearchProjectFile::Validate() {
+  const size_t length = mapping_.length();
+  FileHeader header;
+  if (length < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, mapping_.data(), sizeof(header));
+  if (header.magic != kFileMagic || header.version != kFileVersion ||
+      header.bodies_offset > length ||
+      header.list_entry_count > length / sizeof(StringRef)) {
+    return false;
+  }
+
+  source_count_ = header.source_count;
+  note_count_ = header.note_count;
+  list_entry_count_ = static_cast<size_t>(header.list_entry_count);
+  lists_offset_ = sizeof(FileHeader) + sizeof(ProjectRecord) +
+                  source_count_ * sizeof(SourceRecord) +
+                  note_count_ * sizeof(NoteRecord);
+  if (lists_offset_ > length ||
+      list_entry_count_ > (length - lists_offset_) / sizeof(StringRef)) {
+    return false;
+  }
+
+  ProjectRecord project;
+  memcpy(&project, mapping_.data() + sizeof(FileHeader), sizeof(project));
+  if (!IsValid(project.id) || !IsValid(project.name) ||
+      !IsValid(project.description)) {
+    return false;
+  }
+  for (size_t i = 0; i < source_count_; ++i) {
+    SourceRecord record = GetSourceRecord(i);
+    if (!IsValid(record.url) || !IsValid(record.title) ||
+        !IsValid(record.summary) || !IsValid(record.author) ||
+        !IsValid(record.published_date) || !IsValid(record.body) ||
+        !IsValid(record.key_points)) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < note_count_; ++i) {
+    NoteRecord record = GetNoteRecord(i);
+    if (!IsValid(record.id) || !IsValid(record.project_id) ||
+        !IsValid(record.title) || !IsValid(record.content) ||
+        !IsValid(record.tags) || !IsValid(record.related_source_urls)) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < list_entry_count_; ++i) {
+    StringRef ref;
+    memcpy(&ref, mapping_.data() + lists_offset_ + i * sizeof(StringRef),
+           sizeof(ref));
+    if (!IsValid(ref)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ResearchProjectFile::IsValid(const StringRef& ref) const {
+  return ref.offset <= mapping_.length() &&
+         ref.size <= mapping_.length() - ref.offset;
+}
+
+bool ResearchProjectFile::IsValid(const ListRef& ref) const {
+  return ref.first <= list_entry_count_ &&
+         ref.count <= list_entry_count_ - ref.first;
+}
+
+std::string_view ResearchProjectFile::GetString(const StringRef& ref) const {
+  return std::string_view(
+      reinterpret_cast<const char*>(mapping_.data()) + ref.offset,
+      static_cast<size_t>(ref.size));
+}
+
+std::vector<std::string> ResearchProjectFile::GetStringList(
+    const ListRef& ref) const {
+  std::vector<std::string> values;
+  values.reserve(ref.count);
+  for (uint32_t i = 0; i < ref.count; ++i) {
+    StringRef entry;
+    memcpy(&entry,
+           mapping_.data() + lists_offset_ + (ref.first + i) * sizeof(entry),
+           sizeof(entry));
+    values.emplace_back(GetString(entry));
+  }
+  return values;
+}
+
+ResearchProjectFile::SourceRecord ResearchProjectFile::GetSourceRecord(
+    size_t index) const {
+  DCHECK_LT(index, source_count_);
+  SourceRecord record;
+  memcpy(&record,
+         mapping_.data() + sizeof(FileHeader) + sizeof(ProjectRecord) +
+             index * sizeof(SourceRecord),
+         sizeof(record));
+  return record;
+}
+
+ResearchProjectFile::NoteRecord ResearchProjectFile::GetNoteRecord(
+    size_t index) const {
+  DCHECK_LT(index, note_count_);
+  NoteRecord record;
+  memcpy(&record,
+         mapping_.data() + sizeof(FileHeader) + sizeof(ProjectRecord) +
+             source_count_ * sizeof(SourceRecord) +
+             index * sizeof(NoteRecord),
+         sizeof(record));
+  return record;
+}
+
+}  // namespace ai
+}  // namespace browser_core
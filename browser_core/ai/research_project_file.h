@@ -0,0 +1,123 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_AI_RESEARCH_PROJECT_FILE_H_
+#define BROWSER_CORE_AI_RESEARCH_PROJECT_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+#include "browser_core/ai/research_assistant.h"
+
+namespace browser_core {
+namespace ai {
+
+// ResearchProjectFile stores one research project, with its sources and
+// notes, in a compact binary file that is read in place.
+//
+// The file starts with fixed-size records, then the strings they refer
+// to, then the full text of every source, page aligned:
+//
+//   [FileHeader][ProjectRecord][SourceRecord]...[NoteRecord]...
+//   [string lists][strings][pad][source bodies]
+//
+// Records refer to strings by offset and size, so nothing is parsed or
+// copied on open: Open() maps the file and checks that every record and
+// reference is in bounds, which reads the records alone. Strings are read
+// as views into the mapping when asked for, and a source body is only
+// paged in when GetSourceBody() is called for it, so opening a project of
+// hundreds of sources touches a few pages of metadata.
+//
+// The format is versioned; a file of another version or with an
+// out-of-bounds reference fails to open. Values are in the host's byte
+// order.
+//
+// Open() and Write() block on file IO. Once open, the file is immutable
+// and may be read from any thread.
+class ResearchProjectFile {
+ public:
+  using ResearchProject = ResearchAssistant::ResearchProject;
+  using ResearchSource = ResearchAssistant::ResearchSource;
+  using ResearchNote = ResearchAssistant::ResearchNote;
+
+  // Input to Write()
+  struct SourceData {
+    ResearchSource source;
+    // Full text of the source
+    std::string_view body;
+  };
+
+  // Map the project at |path|. Returns null if the file cannot be mapped or
+  // is malformed.
+  static std::unique_ptr<ResearchProjectFile> Open(const base::FilePath& path);
+
+  // Write the project to |path| in this format. The file is replaced
+  // atomically, so a reader never sees it half written.
+  static bool Write(const base::FilePath& path,
+                    const ResearchProject& project,
+                    const std::vector<SourceData>& sources,
+                    const std::vector<ResearchNote>& notes);
+
+  ~ResearchProjectFile();
+
+  ResearchProjectFile(const ResearchProjectFile&) = delete;
+  ResearchProjectFile& operator=(const ResearchProjectFile&) = delete;
+
+  ResearchProject GetProject() const;
+
+  size_t source_count() const { return source_count_; }
+  size_t note_count() const { return note_count_; }
+
+  // Views into the mapping, valid while the file is open
+  std::string_view GetSourceUrl(size_t index) const;
+  std::string_view GetSourceTitle(size_t index) const;
+  std::string_view GetSourceBody(size_t index) const;
+
+  // Index of the source with |url|, or source_count()
+  size_t FindSource(std::string_view url) const;
+
+  // Copies of the metadata of source or note |index|; bodies are left out
+  ResearchSource GetSource(size_t index) const;
+  ResearchNote GetNote(size_t index) const;
+
+  size_t GetMappedBytes() const { return mapping_.length(); }
+
+ private:
+  struct StringRef;
+  struct ListRef;
+  struct ProjectRecord;
+  struct SourceRecord;
+  struct NoteRecord;
+
+  ResearchProjectFile();
+
+  // Check the header and that every reference is in bounds
+  bool Validate();
+  bool IsValid(const StringRef& ref) const;
+  bool IsValid(const ListRef& ref) const;
+
+  std::string_view GetString(const StringRef& ref) const;
+  std::vector<std::string> GetStringList(const ListRef& ref) const;
+  SourceRecord GetSourceRecord(size_t index) const;
+  NoteRecord GetNoteRecord(size_t index) const;
+
+  base::MemoryMappedFile mapping_;
+  size_t source_count_ = 0;
+  size_t note_count_ = 0;
+  // Where the string lists start, in bytes, and their number of entries
+  size_t lists_offset_ = 0;
+  size_t list_entry_count_ = 0;
+};
+
+}  // namespace ai
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_AI_RESEARCH_PROJECT_FILE_H_
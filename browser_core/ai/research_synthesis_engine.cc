@@ -0,0 +1,487 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ai/research_synthesis_engine.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "asol/core/hnsw_index.h"
+#include "asol/core/vector_kernels.h"
+#include "base/barrier_callback.h"
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "browser_core/ai/extractive_compressor.h"
+
+namespace browser_core {
+namespace ai {
+
+namespace {
+
+using asol::core::AIServiceManager;
+
+// Same ratio as ExtractiveCompressor::EstimateTokens()
+constexpr size_t kBytesPerToken = 4;
+
+// "[n] title (url)" for each source cited in |excerpts|, numbered as
+// |numbers| gives
+std::string FormatSources(const std::vector<ResearchSynthesisEngine::Excerpt>&
+                              excerpts,
+                          const std::map<std::string, size_t>& numbers) {
+  std::vector<std::pair<size_t, std::string>> lines;
+  for (const auto& [url, number] : numbers) {
+    auto it = std::find_if(
+        excerpts.begin(), excerpts.end(),
+        [&url](const ResearchSynthesisEngine::Excerpt& excerpt) {
+          return excerpt.url == url;
+        });
+    lines.emplace_back(number, "[" + base::NumberToString(number) + "] " +
+                                   it->title + " (" + url + ")\n");
+  }
+  std::sort(lines.begin(), lines.end());
+  std::string sources;
+  for (const auto& [number, line] : lines) {
+    sources += line;
+  }
+  return sources;
+}
+
+// Excerpts |indices| of |excerpts|, each headed by its source's number
+std::string FormatExcerpts(
+    const std::vector<ResearchSynthesisEngine::Excerpt>& excerpts,
+    const std::vector<size_t>& indices,
+    const std::map<std::string, size_t>& numbers) {
+  std::string text;
+  for (size_t index : indices) {
+    const ResearchSynthesisEngine::Excerpt& excerpt = excerpts[index];
+    text += "[" + base::NumberToString(numbers.at(excerpt.url)) + "] " +
+            excerpt.text + "\n\n";
+  }
+  return text;
+}
+
+}  // namespace
+
+ResearchSynthesisEngine::Chunk::Chunk() = default;
+ResearchSynthesisEngine::Chunk::Chunk(Chunk&&) = default;
+ResearchSynthesisEngine::Chunk& ResearchSynthesisEngine::Chunk::operator=(
+    Chunk&&) = default;
+ResearchSynthesisEngine::Chunk::~Chunk() = default;
+
+ResearchSynthesisEngine::Project::Project() = default;
+ResearchSynthesisEngine::Project::~Project() = default;
+
+ResearchSynthesisEngine::ResearchSynthesisEngine(
+    asol::core::LocalAIProcessor* processor,
+    asol::core::AIServiceManager* ai_service_manager,
+    const Options& options)
+    : processor_(processor),
+      ai_service_manager_(ai_service_manager),
+      options_(options) {}
+
+ResearchSynthesisEngine::~ResearchSynthesisEngine() = default;
+
+void ResearchSynthesisEngine::AddSource(const std::string& project_id,
+                                        const std::string& url,
+                                        const std::string& title,
+                                        const std::string& content,
+                                        base::OnceClosure done) {
+  Project& project = projects_[project_id];
+  Source& source = project.sources[url];
+  RemoveChunks(&project, &source);
+  source.title = title;
+  source.generation = next_generation_++;
+
+  std::vector<std::string> texts =
+      SplitIntoChunks(content, options_.chunk_tokens);
+  if (texts.empty() || !processor_) {
+    if (done) {
+      std::move(done).Run();
+    }
+    return;
+  }
+
+  std::vector<std::string_view> views(texts.begin(), texts.end());
+  processor_->GenerateEmbeddings(
+      views, base::BindOnce(&ResearchSynthesisEngine::OnSourceEmbedded,
+                            weak_ptr_factory_.GetWeakPtr(), project_id, url,
+                            source.generation, std::move(texts),
+                            std::move(done)));
+}
+
+void ResearchSynthesisEngine::RemoveSource(const std::string& project_id,
+                                           const std::string& url) {
+  auto project_it = projects_.find(project_id);
+  if (project_it == projects_.end()) {
+    return;
+  }
+  Project& project = project_it->second;
+  auto source_it = project.sources.find(url);
+  if (source_it == project.sources.end()) {
+    return;
+  }
+  RemoveChunks(&project, &source_it->second);
+  project.sources.erase(source_it);
+}
+
+void ResearchSynthesisEngine::RemoveProject(const std::string& project_id) {
+  projects_.erase(project_id);
+}
+
+void ResearchSynthesisEngine::Retrieve(const std::string& project_id,
+                                       const std::string& query,
+                                       size_t max_chunks,
+                                       RetrieveCallback callback) {
+  auto it = projects_.find(project_id);
+  if (it == projects_.end() || !it->second.index || !processor_ ||
+      max_chunks == 0) {
+    std::move(callback).Run({});
+    return;
+  }
+
+  std::string_view text = query;
+  processor_->GenerateEmbeddings(
+      base::span<const std::string_view>(&text, 1u),
+      base::BindOnce(&ResearchSynthesisEngine::OnQueryEmbedded,
+                     weak_ptr_factory_.GetWeakPtr(), project_id, max_chunks,
+                     std::move(callback)));
+}
+
+void ResearchSynthesisEngine::Synthesize(const std::string& project_id,
+                                         const std::string& question,
+                                         const std::string& instruction,
+                                         SynthesisCallback callback) {
+  Retrieve(project_id, question, options_.max_retrieved_chunks,
+           base::BindOnce(&ResearchSynthesisEngine::OnRetrievedForSynthesis,
+                          weak_ptr_factory_.GetWeakPtr(), project_id,
+                          question, instruction, std::move(callback)));
+}
+
+// static
+std::vector<std::string> ResearchSynthesisEngine::SplitIntoChunks(
+    std::string_view text,
+    size_t max_tokens) {
+  const size_t max_size = std::max<size_t>(max_tokens, 1) * kBytesPerToken;
+  std::vector<std::string> chunks;
+  std::string chunk;
+  auto flush = [&]() {
+    if (!chunk.empty()) {
+      chunks.push_back(std::move(chunk));
+      chunk.clear();
+    }
+  };
+
+  for (std::string_view paragraph : base::SplitStringPiece(
+           text, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    if (chunk.size() + paragraph.size() + 1 > max_size) {
+      flush();
+    }
+    // A paragraph too long for a chunk of its own is cut at spaces
+    while (paragraph.size() > max_size) {
+      size_t cut = paragraph.rfind(' ', max_size);
+      if (cut == std::string_view::npos || cut == 0) {
+        cut = max_size;
+      }
+      chunks.emplace_back(
+          base::TrimWhitespaceASCII(paragraph.substr(0, cut), base::TRIM_ALL));
+      paragraph = base::TrimWhitespaceASCII(paragraph.substr(cut),
+                                            base::TRIM_LEADING);
+    }
+    if (!chunk.empty()) {
+      chunk += '\n';
+    }
+    chunk.append(paragraph);
+  }
+  flush();
+  return chunks;
+}
+
+size_t ResearchSynthesisEngine::GetChunkCount(
+    const std::string& project_id) const {
+  auto it = projects_.find(project_id);
+  return it == projects_.end() ? 0 : it->second.chunks.size();
+}
+
+void ResearchSynthesisEngine::OnSourceEmbedded(
+    std::string project_id,
+    std::string url,
+    uint64_t generation,
+    std::vector<std::string> texts,
+    base::OnceClosure done,
+    asol::core::LocalAIProcessor::EmbeddingBatch batch) {
+  auto project_it = projects_.find(project_id);
+  Project* project =
+      project_it == projects_.end() ? nullptr : &project_it->second;
+  auto source_it = project ? project->sources.find(url)
+                           : std::map<std::string, Source>::iterator();
+  bool current = project && source_it != project->sources.end() &&
+                 source_it->second.generation == generation;
+  if (!current || batch.size() != texts.size()) {
+    if (current) {
+      DLOG(WARNING) << "Failed to embed research source " << url;
+    }
+    if (done) {
+      std::move(done).Run();
+    }
+    return;
+  }
+
+  // A model of another width means the index is stale; start it over, to
+  // be refilled as sources are added again
+  if (project->index &&
+      project->index->options().dimension != batch.dimension) {
+    project->index.reset();
+    project->chunks.clear();
+    for (auto& [other_url, source] : project->sources) {
+      source.chunks.clear();
+    }
+  }
+  if (!project->index) {
+    asol::core::HnswIndex::Options index_options;
+    index_options.dimension = batch.dimension;
+    project->index =
+        std::make_unique<asol::core::HnswIndex>(index_options);
+  }
+
+  Source& source = source_it->second;
+  for (size_t i = 0; i < texts.size(); ++i) {
+    ChunkId id = next_chunk_id_++;
+    if (!project->index->Add(id, batch.row(i))) {
+      continue;
+    }
+    Chunk chunk;
+    chunk.url = url;
+    chunk.text = std::move(texts[i]);
+    chunk.embedding.assign(batch.row(i), batch.row(i) + batch.dimension);
+    project->chunks.emplace(id, std::move(chunk));
+    source.chunks.push_back(id);
+  }
+  if (done) {
+    std::move(done).Run();
+  }
+}
+
+void ResearchSynthesisEngine::OnQueryEmbedded(
+    std::string project_id,
+    size_t max_chunks,
+    RetrieveCallback callback,
+    asol::core::LocalAIProcessor::EmbeddingBatch batch) {
+  auto it = projects_.find(project_id);
+  if (it == projects_.end() || !it->second.index || batch.size() != 1 ||
+      it->second.index->options().dimension != batch.dimension) {
+    std::move(callback).Run({});
+    return;
+  }
+  const Project& project = it->second;
+
+  std::vector<Excerpt> excerpts;
+  for (const asol::core::HnswIndex::Neighbor& neighbor :
+       project.index->Search(batch.row(0), max_chunks)) {
+    auto chunk_it = project.chunks.find(neighbor.id);
+    if (chunk_it == project.chunks.end()) {
+      continue;
+    }
+    const Chunk& chunk = chunk_it->second;
+    Excerpt excerpt;
+    excerpt.url = chunk.url;
+    excerpt.title = project.sources.at(chunk.url).title;
+    excerpt.text = chunk.text;
+    // The index compares quantized vectors; rank by the exact similarity
+    excerpt.similarity = asol::core::DotProduct(
+        chunk.embedding.data(), batch.row(0), batch.dimension);
+    excerpt.chunk_id = neighbor.id;
+    excerpts.push_back(std::move(excerpt));
+  }
+  std::stable_sort(excerpts.begin(), excerpts.end(),
+                   [](const Excerpt& a, const Excerpt& b) {
+                     return a.similarity > b.similarity;
+                   });
+  std::move(callback).Run(std::move(excerpts));
+}
+
+void ResearchSynthesisEngine::OnRetrievedForSynthesis(
+    std::string project_id,
+    std::string question,
+    std::string instruction,
+    SynthesisCallback callback,
+    std::vector<Excerpt> excerpts) {
+  if (excerpts.empty() || !ai_service_manager_) {
+    std::move(callback).Run(false, std::string());
+    return;
+  }
+
+  // Cluster by the stored embeddings of the chunks retrieved. A chunk
+  // removed meanwhile clusters on its own.
+  auto project_it = projects_.find(project_id);
+  std::vector<const Chunk*> chunks;
+  chunks.reserve(excerpts.size());
+  for (const Excerpt& excerpt : excerpts) {
+    const Chunk* chunk = nullptr;
+    if (project_it != projects_.end()) {
+      auto chunk_it = project_it->second.chunks.find(excerpt.chunk_id);
+      if (chunk_it != project_it->second.chunks.end()) {
+        chunk = &chunk_it->second;
+      }
+    }
+    chunks.push_back(chunk);
+  }
+  std::vector<std::vector<size_t>> clusters = Cluster(excerpts, chunks);
+  MapReduce(std::move(question), std::move(instruction), std::move(excerpts),
+            std::move(clusters), std::move(callback));
+}
+
+void ResearchSynthesisEngine::MapReduce(
+    std::string question,
+    std::string instruction,
+    std::vector<Excerpt> excerpts,
+    std::vector<std::vector<size_t>> clusters,
+    SynthesisCallback callback) {
+  // Number the sources in the order they were first retrieved, so the
+  // summaries and the answer cite them alike
+  std::map<std::string, size_t> numbers;
+  for (const std::vector<size_t>& cluster : clusters) {
+    for (size_t index : cluster) {
+      numbers.emplace(excerpts[index].url, numbers.size() + 1);
+    }
+  }
+  std::string sources = FormatSources(excerpts, numbers);
+
+  // One cluster holds everything retrieved; answer from it directly
+  if (clusters.size() == 1) {
+    OnClustersSummarized(
+        std::move(question), std::move(instruction), std::move(sources),
+        std::move(callback),
+        {{0, FormatExcerpts(excerpts, clusters[0], numbers)}});
+    return;
+  }
+
+  auto barrier = base::BarrierCallback<std::pair<size_t, std::string>>(
+      clusters.size(),
+      base::BindOnce(&ResearchSynthesisEngine::OnClustersSummarized,
+                     weak_ptr_factory_.GetWeakPtr(), question, instruction,
+                     std::move(sources), std::move(callback)));
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    AIServiceManager::AIRequestParams params;
+    params.task_type = AIServiceManager::TaskType::TEXT_SUMMARIZATION;
+    params.input_text =
+        "Summarize what the following excerpts say that bears on the "
+        "question below. Keep the [n] source markers on the points they "
+        "support and leave out anything unrelated.\n\nQuestion: " +
+        question + "\n\nExcerpts:\n\n" +
+        FormatExcerpts(excerpts, clusters[i], numbers);
+    ai_service_manager_->ProcessRequest(
+        params, base::BindOnce(
+                    [](size_t index,
+                       base::RepeatingCallback<void(
+                           std::pair<size_t, std::string>)> barrier,
+                       bool success, const std::string& response) {
+                      barrier.Run({index, success ? response : std::string()});
+                    },
+                    i, barrier));
+  }
+}
+
+void ResearchSynthesisEngine::OnClustersSummarized(
+    std::string question,
+    std::string instruction,
+    std::string sources,
+    SynthesisCallback callback,
+    std::vector<std::pair<size_t, std::string>> summaries) {
+  std::sort(summaries.begin(), summaries.end());
+  std::string notes;
+  for (const auto& [index, summary] : summaries) {
+    std::string_view trimmed =
+        base::TrimWhitespaceASCII(summary, base::TRIM_ALL);
+    if (!trimmed.empty()) {
+      notes.append(trimmed);
+      notes += "\n\n";
+    }
+  }
+  if (notes.empty()) {
+    std::move(callback).Run(false, std::string());
+    return;
+  }
+
+  AIServiceManager::AIRequestParams params;
+  params.task_type = AIServiceManager::TaskType::TEXT_GENERATION;
+  params.input_text = instruction + "\n\nQuestion: " + question +
+                      "\n\nNotes from the sources:\n\n" + notes +
+                      "Sources:\n" + sources;
+  ai_service_manager_->ProcessRequest(params, std::move(callback));
+}
+
+std::vector<std::vector<size_t>> ResearchSynthesisEngine::Cluster(
+    const std::vector<Excerpt>& excerpts,
+    const std::vector<const Chunk*>& chunks) const {
+  const size_t max_clusters = std::max<size_t>(options_.max_clusters, 1);
+  std::vector<std::vector<size_t>> clusters;
+  std::vector<size_t> cluster_tokens;
+
+  for (size_t i = 0; i < excerpts.size(); ++i) {
+    size_t tokens = ExtractiveCompressor::EstimateTokens(excerpts[i].text);
+
+    // The most similar cluster with room, going by its first chunk
+    size_t best = clusters.size();
+    float best_similarity = -1.0f;
+    for (size_t c = 0; c < clusters.size(); ++c) {
+      if (cluster_tokens[c] + tokens > options_.max_cluster_tokens) {
+        continue;
+      }
+      const Chunk* leader = chunks[clusters[c].front()];
+      float similarity =
+          leader && chunks[i]
+              ? asol::core::DotProduct(leader->embedding.data(),
+                                       chunks[i]->embedding.data(),
+                                       leader->embedding.size())
+              : 0.0f;
+      if (similarity > best_similarity) {
+        best = c;
+        best_similarity = similarity;
+      }
+    }
+
+    if (best < clusters.size() &&
+        (best_similarity >= options_.cluster_similarity ||
+         clusters.size() == max_clusters)) {
+      clusters[best].push_back(i);
+      cluster_tokens[best] += tokens;
+    } else if (clusters.size() < max_clusters) {
+      clusters.push_back({i});
+      cluster_tokens.push_back(tokens);
+    }
+    // Otherwise every cluster is full; the less similar rest is dropped
+  }
+
+  // Everything fits in one request; no need to summarize first
+  size_t total_tokens = 0;
+  for (size_t tokens : cluster_tokens) {
+    total_tokens += tokens;
+  }
+  if (clusters.size() > 1 && total_tokens <= options_.max_cluster_tokens) {
+    std::vector<size_t> all;
+    for (const std::vector<size_t>& cluster : clusters) {
+      all.insert(all.end(), cluster.begin(), cluster.end());
+    }
+    std::sort(all.begin(), all.end());
+    clusters = {std::move(all)};
+  }
+  return clusters;
+}
+
+// static
+void ResearchSynthesisEngine::RemoveChunks(Project* project, Source* source) {
+  for (ChunkId id : source->chunks) {
+    if (project->index) {
+      project->index->Remove(id);
+    }
+    project->chunks.erase(id);
+  }
+  source->chunks.clear();
+}
+
+}  // namespace ai
+}  // namespace browser_core
@@ -0,0 +1,208 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_AI_RESEARCH_SYNTHESIS_ENGINE_H_
+#define BROWSER_CORE_AI_RESEARCH_SYNTHESIS_ENGINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asol/core/ai_service_manager.h"
+#include "asol/core/local_ai_processor.h"
+#include "base/functional/callback.h"
+#include "base/memory/weak_ptr.h"
+
+namespace asol {
+namespace core {
+class HnswIndex;
+}
+}  // namespace asol
+
+namespace browser_core {
+namespace ai {
+
+// ResearchSynthesisEngine answers questions over the sources of a research
+// project without sending every source to the model, so the time and
+// tokens an answer takes depend on the question rather than on how many
+// sources the project has.
+//
+// Sources are split into chunks of a few hundred tokens, embedded with the
+// on-device model and kept in an HNSW index per project. A question is
+// answered by map-reduce over the chunks nearest it: they are grouped by
+// similarity into a few clusters, each cluster is summarized with respect
+// to the question, all at once, and the summaries are synthesized into
+// the answer in one last request. A question whose chunks fit in one
+// cluster skips the summaries.
+//
+// Must be used on one sequence.
+class ResearchSynthesisEngine {
+ public:
+  struct Options {
+    // Chunks are grown from whole paragraphs up to this size
+    size_t chunk_tokens = 300;
+
+    // Chunks retrieved for a question
+    size_t max_retrieved_chunks = 24;
+
+    // Least cosine similarity to a cluster's first chunk for a chunk to
+    // join it, and the most clusters and tokens per cluster
+    float cluster_similarity = 0.75f;
+    size_t max_clusters = 6;
+    size_t max_cluster_tokens = 1500;
+  };
+
+  // A chunk of a source
+  struct Excerpt {
+    std::string url;
+    std::string title;
+    std::string text;
+    // Cosine similarity to the query
+    float similarity = 0;
+    // Identifies the chunk within its project
+    uint64_t chunk_id = 0;
+  };
+
+  using RetrieveCallback = base::OnceCallback<void(std::vector<Excerpt>)>;
+  using SynthesisCallback =
+      base::OnceCallback<void(bool success, const std::string& response)>;
+
+  // |processor| and |ai_service_manager| are not owned and must outlive
+  // this.
+  ResearchSynthesisEngine(asol::core::LocalAIProcessor* processor,
+                          asol::core::AIServiceManager* ai_service_manager,
+                          const Options& options);
+  ~ResearchSynthesisEngine();
+
+  ResearchSynthesisEngine(const ResearchSynthesisEngine&) = delete;
+  ResearchSynthesisEngine& operator=(const ResearchSynthesisEngine&) = delete;
+
+  // Index |content| as the source at |url| of |project_id|, replacing what
+  // was indexed for it. |done| runs once the chunks are searchable, or
+  // embedding failed.
+  void AddSource(const std::string& project_id,
+                 const std::string& url,
+                 const std::string& title,
+                 const std::string& content,
+                 base::OnceClosure done = base::OnceClosure());
+
+  void RemoveSource(const std::string& project_id, const std::string& url);
+  void RemoveProject(const std::string& project_id);
+
+  // Run |callback| with up to |max_chunks| chunks of |project_id| nearest
+  // |query|, nearest first. Runs it with none if embedding failed.
+  void Retrieve(const std::string& project_id,
+                const std::string& query,
+                size_t max_chunks,
+                RetrieveCallback callback);
+
+  // Answer |question| from the chunks of |project_id| nearest it, following
+  // |instruction| in the final request, e.g. the output format wanted
+  void Synthesize(const std::string& project_id,
+                  const std::string& question,
+                  const std::string& instruction,
+                  SynthesisCallback callback);
+
+  // |text| split at paragraphs, and within long paragraphs at spaces, into
+  // chunks of about |max_tokens|
+  static std::vector<std::string> SplitIntoChunks(std::string_view text,
+                                                  size_t max_tokens);
+
+  size_t GetChunkCount(const std::string& project_id) const;
+
+ private:
+  using ChunkId = uint64_t;
+
+  struct Chunk {
+    Chunk();
+    Chunk(Chunk&&);
+    Chunk& operator=(Chunk&&);
+    ~Chunk();
+
+    std::string url;
+    std::string text;
+    // L2-normalized, for clustering
+    std::vector<float> embedding;
+  };
+
+  struct Source {
+    std::string title;
+    std::vector<ChunkId> chunks;
+    // Moves on with each AddSource(), so a stale embedding is dropped
+    uint64_t generation = 0;
+  };
+
+  struct Project {
+    Project();
+    ~Project();
+
+    // Null until the first source is embedded
+    std::unique_ptr<asol::core::HnswIndex> index;
+    std::unordered_map<ChunkId, Chunk> chunks;
+    std::map<std::string, Source> sources;
+  };
+
+  void OnSourceEmbedded(std::string project_id,
+                        std::string url,
+                        uint64_t generation,
+                        std::vector<std::string> texts,
+                        base::OnceClosure done,
+                        asol::core::LocalAIProcessor::EmbeddingBatch batch);
+
+  void OnQueryEmbedded(std::string project_id,
+                       size_t max_chunks,
+                       RetrieveCallback callback,
+                       asol::core::LocalAIProcessor::EmbeddingBatch batch);
+
+  void OnRetrievedForSynthesis(std::string project_id,
+                               std::string question,
+                               std::string instruction,
+                               SynthesisCallback callback,
+                               std::vector<Excerpt> excerpts);
+
+  // Summarize each cluster of |excerpts| with respect to |question|, then
+  // synthesize the summaries
+  void MapReduce(std::string question,
+                 std::string instruction,
+                 std::vector<Excerpt> excerpts,
+                 std::vector<std::vector<size_t>> clusters,
+                 SynthesisCallback callback);
+
+  void OnClustersSummarized(
+      std::string question,
+      std::string instruction,
+      std::string sources,
+      SynthesisCallback callback,
+      std::vector<std::pair<size_t, std::string>> summaries);
+
+  // Group |excerpts|, nearest the question first, into clusters of indices
+  std::vector<std::vector<size_t>> Cluster(
+      const std::vector<Excerpt>& excerpts,
+      const std::vector<const Chunk*>& chunks) const;
+
+  // Drop the chunks of |source| from |project|
+  static void RemoveChunks(Project* project, Source* source);
+
+  asol::core::LocalAIProcessor* const processor_;
+  asol::core::AIServiceManager* const ai_service_manager_;
+  const Options options_;
+
+  std::map<std::string, Project> projects_;
+  ChunkId next_chunk_id_ = 1;
+  uint64_t next_generation_ = 1;
+
+  base::WeakPtrFactory<ResearchSynthesisEngine> weak_ptr_factory_{this};
+};
+
+}  // namespace ai
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_AI_RESEARCH_SYNTHESIS_ENGINE_H_
@@ -4,18 +4,38 @@
 
 #include "browser_core/ai/summarization_service.h"
 
+#include <stdint.h>
+
 #include <algorithm>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "base/functional/callback_helpers.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/location.h"
+#include "base/memory/ref_counted.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/time.h"
+#include "asol/adapters/adapter_interface.h"
 #include "asol/core/ai_service_manager.h"
+#include "asol/core/ai_service_provider.h"
 #include "asol/core/privacy_proxy.h"
+#include "asol/core/prompt_cache.h"
+#include "asol/core/prompt_template.h"
+#include "asol/core/persistent_response_store.h"
+#include "asol/core/service_manager.h"
+#include "asol/core/startup_trace.h"
+#include "asol/core/token_counter.h"
+#include "asol/core/trace_context.h"
+#include "browser_core/ai/extractive_compressor.h"
+#include "browser_core/ai/summary_cache.h"
 
 namespace browser_core {
 namespace ai {
@@ -26,16 +46,53 @@ namespace {
 constexpr size_t kMinContentLength = 1000;
 
 // Maximum content length for summarization (in characters)
-constexpr size_t kMaxContentLength = 100000;
+constexpr size_t kMaxContentLength = 2000000;
+
+// Longer content is summarized in sections and the section summaries
+// combined, so no request grows with the document
+constexpr size_t kMaxSinglePassContentLength = 24000;
+
+// Target size of one section
+constexpr size_t kChunkLength = 12000;
+
+// Sections of one document requested at a time
+constexpr size_t kMaxChunksInFlight = 6;
+
+// Times section summaries may themselves be summarized in sections before
+// the final combination
+constexpr int kMaxReduceLevels = 2;
+
+// Content tokens sent in one request for each summary length; longer
+// content is cut down to its most representative sentences first
+constexpr size_t kVeryShortContentTokens = 1500;
+constexpr size_t kShortContentTokens = 2500;
+constexpr size_t kMediumContentTokens = 3500;
+constexpr size_t kLongContentTokens = 5000;
+
+// Budget feature summarization requests are charged to
+constexpr char kSummarizationBudgetFeature[] = "summarization";
+
+// Words that occur in more sentences of the content than this do not
+// select the sentences a summary sentence is compared with
+constexpr size_t kMaxCandidatePostings = 64;
+
+// Documents whose source linkers are kept
+constexpr size_t kMaxCachedSourceLinkers = 4;
+
+// Adapter capability streamed summaries are requested from
+constexpr char kSummarizationCapability[] = "summarization";
 
 // Minimum paragraph count for summarization
 constexpr int kMinParagraphCount = 3;
 
-// Maximum cache size
-constexpr size_t kMaxCacheSize = 50;
-
-// Cache expiration time (24 hours)
-constexpr base::TimeDelta kCacheExpirationTime = base::Hours(24);
+SummarizationService::SummaryResult MakeErrorResult(
+    const std::string& message) {
+  SummarizationService::SummaryResult result;
+  result.success = false;
+  result.error_message = message;
+  result.timestamp = base::Time::Now();
+  return result;
+}
 
 // Helper function to count paragraphs in content
 int CountParagraphs(const std::string& content) {
@@ -44,30 +101,69 @@ int CountParagraphs(const std::string& content) {
   return paragraphs.size();
 }
 
-// Helper function to extract paragraphs from content
-std::vector<std::string> ExtractParagraphs(const std::string& content) {
-  return base::SplitString(
-      content, "\n\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+// A sentence of some text, viewed in place
+struct Sentence {
+  std::string_view text;
+  int paragraph_index;
+  int sentence_index;
+};
+
+// Split |text| into paragraphs at blank lines and those into sentences at
+// ". ", keeping each sentence's period
+std::vector<Sentence> SplitSentences(std::string_view text) {
+  std::vector<Sentence> sentences;
+  std::vector<std::string_view> paragraphs = base::SplitStringPieceUsingSubstr(
+      text, "\n\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  for (size_t p = 0; p < paragraphs.size(); ++p) {
+    std::string_view paragraph = paragraphs[p];
+    std::vector<std::string_view> parts = base::SplitStringPieceUsingSubstr(
+        paragraph, ". ", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+    for (size_t s = 0; s < parts.size(); ++s) {
+      std::string_view sentence = parts[s];
+      size_t end = sentence.data() + sentence.size() - paragraph.data();
+      if (end < paragraph.size() && paragraph[end] == '.') {
+        sentence = paragraph.substr(sentence.data() - paragraph.data(),
+                                    sentence.size() + 1);
+      }
+      sentences.push_back(
+          {sentence, static_cast<int>(p), static_cast<int>(s)});
+    }
+  }
+  return sentences;
 }
 
-// Helper function to extract sentences from a paragraph
-std::vector<std::string> ExtractSentences(const std::string& paragraph) {
-  // Simple sentence splitting (can be improved)
-  std::vector<std::string> sentences = base::SplitString(
-      paragraph, ". ", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
-  
-  // Add back the period that was removed during splitting
-  for (size_t i = 0; i < sentences.size() - 1; ++i) {
-    sentences[i] += ".";
+// Lowercase words of |sentence|
+std::vector<std::string> SplitWords(std::string_view sentence) {
+  return base::SplitString(base::ToLowerASCII(sentence), " ",
+                           base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+}
+
+// End of the last complete sentence in text[from, end): just past a line
+// break, or past the space after a period. |from| if there is none.
+size_t FindLastSentenceEnd(std::string_view text, size_t from) {
+  for (size_t i = text.size(); i > from; --i) {
+    if (text[i - 1] == '\n') {
+      return i;
+    }
+    if (text[i - 1] == ' ' && i - 1 > from && text[i - 2] == '.') {
+      return i;
+    }
   }
-  
-  // Check if the last sentence already ends with a period
-  if (!sentences.empty() && !sentences.back().empty() && 
-      sentences.back().back() != '.') {
-    sentences.back() += ".";
+  return from;
+}
+
+// Point the links of a cached summary at |page_url|; the same content may
+// have been summarized at another address
+void RebaseOnPage(const std::string& page_url,
+                  SummarizationService::SummaryResult* result) {
+  for (SummarizationService::SourceLink& link : result->source_links) {
+    size_t fragment = link.url_fragment.find('#');
+    link.url_fragment =
+        page_url + (fragment == std::string::npos
+                        ? std::string()
+                        : link.url_fragment.substr(fragment));
   }
-  
-  return sentences;
+  result->metadata["page_url"] = page_url;
 }
 
 // Helper function to get summary format string
@@ -104,13 +200,318 @@ std::string GetSummaryLengthString(
   return "2-3 paragraphs";  // Default
 }
 
+// Instructions that shape a summary in |format|
+std::string GetFormatInstructions(SummarizationService::SummaryFormat format) {
+  switch (format) {
+    case SummarizationService::SummaryFormat::EXECUTIVE_SUMMARY:
+      return "Focus on the most important points and key takeaways. "
+             "The summary should be concise and informative.\n\n";
+    case SummarizationService::SummaryFormat::BULLET_POINTS:
+      return "Present the main points as bullet points. "
+             "Each bullet point should be clear and self-contained.\n\n";
+    case SummarizationService::SummaryFormat::QA_FORMAT:
+      return "Structure the summary as questions and answers. "
+             "Identify the key questions addressed in the content "
+             "and provide concise answers.\n\n";
+    case SummarizationService::SummaryFormat::TECHNICAL_BRIEF:
+      return "This summary is for experts in the field. "
+             "Use appropriate technical terminology and focus on "
+             "advanced concepts and details.\n\n";
+    case SummarizationService::SummaryFormat::SIMPLIFIED:
+      return "This summary is for beginners. "
+             "Explain concepts in simple terms, avoid jargon, "
+             "and provide context for technical terms.\n\n";
+  }
+  return std::string();
+}
+
+// Prompts put their instructions first and the content last, so the
+// instructions form a prefix providers can cache.
+constexpr asol::core::PromptTemplate kSummaryPrompt(
+    "Please summarize the following content in {format} format with a "
+    "length of {length}.\n\n{instructions}"
+    "Content to summarize:\n\n{content}",
+    "content");
+
+constexpr asol::core::PromptTemplate kChunkPrompt(
+    "The following is one section of a longer document. Summarize its "
+    "key points, facts and conclusions in a few sentences, so they can "
+    "be combined with the summaries of the other sections. Do not add "
+    "an introduction.\n\nSection:\n\n{section}",
+    "section");
+
+constexpr asol::core::PromptTemplate kReducePrompt(
+    "The following are summaries of consecutive sections of one long "
+    "document. Combine them into a single summary of the whole document "
+    "in {format} format with a length of {length}.\n\n{instructions}"
+    "Section summaries:\n\n{summaries}",
+    "summaries");
+
+// Prompt for one section of a long document
+std::string FormatChunkPrompt(std::string_view section) {
+  return kChunkPrompt.Render({{"section", section}});
+}
+
+// Metadata recorded with every summary
+void AddSummaryMetadata(const std::string& page_url,
+                        SummarizationService::SummaryResult* result) {
+  result->metadata["page_url"] = page_url;
+  result->metadata["timestamp"] =
+      std::to_string(result->timestamp.ToDoubleT());
+  result->metadata["format"] = GetSummaryFormatString(result->format);
+  result->metadata["length"] = GetSummaryLengthString(result->length);
+}
+
+size_t GetContentTokenBudget(SummarizationService::SummaryLength length) {
+  switch (length) {
+    case SummarizationService::SummaryLength::VERY_SHORT:
+      return kVeryShortContentTokens;
+    case SummarizationService::SummaryLength::SHORT:
+      return kShortContentTokens;
+    case SummarizationService::SummaryLength::MEDIUM:
+      return kMediumContentTokens;
+    case SummarizationService::SummaryLength::LONG:
+      return kLongContentTokens;
+  }
+  return kMediumContentTokens;
+}
+
+// Report what compressing the content saved with a successful summary
+void AddCompressionMetadata(
+    const ExtractiveCompressor::Result& compressed,
+    base::TimeDelta extraction_time,
+    base::TimeTicks request_start,
+    SummarizationService::SummarizationCallback callback,
+    const SummarizationService::SummaryResult& result) {
+  if (!result.success) {
+    std::move(callback).Run(result);
+    return;
+  }
+  SummarizationService::SummaryResult reported = result;
+  reported.metadata["prompt_tokens_original"] =
+      base::NumberToString(compressed.original_tokens);
+  reported.metadata["prompt_tokens_sent"] =
+      base::NumberToString(compressed.tokens);
+  reported.metadata["prompt_token_reduction"] = base::NumberToString(
+      100 - compressed.tokens * 100 / compressed.original_tokens);
+  reported.metadata["sentences_kept"] =
+      base::NumberToString(compressed.kept_sentence_count) + "/" +
+      base::NumberToString(compressed.sentence_count);
+  reported.metadata["extraction_time_ms"] =
+      base::NumberToString(extraction_time.InMilliseconds());
+  reported.metadata["request_latency_ms"] = base::NumberToString(
+      (base::TimeTicks::Now() - request_start).InMilliseconds());
+  std::move(callback).Run(reported);
+}
+
+// Ends |span| when the summary is reported
+SummarizationService::SummarizationCallback EndSpanOnResult(
+    asol::core::TraceSpan span,
+    SummarizationService::SummarizationCallback callback) {
+  return base::BindOnce(
+      [](asol::core::TraceSpan span,
+         SummarizationService::SummarizationCallback callback,
+         const SummarizationService::SummaryResult& result) {
+        span.End();
+        std::move(callback).Run(result);
+      },
+      std::move(span), std::move(callback));
+}
+
+// Marks the process's first summary text, partial or whole, in the startup
+// trace before |callback| runs; null callbacks stay null
+template <typename... Args>
+base::RepeatingCallback<void(Args...)> MarkFirstSummaryText(
+    base::RepeatingCallback<void(Args...)> callback) {
+  if (!callback || !asol::core::StartupTrace::Get()) {
+    return callback;
+  }
+  return base::BindRepeating(
+      [](const base::RepeatingCallback<void(Args...)>& callback,
+         Args... args) {
+        asol::core::StartupTrace::Get()->AddMarkOnce("first_summary_text");
+        callback.Run(std::forward<Args>(args)...);
+      },
+      std::move(callback));
+}
+
+template <typename... Args>
+base::OnceCallback<void(Args...)> MarkFirstSummaryText(
+    base::OnceCallback<void(Args...)> callback) {
+  if (!callback || !asol::core::StartupTrace::Get()) {
+    return callback;
+  }
+  return base::BindOnce(
+      [](base::OnceCallback<void(Args...)> callback, Args... args) {
+        asol::core::StartupTrace::Get()->AddMarkOnce("first_summary_text");
+        std::move(callback).Run(std::forward<Args>(args)...);
+      },
+      std::move(callback));
+}
+
 }  // namespace
 
+// Indexes the sentences of the original content once, so summaries of it
+// in any format and length, including ones streamed a sentence at a time,
+// are linked without rescanning it.
+//
+// Each word of the content gets an ID, and an inverted index lists the
+// sentences each word occurs in. A summary sentence is compared only with
+// the sentences that share one of its rarer words, so linking costs about
+// the same however long the content is.
+class SummarizationService::SourceLinker
+    : public base::RefCounted<SourceLinker> {
+ public:
+  explicit SourceLinker(asol::core::SharedText original_content)
+      : content_(std::move(original_content)),
+        sentences_(SplitSentences(content_)) {
+    sentence_words_.reserve(sentences_.size());
+    sentence_word_counts_.reserve(sentences_.size());
+    for (size_t i = 0; i < sentences_.size(); ++i) {
+      std::vector<std::string> words = SplitWords(sentences_[i].text);
+      std::vector<int> ids;
+      ids.reserve(words.size());
+      for (std::string& word : words) {
+        auto [it, inserted] = vocabulary_.try_emplace(
+            std::move(word), static_cast<int>(postings_.size()));
+        if (inserted) {
+          postings_.emplace_back();
+        }
+        ids.push_back(it->second);
+      }
+      sentence_word_counts_.push_back(ids.size());
+      std::sort(ids.begin(), ids.end());
+      ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+      for (int id : ids) {
+        postings_[id].push_back(static_cast<uint32_t>(i));
+      }
+      sentence_words_.push_back(std::move(ids));
+    }
+  }
+
+  SourceLinker(const SourceLinker&) = delete;
+  SourceLinker& operator=(const SourceLinker&) = delete;
+
+  // Append a link for each sentence of |summary| that resembles a sentence
+  // of the original content closely enough
+  void Link(std::string_view summary,
+            const std::string& page_url,
+            std::vector<SourceLink>* links) const {
+    std::vector<uint32_t> candidates;
+    for (const Sentence& summary_sentence : SplitSentences(summary)) {
+      // Simple word overlap; a semantic similarity measure would do better
+      std::vector<std::string> summary_words =
+          SplitWords(summary_sentence.text);
+      if (summary_words.empty()) {
+        continue;
+      }
+
+      // Words the content does not have cannot match, but still count
+      // towards the summary sentence's length
+      std::vector<int> summary_ids;
+      const std::vector<uint32_t>* rarest = nullptr;
+      candidates.clear();
+      for (const std::string& word : summary_words) {
+        auto it = vocabulary_.find(word);
+        if (it == vocabulary_.end()) {
+          continue;
+        }
+        summary_ids.push_back(it->second);
+        const std::vector<uint32_t>& sentences = postings_[it->second];
+        if (!rarest || sentences.size() < rarest->size()) {
+          rarest = &sentences;
+        }
+        // Words in many sentences say little about which one this came
+        // from; they still count for the candidates other words find
+        if (sentences.size() <= kMaxCandidatePostings) {
+          candidates.insert(candidates.end(), sentences.begin(),
+                            sentences.end());
+        }
+      }
+      if (!rarest) {
+        continue;
+      }
+      if (candidates.empty()) {
+        candidates = *rarest;
+      }
+      // In content order, so ties go to the earliest sentence
+      std::sort(candidates.begin(), candidates.end());
+      candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                       candidates.end());
+
+      const Sentence* best = nullptr;
+      double best_similarity = 0.0;
+      for (uint32_t index : candidates) {
+        const std::vector<int>& words = sentence_words_[index];
+        int common_words = 0;
+        for (int id : summary_ids) {
+          if (std::binary_search(words.begin(), words.end(), id)) {
+            common_words++;
+          }
+        }
+        double similarity =
+            static_cast<double>(common_words) /
+            std::min(summary_words.size(), sentence_word_counts_[index]);
+        if (similarity > best_similarity) {
+          best_similarity = similarity;
+          best = &sentences_[index];
+        }
+      }
+
+      // Only add links with reasonable similarity
+      if (best && best_similarity > 0.3) {
+        SourceLink link;
+        link.anchor_text = std::string(summary_sentence.text);
+        link.text_snippet = std::string(best->text);
+        link.text_offset = best->text.data() - content_.data();
+        link.text_length = best->text.size();
+        link.paragraph_index = best->paragraph_index;
+        link.sentence_index = best->sentence_index;
+        // Create URL fragment (e.g., #p5s2 for paragraph 5, sentence 2)
+        link.url_fragment = page_url + "#p" +
+                            base::NumberToString(best->paragraph_index + 1) +
+                            "s" +
+                            base::NumberToString(best->sentence_index + 1);
+        links->push_back(std::move(link));
+      }
+    }
+  }
+
+ private:
+  friend class base::RefCounted<SourceLinker>;
+  ~SourceLinker() = default;
+
+  const asol::core::SharedText content_;
+
+  // Sentences of |content_|, viewed in place so each link can say exactly
+  // where its snippet is
+  std::vector<Sentence> sentences_;
+
+  // Sorted distinct word IDs of each sentence, and its number of words
+  std::vector<std::vector<int>> sentence_words_;
+  std::vector<size_t> sentence_word_counts_;
+
+  std::unordered_map<std::string, int> vocabulary_;
+
+  // Sentences each word occurs in, in order, by word ID
+  std::vector<std::vector<uint32_t>> postings_;
+};
+
 SummarizationService::SummarizationService()
-    : weak_ptr_factory_(this) {}
+    : summary_cache_(std::make_unique<SummaryCache>()),
+      weak_ptr_factory_(this) {}
 
 SummarizationService::~SummarizationService() = default;
 
+SummarizationService::ChunkedJob::ChunkedJob() = default;
+SummarizationService::ChunkedJob::~ChunkedJob() = default;
+
+SummarizationService::StreamingJob::StreamingJob() = default;
+SummarizationService::StreamingJob::~StreamingJob() = default;
+
+SummarizationService::ActiveStream::ActiveStream() = default;
+SummarizationService::ActiveStream::~ActiveStream() = default;
+
 bool SummarizationService::Initialize(
     asol::core::AIServiceManager* ai_service_manager,
     asol::core::PrivacyProxy* privacy_proxy) {
@@ -119,40 +520,90 @@ bool SummarizationService::Initialize(
   return (ai_service_manager_ != nullptr && privacy_proxy_ != nullptr);
 }
 
+void SummarizationService::SetRequestScheduler(
+    asol::core::RequestScheduler* scheduler) {
+  request_scheduler_ = scheduler;
+}
+
+void SummarizationService::SetBudgetManager(
+    asol::core::BudgetManager* budget_manager) {
+  budget_manager_ = budget_manager;
+}
+
+void SummarizationService::SetLocalProviderId(const std::string& provider_id) {
+  local_provider_id_ = provider_id;
+}
+
+void SummarizationService::SetStreamingServiceManager(
+    asol::core::ServiceManager* service_manager) {
+  streaming_service_manager_ = service_manager;
+}
+
+void SummarizationService::EnablePersistentCache(const base::FilePath& path,
+                                                 size_t max_bytes) {
+  asol::core::PersistentResponseStore::Options options;
+  options.path = path;
+  options.max_bytes = max_bytes;
+  summary_cache_->SetPersistentStore(
+      std::make_unique<asol::core::PersistentResponseStore>(options));
+}
+
 void SummarizationService::SummarizeContent(
     const std::string& content,
     const std::string& page_url,
     SummaryFormat format,
     SummaryLength length,
     SummarizationCallback callback) {
-  // Check if content is summarizable
-  if (!IsContentSummarizable(content)) {
-    SummaryResult result;
-    result.success = false;
-    result.error_message = "Content is not suitable for summarization";
-    result.timestamp = base::Time::Now();
-    std::move(callback).Run(result);
-    return;
-  }
+  SummarizeContent(content, page_url, format, length,
+                 asol::core::RequestPriority::INTERACTIVE, nullptr,
+                 asol::core::TraceContext(), std::move(callback));
+}
 
-  // Check cache first
-  std::string cache_key = page_url + "_" + 
-                        std::to_string(static_cast<int>(format)) + "_" +
-                        std::to_string(static_cast<int>(length));
-  
-  auto cache_it = summary_cache_.find(cache_key);
-  if (cache_it != summary_cache_.end()) {
-    // Check if cache entry is still valid
-    if (base::Time::Now() - cache_it->second.timestamp < kCacheExpirationTime) {
-      std::move(callback).Run(cache_it->second);
-      return;
-    }
-    // Cache entry expired, remove it
-    summary_cache_.erase(cache_it);
-  }
+void SummarizationService::SummarizeContent(
+    const std::string& content,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    SummarizationCallback callback) {
+  SummarizeContentInternal(content, page_url, format, length, priority,
+                           std::move(cancellation_token), trace,
+                           PartialSummaryCallback(), SummaryDeltaCallback(),
+                           std::move(callback));
+}
 
-  // Process content through privacy proxy first
-  ProcessWithPrivacyProxy(content, page_url, format, length, std::move(callback));
+void SummarizationService::SummarizeLongContent(
+    const std::string& content,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    PartialSummaryCallback on_partial,
+    SummarizationCallback callback) {
+  SummarizeContentInternal(content, page_url, format, length, priority,
+                           std::move(cancellation_token), trace,
+                           std::move(on_partial), SummaryDeltaCallback(),
+                           std::move(callback));
+}
+
+void SummarizationService::SummarizeContentStreaming(
+    const std::string& content,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    SummaryDeltaCallback on_delta,
+    SummarizationCallback callback) {
+  SummarizeContentInternal(content, page_url, format, length, priority,
+                           std::move(cancellation_token), trace,
+                           PartialSummaryCallback(), std::move(on_delta),
+                           std::move(callback));
 }
 
 void SummarizationService::SummarizeContent(
@@ -182,273 +633,823 @@ base::WeakPtr<SummarizationService> SummarizationService::GetWeakPtr() {
   return weak_ptr_factory_.GetWeakPtr();
 }
 
+void SummarizationService::SummarizeContentInternal(
+    const std::string& content,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    PartialSummaryCallback on_partial,
+    SummaryDeltaCallback on_delta,
+    SummarizationCallback callback) {
+  // Every stage of the summary, on every layer down to the provider's
+  // HTTP request, is traced under this span
+  asol::core::TraceSpan span("SummarizationService::Summarize", trace);
+  asol::core::TraceContext summary_trace = span.context();
+  callback = EndSpanOnResult(std::move(span), std::move(callback));
+  on_partial = MarkFirstSummaryText(std::move(on_partial));
+  on_delta = MarkFirstSummaryText(std::move(on_delta));
+  callback = MarkFirstSummaryText(std::move(callback));
+
+  // Check if content is summarizable
+  if (!IsContentSummarizable(content)) {
+    std::move(callback).Run(
+        MakeErrorResult("Content is not suitable for summarization"));
+    return;
+  }
+
+  // Check cache first
+  std::string cache_key = SummaryCache::ComputeKey(content, format, length);
+  SummaryResult cached;
+  if (summary_cache_->Get(cache_key, &cached)) {
+    RebaseOnPage(page_url, &cached);
+    if (on_delta) {
+      SummaryDelta delta;
+      delta.text = cached.summary_text;
+      delta.source_links = cached.source_links;
+      on_delta.Run(delta);
+    }
+    std::move(callback).Run(cached);
+    return;
+  }
+
+  // Process content through privacy proxy first
+  ProcessWithPrivacyProxy(content, page_url, format, length, cache_key,
+                        priority, std::move(cancellation_token), summary_trace,
+                        std::move(on_partial), std::move(on_delta),
+                        std::move(callback));
+}
+
 void SummarizationService::ProcessWithPrivacyProxy(
     const std::string& content,
     const std::string& page_url,
     SummaryFormat format,
     SummaryLength length,
+    const std::string& cache_key,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    PartialSummaryCallback on_partial,
+    SummaryDeltaCallback on_delta,
     SummarizationCallback callback) {
   // Use privacy proxy to redact any PII before sending to AI service
   privacy_proxy_->ProcessText(
       content,
       base::BindOnce(
           [](base::WeakPtr<SummarizationService> self,
-             const std::string& original_content,
              const std::string& page_url,
              SummaryFormat format,
              SummaryLength length,
+             const std::string& cache_key,
+             asol::core::RequestPriority priority,
+             scoped_refptr<asol::core::CancellationToken> cancellation_token,
+             const asol::core::TraceContext& trace,
+             PartialSummaryCallback on_partial,
+             SummaryDeltaCallback on_delta,
              SummarizationCallback callback,
              const asol::core::PrivacyProxy::ProcessingResult& privacy_result) {
             if (!self)
               return;
+
+            // Too long for one request: summarize it in sections
+            if (privacy_result.processed_text.size() >
+                kMaxSinglePassContentLength) {
+              self->StartChunkedSummary(
+                  privacy_result.processed_text, page_url, format, length,
+                  cache_key, priority, std::move(cancellation_token), trace,
+                  std::move(on_partial), std::move(on_delta),
+                  std::move(callback));
+              return;
+            }
             
             self->ProcessWithAIService(
                 privacy_result.processed_text,
                 page_url,
                 format,
                 length,
+                cache_key,
+                priority,
+                std::move(cancellation_token),
+                trace,
+                std::move(on_delta),
                 std::move(callback));
           },
           weak_ptr_factory_.GetWeakPtr(),
-          content,  // Keep original content for source link generation
           page_url,
           format,
           length,
-          std::move(callback)));
+          cache_key,
+          priority,
+          std::move(cancellation_token),
+          trace,
+          std::move(on_partial),
+          std::move(on_delta),
+          std::move(callback)),
+      trace);
 }
 
 void SummarizationService::ProcessWithAIService(
-    const std::string& processed_content,
+    const asol::core::SharedText& processed_content,
     const std::string& page_url,
     SummaryFormat format,
     SummaryLength length,
+    const std::string& cache_key,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    SummaryDeltaCallback on_delta,
     SummarizationCallback callback) {
+  // Send only as much of the content as the summary length calls for.
+  // Source links still point into the whole content.
+  base::TimeTicks start = base::TimeTicks::Now();
+  ExtractiveCompressor::Result compressed = ExtractiveCompressor::Compress(
+      processed_content, GetContentTokenBudget(length));
+  base::TimeTicks extracted = base::TimeTicks::Now();
+
   // Format the prompt for the AI service
-  std::string prompt = FormatSummaryPrompt(processed_content, format, length);
+  std::string prompt = FormatSummaryPrompt(compressed.text, format, length);
+  size_t prefix_length = prompt.size() - compressed.text.size();
+
+  if (compressed.compressed()) {
+    callback = base::BindOnce(&AddCompressionMetadata, std::move(compressed),
+                              extracted - start, extracted, std::move(callback));
+  }
+
+  RequestFinalSummary(
+      MakeRequestParams(std::move(prompt), prefix_length, page_url, format,
+                        length, priority, std::move(cancellation_token),
+                        trace),
+      priority, processed_content, page_url, format, length, cache_key,
+      std::move(on_delta), std::move(callback));
+}
 
-  // Prepare request parameters
+asol::core::AIServiceManager::AIRequestParams
+SummarizationService::MakeRequestParams(
+    std::string prompt,
+    size_t prompt_prefix_length,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace) const {
   asol::core::AIServiceManager::AIRequestParams params;
   params.task_type = asol::core::AIServiceManager::TaskType::TEXT_SUMMARIZATION;
-  params.input_text = prompt;
+  params.input_text = std::move(prompt);
   
   // Add metadata about the summary request
   params.custom_params["summary_format"] = GetSummaryFormatString(format);
   params.custom_params["summary_length"] = GetSummaryLengthString(length);
   params.custom_params["page_url"] = page_url;
+  params.custom_params[asol::core::kRequestPriorityParam] =
+      asol::core::RequestPriorityToString(priority);
+  params.custom_params[asol::core::kBudgetFeatureParam] =
+      kSummarizationBudgetFeature;
+  // Everything before the content is the same for every page summarized
+  // with this format and length, so providers can serve it from cache
+  params.custom_params[asol::core::kPromptPrefixLengthParam] =
+      base::NumberToString(prompt_prefix_length);
+  params.cancellation_token = std::move(cancellation_token);
+  params.trace = trace;
+  return params;
+}
+
+void SummarizationService::RequestSummary(
+    asol::core::AIServiceManager::AIRequestParams params,
+    asol::core::RequestPriority priority,
+    SummarizationCallback on_error,
+    TextCallback on_text,
+    ResponseCallback on_response) {
+  // The page went away while the content was being redacted; do not spend
+  // budget on it
+  if (params.cancellation_token && params.cancellation_token->IsCancelled()) {
+    std::move(on_error).Run(
+        MakeErrorResult(asol::core::kRequestCancelledError));
+    return;
+  }
+
+  if (budget_manager_) {
+    // There is no cheaper route from here, so a downgrade goes out as is.
+    // Once only local work is allowed the on-device model summarizes, free.
+    asol::core::BudgetScope scope{std::string(), kSummarizationBudgetFeature};
+    double cost = EstimateCost(params.provider_id, params.input_text);
+    asol::core::BudgetManager::Decision decision =
+        budget_manager_->Evaluate(scope, cost, priority);
+    if (decision == asol::core::BudgetManager::Decision::LOCAL_ONLY &&
+        !local_provider_id_.empty()) {
+      params.provider_id = local_provider_id_;
+    } else if (decision == asol::core::BudgetManager::Decision::REJECT ||
+               decision == asol::core::BudgetManager::Decision::LOCAL_ONLY) {
+      std::move(on_error).Run(
+          MakeErrorResult("Daily summarization budget reached"));
+      return;
+    } else {
+      budget_manager_->RecordSpend(scope, cost);
+    }
+  }
+
+  if (!request_scheduler_) {
+    SendToAIService(params, std::move(on_error), std::move(on_text),
+                    std::move(on_response), base::DoNothing());
+    return;
+  }
+
+  // Wait for a slot in the priority class; a shed request reports failure
+  // so the UI does not stay in the loading state
+  auto [send_error_callback, preempted_callback] =
+      base::SplitOnceCallback(std::move(on_error));
+  request_scheduler_->Schedule(
+      priority,
+      base::BindOnce(&SummarizationService::SendToAIService,
+                     weak_ptr_factory_.GetWeakPtr(), params,
+                     std::move(send_error_callback), std::move(on_text),
+                     std::move(on_response)),
+      base::BindOnce(
+          [](SummarizationCallback callback) {
+            std::move(callback).Run(MakeErrorResult(
+                "Summarization was preempted by higher-priority work"));
+          },
+          std::move(preempted_callback)));
+}
+
+void SummarizationService::SendToAIService(
+    const asol::core::AIServiceManager::AIRequestParams& params,
+    SummarizationCallback on_error,
+    TextCallback on_text,
+    ResponseCallback on_response,
+    base::OnceClosure done) {
+  // Cancelled while waiting for a slot
+  if (params.cancellation_token && params.cancellation_token->IsCancelled()) {
+    std::move(done).Run();
+    std::move(on_error).Run(
+        MakeErrorResult(asol::core::kRequestCancelledError));
+    return;
+  }
+
+  // The streaming adapters are all remote, so the local model answers in
+  // one piece and costs nothing
+  bool local =
+      !local_provider_id_.empty() && params.provider_id == local_provider_id_;
+  if (on_text && streaming_service_manager_ && !local) {
+    StreamFromService(params, std::move(on_text), std::move(on_response),
+                      std::move(done));
+    return;
+  }
 
   // Send request to AI service manager
   ai_service_manager_->ProcessRequest(
       params,
       base::BindOnce(
           [](base::WeakPtr<SummarizationService> self,
-             const std::string& original_content,
-             const std::string& page_url,
-             SummaryFormat format,
-             SummaryLength length,
-             SummarizationCallback callback,
+             ResponseCallback on_response,
+             base::OnceClosure done,
+             bool local,
+             const std::string& provider_id,
              bool success,
              const std::string& response) {
+            std::move(done).Run();
             if (!self)
               return;
+
+            if (success && !local && self->budget_manager_) {
+              self->budget_manager_->RecordSpend(
+                  {std::string(), kSummarizationBudgetFeature},
+                  self->EstimateCost(provider_id, response));
+            }
             
-            self->HandleAIResponse(
-                original_content,
-                page_url,
-                format,
-                length,
-                std::move(callback),
-                success,
-                response);
+            std::move(on_response).Run(success, response);
           },
           weak_ptr_factory_.GetWeakPtr(),
-          processed_content,  // We'll use this as the "original" content
-          page_url,
-          format,
-          length,
-          std::move(callback)));
+          std::move(on_response),
+          std::move(done), local, params.provider_id));
 }
 
-void SummarizationService::HandleAIResponse(
-    const std::string& original_content,
+void SummarizationService::StreamFromService(
+    const asol::core::AIServiceManager::AIRequestParams& params,
+    TextCallback on_text,
+    ResponseCallback on_response,
+    base::OnceClosure done) {
+  int stream_id = next_stream_id_++;
+  auto stream = std::make_unique<ActiveStream>();
+  stream->on_text = std::move(on_text);
+  stream->on_response = std::move(on_response);
+  stream->done = std::move(done);
+  // The provider cannot be told to stop; the rest of its answer goes unseen
+  if (params.cancellation_token) {
+    stream->cancel_subscription =
+        params.cancellation_token->AddCancelCallback(base::BindOnce(
+            &SummarizationService::FinishStream,
+            weak_ptr_factory_.GetWeakPtr(), stream_id, false,
+            std::string(asol::core::kRequestCancelledError)));
+  }
+  active_streams_[stream_id] = std::move(stream);
+
+  // Adapters may answer on their own threads; handle every piece here
+  scoped_refptr<base::SequencedTaskRunner> task_runner =
+      base::SequencedTaskRunner::GetCurrentDefault();
+  base::RepeatingCallback<void(bool, const std::string&, bool)> on_event =
+      base::BindRepeating(&SummarizationService::OnStreamEvent,
+                          weak_ptr_factory_.GetWeakPtr(), stream_id);
+  // Streaming adapters take their input as a std::string
+  streaming_service_manager_->ProcessTextWithCapabilityStream(
+      kSummarizationCapability, std::string(params.input_text),
+      [task_runner, on_event](const asol::adapters::ModelResponse& response,
+                              bool is_done) {
+        task_runner->PostTask(
+            FROM_HERE,
+            base::BindOnce(on_event, response.success,
+                           response.success ? response.text
+                                            : response.error_message,
+                           is_done));
+      });
+}
+
+void SummarizationService::OnStreamEvent(int stream_id,
+                                         bool success,
+                                         const std::string& text,
+                                         bool is_done) {
+  auto it = active_streams_.find(stream_id);
+  if (it == active_streams_.end()) {
+    return;  // Cancelled
+  }
+  if (!success) {
+    FinishStream(stream_id, false, text);
+    return;
+  }
+
+  ActiveStream* stream = it->second.get();
+  stream->text += text;
+  if (!text.empty()) {
+    stream->on_text.Run(text);
+    // The caller may have cancelled from the callback
+    if (!active_streams_.count(stream_id)) {
+      return;
+    }
+  }
+  if (is_done) {
+    FinishStream(stream_id, true, std::string());
+  }
+}
+
+void SummarizationService::FinishStream(int stream_id,
+                                        bool success,
+                                        const std::string& error) {
+  auto it = active_streams_.find(stream_id);
+  if (it == active_streams_.end()) {
+    return;
+  }
+  std::unique_ptr<ActiveStream> stream = std::move(it->second);
+  active_streams_.erase(it);
+  std::move(stream->done).Run();
+
+  // The streaming adapters have no tokenizer of their own; they answer
+  // for the same models as the default summarization provider
+  if (success && budget_manager_) {
+    budget_manager_->RecordSpend({std::string(), kSummarizationBudgetFeature},
+                                 EstimateCost(std::string(), stream->text));
+  }
+  std::move(stream->on_response).Run(success, success ? stream->text : error);
+}
+
+void SummarizationService::RequestFinalSummary(
+    asol::core::AIServiceManager::AIRequestParams params,
+    asol::core::RequestPriority priority,
+    asol::core::SharedText original_content,
     const std::string& page_url,
     SummaryFormat format,
     SummaryLength length,
-    SummarizationCallback callback,
-    bool success,
-    const std::string& response) {
-  SummaryResult result;
-  result.format = format;
-  result.length = length;
-  result.success = success;
-  result.timestamp = base::Time::Now();
-  
-  if (success) {
-    result.summary_text = response;
-    
-    // Generate source links
-    result.source_links = GenerateSourceLinks(original_content, response, page_url);
-    
-    // Add metadata
-    result.metadata["page_url"] = page_url;
-    result.metadata["timestamp"] = std::to_string(result.timestamp.ToDoubleT());
-    result.metadata["format"] = GetSummaryFormatString(format);
-    result.metadata["length"] = GetSummaryLengthString(length);
-    
-    // Cache the result
-    std::string cache_key = page_url + "_" + 
-                          std::to_string(static_cast<int>(format)) + "_" +
-                          std::to_string(static_cast<int>(length));
-    
-    // Limit cache size
-    if (summary_cache_.size() >= kMaxCacheSize) {
-      // Find oldest entry
-      auto oldest_it = summary_cache_.begin();
-      for (auto it = summary_cache_.begin(); it != summary_cache_.end(); ++it) {
-        if (it->second.timestamp < oldest_it->second.timestamp) {
-          oldest_it = it;
-        }
-      }
-      summary_cache_.erase(oldest_it);
-    }
-    
-    summary_cache_[cache_key] = result;
-  } else {
-    result.error_message = "Failed to generate summary: " + response;
+    const std::string& cache_key,
+    SummaryDeltaCallback on_delta,
+    SummarizationCallback callback) {
+  if (!on_delta) {
+    auto [error_callback, response_callback] =
+        base::SplitOnceCallback(std::move(callback));
+    RequestSummary(
+        std::move(params), priority, std::move(error_callback),
+        TextCallback(),
+        base::BindOnce(&SummarizationService::HandleAIResponse,
+                       weak_ptr_factory_.GetWeakPtr(),
+                       std::move(original_content), page_url, format, length,
+                       cache_key, std::move(response_callback)));
+    return;
   }
-  
-  std::move(callback).Run(result);
+
+  auto job = std::make_unique<StreamingJob>();
+  job->page_url = page_url;
+  job->format = format;
+  job->length = length;
+  job->cache_key = cache_key;
+  job->on_delta = std::move(on_delta);
+  job->callback = std::move(callback);
+  job->linker = GetSourceLinker(original_content);
+
+  int job_id = next_streaming_job_id_++;
+  streaming_jobs_[job_id] = std::move(job);
+  RequestSummary(
+      std::move(params), priority,
+      base::BindOnce(&SummarizationService::OnStreamingJobFailed,
+                     weak_ptr_factory_.GetWeakPtr(), job_id),
+      base::BindRepeating(&SummarizationService::OnSummaryTextStreamed,
+                          weak_ptr_factory_.GetWeakPtr(), job_id),
+      base::BindOnce(&SummarizationService::OnStreamedSummaryComplete,
+                     weak_ptr_factory_.GetWeakPtr(), job_id));
 }
 
-std::vector<SummarizationService::SourceLink> SummarizationService::GenerateSourceLinks(
-    const std::string& original_content,
-    const std::string& summary,
-    const std::string& page_url) {
-  std::vector<SourceLink> source_links;
-  
-  // Extract paragraphs from original content
-  std::vector<std::string> paragraphs = ExtractParagraphs(original_content);
-  
-  // Extract sentences from summary
-  std::vector<std::string> summary_sentences;
-  std::vector<std::string> summary_paragraphs = ExtractParagraphs(summary);
-  for (const auto& paragraph : summary_paragraphs) {
-    std::vector<std::string> sentences = ExtractSentences(paragraph);
-    summary_sentences.insert(summary_sentences.end(), sentences.begin(), sentences.end());
+void SummarizationService::OnSummaryTextStreamed(int job_id,
+                                                 const std::string& text) {
+  auto it = streaming_jobs_.find(job_id);
+  if (it == streaming_jobs_.end()) {
+    return;
   }
+  StreamingJob* job = it->second.get();
+  job->summary_text += text;
+
+  SummaryDelta delta;
+  delta.text = text;
+  // Link the sentences this piece completed; the one still being written
+  // waits for its end
+  size_t end = FindLastSentenceEnd(job->summary_text, job->linked_length);
+  if (end > job->linked_length) {
+    job->linker->Link(std::string_view(job->summary_text)
+                          .substr(job->linked_length, end - job->linked_length),
+                      job->page_url, &delta.source_links);
+    job->linked_length = end;
+    job->source_links.insert(job->source_links.end(),
+                             delta.source_links.begin(),
+                             delta.source_links.end());
+  }
+  job->on_delta.Run(delta);
+}
+
+void SummarizationService::OnStreamedSummaryComplete(
+    int job_id,
+    bool success,
+    const std::string& response) {
+  auto it = streaming_jobs_.find(job_id);
+  if (it == streaming_jobs_.end()) {
+    return;
+  }
+  std::unique_ptr<StreamingJob> job = std::move(it->second);
+  streaming_jobs_.erase(it);
+
+  if (!success) {
+    std::move(job->callback).Run(MakeErrorResult(
+        asol::core::IsCancellationError(response)
+            ? response
+            : "Failed to generate summary: " + response));
+    return;
+  }
+
+  // Whatever was not streamed (all of it, from a provider that cannot
+  // stream) arrives now, with the links of the last sentence
+  SummaryDelta delta;
+  if (response.size() > job->summary_text.size()) {
+    delta.text = response.substr(job->summary_text.size());
+    job->summary_text += delta.text;
+  }
+  job->linker->Link(
+      std::string_view(job->summary_text).substr(job->linked_length),
+      job->page_url, &delta.source_links);
+  job->source_links.insert(job->source_links.end(),
+                           delta.source_links.begin(),
+                           delta.source_links.end());
+  if (!delta.text.empty() || !delta.source_links.empty()) {
+    job->on_delta.Run(delta);
+  }
+
+  SummaryResult result;
+  result.format = job->format;
+  result.length = job->length;
+  result.success = true;
+  result.timestamp = base::Time::Now();
+  result.summary_text = std::move(job->summary_text);
+  result.source_links = std::move(job->source_links);
+  AddSummaryMetadata(job->page_url, &result);
+  CacheSummary(job->cache_key, result);
+  std::move(job->callback).Run(result);
+}
+
+void SummarizationService::OnStreamingJobFailed(int job_id,
+                                                const SummaryResult& result) {
+  auto it = streaming_jobs_.find(job_id);
+  if (it == streaming_jobs_.end()) {
+    return;
+  }
+  SummarizationCallback callback = std::move(it->second->callback);
+  streaming_jobs_.erase(it);
+  std::move(callback).Run(result);
+}
+
+void SummarizationService::StartChunkedSummary(
+    const asol::core::SharedText& processed_content,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    const std::string& cache_key,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    PartialSummaryCallback on_partial,
+    SummaryDeltaCallback on_delta,
+    SummarizationCallback callback) {
+  auto job = std::make_unique<ChunkedJob>();
+  job->source_content = processed_content;
+  job->page_url = page_url;
+  job->format = format;
+  job->length = length;
+  job->cache_key = cache_key;
+  job->priority = priority;
+  job->cancellation_token = std::move(cancellation_token);
+  job->trace = trace;
+  job->on_partial = std::move(on_partial);
+  job->on_delta = std::move(on_delta);
+  job->callback = std::move(callback);
+  job->chunks = SplitIntoChunks(job->source_content, kChunkLength);
+  job->chunk_summaries.resize(job->chunks.size());
+
+  int job_id = next_chunked_job_id_++;
+  chunked_jobs_[job_id] = std::move(job);
+  SendChunks(job_id);
+}
+
+void SummarizationService::SendChunks(int job_id) {
+  ChunkedJob* job = chunked_jobs_[job_id].get();
+  std::string_view input = job->level == 0
+                               ? job->source_content.view()
+                               : std::string_view(job->level_content);
+
+  // Keep a few sections in flight; the scheduler and the providers' rate
+  // limits decide how many of those run at once
+  while (job->in_flight < kMaxChunksInFlight &&
+         job->next_chunk < job->chunks.size()) {
+    size_t index = job->next_chunk++;
+    job->in_flight++;
+
+    const TextChunk& chunk = job->chunks[index];
+    std::string_view text =
+        std::string_view(input).substr(chunk.offset, chunk.length);
+    std::string prompt = FormatChunkPrompt(text);
+    size_t prefix_length = prompt.size() - text.size();
+    RequestSummary(
+        MakeRequestParams(std::move(prompt), prefix_length, job->page_url,
+                          job->format, job->length, job->priority,
+                          job->cancellation_token, job->trace),
+        job->priority,
+        base::BindOnce(&SummarizationService::OnChunkFailed,
+                       weak_ptr_factory_.GetWeakPtr(), job_id),
+        TextCallback(),
+        base::BindOnce(&SummarizationService::OnChunkSummarized,
+                       weak_ptr_factory_.GetWeakPtr(), job_id, index));
+
+    // A request can fail synchronously and end the job
+    if (!chunked_jobs_.count(job_id)) {
+      return;
+    }
+  }
+}
+
+void SummarizationService::OnChunkSummarized(int job_id,
+                                             size_t index,
+                                             bool success,
+                                             const std::string& response) {
+  auto it = chunked_jobs_.find(job_id);
+  if (it == chunked_jobs_.end()) {
+    return;  // An earlier section failed
+  }
+  if (!success) {
+    OnChunkFailed(job_id,
+                  MakeErrorResult("Failed to generate summary: " + response));
+    return;
+  }
+
+  ChunkedJob* job = it->second.get();
+  job->in_flight--;
+  job->completed++;
+  job->chunk_summaries[index] = response;
+
+  // Show each section of the document as soon as it is summarized
+  if (job->level == 0 && job->on_partial) {
+    PartialSummary partial;
+    partial.section_index = index;
+    partial.section_count = job->chunks.size();
+    partial.summary_text = response;
+    partial.text_offset = job->chunks[index].offset;
+    partial.text_length = job->chunks[index].length;
+    job->on_partial.Run(partial);
+    if (!chunked_jobs_.count(job_id)) {
+      return;
+    }
+  }
+
+  if (job->completed < job->chunks.size()) {
+    SendChunks(job_id);
+    return;
+  }
+
+  // Every section is in: reduce them
+  std::string combined = base::JoinString(job->chunk_summaries, "\n\n");
+  if (combined.size() > kMaxSinglePassContentLength &&
+      job->level < kMaxReduceLevels) {
+    // Still too long for one request; summarize the summaries in sections
+    job->level++;
+    job->level_content = std::move(combined);
+    job->chunks = SplitIntoChunks(job->level_content, kChunkLength);
+    job->chunk_summaries.assign(job->chunks.size(), std::string());
+    job->next_chunk = 0;
+    job->completed = 0;
+    SendChunks(job_id);
+    return;
+  }
+
+  std::string prompt = FormatReducePrompt(combined, job->format, job->length);
+  size_t prefix_length = prompt.size() - combined.size();
+  std::unique_ptr<ChunkedJob> finished = std::move(it->second);
+  chunked_jobs_.erase(it);
+  RequestFinalSummary(
+      MakeRequestParams(std::move(prompt), prefix_length, finished->page_url,
+                        finished->format, finished->length,
+                        finished->priority, finished->cancellation_token,
+                        finished->trace),
+      finished->priority, std::move(finished->source_content),
+      finished->page_url, finished->format, finished->length,
+      finished->cache_key, std::move(finished->on_delta),
+      std::move(finished->callback));
+}
+
+void SummarizationService::OnChunkFailed(int job_id,
+                                         const SummaryResult& result) {
+  // One missing section would leave a hole in the summary; give up on the
+  // rest and let sections still in flight finish unseen
+  auto it = chunked_jobs_.find(job_id);
+  if (it == chunked_jobs_.end()) {
+    return;
+  }
+  SummarizationCallback callback = std::move(it->second->callback);
+  chunked_jobs_.erase(it);
+  std::move(callback).Run(result);
+}
+
+void SummarizationService::HandleAIResponse(
+    const asol::core::SharedText& original_content,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    const std::string& cache_key,
+    SummarizationCallback callback,
+    bool success,
+    const std::string& response) {
+  SummaryResult result;
+  result.format = format;
+  result.length = length;
+  result.success = success;
+  result.timestamp = base::Time::Now();
   
-  // For each summary sentence, find the most similar sentence in the original content
-  for (const auto& summary_sentence : summary_sentences) {
-    SourceLink link;
-    link.anchor_text = summary_sentence;
+  if (success) {
+    result.summary_text = response;
     
-    // Find the most similar paragraph and sentence
-    int best_paragraph_index = 0;
-    int best_sentence_index = 0;
-    double best_similarity = 0.0;
+    // Generate source links
+    result.source_links = GenerateSourceLinks(original_content, response, page_url);
     
-    for (size_t p = 0; p < paragraphs.size(); ++p) {
-      std::vector<std::string> sentences = ExtractSentences(paragraphs[p]);
-      
-      for (size_t s = 0; s < sentences.size(); ++s) {
-        // Simple similarity measure (can be improved)
-        // In a real implementation, we would use a more sophisticated
-        // similarity measure like cosine similarity or semantic similarity
-        
-        // For now, just use a simple word overlap measure
-        std::vector<std::string> summary_words = base::SplitString(
-            base::ToLowerASCII(summary_sentence), " ", base::TRIM_WHITESPACE, 
-            base::SPLIT_WANT_NONEMPTY);
-        
-        std::vector<std::string> sentence_words = base::SplitString(
-            base::ToLowerASCII(sentences[s]), " ", base::TRIM_WHITESPACE, 
-            base::SPLIT_WANT_NONEMPTY);
-        
-        // Count common words
-        int common_words = 0;
-        for (const auto& word : summary_words) {
-          if (std::find(sentence_words.begin(), sentence_words.end(), word) != 
-              sentence_words.end()) {
-            common_words++;
-          }
-        }
-        
-        // Calculate similarity as proportion of common words
-        double similarity = 0.0;
-        if (!summary_words.empty() && !sentence_words.empty()) {
-          similarity = static_cast<double>(common_words) / 
-                     std::min(summary_words.size(), sentence_words.size());
+    // Add metadata
+    AddSummaryMetadata(page_url, &result);
+    
+    // Cache the result
+    CacheSummary(cache_key, result);
+  } else {
+    result.error_message = "Failed to generate summary: " + response;
+  }
+  
+  std::move(callback).Run(result);
+}
+
+void SummarizationService::CacheSummary(
+    const std::string& cache_key,
+    const SummaryResult& result) {
+  summary_cache_->Put(cache_key, result);
+}
+
+double SummarizationService::EstimateCost(const std::string& provider_id,
+                                          std::string_view text) {
+  asol::core::AIServiceProvider* provider = nullptr;
+  if (ai_service_manager_) {
+    provider = provider_id.empty()
+                   ? ai_service_manager_->GetDefaultProviderForTask(
+                         asol::core::AIServiceManager::TaskType::
+                             TEXT_SUMMARIZATION)
+                   : ai_service_manager_->GetProviderById(provider_id);
+  }
+  size_t tokens = provider
+                      ? provider->GetTokenCounter().CountTokens(text)
+                      : asol::core::BudgetManager::EstimateTokens(text);
+  return asol::core::BudgetManager::EstimateCost(
+      tokens, budget_manager_->default_cost_per_1k_tokens());
+}
+
+std::vector<SummarizationService::SourceLink> SummarizationService::GenerateSourceLinks(
+    const asol::core::SharedText& original_content,
+    const std::string& summary,
+    const std::string& page_url) {
+  std::vector<SourceLink> source_links;
+  GetSourceLinker(original_content)->Link(summary, page_url, &source_links);
+  return source_links;
+}
+
+scoped_refptr<SummarizationService::SourceLinker>
+SummarizationService::GetSourceLinker(
+    const asol::core::SharedText& original_content) {
+  asol::core::Hasher128 hasher;
+  hasher.Update(original_content);
+  asol::core::RequestFingerprint content_key = hasher.Finish();
+  for (auto it = source_linkers_.begin(); it != source_linkers_.end(); ++it) {
+    if (it->content_key == content_key) {
+      source_linkers_.splice(source_linkers_.begin(), source_linkers_, it);
+      return it->linker;
+    }
+  }
+
+  auto linker = base::MakeRefCounted<SourceLinker>(original_content);
+  source_linkers_.push_front({content_key, linker});
+  if (source_linkers_.size() > kMaxCachedSourceLinkers) {
+    source_linkers_.pop_back();
+  }
+  return linker;
+}
+
+std::string SummarizationService::FormatReducePrompt(
+    const std::string& section_summaries,
+    SummaryFormat format,
+    SummaryLength length) {
+  return kReducePrompt.Render(
+      {{"format", GetSummaryFormatString(format)},
+       {"length", GetSummaryLengthString(length)},
+       {"instructions", GetFormatInstructions(format)},
+       {"summaries", section_summaries}});
+}
+
+// static
+std::vector<SummarizationService::TextChunk>
+SummarizationService::SplitIntoChunks(std::string_view text,
+                                      size_t max_length) {
+  std::vector<TextChunk> chunks;
+  size_t start = 0;
+  size_t end = 0;  // Empty chunk while start == end
+  auto flush = [&] {
+    if (end > start) {
+      chunks.push_back({start, end - start});
+    }
+  };
+
+  // Whole paragraphs are packed together; a paragraph longer than a chunk
+  // is cut at the last sentence end that fits, or hard if there is none
+  for (std::string_view paragraph : base::SplitStringPieceUsingSubstr(
+           text, "\n\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    size_t offset = paragraph.data() - text.data();
+    size_t paragraph_end = offset + paragraph.size();
+    if (end > start && paragraph_end - start <= max_length) {
+      end = paragraph_end;
+      continue;
+    }
+    flush();
+    while (paragraph_end - offset > max_length) {
+      std::string_view window = text.substr(offset, max_length);
+      size_t cut = window.rfind(". ");
+      if (cut == std::string_view::npos || cut < max_length / 2) {
+        cut = max_length;
+        // Do not split a UTF-8 sequence
+        while (cut > 0 && (static_cast<unsigned char>(text[offset + cut]) &
+                           0xC0) == 0x80) {
+          --cut;
         }
-        
-        if (similarity > best_similarity) {
-          best_similarity = similarity;
-          best_paragraph_index = p;
-          best_sentence_index = s;
-          link.text_snippet = sentences[s];
+        if (cut == 0) {
+          cut = max_length;
         }
+      } else {
+        cut += 1;  // Keep the period
+      }
+      chunks.push_back({offset, cut});
+      offset += cut;
+      while (offset < paragraph_end && text[offset] == ' ') {
+        ++offset;
       }
     }
-    
-    // Only add links with reasonable similarity
-    if (best_similarity > 0.3) {
-      // Create URL fragment (e.g., #p5s2 for paragraph 5, sentence 2)
-      link.url_fragment = page_url + "#p" + std::to_string(best_paragraph_index + 1) +
-                        "s" + std::to_string(best_sentence_index + 1);
-      link.paragraph_index = best_paragraph_index;
-      link.sentence_index = best_sentence_index;
-      
-      source_links.push_back(link);
-    }
+    start = offset;
+    end = paragraph_end;
   }
-  
-  return source_links;
+  flush();
+  return chunks;
 }
 
 std::string SummarizationService::FormatSummaryPrompt(
     const std::string& content,
     SummaryFormat format,
     SummaryLength length) {
-  std::stringstream prompt;
-  
-  // Base prompt
-  prompt << "Please summarize the following content ";
-  
-  // Add format specification
-  prompt << "in " << GetSummaryFormatString(format) << " format ";
-  
-  // Add length specification
-  prompt << "with a length of " << GetSummaryLengthString(length) << ".\n\n";
-  
-  // Add special instructions based on format
-  switch (format) {
-    case SummaryFormat::EXECUTIVE_SUMMARY:
-      prompt << "Focus on the most important points and key takeaways. ";
-      prompt << "The summary should be concise and informative.\n\n";
-      break;
-    case SummaryFormat::BULLET_POINTS:
-      prompt << "Present the main points as bullet points. ";
-      prompt << "Each bullet point should be clear and self-contained.\n\n";
-      break;
-    case SummaryFormat::QA_FORMAT:
-      prompt << "Structure the summary as questions and answers. ";
-      prompt << "Identify the key questions addressed in the content ";
-      prompt << "and provide concise answers.\n\n";
-      break;
-    case SummaryFormat::TECHNICAL_BRIEF:
-      prompt << "This summary is for experts in the field. ";
-      prompt << "Use appropriate technical terminology and focus on ";
-      prompt << "advanced concepts and details.\n\n";
-      break;
-    case SummaryFormat::SIMPLIFIED:
-      prompt << "This summary is for beginners. ";
-      prompt << "Explain concepts in simple terms, avoid jargon, ";
-      prompt << "and provide context for technical terms.\n\n";
-      break;
-  }
-  
-  // Add the content to summarize
-  prompt << "Content to summarize:\n\n" << content;
-  
-  return prompt.str();
+  return kSummaryPrompt.Render(
+      {{"format", GetSummaryFormatString(format)},
+       {"length", GetSummaryLengthString(length)},
+       {"instructions", GetFormatInstructions(format)},
+       {"content", content}});
 }
 
 }  // namespace ai
@@ -458,18 +1459,38 @@ std::string SummarizationService::FormatSummaryPrompt(
 
 #include "browser_core/ai/summarization_service.h"
 
+#include <stdint.h>
+
 #include <algorithm>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "base/functional/callback_helpers.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/location.h"
+#include "base/memory/ref_counted.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/time.h"
+#include "asol/adapters/adapter_interface.h"
 #include "asol/core/ai_service_manager.h"
+#include "asol/core/ai_service_provider.h"
 #include "asol/core/privacy_proxy.h"
+#include "asol/core/prompt_cache.h"
+#include "asol/core/prompt_template.h"
+#include "asol/core/persistent_response_store.h"
+#include "asol/core/service_manager.h"
+#include "asol/core/startup_trace.h"
+#include "asol/core/token_counter.h"
+#include "asol/core/trace_context.h"
+#include "browser_core/ai/extractive_compressor.h"
+#include "browser_core/ai/summary_cache.h"
 
 namespace browser_core {
 namespace ai {
@@ -480,16 +1501,53 @@ namespace {
 constexpr size_t kMinContentLength = 1000;
 
 // Maximum content length for summarization (in characters)
-constexpr size_t kMaxContentLength = 100000;
+constexpr size_t kMaxContentLength = 2000000;
+
+// Longer content is summarized in sections and the section summaries
+// combined, so no request grows with the document
+constexpr size_t kMaxSinglePassContentLength = 24000;
+
+// Target size of one section
+constexpr size_t kChunkLength = 12000;
+
+// Sections of one document requested at a time
+constexpr size_t kMaxChunksInFlight = 6;
+
+// Times section summaries may themselves be summarized in sections before
+// the final combination
+constexpr int kMaxReduceLevels = 2;
+
+// Content tokens sent in one request for each summary length; longer
+// content is cut down to its most representative sentences first
+constexpr size_t kVeryShortContentTokens = 1500;
+constexpr size_t kShortContentTokens = 2500;
+constexpr size_t kMediumContentTokens = 3500;
+constexpr size_t kLongContentTokens = 5000;
+
+// Budget feature summarization requests are charged to
+constexpr char kSummarizationBudgetFeature[] = "summarization";
+
+// Words that occur in more sentences of the content than this do not
+// select the sentences a summary sentence is compared with
+constexpr size_t kMaxCandidatePostings = 64;
+
+// Documents whose source linkers are kept
+constexpr size_t kMaxCachedSourceLinkers = 4;
+
+// Adapter capability streamed summaries are requested from
+constexpr char kSummarizationCapability[] = "summarization";
 
 // Minimum paragraph count for summarization
 constexpr int kMinParagraphCount = 3;
 
-// Maximum cache size
-constexpr size_t kMaxCacheSize = 50;
-
-// Cache expiration time (24 hours)
-constexpr base::TimeDelta kCacheExpirationTime = base::Hours(24);
+SummarizationService::SummaryResult MakeErrorResult(
+    const std::string& message) {
+  SummarizationService::SummaryResult result;
+  result.success = false;
+  result.error_message = message;
+  result.timestamp = base::Time::Now();
+  return result;
+}
 
 // Helper function to count paragraphs in content
 int CountParagraphs(const std::string& content) {
@@ -498,30 +1556,69 @@ int CountParagraphs(const std::string& content) {
   return paragraphs.size();
 }
 
-// Helper function to extract paragraphs from content
-std::vector<std::string> ExtractParagraphs(const std::string& content) {
-  return base::SplitString(
-      content, "\n\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+// A sentence of some text, viewed in place
+struct Sentence {
+  std::string_view text;
+  int paragraph_index;
+  int sentence_index;
+};
+
+// Split |text| into paragraphs at blank lines and those into sentences at
+// ". ", keeping each sentence's period
+std::vector<Sentence> SplitSentences(std::string_view text) {
+  std::vector<Sentence> sentences;
+  std::vector<std::string_view> paragraphs = base::SplitStringPieceUsingSubstr(
+      text, "\n\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  for (size_t p = 0; p < paragraphs.size(); ++p) {
+    std::string_view paragraph = paragraphs[p];
+    std::vector<std::string_view> parts = base::SplitStringPieceUsingSubstr(
+        paragraph, ". ", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+    for (size_t s = 0; s < parts.size(); ++s) {
+      std::string_view sentence = parts[s];
+      size_t end = sentence.data() + sentence.size() - paragraph.data();
+      if (end < paragraph.size() && paragraph[end] == '.') {
+        sentence = paragraph.substr(sentence.data() - paragraph.data(),
+                                    sentence.size() + 1);
+      }
+      sentences.push_back(
+          {sentence, static_cast<int>(p), static_cast<int>(s)});
+    }
+  }
+  return sentences;
 }
 
-// Helper function to extract sentences from a paragraph
-std::vector<std::string> ExtractSentences(const std::string& paragraph) {
-  // Simple sentence splitting (can be improved)
-  std::vector<std::string> sentences = base::SplitString(
-      paragraph, ". ", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
-  
-  // Add back the period that was removed during splitting
-  for (size_t i = 0; i < sentences.size() - 1; ++i) {
-    sentences[i] += ".";
+// Lowercase words of |sentence|
+std::vector<std::string> SplitWords(std::string_view sentence) {
+  return base::SplitString(base::ToLowerASCII(sentence), " ",
+                           base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+}
+
+// End of the last complete sentence in text[from, end): just past a line
+// break, or past the space after a period. |from| if there is none.
+size_t FindLastSentenceEnd(std::string_view text, size_t from) {
+  for (size_t i = text.size(); i > from; --i) {
+    if (text[i - 1] == '\n') {
+      return i;
+    }
+    if (text[i - 1] == ' ' && i - 1 > from && text[i - 2] == '.') {
+      return i;
+    }
   }
-  
-  // Check if the last sentence already ends with a period
-  if (!sentences.empty() && !sentences.back().empty() && 
-      sentences.back().back() != '.') {
-    sentences.back() += ".";
+  return from;
+}
+
+// Point the links of a cached summary at |page_url|; the same content may
+// have been summarized at another address
+void RebaseOnPage(const std::string& page_url,
+                  SummarizationService::SummaryResult* result) {
+  for (SummarizationService::SourceLink& link : result->source_links) {
+    size_t fragment = link.url_fragment.find('#');
+    link.url_fragment =
+        page_url + (fragment == std::string::npos
+                        ? std::string()
+                        : link.url_fragment.substr(fragment));
   }
-  
-  return sentences;
+  result->metadata["page_url"] = page_url;
 }
 
 // Helper function to get summary format string
@@ -558,13 +1655,318 @@ std::string GetSummaryLengthString(
   return "2-3 paragraphs";  // Default
 }
 
+// Instructions that shape a summary in |format|
+std::string GetFormatInstructions(SummarizationService::SummaryFormat format) {
+  switch (format) {
+    case SummarizationService::SummaryFormat::EXECUTIVE_SUMMARY:
+      return "Focus on the most important points and key takeaways. "
+             "The summary should be concise and informative.\n\n";
+    case SummarizationService::SummaryFormat::BULLET_POINTS:
+      return "Present the main points as bullet points. "
+             "Each bullet point should be clear and self-contained.\n\n";
+    case SummarizationService::SummaryFormat::QA_FORMAT:
+      return "Structure the summary as questions and answers. "
+             "Identify the key questions addressed in the content "
+             "and provide concise answers.\n\n";
+    case SummarizationService::SummaryFormat::TECHNICAL_BRIEF:
+      return "This summary is for experts in the field. "
+             "Use appropriate technical terminology and focus on "
+             "advanced concepts and details.\n\n";
+    case SummarizationService::SummaryFormat::SIMPLIFIED:
+      return "This summary is for beginners. "
+             "Explain concepts in simple terms, avoid jargon, "
+             "and provide context for technical terms.\n\n";
+  }
+  return std::string();
+}
+
+// Prompts put their instructions first and the content last, so the
+// instructions form a prefix providers can cache.
+constexpr asol::core::PromptTemplate kSummaryPrompt(
+    "Please summarize the following content in {format} format with a "
+    "length of {length}.\n\n{instructions}"
+    "Content to summarize:\n\n{content}",
+    "content");
+
+constexpr asol::core::PromptTemplate kChunkPrompt(
+    "The following is one section of a longer document. Summarize its "
+    "key points, facts and conclusions in a few sentences, so they can "
+    "be combined with the summaries of the other sections. Do not add "
+    "an introduction.\n\nSection:\n\n{section}",
+    "section");
+
+constexpr asol::core::PromptTemplate kReducePrompt(
+    "The following are summaries of consecutive sections of one long "
+    "document. Combine them into a single summary of the whole document "
+    "in {format} format with a length of {length}.\n\n{instructions}"
+    "Section summaries:\n\n{summaries}",
+    "summaries");
+
+// Prompt for one section of a long document
+std::string FormatChunkPrompt(std::string_view section) {
+  return kChunkPrompt.Render({{"section", section}});
+}
+
+// Metadata recorded with every summary
+void AddSummaryMetadata(const std::string& page_url,
+                        SummarizationService::SummaryResult* result) {
+  result->metadata["page_url"] = page_url;
+  result->metadata["timestamp"] =
+      std::to_string(result->timestamp.ToDoubleT());
+  result->metadata["format"] = GetSummaryFormatString(result->format);
+  result->metadata["length"] = GetSummaryLengthString(result->length);
+}
+
+size_t GetContentTokenBudget(SummarizationService::SummaryLength length) {
+  switch (length) {
+    case SummarizationService::SummaryLength::VERY_SHORT:
+      return kVeryShortContentTokens;
+    case SummarizationService::SummaryLength::SHORT:
+      return kShortContentTokens;
+    case SummarizationService::SummaryLength::MEDIUM:
+      return kMediumContentTokens;
+    case SummarizationService::SummaryLength::LONG:
+      return kLongContentTokens;
+  }
+  return kMediumContentTokens;
+}
+
+// Report what compressing the content saved with a successful summary
+void AddCompressionMetadata(
+    const ExtractiveCompressor::Result& compressed,
+    base::TimeDelta extraction_time,
+    base::TimeTicks request_start,
+    SummarizationService::SummarizationCallback callback,
+    const SummarizationService::SummaryResult& result) {
+  if (!result.success) {
+    std::move(callback).Run(result);
+    return;
+  }
+  SummarizationService::SummaryResult reported = result;
+  reported.metadata["prompt_tokens_original"] =
+      base::NumberToString(compressed.original_tokens);
+  reported.metadata["prompt_tokens_sent"] =
+      base::NumberToString(compressed.tokens);
+  reported.metadata["prompt_token_reduction"] = base::NumberToString(
+      100 - compressed.tokens * 100 / compressed.original_tokens);
+  reported.metadata["sentences_kept"] =
+      base::NumberToString(compressed.kept_sentence_count) + "/" +
+      base::NumberToString(compressed.sentence_count);
+  reported.metadata["extraction_time_ms"] =
+      base::NumberToString(extraction_time.InMilliseconds());
+  reported.metadata["request_latency_ms"] = base::NumberToString(
+      (base::TimeTicks::Now() - request_start).InMilliseconds());
+  std::move(callback).Run(reported);
+}
+
+// Ends |span| when the summary is reported
+SummarizationService::SummarizationCallback EndSpanOnResult(
+    asol::core::TraceSpan span,
+    SummarizationService::SummarizationCallback callback) {
+  return base::BindOnce(
+      [](asol::core::TraceSpan span,
+         SummarizationService::SummarizationCallback callback,
+         const SummarizationService::SummaryResult& result) {
+        span.End();
+        std::move(callback).Run(result);
+      },
+      std::move(span), std::move(callback));
+}
+
+// Marks the process's first summary text, partial or whole, in the startup
+// trace before |callback| runs; null callbacks stay null
+template <typename... Args>
+base::RepeatingCallback<void(Args...)> MarkFirstSummaryText(
+    base::RepeatingCallback<void(Args...)> callback) {
+  if (!callback || !asol::core::StartupTrace::Get()) {
+    return callback;
+  }
+  return base::BindRepeating(
+      [](const base::RepeatingCallback<void(Args...)>& callback,
+         Args... args) {
+        asol::core::StartupTrace::Get()->AddMarkOnce("first_summary_text");
+        callback.Run(std::forward<Args>(args)...);
+      },
+      std::move(callback));
+}
+
+template <typename... Args>
+base::OnceCallback<void(Args...)> MarkFirstSummaryText(
+    base::OnceCallback<void(Args...)> callback) {
+  if (!callback || !asol::core::StartupTrace::Get()) {
+    return callback;
+  }
+  return base::BindOnce(
+      [](base::OnceCallback<void(Args...)> callback, Args... args) {
+        asol::core::StartupTrace::Get()->AddMarkOnce("first_summary_text");
+        std::move(callback).Run(std::forward<Args>(args)...);
+      },
+      std::move(callback));
+}
+
 }  // namespace
 
+// Indexes the sentences of the original content once, so summaries of it
+// in any format and length, including ones streamed a sentence at a time,
+// are linked without rescanning it.
+//
+// Each word of the content gets an ID, and an inverted index lists the
+// sentences each word occurs in. A summary sentence is compared only with
+// the sentences that share one of its rarer words, so linking costs about
+// the same however long the content is.
+class SummarizationService::SourceLinker
+    : public base::RefCounted<SourceLinker> {
+ public:
+  explicit SourceLinker(asol::core::SharedText original_content)
+      : content_(std::move(original_content)),
+        sentences_(SplitSentences(content_)) {
+    sentence_words_.reserve(sentences_.size());
+    sentence_word_counts_.reserve(sentences_.size());
+    for (size_t i = 0; i < sentences_.size(); ++i) {
+      std::vector<std::string> words = SplitWords(sentences_[i].text);
+      std::vector<int> ids;
+      ids.reserve(words.size());
+      for (std::string& word : words) {
+        auto [it, inserted] = vocabulary_.try_emplace(
+            std::move(word), static_cast<int>(postings_.size()));
+        if (inserted) {
+          postings_.emplace_back();
+        }
+        ids.push_back(it->second);
+      }
+      sentence_word_counts_.push_back(ids.size());
+      std::sort(ids.begin(), ids.end());
+      ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+      for (int id : ids) {
+        postings_[id].push_back(static_cast<uint32_t>(i));
+      }
+      sentence_words_.push_back(std::move(ids));
+    }
+  }
+
+  SourceLinker(const SourceLinker&) = delete;
+  SourceLinker& operator=(const SourceLinker&) = delete;
+
+  // Append a link for each sentence of |summary| that resembles a sentence
+  // of the original content closely enough
+  void Link(std::string_view summary,
+            const std::string& page_url,
+            std::vector<SourceLink>* links) const {
+    std::vector<uint32_t> candidates;
+    for (const Sentence& summary_sentence : SplitSentences(summary)) {
+      // Simple word overlap; a semantic similarity measure would do better
+      std::vector<std::string> summary_words =
+          SplitWords(summary_sentence.text);
+      if (summary_words.empty()) {
+        continue;
+      }
+
+      // Words the content does not have cannot match, but still count
+      // towards the summary sentence's length
+      std::vector<int> summary_ids;
+      const std::vector<uint32_t>* rarest = nullptr;
+      candidates.clear();
+      for (const std::string& word : summary_words) {
+        auto it = vocabulary_.find(word);
+        if (it == vocabulary_.end()) {
+          continue;
+        }
+        summary_ids.push_back(it->second);
+        const std::vector<uint32_t>& sentences = postings_[it->second];
+        if (!rarest || sentences.size() < rarest->size()) {
+          rarest = &sentences;
+        }
+        // Words in many sentences say little about which one this came
+        // from; they still count for the candidates other words find
+        if (sentences.size() <= kMaxCandidatePostings) {
+          candidates.insert(candidates.end(), sentences.begin(),
+                            sentences.end());
+        }
+      }
+      if (!rarest) {
+        continue;
+      }
+      if (candidates.empty()) {
+        candidates = *rarest;
+      }
+      // In content order, so ties go to the earliest sentence
+      std::sort(candidates.begin(), candidates.end());
+      candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                       candidates.end());
+
+      const Sentence* best = nullptr;
+      double best_similarity = 0.0;
+      for (uint32_t index : candidates) {
+        const std::vector<int>& words = sentence_words_[index];
+        int common_words = 0;
+        for (int id : summary_ids) {
+          if (std::binary_search(words.begin(), words.end(), id)) {
+            common_words++;
+          }
+        }
+        double similarity =
+            static_cast<double>(common_words) /
+            std::min(summary_words.size(), sentence_word_counts_[index]);
+        if (similarity > best_similarity) {
+          best_similarity = similarity;
+          best = &sentences_[index];
+        }
+      }
+
+      // Only add links with reasonable similarity
+      if (best && best_similarity > 0.3) {
+        SourceLink link;
+        link.anchor_text = std::string(summary_sentence.text);
+        link.text_snippet = std::string(best->text);
+        link.text_offset = best->text.data() - content_.data();
+        link.text_length = best->text.size();
+        link.paragraph_index = best->paragraph_index;
+        link.sentence_index = best->sentence_index;
+        // Create URL fragment (e.g., #p5s2 for paragraph 5, sentence 2)
+        link.url_fragment = page_url + "#p" +
+                            base::NumberToString(best->paragraph_index + 1) +
+                            "s" +
+                            base::NumberToString(best->sentence_index + 1);
+        links->push_back(std::move(link));
+      }
+    }
+  }
+
+ private:
+  friend class base::RefCounted<SourceLinker>;
+  ~SourceLinker() = default;
+
+  const asol::core::SharedText content_;
+
+  // Sentences of |content_|, viewed in place so each link can say exactly
+  // where its snippet is
+  std::vector<Sentence> sentences_;
+
+  // Sorted distinct word IDs of each sentence, and its number of words
+  std::vector<std::vector<int>> sentence_words_;
+  std::vector<size_t> sentence_word_counts_;
+
+  std::unordered_map<std::string, int> vocabulary_;
+
+  // Sentences each word occurs in, in order, by word ID
+  std::vector<std::vector<uint32_t>> postings_;
+};
+
 SummarizationService::SummarizationService()
-    : weak_ptr_factory_(this) {}
+    : summary_cache_(std::make_unique<SummaryCache>()),
+      weak_ptr_factory_(this) {}
 
 SummarizationService::~SummarizationService() = default;
 
+SummarizationService::ChunkedJob::ChunkedJob() = default;
+SummarizationService::ChunkedJob::~ChunkedJob() = default;
+
+SummarizationService::StreamingJob::StreamingJob() = default;
+SummarizationService::StreamingJob::~StreamingJob() = default;
+
+SummarizationService::ActiveStream::ActiveStream() = default;
+SummarizationService::ActiveStream::~ActiveStream() = default;
+
 bool SummarizationService::Initialize(
     asol::core::AIServiceManager* ai_service_manager,
     asol::core::PrivacyProxy* privacy_proxy) {
@@ -573,40 +1975,90 @@ bool SummarizationService::Initialize(
   return (ai_service_manager_ != nullptr && privacy_proxy_ != nullptr);
 }
 
+void SummarizationService::SetRequestScheduler(
+    asol::core::RequestScheduler* scheduler) {
+  request_scheduler_ = scheduler;
+}
+
+void SummarizationService::SetBudgetManager(
+    asol::core::BudgetManager* budget_manager) {
+  budget_manager_ = budget_manager;
+}
+
+void SummarizationService::SetLocalProviderId(const std::string& provider_id) {
+  local_provider_id_ = provider_id;
+}
+
+void SummarizationService::SetStreamingServiceManager(
+    asol::core::ServiceManager* service_manager) {
+  streaming_service_manager_ = service_manager;
+}
+
+void SummarizationService::EnablePersistentCache(const base::FilePath& path,
+                                                 size_t max_bytes) {
+  asol::core::PersistentResponseStore::Options options;
+  options.path = path;
+  options.max_bytes = max_bytes;
+  summary_cache_->SetPersistentStore(
+      std::make_unique<asol::core::PersistentResponseStore>(options));
+}
+
 void SummarizationService::SummarizeContent(
     const std::string& content,
     const std::string& page_url,
     SummaryFormat format,
     SummaryLength length,
     SummarizationCallback callback) {
-  // Check if content is summarizable
-  if (!IsContentSummarizable(content)) {
-    SummaryResult result;
-    result.success = false;
-    result.error_message = "Content is not suitable for summarization";
-    result.timestamp = base::Time::Now();
-    std::move(callback).Run(result);
-    return;
-  }
+  SummarizeContent(content, page_url, format, length,
+                 asol::core::RequestPriority::INTERACTIVE, nullptr,
+                 asol::core::TraceContext(), std::move(callback));
+}
 
-  // Check cache first
-  std::string cache_key = page_url + "_" + 
-                        std::to_string(static_cast<int>(format)) + "_" +
-                        std::to_string(static_cast<int>(length));
-  
-  auto cache_it = summary_cache_.find(cache_key);
-  if (cache_it != summary_cache_.end()) {
-    // Check if cache entry is still valid
-    if (base::Time::Now() - cache_it->second.timestamp < kCacheExpirationTime) {
-      std::move(callback).Run(cache_it->second);
-      return;
-    }
-    // Cache entry expired, remove it
-    summary_cache_.erase(cache_it);
-  }
+void SummarizationService::SummarizeContent(
+    const std::string& content,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    SummarizationCallback callback) {
+  SummarizeContentInternal(content, page_url, format, length, priority,
+                           std::move(cancellation_token), trace,
+                           PartialSummaryCallback(), SummaryDeltaCallback(),
+                           std::move(callback));
+}
 
-  // Process content through privacy proxy first
-  ProcessWithPrivacyProxy(content, page_url, format, length, std::move(callback));
+void SummarizationService::SummarizeLongContent(
+    const std::string& content,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    PartialSummaryCallback on_partial,
+    SummarizationCallback callback) {
+  SummarizeContentInternal(content, page_url, format, length, priority,
+                           std::move(cancellation_token), trace,
+                           std::move(on_partial), SummaryDeltaCallback(),
+                           std::move(callback));
+}
+
+void SummarizationService::SummarizeContentStreaming(
+    const std::string& content,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    SummaryDeltaCallback on_delta,
+    SummarizationCallback callback) {
+  SummarizeContentInternal(content, page_url, format, length, priority,
+                           std::move(cancellation_token), trace,
+                           PartialSummaryCallback(), std::move(on_delta),
+                           std::move(callback));
 }
 
 void SummarizationService::SummarizeContent(
@@ -636,97 +2088,670 @@ base::WeakPtr<SummarizationService> SummarizationService::GetWeakPtr() {
   return weak_ptr_factory_.GetWeakPtr();
 }
 
+void SummarizationService::SummarizeContentInternal(
+    const std::string& content,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    PartialSummaryCallback on_partial,
+    SummaryDeltaCallback on_delta,
+    SummarizationCallback callback) {
+  // Every stage of the summary, on every layer down to the provider's
+  // HTTP request, is traced under this span
+  asol::core::TraceSpan span("SummarizationService::Summarize", trace);
+  asol::core::TraceContext summary_trace = span.context();
+  callback = EndSpanOnResult(std::move(span), std::move(callback));
+  on_partial = MarkFirstSummaryText(std::move(on_partial));
+  on_delta = MarkFirstSummaryText(std::move(on_delta));
+  callback = MarkFirstSummaryText(std::move(callback));
+
+  // Check if content is summarizable
+  if (!IsContentSummarizable(content)) {
+    std::move(callback).Run(
+        MakeErrorResult("Content is not suitable for summarization"));
+    return;
+  }
+
+  // Check cache first
+  std::string cache_key = SummaryCache::ComputeKey(content, format, length);
+  SummaryResult cached;
+  if (summary_cache_->Get(cache_key, &cached)) {
+    RebaseOnPage(page_url, &cached);
+    if (on_delta) {
+      SummaryDelta delta;
+      delta.text = cached.summary_text;
+      delta.source_links = cached.source_links;
+      on_delta.Run(delta);
+    }
+    std::move(callback).Run(cached);
+    return;
+  }
+
+  // Process content through privacy proxy first
+  ProcessWithPrivacyProxy(content, page_url, format, length, cache_key,
+                        priority, std::move(cancellation_token), summary_trace,
+                        std::move(on_partial), std::move(on_delta),
+                        std::move(callback));
+}
+
 void SummarizationService::ProcessWithPrivacyProxy(
     const std::string& content,
     const std::string& page_url,
     SummaryFormat format,
     SummaryLength length,
+    const std::string& cache_key,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    PartialSummaryCallback on_partial,
+    SummaryDeltaCallback on_delta,
     SummarizationCallback callback) {
   // Use privacy proxy to redact any PII before sending to AI service
   privacy_proxy_->ProcessText(
       content,
       base::BindOnce(
           [](base::WeakPtr<SummarizationService> self,
-             const std::string& original_content,
              const std::string& page_url,
              SummaryFormat format,
              SummaryLength length,
+             const std::string& cache_key,
+             asol::core::RequestPriority priority,
+             scoped_refptr<asol::core::CancellationToken> cancellation_token,
+             const asol::core::TraceContext& trace,
+             PartialSummaryCallback on_partial,
+             SummaryDeltaCallback on_delta,
              SummarizationCallback callback,
              const asol::core::PrivacyProxy::ProcessingResult& privacy_result) {
             if (!self)
               return;
+
+            // Too long for one request: summarize it in sections
+            if (privacy_result.processed_text.size() >
+                kMaxSinglePassContentLength) {
+              self->StartChunkedSummary(
+                  privacy_result.processed_text, page_url, format, length,
+                  cache_key, priority, std::move(cancellation_token), trace,
+                  std::move(on_partial), std::move(on_delta),
+                  std::move(callback));
+              return;
+            }
             
             self->ProcessWithAIService(
                 privacy_result.processed_text,
                 page_url,
                 format,
                 length,
+                cache_key,
+                priority,
+                std::move(cancellation_token),
+                trace,
+                std::move(on_delta),
                 std::move(callback));
           },
           weak_ptr_factory_.GetWeakPtr(),
-          content,  // Keep original content for source link generation
           page_url,
           format,
           length,
-          std::move(callback)));
+          cache_key,
+          priority,
+          std::move(cancellation_token),
+          trace,
+          std::move(on_partial),
+          std::move(on_delta),
+          std::move(callback)),
+      trace);
 }
 
 void SummarizationService::ProcessWithAIService(
-    const std::string& processed_content,
+    const asol::core::SharedText& processed_content,
     const std::string& page_url,
     SummaryFormat format,
     SummaryLength length,
+    const std::string& cache_key,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    SummaryDeltaCallback on_delta,
     SummarizationCallback callback) {
+  // Send only as much of the content as the summary length calls for.
+  // Source links still point into the whole content.
+  base::TimeTicks start = base::TimeTicks::Now();
+  ExtractiveCompressor::Result compressed = ExtractiveCompressor::Compress(
+      processed_content, GetContentTokenBudget(length));
+  base::TimeTicks extracted = base::TimeTicks::Now();
+
   // Format the prompt for the AI service
-  std::string prompt = FormatSummaryPrompt(processed_content, format, length);
+  std::string prompt = FormatSummaryPrompt(compressed.text, format, length);
+  size_t prefix_length = prompt.size() - compressed.text.size();
 
-  // Prepare request parameters
+  if (compressed.compressed()) {
+    callback = base::BindOnce(&AddCompressionMetadata, std::move(compressed),
+                              extracted - start, extracted, std::move(callback));
+  }
+
+  RequestFinalSummary(
+      MakeRequestParams(std::move(prompt), prefix_length, page_url, format,
+                        length, priority, std::move(cancellation_token),
+                        trace),
+      priority, processed_content, page_url, format, length, cache_key,
+      std::move(on_delta), std::move(callback));
+}
+
+asol::core::AIServiceManager::AIRequestParams
+SummarizationService::MakeRequestParams(
+    std::string prompt,
+    size_t prompt_prefix_length,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace) const {
   asol::core::AIServiceManager::AIRequestParams params;
   params.task_type = asol::core::AIServiceManager::TaskType::TEXT_SUMMARIZATION;
-  params.input_text = prompt;
+  params.input_text = std::move(prompt);
   
   // Add metadata about the summary request
   params.custom_params["summary_format"] = GetSummaryFormatString(format);
   params.custom_params["summary_length"] = GetSummaryLengthString(length);
   params.custom_params["page_url"] = page_url;
+  params.custom_params[asol::core::kRequestPriorityParam] =
+      asol::core::RequestPriorityToString(priority);
+  params.custom_params[asol::core::kBudgetFeatureParam] =
+      kSummarizationBudgetFeature;
+  // Everything before the content is the same for every page summarized
+  // with this format and length, so providers can serve it from cache
+  params.custom_params[asol::core::kPromptPrefixLengthParam] =
+      base::NumberToString(prompt_prefix_length);
+  params.cancellation_token = std::move(cancellation_token);
+  params.trace = trace;
+  return params;
+}
+
+void SummarizationService::RequestSummary(
+    asol::core::AIServiceManager::AIRequestParams params,
+    asol::core::RequestPriority priority,
+    SummarizationCallback on_error,
+    TextCallback on_text,
+    ResponseCallback on_response) {
+  // The page went away while the content was being redacted; do not spend
+  // budget on it
+  if (params.cancellation_token && params.cancellation_token->IsCancelled()) {
+    std::move(on_error).Run(
+        MakeErrorResult(asol::core::kRequestCancelledError));
+    return;
+  }
+
+  if (budget_manager_) {
+    // There is no cheaper route from here, so a downgrade goes out as is.
+    // Once only local work is allowed the on-device model summarizes, free.
+    asol::core::BudgetScope scope{std::string(), kSummarizationBudgetFeature};
+    double cost = EstimateCost(params.provider_id, params.input_text);
+    asol::core::BudgetManager::Decision decision =
+        budget_manager_->Evaluate(scope, cost, priority);
+    if (decision == asol::core::BudgetManager::Decision::LOCAL_ONLY &&
+        !local_provider_id_.empty()) {
+      params.provider_id = local_provider_id_;
+    } else if (decision == asol::core::BudgetManager::Decision::REJECT ||
+               decision == asol::core::BudgetManager::Decision::LOCAL_ONLY) {
+      std::move(on_error).Run(
+          MakeErrorResult("Daily summarization budget reached"));
+      return;
+    } else {
+      budget_manager_->RecordSpend(scope, cost);
+    }
+  }
+
+  if (!request_scheduler_) {
+    SendToAIService(params, std::move(on_error), std::move(on_text),
+                    std::move(on_response), base::DoNothing());
+    return;
+  }
+
+  // Wait for a slot in the priority class; a shed request reports failure
+  // so the UI does not stay in the loading state
+  auto [send_error_callback, preempted_callback] =
+      base::SplitOnceCallback(std::move(on_error));
+  request_scheduler_->Schedule(
+      priority,
+      base::BindOnce(&SummarizationService::SendToAIService,
+                     weak_ptr_factory_.GetWeakPtr(), params,
+                     std::move(send_error_callback), std::move(on_text),
+                     std::move(on_response)),
+      base::BindOnce(
+          [](SummarizationCallback callback) {
+            std::move(callback).Run(MakeErrorResult(
+                "Summarization was preempted by higher-priority work"));
+          },
+          std::move(preempted_callback)));
+}
+
+void SummarizationService::SendToAIService(
+    const asol::core::AIServiceManager::AIRequestParams& params,
+    SummarizationCallback on_error,
+    TextCallback on_text,
+    ResponseCallback on_response,
+    base::OnceClosure done) {
+  // Cancelled while waiting for a slot
+  if (params.cancellation_token && params.cancellation_token->IsCancelled()) {
+    std::move(done).Run();
+    std::move(on_error).Run(
+        MakeErrorResult(asol::core::kRequestCancelledError));
+    return;
+  }
+
+  // The streaming adapters are all remote, so the local model answers in
+  // one piece and costs nothing
+  bool local =
+      !local_provider_id_.empty() && params.provider_id == local_provider_id_;
+  if (on_text && streaming_service_manager_ && !local) {
+    StreamFromService(params, std::move(on_text), std::move(on_response),
+                      std::move(done));
+    return;
+  }
 
   // Send request to AI service manager
   ai_service_manager_->ProcessRequest(
       params,
       base::BindOnce(
           [](base::WeakPtr<SummarizationService> self,
-             const std::string& original_content,
-             const std::string& page_url,
-             SummaryFormat format,
-             SummaryLength length,
-             SummarizationCallback callback,
+             ResponseCallback on_response,
+             base::OnceClosure done,
+             bool local,
+             const std::string& provider_id,
              bool success,
              const std::string& response) {
+            std::move(done).Run();
             if (!self)
               return;
+
+            if (success && !local && self->budget_manager_) {
+              self->budget_manager_->RecordSpend(
+                  {std::string(), kSummarizationBudgetFeature},
+                  self->EstimateCost(provider_id, response));
+            }
             
-            self->HandleAIResponse(
-                original_content,
-                page_url,
-                format,
-                length,
-                std::move(callback),
-                success,
-                response);
+            std::move(on_response).Run(success, response);
           },
           weak_ptr_factory_.GetWeakPtr(),
-          processed_content,  // We'll use this as the "original" content
-          page_url,
-          format,
-          length,
-          std::move(callback)));
+          std::move(on_response),
+          std::move(done), local, params.provider_id));
+}
+
+void SummarizationService::StreamFromService(
+    const asol::core::AIServiceManager::AIRequestParams& params,
+    TextCallback on_text,
+    ResponseCallback on_response,
+    base::OnceClosure done) {
+  int stream_id = next_stream_id_++;
+  auto stream = std::make_unique<ActiveStream>();
+  stream->on_text = std::move(on_text);
+  stream->on_response = std::move(on_response);
+  stream->done = std::move(done);
+  // The provider cannot be told to stop; the rest of its answer goes unseen
+  if (params.cancellation_token) {
+    stream->cancel_subscription =
+        params.cancellation_token->AddCancelCallback(base::BindOnce(
+            &SummarizationService::FinishStream,
+            weak_ptr_factory_.GetWeakPtr(), stream_id, false,
+            std::string(asol::core::kRequestCancelledError)));
+  }
+  active_streams_[stream_id] = std::move(stream);
+
+  // Adapters may answer on their own threads; handle every piece here
+  scoped_refptr<base::SequencedTaskRunner> task_runner =
+      base::SequencedTaskRunner::GetCurrentDefault();
+  base::RepeatingCallback<void(bool, const std::string&, bool)> on_event =
+      base::BindRepeating(&SummarizationService::OnStreamEvent,
+                          weak_ptr_factory_.GetWeakPtr(), stream_id);
+  // Streaming adapters take their input as a std::string
+  streaming_service_manager_->ProcessTextWithCapabilityStream(
+      kSummarizationCapability, std::string(params.input_text),
+      [task_runner, on_event](const asol::adapters::ModelResponse& response,
+                              bool is_done) {
+        task_runner->PostTask(
+            FROM_HERE,
+            base::BindOnce(on_event, response.success,
+                           response.success ? response.text
+                                            : response.error_message,
+                           is_done));
+      });
+}
+
+void SummarizationService::OnStreamEvent(int stream_id,
+                                         bool success,
+                                         const std::string& text,
+                                         bool is_done) {
+  auto it = active_streams_.find(stream_id);
+  if (it == active_streams_.end()) {
+    return;  // Cancelled
+  }
+  if (!success) {
+    FinishStream(stream_id, false, text);
+    return;
+  }
+
+  ActiveStream* stream = it->second.get();
+  stream->text += text;
+  if (!text.empty()) {
+    stream->on_text.Run(text);
+    // The caller may have cancelled from the callback
+    if (!active_streams_.count(stream_id)) {
+      return;
+    }
+  }
+  if (is_done) {
+    FinishStream(stream_id, true, std::string());
+  }
+}
+
+void SummarizationService::FinishStream(int stream_id,
+                                        bool success,
+                                        const std::string& error) {
+  auto it = active_streams_.find(stream_id);
+  if (it == active_streams_.end()) {
+    return;
+  }
+  std::unique_ptr<ActiveStream> stream = std::move(it->second);
+  active_streams_.erase(it);
+  std::move(stream->done).Run();
+
+  // The streaming adapters have no tokenizer of their own; they answer
+  // for the same models as the default summarization provider
+  if (success && budget_manager_) {
+    budget_manager_->RecordSpend({std::string(), kSummarizationBudgetFeature},
+                                 EstimateCost(std::string(), stream->text));
+  }
+  std::move(stream->on_response).Run(success, success ? stream->text : error);
+}
+
+void SummarizationService::RequestFinalSummary(
+    asol::core::AIServiceManager::AIRequestParams params,
+    asol::core::RequestPriority priority,
+    asol::core::SharedText original_content,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    const std::string& cache_key,
+    SummaryDeltaCallback on_delta,
+    SummarizationCallback callback) {
+  if (!on_delta) {
+    auto [error_callback, response_callback] =
+        base::SplitOnceCallback(std::move(callback));
+    RequestSummary(
+        std::move(params), priority, std::move(error_callback),
+        TextCallback(),
+        base::BindOnce(&SummarizationService::HandleAIResponse,
+                       weak_ptr_factory_.GetWeakPtr(),
+                       std::move(original_content), page_url, format, length,
+                       cache_key, std::move(response_callback)));
+    return;
+  }
+
+  auto job = std::make_unique<StreamingJob>();
+  job->page_url = page_url;
+  job->format = format;
+  job->length = length;
+  job->cache_key = cache_key;
+  job->on_delta = std::move(on_delta);
+  job->callback = std::move(callback);
+  job->linker = GetSourceLinker(original_content);
+
+  int job_id = next_streaming_job_id_++;
+  streaming_jobs_[job_id] = std::move(job);
+  RequestSummary(
+      std::move(params), priority,
+      base::BindOnce(&SummarizationService::OnStreamingJobFailed,
+                     weak_ptr_factory_.GetWeakPtr(), job_id),
+      base::BindRepeating(&SummarizationService::OnSummaryTextStreamed,
+                          weak_ptr_factory_.GetWeakPtr(), job_id),
+      base::BindOnce(&SummarizationService::OnStreamedSummaryComplete,
+                     weak_ptr_factory_.GetWeakPtr(), job_id));
+}
+
+void SummarizationService::OnSummaryTextStreamed(int job_id,
+                                                 const std::string& text) {
+  auto it = streaming_jobs_.find(job_id);
+  if (it == streaming_jobs_.end()) {
+    return;
+  }
+  StreamingJob* job = it->second.get();
+  job->summary_text += text;
+
+  SummaryDelta delta;
+  delta.text = text;
+  // Link the sentences this piece completed; the one still being written
+  // waits for its end
+  size_t end = FindLastSentenceEnd(job->summary_text, job->linked_length);
+  if (end > job->linked_length) {
+    job->linker->Link(std::string_view(job->summary_text)
+                          .substr(job->linked_length, end - job->linked_length),
+                      job->page_url, &delta.source_links);
+    job->linked_length = end;
+    job->source_links.insert(job->source_links.end(),
+                             delta.source_links.begin(),
+                             delta.source_links.end());
+  }
+  job->on_delta.Run(delta);
+}
+
+void SummarizationService::OnStreamedSummaryComplete(
+    int job_id,
+    bool success,
+    const std::string& response) {
+  auto it = streaming_jobs_.find(job_id);
+  if (it == streaming_jobs_.end()) {
+    return;
+  }
+  std::unique_ptr<StreamingJob> job = std::move(it->second);
+  streaming_jobs_.erase(it);
+
+  if (!success) {
+    std::move(job->callback).Run(MakeErrorResult(
+        asol::core::IsCancellationError(response)
+            ? response
+            : "Failed to generate summary: " + response));
+    return;
+  }
+
+  // Whatever was not streamed (all of it, from a provider that cannot
+  // stream) arrives now, with the links of the last sentence
+  SummaryDelta delta;
+  if (response.size() > job->summary_text.size()) {
+    delta.text = response.substr(job->summary_text.size());
+    job->summary_text += delta.text;
+  }
+  job->linker->Link(
+      std::string_view(job->summary_text).substr(job->linked_length),
+      job->page_url, &delta.source_links);
+  job->source_links.insert(job->source_links.end(),
+                           delta.source_links.begin(),
+                           delta.source_links.end());
+  if (!delta.text.empty() || !delta.source_links.empty()) {
+    job->on_delta.Run(delta);
+  }
+
+  SummaryResult result;
+  result.format = job->format;
+  result.length = job->length;
+  result.success = true;
+  result.timestamp = base::Time::Now();
+  result.summary_text = std::move(job->summary_text);
+  result.source_links = std::move(job->source_links);
+  AddSummaryMetadata(job->page_url, &result);
+  CacheSummary(job->cache_key, result);
+  std::move(job->callback).Run(result);
+}
+
+void SummarizationService::OnStreamingJobFailed(int job_id,
+                                                const SummaryResult& result) {
+  auto it = streaming_jobs_.find(job_id);
+  if (it == streaming_jobs_.end()) {
+    return;
+  }
+  SummarizationCallback callback = std::move(it->second->callback);
+  streaming_jobs_.erase(it);
+  std::move(callback).Run(result);
+}
+
+void SummarizationService::StartChunkedSummary(
+    const asol::core::SharedText& processed_content,
+    const std::string& page_url,
+    SummaryFormat format,
+    SummaryLength length,
+    const std::string& cache_key,
+    asol::core::RequestPriority priority,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const asol::core::TraceContext& trace,
+    PartialSummaryCallback on_partial,
+    SummaryDeltaCallback on_delta,
+    SummarizationCallback callback) {
+  auto job = std::make_unique<ChunkedJob>();
+  job->source_content = processed_content;
+  job->page_url = page_url;
+  job->format = format;
+  job->length = length;
+  job->cache_key = cache_key;
+  job->priority = priority;
+  job->cancellation_token = std::move(cancellation_token);
+  job->trace = trace;
+  job->on_partial = std::move(on_partial);
+  job->on_delta = std::move(on_delta);
+  job->callback = std::move(callback);
+  job->chunks = SplitIntoChunks(job->source_content, kChunkLength);
+  job->chunk_summaries.resize(job->chunks.size());
+
+  int job_id = next_chunked_job_id_++;
+  chunked_jobs_[job_id] = std::move(job);
+  SendChunks(job_id);
+}
+
+void SummarizationService::SendChunks(int job_id) {
+  ChunkedJob* job = chunked_jobs_[job_id].get();
+  std::string_view input = job->level == 0
+                               ? job->source_content.view()
+                               : std::string_view(job->level_content);
+
+  // Keep a few sections in flight; the scheduler and the providers' rate
+  // limits decide how many of those run at once
+  while (job->in_flight < kMaxChunksInFlight &&
+         job->next_chunk < job->chunks.size()) {
+    size_t index = job->next_chunk++;
+    job->in_flight++;
+
+    const TextChunk& chunk = job->chunks[index];
+    std::string_view text =
+        std::string_view(input).substr(chunk.offset, chunk.length);
+    std::string prompt = FormatChunkPrompt(text);
+    size_t prefix_length = prompt.size() - text.size();
+    RequestSummary(
+        MakeRequestParams(std::move(prompt), prefix_length, job->page_url,
+                          job->format, job->length, job->priority,
+                          job->cancellation_token, job->trace),
+        job->priority,
+        base::BindOnce(&SummarizationService::OnChunkFailed,
+                       weak_ptr_factory_.GetWeakPtr(), job_id),
+        TextCallback(),
+        base::BindOnce(&SummarizationService::OnChunkSummarized,
+                       weak_ptr_factory_.GetWeakPtr(), job_id, index));
+
+    // A request can fail synchronously and end the job
+    if (!chunked_jobs_.count(job_id)) {
+      return;
+    }
+  }
+}
+
+void SummarizationService::OnChunkSummarized(int job_id,
+                                             size_t index,
+                                             bool success,
+                                             const std::string& response) {
+  auto it = chunked_jobs_.find(job_id);
+  if (it == chunked_jobs_.end()) {
+    return;  // An earlier section failed
+  }
+  if (!success) {
+    OnChunkFailed(job_id,
+                  MakeErrorResult("Failed to generate summary: " + response));
+    return;
+  }
+
+  ChunkedJob* job = it->second.get();
+  job->in_flight--;
+  job->completed++;
+  job->chunk_summaries[index] = response;
+
+  // Show each section of the document as soon as it is summarized
+  if (job->level == 0 && job->on_partial) {
+    PartialSummary partial;
+    partial.section_index = index;
+    partial.section_count = job->chunks.size();
+    partial.summary_text = response;
+    partial.text_offset = job->chunks[index].offset;
+    partial.text_length = job->chunks[index].length;
+    job->on_partial.Run(partial);
+    if (!chunked_jobs_.count(job_id)) {
+      return;
+    }
+  }
+
+  if (job->completed < job->chunks.size()) {
+    SendChunks(job_id);
+    return;
+  }
+
+  // Every section is in: reduce them
+  std::string combined = base::JoinString(job->chunk_summaries, "\n\n");
+  if (combined.size() > kMaxSinglePassContentLength &&
+      job->level < kMaxReduceLevels) {
+    // Still too long for one request; summarize the summaries in sections
+    job->level++;
+    job->level_content = std::move(combined);
+    job->chunks = SplitIntoChunks(job->level_content, kChunkLength);
+    job->chunk_summaries.assign(job->chunks.size(), std::string());
+    job->next_chunk = 0;
+    job->completed = 0;
+    SendChunks(job_id);
+    return;
+  }
+
+  std::string prompt = FormatReducePrompt(combined, job->format, job->length);
+  size_t prefix_length = prompt.size() - combined.size();
+  std::unique_ptr<ChunkedJob> finished = std::move(it->second);
+  chunked_jobs_.erase(it);
+  RequestFinalSummary(
+      MakeRequestParams(std::move(prompt), prefix_length, finished->page_url,
+                        finished->format, finished->length,
+                        finished->priority, finished->cancellation_token,
+                        finished->trace),
+      finished->priority, std::move(finished->source_content),
+      finished->page_url, finished->format, finished->length,
+      finished->cache_key, std::move(finished->on_delta),
+      std::move(finished->callback));
+}
+
+void SummarizationService::OnChunkFailed(int job_id,
+                                         const SummaryResult& result) {
+  // One missing section would leave a hole in the summary; give up on the
+  // rest and let sections still in flight finish unseen
+  auto it = chunked_jobs_.find(job_id);
+  if (it == chunked_jobs_.end()) {
+    return;
+  }
+  SummarizationCallback callback = std::move(it->second->callback);
+  chunked_jobs_.erase(it);
+  std::move(callback).Run(result);
 }
 
 void SummarizationService::HandleAIResponse(
-    const std::string& original_content,
+    const asol::core::SharedText& original_content,
     const std::string& page_url,
     SummaryFormat format,
     SummaryLength length,
+    const std::string& cache_key,
     SummarizationCallback callback,
     bool success,
     const std::string& response) {
@@ -743,29 +2768,10 @@ void SummarizationService::HandleAIResponse(
     result.source_links = GenerateSourceLinks(original_content, response, page_url);
     
     // Add metadata
-    result.metadata["page_url"] = page_url;
-    result.metadata["timestamp"] = std::to_string(result.timestamp.ToDoubleT());
-    result.metadata["format"] = GetSummaryFormatString(format);
-    result.metadata["length"] = GetSummaryLengthString(length);
+    AddSummaryMetadata(page_url, &result);
     
     // Cache the result
-    std::string cache_key = page_url + "_" + 
-                          std::to_string(static_cast<int>(format)) + "_" +
-                          std::to_string(static_cast<int>(length));
-    
-    // Limit cache size
-    if (summary_cache_.size() >= kMaxCacheSize) {
-      // Find oldest entry
-      auto oldest_it = summary_cache_.begin();
-      for (auto it = summary_cache_.begin(); it != summary_cache_.end(); ++it) {
-        if (it->second.timestamp < oldest_it->second.timestamp) {
-          oldest_it = it;
-        }
-      }
-      summary_cache_.erase(oldest_it);
-    }
-    
-    summary_cache_[cache_key] = result;
+    CacheSummary(cache_key, result);
   } else {
     result.error_message = "Failed to generate summary: " + response;
   }
@@ -773,136 +2779,132 @@ void SummarizationService::HandleAIResponse(
   std::move(callback).Run(result);
 }
 
+void SummarizationService::CacheSummary(
+    const std::string& cache_key,
+    const SummaryResult& result) {
+  summary_cache_->Put(cache_key, result);
+}
+
+double SummarizationService::EstimateCost(const std::string& provider_id,
+                                          std::string_view text) {
+  asol::core::AIServiceProvider* provider = nullptr;
+  if (ai_service_manager_) {
+    provider = provider_id.empty()
+                   ? ai_service_manager_->GetDefaultProviderForTask(
+                         asol::core::AIServiceManager::TaskType::
+                             TEXT_SUMMARIZATION)
+                   : ai_service_manager_->GetProviderById(provider_id);
+  }
+  size_t tokens = provider
+                      ? provider->GetTokenCounter().CountTokens(text)
+                      : asol::core::BudgetManager::EstimateTokens(text);
+  return asol::core::BudgetManager::EstimateCost(
+      tokens, budget_manager_->default_cost_per_1k_tokens());
+}
+
 std::vector<SummarizationService::SourceLink> SummarizationService::GenerateSourceLinks(
-    const std::string& original_content,
+    const asol::core::SharedText& original_content,
     const std::string& summary,
     const std::string& page_url) {
   std::vector<SourceLink> source_links;
-  
-  // Extract paragraphs from original content
-  std::vector<std::string> paragraphs = ExtractParagraphs(original_content);
-  
-  // Extract sentences from summary
-  std::vector<std::string> summary_sentences;
-  std::vector<std::string> summary_paragraphs = ExtractParagraphs(summary);
-  for (const auto& paragraph : summary_paragraphs) {
-    std::vector<std::string> sentences = ExtractSentences(paragraph);
-    summary_sentences.insert(summary_sentences.end(), sentences.begin(), sentences.end());
+  GetSourceLinker(original_content)->Link(summary, page_url, &source_links);
+  return source_links;
+}
+
+scoped_refptr<SummarizationService::SourceLinker>
+SummarizationService::GetSourceLinker(
+    const asol::core::SharedText& original_content) {
+  asol::core::Hasher128 hasher;
+  hasher.Update(original_content);
+  asol::core::RequestFingerprint content_key = hasher.Finish();
+  for (auto it = source_linkers_.begin(); it != source_linkers_.end(); ++it) {
+    if (it->content_key == content_key) {
+      source_linkers_.splice(source_linkers_.begin(), source_linkers_, it);
+      return it->linker;
+    }
   }
-  
-  // For each summary sentence, find the most similar sentence in the original content
-  for (const auto& summary_sentence : summary_sentences) {
-    SourceLink link;
-    link.anchor_text = summary_sentence;
-    
-    // Find the most similar paragraph and sentence
-    int best_paragraph_index = 0;
-    int best_sentence_index = 0;
-    double best_similarity = 0.0;
-    
-    for (size_t p = 0; p < paragraphs.size(); ++p) {
-      std::vector<std::string> sentences = ExtractSentences(paragraphs[p]);
-      
-      for (size_t s = 0; s < sentences.size(); ++s) {
-        // Simple similarity measure (can be improved)
-        // In a real implementation, we would use a more sophisticated
-        // similarity measure like cosine similarity or semantic similarity
-        
-        // For now, just use a simple word overlap measure
-        std::vector<std::string> summary_words = base::SplitString(
-            base::ToLowerASCII(summary_sentence), " ", base::TRIM_WHITESPACE, 
-            base::SPLIT_WANT_NONEMPTY);
-        
-        std::vector<std::string> sentence_words = base::SplitString(
-            base::ToLowerASCII(sentences[s]), " ", base::TRIM_WHITESPACE, 
-            base::SPLIT_WANT_NONEMPTY);
-        
-        // Count common words
-        int common_words = 0;
-        for (const auto& word : summary_words) {
-          if (std::find(sentence_words.begin(), sentence_words.end(), word) != 
-              sentence_words.end()) {
-            common_words++;
-          }
-        }
-        
-        // Calculate similarity as proportion of common words
-        double similarity = 0.0;
-        if (!summary_words.empty() && !sentence_words.empty()) {
-          similarity = static_cast<double>(common_words) / 
-                     std::min(summary_words.size(), sentence_words.size());
+
+  auto linker = base::MakeRefCounted<SourceLinker>(original_content);
+  source_linkers_.push_front({content_key, linker});
+  if (source_linkers_.size() > kMaxCachedSourceLinkers) {
+    source_linkers_.pop_back();
+  }
+  return linker;
+}
+
+std::string SummarizationService::FormatReducePrompt(
+    const std::string& section_summaries,
+    SummaryFormat format,
+    SummaryLength length) {
+  return kReducePrompt.Render(
+      {{"format", GetSummaryFormatString(format)},
+       {"length", GetSummaryLengthString(length)},
+       {"instructions", GetFormatInstructions(format)},
+       {"summaries", section_summaries}});
+}
+
+// static
+std::vector<SummarizationService::TextChunk>
+SummarizationService::SplitIntoChunks(std::string_view text,
+                                      size_t max_length) {
+  std::vector<TextChunk> chunks;
+  size_t start = 0;
+  size_t end = 0;  // Empty chunk while start == end
+  auto flush = [&] {
+    if (end > start) {
+      chunks.push_back({start, end - start});
+    }
+  };
+
+  // Whole paragraphs are packed together; a paragraph longer than a chunk
+  // is cut at the last sentence end that fits, or hard if there is none
+  for (std::string_view paragraph : base::SplitStringPieceUsingSubstr(
+           text, "\n\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    size_t offset = paragraph.data() - text.data();
+    size_t paragraph_end = offset + paragraph.size();
+    if (end > start && paragraph_end - start <= max_length) {
+      end = paragraph_end;
+      continue;
+    }
+    flush();
+    while (paragraph_end - offset > max_length) {
+      std::string_view window = text.substr(offset, max_length);
+      size_t cut = window.rfind(". ");
+      if (cut == std::string_view::npos || cut < max_length / 2) {
+        cut = max_length;
+        // Do not split a UTF-8 sequence
+        while (cut > 0 && (static_cast<unsigned char>(text[offset + cut]) &
+                           0xC0) == 0x80) {
+          --cut;
         }
-        
-        if (similarity > best_similarity) {
-          best_similarity = similarity;
-          best_paragraph_index = p;
-          best_sentence_index = s;
-          link.text_snippet = sentences[s];
+        if (cut == 0) {
+          cut = max_length;
         }
+      } else {
+        cut += 1;  // Keep the period
+      }
+      chunks.push_back({offset, cut});
+      offset += cut;
+      while (offset < paragraph_end && text[offset] == ' ') {
+        ++offset;
       }
     }
-    
-    // Only add links with reasonable similarity
-    if (best_similarity > 0.3) {
-      // Create URL fragment (e.g., #p5s2 for paragraph 5, sentence 2)
-      link.url_fragment = page_url + "#p" + std::to_string(best_paragraph_index + 1) +
-                        "s" + std::to_string(best_sentence_index + 1);
-      link.paragraph_index = best_paragraph_index;
-      link.sentence_index = best_sentence_index;
-      
-      source_links.push_back(link);
-    }
+    start = offset;
+    end = paragraph_end;
   }
-  
-  return source_links;
+  flush();
+  return chunks;
 }
 
 std::string SummarizationService::FormatSummaryPrompt(
     const std::string& content,
     SummaryFormat format,
     SummaryLength length) {
-  std::stringstream prompt;
-  
-  // Base prompt
-  prompt << "Please summarize the following content ";
-  
-  // Add format specification
-  prompt << "in " << GetSummaryFormatString(format) << " format ";
-  
-  // Add length specification
-  prompt << "with a length of " << GetSummaryLengthString(length) << ".\n\n";
-  
-  // Add special instructions based on format
-  switch (format) {
-    case SummaryFormat::EXECUTIVE_SUMMARY:
-      prompt << "Focus on the most important points and key takeaways. ";
-      prompt << "The summary should be concise and informative.\n\n";
-      break;
-    case SummaryFormat::BULLET_POINTS:
-      prompt << "Present the main points as bullet points. ";
-      prompt << "Each bullet point should be clear and self-contained.\n\n";
-      break;
-    case SummaryFormat::QA_FORMAT:
-      prompt << "Structure the summary as questions and answers. ";
-      prompt << "Identify the key questions addressed in the content ";
-      prompt << "and provide concise answers.\n\n";
-      break;
-    case SummaryFormat::TECHNICAL_BRIEF:
-      prompt << "This summary is for experts in the field. ";
-      prompt << "Use appropriate technical terminology and focus on ";
-      prompt << "advanced concepts and details.\n\n";
-      break;
-    case SummaryFormat::SIMPLIFIED:
-      prompt << "This summary is for beginners. ";
-      prompt << "Explain concepts in simple terms, avoid jargon, ";
-      prompt << "and provide context for technical terms.\n\n";
-      break;
-  }
-  
-  // Add the content to summarize
-  prompt << "Content to summarize:\n\n" << content;
-  
-  return prompt.str();
+  return kSummaryPrompt.Render(
+      {{"format", GetSummaryFormatString(format)},
+       {"length", GetSummaryLengthString(length)},
+       {"instructions", GetFormatInstructions(format)},
+       {"content", content}});
 }
 
 }  // namespace ai
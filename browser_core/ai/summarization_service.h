@@ -5,25 +5,41 @@
 #ifndef BROWSER_CORE_AI_SUMMARIZATION_SERVICE_H_
 #define BROWSER_CORE_AI_SUMMARIZATION_SERVICE_H_
 
+#include <stddef.h>
+
+#include <list>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
 #include "base/callback.h"
+#include "base/callback_list.h"
+#include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
+#include "asol/core/ai_service_manager.h"
+#include "asol/core/budget_manager.h"
+#include "asol/core/cancellation_token.h"
+#include "asol/core/request_fingerprint.h"
+#include "asol/core/request_scheduler.h"
+#include "asol/core/shared_text.h"
+#include "asol/core/trace_context.h"
+#include "base/memory/scoped_refptr.h"
 
 namespace asol {
 namespace core {
-class AIServiceManager;
 class PrivacyProxy;
+class ServiceManager;
 }  // namespace core
 }  // namespace asol
 
 namespace browser_core {
 namespace ai {
 
+class SummaryCache;
+
 // SummarizationService provides AI-powered summarization capabilities for web content.
 // It integrates with the ASOL layer to leverage the best AI model for summarization
 // while ensuring privacy protection.
@@ -53,6 +69,10 @@ class SummarizationService {
     std::string url_fragment;
     int paragraph_index;
     int sentence_index;
+
+    // Where |text_snippet| is in the summarized content
+    size_t text_offset = 0;
+    size_t text_length = 0;
   };
 
   // Summary result
@@ -67,10 +87,37 @@ class SummarizationService {
     base::Time timestamp;
   };
 
+  // The summary of one section of a long document, delivered as soon as
+  // it is ready and before the summary of the whole
+  struct PartialSummary {
+    size_t section_index = 0;
+    size_t section_count = 0;
+    std::string summary_text;
+
+    // The section's range of the summarized content
+    size_t text_offset = 0;
+    size_t text_length = 0;
+  };
+
+  // A piece of a summary as it is generated
+  struct SummaryDelta {
+    // Text to append to the summary delivered so far
+    std::string text;
+
+    // Links for the summary sentences this piece completed
+    std::vector<SourceLink> source_links;
+  };
+
   // Callback for summarization requests
   using SummarizationCallback = 
       base::OnceCallback<void(const SummaryResult& result)>;
 
+  using PartialSummaryCallback =
+      base::RepeatingCallback<void(const PartialSummary& partial)>;
+
+  using SummaryDeltaCallback =
+      base::RepeatingCallback<void(const SummaryDelta& delta)>;
+
   SummarizationService();
   ~SummarizationService();
 
@@ -82,6 +129,31 @@ class SummarizationService {
   bool Initialize(asol::core::AIServiceManager* ai_service_manager,
                 asol::core::PrivacyProxy* privacy_proxy);
 
+  // Send AI requests through |scheduler| so they share provider capacity
+  // with the rest of the browser. Optional; not owned.
+  void SetRequestScheduler(asol::core::RequestScheduler* scheduler);
+
+  // Charge requests to the "summarization" feature budget. Prefetch and
+  // background summaries are refused once it runs low, so automatic
+  // summarization cannot spend without bound. Optional; not owned.
+  void SetBudgetManager(asol::core::BudgetManager* budget_manager);
+
+  // Once the budget allows only local work, summarize with |provider_id|,
+  // an on-device provider registered with the AIServiceManager, instead of
+  // refusing. Its summaries are not charged. Empty (the default) refuses.
+  void SetLocalProviderId(const std::string& provider_id);
+
+  // Stream summaries for SummarizeContentStreaming() from the adapters
+  // |service_manager| routes "summarization" to. Without it, streamed
+  // summaries arrive as one piece. Optional; not owned.
+  void SetStreamingServiceManager(
+      asol::core::ServiceManager* service_manager);
+
+  // Keep summaries on disk at |path|, within |max_bytes|, so repeat
+  // summaries stay instant across restarts. Lookups and stores then do
+  // blocking file IO.
+  void EnablePersistentCache(const base::FilePath& path, size_t max_bytes);
+
   // Summarize content with specified format and length
   void SummarizeContent(const std::string& content,
                       const std::string& page_url,
@@ -89,6 +161,59 @@ class SummarizationService {
                       SummaryLength length,
                       SummarizationCallback callback);
 
+  // Summarize content as |priority| work. Summaries nobody asked for yet
+  // should use PREFETCH so they yield to user requests; if the scheduler
+  // sheds the request, |callback| gets a failed result. Cancel
+  // |cancellation_token| (may be null) when the page goes away: a queued
+  // request is dropped, one in flight is aborted at the provider, and
+  // |callback| gets a failed result. The summary is traced as a span under
+  // |trace|, or as a trace of its own if |trace| is invalid.
+  void SummarizeContent(
+      const std::string& content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      SummarizationCallback callback);
+
+  // Like the above, and reports progress on long content. Content too long
+  // for one request is split into sections along paragraph breaks, the
+  // sections are summarized concurrently within the scheduler's and
+  // providers' limits, and the section summaries are combined into the
+  // final summary, so the time taken grows with the section size rather
+  // than the document's. |on_partial| (may be null) gets each section
+  // summary as it arrives. Shorter content is summarized in one request
+  // and reports no partial results.
+  void SummarizeLongContent(
+      const std::string& content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      PartialSummaryCallback on_partial,
+      SummarizationCallback callback);
+
+  // Like SummarizeContent(), and delivers the summary while it is being
+  // generated, so it can be shown before it is finished. |on_delta| gets
+  // each piece of text as the provider produces it, with the source links
+  // of the sentences it completed; |callback| then gets the whole result.
+  // For long content only the final combination of the section summaries
+  // is streamed. A cached summary arrives as one piece.
+  void SummarizeContentStreaming(
+      const std::string& content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      SummaryDeltaCallback on_delta,
+      SummarizationCallback callback);
+
   // Summarize content with default settings
   void SummarizeContent(const std::string& content,
                       const std::string& page_url,
@@ -97,34 +222,257 @@ class SummarizationService {
   // Check if content is summarizable
   bool IsContentSummarizable(const std::string& content) const;
 
+  // Link the sentences of |summary| to |original_content| as a finished
+  // summary is linked, for benchmarks
+  std::vector<SourceLink> GenerateSourceLinksForTesting(
+      const asol::core::SharedText& original_content,
+      const std::string& summary,
+      const std::string& page_url) {
+    return GenerateSourceLinks(original_content, summary, page_url);
+  }
+
   // Get a weak pointer to this instance
   base::WeakPtr<SummarizationService> GetWeakPtr();
 
  private:
+  // A range of the content summarized as one section
+  struct TextChunk {
+    size_t offset = 0;
+    size_t length = 0;
+  };
+
+  // A long document being summarized in sections
+  struct ChunkedJob {
+    ChunkedJob();
+    ~ChunkedJob();
+
+    asol::core::SharedText source_content;
+    std::string page_url;
+    SummaryFormat format;
+    SummaryLength length;
+    std::string cache_key;
+    asol::core::RequestPriority priority;
+    scoped_refptr<asol::core::CancellationToken> cancellation_token;
+    // The span of the whole summary
+    asol::core::TraceContext trace;
+    PartialSummaryCallback on_partial;
+    SummaryDeltaCallback on_delta;
+    SummarizationCallback callback;
+
+    // 0 while summarizing |source_content|; each further level summarizes
+    // the joined section summaries of the one before, in |level_content|
+    int level = 0;
+    std::string level_content;
+
+    std::vector<TextChunk> chunks;
+    std::vector<std::string> chunk_summaries;
+    size_t next_chunk = 0;
+    size_t in_flight = 0;
+    size_t completed = 0;
+  };
+
+  // Outcome of a request the service sent
+  using ResponseCallback =
+      base::OnceCallback<void(bool success, const std::string& response)>;
+
+  // Text of a response as it streams in
+  using TextCallback = base::RepeatingCallback<void(const std::string& text)>;
+
+  // Links summary sentences to the content sentences they came from.
+  // Shared by the summaries of one document.
+  class SourceLinker;
+
+  struct CachedSourceLinker {
+    asol::core::RequestFingerprint content_key;
+    scoped_refptr<SourceLinker> linker;
+  };
+
+  // A summary being streamed to the caller
+  struct StreamingJob {
+    StreamingJob();
+    ~StreamingJob();
+
+    std::string page_url;
+    SummaryFormat format;
+    SummaryLength length;
+    std::string cache_key;
+    SummaryDeltaCallback on_delta;
+    SummarizationCallback callback;
+    scoped_refptr<SourceLinker> linker;
+
+    // Received so far; sentences before |linked_length| have been linked
+    std::string summary_text;
+    size_t linked_length = 0;
+    std::vector<SourceLink> source_links;
+  };
+
+  // A response the provider is streaming
+  struct ActiveStream {
+    ActiveStream();
+    ~ActiveStream();
+
+    TextCallback on_text;
+    ResponseCallback on_response;
+
+    // Frees the scheduler slot
+    base::OnceClosure done;
+
+    // Received so far
+    std::string text;
+
+    base::CallbackListSubscription cancel_subscription;
+  };
+
   // Helper methods
-  void ProcessWithPrivacyProxy(const std::string& content,
-                             const std::string& page_url,
-                             SummaryFormat format,
-                             SummaryLength length,
-                             SummarizationCallback callback);
-
-  void ProcessWithAIService(const std::string& processed_content,
-                          const std::string& page_url,
-                          SummaryFormat format,
-                          SummaryLength length,
-                          SummarizationCallback callback);
-
-  void HandleAIResponse(const std::string& original_content,
+  void SummarizeContentInternal(
+      const std::string& content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      PartialSummaryCallback on_partial,
+      SummaryDeltaCallback on_delta,
+      SummarizationCallback callback);
+
+  void ProcessWithPrivacyProxy(
+      const std::string& content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      const std::string& cache_key,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      PartialSummaryCallback on_partial,
+      SummaryDeltaCallback on_delta,
+      SummarizationCallback callback);
+
+  void ProcessWithAIService(
+      const asol::core::SharedText& processed_content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      const std::string& cache_key,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      SummaryDeltaCallback on_delta,
+      SummarizationCallback callback);
+
+  asol::core::AIServiceManager::AIRequestParams MakeRequestParams(
+      std::string prompt,
+      size_t prompt_prefix_length,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace) const;
+
+  // Charge the budget for |params| and send it once the scheduler admits
+  // it. A request refused before it is sent (cancelled, over budget, shed)
+  // runs |on_error| with the result to report; otherwise |on_response|
+  // gets the provider's answer. With |on_text| (may be null) and a
+  // streaming service manager, the answer is streamed and |on_text| gets
+  // each piece before |on_response| gets the whole.
+  void RequestSummary(asol::core::AIServiceManager::AIRequestParams params,
+                      asol::core::RequestPriority priority,
+                      SummarizationCallback on_error,
+                      TextCallback on_text,
+                      ResponseCallback on_response);
+
+  // Issue the request once the scheduler admits it; |done| frees the slot
+  void SendToAIService(
+      const asol::core::AIServiceManager::AIRequestParams& params,
+      SummarizationCallback on_error,
+      TextCallback on_text,
+      ResponseCallback on_response,
+      base::OnceClosure done);
+
+  // Stream the answer to |params| from the streaming service manager
+  void StreamFromService(
+      const asol::core::AIServiceManager::AIRequestParams& params,
+      TextCallback on_text,
+      ResponseCallback on_response,
+      base::OnceClosure done);
+  void OnStreamEvent(int stream_id,
+                     bool success,
+                     const std::string& text,
+                     bool is_done);
+  void FinishStream(int stream_id, bool success, const std::string& error);
+
+  // Request the summary |callback| reports, of |original_content|. With
+  // |on_delta|, it is streamed and linked a sentence at a time.
+  void RequestFinalSummary(
+      asol::core::AIServiceManager::AIRequestParams params,
+      asol::core::RequestPriority priority,
+      asol::core::SharedText original_content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      const std::string& cache_key,
+      SummaryDeltaCallback on_delta,
+      SummarizationCallback callback);
+  void OnSummaryTextStreamed(int job_id, const std::string& text);
+  void OnStreamedSummaryComplete(int job_id,
+                                 bool success,
+                                 const std::string& response);
+  void OnStreamingJobFailed(int job_id, const SummaryResult& result);
+
+  // Map-reduce summarization of content too long for one request
+  void StartChunkedSummary(
+      const asol::core::SharedText& processed_content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      const std::string& cache_key,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      PartialSummaryCallback on_partial,
+      SummaryDeltaCallback on_delta,
+      SummarizationCallback callback);
+  void SendChunks(int job_id);
+  void OnChunkSummarized(int job_id,
+                         size_t index,
+                         bool success,
+                         const std::string& response);
+  void OnChunkFailed(int job_id, const SummaryResult& result);
+
+  // Split |text| into sections of at most |max_length| characters along
+  // paragraph breaks
+  static std::vector<TextChunk> SplitIntoChunks(std::string_view text,
+                                                size_t max_length);
+
+  void HandleAIResponse(const asol::core::SharedText& original_content,
                       const std::string& page_url,
                       SummaryFormat format,
                       SummaryLength length,
+                      const std::string& cache_key,
                       SummarizationCallback callback,
                       bool success,
                       const std::string& response);
 
+  // Keep |result| for later requests for the same content and options
+  void CacheSummary(const std::string& cache_key,
+                    const SummaryResult& result);
+
+  // Cost of |text| at the budget's default price, counted with the
+  // tokenizer of |provider_id|, or of the default summarization provider if
+  // it is empty; about four bytes per token if neither is registered
+  double EstimateCost(const std::string& provider_id, std::string_view text);
+
+  // The linker for |original_content|. Linkers of recent documents are
+  // kept, so summarizing one in another format or length, or again after
+  // its summary was evicted, does not index it again.
+  scoped_refptr<SourceLinker> GetSourceLinker(
+      const asol::core::SharedText& original_content);
+
   // Generate source links from original content and summary
   std::vector<SourceLink> GenerateSourceLinks(
-      const std::string& original_content,
+      const asol::core::SharedText& original_content,
       const std::string& summary,
       const std::string& page_url);
 
@@ -133,12 +481,37 @@ class SummarizationService {
                                 SummaryFormat format,
                                 SummaryLength length);
 
+  // Format the prompt that combines the section summaries of a long
+  // document into one summary
+  std::string FormatReducePrompt(const std::string& section_summaries,
+                                 SummaryFormat format,
+                                 SummaryLength length);
+
   // Components
   asol::core::AIServiceManager* ai_service_manager_ = nullptr;
   asol::core::PrivacyProxy* privacy_proxy_ = nullptr;
+  asol::core::RequestScheduler* request_scheduler_ = nullptr;
+  asol::core::BudgetManager* budget_manager_ = nullptr;
+  std::string local_provider_id_;
+  asol::core::ServiceManager* streaming_service_manager_ = nullptr;
+
+  // Recent summaries, by content, format and length
+  std::unique_ptr<SummaryCache> summary_cache_;
+
+  // Linkers of recently summarized documents, most recently used first
+  std::list<CachedSourceLinker> source_linkers_;
+
+  // Long documents being summarized, by job ID
+  std::unordered_map<int, std::unique_ptr<ChunkedJob>> chunked_jobs_;
+  int next_chunked_job_id_ = 1;
+
+  // Summaries being streamed to callers, by job ID
+  std::unordered_map<int, std::unique_ptr<StreamingJob>> streaming_jobs_;
+  int next_streaming_job_id_ = 1;
 
-  // Cache of recent summaries
-  std::unordered_map<std::string, SummaryResult> summary_cache_;
+  // Provider streams in progress, by stream ID
+  std::unordered_map<int, std::unique_ptr<ActiveStream>> active_streams_;
+  int next_stream_id_ = 1;
 
   // For weak pointers
   base::WeakPtrFactory<SummarizationService> weak_ptr_factory_{this};
@@ -154,25 +527,41 @@ class SummarizationService {
 #ifndef BROWSER_CORE_AI_SUMMARIZATION_SERVICE_H_
 #define BROWSER_CORE_AI_SUMMARIZATION_SERVICE_H_
 
+#include <stddef.h>
+
+#include <list>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
 #include "base/callback.h"
+#include "base/callback_list.h"
+#include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
+#include "asol/core/ai_service_manager.h"
+#include "asol/core/budget_manager.h"
+#include "asol/core/cancellation_token.h"
+#include "asol/core/request_fingerprint.h"
+#include "asol/core/request_scheduler.h"
+#include "asol/core/shared_text.h"
+#include "asol/core/trace_context.h"
+#include "base/memory/scoped_refptr.h"
 
 namespace asol {
 namespace core {
-class AIServiceManager;
 class PrivacyProxy;
+class ServiceManager;
 }  // namespace core
 }  // namespace asol
 
 namespace browser_core {
 namespace ai {
 
+class SummaryCache;
+
 // SummarizationService provides AI-powered summarization capabilities for web content.
 // It integrates with the ASOL layer to leverage the best AI model for summarization
 // while ensuring privacy protection.
@@ -202,6 +591,10 @@ class SummarizationService {
     std::string url_fragment;
     int paragraph_index;
     int sentence_index;
+
+    // Where |text_snippet| is in the summarized content
+    size_t text_offset = 0;
+    size_t text_length = 0;
   };
 
   // Summary result
@@ -216,10 +609,37 @@ class SummarizationService {
     base::Time timestamp;
   };
 
+  // The summary of one section of a long document, delivered as soon as
+  // it is ready and before the summary of the whole
+  struct PartialSummary {
+    size_t section_index = 0;
+    size_t section_count = 0;
+    std::string summary_text;
+
+    // The section's range of the summarized content
+    size_t text_offset = 0;
+    size_t text_length = 0;
+  };
+
+  // A piece of a summary as it is generated
+  struct SummaryDelta {
+    // Text to append to the summary delivered so far
+    std::string text;
+
+    // Links for the summary sentences this piece completed
+    std::vector<SourceLink> source_links;
+  };
+
   // Callback for summarization requests
   using SummarizationCallback = 
       base::OnceCallback<void(const SummaryResult& result)>;
 
+  using PartialSummaryCallback =
+      base::RepeatingCallback<void(const PartialSummary& partial)>;
+
+  using SummaryDeltaCallback =
+      base::RepeatingCallback<void(const SummaryDelta& delta)>;
+
   SummarizationService();
   ~SummarizationService();
 
@@ -231,6 +651,31 @@ class SummarizationService {
   bool Initialize(asol::core::AIServiceManager* ai_service_manager,
                 asol::core::PrivacyProxy* privacy_proxy);
 
+  // Send AI requests through |scheduler| so they share provider capacity
+  // with the rest of the browser. Optional; not owned.
+  void SetRequestScheduler(asol::core::RequestScheduler* scheduler);
+
+  // Charge requests to the "summarization" feature budget. Prefetch and
+  // background summaries are refused once it runs low, so automatic
+  // summarization cannot spend without bound. Optional; not owned.
+  void SetBudgetManager(asol::core::BudgetManager* budget_manager);
+
+  // Once the budget allows only local work, summarize with |provider_id|,
+  // an on-device provider registered with the AIServiceManager, instead of
+  // refusing. Its summaries are not charged. Empty (the default) refuses.
+  void SetLocalProviderId(const std::string& provider_id);
+
+  // Stream summaries for SummarizeContentStreaming() from the adapters
+  // |service_manager| routes "summarization" to. Without it, streamed
+  // summaries arrive as one piece. Optional; not owned.
+  void SetStreamingServiceManager(
+      asol::core::ServiceManager* service_manager);
+
+  // Keep summaries on disk at |path|, within |max_bytes|, so repeat
+  // summaries stay instant across restarts. Lookups and stores then do
+  // blocking file IO.
+  void EnablePersistentCache(const base::FilePath& path, size_t max_bytes);
+
   // Summarize content with specified format and length
   void SummarizeContent(const std::string& content,
                       const std::string& page_url,
@@ -238,6 +683,59 @@ class SummarizationService {
                       SummaryLength length,
                       SummarizationCallback callback);
 
+  // Summarize content as |priority| work. Summaries nobody asked for yet
+  // should use PREFETCH so they yield to user requests; if the scheduler
+  // sheds the request, |callback| gets a failed result. Cancel
+  // |cancellation_token| (may be null) when the page goes away: a queued
+  // request is dropped, one in flight is aborted at the provider, and
+  // |callback| gets a failed result. The summary is traced as a span under
+  // |trace|, or as a trace of its own if |trace| is invalid.
+  void SummarizeContent(
+      const std::string& content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      SummarizationCallback callback);
+
+  // Like the above, and reports progress on long content. Content too long
+  // for one request is split into sections along paragraph breaks, the
+  // sections are summarized concurrently within the scheduler's and
+  // providers' limits, and the section summaries are combined into the
+  // final summary, so the time taken grows with the section size rather
+  // than the document's. |on_partial| (may be null) gets each section
+  // summary as it arrives. Shorter content is summarized in one request
+  // and reports no partial results.
+  void SummarizeLongContent(
+      const std::string& content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      PartialSummaryCallback on_partial,
+      SummarizationCallback callback);
+
+  // Like SummarizeContent(), and delivers the summary while it is being
+  // generated, so it can be shown before it is finished. |on_delta| gets
+  // each piece of text as the provider produces it, with the source links
+  // of the sentences it completed; |callback| then gets the whole result.
+  // For long content only the final combination of the section summaries
+  // is streamed. A cached summary arrives as one piece.
+  void SummarizeContentStreaming(
+      const std::string& content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      SummaryDeltaCallback on_delta,
+      SummarizationCallback callback);
+
   // Summarize content with default settings
   void SummarizeContent(const std::string& content,
                       const std::string& page_url,
@@ -246,34 +744,257 @@ class SummarizationService {
   // Check if content is summarizable
   bool IsContentSummarizable(const std::string& content) const;
 
+  // Link the sentences of |summary| to |original_content| as a finished
+  // summary is linked, for benchmarks
+  std::vector<SourceLink> GenerateSourceLinksForTesting(
+      const asol::core::SharedText& original_content,
+      const std::string& summary,
+      const std::string& page_url) {
+    return GenerateSourceLinks(original_content, summary, page_url);
+  }
+
   // Get a weak pointer to this instance
   base::WeakPtr<SummarizationService> GetWeakPtr();
 
  private:
+  // A range of the content summarized as one section
+  struct TextChunk {
+    size_t offset = 0;
+    size_t length = 0;
+  };
+
+  // A long document being summarized in sections
+  struct ChunkedJob {
+    ChunkedJob();
+    ~ChunkedJob();
+
+    asol::core::SharedText source_content;
+    std::string page_url;
+    SummaryFormat format;
+    SummaryLength length;
+    std::string cache_key;
+    asol::core::RequestPriority priority;
+    scoped_refptr<asol::core::CancellationToken> cancellation_token;
+    // The span of the whole summary
+    asol::core::TraceContext trace;
+    PartialSummaryCallback on_partial;
+    SummaryDeltaCallback on_delta;
+    SummarizationCallback callback;
+
+    // 0 while summarizing |source_content|; each further level summarizes
+    // the joined section summaries of the one before, in |level_content|
+    int level = 0;
+    std::string level_content;
+
+    std::vector<TextChunk> chunks;
+    std::vector<std::string> chunk_summaries;
+    size_t next_chunk = 0;
+    size_t in_flight = 0;
+    size_t completed = 0;
+  };
+
+  // Outcome of a request the service sent
+  using ResponseCallback =
+      base::OnceCallback<void(bool success, const std::string& response)>;
+
+  // Text of a response as it streams in
+  using TextCallback = base::RepeatingCallback<void(const std::string& text)>;
+
+  // Links summary sentences to the content sentences they came from.
+  // Shared by the summaries of one document.
+  class SourceLinker;
+
+  struct CachedSourceLinker {
+    asol::core::RequestFingerprint content_key;
+    scoped_refptr<SourceLinker> linker;
+  };
+
+  // A summary being streamed to the caller
+  struct StreamingJob {
+    StreamingJob();
+    ~StreamingJob();
+
+    std::string page_url;
+    SummaryFormat format;
+    SummaryLength length;
+    std::string cache_key;
+    SummaryDeltaCallback on_delta;
+    SummarizationCallback callback;
+    scoped_refptr<SourceLinker> linker;
+
+    // Received so far; sentences before |linked_length| have been linked
+    std::string summary_text;
+    size_t linked_length = 0;
+    std::vector<SourceLink> source_links;
+  };
+
+  // A response the provider is streaming
+  struct ActiveStream {
+    ActiveStream();
+    ~ActiveStream();
+
+    TextCallback on_text;
+    ResponseCallback on_response;
+
+    // Frees the scheduler slot
+    base::OnceClosure done;
+
+    // Received so far
+    std::string text;
+
+    base::CallbackListSubscription cancel_subscription;
+  };
+
   // Helper methods
-  void ProcessWithPrivacyProxy(const std::string& content,
-                             const std::string& page_url,
-                             SummaryFormat format,
-                             SummaryLength length,
-                             SummarizationCallback callback);
-
-  void ProcessWithAIService(const std::string& processed_content,
-                          const std::string& page_url,
-                          SummaryFormat format,
-                          SummaryLength length,
-                          SummarizationCallback callback);
-
-  void HandleAIResponse(const std::string& original_content,
+  void SummarizeContentInternal(
+      const std::string& content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      PartialSummaryCallback on_partial,
+      SummaryDeltaCallback on_delta,
+      SummarizationCallback callback);
+
+  void ProcessWithPrivacyProxy(
+      const std::string& content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      const std::string& cache_key,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      PartialSummaryCallback on_partial,
+      SummaryDeltaCallback on_delta,
+      SummarizationCallback callback);
+
+  void ProcessWithAIService(
+      const asol::core::SharedText& processed_content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      const std::string& cache_key,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      SummaryDeltaCallback on_delta,
+      SummarizationCallback callback);
+
+  asol::core::AIServiceManager::AIRequestParams MakeRequestParams(
+      std::string prompt,
+      size_t prompt_prefix_length,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace) const;
+
+  // Charge the budget for |params| and send it once the scheduler admits
+  // it. A request refused before it is sent (cancelled, over budget, shed)
+  // runs |on_error| with the result to report; otherwise |on_response|
+  // gets the provider's answer. With |on_text| (may be null) and a
+  // streaming service manager, the answer is streamed and |on_text| gets
+  // each piece before |on_response| gets the whole.
+  void RequestSummary(asol::core::AIServiceManager::AIRequestParams params,
+                      asol::core::RequestPriority priority,
+                      SummarizationCallback on_error,
+                      TextCallback on_text,
+                      ResponseCallback on_response);
+
+  // Issue the request once the scheduler admits it; |done| frees the slot
+  void SendToAIService(
+      const asol::core::AIServiceManager::AIRequestParams& params,
+      SummarizationCallback on_error,
+      TextCallback on_text,
+      ResponseCallback on_response,
+      base::OnceClosure done);
+
+  // Stream the answer to |params| from the streaming service manager
+  void StreamFromService(
+      const asol::core::AIServiceManager::AIRequestParams& params,
+      TextCallback on_text,
+      ResponseCallback on_response,
+      base::OnceClosure done);
+  void OnStreamEvent(int stream_id,
+                     bool success,
+                     const std::string& text,
+                     bool is_done);
+  void FinishStream(int stream_id, bool success, const std::string& error);
+
+  // Request the summary |callback| reports, of |original_content|. With
+  // |on_delta|, it is streamed and linked a sentence at a time.
+  void RequestFinalSummary(
+      asol::core::AIServiceManager::AIRequestParams params,
+      asol::core::RequestPriority priority,
+      asol::core::SharedText original_content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      const std::string& cache_key,
+      SummaryDeltaCallback on_delta,
+      SummarizationCallback callback);
+  void OnSummaryTextStreamed(int job_id, const std::string& text);
+  void OnStreamedSummaryComplete(int job_id,
+                                 bool success,
+                                 const std::string& response);
+  void OnStreamingJobFailed(int job_id, const SummaryResult& result);
+
+  // Map-reduce summarization of content too long for one request
+  void StartChunkedSummary(
+      const asol::core::SharedText& processed_content,
+      const std::string& page_url,
+      SummaryFormat format,
+      SummaryLength length,
+      const std::string& cache_key,
+      asol::core::RequestPriority priority,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const asol::core::TraceContext& trace,
+      PartialSummaryCallback on_partial,
+      SummaryDeltaCallback on_delta,
+      SummarizationCallback callback);
+  void SendChunks(int job_id);
+  void OnChunkSummarized(int job_id,
+                         size_t index,
+                         bool success,
+                         const std::string& response);
+  void OnChunkFailed(int job_id, const SummaryResult& result);
+
+  // Split |text| into sections of at most |max_length| characters along
+  // paragraph breaks
+  static std::vector<TextChunk> SplitIntoChunks(std::string_view text,
+                                                size_t max_length);
+
+  void HandleAIResponse(const asol::core::SharedText& original_content,
                       const std::string& page_url,
                       SummaryFormat format,
                       SummaryLength length,
+                      const std::string& cache_key,
                       SummarizationCallback callback,
                       bool success,
                       const std::string& response);
 
+  // Keep |result| for later requests for the same content and options
+  void CacheSummary(const std::string& cache_key,
+                    const SummaryResult& result);
+
+  // Cost of |text| at the budget's default price, counted with the
+  // tokenizer of |provider_id|, or of the default summarization provider if
+  // it is empty; about four bytes per token if neither is registered
+  double EstimateCost(const std::string& provider_id, std::string_view text);
+
+  // The linker for |original_content|. Linkers of recent documents are
+  // kept, so summarizing one in another format or length, or again after
+  // its summary was evicted, does not index it again.
+  scoped_refptr<SourceLinker> GetSourceLinker(
+      const asol::core::SharedText& original_content);
+
   // Generate source links from original content and summary
   std::vector<SourceLink> GenerateSourceLinks(
-      const std::string& original_content,
+      const asol::core::SharedText& original_content,
       const std::string& summary,
       const std::string& page_url);
 
@@ -282,12 +1003,37 @@ class SummarizationService {
                                 SummaryFormat format,
                                 SummaryLength length);
 
+  // Format the prompt that combines the section summaries of a long
+  // document into one summary
+  std::string FormatReducePrompt(const std::string& section_summaries,
+                                 SummaryFormat format,
+                                 SummaryLength length);
+
   // Components
   asol::core::AIServiceManager* ai_service_manager_ = nullptr;
   asol::core::PrivacyProxy* privacy_proxy_ = nullptr;
+  asol::core::RequestScheduler* request_scheduler_ = nullptr;
+  asol::core::BudgetManager* budget_manager_ = nullptr;
+  std::string local_provider_id_;
+  asol::core::ServiceManager* streaming_service_manager_ = nullptr;
+
+  // Recent summaries, by content, format and length
+  std::unique_ptr<SummaryCache> summary_cache_;
+
+  // Linkers of recently summarized documents, most recently used first
+  std::list<CachedSourceLinker> source_linkers_;
+
+  // Long documents being summarized, by job ID
+  std::unordered_map<int, std::unique_ptr<ChunkedJob>> chunked_jobs_;
+  int next_chunked_job_id_ = 1;
+
+  // Summaries being streamed to callers, by job ID
+  std::unordered_map<int, std::unique_ptr<StreamingJob>> streaming_jobs_;
+  int next_streaming_job_id_ = 1;
 
-  // Cache of recent summaries
-  std::unordered_map<std::string, SummaryResult> summary_cache_;
+  // Provider streams in progress, by stream ID
+  std::unordered_map<int, std::unique_ptr<ActiveStream>> active_streams_;
+  int next_stream_id_ = 1;
 
   // For weak pointers
   base::WeakPtrFactory<SummarizationService> weak_ptr_factory_{this};
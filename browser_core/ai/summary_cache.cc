@@ -0,0 +1,238 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ai/summary_cache.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+
+#include "asol/core/persistent_response_store.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+#include "crypto/secure_hash.h"
+#include "crypto/sha2.h"
+
+namespace browser_core {
+namespace ai {
+
+namespace {
+
+using SummaryResult = SummarizationService::SummaryResult;
+using SourceLink = SummarizationService::SourceLink;
+
+// Approximate bookkeeping cost of one entry (list node, index slot)
+constexpr size_t kEntryOverheadBytes = 128;
+
+// Approximate cost of one source link besides its strings
+constexpr size_t kLinkOverheadBytes = sizeof(SourceLink);
+
+// Approximate cost of one metadata pair besides its strings
+constexpr size_t kMetadataOverheadBytes = 2 * sizeof(std::string) + 32;
+
+size_t ComputeCharge(const SummaryResult& result) {
+  size_t charge = kEntryOverheadBytes + result.summary_text.size() +
+                  result.error_message.size();
+  for (const SourceLink& link : result.source_links) {
+    charge += kLinkOverheadBytes + link.text_snippet.size() +
+              link.anchor_text.size() + link.url_fragment.size();
+  }
+  for (const auto& [name, value] : result.metadata) {
+    charge += kMetadataOverheadBytes + name.size() + value.size();
+  }
+  return charge;
+}
+
+std::string SerializeResult(const SummaryResult& result) {
+  base::Value::List links;
+  for (const SourceLink& link : result.source_links) {
+    base::Value::Dict entry;
+    entry.Set("snippet", link.text_snippet);
+    entry.Set("anchor", link.anchor_text);
+    entry.Set("fragment", link.url_fragment);
+    entry.Set("paragraph", link.paragraph_index);
+    entry.Set("sentence", link.sentence_index);
+    entry.Set("offset", static_cast<int>(link.text_offset));
+    entry.Set("length", static_cast<int>(link.text_length));
+    links.Append(std::move(entry));
+  }
+  base::Value::Dict metadata;
+  for (const auto& [name, value] : result.metadata) {
+    metadata.Set(name, value);
+  }
+
+  base::Value::Dict record;
+  record.Set("text", result.summary_text);
+  record.Set("format", static_cast<int>(result.format));
+  record.Set("length", static_cast<int>(result.length));
+  record.Set("timestamp", result.timestamp.ToDoubleT());
+  record.Set("links", std::move(links));
+  record.Set("metadata", std::move(metadata));
+
+  std::string json;
+  base::JSONWriter::Write(record, &json);
+  return json;
+}
+
+bool DeserializeResult(const std::string& json, SummaryResult* result) {
+  absl::optional<base::Value> value = base::JSONReader::Read(json);
+  if (!value || !value->is_dict()) {
+    return false;
+  }
+  const base::Value::Dict& record = value->GetDict();
+  const std::string* text = record.FindString("text");
+  absl::optional<int> format = record.FindInt("format");
+  absl::optional<int> length = record.FindInt("length");
+  absl::optional<double> timestamp = record.FindDouble("timestamp");
+  if (!text || !format || !length || !timestamp) {
+    return false;
+  }
+
+  *result = SummaryResult();
+  result->summary_text = *text;
+  result->format = static_cast<SummarizationService::SummaryFormat>(*format);
+  result->length = static_cast<SummarizationService::SummaryLength>(*length);
+  result->timestamp = base::Time::FromDoubleT(*timestamp);
+  result->success = true;
+
+  if (const base::Value::List* links = record.FindList("links")) {
+    for (const base::Value& item : *links) {
+      if (!item.is_dict()) {
+        continue;
+      }
+      const base::Value::Dict& entry = item.GetDict();
+      SourceLink link;
+      if (const std::string* snippet = entry.FindString("snippet")) {
+        link.text_snippet = *snippet;
+      }
+      if (const std::string* anchor = entry.FindString("anchor")) {
+        link.anchor_text = *anchor;
+      }
+      if (const std::string* fragment = entry.FindString("fragment")) {
+        link.url_fragment = *fragment;
+      }
+      link.paragraph_index = entry.FindInt("paragraph").value_or(0);
+      link.sentence_index = entry.FindInt("sentence").value_or(0);
+      link.text_offset = entry.FindInt("offset").value_or(0);
+      link.text_length = entry.FindInt("length").value_or(0);
+      result->source_links.push_back(std::move(link));
+    }
+  }
+  if (const base::Value::Dict* metadata = record.FindDict("metadata")) {
+    for (const auto [name, item] : *metadata) {
+      if (item.is_string()) {
+        result->metadata[name] = item.GetString();
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+SummaryCache::SummaryCache(size_t max_bytes, base::TimeDelta time_to_live)
+    : max_bytes_(max_bytes), time_to_live_(time_to_live) {}
+
+SummaryCache::~SummaryCache() = default;
+
+// static
+SummaryCache::Key SummaryCache::ComputeKey(
+    std::string_view content,
+    SummarizationService::SummaryFormat format,
+    SummarizationService::SummaryLength length) {
+  std::unique_ptr<crypto::SecureHash> hash =
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256);
+  uint64_t options[] = {static_cast<uint64_t>(format),
+                        static_cast<uint64_t>(length)};
+  hash->Update(options, sizeof(options));
+  hash->Update(content.data(), content.size());
+  Key key(crypto::kSHA256Length, '\0');
+  hash->Finish(key.data(), key.size());
+  return key;
+}
+
+void SummaryCache::SetPersistentStore(
+    std::unique_ptr<asol::core::PersistentResponseStore> store) {
+  persistent_store_ = std::move(store);
+  if (persistent_store_) {
+    persistent_store_->SetTimeToLive(time_to_live_);
+  }
+}
+
+bool SummaryCache::Get(const Key& key, SummaryResult* result) {
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    if (!IsExpired(it->second->result)) {
+      ++hits_;
+      lru_.splice(lru_.begin(), lru_, it->second);
+      *result = it->second->result;
+      return true;
+    }
+    Erase(it);
+  }
+
+  std::string record;
+  if (persistent_store_ &&
+      persistent_store_->Get(base::HexEncode(key.data(), key.size()),
+                             &record) &&
+      DeserializeResult(record, result) && !IsExpired(*result)) {
+    ++hits_;
+    ++persistent_hits_;
+    Insert(key, *result);
+    return true;
+  }
+  ++misses_;
+  return false;
+}
+
+void SummaryCache::Put(const Key& key, const SummaryResult& result) {
+  Insert(key, result);
+  if (persistent_store_) {
+    persistent_store_->Put(base::HexEncode(key.data(), key.size()),
+                           SerializeResult(result));
+  }
+}
+
+void SummaryCache::Clear() {
+  index_.clear();
+  lru_.clear();
+  bytes_ = 0;
+  if (persistent_store_) {
+    persistent_store_->Clear();
+  }
+}
+
+bool SummaryCache::IsExpired(const SummaryResult& result) const {
+  return base::Time::Now() - result.timestamp >= time_to_live_;
+}
+
+void SummaryCache::Insert(const Key& key, const SummaryResult& result) {
+  auto existing = index_.find(key);
+  if (existing != index_.end()) {
+    Erase(existing);
+  }
+
+  size_t charge = ComputeCharge(result);
+  if (charge > max_bytes_) {
+    return;
+  }
+  while (!lru_.empty() && bytes_ + charge > max_bytes_) {
+    Erase(index_.find(lru_.back().key));
+  }
+  bytes_ += charge;
+  lru_.push_front({key, result, charge});
+  index_[key] = lru_.begin();
+}
+
+void SummaryCache::Erase(Index::iterator it) {
+  bytes_ -= it->second->charge;
+  lru_.erase(it->second);
+  index_.erase(it);
+}
+
+}  // namespace ai
+}  // namespace browser_core
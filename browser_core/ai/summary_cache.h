@@ -0,0 +1,117 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_AI_SUMMARY_CACHE_H_
+#define BROWSER_CORE_AI_SUMMARY_CACHE_H_
+
+#include <stddef.h>
+
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "base/time/time.h"
+#include "browser_core/ai/summarization_service.h"
+
+namespace asol {
+namespace core {
+class PersistentResponseStore;
+}  // namespace core
+}  // namespace asol
+
+namespace browser_core {
+namespace ai {
+
+// SummaryCache remembers recent summaries so asking again for the summary
+// of the same content is instant.
+//
+// Entries are keyed by a SHA-256 digest of the summarized content and the
+// format and length asked for, so the same article reached through
+// different URLs is summarized once, and a page whose content changed is
+// summarized again. The digest stands in for the content: a page cannot be
+// crafted to collide with another and be served its summary, and no
+// content is kept to check hits against.
+// Bounded by an estimate of the bytes held, and evicts least recently used
+// summaries first. Entries older than the time to live are misses.
+//
+// With a persistent store, misses consult the store and summaries are
+// written through, so they survive restarts. The store does blocking file
+// IO on the calling sequence.
+//
+// Must be used on one sequence.
+class SummaryCache {
+ public:
+  // Raw SHA-256 digest
+  using Key = std::string;
+
+  static constexpr size_t kDefaultMaxBytes = 4 * 1024 * 1024;
+  static constexpr base::TimeDelta kDefaultTimeToLive = base::Hours(24);
+
+  explicit SummaryCache(size_t max_bytes = kDefaultMaxBytes,
+                        base::TimeDelta time_to_live = kDefaultTimeToLive);
+  ~SummaryCache();
+
+  SummaryCache(const SummaryCache&) = delete;
+  SummaryCache& operator=(const SummaryCache&) = delete;
+
+  static Key ComputeKey(std::string_view content,
+                        SummarizationService::SummaryFormat format,
+                        SummarizationService::SummaryLength length);
+
+  // Also keep summaries in |store|, replacing any store set before. Null
+  // turns persistence off.
+  void SetPersistentStore(
+      std::unique_ptr<asol::core::PersistentResponseStore> store);
+
+  // Copy the summary cached under |key| to |result|. Returns false if
+  // there is none or it expired.
+  bool Get(const Key& key, SummarizationService::SummaryResult* result);
+
+  // Remember |result| under |key|. Summaries larger than the whole budget
+  // are only persisted.
+  void Put(const Key& key, const SummarizationService::SummaryResult& result);
+
+  // Forget every summary, on disk too
+  void Clear();
+
+  size_t GetHitCount() const { return hits_; }
+  size_t GetMissCount() const { return misses_; }
+  size_t GetPersistentHitCount() const { return persistent_hits_; }
+  size_t GetByteSize() const { return bytes_; }
+  size_t GetEntryCount() const { return index_.size(); }
+
+ private:
+  struct Entry {
+    Key key;
+    SummarizationService::SummaryResult result;
+    size_t charge = 0;
+  };
+  using LruList = std::list<Entry>;
+  using Index = std::unordered_map<Key, LruList::iterator>;
+
+  bool IsExpired(const SummarizationService::SummaryResult& result) const;
+
+  // Add |result| to memory only, evicting as needed
+  void Insert(const Key& key, const SummarizationService::SummaryResult& result);
+  void Erase(Index::iterator it);
+
+  const size_t max_bytes_;
+  const base::TimeDelta time_to_live_;
+  size_t bytes_ = 0;
+  LruList lru_;
+  Index index_;
+
+  std::unique_ptr<asol::core::PersistentResponseStore> persistent_store_;
+
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+  size_t persistent_hits_ = 0;
+};
+
+}  // namespace ai
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_AI_SUMMARY_CACHE_H_
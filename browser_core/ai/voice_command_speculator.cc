@@ -0,0 +1,96 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ai/voice_command_speculator.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace browser_core {
+namespace ai {
+
+VoiceCommandSpeculator::Preparation::Preparation() = default;
+VoiceCommandSpeculator::Preparation::Preparation(Preparation&&) = default;
+VoiceCommandSpeculator::Preparation&
+VoiceCommandSpeculator::Preparation::operator=(Preparation&&) = default;
+VoiceCommandSpeculator::Preparation::~Preparation() = default;
+
+VoiceCommandSpeculator::VoiceCommandSpeculator(
+    const VoiceIntentClassifier* classifier)
+    : classifier_(classifier) {}
+
+VoiceCommandSpeculator::~VoiceCommandSpeculator() {
+  Reset();
+}
+
+void VoiceCommandSpeculator::SetPrepareCallback(PrepareCallback callback) {
+  prepare_callback_ = std::move(callback);
+}
+
+void VoiceCommandSpeculator::OnPartialHypothesis(std::string_view text) {
+  VoiceIntent intent = classifier_->MatchPatterns(text);
+  if (intent.confidence < VoiceIntentClassifier::kMinConfidence) {
+    candidate_count_ = 0;
+    return;
+  }
+  if (candidate_count_ > 0 && IsSameIntent(intent, candidate_)) {
+    ++candidate_count_;
+  } else {
+    candidate_ = std::move(intent);
+    candidate_count_ = 1;
+  }
+
+  if (candidate_count_ != kStableHypotheses || !prepare_callback_) {
+    return;
+  }
+  bool already_prepared = std::any_of(
+      preparations_.begin(), preparations_.end(),
+      [this](const Preparation& preparation) {
+        return IsSameIntent(preparation.intent, candidate_);
+      });
+  if (already_prepared) {
+    return;
+  }
+  Preparation preparation;
+  preparation.intent = candidate_;
+  preparation.cancellation_token =
+      base::MakeRefCounted<asol::core::CancellationToken>();
+  prepare_callback_.Run(preparation.intent, preparation.cancellation_token);
+  preparations_.push_back(std::move(preparation));
+}
+
+VoiceCommandSpeculator::FinalIntent VoiceCommandSpeculator::OnFinalHypothesis(
+    std::string_view text) {
+  FinalIntent final_intent;
+  final_intent.intent = classifier_->MatchPatterns(text);
+  for (Preparation& preparation : preparations_) {
+    if (!final_intent.prepared &&
+        IsSameIntent(preparation.intent, final_intent.intent)) {
+      final_intent.prepared = true;
+      continue;
+    }
+    preparation.cancellation_token->Cancel();
+  }
+  preparations_.clear();
+  candidate_count_ = 0;
+  return final_intent;
+}
+
+void VoiceCommandSpeculator::Reset() {
+  for (Preparation& preparation : preparations_) {
+    preparation.cancellation_token->Cancel();
+  }
+  preparations_.clear();
+  candidate_count_ = 0;
+}
+
+// static
+bool VoiceCommandSpeculator::IsSameIntent(const VoiceIntent& a,
+                                          const VoiceIntent& b) {
+  return a.type == b.type && a.action == b.action &&
+         a.parameters == b.parameters;
+}
+
+}  // namespace ai
+}  // namespace browser_core
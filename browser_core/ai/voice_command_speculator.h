@@ -0,0 +1,94 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_AI_VOICE_COMMAND_SPECULATOR_H_
+#define BROWSER_CORE_AI_VOICE_COMMAND_SPECULATOR_H_
+
+#include <string_view>
+#include <vector>
+
+#include "asol/core/cancellation_token.h"
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "browser_core/ai/voice_intent_classifier.h"
+
+namespace browser_core {
+namespace ai {
+
+// VoiceCommandSpeculator runs the partial hypotheses of an utterance
+// through the local intent grammar, so that a command can be prepared
+// while it is still being spoken, e.g. connecting to the site of "open
+// example.com", and runs at the end of speech with nothing left to do.
+//
+// Recognizers revise partials as more audio arrives ("open example.co"
+// before "open example.com"), so an intent is prepared only once it is
+// confident and the same over kStableHypotheses partials in a row.
+// Preparations the final hypothesis does not confirm are cancelled.
+class VoiceCommandSpeculator {
+ public:
+  // Prepare |intent| ahead of time. Preparing must be cheap and safe to
+  // throw away; work still running when |cancellation_token| is cancelled
+  // should stop.
+  using PrepareCallback = base::RepeatingCallback<void(
+      const VoiceIntent& intent,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token)>;
+
+  // Consecutive partials that must agree before an intent is prepared
+  static constexpr int kStableHypotheses = 2;
+
+  struct FinalIntent {
+    VoiceIntent intent;
+    // Whether |intent| was prepared from the partials
+    bool prepared = false;
+  };
+
+  // |classifier| must outlive this
+  explicit VoiceCommandSpeculator(const VoiceIntentClassifier* classifier);
+  ~VoiceCommandSpeculator();
+
+  VoiceCommandSpeculator(const VoiceCommandSpeculator&) = delete;
+  VoiceCommandSpeculator& operator=(const VoiceCommandSpeculator&) = delete;
+
+  // Nothing is prepared until this is set
+  void SetPrepareCallback(PrepareCallback callback);
+
+  // A partial hypothesis of the current utterance, as a whole
+  void OnPartialHypothesis(std::string_view text);
+
+  // End of the utterance: the intent of |text|. Preparations of other
+  // intents are cancelled and the speculator is ready for the next
+  // utterance.
+  FinalIntent OnFinalHypothesis(std::string_view text);
+
+  // Abandon the utterance, cancelling all its preparations
+  void Reset();
+
+ private:
+  struct Preparation {
+    Preparation();
+    Preparation(Preparation&&);
+    Preparation& operator=(Preparation&&);
+    ~Preparation();
+
+    VoiceIntent intent;
+    scoped_refptr<asol::core::CancellationToken> cancellation_token;
+  };
+
+  static bool IsSameIntent(const VoiceIntent& a, const VoiceIntent& b);
+
+  const VoiceIntentClassifier* const classifier_;
+  PrepareCallback prepare_callback_;
+
+  // Intent of the latest partials and how many in a row had it
+  VoiceIntent candidate_;
+  int candidate_count_ = 0;
+
+  // Intents prepared during the current utterance
+  std::vector<Preparation> preparations_;
+};
+
+}  // namespace ai
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_AI_VOICE_COMMAND_SPECULATOR_H_
@@ -15,9 +15,19 @@
 #include "asol/core/ai_service_manager.h"
 #include "browser_core/engine/browser_engine.h"
 
+namespace asol {
+namespace core {
+class LocalAIProcessor;
+}  // namespace core
+}  // namespace asol
+
 namespace browser_core {
 namespace ai {
 
+class VoiceCommandSpeculator;
+class VoiceIntentClassifier;
+struct VoiceIntent;
+
 // VoiceCommandSystem provides voice interaction capabilities for the browser.
 class VoiceCommandSystem {
  public:
@@ -51,11 +61,15 @@ class VoiceCommandSystem {
     std::string text;
     float confidence;
     std::string error_message;
+    // False for a partial hypothesis of an utterance still being spoken
+    bool is_final = true;
   };
 
   // Callback for voice recognition
   using VoiceRecognitionCallback = 
       base::OnceCallback<void(const VoiceRecognitionResult&)>;
+  using PartialRecognitionCallback =
+      base::RepeatingCallback<void(const VoiceRecognitionResult&)>;
 
   VoiceCommandSystem();
   ~VoiceCommandSystem();
@@ -68,16 +82,28 @@ class VoiceCommandSystem {
   bool Initialize(BrowserEngine* browser_engine, 
                 asol::core::AIServiceManager* ai_service_manager);
 
-  // Start listening for voice commands
+  // Start listening for voice commands. Partial hypotheses go through the
+  // intent grammar as they arrive, so unambiguous commands are prepared
+  // (see VoiceCommandSpeculator) before the final result is delivered to
+  // |callback|.
   void StartListening(VoiceRecognitionCallback callback);
 
+  // Also deliver partial hypotheses to |callback|, e.g. for live captions
+  void SetPartialRecognitionCallback(PartialRecognitionCallback callback);
+
   // Stop listening
   void StopListening();
 
-  // Process a voice command
+  // Process a voice command. Common commands are recognized on the device
+  // by VoiceIntentClassifier and handled without a network round trip;
+  // the AI service classifies only those it is not confident about.
   void ProcessCommand(const std::string& command_text, 
                     CommandResultCallback callback);
 
+  // Local model the intent classifier falls back to before the AI
+  // service. Not owned; may be null.
+  void SetLocalAIProcessor(asol::core::LocalAIProcessor* processor);
+
   // Check if the system is currently listening
   bool IsListening() const;
 
@@ -114,6 +140,16 @@ class VoiceCommandSystem {
   // Classify command type
   CommandType ClassifyCommand(const std::string& command);
 
+  // Feed a partial hypothesis to the speculator and to the partial
+  // recognition callback
+  void OnPartialRecognition(const VoiceRecognitionResult& result);
+
+  // Dispatch |command| to the handler for |intent|, or have the AI service
+  // classify it if |intent| is below VoiceIntentClassifier::kMinConfidence
+  void OnCommandClassified(const std::string& command,
+                           CommandResultCallback callback,
+                           const VoiceIntent& intent);
+
   // Parse command parameters
   std::unordered_map<std::string, std::string> ParseCommandParameters(
       const std::string& command, CommandType command_type);
@@ -122,6 +158,14 @@ class VoiceCommandSystem {
   BrowserEngine* browser_engine_ = nullptr;
   asol::core::AIServiceManager* ai_service_manager_ = nullptr;
 
+  // Local fast path for command classification
+  std::unique_ptr<VoiceIntentClassifier> intent_classifier_;
+
+  // Prepares commands from partial hypotheses; ProcessCommand runs a
+  // prepared intent without classifying it again
+  std::unique_ptr<VoiceCommandSpeculator> speculator_;
+  PartialRecognitionCallback partial_recognition_callback_;
+
   // Voice recognition state
   bool is_listening_ = false;
   bool is_enabled_ = true;
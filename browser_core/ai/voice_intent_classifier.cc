@@ -0,0 +1,312 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ai/voice_intent_classifier.h"
+
+#include <string.h>
+
+#include <iterator>
+#include <utility>
+
+#include "asol/core/local_ai_processor.h"
+#include "base/containers/contains.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+
+namespace browser_core {
+namespace ai {
+
+namespace {
+
+using CommandType = VoiceCommandSystem::CommandType;
+
+// Confidence of a full pattern match, with and without a free slot, and of
+// a command that only starts like a question
+constexpr float kPatternConfidence = 0.98f;
+constexpr float kSlotPatternConfidence = 0.95f;
+constexpr float kQuestionConfidence = 0.85f;
+// A "go to" target that is not a host may be a site name or a page of this
+// one, which the remote AI resolves better
+constexpr float kUnresolvedTargetConfidence = 0.6f;
+
+// The grammar, tried in order; more specific patterns come first so that
+// "open new tab" or "go to the top" is not taken for a site to visit
+struct PatternSpec {
+  CommandType type;
+  const char* action;
+  const char* pattern;
+  bool needs_host;
+};
+
+constexpr PatternSpec kPatternSpecs[] = {
+    {CommandType::BROWSER_ACTION, "new_tab", "(open) (a) new tab", false},
+    {CommandType::BROWSER_ACTION, "new_window", "(open) (a) new window",
+     false},
+    {CommandType::BROWSER_ACTION, "close_tab", "close (this|the) tab", false},
+    {CommandType::BROWSER_ACTION, "reopen_tab", "reopen (closed|last) tab",
+     false},
+    {CommandType::BROWSER_ACTION, "next_tab", "(go) (to) (the) next tab",
+     false},
+    {CommandType::BROWSER_ACTION, "previous_tab",
+     "(go) (to) (the) previous tab", false},
+    {CommandType::BROWSER_ACTION, "reload", "reload|refresh (this|the) (page)",
+     false},
+    {CommandType::BROWSER_ACTION, "stop", "stop (loading)", false},
+    {CommandType::BROWSER_ACTION, "bookmark", "bookmark (this|the) (page)",
+     false},
+    {CommandType::NAVIGATION, "back", "(go) back", false},
+    {CommandType::NAVIGATION, "back", "(go) (to) (the) previous page", false},
+    {CommandType::NAVIGATION, "forward", "(go) forward", false},
+    {CommandType::NAVIGATION, "home", "(go) home", false},
+    {CommandType::PAGE_ACTION, "scroll_down", "scroll down", false},
+    {CommandType::PAGE_ACTION, "scroll_up", "scroll up", false},
+    {CommandType::PAGE_ACTION, "scroll_top", "scroll|go to (the) top", false},
+    {CommandType::PAGE_ACTION, "scroll_bottom", "scroll|go to (the) bottom",
+     false},
+    {CommandType::PAGE_ACTION, "page_down", "page down", false},
+    {CommandType::PAGE_ACTION, "page_up", "page up", false},
+    {CommandType::PAGE_ACTION, "zoom_in", "zoom in", false},
+    {CommandType::PAGE_ACTION, "zoom_out", "zoom out", false},
+    {CommandType::PAGE_ACTION, "zoom_reset", "reset zoom", false},
+    {CommandType::PAGE_ACTION, "click", "click|tap|press (on) {target}",
+     false},
+    {CommandType::PAGE_ACTION, "find", "find {query}", false},
+    {CommandType::NAVIGATION, "navigate", "go|navigate to {target}", true},
+    {CommandType::NAVIGATION, "navigate", "open|visit {target}", true},
+    {CommandType::SEARCH, "search", "search (for) {query}", false},
+    {CommandType::SEARCH, "search", "look up {query}", false},
+    {CommandType::SEARCH, "search", "google {query}", false},
+    {CommandType::CONTENT_ACTION, "summarize",
+     "summarize (this|the) (page|article)", false},
+    {CommandType::CONTENT_ACTION, "translate",
+     "translate (this|the) (page) into|to {language}", false},
+    {CommandType::CONTENT_ACTION, "read_aloud",
+     "read (this|the) (page|article) (aloud)", false},
+    {CommandType::SYSTEM, "dark_mode_on", "turn|switch on dark mode", false},
+    {CommandType::SYSTEM, "dark_mode_on", "enable dark mode", false},
+    {CommandType::SYSTEM, "dark_mode_off", "turn|switch off dark mode", false},
+    {CommandType::SYSTEM, "dark_mode_off", "disable dark mode", false},
+};
+
+// First words of a question
+constexpr const char* kQuestionWords[] = {
+    "what", "who",  "whom", "whose", "when", "where", "why",
+    "how",  "which", "is",  "are",   "does", "do",    "did",
+};
+
+// Courtesy words around a command
+constexpr const char* kLeadingFillers[] = {"please", "can you", "could you",
+                                           "would you", "will you"};
+constexpr const char* kTrailingFillers[] = {"please", "for me"};
+
+// Labels of the CLASSIFICATION model, by command type
+constexpr std::pair<const char*, CommandType> kModelLabels[] = {
+    {"navigation", CommandType::NAVIGATION},
+    {"search", CommandType::SEARCH},
+    {"browser_action", CommandType::BROWSER_ACTION},
+    {"question", CommandType::QUESTION},
+    {"page_action", CommandType::PAGE_ACTION},
+    {"content_action", CommandType::CONTENT_ACTION},
+    {"system", CommandType::SYSTEM},
+};
+
+// Lowercase words of |command| without punctuation or courtesy words.
+// Characters of hosts and URLs are kept.
+std::vector<std::string> NormalizeCommand(std::string_view command) {
+  std::string text = base::ToLowerASCII(command);
+  for (char& c : text) {
+    if (!base::IsAsciiAlphaNumeric(c) && c != '.' && c != '/' && c != ':' &&
+        c != '-' && c != '\'') {
+      c = ' ';
+    }
+  }
+  // Sentence-final periods are punctuation, not part of a host
+  std::string_view trimmed = base::TrimString(text, " .", base::TRIM_ALL);
+
+  for (const char* filler : kLeadingFillers) {
+    if (base::StartsWith(trimmed, std::string(filler) + " ")) {
+      trimmed.remove_prefix(strlen(filler) + 1);
+    }
+  }
+  for (const char* filler : kTrailingFillers) {
+    if (base::EndsWith(trimmed, std::string(" ") + filler)) {
+      trimmed.remove_suffix(strlen(filler) + 1);
+    }
+  }
+  return base::SplitString(trimmed, " ", base::TRIM_WHITESPACE,
+                           base::SPLIT_WANT_NONEMPTY);
+}
+
+// Whether |target| looks like a host or URL rather than a name
+bool LooksLikeHost(std::string_view target) {
+  if (target.find(' ') != std::string_view::npos) {
+    return false;
+  }
+  size_t dot = target.find('.');
+  return dot != std::string_view::npos && dot > 0 && dot + 1 < target.size();
+}
+
+}  // namespace
+
+VoiceIntent::VoiceIntent() = default;
+VoiceIntent::VoiceIntent(const VoiceIntent&) = default;
+VoiceIntent& VoiceIntent::operator=(const VoiceIntent&) = default;
+VoiceIntent::~VoiceIntent() = default;
+
+VoiceIntentClassifier::PatternToken::PatternToken() = default;
+VoiceIntentClassifier::PatternToken::PatternToken(const PatternToken&) =
+    default;
+VoiceIntentClassifier::PatternToken::~PatternToken() = default;
+
+VoiceIntentClassifier::Pattern::Pattern() = default;
+VoiceIntentClassifier::Pattern::Pattern(Pattern&&) = default;
+VoiceIntentClassifier::Pattern::~Pattern() = default;
+
+VoiceIntentClassifier::VoiceIntentClassifier() {
+  patterns_.reserve(std::size(kPatternSpecs));
+  for (const PatternSpec& spec : kPatternSpecs) {
+    patterns_.push_back(
+        ParsePattern(spec.type, spec.action, spec.pattern, spec.needs_host));
+  }
+}
+
+VoiceIntentClassifier::~VoiceIntentClassifier() = default;
+
+VoiceIntent VoiceIntentClassifier::MatchPatterns(
+    std::string_view command) const {
+  VoiceIntent intent;
+  std::vector<std::string> words = NormalizeCommand(command);
+  if (words.empty()) {
+    return intent;
+  }
+
+  for (const Pattern& pattern : patterns_) {
+    std::unordered_map<std::string, std::string> slots;
+    if (!Match(pattern, 0, words, 0, &slots)) {
+      continue;
+    }
+    intent.type = pattern.type;
+    intent.action = pattern.action;
+    intent.confidence = slots.empty() ? kPatternConfidence
+                                      : kSlotPatternConfidence;
+    if (pattern.needs_host) {
+      for (const auto& [name, value] : slots) {
+        if (!LooksLikeHost(value)) {
+          intent.confidence = kUnresolvedTargetConfidence;
+        }
+      }
+    }
+    intent.parameters = std::move(slots);
+    return intent;
+  }
+
+  for (const char* question_word : kQuestionWords) {
+    if (words[0] == question_word && words.size() > 1) {
+      intent.type = CommandType::QUESTION;
+      intent.confidence = kQuestionConfidence;
+      intent.parameters["question"] = std::string(
+          base::TrimWhitespaceASCII(command, base::TRIM_ALL));
+      break;
+    }
+  }
+  return intent;
+}
+
+void VoiceIntentClassifier::Classify(const std::string& command,
+                                     IntentCallback callback) {
+  VoiceIntent intent = MatchPatterns(command);
+  if (intent.confidence >= kMinConfidence || !local_ai_processor_ ||
+      local_ai_processor_->GetModelStatus(
+          asol::core::LocalAIProcessor::ModelType::CLASSIFICATION) !=
+          asol::core::LocalAIProcessor::ModelStatus::READY) {
+    std::move(callback).Run(intent);
+    return;
+  }
+
+  local_ai_processor_->ClassifyContent(
+      command, base::BindOnce(&VoiceIntentClassifier::OnModelScores,
+                              weak_ptr_factory_.GetWeakPtr(),
+                              std::move(intent), std::move(callback)));
+}
+
+// static
+VoiceIntentClassifier::Pattern VoiceIntentClassifier::ParsePattern(
+    VoiceCommandSystem::CommandType type,
+    std::string action,
+    std::string_view pattern,
+    bool needs_host) {
+  Pattern parsed;
+  parsed.type = type;
+  parsed.action = std::move(action);
+  parsed.needs_host = needs_host;
+  for (std::string_view word : base::SplitStringPiece(
+           pattern, " ", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    PatternToken token;
+    if (word.size() > 2 && word.front() == '{' && word.back() == '}') {
+      token.slot = std::string(word.substr(1, word.size() - 2));
+    } else {
+      if (word.size() > 2 && word.front() == '(' && word.back() == ')') {
+        token.optional = true;
+        word = word.substr(1, word.size() - 2);
+      }
+      token.words = base::SplitString(word, "|", base::TRIM_WHITESPACE,
+                                      base::SPLIT_WANT_NONEMPTY);
+    }
+    parsed.tokens.push_back(std::move(token));
+  }
+  return parsed;
+}
+
+// static
+bool VoiceIntentClassifier::Match(
+    const Pattern& pattern,
+    size_t token,
+    const std::vector<std::string>& words,
+    size_t word,
+    std::unordered_map<std::string, std::string>* slots) {
+  if (token == pattern.tokens.size()) {
+    return word == words.size();
+  }
+  const PatternToken& current = pattern.tokens[token];
+
+  // A slot takes the rest of the command, at least one word of it
+  if (!current.slot.empty()) {
+    if (word == words.size()) {
+      return false;
+    }
+    (*slots)[current.slot] = base::JoinString(
+        std::vector<std::string>(words.begin() + word, words.end()), " ");
+    return token + 1 == pattern.tokens.size();
+  }
+
+  if (word < words.size() &&
+      base::Contains(current.words, words[word]) &&
+      Match(pattern, token + 1, words, word + 1, slots)) {
+    return true;
+  }
+  return current.optional && Match(pattern, token + 1, words, word, slots);
+}
+
+void VoiceIntentClassifier::OnModelScores(
+    VoiceIntent intent,
+    IntentCallback callback,
+    const std::unordered_map<std::string, float>& scores) {
+  for (const auto& [label, type] : kModelLabels) {
+    auto it = scores.find(label);
+    if (it == scores.end() || it->second <= intent.confidence) {
+      continue;
+    }
+    if (intent.type != type) {
+      // The pattern's action and slots belong to another type
+      intent.type = type;
+      intent.action.clear();
+      intent.parameters.clear();
+    }
+    intent.confidence = it->second;
+  }
+  std::move(callback).Run(intent);
+}
+
+}  // namespace ai
+}  // namespace browser_core
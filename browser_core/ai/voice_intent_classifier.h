@@ -0,0 +1,128 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_AI_VOICE_INTENT_CLASSIFIER_H_
+#define BROWSER_CORE_AI_VOICE_INTENT_CLASSIFIER_H_
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "browser_core/ai/voice_command_system.h"
+
+namespace asol {
+namespace core {
+class LocalAIProcessor;
+}  // namespace core
+}  // namespace asol
+
+namespace browser_core {
+namespace ai {
+
+// What a voice command asks for
+struct VoiceIntent {
+  VoiceIntent();
+  VoiceIntent(const VoiceIntent&);
+  VoiceIntent& operator=(const VoiceIntent&);
+  ~VoiceIntent();
+
+  VoiceCommandSystem::CommandType type =
+      VoiceCommandSystem::CommandType::UNKNOWN;
+  float confidence = 0.0f;
+  // e.g. "back", "new_tab" or "scroll_down"; empty if only the type is
+  // known
+  std::string action;
+  // Slots of the command, e.g. "query" for a search
+  std::unordered_map<std::string, std::string> parameters;
+};
+
+// VoiceIntentClassifier recognizes the common voice commands on the device
+// so they run without a network round trip.
+//
+// A pattern grammar covers navigation, tab, scrolling, zoom, search and
+// similar commands and is matched in microseconds. Commands it does not
+// cover go to the CLASSIFICATION model of a LocalAIProcessor, when one is
+// set and its model is loaded. Intents below kMinConfidence should be
+// classified by the remote AI instead.
+class VoiceIntentClassifier {
+ public:
+  using IntentCallback = base::OnceCallback<void(const VoiceIntent&)>;
+
+  // Confidence an intent needs to be acted on without the remote AI
+  static constexpr float kMinConfidence = 0.8f;
+
+  VoiceIntentClassifier();
+  ~VoiceIntentClassifier();
+
+  VoiceIntentClassifier(const VoiceIntentClassifier&) = delete;
+  VoiceIntentClassifier& operator=(const VoiceIntentClassifier&) = delete;
+
+  // Model to ask when no pattern matches. Not owned; may be null.
+  void SetLocalAIProcessor(asol::core::LocalAIProcessor* processor) {
+    local_ai_processor_ = processor;
+  }
+
+  // Match |command| against the pattern grammar only
+  VoiceIntent MatchPatterns(std::string_view command) const;
+
+  // Classify |command| by pattern, then by the local model if no pattern
+  // is confident. Runs |callback| synchronously unless the model is asked.
+  void Classify(const std::string& command, IntentCallback callback);
+
+ private:
+  // One word of a pattern: alternatives, optional ones in parentheses, or
+  // a {slot} taking the rest of the command
+  struct PatternToken {
+    PatternToken();
+    PatternToken(const PatternToken&);
+    ~PatternToken();
+
+    std::vector<std::string> words;
+    bool optional = false;
+    std::string slot;
+  };
+
+  struct Pattern {
+    Pattern();
+    Pattern(Pattern&&);
+    ~Pattern();
+
+    VoiceCommandSystem::CommandType type;
+    std::string action;
+    std::vector<PatternToken> tokens;
+    // Slot that must look like a host or URL to be confident, e.g. for
+    // "go to {target}"
+    bool needs_host = false;
+  };
+
+  static Pattern ParsePattern(VoiceCommandSystem::CommandType type,
+                              std::string action,
+                              std::string_view pattern,
+                              bool needs_host);
+
+  // Whether |words| from |word| on match |pattern|'s tokens from |token|
+  // on, filling |slots|
+  static bool Match(const Pattern& pattern,
+                    size_t token,
+                    const std::vector<std::string>& words,
+                    size_t word,
+                    std::unordered_map<std::string, std::string>* slots);
+
+  void OnModelScores(VoiceIntent intent,
+                     IntentCallback callback,
+                     const std::unordered_map<std::string, float>& scores);
+
+  std::vector<Pattern> patterns_;
+  asol::core::LocalAIProcessor* local_ai_processor_ = nullptr;
+
+  base::WeakPtrFactory<VoiceIntentClassifier> weak_ptr_factory_{this};
+};
+
+}  // namespace ai
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_AI_VOICE_INTENT_CLASSIFIER_H_
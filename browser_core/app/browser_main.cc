@@ -6,13 +6,56 @@
 
 #include <utility>
 
+#include "base/functional/bind.h"
 #include "base/logging.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_util.h"
 #include "asol/adapters/gemini/gemini_service_provider.h"
+#include "asol/core/budget_manager.h"
+#include "asol/core/deferred_initializer.h"
+#include "asol/core/network_quality_estimator.h"
+#include "asol/core/retry_policy.h"
+#include "asol/core/startup_trace.h"
+#include "browser_core/content/page_snapshot_service.h"
 
 namespace browser_core {
 namespace app {
 
+namespace {
+
+// Components BrowserMain defers, as known to the DeferredInitializer
+constexpr char kVoiceCommandSystem[] = "voice_command_system";
+constexpr char kResearchAssistant[] = "research_assistant";
+
+// Estimated US dollars the orchestrator may spend on remote providers a day
+constexpr double kDailyAIBudget = 5.0;
+
+// Shared by every remote provider, so retries stay a fraction of the
+// browser's total AI traffic during an outage rather than per provider
+asol::core::RetryBudget* GetRetryBudget() {
+  static base::NoDestructor<asol::core::RetryBudget> budget;
+  return budget.get();
+}
+
+// Judges the connection from the outcome of the orchestrator's calls to
+// every provider and from the transport's round trips and throughput
+asol::core::NetworkQualityEstimator* GetNetworkQualityEstimator() {
+  static base::NoDestructor<asol::core::NetworkQualityEstimator> estimator;
+  return estimator.get();
+}
+
+// Caps what the requests the orchestrator routes cost per day
+asol::core::BudgetManager* GetBudgetManager() {
+  static base::NoDestructor<asol::core::BudgetManager> budget_manager([] {
+    asol::core::BudgetManager::Limits limits;
+    limits.global_daily = kDailyAIBudget;
+    return limits;
+  }());
+  return budget_manager.get();
+}
+
+}  // namespace
+
 BrowserMain::BrowserMain() = default;
 
 BrowserMain::~BrowserMain() = default;
@@ -21,23 +64,33 @@ bool BrowserMain::Initialize(const StartupParams& params) {
   LOG(INFO) << "Initializing DashAIBrowser...";
   
   // Initialize components in the correct order
-  if (!InitializeBrowserEngine()) {
-    LOG(ERROR) << "Failed to initialize browser engine";
-    return false;
+  {
+    asol::core::ScopedStartupPhase phase("browser_engine_init");
+    if (!InitializeBrowserEngine()) {
+      LOG(ERROR) << "Failed to initialize browser engine";
+      return false;
+    }
   }
   
-  if (params.enable_ai_features && !InitializeAIComponents()) {
-    LOG(ERROR) << "Failed to initialize AI components";
-    return false;
+  if (params.enable_ai_features) {
+    asol::core::ScopedStartupPhase phase("ai_components_init");
+    if (!InitializeAIComponents()) {
+      LOG(ERROR) << "Failed to initialize AI components";
+      return false;
+    }
   }
   
-  if (params.enable_advanced_security && !InitializeSecurityComponents()) {
-    LOG(ERROR) << "Failed to initialize security components";
-    return false;
+  if (params.enable_advanced_security) {
+    asol::core::ScopedStartupPhase phase("security_init");
+    if (!InitializeSecurityComponents()) {
+      LOG(ERROR) << "Failed to initialize security components";
+      return false;
+    }
   }
   
   // Register AI providers
   if (params.enable_ai_features) {
+    asol::core::ScopedStartupPhase phase("provider_init");
     RegisterAIProviders();
   }
   
@@ -54,6 +107,15 @@ bool BrowserMain::Initialize(const StartupParams& params) {
 
 int BrowserMain::Run() {
   LOG(INFO) << "Running DashAIBrowser main loop";
+
+  // The first window paints as the loop starts; the deferred AI components
+  // come up behind it
+  if (asol::core::StartupTrace* trace = asol::core::StartupTrace::Get()) {
+    trace->AddMarkOnce("first_paint");
+  }
+  if (browser_ai_integration_) {
+    browser_ai_integration_->OnFirstPaint();
+  }
   
   // In a real implementation, this would run the main event loop
   // For now, we'll just return success
@@ -73,6 +135,9 @@ void BrowserMain::Shutdown() {
   content_understanding_.reset();
   browser_ai_integration_.reset();
   security_manager_.reset();
+  if (multi_model_orchestrator_) {
+    multi_model_orchestrator_->SetLocalProcessor(nullptr);
+  }
   local_ai_processor_.reset();
   multi_model_orchestrator_.reset();
   ai_service_manager_.reset();
@@ -102,6 +167,10 @@ ai::ContentUnderstanding* BrowserMain::GetContentUnderstanding() {
 }
 
 ai::VoiceCommandSystem* BrowserMain::GetVoiceCommandSystem() {
+  if (browser_ai_integration_) {
+    browser_ai_integration_->GetDeferredInitializer()->EnsureInitialized(
+        kVoiceCommandSystem);
+  }
   return voice_command_system_.get();
 }
 
@@ -110,6 +179,10 @@ ai::SmartSuggestions* BrowserMain::GetSmartSuggestions() {
 }
 
 ai::ResearchAssistant* BrowserMain::GetResearchAssistant() {
+  if (browser_ai_integration_) {
+    browser_ai_integration_->GetDeferredInitializer()->EnsureInitialized(
+        kResearchAssistant);
+  }
   return research_assistant_.get();
 }
 
@@ -156,6 +229,16 @@ bool BrowserMain::InitializeAIComponents() {
     LOG(ERROR) << "Failed to initialize multi-model orchestrator";
     return false;
   }
+
+  // Omnibox suggestions and voice commands are interactive; hedge them
+  // rather than wait on a slow provider
+  asol::core::MultiModelOrchestrator::HedgingPolicy hedging_policy;
+  hedging_policy.enabled = true;
+  multi_model_orchestrator_->SetHedgingPolicy(
+      asol::core::AIServiceManager::TaskType::TEXT_GENERATION, hedging_policy);
+  multi_model_orchestrator_->SetHedgingPolicy(
+      asol::core::AIServiceManager::TaskType::QUESTION_ANSWERING,
+      hedging_policy);
   
   // Initialize local AI processor
   local_ai_processor_ = std::make_unique<asol::core::LocalAIProcessor>();
@@ -163,6 +246,23 @@ bool BrowserMain::InitializeAIComponents() {
     LOG(ERROR) << "Failed to initialize local AI processor";
     return false;
   }
+
+  // The local model takes over when the network or the budget gives out.
+  // Requests rank as BALANCED: LOCAL_FIRST_SPECULATIVE would run every
+  // summary both locally and remotely, and no caller here shows drafts.
+  multi_model_orchestrator_->SetLocalProcessor(local_ai_processor_.get());
+
+  // On a flaky or lost connection, summaries, page analysis and omnibox
+  // suggestions come from the local model instead of waiting out timeouts,
+  // and background work waits for the network to recover
+  multi_model_orchestrator_->SetNetworkQualityEstimator(
+      GetNetworkQualityEstimator());
+
+  // As the day's budget runs low, requests move to cheaper providers and
+  // then to the local model, which costs nothing
+  multi_model_orchestrator_->SetBudgetManager(GetBudgetManager());
+  multi_model_orchestrator_->SetProviderCost(
+      local_ai_processor_->GetProviderId(), 0.0);
   
   // Initialize browser AI integration
   browser_ai_integration_ = std::make_unique<ai::BrowserAIIntegration>();
@@ -170,6 +270,11 @@ bool BrowserMain::InitializeAIComponents() {
     LOG(ERROR) << "Failed to initialize browser AI integration";
     return false;
   }
+
+  // Summaries, analysis and questions about the same page share one
+  // extraction per version of its content
+  browser_ai_integration_->SetPageSnapshotService(
+      base::MakeRefCounted<content::PageSnapshotService>());
   
   // Initialize content understanding
   content_understanding_ = std::make_unique<ai::ContentUnderstanding>();
@@ -178,13 +283,6 @@ bool BrowserMain::InitializeAIComponents() {
     return false;
   }
   
-  // Initialize voice command system
-  voice_command_system_ = std::make_unique<ai::VoiceCommandSystem>();
-  if (!voice_command_system_->Initialize(browser_engine_.get(), ai_service_manager_.get())) {
-    LOG(ERROR) << "Failed to initialize voice command system";
-    return false;
-  }
-  
   // Initialize smart suggestions
   smart_suggestions_ = std::make_unique<ai::SmartSuggestions>();
   if (!smart_suggestions_->Initialize(browser_engine_.get(), ai_service_manager_.get(), content_understanding_.get())) {
@@ -192,12 +290,37 @@ bool BrowserMain::InitializeAIComponents() {
     return false;
   }
   
-  // Initialize research assistant
-  research_assistant_ = std::make_unique<ai::ResearchAssistant>();
-  if (!research_assistant_->Initialize(browser_engine_.get(), ai_service_manager_.get(), content_understanding_.get())) {
-    LOG(ERROR) << "Failed to initialize research assistant";
-    return false;
-  }
+  // Voice commands and the research assistant are off the startup path;
+  // they come up when first asked for
+  asol::core::DeferredInitializer* deferred_initializer =
+      browser_ai_integration_->GetDeferredInitializer();
+  deferred_initializer->Register(
+      kVoiceCommandSystem, asol::core::DeferredInitializer::Phase::kOnDemand,
+      {}, base::BindOnce([](BrowserMain* main) {
+        main->voice_command_system_ =
+            std::make_unique<ai::VoiceCommandSystem>();
+        if (!main->voice_command_system_->Initialize(
+                main->browser_engine_.get(),
+                main->ai_service_manager_.get())) {
+          main->voice_command_system_.reset();
+          return false;
+        }
+        return true;
+      }, base::Unretained(this)));
+  deferred_initializer->Register(
+      kResearchAssistant, asol::core::DeferredInitializer::Phase::kOnDemand,
+      {}, base::BindOnce([](BrowserMain* main) {
+        main->research_assistant_ = std::make_unique<ai::ResearchAssistant>();
+        if (!main->research_assistant_->Initialize(
+                main->browser_engine_.get(), main->ai_service_manager_.get(),
+                main->content_understanding_.get())) {
+          main->research_assistant_.reset();
+          return false;
+        }
+        main->research_assistant_->SetLocalAIProcessor(
+            main->local_ai_processor_.get());
+        return true;
+      }, base::Unretained(this)));
   
   return true;
 }
@@ -277,8 +400,11 @@ void BrowserMain::ParseCommandLine(const base::CommandLine& command_line, Startu
 }
 
 void BrowserMain::RegisterAIProviders() {
-  // Register Gemini provider
+  // Register Gemini provider. It retries transient failures itself, failing
+  // over between endpoints, so it is not wrapped in a RetryingProvider too.
   auto gemini_provider = std::make_unique<asol::adapters::gemini::GeminiServiceProvider>();
+  gemini_provider->SetRetryBudget(GetRetryBudget());
+  gemini_provider->SetNetworkQualityEstimator(GetNetworkQualityEstimator());
   ai_service_manager_->RegisterProvider(std::move(gemini_provider));
   
   // Register local AI processor as a provider
@@ -303,6 +429,13 @@ void BrowserMain::RegisterAIProviders() {
   
   ai_service_manager_->SetDefaultProviderForTask(
       asol::core::AIServiceManager::TaskType::TRANSLATION, "gemini");
+
+  // Connect to the remote providers now so the first summary does not wait
+  // on DNS, TCP and TLS
+  for (asol::core::AIServiceProvider* provider :
+       ai_service_manager_->GetAllProviders()) {
+    provider->Preconnect();
+  }
 }
 
 }  // namespace app
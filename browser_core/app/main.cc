@@ -4,6 +4,7 @@
 
 #include <memory>
 
+#include "asol/core/startup_trace.h"
 #include "base/at_exit.h"
 #include "base/command_line.h"
 #include "base/logging.h"
@@ -12,6 +13,9 @@
 #include "browser_core/app/browser_main.h"
 
 int main(int argc, char* argv[]) {
+  // Report startup phases to the startup benchmark, when it launched us
+  asol::core::StartupTrace::Start("browser");
+
   // Initialize the CommandLine object.
   base::CommandLine::Init(argc, argv);
   
@@ -0,0 +1,473 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Microbenchmarks of the browser-side hot paths: content extraction,
+// linking summaries back to their sources and searching browsing memory.
+// Inputs are generated from fixed seeds, so results can be tracked from
+// build to build:
+//
+//   browser_core_perf_benchmarks --benchmark_out=browser_core_perf.json
+//
+// writes the results as JSON. Any other Google Benchmark flag applies,
+// e.g. --benchmark_filter=ExtractContent.
+//
+// Extraction runs on built-in pages shaped like real ones, markup,
+// scripts and navigation included. --page_corpus=DIR runs it on every
+// .html file in DIR instead, such as pages saved from the web.
+
+#include <stddef.h>
+
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "asol/core/shared_text.h"
+#include "asol/core/symbol_table.h"
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/functional/callback.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task/single_thread_task_executor.h"
+#include "browser_core/ai/summarization_service.h"
+#include "browser_core/content/content_extractor.h"
+#include "browser_core/ui/memory_search_index.h"
+#include "third_party/google_benchmark/src/include/benchmark/benchmark.h"
+
+namespace {
+
+using browser_core::ai::SummarizationService;
+using browser_core::content::ContentExtractor;
+using browser_core::ui::MemorySearchIndex;
+
+struct CorpusPage {
+  std::string name;
+  std::string url;
+  std::string html;
+};
+
+// Made-up words from syllables, so text tokenizes like prose without a
+// dictionary in the tree
+std::vector<std::string> MakeVocabulary() {
+  static const char* const kSyllables[] = {
+      "ar", "ben", "cor", "dal", "en", "fir", "gan", "hol", "is", "jor",
+      "kel", "lan", "mor", "nel", "or", "pra", "quin", "ros", "sel", "tor",
+      "ul", "ven", "wil", "xen", "yar", "zo",
+  };
+  std::vector<std::string> words;
+  for (const char* first : kSyllables) {
+    for (const char* second : kSyllables) {
+      words.push_back(base::StrCat({first, second}));
+    }
+  }
+  return words;
+}
+
+// Draws words with a skew toward the start of the vocabulary, as real text
+// repeats its common words
+class WordSource {
+ public:
+  explicit WordSource(uint32_t seed) : engine_(seed) {}
+
+  const std::string& Next() {
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(engine_);
+    return vocabulary_[static_cast<size_t>(u * u * u * vocabulary_.size())];
+  }
+
+  std::string Sentence(size_t words) {
+    std::string sentence = "The";
+    for (size_t i = 0; i < words; ++i) {
+      base::StrAppend(&sentence, {" ", Next()});
+    }
+    sentence += ".";
+    return sentence;
+  }
+
+  size_t Uniform(size_t max) {
+    return std::uniform_int_distribution<size_t>(0, max - 1)(engine_);
+  }
+
+ private:
+  const std::vector<std::string> vocabulary_ = MakeVocabulary();
+  std::mt19937 engine_;
+};
+
+// The parts of a page around its content: scripts, styles, navigation and
+// footer, which together are often most of the bytes
+std::string PageChrome(WordSource& words, bool header) {
+  std::string html;
+  if (header) {
+    html +=
+        "<head><meta charset=\"utf-8\"><meta name=\"viewport\" "
+        "content=\"width=device-width\">\n<style>";
+    for (int i = 0; i < 200; ++i) {
+      base::StrAppend(&html, {".c", base::NumberToString(i),
+                              "{margin:0 auto;padding:4px 8px;color:#333}"});
+    }
+    html += "</style>\n<script>";
+    for (int i = 0; i < 100; ++i) {
+      base::StrAppend(&html, {"window.__cfg", base::NumberToString(i),
+                              "={track:true,id:\"", words.Next(), "\"};"});
+    }
+    html += "</script></head>\n<body><header><nav><ul>";
+  } else {
+    html += "<footer><ul>";
+  }
+  for (int i = 0; i < 40; ++i) {
+    base::StrAppend(&html, {"<li><a href=\"/", words.Next(), "\">",
+                            words.Next(), " ", words.Next(), "</a></li>"});
+  }
+  html += header ? "</ul></nav></header>\n" : "</ul></footer></body>\n";
+  return html;
+}
+
+std::string Paragraphs(WordSource& words, size_t count) {
+  std::string html;
+  for (size_t i = 0; i < count; ++i) {
+    html += "<p>";
+    for (int j = 0; j < 4; ++j) {
+      base::StrAppend(&html, {words.Sentence(12 + words.Uniform(10)), " "});
+    }
+    html += "</p>\n";
+  }
+  return html;
+}
+
+CorpusPage MakeNewsArticle() {
+  WordSource words(1);
+  CorpusPage page{"news_article", "https://news.example.com/2025/04/story",
+                  "<!DOCTYPE html><html>"};
+  page.html += PageChrome(words, true);
+  page.html +=
+      "<main><article><h1>City council approves new transit plan</h1>"
+      "<p class=\"byline\">By Alex Morgan, April 3, 2025</p>\n";
+  page.html += Paragraphs(words, 14);
+  page.html += "</article><aside class=\"ad\"><script>loadAd(1)</script>";
+  page.html += Paragraphs(words, 2);
+  page.html += "</aside><section class=\"comments\">";
+  for (int i = 0; i < 20; ++i) {
+    base::StrAppend(&page.html, {"<div class=\"comment\"><b>", words.Next(),
+                                 "</b>", Paragraphs(words, 1), "</div>"});
+  }
+  page.html += "</section></main>\n";
+  page.html += PageChrome(words, false);
+  page.html += "</html>";
+  return page;
+}
+
+CorpusPage MakeDocumentationPage() {
+  WordSource words(2);
+  CorpusPage page{"documentation", "https://docs.example.com/guide/caching",
+                  "<!DOCTYPE html><html>"};
+  page.html += PageChrome(words, true);
+  page.html += "<div class=\"sidebar\"><ul>";
+  for (int i = 0; i < 80; ++i) {
+    base::StrAppend(&page.html, {"<li><a href=\"#s", base::NumberToString(i),
+                                 "\">", words.Next(), "</a></li>"});
+  }
+  page.html += "</ul></div><main><h1>Caching guide</h1>\n";
+  for (int section = 0; section < 12; ++section) {
+    base::StrAppend(&page.html,
+                    {"<h2 id=\"s", base::NumberToString(section), "\">",
+                     words.Next(), " ", words.Next(), "</h2>\n",
+                     Paragraphs(words, 3),
+                     "<pre><code>cache.put(key, value);\n"
+                     "auto entry = cache.get(key);\n</code></pre>\n"
+                     "<table><tr><th>Option</th><th>Default</th></tr>"});
+    for (int row = 0; row < 6; ++row) {
+      base::StrAppend(&page.html, {"<tr><td>", words.Next(), "</td><td>",
+                                   base::NumberToString(row * 64),
+                                   "</td></tr>"});
+    }
+    page.html += "</table>\n";
+  }
+  page.html += "</main>\n";
+  page.html += PageChrome(words, false);
+  page.html += "</html>";
+  return page;
+}
+
+CorpusPage MakeForumThread() {
+  WordSource words(3);
+  CorpusPage page{"forum_thread", "https://forum.example.org/t/12345",
+                  "<!DOCTYPE html><html>"};
+  page.html += PageChrome(words, true);
+  page.html += "<main><h1>Laptop fan noise after update</h1>\n";
+  for (int post = 0; post < 60; ++post) {
+    base::StrAppend(
+        &page.html,
+        {"<div class=\"post\"><div class=\"author\"><img src=\"/avatars/",
+         base::NumberToString(post), ".png\"><a href=\"/u/", words.Next(),
+         "\">", words.Next(), "</a></div>", Paragraphs(words, 1 + post % 3),
+         "<div class=\"actions\"><a>Reply</a><a>Quote</a><a>Report</a>"
+         "</div></div>\n"});
+  }
+  page.html += "</main>\n";
+  page.html += PageChrome(words, false);
+  page.html += "</html>";
+  return page;
+}
+
+CorpusPage MakeProductPage() {
+  WordSource words(4);
+  CorpusPage page{"product_page", "https://shop.example.com/p/headphones",
+                  "<!DOCTYPE html><html>"};
+  page.html += PageChrome(words, true);
+  page.html +=
+      "<main><h1>Wireless noise-cancelling headphones</h1>"
+      "<div class=\"price\">$199.00</div>\n";
+  page.html += Paragraphs(words, 4);
+  page.html += "<ul class=\"specs\">";
+  for (int i = 0; i < 30; ++i) {
+    base::StrAppend(&page.html, {"<li>", words.Next(), ": ", words.Next(),
+                                 "</li>"});
+  }
+  page.html += "</ul><section class=\"reviews\">";
+  for (int i = 0; i < 25; ++i) {
+    base::StrAppend(&page.html, {"<div class=\"review\"><span>",
+                                 base::NumberToString(1 + i % 5),
+                                 " stars</span>", Paragraphs(words, 1),
+                                 "</div>"});
+  }
+  page.html += "</section><div class=\"related\">";
+  for (int i = 0; i < 24; ++i) {
+    base::StrAppend(&page.html,
+                    {"<a href=\"/p/", words.Next(), "\"><img src=\"/",
+                     words.Next(), ".jpg\">", words.Next(), "</a>"});
+  }
+  page.html += "</div></main>\n";
+  page.html += PageChrome(words, false);
+  page.html += "</html>";
+  return page;
+}
+
+// The .html files in |directory|, or the built-in pages if it is empty
+std::vector<CorpusPage> LoadCorpus(const base::FilePath& directory) {
+  if (directory.empty()) {
+    return {MakeNewsArticle(), MakeDocumentationPage(), MakeForumThread(),
+            MakeProductPage()};
+  }
+  std::vector<CorpusPage> corpus;
+  base::FileEnumerator files(directory, /*recursive=*/false,
+                             base::FileEnumerator::FILES,
+                             FILE_PATH_LITERAL("*.html"));
+  for (base::FilePath path = files.Next(); !path.empty();
+       path = files.Next()) {
+    CorpusPage page;
+    page.name = path.BaseName().RemoveExtension().AsUTF8Unsafe();
+    page.url = "https://corpus.example/" + path.BaseName().AsUTF8Unsafe();
+    if (base::ReadFileToString(path, &page.html)) {
+      corpus.push_back(std::move(page));
+    }
+  }
+  return corpus;
+}
+
+void BM_ExtractContentSync(benchmark::State& state, const CorpusPage* page) {
+  ContentExtractor extractor;
+  extractor.Initialize();
+  size_t paragraphs = 0;
+  for (auto _ : state) {
+    ContentExtractor::ExtractedContent content =
+        extractor.ExtractContentSync(page->url, page->html);
+    paragraphs = content.paragraphs.size();
+    benchmark::DoNotOptimize(content);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(page->html.size()));
+  state.counters["paragraphs"] = paragraphs;
+}
+
+// A document of |sentences| sentences, five to a paragraph
+std::string MakeDocument(size_t sentences, uint32_t seed) {
+  WordSource words(seed);
+  std::string document;
+  for (size_t i = 0; i < sentences; ++i) {
+    base::StrAppend(&document, {words.Sentence(10 + words.Uniform(12)),
+                                i % 5 == 4 ? "\n\n" : " "});
+  }
+  return document;
+}
+
+// A summary of |document| made of five of its sentences, shortened the way
+// a model rewords what it quotes
+std::string MakeSummary(const std::string& document) {
+  std::string summary;
+  size_t step = document.size() / 5;
+  for (size_t i = 0; i < 5; ++i) {
+    size_t start = document.find("The ", i * step);
+    size_t end = document.find('.', start);
+    if (start == std::string::npos || end == std::string::npos) {
+      break;
+    }
+    std::string_view sentence(document.data() + start, end - start);
+    base::StrAppend(&summary,
+                    {sentence.substr(0, sentence.size() * 3 / 4), ". "});
+  }
+  return summary;
+}
+
+// Linking a summary to a document whose index is already built, as for
+// the sentences of a streamed summary. Arg: sentences in the document.
+void BM_GenerateSourceLinks(benchmark::State& state) {
+  asol::core::SharedText document(
+      MakeDocument(static_cast<size_t>(state.range(0)), 1));
+  std::string summary = MakeSummary(std::string(document.view()));
+  SummarizationService service;
+  service.GenerateSourceLinksForTesting(document, summary, "https://a.test/");
+
+  size_t links = 0;
+  for (auto _ : state) {
+    std::vector<SummarizationService::SourceLink> result =
+        service.GenerateSourceLinksForTesting(document, summary,
+                                              "https://a.test/");
+    links = result.size();
+    benchmark::DoNotOptimize(result);
+  }
+  state.counters["links"] = links;
+}
+BENCHMARK(BM_GenerateSourceLinks)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
+
+// Linking a summary to a document seen for the first time, index building
+// included. Cycles through more documents than the service keeps indexes
+// for. Arg: sentences in the document.
+void BM_GenerateSourceLinksCold(benchmark::State& state) {
+  constexpr size_t kDocuments = 5;
+  std::vector<asol::core::SharedText> documents;
+  std::vector<std::string> summaries;
+  for (size_t i = 0; i < kDocuments; ++i) {
+    documents.emplace_back(
+        MakeDocument(static_cast<size_t>(state.range(0)), 1 + i));
+    summaries.push_back(MakeSummary(std::string(documents.back().view())));
+  }
+  SummarizationService service;
+
+  size_t next = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(service.GenerateSourceLinksForTesting(
+        documents[next], summaries[next], "https://a.test/"));
+    next = (next + 1) % kDocuments;
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(documents[0].size()));
+}
+BENCHMARK(BM_GenerateSourceLinksCold)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+// History items as MemoryPalace indexes them
+struct MemoryItem {
+  std::string title;
+  std::string summary;
+  std::vector<asol::core::Symbol> topics;
+  std::vector<asol::core::Symbol> entities;
+};
+
+std::vector<MemoryItem> MakeMemoryItems(size_t count) {
+  WordSource words(7);
+  std::vector<MemoryItem> items(count);
+  for (MemoryItem& item : items) {
+    item.title = words.Sentence(6);
+    item.summary = words.Sentence(30) + " " + words.Sentence(20);
+    for (int i = 0; i < 3; ++i) {
+      item.topics.emplace_back(words.Next());
+      item.entities.emplace_back(words.Next() + " " + words.Next());
+    }
+  }
+  return items;
+}
+
+void IndexMemoryItems(const std::vector<MemoryItem>& items,
+                      MemorySearchIndex* index) {
+  for (size_t i = 0; i < items.size(); ++i) {
+    MemorySearchIndex::Fields fields;
+    fields.title = items[i].title;
+    fields.summary = items[i].summary;
+    fields.topics = &items[i].topics;
+    fields.entities = &items[i].entities;
+    index->Update(i, fields);
+  }
+}
+
+// A text search of browsing memory: the local ranking MemoryPalace does
+// before the AI re-ranks its best candidates. Arg: items in memory.
+void BM_MemoryPalaceSearch(benchmark::State& state) {
+  std::vector<MemoryItem> items =
+      MakeMemoryItems(static_cast<size_t>(state.range(0)));
+  MemorySearchIndex index;
+  IndexMemoryItems(items, &index);
+
+  WordSource words(8);
+  std::vector<std::string> queries;
+  for (int i = 0; i < 32; ++i) {
+    queries.push_back(base::StrCat({words.Next(), " ", words.Next()}));
+  }
+
+  // MemoryPalace's candidate count
+  constexpr size_t kMaxHits = 20;
+  size_t next = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        index.Search(queries[next], kMaxHits, MemorySearchIndex::ItemFilter()));
+    next = (next + 1) % queries.size();
+  }
+}
+BENCHMARK(BM_MemoryPalaceSearch)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
+
+// Recording items in browsing memory. Arg: items recorded.
+void BM_MemoryPalaceIndex(benchmark::State& state) {
+  std::vector<MemoryItem> items =
+      MakeMemoryItems(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    MemorySearchIndex index;
+    IndexMemoryItems(items, &index);
+    benchmark::DoNotOptimize(index.GetTermCount());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MemoryPalaceIndex)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager at_exit_manager;
+  base::CommandLine::Init(argc, argv);
+  base::SingleThreadTaskExecutor main_task_executor;
+
+  // One benchmark per page, so each can be tracked on its own
+  std::vector<CorpusPage> corpus =
+      LoadCorpus(base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+          "page_corpus"));
+  for (const CorpusPage& page : corpus) {
+    benchmark::RegisterBenchmark(
+        ("BM_ExtractContentSync/" + page.name).c_str(), BM_ExtractContentSync,
+        &page)
+        ->Unit(benchmark::kMicrosecond);
+  }
+
+  // Google Benchmark ignores --page_corpus
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
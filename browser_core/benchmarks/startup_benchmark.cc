@@ -0,0 +1,381 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Launches the browser and the ASOL gateway repeatedly, with a cold and a
+// warm page cache, and prints how long each phase of their startup took,
+// so lazy initialization, persistent caches and preconnects can be checked
+// for regressions. The processes report their phases through
+// asol::core::StartupTrace (asol/cpp/utils/startup_trace.h in the gateway)
+// to a file this names in $DASHAI_STARTUP_TRACE.
+//
+// Flags:
+//   --browser=PATH          the browser (browser_core/app); skipped if unset
+//   --browser-args=ARGS     its arguments, space separated
+//   --gateway=PATH          asol_gateway; skipped if unset
+//   --gateway-args=ARGS     e.g. "127.0.0.1:50151 --mock-providers=mock"
+//   --gateway-client=CMD    shell command run once the gateway listens, to
+//                           make its first RPC, e.g. a grpcurl call
+//   --browser-until=PHASE   end a run at this phase rather than at exit
+//   --gateway-until=PHASE   (default first_rpc with a client, else listen)
+//   --runs=N                runs of each binary and mode (default 5)
+//   --modes=cold,warm
+//   --evict=PATH,...        more files to drop from the page cache before a
+//                           cold run, e.g. shared libraries, the config and
+//                           the persistent caches; the binary always is
+//   --drop-caches           drop the whole page cache instead (root only)
+//   --timeout-ms=N          per run (default 30000)
+//
+// A warm mode starts with a discarded priming run. A run ends when the
+// process exits or reports its --*-until phase, when it is sent SIGTERM.
+//
+// Phases, as reported:
+//   library_load       launch to main(): exec, dynamic linking, static init
+//   config_load        ConfigLoader reading the config (browser)
+//   config_parse       flag parsing (gateway)
+//   browser_engine_init, ai_components_init, security_init
+//   provider_init      AI provider set-up
+//   cache_load         opening the persistent response cache
+//   connection_warmup  the first provider preconnect, sent to answered
+//   listen             the gateway binding its port
+//   first_paint        the first window (browser)
+//   first_summary_text the first summary text delivered, i.e. first TTFT
+//   first_rpc, first_chunk  the gateway's first answer and streamed chunk
+//
+// One CSV row per binary, mode and phase: the median and p90 over the runs
+// of when it started and ended, from launch, and of how long it took.
+// Phases a run did not reach are left out of its numbers, so |runs| says
+// how many reached it.
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stddef.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "asol/core/startup_trace.h"
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_file.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/process/launch.h"
+#include "base/process/process.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/time/time.h"
+
+namespace {
+
+using asol::core::StartupTrace;
+
+constexpr base::TimeDelta kPollInterval = base::Milliseconds(2);
+constexpr base::TimeDelta kShutdownTimeout = base::Seconds(5);
+
+// One binary under test
+struct Target {
+  std::string name;
+  base::FilePath binary;
+  std::vector<std::string> args;
+  std::string client_command;
+  std::string until_phase;
+};
+
+struct RunOptions {
+  std::vector<base::FilePath> evict;
+  bool drop_caches = false;
+  base::TimeDelta timeout;
+  base::FilePath trace_path;
+};
+
+// Times of one phase over the runs, in ms from launch
+struct PhaseSamples {
+  std::vector<double> start_ms;
+  std::vector<double> end_ms;
+  std::vector<double> duration_ms;
+};
+
+// The |percentile|th of |values|, which must not be empty
+double Percentile(std::vector<double> values, double percentile) {
+  std::sort(values.begin(), values.end());
+  size_t index = static_cast<size_t>(percentile / 100.0 *
+                                     static_cast<double>(values.size() - 1));
+  return values[index];
+}
+
+// Drop |path| from the page cache, so the next read of it goes to disk
+void EvictFile(const base::FilePath& path) {
+  base::ScopedFD fd(open(path.value().c_str(), O_RDONLY | O_CLOEXEC));
+  if (!fd.is_valid() ||
+      posix_fadvise(fd.get(), 0, 0, POSIX_FADV_DONTNEED) != 0) {
+    std::cerr << "Cannot evict " << path.value() << std::endl;
+  }
+}
+
+void MakeCacheCold(const Target& target, const RunOptions& options) {
+  if (options.drop_caches) {
+    sync();
+    if (!base::WriteFile(base::FilePath("/proc/sys/vm/drop_caches"), "3")) {
+      std::cerr << "Cannot drop the page cache; --drop-caches needs root"
+                << std::endl;
+    }
+    return;
+  }
+  EvictFile(target.binary);
+  for (const base::FilePath& path : options.evict) {
+    EvictFile(path);
+  }
+}
+
+std::map<std::string, StartupTrace::Phase> ReadTrace(
+    const base::FilePath& path) {
+  std::map<std::string, StartupTrace::Phase> phases;
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents)) {
+    return phases;
+  }
+  for (const std::string& line : base::SplitString(
+           contents, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    std::optional<StartupTrace::Phase> phase = StartupTrace::ParsePhase(line);
+    if (phase) {
+      phases.emplace(phase->phase, *phase);
+    }
+  }
+  return phases;
+}
+
+// Launch |command_line|, tracing its startup to |trace_path| unless empty
+std::optional<base::Process> Launch(const base::CommandLine& command_line,
+                                    const base::FilePath& trace_path) {
+  base::LaunchOptions options;
+  if (!trace_path.empty()) {
+    options.environment[StartupTrace::kPathVariable] = trace_path.value();
+  }
+  // Keep the processes' logging out of the CSV
+  options.fds_to_remap.emplace_back(STDERR_FILENO, STDOUT_FILENO);
+  base::Process process = base::LaunchProcess(command_line, options);
+  if (!process.IsValid()) {
+    return std::nullopt;
+  }
+  return process;
+}
+
+// Launch |target| once and return the phases it reported, timed from
+// launch. Empty if it could not be launched.
+std::map<std::string, StartupTrace::Phase> RunOnce(const Target& target,
+                                                   const RunOptions& options) {
+  base::DeleteFile(options.trace_path);
+  base::CommandLine command_line(target.binary);
+  for (const std::string& arg : target.args) {
+    command_line.AppendArg(arg);
+  }
+
+  base::TimeTicks launched = base::TimeTicks::Now();
+  std::optional<base::Process> process =
+      Launch(command_line, options.trace_path);
+  if (!process) {
+    std::cerr << "Cannot launch " << target.binary.value() << std::endl;
+    return {};
+  }
+
+  std::optional<base::Process> client;
+  bool client_launched = false;
+  base::TimeTicks deadline = launched + options.timeout;
+  bool exited = false;
+  while (base::TimeTicks::Now() < deadline) {
+    int exit_code = 0;
+    if (process->WaitForExitWithTimeout(kPollInterval, &exit_code)) {
+      exited = true;
+      break;
+    }
+    std::map<std::string, StartupTrace::Phase> phases =
+        ReadTrace(options.trace_path);
+    if (!target.client_command.empty() && !client_launched &&
+        phases.count("listen")) {
+      client_launched = true;
+      client = Launch(base::CommandLine({"/bin/sh", "-c",
+                                         target.client_command}),
+                      base::FilePath());
+    }
+    if (!target.until_phase.empty() && phases.count(target.until_phase)) {
+      break;
+    }
+  }
+  if (!exited) {
+    // SIGTERM first, so the gateway shuts down and frees its port
+    kill(process->Pid(), SIGTERM);
+    if (!process->WaitForExitWithTimeout(kShutdownTimeout, nullptr)) {
+      process->Terminate(0, /*wait=*/true);
+    }
+  }
+  if (client && !client->WaitForExitWithTimeout(kShutdownTimeout, nullptr)) {
+    client->Terminate(0, /*wait=*/true);
+  }
+
+  std::map<std::string, StartupTrace::Phase> phases =
+      ReadTrace(options.trace_path);
+  auto main_it = phases.find("main");
+  if (main_it != phases.end()) {
+    StartupTrace::Phase library_load;
+    library_load.phase = "library_load";
+    library_load.start = launched;
+    library_load.end = main_it->second.start;
+    phases.emplace(library_load.phase, library_load);
+  }
+  // Measure every phase from launch
+  for (auto& [name, phase] : phases) {
+    phase.start = base::TimeTicks() + (phase.start - launched);
+    phase.end = base::TimeTicks() + (phase.end - launched);
+  }
+  return phases;
+}
+
+void Report(const std::string& target,
+            const std::string& mode,
+            const std::map<std::string, PhaseSamples>& samples) {
+  // In the order the phases end, roughly the order of startup
+  std::vector<std::pair<double, std::string>> order;
+  for (const auto& [phase, phase_samples] : samples) {
+    order.emplace_back(Percentile(phase_samples.end_ms, 50), phase);
+  }
+  std::sort(order.begin(), order.end());
+
+  for (const auto& [end_ms, phase] : order) {
+    const PhaseSamples& phase_samples = samples.at(phase);
+    std::cout << target << ',' << mode << ',' << phase << ','
+              << phase_samples.end_ms.size() << ','
+              << Percentile(phase_samples.start_ms, 50) << ',' << end_ms
+              << ',' << Percentile(phase_samples.end_ms, 90) << ','
+              << Percentile(phase_samples.duration_ms, 50) << ','
+              << Percentile(phase_samples.duration_ms, 90) << '\n';
+  }
+}
+
+void Benchmark(const Target& target,
+               const std::vector<std::string>& modes,
+               int runs,
+               const RunOptions& options) {
+  for (const std::string& mode : modes) {
+    bool cold = mode == "cold";
+    if (!cold) {
+      RunOnce(target, options);  // Primes the cache
+    }
+
+    std::map<std::string, PhaseSamples> samples;
+    for (int run = 0; run < runs; ++run) {
+      if (cold) {
+        MakeCacheCold(target, options);
+      }
+      for (const auto& [name, phase] : RunOnce(target, options)) {
+        PhaseSamples& phase_samples = samples[name];
+        phase_samples.start_ms.push_back(
+            (phase.start - base::TimeTicks()).InMillisecondsF());
+        phase_samples.end_ms.push_back(
+            (phase.end - base::TimeTicks()).InMillisecondsF());
+        phase_samples.duration_ms.push_back(
+            (phase.end - phase.start).InMillisecondsF());
+      }
+    }
+    Report(target.name, mode, samples);
+  }
+}
+
+std::vector<std::string> SplitFlag(const base::CommandLine& command_line,
+                                   const char* name,
+                                   const char* separators) {
+  return base::SplitString(command_line.GetSwitchValueASCII(name), separators,
+                           base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  base::AtExitManager at_exit_manager;
+  base::CommandLine::Init(argc, argv);
+
+  const base::CommandLine* command_line =
+      base::CommandLine::ForCurrentProcess();
+  std::vector<Target> targets;
+  if (command_line->HasSwitch("browser")) {
+    Target browser;
+    browser.name = "browser";
+    browser.binary = command_line->GetSwitchValuePath("browser");
+    browser.args = SplitFlag(*command_line, "browser-args", " ");
+    browser.until_phase = command_line->GetSwitchValueASCII("browser-until");
+    targets.push_back(browser);
+  }
+  if (command_line->HasSwitch("gateway")) {
+    Target gateway;
+    gateway.name = "gateway";
+    gateway.binary = command_line->GetSwitchValuePath("gateway");
+    gateway.args = SplitFlag(*command_line, "gateway-args", " ");
+    gateway.client_command =
+        command_line->GetSwitchValueASCII("gateway-client");
+    gateway.until_phase = command_line->GetSwitchValueASCII("gateway-until");
+    if (gateway.until_phase.empty()) {
+      // The gateway serves until stopped
+      gateway.until_phase =
+          gateway.client_command.empty() ? "listen" : "first_rpc";
+    }
+    targets.push_back(gateway);
+  }
+  if (targets.empty()) {
+    std::cerr << "Give --browser=PATH, --gateway=PATH or both" << std::endl;
+    return 1;
+  }
+
+  int runs = 5;
+  if (command_line->HasSwitch("runs") &&
+      (!base::StringToInt(command_line->GetSwitchValueASCII("runs"), &runs) ||
+       runs < 1)) {
+    std::cerr << "--runs must be a positive number" << std::endl;
+    return 1;
+  }
+  int timeout_ms = 30000;
+  if (command_line->HasSwitch("timeout-ms") &&
+      (!base::StringToInt(command_line->GetSwitchValueASCII("timeout-ms"),
+                          &timeout_ms) ||
+       timeout_ms < 1)) {
+    std::cerr << "--timeout-ms must be a positive number" << std::endl;
+    return 1;
+  }
+  std::vector<std::string> modes = SplitFlag(*command_line, "modes", ",");
+  if (modes.empty()) {
+    modes = {"cold", "warm"};
+  }
+  for (const std::string& mode : modes) {
+    if (mode != "cold" && mode != "warm") {
+      std::cerr << "Unknown mode " << mode << std::endl;
+      return 1;
+    }
+  }
+
+  base::ScopedTempDir temp_dir;
+  if (!temp_dir.CreateUniqueTempDir()) {
+    std::cerr << "Cannot create a temporary directory" << std::endl;
+    return 1;
+  }
+  RunOptions options;
+  for (const std::string& path : SplitFlag(*command_line, "evict", ",")) {
+    options.evict.push_back(base::FilePath(path));
+  }
+  options.drop_caches = command_line->HasSwitch("drop-caches");
+  options.timeout = base::Milliseconds(timeout_ms);
+  options.trace_path = temp_dir.GetPath().AppendASCII("startup_trace.jsonl");
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "target,mode,phase,runs,start_p50_ms,end_p50_ms,end_p90_ms,"
+               "duration_p50_ms,duration_p90_ms\n";
+  for (const Target& target : targets) {
+    Benchmark(target, modes, runs, options);
+  }
+  return 0;
+}
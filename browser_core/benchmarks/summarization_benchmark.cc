@@ -0,0 +1,603 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Runs a fixed corpus of pages through every summary format and length on
+// each target and prints one CSV row per run, then the mean of each
+// target, so changes to the pipeline and providers can be compared on the
+// same numbers.
+//
+// Targets:
+//   cache   summaries served from the summary cache, after a priming run
+//   local   the on-device model (LocalAIProcessor)
+//   stream  a streaming adapter through ServiceManager, for TTFT
+//   <id>    any other name is a hosted provider stood in for by
+//           MockServiceProvider under that ID, so runs are repeatable
+//
+// Flags:
+//   --targets=cache,local,gemini,openai,claude,stream
+//   --iterations=N      runs of each case (default 1)
+//   --seed=N            seed of the mock providers (default 1)
+//
+// Quality is ROUGE-1 and ROUGE-L F1 against one reference summary per
+// page, a proxy that rewards covering the reference's words in order.
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "asol/adapters/mock/mock_service_provider.h"
+#include "asol/adapters/mock/mock_text_adapter.h"
+#include "asol/core/ai_service_manager.h"
+#include "asol/core/local_ai_processor.h"
+#include "asol/core/privacy_proxy.h"
+#include "asol/core/service_manager.h"
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/functional/bind.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/task/single_thread_task_executor.h"
+#include "base/time/time.h"
+#include "browser_core/ai/extractive_compressor.h"
+#include "browser_core/ai/summarization_service.h"
+#include "browser_core/content/content_extractor.h"
+
+namespace {
+
+using browser_core::ai::ExtractiveCompressor;
+using browser_core::ai::SummarizationService;
+using SummaryFormat = SummarizationService::SummaryFormat;
+using SummaryLength = SummarizationService::SummaryLength;
+
+constexpr char kDefaultTargets[] = "cache,local,gemini,openai,claude,stream";
+
+// Adapter and provider the stream target registers; section summaries of
+// long pages still go through the provider
+constexpr char kStreamAdapterId[] = "benchmark_stream";
+
+// Provider the cache target primes its cache from
+constexpr char kCacheProviderId[] = "benchmark_cache";
+
+constexpr struct {
+  SummaryFormat format;
+  const char* name;
+} kFormats[] = {
+    {SummaryFormat::EXECUTIVE_SUMMARY, "executive_summary"},
+    {SummaryFormat::BULLET_POINTS, "bullet_points"},
+    {SummaryFormat::QA_FORMAT, "qa"},
+    {SummaryFormat::TECHNICAL_BRIEF, "technical_brief"},
+    {SummaryFormat::SIMPLIFIED, "simplified"},
+};
+
+constexpr struct {
+  SummaryLength length;
+  const char* name;
+} kLengths[] = {
+    {SummaryLength::VERY_SHORT, "very_short"},
+    {SummaryLength::SHORT, "short"},
+    {SummaryLength::MEDIUM, "medium"},
+    {SummaryLength::LONG, "long"},
+};
+
+struct BenchmarkPage {
+  std::string name;
+  std::string url;
+  std::string html;
+  std::string reference_summary;
+};
+
+std::string Paragraph(std::string_view text) {
+  return "<p>" + std::string(text) + "</p>\n";
+}
+
+BenchmarkPage MakeShortNewsPage() {
+  BenchmarkPage page;
+  page.name = "short_news";
+  page.url = "https://news.example.com/2025/01/city-opens-bridge";
+  page.html =
+      "<html><head><title>City opens new river bridge</title></head><body>"
+      "<article><h1>City opens new river bridge</h1>\n" +
+      Paragraph(
+          "The city opened its new river bridge on Monday, two months ahead "
+          "of schedule and within the budget approved three years ago. The "
+          "bridge carries four traffic lanes, two bus lanes and a separated "
+          "cycle path between the harbour district and the old town.") +
+      Paragraph(
+          "Officials expect the crossing to cut average commute times by "
+          "twelve minutes for residents of the eastern suburbs, who until "
+          "now had to drive through the city centre. Traffic engineers will "
+          "monitor congestion on the approach roads during the first month "
+          "and adjust signal timings where queues form.") +
+      Paragraph(
+          "The project was funded jointly by the regional government and a "
+          "federal infrastructure grant. Construction employed about six "
+          "hundred workers at its peak, and the contractor reported no "
+          "serious injuries over the build. Local businesses near the old "
+          "ferry terminal worry that fewer passengers will pass their "
+          "shops, and the council has promised a review of the ferry "
+          "timetable.") +
+      Paragraph(
+          "The old swing bridge upstream will close for renovation next "
+          "year and reopen to pedestrians and cyclists only. The mayor said "
+          "the new bridge marks the start of a wider plan to move freight "
+          "traffic out of residential streets.") +
+      "</article></body></html>";
+  page.reference_summary =
+      "The city opened its new river bridge two months early and on budget. "
+      "It links the harbour district and the old town with traffic lanes, "
+      "bus lanes and a cycle path, and should cut eastern commutes by "
+      "twelve minutes. Ferry businesses fear losing passengers. The old "
+      "swing bridge will be renovated for pedestrians and cyclists.";
+  return page;
+}
+
+// About 45 000 characters, so it is summarized in sections
+BenchmarkPage MakeLongDocumentationPage() {
+  static const char* const kTopics[] = {
+      "authentication", "pagination",  "rate limits", "webhooks",
+      "error codes",    "versioning",  "batching",    "idempotency",
+      "timeouts",       "retries",     "filtering",   "sorting",
+      "field masks",    "long polling", "uploads",    "downloads",
+      "quotas",         "audit logs",  "regions",     "deprecation",
+      "encryption",     "access keys", "lifecycle rules", "replication",
+      "object locks",   "metadata",    "signed URLs", "multipart copies",
+      "notifications",  "inventories", "tagging",     "checksums",
+      "range reads",    "compression", "caching",     "CORS rules",
+      "service limits", "billing",     "monitoring",  "migrations",
+  };
+  BenchmarkPage page;
+  page.name = "long_docs";
+  page.url = "https://docs.example.com/api/guide";
+  page.html =
+      "<html><head><title>Storage API developer guide</title></head><body>"
+      "<main><h1>Storage API developer guide</h1>\n";
+  for (const char* topic : kTopics) {
+    page.html += "<h2>" + std::string(topic) + "</h2>\n";
+    page.html += Paragraph(
+        "This section explains how the Storage API handles " +
+        std::string(topic) +
+        ". Every request to the API is made over HTTPS and returns JSON, "
+        "and the behaviour described here applies to all endpoints unless "
+        "an endpoint's reference page says otherwise.");
+    page.html += Paragraph(
+        "Clients should read the " + std::string(topic) +
+        " settings of their project before sending production traffic. "
+        "Defaults are chosen to be safe for small workloads, and larger "
+        "deployments usually need to raise them through the console or the "
+        "admin endpoint. Changes take effect within a minute and are "
+        "recorded in the project's audit log.");
+    page.html += Paragraph(
+        "When " + std::string(topic) +
+        " are misconfigured, the API answers with a descriptive error that "
+        "names the offending parameter and links to this guide. Client "
+        "libraries surface these errors as typed exceptions, and the "
+        "troubleshooting page lists the most common causes together with "
+        "the fix for each of them.");
+    page.html += Paragraph(
+        "A worked example at the end of the section shows a complete "
+        "request and response for " + std::string(topic) +
+        ", first with curl and then with the official client library, "
+        "including the headers that matter and the fields of the response "
+        "that applications are expected to check.");
+  }
+  page.html += "</main></body></html>";
+  page.reference_summary =
+      "The guide describes how the Storage API handles authentication, "
+      "pagination, rate limits, webhooks, errors, versioning and other "
+      "request settings over HTTPS and JSON. Defaults suit small workloads "
+      "and can be raised in the console. Misconfiguration produces "
+      "descriptive errors, surfaced as typed exceptions, and each section "
+      "ends with a curl and client library example.";
+  return page;
+}
+
+BenchmarkPage MakeForumThreadPage() {
+  static const char* const kPosts[] = {
+      "My laptop fan runs at full speed as soon as I open the browser, even "
+      "with a single blank tab. Temperatures sit around ninety degrees and "
+      "the battery drains in two hours. Has anyone else seen this after the "
+      "latest update?",
+      "Same here since the update. Disabling hardware acceleration in the "
+      "settings brought my temperatures back to normal, but scrolling got "
+      "noticeably choppier on long pages.",
+      "Check the task manager first. In my case one extension was using a "
+      "whole core in the background. Removing it fixed the fan noise "
+      "without touching hardware acceleration.",
+      "I tried both suggestions. No extension stood out, and turning off "
+      "hardware acceleration helped a little. What finally fixed it was "
+      "updating the graphics driver, which was two years old.",
+      "The release notes for the next version mention a fix for a GPU "
+      "process loop on some integrated graphics chips, which sounds like "
+      "this exact problem. Until then the driver update is the best "
+      "workaround.",
+      "Confirming that the driver update worked for me as well. Fan is "
+      "quiet, temperatures are back to the fifties and battery life is "
+      "around six hours again.",
+  };
+  BenchmarkPage page;
+  page.name = "forum";
+  page.url = "https://forum.example.com/t/fan-runs-at-full-speed/4821";
+  page.html =
+      "<html><head><title>Fan runs at full speed with browser open</title>"
+      "</head><body><div class=\"thread\"><h1>Fan runs at full speed with "
+      "browser open</h1>\n";
+  for (const char* post : kPosts) {
+    page.html += "<div class=\"post\">" + Paragraph(post) + "</div>\n";
+  }
+  page.html += "</div></body></html>";
+  page.reference_summary =
+      "After an update the browser drove laptop fans to full speed and "
+      "drained batteries. Disabling hardware acceleration helped somewhat "
+      "and one user found a heavy extension, but updating the old graphics "
+      "driver fixed it. A fix for a GPU process loop is coming in the next "
+      "version.";
+  return page;
+}
+
+std::vector<BenchmarkPage> MakeCorpus() {
+  return {MakeShortNewsPage(), MakeLongDocumentationPage(),
+          MakeForumThreadPage()};
+}
+
+std::vector<std::string> Tokenize(std::string_view text) {
+  std::vector<std::string> words;
+  std::string word;
+  for (char c : text) {
+    if (base::IsAsciiAlphaNumeric(c)) {
+      word.push_back(base::ToLowerASCII(c));
+    } else if (!word.empty()) {
+      words.push_back(std::move(word));
+      word.clear();
+    }
+  }
+  if (!word.empty()) {
+    words.push_back(std::move(word));
+  }
+  return words;
+}
+
+double F1(size_t matches, size_t candidate_size, size_t reference_size) {
+  if (matches == 0) {
+    return 0.0;
+  }
+  double precision = static_cast<double>(matches) / candidate_size;
+  double recall = static_cast<double>(matches) / reference_size;
+  return 2 * precision * recall / (precision + recall);
+}
+
+// Unigram overlap, counting each reference word at most as often as it
+// occurs there
+double Rouge1(const std::vector<std::string>& candidate,
+              const std::vector<std::string>& reference) {
+  std::unordered_map<std::string_view, size_t> counts;
+  for (const std::string& word : reference) {
+    ++counts[word];
+  }
+  size_t matches = 0;
+  for (const std::string& word : candidate) {
+    auto it = counts.find(word);
+    if (it != counts.end() && it->second > 0) {
+      --it->second;
+      ++matches;
+    }
+  }
+  return F1(matches, candidate.size(), reference.size());
+}
+
+// Longest common subsequence of words
+double RougeL(const std::vector<std::string>& candidate,
+              const std::vector<std::string>& reference) {
+  std::vector<size_t> previous(reference.size() + 1, 0);
+  std::vector<size_t> current(reference.size() + 1, 0);
+  for (const std::string& word : candidate) {
+    for (size_t j = 1; j <= reference.size(); ++j) {
+      current[j] = word == reference[j - 1]
+                       ? previous[j - 1] + 1
+                       : std::max(previous[j], current[j - 1]);
+    }
+    previous.swap(current);
+  }
+  return F1(previous[reference.size()], candidate.size(), reference.size());
+}
+
+struct RunResult {
+  bool success = false;
+  double extraction_ms = 0;
+  double redaction_ms = 0;
+  double ttft_ms = 0;
+  double total_ms = 0;
+  size_t input_tokens = 0;
+  size_t output_tokens = 0;
+  double rouge_1 = 0;
+  double rouge_l = 0;
+};
+
+struct TargetTotals {
+  size_t runs = 0;
+  size_t failures = 0;
+  RunResult sum;
+};
+
+double Milliseconds(base::TimeDelta delta) {
+  return delta.InMillisecondsF();
+}
+
+// Summarize |content| with |service| and wait for the result
+void Summarize(SummarizationService* service,
+               const std::string& content,
+               const BenchmarkPage& page,
+               SummaryFormat format,
+               SummaryLength length,
+               RunResult* run) {
+  base::RunLoop run_loop;
+  base::TimeTicks start = base::TimeTicks::Now();
+  base::TimeTicks first_delta;
+  SummarizationService::SummaryResult result;
+  service->SummarizeContentStreaming(
+      content, page.url, format, length,
+      asol::core::RequestPriority::INTERACTIVE, nullptr,
+      asol::core::TraceContext(),
+      base::BindRepeating(
+          [](base::TimeTicks* first_delta,
+             const SummarizationService::SummaryDelta& delta) {
+            if (first_delta->is_null()) {
+              *first_delta = base::TimeTicks::Now();
+            }
+          },
+          &first_delta),
+      base::BindOnce(
+          [](SummarizationService::SummaryResult* out,
+             base::OnceClosure quit,
+             const SummarizationService::SummaryResult& result) {
+            *out = result;
+            std::move(quit).Run();
+          },
+          &result, run_loop.QuitClosure()));
+  run_loop.Run();
+  base::TimeTicks end = base::TimeTicks::Now();
+
+  run->success = result.success;
+  run->total_ms = Milliseconds(end - start);
+  run->ttft_ms =
+      Milliseconds((first_delta.is_null() ? end : first_delta) - start);
+
+  // Compressed prompts report what was actually sent
+  run->input_tokens = ExtractiveCompressor::EstimateTokens(content);
+  auto sent = result.metadata.find("prompt_tokens_sent");
+  if (sent != result.metadata.end()) {
+    base::StringToSizeT(sent->second, &run->input_tokens);
+  }
+  run->output_tokens = ExtractiveCompressor::EstimateTokens(result.summary_text);
+
+  std::vector<std::string> candidate = Tokenize(result.summary_text);
+  std::vector<std::string> reference = Tokenize(page.reference_summary);
+  run->rouge_1 = Rouge1(candidate, reference);
+  run->rouge_l = RougeL(candidate, reference);
+}
+
+void PrintRow(const std::string& target,
+              const BenchmarkPage& page,
+              const char* format,
+              const char* length,
+              const RunResult& run) {
+  std::cout << target << ',' << page.name << ',' << format << ',' << length
+            << ',' << (run.success ? "ok" : "error") << ',' << std::fixed
+            << std::setprecision(2) << run.extraction_ms << ','
+            << run.redaction_ms << ',' << run.ttft_ms << ',' << run.total_ms
+            << ',' << run.input_tokens << ',' << run.output_tokens << ','
+            << std::setprecision(3) << run.rouge_1 << ',' << run.rouge_l
+            << '\n';
+}
+
+void Accumulate(const RunResult& run, TargetTotals* totals) {
+  ++totals->runs;
+  if (!run.success) {
+    ++totals->failures;
+    return;
+  }
+  totals->sum.extraction_ms += run.extraction_ms;
+  totals->sum.redaction_ms += run.redaction_ms;
+  totals->sum.ttft_ms += run.ttft_ms;
+  totals->sum.total_ms += run.total_ms;
+  totals->sum.input_tokens += run.input_tokens;
+  totals->sum.output_tokens += run.output_tokens;
+  totals->sum.rouge_1 += run.rouge_1;
+  totals->sum.rouge_l += run.rouge_l;
+}
+
+void PrintTotals(const std::map<std::string, TargetTotals>& totals) {
+  std::cout << "\ntarget,runs,failures,mean_extraction_ms,mean_redaction_ms,"
+               "mean_ttft_ms,mean_total_ms,mean_input_tokens,"
+               "mean_output_tokens,mean_rouge_1,mean_rouge_l\n";
+  for (const auto& [target, total] : totals) {
+    size_t ok = total.runs - total.failures;
+    double n = ok ? static_cast<double>(ok) : 1.0;
+    std::cout << target << ',' << total.runs << ',' << total.failures << ','
+              << std::fixed << std::setprecision(2)
+              << total.sum.extraction_ms / n << ','
+              << total.sum.redaction_ms / n << ',' << total.sum.ttft_ms / n
+              << ',' << total.sum.total_ms / n << ','
+              << total.sum.input_tokens / n << ','
+              << total.sum.output_tokens / n << ',' << std::setprecision(3)
+              << total.sum.rouge_1 / n << ',' << total.sum.rouge_l / n
+              << '\n';
+  }
+}
+
+// Make the local model ready to serve
+bool LoadLocalModel(asol::core::LocalAIProcessor* processor) {
+  if (!processor->Initialize()) {
+    return false;
+  }
+  bool loaded = false;
+  base::RunLoop run_loop;
+  processor->LoadModel(
+      asol::core::LocalAIProcessor::ModelType::TEXT_SMALL,
+      base::BindOnce(
+          [](bool* loaded, base::OnceClosure quit, bool success) {
+            *loaded = success;
+            std::move(quit).Run();
+          },
+          &loaded, run_loop.QuitClosure()));
+  run_loop.Run();
+  return loaded;
+}
+
+std::unique_ptr<SummarizationService> CreateService(
+    asol::core::AIServiceManager* ai_service_manager,
+    asol::core::PrivacyProxy* privacy_proxy,
+    asol::core::ServiceManager* streaming_service_manager) {
+  auto service = std::make_unique<SummarizationService>();
+  if (!service->Initialize(ai_service_manager, privacy_proxy)) {
+    return nullptr;
+  }
+  if (streaming_service_manager) {
+    service->SetStreamingServiceManager(streaming_service_manager);
+  }
+  return service;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  base::AtExitManager at_exit_manager;
+  base::CommandLine::Init(argc, argv);
+  base::SingleThreadTaskExecutor main_task_executor;
+
+  const base::CommandLine* command_line =
+      base::CommandLine::ForCurrentProcess();
+  std::string targets_flag = command_line->GetSwitchValueASCII("targets");
+  std::vector<std::string> targets = base::SplitString(
+      targets_flag.empty() ? kDefaultTargets : targets_flag, ",",
+      base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  int iterations = 1;
+  if (command_line->HasSwitch("iterations") &&
+      (!base::StringToInt(command_line->GetSwitchValueASCII("iterations"),
+                          &iterations) ||
+       iterations < 1)) {
+    std::cerr << "--iterations must be a positive number" << std::endl;
+    return 1;
+  }
+  std::string seed = command_line->GetSwitchValueASCII("seed");
+  if (seed.empty()) {
+    seed = "1";
+  }
+
+  // Extraction and redaction do not depend on the target, so each page is
+  // prepared once and its timings reported with every run of it
+  std::vector<BenchmarkPage> corpus = MakeCorpus();
+  browser_core::content::ContentExtractor extractor;
+  extractor.Initialize();
+  asol::core::PrivacyProxy privacy_proxy;
+  std::vector<std::string> contents;
+  std::vector<double> extraction_ms;
+  std::vector<double> redaction_ms;
+  for (const BenchmarkPage& page : corpus) {
+    base::TimeTicks start = base::TimeTicks::Now();
+    browser_core::content::ContentExtractor::ExtractedContent extracted =
+        extractor.ExtractContentSync(page.url, page.html);
+    base::TimeTicks extracted_at = base::TimeTicks::Now();
+    privacy_proxy.ProcessTextSync(extracted.main_text);
+    base::TimeTicks redacted_at = base::TimeTicks::Now();
+    contents.push_back(extracted.main_text);
+    extraction_ms.push_back(Milliseconds(extracted_at - start));
+    redaction_ms.push_back(Milliseconds(redacted_at - extracted_at));
+  }
+
+  asol::core::AIServiceManager ai_service_manager;
+  ai_service_manager.Initialize();
+
+  std::cout << "target,page,format,length,status,extraction_ms,redaction_ms,"
+               "ttft_ms,total_ms,input_tokens,output_tokens,rouge_1,rouge_l\n";
+  std::map<std::string, TargetTotals> totals;
+  for (const std::string& target : targets) {
+    std::string provider_id = target;
+    asol::core::ServiceManager* streaming_service_manager = nullptr;
+    if (target == "local") {
+      auto processor = std::make_unique<asol::core::LocalAIProcessor>();
+      if (!LoadLocalModel(processor.get())) {
+        std::cerr << "Skipping local: the model could not be loaded"
+                  << std::endl;
+        continue;
+      }
+      provider_id = processor->GetProviderId();
+      if (!ai_service_manager.GetProviderById(provider_id)) {
+        ai_service_manager.RegisterProvider(std::move(processor));
+      }
+    } else {
+      if (target == "cache") {
+        provider_id = kCacheProviderId;
+      } else if (target == "stream") {
+        provider_id = kStreamAdapterId;
+        streaming_service_manager = asol::core::ServiceManager::GetInstance();
+        if (!streaming_service_manager->GetAdapter(kStreamAdapterId)) {
+          auto adapter =
+              std::make_unique<asol::adapters::mock::MockTextAdapter>();
+          adapter->Initialize("{\"seed\": \"" + seed + "\"}");
+          streaming_service_manager->RegisterAdapter(kStreamAdapterId,
+                                                     std::move(adapter));
+        }
+      }
+      if (!ai_service_manager.GetProviderById(provider_id)) {
+        auto provider =
+            std::make_unique<asol::adapters::mock::MockServiceProvider>(
+                provider_id);
+        provider->Configure({{"seed", seed}});
+        ai_service_manager.RegisterProvider(std::move(provider));
+      }
+    }
+    ai_service_manager.SetDefaultProviderForTask(
+        asol::core::AIServiceManager::TaskType::TEXT_SUMMARIZATION,
+        provider_id);
+
+    for (size_t p = 0; p < corpus.size(); ++p) {
+      for (const auto& format : kFormats) {
+        for (const auto& length : kLengths) {
+          for (int i = 0; i < iterations; ++i) {
+            // Each run starts from an empty summary cache, except that the
+            // cache target first fills it
+            std::unique_ptr<SummarizationService> service = CreateService(
+                &ai_service_manager, &privacy_proxy,
+                streaming_service_manager);
+            if (!service) {
+              std::cerr << "Failed to initialize the summarization service"
+                        << std::endl;
+              return 1;
+            }
+            if (target == "cache") {
+              RunResult priming;
+              Summarize(service.get(), contents[p], corpus[p], format.format,
+                        length.length, &priming);
+            }
+
+            RunResult run;
+            run.extraction_ms = extraction_ms[p];
+            run.redaction_ms = redaction_ms[p];
+            Summarize(service.get(), contents[p], corpus[p], format.format,
+                      length.length, &run);
+            if (target == "cache") {
+              // Served without a request
+              run.input_tokens = 0;
+              run.output_tokens = 0;
+            }
+            PrintRow(target, corpus[p], format.name, length.name, run);
+            Accumulate(run, &totals[target]);
+          }
+        }
+      }
+    }
+  }
+  PrintTotals(totals);
+  return 0;
+}
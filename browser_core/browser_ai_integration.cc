@@ -4,38 +4,72 @@
 
 #include "browser_core/browser_ai_integration.h"
 
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
 #include "base/bind.h"
 #include "base/logging.h"
+#include "base/time/time.h"
+#include "browser_core/features/summarization_feature.h"
+#include "asol/core/service_manager.h"
 
 namespace browser_core {
 
+namespace {
+
+// Daily AI spend limits, in US dollars
+constexpr double kDailyAIBudget = 5.0;
+constexpr double kDailySummarizationBudget = 1.0;
+
+// Components, as known to the DeferredInitializer
+constexpr char kRequestScheduler[] = "request_scheduler";
+constexpr char kContentUnderstanding[] = "content_understanding";
+constexpr char kSmartSuggestions[] = "smart_suggestions";
+constexpr char kPredictiveOmnibox[] = "predictive_omnibox";
+constexpr char kBrowserFeatures[] = "browser_features";
+constexpr char kBrowserContentHandler[] = "browser_content_handler";
+constexpr char kPageAnalysisQueue[] = "page_analysis_queue";
+constexpr char kMemoryPalace[] = "memory_palace";
+constexpr char kContextualManager[] = "contextual_manager";
+constexpr char kMultiAdapterManager[] = "multi_adapter_manager";
+constexpr char kAISettingsPage[] = "ai_settings_page";
+
+// Creating the adapters sets up their HTTP clients; more than the default
+// budget, but still worth watching
+constexpr base::TimeDelta kAdapterBudget = base::Milliseconds(100);
+
+std::unique_ptr<asol::core::BudgetManager> CreateBudgetManager() {
+  asol::core::BudgetManager::Limits limits;
+  limits.global_daily = kDailyAIBudget;
+  limits.feature_daily["summarization"] = kDailySummarizationBudget;
+  return std::make_unique<asol::core::BudgetManager>(limits);
+}
+
+std::string PageTitle(const BrowserContentHandler::ProcessingResult& result) {
+  return result.page_title.empty() ? "Untitled Page" : result.page_title;
+}
+
+}  // namespace
+
 BrowserAIIntegration::BrowserAIIntegration()
-    : weak_ptr_factory_(this) {}
+    : page_snapshot_service_(
+          base::MakeRefCounted<content::PageSnapshotService>()),
+      deferred_initializer_(
+          std::make_unique<asol::core::DeferredInitializer>()),
+      weak_ptr_factory_(this) {}
 
 BrowserAIIntegration::~BrowserAIIntegration() = default;
 
 bool BrowserAIIntegration::Initialize(
     asol::core::AIServiceManager* ai_service_manager,
     asol::core::PrivacyProxy* privacy_proxy) {
-  // Initialize the multi-adapter manager
-  InitializeMultiAdapterManager();
-  
-  // Initialize browser features
-  browser_features_ = std::make_unique<BrowserFeatures>();
-  if (!browser_features_->Initialize(ai_service_manager, privacy_proxy)) {
+  if (!InitializeMultiAdapterManager() || !InitializeRequestScheduler() ||
+      !InitializeBrowserFeatures(ai_service_manager, privacy_proxy) ||
+      !InitializeBrowserContentHandler() || !InitializeAISettingsPage()) {
     return false;
   }
   
-  // Initialize browser content handler
-  browser_content_handler_ = std::make_unique<BrowserContentHandler>();
-  if (!browser_content_handler_->Initialize(browser_features_.get())) {
-    return false;
-  }
-  
-  // Initialize AI settings page
-  ai_settings_page_ = std::make_unique<ui::AISettingsPage>(multi_adapter_manager_.get());
-  ai_settings_page_->Initialize();
-  
   LOG(INFO) << "BrowserAIIntegration initialized with multiple AI adapters.";
   
   return true;
@@ -54,140 +88,156 @@ bool BrowserAIIntegration::InitializeWithEngine(
   // Store external components
   browser_engine_ = browser_engine;
   context_manager_ = context_manager;
-  
-  // Initialize the multi-adapter manager
-  InitializeMultiAdapterManager();
-  
-  // Initialize browser features
-  browser_features_ = std::make_unique<BrowserFeatures>();
-  if (!browser_features_->Initialize(ai_service_manager, privacy_proxy)) {
-    LOG(ERROR) << "Failed to initialize browser features";
-    return false;
-  }
-  
-  // Initialize browser content handler
-  browser_content_handler_ = std::make_unique<BrowserContentHandler>();
-  if (!browser_content_handler_->Initialize(browser_features_.get())) {
-    LOG(ERROR) << "Failed to initialize browser content handler";
-    return false;
-  }
-  
-  // Initialize AI settings page
-  ai_settings_page_ = std::make_unique<ui::AISettingsPage>(multi_adapter_manager_.get());
-  ai_settings_page_->Initialize();
-  
-  // Initialize content understanding
-  content_understanding_ = std::make_unique<ai::ContentUnderstanding>();
-  if (!content_understanding_->Initialize(browser_engine_, ai_service_manager)) {
-    LOG(ERROR) << "Failed to initialize content understanding";
-    return false;
-  }
-  
-  // Initialize smart suggestions
-  smart_suggestions_ = std::make_unique<ai::SmartSuggestions>();
-  if (!smart_suggestions_->Initialize(browser_engine_, ai_service_manager, content_understanding_.get())) {
-    LOG(ERROR) << "Failed to initialize smart suggestions";
-    return false;
-  }
-  
-  // Initialize predictive omnibox
-  predictive_omnibox_ = std::make_unique<ui::PredictiveOmnibox>();
-  if (!predictive_omnibox_->Initialize(
-          browser_engine_, ai_service_manager, context_manager_,
-          smart_suggestions_.get(), content_understanding_.get())) {
-    LOG(ERROR) << "Failed to initialize predictive omnibox";
-    return false;
-  }
-  
-  // Initialize memory palace
-  memory_palace_ = std::make_unique<ui::MemoryPalace>();
-  if (!memory_palace_->Initialize(
-          browser_engine_, ai_service_manager, context_manager_,
-          content_understanding_.get())) {
-    LOG(ERROR) << "Failed to initialize memory palace";
-    return false;
-  }
-  
-  // Initialize contextual manager
-  contextual_manager_ = std::make_unique<ui::ContextualManager>();
-  if (!contextual_manager_->Initialize(
-          browser_engine_, ai_service_manager, context_manager_,
-          content_understanding_.get())) {
-    LOG(ERROR) << "Failed to initialize contextual manager";
+
+  // Only the scheduler is needed before the first window paints. The
+  // components the user reaches first come up right after it, in this
+  // order; the rest when first used.
+  using Phase = asol::core::DeferredInitializer::Phase;
+  deferred_initializer_->Register(
+      kRequestScheduler, Phase::kEager, {},
+      base::BindOnce(&BrowserAIIntegration::InitializeRequestScheduler,
+                     base::Unretained(this)));
+  deferred_initializer_->Register(
+      kContentUnderstanding, Phase::kAfterFirstPaint, {},
+      base::BindOnce(&BrowserAIIntegration::InitializeContentUnderstanding,
+                     base::Unretained(this), ai_service_manager));
+  deferred_initializer_->Register(
+      kSmartSuggestions, Phase::kAfterFirstPaint, {kContentUnderstanding},
+      base::BindOnce(&BrowserAIIntegration::InitializeSmartSuggestions,
+                     base::Unretained(this), ai_service_manager));
+  deferred_initializer_->Register(
+      kPredictiveOmnibox, Phase::kAfterFirstPaint,
+      {kContentUnderstanding, kSmartSuggestions},
+      base::BindOnce(&BrowserAIIntegration::InitializePredictiveOmnibox,
+                     base::Unretained(this), ai_service_manager));
+  deferred_initializer_->Register(
+      kBrowserFeatures, Phase::kAfterFirstPaint, {kRequestScheduler},
+      base::BindOnce(&BrowserAIIntegration::InitializeBrowserFeatures,
+                     base::Unretained(this), ai_service_manager,
+                     privacy_proxy));
+  deferred_initializer_->Register(
+      kBrowserContentHandler, Phase::kAfterFirstPaint, {kBrowserFeatures},
+      base::BindOnce(&BrowserAIIntegration::InitializeBrowserContentHandler,
+                     base::Unretained(this)));
+  deferred_initializer_->Register(
+      kPageAnalysisQueue, Phase::kAfterFirstPaint,
+      {kRequestScheduler, kContentUnderstanding},
+      base::BindOnce(&BrowserAIIntegration::InitializePageAnalysisQueue,
+                     base::Unretained(this)));
+  deferred_initializer_->Register(
+      kMemoryPalace, Phase::kAfterFirstPaint, {kPageAnalysisQueue},
+      base::BindOnce(&BrowserAIIntegration::InitializeMemoryPalace,
+                     base::Unretained(this), ai_service_manager));
+  deferred_initializer_->Register(
+      kContextualManager, Phase::kAfterFirstPaint, {kPageAnalysisQueue},
+      base::BindOnce(&BrowserAIIntegration::InitializeContextualManager,
+                     base::Unretained(this), ai_service_manager));
+  deferred_initializer_->Register(
+      kMultiAdapterManager, Phase::kOnDemand, {},
+      base::BindOnce(&BrowserAIIntegration::InitializeMultiAdapterManager,
+                     base::Unretained(this)),
+      kAdapterBudget);
+  deferred_initializer_->Register(
+      kAISettingsPage, Phase::kOnDemand, {kMultiAdapterManager},
+      base::BindOnce(&BrowserAIIntegration::InitializeAISettingsPage,
+                     base::Unretained(this)));
+
+  if (!deferred_initializer_->RunEager()) {
     return false;
   }
-  
-  LOG(INFO) << "BrowserAIIntegration initialized with browser engine and AI components";
+
+  LOG(INFO) << "BrowserAIIntegration initialized with browser engine; AI "
+               "components follow after first paint";
   
   return true;
 }
 
+void BrowserAIIntegration::OnFirstPaint() {
+  deferred_initializer_->OnFirstPaint();
+}
+
+asol::core::DeferredInitializer*
+BrowserAIIntegration::GetDeferredInitializer() {
+  return deferred_initializer_.get();
+}
+
 BrowserFeatures* BrowserAIIntegration::GetBrowserFeatures() {
+  EnsureInitialized(kBrowserFeatures);
   return browser_features_.get();
 }
 
 BrowserContentHandler* BrowserAIIntegration::GetBrowserContentHandler() {
+  EnsureInitialized(kBrowserContentHandler);
   return browser_content_handler_.get();
 }
 
+scoped_refptr<content::PageSnapshotService>
+BrowserAIIntegration::GetPageSnapshotService() {
+  return page_snapshot_service_;
+}
+
 void BrowserAIIntegration::OnPageLoaded(
     const std::string& page_url,
     const std::string& html_content,
     views::View* toolbar_view,
     views::Widget* browser_widget) {
-  // Forward to browser content handler
-  browser_content_handler_->OnPageLoaded(
-      page_url, html_content, toolbar_view, browser_widget);
-      
-  // Extract title from content (in a real implementation, this would be more robust)
-  std::string title = "Untitled Page";
-    size_t title_start = html_content.find("<title>");
-  size_t title_end = html_content.find("</title>");
-  if (title_start != std::string::npos && title_end != std::string::npos) {
-    title_start += 7;  // Length of "<title>"
-    if (title_start < title_end) {
-      title = html_content.substr(title_start, title_end - title_start);
-    }
-  }
-  
-  // Record page visit in memory palace
-  if (memory_palace_ && !page_url.empty()) {
-    memory_palace_->RecordPageVisit(page_url, title, html_content);
-  }
-  
-  // Update contextual manager
-  if (contextual_manager_ && !page_url.empty()) {
-    contextual_manager_->UpdateContext(page_url, title, html_content);
+  // A page loaded before the deferred initialization got to them
+  EnsureInitialized(kBrowserContentHandler);
+  EnsureInitialized(kMemoryPalace);
+  EnsureInitialized(kContextualManager);
+
+  // Forward to browser content handler, which records the visit in
+  // memory and updates the context alongside the features
+  if (browser_content_handler_) {
+    browser_content_handler_->OnPageLoaded(
+        page_url, html_content, toolbar_view, browser_widget);
   }
 }
 
 void BrowserAIIntegration::OnPageUnloaded(const std::string& page_url) {
   // Forward to browser content handler
-  browser_content_handler_->OnPageUnloaded(page_url);
+  if (browser_content_handler_) {
+    browser_content_handler_->OnPageUnloaded(page_url);
+  }
 }
 
 void BrowserAIIntegration::OnBrowserClosed() {
-  // Forward to browser content handler
-  browser_content_handler_->OnBrowserClosed();
+  // Forward to browser content handler, if it ever came up
+  if (browser_content_handler_) {
+    browser_content_handler_->OnBrowserClosed();
+  }
 }
 
 asol::core::MultiAdapterManager* BrowserAIIntegration::GetMultiAdapterManager() {
+  EnsureInitialized(kMultiAdapterManager);
   return multi_adapter_manager_.get();
 }
 
+asol::core::RequestScheduler* BrowserAIIntegration::GetRequestScheduler() {
+  return request_scheduler_.get();
+}
+
+asol::core::BudgetManager* BrowserAIIntegration::GetBudgetManager() {
+  return budget_manager_.get();
+}
+
 ui::AISettingsPage* BrowserAIIntegration::GetAISettingsPage() {
+  EnsureInitialized(kAISettingsPage);
   return ai_settings_page_.get();
 }
 
 ui::PredictiveOmnibox* BrowserAIIntegration::GetPredictiveOmnibox() {
+  EnsureInitialized(kPredictiveOmnibox);
   return predictive_omnibox_.get();
 }
 
 ui::MemoryPalace* BrowserAIIntegration::GetMemoryPalace() {
+  EnsureInitialized(kMemoryPalace);
   return memory_palace_.get();
 }
 
 ui::ContextualManager* BrowserAIIntegration::GetContextualManager() {
+  EnsureInitialized(kContextualManager);
   return contextual_manager_.get();
 }
 
@@ -204,12 +254,13 @@ ai::MultimediaUnderstanding* BrowserAIIntegration::GetMultimediaUnderstanding()
 }
 
 void BrowserAIIntegration::ShowAISettingsPage() {
+  EnsureInitialized(kAISettingsPage);
   if (ai_settings_page_) {
     ai_settings_page_->Show();
   }
 }
 
-void BrowserAIIntegration::InitializeMultiAdapterManager() {
+bool BrowserAIIntegration::InitializeMultiAdapterManager() {
   // Create configuration for the adapters
   std::unordered_map<std::string, std::string> config;
   
@@ -235,6 +286,166 @@ void BrowserAIIntegration::InitializeMultiAdapterManager() {
   }
   
   LOG(INFO) << "Active provider: " << multi_adapter_manager_->GetActiveProviderId();
+  return true;
+}
+
+bool BrowserAIIntegration::InitializeRequestScheduler() {
+  // All AI work shares one scheduler so background analysis queues behind
+  // user requests
+  request_scheduler_ = std::make_unique<asol::core::RequestScheduler>();
+  budget_manager_ = CreateBudgetManager();
+  return true;
+}
+
+bool BrowserAIIntegration::InitializeBrowserFeatures(
+    asol::core::AIServiceManager* ai_service_manager,
+    asol::core::PrivacyProxy* privacy_proxy) {
+  browser_features_ = std::make_unique<BrowserFeatures>();
+  if (!browser_features_->Initialize(ai_service_manager, privacy_proxy)) {
+    LOG(ERROR) << "Failed to initialize browser features";
+    browser_features_.reset();
+    return false;
+  }
+  browser_features_->GetSummarizationFeature()->SetRequestScheduler(
+      request_scheduler_.get());
+  browser_features_->GetSummarizationFeature()->SetBudgetManager(
+      budget_manager_.get());
+  browser_features_->GetSummarizationFeature()->SetStreamingServiceManager(
+      asol::core::ServiceManager::GetInstance());
+  return true;
+}
+
+bool BrowserAIIntegration::InitializeBrowserContentHandler() {
+  browser_content_handler_ = std::make_unique<BrowserContentHandler>();
+  // Pages the embedder hands over and pages snapshotted from their tabs
+  // share extracted text
+  browser_content_handler_->SetPageContentCache(
+      base::WrapRefCounted(page_snapshot_service_->content_cache()));
+  if (!browser_content_handler_->Initialize(browser_features_.get())) {
+    LOG(ERROR) << "Failed to initialize browser content handler";
+    browser_content_handler_.reset();
+    return false;
+  }
+
+  // Steps of every loaded page, next to the features. The handler is
+  // ours, so its graphs end before we do.
+  browser_content_handler_->AddPageTask(
+      "memory", base::BindRepeating(&BrowserAIIntegration::RecordPageVisit,
+                                    base::Unretained(this)));
+  browser_content_handler_->AddPageTask(
+      "context", base::BindRepeating(&BrowserAIIntegration::UpdatePageContext,
+                                     base::Unretained(this)));
+  return true;
+}
+
+void BrowserAIIntegration::RecordPageVisit(
+    const BrowserContentHandler::ProcessingResult& result,
+    base::OnceClosure done) {
+  if (memory_palace_ && !result.page_url.empty()) {
+    memory_palace_->RecordPageVisit(
+        result.page_url, PageTitle(result), result.main_content);
+  }
+  std::move(done).Run();
+}
+
+void BrowserAIIntegration::UpdatePageContext(
+    const BrowserContentHandler::ProcessingResult& result,
+    base::OnceClosure done) {
+  if (contextual_manager_ && !result.page_url.empty()) {
+    contextual_manager_->UpdateContext(
+        result.page_url, PageTitle(result), result.main_content);
+  }
+  std::move(done).Run();
+}
+
+bool BrowserAIIntegration::InitializeAISettingsPage() {
+  ai_settings_page_ =
+      std::make_unique<ui::AISettingsPage>(multi_adapter_manager_.get());
+  ai_settings_page_->Initialize();
+  return true;
+}
+
+bool BrowserAIIntegration::InitializeContentUnderstanding(
+    asol::core::AIServiceManager* ai_service_manager) {
+  content_understanding_ = std::make_unique<ai::ContentUnderstanding>();
+  if (!content_understanding_->Initialize(browser_engine_,
+                                          ai_service_manager)) {
+    LOG(ERROR) << "Failed to initialize content understanding";
+    content_understanding_.reset();
+    return false;
+  }
+  return true;
+}
+
+bool BrowserAIIntegration::InitializeSmartSuggestions(
+    asol::core::AIServiceManager* ai_service_manager) {
+  smart_suggestions_ = std::make_unique<ai::SmartSuggestions>();
+  if (!smart_suggestions_->Initialize(browser_engine_, ai_service_manager,
+                                      content_understanding_.get())) {
+    LOG(ERROR) << "Failed to initialize smart suggestions";
+    smart_suggestions_.reset();
+    return false;
+  }
+  return true;
+}
+
+bool BrowserAIIntegration::InitializePredictiveOmnibox(
+    asol::core::AIServiceManager* ai_service_manager) {
+  predictive_omnibox_ = std::make_unique<ui::PredictiveOmnibox>();
+  if (!predictive_omnibox_->Initialize(
+          browser_engine_, ai_service_manager, context_manager_,
+          smart_suggestions_.get(), content_understanding_.get())) {
+    LOG(ERROR) << "Failed to initialize predictive omnibox";
+    predictive_omnibox_.reset();
+    return false;
+  }
+  return true;
+}
+
+bool BrowserAIIntegration::InitializePageAnalysisQueue() {
+  // Visits are analyzed once, in the background, for every feature that
+  // wants the analysis
+  page_analysis_queue_ = std::make_unique<ai::PageAnalysisQueue>(
+      content_understanding_.get(), ai::PageAnalysisQueue::Options());
+  page_analysis_queue_->SetRequestScheduler(request_scheduler_.get());
+  return true;
+}
+
+bool BrowserAIIntegration::InitializeMemoryPalace(
+    asol::core::AIServiceManager* ai_service_manager) {
+  memory_palace_ = std::make_unique<ui::MemoryPalace>();
+  if (!memory_palace_->Initialize(
+          browser_engine_, ai_service_manager, context_manager_,
+          content_understanding_.get())) {
+    LOG(ERROR) << "Failed to initialize memory palace";
+    memory_palace_.reset();
+    return false;
+  }
+  memory_palace_->SetRequestScheduler(request_scheduler_.get());
+  memory_palace_->SetPageAnalysisQueue(page_analysis_queue_.get());
+  return true;
+}
+
+bool BrowserAIIntegration::InitializeContextualManager(
+    asol::core::AIServiceManager* ai_service_manager) {
+  contextual_manager_ = std::make_unique<ui::ContextualManager>();
+  if (!contextual_manager_->Initialize(
+          browser_engine_, ai_service_manager, context_manager_,
+          content_understanding_.get())) {
+    LOG(ERROR) << "Failed to initialize contextual manager";
+    contextual_manager_.reset();
+    return false;
+  }
+  contextual_manager_->SetRequestScheduler(request_scheduler_.get());
+  contextual_manager_->SetPageAnalysisQueue(page_analysis_queue_.get());
+  return true;
+}
+
+void BrowserAIIntegration::EnsureInitialized(const char* component) {
+  // Initialize() without an engine creates its components up front
+  if (browser_engine_) {
+    deferred_initializer_->EnsureInitialized(component);
+  }
 }
 
 base::WeakPtr<BrowserAIIntegration> BrowserAIIntegration::GetWeakPtr() {
@@ -8,22 +8,29 @@
 #include <memory>
 #include <string>
 
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "browser_core/browser_features.h"
 #include "browser_core/browser_content_handler.h"
 #include "asol/adapters/adapter_factory.h"
 #include "asol/core/ai_service_manager.h"
+#include "asol/core/budget_manager.h"
 #include "asol/core/multi_adapter_manager.h"
 #include "asol/core/privacy_proxy.h"
 #include "asol/core/context_manager.h"
+#include "asol/core/deferred_initializer.h"
+#include "asol/core/request_scheduler.h"
 #include "browser_core/ui/ai_settings_page.h"
 #include "browser_core/ui/predictive_omnibox.h"
 #include "browser_core/ui/memory_palace.h"
+#include "browser_core/ui/contextual_manager.h"
 #include "browser_core/ui/adaptive_rendering_engine.h"
 #include "browser_core/ui/semantic_search.h"
 #include "browser_core/ai/smart_suggestions.h"
 #include "browser_core/ai/content_understanding.h"
 #include "browser_core/ai/multimedia_understanding.h"
+#include "browser_core/ai/page_analysis_queue.h"
+#include "browser_core/content/page_snapshot_service.h"
 #include "browser_core/engine/browser_engine.h"
 
 namespace browser_core {
@@ -44,20 +51,43 @@ class BrowserAIIntegration {
   bool Initialize(asol::core::AIServiceManager* ai_service_manager,
                 asol::core::PrivacyProxy* privacy_proxy);
 
-  // Initialize with browser engine and context manager
+  // Initialize with browser engine and context manager. Only what the
+  // first window needs is created now; the components users reach first
+  // follow after OnFirstPaint(), and the rest when first used. The getters
+  // below create their component if it is not yet, and return null if it
+  // failed.
   bool InitializeWithEngine(BrowserEngine* browser_engine,
                           asol::core::AIServiceManager* ai_service_manager,
                           asol::core::PrivacyProxy* privacy_proxy,
                           asol::core::ContextManager* context_manager);
 
+  // Call once the first browser window has painted, to bring up the
+  // deferred components in the background
+  void OnFirstPaint();
+
+  // Brings the components up and traces their startup. Embedders may
+  // register components of their own.
+  asol::core::DeferredInitializer* GetDeferredInitializer();
+
   // Get the browser features
   BrowserFeatures* GetBrowserFeatures();
 
   // Get the browser content handler
   BrowserContentHandler* GetBrowserContentHandler();
+
+  // Get the page snapshots shared by the features that read pages, so a
+  // page is extracted once per version of its content
+  scoped_refptr<content::PageSnapshotService> GetPageSnapshotService();
   
   // Get the multi-adapter manager
   asol::core::MultiAdapterManager* GetMultiAdapterManager();
+
+  // Get the scheduler that orders interactive, prefetch and background AI
+  // work
+  asol::core::RequestScheduler* GetRequestScheduler();
+
+  // Get the daily AI spend limits
+  asol::core::BudgetManager* GetBudgetManager();
   
   // Get the AI settings page
   ui::AISettingsPage* GetAISettingsPage();
@@ -67,6 +97,9 @@ class BrowserAIIntegration {
   
   // Get the memory palace
   ui::MemoryPalace* GetMemoryPalace();
+
+  // Get the contextual manager
+  ui::ContextualManager* GetContextualManager();
   
   // Get the adaptive rendering engine
   ui::AdaptiveRenderingEngine* GetAdaptiveRenderingEngine();
@@ -92,23 +125,58 @@ class BrowserAIIntegration {
   base::WeakPtr<BrowserAIIntegration> GetWeakPtr();
 
  private:
-  // Initialize the multi-adapter manager
-  void InitializeMultiAdapterManager();
+  // Create each component, after the ones it uses. Return false on
+  // failure, leaving it null.
+  bool InitializeMultiAdapterManager();
+  bool InitializeRequestScheduler();
+  bool InitializeBrowserFeatures(
+      asol::core::AIServiceManager* ai_service_manager,
+      asol::core::PrivacyProxy* privacy_proxy);
+  bool InitializeBrowserContentHandler();
+  bool InitializeAISettingsPage();
+  bool InitializeContentUnderstanding(
+      asol::core::AIServiceManager* ai_service_manager);
+  bool InitializeSmartSuggestions(
+      asol::core::AIServiceManager* ai_service_manager);
+  bool InitializePredictiveOmnibox(
+      asol::core::AIServiceManager* ai_service_manager);
+  bool InitializePageAnalysisQueue();
+  bool InitializeMemoryPalace(asol::core::AIServiceManager* ai_service_manager);
+  bool InitializeContextualManager(
+      asol::core::AIServiceManager* ai_service_manager);
+
+  // Page steps run by the content handler for every loaded page
+  void RecordPageVisit(const BrowserContentHandler::ProcessingResult& result,
+                       base::OnceClosure done);
+  void UpdatePageContext(
+      const BrowserContentHandler::ProcessingResult& result,
+      base::OnceClosure done);
+
+  // Create |component| now if it is deferred and not yet
+  void EnsureInitialized(const char* component);
 
   // Components
   std::unique_ptr<BrowserFeatures> browser_features_;
   std::unique_ptr<BrowserContentHandler> browser_content_handler_;
   std::unique_ptr<asol::core::MultiAdapterManager> multi_adapter_manager_;
+  std::unique_ptr<asol::core::RequestScheduler> request_scheduler_;
+  std::unique_ptr<asol::core::BudgetManager> budget_manager_;
   std::unique_ptr<ui::AISettingsPage> ai_settings_page_;
   std::unique_ptr<ui::PredictiveOmnibox> predictive_omnibox_;
+  // Declared before its observers so it outlives them
+  std::unique_ptr<ai::PageAnalysisQueue> page_analysis_queue_;
   std::unique_ptr<ui::MemoryPalace> memory_palace_;
+  std::unique_ptr<ui::ContextualManager> contextual_manager_;
   std::unique_ptr<ai::SmartSuggestions> smart_suggestions_;
   std::unique_ptr<ai::ContentUnderstanding> content_understanding_;
+  scoped_refptr<content::PageSnapshotService> page_snapshot_service_;
 
   // External components (not owned)
   BrowserEngine* browser_engine_ = nullptr;
   asol::core::ContextManager* context_manager_ = nullptr;
 
+  std::unique_ptr<asol::core::DeferredInitializer> deferred_initializer_;
+
   // For weak pointers
   base::WeakPtrFactory<BrowserAIIntegration> weak_ptr_factory_{this};
 };
@@ -7,18 +7,41 @@
 #include <algorithm>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 #include "base/bind.h"
+#include "base/callback_helpers.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string_util.h"
 #include "browser_core/features/summarization_feature.h"
 
 namespace browser_core {
 
-namespace {
+struct BrowserContentHandler::PageJob
+    : public base::RefCountedThreadSafe<PageJob> {
+  std::string page_url;
+  content::PageContentCache::Fingerprint fingerprint;
 
-// Maximum cache size
-constexpr size_t kMaxCacheSize = 20;
+  // Input and output of the "extract" step, which runs on the thread pool
+  std::string html_content;
+  content::ContentExtractor::ExtractedContent content;
 
-}  // namespace
+  // Set before the graph runs for a cached page, else by "result"
+  bool has_result = false;
+  ProcessingResult result;
+
+ private:
+  friend class base::RefCountedThreadSafe<PageJob>;
+
+  ~PageJob() = default;
+};
+
+BrowserContentHandler::PageGraph::PageGraph() = default;
+BrowserContentHandler::PageGraph::PageGraph(PageGraph&&) = default;
+BrowserContentHandler::PageGraph& BrowserContentHandler::PageGraph::operator=(
+    PageGraph&&) = default;
+BrowserContentHandler::PageGraph::~PageGraph() = default;
 
 BrowserContentHandler::BrowserContentHandler()
     : weak_ptr_factory_(this) {}
@@ -33,6 +56,10 @@ bool BrowserContentHandler::Initialize(BrowserFeatures* browser_features) {
   if (!content_extractor_->Initialize()) {
     return false;
   }
+  extraction_service_ = std::make_unique<content::ContentExtractionService>();
+  if (!content_cache_) {
+    content_cache_ = base::MakeRefCounted<content::PageContentCache>();
+  }
   
   return true;
 }
@@ -43,70 +70,92 @@ void BrowserContentHandler::ProcessPage(
     views::View* toolbar_view,
     views::Widget* browser_widget,
     ProcessingCallback callback) {
-  // Check cache first
-  auto cache_it = page_cache_.find(page_url);
-  if (cache_it != page_cache_.end()) {
-    std::move(callback).Run(cache_it->second);
-    return;
-  }
-  
-  // Extract content
-  content_extractor_->ExtractContent(
-      page_url,
-      html_content,
-      base::BindOnce(&BrowserContentHandler::OnContentExtracted,
-                   weak_ptr_factory_.GetWeakPtr(),
-                   page_url,
-                   toolbar_view,
-                   browser_widget,
-                   std::move(callback)));
+  RunPageGraph(page_url, html_content, toolbar_view, browser_widget,
+               /*notify_features=*/false, std::move(callback));
 }
 
 BrowserContentHandler::ProcessingResult BrowserContentHandler::ProcessPageSync(
     const std::string& page_url,
     const std::string& html_content) {
   // Check cache first
-  auto cache_it = page_cache_.find(page_url);
-  if (cache_it != page_cache_.end()) {
-    return cache_it->second;
+  content::PageContentCache::Fingerprint fingerprint =
+      content::PageContentCache::ComputeFingerprint(html_content);
+  if (const content::ContentExtractor::ExtractedContent* cached =
+          content_cache_->Get(page_url, fingerprint)) {
+    return BuildResult(page_url, *cached);
   }
   
   // Extract content
   content::ContentExtractor::ExtractedContent extracted_content = 
       content_extractor_->ExtractContentSync(page_url, html_content);
   
-  // Create processing result
-  ProcessingResult result;
-  result.page_url = page_url;
-  result.page_title = extracted_content.title;
-  result.main_content = extracted_content.main_text;
-  result.content_type = extracted_content.content_type;
-  
-  // Check if content is summarizable
-  features::SummarizationFeature* summarization_feature = 
-      browser_features_->GetSummarizationFeature();
-  if (summarization_feature) {
-    features::SummarizationFeature::EligibilityResult eligibility = 
-        summarization_feature->IsPageEligibleForSummarization(
-            page_url, extracted_content.main_text);
-    result.is_summarizable = eligibility.is_eligible;
+  return CacheResult(page_url, fingerprint, extracted_content);
+}
+
+void BrowserContentHandler::ProcessPages(
+    std::vector<content::ContentExtractionService::Page> pages,
+    BatchProcessingCallback callback,
+    base::OnceClosure done) {
+  // Answer cached pages straight away and extract the rest
+  std::vector<content::ContentExtractionService::Page> to_extract;
+  std::vector<content::PageContentCache::Fingerprint> fingerprints;
+  for (auto& page : pages) {
+    content::PageContentCache::Fingerprint fingerprint =
+        content::PageContentCache::ComputeFingerprint(page.html);
+    if (const content::ContentExtractor::ExtractedContent* cached =
+            content_cache_->Get(page.url, fingerprint)) {
+      callback.Run(BuildResult(page.url, *cached));
+    } else {
+      to_extract.push_back(std::move(page));
+      fingerprints.push_back(fingerprint);
+    }
+  }
+
+  extraction_service_->ExtractBatch(
+      std::move(to_extract), base::TaskPriority::USER_VISIBLE,
+      base::BindRepeating(&BrowserContentHandler::OnBatchPageExtracted,
+                          weak_ptr_factory_.GetWeakPtr(), callback,
+                          std::move(fingerprints)),
+      std::move(done));
+}
+
+BrowserContentHandler::ContentUpdate BrowserContentHandler::ApplyContentDelta(
+    const std::string& page_url,
+    const content::LiveContentModel::Delta& delta) {
+  std::unique_ptr<content::LiveContentModel>& model = live_content_[page_url];
+  if (!model) {
+    model = std::make_unique<content::LiveContentModel>();
+  }
+
+  ContentUpdate update;
+  update.changes = model->Apply(delta);
+
+  const content::ContentExtractor::ExtractedContent* cached =
+      content_cache_->GetAnyVersion(page_url);
+  if (update.changes.empty() && cached) {
+    update.result = BuildResult(page_url, *cached);
+    return update;
+  }
+
+  // Keep the title and content type of the last full extraction; only the
+  // text moves. The live text is its own version of the page.
+  content::ContentExtractor::ExtractedContent content;
+  if (cached) {
+    content = *cached;
   } else {
-    result.is_summarizable = false;
+    content.content_type = content::ContentExtractor::ContentType::UNKNOWN;
+    content.success = true;
   }
-  
-  // For now, assume all content is searchable and analyzable
-  result.is_searchable = true;
-  result.is_analyzable = true;
-  
-  // Cache the result
-  if (page_cache_.size() >= kMaxCacheSize) {
-    // Remove a random entry (in a real implementation, we would use LRU)
-    auto it = page_cache_.begin();
-    page_cache_.erase(it);
+  content.main_text = model->GetText();
+  content.paragraphs.clear();
+  for (const content::LiveContentModel::Block& block : model->blocks()) {
+    content.paragraphs.push_back(block.text);
   }
-  page_cache_[page_url] = result;
-  
-  return result;
+  update.result = CacheResult(
+      page_url,
+      content::PageContentCache::ComputeFingerprint(content.main_text),
+      content);
+  return update;
 }
 
 void BrowserContentHandler::OnPageLoaded(
@@ -114,40 +163,22 @@ void BrowserContentHandler::OnPageLoaded(
     const std::string& html_content,
     views::View* toolbar_view,
     views::Widget* browser_widget) {
-  // Process the page
-  ProcessPage(
-      page_url,
-      html_content,
-      toolbar_view,
-      browser_widget,
-      base::BindOnce(
-          [](base::WeakPtr<BrowserContentHandler> self,
-             const std::string& page_url,
-             const std::string& html_content,
-             views::View* toolbar_view,
-             views::Widget* browser_widget,
-             const ProcessingResult& result) {
-            if (!self)
-              return;
-            
-            // Notify features of page load
-            if (self->browser_features_) {
-              features::SummarizationFeature* summarization_feature = 
-                  self->browser_features_->GetSummarizationFeature();
-              if (summarization_feature) {
-                summarization_feature->OnPageLoaded(
-                    page_url, result.main_content, toolbar_view, browser_widget);
-              }
-            }
-          },
-          weak_ptr_factory_.GetWeakPtr(),
-          page_url,
-          html_content,
-          toolbar_view,
-          browser_widget));
+  // Process the page, then notify features of page load
+  RunPageGraph(page_url, html_content, toolbar_view, browser_widget,
+               /*notify_features=*/true, base::DoNothing());
 }
 
 void BrowserContentHandler::OnPageUnloaded(const std::string& page_url) {
+  live_content_.erase(page_url);
+
+  // Features have no use for a page that is gone; what already started
+  // finishes
+  for (auto& [graph_id, page_graph] : page_graphs_) {
+    if (page_graph.stops_on_unload && page_graph.page_url == page_url) {
+      page_graph.graph->Cancel();
+    }
+  }
+
   // Notify features of page unload
   if (browser_features_) {
     features::SummarizationFeature* summarization_feature = 
@@ -159,6 +190,12 @@ void BrowserContentHandler::OnPageUnloaded(const std::string& page_url) {
 }
 
 void BrowserContentHandler::OnBrowserClosed() {
+  for (auto& [graph_id, page_graph] : page_graphs_) {
+    if (page_graph.stops_on_unload) {
+      page_graph.graph->Cancel();
+    }
+  }
+
   // Notify features of browser close
   if (browser_features_) {
     features::SummarizationFeature* summarization_feature = 
@@ -169,18 +206,150 @@ void BrowserContentHandler::OnBrowserClosed() {
   }
   
   // Clear cache
-  page_cache_.clear();
+  content_cache_->Clear();
+  live_content_.clear();
+}
+
+void BrowserContentHandler::SetPageContentCache(
+    scoped_refptr<content::PageContentCache> cache) {
+  content_cache_ = std::move(cache);
+}
+
+void BrowserContentHandler::AddPageTask(std::string name, PageTask task) {
+  page_tasks_.emplace_back(std::move(name), std::move(task));
 }
 
 base::WeakPtr<BrowserContentHandler> BrowserContentHandler::GetWeakPtr() {
   return weak_ptr_factory_.GetWeakPtr();
 }
 
-void BrowserContentHandler::OnContentExtracted(
+void BrowserContentHandler::RunPageGraph(const std::string& page_url,
+                                         const std::string& html_content,
+                                         views::View* toolbar_view,
+                                         views::Widget* browser_widget,
+                                         bool notify_features,
+                                         ProcessingCallback callback) {
+  auto job = base::MakeRefCounted<PageJob>();
+  job->page_url = page_url;
+  job->fingerprint =
+      content::PageContentCache::ComputeFingerprint(html_content);
+  auto graph = std::make_unique<asol::core::TaskGraph>();
+
+  // extract -> result -> (summarization, page tasks...)
+  std::vector<asol::core::TaskGraph::NodeId> extracted;
+  if (const content::ContentExtractor::ExtractedContent* cached =
+          content_cache_->Get(page_url, job->fingerprint)) {
+    job->result = BuildResult(page_url, *cached);
+    job->has_result = true;
+  } else {
+    job->html_content = html_content;
+    extracted.push_back(graph->AddBlockingTask(
+        "extract", {},
+        base::BindOnce(
+            [](content::ContentExtractor* extractor,
+               scoped_refptr<PageJob> job) {
+              job->content = extractor->ExtractContentSync(
+                  job->page_url, job->html_content);
+            },
+            base::Unretained(content_extractor_.get()), job)));
+  }
+  asol::core::TaskGraph::NodeId result = graph->AddTask(
+      "result", std::move(extracted),
+      base::BindOnce(&BrowserContentHandler::BuildPageResult,
+                     weak_ptr_factory_.GetWeakPtr(), job,
+                     std::move(callback)));
+
+  if (notify_features) {
+    graph->AddTask("summarization", {result},
+                   base::BindOnce(&BrowserContentHandler::NotifySummarization,
+                                  weak_ptr_factory_.GetWeakPtr(), job,
+                                  toolbar_view, browser_widget));
+    for (const auto& [name, task] : page_tasks_) {
+      graph->AddTask(name, {result},
+                     base::BindOnce(
+                         [](PageTask task, scoped_refptr<PageJob> job,
+                            base::OnceClosure done) {
+                           task.Run(job->result, std::move(done));
+                         },
+                         task, job));
+    }
+  }
+
+  int graph_id = next_graph_id_++;
+  PageGraph& page_graph = page_graphs_[graph_id];
+  page_graph.page_url = page_url;
+  page_graph.graph = std::move(graph);
+  page_graph.stops_on_unload = notify_features;
+  // May run "result" before returning, on a cached page
+  page_graph.graph->Run(base::BindOnce(&BrowserContentHandler::OnPageGraphDone,
+                                       weak_ptr_factory_.GetWeakPtr(),
+                                       graph_id));
+}
+
+void BrowserContentHandler::BuildPageResult(scoped_refptr<PageJob> job,
+                                            ProcessingCallback callback,
+                                            base::OnceClosure done) {
+  if (!job->has_result) {
+    job->result = CacheResult(job->page_url, job->fingerprint, job->content);
+    job->has_result = true;
+    job->html_content.clear();
+  }
+  std::move(callback).Run(job->result);
+  std::move(done).Run();
+}
+
+void BrowserContentHandler::NotifySummarization(scoped_refptr<PageJob> job,
+                                                views::View* toolbar_view,
+                                                views::Widget* browser_widget,
+                                                base::OnceClosure done) {
+  // The feature answers through its own UI; the step ends once it has
+  // the page
+  if (browser_features_) {
+    features::SummarizationFeature* summarization_feature =
+        browser_features_->GetSummarizationFeature();
+    if (summarization_feature) {
+      summarization_feature->OnPageLoaded(job->page_url,
+                                          job->result.main_content,
+                                          toolbar_view, browser_widget);
+    }
+  }
+  std::move(done).Run();
+}
+
+void BrowserContentHandler::OnPageGraphDone(
+    int graph_id,
+    const asol::core::TaskGraph::Report& report) {
+  auto it = page_graphs_.find(graph_id);
+  if (it == page_graphs_.end()) {
+    return;
+  }
+  DVLOG(1) << "Processed " << it->second.page_url << " in "
+           << report.elapsed.InMilliseconds() << " ms, critical path "
+           << report.critical_path.InMilliseconds() << " ms ("
+           << base::JoinString(report.critical_path_nodes, " > ") << ")"
+           << (report.cancelled ? ", cancelled" : "");
+  page_graphs_.erase(it);
+}
+
+void BrowserContentHandler::OnBatchPageExtracted(
+    BatchProcessingCallback callback,
+    const std::vector<content::PageContentCache::Fingerprint>& fingerprints,
+    size_t index,
+    const std::string& page_url,
+    const content::ContentExtractor::ExtractedContent& content) {
+  callback.Run(CacheResult(page_url, fingerprints[index], content));
+}
+
+BrowserContentHandler::ProcessingResult BrowserContentHandler::CacheResult(
+    const std::string& page_url,
+    const content::PageContentCache::Fingerprint& fingerprint,
+    const content::ContentExtractor::ExtractedContent& content) {
+  content_cache_->Put(page_url, fingerprint, content);
+  return BuildResult(page_url, content);
+}
+
+BrowserContentHandler::ProcessingResult BrowserContentHandler::BuildResult(
     const std::string& page_url,
-    views::View* toolbar_view,
-    views::Widget* browser_widget,
-    ProcessingCallback callback,
     const content::ContentExtractor::ExtractedContent& content) {
   // Create processing result
   ProcessingResult result;
@@ -188,14 +357,14 @@ void BrowserContentHandler::OnContentExtracted(
   result.page_title = content.title;
   result.main_content = content.main_text;
   result.content_type = content.content_type;
-  
+
   // Check if content is summarizable
   features::SummarizationFeature* summarization_feature = 
       browser_features_->GetSummarizationFeature();
   if (summarization_feature) {
     features::SummarizationFeature::EligibilityResult eligibility = 
         summarization_feature->IsPageEligibleForSummarization(
-            page_url, content.main_text);
+            result.page_url, result.main_content);
     result.is_summarizable = eligibility.is_eligible;
   } else {
     result.is_summarizable = false;
@@ -205,16 +374,7 @@ void BrowserContentHandler::OnContentExtracted(
   result.is_searchable = true;
   result.is_analyzable = true;
   
-  // Cache the result
-  if (page_cache_.size() >= kMaxCacheSize) {
-    // Remove a random entry (in a real implementation, we would use LRU)
-    auto it = page_cache_.begin();
-    page_cache_.erase(it);
-  }
-  page_cache_[page_url] = result;
-  
-  // Return the result
-  std::move(callback).Run(result);
+  return result;
 }
 
 }  // namespace browser_core// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
@@ -226,18 +386,41 @@ void BrowserContentHandler::OnContentExtracted(
 #include <algorithm>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 #include "base/bind.h"
+#include "base/callback_helpers.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string_util.h"
 #include "browser_core/features/summarization_feature.h"
 
 namespace browser_core {
 
-namespace {
+struct BrowserContentHandler::PageJob
+    : public base::RefCountedThreadSafe<PageJob> {
+  std::string page_url;
+  content::PageContentCache::Fingerprint fingerprint;
 
-// Maximum cache size
-constexpr size_t kMaxCacheSize = 20;
+  // Input and output of the "extract" step, which runs on the thread pool
+  std::string html_content;
+  content::ContentExtractor::ExtractedContent content;
 
-}  // namespace
+  // Set before the graph runs for a cached page, else by "result"
+  bool has_result = false;
+  ProcessingResult result;
+
+ private:
+  friend class base::RefCountedThreadSafe<PageJob>;
+
+  ~PageJob() = default;
+};
+
+BrowserContentHandler::PageGraph::PageGraph() = default;
+BrowserContentHandler::PageGraph::PageGraph(PageGraph&&) = default;
+BrowserContentHandler::PageGraph& BrowserContentHandler::PageGraph::operator=(
+    PageGraph&&) = default;
+BrowserContentHandler::PageGraph::~PageGraph() = default;
 
 BrowserContentHandler::BrowserContentHandler()
     : weak_ptr_factory_(this) {}
@@ -252,6 +435,10 @@ bool BrowserContentHandler::Initialize(BrowserFeatures* browser_features) {
   if (!content_extractor_->Initialize()) {
     return false;
   }
+  extraction_service_ = std::make_unique<content::ContentExtractionService>();
+  if (!content_cache_) {
+    content_cache_ = base::MakeRefCounted<content::PageContentCache>();
+  }
   
   return true;
 }
@@ -262,70 +449,92 @@ void BrowserContentHandler::ProcessPage(
     views::View* toolbar_view,
     views::Widget* browser_widget,
     ProcessingCallback callback) {
-  // Check cache first
-  auto cache_it = page_cache_.find(page_url);
-  if (cache_it != page_cache_.end()) {
-    std::move(callback).Run(cache_it->second);
-    return;
-  }
-  
-  // Extract content
-  content_extractor_->ExtractContent(
-      page_url,
-      html_content,
-      base::BindOnce(&BrowserContentHandler::OnContentExtracted,
-                   weak_ptr_factory_.GetWeakPtr(),
-                   page_url,
-                   toolbar_view,
-                   browser_widget,
-                   std::move(callback)));
+  RunPageGraph(page_url, html_content, toolbar_view, browser_widget,
+               /*notify_features=*/false, std::move(callback));
 }
 
 BrowserContentHandler::ProcessingResult BrowserContentHandler::ProcessPageSync(
     const std::string& page_url,
     const std::string& html_content) {
   // Check cache first
-  auto cache_it = page_cache_.find(page_url);
-  if (cache_it != page_cache_.end()) {
-    return cache_it->second;
+  content::PageContentCache::Fingerprint fingerprint =
+      content::PageContentCache::ComputeFingerprint(html_content);
+  if (const content::ContentExtractor::ExtractedContent* cached =
+          content_cache_->Get(page_url, fingerprint)) {
+    return BuildResult(page_url, *cached);
   }
   
   // Extract content
   content::ContentExtractor::ExtractedContent extracted_content = 
       content_extractor_->ExtractContentSync(page_url, html_content);
   
-  // Create processing result
-  ProcessingResult result;
-  result.page_url = page_url;
-  result.page_title = extracted_content.title;
-  result.main_content = extracted_content.main_text;
-  result.content_type = extracted_content.content_type;
-  
-  // Check if content is summarizable
-  features::SummarizationFeature* summarization_feature = 
-      browser_features_->GetSummarizationFeature();
-  if (summarization_feature) {
-    features::SummarizationFeature::EligibilityResult eligibility = 
-        summarization_feature->IsPageEligibleForSummarization(
-            page_url, extracted_content.main_text);
-    result.is_summarizable = eligibility.is_eligible;
+  return CacheResult(page_url, fingerprint, extracted_content);
+}
+
+void BrowserContentHandler::ProcessPages(
+    std::vector<content::ContentExtractionService::Page> pages,
+    BatchProcessingCallback callback,
+    base::OnceClosure done) {
+  // Answer cached pages straight away and extract the rest
+  std::vector<content::ContentExtractionService::Page> to_extract;
+  std::vector<content::PageContentCache::Fingerprint> fingerprints;
+  for (auto& page : pages) {
+    content::PageContentCache::Fingerprint fingerprint =
+        content::PageContentCache::ComputeFingerprint(page.html);
+    if (const content::ContentExtractor::ExtractedContent* cached =
+            content_cache_->Get(page.url, fingerprint)) {
+      callback.Run(BuildResult(page.url, *cached));
+    } else {
+      to_extract.push_back(std::move(page));
+      fingerprints.push_back(fingerprint);
+    }
+  }
+
+  extraction_service_->ExtractBatch(
+      std::move(to_extract), base::TaskPriority::USER_VISIBLE,
+      base::BindRepeating(&BrowserContentHandler::OnBatchPageExtracted,
+                          weak_ptr_factory_.GetWeakPtr(), callback,
+                          std::move(fingerprints)),
+      std::move(done));
+}
+
+BrowserContentHandler::ContentUpdate BrowserContentHandler::ApplyContentDelta(
+    const std::string& page_url,
+    const content::LiveContentModel::Delta& delta) {
+  std::unique_ptr<content::LiveContentModel>& model = live_content_[page_url];
+  if (!model) {
+    model = std::make_unique<content::LiveContentModel>();
+  }
+
+  ContentUpdate update;
+  update.changes = model->Apply(delta);
+
+  const content::ContentExtractor::ExtractedContent* cached =
+      content_cache_->GetAnyVersion(page_url);
+  if (update.changes.empty() && cached) {
+    update.result = BuildResult(page_url, *cached);
+    return update;
+  }
+
+  // Keep the title and content type of the last full extraction; only the
+  // text moves. The live text is its own version of the page.
+  content::ContentExtractor::ExtractedContent content;
+  if (cached) {
+    content = *cached;
   } else {
-    result.is_summarizable = false;
+    content.content_type = content::ContentExtractor::ContentType::UNKNOWN;
+    content.success = true;
   }
-  
-  // For now, assume all content is searchable and analyzable
-  result.is_searchable = true;
-  result.is_analyzable = true;
-  
-  // Cache the result
-  if (page_cache_.size() >= kMaxCacheSize) {
-    // Remove a random entry (in a real implementation, we would use LRU)
-    auto it = page_cache_.begin();
-    page_cache_.erase(it);
+  content.main_text = model->GetText();
+  content.paragraphs.clear();
+  for (const content::LiveContentModel::Block& block : model->blocks()) {
+    content.paragraphs.push_back(block.text);
   }
-  page_cache_[page_url] = result;
-  
-  return result;
+  update.result = CacheResult(
+      page_url,
+      content::PageContentCache::ComputeFingerprint(content.main_text),
+      content);
+  return update;
 }
 
 void BrowserContentHandler::OnPageLoaded(
@@ -333,40 +542,22 @@ void BrowserContentHandler::OnPageLoaded(
     const std::string& html_content,
     views::View* toolbar_view,
     views::Widget* browser_widget) {
-  // Process the page
-  ProcessPage(
-      page_url,
-      html_content,
-      toolbar_view,
-      browser_widget,
-      base::BindOnce(
-          [](base::WeakPtr<BrowserContentHandler> self,
-             const std::string& page_url,
-             const std::string& html_content,
-             views::View* toolbar_view,
-             views::Widget* browser_widget,
-             const ProcessingResult& result) {
-            if (!self)
-              return;
-            
-            // Notify features of page load
-            if (self->browser_features_) {
-              features::SummarizationFeature* summarization_feature = 
-                  self->browser_features_->GetSummarizationFeature();
-              if (summarization_feature) {
-                summarization_feature->OnPageLoaded(
-                    page_url, result.main_content, toolbar_view, browser_widget);
-              }
-            }
-          },
-          weak_ptr_factory_.GetWeakPtr(),
-          page_url,
-          html_content,
-          toolbar_view,
-          browser_widget));
+  // Process the page, then notify features of page load
+  RunPageGraph(page_url, html_content, toolbar_view, browser_widget,
+               /*notify_features=*/true, base::DoNothing());
 }
 
 void BrowserContentHandler::OnPageUnloaded(const std::string& page_url) {
+  live_content_.erase(page_url);
+
+  // Features have no use for a page that is gone; what already started
+  // finishes
+  for (auto& [graph_id, page_graph] : page_graphs_) {
+    if (page_graph.stops_on_unload && page_graph.page_url == page_url) {
+      page_graph.graph->Cancel();
+    }
+  }
+
   // Notify features of page unload
   if (browser_features_) {
     features::SummarizationFeature* summarization_feature = 
@@ -378,6 +569,12 @@ void BrowserContentHandler::OnPageUnloaded(const std::string& page_url) {
 }
 
 void BrowserContentHandler::OnBrowserClosed() {
+  for (auto& [graph_id, page_graph] : page_graphs_) {
+    if (page_graph.stops_on_unload) {
+      page_graph.graph->Cancel();
+    }
+  }
+
   // Notify features of browser close
   if (browser_features_) {
     features::SummarizationFeature* summarization_feature = 
@@ -388,18 +585,150 @@ void BrowserContentHandler::OnBrowserClosed() {
   }
   
   // Clear cache
-  page_cache_.clear();
+  content_cache_->Clear();
+  live_content_.clear();
+}
+
+void BrowserContentHandler::SetPageContentCache(
+    scoped_refptr<content::PageContentCache> cache) {
+  content_cache_ = std::move(cache);
+}
+
+void BrowserContentHandler::AddPageTask(std::string name, PageTask task) {
+  page_tasks_.emplace_back(std::move(name), std::move(task));
 }
 
 base::WeakPtr<BrowserContentHandler> BrowserContentHandler::GetWeakPtr() {
   return weak_ptr_factory_.GetWeakPtr();
 }
 
-void BrowserContentHandler::OnContentExtracted(
+void BrowserContentHandler::RunPageGraph(const std::string& page_url,
+                                         const std::string& html_content,
+                                         views::View* toolbar_view,
+                                         views::Widget* browser_widget,
+                                         bool notify_features,
+                                         ProcessingCallback callback) {
+  auto job = base::MakeRefCounted<PageJob>();
+  job->page_url = page_url;
+  job->fingerprint =
+      content::PageContentCache::ComputeFingerprint(html_content);
+  auto graph = std::make_unique<asol::core::TaskGraph>();
+
+  // extract -> result -> (summarization, page tasks...)
+  std::vector<asol::core::TaskGraph::NodeId> extracted;
+  if (const content::ContentExtractor::ExtractedContent* cached =
+          content_cache_->Get(page_url, job->fingerprint)) {
+    job->result = BuildResult(page_url, *cached);
+    job->has_result = true;
+  } else {
+    job->html_content = html_content;
+    extracted.push_back(graph->AddBlockingTask(
+        "extract", {},
+        base::BindOnce(
+            [](content::ContentExtractor* extractor,
+               scoped_refptr<PageJob> job) {
+              job->content = extractor->ExtractContentSync(
+                  job->page_url, job->html_content);
+            },
+            base::Unretained(content_extractor_.get()), job)));
+  }
+  asol::core::TaskGraph::NodeId result = graph->AddTask(
+      "result", std::move(extracted),
+      base::BindOnce(&BrowserContentHandler::BuildPageResult,
+                     weak_ptr_factory_.GetWeakPtr(), job,
+                     std::move(callback)));
+
+  if (notify_features) {
+    graph->AddTask("summarization", {result},
+                   base::BindOnce(&BrowserContentHandler::NotifySummarization,
+                                  weak_ptr_factory_.GetWeakPtr(), job,
+                                  toolbar_view, browser_widget));
+    for (const auto& [name, task] : page_tasks_) {
+      graph->AddTask(name, {result},
+                     base::BindOnce(
+                         [](PageTask task, scoped_refptr<PageJob> job,
+                            base::OnceClosure done) {
+                           task.Run(job->result, std::move(done));
+                         },
+                         task, job));
+    }
+  }
+
+  int graph_id = next_graph_id_++;
+  PageGraph& page_graph = page_graphs_[graph_id];
+  page_graph.page_url = page_url;
+  page_graph.graph = std::move(graph);
+  page_graph.stops_on_unload = notify_features;
+  // May run "result" before returning, on a cached page
+  page_graph.graph->Run(base::BindOnce(&BrowserContentHandler::OnPageGraphDone,
+                                       weak_ptr_factory_.GetWeakPtr(),
+                                       graph_id));
+}
+
+void BrowserContentHandler::BuildPageResult(scoped_refptr<PageJob> job,
+                                            ProcessingCallback callback,
+                                            base::OnceClosure done) {
+  if (!job->has_result) {
+    job->result = CacheResult(job->page_url, job->fingerprint, job->content);
+    job->has_result = true;
+    job->html_content.clear();
+  }
+  std::move(callback).Run(job->result);
+  std::move(done).Run();
+}
+
+void BrowserContentHandler::NotifySummarization(scoped_refptr<PageJob> job,
+                                                views::View* toolbar_view,
+                                                views::Widget* browser_widget,
+                                                base::OnceClosure done) {
+  // The feature answers through its own UI; the step ends once it has
+  // the page
+  if (browser_features_) {
+    features::SummarizationFeature* summarization_feature =
+        browser_features_->GetSummarizationFeature();
+    if (summarization_feature) {
+      summarization_feature->OnPageLoaded(job->page_url,
+                                          job->result.main_content,
+                                          toolbar_view, browser_widget);
+    }
+  }
+  std::move(done).Run();
+}
+
+void BrowserContentHandler::OnPageGraphDone(
+    int graph_id,
+    const asol::core::TaskGraph::Report& report) {
+  auto it = page_graphs_.find(graph_id);
+  if (it == page_graphs_.end()) {
+    return;
+  }
+  DVLOG(1) << "Processed " << it->second.page_url << " in "
+           << report.elapsed.InMilliseconds() << " ms, critical path "
+           << report.critical_path.InMilliseconds() << " ms ("
+           << base::JoinString(report.critical_path_nodes, " > ") << ")"
+           << (report.cancelled ? ", cancelled" : "");
+  page_graphs_.erase(it);
+}
+
+void BrowserContentHandler::OnBatchPageExtracted(
+    BatchProcessingCallback callback,
+    const std::vector<content::PageContentCache::Fingerprint>& fingerprints,
+    size_t index,
+    const std::string& page_url,
+    const content::ContentExtractor::ExtractedContent& content) {
+  callback.Run(CacheResult(page_url, fingerprints[index], content));
+}
+
+BrowserContentHandler::ProcessingResult BrowserContentHandler::CacheResult(
+    const std::string& page_url,
+    const content::PageContentCache::Fingerprint& fingerprint,
+    const content::ContentExtractor::ExtractedContent& content) {
+  content_cache_->Put(page_url, fingerprint, content);
+  return BuildResult(page_url, content);
+}
+
+BrowserContentHandler::ProcessingResult BrowserContentHandler::BuildResult(
     const std::string& page_url,
-    views::View* toolbar_view,
-    views::Widget* browser_widget,
-    ProcessingCallback callback,
     const content::ContentExtractor::ExtractedContent& content) {
   // Create processing result
   ProcessingResult result;
@@ -407,14 +736,14 @@ void BrowserContentHandler::OnContentExtracted(
   result.page_title = content.title;
   result.main_content = content.main_text;
   result.content_type = content.content_type;
-  
+
   // Check if content is summarizable
   features::SummarizationFeature* summarization_feature = 
       browser_features_->GetSummarizationFeature();
   if (summarization_feature) {
     features::SummarizationFeature::EligibilityResult eligibility = 
         summarization_feature->IsPageEligibleForSummarization(
-            page_url, content.main_text);
+            result.page_url, result.main_content);
     result.is_summarizable = eligibility.is_eligible;
   } else {
     result.is_summarizable = false;
@@ -424,16 +753,7 @@ void BrowserContentHandler::OnContentExtracted(
   result.is_searchable = true;
   result.is_analyzable = true;
   
-  // Cache the result
-  if (page_cache_.size() >= kMaxCacheSize) {
-    // Remove a random entry (in a real implementation, we would use LRU)
-    auto it = page_cache_.begin();
-    page_cache_.erase(it);
-  }
-  page_cache_[page_url] = result;
-  
-  // Return the result
-  std::move(callback).Run(result);
+  return result;
 }
 
 }  // namespace browser_core
\ No newline at end of file
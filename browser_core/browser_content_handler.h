@@ -8,11 +8,18 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "asol/core/task_graph.h"
 #include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "browser_core/browser_features.h"
+#include "browser_core/content/content_extraction_service.h"
 #include "browser_core/content/content_extractor.h"
+#include "browser_core/content/live_content_model.h"
+#include "browser_core/content/page_content_cache.h"
 #include "ui/views/view.h"
 #include "ui/views/widget/widget.h"
 
@@ -20,6 +27,11 @@ namespace browser_core {
 
 // BrowserContentHandler manages content extraction and processing for browser pages.
 // It coordinates between the content extraction, AI features, and browser UI.
+//
+// Each page goes through a graph of steps (see asol::core::TaskGraph):
+// extraction on the thread pool, unless the page is cached, then building
+// its result, then the features and page tasks side by side, so their AI
+// calls overlap. Steps of a page that has been unloaded are not started.
 class BrowserContentHandler {
  public:
   // Content processing result
@@ -33,10 +45,27 @@ class BrowserContentHandler {
     bool is_analyzable;
   };
 
+  // Result of bringing a dynamic page up to date
+  struct ContentUpdate {
+    ProcessingResult result;
+
+    // The blocks to re-summarize or re-index
+    content::LiveContentModel::Update changes;
+  };
+
   // Callback for content processing
   using ProcessingCallback = 
       base::OnceCallback<void(const ProcessingResult& result)>;
 
+  // Callback for each page of a batch
+  using BatchProcessingCallback =
+      base::RepeatingCallback<void(const ProcessingResult& result)>;
+
+  // Step run for each loaded page once its result is built, alongside the
+  // features; runs |done| when finished, e.g. once its AI call answers
+  using PageTask = base::RepeatingCallback<void(const ProcessingResult& result,
+                                                base::OnceClosure done)>;
+
   BrowserContentHandler();
   ~BrowserContentHandler();
 
@@ -47,6 +76,18 @@ class BrowserContentHandler {
   // Initialize the handler
   bool Initialize(BrowserFeatures* browser_features);
 
+  // Share |cache| with other extractors of the same pages, such as
+  // ai::BrowserAIIntegration. Call before Initialize(), which otherwise
+  // creates a cache of its own.
+  void SetPageContentCache(scoped_refptr<content::PageContentCache> cache);
+  content::PageContentCache* page_content_cache() const {
+    return content_cache_.get();
+  }
+
+  // Run |task| for every page passed to OnPageLoaded() from now on, such
+  // as indexing it into memory. |name| labels it in the timings.
+  void AddPageTask(std::string name, PageTask task);
+
   // Process a page
   void ProcessPage(const std::string& page_url,
                  const std::string& html_content,
@@ -58,6 +99,22 @@ class BrowserContentHandler {
   ProcessingResult ProcessPageSync(const std::string& page_url,
                                  const std::string& html_content);
 
+  // Process several pages at once, e.g. every open tab, extracting them in
+  // parallel. |callback| runs for each page as it finishes, and |done|
+  // after the last.
+  void ProcessPages(std::vector<content::ContentExtractionService::Page> pages,
+                    BatchProcessingCallback callback,
+                    base::OnceClosure done);
+
+  // Bring a page that changes in place, such as a single-page app or an
+  // infinite feed, up to date from a renderer delta (see
+  // PageContextExtractor::ExtractContentDelta) instead of processing it
+  // again. The cached result keeps the page's title and content type with
+  // the new text.
+  ContentUpdate ApplyContentDelta(
+      const std::string& page_url,
+      const content::LiveContentModel::Delta& delta);
+
   // Notify the handler of page navigation events
   void OnPageLoaded(const std::string& page_url,
                   const std::string& html_content,
@@ -70,19 +127,83 @@ class BrowserContentHandler {
   base::WeakPtr<BrowserContentHandler> GetWeakPtr();
 
  private:
-  // Handle content extraction result
-  void OnContentExtracted(const std::string& page_url,
-                        views::View* toolbar_view,
-                        views::Widget* browser_widget,
-                        ProcessingCallback callback,
-                        const content::ContentExtractor::ExtractedContent& content);
+  // A page on its way through its graph
+  struct PageJob;
+
+  // A page's graph while it runs
+  struct PageGraph {
+    PageGraph();
+    PageGraph(PageGraph&&);
+    PageGraph& operator=(PageGraph&&);
+    ~PageGraph();
+
+    std::string page_url;
+    std::unique_ptr<asol::core::TaskGraph> graph;
+    // Whether unloading the page cancels it
+    bool stops_on_unload = false;
+  };
+
+  // Run the graph of a page: extract it unless cached, build its result
+  // and hand it to |callback|, then, if |notify_features|, run the
+  // features and page tasks. Only graphs that notify features stop when
+  // the page is unloaded; |callback| always gets its result.
+  void RunPageGraph(const std::string& page_url,
+                    const std::string& html_content,
+                    views::View* toolbar_view,
+                    views::Widget* browser_widget,
+                    bool notify_features,
+                    ProcessingCallback callback);
+
+  // Graph steps
+  void BuildPageResult(scoped_refptr<PageJob> job,
+                       ProcessingCallback callback,
+                       base::OnceClosure done);
+  void NotifySummarization(scoped_refptr<PageJob> job,
+                           views::View* toolbar_view,
+                           views::Widget* browser_widget,
+                           base::OnceClosure done);
+
+  void OnPageGraphDone(int graph_id,
+                       const asol::core::TaskGraph::Report& report);
+
+  // Handle a page of a ProcessPages() batch
+  void OnBatchPageExtracted(
+      BatchProcessingCallback callback,
+      const std::vector<content::PageContentCache::Fingerprint>& fingerprints,
+      size_t index,
+      const std::string& page_url,
+      const content::ContentExtractor::ExtractedContent& content);
+
+  // Cache |content| as version |fingerprint| of the page and build its
+  // result
+  ProcessingResult CacheResult(
+      const std::string& page_url,
+      const content::PageContentCache::Fingerprint& fingerprint,
+      const content::ContentExtractor::ExtractedContent& content);
+
+  // Build the result for extracted |content|
+  ProcessingResult BuildResult(
+      const std::string& page_url,
+      const content::ContentExtractor::ExtractedContent& content);
 
   // Components
   BrowserFeatures* browser_features_ = nullptr;
   std::unique_ptr<content::ContentExtractor> content_extractor_;
+  std::unique_ptr<content::ContentExtractionService> extraction_service_;
+
+  // Extracted content of recent pages, by URL and content version
+  scoped_refptr<content::PageContentCache> content_cache_;
+
+  // Steps added through AddPageTask(), by name
+  std::vector<std::pair<std::string, PageTask>> page_tasks_;
+
+  // Graphs of pages being processed, by ID
+  std::unordered_map<int, PageGraph> page_graphs_;
+  int next_graph_id_ = 1;
 
-  // Cache of processed pages
-  std::unordered_map<std::string, ProcessingResult> page_cache_;
+  // Block models of pages updated through ApplyContentDelta()
+  std::unordered_map<std::string, std::unique_ptr<content::LiveContentModel>>
+      live_content_;
 
   // For weak pointers
   base::WeakPtrFactory<BrowserContentHandler> weak_ptr_factory_{this};
@@ -0,0 +1,145 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/content/content_extraction_service.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/system/sys_info.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+#include "browser_core/content/page_scanner.h"
+
+namespace browser_core {
+namespace content {
+
+namespace {
+
+ContentExtractor::ExtractedContent ExtractPage(const std::string& html) {
+  ContentExtractor::ExtractedContent content;
+  content.success = true;
+  ScanPage(html, &content);
+  return content;
+}
+
+size_t DefaultParallelism() {
+  return static_cast<size_t>(
+      std::max(1, base::SysInfo::NumberOfProcessors()));
+}
+
+}  // namespace
+
+ContentExtractionService::Batch::Batch() = default;
+ContentExtractionService::Batch::Batch(Batch&&) = default;
+ContentExtractionService::Batch& ContentExtractionService::Batch::operator=(
+    Batch&&) = default;
+ContentExtractionService::Batch::~Batch() = default;
+
+ContentExtractionService::ContentExtractionService()
+    : ContentExtractionService(Options()) {}
+
+ContentExtractionService::ContentExtractionService(const Options& options)
+    : max_parallelism_(options.max_parallelism
+                           ? options.max_parallelism
+                           : DefaultParallelism()) {}
+
+ContentExtractionService::~ContentExtractionService() = default;
+
+ContentExtractionService::BatchId ContentExtractionService::ExtractBatch(
+    std::vector<Page> pages,
+    base::TaskPriority priority,
+    PageCallback on_page,
+    base::OnceClosure on_done) {
+  BatchId batch_id = next_batch_id_++;
+  if (pages.empty()) {
+    base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+        FROM_HERE, std::move(on_done));
+    return batch_id;
+  }
+
+  Batch& batch = batches_[batch_id];
+  batch.priority = priority;
+  batch.on_page = std::move(on_page);
+  batch.on_done = std::move(on_done);
+  batch.remaining = pages.size();
+  for (size_t i = 0; i < pages.size(); ++i) {
+    queue_.push_back({batch_id, i, std::move(pages[i])});
+  }
+
+  StartJobs();
+  return batch_id;
+}
+
+void ContentExtractionService::CancelBatch(BatchId batch_id) {
+  if (!batches_.erase(batch_id)) {
+    return;
+  }
+  queue_.erase(std::remove_if(queue_.begin(), queue_.end(),
+                              [batch_id](const Job& job) {
+                                return job.batch_id == batch_id;
+                              }),
+               queue_.end());
+}
+
+size_t ContentExtractionService::GetPendingPageCount() const {
+  return queue_.size() + running_;
+}
+
+void ContentExtractionService::StartJobs() {
+  while (running_ < max_parallelism_ && !queue_.empty()) {
+    Job job = std::move(queue_.front());
+    queue_.pop_front();
+    running_++;
+
+    // The page's HTML moves into the task and is freed there
+    base::ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE,
+        {batches_[job.batch_id].priority,
+         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+        base::BindOnce(&ExtractPage, std::move(job.page.html)),
+        base::BindOnce(&ContentExtractionService::OnPageExtracted,
+                       weak_ptr_factory_.GetWeakPtr(), job.batch_id,
+                       job.index, std::move(job.page.url)));
+  }
+}
+
+void ContentExtractionService::OnPageExtracted(
+    BatchId batch_id,
+    size_t index,
+    std::string url,
+    ContentExtractor::ExtractedContent content) {
+  running_--;
+
+  auto it = batches_.find(batch_id);
+  if (it != batches_.end()) {
+    // Copy the callback: it may start or cancel batches, which can move
+    // |it| or destroy it
+    PageCallback on_page = it->second.on_page;
+    base::OnceClosure on_done;
+    if (--it->second.remaining == 0) {
+      on_done = std::move(it->second.on_done);
+      batches_.erase(it);
+    }
+
+    base::WeakPtr<ContentExtractionService> self =
+        weak_ptr_factory_.GetWeakPtr();
+    on_page.Run(index, url, content);
+    if (!self) {
+      return;
+    }
+    if (on_done) {
+      std::move(on_done).Run();
+      if (!self) {
+        return;
+      }
+    }
+  }
+
+  StartJobs();
+}
+
+}  // namespace content
+}  // namespace browser_core
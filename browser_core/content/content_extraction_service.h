@@ -0,0 +1,121 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_CONTENT_CONTENT_EXTRACTION_SERVICE_H_
+#define BROWSER_CORE_CONTENT_CONTENT_EXTRACTION_SERVICE_H_
+
+#include <stddef.h>
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/task/task_traits.h"
+#include "browser_core/content/content_extractor.h"
+
+namespace browser_core {
+namespace content {
+
+// ContentExtractionService extracts batches of pages, such as every open
+// tab or the pages of a research session, in parallel on the thread pool,
+// and reports each page as soon as it is done.
+//
+// Pages from all batches share one queue, and at most |max_parallelism|
+// of them are extracted at a time, so a large batch cannot flood the
+// thread pool; batches are served in the order they arrive. Extraction
+// needs no state, so each page is one independent task.
+//
+// Must be used on one sequence; callbacks run on it.
+class ContentExtractionService {
+ public:
+  struct Page {
+    std::string url;
+    std::string html;
+  };
+
+  struct Options {
+    // Pages extracted at once; 0 means one per processor
+    size_t max_parallelism = 0;
+  };
+
+  using BatchId = int;
+
+  // Runs once per page, in the order they finish, with the page's index
+  // in its batch
+  using PageCallback = base::RepeatingCallback<void(
+      size_t index,
+      const std::string& url,
+      const ContentExtractor::ExtractedContent& content)>;
+
+  ContentExtractionService();
+  explicit ContentExtractionService(const Options& options);
+  ~ContentExtractionService();
+
+  ContentExtractionService(const ContentExtractionService&) = delete;
+  ContentExtractionService& operator=(const ContentExtractionService&) =
+      delete;
+
+  // Extract |pages| at |priority|. |on_page| runs for each page, then
+  // |on_done| once, after the last (or straight away, posted, for an
+  // empty batch).
+  BatchId ExtractBatch(std::vector<Page> pages,
+                       base::TaskPriority priority,
+                       PageCallback on_page,
+                       base::OnceClosure on_done);
+
+  // Drop the pages of |batch_id| that have not started; pages already
+  // being extracted finish unreported. Neither callback runs again.
+  void CancelBatch(BatchId batch_id);
+
+  // Pages queued or being extracted, across all batches
+  size_t GetPendingPageCount() const;
+
+  size_t max_parallelism() const { return max_parallelism_; }
+
+ private:
+  struct Batch {
+    Batch();
+    Batch(Batch&&);
+    Batch& operator=(Batch&&);
+    ~Batch();
+
+    base::TaskPriority priority = base::TaskPriority::USER_VISIBLE;
+    PageCallback on_page;
+    base::OnceClosure on_done;
+
+    // Pages not yet reported
+    size_t remaining = 0;
+  };
+
+  struct Job {
+    BatchId batch_id;
+    size_t index;
+    Page page;
+  };
+
+  // Start queued pages while there is room
+  void StartJobs();
+
+  void OnPageExtracted(BatchId batch_id,
+                       size_t index,
+                       std::string url,
+                       ContentExtractor::ExtractedContent content);
+
+  const size_t max_parallelism_;
+
+  BatchId next_batch_id_ = 1;
+  std::unordered_map<BatchId, Batch> batches_;
+  std::deque<Job> queue_;
+  size_t running_ = 0;
+
+  base::WeakPtrFactory<ContentExtractionService> weak_ptr_factory_{this};
+};
+
+}  // namespace content
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_CONTENT_CONTENT_EXTRACTION_SERVICE_H_
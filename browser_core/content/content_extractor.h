@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "base/callback.h"
@@ -45,6 +46,38 @@ class ContentExtractor {
     std::string error_message;
   };
 
+  // A range of ExtractedText::text
+  struct TextSpan {
+    size_t offset = 0;
+    size_t length = 0;
+  };
+
+  // Extracted content without the copies: the page's text is normalized
+  // once into |text|, and the text fields are spans of it, so they also
+  // give their exact position in the page text.
+  struct ExtractedText {
+    // The page's visible text, whitespace collapsed, with a blank line
+    // between blocks
+    std::string text;
+
+    TextSpan title;
+    TextSpan main_text;
+    std::vector<TextSpan> paragraphs;
+    std::vector<TextSpan> headings;
+
+    // These may come from attributes rather than the text
+    std::string author;
+    std::string date;
+    std::vector<std::string> images;
+    std::vector<std::string> links;
+
+    ContentType content_type = ContentType::UNKNOWN;
+
+    std::string_view Get(const TextSpan& span) const {
+      return std::string_view(text).substr(span.offset, span.length);
+    }
+  };
+
   // Callback for content extraction
   using ExtractionCallback = 
       base::OnceCallback<void(const ExtractedContent& content)>;
@@ -68,6 +101,11 @@ class ContentExtractor {
   ExtractedContent ExtractContentSync(const std::string& page_url,
                                     const std::string& html_content);
 
+  // Like ExtractContentSync(), but without copying each field out of the
+  // page text
+  ExtractedText ExtractTextSync(const std::string& page_url,
+                                const std::string& html_content);
+
   // Detect content type
   ContentType DetectContentType(const std::string& html_content);
 
@@ -78,30 +116,6 @@ class ContentExtractor {
   base::WeakPtr<ContentExtractor> GetWeakPtr();
 
  private:
-  // Extract main text content
-  std::string ExtractMainText(const std::string& html_content);
-
-  // Extract title
-  std::string ExtractTitle(const std::string& html_content);
-
-  // Extract author
-  std::string ExtractAuthor(const std::string& html_content);
-
-  // Extract date
-  std::string ExtractDate(const std::string& html_content);
-
-  // Extract paragraphs
-  std::vector<std::string> ExtractParagraphs(const std::string& html_content);
-
-  // Extract headings
-  std::vector<std::string> ExtractHeadings(const std::string& html_content);
-
-  // Extract images
-  std::vector<std::string> ExtractImages(const std::string& html_content);
-
-  // Extract links
-  std::vector<std::string> ExtractLinks(const std::string& html_content);
-
   // For weak pointers
   base::WeakPtrFactory<ContentExtractor> weak_ptr_factory_{this};
 };
@@ -118,6 +132,7 @@ class ContentExtractor {
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "base/callback.h"
@@ -156,6 +171,38 @@ class ContentExtractor {
     std::string error_message;
   };
 
+  // A range of ExtractedText::text
+  struct TextSpan {
+    size_t offset = 0;
+    size_t length = 0;
+  };
+
+  // Extracted content without the copies: the page's text is normalized
+  // once into |text|, and the text fields are spans of it, so they also
+  // give their exact position in the page text.
+  struct ExtractedText {
+    // The page's visible text, whitespace collapsed, with a blank line
+    // between blocks
+    std::string text;
+
+    TextSpan title;
+    TextSpan main_text;
+    std::vector<TextSpan> paragraphs;
+    std::vector<TextSpan> headings;
+
+    // These may come from attributes rather than the text
+    std::string author;
+    std::string date;
+    std::vector<std::string> images;
+    std::vector<std::string> links;
+
+    ContentType content_type = ContentType::UNKNOWN;
+
+    std::string_view Get(const TextSpan& span) const {
+      return std::string_view(text).substr(span.offset, span.length);
+    }
+  };
+
   // Callback for content extraction
   using ExtractionCallback = 
       base::OnceCallback<void(const ExtractedContent& content)>;
@@ -179,6 +226,11 @@ class ContentExtractor {
   ExtractedContent ExtractContentSync(const std::string& page_url,
                                     const std::string& html_content);
 
+  // Like ExtractContentSync(), but without copying each field out of the
+  // page text
+  ExtractedText ExtractTextSync(const std::string& page_url,
+                                const std::string& html_content);
+
   // Detect content type
   ContentType DetectContentType(const std::string& html_content);
 
@@ -189,30 +241,6 @@ class ContentExtractor {
   base::WeakPtr<ContentExtractor> GetWeakPtr();
 
  private:
-  // Extract main text content
-  std::string ExtractMainText(const std::string& html_content);
-
-  // Extract title
-  std::string ExtractTitle(const std::string& html_content);
-
-  // Extract author
-  std::string ExtractAuthor(const std::string& html_content);
-
-  // Extract date
-  std::string ExtractDate(const std::string& html_content);
-
-  // Extract paragraphs
-  std::vector<std::string> ExtractParagraphs(const std::string& html_content);
-
-  // Extract headings
-  std::vector<std::string> ExtractHeadings(const std::string& html_content);
-
-  // Extract images
-  std::vector<std::string> ExtractImages(const std::string& html_content);
-
-  // Extract links
-  std::vector<std::string> ExtractLinks(const std::string& html_content);
-
   // For weak pointers
   base::WeakPtrFactory<ContentExtractor> weak_ptr_factory_{this};
 };
@@ -0,0 +1,418 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/content/html_tokenizer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "browser_core/content/text_scan.h"
+
+namespace browser_core {
+namespace content {
+
+namespace {
+
+struct NamedEntity {
+  const char* name;
+  uint32_t code_point;
+};
+
+// The named references pages commonly use; others are left as written
+constexpr NamedEntity kNamedEntities[] = {
+    {"amp", '&'},       {"lt", '<'},         {"gt", '>'},
+    {"quot", '"'},      {"apos", '\''},      {"nbsp", 0xa0},
+    {"copy", 0xa9},     {"reg", 0xae},       {"trade", 0x2122},
+    {"mdash", 0x2014},  {"ndash", 0x2013},   {"hellip", 0x2026},
+    {"lsquo", 0x2018},  {"rsquo", 0x2019},   {"ldquo", 0x201c},
+    {"rdquo", 0x201d},  {"laquo", 0xab},     {"raquo", 0xbb},
+    {"bull", 0x2022},   {"middot", 0xb7},    {"deg", 0xb0},
+    {"euro", 0x20ac},   {"pound", 0xa3},     {"yen", 0xa5},
+    {"cent", 0xa2},     {"sect", 0xa7},      {"para", 0xb6},
+    {"times", 0xd7},    {"divide", 0xf7},    {"plusmn", 0xb1},
+    {"frac12", 0xbd},   {"eacute", 0xe9},    {"egrave", 0xe8},
+    {"aacute", 0xe1},   {"agrave", 0xe0},    {"ouml", 0xf6},
+    {"uuml", 0xfc},     {"auml", 0xe4},      {"szlig", 0xdf},
+    {"ccedil", 0xe7},   {"ntilde", 0xf1},    {"zwj", 0x200d},
+    {"zwnj", 0x200c},   {"thinsp", 0x2009},  {"ensp", 0x2002},
+    {"emsp", 0x2003},
+};
+
+// Longest reference considered, "&#x10FFFF;" and the names above included
+constexpr size_t kMaxReferenceLength = 10;
+
+constexpr std::string_view kBlockBoundaryTags[] = {
+    "address", "article", "aside",  "blockquote", "br",      "caption",
+    "dd",      "details", "div",    "dl",         "dt",      "figcaption",
+    "figure",  "footer",  "form",   "h1",         "h2",      "h3",
+    "h4",      "h5",      "h6",     "header",     "hr",      "li",
+    "main",    "nav",     "ol",     "option",     "p",       "pre",
+    "section", "summary", "table",  "td",         "th",      "title",
+    "tr",      "ul",
+};
+
+bool IsAsciiWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+bool IsAsciiAlpha(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+char ToLowerAscii(char c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+bool StartsWithLowercase(std::string_view text, std::string_view lowercase) {
+  if (text.size() < lowercase.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lowercase.size(); ++i) {
+    if (ToLowerAscii(text[i]) != lowercase[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Ends a tag or attribute name
+bool IsNameEnd(char c) {
+  return IsAsciiWhitespace(c) || c == '/' || c == '>' || c == '=';
+}
+
+// Parse the reference after the '&' at the start of |text| (e.g. "amp;").
+// Returns the number of bytes consumed, after the '&', or 0 if there is
+// no reference.
+size_t ParseReference(std::string_view text, uint32_t* code_point) {
+  size_t semicolon = text.substr(0, kMaxReferenceLength + 1).find(';');
+  if (semicolon == std::string_view::npos || semicolon == 0) {
+    return 0;
+  }
+  std::string_view name = text.substr(0, semicolon);
+
+  if (name[0] == '#') {
+    bool hex = name.size() > 1 && (name[1] == 'x' || name[1] == 'X');
+    std::string_view digits = name.substr(hex ? 2 : 1);
+    if (digits.empty()) {
+      return 0;
+    }
+    uint32_t value = 0;
+    for (char c : digits) {
+      uint32_t digit;
+      if (c >= '0' && c <= '9') {
+        digit = c - '0';
+      } else if (hex && ToLowerAscii(c) >= 'a' && ToLowerAscii(c) <= 'f') {
+        digit = ToLowerAscii(c) - 'a' + 10;
+      } else {
+        return 0;
+      }
+      value = value * (hex ? 16 : 10) + digit;
+    }
+    *code_point = value;
+    return semicolon + 1;
+  }
+
+  for (const NamedEntity& entity : kNamedEntities) {
+    if (name == entity.name) {
+      *code_point = entity.code_point;
+      return semicolon + 1;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+std::string_view HtmlTokenizer::Token::GetAttribute(
+    std::string_view attribute_name) const {
+  if (attributes) {
+    for (const Attribute& attribute : *attributes) {
+      if (attribute.name == attribute_name) {
+        return attribute.value;
+      }
+    }
+  }
+  return std::string_view();
+}
+
+HtmlTokenizer::HtmlTokenizer(std::string_view html) : html_(html) {}
+
+HtmlTokenizer::~HtmlTokenizer() = default;
+
+bool HtmlTokenizer::Next(Token* token) {
+  if (!raw_text_end_.empty()) {
+    SkipRawText(raw_text_end_);
+    raw_text_end_.clear();
+  }
+
+  while (position_ < html_.size()) {
+    size_t start = position_;
+    if (html_[position_] == '<') {
+      if (ReadTag(token)) {
+        return true;
+      }
+      if (position_ != start) {
+        continue;  // Skipped a comment or the like
+      }
+      // A stray '<' is text
+      position_++;
+    }
+
+    const void* next_tag = memchr(html_.data() + position_, '<',
+                                  html_.size() - position_);
+    position_ = next_tag
+                    ? static_cast<size_t>(static_cast<const char*>(next_tag) -
+                                          html_.data())
+                    : html_.size();
+    token->type = TokenType::kText;
+    token->name = std::string_view();
+    token->text = html_.substr(start, position_ - start);
+    token->attributes = nullptr;
+    token->self_closing = false;
+    return true;
+  }
+  return false;
+}
+
+bool HtmlTokenizer::ReadTag(Token* token) {
+  std::string_view rest = html_.substr(position_);
+  if (rest.size() < 2) {
+    return false;
+  }
+
+  if (rest[1] == '!' || rest[1] == '?') {
+    // Comment, doctype or processing instruction
+    size_t end = rest.substr(0, 4) == "<!--" ? rest.find("-->", 4)
+                                             : rest.find('>', 2);
+    size_t terminator_length = rest.substr(0, 4) == "<!--" ? 3 : 1;
+    position_ = end == std::string_view::npos
+                    ? html_.size()
+                    : position_ + end + terminator_length;
+    return false;
+  }
+
+  const bool end_tag = rest[1] == '/';
+  size_t name_start = end_tag ? 2 : 1;
+  if (name_start >= rest.size() || !IsAsciiAlpha(rest[name_start])) {
+    return false;
+  }
+
+  size_t name_end = name_start;
+  while (name_end < rest.size() && !IsNameEnd(rest[name_end])) {
+    ++name_end;
+  }
+  tag_name_.resize(name_end - name_start);
+  std::transform(rest.begin() + name_start, rest.begin() + name_end,
+                 tag_name_.begin(), ToLowerAscii);
+  position_ += name_end;
+
+  token->name = tag_name_;
+  token->text = std::string_view();
+  token->self_closing = false;
+  attributes_.clear();
+
+  if (end_tag) {
+    size_t close = html_.find('>', position_);
+    position_ = close == std::string_view::npos ? html_.size() : close + 1;
+    token->type = TokenType::kEndTag;
+    token->attributes = nullptr;
+    return true;
+  }
+
+  token->type = TokenType::kStartTag;
+  token->attributes = &attributes_;
+  ReadAttributes(token);
+  if (!token->self_closing &&
+      (tag_name_ == "script" || tag_name_ == "style")) {
+    raw_text_end_ = "</" + tag_name_;
+  }
+  return true;
+}
+
+void HtmlTokenizer::ReadAttributes(Token* token) {
+  const size_t size = html_.size();
+  while (position_ < size) {
+    char c = html_[position_];
+    if (c == '>') {
+      position_++;
+      return;
+    }
+    if (IsAsciiWhitespace(c) || c == '=') {
+      position_++;
+      continue;
+    }
+    if (c == '/') {
+      position_++;
+      if (position_ < size && html_[position_] == '>') {
+        token->self_closing = true;
+      }
+      continue;
+    }
+
+    size_t name_start = position_;
+    while (position_ < size && !IsNameEnd(html_[position_])) {
+      ++position_;
+    }
+    Attribute attribute;
+    attribute.name.resize(position_ - name_start);
+    std::transform(html_.begin() + name_start, html_.begin() + position_,
+                   attribute.name.begin(), ToLowerAscii);
+
+    size_t after_name = position_;
+    while (position_ < size && IsAsciiWhitespace(html_[position_])) {
+      ++position_;
+    }
+    if (position_ >= size || html_[position_] != '=') {
+      // A bare attribute such as "disabled"
+      position_ = after_name;
+      attributes_.push_back(std::move(attribute));
+      continue;
+    }
+    position_++;
+    while (position_ < size && IsAsciiWhitespace(html_[position_])) {
+      ++position_;
+    }
+
+    if (position_ < size &&
+        (html_[position_] == '"' || html_[position_] == '\'')) {
+      char quote = html_[position_++];
+      size_t close = html_.find(quote, position_);
+      size_t value_end = close == std::string_view::npos ? size : close;
+      attribute.value = html_.substr(position_, value_end - position_);
+      position_ = close == std::string_view::npos ? size : close + 1;
+    } else {
+      size_t value_start = position_;
+      while (position_ < size && !IsAsciiWhitespace(html_[position_]) &&
+             html_[position_] != '>') {
+        ++position_;
+      }
+      attribute.value = html_.substr(value_start, position_ - value_start);
+    }
+    attributes_.push_back(std::move(attribute));
+  }
+}
+
+void HtmlTokenizer::SkipRawText(std::string_view end_tag) {
+  while (position_ < html_.size()) {
+    const void* next = memchr(html_.data() + position_, '<',
+                              html_.size() - position_);
+    if (!next) {
+      break;
+    }
+    position_ = static_cast<const char*>(next) - html_.data();
+    if (StartsWithLowercase(html_.substr(position_), end_tag)) {
+      return;  // The end tag is the next token
+    }
+    position_++;
+  }
+  position_ = html_.size();
+}
+
+TextAccumulator::TextAccumulator() = default;
+TextAccumulator::~TextAccumulator() = default;
+
+void TextAccumulator::AppendText(std::string_view raw) {
+  size_t i = 0;
+  while (i < raw.size()) {
+    char c = raw[i];
+    if (c == '&') {
+      uint32_t code_point = 0;
+      size_t length = ParseReference(raw.substr(i + 1), &code_point);
+      if (length > 0) {
+        AppendCodePoint(code_point);
+        i += 1 + length;
+        continue;
+      }
+    } else if (IsAsciiWhitespace(c)) {
+      AppendBreak();
+      ++i;
+      continue;
+    }
+
+    // Copy the character and the plain run after it, single spaces
+    // between words included, at once
+    size_t run = PlainTextRunLength(raw.substr(i + 1));
+    AppendChar(c);
+    text_.append(raw.data() + i + 1, run);
+    i += 1 + run;
+  }
+}
+
+std::string TextAccumulator::Take() {
+  pending_ = Separator::kNone;
+  return std::move(text_);
+}
+
+void TextAccumulator::AppendChar(char c) {
+  if (!text_.empty()) {
+    if (pending_ == Separator::kSpace) {
+      text_ += ' ';
+    } else if (pending_ == Separator::kParagraph) {
+      text_ += "\n\n";
+    }
+  }
+  pending_ = Separator::kNone;
+  text_ += c;
+}
+
+void TextAccumulator::AppendCodePoint(uint32_t code_point) {
+  if (code_point == 0xa0) {
+    // A non-breaking space is still a space between words
+    AppendBreak();
+    return;
+  }
+  if (code_point == 0 || code_point > 0x10ffff ||
+      (code_point >= 0xd800 && code_point <= 0xdfff)) {
+    code_point = 0xfffd;
+  }
+  if (code_point < 0x80) {
+    if (IsAsciiWhitespace(static_cast<char>(code_point))) {
+      AppendBreak();
+    } else {
+      AppendChar(static_cast<char>(code_point));
+    }
+    return;
+  }
+
+  char bytes[4];
+  size_t length;
+  if (code_point < 0x800) {
+    bytes[0] = static_cast<char>(0xc0 | (code_point >> 6));
+    length = 2;
+  } else if (code_point < 0x10000) {
+    bytes[0] = static_cast<char>(0xe0 | (code_point >> 12));
+    length = 3;
+  } else {
+    bytes[0] = static_cast<char>(0xf0 | (code_point >> 18));
+    length = 4;
+  }
+  for (size_t i = 1; i < length; ++i) {
+    bytes[i] = static_cast<char>(
+        0x80 | ((code_point >> (6 * (length - 1 - i))) & 0x3f));
+  }
+  AppendChar(bytes[0]);
+  text_.append(bytes + 1, length - 1);
+}
+
+bool IsBlockBoundaryTag(std::string_view tag_name) {
+  return std::find(std::begin(kBlockBoundaryTags), std::end(kBlockBoundaryTags),
+                   tag_name) != std::end(kBlockBoundaryTags);
+}
+
+std::string HtmlToText(std::string_view html) {
+  HtmlTokenizer tokenizer(html);
+  HtmlTokenizer::Token token;
+  TextAccumulator text;
+  while (tokenizer.Next(&token)) {
+    if (token.type == HtmlTokenizer::TokenType::kText) {
+      text.AppendText(token.text);
+    } else if (IsBlockBoundaryTag(token.name)) {
+      text.AppendBreak();
+    }
+  }
+  return text.Take();
+}
+
+}  // namespace content
+}  // namespace browser_core
@@ -0,0 +1,148 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_CONTENT_HTML_TOKENIZER_H_
+#define BROWSER_CORE_CONTENT_HTML_TOKENIZER_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace browser_core {
+namespace content {
+
+// HtmlTokenizer splits an HTML document into tags and text in one forward
+// pass, without building a DOM and without backtracking, so its cost is
+// linear in the input however the markup is malformed.
+//
+// It is forgiving in the way pages need: a '<' that does not start a tag
+// is text, an unterminated tag ends the document, comments, doctypes and
+// processing instructions are skipped, and the contents of <script> and
+// <style> are skipped rather than read as markup. Tag and attribute names
+// are lowercased; text and attribute values are left raw (see
+// TextAccumulator for decoding).
+//
+// Tokens point into the input and into the tokenizer, and are valid until
+// the next call to Next().
+class HtmlTokenizer {
+ public:
+  enum class TokenType {
+    kStartTag,
+    kEndTag,
+    kText,
+  };
+
+  struct Attribute {
+    std::string name;
+    std::string_view value;
+  };
+
+  struct Token {
+    TokenType type = TokenType::kText;
+
+    // Lowercase tag name; empty for text
+    std::string_view name;
+
+    // Raw text; empty for tags
+    std::string_view text;
+
+    // Start tags only
+    const std::vector<Attribute>* attributes = nullptr;
+    bool self_closing = false;
+
+    // Raw value of the attribute called |attribute_name| (lowercase), or
+    // an empty view
+    std::string_view GetAttribute(std::string_view attribute_name) const;
+  };
+
+  explicit HtmlTokenizer(std::string_view html);
+  ~HtmlTokenizer();
+
+  HtmlTokenizer(const HtmlTokenizer&) = delete;
+  HtmlTokenizer& operator=(const HtmlTokenizer&) = delete;
+
+  // Read the next token. Returns false at the end of the input.
+  bool Next(Token* token);
+
+ private:
+  // Parse the tag whose '<' is at |position_|. Returns false if it is not
+  // a tag: either a comment or the like was skipped, or nothing was
+  // consumed and the '<' is text.
+  bool ReadTag(Token* token);
+
+  void ReadAttributes(Token* token);
+
+  // Skip past the closing tag of a raw text element such as <script>
+  void SkipRawText(std::string_view tag_name);
+
+  std::string_view html_;
+  size_t position_ = 0;
+
+  // Storage for the current token
+  std::string tag_name_;
+  std::vector<Attribute> attributes_;
+
+  // Set after a <script> or <style> start tag: its contents are skipped
+  // before the next token
+  std::string raw_text_end_;
+};
+
+// TextAccumulator turns raw HTML text into plain text as it is appended:
+// character references are decoded and runs of whitespace collapse into a
+// single space, with none at either end. Breaks between blocks of text
+// are only written once text follows them.
+class TextAccumulator {
+ public:
+  TextAccumulator();
+  ~TextAccumulator();
+
+  // Append raw text, as found between tags
+  void AppendText(std::string_view raw);
+
+  // Separate what comes next from what came before with a space, e.g. at
+  // a block element or <br>
+  void AppendBreak() {
+    if (pending_ == Separator::kNone) {
+      pending_ = Separator::kSpace;
+    }
+  }
+
+  // Separate what comes next from what came before with a blank line,
+  // e.g. between paragraphs
+  void AppendParagraphBreak() { pending_ = Separator::kParagraph; }
+
+  bool empty() const { return text_.empty(); }
+  size_t size() const { return text_.size(); }
+  const std::string& text() const { return text_; }
+
+  // Hand over the text and start afresh
+  std::string Take();
+
+ private:
+  enum class Separator {
+    kNone,
+    kSpace,
+    kParagraph,
+  };
+
+  void AppendChar(char c);
+  void AppendCodePoint(uint32_t code_point);
+
+  std::string text_;
+  Separator pending_ = Separator::kNone;
+};
+
+// Whether |tag_name| (lowercase) starts a new block of text, so that the
+// words on either side of it must not run together
+bool IsBlockBoundaryTag(std::string_view tag_name);
+
+// Plain text of |html|: tags stripped, script and style contents dropped,
+// character references decoded and whitespace normalized, in one pass.
+std::string HtmlToText(std::string_view html);
+
+}  // namespace content
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_CONTENT_HTML_TOKENIZER_H_
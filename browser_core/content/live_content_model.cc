@@ -0,0 +1,97 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/content/live_content_model.h"
+
+#include <iterator>
+#include <utility>
+
+namespace browser_core {
+namespace content {
+
+LiveContentModel::Delta::Delta() = default;
+LiveContentModel::Delta::Delta(Delta&&) = default;
+LiveContentModel::Delta& LiveContentModel::Delta::operator=(Delta&&) =
+    default;
+LiveContentModel::Delta::~Delta() = default;
+
+LiveContentModel::Update::Update() = default;
+LiveContentModel::Update::Update(const Update&) = default;
+LiveContentModel::Update& LiveContentModel::Update::operator=(
+    const Update&) = default;
+LiveContentModel::Update::~Update() = default;
+
+LiveContentModel::LiveContentModel() = default;
+LiveContentModel::~LiveContentModel() = default;
+
+LiveContentModel::Update LiveContentModel::Apply(const Delta& delta) {
+  Update update;
+  if (delta.reset) {
+    for (const Block& block : blocks_) {
+      update.removed.push_back(block.id);
+    }
+    blocks_.clear();
+    index_.clear();
+  }
+
+  // Removals first, so an ID the renderer reuses cannot collide
+  for (int id : delta.removed) {
+    auto it = index_.find(id);
+    if (it == index_.end()) {
+      continue;
+    }
+    blocks_.erase(it->second);
+    index_.erase(it);
+    update.removed.push_back(id);
+  }
+
+  for (const Delta::AddedBlock& added : delta.added) {
+    if (index_.count(added.id)) {
+      continue;
+    }
+    BlockList::iterator position = blocks_.end();
+    if (added.after_id == 0) {
+      position = blocks_.begin();
+    } else {
+      auto after = index_.find(added.after_id);
+      if (after != index_.end()) {
+        position = std::next(after->second);
+      }
+    }
+    index_[added.id] = blocks_.insert(position, {added.id, added.text});
+    update.updated.push_back({added.id, added.text});
+  }
+
+  for (const Block& changed : delta.changed) {
+    auto it = index_.find(changed.id);
+    if (it == index_.end() || it->second->text == changed.text) {
+      continue;
+    }
+    it->second->text = changed.text;
+    update.updated.push_back(changed);
+  }
+
+  if (!update.empty()) {
+    text_valid_ = false;
+  }
+  return update;
+}
+
+const std::string& LiveContentModel::GetText() const {
+  if (text_valid_) {
+    return text_;
+  }
+  text_.clear();
+  for (const Block& block : blocks_) {
+    if (!text_.empty()) {
+      text_ += "\n\n";
+    }
+    text_ += block.text;
+  }
+  text_valid_ = true;
+  return text_;
+}
+
+}  // namespace content
+}  // namespace browser_core
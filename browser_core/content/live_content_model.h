@@ -0,0 +1,97 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_CONTENT_LIVE_CONTENT_MODEL_H_
+#define BROWSER_CORE_CONTENT_LIVE_CONTENT_MODEL_H_
+
+#include <stddef.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace browser_core {
+namespace content {
+
+// LiveContentModel holds the text blocks of a page that changes in place,
+// such as a single-page app or an infinite feed, and keeps them current
+// from deltas reported by the renderer instead of re-extracting the page.
+//
+// Blocks are keyed by the renderer's block IDs and kept in document order.
+// Applying a delta reports which blocks are new or different, so consumers
+// re-summarize or re-index only those.
+class LiveContentModel {
+ public:
+  struct Block {
+    int id = 0;
+    std::string text;
+  };
+
+  // A renderer delta; see PageContextExtractor::ContentDelta
+  struct Delta {
+    struct AddedBlock {
+      int id = 0;
+      int after_id = 0;  // 0 for the start
+      std::string text;
+    };
+
+    Delta();
+    Delta(Delta&&);
+    Delta& operator=(Delta&&);
+    ~Delta();
+
+    bool reset = false;
+    std::vector<AddedBlock> added;
+    std::vector<Block> changed;
+    std::vector<int> removed;
+  };
+
+  // The effect of one delta
+  struct Update {
+    Update();
+    Update(const Update&);
+    Update& operator=(const Update&);
+    ~Update();
+
+    bool empty() const { return updated.empty() && removed.empty(); }
+
+    // Blocks added or changed, in the order the delta listed them
+    std::vector<Block> updated;
+    std::vector<int> removed;
+  };
+
+  LiveContentModel();
+  ~LiveContentModel();
+
+  LiveContentModel(const LiveContentModel&) = delete;
+  LiveContentModel& operator=(const LiveContentModel&) = delete;
+
+  // Apply |delta|. A reset delta replaces every block. Added blocks whose
+  // predecessor is unknown go at the end; changes and removals of unknown
+  // blocks are ignored.
+  Update Apply(const Delta& delta);
+
+  // The blocks in document order, separated by blank lines. Cached until
+  // the next Apply().
+  const std::string& GetText() const;
+
+  // The blocks in document order
+  const std::list<Block>& blocks() const { return blocks_; }
+  size_t block_count() const { return blocks_.size(); }
+
+ private:
+  using BlockList = std::list<Block>;
+
+  BlockList blocks_;
+  std::unordered_map<int, BlockList::iterator> index_;
+
+  mutable std::string text_;
+  mutable bool text_valid_ = true;
+};
+
+}  // namespace content
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_CONTENT_LIVE_CONTENT_MODEL_H_
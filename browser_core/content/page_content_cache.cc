@@ -0,0 +1,110 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/content/page_content_cache.h"
+
+#include <utility>
+#include <vector>
+
+namespace browser_core {
+namespace content {
+
+namespace {
+
+// Approximate bookkeeping cost of one entry (list node, index slot)
+constexpr size_t kEntryOverheadBytes = 128;
+
+// Approximate cost of one string held in a list
+constexpr size_t kStringOverheadBytes = sizeof(std::string);
+
+size_t StringsSize(const std::vector<std::string>& strings) {
+  size_t size = 0;
+  for (const std::string& string : strings) {
+    size += string.size() + kStringOverheadBytes;
+  }
+  return size;
+}
+
+size_t ComputeCharge(const std::string& url,
+                     const ContentExtractor::ExtractedContent& content) {
+  return kEntryOverheadBytes + url.size() + content.title.size() +
+         content.main_text.size() + content.author.size() +
+         content.date.size() + content.error_message.size() +
+         StringsSize(content.paragraphs) + StringsSize(content.headings) +
+         StringsSize(content.images) + StringsSize(content.links);
+}
+
+}  // namespace
+
+PageContentCache::PageContentCache(size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+PageContentCache::~PageContentCache() = default;
+
+// static
+PageContentCache::Fingerprint PageContentCache::ComputeFingerprint(
+    std::string_view content) {
+  asol::core::Hasher128 hasher;
+  hasher.Update(content);
+  return hasher.Finish();
+}
+
+const ContentExtractor::ExtractedContent* PageContentCache::Get(
+    const std::string& url,
+    const Fingerprint& fingerprint) {
+  auto it = index_.find(url);
+  if (it == index_.end() || it->second->fingerprint != fingerprint) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return &it->second->content;
+}
+
+const ContentExtractor::ExtractedContent* PageContentCache::GetAnyVersion(
+    const std::string& url) const {
+  auto it = index_.find(url);
+  return it == index_.end() ? nullptr : &it->second->content;
+}
+
+void PageContentCache::Put(const std::string& url,
+                           const Fingerprint& fingerprint,
+                           ContentExtractor::ExtractedContent content) {
+  Remove(url);
+
+  size_t charge = ComputeCharge(url, content);
+  if (charge > max_bytes_) {
+    return;
+  }
+  while (!lru_.empty() && bytes_ + charge > max_bytes_) {
+    Erase(index_.find(lru_.back().url));
+  }
+  bytes_ += charge;
+  lru_.push_front({url, fingerprint, std::move(content), charge});
+  index_[url] = lru_.begin();
+}
+
+void PageContentCache::Remove(const std::string& url) {
+  auto it = index_.find(url);
+  if (it != index_.end()) {
+    Erase(it);
+  }
+}
+
+void PageContentCache::Clear() {
+  index_.clear();
+  lru_.clear();
+  bytes_ = 0;
+}
+
+void PageContentCache::Erase(
+    std::unordered_map<std::string, LruList::iterator>::iterator it) {
+  bytes_ -= it->second->charge;
+  lru_.erase(it->second);
+  index_.erase(it);
+}
+
+}  // namespace content
+}  // namespace browser_core
@@ -0,0 +1,99 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_CONTENT_PAGE_CONTENT_CACHE_H_
+#define BROWSER_CORE_CONTENT_PAGE_CONTENT_CACHE_H_
+
+#include <stddef.h>
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "asol/core/request_fingerprint.h"
+#include "base/memory/ref_counted.h"
+#include "browser_core/content/content_extractor.h"
+
+namespace browser_core {
+namespace content {
+
+// PageContentCache remembers the extracted content of recently seen pages,
+// so a page is extracted once per version of its content however many
+// features ask for it.
+//
+// Entries are keyed by URL and carry a fingerprint of the content they
+// were extracted from; a lookup with a different fingerprint is a miss, so
+// a URL whose content changed is never served stale. Only the latest
+// version of a URL is kept. Bounded by an estimate of the bytes held, and
+// evicts least recently used pages first.
+//
+// Shared by reference between its users. Must be used on one sequence.
+class PageContentCache : public base::RefCounted<PageContentCache> {
+ public:
+  using Fingerprint = asol::core::RequestFingerprint;
+
+  static constexpr size_t kDefaultMaxBytes = 16 * 1024 * 1024;
+
+  explicit PageContentCache(size_t max_bytes = kDefaultMaxBytes);
+
+  PageContentCache(const PageContentCache&) = delete;
+  PageContentCache& operator=(const PageContentCache&) = delete;
+
+  // Fingerprint of the content a page was extracted from, usually its HTML
+  static Fingerprint ComputeFingerprint(std::string_view content);
+
+  // The content extracted from version |fingerprint| of |url|, or null.
+  // The pointer is valid until the next call that changes the cache.
+  const ContentExtractor::ExtractedContent* Get(
+      const std::string& url,
+      const Fingerprint& fingerprint);
+
+  // The latest content of |url| whatever its version, or null. Does not
+  // count as a hit.
+  const ContentExtractor::ExtractedContent* GetAnyVersion(
+      const std::string& url) const;
+
+  // Remember |content| as version |fingerprint| of |url|, replacing any
+  // other version. Content larger than the whole budget is not kept.
+  void Put(const std::string& url,
+           const Fingerprint& fingerprint,
+           ContentExtractor::ExtractedContent content);
+
+  void Remove(const std::string& url);
+  void Clear();
+
+  size_t GetHitCount() const { return hits_; }
+  size_t GetMissCount() const { return misses_; }
+  size_t GetByteSize() const { return bytes_; }
+  size_t GetEntryCount() const { return index_.size(); }
+
+ private:
+  friend class base::RefCounted<PageContentCache>;
+
+  struct Entry {
+    std::string url;
+    Fingerprint fingerprint;
+    ContentExtractor::ExtractedContent content;
+    size_t charge = 0;
+  };
+  using LruList = std::list<Entry>;
+
+  ~PageContentCache();
+
+  void Erase(std::unordered_map<std::string, LruList::iterator>::iterator it);
+
+  const size_t max_bytes_;
+  size_t bytes_ = 0;
+  LruList lru_;
+  std::unordered_map<std::string, LruList::iterator> index_;
+
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+};
+
+}  // namespace content
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_CONTENT_PAGE_CONTENT_CACHE_H_
@@ -0,0 +1,590 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/content/page_scanner.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/strings/string_util.h"
+#include "browser_core/content/html_tokenizer.h"
+
+namespace browser_core {
+namespace content {
+
+namespace {
+
+using ContentType = ContentExtractor::ContentType;
+using Token = HtmlTokenizer::Token;
+using TokenType = HtmlTokenizer::TokenType;
+
+// What a page's words and class names suggest it is
+enum Signal {
+  kArticle,
+  kProduct,
+  kDocumentation,
+  kForum,
+  kSocial,
+  kSignalCount,
+};
+
+constexpr int kNotCounted = -1;
+
+struct Keyword {
+  std::string_view word;
+
+  // The word must follow this one, e.g. "buy" for "now"
+  std::string_view previous;
+
+  // Signals (bit per Signal) the word gives on its own, and as a prefix
+  // such as "post-"
+  uint8_t signals;
+  uint8_t prefix_signals;
+
+  // Signal whose tally the word adds to, or kNotCounted
+  int counted;
+};
+
+constexpr uint8_t Bit(Signal signal) {
+  return static_cast<uint8_t>(1 << signal);
+}
+
+// Sorted by word
+constexpr Keyword kKeywords[] = {
+    {"api", "", 0, Bit(kDocumentation), kNotCounted},
+    {"article", "", 0, Bit(kArticle), kNotCounted},
+    {"blog", "", 0, Bit(kArticle), kNotCounted},
+    {"cart", "to", Bit(kProduct), 0, kNotCounted},
+    {"comment", "", 0, Bit(kForum), kForum},
+    {"cost", "", 0, 0, kProduct},
+    {"discussion", "", 0, Bit(kForum), kNotCounted},
+    {"documentation", "", Bit(kDocumentation), 0, kNotCounted},
+    {"example", "", 0, 0, kDocumentation},
+    {"feed", "", 0, Bit(kSocial), kNotCounted},
+    {"follow", "", 0, 0, kSocial},
+    {"forum", "", 0, Bit(kForum), kNotCounted},
+    {"function", "", 0, 0, kDocumentation},
+    {"guide", "", 0, Bit(kDocumentation), kNotCounted},
+    {"like", "", 0, 0, kSocial},
+    {"manual", "", 0, Bit(kDocumentation), kNotCounted},
+    {"method", "", 0, 0, kDocumentation},
+    {"now", "buy", Bit(kProduct), 0, kNotCounted},
+    {"post", "", 0, Bit(kArticle) | Bit(kForum), kForum},
+    {"price", "", Bit(kProduct), 0, kProduct},
+    {"product", "", 0, Bit(kProduct), kNotCounted},
+    {"profile", "", 0, Bit(kSocial), kNotCounted},
+    {"reference", "", 0, Bit(kDocumentation), kNotCounted},
+    {"reply", "", 0, 0, kForum},
+    {"share", "", 0, 0, kSocial},
+    {"social", "", 0, Bit(kSocial), kNotCounted},
+    {"status", "", 0, Bit(kSocial), kSocial},
+    {"thread", "", 0, Bit(kForum), kForum},
+    {"tweet", "", 0, Bit(kSocial), kSocial},
+};
+
+constexpr bool KeywordsAreSorted() {
+  for (size_t i = 1; i < std::size(kKeywords); ++i) {
+    if (!(kKeywords[i - 1].word < kKeywords[i].word)) {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(KeywordsAreSorted(), "kKeywords must be sorted by word");
+
+// Bounds on the length of a keyword, plural included
+constexpr size_t kMinKeywordLength = 3;
+constexpr size_t kMaxKeywordLength = 14;
+
+const Keyword* FindKeyword(std::string_view word) {
+  const Keyword* it = std::lower_bound(
+      std::begin(kKeywords), std::end(kKeywords), word,
+      [](const Keyword& keyword, std::string_view word) {
+        return keyword.word < word;
+      });
+  return it != std::end(kKeywords) && it->word == word ? it : nullptr;
+}
+
+// Keyword signals, gathered from text and class/id attributes
+class SignalCounter {
+ public:
+  void Scan(std::string_view text) {
+    std::string_view previous;
+    size_t i = 0;
+    while (i < text.size()) {
+      char c = text[i];
+      if (base::IsAsciiAlpha(c)) {
+        size_t start = i;
+        while (i < text.size() && base::IsAsciiAlpha(text[i])) {
+          ++i;
+        }
+        std::string_view word = text.substr(start, i - start);
+        if (word.size() >= kMinKeywordLength &&
+            word.size() <= kMaxKeywordLength) {
+          bool prefix = i < text.size() && text[i] == '-';
+          AddWord(word, previous, prefix);
+        }
+        previous = word;
+        continue;
+      }
+
+      // Currency: '$', '£' (C2 A3) and '€' (E2 82 AC)
+      if (c == '$' || text.substr(i, 2) == "\xc2\xa3" ||
+          text.substr(i, 3) == "\xe2\x82\xac") {
+        counts_[kProduct]++;
+      }
+      if (!base::IsAsciiWhitespace(c)) {
+        previous = std::string_view();
+      }
+      ++i;
+    }
+  }
+
+  void AddSignal(Signal signal) { present_ |= Bit(signal); }
+  void Count(Signal signal) { counts_[signal]++; }
+
+  // |paragraph_count| and |heading_count| weigh towards an article
+  ContentType Decide(size_t paragraph_count, size_t heading_count) const {
+    // A telling word anywhere decides, in this order
+    constexpr std::pair<Signal, ContentType> kOrder[] = {
+        {kArticle, ContentType::ARTICLE},
+        {kProduct, ContentType::PRODUCT},
+        {kDocumentation, ContentType::DOCUMENTATION},
+        {kForum, ContentType::FORUM},
+        {kSocial, ContentType::SOCIAL},
+    };
+    for (const auto& [signal, type] : kOrder) {
+      if (present_ & Bit(signal)) {
+        return type;
+      }
+    }
+
+    // Otherwise the most frequent kind of word does
+    std::array<size_t, kSignalCount> scores;
+    scores[kArticle] = heading_count / 2 + paragraph_count / 3;
+    for (int signal = kProduct; signal < kSignalCount; ++signal) {
+      scores[signal] = counts_[signal] / 2;
+    }
+    size_t max_score = *std::max_element(scores.begin(), scores.end());
+    if (max_score == 0) {
+      return ContentType::UNKNOWN;
+    }
+    if (std::count(scores.begin(), scores.end(), max_score) > 1) {
+      return ContentType::MIXED;
+    }
+    for (const auto& [signal, type] : kOrder) {
+      if (scores[signal] == max_score) {
+        return type;
+      }
+    }
+    return ContentType::UNKNOWN;
+  }
+
+ private:
+  // |word| and |previous| are as written in the page, in any case
+  void AddWord(std::string_view word,
+               std::string_view previous,
+               bool prefix) {
+    char lowercase[kMaxKeywordLength];
+    for (size_t i = 0; i < word.size(); ++i) {
+      lowercase[i] = base::ToLowerASCII(word[i]);
+    }
+    std::string_view key(lowercase, word.size());
+    const Keyword* keyword = FindKeyword(key);
+    if (!keyword && key.back() == 's') {
+      keyword = FindKeyword(key.substr(0, key.size() - 1));
+    }
+    if (!keyword) {
+      return;
+    }
+    if (!keyword->previous.empty() &&
+        !base::EqualsCaseInsensitiveASCII(previous, keyword->previous)) {
+      return;
+    }
+    present_ |= keyword->signals;
+    if (prefix) {
+      present_ |= keyword->prefix_signals;
+    }
+    if (keyword->counted != kNotCounted) {
+      counts_[keyword->counted]++;
+    }
+  }
+
+  uint8_t present_ = 0;
+  std::array<size_t, kSignalCount> counts_ = {};
+};
+
+bool ClassContains(const Token& token, std::string_view name) {
+  return token.GetAttribute("class").find(name) != std::string_view::npos;
+}
+
+std::string DecodeAttribute(std::string_view value) {
+  TextAccumulator text;
+  text.AppendText(value);
+  return text.Take();
+}
+
+bool IsHeadingTag(std::string_view tag) {
+  return tag.size() == 2 && tag[0] == 'h' && tag[1] >= '1' && tag[1] <= '6';
+}
+
+// Where in the page text the first element with a given tag that
+// satisfies a test lies, including its nested elements of the same tag
+class Region {
+ public:
+  explicit Region(std::string_view tag) : tag_(tag) {}
+
+  // |matches| says whether a start tag of |tag_| may begin the region;
+  // |offset| is the size of the page text so far
+  void OnStartTag(const Token& token, bool matches, size_t offset) {
+    if (token.name != tag_ || token.self_closing) {
+      return;
+    }
+    if (depth_ > 0) {
+      depth_++;
+    } else if (!started_ && matches) {
+      depth_ = 1;
+      started_ = true;
+      start_ = offset;
+    }
+  }
+
+  void OnEndTag(const Token& token, size_t offset) {
+    if (depth_ > 0 && token.name == tag_ && --depth_ == 0) {
+      end_ = offset;
+    }
+  }
+
+  bool started() const { return started_; }
+  size_t start() const { return start_; }
+
+  // A region still open at the end of the page ends there
+  size_t end(size_t text_size) const { return depth_ > 0 ? text_size : end_; }
+
+ private:
+  const std::string_view tag_;
+  int depth_ = 0;
+  bool started_ = false;
+  size_t start_ = 0;
+  size_t end_ = 0;
+};
+
+class PageScanner {
+ public:
+  explicit PageScanner(ContentExtractor::ExtractedText* result)
+      : result_(result) {}
+
+  void Scan(std::string_view html) {
+    HtmlTokenizer tokenizer(html);
+    Token token;
+    while (tokenizer.Next(&token)) {
+      switch (token.type) {
+        case TokenType::kStartTag:
+          OnStartTag(token);
+          break;
+        case TokenType::kEndTag:
+          OnEndTag(token);
+          break;
+        case TokenType::kText:
+          signals_.Scan(token.text);
+          text_.AppendText(token.text);
+          break;
+      }
+    }
+    Finish();
+  }
+
+ private:
+  void OnStartTag(const Token& token) {
+    std::string_view tag = token.name;
+    std::string_view class_name = token.GetAttribute("class");
+    signals_.Scan(class_name);
+    signals_.Scan(token.GetAttribute("id"));
+
+    if (IsBlockBoundaryTag(tag)) {
+      OnBlockBoundary(tag);
+    }
+
+    article_.OnStartTag(token, true, text_.size());
+    main_.OnStartTag(token, true, text_.size());
+    content_div_.OnStartTag(token, ClassContains(token, "content"),
+                            text_.size());
+
+    if (IsHeadingTag(tag)) {
+      FlushHeading();
+      heading_level_ = tag[1] - '0';
+      heading_start_ = text_.size();
+    } else if (tag == "p") {
+      in_paragraph_ = !token.self_closing;
+      paragraph_start_ = text_.size();
+    } else if (tag == "title") {
+      in_title_ = !title_found_ && !token.self_closing;
+      title_start_ = text_.size();
+    } else if (tag == "article") {
+      signals_.AddSignal(kArticle);
+    } else if (tag == "code" || tag == "pre") {
+      signals_.Count(kDocumentation);
+    } else if (tag == "meta") {
+      OnMetaTag(token);
+    } else if (tag == "time") {
+      if (time_date_.empty()) {
+        time_date_ = DecodeAttribute(token.GetAttribute("datetime"));
+      }
+    } else if (tag == "img") {
+      std::string_view src = token.GetAttribute("src");
+      if (!src.empty()) {
+        result_->images.emplace_back(src);
+      }
+    } else if (tag == "a") {
+      std::string_view href = token.GetAttribute("href");
+      if (!href.empty()) {
+        result_->links.emplace_back(href);
+      }
+    }
+
+    if (base::StartsWith(class_name, "article")) {
+      signals_.AddSignal(kArticle);
+    }
+    if (!element_author_.length && !in_author_ &&
+        ClassContains(token, "author")) {
+      in_author_ = true;
+      author_start_ = text_.size();
+    }
+    if (!element_date_.length && !in_date_ && ClassContains(token, "date")) {
+      in_date_ = true;
+      date_start_ = text_.size();
+    }
+  }
+
+  void OnEndTag(const Token& token) {
+    std::string_view tag = token.name;
+    article_.OnEndTag(token, text_.size());
+    main_.OnEndTag(token, text_.size());
+    content_div_.OnEndTag(token, text_.size());
+
+    if (heading_level_ > 0 && IsHeadingTag(tag)) {
+      FlushHeading();
+    } else if (tag == "p") {
+      FlushParagraph();
+    } else if (tag == "title" && in_title_) {
+      result_->title = SpanFrom(title_start_);
+      title_found_ = true;
+      in_title_ = false;
+    }
+
+    // The author and date elements end at the first closing tag
+    if (in_author_) {
+      element_author_ = SpanFrom(author_start_);
+      in_author_ = false;
+    }
+    if (in_date_) {
+      element_date_ = SpanFrom(date_start_);
+      in_date_ = false;
+    }
+
+    if (IsBlockBoundaryTag(tag)) {
+      OnBlockBoundary(tag);
+    }
+  }
+
+  void OnBlockBoundary(std::string_view tag) {
+    if (tag == "br") {
+      text_.AppendBreak();
+      return;
+    }
+    // A paragraph also ends with the block around it
+    FlushParagraph();
+    text_.AppendParagraphBreak();
+  }
+
+  void OnMetaTag(const Token& token) {
+    std::string_view name = token.GetAttribute("name");
+    if (base::EqualsCaseInsensitiveASCII(name, "author")) {
+      if (meta_author_.empty()) {
+        meta_author_ = DecodeAttribute(token.GetAttribute("content"));
+      }
+    } else if (base::EqualsCaseInsensitiveASCII(name, "date")) {
+      if (meta_date_.empty()) {
+        meta_date_ = DecodeAttribute(token.GetAttribute("content"));
+      }
+    }
+  }
+
+  // The text written since the page text was |start| long, less the
+  // separator written ahead of it
+  ContentExtractor::TextSpan SpanFrom(size_t start) const {
+    return Span(start, text_.size());
+  }
+
+  ContentExtractor::TextSpan Span(size_t start, size_t end) const {
+    const std::string& text = text_.text();
+    while (start < end && (text[start] == ' ' || text[start] == '\n')) {
+      ++start;
+    }
+    return {start, end - start};
+  }
+
+  void FlushParagraph() {
+    if (in_paragraph_) {
+      ContentExtractor::TextSpan span = SpanFrom(paragraph_start_);
+      if (span.length) {
+        result_->paragraphs.push_back(span);
+      }
+      in_paragraph_ = false;
+    }
+  }
+
+  void FlushHeading() {
+    if (heading_level_ > 0) {
+      ContentExtractor::TextSpan span = SpanFrom(heading_start_);
+      if (span.length) {
+        headings_[heading_level_ - 1].push_back(span);
+      }
+      heading_level_ = 0;
+    }
+  }
+
+  void Finish() {
+    // Elements left open at the end of the page end there
+    FlushParagraph();
+    FlushHeading();
+    if (in_title_) {
+      result_->title = SpanFrom(title_start_);
+    }
+    if (in_author_) {
+      element_author_ = SpanFrom(author_start_);
+    }
+    if (in_date_) {
+      element_date_ = SpanFrom(date_start_);
+    }
+
+    // Headings are listed by level, then in page order
+    size_t heading_count = 0;
+    for (const auto& level : headings_) {
+      heading_count += level.size();
+    }
+    result_->headings.reserve(heading_count);
+    for (const auto& level : headings_) {
+      result_->headings.insert(result_->headings.end(), level.begin(),
+                               level.end());
+    }
+
+    if (!result_->title.length && !headings_[0].empty()) {
+      result_->title = headings_[0].front();
+    }
+
+    result_->main_text = MainTextSpan();
+
+    result_->author = !meta_author_.empty()
+                          ? std::move(meta_author_)
+                          : std::string(Get(element_author_));
+    if (!meta_date_.empty()) {
+      result_->date = std::move(meta_date_);
+    } else if (!time_date_.empty()) {
+      result_->date = std::move(time_date_);
+    } else {
+      result_->date = std::string(Get(element_date_));
+    }
+
+    result_->content_type =
+        signals_.Decide(result_->paragraphs.size(), heading_count);
+    result_->text = text_.Take();
+  }
+
+  // The first of <article>, <main> and the content div with any text;
+  // failing those, the stretch from the first paragraph to the last
+  ContentExtractor::TextSpan MainTextSpan() const {
+    for (const Region* region : {&article_, &main_, &content_div_}) {
+      if (region->started()) {
+        ContentExtractor::TextSpan span =
+            Span(region->start(), region->end(text_.size()));
+        if (span.length) {
+          return span;
+        }
+      }
+    }
+    if (result_->paragraphs.empty()) {
+      return {};
+    }
+    const ContentExtractor::TextSpan& last = result_->paragraphs.back();
+    return Span(result_->paragraphs.front().offset, last.offset + last.length);
+  }
+
+  std::string_view Get(const ContentExtractor::TextSpan& span) const {
+    return std::string_view(text_.text()).substr(span.offset, span.length);
+  }
+
+  ContentExtractor::ExtractedText* const result_;
+
+  // The page text that every span refers to
+  TextAccumulator text_;
+
+  SignalCounter signals_;
+
+  size_t title_start_ = 0;
+  bool in_title_ = false;
+  bool title_found_ = false;
+
+  size_t paragraph_start_ = 0;
+  bool in_paragraph_ = false;
+
+  // Level of the heading being read, or 0
+  size_t heading_start_ = 0;
+  int heading_level_ = 0;
+  std::vector<ContentExtractor::TextSpan> headings_[6];
+
+  Region article_{"article"};
+  Region main_{"main"};
+  Region content_div_{"div"};
+
+  std::string meta_author_;
+  ContentExtractor::TextSpan element_author_;
+  size_t author_start_ = 0;
+  bool in_author_ = false;
+
+  std::string meta_date_;
+  std::string time_date_;
+  ContentExtractor::TextSpan element_date_;
+  size_t date_start_ = 0;
+  bool in_date_ = false;
+};
+
+}  // namespace
+
+void ScanPageText(std::string_view html,
+                  ContentExtractor::ExtractedText* text) {
+  PageScanner(text).Scan(html);
+}
+
+void ScanPage(std::string_view html,
+              ContentExtractor::ExtractedContent* content) {
+  ContentExtractor::ExtractedText text;
+  ScanPageText(html, &text);
+
+  auto copy_spans = [&text](const std::vector<ContentExtractor::TextSpan>&
+                                spans) {
+    std::vector<std::string> strings;
+    strings.reserve(spans.size());
+    for (const ContentExtractor::TextSpan& span : spans) {
+      strings.emplace_back(text.Get(span));
+    }
+    return strings;
+  };
+
+  content->title = std::string(text.Get(text.title));
+  content->main_text = std::string(text.Get(text.main_text));
+  content->author = std::move(text.author);
+  content->date = std::move(text.date);
+  content->content_type = text.content_type;
+  content->paragraphs = copy_spans(text.paragraphs);
+  content->headings = copy_spans(text.headings);
+  content->images = std::move(text.images);
+  content->links = std::move(text.links);
+}
+
+}  // namespace content
+}  // namespace browser_core
@@ -0,0 +1,37 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_CONTENT_PAGE_SCANNER_H_
+#define BROWSER_CORE_CONTENT_PAGE_SCANNER_H_
+
+#include <string_view>
+
+#include "browser_core/content/content_extractor.h"
+
+namespace browser_core {
+namespace content {
+
+// Fill in |text| from |html| in a single walk over its tokens.
+//
+// The page text is normalized once as the tokens go past, and each field
+// is a span of it recorded by its own small piece of state, rather than
+// found by searching the page again: the title, the main text (the first
+// <article>, else <main>, else the first div whose class names "content",
+// else the stretch from the first paragraph to the last), the paragraphs
+// and the headings. The author and date (meta tags first, then
+// <time datetime>, then elements whose class names them), the image and
+// link URLs, and the keyword signals that decide the content type are
+// gathered in the same walk.
+void ScanPageText(std::string_view html,
+                  ContentExtractor::ExtractedText* text);
+
+// Like ScanPageText(), but copies each field out into |content|. Leaves
+// |success| and |error_message| alone.
+void ScanPage(std::string_view html,
+              ContentExtractor::ExtractedContent* content);
+
+}  // namespace content
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_CONTENT_PAGE_SCANNER_H_
@@ -0,0 +1,371 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/content/page_snapshot_service.h"
+
+#include <utility>
+
+#include "base/check.h"
+#include "base/functional/bind.h"
+#include "base/json/json_reader.h"
+#include "base/values.h"
+
+namespace browser_core {
+namespace content {
+
+namespace {
+
+// One pass over the page for every view the scripts of its readers used
+// to extract separately. Each view is serialized as its own JSON string.
+constexpr char kSnapshotScript[] = R"(
+  (function() {
+    // Structure view
+    function extractStructure() {
+      // Extract main content
+      const content = {
+        title: document.title,
+        url: window.location.href,
+        text: document.body.innerText,
+        elements: []
+      };
+    
+      // Extract text elements with their selectors
+      const textElements = document.querySelectorAll('p, h1, h2, h3, h4, h5, h6, li, td, th, div:not(:has(*))');
+      for (let i = 0; i < textElements.length; i++) {
+        const el = textElements[i];
+        if (el.innerText.trim().length > 0) {
+          // Create a unique selector for the element
+          let selector = '';
+          if (el.id) {
+            selector = '#' + el.id;
+          } else if (el.className && typeof el.className === 'string') {
+            selector = el.tagName.toLowerCase() + '.' + 
+                      el.className.trim().replace(/\s+/g, '.');
+          } else {
+            // Create a path selector
+            let path = [];
+            let currentEl = el;
+            while (currentEl && currentEl.tagName !== 'HTML') {
+              let selector = currentEl.tagName.toLowerCase();
+              if (currentEl.id) {
+                selector += '#' + currentEl.id;
+                path.unshift(selector);
+                break;
+              } else if (currentEl.className && typeof currentEl.className === 'string') {
+                selector += '.' + currentEl.className.trim().replace(/\s+/g, '.');
+              }
+            
+              // Add nth-child if needed
+              if (!currentEl.id) {
+                let siblings = 1;
+                let sibling = currentEl;
+                while (sibling = sibling.previousElementSibling) {
+                  siblings++;
+                }
+                if (siblings > 1) {
+                  selector += ':nth-child(' + siblings + ')';
+                }
+              }
+            
+              path.unshift(selector);
+              currentEl = currentEl.parentElement;
+            }
+            selector = path.join(' > ');
+          }
+        
+          content.elements.push({
+            text: el.innerText.trim(),
+            selector: selector,
+            tag: el.tagName.toLowerCase()
+          });
+        }
+      }
+    
+      return JSON.stringify(content);
+    }
+
+    // Layout view
+    function extractLayout() {
+      // Extract main content
+      const content = {
+        title: document.title,
+        url: window.location.href,
+        headings: [],
+        paragraphs: [],
+        images: [],
+        links: [],
+        forms: [],
+        layout: {}
+      };
+    
+      // Extract headings
+      const headings = document.querySelectorAll('h1, h2, h3, h4, h5, h6');
+      for (let i = 0; i < headings.length; i++) {
+        const heading = headings[i];
+        content.headings.push({
+          text: heading.textContent.trim(),
+          level: parseInt(heading.tagName.substring(1)),
+          position: {
+            x: heading.getBoundingClientRect().left,
+            y: heading.getBoundingClientRect().top
+          }
+        });
+      }
+    
+      // Extract paragraphs
+      const paragraphs = document.querySelectorAll('p');
+      for (let i = 0; i < paragraphs.length; i++) {
+        const paragraph = paragraphs[i];
+        content.paragraphs.push({
+          text: paragraph.textContent.trim(),
+          length: paragraph.textContent.trim().length,
+          position: {
+            x: paragraph.getBoundingClientRect().left,
+            y: paragraph.getBoundingClientRect().top
+          }
+        });
+      }
+    
+      // Extract images
+      const images = document.querySelectorAll('img');
+      for (let i = 0; i < images.length; i++) {
+        const image = images[i];
+        content.images.push({
+          src: image.src,
+          alt: image.alt,
+          width: image.width,
+          height: image.height,
+          position: {
+            x: image.getBoundingClientRect().left,
+            y: image.getBoundingClientRect().top
+          }
+        });
+      }
+    
+      // Extract links
+      const links = document.querySelectorAll('a');
+      for (let i = 0; i < links.length; i++) {
+        const link = links[i];
+        content.links.push({
+          href: link.href,
+          text: link.textContent.trim(),
+          position: {
+            x: link.getBoundingClientRect().left,
+            y: link.getBoundingClientRect().top
+          }
+        });
+      }
+    
+      // Extract forms
+      const forms = document.querySelectorAll('form');
+      for (let i = 0; i < forms.length; i++) {
+        const form = forms[i];
+        content.forms.push({
+          id: form.id,
+          action: form.action,
+          method: form.method,
+          position: {
+            x: form.getBoundingClientRect().left,
+            y: form.getBoundingClientRect().top
+          }
+        });
+      }
+    
+      // Extract layout information
+      content.layout = {
+        viewport: {
+          width: window.innerWidth,
+          height: window.innerHeight
+        },
+        body: {
+          width: document.body.scrollWidth,
+          height: document.body.scrollHeight
+        }
+      };
+    
+      return JSON.stringify(content);
+    }
+
+    return JSON.stringify({
+      url: window.location.href,
+      structure: extractStructure(),
+      layout: extractLayout()
+    });
+  })();
+)";
+
+constexpr char kEmptyView[] = "{}";
+
+}  // namespace
+
+PageSnapshot::PageSnapshot() = default;
+PageSnapshot::~PageSnapshot() = default;
+
+PageSnapshotService::Extraction::Extraction() = default;
+PageSnapshotService::Extraction::Extraction(Extraction&&) = default;
+PageSnapshotService::Extraction& PageSnapshotService::Extraction::operator=(
+    Extraction&&) = default;
+PageSnapshotService::Extraction::~Extraction() = default;
+
+PageSnapshotService::PageSnapshotService(
+    scoped_refptr<PageContentCache> content_cache,
+    size_t max_tabs)
+    : content_cache_(content_cache
+                         ? std::move(content_cache)
+                         : base::MakeRefCounted<PageContentCache>()),
+      content_extractor_(std::make_unique<ContentExtractor>()),
+      max_tabs_(max_tabs) {
+  content_extractor_->Initialize();
+}
+
+PageSnapshotService::~PageSnapshotService() = default;
+
+void PageSnapshotService::GetSnapshot(WebContents* web_contents,
+                                      SnapshotCallback callback) {
+  DCHECK(web_contents);
+  std::string page_source = web_contents->GetPageSource();
+  PageContentCache::Fingerprint fingerprint =
+      PageContentCache::ComputeFingerprint(page_source);
+
+  Tab& tab = tabs_[web_contents];
+  tab.last_used = ++use_clock_;
+  if (tab.fingerprint == fingerprint) {
+    if (tab.snapshot) {
+      ++hits_;
+      std::move(callback).Run(tab.snapshot);
+      return;
+    }
+    if (tab.extraction_id) {
+      ++joins_;
+      extractions_[tab.extraction_id].callbacks.push_back(
+          std::move(callback));
+      return;
+    }
+  }
+
+  // A new version of the page. An extraction of the old one still
+  // answers its callers, but is not kept.
+  int extraction_id = next_extraction_id_++;
+  ++extractions_started_;
+  tab.fingerprint = fingerprint;
+  tab.snapshot = nullptr;
+  tab.extraction_id = extraction_id;
+
+  Extraction& extraction = extractions_[extraction_id];
+  extraction.web_contents = web_contents;
+  extraction.page_source = std::move(page_source);
+  extraction.snapshot = base::MakeRefCounted<PageSnapshot>();
+  extraction.snapshot->fingerprint = fingerprint;
+  extraction.callbacks.push_back(std::move(callback));
+  EvictTabs();
+
+  web_contents->ExecuteJavaScript(
+      kSnapshotScript,
+      base::BindOnce(&PageSnapshotService::OnScriptDone,
+                     base::WrapRefCounted(this), extraction_id));
+}
+
+void PageSnapshotService::Invalidate(WebContents* web_contents) {
+  tabs_.erase(web_contents);
+}
+
+void PageSnapshotService::OnScriptDone(
+    int extraction_id,
+    const WebContents::JavaScriptResult& result) {
+  auto it = extractions_.find(extraction_id);
+  DCHECK(it != extractions_.end());
+  PageSnapshot* snapshot = it->second.snapshot.get();
+
+  absl::optional<base::Value> views;
+  if (result.success) {
+    views = base::JSONReader::Read(result.result);
+  }
+  if (views && views->is_dict()) {
+    const base::Value::Dict& dict = views->GetDict();
+    snapshot->url = dict.FindString("url").value_or(std::string());
+    snapshot->structure = dict.FindString("structure").value_or(kEmptyView);
+    snapshot->layout = dict.FindString("layout").value_or(kEmptyView);
+    it->second.read_page = true;
+  } else {
+    snapshot->structure = kEmptyView;
+    snapshot->layout = kEmptyView;
+  }
+
+  // The text view comes from the HTML, shared with other extractors of
+  // the same page version through the cache
+  std::string page_source = std::move(it->second.page_source);
+  if (!page_source.empty()) {
+    if (const ContentExtractor::ExtractedContent* cached =
+            content_cache_->Get(snapshot->url, snapshot->fingerprint)) {
+      snapshot->content = *cached;
+      Finish(extraction_id);
+      return;
+    }
+    content_extractor_->ExtractContent(
+        snapshot->url, page_source,
+        base::BindOnce(&PageSnapshotService::OnTextExtracted,
+                       base::WrapRefCounted(this), extraction_id));
+    return;
+  }
+
+  // Without a source, the rendered text is the best there is
+  absl::optional<base::Value> structure =
+      base::JSONReader::Read(snapshot->structure);
+  if (structure && structure->is_dict()) {
+    const base::Value::Dict& dict = structure->GetDict();
+    snapshot->content.success = true;
+    snapshot->content.title = dict.FindString("title").value_or(std::string());
+    snapshot->content.main_text =
+        dict.FindString("text").value_or(std::string());
+  }
+  Finish(extraction_id);
+}
+
+void PageSnapshotService::OnTextExtracted(
+    int extraction_id,
+    const ContentExtractor::ExtractedContent& content) {
+  auto it = extractions_.find(extraction_id);
+  DCHECK(it != extractions_.end());
+  PageSnapshot* snapshot = it->second.snapshot.get();
+  snapshot->content = content;
+  content_cache_->Put(snapshot->url, snapshot->fingerprint, content);
+  Finish(extraction_id);
+}
+
+void PageSnapshotService::Finish(int extraction_id) {
+  auto it = extractions_.find(extraction_id);
+  DCHECK(it != extractions_.end());
+  Extraction extraction = std::move(it->second);
+  extractions_.erase(it);
+  scoped_refptr<const PageSnapshot> snapshot = std::move(extraction.snapshot);
+
+  // A page the script could not read is not kept, so the next request
+  // tries again
+  auto tab = tabs_.find(extraction.web_contents);
+  if (tab != tabs_.end() && tab->second.extraction_id == extraction_id) {
+    tab->second.extraction_id = 0;
+    if (extraction.read_page) {
+      tab->second.snapshot = snapshot;
+    }
+  }
+
+  for (SnapshotCallback& callback : extraction.callbacks) {
+    std::move(callback).Run(snapshot);
+  }
+}
+
+void PageSnapshotService::EvictTabs() {
+  while (tabs_.size() > max_tabs_) {
+    auto oldest = tabs_.begin();
+    for (auto it = tabs_.begin(); it != tabs_.end(); ++it) {
+      if (it->second.last_used < oldest->second.last_used) {
+        oldest = it;
+      }
+    }
+    tabs_.erase(oldest);
+  }
+}
+
+}  // namespace content
+}  // namespace browser_core
@@ -0,0 +1,163 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_CONTENT_PAGE_SNAPSHOT_SERVICE_H_
+#define BROWSER_CORE_CONTENT_PAGE_SNAPSHOT_SERVICE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "browser_core/content/content_extractor.h"
+#include "browser_core/content/page_content_cache.h"
+#include "browser_core/engine/web_contents.h"
+
+namespace browser_core {
+namespace content {
+
+// PageSnapshot is what was extracted from one version of a page, in the
+// views the features reading it need. It does not change once handed out,
+// so every feature shares one copy, on any sequence.
+struct PageSnapshot : public base::RefCountedThreadSafe<PageSnapshot> {
+  PageSnapshot();
+
+  PageSnapshot(const PageSnapshot&) = delete;
+  PageSnapshot& operator=(const PageSnapshot&) = delete;
+
+  std::string url;
+  PageContentCache::Fingerprint fingerprint;
+
+  // Text view: the main content, title and type of the page, extracted
+  // from its HTML, or its rendered text when it has no source
+  ContentExtractor::ExtractedContent content;
+
+  // Structure view: JSON with the page's title, URL and rendered text, and
+  // its text elements, each with a CSS selector. "{}" if the page could
+  // not be read.
+  std::string structure;
+
+  // Layout view: JSON with the page's headings, paragraphs, images, links
+  // and forms and where they are, and the viewport and body sizes. "{}" if
+  // the page could not be read.
+  std::string layout;
+
+ private:
+  friend class base::RefCountedThreadSafe<PageSnapshot>;
+
+  ~PageSnapshot();
+};
+
+// PageSnapshotService extracts the page in each tab once per version of
+// its content, and shares the result between the features that read it,
+// such as semantic search, adaptive rendering and page summaries.
+//
+// Snapshots are kept by tab, as its WebContents, with a fingerprint of the
+// page source they were taken from. A request for a page whose source has
+// changed since, e.g. after a navigation, takes a new snapshot, so none is
+// served stale. A request that arrives while the same version is being
+// extracted waits for that extraction instead of starting another. The
+// text view goes through a PageContentCache, which BrowserContentHandler
+// may share. Keeps the snapshots of the most recently used tabs.
+//
+// Shared by reference between its users. Must be used on one sequence;
+// callbacks run on it.
+class PageSnapshotService : public base::RefCounted<PageSnapshotService> {
+ public:
+  using SnapshotCallback =
+      base::OnceCallback<void(scoped_refptr<const PageSnapshot> snapshot)>;
+
+  static constexpr size_t kDefaultMaxTabs = 16;
+
+  // |content_cache| may be null, for a cache of the service's own
+  explicit PageSnapshotService(
+      scoped_refptr<PageContentCache> content_cache = nullptr,
+      size_t max_tabs = kDefaultMaxTabs);
+
+  PageSnapshotService(const PageSnapshotService&) = delete;
+  PageSnapshotService& operator=(const PageSnapshotService&) = delete;
+
+  // Run |callback| with a snapshot of the page in |web_contents| as it is
+  // now: straight away if one was taken, else once extraction finishes.
+  // The snapshot is never null.
+  void GetSnapshot(WebContents* web_contents, SnapshotCallback callback);
+
+  // Forget |web_contents|, e.g. when it navigates or its tab closes. An
+  // extraction already running still answers its callers.
+  void Invalidate(WebContents* web_contents);
+
+  // Requests served from a kept snapshot, requests that waited for an
+  // extraction already running, and extractions started
+  size_t GetHitCount() const { return hits_; }
+  size_t GetJoinCount() const { return joins_; }
+  size_t GetExtractionCount() const { return extractions_started_; }
+
+  PageContentCache* content_cache() const { return content_cache_.get(); }
+
+ private:
+  friend class base::RefCounted<PageSnapshotService>;
+
+  // The latest version seen of a tab's page
+  struct Tab {
+    PageContentCache::Fingerprint fingerprint;
+    // Null until extracted
+    scoped_refptr<const PageSnapshot> snapshot;
+    // The extraction of |fingerprint| while it runs, else 0
+    int extraction_id = 0;
+    uint64_t last_used = 0;
+  };
+
+  struct Extraction {
+    Extraction();
+    Extraction(Extraction&&);
+    Extraction& operator=(Extraction&&);
+    ~Extraction();
+
+    WebContents* web_contents = nullptr;
+    std::string page_source;
+    scoped_refptr<PageSnapshot> snapshot;
+    // Whether the snapshot script succeeded
+    bool read_page = false;
+    std::vector<SnapshotCallback> callbacks;
+  };
+
+  ~PageSnapshotService();
+
+  // Fill in the structure and layout views from the snapshot script, then
+  // extract the text view
+  void OnScriptDone(int extraction_id,
+                    const WebContents::JavaScriptResult& result);
+  void OnTextExtracted(int extraction_id,
+                       const ContentExtractor::ExtractedContent& content);
+
+  // Keep the snapshot of |extraction_id| if it is still its tab's latest
+  // version, and hand it to everyone waiting
+  void Finish(int extraction_id);
+
+  // Drop the least recently used tab while there are too many
+  void EvictTabs();
+
+  scoped_refptr<PageContentCache> content_cache_;
+  std::unique_ptr<ContentExtractor> content_extractor_;
+  const size_t max_tabs_;
+
+  std::unordered_map<WebContents*, Tab> tabs_;
+  std::unordered_map<int, Extraction> extractions_;
+  int next_extraction_id_ = 1;
+  uint64_t use_clock_ = 0;
+
+  size_t hits_ = 0;
+  size_t joins_ = 0;
+  size_t extractions_started_ = 0;
+};
+
+}  // namespace content
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_CONTENT_PAGE_SNAPSHOT_SERVICE_H_
@@ -0,0 +1,182 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/content/text_scan.h"
+
+#include <stdint.h>
+
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+
+#include "base/cpu.h"
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace browser_core {
+namespace content {
+
+namespace {
+
+// The whitespace TextAccumulator collapses; '\v' is not among it
+bool IsWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+// Whether the byte at |i| ends a plain run: see PlainTextRunLength()
+bool EndsRun(std::string_view text, size_t i) {
+  char c = text[i];
+  if (c == '&' || (c != ' ' && IsWhitespace(c))) {
+    return true;
+  }
+  if (c != ' ') {
+    return false;
+  }
+  // A space is only plain with an ordinary character after it
+  return i + 1 == text.size() || text[i + 1] == '&' ||
+         IsWhitespace(text[i + 1]);
+}
+
+size_t PlainTextRunLengthFrom(std::string_view text, size_t i) {
+  while (i < text.size() && !EndsRun(text, i)) {
+    ++i;
+  }
+  return i;
+}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+// Each kernel compares a block, and the block one byte on for what follows
+// each space, so it stops a byte short of the end and leaves the rest to
+// PlainTextRunLengthFrom()
+
+// '\t', '\n', '\f' or '\r'
+__attribute__((target("avx2"))) __m256i ControlWhitespaceAvx2(__m256i v) {
+  return _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')),
+                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\f')),
+                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+}
+
+__attribute__((target("avx2"))) size_t PlainTextRunLengthAvx2(
+    std::string_view text) {
+  const __m256i amp = _mm256_set1_epi8('&');
+  const __m256i space = _mm256_set1_epi8(' ');
+  const char* data = text.data();
+  size_t i = 0;
+  for (; i + 33 <= text.size(); i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    __m256i next =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+    __m256i next_special = _mm256_or_si256(
+        ControlWhitespaceAvx2(next),
+        _mm256_or_si256(_mm256_cmpeq_epi8(next, space),
+                        _mm256_cmpeq_epi8(next, amp)));
+    __m256i special = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, amp), ControlWhitespaceAvx2(v)),
+        _mm256_and_si256(_mm256_cmpeq_epi8(v, space), next_special));
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+    if (mask) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return PlainTextRunLengthFrom(text, i);
+}
+
+__m128i ControlWhitespaceSse2(__m128i v) {
+  return _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\t')),
+                   _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\f')),
+                   _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+}
+
+size_t PlainTextRunLengthSse2(std::string_view text) {
+  const __m128i amp = _mm_set1_epi8('&');
+  const __m128i space = _mm_set1_epi8(' ');
+  const char* data = text.data();
+  size_t i = 0;
+  for (; i + 17 <= text.size(); i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    __m128i next =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1));
+    __m128i next_special = _mm_or_si128(
+        ControlWhitespaceSse2(next),
+        _mm_or_si128(_mm_cmpeq_epi8(next, space), _mm_cmpeq_epi8(next, amp)));
+    __m128i special = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, amp), ControlWhitespaceSse2(v)),
+        _mm_and_si128(_mm_cmpeq_epi8(v, space), next_special));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+    if (mask) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return PlainTextRunLengthFrom(text, i);
+}
+
+bool HasAvx2() {
+  static const bool has_avx2 = [] {
+    base::CPU cpu;
+    return cpu.has_avx2();
+  }();
+  return has_avx2;
+}
+
+#elif defined(ARCH_CPU_ARM64)
+
+uint8x16_t ControlWhitespaceNeon(uint8x16_t v) {
+  return vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8('\t')),
+                           vceqq_u8(v, vdupq_n_u8('\n'))),
+                  vorrq_u8(vceqq_u8(v, vdupq_n_u8('\f')),
+                           vceqq_u8(v, vdupq_n_u8('\r'))));
+}
+
+size_t PlainTextRunLengthNeon(std::string_view text) {
+  const uint8x16_t amp = vdupq_n_u8('&');
+  const uint8x16_t space = vdupq_n_u8(' ');
+
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(text.data());
+  size_t i = 0;
+  for (; i + 17 <= text.size(); i += 16) {
+    uint8x16_t v = vld1q_u8(data + i);
+    uint8x16_t next = vld1q_u8(data + i + 1);
+    uint8x16_t next_special =
+        vorrq_u8(ControlWhitespaceNeon(next),
+                 vorrq_u8(vceqq_u8(next, space), vceqq_u8(next, amp)));
+    uint8x16_t special =
+        vorrq_u8(vorrq_u8(vceqq_u8(v, amp), ControlWhitespaceNeon(v)),
+                 vandq_u8(vceqq_u8(v, space), next_special));
+    // Narrow each byte mask to four bits, as NEON has no movemask
+    uint64_t mask = vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)),
+        0);
+    if (mask) {
+      return i + __builtin_ctzll(mask) / 4;
+    }
+  }
+  return PlainTextRunLengthFrom(text, i);
+}
+
+#endif
+
+}  // namespace
+
+size_t PlainTextRunLength(std::string_view text) {
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (HasAvx2()) {
+    return PlainTextRunLengthAvx2(text);
+  }
+  return PlainTextRunLengthSse2(text);
+#elif defined(ARCH_CPU_ARM64)
+  return PlainTextRunLengthNeon(text);
+#else
+  return PlainTextRunLengthFrom(text, 0);
+#endif
+}
+
+}  // namespace content
+}  // namespace browser_core
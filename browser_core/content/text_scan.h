@@ -0,0 +1,26 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_CONTENT_TEXT_SCAN_H_
+#define BROWSER_CORE_CONTENT_TEXT_SCAN_H_
+
+#include <stddef.h>
+
+#include <string_view>
+
+namespace browser_core {
+namespace content {
+
+// Length of the run at the start of |text| that needs no decoding or
+// whitespace normalization and can be copied as it is: it ends at the
+// first '&', at any whitespace other than a single space between two
+// other characters, and at a space that ends |text|.
+//
+// Uses AVX2 or SSE2 on x86 and NEON on ARM64, 32 or 16 bytes at a time.
+size_t PlainTextRunLength(std::string_view text);
+
+}  // namespace content
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_CONTENT_TEXT_SCAN_H_
@@ -8,14 +8,26 @@
 #include <utility>
 
 #include "base/logging.h"
+#include "base/time/time.h"
+#include "browser_core/engine/history_store.h"
+#include "browser_core/engine/navigation_predictor.h"
 #include "browser_core/engine/tab_impl.h"
+#include "browser_core/engine/tab_registry.h"
 
 namespace browser_core {
 
+namespace {
+
+// Most frecent history entries offered to the navigation predictor
+constexpr size_t kHistoryPredictions = 8;
+
+}  // namespace
+
 // Private implementation of BrowserEngine
 class BrowserEngine::Impl {
  public:
-  Impl() : next_tab_id_(1), active_tab_id_(-1) {
+  Impl()
+      : history_store_(std::make_unique<HistoryStore>()) {
     home_page_ = "https://www.dashaibrowser.com";
     user_agent_ = "DashAIBrowser/1.0";
     download_directory_ = "/downloads";
@@ -24,9 +36,7 @@ class BrowserEngine::Impl {
     popups_blocked_ = true;
   }
 
-  ~Impl() {
-    tabs_.clear();
-  }
+  ~Impl() = default;
 
   bool Initialize() {
     LOG(INFO) << "Initializing BrowserEngine";
@@ -35,14 +45,18 @@ class BrowserEngine::Impl {
   }
 
   std::unique_ptr<Tab> CreateTab() {
-    int tab_id = next_tab_id_++;
+    int tab_id = tabs_.next_id();
+    if (tab_id == TabRegistry::kNoTab) {
+      LOG(ERROR) << "Too many tabs open";
+      return nullptr;
+    }
     auto tab = std::make_unique<TabImpl>(tab_id);
     
     Tab* tab_ptr = tab.get();
-    tabs_[tab_id] = tab_ptr;
+    tabs_.Add(tab_ptr);
     
-    if (active_tab_id_ == -1) {
-      active_tab_id_ = tab_id;
+    if (tabs_.active_tab_id() == TabRegistry::kNoTab) {
+      tabs_.set_active_tab_id(tab_id);
       tab_ptr->SetActive(true);
     }
     
@@ -51,21 +65,24 @@ class BrowserEngine::Impl {
   }
 
   bool CloseTab(int tab_id) {
-    auto it = tabs_.find(tab_id);
-    if (it == tabs_.end()) {
+    bool was_active = tab_id == tabs_.active_tab_id();
+    if (!tabs_.Remove(tab_id)) {
       LOG(ERROR) << "Attempted to close non-existent tab: " << tab_id;
       return false;
     }
-    
-    tabs_.erase(it);
     LOG(INFO) << "Closed tab with ID: " << tab_id;
     
     // If we closed the active tab, activate another one if available
-    if (tab_id == active_tab_id_) {
-      active_tab_id_ = -1;
-      if (!tabs_.empty()) {
-        active_tab_id_ = tabs_.begin()->first;
-        tabs_[active_tab_id_]->SetActive(true);
+    if (was_active) {
+      Tab* next_active = nullptr;
+      tabs_.ForEach([&next_active](int, Tab* tab) {
+        if (!next_active) {
+          next_active = tab;
+        }
+      });
+      if (next_active) {
+        tabs_.set_active_tab_id(next_active->GetId());
+        next_active->SetActive(true);
       }
     }
     
@@ -73,45 +90,34 @@ class BrowserEngine::Impl {
   }
 
   Tab* GetTabById(int tab_id) {
-    auto it = tabs_.find(tab_id);
-    if (it == tabs_.end()) {
-      return nullptr;
-    }
-    return it->second;
+    return tabs_.Get(tab_id);
   }
 
   std::vector<Tab*> GetAllTabs() {
     std::vector<Tab*> result;
     result.reserve(tabs_.size());
-    
-    for (const auto& pair : tabs_) {
-      result.push_back(pair.second);
-    }
-    
+    tabs_.ForEach([&result](int, Tab* tab) { result.push_back(tab); });
     return result;
   }
 
   Tab* GetActiveTab() {
-    if (active_tab_id_ == -1) {
-      return nullptr;
-    }
-    return GetTabById(active_tab_id_);
+    return tabs_.Get(tabs_.active_tab_id());
   }
 
+  const TabRegistry& tabs() const { return tabs_; }
+
   void SetActiveTab(int tab_id) {
     // Deactivate current active tab
-    if (active_tab_id_ != -1) {
-      Tab* current_active = GetTabById(active_tab_id_);
-      if (current_active) {
-        current_active->SetActive(false);
-      }
+    Tab* current_active = GetActiveTab();
+    if (current_active) {
+      current_active->SetActive(false);
     }
     
     // Activate new tab
     Tab* new_active = GetTabById(tab_id);
     if (new_active) {
       new_active->SetActive(true);
-      active_tab_id_ = tab_id;
+      tabs_.set_active_tab_id(tab_id);
       LOG(INFO) << "Set active tab to: " << tab_id;
     } else {
       LOG(ERROR) << "Attempted to activate non-existent tab: " << tab_id;
@@ -121,7 +127,10 @@ class BrowserEngine::Impl {
   void Navigate(int tab_id, const std::string& url) {
     Tab* tab = GetTabById(tab_id);
     if (tab) {
+      navigation_predictor_.OnNavigation(url);
       tab->Navigate(url);
+      history_store_->AddVisit(url, std::string(), base::Time::Now());
+      PredictFromHistory(url);
       LOG(INFO) << "Navigating tab " << tab_id << " to: " << url;
     } else {
       LOG(ERROR) << "Attempted to navigate non-existent tab: " << tab_id;
@@ -157,59 +166,64 @@ class BrowserEngine::Impl {
   }
 
   void AddBookmark(const std::string& url, const std::string& title) {
-    bookmarks_[url] = title;
+    history_store_->AddBookmark(url, title, base::Time::Now());
     LOG(INFO) << "Added bookmark: " << title << " (" << url << ")";
   }
 
   void RemoveBookmark(const std::string& url) {
-    bookmarks_.erase(url);
+    history_store_->RemoveBookmark(url);
     LOG(INFO) << "Removed bookmark: " << url;
   }
 
   bool IsBookmarked(const std::string& url) {
-    return bookmarks_.find(url) != bookmarks_.end();
+    return history_store_->IsBookmarked(url);
   }
 
   std::vector<std::pair<std::string, std::string>> GetBookmarks() {
     std::vector<std::pair<std::string, std::string>> result;
-    result.reserve(bookmarks_.size());
+    result.reserve(history_store_->bookmark_count());
     
-    for (const auto& pair : bookmarks_) {
-      result.emplace_back(pair.first, pair.second);
+    for (const HistoryStore::Entry* entry : history_store_->GetBookmarks()) {
+      result.emplace_back(entry->url, entry->bookmark_title);
     }
     
     return result;
   }
 
   std::vector<std::pair<std::string, std::string>> GetHistory(int max_items) {
-    std::vector<std::pair<std::string, std::string>> result;
-    
-    // In a real implementation, this would query a history database
-    // For now, return a placeholder
-    result.reserve(std::min(max_items, static_cast<int>(history_.size())));
-    
-    int count = 0;
-    for (const auto& pair : history_) {
-      if (count >= max_items) {
-        break;
-      }
-      result.emplace_back(pair.first, pair.second);
-      count++;
-    }
-    
-    return result;
+    return ToPairs(history_store_->GetMostRecent(std::max(max_items, 0)));
+  }
+
+  std::vector<std::pair<std::string, std::string>> GetTopSites(int max_items) {
+    return ToPairs(history_store_->GetMostFrecent(std::max(max_items, 0)));
   }
 
   void ClearHistory() {
-    history_.clear();
+    history_store_->ClearHistory();
     LOG(INFO) << "Cleared browsing history";
   }
 
   void RemoveFromHistory(const std::string& url) {
-    history_.erase(url);
+    history_store_->RemoveFromHistory(url);
     LOG(INFO) << "Removed from history: " << url;
   }
 
+  void LoadHistory(const base::FilePath& path, base::OnceClosure callback) {
+    // Visits and bookmarks so far are kept, after the loaded ones
+    auto store = std::make_unique<HistoryStore>(path);
+    for (const HistoryStore::Entry* entry : history_store_->GetBookmarks()) {
+      store->AddBookmark(entry->url, entry->bookmark_title,
+                         entry->bookmark_time);
+    }
+    std::vector<const HistoryStore::Entry*> visited =
+        history_store_->GetMostRecent(history_store_->history_size());
+    for (auto it = visited.rbegin(); it != visited.rend(); ++it) {
+      store->AddVisit((*it)->url, (*it)->title, (*it)->last_visit);
+    }
+    history_store_ = std::move(store);
+    history_store_->Load(std::move(callback));
+  }
+
   void SetHomePage(const std::string& url) {
     home_page_ = url;
   }
@@ -258,12 +272,50 @@ class BrowserEngine::Impl {
     return popups_blocked_;
   }
 
+  NavigationPredictor* GetNavigationPredictor() {
+    return &navigation_predictor_;
+  }
+
  private:
-  int next_tab_id_;
-  int active_tab_id_;
-  std::map<int, Tab*> tabs_;
-  std::map<std::string, std::string> bookmarks_;
-  std::map<std::string, std::string> history_;
+  // Offer the most frecent sites but |current_url| to the predictor, each
+  // as likely as its share of their frecency
+  void PredictFromHistory(const std::string& current_url) {
+    base::Time now = base::Time::Now();
+    std::vector<NavigationPredictor::Candidate> candidates;
+    double total = 0;
+    for (const HistoryStore::Entry* entry :
+         history_store_->GetMostFrecent(kHistoryPredictions + 1)) {
+      if (entry->url == current_url ||
+          candidates.size() == kHistoryPredictions) {
+        continue;
+      }
+      double frecency = HistoryStore::GetFrecency(*entry, now);
+      candidates.push_back({entry->url, static_cast<float>(frecency)});
+      total += frecency;
+    }
+    if (total <= 0) {
+      return;
+    }
+    for (NavigationPredictor::Candidate& candidate : candidates) {
+      candidate.confidence = static_cast<float>(candidate.confidence / total);
+    }
+    navigation_predictor_.SetCandidates(NavigationPredictor::Source::kHistory,
+                                        std::move(candidates));
+  }
+
+  static std::vector<std::pair<std::string, std::string>> ToPairs(
+      const std::vector<const HistoryStore::Entry*>& entries) {
+    std::vector<std::pair<std::string, std::string>> result;
+    result.reserve(entries.size());
+    for (const HistoryStore::Entry* entry : entries) {
+      result.emplace_back(entry->url, entry->title);
+    }
+    return result;
+  }
+
+  TabRegistry tabs_;
+  std::unique_ptr<HistoryStore> history_store_;
+  NavigationPredictor navigation_predictor_;
   
   // Settings
   std::string home_page_;
@@ -304,6 +356,18 @@ Tab* BrowserEngine::GetActiveTab() {
   return impl_->GetActiveTab();
 }
 
+void BrowserEngine::ForEachTab(base::FunctionRef<void(Tab*)> visitor) const {
+  impl_->tabs().ForEach([visitor](int, Tab* tab) { visitor(tab); });
+}
+
+int BrowserEngine::GetActiveTabId() const {
+  return impl_->tabs().active_tab_id();
+}
+
+size_t BrowserEngine::GetTabCount() const {
+  return impl_->tabs().size();
+}
+
 void BrowserEngine::SetActiveTab(int tab_id) {
   impl_->SetActiveTab(tab_id);
 }
@@ -348,6 +412,10 @@ std::vector<std::pair<std::string, std::string>> BrowserEngine::GetHistory(int m
   return impl_->GetHistory(max_items);
 }
 
+std::vector<std::pair<std::string, std::string>> BrowserEngine::GetTopSites(int max_items) {
+  return impl_->GetTopSites(max_items);
+}
+
 void BrowserEngine::ClearHistory() {
   impl_->ClearHistory();
 }
@@ -356,6 +424,11 @@ void BrowserEngine::RemoveFromHistory(const std::string& url) {
   impl_->RemoveFromHistory(url);
 }
 
+void BrowserEngine::LoadHistory(const base::FilePath& path,
+                                base::OnceClosure callback) {
+  impl_->LoadHistory(path, std::move(callback));
+}
+
 void BrowserEngine::SetHomePage(const std::string& url) {
   impl_->SetHomePage(url);
 }
@@ -404,6 +477,10 @@ bool BrowserEngine::ArePopupsBlocked() const {
   return impl_->ArePopupsBlocked();
 }
 
+NavigationPredictor* BrowserEngine::GetNavigationPredictor() {
+  return impl_->GetNavigationPredictor();
+}
+
 base::WeakPtr<BrowserEngine> BrowserEngine::GetWeakPtr() {
   return weak_ptr_factory_.GetWeakPtr();
 }
@@ -5,11 +5,15 @@
 #ifndef BROWSER_CORE_ENGINE_BROWSER_ENGINE_H_
 #define BROWSER_CORE_ENGINE_BROWSER_ENGINE_H_
 
+#include <stddef.h>
+
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/functional/function_ref.h"
 #include "base/memory/weak_ptr.h"
 #include "browser_core/engine/navigation_controller.h"
 #include "browser_core/engine/tab.h"
@@ -17,6 +21,8 @@
 
 namespace browser_core {
 
+class NavigationPredictor;
+
 // BrowserEngine is the main interface for browser functionality.
 // It manages tabs, navigation, and browser-wide settings.
 class BrowserEngine {
@@ -39,6 +45,16 @@ class BrowserEngine {
   Tab* GetActiveTab();
   void SetActiveTab(int tab_id);
 
+  // GetTabById() and these are O(1) per tab and may be called from any
+  // thread, without locking or allocating. A Tab* they give is only good
+  // while the tab is open, so use it on the UI sequence.
+  //
+  // Run |visitor| on each tab, without building a list as GetAllTabs() does
+  void ForEachTab(base::FunctionRef<void(Tab*)> visitor) const;
+  // -1 if no tab is active
+  int GetActiveTabId() const;
+  size_t GetTabCount() const;
+
   // Navigation
   void Navigate(int tab_id, const std::string& url);
   void GoBack(int tab_id);
@@ -52,10 +68,16 @@ class BrowserEngine {
   bool IsBookmarked(const std::string& url);
   std::vector<std::pair<std::string, std::string>> GetBookmarks();
 
-  // History
+  // History, kept in a HistoryStore. Navigate() records visits.
+  // Most recently visited first
   std::vector<std::pair<std::string, std::string>> GetHistory(int max_items);
+  // Most frecent first
+  std::vector<std::pair<std::string, std::string>> GetTopSites(int max_items);
   void ClearHistory();
   void RemoveFromHistory(const std::string& url);
+  // Persist history and bookmarks at |path|, loading what is there, and
+  // run |callback| once loaded. Until called they are memory only.
+  void LoadHistory(const base::FilePath& path, base::OnceClosure callback);
 
   // Settings
   void SetHomePage(const std::string& url);
@@ -73,6 +95,11 @@ class BrowserEngine {
   void SetPopupsBlocked(bool blocked);
   bool ArePopupsBlocked() const;
 
+  // Speculates on where tabs navigate next. Navigate() scores it and feeds
+  // it history; the AI features feed it their suggestions. Runs dry until
+  // given a delegate.
+  NavigationPredictor* GetNavigationPredictor();
+
   // Get a weak pointer to this instance
   base::WeakPtr<BrowserEngine> GetWeakPtr();
 
@@ -0,0 +1,654 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/engine/history_store.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include "base/check.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/hash/hash.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/task/thread_pool.h"
+
+namespace browser_core {
+
+namespace {
+
+constexpr uint32_t kFileMagic = 0x54534948;  // "HIST"
+constexpr uint32_t kFileVersion = 1;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+};
+
+// Before each record's bytes
+struct FrameHeader {
+  uint32_t size;
+  uint32_t checksum;  // base::PersistentHash() of the record
+};
+
+enum RecordType : uint8_t {
+  kVisit = 1,
+  kRemoveFromHistory = 2,
+  kClearHistory = 3,
+  kAddBookmark = 4,
+  kRemoveBookmark = 5,
+  // Whole entry, in snapshots
+  kEntry = 6,
+};
+
+// Frecency decay per second, in log space
+const double kDecayRate =
+    std::log(2.0) / HistoryStore::kFrecencyHalfLife.InSecondsF();
+
+// log of the weight of a visit at |time| as of the frecency epoch
+double GetVisitScore(base::Time time) {
+  return kDecayRate * (time - base::Time::UnixEpoch()).InSecondsF();
+}
+
+// log(exp(a) + exp(b)) without overflow
+double LogAddExp(double a, double b) {
+  double high = std::max(a, b);
+  return high + std::log1p(std::exp(std::min(a, b) - high));
+}
+
+double GetFrecencyKey(const HistoryStore::Entry& entry) {
+  return entry.visit_score + (entry.bookmarked ? std::log(2.0) : 0.0);
+}
+
+int64_t ToMicroseconds(base::Time time) {
+  return time.ToDeltaSinceWindowsEpoch().InMicroseconds();
+}
+
+base::Time FromMicroseconds(int64_t microseconds) {
+  return base::Time::FromDeltaSinceWindowsEpoch(
+      base::Microseconds(microseconds));
+}
+
+template <typename T>
+void Append(T value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+void AppendString(std::string_view value, std::string* out) {
+  AppendVarint(value.size(), out);
+  out->append(value);
+}
+
+void AppendFrame(std::string_view record, std::string* out) {
+  Append(FrameHeader{static_cast<uint32_t>(record.size()),
+                     base::PersistentHash(record)},
+         out);
+  out->append(record);
+}
+
+template <typename T>
+bool Read(const uint8_t** pos, const uint8_t* end, T* value) {
+  if (static_cast<size_t>(end - *pos) < sizeof(T)) {
+    return false;
+  }
+  memcpy(value, *pos, sizeof(T));
+  *pos += sizeof(T);
+  return true;
+}
+
+bool ReadVarint(const uint8_t** pos, const uint8_t* end, uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64 && *pos < end; shift += 7) {
+    uint8_t byte = *(*pos)++;
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ReadString(const uint8_t** pos, const uint8_t* end, std::string* value) {
+  uint64_t size = 0;
+  if (!ReadVarint(pos, end, &size) ||
+      size > static_cast<uint64_t>(end - *pos)) {
+    return false;
+  }
+  value->assign(reinterpret_cast<const char*>(*pos), size);
+  *pos += size;
+  return true;
+}
+
+bool ReadTime(const uint8_t** pos, const uint8_t* end, base::Time* time) {
+  int64_t microseconds = 0;
+  if (!Read(pos, end, &microseconds)) {
+    return false;
+  }
+  *time = FromMicroseconds(microseconds);
+  return true;
+}
+
+// Bytes of |entry| in a snapshot, roughly
+size_t GetSnapshotSize(const HistoryStore::Entry& entry) {
+  return sizeof(FrameHeader) + 40 + entry.url.size() + entry.title.size() +
+         entry.bookmark_title.size();
+}
+
+}  // namespace
+
+// The journal file, used on the store's task runner
+class HistoryStore::Journal
+    : public base::RefCountedThreadSafe<HistoryStore::Journal> {
+ public:
+  explicit Journal(base::FilePath path) : path_(std::move(path)) {}
+
+  Journal(const Journal&) = delete;
+  Journal& operator=(const Journal&) = delete;
+
+  // Open the journal and return its records, dropping a torn tail
+  std::vector<std::string> Read();
+
+  // Append |frames|
+  void AppendFrames(std::string frames);
+
+  // Replace the journal with |records|
+  void Rewrite(std::vector<std::string> records);
+
+ private:
+  friend class base::RefCountedThreadSafe<Journal>;
+  ~Journal() = default;
+
+  // Start an empty journal in |file_|
+  bool Reset();
+
+  const base::FilePath path_;
+  base::File file_;
+  uint64_t file_size_ = 0;
+};
+
+std::vector<std::string> HistoryStore::Journal::Read() {
+  std::vector<std::string> records;
+  if (!base::CreateDirectory(path_.DirName())) {
+    LOG(ERROR) << "Failed to create history directory: "
+               << path_.DirName().value();
+    return records;
+  }
+  file_.Initialize(path_, base::File::FLAG_OPEN_ALWAYS |
+                              base::File::FLAG_READ | base::File::FLAG_WRITE);
+  if (!file_.IsValid()) {
+    LOG(ERROR) << "Failed to open history: " << path_.value();
+    return records;
+  }
+
+  int64_t length = file_.GetLength();
+  std::string data(length > 0 ? static_cast<size_t>(length) : 0, '\0');
+  FileHeader header = {};
+  if (data.size() < sizeof(FileHeader) ||
+      file_.Read(0, data.data(), static_cast<int>(data.size())) !=
+          static_cast<int>(data.size())) {
+    Reset();
+    return records;
+  }
+  memcpy(&header, data.data(), sizeof(header));
+  if (header.magic != kFileMagic || header.version != kFileVersion) {
+    // Foreign or older format: start over
+    Reset();
+    return records;
+  }
+
+  size_t offset = sizeof(FileHeader);
+  while (offset + sizeof(FrameHeader) <= data.size()) {
+    FrameHeader frame;
+    memcpy(&frame, data.data() + offset, sizeof(frame));
+    size_t end = offset + sizeof(FrameHeader) + frame.size;
+    if (end > data.size()) {
+      break;
+    }
+    std::string_view record(data.data() + offset + sizeof(FrameHeader),
+                            frame.size);
+    if (base::PersistentHash(record) != frame.checksum) {
+      break;
+    }
+    records.emplace_back(record);
+    offset = end;
+  }
+
+  if (offset < data.size()) {
+    // A torn write from a previous session; drop the partial tail
+    LOG(WARNING) << "Truncating history at offset " << offset << " of "
+                 << data.size();
+    file_.SetLength(static_cast<int64_t>(offset));
+  }
+  file_size_ = offset;
+  return records;
+}
+
+void HistoryStore::Journal::AppendFrames(std::string frames) {
+  if (!file_.IsValid()) {
+    return;
+  }
+  // One write per batch keeps a crash from interleaving partial records
+  if (file_.Write(static_cast<int64_t>(file_size_), frames.data(),
+                  static_cast<int>(frames.size())) !=
+      static_cast<int>(frames.size())) {
+    LOG(ERROR) << "Failed to append to history: " << path_.value();
+    return;
+  }
+  file_size_ += frames.size();
+}
+
+void HistoryStore::Journal::Rewrite(std::vector<std::string> records) {
+  std::string data;
+  Append(FileHeader{kFileMagic, kFileVersion}, &data);
+  for (const std::string& record : records) {
+    AppendFrame(record, &data);
+  }
+
+  base::FilePath temp_path = path_.AddExtension(FILE_PATH_LITERAL("tmp"));
+  file_.Close();
+  if (!base::WriteFile(temp_path, data) ||
+      !base::ReplaceFile(temp_path, path_, nullptr)) {
+    LOG(ERROR) << "Failed to compact history: " << path_.value();
+    base::DeleteFile(temp_path);
+  }
+  // Continue appending to whichever journal is now in place
+  file_.Initialize(path_, base::File::FLAG_OPEN | base::File::FLAG_READ |
+                              base::File::FLAG_WRITE);
+  int64_t length = file_.IsValid() ? file_.GetLength() : -1;
+  file_size_ = length > 0 ? static_cast<uint64_t>(length) : 0;
+}
+
+bool HistoryStore::Journal::Reset() {
+  std::string header;
+  Append(FileHeader{kFileMagic, kFileVersion}, &header);
+  file_.SetLength(0);
+  file_size_ = 0;
+  if (file_.Write(0, header.data(), static_cast<int>(header.size())) !=
+      static_cast<int>(header.size())) {
+    LOG(ERROR) << "Failed to initialize history: " << path_.value();
+    file_.Close();
+    return false;
+  }
+  file_size_ = header.size();
+  return true;
+}
+
+bool HistoryStore::ByTime::operator()(const Entry* a, const Entry* b) const {
+  if (a->last_visit != b->last_visit) {
+    return a->last_visit > b->last_visit;
+  }
+  return a->url < b->url;
+}
+
+bool HistoryStore::ByFrecency::operator()(const Entry* a,
+                                          const Entry* b) const {
+  double a_key = GetFrecencyKey(*a);
+  double b_key = GetFrecencyKey(*b);
+  if (a_key != b_key) {
+    return a_key > b_key;
+  }
+  return a->url < b->url;
+}
+
+HistoryStore::HistoryStore(
+    const base::FilePath& path,
+    scoped_refptr<base::SequencedTaskRunner> task_runner) {
+  if (path.empty()) {
+    loaded_ = true;
+    return;
+  }
+  task_runner_ = task_runner ? std::move(task_runner)
+                             : base::ThreadPool::CreateSequencedTaskRunner(
+                                   {base::MayBlock(),
+                                    base::TaskPriority::USER_VISIBLE,
+                                    base::TaskShutdownBehavior::BLOCK_SHUTDOWN});
+  journal_ = base::MakeRefCounted<Journal>(path);
+}
+
+HistoryStore::~HistoryStore() = default;
+
+void HistoryStore::Load(base::OnceClosure callback) {
+  if (!journal_) {
+    std::move(callback).Run();
+    return;
+  }
+  task_runner_->PostTaskAndReplyWithResult(
+      FROM_HERE, base::BindOnce(&Journal::Read, journal_),
+      base::BindOnce(&HistoryStore::OnLoaded, weak_ptr_factory_.GetWeakPtr(),
+                     std::move(callback)));
+}
+
+void HistoryStore::AddVisit(const std::string& url,
+                            const std::string& title,
+                            base::Time time) {
+  std::string record;
+  Append(kVisit, &record);
+  AppendString(url, &record);
+  AppendString(title, &record);
+  Append(ToMicroseconds(time), &record);
+  Commit(std::move(record));
+}
+
+void HistoryStore::RemoveFromHistory(const std::string& url) {
+  std::string record;
+  Append(kRemoveFromHistory, &record);
+  AppendString(url, &record);
+  Commit(std::move(record));
+}
+
+void HistoryStore::ClearHistory() {
+  std::string record;
+  Append(kClearHistory, &record);
+  Commit(std::move(record));
+}
+
+void HistoryStore::AddBookmark(const std::string& url,
+                               const std::string& title,
+                               base::Time time) {
+  std::string record;
+  Append(kAddBookmark, &record);
+  AppendString(url, &record);
+  AppendString(title, &record);
+  Append(ToMicroseconds(time), &record);
+  Commit(std::move(record));
+}
+
+void HistoryStore::RemoveBookmark(const std::string& url) {
+  std::string record;
+  Append(kRemoveBookmark, &record);
+  AppendString(url, &record);
+  Commit(std::move(record));
+}
+
+bool HistoryStore::IsBookmarked(const std::string& url) const {
+  const Entry* entry = Find(url);
+  return entry && entry->bookmarked;
+}
+
+const HistoryStore::Entry* HistoryStore::Find(const std::string& url) const {
+  auto it = entries_.find(url);
+  return it != entries_.end() ? it->second.get() : nullptr;
+}
+
+std::vector<const HistoryStore::Entry*> HistoryStore::GetMostRecent(
+    size_t max_entries) const {
+  std::vector<const Entry*> result;
+  result.reserve(std::min(max_entries, by_time_.size()));
+  for (auto it = by_time_.begin();
+       it != by_time_.end() && result.size() < max_entries; ++it) {
+    result.push_back(*it);
+  }
+  return result;
+}
+
+std::vector<const HistoryStore::Entry*> HistoryStore::GetMostFrecent(
+    size_t max_entries) const {
+  std::vector<const Entry*> result;
+  result.reserve(std::min(max_entries, by_frecency_.size()));
+  for (auto it = by_frecency_.begin();
+       it != by_frecency_.end() && result.size() < max_entries; ++it) {
+    result.push_back(*it);
+  }
+  return result;
+}
+
+std::vector<const HistoryStore::Entry*> HistoryStore::GetBookmarks() const {
+  return std::vector<const Entry*>(bookmarks_.begin(), bookmarks_.end());
+}
+
+// static
+double HistoryStore::GetFrecency(const Entry& entry, base::Time now) {
+  if (!entry.in_history()) {
+    return 0;
+  }
+  return std::exp(GetFrecencyKey(entry) - GetVisitScore(now));
+}
+
+bool HistoryStore::Apply(std::string_view record) {
+  const uint8_t* pos = reinterpret_cast<const uint8_t*>(record.data());
+  const uint8_t* end = pos + record.size();
+  uint8_t type = 0;
+  if (!Read(&pos, end, &type)) {
+    return false;
+  }
+
+  if (type == kClearHistory) {
+    std::vector<Entry*> visited(by_time_.begin(), by_time_.end());
+    for (Entry* entry : visited) {
+      Unindex(entry);
+      entry->visit_count = 0;
+      entry->last_visit = base::Time();
+      entry->visit_score = 0;
+      Reindex(entry);
+    }
+    return true;
+  }
+
+  std::string url;
+  if (!ReadString(&pos, end, &url)) {
+    return false;
+  }
+  switch (type) {
+    case kVisit: {
+      std::string title;
+      base::Time time;
+      if (!ReadString(&pos, end, &title) || !ReadTime(&pos, end, &time)) {
+        return false;
+      }
+      Entry* entry = GetOrCreate(url);
+      Unindex(entry);
+      if (!title.empty()) {
+        entry->title = std::move(title);
+      }
+      double score = GetVisitScore(time);
+      entry->visit_score = entry->visit_count > 0
+                               ? LogAddExp(entry->visit_score, score)
+                               : score;
+      ++entry->visit_count;
+      entry->last_visit = std::max(entry->last_visit, time);
+      Reindex(entry);
+      return true;
+    }
+    case kRemoveFromHistory: {
+      auto it = entries_.find(url);
+      if (it != entries_.end()) {
+        Entry* entry = it->second.get();
+        Unindex(entry);
+        entry->visit_count = 0;
+        entry->last_visit = base::Time();
+        entry->visit_score = 0;
+        Reindex(entry);
+      }
+      return true;
+    }
+    case kAddBookmark: {
+      std::string title;
+      base::Time time;
+      if (!ReadString(&pos, end, &title) || !ReadTime(&pos, end, &time)) {
+        return false;
+      }
+      Entry* entry = GetOrCreate(url);
+      Unindex(entry);
+      entry->bookmarked = true;
+      entry->bookmark_title = std::move(title);
+      entry->bookmark_time = time;
+      Reindex(entry);
+      return true;
+    }
+    case kRemoveBookmark: {
+      auto it = entries_.find(url);
+      if (it != entries_.end()) {
+        Entry* entry = it->second.get();
+        Unindex(entry);
+        entry->bookmarked = false;
+        entry->bookmark_title.clear();
+        entry->bookmark_time = base::Time();
+        Reindex(entry);
+      }
+      return true;
+    }
+    case kEntry: {
+      Entry loaded;
+      uint64_t visit_count = 0;
+      uint8_t bookmarked = 0;
+      if (!ReadString(&pos, end, &loaded.title) ||
+          !ReadVarint(&pos, end, &visit_count) ||
+          !ReadTime(&pos, end, &loaded.last_visit) ||
+          !Read(&pos, end, &loaded.visit_score) ||
+          !Read(&pos, end, &bookmarked) ||
+          !ReadString(&pos, end, &loaded.bookmark_title) ||
+          !ReadTime(&pos, end, &loaded.bookmark_time)) {
+        return false;
+      }
+      Entry* entry = GetOrCreate(url);
+      Unindex(entry);
+      loaded.url = std::move(url);
+      loaded.visit_count = static_cast<int>(visit_count);
+      loaded.bookmarked = bookmarked != 0;
+      *entry = std::move(loaded);
+      Reindex(entry);
+      return true;
+    }
+  }
+  return false;
+}
+
+void HistoryStore::Commit(std::string record) {
+  bool applied = Apply(record);
+  DCHECK(applied);
+  if (!journal_) {
+    return;
+  }
+
+  // The journal file is only open once Read() has run; OnLoaded() writes
+  // these after the loaded records
+  if (!loaded_) {
+    early_records_.push_back(std::move(record));
+    return;
+  }
+
+  std::string frame;
+  AppendFrame(record, &frame);
+  journal_bytes_ += frame.size();
+  task_runner_->PostTask(FROM_HERE, base::BindOnce(&Journal::AppendFrames,
+                                                   journal_, std::move(frame)));
+  MaybeCompact();
+}
+
+void HistoryStore::MaybeCompact() {
+  if (journal_bytes_ > kMinCompactionBytes &&
+      journal_bytes_ > 2 * live_bytes_) {
+    std::vector<std::string> snapshot = Snapshot();
+    journal_bytes_ = sizeof(FileHeader);
+    for (const std::string& entry_record : snapshot) {
+      journal_bytes_ += sizeof(FrameHeader) + entry_record.size();
+    }
+    task_runner_->PostTask(FROM_HERE, base::BindOnce(&Journal::Rewrite,
+                                                     journal_,
+                                                     std::move(snapshot)));
+  }
+}
+
+void HistoryStore::OnLoaded(base::OnceClosure callback,
+                            std::vector<std::string> records) {
+  // Changes made meanwhile were applied early; redo them after the loaded
+  // ones
+  by_time_.clear();
+  by_frecency_.clear();
+  bookmarks_.clear();
+  entries_.clear();
+  live_bytes_ = 0;
+
+  journal_bytes_ = sizeof(FileHeader);
+  for (const std::string& record : records) {
+    if (!Apply(record)) {
+      LOG(WARNING) << "Skipping malformed history record";
+    }
+    journal_bytes_ += sizeof(FrameHeader) + record.size();
+  }
+  std::string frames;
+  for (const std::string& record : early_records_) {
+    Apply(record);
+    AppendFrame(record, &frames);
+  }
+  early_records_.clear();
+  loaded_ = true;
+  if (!frames.empty()) {
+    journal_bytes_ += frames.size();
+    task_runner_->PostTask(
+        FROM_HERE,
+        base::BindOnce(&Journal::AppendFrames, journal_, std::move(frames)));
+    MaybeCompact();
+  }
+  std::move(callback).Run();
+}
+
+HistoryStore::Entry* HistoryStore::GetOrCreate(const std::string& url) {
+  std::unique_ptr<Entry>& entry = entries_[url];
+  if (!entry) {
+    entry = std::make_unique<Entry>();
+    entry->url = url;
+  }
+  return entry.get();
+}
+
+void HistoryStore::Unindex(Entry* entry) {
+  if (entry->in_history()) {
+    by_time_.erase(entry);
+    by_frecency_.erase(entry);
+  }
+  if (entry->bookmarked) {
+    bookmarks_.erase(entry);
+  }
+  if (entry->in_history() || entry->bookmarked) {
+    live_bytes_ -= GetSnapshotSize(*entry);
+  }
+}
+
+void HistoryStore::Reindex(Entry* entry) {
+  if (!entry->in_history() && !entry->bookmarked) {
+    entries_.erase(entry->url);
+    return;
+  }
+  if (entry->in_history()) {
+    by_time_.insert(entry);
+    by_frecency_.insert(entry);
+  }
+  if (entry->bookmarked) {
+    bookmarks_.insert(entry);
+  }
+  live_bytes_ += GetSnapshotSize(*entry);
+}
+
+std::vector<std::string> HistoryStore::Snapshot() const {
+  std::vector<std::string> records;
+  records.reserve(entries_.size());
+  for (const auto& [url, entry] : entries_) {
+    std::string record;
+    Append(kEntry, &record);
+    AppendString(entry->url, &record);
+    AppendString(entry->title, &record);
+    AppendVarint(static_cast<uint64_t>(entry->visit_count), &record);
+    Append(ToMicroseconds(entry->last_visit), &record);
+    Append(entry->visit_score, &record);
+    Append(static_cast<uint8_t>(entry->bookmarked), &record);
+    AppendString(entry->bookmark_title, &record);
+    Append(ToMicroseconds(entry->bookmark_time), &record);
+    records.push_back(std::move(record));
+  }
+  return records;
+}
+
+}  // namespace browser_core
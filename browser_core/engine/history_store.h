@@ -0,0 +1,178 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_ENGINE_HISTORY_STORE_H_
+#define BROWSER_CORE_ENGINE_HISTORY_STORE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/time.h"
+
+namespace browser_core {
+
+// HistoryStore holds browsing history and bookmarks, indexed for the
+// queries every AI feature makes of them, and persists them incrementally.
+//
+// Entries are found by URL through a hash index. History entries are also
+// kept in two ordered indexes, by last visit and by frecency, so the most
+// recent or most frecent N entries cost O(log n + N) rather than a scan
+// and copy of the whole history. Bookmarks are an ordered index of their
+// own.
+//
+// Frecency is the sum over an entry's visits of a weight halving every
+// kFrecencyHalfLife. As every score decays at the same rate, their order
+// never changes with time alone, so the index is keyed by the score as of
+// a fixed epoch, in log space, and only the entry visited moves. A
+// bookmark doubles an entry's score.
+//
+// Every change is a record appended to a journal file on a background
+// sequence; the journal is replayed by Load() and rewritten as a snapshot
+// of the live entries once it is mostly superseded records. A torn record
+// at the end, from a crash, is dropped on load.
+//
+// Must be used on one sequence.
+class HistoryStore {
+ public:
+  struct Entry {
+    std::string url;
+    std::string title;
+
+    // History; a bookmark never visited has no visits
+    int visit_count = 0;
+    base::Time last_visit;
+    // log of the sum of visit weights as of the frecency epoch
+    double visit_score = 0;
+
+    bool bookmarked = false;
+    std::string bookmark_title;
+    base::Time bookmark_time;
+
+    bool in_history() const { return visit_count > 0; }
+  };
+
+  static constexpr base::TimeDelta kFrecencyHalfLife = base::Days(30);
+  // The journal is rewritten when over this and twice the live data
+  static constexpr size_t kMinCompactionBytes = 1024 * 1024;
+
+  // With an empty |path| the store is memory only. |task_runner| does the
+  // file IO; defaults to a thread pool sequence.
+  explicit HistoryStore(
+      const base::FilePath& path = base::FilePath(),
+      scoped_refptr<base::SequencedTaskRunner> task_runner = nullptr);
+  ~HistoryStore();
+
+  HistoryStore(const HistoryStore&) = delete;
+  HistoryStore& operator=(const HistoryStore&) = delete;
+
+  // Read the journal and run |callback|. Changes made before it finishes
+  // apply after the loaded ones.
+  void Load(base::OnceClosure callback);
+  bool loaded() const { return loaded_; }
+
+  // Record a visit to |url| at |time|. An empty |title| keeps the known
+  // one.
+  void AddVisit(const std::string& url,
+                const std::string& title,
+                base::Time time);
+  // Remove |url| from history; a bookmark for it stays
+  void RemoveFromHistory(const std::string& url);
+  // Remove all history; bookmarks stay
+  void ClearHistory();
+
+  void AddBookmark(const std::string& url,
+                   const std::string& title,
+                   base::Time time);
+  void RemoveBookmark(const std::string& url);
+  bool IsBookmarked(const std::string& url) const;
+
+  // Entry for |url|, or null
+  const Entry* Find(const std::string& url) const;
+
+  // History entries, most recently visited first
+  std::vector<const Entry*> GetMostRecent(size_t max_entries) const;
+  // History entries, most frecent first
+  std::vector<const Entry*> GetMostFrecent(size_t max_entries) const;
+  // Bookmarks, by URL
+  std::vector<const Entry*> GetBookmarks() const;
+
+  size_t history_size() const { return by_time_.size(); }
+  size_t bookmark_count() const { return bookmarks_.size(); }
+
+  // Frecency of |entry| at |now|
+  static double GetFrecency(const Entry& entry, base::Time now);
+
+ private:
+  class Journal;
+
+  struct ByTime {
+    bool operator()(const Entry* a, const Entry* b) const;
+  };
+  struct ByFrecency {
+    bool operator()(const Entry* a, const Entry* b) const;
+  };
+  struct ByUrl {
+    bool operator()(const Entry* a, const Entry* b) const {
+      return a->url < b->url;
+    }
+  };
+
+  // Apply the journal record |record|, from this session or a past one.
+  // Returns false if it is malformed.
+  bool Apply(std::string_view record);
+
+  // Apply |record| and persist it
+  void Commit(std::string record);
+
+  // Rewrite the journal as a snapshot if it is mostly superseded records
+  void MaybeCompact();
+
+  void OnLoaded(base::OnceClosure callback, std::vector<std::string> records);
+
+  // Entry for |url|, created if missing
+  Entry* GetOrCreate(const std::string& url);
+  // Take |entry| out of the ordered indexes, to change their keys, and put
+  // it back, or erase it if neither history nor bookmark
+  void Unindex(Entry* entry);
+  void Reindex(Entry* entry);
+
+  // Journal records describing the live entries
+  std::vector<std::string> Snapshot() const;
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  // Null if memory only
+  scoped_refptr<Journal> journal_;
+
+  bool loaded_ = false;
+  // Records committed before loading finished, written to the journal
+  // once it is open
+  std::vector<std::string> early_records_;
+
+  std::unordered_map<std::string, std::unique_ptr<Entry>> entries_;
+  std::set<Entry*, ByTime> by_time_;
+  std::set<Entry*, ByFrecency> by_frecency_;
+  std::set<Entry*, ByUrl> bookmarks_;
+
+  // Bytes of the journal, and roughly of a snapshot of the live entries
+  size_t journal_bytes_ = 0;
+  size_t live_bytes_ = 0;
+
+  base::WeakPtrFactory<HistoryStore> weak_ptr_factory_{this};
+};
+
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_ENGINE_HISTORY_STORE_H_
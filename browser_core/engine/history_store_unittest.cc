@@ -0,0 +1,148 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/engine/history_store.h"
+
+#include <memory>
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace browser_core {
+namespace {
+
+class HistoryStoreTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("history");
+  }
+
+  // A store on the test's sequence, so RunUntilIdle() flushes its IO
+  std::unique_ptr<HistoryStore> CreateStore() {
+    return std::make_unique<HistoryStore>(
+        path_, base::SequencedTaskRunner::GetCurrentDefault());
+  }
+
+  std::unique_ptr<HistoryStore> CreateLoadedStore() {
+    std::unique_ptr<HistoryStore> store = CreateStore();
+    base::RunLoop run_loop;
+    store->Load(run_loop.QuitClosure());
+    run_loop.Run();
+    return store;
+  }
+
+  int64_t GetJournalSize() {
+    task_environment_.RunUntilIdle();
+    int64_t size = 0;
+    EXPECT_TRUE(base::GetFileSize(path_, &size));
+    return size;
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
+  const base::Time now_ = base::Time::Now();
+};
+
+TEST_F(HistoryStoreTest, PersistsAcrossReload) {
+  std::unique_ptr<HistoryStore> store = CreateLoadedStore();
+  store->AddVisit("https://a.example/", "A", now_ - base::Hours(2));
+  store->AddVisit("https://b.example/", "B", now_ - base::Hours(1));
+  store->AddVisit("https://a.example/", "", now_);
+  store->AddBookmark("https://c.example/", "C", now_);
+  store->RemoveFromHistory("https://b.example/");
+  task_environment_.RunUntilIdle();
+  store.reset();
+
+  store = CreateLoadedStore();
+  const HistoryStore::Entry* a = store->Find("https://a.example/");
+  ASSERT_TRUE(a);
+  EXPECT_EQ(a->title, "A");
+  EXPECT_EQ(a->visit_count, 2);
+  EXPECT_EQ(a->last_visit, now_);
+  EXPECT_FALSE(store->Find("https://b.example/"));
+  EXPECT_TRUE(store->IsBookmarked("https://c.example/"));
+  EXPECT_EQ(store->history_size(), 1u);
+  EXPECT_EQ(store->bookmark_count(), 1u);
+}
+
+TEST_F(HistoryStoreTest, CommitsBeforeLoadArePersisted) {
+  std::unique_ptr<HistoryStore> store = CreateLoadedStore();
+  store->AddVisit("https://old.example/", "Old", now_ - base::Days(1));
+  task_environment_.RunUntilIdle();
+  store.reset();
+
+  // As when the engine migrates its visits and bookmarks into a new store
+  store = CreateStore();
+  store->AddBookmark("https://early.example/", "Early", now_);
+  store->AddVisit("https://early.example/", "Early", now_);
+  base::RunLoop run_loop;
+  store->Load(run_loop.QuitClosure());
+  run_loop.Run();
+  EXPECT_TRUE(store->Find("https://old.example/"));
+  EXPECT_TRUE(store->IsBookmarked("https://early.example/"));
+  task_environment_.RunUntilIdle();
+  store.reset();
+
+  store = CreateLoadedStore();
+  EXPECT_TRUE(store->Find("https://old.example/"));
+  const HistoryStore::Entry* early = store->Find("https://early.example/");
+  ASSERT_TRUE(early);
+  EXPECT_TRUE(early->bookmarked);
+  EXPECT_EQ(early->visit_count, 1);
+}
+
+TEST_F(HistoryStoreTest, CompactsSupersededRecords) {
+  std::unique_ptr<HistoryStore> store = CreateLoadedStore();
+  const std::string title(1024, 't');
+  int visits = 0;
+  for (; visits < 2000; ++visits) {
+    store->AddVisit("https://a.example/", title,
+                    now_ - base::Seconds(2000 - visits));
+  }
+  store->AddBookmark("https://b.example/", "B", now_);
+
+  // Two thousand records of a single entry take far less once compacted
+  EXPECT_LT(GetJournalSize(),
+            static_cast<int64_t>(HistoryStore::kMinCompactionBytes));
+  store.reset();
+
+  store = CreateLoadedStore();
+  const HistoryStore::Entry* a = store->Find("https://a.example/");
+  ASSERT_TRUE(a);
+  EXPECT_EQ(a->visit_count, visits);
+  EXPECT_EQ(a->title, title);
+  EXPECT_TRUE(store->IsBookmarked("https://b.example/"));
+}
+
+TEST_F(HistoryStoreTest, DropsTornTail) {
+  std::unique_ptr<HistoryStore> store = CreateLoadedStore();
+  store->AddVisit("https://a.example/", "A", now_);
+  int64_t intact_size = GetJournalSize();
+  store.reset();
+
+  // A frame header promising more than was written before a crash
+  ASSERT_TRUE(base::AppendToFile(path_, std::string("\x40\0\0\0\x12\x34", 6)));
+
+  store = CreateLoadedStore();
+  EXPECT_TRUE(store->Find("https://a.example/"));
+  EXPECT_EQ(GetJournalSize(), intact_size);
+
+  // Appends continue from the end of the last whole record
+  store->AddVisit("https://b.example/", "B", now_);
+  task_environment_.RunUntilIdle();
+  store.reset();
+  store = CreateLoadedStore();
+  EXPECT_TRUE(store->Find("https://a.example/"));
+  EXPECT_TRUE(store->Find("https://b.example/"));
+}
+
+}  // namespace
+}  // namespace browser_core
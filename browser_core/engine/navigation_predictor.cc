@@ -0,0 +1,311 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/engine/navigation_predictor.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/strings/string_util.h"
+#include "base/time/default_tick_clock.h"
+
+namespace browser_core {
+
+namespace {
+
+size_t Index(NavigationPredictor::Speculation speculation) {
+  return static_cast<size_t>(speculation);
+}
+
+size_t Index(NavigationPredictor::Source source) {
+  return static_cast<size_t>(source);
+}
+
+}  // namespace
+
+NavigationPredictor::NavigationPredictor() : NavigationPredictor(Config()) {}
+
+NavigationPredictor::NavigationPredictor(const Config& config)
+    : config_(config),
+      clock_(base::DefaultTickClock::GetInstance()),
+      budget_bytes_(static_cast<double>(config.budget_burst_bytes)),
+      budget_time_(clock_->NowTicks()) {}
+
+NavigationPredictor::~NavigationPredictor() {
+  for (const InFlight& in_flight : in_flight_) {
+    if (delegate_ && in_flight.speculation == Speculation::kPrerender) {
+      delegate_->CancelPrerender(in_flight.target.url);
+    }
+  }
+}
+
+void NavigationPredictor::SetTickClockForTesting(const base::TickClock* clock) {
+  clock_ = clock;
+  budget_time_ = clock_->NowTicks();
+}
+
+void NavigationPredictor::SetConfig(const Config& config) {
+  config_ = config;
+  budget_bytes_ = std::min(budget_bytes_,
+                           static_cast<double>(config_.budget_burst_bytes));
+  Speculate();
+}
+
+void NavigationPredictor::SetCandidates(Source source,
+                                        std::vector<Candidate> candidates) {
+  candidates_[Index(source)] = std::move(candidates);
+  Speculate();
+}
+
+void NavigationPredictor::OnNavigation(std::string_view url) {
+  ExpireSpeculations(clock_->NowTicks());
+
+  Target target;
+  bool parsed = ParseTarget(url, &target);
+  bool predicted = false;
+  for (const InFlight& in_flight : in_flight_) {
+    bool hit = parsed && Covers(in_flight, in_flight.speculation, target);
+    predicted |= hit;
+    Finish(in_flight, hit);
+  }
+  in_flight_.clear();
+  for (std::vector<Candidate>& candidates : candidates_) {
+    candidates.clear();
+  }
+
+  stats_.navigations++;
+  if (predicted) {
+    stats_.predicted_navigations++;
+  }
+}
+
+// static
+bool NavigationPredictor::ParseTarget(std::string_view url, Target* target) {
+  size_t scheme_end = url.find("://");
+  if (scheme_end == std::string_view::npos) {
+    return false;
+  }
+  std::string scheme = base::ToLowerASCII(url.substr(0, scheme_end));
+  if (scheme != "http" && scheme != "https") {
+    return false;
+  }
+
+  url = url.substr(0, url.find('#'));
+  std::string_view rest = url.substr(scheme_end + 3);
+  size_t authority_end = rest.find_first_of("/?");
+  std::string_view authority = rest.substr(0, authority_end);
+  std::string_view path;
+  if (authority_end != std::string_view::npos) {
+    path = rest.substr(authority_end);
+  }
+  size_t at = authority.rfind('@');
+  if (at != std::string_view::npos) {
+    authority.remove_prefix(at + 1);
+  }
+  std::string_view host = authority;
+  std::string_view port;
+  size_t colon = host.rfind(':');
+  if (colon != std::string_view::npos &&
+      host.find(']', colon) == std::string_view::npos) {
+    port = host.substr(colon + 1);
+    host = host.substr(0, colon);
+  }
+  if (host.empty()) {
+    return false;
+  }
+
+  target->host = base::ToLowerASCII(host);
+  target->origin = scheme + "://" + target->host;
+  if (!port.empty() && !(scheme == "http" && port == "80") &&
+      !(scheme == "https" && port == "443")) {
+    target->origin += ":" + std::string(port);
+  }
+  target->url = target->origin + std::string(path.empty() ? "/" : path);
+  return true;
+}
+
+// static
+bool NavigationPredictor::Covers(const InFlight& in_flight,
+                                 Speculation speculation,
+                                 const Target& target) {
+  if (in_flight.speculation < speculation) {
+    return false;
+  }
+  switch (speculation) {
+    case Speculation::kDnsPrefetch:
+      return in_flight.target.host == target.host;
+    case Speculation::kPreconnect:
+      return in_flight.target.origin == target.origin;
+    case Speculation::kPrerender:
+      return in_flight.target.url == target.url;
+  }
+  return false;
+}
+
+void NavigationPredictor::Speculate() {
+  base::TimeTicks now = clock_->NowTicks();
+  ExpireSpeculations(now);
+  RefillBudget(now);
+
+  // Each URL's best weighted confidence, and the source giving it
+  struct Prediction {
+    Target target;
+    double confidence = 0;
+    Source source = Source::kOmnibox;
+  };
+  std::vector<Prediction> predictions;
+  std::unordered_map<std::string, size_t> by_url;
+  for (size_t i = 0; i < kSourceCount; ++i) {
+    double weight = config_.source_weights[i];
+    for (const Candidate& candidate : candidates_[i]) {
+      Target target;
+      if (!ParseTarget(candidate.url, &target)) {
+        continue;
+      }
+      double confidence =
+          std::clamp(candidate.confidence * weight, 0.0, 1.0);
+      auto [it, inserted] = by_url.emplace(target.url, predictions.size());
+      if (inserted) {
+        predictions.push_back({std::move(target), confidence,
+                               static_cast<Source>(i)});
+      } else if (confidence > predictions[it->second].confidence) {
+        predictions[it->second].confidence = confidence;
+        predictions[it->second].source = static_cast<Source>(i);
+      }
+    }
+  }
+
+  // Free the prerender slots of pages no longer likely enough
+  double prerender_threshold =
+      config_.thresholds[Index(Speculation::kPrerender)];
+  auto dropped = std::stable_partition(
+      in_flight_.begin(), in_flight_.end(), [&](const InFlight& in_flight) {
+        if (in_flight.speculation != Speculation::kPrerender) {
+          return true;
+        }
+        auto it = by_url.find(in_flight.target.url);
+        return it != by_url.end() &&
+               predictions[it->second].confidence >= prerender_threshold;
+      });
+  for (auto it = dropped; it != in_flight_.end(); ++it) {
+    Finish(*it, /*hit=*/false);
+  }
+  in_flight_.erase(dropped, in_flight_.end());
+
+  std::stable_sort(predictions.begin(), predictions.end(),
+                   [](const Prediction& a, const Prediction& b) {
+                     return a.confidence > b.confidence;
+                   });
+  for (const Prediction& prediction : predictions) {
+    if (prediction.confidence <
+        config_.thresholds[Index(Speculation::kDnsPrefetch)]) {
+      break;
+    }
+    // The costliest speculation the confidence allows, downgraded until
+    // one is already in flight or fits its cap and the budget
+    for (int level = static_cast<int>(Speculation::kMaxValue); level >= 0;
+         --level) {
+      auto speculation = static_cast<Speculation>(level);
+      if (prediction.confidence < config_.thresholds[level]) {
+        continue;
+      }
+      bool covered = std::any_of(
+          in_flight_.begin(), in_flight_.end(), [&](const InFlight& in_flight) {
+            return Covers(in_flight, speculation, prediction.target);
+          });
+      if (covered) {
+        break;
+      }
+      if (CountInFlight(speculation) >= config_.max_in_flight[level]) {
+        continue;
+      }
+      if (budget_bytes_ < config_.costs[level]) {
+        stats_.over_budget++;
+        continue;
+      }
+      Issue(speculation, prediction.target, prediction.source,
+            prediction.confidence);
+      break;
+    }
+  }
+}
+
+void NavigationPredictor::Issue(Speculation speculation,
+                                const Target& target,
+                                Source source,
+                                double confidence) {
+  int64_t cost = config_.costs[Index(speculation)];
+  budget_bytes_ -= cost;
+  in_flight_.push_back(
+      {speculation, target, source, confidence, cost, clock_->NowTicks()});
+
+  for (Counts* counts : {&stats_.by_speculation[Index(speculation)],
+                         &stats_.by_source[Index(source)]}) {
+    counts->issued++;
+    counts->bytes += cost;
+  }
+
+  DVLOG(1) << "Speculating " << static_cast<int>(speculation) << " on "
+           << target.url << " at confidence " << confidence;
+  if (!delegate_) {
+    return;
+  }
+  switch (speculation) {
+    case Speculation::kDnsPrefetch:
+      delegate_->PrefetchDns(target.host);
+      break;
+    case Speculation::kPreconnect:
+      delegate_->Preconnect(target.origin);
+      break;
+    case Speculation::kPrerender:
+      delegate_->Prerender(target.url);
+      break;
+  }
+}
+
+void NavigationPredictor::Finish(const InFlight& in_flight, bool hit) {
+  for (Counts* counts :
+       {&stats_.by_speculation[Index(in_flight.speculation)],
+        &stats_.by_source[Index(in_flight.source)]}) {
+    if (hit) {
+      counts->hits++;
+    } else {
+      counts->wasted++;
+      counts->wasted_bytes += in_flight.cost;
+    }
+  }
+  if (!hit && delegate_ && in_flight.speculation == Speculation::kPrerender) {
+    delegate_->CancelPrerender(in_flight.target.url);
+  }
+}
+
+void NavigationPredictor::ExpireSpeculations(base::TimeTicks now) {
+  auto expired = std::stable_partition(
+      in_flight_.begin(), in_flight_.end(), [&](const InFlight& in_flight) {
+        return now - in_flight.start < config_.speculation_lifetime;
+      });
+  for (auto it = expired; it != in_flight_.end(); ++it) {
+    Finish(*it, /*hit=*/false);
+  }
+  in_flight_.erase(expired, in_flight_.end());
+}
+
+void NavigationPredictor::RefillBudget(base::TimeTicks now) {
+  budget_bytes_ = std::min(
+      static_cast<double>(config_.budget_burst_bytes),
+      budget_bytes_ +
+          (now - budget_time_).InSecondsF() * config_.budget_bytes_per_second);
+  budget_time_ = now;
+}
+
+size_t NavigationPredictor::CountInFlight(Speculation speculation) const {
+  return std::count_if(in_flight_.begin(), in_flight_.end(),
+                       [speculation](const InFlight& in_flight) {
+                         return in_flight.speculation == speculation;
+                       });
+}
+
+}  // namespace browser_core
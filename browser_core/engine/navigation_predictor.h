@@ -0,0 +1,209 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_ENGINE_NAVIGATION_PREDICTOR_H_
+#define BROWSER_CORE_ENGINE_NAVIGATION_PREDICTOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/time/tick_clock.h"
+#include "base/time/time.h"
+
+namespace browser_core {
+
+// NavigationPredictor guesses where the user will go next and warms the
+// network up for it: resolving the host, connecting to the origin or
+// prerendering the page, the more confident it is.
+//
+// Predictions come from several sources, each replacing its own list of
+// candidate URLs with confidences whenever it has new ones: the omnibox
+// while the user types, smart suggestions, the URLs of the user's active
+// tasks and the most frecent history. A URL's confidence is the highest
+// any source gives it, scaled by how far that source is trusted. Each
+// speculation has a confidence threshold, and a cap on how many may be in
+// flight; a candidate that cannot have the speculation it qualifies for
+// gets the next cheaper one.
+//
+// Speculations spend from a bandwidth budget, a bucket of bytes refilled
+// at a steady rate, at an estimated cost each, so bursts of predictions
+// cannot flood the connection. Prerenders whose candidate falls below the
+// threshold are cancelled.
+//
+// Each navigation scores the speculations in flight: those for the page,
+// its origin or its host are hits, the rest are waste, as are those that
+// live past their lifetime. The stats, per speculation and per source,
+// are for tuning the thresholds and source weights. Without a delegate to
+// carry them out the predictor runs dry, recording what it would have
+// done, so they can be tuned before it goes live.
+//
+// Must be used on one sequence.
+class NavigationPredictor {
+ public:
+  enum class Source {
+    kOmnibox,
+    kSmartSuggestions,
+    kContextualTasks,
+    kHistory,
+    kMaxValue = kHistory,
+  };
+  static constexpr size_t kSourceCount =
+      static_cast<size_t>(Source::kMaxValue) + 1;
+
+  // In increasing cost; each implies the ones before it
+  enum class Speculation {
+    kDnsPrefetch,
+    kPreconnect,
+    kPrerender,
+    kMaxValue = kPrerender,
+  };
+  static constexpr size_t kSpeculationCount =
+      static_cast<size_t>(Speculation::kMaxValue) + 1;
+
+  struct Candidate {
+    std::string url;
+    // 0 to 1
+    float confidence = 0;
+  };
+
+  struct Config {
+    // Least confidence for each speculation, indexed by Speculation
+    std::array<double, kSpeculationCount> thresholds = {0.2, 0.4, 0.8};
+    // Estimated bytes each speculation costs, indexed by Speculation
+    std::array<int64_t, kSpeculationCount> costs = {512, 8 * 1024,
+                                                    2 * 1024 * 1024};
+    // Most speculations in flight at once, indexed by Speculation
+    std::array<size_t, kSpeculationCount> max_in_flight = {16, 6, 1};
+    // Scale of each source's confidences, indexed by Source
+    std::array<double, kSourceCount> source_weights = {1.0, 0.9, 0.7, 0.6};
+
+    // The bandwidth budget: up to |budget_burst_bytes| at once, refilled
+    // at |budget_bytes_per_second|
+    int64_t budget_bytes_per_second = 64 * 1024;
+    int64_t budget_burst_bytes = 4 * 1024 * 1024;
+
+    // A speculation not navigated to within this is wasted
+    base::TimeDelta speculation_lifetime = base::Minutes(2);
+  };
+
+  struct Counts {
+    size_t issued = 0;
+    size_t hits = 0;
+    size_t wasted = 0;
+    int64_t bytes = 0;
+    int64_t wasted_bytes = 0;
+
+    // Of the speculations scored, the fraction that were hits
+    double GetHitRate() const {
+      size_t scored = hits + wasted;
+      return scored ? static_cast<double>(hits) / scored : 0.0;
+    }
+  };
+
+  struct Stats {
+    std::array<Counts, kSpeculationCount> by_speculation;
+    std::array<Counts, kSourceCount> by_source;
+    size_t navigations = 0;
+    // Navigations at least one speculation was a hit for
+    size_t predicted_navigations = 0;
+    // Speculations downgraded or dropped for lack of budget
+    size_t over_budget = 0;
+  };
+
+  // Carries the speculations out
+  class Delegate {
+   public:
+    virtual ~Delegate() = default;
+
+    virtual void PrefetchDns(const std::string& host) = 0;
+    virtual void Preconnect(const std::string& origin) = 0;
+    virtual void Prerender(const std::string& url) = 0;
+    virtual void CancelPrerender(const std::string& url) = 0;
+  };
+
+  NavigationPredictor();
+  explicit NavigationPredictor(const Config& config);
+  ~NavigationPredictor();
+
+  NavigationPredictor(const NavigationPredictor&) = delete;
+  NavigationPredictor& operator=(const NavigationPredictor&) = delete;
+
+  // Not owned; null runs the predictor dry
+  void SetDelegate(Delegate* delegate) { delegate_ = delegate; }
+
+  void SetTickClockForTesting(const base::TickClock* clock);
+
+  const Config& config() const { return config_; }
+  void SetConfig(const Config& config);
+
+  // Replace |source|'s candidates and speculate on the result. Only http
+  // and https URLs are considered.
+  void SetCandidates(Source source, std::vector<Candidate> candidates);
+
+  // Score the speculations in flight against a navigation to |url|, then
+  // drop them and every source's candidates, which were for the page left
+  void OnNavigation(std::string_view url);
+
+  const Stats& stats() const { return stats_; }
+  void ResetStats() { stats_ = Stats(); }
+
+ private:
+  // A URL split into what each speculation is for
+  struct Target {
+    std::string url;
+    std::string origin;
+    std::string host;
+  };
+
+  struct InFlight {
+    Speculation speculation;
+    Target target;
+    Source source;
+    double confidence = 0;
+    int64_t cost = 0;
+    base::TimeTicks start;
+  };
+
+  // The http or https |url| split, with the host lowercase and without
+  // user name, default port or fragment. Returns false for other URLs.
+  static bool ParseTarget(std::string_view url, Target* target);
+
+  // Whether |in_flight| already does |speculation| for |target|
+  static bool Covers(const InFlight& in_flight,
+                     Speculation speculation,
+                     const Target& target);
+
+  void Speculate();
+  void Issue(Speculation speculation,
+             const Target& target,
+             Source source,
+             double confidence);
+  // Score |in_flight|, cancelling it if a prerender
+  void Finish(const InFlight& in_flight, bool hit);
+  void ExpireSpeculations(base::TimeTicks now);
+  void RefillBudget(base::TimeTicks now);
+  size_t CountInFlight(Speculation speculation) const;
+
+  Config config_;
+  const base::TickClock* clock_;
+  Delegate* delegate_ = nullptr;
+
+  std::array<std::vector<Candidate>, kSourceCount> candidates_;
+  std::vector<InFlight> in_flight_;
+
+  // Bytes left in the budget, as of |budget_time_|
+  double budget_bytes_;
+  base::TimeTicks budget_time_;
+
+  Stats stats_;
+};
+
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_ENGINE_NAVIGATION_PREDICTOR_H_
@@ -0,0 +1,128 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/engine/tab_registry.h"
+
+#include <algorithm>
+
+#include "base/check.h"
+
+namespace browser_core {
+
+TabRegistry::TabRegistry() = default;
+
+TabRegistry::~TabRegistry() = default;
+
+int TabRegistry::next_id() const {
+  size_t index;
+  if (!free_slots_.empty()) {
+    index = free_slots_.front();
+  } else {
+    index = slot_count_.load(std::memory_order_relaxed);
+    if (index == kMaxTabs) {
+      return kNoTab;
+    }
+  }
+  const Slot* slot = FindSlot(MakeId(index, 1));
+  return MakeId(index, slot ? slot->generation.load(std::memory_order_relaxed)
+                            : 1);
+}
+
+int TabRegistry::Add(Tab* tab) {
+  DCHECK(tab);
+  size_t index;
+  if (!free_slots_.empty()) {
+    index = free_slots_.front();
+    free_slots_.pop_front();
+  } else {
+    index = slot_count_.load(std::memory_order_relaxed);
+    if (index == kMaxTabs) {
+      return kNoTab;
+    }
+    size_t chunk = index >> kChunkBits;
+    if (!owned_chunks_[chunk]) {
+      owned_chunks_[chunk] = std::make_unique<Chunk>();
+      chunks_[chunk].store(owned_chunks_[chunk].get(),
+                           std::memory_order_release);
+    }
+    slot_count_.store(index + 1, std::memory_order_release);
+  }
+
+  Slot& slot = (*owned_chunks_[index >> kChunkBits])[index % kChunkSize];
+  slot.tab.store(tab, std::memory_order_release);
+  size_.fetch_add(1, std::memory_order_release);
+  return MakeId(index, slot.generation.load(std::memory_order_relaxed));
+}
+
+bool TabRegistry::Remove(int tab_id) {
+  Slot* slot = FindSlot(tab_id);
+  // A stale ID names a slot that has moved on, maybe to another tab
+  if (!slot || !slot->tab.load(std::memory_order_relaxed) ||
+      slot->generation.load(std::memory_order_relaxed) !=
+          static_cast<uint32_t>(tab_id) >> kIndexBits) {
+    return false;
+  }
+
+  // Clear the tab before moving the generation on, so that a reader who
+  // sees the old generation sees either the tab or nothing
+  slot->tab.store(nullptr, std::memory_order_release);
+  uint32_t generation =
+      (slot->generation.load(std::memory_order_relaxed) + 1) & kGenerationMask;
+  slot->generation.store(generation ? generation : 1,
+                         std::memory_order_release);
+  free_slots_.push_back(static_cast<size_t>(tab_id) & (kMaxTabs - 1));
+  size_.fetch_sub(1, std::memory_order_release);
+
+  int expected = tab_id;
+  active_tab_id_.compare_exchange_strong(expected, kNoTab,
+                                         std::memory_order_acq_rel);
+  return true;
+}
+
+Tab* TabRegistry::Get(int tab_id) const {
+  const Slot* slot = FindSlot(tab_id);
+  if (!slot) {
+    return nullptr;
+  }
+  // Read the tab before the generation, which Remove() moves on after
+  // clearing the tab, so a tab that replaced |tab_id|'s is never returned
+  Tab* tab = slot->tab.load(std::memory_order_acquire);
+  if (slot->generation.load(std::memory_order_acquire) !=
+      static_cast<uint32_t>(tab_id) >> kIndexBits) {
+    return nullptr;
+  }
+  return tab;
+}
+
+void TabRegistry::ForEach(
+    base::FunctionRef<void(int tab_id, Tab* tab)> visitor) const {
+  size_t slot_count = slot_count_.load(std::memory_order_acquire);
+  for (size_t chunk = 0; chunk << kChunkBits < slot_count; ++chunk) {
+    const Chunk* slots = chunks_[chunk].load(std::memory_order_acquire);
+    size_t end = std::min(kChunkSize, slot_count - (chunk << kChunkBits));
+    for (size_t i = 0; i < end; ++i) {
+      Tab* tab = (*slots)[i].tab.load(std::memory_order_acquire);
+      if (tab) {
+        visitor(MakeId(chunk << kChunkBits | i,
+                       (*slots)[i].generation.load(std::memory_order_acquire)),
+                tab);
+      }
+    }
+  }
+}
+
+const TabRegistry::Slot* TabRegistry::FindSlot(int tab_id) const {
+  if (tab_id <= 0) {
+    return nullptr;
+  }
+  size_t index = static_cast<size_t>(tab_id) & (kMaxTabs - 1);
+  if (index >= slot_count_.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  const Chunk* slots =
+      chunks_[index >> kChunkBits].load(std::memory_order_acquire);
+  return &(*slots)[index % kChunkSize];
+}
+
+}  // namespace browser_core
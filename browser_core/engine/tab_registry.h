@@ -0,0 +1,116 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_ENGINE_TAB_REGISTRY_H_
+#define BROWSER_CORE_ENGINE_TAB_REGISTRY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <utility>
+
+#include "base/functional/function_ref.h"
+
+namespace browser_core {
+
+class Tab;
+
+// TabRegistry maps tab IDs to tabs in O(1), for the AI features that look
+// tabs up on every request.
+//
+// It is a slot map: a tab ID is the index of the tab's slot and the slot's
+// generation, which moves on each time a tab leaves the slot, so the ID of
+// a closed tab never finds the tab that reuses its slot. Freed slots are
+// reused oldest first, to wrap the generations as slowly as possible.
+//
+// Tabs are added and removed on the UI sequence. Lookups, iteration and
+// the active tab ID may be read from any thread, without locks or
+// allocation: slots live in chunks that are allocated once and never
+// move, and are published with release stores. A Tab* read off the UI
+// sequence is only good for as long as the tab stays open, so background
+// workers should keep to IDs and post back to the UI sequence to use it.
+class TabRegistry {
+ public:
+  static constexpr int kNoTab = -1;
+  // A tab ID is |generation| << kIndexBits | index, and never negative
+  static constexpr int kIndexBits = 16;
+  static constexpr size_t kMaxTabs = size_t{1} << kIndexBits;
+
+  TabRegistry();
+  ~TabRegistry();
+
+  TabRegistry(const TabRegistry&) = delete;
+  TabRegistry& operator=(const TabRegistry&) = delete;
+
+  // The ID the next Add() will return, for tabs that are built knowing
+  // their ID. UI sequence only.
+  int next_id() const;
+
+  // Put |tab| in a free slot and return its ID, or kNoTab if every slot
+  // is taken. UI sequence only.
+  int Add(Tab* tab);
+
+  // Empty the slot of |tab_id|, clearing the active tab if it was. Returns
+  // false if |tab_id| is not registered. UI sequence only.
+  bool Remove(int tab_id);
+
+  // The tab with |tab_id|, or null if it is not registered
+  Tab* Get(int tab_id) const;
+  bool Contains(int tab_id) const { return Get(tab_id) != nullptr; }
+
+  // Run |visitor| on each tab, in slot order. A tab added or removed
+  // meanwhile on the UI sequence may or may not be visited.
+  void ForEach(base::FunctionRef<void(int tab_id, Tab* tab)> visitor) const;
+
+  size_t size() const { return size_.load(std::memory_order_acquire); }
+
+  // kNoTab if none
+  int active_tab_id() const {
+    return active_tab_id_.load(std::memory_order_acquire);
+  }
+  void set_active_tab_id(int tab_id) {
+    active_tab_id_.store(tab_id, std::memory_order_release);
+  }
+
+ private:
+  static constexpr size_t kChunkBits = 6;
+  static constexpr size_t kChunkSize = size_t{1} << kChunkBits;
+  static constexpr size_t kChunkCount = kMaxTabs / kChunkSize;
+  static constexpr uint32_t kGenerationMask = (1u << (31 - kIndexBits)) - 1;
+
+  struct Slot {
+    std::atomic<Tab*> tab{nullptr};
+    // Never 0, so that no tab ID is 0
+    std::atomic<uint32_t> generation{1};
+  };
+  using Chunk = std::array<Slot, kChunkSize>;
+
+  static int MakeId(size_t index, uint32_t generation) {
+    return static_cast<int>(generation << kIndexBits | index);
+  }
+
+  // The slot of |tab_id|, or null if it was never allocated
+  const Slot* FindSlot(int tab_id) const;
+  Slot* FindSlot(int tab_id) {
+    return const_cast<Slot*>(std::as_const(*this).FindSlot(tab_id));
+  }
+
+  std::array<std::atomic<Chunk*>, kChunkCount> chunks_{};
+  // Slots below this have been allocated
+  std::atomic<size_t> slot_count_{0};
+  std::atomic<size_t> size_{0};
+  std::atomic<int> active_tab_id_{kNoTab};
+
+  // UI sequence only
+  std::deque<size_t> free_slots_;
+  std::array<std::unique_ptr<Chunk>, kChunkCount> owned_chunks_;
+};
+
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_ENGINE_TAB_REGISTRY_H_
@@ -0,0 +1,46 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/engine/tab_registry.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace browser_core {
+namespace {
+
+// The registry never dereferences its tabs, so any distinct addresses do
+class TabRegistryTest : public testing::Test {
+ protected:
+  Tab* tab(int index) { return reinterpret_cast<Tab*>(&storage_[index]); }
+
+ private:
+  int storage_[2] = {};
+};
+
+TEST_F(TabRegistryTest, StaleIdDoesNotFindTheTabReusingItsSlot) {
+  TabRegistry registry;
+  int a = registry.Add(tab(0));
+  ASSERT_TRUE(registry.Remove(a));
+  int b = registry.Add(tab(1));
+  ASSERT_NE(a, b);
+
+  EXPECT_EQ(registry.Get(a), nullptr);
+  EXPECT_EQ(registry.Get(b), tab(1));
+}
+
+TEST_F(TabRegistryTest, RemovingStaleIdKeepsTheTabReusingItsSlot) {
+  TabRegistry registry;
+  int a = registry.Add(tab(0));
+  ASSERT_TRUE(registry.Remove(a));
+  int b = registry.Add(tab(1));
+  registry.set_active_tab_id(b);
+
+  EXPECT_FALSE(registry.Remove(a));
+  EXPECT_EQ(registry.Get(b), tab(1));
+  EXPECT_EQ(registry.size(), 1u);
+  EXPECT_EQ(registry.active_tab_id(), b);
+}
+
+}  // namespace
+}  // namespace browser_core
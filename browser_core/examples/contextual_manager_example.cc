@@ -451,10 +451,11 @@ int main(int argc, char* argv[]) {
   
   // Test 1: Get context snapshot
   std::cout << "Test 1: Context Snapshot" << std::endl;
-  contextual_manager.GetContextSnapshot(base::BindOnce([](
-      const browser_core::ui::ContextualManager::ContextSnapshot& snapshot) {
-    PrintContextSnapshot(snapshot);
-  }));
+  contextual_manager.GetContextSnapshot(base::BindOnce(
+      [](scoped_refptr<const browser_core::ui::ContextualManager::
+                           SharedContextSnapshot> snapshot) {
+        PrintContextSnapshot(snapshot->get());
+      }));
   
   // Wait for async operations to complete
   std::this_thread::sleep_for(std::chrono::milliseconds(200));
@@ -974,10 +975,11 @@ int main(int argc, char* argv[]) {
   
   // Test 1: Get context snapshot
   std::cout << "Test 1: Context Snapshot" << std::endl;
-  contextual_manager.GetContextSnapshot(base::BindOnce([](
-      const browser_core::ui::ContextualManager::ContextSnapshot& snapshot) {
-    PrintContextSnapshot(snapshot);
-  }));
+  contextual_manager.GetContextSnapshot(base::BindOnce(
+      [](scoped_refptr<const browser_core::ui::ContextualManager::
+                           SharedContextSnapshot> snapshot) {
+        PrintContextSnapshot(snapshot->get());
+      }));
   
   // Wait for async operations to complete
   std::this_thread::sleep_for(std::chrono::milliseconds(200));
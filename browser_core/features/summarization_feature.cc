@@ -6,10 +6,12 @@
 
 #include <algorithm>
 #include <string>
-#include <vector>
+#include <string_view>
 
 #include "base/bind.h"
+#include "base/location.h"
 #include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
 #include "base/time/time.h"
 
 namespace browser_core {
@@ -26,17 +28,74 @@ constexpr int kMinReadingTimeSeconds = 120;  // 2 minutes
 // Average reading speed (words per minute)
 constexpr int kAverageReadingSpeedWPM = 250;
 
+// Lines with fewer words are navigation, captions or list items rather
+// than prose
+constexpr size_t kMinProseParagraphWords = 30;
+
+// Pages scoring lower are not summarized automatically
+constexpr float kMinAutoSummaryScore = 0.3f;
+
+// Reading time at which a page gets the full time score (in seconds)
+constexpr double kFullScoreReadingTimeSeconds = 300;
+
+// Predicted pages being fetched or summarized at once
+constexpr size_t kMaxPrefetchesInFlight = 2;
+
+// Predicted pages remembered; the oldest is given up as wasted beyond this
+constexpr size_t kMaxTrackedPrefetches = 16;
+
+// Word counts of page text, taken in one pass without copying it
+struct TextStats {
+  size_t word_count = 0;
+
+  // Words in lines long enough to be prose
+  size_t prose_word_count = 0;
+};
+
+TextStats ScanText(std::string_view content) {
+  TextStats stats;
+  size_t line_words = 0;
+  bool in_word = false;
+  for (char c : content) {
+    if (c == '\n') {
+      if (line_words >= kMinProseParagraphWords)
+        stats.prose_word_count += line_words;
+      line_words = 0;
+      in_word = false;
+    } else if (base::IsAsciiWhitespace(c)) {
+      in_word = false;
+    } else if (!in_word) {
+      in_word = true;
+      ++line_words;
+      ++stats.word_count;
+    }
+  }
+  if (line_words >= kMinProseParagraphWords)
+    stats.prose_word_count += line_words;
+  return stats;
+}
+
 // Helper function to estimate reading time
-base::TimeDelta EstimateReadingTime(const std::string& content) {
-  // Count words
-  std::vector<std::string> words = base::SplitString(
-      content, " ", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
-  
-  // Calculate reading time
-  double minutes = static_cast<double>(words.size()) / kAverageReadingSpeedWPM;
+base::TimeDelta EstimateReadingTime(size_t word_count) {
+  double minutes = static_cast<double>(word_count) / kAverageReadingSpeedWPM;
   return base::Seconds(minutes * 60);
 }
 
+// How much a page stands to gain from a summary, from 0 to 1: long reads
+// that are mostly prose score high, while short pages and pages made of
+// link lists, feeds or forms score low
+float ComputeAutoSummaryScore(const TextStats& stats) {
+  if (stats.word_count == 0)
+    return 0.0f;
+  float time_score = std::min(
+      1.0f, static_cast<float>(EstimateReadingTime(stats.word_count)
+                                   .InSecondsF() /
+                               kFullScoreReadingTimeSeconds));
+  float prose_share =
+      static_cast<float>(stats.prose_word_count) / stats.word_count;
+  return time_score * prose_share;
+}
+
 // Helper function to check if a URL is eligible for summarization
 bool IsURLEligible(const std::string& url) {
   // Skip empty URLs
@@ -68,6 +127,14 @@ bool IsURLEligible(const std::string& url) {
 
 }  // namespace
 
+double SummarizationFeature::PrefetchStats::GetHitRate() const {
+  return started ? static_cast<double>(hits) / started : 0.0;
+}
+
+double SummarizationFeature::PrefetchStats::GetWasteRate() const {
+  return started ? static_cast<double>(wasted) / started : 0.0;
+}
+
 SummarizationFeature::SummarizationFeature()
     : weak_ptr_factory_(this) {}
 
@@ -94,6 +161,66 @@ bool SummarizationFeature::Initialize(
   return true;
 }
 
+void SummarizationFeature::SetRequestScheduler(
+    asol::core::RequestScheduler* scheduler) {
+  summarization_service_->SetRequestScheduler(scheduler);
+}
+
+void SummarizationFeature::SetBudgetManager(
+    asol::core::BudgetManager* budget_manager) {
+  summarization_service_->SetBudgetManager(budget_manager);
+}
+
+void SummarizationFeature::SetLocalProviderId(const std::string& provider_id) {
+  summarization_service_->SetLocalProviderId(provider_id);
+}
+
+void SummarizationFeature::SetStreamingServiceManager(
+    asol::core::ServiceManager* service_manager) {
+  summarization_service_->SetStreamingServiceManager(service_manager);
+}
+
+void SummarizationFeature::SetPrefetchContentFetcher(
+    PageContentFetcher fetcher) {
+  prefetch_fetcher_ = std::move(fetcher);
+  if (!prefetch_fetcher_)
+    DropAllPrefetches();
+}
+
+void SummarizationFeature::SetPrefetchThreshold(float threshold) {
+  prefetch_threshold_ = std::clamp(threshold, 0.0f, 1.0f);
+}
+
+void SummarizationFeature::OnNavigationPredicted(const std::string& page_url,
+                                                 float confidence) {
+  ++prefetch_stats_.predictions;
+  if (!prefetch_fetcher_ || feature_mode_ == FeatureMode::MANUAL ||
+      !IsURLEligible(page_url) || page_url == current_page_url_ ||
+      FindPrefetch(page_url) != prefetches_.end()) {
+    return;
+  }
+  if (confidence < prefetch_threshold_) {
+    ++prefetch_stats_.below_threshold;
+    return;
+  }
+
+  // Speculation must stay cheap; a finished prefetch holds no slot
+  size_t in_flight = std::count_if(
+      prefetches_.begin(), prefetches_.end(),
+      [](const Prefetch& prefetch) { return !prefetch.done; });
+  if (in_flight >= kMaxPrefetchesInFlight)
+    return;
+  if (prefetches_.size() >= kMaxTrackedPrefetches)
+    DropPrefetch(prefetches_.begin());
+
+  auto token = base::MakeRefCounted<asol::core::CancellationToken>();
+  prefetches_.push_back({page_url, token});
+  prefetch_fetcher_.Run(
+      page_url,
+      base::BindOnce(&SummarizationFeature::OnPrefetchContentFetched,
+                     weak_ptr_factory_.GetWeakPtr(), token, page_url));
+}
+
 SummarizationFeature::EligibilityResult 
 SummarizationFeature::IsPageEligibleForSummarization(
     const std::string& page_url,
@@ -122,14 +249,20 @@ SummarizationFeature::IsPageEligibleForSummarization(
   
   // Calculate confidence score based on content length and estimated reading time
   float length_score = std::min(1.0f, page_content.length() / 10000.0f);
-  float time_score = std::min(1.0f, 
-      EstimateReadingTime(page_content).InSecondsF() / 300.0f);  // Max 5 minutes
+  float time_score = std::min(1.0f,
+      EstimateReadingTime(ScanText(page_content).word_count).InSecondsF() /
+          300.0f);  // Max 5 minutes
   
   result.confidence_score = (length_score + time_score) / 2.0f;
   
   return result;
 }
 
+void SummarizationFeature::SetAutoSummaryDwellTime(
+    base::TimeDelta dwell_time) {
+  auto_summary_dwell_time_ = dwell_time;
+}
+
 void SummarizationFeature::SetFeatureMode(FeatureMode mode) {
   feature_mode_ = mode;
 }
@@ -155,11 +288,19 @@ void SummarizationFeature::OnPageLoaded(
     const std::string& page_content,
     views::View* toolbar_view,
     views::Widget* browser_widget) {
+  // The previous page's summary is no longer wanted
+  CancelPendingAutoSummarization();
+  CancelAutoSummarization();
+
+  // A summary prefetched for this page is now in the summary cache
+  ConsumePrefetch(page_url);
+
   // Store current page info
   current_page_url_ = page_url;
   current_page_content_ = page_content;
   current_toolbar_view_ = toolbar_view;
   current_browser_widget_ = browser_widget;
+  page_visible_ = true;
   
   // Check if page is eligible for summarization
   EligibilityResult eligibility = 
@@ -179,7 +320,7 @@ void SummarizationFeature::OnPageLoaded(
     if ((feature_mode_ == FeatureMode::AUTOMATIC || 
          feature_mode_ == FeatureMode::HYBRID) &&
         ShouldAutoSummarize(page_url, page_content)) {
-      HandleAutoSummarization(page_url, page_content, browser_widget);
+      ScheduleAutoSummarization();
     }
   } else {
     // Hide the Synapse button
@@ -192,6 +333,9 @@ void SummarizationFeature::OnPageLoaded(
 
 void SummarizationFeature::OnPageUnloaded(const std::string& page_url) {
   if (current_page_url_ == page_url) {
+    CancelPendingAutoSummarization();
+    CancelAutoSummarization();
+
     // Hide the Synapse button
     summarization_ui_->HideSynapseButton();
     
@@ -206,7 +350,29 @@ void SummarizationFeature::OnPageUnloaded(const std::string& page_url) {
   }
 }
 
+void SummarizationFeature::OnPageVisibilityChanged(
+    const std::string& page_url,
+    bool visible) {
+  if (page_url != current_page_url_ || visible == page_visible_)
+    return;
+  page_visible_ = visible;
+  if (!auto_summary_pending_)
+    return;
+
+  if (visible) {
+    StartDwellTimer();
+  } else {
+    // Only time spent visible counts towards the dwell
+    ++dwell_generation_;
+    dwell_remaining_ -= base::TimeTicks::Now() - dwell_started_;
+  }
+}
+
 void SummarizationFeature::OnBrowserClosed() {
+  CancelPendingAutoSummarization();
+  CancelAutoSummarization();
+  DropAllPrefetches();
+
   // Hide the Synapse button
   summarization_ui_->HideSynapseButton();
   
@@ -236,14 +402,42 @@ bool SummarizationFeature::ShouldAutoSummarize(
     return false;
   
   // Check estimated reading time
-  base::TimeDelta reading_time = EstimateReadingTime(page_content);
+  TextStats stats = ScanText(page_content);
+  base::TimeDelta reading_time = EstimateReadingTime(stats.word_count);
   if (reading_time.InSeconds() < kMinReadingTimeSeconds)
     return false;
   
-  // In a real implementation, we would use more sophisticated heuristics
-  // such as content type analysis, user preferences, browsing history, etc.
-  
-  return true;
+  // Skip pages that are long but not prose, e.g. feeds and link lists
+  return ComputeAutoSummaryScore(stats) >= kMinAutoSummaryScore;
+}
+
+void SummarizationFeature::ScheduleAutoSummarization() {
+  auto_summary_pending_ = true;
+  dwell_remaining_ = auto_summary_dwell_time_;
+  if (page_visible_)
+    StartDwellTimer();
+}
+
+void SummarizationFeature::StartDwellTimer() {
+  dwell_started_ = base::TimeTicks::Now();
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&SummarizationFeature::OnDwellTimeElapsed,
+                     weak_ptr_factory_.GetWeakPtr(), ++dwell_generation_),
+      std::max(dwell_remaining_, base::TimeDelta()));
+}
+
+void SummarizationFeature::OnDwellTimeElapsed(int generation) {
+  if (generation != dwell_generation_ || !auto_summary_pending_)
+    return;
+  auto_summary_pending_ = false;
+  HandleAutoSummarization(current_page_url_, current_page_content_,
+                          current_browser_widget_);
+}
+
+void SummarizationFeature::CancelPendingAutoSummarization() {
+  auto_summary_pending_ = false;
+  ++dwell_generation_;
 }
 
 void SummarizationFeature::HandleAutoSummarization(
@@ -256,17 +450,41 @@ void SummarizationFeature::HandleAutoSummarization(
   // Show the summary sidebar
   summarization_ui_->ShowSummarySidebar(browser_widget);
   
-  // Trigger summarization
-  summarization_service_->SummarizeContent(
+  // Trigger summarization; nobody asked for it yet, so it yields to
+  // user-initiated requests. The summary is shown as it is generated.
+  CancelAutoSummarization();
+  auto_summary_token_ = base::MakeRefCounted<asol::core::CancellationToken>();
+  // The root of the summary's trace, through ASOL to the gateway; it ends
+  // when the summary is shown
+  asol::core::TraceSpan span("SummarizationFeature::AutoSummarize",
+                             asol::core::TraceContext());
+  asol::core::TraceContext trace = span.context();
+  summarization_service_->SummarizeContentStreaming(
       page_content,
       page_url,
       preferred_format_,
       preferred_length_,
+      asol::core::RequestPriority::PREFETCH,
+      auto_summary_token_,
+      trace,
+      base::BindRepeating(
+          [](base::WeakPtr<SummarizationFeature> self,
+             const ai::SummarizationService::SummaryDelta& delta) {
+            if (self)
+              self->summarization_ui_->AppendSummaryDelta(delta);
+          },
+          weak_ptr_factory_.GetWeakPtr()),
       base::BindOnce(
           [](base::WeakPtr<SummarizationFeature> self,
+             asol::core::TraceSpan span,
              const ai::SummarizationService::SummaryResult& result) {
+            span.End();
             if (!self)
               return;
+
+            // The page it was for is gone; leave the UI to the next one
+            if (asol::core::IsCancellationError(result.error_message))
+              return;
             
             if (result.success) {
               self->summarization_ui_->SetUIState(
@@ -276,7 +494,100 @@ void SummarizationFeature::HandleAutoSummarization(
                   ui::SummarizationUI::UIState::ERROR);
             }
           },
-          weak_ptr_factory_.GetWeakPtr()));
+          weak_ptr_factory_.GetWeakPtr(), std::move(span)));
+}
+
+void SummarizationFeature::CancelAutoSummarization() {
+  if (!auto_summary_token_)
+    return;
+  auto_summary_token_->Cancel();
+  auto_summary_token_ = nullptr;
+}
+
+SummarizationFeature::PrefetchList::iterator
+SummarizationFeature::FindPrefetch(const std::string& page_url) {
+  return std::find_if(prefetches_.begin(), prefetches_.end(),
+                      [&](const Prefetch& prefetch) {
+                        return prefetch.page_url == page_url;
+                      });
+}
+
+void SummarizationFeature::OnPrefetchContentFetched(
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const std::string& page_url,
+    const std::string& page_content) {
+  if (cancellation_token->IsCancelled())
+    return;
+  auto it = FindPrefetch(page_url);
+  if (it == prefetches_.end())
+    return;
+
+  // Not worth a summary; forget it without charging anything
+  if (!summarization_service_->IsContentSummarizable(page_content)) {
+    prefetches_.erase(it);
+    return;
+  }
+
+  // Nobody is waiting for it, so it runs as background work: it yields to
+  // every other request and stops early as the budget runs low
+  it->summarizing = true;
+  ++prefetch_stats_.started;
+  summarization_service_->SummarizeContent(
+      page_content, page_url, preferred_format_, preferred_length_,
+      asol::core::RequestPriority::BACKGROUND, cancellation_token,
+      asol::core::TraceContext(),
+      base::BindOnce(&SummarizationFeature::OnPrefetchSummarized,
+                     weak_ptr_factory_.GetWeakPtr(), cancellation_token,
+                     page_url));
+}
+
+void SummarizationFeature::OnPrefetchSummarized(
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const std::string& page_url,
+    const ai::SummarizationService::SummaryResult& result) {
+  if (cancellation_token->IsCancelled())
+    return;
+  auto it = FindPrefetch(page_url);
+  if (it == prefetches_.end() ||
+      it->cancellation_token != cancellation_token) {
+    return;
+  }
+
+  if (result.success) {
+    ++prefetch_stats_.completed;
+    it->done = true;
+  } else {
+    ++prefetch_stats_.failed;
+    prefetches_.erase(it);
+  }
+}
+
+void SummarizationFeature::ConsumePrefetch(const std::string& page_url) {
+  auto it = FindPrefetch(page_url);
+  if (it == prefetches_.end())
+    return;
+
+  if (it->done) {
+    ++prefetch_stats_.hits;
+  } else if (it->summarizing) {
+    // Left to finish so the summary is cached for the next visit
+    ++prefetch_stats_.late;
+  } else {
+    it->cancellation_token->Cancel();
+  }
+  prefetches_.erase(it);
+}
+
+void SummarizationFeature::DropPrefetch(PrefetchList::iterator it) {
+  if (it->summarizing)
+    ++prefetch_stats_.wasted;
+  it->cancellation_token->Cancel();
+  prefetches_.erase(it);
+}
+
+void SummarizationFeature::DropAllPrefetches() {
+  while (!prefetches_.empty())
+    DropPrefetch(prefetches_.begin());
 }
 
 void SummarizationFeature::OnUIEvent(
@@ -310,10 +621,12 @@ void SummarizationFeature::OnUIEvent(
 
 #include <algorithm>
 #include <string>
-#include <vector>
+#include <string_view>
 
 #include "base/bind.h"
+#include "base/location.h"
 #include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
 #include "base/time/time.h"
 
 namespace browser_core {
@@ -330,17 +643,74 @@ constexpr int kMinReadingTimeSeconds = 120;  // 2 minutes
 // Average reading speed (words per minute)
 constexpr int kAverageReadingSpeedWPM = 250;
 
+// Lines with fewer words are navigation, captions or list items rather
+// than prose
+constexpr size_t kMinProseParagraphWords = 30;
+
+// Pages scoring lower are not summarized automatically
+constexpr float kMinAutoSummaryScore = 0.3f;
+
+// Reading time at which a page gets the full time score (in seconds)
+constexpr double kFullScoreReadingTimeSeconds = 300;
+
+// Predicted pages being fetched or summarized at once
+constexpr size_t kMaxPrefetchesInFlight = 2;
+
+// Predicted pages remembered; the oldest is given up as wasted beyond this
+constexpr size_t kMaxTrackedPrefetches = 16;
+
+// Word counts of page text, taken in one pass without copying it
+struct TextStats {
+  size_t word_count = 0;
+
+  // Words in lines long enough to be prose
+  size_t prose_word_count = 0;
+};
+
+TextStats ScanText(std::string_view content) {
+  TextStats stats;
+  size_t line_words = 0;
+  bool in_word = false;
+  for (char c : content) {
+    if (c == '\n') {
+      if (line_words >= kMinProseParagraphWords)
+        stats.prose_word_count += line_words;
+      line_words = 0;
+      in_word = false;
+    } else if (base::IsAsciiWhitespace(c)) {
+      in_word = false;
+    } else if (!in_word) {
+      in_word = true;
+      ++line_words;
+      ++stats.word_count;
+    }
+  }
+  if (line_words >= kMinProseParagraphWords)
+    stats.prose_word_count += line_words;
+  return stats;
+}
+
 // Helper function to estimate reading time
-base::TimeDelta EstimateReadingTime(const std::string& content) {
-  // Count words
-  std::vector<std::string> words = base::SplitString(
-      content, " ", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
-  
-  // Calculate reading time
-  double minutes = static_cast<double>(words.size()) / kAverageReadingSpeedWPM;
+base::TimeDelta EstimateReadingTime(size_t word_count) {
+  double minutes = static_cast<double>(word_count) / kAverageReadingSpeedWPM;
   return base::Seconds(minutes * 60);
 }
 
+// How much a page stands to gain from a summary, from 0 to 1: long reads
+// that are mostly prose score high, while short pages and pages made of
+// link lists, feeds or forms score low
+float ComputeAutoSummaryScore(const TextStats& stats) {
+  if (stats.word_count == 0)
+    return 0.0f;
+  float time_score = std::min(
+      1.0f, static_cast<float>(EstimateReadingTime(stats.word_count)
+                                   .InSecondsF() /
+                               kFullScoreReadingTimeSeconds));
+  float prose_share =
+      static_cast<float>(stats.prose_word_count) / stats.word_count;
+  return time_score * prose_share;
+}
+
 // Helper function to check if a URL is eligible for summarization
 bool IsURLEligible(const std::string& url) {
   // Skip empty URLs
@@ -372,6 +742,14 @@ bool IsURLEligible(const std::string& url) {
 
 }  // namespace
 
+double SummarizationFeature::PrefetchStats::GetHitRate() const {
+  return started ? static_cast<double>(hits) / started : 0.0;
+}
+
+double SummarizationFeature::PrefetchStats::GetWasteRate() const {
+  return started ? static_cast<double>(wasted) / started : 0.0;
+}
+
 SummarizationFeature::SummarizationFeature()
     : weak_ptr_factory_(this) {}
 
@@ -398,6 +776,66 @@ bool SummarizationFeature::Initialize(
   return true;
 }
 
+void SummarizationFeature::SetRequestScheduler(
+    asol::core::RequestScheduler* scheduler) {
+  summarization_service_->SetRequestScheduler(scheduler);
+}
+
+void SummarizationFeature::SetBudgetManager(
+    asol::core::BudgetManager* budget_manager) {
+  summarization_service_->SetBudgetManager(budget_manager);
+}
+
+void SummarizationFeature::SetLocalProviderId(const std::string& provider_id) {
+  summarization_service_->SetLocalProviderId(provider_id);
+}
+
+void SummarizationFeature::SetStreamingServiceManager(
+    asol::core::ServiceManager* service_manager) {
+  summarization_service_->SetStreamingServiceManager(service_manager);
+}
+
+void SummarizationFeature::SetPrefetchContentFetcher(
+    PageContentFetcher fetcher) {
+  prefetch_fetcher_ = std::move(fetcher);
+  if (!prefetch_fetcher_)
+    DropAllPrefetches();
+}
+
+void SummarizationFeature::SetPrefetchThreshold(float threshold) {
+  prefetch_threshold_ = std::clamp(threshold, 0.0f, 1.0f);
+}
+
+void SummarizationFeature::OnNavigationPredicted(const std::string& page_url,
+                                                 float confidence) {
+  ++prefetch_stats_.predictions;
+  if (!prefetch_fetcher_ || feature_mode_ == FeatureMode::MANUAL ||
+      !IsURLEligible(page_url) || page_url == current_page_url_ ||
+      FindPrefetch(page_url) != prefetches_.end()) {
+    return;
+  }
+  if (confidence < prefetch_threshold_) {
+    ++prefetch_stats_.below_threshold;
+    return;
+  }
+
+  // Speculation must stay cheap; a finished prefetch holds no slot
+  size_t in_flight = std::count_if(
+      prefetches_.begin(), prefetches_.end(),
+      [](const Prefetch& prefetch) { return !prefetch.done; });
+  if (in_flight >= kMaxPrefetchesInFlight)
+    return;
+  if (prefetches_.size() >= kMaxTrackedPrefetches)
+    DropPrefetch(prefetches_.begin());
+
+  auto token = base::MakeRefCounted<asol::core::CancellationToken>();
+  prefetches_.push_back({page_url, token});
+  prefetch_fetcher_.Run(
+      page_url,
+      base::BindOnce(&SummarizationFeature::OnPrefetchContentFetched,
+                     weak_ptr_factory_.GetWeakPtr(), token, page_url));
+}
+
 SummarizationFeature::EligibilityResult 
 SummarizationFeature::IsPageEligibleForSummarization(
     const std::string& page_url,
@@ -426,14 +864,20 @@ SummarizationFeature::IsPageEligibleForSummarization(
   
   // Calculate confidence score based on content length and estimated reading time
   float length_score = std::min(1.0f, page_content.length() / 10000.0f);
-  float time_score = std::min(1.0f, 
-      EstimateReadingTime(page_content).InSecondsF() / 300.0f);  // Max 5 minutes
+  float time_score = std::min(1.0f,
+      EstimateReadingTime(ScanText(page_content).word_count).InSecondsF() /
+          300.0f);  // Max 5 minutes
   
   result.confidence_score = (length_score + time_score) / 2.0f;
   
   return result;
 }
 
+void SummarizationFeature::SetAutoSummaryDwellTime(
+    base::TimeDelta dwell_time) {
+  auto_summary_dwell_time_ = dwell_time;
+}
+
 void SummarizationFeature::SetFeatureMode(FeatureMode mode) {
   feature_mode_ = mode;
 }
@@ -459,11 +903,19 @@ void SummarizationFeature::OnPageLoaded(
     const std::string& page_content,
     views::View* toolbar_view,
     views::Widget* browser_widget) {
+  // The previous page's summary is no longer wanted
+  CancelPendingAutoSummarization();
+  CancelAutoSummarization();
+
+  // A summary prefetched for this page is now in the summary cache
+  ConsumePrefetch(page_url);
+
   // Store current page info
   current_page_url_ = page_url;
   current_page_content_ = page_content;
   current_toolbar_view_ = toolbar_view;
   current_browser_widget_ = browser_widget;
+  page_visible_ = true;
   
   // Check if page is eligible for summarization
   EligibilityResult eligibility = 
@@ -483,7 +935,7 @@ void SummarizationFeature::OnPageLoaded(
     if ((feature_mode_ == FeatureMode::AUTOMATIC || 
          feature_mode_ == FeatureMode::HYBRID) &&
         ShouldAutoSummarize(page_url, page_content)) {
-      HandleAutoSummarization(page_url, page_content, browser_widget);
+      ScheduleAutoSummarization();
     }
   } else {
     // Hide the Synapse button
@@ -496,6 +948,9 @@ void SummarizationFeature::OnPageLoaded(
 
 void SummarizationFeature::OnPageUnloaded(const std::string& page_url) {
   if (current_page_url_ == page_url) {
+    CancelPendingAutoSummarization();
+    CancelAutoSummarization();
+
     // Hide the Synapse button
     summarization_ui_->HideSynapseButton();
     
@@ -510,7 +965,29 @@ void SummarizationFeature::OnPageUnloaded(const std::string& page_url) {
   }
 }
 
+void SummarizationFeature::OnPageVisibilityChanged(
+    const std::string& page_url,
+    bool visible) {
+  if (page_url != current_page_url_ || visible == page_visible_)
+    return;
+  page_visible_ = visible;
+  if (!auto_summary_pending_)
+    return;
+
+  if (visible) {
+    StartDwellTimer();
+  } else {
+    // Only time spent visible counts towards the dwell
+    ++dwell_generation_;
+    dwell_remaining_ -= base::TimeTicks::Now() - dwell_started_;
+  }
+}
+
 void SummarizationFeature::OnBrowserClosed() {
+  CancelPendingAutoSummarization();
+  CancelAutoSummarization();
+  DropAllPrefetches();
+
   // Hide the Synapse button
   summarization_ui_->HideSynapseButton();
   
@@ -540,14 +1017,42 @@ bool SummarizationFeature::ShouldAutoSummarize(
     return false;
   
   // Check estimated reading time
-  base::TimeDelta reading_time = EstimateReadingTime(page_content);
+  TextStats stats = ScanText(page_content);
+  base::TimeDelta reading_time = EstimateReadingTime(stats.word_count);
   if (reading_time.InSeconds() < kMinReadingTimeSeconds)
     return false;
   
-  // In a real implementation, we would use more sophisticated heuristics
-  // such as content type analysis, user preferences, browsing history, etc.
-  
-  return true;
+  // Skip pages that are long but not prose, e.g. feeds and link lists
+  return ComputeAutoSummaryScore(stats) >= kMinAutoSummaryScore;
+}
+
+void SummarizationFeature::ScheduleAutoSummarization() {
+  auto_summary_pending_ = true;
+  dwell_remaining_ = auto_summary_dwell_time_;
+  if (page_visible_)
+    StartDwellTimer();
+}
+
+void SummarizationFeature::StartDwellTimer() {
+  dwell_started_ = base::TimeTicks::Now();
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&SummarizationFeature::OnDwellTimeElapsed,
+                     weak_ptr_factory_.GetWeakPtr(), ++dwell_generation_),
+      std::max(dwell_remaining_, base::TimeDelta()));
+}
+
+void SummarizationFeature::OnDwellTimeElapsed(int generation) {
+  if (generation != dwell_generation_ || !auto_summary_pending_)
+    return;
+  auto_summary_pending_ = false;
+  HandleAutoSummarization(current_page_url_, current_page_content_,
+                          current_browser_widget_);
+}
+
+void SummarizationFeature::CancelPendingAutoSummarization() {
+  auto_summary_pending_ = false;
+  ++dwell_generation_;
 }
 
 void SummarizationFeature::HandleAutoSummarization(
@@ -560,17 +1065,41 @@ void SummarizationFeature::HandleAutoSummarization(
   // Show the summary sidebar
   summarization_ui_->ShowSummarySidebar(browser_widget);
   
-  // Trigger summarization
-  summarization_service_->SummarizeContent(
+  // Trigger summarization; nobody asked for it yet, so it yields to
+  // user-initiated requests. The summary is shown as it is generated.
+  CancelAutoSummarization();
+  auto_summary_token_ = base::MakeRefCounted<asol::core::CancellationToken>();
+  // The root of the summary's trace, through ASOL to the gateway; it ends
+  // when the summary is shown
+  asol::core::TraceSpan span("SummarizationFeature::AutoSummarize",
+                             asol::core::TraceContext());
+  asol::core::TraceContext trace = span.context();
+  summarization_service_->SummarizeContentStreaming(
       page_content,
       page_url,
       preferred_format_,
       preferred_length_,
+      asol::core::RequestPriority::PREFETCH,
+      auto_summary_token_,
+      trace,
+      base::BindRepeating(
+          [](base::WeakPtr<SummarizationFeature> self,
+             const ai::SummarizationService::SummaryDelta& delta) {
+            if (self)
+              self->summarization_ui_->AppendSummaryDelta(delta);
+          },
+          weak_ptr_factory_.GetWeakPtr()),
       base::BindOnce(
           [](base::WeakPtr<SummarizationFeature> self,
+             asol::core::TraceSpan span,
              const ai::SummarizationService::SummaryResult& result) {
+            span.End();
             if (!self)
               return;
+
+            // The page it was for is gone; leave the UI to the next one
+            if (asol::core::IsCancellationError(result.error_message))
+              return;
             
             if (result.success) {
               self->summarization_ui_->SetUIState(
@@ -580,7 +1109,100 @@ void SummarizationFeature::HandleAutoSummarization(
                   ui::SummarizationUI::UIState::ERROR);
             }
           },
-          weak_ptr_factory_.GetWeakPtr()));
+          weak_ptr_factory_.GetWeakPtr(), std::move(span)));
+}
+
+void SummarizationFeature::CancelAutoSummarization() {
+  if (!auto_summary_token_)
+    return;
+  auto_summary_token_->Cancel();
+  auto_summary_token_ = nullptr;
+}
+
+SummarizationFeature::PrefetchList::iterator
+SummarizationFeature::FindPrefetch(const std::string& page_url) {
+  return std::find_if(prefetches_.begin(), prefetches_.end(),
+                      [&](const Prefetch& prefetch) {
+                        return prefetch.page_url == page_url;
+                      });
+}
+
+void SummarizationFeature::OnPrefetchContentFetched(
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const std::string& page_url,
+    const std::string& page_content) {
+  if (cancellation_token->IsCancelled())
+    return;
+  auto it = FindPrefetch(page_url);
+  if (it == prefetches_.end())
+    return;
+
+  // Not worth a summary; forget it without charging anything
+  if (!summarization_service_->IsContentSummarizable(page_content)) {
+    prefetches_.erase(it);
+    return;
+  }
+
+  // Nobody is waiting for it, so it runs as background work: it yields to
+  // every other request and stops early as the budget runs low
+  it->summarizing = true;
+  ++prefetch_stats_.started;
+  summarization_service_->SummarizeContent(
+      page_content, page_url, preferred_format_, preferred_length_,
+      asol::core::RequestPriority::BACKGROUND, cancellation_token,
+      asol::core::TraceContext(),
+      base::BindOnce(&SummarizationFeature::OnPrefetchSummarized,
+                     weak_ptr_factory_.GetWeakPtr(), cancellation_token,
+                     page_url));
+}
+
+void SummarizationFeature::OnPrefetchSummarized(
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    const std::string& page_url,
+    const ai::SummarizationService::SummaryResult& result) {
+  if (cancellation_token->IsCancelled())
+    return;
+  auto it = FindPrefetch(page_url);
+  if (it == prefetches_.end() ||
+      it->cancellation_token != cancellation_token) {
+    return;
+  }
+
+  if (result.success) {
+    ++prefetch_stats_.completed;
+    it->done = true;
+  } else {
+    ++prefetch_stats_.failed;
+    prefetches_.erase(it);
+  }
+}
+
+void SummarizationFeature::ConsumePrefetch(const std::string& page_url) {
+  auto it = FindPrefetch(page_url);
+  if (it == prefetches_.end())
+    return;
+
+  if (it->done) {
+    ++prefetch_stats_.hits;
+  } else if (it->summarizing) {
+    // Left to finish so the summary is cached for the next visit
+    ++prefetch_stats_.late;
+  } else {
+    it->cancellation_token->Cancel();
+  }
+  prefetches_.erase(it);
+}
+
+void SummarizationFeature::DropPrefetch(PrefetchList::iterator it) {
+  if (it->summarizing)
+    ++prefetch_stats_.wasted;
+  it->cancellation_token->Cancel();
+  prefetches_.erase(it);
+}
+
+void SummarizationFeature::DropAllPrefetches() {
+  while (!prefetches_.empty())
+    DropPrefetch(prefetches_.begin());
 }
 
 void SummarizationFeature::OnUIEvent(
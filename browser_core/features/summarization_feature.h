@@ -5,16 +5,24 @@
 #ifndef BROWSER_CORE_FEATURES_SUMMARIZATION_FEATURE_H_
 #define BROWSER_CORE_FEATURES_SUMMARIZATION_FEATURE_H_
 
+#include <list>
 #include <memory>
 #include <string>
 #include <unordered_map>
 
 #include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "browser_core/ai/summarization_service.h"
 #include "browser_core/ui/summarization_ui.h"
 #include "asol/core/ai_service_manager.h"
+#include "asol/core/budget_manager.h"
+#include "asol/core/cancellation_token.h"
 #include "asol/core/privacy_proxy.h"
+#include "asol/core/request_scheduler.h"
+#include "asol/core/service_manager.h"
+#include "asol/core/trace_context.h"
 
 namespace browser_core {
 namespace features {
@@ -38,6 +46,40 @@ class SummarizationFeature {
     float confidence_score;
   };
 
+  // Counts of speculative summaries, for tuning the prediction threshold.
+  // A prefetch is a hit when its page is opened with the summary ready,
+  // and wasted when the summary was paid for but the page never opened.
+  struct PrefetchStats {
+    size_t predictions = 0;      // Navigations predicted
+    size_t below_threshold = 0;  // Ignored as too unlikely
+    size_t started = 0;          // Summaries requested
+    size_t completed = 0;        // Summaries cached ahead of the page
+    size_t failed = 0;           // Summaries that could not be produced
+    size_t hits = 0;             // Opened with the summary ready
+    size_t late = 0;             // Opened while the summary was in progress
+    size_t wasted = 0;           // Requested but never opened
+
+    // Fractions of the summaries started; 0 before any
+    double GetHitRate() const;
+    double GetWasteRate() const;
+  };
+
+  // Fetches the content of a page that has not been opened yet, as
+  // OnPageLoaded() would get it, and runs the callback with it; empty
+  // content when it could not be fetched
+  using PageContentCallback =
+      base::OnceCallback<void(const std::string& page_content)>;
+  using PageContentFetcher =
+      base::RepeatingCallback<void(const std::string& page_url,
+                                   PageContentCallback callback)>;
+
+  // Predictions at least this likely are prefetched by default
+  static constexpr float kDefaultPrefetchThreshold = 0.5f;
+
+  // Time a page must stay visible before it is summarized automatically
+  static constexpr base::TimeDelta kDefaultAutoSummaryDwellTime =
+      base::Seconds(15);
+
   SummarizationFeature();
   ~SummarizationFeature();
 
@@ -49,10 +91,46 @@ class SummarizationFeature {
   bool Initialize(asol::core::AIServiceManager* ai_service_manager,
                 asol::core::PrivacyProxy* privacy_proxy);
 
+  // Schedule summarization requests through |scheduler|. Automatic
+  // summaries run as prefetch work. Not owned.
+  void SetRequestScheduler(asol::core::RequestScheduler* scheduler);
+
+  // Charge summarization to |budget_manager|; automatic summaries stop
+  // once the daily budget runs low. Not owned.
+  void SetBudgetManager(asol::core::BudgetManager* budget_manager);
+
+  // Summarize on the device with |provider_id| once the budget is spent
+  void SetLocalProviderId(const std::string& provider_id);
+
+  // Stream summaries into the sidebar from the adapters |service_manager|
+  // routes summarization to. Not owned.
+  void SetStreamingServiceManager(
+      asol::core::ServiceManager* service_manager);
+
+  // Pre-summarize pages the user is predicted to open, fetching them with
+  // |fetcher|. Prefetching is off until a fetcher is set.
+  void SetPrefetchContentFetcher(PageContentFetcher fetcher);
+
+  // Predictions less likely than |threshold| (0 to 1) are not prefetched
+  void SetPrefetchThreshold(float threshold);
+
+  // The user is likely to open |page_url| soon, e.g. they hover a link to
+  // it or the omnibox predicts it, with likelihood |confidence| (0 to 1).
+  // The page is fetched and summarized as background work, within the
+  // background budget, so its summary is cached by the time it opens.
+  void OnNavigationPredicted(const std::string& page_url, float confidence);
+
+  const PrefetchStats& GetPrefetchStats() const { return prefetch_stats_; }
+
   // Check if a page is eligible for summarization
   EligibilityResult IsPageEligibleForSummarization(const std::string& page_url,
                                                  const std::string& page_content);
 
+  // Automatic summaries start only once their page has been visible for
+  // |dwell_time| since it finished loading, so tabs closed or left within
+  // seconds cost nothing. Time spent hidden does not count.
+  void SetAutoSummaryDwellTime(base::TimeDelta dwell_time);
+
   // Set the feature mode
   void SetFeatureMode(FeatureMode mode);
   FeatureMode GetFeatureMode() const;
@@ -67,6 +145,7 @@ class SummarizationFeature {
                   views::View* toolbar_view,
                   views::Widget* browser_widget);
   void OnPageUnloaded(const std::string& page_url);
+  void OnPageVisibilityChanged(const std::string& page_url, bool visible);
   void OnBrowserClosed();
 
   // Get a weak pointer to this instance
@@ -77,11 +156,50 @@ class SummarizationFeature {
   bool ShouldAutoSummarize(const std::string& page_url,
                          const std::string& page_content);
 
+  // Summarize the current page automatically once it has been visible for
+  // the dwell time
+  void ScheduleAutoSummarization();
+  void StartDwellTimer();
+  void OnDwellTimeElapsed(int generation);
+
+  // Forget an automatic summary that has not started yet
+  void CancelPendingAutoSummarization();
+
   // Handle automatic summarization
   void HandleAutoSummarization(const std::string& page_url,
                              const std::string& page_content,
                              views::Widget* browser_widget);
 
+  // Abandon the automatic summary still running for the current page, if any
+  void CancelAutoSummarization();
+
+  // A page being summarized ahead of being opened
+  struct Prefetch {
+    std::string page_url;
+    scoped_refptr<asol::core::CancellationToken> cancellation_token;
+    bool summarizing = false;
+    bool done = false;
+  };
+  using PrefetchList = std::list<Prefetch>;
+
+  PrefetchList::iterator FindPrefetch(const std::string& page_url);
+
+  void OnPrefetchContentFetched(
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const std::string& page_url,
+      const std::string& page_content);
+  void OnPrefetchSummarized(
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const std::string& page_url,
+      const ai::SummarizationService::SummaryResult& result);
+
+  // |page_url| opened; settle its prefetch, if any
+  void ConsumePrefetch(const std::string& page_url);
+
+  // Stop tracking |it|, abandoning it if still in progress
+  void DropPrefetch(PrefetchList::iterator it);
+  void DropAllPrefetches();
+
   // Handle UI events
   void OnUIEvent(const std::string& event_type, const std::string& event_data);
 
@@ -102,6 +220,24 @@ class SummarizationFeature {
   views::View* current_toolbar_view_ = nullptr;
   views::Widget* current_browser_widget_ = nullptr;
 
+  // Dwell before the current page is summarized automatically. A timer
+  // only fires if |dwell_generation_| is unchanged since it was set.
+  base::TimeDelta auto_summary_dwell_time_ = kDefaultAutoSummaryDwellTime;
+  bool auto_summary_pending_ = false;
+  bool page_visible_ = false;
+  base::TimeDelta dwell_remaining_;
+  base::TimeTicks dwell_started_;
+  int dwell_generation_ = 0;
+
+  // Cancels the automatic summary of the current page once it goes away
+  scoped_refptr<asol::core::CancellationToken> auto_summary_token_;
+
+  // Speculative summaries of predicted pages, oldest first
+  PageContentFetcher prefetch_fetcher_;
+  float prefetch_threshold_ = kDefaultPrefetchThreshold;
+  PrefetchList prefetches_;
+  PrefetchStats prefetch_stats_;
+
   // For weak pointers
   base::WeakPtrFactory<SummarizationFeature> weak_ptr_factory_{this};
 };
@@ -116,16 +252,24 @@ class SummarizationFeature {
 #ifndef BROWSER_CORE_FEATURES_SUMMARIZATION_FEATURE_H_
 #define BROWSER_CORE_FEATURES_SUMMARIZATION_FEATURE_H_
 
+#include <list>
 #include <memory>
 #include <string>
 #include <unordered_map>
 
 #include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "browser_core/ai/summarization_service.h"
 #include "browser_core/ui/summarization_ui.h"
 #include "asol/core/ai_service_manager.h"
+#include "asol/core/budget_manager.h"
+#include "asol/core/cancellation_token.h"
 #include "asol/core/privacy_proxy.h"
+#include "asol/core/request_scheduler.h"
+#include "asol/core/service_manager.h"
+#include "asol/core/trace_context.h"
 
 namespace browser_core {
 namespace features {
@@ -149,6 +293,40 @@ class SummarizationFeature {
     float confidence_score;
   };
 
+  // Counts of speculative summaries, for tuning the prediction threshold.
+  // A prefetch is a hit when its page is opened with the summary ready,
+  // and wasted when the summary was paid for but the page never opened.
+  struct PrefetchStats {
+    size_t predictions = 0;      // Navigations predicted
+    size_t below_threshold = 0;  // Ignored as too unlikely
+    size_t started = 0;          // Summaries requested
+    size_t completed = 0;        // Summaries cached ahead of the page
+    size_t failed = 0;           // Summaries that could not be produced
+    size_t hits = 0;             // Opened with the summary ready
+    size_t late = 0;             // Opened while the summary was in progress
+    size_t wasted = 0;           // Requested but never opened
+
+    // Fractions of the summaries started; 0 before any
+    double GetHitRate() const;
+    double GetWasteRate() const;
+  };
+
+  // Fetches the content of a page that has not been opened yet, as
+  // OnPageLoaded() would get it, and runs the callback with it; empty
+  // content when it could not be fetched
+  using PageContentCallback =
+      base::OnceCallback<void(const std::string& page_content)>;
+  using PageContentFetcher =
+      base::RepeatingCallback<void(const std::string& page_url,
+                                   PageContentCallback callback)>;
+
+  // Predictions at least this likely are prefetched by default
+  static constexpr float kDefaultPrefetchThreshold = 0.5f;
+
+  // Time a page must stay visible before it is summarized automatically
+  static constexpr base::TimeDelta kDefaultAutoSummaryDwellTime =
+      base::Seconds(15);
+
   SummarizationFeature();
   ~SummarizationFeature();
 
@@ -160,10 +338,46 @@ class SummarizationFeature {
   bool Initialize(asol::core::AIServiceManager* ai_service_manager,
                 asol::core::PrivacyProxy* privacy_proxy);
 
+  // Schedule summarization requests through |scheduler|. Automatic
+  // summaries run as prefetch work. Not owned.
+  void SetRequestScheduler(asol::core::RequestScheduler* scheduler);
+
+  // Charge summarization to |budget_manager|; automatic summaries stop
+  // once the daily budget runs low. Not owned.
+  void SetBudgetManager(asol::core::BudgetManager* budget_manager);
+
+  // Summarize on the device with |provider_id| once the budget is spent
+  void SetLocalProviderId(const std::string& provider_id);
+
+  // Stream summaries into the sidebar from the adapters |service_manager|
+  // routes summarization to. Not owned.
+  void SetStreamingServiceManager(
+      asol::core::ServiceManager* service_manager);
+
+  // Pre-summarize pages the user is predicted to open, fetching them with
+  // |fetcher|. Prefetching is off until a fetcher is set.
+  void SetPrefetchContentFetcher(PageContentFetcher fetcher);
+
+  // Predictions less likely than |threshold| (0 to 1) are not prefetched
+  void SetPrefetchThreshold(float threshold);
+
+  // The user is likely to open |page_url| soon, e.g. they hover a link to
+  // it or the omnibox predicts it, with likelihood |confidence| (0 to 1).
+  // The page is fetched and summarized as background work, within the
+  // background budget, so its summary is cached by the time it opens.
+  void OnNavigationPredicted(const std::string& page_url, float confidence);
+
+  const PrefetchStats& GetPrefetchStats() const { return prefetch_stats_; }
+
   // Check if a page is eligible for summarization
   EligibilityResult IsPageEligibleForSummarization(const std::string& page_url,
                                                  const std::string& page_content);
 
+  // Automatic summaries start only once their page has been visible for
+  // |dwell_time| since it finished loading, so tabs closed or left within
+  // seconds cost nothing. Time spent hidden does not count.
+  void SetAutoSummaryDwellTime(base::TimeDelta dwell_time);
+
   // Set the feature mode
   void SetFeatureMode(FeatureMode mode);
   FeatureMode GetFeatureMode() const;
@@ -178,6 +392,7 @@ class SummarizationFeature {
                   views::View* toolbar_view,
                   views::Widget* browser_widget);
   void OnPageUnloaded(const std::string& page_url);
+  void OnPageVisibilityChanged(const std::string& page_url, bool visible);
   void OnBrowserClosed();
 
   // Get a weak pointer to this instance
@@ -188,11 +403,50 @@ class SummarizationFeature {
   bool ShouldAutoSummarize(const std::string& page_url,
                          const std::string& page_content);
 
+  // Summarize the current page automatically once it has been visible for
+  // the dwell time
+  void ScheduleAutoSummarization();
+  void StartDwellTimer();
+  void OnDwellTimeElapsed(int generation);
+
+  // Forget an automatic summary that has not started yet
+  void CancelPendingAutoSummarization();
+
   // Handle automatic summarization
   void HandleAutoSummarization(const std::string& page_url,
                              const std::string& page_content,
                              views::Widget* browser_widget);
 
+  // Abandon the automatic summary still running for the current page, if any
+  void CancelAutoSummarization();
+
+  // A page being summarized ahead of being opened
+  struct Prefetch {
+    std::string page_url;
+    scoped_refptr<asol::core::CancellationToken> cancellation_token;
+    bool summarizing = false;
+    bool done = false;
+  };
+  using PrefetchList = std::list<Prefetch>;
+
+  PrefetchList::iterator FindPrefetch(const std::string& page_url);
+
+  void OnPrefetchContentFetched(
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const std::string& page_url,
+      const std::string& page_content);
+  void OnPrefetchSummarized(
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      const std::string& page_url,
+      const ai::SummarizationService::SummaryResult& result);
+
+  // |page_url| opened; settle its prefetch, if any
+  void ConsumePrefetch(const std::string& page_url);
+
+  // Stop tracking |it|, abandoning it if still in progress
+  void DropPrefetch(PrefetchList::iterator it);
+  void DropAllPrefetches();
+
   // Handle UI events
   void OnUIEvent(const std::string& event_type, const std::string& event_data);
 
@@ -213,6 +467,24 @@ class SummarizationFeature {
   views::View* current_toolbar_view_ = nullptr;
   views::Widget* current_browser_widget_ = nullptr;
 
+  // Dwell before the current page is summarized automatically. A timer
+  // only fires if |dwell_generation_| is unchanged since it was set.
+  base::TimeDelta auto_summary_dwell_time_ = kDefaultAutoSummaryDwellTime;
+  bool auto_summary_pending_ = false;
+  bool page_visible_ = false;
+  base::TimeDelta dwell_remaining_;
+  base::TimeTicks dwell_started_;
+  int dwell_generation_ = 0;
+
+  // Cancels the automatic summary of the current page once it goes away
+  scoped_refptr<asol::core::CancellationToken> auto_summary_token_;
+
+  // Speculative summaries of predicted pages, oldest first
+  PageContentFetcher prefetch_fetcher_;
+  float prefetch_threshold_ = kDefaultPrefetchThreshold;
+  PrefetchList prefetches_;
+  PrefetchStats prefetch_stats_;
+
   // For weak pointers
   base::WeakPtrFactory<SummarizationFeature> weak_ptr_factory_{this};
 };
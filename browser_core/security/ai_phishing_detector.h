@@ -14,11 +14,17 @@
 #include "base/memory/weak_ptr.h"
 #include "asol/core/ai_service_manager.h"
 #include "browser_core/security/phishing_detector.h"
+#include "browser_core/security/phishing_triage.h"
 
 namespace browser_core {
 namespace security {
 
 // AIPhishingDetector uses AI to detect sophisticated phishing attempts.
+//
+// Detection runs through a PhishingTriage: the phishing list, allowlist,
+// URL tricks and a local URL classifier decide most pages without a
+// model, and AnalyzeContent() and AnalyzeVisualSimilarity() run, at the
+// same time, only for pages the local stages find ambiguous.
 class AIPhishingDetector {
  public:
   // Phishing detection result (extended from PhishingDetector)
@@ -46,7 +52,8 @@ class AIPhishingDetector {
   // Initialize with AI service manager
   bool Initialize(asol::core::AIServiceManager* ai_service_manager);
 
-  // Detect phishing using AI
+  // Detect phishing, asking the AI stages only if the local stages cannot
+  // decide. |callback| may run before this returns.
   void DetectPhishing(const std::string& url, 
                     const std::string& page_content,
                     const std::string& page_screenshot,
@@ -71,6 +78,15 @@ class AIPhishingDetector {
   void CheckPhishingPatterns(const std::string& content,
                            base::OnceCallback<void(const std::vector<std::string>& patterns)> callback);
 
+  // Lists and brand index for the local stages; each may be null and must
+  // outlive this
+  void SetLocalLists(const PhishingDomainSet* phishing_list,
+                     const PhishingDomainSet* allowlist,
+                     const BrandSimilarityIndex* brand_index);
+
+  // Pages decided by each stage, to watch how many reach the AI stages
+  size_t GetDecisionCount(PhishingTriage::Stage stage) const;
+
   // Enable/disable AI phishing detection
   void Enable(bool enable);
   bool IsEnabled() const;
@@ -100,6 +116,10 @@ class AIPhishingDetector {
   // AI service manager
   asol::core::AIServiceManager* ai_service_manager_ = nullptr;
 
+  // Staged detection; its AI stages call AnalyzeContent() and
+  // AnalyzeVisualSimilarity()
+  std::unique_ptr<PhishingTriage> triage_;
+
   // State
   bool is_enabled_ = true;
   float sensitivity_ = 0.7f;
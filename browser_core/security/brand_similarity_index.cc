@@ -0,0 +1,430 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/security/brand_similarity_index.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <utility>
+
+#include "base/containers/contains.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+
+namespace browser_core {
+namespace security {
+
+namespace {
+
+// Lookalikes of ASCII letters among the characters spoofed hosts use most:
+// Cyrillic and Greek letters drawn like Latin ones, and Latin letters with
+// marks that are easy to miss
+struct Confusable {
+  char32_t code_point;
+  char prototype;
+};
+
+constexpr Confusable kConfusables[] = {
+    // Latin
+    {0x0101, 'a'}, {0x0103, 'a'}, {0x0105, 'a'}, {0x0107, 'c'},
+    {0x010D, 'c'}, {0x010F, 'd'}, {0x0113, 'e'}, {0x0117, 'e'},
+    {0x0119, 'e'}, {0x011B, 'e'}, {0x011F, 'g'}, {0x012B, 'i'},
+    {0x012F, 'i'}, {0x0131, 'i'}, {0x0142, 'l'}, {0x0144, 'n'},
+    {0x0148, 'n'}, {0x014D, 'o'}, {0x0151, 'o'}, {0x0159, 'r'},
+    {0x015B, 's'}, {0x0161, 's'}, {0x0165, 't'}, {0x016B, 'u'},
+    {0x016F, 'u'}, {0x0171, 'u'}, {0x017A, 'z'}, {0x017C, 'z'},
+    {0x017E, 'z'}, {0x01C0, 'l'}, {0x0251, 'a'}, {0x0261, 'g'},
+    {0x0269, 'i'},
+    // Greek
+    {0x03B1, 'a'}, {0x03B5, 'e'}, {0x03B9, 'i'}, {0x03BA, 'k'},
+    {0x03BD, 'v'}, {0x03BF, 'o'}, {0x03C1, 'p'}, {0x03C4, 't'},
+    {0x03C5, 'u'}, {0x03C9, 'w'},
+    // Cyrillic
+    {0x0430, 'a'}, {0x0433, 'r'}, {0x0435, 'e'}, {0x043A, 'k'},
+    {0x043E, 'o'}, {0x0440, 'p'}, {0x0441, 'c'}, {0x0443, 'y'},
+    {0x0445, 'x'}, {0x0454, 'e'}, {0x0455, 's'}, {0x0456, 'i'},
+    {0x0457, 'i'}, {0x0458, 'j'}, {0x04BB, 'h'}, {0x04CF, 'l'},
+    {0x0501, 'd'}, {0x051B, 'q'}, {0x051D, 'w'},
+};
+
+// Latin-1 lowercase letters from U+00E0, as their base letter; 0 for
+// U+00F7, the division sign
+constexpr char kLatin1Letters[] = "aaaaaaaceeeeiiii" "dnooooo\0ouuuuyty";
+
+// Letter pairs drawn like one letter
+constexpr std::pair<const char*, const char*> kConfusableSequences[] = {
+    {"rn", "m"},
+    {"vv", "w"},
+};
+
+// Punycode parameters (RFC 3492)
+constexpr uint32_t kPunycodeBase = 36;
+constexpr uint32_t kPunycodeTMin = 1;
+constexpr uint32_t kPunycodeTMax = 26;
+constexpr uint32_t kPunycodeSkew = 38;
+constexpr uint32_t kPunycodeDamp = 700;
+constexpr uint32_t kPunycodeInitialBias = 72;
+constexpr uint32_t kPunycodeInitialN = 128;
+
+uint32_t AdaptBias(uint32_t delta, uint32_t points, bool first) {
+  delta = first ? delta / kPunycodeDamp : delta / 2;
+  delta += delta / points;
+  uint32_t k = 0;
+  while (delta > ((kPunycodeBase - kPunycodeTMin) * kPunycodeTMax) / 2) {
+    delta /= kPunycodeBase - kPunycodeTMin;
+    k += kPunycodeBase;
+  }
+  return k + (kPunycodeBase - kPunycodeTMin + 1) * delta /
+                 (delta + kPunycodeSkew);
+}
+
+void AppendUTF8(char32_t code_point, std::string* out) {
+  if (code_point < 0x80) {
+    out->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    out->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    out->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+// Next code point of the UTF-8 |text| from |*pos|; U+FFFD for a malformed
+// sequence, which is skipped a byte at a time
+char32_t ReadUTF8(std::string_view text, size_t* pos) {
+  uint8_t lead = static_cast<uint8_t>(text[(*pos)++]);
+  if (lead < 0x80) {
+    return lead;
+  }
+  size_t length = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+  if (length == 0 || *pos + length > text.size()) {
+    return 0xFFFD;
+  }
+  char32_t code_point = lead & (0x3F >> length);
+  for (size_t i = 0; i < length; ++i) {
+    uint8_t byte = static_cast<uint8_t>(text[*pos + i]);
+    if ((byte & 0xC0) != 0x80) {
+      return 0xFFFD;
+    }
+    code_point = (code_point << 6) | (byte & 0x3F);
+  }
+  *pos += length;
+  return code_point;
+}
+
+// ASCII prototype of |code_point|, or 0 if it has none
+char GetPrototype(char32_t code_point) {
+  if (code_point < 0x80) {
+    char c = base::ToLowerASCII(static_cast<char>(code_point));
+    return c == '0' ? 'o' : c == '1' ? 'l' : c;
+  }
+  if (code_point >= 0xC0 && code_point <= 0xFF && code_point != 0xDF) {
+    // Uppercase Latin-1 letters are 0x20 below their lowercase forms
+    return kLatin1Letters[(code_point | 0x20) - 0xE0];
+  }
+  if (code_point >= 0xFF01 && code_point <= 0xFF5E) {
+    // Fullwidth forms of ASCII
+    return GetPrototype(code_point - 0xFF01 + 0x21);
+  }
+  const Confusable* it = std::lower_bound(
+      std::begin(kConfusables), std::end(kConfusables), code_point,
+      [](const Confusable& confusable, char32_t value) {
+        return confusable.code_point < value;
+      });
+  return it != std::end(kConfusables) && it->code_point == code_point
+             ? it->prototype
+             : 0;
+}
+
+}  // namespace
+
+BrandSimilarityIndex::BrandSimilarityIndex() = default;
+BrandSimilarityIndex::~BrandSimilarityIndex() = default;
+
+void BrandSimilarityIndex::AddBrand(std::string_view brand_name,
+                                    std::string_view brand_domain) {
+  Brand brand;
+  brand.name = std::string(brand_name);
+  brand.domain = base::ToLowerASCII(brand_domain);
+  if (base::StartsWith(brand.domain, "www.")) {
+    brand.domain.erase(0, 4);
+  }
+  brand.key = GetSkeleton(brand.domain.substr(0, brand.domain.find('.')));
+  if (brand.key.empty()) {
+    return;
+  }
+
+  uint32_t index = static_cast<uint32_t>(brands_.size());
+  ForEachDeletion(brand.key, GetAllowedDistance(brand.key.size()),
+                  [this, index](const std::string& deletion) {
+                    std::vector<uint32_t>& entries = deletions_[deletion];
+                    if (entries.empty() || entries.back() != index) {
+                      entries.push_back(index);
+                    }
+                  });
+  brands_.push_back(std::move(brand));
+}
+
+bool BrandSimilarityIndex::FindSimilarBrand(std::string_view host,
+                                            Match* match) const {
+  std::string normalized = base::ToLowerASCII(host);
+  normalized = normalized.substr(0, normalized.find(':'));
+  while (!normalized.empty() && normalized.back() == '.') {
+    normalized.pop_back();
+  }
+
+  // Parts of the host to compare with brand keys: each label but the
+  // last, whole, without hyphens, and between hyphens
+  std::vector<std::string> labels = base::SplitString(
+      normalized, ".", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  if (labels.size() > 1) {
+    labels.pop_back();
+  }
+  std::vector<std::string> parts;
+  for (const std::string& label : labels) {
+    if (label == "www") {
+      continue;
+    }
+    std::string skeleton = GetSkeleton(DecodePunycodeLabel(label));
+    std::vector<std::string> pieces = base::SplitString(
+        skeleton, "-", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+    if (pieces.size() > 1) {
+      std::string joined;
+      for (const std::string& piece : pieces) {
+        joined += piece;
+      }
+      parts.push_back(std::move(joined));
+    }
+    parts.push_back(std::move(skeleton));
+    for (std::string& piece : pieces) {
+      parts.push_back(std::move(piece));
+    }
+  }
+
+  std::sort(parts.begin(), parts.end());
+  parts.erase(std::unique(parts.begin(), parts.end()), parts.end());
+
+  const Brand* best = nullptr;
+  int best_distance = kMaxEditDistance + 1;
+  std::vector<uint32_t> candidates;
+  for (const std::string& part : parts) {
+    if (part.empty() || part.size() > 63) {
+      continue;
+    }
+    // No key that could be within its allowed edits of |part| allows more
+    // than the longest such key
+    int max_deletes = GetAllowedDistance(part.size() + kMaxEditDistance);
+    candidates.clear();
+    ForEachDeletion(part, max_deletes,
+                    [this, &candidates](const std::string& deletion) {
+                      auto it = deletions_.find(deletion);
+                      if (it != deletions_.end()) {
+                        candidates.insert(candidates.end(),
+                                          it->second.begin(),
+                                          it->second.end());
+                      }
+                    });
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+
+    for (uint32_t index : candidates) {
+      const Brand& brand = brands_[index];
+      int allowed = GetAllowedDistance(brand.key.size());
+      int distance = GetEditDistance(part, brand.key, allowed);
+      if (distance > allowed || distance >= best_distance ||
+          IsOnDomain(normalized, brand.domain)) {
+        continue;
+      }
+      best = &brand;
+      best_distance = distance;
+    }
+  }
+
+  if (!best) {
+    return false;
+  }
+  if (match) {
+    match->brand_name = best->name;
+    match->brand_domain = best->domain;
+    match->distance = best_distance;
+  }
+  return true;
+}
+
+// static
+std::string BrandSimilarityIndex::GetSkeleton(std::string_view text) {
+  std::string skeleton;
+  skeleton.reserve(text.size());
+  for (size_t pos = 0; pos < text.size();) {
+    char32_t code_point = ReadUTF8(text, &pos);
+    char prototype = GetPrototype(code_point);
+    if (prototype) {
+      skeleton.push_back(prototype);
+    } else {
+      AppendUTF8(code_point, &skeleton);
+    }
+  }
+  for (const auto& [sequence, replacement] : kConfusableSequences) {
+    base::ReplaceSubstringsAfterOffset(&skeleton, 0, sequence, replacement);
+  }
+  return skeleton;
+}
+
+// static
+std::string BrandSimilarityIndex::DecodePunycodeLabel(std::string_view label) {
+  if (!base::StartsWith(label, "xn--")) {
+    return std::string(label);
+  }
+  std::string_view encoded = label.substr(4);
+
+  // Basic code points come first, up to the last delimiter
+  std::u32string output;
+  size_t delimiter = encoded.rfind('-');
+  size_t start = 0;
+  if (delimiter != std::string_view::npos) {
+    for (char c : encoded.substr(0, delimiter)) {
+      output.push_back(static_cast<unsigned char>(c));
+    }
+    start = delimiter + 1;
+  }
+
+  uint32_t n = kPunycodeInitialN;
+  uint32_t i = 0;
+  uint32_t bias = kPunycodeInitialBias;
+  for (size_t pos = start; pos < encoded.size();) {
+    uint32_t old_i = i;
+    uint32_t weight = 1;
+    for (uint32_t k = kPunycodeBase;; k += kPunycodeBase) {
+      if (pos >= encoded.size()) {
+        return std::string(label);
+      }
+      char c = base::ToLowerASCII(encoded[pos++]);
+      uint32_t digit;
+      if (c >= 'a' && c <= 'z') {
+        digit = c - 'a';
+      } else if (c >= '0' && c <= '9') {
+        digit = c - '0' + 26;
+      } else {
+        return std::string(label);
+      }
+      if (digit > (UINT32_MAX - i) / weight) {
+        return std::string(label);
+      }
+      i += digit * weight;
+      uint32_t t = k <= bias                   ? kPunycodeTMin
+                   : k >= bias + kPunycodeTMax ? kPunycodeTMax
+                                               : k - bias;
+      if (digit < t) {
+        break;
+      }
+      if (weight > UINT32_MAX / (kPunycodeBase - t)) {
+        return std::string(label);
+      }
+      weight *= kPunycodeBase - t;
+    }
+    uint32_t points = static_cast<uint32_t>(output.size()) + 1;
+    bias = AdaptBias(i - old_i, points, old_i == 0);
+    if (i / points > 0x10FFFF - n) {
+      return std::string(label);
+    }
+    n += i / points;
+    i %= points;
+    output.insert(output.begin() + i, static_cast<char32_t>(n));
+    ++i;
+  }
+
+  std::string decoded;
+  for (char32_t code_point : output) {
+    AppendUTF8(code_point, &decoded);
+  }
+  return decoded;
+}
+
+// static
+int BrandSimilarityIndex::GetEditDistance(std::string_view a,
+                                          std::string_view b,
+                                          int max_distance) {
+  int length_difference = static_cast<int>(a.size()) -
+                          static_cast<int>(b.size());
+  if (std::abs(length_difference) > max_distance) {
+    return max_distance + 1;
+  }
+
+  // Rows of the optimal string alignment distance, two back for
+  // transpositions
+  std::vector<int> before(b.size() + 1);
+  std::vector<int> previous(b.size() + 1);
+  std::vector<int> current(b.size() + 1);
+  for (size_t j = 0; j <= b.size(); ++j) {
+    previous[j] = static_cast<int>(j);
+  }
+  for (size_t i = 1; i <= a.size(); ++i) {
+    current[0] = static_cast<int>(i);
+    int row_minimum = current[0];
+    for (size_t j = 1; j <= b.size(); ++j) {
+      int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+      current[j] = std::min({previous[j] + 1, current[j - 1] + 1,
+                             previous[j - 1] + cost});
+      if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+        current[j] = std::min(current[j], before[j - 2] + 1);
+      }
+      row_minimum = std::min(row_minimum, current[j]);
+    }
+    if (row_minimum > max_distance) {
+      return max_distance + 1;
+    }
+    std::swap(before, previous);
+    std::swap(previous, current);
+  }
+  return std::min(previous[b.size()], max_distance + 1);
+}
+
+// static
+int BrandSimilarityIndex::GetAllowedDistance(size_t key_length) {
+  if (key_length < kMinTypoLength) {
+    return 0;
+  }
+  return key_length < 9 ? 1 : kMaxEditDistance;
+}
+
+// static
+template <typename Visitor>
+void BrandSimilarityIndex::ForEachDeletion(const std::string& key,
+                                           int max_deletes,
+                                           Visitor visit) {
+  visit(key);
+  if (max_deletes == 0 || key.size() <= 1) {
+    return;
+  }
+  std::string deletion;
+  for (size_t i = 0; i < key.size(); ++i) {
+    // Deleting one of a run of equal characters gives the same string
+    if (i > 0 && key[i] == key[i - 1]) {
+      continue;
+    }
+    deletion.assign(key, 0, i);
+    deletion.append(key, i + 1, std::string::npos);
+    ForEachDeletion(deletion, max_deletes - 1, visit);
+  }
+}
+
+// static
+bool BrandSimilarityIndex::IsOnDomain(std::string_view host,
+                                      std::string_view domain) {
+  return host == domain ||
+         (host.size() > domain.size() && base::EndsWith(host, domain) &&
+          host[host.size() - domain.size() - 1] == '.');
+}
+
+}  // namespace security
+}  // namespace browser_core
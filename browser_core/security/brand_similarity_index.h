@@ -0,0 +1,103 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_SECURITY_BRAND_SIMILARITY_INDEX_H_
+#define BROWSER_CORE_SECURITY_BRAND_SIMILARITY_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace browser_core {
+namespace security {
+
+// BrandSimilarityIndex finds the protected brand a host imitates, by
+// lookalike characters ("pаypal" with a Cyrillic "а", "paypa1"), typos
+// ("paypall") or decoration ("paypal-login"), in microseconds however
+// many brands it holds.
+//
+// Brands are keyed by the skeleton of the first label of their domain: a
+// form in which confusable characters are replaced by one prototype, in
+// the spirit of the UTS #39 skeleton, over a table of the characters most
+// used in spoofing rather than the full confusables data. Hosts are split
+// into labels, Punycode labels decoded first, and further into the parts
+// between hyphens; each part's skeleton is looked up in a SymSpell index
+// of brand keys with up to kMaxEditDistance characters deleted, and
+// candidates are confirmed with the edit distance. Longer keys allow more
+// edits, and keys shorter than kMinTypoLength must match exactly, as short
+// names are a few edits from too many words.
+class BrandSimilarityIndex {
+ public:
+  static constexpr int kMaxEditDistance = 2;
+  static constexpr size_t kMinTypoLength = 5;
+
+  struct Match {
+    std::string brand_name;
+    std::string brand_domain;
+    // Edits between the host part and the brand key; 0 when they only
+    // differ in lookalike characters or the host only adds decoration
+    int distance = 0;
+  };
+
+  BrandSimilarityIndex();
+  ~BrandSimilarityIndex();
+
+  BrandSimilarityIndex(const BrandSimilarityIndex&) = delete;
+  BrandSimilarityIndex& operator=(const BrandSimilarityIndex&) = delete;
+
+  // Protect |brand_domain|, e.g. "paypal.com", under |brand_name|
+  void AddBrand(std::string_view brand_name, std::string_view brand_domain);
+
+  size_t size() const { return brands_.size(); }
+
+  // Whether |host| imitates a brand without being on the brand's domain.
+  // Fills |match| with the closest brand.
+  bool FindSimilarBrand(std::string_view host, Match* match) const;
+
+  // Skeleton of the UTF-8 |text|: lowercase, with lookalikes replaced
+  static std::string GetSkeleton(std::string_view text);
+
+  // |label| decoded from Punycode ("xn--..."), as UTF-8. Returns |label|
+  // itself if it is not Punycode or is malformed.
+  static std::string DecodePunycodeLabel(std::string_view label);
+
+  // Edit distance between |a| and |b| counting adjacent transpositions as
+  // one edit, or |max_distance| + 1 if it is larger
+  static int GetEditDistance(std::string_view a,
+                             std::string_view b,
+                             int max_distance);
+
+ private:
+  struct Brand {
+    std::string name;
+    std::string domain;
+    std::string key;
+  };
+
+  // Edits allowed between a host part and a brand key of |key_length|
+  static int GetAllowedDistance(size_t key_length);
+
+  // Call |visit| with |key| and every string made by deleting up to
+  // |max_deletes| of its characters, possibly more than once
+  template <typename Visitor>
+  static void ForEachDeletion(const std::string& key,
+                              int max_deletes,
+                              Visitor visit);
+
+  // Whether |host| is |domain| or a host under it
+  static bool IsOnDomain(std::string_view host, std::string_view domain);
+
+  std::vector<Brand> brands_;
+  // Brand keys and their deletions, to indices of |brands_|
+  std::unordered_map<std::string, std::vector<uint32_t>> deletions_;
+};
+
+}  // namespace security
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_SECURITY_BRAND_SIMILARITY_INDEX_H_
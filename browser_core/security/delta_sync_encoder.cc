@@ -0,0 +1,287 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/security/delta_sync_encoder.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <array>
+#include <unordered_set>
+#include <utility>
+
+#include "base/check.h"
+#include "crypto/aead.h"
+#include "crypto/hkdf.h"
+#include "crypto/hmac.h"
+
+namespace browser_core {
+namespace security {
+
+namespace {
+
+constexpr uint32_t kManifestMagic = 0x4D534444;  // "DDSM"
+// Version 2 added the MAC
+constexpr uint32_t kManifestVersion = 2;
+
+constexpr char kIdKeyInfo[] = "delta-sync chunk id";
+constexpr char kEncryptionKeyInfo[] = "delta-sync chunk encryption";
+constexpr char kManifestKeyInfo[] = "delta-sync manifest";
+constexpr size_t kKeySize = 32;
+// HMAC-SHA256 after the manifest's fields
+constexpr size_t kManifestMacSize = 32;
+constexpr size_t kNonceSize = 12;
+
+// FastCDC masks for an 8 KiB average: 15 bits set below the average size,
+// so boundaries are rarer there, and 11 above it, so they are likelier,
+// spread over the high bits the gear hash mixes best
+constexpr uint64_t kMaskSmall = 0x0003590703530000ull;
+constexpr uint64_t kMaskLarge = 0x0000d90003530000ull;
+
+// Random value per byte for the gear hash, from splitmix64 so the table
+// and hence chunk boundaries are the same on every build
+constexpr std::array<uint64_t, 256> MakeGearTable() {
+  std::array<uint64_t, 256> table = {};
+  uint64_t state = 0x6465627375636463ull;
+  for (uint64_t& value : table) {
+    state += 0x9e3779b97f4a7c15ull;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    value = z ^ (z >> 31);
+  }
+  return table;
+}
+
+constexpr std::array<uint64_t, 256> kGearTable = MakeGearTable();
+
+// Length of the chunk at the start of |size| bytes at |data|
+size_t FindChunkEnd(const uint8_t* data, size_t size) {
+  if (size <= DeltaSyncEncoder::kMinChunkSize) {
+    return size;
+  }
+  size_t end = std::min(size, DeltaSyncEncoder::kMaxChunkSize);
+  size_t normal = std::min(end, DeltaSyncEncoder::kAverageChunkSize);
+  uint64_t hash = 0;
+  size_t i = DeltaSyncEncoder::kMinChunkSize;
+  for (; i < normal; ++i) {
+    hash = (hash << 1) + kGearTable[data[i]];
+    if (!(hash & kMaskSmall)) {
+      return i + 1;
+    }
+  }
+  for (; i < end; ++i) {
+    hash = (hash << 1) + kGearTable[data[i]];
+    if (!(hash & kMaskLarge)) {
+      return i + 1;
+    }
+  }
+  return end;
+}
+
+template <typename T>
+void Append(T value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool ReadValue(std::string_view* in, T* value) {
+  if (in->size() < sizeof(T)) {
+    return false;
+  }
+  memcpy(value, in->data(), sizeof(T));
+  in->remove_prefix(sizeof(T));
+  return true;
+}
+
+}  // namespace
+
+DeltaSyncEncoder::Manifest::Manifest() = default;
+DeltaSyncEncoder::Manifest::Manifest(const Manifest&) = default;
+DeltaSyncEncoder::Manifest::Manifest(Manifest&&) = default;
+DeltaSyncEncoder::Manifest& DeltaSyncEncoder::Manifest::operator=(
+    const Manifest&) = default;
+DeltaSyncEncoder::Manifest& DeltaSyncEncoder::Manifest::operator=(
+    Manifest&&) = default;
+DeltaSyncEncoder::Manifest::~Manifest() = default;
+
+DeltaSyncEncoder::Delta::Delta() = default;
+DeltaSyncEncoder::Delta::Delta(Delta&&) = default;
+DeltaSyncEncoder::Delta& DeltaSyncEncoder::Delta::operator=(Delta&&) = default;
+DeltaSyncEncoder::Delta::~Delta() = default;
+
+DeltaSyncEncoder::DeltaSyncEncoder(std::string_view sync_key)
+    : id_key_(crypto::HkdfSha256(sync_key, "", kIdKeyInfo, kKeySize)),
+      encryption_key_(
+          crypto::HkdfSha256(sync_key, "", kEncryptionKeyInfo, kKeySize)),
+      manifest_key_(
+          crypto::HkdfSha256(sync_key, "", kManifestKeyInfo, kKeySize)) {}
+
+DeltaSyncEncoder::~DeltaSyncEncoder() = default;
+
+DeltaSyncEncoder::Delta DeltaSyncEncoder::Encode(
+    std::string_view data,
+    const Manifest& previous) const {
+  crypto::Aead aead(crypto::Aead::AES_256_GCM_SIV);
+  aead.Init(&encryption_key_);
+  DCHECK_EQ(aead.NonceLength(), kNonceSize);
+
+  std::unordered_set<std::string> known(previous.chunk_ids.begin(),
+                                        previous.chunk_ids.end());
+  std::unordered_set<std::string> used;
+
+  Delta delta;
+  delta.manifest.data_size = data.size();
+  size_t offset = 0;
+  for (size_t length : FindChunkLengths(data)) {
+    std::string_view content = data.substr(offset, length);
+    offset += length;
+    std::string id = ComputeChunkId(content);
+    delta.manifest.chunk_ids.push_back(id);
+    if (known.count(id)) {
+      delta.reused_bytes += length;
+      used.insert(std::move(id));
+      continue;
+    }
+    if (!used.insert(id).second) {
+      // Repeated within |data|; sent once
+      continue;
+    }
+    EncryptedChunk chunk;
+    chunk.id = std::move(id);
+    // The id already is a keyed hash of the content, so as a nonce it only
+    // repeats for equal chunks, which GCM-SIV tolerates
+    std::string_view nonce(chunk.id.data(), kNonceSize);
+    bool sealed = aead.Seal(content, nonce, chunk.id, &chunk.ciphertext);
+    DCHECK(sealed);
+    delta.new_chunks.push_back(std::move(chunk));
+  }
+
+  for (const std::string& id : known) {
+    if (!used.count(id)) {
+      delta.removed_chunk_ids.push_back(id);
+    }
+  }
+  return delta;
+}
+
+bool DeltaSyncEncoder::Decode(
+    const Manifest& manifest,
+    const std::unordered_map<std::string, std::string>& chunks,
+    std::string* data) const {
+  crypto::Aead aead(crypto::Aead::AES_256_GCM_SIV);
+  aead.Init(&encryption_key_);
+
+  data->clear();
+  // |data_size| comes from the synced manifest; no chunk is larger than
+  // kMaxChunkSize, so anything more cannot be honest and must not size
+  // the allocation
+  if (manifest.data_size > manifest.chunk_ids.size() * kMaxChunkSize) {
+    return false;
+  }
+  data->reserve(manifest.data_size);
+  std::string content;
+  for (const std::string& id : manifest.chunk_ids) {
+    auto it = chunks.find(id);
+    if (id.size() != kChunkIdSize || it == chunks.end()) {
+      return false;
+    }
+    std::string_view nonce(id.data(), kNonceSize);
+    if (!aead.Open(it->second, nonce, id, &content) ||
+        ComputeChunkId(content) != id) {
+      return false;
+    }
+    data->append(content);
+  }
+  return data->size() == manifest.data_size;
+}
+
+// static
+std::vector<size_t> DeltaSyncEncoder::FindChunkLengths(std::string_view data) {
+  std::vector<size_t> lengths;
+  lengths.reserve(data.size() / kAverageChunkSize + 1);
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+  size_t offset = 0;
+  while (offset < data.size()) {
+    size_t length = FindChunkEnd(bytes + offset, data.size() - offset);
+    lengths.push_back(length);
+    offset += length;
+  }
+  return lengths;
+}
+
+std::string DeltaSyncEncoder::SerializeManifest(
+    const Manifest& manifest) const {
+  std::string serialized;
+  serialized.reserve(24 + manifest.chunk_ids.size() * kChunkIdSize +
+                     kManifestMacSize);
+  Append(kManifestMagic, &serialized);
+  Append(kManifestVersion, &serialized);
+  Append(manifest.data_size, &serialized);
+  Append(static_cast<uint32_t>(manifest.chunk_ids.size()), &serialized);
+  for (const std::string& id : manifest.chunk_ids) {
+    DCHECK_EQ(id.size(), kChunkIdSize);
+    serialized.append(id);
+  }
+
+  crypto::HMAC hmac(crypto::HMAC::SHA256);
+  std::string mac(kManifestMacSize, '\0');
+  bool signed_ok =
+      hmac.Init(manifest_key_) &&
+      hmac.Sign(serialized, reinterpret_cast<unsigned char*>(mac.data()),
+                mac.size());
+  DCHECK(signed_ok);
+  serialized.append(mac);
+  return serialized;
+}
+
+bool DeltaSyncEncoder::ParseManifest(std::string_view serialized,
+                                     Manifest* manifest) const {
+  // The chunks authenticate only themselves; the MAC covers their order,
+  // their list and the data size, none of which the server may change
+  if (serialized.size() < kManifestMacSize) {
+    return false;
+  }
+  std::string_view mac =
+      serialized.substr(serialized.size() - kManifestMacSize);
+  serialized.remove_suffix(kManifestMacSize);
+  crypto::HMAC hmac(crypto::HMAC::SHA256);
+  if (!hmac.Init(manifest_key_) || !hmac.Verify(serialized, mac)) {
+    return false;
+  }
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint64_t data_size = 0;
+  uint32_t chunk_count = 0;
+  if (!ReadValue(&serialized, &magic) || magic != kManifestMagic ||
+      !ReadValue(&serialized, &version) || version != kManifestVersion ||
+      !ReadValue(&serialized, &data_size) ||
+      !ReadValue(&serialized, &chunk_count) ||
+      serialized.size() != static_cast<size_t>(chunk_count) * kChunkIdSize) {
+    return false;
+  }
+  manifest->data_size = data_size;
+  manifest->chunk_ids.clear();
+  manifest->chunk_ids.reserve(chunk_count);
+  for (uint32_t i = 0; i < chunk_count; ++i) {
+    manifest->chunk_ids.emplace_back(serialized.substr(i * kChunkIdSize,
+                                                       kChunkIdSize));
+  }
+  return true;
+}
+
+std::string DeltaSyncEncoder::ComputeChunkId(std::string_view content) const {
+  crypto::HMAC hmac(crypto::HMAC::SHA256);
+  std::string id(kChunkIdSize, '\0');
+  bool signed_ok =
+      hmac.Init(id_key_) &&
+      hmac.Sign(content, reinterpret_cast<unsigned char*>(id.data()),
+                id.size());
+  DCHECK(signed_ok);
+  return id;
+}
+
+}  // namespace security
+}  // namespace browser_core
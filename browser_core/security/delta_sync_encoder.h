@@ -0,0 +1,121 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_SECURITY_DELTA_SYNC_ENCODER_H_
+#define BROWSER_CORE_SECURITY_DELTA_SYNC_ENCODER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace browser_core {
+namespace security {
+
+// DeltaSyncEncoder turns a synced data set into encrypted chunks and a
+// manifest listing them, so that a sync uploads only the chunks the
+// server does not have yet and costs in proportion to what changed.
+//
+// Data is split with FastCDC content-defined chunking: boundaries are
+// where a rolling gear hash of the content hits a mask, so an insertion
+// or deletion only changes the chunks around it and the rest keep their
+// boundaries and bytes. Chunk sizes are normalized around kAverageChunkSize
+// and held between kMinChunkSize and kMaxChunkSize.
+//
+// A chunk's id is an HMAC of its content under a key derived from the
+// sync key, and the chunk is sealed with AES-256-GCM-SIV under another
+// derived key, with a nonce taken from the id. Equal chunks thus encrypt
+// equally for one account, which is what lets a sync skip them, while
+// the server, without the key, can neither read chunks nor confirm a
+// guess of their content as plain convergent encryption would allow.
+//
+// The serialized manifest carries an HMAC under a third derived key, so
+// the server cannot reorder, drop or splice chunks or change the data
+// size either.
+class DeltaSyncEncoder {
+ public:
+  static constexpr size_t kMinChunkSize = 2 * 1024;
+  static constexpr size_t kAverageChunkSize = 8 * 1024;
+  static constexpr size_t kMaxChunkSize = 64 * 1024;
+  static constexpr size_t kChunkIdSize = 32;
+
+  // Chunks making up a data set, in order
+  struct Manifest {
+    Manifest();
+    Manifest(const Manifest&);
+    Manifest(Manifest&&);
+    Manifest& operator=(const Manifest&);
+    Manifest& operator=(Manifest&&);
+    ~Manifest();
+
+    // Raw ids, kChunkIdSize bytes each
+    std::vector<std::string> chunk_ids;
+    uint64_t data_size = 0;
+  };
+
+  struct EncryptedChunk {
+    std::string id;
+    std::string ciphertext;
+  };
+
+  // What a sync has to send
+  struct Delta {
+    Delta();
+    Delta(Delta&&);
+    Delta& operator=(Delta&&);
+    ~Delta();
+
+    Manifest manifest;
+    // Chunks of |manifest| not in the previous one, each once
+    std::vector<EncryptedChunk> new_chunks;
+    // Chunks of the previous manifest no longer used
+    std::vector<std::string> removed_chunk_ids;
+    // Bytes of data covered by chunks the server already has
+    uint64_t reused_bytes = 0;
+  };
+
+  // |sync_key| is the account's secret key, e.g. derived from the
+  // passphrase
+  explicit DeltaSyncEncoder(std::string_view sync_key);
+  ~DeltaSyncEncoder();
+
+  DeltaSyncEncoder(const DeltaSyncEncoder&) = delete;
+  DeltaSyncEncoder& operator=(const DeltaSyncEncoder&) = delete;
+
+  // Chunk and encrypt |data|, keeping only the chunks |previous|, the
+  // manifest of the last successful sync, does not list
+  Delta Encode(std::string_view data, const Manifest& previous) const;
+
+  // Reassemble the data of |manifest| into |data| from |chunks|, by id.
+  // Returns false if a chunk is missing or was tampered with, or if the
+  // manifest claims more data than its chunks can hold.
+  bool Decode(const Manifest& manifest,
+              const std::unordered_map<std::string, std::string>& chunks,
+              std::string* data) const;
+
+  // Lengths of the chunks of |data|, in order
+  static std::vector<size_t> FindChunkLengths(std::string_view data);
+
+  // |manifest| with its MAC
+  std::string SerializeManifest(const Manifest& manifest) const;
+  // Returns false if |serialized| is malformed or its MAC does not match,
+  // i.e. it was not serialized under this sync key or was changed since
+  bool ParseManifest(std::string_view serialized, Manifest* manifest) const;
+
+ private:
+  // Id of a chunk with |content|
+  std::string ComputeChunkId(std::string_view content) const;
+
+  std::string id_key_;
+  std::string encryption_key_;
+  std::string manifest_key_;
+};
+
+}  // namespace security
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_SECURITY_DELTA_SYNC_ENCODER_H_
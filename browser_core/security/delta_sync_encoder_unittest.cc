@@ -0,0 +1,155 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/security/delta_sync_encoder.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace browser_core {
+namespace security {
+namespace {
+
+constexpr char kSyncKey[] = "0123456789abcdef0123456789abcdef";
+
+// |size| bytes of incompressible, reproducible data
+std::string MakeData(size_t size, uint64_t seed) {
+  std::string data(size, '\0');
+  uint64_t state = seed;
+  for (char& byte : data) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    byte = static_cast<char>(state >> 56);
+  }
+  return data;
+}
+
+// The chunks of every delta in |deltas|, by id, as the server keeps them
+std::unordered_map<std::string, std::string> CollectChunks(
+    std::initializer_list<const DeltaSyncEncoder::Delta*> deltas) {
+  std::unordered_map<std::string, std::string> chunks;
+  for (const DeltaSyncEncoder::Delta* delta : deltas) {
+    for (const DeltaSyncEncoder::EncryptedChunk& chunk : delta->new_chunks) {
+      chunks[chunk.id] = chunk.ciphertext;
+    }
+  }
+  return chunks;
+}
+
+class DeltaSyncEncoderTest : public testing::Test {
+ protected:
+  // The manifest as the server would hand it back
+  bool RoundTripManifest(const DeltaSyncEncoder::Manifest& manifest,
+                         DeltaSyncEncoder::Manifest* parsed) {
+    return encoder_.ParseManifest(encoder_.SerializeManifest(manifest),
+                                  parsed);
+  }
+
+  DeltaSyncEncoder encoder_{kSyncKey};
+};
+
+TEST_F(DeltaSyncEncoderTest, InsertionKeepsOtherChunkBoundaries) {
+  std::string data = MakeData(512 * 1024, 1);
+  std::string edited = data;
+  edited.insert(data.size() / 2, "a few inserted bytes");
+
+  DeltaSyncEncoder::Delta first = encoder_.Encode(data, {});
+  DeltaSyncEncoder::Delta second = encoder_.Encode(edited, first.manifest);
+
+  std::unordered_set<std::string> old_ids(first.manifest.chunk_ids.begin(),
+                                          first.manifest.chunk_ids.end());
+  size_t shared = 0;
+  for (const std::string& id : second.manifest.chunk_ids) {
+    shared += old_ids.count(id);
+  }
+  // Only the chunks around the insertion change
+  EXPECT_GE(shared + 3, second.manifest.chunk_ids.size());
+  EXPECT_LE(second.new_chunks.size(), 3u);
+  EXPECT_GE(second.reused_bytes + 3 * DeltaSyncEncoder::kMaxChunkSize,
+            edited.size());
+
+  for (size_t length : DeltaSyncEncoder::FindChunkLengths(edited)) {
+    EXPECT_LE(length, DeltaSyncEncoder::kMaxChunkSize);
+  }
+}
+
+TEST_F(DeltaSyncEncoderTest, RoundTrips) {
+  std::string data = MakeData(300 * 1024, 2);
+  std::string edited = data.substr(0, 100 * 1024) + data.substr(120 * 1024);
+  DeltaSyncEncoder::Delta first = encoder_.Encode(data, {});
+  DeltaSyncEncoder::Delta second = encoder_.Encode(edited, first.manifest);
+
+  DeltaSyncEncoder::Manifest parsed;
+  ASSERT_TRUE(RoundTripManifest(second.manifest, &parsed));
+  EXPECT_EQ(parsed.chunk_ids, second.manifest.chunk_ids);
+  EXPECT_EQ(parsed.data_size, edited.size());
+
+  std::string decoded;
+  ASSERT_TRUE(
+      encoder_.Decode(parsed, CollectChunks({&first, &second}), &decoded));
+  EXPECT_EQ(decoded, edited);
+
+  // Another account's key neither parses the manifest nor opens a chunk
+  DeltaSyncEncoder other("fedcba9876543210fedcba9876543210");
+  EXPECT_FALSE(
+      other.ParseManifest(encoder_.SerializeManifest(parsed), &parsed));
+  EXPECT_FALSE(
+      other.Decode(second.manifest, CollectChunks({&first, &second}),
+                   &decoded));
+}
+
+TEST_F(DeltaSyncEncoderTest, RejectsTamperedManifests) {
+  DeltaSyncEncoder::Delta delta =
+      encoder_.Encode(MakeData(200 * 1024, 3), {});
+  ASSERT_GE(delta.manifest.chunk_ids.size(), 3u);
+  std::string serialized = encoder_.SerializeManifest(delta.manifest);
+  DeltaSyncEncoder::Manifest parsed;
+  ASSERT_TRUE(encoder_.ParseManifest(serialized, &parsed));
+
+  // Header: magic, version, data size, chunk count
+  const size_t kSizeOffset = 8;
+  const size_t kCountOffset = 16;
+  const size_t kIdsOffset = 20;
+  const size_t kIdSize = DeltaSyncEncoder::kChunkIdSize;
+
+  std::string reordered = serialized;
+  std::swap_ranges(reordered.begin() + kIdsOffset,
+                   reordered.begin() + kIdsOffset + kIdSize,
+                   reordered.begin() + kIdsOffset + kIdSize);
+  EXPECT_FALSE(encoder_.ParseManifest(reordered, &parsed));
+
+  std::string truncated = serialized;
+  uint32_t count = static_cast<uint32_t>(delta.manifest.chunk_ids.size() - 1);
+  memcpy(truncated.data() + kCountOffset, &count, sizeof(count));
+  truncated.erase(kIdsOffset + count * kIdSize, kIdSize);
+  EXPECT_FALSE(encoder_.ParseManifest(truncated, &parsed));
+
+  std::string resized = serialized;
+  uint64_t data_size = delta.manifest.data_size - 1;
+  memcpy(resized.data() + kSizeOffset, &data_size, sizeof(data_size));
+  EXPECT_FALSE(encoder_.ParseManifest(resized, &parsed));
+
+  EXPECT_FALSE(encoder_.ParseManifest(
+      std::string_view(serialized).substr(0, serialized.size() - 1), &parsed));
+
+  // A manifest built in memory still may not claim more than its chunks
+  DeltaSyncEncoder::Manifest oversized = delta.manifest;
+  oversized.data_size =
+      oversized.chunk_ids.size() * DeltaSyncEncoder::kMaxChunkSize + 1;
+  std::string decoded;
+  EXPECT_FALSE(encoder_.Decode(oversized, CollectChunks({&delta}), &decoded));
+}
+
+}  // namespace
+}  // namespace security
+}  // namespace browser_core
@@ -0,0 +1,256 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/security/malware_scanner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "asol/core/cancellation_token.h"
+#include "base/barrier_closure.h"
+#include "base/files/file.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/task/thread_pool.h"
+#include "base/thread_annotations.h"
+
+namespace browser_core {
+namespace security {
+
+namespace {
+
+// Sort |matches| by offset and keep the first MalwareScanner::kMaxMatches
+void SortMatches(std::vector<MalwareScanner::Match>* matches) {
+  std::sort(matches->begin(), matches->end(),
+            [](const MalwareScanner::Match& a, const MalwareScanner::Match& b) {
+              return a.offset != b.offset
+                         ? a.offset < b.offset
+                         : a.signature_index < b.signature_index;
+            });
+  if (matches->size() > MalwareScanner::kMaxMatches) {
+    matches->resize(MalwareScanner::kMaxMatches);
+  }
+}
+
+}  // namespace
+
+// A file being scanned, shared by the workers scanning its chunks
+class MalwareScanner::FileScan
+    : public base::RefCountedThreadSafe<MalwareScanner::FileScan> {
+ public:
+  FileScan(scoped_refptr<const SignatureMatcher> matcher, base::FilePath path)
+      : matcher_(std::move(matcher)), path_(std::move(path)) {}
+
+  FileScan(const FileScan&) = delete;
+  FileScan& operator=(const FileScan&) = delete;
+
+  void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+  // Scan chunks until none are left or the scan stops. Runs on a worker.
+  void Run();
+
+  // Result once every worker is done
+  ScanResult TakeResult();
+
+ private:
+  friend class base::RefCountedThreadSafe<FileScan>;
+  ~FileScan() = default;
+
+  bool ShouldStop() const {
+    return cancelled_.load(std::memory_order_relaxed) ||
+           failed_.load(std::memory_order_relaxed) ||
+           match_count_.load(std::memory_order_relaxed) >= kMaxMatches;
+  }
+
+  // Read |size| bytes at |offset| of |file| into |data|
+  static bool ReadFully(base::File& file,
+                        uint64_t offset,
+                        uint8_t* data,
+                        size_t size);
+
+  const scoped_refptr<const SignatureMatcher> matcher_;
+  const base::FilePath path_;
+
+  std::atomic<uint64_t> next_chunk_{0};
+  std::atomic<uint64_t> bytes_scanned_{0};
+  std::atomic<size_t> match_count_{0};
+  std::atomic<bool> cancelled_{false};
+  std::atomic<bool> failed_{false};
+
+  base::Lock lock_;
+  std::vector<Match> matches_ GUARDED_BY(lock_);
+};
+
+void MalwareScanner::FileScan::Run() {
+  if (ShouldStop()) {
+    return;
+  }
+  base::File file(path_, base::File::FLAG_OPEN | base::File::FLAG_READ |
+                             base::File::FLAG_WIN_SHARE_DELETE);
+  int64_t length = file.IsValid() ? file.GetLength() : -1;
+  if (length < 0) {
+    failed_.store(true, std::memory_order_relaxed);
+    return;
+  }
+
+  size_t overlap =
+      matcher_->max_pattern_length() > 0 ? matcher_->max_pattern_length() - 1
+                                         : 0;
+  std::vector<uint8_t> buffer;
+  std::vector<Match> found;
+  while (!ShouldStop()) {
+    uint64_t start =
+        next_chunk_.fetch_add(1, std::memory_order_relaxed) * kChunkSize;
+    if (start >= static_cast<uint64_t>(length)) {
+      break;
+    }
+    uint64_t end = std::min<uint64_t>(start + kChunkSize, length);
+    uint64_t read_start = start > overlap ? start - overlap : 0;
+    read_start -= read_start % kReadAlignment;
+
+    buffer.resize(end - read_start);
+    if (!ReadFully(file, read_start, buffer.data(), buffer.size())) {
+      failed_.store(true, std::memory_order_relaxed);
+      break;
+    }
+
+    // Matches ending before |start| belong to the previous chunk
+    size_t chunk_offset = start - read_start;
+    matcher_->Scan(
+        buffer.data(), buffer.size(), SignatureMatcher::kInitialState,
+        [this, &found, chunk_offset, read_start](size_t index, size_t end) {
+          if (end <= chunk_offset) {
+            return true;
+          }
+          Match match;
+          match.signature_index = index;
+          match.offset =
+              read_start + end - matcher_->signature(index).pattern.size();
+          found.push_back(std::move(match));
+          return match_count_.fetch_add(1, std::memory_order_relaxed) + 1 <
+                 kMaxMatches;
+        });
+    bytes_scanned_.fetch_add(end - start, std::memory_order_relaxed);
+  }
+
+  base::AutoLock lock(lock_);
+  matches_.insert(matches_.end(), std::make_move_iterator(found.begin()),
+                  std::make_move_iterator(found.end()));
+}
+
+MalwareScanner::ScanResult MalwareScanner::FileScan::TakeResult() {
+  ScanResult result;
+  result.completed = !cancelled_.load(std::memory_order_relaxed) &&
+                     !failed_.load(std::memory_order_relaxed);
+  result.bytes_scanned = bytes_scanned_.load(std::memory_order_relaxed);
+  {
+    base::AutoLock lock(lock_);
+    result.matches = std::move(matches_);
+  }
+  SortMatches(&result.matches);
+  for (Match& match : result.matches) {
+    match.signature_name = matcher_->signature(match.signature_index).name;
+  }
+  return result;
+}
+
+// static
+bool MalwareScanner::FileScan::ReadFully(base::File& file,
+                                         uint64_t offset,
+                                         uint8_t* data,
+                                         size_t size) {
+  while (size > 0) {
+    int read = file.Read(static_cast<int64_t>(offset),
+                         reinterpret_cast<char*>(data),
+                         static_cast<int>(size));
+    if (read <= 0) {
+      // The file shrank or could not be read
+      return false;
+    }
+    offset += read;
+    data += read;
+    size -= read;
+  }
+  return true;
+}
+
+MalwareScanner::PendingScan::PendingScan() = default;
+MalwareScanner::PendingScan::PendingScan(PendingScan&&) = default;
+MalwareScanner::PendingScan& MalwareScanner::PendingScan::operator=(
+    PendingScan&&) = default;
+MalwareScanner::PendingScan::~PendingScan() = default;
+
+MalwareScanner::MalwareScanner(scoped_refptr<const SignatureMatcher> matcher)
+    : matcher_(std::move(matcher)) {}
+
+MalwareScanner::~MalwareScanner() {
+  for (auto& [scan_id, pending] : pending_scans_) {
+    pending.scan->Cancel();
+  }
+}
+
+MalwareScanner::ScanResult MalwareScanner::ScanContent(
+    std::string_view content) const {
+  ScanResult result;
+  result.completed = true;
+  result.bytes_scanned = content.size();
+  matcher_->Scan(
+      reinterpret_cast<const uint8_t*>(content.data()), content.size(),
+      SignatureMatcher::kInitialState,
+      [this, &result](size_t index, size_t end) {
+        Match match;
+        match.signature_index = index;
+        match.signature_name = matcher_->signature(index).name;
+        match.offset = end - matcher_->signature(index).pattern.size();
+        result.matches.push_back(std::move(match));
+        return result.matches.size() < kMaxMatches;
+      });
+  SortMatches(&result.matches);
+  return result;
+}
+
+void MalwareScanner::ScanFile(
+    const base::FilePath& path,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    ScanCallback callback) {
+  int scan_id = next_scan_id_++;
+  PendingScan& pending = pending_scans_[scan_id];
+  pending.scan = base::MakeRefCounted<FileScan>(matcher_, path);
+  if (cancellation_token) {
+    if (cancellation_token->IsCancelled()) {
+      pending.scan->Cancel();
+    } else {
+      pending.cancel_subscription = cancellation_token->AddCancelCallback(
+          base::BindOnce(&FileScan::Cancel, pending.scan));
+    }
+  }
+
+  base::RepeatingClosure done = base::BarrierClosure(
+      kMaxParallelScans,
+      base::BindOnce(&MalwareScanner::OnFileScanned,
+                     weak_ptr_factory_.GetWeakPtr(), scan_id,
+                     std::move(callback)));
+  for (size_t i = 0; i < kMaxParallelScans; ++i) {
+    // Workers that find no chunk left finish at once
+    base::ThreadPool::PostTaskAndReply(
+        FROM_HERE,
+        {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+        base::BindOnce(&FileScan::Run, pending.scan), done);
+  }
+}
+
+void MalwareScanner::OnFileScanned(int scan_id, ScanCallback callback) {
+  auto it = pending_scans_.find(scan_id);
+  if (it == pending_scans_.end()) {
+    return;
+  }
+  scoped_refptr<FileScan> scan = std::move(it->second.scan);
+  pending_scans_.erase(it);
+  std::move(callback).Run(scan->TakeResult());
+}
+
+}  // namespace security
+}  // namespace browser_core
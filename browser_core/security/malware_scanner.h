@@ -0,0 +1,117 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_SECURITY_MALWARE_SCANNER_H_
+#define BROWSER_CORE_SECURITY_MALWARE_SCANNER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/callback_list.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "browser_core/security/signature_matcher.h"
+
+namespace asol {
+namespace core {
+class CancellationToken;
+}  // namespace core
+}  // namespace asol
+
+namespace browser_core {
+namespace security {
+
+// MalwareScanner looks for malware signatures in page content and in
+// downloaded files of any size, through a SignatureMatcher.
+//
+// Files are never loaded whole. ScanFile() splits a file into chunks of
+// kChunkSize and scans them on up to kMaxParallelScans thread pool
+// workers, each reading its chunks with positional reads into a buffer
+// of its own, from max_pattern_length() - 1 bytes before the chunk so that
+// matches across chunk boundaries are found, and keeping only matches
+// ending in the chunk. The file is opened shared and read-only, so the
+// download stays usable while the scan runs, and a scan stops early once
+// it has kMaxMatches matches or is cancelled.
+//
+// ScanFile() must be called on one sequence; its callback runs there.
+class MalwareScanner {
+ public:
+  struct Match {
+    size_t signature_index = 0;
+    std::string signature_name;
+    // Offset of the first byte of the match
+    uint64_t offset = 0;
+  };
+
+  struct ScanResult {
+    // False if the scan was cancelled or the file could not be read
+    bool completed = false;
+    uint64_t bytes_scanned = 0;
+    // In order of offset
+    std::vector<Match> matches;
+  };
+  using ScanCallback = base::OnceCallback<void(const ScanResult&)>;
+
+  // Bytes scanned at a time; a multiple of kReadAlignment
+  static constexpr size_t kChunkSize = 8 * 1024 * 1024;
+  // Reads start at multiples of this
+  static constexpr size_t kReadAlignment = 64 * 1024;
+  static constexpr size_t kMaxParallelScans = 4;
+  static constexpr size_t kMaxMatches = 64;
+
+  explicit MalwareScanner(scoped_refptr<const SignatureMatcher> matcher);
+  ~MalwareScanner();
+
+  MalwareScanner(const MalwareScanner&) = delete;
+  MalwareScanner& operator=(const MalwareScanner&) = delete;
+
+  // Scan |content| on the calling thread
+  ScanResult ScanContent(std::string_view content) const;
+
+  // Scan the file at |path| in the background. |cancellation_token| may be
+  // null. Scans still running when this is destroyed are cancelled and
+  // their callbacks never run.
+  void ScanFile(
+      const base::FilePath& path,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      ScanCallback callback);
+
+  // Scans started and not finished
+  size_t GetPendingScanCount() const { return pending_scans_.size(); }
+
+ private:
+  class FileScan;
+
+  struct PendingScan {
+    PendingScan();
+    PendingScan(PendingScan&&);
+    PendingScan& operator=(PendingScan&&);
+    ~PendingScan();
+
+    scoped_refptr<FileScan> scan;
+    // Forwards the caller's cancellation to the workers
+    base::CallbackListSubscription cancel_subscription;
+  };
+
+  void OnFileScanned(int scan_id, ScanCallback callback);
+
+  const scoped_refptr<const SignatureMatcher> matcher_;
+
+  int next_scan_id_ = 0;
+  std::map<int, PendingScan> pending_scans_;
+
+  base::WeakPtrFactory<MalwareScanner> weak_ptr_factory_{this};
+};
+
+}  // namespace security
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_SECURITY_MALWARE_SCANNER_H_
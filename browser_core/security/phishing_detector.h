@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "base/callback.h"
+#include "base/files/file_path.h"
 #include "browser_core/security/security_manager.h"
 
 namespace browser_core {
@@ -35,18 +36,32 @@ class PhishingDetector {
   // Initialize the phishing detector
   bool Initialize();
 
-  // Detect phishing in a URL and page content
+  // Detect phishing in a URL and page content. The host and the domains
+  // it is under are looked up in the phishing list first, which for hosts
+  // not on it usually ends at the list's filter (see PhishingDomainSet).
   void DetectPhishing(const std::string& url, 
                     const std::string& page_content,
                     PhishingDetectionCallback callback);
 
-  // Check if a URL is similar to a known brand
+  // Check if a URL is similar to a known brand: whether its host imitates
+  // a protected brand's domain by lookalike characters, typos or
+  // decoration without being on it. Looked up in a BrandSimilarityIndex,
+  // so the cost does not grow with the number of brands.
   bool IsSimilarToBrand(const std::string& url, std::string* brand_name);
 
-  // Get the list of known phishing domains
+  // Get the list of known phishing domains. Copies the whole list, which
+  // may hold millions of domains; lookups should go through DetectPhishing.
   std::vector<std::string> GetKnownPhishingDomains() const;
 
-  // Add a domain to the phishing list
+  // Replace the phishing list with the one saved at |path|, mapped rather
+  // than read. Returns false, keeping the current list, if it cannot be.
+  bool LoadPhishingList(const base::FilePath& path);
+
+  // Save the phishing list to |path| for LoadPhishingList()
+  bool SavePhishingList(const base::FilePath& path) const;
+
+  // Add a domain to the phishing list. Updates apply without rebuilding
+  // the list.
   void AddPhishingDomain(const std::string& domain);
 
   // Remove a domain from the phishing list
@@ -60,7 +75,8 @@ class PhishingDetector {
   bool IsAIDetectionEnabled() const;
 
  private:
-  // Private implementation
+  // Private implementation; holds the phishing list as a
+  // PhishingDomainSet and the protected brands as a BrandSimilarityIndex
   class Impl;
   std::unique_ptr<Impl> impl_;
 };
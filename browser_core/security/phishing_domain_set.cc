@@ -0,0 +1,524 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/security/phishing_domain_set.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "asol/core/request_fingerprint.h"
+#include "base/files/file_util.h"
+#include "base/logging.h"
+#include "base/strings/string_util.h"
+
+namespace browser_core {
+namespace security {
+
+namespace {
+
+constexpr uint32_t kFileMagic = 0x53444850;  // "PHDS"
+constexpr uint32_t kFileVersion = 1;
+
+struct ImageHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t domain_count;
+  uint32_t block_count;
+  uint64_t filter_seed;
+  uint32_t filter_block_length;
+  uint32_t reserved;
+};
+
+// Pending changes are folded into the image once they exceed this many,
+// or an eighth of the image if more
+constexpr size_t kMinCompactionChanges = 4096;
+
+// Seeds tried for the filter before giving up; each fails with a
+// probability well under 1% at the filter's size
+constexpr int kMaxFilterAttempts = 64;
+
+template <typename T>
+void Append(T value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T Read(const uint8_t* data, size_t index) {
+  T value;
+  memcpy(&value, data + index * sizeof(T), sizeof(T));
+  return value;
+}
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+// Read a varint at |*pos| before |end|. Returns false if it runs past.
+bool ReadVarint(const uint8_t** pos, const uint8_t* end, uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64 && *pos < end; shift += 7) {
+    uint8_t byte = *(*pos)++;
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Lowercase |domain| without trailing dots
+std::string NormalizeDomain(std::string_view domain) {
+  while (!domain.empty() && domain.back() == '.') {
+    domain.remove_suffix(1);
+  }
+  return base::ToLowerASCII(domain);
+}
+
+std::string Reversed(std::string_view value) {
+  return std::string(value.rbegin(), value.rend());
+}
+
+uint64_t HashDomain(std::string_view domain) {
+  asol::core::Hasher128 hasher;
+  hasher.Update(domain);
+  return hasher.Finish().low;
+}
+
+// Finalizer of splitmix64, to derive a filter hash per seed
+uint64_t Mix(uint64_t value) {
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31);
+}
+
+uint64_t RotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+// Index in [0, range) for the top bits of |value|
+uint32_t Reduce(uint32_t value, uint32_t range) {
+  return static_cast<uint32_t>((static_cast<uint64_t>(value) * range) >> 32);
+}
+
+uint8_t Fingerprint(uint64_t hash) {
+  return static_cast<uint8_t>(hash ^ (hash >> 32));
+}
+
+// The three filter slots of |hash|, one per block
+void GetSlots(uint64_t hash, uint32_t block_length, uint32_t slots[3]) {
+  slots[0] = Reduce(static_cast<uint32_t>(hash), block_length);
+  slots[1] = Reduce(static_cast<uint32_t>(RotateLeft(hash, 21)),
+                    block_length) +
+             block_length;
+  slots[2] = Reduce(static_cast<uint32_t>(RotateLeft(hash, 42)),
+                    block_length) +
+             2 * block_length;
+}
+
+// Fingerprints of an xor filter over |hashes|, which must be distinct, so
+// that the fingerprint of each is the xor of its three slots. Peeling
+// fails for an unlucky seed; the next one is tried.
+bool BuildFilter(const std::vector<uint64_t>& hashes,
+                 uint32_t block_length,
+                 uint64_t seed,
+                 std::string* fingerprints) {
+  const size_t capacity = 3 * static_cast<size_t>(block_length);
+  std::vector<uint64_t> xor_masks(capacity);
+  std::vector<uint32_t> counts(capacity);
+  uint32_t slots[3];
+  for (uint64_t hash : hashes) {
+    uint64_t mixed = Mix(hash ^ seed);
+    GetSlots(mixed, block_length, slots);
+    for (uint32_t slot : slots) {
+      xor_masks[slot] ^= mixed;
+      ++counts[slot];
+    }
+  }
+
+  // Peel slots with a single hash until none is left
+  std::vector<uint32_t> queue;
+  for (uint32_t slot = 0; slot < capacity; ++slot) {
+    if (counts[slot] == 1) {
+      queue.push_back(slot);
+    }
+  }
+  std::vector<std::pair<uint64_t, uint32_t>> order;
+  order.reserve(hashes.size());
+  while (!queue.empty()) {
+    uint32_t slot = queue.back();
+    queue.pop_back();
+    if (counts[slot] != 1) {
+      continue;
+    }
+    uint64_t mixed = xor_masks[slot];
+    order.emplace_back(mixed, slot);
+    GetSlots(mixed, block_length, slots);
+    for (uint32_t other : slots) {
+      xor_masks[other] ^= mixed;
+      if (--counts[other] == 1) {
+        queue.push_back(other);
+      }
+    }
+  }
+  if (order.size() != hashes.size()) {
+    return false;
+  }
+
+  fingerprints->assign(capacity, '\0');
+  auto* values = reinterpret_cast<uint8_t*>(fingerprints->data());
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    GetSlots(it->first, block_length, slots);
+    values[it->second] = 0;
+    values[it->second] = Fingerprint(it->first) ^ values[slots[0]] ^
+                         values[slots[1]] ^ values[slots[2]];
+  }
+  return true;
+}
+
+}  // namespace
+
+PhishingDomainSet::PhishingDomainSet() {
+  Assign({});
+}
+
+PhishingDomainSet::~PhishingDomainSet() = default;
+
+bool PhishingDomainSet::Open(const base::FilePath& path) {
+  if (!base::PathExists(path)) {
+    return false;
+  }
+  auto mapping = std::make_unique<base::MemoryMappedFile>();
+  if (!mapping->Initialize(path)) {
+    LOG(ERROR) << "Failed to map phishing domain set: " << path.value();
+    return false;
+  }
+  Image image;
+  if (!ParseImage(mapping->data(), mapping->length(), &image)) {
+    LOG(ERROR) << "Malformed phishing domain set: " << path.value();
+    return false;
+  }
+  mapping_ = std::move(mapping);
+  owned_image_.clear();
+  image_ = image;
+  added_.clear();
+  removed_.clear();
+  return true;
+}
+
+bool PhishingDomainSet::Write(const base::FilePath& path) const {
+  std::string data;
+  if (added_.empty() && removed_.empty()) {
+    const uint8_t* start =
+        mapping_ ? mapping_->data()
+                 : reinterpret_cast<const uint8_t*>(owned_image_.data());
+    size_t size = mapping_ ? mapping_->length() : owned_image_.size();
+    data.assign(reinterpret_cast<const char*>(start), size);
+  } else {
+    data = BuildImage(GetDomains());
+  }
+
+  base::FilePath temp_path = path.AddExtension(FILE_PATH_LITERAL("tmp"));
+  if (!base::WriteFile(temp_path, data) ||
+      !base::ReplaceFile(temp_path, path, nullptr)) {
+    LOG(ERROR) << "Failed to write phishing domain set: " << path.value();
+    base::DeleteFile(temp_path);
+    return false;
+  }
+  return true;
+}
+
+void PhishingDomainSet::Assign(std::vector<std::string> domains) {
+  owned_image_ = BuildImage(std::move(domains));
+  bool valid = ParseImage(
+      reinterpret_cast<const uint8_t*>(owned_image_.data()),
+      owned_image_.size(), &image_);
+  DCHECK(valid);
+  mapping_.reset();
+  added_.clear();
+  removed_.clear();
+}
+
+void PhishingDomainSet::Add(std::string_view domain) {
+  std::string normalized = NormalizeDomain(domain);
+  if (normalized.empty() || removed_.erase(normalized)) {
+    return;
+  }
+  if (!ImageContains(normalized)) {
+    added_.insert(std::move(normalized));
+    MaybeCompact();
+  }
+}
+
+void PhishingDomainSet::Remove(std::string_view domain) {
+  std::string normalized = NormalizeDomain(domain);
+  if (added_.erase(normalized)) {
+    return;
+  }
+  if (ImageContains(normalized)) {
+    removed_.insert(std::move(normalized));
+    MaybeCompact();
+  }
+}
+
+void PhishingDomainSet::Clear() {
+  Assign({});
+}
+
+bool PhishingDomainSet::Contains(std::string_view domain) const {
+  std::string normalized = NormalizeDomain(domain);
+  if (!added_.empty() && added_.count(normalized)) {
+    return true;
+  }
+  if (!removed_.empty() && removed_.count(normalized)) {
+    return false;
+  }
+  return ImageContains(normalized);
+}
+
+bool PhishingDomainSet::MatchesHost(std::string_view host) const {
+  std::string normalized = NormalizeDomain(host);
+  std::string_view domain = normalized;
+  while (!domain.empty()) {
+    if (Contains(domain)) {
+      return true;
+    }
+    size_t dot = domain.find('.');
+    if (dot == std::string_view::npos) {
+      break;
+    }
+    domain.remove_prefix(dot + 1);
+  }
+  return false;
+}
+
+size_t PhishingDomainSet::size() const {
+  return image_.domain_count + added_.size() - removed_.size();
+}
+
+std::vector<std::string> PhishingDomainSet::GetDomains() const {
+  std::vector<std::string> domains;
+  domains.reserve(size());
+  ForEachImageKey([this, &domains](std::string_view key) {
+    std::string domain = Reversed(key);
+    if (!removed_.count(domain)) {
+      domains.push_back(std::move(domain));
+    }
+  });
+  domains.insert(domains.end(), added_.begin(), added_.end());
+  return domains;
+}
+
+// static
+std::string PhishingDomainSet::BuildImage(std::vector<std::string> domains) {
+  for (std::string& domain : domains) {
+    domain = Reversed(NormalizeDomain(domain));
+  }
+  domains.erase(std::remove(domains.begin(), domains.end(), std::string()),
+                domains.end());
+  std::sort(domains.begin(), domains.end());
+  domains.erase(std::unique(domains.begin(), domains.end()), domains.end());
+
+  std::vector<uint64_t> hashes;
+  hashes.reserve(domains.size());
+  for (const std::string& key : domains) {
+    hashes.push_back(HashDomain(Reversed(key)));
+  }
+  // Distinct domains with equal 64-bit hashes are as good as impossible,
+  // but would make peeling fail for every seed
+  std::sort(hashes.begin(), hashes.end());
+  hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+  ImageHeader header = {};
+  header.magic = kFileMagic;
+  header.version = kFileVersion;
+  header.domain_count = static_cast<uint32_t>(domains.size());
+  std::string fingerprints;
+  if (!hashes.empty()) {
+    header.filter_block_length =
+        static_cast<uint32_t>((32 + hashes.size() * 123 / 100) / 3 + 1);
+    for (int attempt = 0; attempt < kMaxFilterAttempts; ++attempt) {
+      header.filter_seed = Mix(header.filter_seed + attempt + 1);
+      if (BuildFilter(hashes, header.filter_block_length, header.filter_seed,
+                      &fingerprints)) {
+        break;
+      }
+    }
+    // Without a filter every lookup goes to the blocks
+    if (fingerprints.empty()) {
+      header.filter_block_length = 0;
+    }
+  }
+
+  // Front-code each block against the previous domain of the block
+  std::string offsets;
+  std::string blocks;
+  for (size_t i = 0; i < domains.size(); ++i) {
+    const std::string& key = domains[i];
+    if (i % kBlockSize == 0) {
+      Append(static_cast<uint32_t>(blocks.size()), &offsets);
+      AppendVarint(0, &blocks);
+      AppendVarint(key.size(), &blocks);
+      blocks.append(key);
+      ++header.block_count;
+      continue;
+    }
+    const std::string& previous = domains[i - 1];
+    size_t shared = std::mismatch(previous.begin(), previous.end(),
+                                  key.begin(), key.end())
+                        .first -
+                    previous.begin();
+    AppendVarint(shared, &blocks);
+    AppendVarint(key.size() - shared, &blocks);
+    blocks.append(key, shared, std::string::npos);
+  }
+  Append(static_cast<uint32_t>(blocks.size()), &offsets);
+
+  std::string image;
+  Append(header, &image);
+  image.append(fingerprints);
+  image.append(offsets);
+  image.append(blocks);
+  return image;
+}
+
+// static
+bool PhishingDomainSet::ParseImage(const uint8_t* data,
+                                   size_t size,
+                                   Image* image) {
+  ImageHeader header;
+  if (size < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (header.magic != kFileMagic || header.version != kFileVersion ||
+      header.block_count !=
+          (header.domain_count + kBlockSize - 1) / kBlockSize) {
+    return false;
+  }
+  size_t fingerprints_size =
+      3 * static_cast<size_t>(header.filter_block_length);
+  size_t offsets_size = (header.block_count + 1) * sizeof(uint32_t);
+  size_t remaining = size - sizeof(header);
+  if (remaining < fingerprints_size ||
+      remaining - fingerprints_size < offsets_size) {
+    return false;
+  }
+
+  image->domain_count = header.domain_count;
+  image->block_count = header.block_count;
+  image->filter_seed = header.filter_seed;
+  image->filter_block_length = header.filter_block_length;
+  image->fingerprints = data + sizeof(header);
+  image->block_offsets = image->fingerprints + fingerprints_size;
+  image->blocks = image->block_offsets + offsets_size;
+  image->blocks_size = remaining - fingerprints_size - offsets_size;
+
+  // Blocks must be in order and within the image; their contents are
+  // checked as they are read
+  uint32_t previous = 0;
+  for (size_t i = 0; i <= image->block_count; ++i) {
+    uint32_t offset = Read<uint32_t>(image->block_offsets, i);
+    if (offset < previous || offset > image->blocks_size) {
+      return false;
+    }
+    previous = offset;
+  }
+  return previous == image->blocks_size;
+}
+
+bool PhishingDomainSet::ImageContains(std::string_view domain) const {
+  if (image_.domain_count == 0 || domain.empty()) {
+    return false;
+  }
+  if (image_.filter_block_length) {
+    uint64_t mixed = Mix(HashDomain(domain) ^ image_.filter_seed);
+    uint32_t slots[3];
+    GetSlots(mixed, image_.filter_block_length, slots);
+    if ((image_.fingerprints[slots[0]] ^ image_.fingerprints[slots[1]] ^
+         image_.fingerprints[slots[2]]) != Fingerprint(mixed)) {
+      return false;
+    }
+  }
+
+  std::string key = Reversed(domain);
+  auto block_start = [this](size_t block) {
+    return image_.blocks + Read<uint32_t>(image_.block_offsets, block);
+  };
+
+  // Last block whose first domain is not after |key|
+  size_t low = 0;
+  size_t high = image_.block_count;
+  while (high - low > 1) {
+    size_t middle = low + (high - low) / 2;
+    const uint8_t* pos = block_start(middle);
+    const uint8_t* end = block_start(middle + 1);
+    uint64_t shared;
+    uint64_t length;
+    if (!ReadVarint(&pos, end, &shared) || !ReadVarint(&pos, end, &length) ||
+        length > static_cast<uint64_t>(end - pos)) {
+      return false;
+    }
+    std::string_view first(reinterpret_cast<const char*>(pos), length);
+    if (first <= key) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+
+  const uint8_t* pos = block_start(low);
+  const uint8_t* end = block_start(low + 1);
+  std::string current;
+  while (pos < end) {
+    uint64_t shared;
+    uint64_t length;
+    if (!ReadVarint(&pos, end, &shared) || !ReadVarint(&pos, end, &length) ||
+        shared > current.size() || length > static_cast<uint64_t>(end - pos)) {
+      return false;
+    }
+    current.resize(shared);
+    current.append(reinterpret_cast<const char*>(pos), length);
+    pos += length;
+    if (current >= key) {
+      return current == key;
+    }
+  }
+  return false;
+}
+
+template <typename Visitor>
+void PhishingDomainSet::ForEachImageKey(Visitor visit) const {
+  const uint8_t* pos = image_.blocks;
+  const uint8_t* end = image_.blocks + image_.blocks_size;
+  std::string current;
+  while (pos < end) {
+    uint64_t shared;
+    uint64_t length;
+    if (!ReadVarint(&pos, end, &shared) || !ReadVarint(&pos, end, &length) ||
+        shared > current.size() || length > static_cast<uint64_t>(end - pos)) {
+      return;
+    }
+    current.resize(shared);
+    current.append(reinterpret_cast<const char*>(pos), length);
+    pos += length;
+    visit(std::string_view(current));
+  }
+}
+
+void PhishingDomainSet::MaybeCompact() {
+  size_t changes = added_.size() + removed_.size();
+  if (changes < std::max<size_t>(kMinCompactionChanges,
+                                 image_.domain_count / 8)) {
+    return;
+  }
+  Assign(GetDomains());
+}
+
+}  // namespace security
+}  // namespace browser_core
@@ -0,0 +1,118 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_SECURITY_PHISHING_DOMAIN_SET_H_
+#define BROWSER_CORE_SECURITY_PHISHING_DOMAIN_SET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+
+namespace browser_core {
+namespace security {
+
+// PhishingDomainSet holds a phishing blocklist of millions of domains in a
+// few bytes per domain and answers lookups in nanoseconds, most of them
+// without touching the list itself.
+//
+// The bulk of the set is an immutable image, built in memory or mapped
+// from a file written by Write():
+//  - an xor filter of 8-bit fingerprints (about 1.23 bytes per domain)
+//    that rules out all but ~0.4% of domains not in the set;
+//  - the domains, reversed so that those under one suffix share a prefix,
+//    sorted and front-coded in blocks of kBlockSize, found by binary
+//    search over the blocks' first domains.
+// Adds and removes go to small hash sets layered over the image and are
+// folded into a new image only once they outgrow a share of it, so list
+// updates do not rebuild the image each time.
+//
+// Domains are compared lowercase and without a trailing dot.
+class PhishingDomainSet {
+ public:
+  // Domains per front-coded block
+  static constexpr size_t kBlockSize = 16;
+
+  PhishingDomainSet();
+  ~PhishingDomainSet();
+
+  PhishingDomainSet(const PhishingDomainSet&) = delete;
+  PhishingDomainSet& operator=(const PhishingDomainSet&) = delete;
+
+  // Replace the set with the one written at |path|, mapped rather than
+  // read. Returns false, leaving the set as it was, if the file is missing
+  // or malformed.
+  bool Open(const base::FilePath& path);
+
+  // Write the set to |path|, replacing the file atomically
+  bool Write(const base::FilePath& path) const;
+
+  // Replace the set with |domains|, in any order and with repeats
+  void Assign(std::vector<std::string> domains);
+
+  void Add(std::string_view domain);
+  void Remove(std::string_view domain);
+  void Clear();
+
+  bool Contains(std::string_view domain) const;
+
+  // Whether |host| or a domain it is under, e.g. "evil.com" for
+  // "login.evil.com", is in the set
+  bool MatchesHost(std::string_view host) const;
+
+  size_t size() const;
+
+  // All domains, in no particular order
+  std::vector<std::string> GetDomains() const;
+
+ private:
+  // Image being read, owned or mapped
+  struct Image {
+    uint32_t domain_count = 0;
+    uint32_t block_count = 0;
+    uint64_t filter_seed = 0;
+    uint32_t filter_block_length = 0;
+    const uint8_t* fingerprints = nullptr;
+    const uint8_t* block_offsets = nullptr;
+    const uint8_t* blocks = nullptr;
+    size_t blocks_size = 0;
+  };
+
+  // Serialized image of |domains|, normalized
+  static std::string BuildImage(std::vector<std::string> domains);
+
+  // Read |size| bytes at |data| into |image|. Returns false if malformed.
+  static bool ParseImage(const uint8_t* data, size_t size, Image* image);
+
+  // Whether the image has |domain|, normalized
+  bool ImageContains(std::string_view domain) const;
+
+  // Call |visit| with each domain of the image, reversed
+  template <typename Visitor>
+  void ForEachImageKey(Visitor visit) const;
+
+  // Fold pending changes into a new image once they are many
+  void MaybeCompact();
+
+  std::unique_ptr<base::MemoryMappedFile> mapping_;
+  std::string owned_image_;
+  Image image_;
+
+  // Changes since the image was built: domains not in it, and domains of
+  // it that are gone
+  std::unordered_set<std::string> added_;
+  std::unordered_set<std::string> removed_;
+};
+
+}  // namespace security
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_SECURITY_PHISHING_DOMAIN_SET_H_
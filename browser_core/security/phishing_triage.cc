@@ -0,0 +1,357 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/security/phishing_triage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "base/containers/contains.h"
+#include "base/strings/string_util.h"
+#include "browser_core/security/brand_similarity_index.h"
+#include "browser_core/security/phishing_domain_set.h"
+
+namespace browser_core {
+namespace security {
+
+namespace {
+
+// Words phishing URLs use to look like an account page
+constexpr const char* kSuspiciousKeywords[] = {
+    "login",  "signin",  "verify",  "account", "update", "secure",
+    "banking", "confirm", "password", "wallet", "unlock", "suspend",
+};
+
+// Top-level domains that host a disproportionate share of phishing
+constexpr const char* kSuspiciousTlds[] = {
+    "zip", "mov", "xyz", "top", "tk", "ml", "ga", "cf", "gq", "click",
+    "country", "work", "support", "rest",
+};
+
+// Keywords counted in a URL at most, so long URLs do not score on length
+constexpr size_t kMaxKeywords = 3;
+
+// Weights of the local classifier, a logistic regression over the
+// lexical features. An https URL with none of them scores about 0.02.
+constexpr float kBias = -4.0f;
+constexpr float kWeightNoHttps = 1.0f;
+constexpr float kWeightIpHost = 2.5f;
+constexpr float kWeightUserInfo = 2.5f;
+constexpr float kWeightPunycode = 1.0f;
+constexpr float kWeightSuspiciousTld = 1.5f;
+constexpr float kWeightLongHost = 0.05f;  // per character over 24
+constexpr float kWeightExtraLabel = 0.5f;  // per label over 3
+constexpr float kWeightHyphen = 0.4f;      // up to 4
+constexpr float kWeightDigit = 0.1f;       // up to 8
+constexpr float kWeightKeyword = 0.8f;
+constexpr float kWeightBrand = 3.0f;
+
+// Parts of a URL the lexical stages look at
+struct UrlParts {
+  std::string_view scheme;
+  std::string_view user_info;
+  std::string_view host;
+  std::string_view rest;
+};
+
+UrlParts SplitUrl(std::string_view url) {
+  UrlParts parts;
+  size_t scheme_end = url.find("://");
+  if (scheme_end != std::string_view::npos) {
+    parts.scheme = url.substr(0, scheme_end);
+    url.remove_prefix(scheme_end + 3);
+  }
+  size_t authority_end = url.find_first_of("/?#");
+  std::string_view authority = url.substr(0, authority_end);
+  if (authority_end != std::string_view::npos) {
+    parts.rest = url.substr(authority_end);
+  }
+  size_t at = authority.rfind('@');
+  if (at != std::string_view::npos) {
+    parts.user_info = authority.substr(0, at);
+    authority.remove_prefix(at + 1);
+  }
+  if (!authority.empty() && authority.front() == '[') {
+    parts.host = authority.substr(0, authority.find(']') + 1);
+  } else {
+    parts.host = authority.substr(0, authority.find(':'));
+  }
+  return parts;
+}
+
+bool IsIpHost(std::string_view host) {
+  if (!host.empty() && host.front() == '[') {
+    return true;
+  }
+  // Dotted quads, and the single numbers browsers also read as addresses
+  return !host.empty() && std::all_of(host.begin(), host.end(), [](char c) {
+    return base::IsAsciiDigit(c) || c == '.';
+  });
+}
+
+}  // namespace
+
+PhishingTriage::PendingAnalysis::PendingAnalysis() = default;
+PhishingTriage::PendingAnalysis::PendingAnalysis(PendingAnalysis&&) = default;
+PhishingTriage::PendingAnalysis& PhishingTriage::PendingAnalysis::operator=(
+    PendingAnalysis&&) = default;
+PhishingTriage::PendingAnalysis::~PendingAnalysis() = default;
+
+PhishingTriage::PhishingTriage() = default;
+PhishingTriage::~PhishingTriage() = default;
+
+void PhishingTriage::SetPhishingList(const PhishingDomainSet* phishing_list) {
+  phishing_list_ = phishing_list;
+}
+
+void PhishingTriage::SetAllowlist(const PhishingDomainSet* allowlist) {
+  allowlist_ = allowlist;
+}
+
+void PhishingTriage::SetBrandIndex(const BrandSimilarityIndex* brand_index) {
+  brand_index_ = brand_index;
+}
+
+void PhishingTriage::SetContentStage(AnalysisStage stage) {
+  content_stage_ = std::move(stage);
+}
+
+void PhishingTriage::SetVisualStage(AnalysisStage stage) {
+  visual_stage_ = std::move(stage);
+}
+
+void PhishingTriage::SetThresholds(float benign_below, float phishing_from) {
+  benign_below_ = std::clamp(benign_below, 0.0f, 1.0f);
+  phishing_from_ = std::clamp(phishing_from, benign_below_, 1.0f);
+}
+
+void PhishingTriage::Triage(const std::string& url,
+                            const std::string& page_content,
+                            const std::string& page_screenshot,
+                            VerdictCallback callback) {
+  Verdict verdict;
+  std::string host = GetHost(url);
+
+  // Stage 1: the lists
+  if (allowlist_ && allowlist_->MatchesHost(host)) {
+    verdict.decided_by = Stage::kAllowlist;
+    verdict.reasons.push_back("Domain is on the allowlist");
+    Decide(std::move(verdict), std::move(callback));
+    return;
+  }
+  if (phishing_list_ && phishing_list_->MatchesHost(host)) {
+    verdict.is_phishing = true;
+    verdict.score = 1.0f;
+    verdict.decided_by = Stage::kPhishingList;
+    verdict.reasons.push_back("Domain is a known phishing domain");
+    Decide(std::move(verdict), std::move(callback));
+    return;
+  }
+
+  // Stage 2: tricks that need no weighing
+  UrlFeatures features = ExtractUrlFeatures(url, brand_index_);
+  verdict.target_brand = features.imitated_brand;
+  if (!features.imitated_brand.empty() && features.has_punycode &&
+      features.brand_distance == 0) {
+    verdict.reasons.push_back("Internationalized domain drawn like " +
+                              features.imitated_brand);
+  }
+  if (features.has_user_info &&
+      SplitUrl(url).user_info.find('.') != std::string_view::npos) {
+    verdict.reasons.push_back(
+        "URL hides its host behind a domain-like user name");
+  }
+  if (!verdict.reasons.empty()) {
+    verdict.is_phishing = true;
+    verdict.score = 1.0f;
+    verdict.decided_by = Stage::kLexical;
+    Decide(std::move(verdict), std::move(callback));
+    return;
+  }
+
+  // Stage 3: the local classifier
+  float local_score = ScoreUrlFeatures(features);
+  verdict.score = local_score;
+  verdict.decided_by = Stage::kLocalClassifier;
+  if (!features.imitated_brand.empty()) {
+    verdict.reasons.push_back("Domain resembles " + features.imitated_brand);
+  }
+  if (features.host_is_ip) {
+    verdict.reasons.push_back("Host is an IP address");
+  }
+  if (features.has_suspicious_tld) {
+    verdict.reasons.push_back("Top-level domain is often used for phishing");
+  }
+  if (features.keyword_count > 0) {
+    verdict.reasons.push_back("URL uses account-related keywords");
+  }
+
+  bool run_content = content_stage_ && !page_content.empty();
+  bool run_visual = visual_stage_ && !page_screenshot.empty();
+  bool ambiguous =
+      local_score >= benign_below_ && local_score < phishing_from_;
+  if (!ambiguous || (!run_content && !run_visual)) {
+    verdict.is_phishing =
+        ambiguous ? local_score >= 0.5f : local_score >= phishing_from_;
+    Decide(std::move(verdict), std::move(callback));
+    return;
+  }
+
+  // Stage 4: the AI stages, at the same time
+  int id = next_analysis_id_++;
+  PendingAnalysis& pending = pending_[id];
+  pending.verdict = std::move(verdict);
+  pending.local_score = local_score;
+  pending.stages_left = (run_content ? 1 : 0) + (run_visual ? 1 : 0);
+  pending.callback = std::move(callback);
+  // Stages may answer synchronously and erase |pending|, so nothing below
+  // touches it
+  if (run_content) {
+    content_stage_.Run(
+        url, page_content,
+        base::BindOnce(&PhishingTriage::OnAnalysisDone,
+                       weak_ptr_factory_.GetWeakPtr(), id, "Content"));
+  }
+  if (run_visual) {
+    visual_stage_.Run(
+        url, page_screenshot,
+        base::BindOnce(&PhishingTriage::OnAnalysisDone,
+                       weak_ptr_factory_.GetWeakPtr(), id, "Visual"));
+  }
+}
+
+size_t PhishingTriage::GetDecisionCount(Stage stage) const {
+  return decision_counts_[static_cast<size_t>(stage)];
+}
+
+// static
+PhishingTriage::UrlFeatures PhishingTriage::ExtractUrlFeatures(
+    std::string_view url,
+    const BrandSimilarityIndex* brand_index) {
+  UrlFeatures features;
+  UrlParts parts = SplitUrl(url);
+  std::string host = GetHost(url);
+
+  features.uses_https = base::EqualsCaseInsensitiveASCII(parts.scheme, "https");
+  features.host_is_ip = IsIpHost(host);
+  features.has_user_info = !parts.user_info.empty();
+  features.host_length = host.size();
+  if (!features.host_is_ip) {
+    features.label_count = std::count(host.begin(), host.end(), '.') + 1;
+    features.hyphen_count = std::count(host.begin(), host.end(), '-');
+    features.digit_count =
+        std::count_if(host.begin(), host.end(), base::IsAsciiDigit<char>);
+    features.has_punycode = base::StartsWith(host, "xn--") ||
+                            host.find(".xn--") != std::string::npos;
+    size_t last_dot = host.rfind('.');
+    std::string_view tld = host;
+    if (last_dot != std::string::npos) {
+      tld.remove_prefix(last_dot + 1);
+    }
+    features.has_suspicious_tld = base::Contains(kSuspiciousTlds, tld);
+  }
+
+  std::string lower = host + base::ToLowerASCII(parts.rest);
+  for (const char* keyword : kSuspiciousKeywords) {
+    if (features.keyword_count == kMaxKeywords) {
+      break;
+    }
+    if (lower.find(keyword) != std::string::npos) {
+      ++features.keyword_count;
+    }
+  }
+
+  BrandSimilarityIndex::Match match;
+  if (brand_index && !features.host_is_ip &&
+      brand_index->FindSimilarBrand(host, &match)) {
+    features.imitated_brand = std::move(match.brand_name);
+    features.brand_distance = match.distance;
+  }
+  return features;
+}
+
+// static
+float PhishingTriage::ScoreUrlFeatures(const UrlFeatures& features) {
+  float logit = kBias;
+  if (!features.uses_https) {
+    logit += kWeightNoHttps;
+  }
+  if (features.host_is_ip) {
+    logit += kWeightIpHost;
+  }
+  if (features.has_user_info) {
+    logit += kWeightUserInfo;
+  }
+  if (features.has_punycode) {
+    logit += kWeightPunycode;
+  }
+  if (features.has_suspicious_tld) {
+    logit += kWeightSuspiciousTld;
+  }
+  if (features.host_length > 24) {
+    logit += kWeightLongHost * (features.host_length - 24);
+  }
+  if (features.label_count > 3) {
+    logit += kWeightExtraLabel * (features.label_count - 3);
+  }
+  logit += kWeightHyphen * std::min<size_t>(features.hyphen_count, 4);
+  logit += kWeightDigit * std::min<size_t>(features.digit_count, 8);
+  logit += kWeightKeyword * features.keyword_count;
+  if (!features.imitated_brand.empty()) {
+    logit += kWeightBrand;
+  }
+  return 1.0f / (1.0f + std::exp(-logit));
+}
+
+// static
+std::string PhishingTriage::GetHost(std::string_view url) {
+  std::string host = base::ToLowerASCII(SplitUrl(url).host);
+  while (!host.empty() && host.back() == '.') {
+    host.pop_back();
+  }
+  return host;
+}
+
+void PhishingTriage::OnAnalysisDone(int id,
+                                    const char* stage_name,
+                                    float score,
+                                    const std::vector<std::string>& reasons) {
+  auto it = pending_.find(id);
+  if (it == pending_.end()) {
+    return;
+  }
+  PendingAnalysis& pending = it->second;
+  if (score >= 0.0f) {
+    pending.ai_score_sum += std::min(score, 1.0f);
+    ++pending.ai_score_count;
+    for (const std::string& reason : reasons) {
+      pending.verdict.reasons.push_back(std::string(stage_name) + ": " +
+                                        reason);
+    }
+  }
+  if (--pending.stages_left > 0) {
+    return;
+  }
+
+  Verdict verdict = std::move(pending.verdict);
+  VerdictCallback callback = std::move(pending.callback);
+  if (pending.ai_score_count > 0) {
+    float ai_score = pending.ai_score_sum / pending.ai_score_count;
+    verdict.score =
+        (1.0f - kAIWeight) * pending.local_score + kAIWeight * ai_score;
+    verdict.decided_by = Stage::kAIAnalysis;
+  }
+  verdict.is_phishing = verdict.score >= 0.5f;
+  pending_.erase(it);
+  Decide(std::move(verdict), std::move(callback));
+}
+
+void PhishingTriage::Decide(Verdict verdict, VerdictCallback callback) {
+  ++decision_counts_[static_cast<size_t>(verdict.decided_by)];
+  std::move(callback).Run(verdict);
+}
+
+}  // namespace security
+}  // namespace browser_core
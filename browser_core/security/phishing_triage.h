@@ -0,0 +1,174 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_SECURITY_PHISHING_TRIAGE_H_
+#define BROWSER_CORE_SECURITY_PHISHING_TRIAGE_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+
+namespace browser_core {
+namespace security {
+
+class BrandSimilarityIndex;
+class PhishingDomainSet;
+
+// PhishingTriage decides whether a page is phishing in stages of rising
+// cost, stopping at the first stage that is sure:
+//  1. the allowlist and the phishing list;
+//  2. lexical tricks in the URL that settle the question alone, such as a
+//     Punycode host drawn like a protected brand;
+//  3. a local linear classifier over the URL's lexical features.
+// Only pages the classifier scores between the benign and phishing
+// thresholds go to the AI content and visual stages, which run at the
+// same time and are blended with the local score. Local stages run
+// synchronously, so most pages are decided before Triage() returns.
+class PhishingTriage {
+ public:
+  enum class Stage {
+    kAllowlist,
+    kPhishingList,
+    kLexical,
+    kLocalClassifier,
+    kAIAnalysis,
+  };
+  static constexpr size_t kStageCount =
+      static_cast<size_t>(Stage::kAIAnalysis) + 1;
+
+  struct Verdict {
+    bool is_phishing = false;
+    // Likelihood of phishing, 0 to 1
+    float score = 0.0f;
+    Stage decided_by = Stage::kLocalClassifier;
+    std::vector<std::string> reasons;
+    // Brand the URL imitates, if any
+    std::string target_brand;
+  };
+  using VerdictCallback = base::OnceCallback<void(const Verdict&)>;
+
+  // Result of an AI stage: a score from 0 to 1, or negative if the stage
+  // could not decide
+  using AnalysisCallback =
+      base::OnceCallback<void(float score,
+                              const std::vector<std::string>& reasons)>;
+  // An AI stage, given the URL and the page content or screenshot
+  using AnalysisStage =
+      base::RepeatingCallback<void(const std::string& url,
+                                   const std::string& input,
+                                   AnalysisCallback callback)>;
+
+  // Lexical features of a URL, the classifier's input
+  struct UrlFeatures {
+    bool uses_https = false;
+    bool host_is_ip = false;
+    bool has_user_info = false;
+    bool has_punycode = false;
+    bool has_suspicious_tld = false;
+    size_t host_length = 0;
+    size_t label_count = 0;
+    size_t hyphen_count = 0;
+    size_t digit_count = 0;
+    size_t keyword_count = 0;
+    // Set when the host imitates a protected brand
+    std::string imitated_brand;
+    int brand_distance = 0;
+  };
+
+  // Default thresholds on the local score
+  static constexpr float kDefaultBenignBelow = 0.15f;
+  static constexpr float kDefaultPhishingFrom = 0.85f;
+  // Share of the AI stages in the final score of an ambiguous page
+  static constexpr float kAIWeight = 0.7f;
+
+  PhishingTriage();
+  ~PhishingTriage();
+
+  PhishingTriage(const PhishingTriage&) = delete;
+  PhishingTriage& operator=(const PhishingTriage&) = delete;
+
+  // Lists and index consulted by the local stages; each may be null and
+  // must outlive this
+  void SetPhishingList(const PhishingDomainSet* phishing_list);
+  void SetAllowlist(const PhishingDomainSet* allowlist);
+  void SetBrandIndex(const BrandSimilarityIndex* brand_index);
+
+  // AI stages for ambiguous pages. Without any, ambiguous pages are
+  // decided on the local score alone.
+  void SetContentStage(AnalysisStage stage);
+  void SetVisualStage(AnalysisStage stage);
+
+  // Local scores below |benign_below| are benign and from |phishing_from|
+  // phishing without asking the AI stages
+  void SetThresholds(float benign_below, float phishing_from);
+
+  // Decide on the page at |url|. |callback| runs before this returns
+  // unless the page needs the AI stages.
+  void Triage(const std::string& url,
+              const std::string& page_content,
+              const std::string& page_screenshot,
+              VerdictCallback callback);
+
+  // Pages decided by |stage| so far
+  size_t GetDecisionCount(Stage stage) const;
+
+  // Lexical features of |url|, with brand imitation looked up in
+  // |brand_index| if not null
+  static UrlFeatures ExtractUrlFeatures(std::string_view url,
+                                        const BrandSimilarityIndex* brand_index);
+
+  // Local classifier score of |features|, 0 to 1
+  static float ScoreUrlFeatures(const UrlFeatures& features);
+
+  // Host of |url|, lowercase and without port or trailing dot
+  static std::string GetHost(std::string_view url);
+
+ private:
+  // A page waiting for its AI stages
+  struct PendingAnalysis {
+    PendingAnalysis();
+    PendingAnalysis(PendingAnalysis&&);
+    PendingAnalysis& operator=(PendingAnalysis&&);
+    ~PendingAnalysis();
+
+    Verdict verdict;
+    float local_score = 0.0f;
+    int stages_left = 0;
+    float ai_score_sum = 0.0f;
+    int ai_score_count = 0;
+    VerdictCallback callback;
+  };
+
+  void OnAnalysisDone(int id,
+                      const char* stage_name,
+                      float score,
+                      const std::vector<std::string>& reasons);
+  void Decide(Verdict verdict, VerdictCallback callback);
+
+  const PhishingDomainSet* phishing_list_ = nullptr;
+  const PhishingDomainSet* allowlist_ = nullptr;
+  const BrandSimilarityIndex* brand_index_ = nullptr;
+  AnalysisStage content_stage_;
+  AnalysisStage visual_stage_;
+  float benign_below_ = kDefaultBenignBelow;
+  float phishing_from_ = kDefaultPhishingFrom;
+
+  int next_analysis_id_ = 0;
+  std::map<int, PendingAnalysis> pending_;
+  std::array<size_t, kStageCount> decision_counts_{};
+
+  base::WeakPtrFactory<PhishingTriage> weak_ptr_factory_{this};
+};
+
+}  // namespace security
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_SECURITY_PHISHING_TRIAGE_H_
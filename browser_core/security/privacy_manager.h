@@ -14,6 +14,12 @@ namespace browser_core {
 namespace security {
 
 // PrivacyManager handles privacy-related features in the browser.
+//
+// Tracker blocks, exceptions and cookie policies are consulted for every
+// request a page makes, so they are kept in a PrivacyRuleTable: one
+// suffix trie answering all three in a single allocation-free walk of the
+// host's labels. Changes build a new table that replaces the current one
+// atomically, so checks on other threads never wait for an update.
 class PrivacyManager {
  public:
   // Privacy protection levels
@@ -95,7 +101,7 @@ class PrivacyManager {
   void ClearLocalStorageForDomain(const std::string& domain);
 
  private:
-  // Private implementation
+  // Private implementation; publishes the rules through a PrivacyRules
   class Impl;
   std::unique_ptr<Impl> impl_;
 };
@@ -0,0 +1,194 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/security/privacy_rule_table.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <utility>
+
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+
+namespace browser_core {
+namespace security {
+
+namespace {
+
+constexpr uint8_t kCookieRules = PrivacyRuleTable::kAllowCookies |
+                                 PrivacyRuleTable::kBlockCookies;
+
+std::string_view TrimTrailingDots(std::string_view domain) {
+  while (!domain.empty() && domain.back() == '.') {
+    domain.remove_suffix(1);
+  }
+  return domain;
+}
+
+}  // namespace
+
+PrivacyRuleTable::PrivacyRuleTable() = default;
+PrivacyRuleTable::~PrivacyRuleTable() = default;
+
+// static
+scoped_refptr<const PrivacyRuleTable> PrivacyRuleTable::Create(
+    std::vector<Entry> entries) {
+  auto table = base::WrapRefCounted(new PrivacyRuleTable());
+
+  std::map<std::string, Entry> merged;
+  for (Entry& entry : entries) {
+    std::string domain =
+        base::ToLowerASCII(TrimTrailingDots(entry.domain));
+    if (domain.empty() || entry.rules == 0) {
+      continue;
+    }
+    Entry& target = merged[domain];
+    target.domain = domain;
+    if (entry.rules & kCookieRules) {
+      target.rules &= ~kCookieRules;
+    }
+    target.rules |= entry.rules;
+    if (entry.rules & kBlockTracker) {
+      target.tracker_type = entry.tracker_type;
+    }
+  }
+
+  // The trie, as nested maps first
+  struct BuildNode {
+    std::map<std::string, size_t> children;
+    uint8_t rules = 0;
+    uint8_t tracker_type = 0;
+  };
+  std::vector<BuildNode> build_nodes(1);
+  for (auto& [domain, entry] : merged) {
+    std::vector<std::string_view> labels = base::SplitStringPiece(
+        domain, ".", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
+    size_t node = 0;
+    for (auto label = labels.rbegin(); label != labels.rend(); ++label) {
+      auto [it, inserted] = build_nodes[node].children.emplace(
+          std::string(*label), build_nodes.size());
+      if (inserted) {
+        build_nodes.emplace_back();
+      }
+      node = it->second;
+    }
+    build_nodes[node].rules = entry.rules;
+    build_nodes[node].tracker_type = entry.tracker_type;
+    table->entries_.push_back(std::move(entry));
+  }
+
+  // Flattened breadth first, each node's edges together and sorted by
+  // label hash
+  table->nodes_.resize(build_nodes.size());
+  std::deque<std::pair<size_t, uint32_t>> queue = {{0, 0}};
+  uint32_t next_index = 1;
+  while (!queue.empty()) {
+    auto [build_index, index] = queue.front();
+    queue.pop_front();
+    const BuildNode& build_node = build_nodes[build_index];
+    Node& node = table->nodes_[index];
+    node.rules = build_node.rules;
+    node.tracker_type = build_node.tracker_type;
+    node.first_edge = static_cast<uint32_t>(table->edges_.size());
+    node.edge_count = static_cast<uint32_t>(build_node.children.size());
+    for (const auto& [label, child] : build_node.children) {
+      Edge edge;
+      edge.label_hash = HashLabel(label);
+      edge.label_offset = static_cast<uint32_t>(table->labels_.size());
+      edge.label_length = static_cast<uint32_t>(label.size());
+      edge.child = next_index++;
+      table->labels_.append(label);
+      table->edges_.push_back(edge);
+      queue.emplace_back(child, edge.child);
+    }
+    std::sort(table->edges_.begin() + node.first_edge, table->edges_.end(),
+              [](const Edge& a, const Edge& b) {
+                return a.label_hash < b.label_hash;
+              });
+  }
+  return table;
+}
+
+PrivacyRuleTable::Match PrivacyRuleTable::Lookup(std::string_view host) const {
+  Match match;
+  std::string_view rest = TrimTrailingDots(host);
+  const Node* node = &nodes_[0];
+  while (!rest.empty() && node->edge_count > 0) {
+    size_t dot = rest.rfind('.');
+    std::string_view label =
+        dot == std::string_view::npos ? rest : rest.substr(dot + 1);
+    rest = dot == std::string_view::npos ? std::string_view()
+                                         : rest.substr(0, dot);
+    uint32_t child = FindChild(*node, label);
+    if (child == 0) {
+      break;
+    }
+    node = &nodes_[child];
+
+    match.rules |= node->rules & ~kCookieRules;
+    if (node->rules & kBlockTracker) {
+      match.tracker_type = node->tracker_type;
+    }
+    // The most specific cookie rule wins
+    if (node->rules & kCookieRules) {
+      match.rules = (match.rules & ~kCookieRules) | (node->rules & kCookieRules);
+      match.cookies_allowed = !(node->rules & kBlockCookies);
+    }
+  }
+  return match;
+}
+
+// static
+uint64_t PrivacyRuleTable::HashLabel(std::string_view label) {
+  // FNV-1a
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (char c : label) {
+    hash ^= static_cast<uint8_t>(base::ToLowerASCII(c));
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+uint32_t PrivacyRuleTable::FindChild(const Node& node,
+                                     std::string_view label) const {
+  uint64_t hash = HashLabel(label);
+  auto begin = edges_.begin() + node.first_edge;
+  auto end = begin + node.edge_count;
+  for (auto it = std::lower_bound(begin, end, hash,
+                                  [](const Edge& edge, uint64_t hash) {
+                                    return edge.label_hash < hash;
+                                  });
+       it != end && it->label_hash == hash; ++it) {
+    std::string_view stored(labels_.data() + it->label_offset,
+                            it->label_length);
+    if (base::EqualsCaseInsensitiveASCII(stored, label)) {
+      return it->child;
+    }
+  }
+  return 0;
+}
+
+PrivacyRules::PrivacyRules() : table_(PrivacyRuleTable::Create({})) {}
+
+PrivacyRules::~PrivacyRules() = default;
+
+scoped_refptr<const PrivacyRuleTable> PrivacyRules::Get() const {
+  base::AutoLock lock(lock_);
+  return table_;
+}
+
+void PrivacyRules::Replace(scoped_refptr<const PrivacyRuleTable> table) {
+  base::AutoLock lock(lock_);
+  // The old table is released after the lock, if this held the last
+  // reference
+  std::swap(table_, table);
+}
+
+PrivacyRuleTable::Match PrivacyRules::Lookup(std::string_view host) const {
+  return Get()->Lookup(host);
+}
+
+}  // namespace security
+}  // namespace browser_core
@@ -0,0 +1,139 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_SECURITY_PRIVACY_RULE_TABLE_H_
+#define BROWSER_CORE_SECURITY_PRIVACY_RULE_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+namespace browser_core {
+namespace security {
+
+// PrivacyRuleTable holds the per-domain privacy rules consulted for every
+// request a page makes: blocked trackers, exceptions and cookie policies.
+// A rule for a domain applies to it and every host under it.
+//
+// The rules are a trie of domain labels read right to left ("com", then
+// "example", then "ads"), flattened into arrays with each node's edges
+// sorted by label hash. A lookup walks the host's labels from the last
+// one, in steps of one binary search each, hashing and comparing labels in
+// place, so it costs O(label count) and allocates nothing. All rule kinds
+// share the trie and one walk answers them all.
+//
+// Tables are immutable: updates build a new table from entries() and
+// publish it through a PrivacyRules, so lookups on any thread never see a
+// table half built.
+class PrivacyRuleTable : public base::RefCountedThreadSafe<PrivacyRuleTable> {
+ public:
+  enum Rule : uint8_t {
+    kBlockTracker = 1 << 0,
+    kException = 1 << 1,
+    kAllowCookies = 1 << 2,
+    kBlockCookies = 1 << 3,
+  };
+
+  struct Entry {
+    std::string domain;
+    // Rule bits
+    uint8_t rules = 0;
+    // Caller's category of the tracker, with kBlockTracker
+    uint8_t tracker_type = 0;
+  };
+
+  struct Match {
+    // Rules of every domain the host is, or is under, combined
+    uint8_t rules = 0;
+    // Of the most specific tracker rule
+    uint8_t tracker_type = 0;
+    // Whether the most specific cookie rule allows cookies; only
+    // meaningful with kAllowCookies or kBlockCookies in |rules|
+    bool cookies_allowed = false;
+
+    bool Has(Rule rule) const { return (rules & rule) != 0; }
+  };
+
+  // Build a table of |entries|. Domains are compared lowercase and
+  // without a trailing dot; the rules of repeated domains are combined,
+  // a later cookie rule replacing an earlier one.
+  static scoped_refptr<const PrivacyRuleTable> Create(
+      std::vector<Entry> entries);
+
+  PrivacyRuleTable(const PrivacyRuleTable&) = delete;
+  PrivacyRuleTable& operator=(const PrivacyRuleTable&) = delete;
+
+  Match Lookup(std::string_view host) const;
+
+  // The entries of the table, one per domain, sorted by domain
+  const std::vector<Entry>& entries() const { return entries_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<PrivacyRuleTable>;
+
+  struct Node {
+    uint32_t first_edge = 0;
+    uint32_t edge_count = 0;
+    uint8_t rules = 0;
+    uint8_t tracker_type = 0;
+  };
+
+  struct Edge {
+    uint64_t label_hash;
+    uint32_t label_offset;
+    uint32_t label_length;
+    uint32_t child;
+  };
+
+  PrivacyRuleTable();
+  ~PrivacyRuleTable();
+
+  // Hash of |label|, lowercase
+  static uint64_t HashLabel(std::string_view label);
+
+  // Child of |node| for |label|, or 0 if none
+  uint32_t FindChild(const Node& node, std::string_view label) const;
+
+  std::vector<Entry> entries_;
+  // Node 0 is the root
+  std::vector<Node> nodes_;
+  std::vector<Edge> edges_;
+  std::string labels_;
+};
+
+// PrivacyRules publishes the current PrivacyRuleTable to lookups on any
+// thread. Readers take a reference under a short lock and look up without
+// it; Replace() swaps in a new table, and the old one lives on until its
+// last reader drops it.
+class PrivacyRules {
+ public:
+  PrivacyRules();
+  ~PrivacyRules();
+
+  PrivacyRules(const PrivacyRules&) = delete;
+  PrivacyRules& operator=(const PrivacyRules&) = delete;
+
+  scoped_refptr<const PrivacyRuleTable> Get() const;
+  void Replace(scoped_refptr<const PrivacyRuleTable> table);
+
+  // Look up |host| in the current table
+  PrivacyRuleTable::Match Lookup(std::string_view host) const;
+
+ private:
+  mutable base::Lock lock_;
+  scoped_refptr<const PrivacyRuleTable> table_ GUARDED_BY(lock_);
+};
+
+}  // namespace security
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_SECURITY_PRIVACY_RULE_TABLE_H_
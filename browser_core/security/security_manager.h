@@ -15,6 +15,8 @@
 namespace browser_core {
 namespace security {
 
+class UrlVerdictCache;
+
 // SecurityManager handles all security-related features in the browser.
 class SecurityManager {
  public:
@@ -73,17 +75,26 @@ class SecurityManager {
   // Initialize the security manager
   bool Initialize();
 
-  // URL security checks
+  // URL security checks. Verdicts are kept in a UrlVerdictCache, so a URL
+  // or host checked recently is answered without running the checks again.
   void CheckURL(const std::string& url, SecurityCheckCallback callback);
   bool IsURLSafe(const std::string& url);
   bool IsURLInSafeBrowsingList(const std::string& url);
 
+  // Drop every cached URL verdict; call whenever a blocklist changes
+  void OnBlocklistsUpdated();
+
+  // Cache of URL verdicts, e.g. for its hit rates
+  const UrlVerdictCache* GetVerdictCache() const;
+
   // Phishing detection
   void DetectPhishing(const std::string& url, 
                     const std::string& page_content,
                     PhishingDetectionCallback callback);
 
-  // Malware scanning
+  // Malware scanning, against signatures through a MalwareScanner.
+  // Downloaded files are scanned in the background in chunks, never
+  // loaded whole, and stay usable meanwhile.
   void ScanForMalware(const std::string& content, 
                     MalwareScanCallback callback);
   void ScanDownloadedFile(const std::string& file_path, 
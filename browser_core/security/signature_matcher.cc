@@ -0,0 +1,163 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/security/signature_matcher.h"
+
+#include <deque>
+#include <map>
+#include <utility>
+
+namespace browser_core {
+namespace security {
+
+SignatureMatcher::SignatureMatcher() = default;
+SignatureMatcher::~SignatureMatcher() = default;
+
+// static
+scoped_refptr<SignatureMatcher> SignatureMatcher::Create(
+    std::vector<Signature> signatures) {
+  auto matcher = base::WrapRefCounted(new SignatureMatcher());
+  signatures.erase(std::remove_if(signatures.begin(), signatures.end(),
+                                  [](const Signature& signature) {
+                                    return signature.pattern.empty();
+                                  }),
+                   signatures.end());
+  matcher->signatures_ = std::move(signatures);
+  const std::vector<Signature>& patterns = matcher->signatures_;
+
+  // Every byte some signature uses is a class of its own; all others
+  // share class 0
+  for (const Signature& signature : patterns) {
+    for (unsigned char c : signature.pattern) {
+      if (matcher->byte_classes_[c] == 0) {
+        matcher->byte_classes_[c] =
+            static_cast<uint16_t>(matcher->class_count_++);
+      }
+    }
+    matcher->max_pattern_length_ =
+        std::max(matcher->max_pattern_length_, signature.pattern.size());
+  }
+
+  // The trie, with each state's own signatures
+  std::vector<std::map<uint16_t, State>> children(1);
+  std::vector<std::vector<uint32_t>> own_outputs(1);
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    State state = kInitialState;
+    for (unsigned char c : patterns[i].pattern) {
+      uint16_t byte_class = matcher->byte_classes_[c];
+      auto it = children[state].find(byte_class);
+      if (it == children[state].end()) {
+        State child = static_cast<State>(children.size());
+        children[state].emplace(byte_class, child);
+        children.emplace_back();
+        own_outputs.emplace_back();
+        state = child;
+      } else {
+        state = it->second;
+      }
+    }
+    own_outputs[state].push_back(static_cast<uint32_t>(i));
+  }
+
+  // Failure and output links, breadth first so that each state's failure
+  // target is done before it
+  size_t state_count = children.size();
+  std::vector<State>& fail = matcher->fail_;
+  std::vector<State>& output_link = matcher->output_link_;
+  fail.assign(state_count, kInitialState);
+  output_link.assign(state_count, kNoState);
+  std::vector<size_t> depth(state_count, 0);
+  std::vector<State> order;
+  order.reserve(state_count);
+  std::deque<State> queue = {kInitialState};
+  while (!queue.empty()) {
+    State state = queue.front();
+    queue.pop_front();
+    order.push_back(state);
+    for (const auto& [byte_class, child] : children[state]) {
+      depth[child] = depth[state] + 1;
+      if (state != kInitialState) {
+        State f = fail[state];
+        while (f != kInitialState && !children[f].count(byte_class)) {
+          f = fail[f];
+        }
+        auto it = children[f].find(byte_class);
+        if (it != children[f].end()) {
+          fail[child] = it->second;
+        }
+      }
+      State f = fail[child];
+      output_link[child] = own_outputs[f].empty() ? output_link[f] : f;
+      queue.push_back(child);
+    }
+  }
+
+  // Full rows for the shallow states, as many as fit the budget.
+  // Breadth first order gives each its failure target's row first.
+  size_t class_count = matcher->class_count_;
+  size_t max_rows =
+      std::max<size_t>(1, kMaxDenseBytes / (class_count * sizeof(uint32_t)));
+  matcher->dense_row_.assign(state_count, kNoRow);
+  for (State state : order) {
+    if (depth[state] > kDenseDepth ||
+        matcher->dense_index_.size() == max_rows) {
+      break;
+    }
+    matcher->dense_row_[state] =
+        static_cast<uint32_t>(matcher->dense_index_.size());
+    matcher->dense_index_.push_back(state);
+  }
+
+  auto encode = [&matcher, &own_outputs, &output_link,
+                 class_count](State state) {
+    uint32_t row = matcher->dense_row_[state];
+    uint32_t value = row != kNoRow
+                         ? static_cast<uint32_t>(row * class_count)
+                         : state | kSparse;
+    if (!own_outputs[state].empty() || output_link[state] != kNoState) {
+      value |= kHasOutput;
+    }
+    return value;
+  };
+
+  // Rows start as a copy of their failure target's
+  matcher->dense_.resize(matcher->dense_index_.size() * class_count,
+                         kInitialState);
+  for (size_t row = 0; row < matcher->dense_index_.size(); ++row) {
+    State state = matcher->dense_index_[row];
+    if (state != kInitialState) {
+      size_t fail_row = matcher->dense_row_[fail[state]];
+      std::copy_n(matcher->dense_.begin() + fail_row * class_count,
+                  class_count, matcher->dense_.begin() + row * class_count);
+    }
+    for (const auto& [byte_class, child] : children[state]) {
+      matcher->dense_[row * class_count + byte_class] = encode(child);
+    }
+  }
+
+  // Own edges for the rest, and the flattened outputs
+  matcher->edge_begin_.reserve(state_count + 1);
+  matcher->output_begin_.reserve(state_count + 1);
+  for (State state = 0; state < state_count; ++state) {
+    matcher->edge_begin_.push_back(
+        static_cast<uint32_t>(matcher->edges_.size()));
+    if (matcher->dense_row_[state] == kNoRow) {
+      for (const auto& [byte_class, child] : children[state]) {
+        matcher->edges_.push_back({byte_class, encode(child)});
+      }
+    }
+    matcher->output_begin_.push_back(
+        static_cast<uint32_t>(matcher->outputs_.size()));
+    matcher->outputs_.insert(matcher->outputs_.end(),
+                             own_outputs[state].begin(),
+                             own_outputs[state].end());
+  }
+  matcher->edge_begin_.push_back(static_cast<uint32_t>(matcher->edges_.size()));
+  matcher->output_begin_.push_back(
+      static_cast<uint32_t>(matcher->outputs_.size()));
+  return matcher;
+}
+
+}  // namespace security
+}  // namespace browser_core
@@ -0,0 +1,197 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_SECURITY_SIGNATURE_MATCHER_H_
+#define BROWSER_CORE_SECURITY_SIGNATURE_MATCHER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
+
+namespace browser_core {
+namespace security {
+
+// SignatureMatcher finds every occurrence of a set of byte signatures in
+// one pass over the data, whatever the number of signatures: an
+// Aho-Corasick automaton.
+//
+// Bytes are mapped to equivalence classes first, bytes no signature
+// tells apart sharing one, so transition rows are as wide as the number
+// of classes rather than 256. States near the root, where scans of
+// ordinary data spend nearly all their time, have a full row, up to
+// kMaxDenseBytes of rows so they stay in cache; a transition to such a
+// state holds the offset of its row, so a step is a single lookup. Deeper
+// states keep only their own edges and fall back along failure links.
+// Transitions also carry a flag for targets with matches, so the scan
+// loop only looks for matches where there are some.
+//
+// Scans can be split: Scan() takes and returns the automaton state, and
+// a chunk scanned from the initial state after the last
+// max_pattern_length() - 1 bytes of the previous chunk finds the same
+// matches ending in it. Immutable once built, so one matcher serves scans
+// on any number of threads.
+class SignatureMatcher : public base::RefCountedThreadSafe<SignatureMatcher> {
+ public:
+  struct Signature {
+    std::string name;
+    // Raw bytes to look for
+    std::string pattern;
+  };
+
+  // Position of a scan in the automaton; opaque
+  using State = uint32_t;
+  static constexpr State kInitialState = 0;
+
+  // Depth up to which states may have a full transition row
+  static constexpr size_t kDenseDepth = 2;
+  // Bytes of full rows at most
+  static constexpr size_t kMaxDenseBytes = 4 * 1024 * 1024;
+
+  // Build the automaton for |signatures|. Empty patterns are ignored.
+  static scoped_refptr<SignatureMatcher> Create(
+      std::vector<Signature> signatures);
+
+  SignatureMatcher(const SignatureMatcher&) = delete;
+  SignatureMatcher& operator=(const SignatureMatcher&) = delete;
+
+  const Signature& signature(size_t index) const { return signatures_[index]; }
+  size_t signature_count() const { return signatures_.size(); }
+  size_t max_pattern_length() const { return max_pattern_length_; }
+  size_t state_count() const { return fail_.size(); }
+  size_t dense_state_count() const { return dense_index_.size(); }
+
+  // Scan |size| bytes at |data| from |state|, calling
+  // |visit(signature_index, end)| for each match, with |end| the offset
+  // just past the match relative to |data|. Stops early if |visit|
+  // returns false. Returns the state to continue with.
+  template <typename Visitor>
+  State Scan(const uint8_t* data,
+             size_t size,
+             State state,
+             Visitor visit) const;
+
+ private:
+  friend class base::RefCountedThreadSafe<SignatureMatcher>;
+
+  // A State, and a stored transition, is the offset of the target's row
+  // in |dense_| if it has one and its index otherwise, with these flags
+  static constexpr uint32_t kHasOutput = 0x80000000u;
+  static constexpr uint32_t kSparse = 0x40000000u;
+  static constexpr uint32_t kValueMask = ~(kHasOutput | kSparse);
+  static constexpr uint32_t kNoRow = UINT32_MAX;
+  static constexpr uint32_t kNoState = UINT32_MAX;
+
+  struct Edge {
+    uint16_t byte_class;
+    uint32_t target;
+  };
+
+  SignatureMatcher();
+  ~SignatureMatcher();
+
+  // Transition from the state without a row at |index| on |byte_class|
+  uint32_t StepSparse(uint32_t index, uint16_t byte_class) const;
+
+  // Index of the state |state|
+  uint32_t GetIndex(State state) const {
+    return (state & kSparse)
+               ? state & kValueMask
+               : dense_index_[(state & kValueMask) / class_count_];
+  }
+
+  // Report the matches of the state at |index|, which has some, ending
+  // at |end|
+  template <typename Visitor>
+  bool VisitOutputs(uint32_t index, size_t end, Visitor& visit) const;
+
+  std::vector<Signature> signatures_;
+  size_t max_pattern_length_ = 0;
+
+  std::array<uint16_t, 256> byte_classes_{};
+  size_t class_count_ = 1;
+
+  // Full rows, and the index of the state of each
+  std::vector<uint32_t> dense_;
+  std::vector<uint32_t> dense_index_;
+
+  // Per state index: its row in |dense_| or kNoRow, its failure link, and
+  // its sorted edges in |edges_| from |edge_begin_[index]| to
+  // |edge_begin_[index + 1]|
+  std::vector<uint32_t> dense_row_;
+  std::vector<uint32_t> fail_;
+  std::vector<uint32_t> edge_begin_;
+  std::vector<Edge> edges_;
+
+  // Per state index: signatures ending there, in |outputs_| from
+  // |output_begin_[index]| to |output_begin_[index + 1]|, and the nearest
+  // state along the failure links with some, or kNoState
+  std::vector<uint32_t> output_begin_;
+  std::vector<uint32_t> outputs_;
+  std::vector<uint32_t> output_link_;
+};
+
+inline uint32_t SignatureMatcher::StepSparse(uint32_t index,
+                                             uint16_t byte_class) const {
+  while (true) {
+    uint32_t row = dense_row_[index];
+    if (row != kNoRow) {
+      return dense_[row * class_count_ + byte_class];
+    }
+    auto begin = edges_.begin() + edge_begin_[index];
+    auto end = edges_.begin() + edge_begin_[index + 1];
+    auto it = std::lower_bound(begin, end, byte_class,
+                               [](const Edge& edge, uint16_t byte_class) {
+                                 return edge.byte_class < byte_class;
+                               });
+    if (it != end && it->byte_class == byte_class) {
+      return it->target;
+    }
+    // Failure links lead to shallower states, and the initial state has a
+    // row
+    index = fail_[index];
+  }
+}
+
+template <typename Visitor>
+bool SignatureMatcher::VisitOutputs(uint32_t index,
+                                    size_t end,
+                                    Visitor& visit) const {
+  for (uint32_t s = index; s != kNoState; s = output_link_[s]) {
+    for (uint32_t i = output_begin_[s]; i < output_begin_[s + 1]; ++i) {
+      if (!visit(static_cast<size_t>(outputs_[i]), end)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename Visitor>
+SignatureMatcher::State SignatureMatcher::Scan(const uint8_t* data,
+                                               size_t size,
+                                               State state,
+                                               Visitor visit) const {
+  for (size_t i = 0; i < size; ++i) {
+    uint16_t byte_class = byte_classes_[data[i]];
+    state = (state & kSparse)
+                ? StepSparse(state & kValueMask, byte_class)
+                : dense_[(state & kValueMask) + byte_class];
+    if ((state & kHasOutput) && !VisitOutputs(GetIndex(state), i + 1, visit)) {
+      break;
+    }
+  }
+  return state;
+}
+
+}  // namespace security
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_SECURITY_SIGNATURE_MATCHER_H_
@@ -0,0 +1,454 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/security/streaming_encryptor.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "asol/core/cancellation_token.h"
+#include "base/barrier_closure.h"
+#include "base/check.h"
+#include "base/files/file.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/task/thread_pool.h"
+#include "base/thread_annotations.h"
+#include "crypto/aead.h"
+#include "crypto/hkdf.h"
+#include "crypto/random.h"
+#include "third_party/boringssl/src/include/openssl/aead.h"
+
+namespace browser_core {
+namespace security {
+
+namespace {
+
+constexpr uint32_t kStreamMagic = 0x4D525453;  // "STRM"
+constexpr uint8_t kStreamVersion = 1;
+
+// Algorithm ids in the header
+constexpr uint8_t kAes256Gcm = 1;
+constexpr uint8_t kChaCha20Poly1305 = 2;
+
+constexpr size_t kSaltSize = 16;
+constexpr size_t kNoncePrefixSize = 7;
+constexpr size_t kNonceSize = 12;
+constexpr size_t kChunkKeySize = 32;
+constexpr char kChunkKeyInfo[] = "streaming-encryptor chunk key";
+
+// Magic, version, algorithm, chunk size, salt, nonce prefix
+constexpr size_t kHeaderSize = 4 + 1 + 1 + 4 + kSaltSize + kNoncePrefixSize;
+constexpr size_t kSealedChunkSize =
+    StreamingEncryptor::kChunkSize + StreamingEncryptor::kTagSize;
+
+// Chunk indices are 32 bits in the nonce
+constexpr uint64_t kMaxChunkCount = uint64_t{1} << 32;
+
+template <typename T>
+void Append(T value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T Read(const char* data) {
+  T value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+// Read |size| bytes at |offset| of |file| into |data|
+bool ReadFully(base::File& file, uint64_t offset, char* data, size_t size) {
+  while (size > 0) {
+    int read = file.Read(static_cast<int64_t>(offset), data,
+                         static_cast<int>(size));
+    if (read <= 0) {
+      // The file shrank or could not be read
+      return false;
+    }
+    offset += read;
+    data += read;
+    size -= read;
+  }
+  return true;
+}
+
+const base::TaskTraits kWorkerTraits = {
+    base::MayBlock(), base::WithBaseSyncPrimitives(),
+    base::TaskPriority::USER_VISIBLE,
+    base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN};
+
+}  // namespace
+
+// An encryption or decryption, shared by the workers processing its chunks
+class StreamingEncryptor::Job
+    : public base::RefCountedThreadSafe<StreamingEncryptor::Job> {
+ public:
+  Job(bool encrypt, base::FilePath path, std::string key, Sink sink)
+      : encrypt_(encrypt),
+        path_(std::move(path)),
+        key_(std::move(key)),
+        sink_(std::move(sink)),
+        window_open_(&lock_) {}
+
+  Job(const Job&) = delete;
+  Job& operator=(const Job&) = delete;
+
+  void Cancel() {
+    cancelled_.store(true, std::memory_order_relaxed);
+    base::AutoLock lock(lock_);
+    window_open_.Broadcast();
+  }
+
+  // Size the stream and derive the chunk key, writing or reading the
+  // header. Runs on a worker before any Run().
+  bool Prepare();
+
+  // Process chunks until none are left or the job stops. Runs on a worker.
+  void Run();
+
+  Result GetResult();
+
+ private:
+  friend class base::RefCountedThreadSafe<Job>;
+  ~Job() = default;
+
+  bool ShouldStop() const {
+    return cancelled_.load(std::memory_order_relaxed) ||
+           failed_.load(std::memory_order_relaxed);
+  }
+
+  void Fail() {
+    failed_.store(true, std::memory_order_relaxed);
+    base::AutoLock lock(lock_);
+    window_open_.Broadcast();
+  }
+
+  bool PrepareEncryption();
+  bool PrepareDecryption(base::File& file);
+
+  // Wait until chunk |index| is within kMaxBufferedChunks of the output.
+  // Returns false if the job stopped.
+  bool WaitForWindow(uint64_t index);
+
+  // Hand |data|, the output of chunk |index|, to the sink once the chunks
+  // before it are written
+  void Output(uint64_t index, std::string data);
+
+  std::string GetNonce(uint64_t index) const;
+
+  const bool encrypt_;
+  const base::FilePath path_;
+  const std::string key_;
+  const Sink sink_;
+
+  // Set by Prepare()
+  crypto::Aead::AeadAlgorithm algorithm_ = crypto::Aead::AES_256_GCM;
+  std::string header_;
+  std::string chunk_key_;
+  uint64_t source_length_ = 0;
+  uint64_t chunk_count_ = 0;
+
+  std::atomic<uint64_t> next_chunk_{0};
+  std::atomic<uint64_t> plaintext_size_{0};
+  std::atomic<bool> cancelled_{false};
+  std::atomic<bool> failed_{false};
+
+  base::Lock lock_;
+  // Signalled when output advances or the job stops
+  base::ConditionVariable window_open_;
+  uint64_t written_chunks_ GUARDED_BY(lock_) = 0;
+  // Finished chunks waiting for earlier ones
+  std::map<uint64_t, std::string> ready_ GUARDED_BY(lock_);
+  // Whether a worker is writing to the sink
+  bool flushing_ GUARDED_BY(lock_) = false;
+};
+
+bool StreamingEncryptor::Job::Prepare() {
+  if (ShouldStop()) {
+    return false;
+  }
+  base::File file(path_, base::File::FLAG_OPEN | base::File::FLAG_READ |
+                             base::File::FLAG_WIN_SHARE_DELETE);
+  int64_t length = file.IsValid() ? file.GetLength() : -1;
+  if (length < 0) {
+    return false;
+  }
+  source_length_ = length;
+  return encrypt_ ? PrepareEncryption() : PrepareDecryption(file);
+}
+
+bool StreamingEncryptor::Job::PrepareEncryption() {
+  // An empty source still has one, empty, chunk, so that the stream
+  // carries a last chunk
+  chunk_count_ = std::max<uint64_t>(
+      1, (source_length_ + kChunkSize - 1) / kChunkSize);
+  if (chunk_count_ > kMaxChunkCount) {
+    return false;
+  }
+
+  // The AES instructions make AES-GCM the faster of the two, and
+  // constant time
+  algorithm_ = EVP_has_aes_hardware() ? crypto::Aead::AES_256_GCM
+                                      : crypto::Aead::CHACHA20_POLY1305;
+  char salt[kSaltSize];
+  char nonce_prefix[kNoncePrefixSize];
+  crypto::RandBytes(salt, sizeof(salt));
+  crypto::RandBytes(nonce_prefix, sizeof(nonce_prefix));
+
+  header_.reserve(kHeaderSize);
+  Append(kStreamMagic, &header_);
+  Append(kStreamVersion, &header_);
+  Append(algorithm_ == crypto::Aead::AES_256_GCM ? kAes256Gcm
+                                                 : kChaCha20Poly1305,
+         &header_);
+  Append(static_cast<uint32_t>(kChunkSize), &header_);
+  header_.append(salt, sizeof(salt));
+  header_.append(nonce_prefix, sizeof(nonce_prefix));
+  chunk_key_ = crypto::HkdfSha256(key_, std::string_view(salt, sizeof(salt)),
+                                  kChunkKeyInfo, kChunkKeySize);
+  // Workers start after this returns
+  return sink_.Run(header_);
+}
+
+bool StreamingEncryptor::Job::PrepareDecryption(base::File& file) {
+  header_.resize(kHeaderSize);
+  if (source_length_ < kHeaderSize + kTagSize ||
+      !ReadFully(file, 0, header_.data(), header_.size())) {
+    return false;
+  }
+  const char* data = header_.data();
+  uint8_t algorithm = Read<uint8_t>(data + 5);
+  if (Read<uint32_t>(data) != kStreamMagic ||
+      Read<uint8_t>(data + 4) != kStreamVersion ||
+      (algorithm != kAes256Gcm && algorithm != kChaCha20Poly1305) ||
+      Read<uint32_t>(data + 6) != kChunkSize) {
+    return false;
+  }
+  algorithm_ = algorithm == kAes256Gcm ? crypto::Aead::AES_256_GCM
+                                       : crypto::Aead::CHACHA20_POLY1305;
+
+  uint64_t body_length = source_length_ - kHeaderSize;
+  chunk_count_ = (body_length + kSealedChunkSize - 1) / kSealedChunkSize;
+  uint64_t last_length = body_length - (chunk_count_ - 1) * kSealedChunkSize;
+  // Only a sole chunk may be empty
+  if (chunk_count_ > kMaxChunkCount ||
+      (chunk_count_ > 1 && last_length <= kTagSize) ||
+      last_length < kTagSize) {
+    return false;
+  }
+  chunk_key_ = crypto::HkdfSha256(
+      key_, std::string_view(data + 10, kSaltSize), kChunkKeyInfo,
+      kChunkKeySize);
+  return true;
+}
+
+void StreamingEncryptor::Job::Run() {
+  if (ShouldStop()) {
+    return;
+  }
+  base::File file(path_, base::File::FLAG_OPEN | base::File::FLAG_READ |
+                             base::File::FLAG_WIN_SHARE_DELETE);
+  if (!file.IsValid()) {
+    Fail();
+    return;
+  }
+  crypto::Aead aead(algorithm_);
+  aead.Init(&chunk_key_);
+
+  uint64_t base_offset = encrypt_ ? 0 : kHeaderSize;
+  size_t stride = encrypt_ ? kChunkSize : kSealedChunkSize;
+  std::string input;
+  while (!ShouldStop()) {
+    uint64_t index = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= chunk_count_ || !WaitForWindow(index)) {
+      break;
+    }
+    uint64_t offset = base_offset + index * stride;
+    input.resize(std::min<uint64_t>(stride, source_length_ - offset));
+    if (!ReadFully(file, offset, input.data(), input.size())) {
+      Fail();
+      break;
+    }
+
+    std::string output;
+    std::string nonce = GetNonce(index);
+    bool processed = encrypt_
+                         ? aead.Seal(input, nonce, header_, &output)
+                         : aead.Open(input, nonce, header_, &output);
+    if (!processed) {
+      Fail();
+      break;
+    }
+    plaintext_size_.fetch_add(encrypt_ ? input.size() : output.size(),
+                              std::memory_order_relaxed);
+    Output(index, std::move(output));
+  }
+}
+
+StreamingEncryptor::Result StreamingEncryptor::Job::GetResult() {
+  Result result;
+  base::AutoLock lock(lock_);
+  result.success = !ShouldStop() && written_chunks_ == chunk_count_;
+  result.plaintext_size = plaintext_size_.load(std::memory_order_relaxed);
+  return result;
+}
+
+bool StreamingEncryptor::Job::WaitForWindow(uint64_t index) {
+  base::AutoLock lock(lock_);
+  // The chunk at |written_chunks_| was claimed before |index| by a worker
+  // not waiting here, so the window always moves on
+  while (!ShouldStop() && index >= written_chunks_ + kMaxBufferedChunks) {
+    window_open_.Wait();
+  }
+  return !ShouldStop();
+}
+
+void StreamingEncryptor::Job::Output(uint64_t index, std::string data) {
+  base::AutoLock lock(lock_);
+  ready_.emplace(index, std::move(data));
+  if (flushing_) {
+    // The flushing worker picks it up
+    return;
+  }
+  flushing_ = true;
+  while (!ShouldStop()) {
+    auto it = ready_.find(written_chunks_);
+    if (it == ready_.end()) {
+      break;
+    }
+    std::string chunk = std::move(it->second);
+    ready_.erase(it);
+    bool accepted;
+    {
+      base::AutoUnlock unlock(lock_);
+      accepted = sink_.Run(chunk);
+    }
+    if (!accepted) {
+      failed_.store(true, std::memory_order_relaxed);
+      break;
+    }
+    ++written_chunks_;
+    window_open_.Broadcast();
+  }
+  flushing_ = false;
+  if (ShouldStop()) {
+    ready_.clear();
+    window_open_.Broadcast();
+  }
+}
+
+std::string StreamingEncryptor::Job::GetNonce(uint64_t index) const {
+  std::string nonce(header_.data() + kHeaderSize - kNoncePrefixSize,
+                    kNoncePrefixSize);
+  uint32_t counter = static_cast<uint32_t>(index);
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    nonce.push_back(static_cast<char>(counter >> shift));
+  }
+  nonce.push_back(index + 1 == chunk_count_ ? 1 : 0);
+  DCHECK_EQ(nonce.size(), kNonceSize);
+  return nonce;
+}
+
+StreamingEncryptor::PendingJob::PendingJob() = default;
+StreamingEncryptor::PendingJob::PendingJob(PendingJob&&) = default;
+StreamingEncryptor::PendingJob& StreamingEncryptor::PendingJob::operator=(
+    PendingJob&&) = default;
+StreamingEncryptor::PendingJob::~PendingJob() = default;
+
+StreamingEncryptor::StreamingEncryptor() = default;
+
+StreamingEncryptor::~StreamingEncryptor() {
+  for (auto& [job_id, pending] : pending_jobs_) {
+    pending.job->Cancel();
+  }
+}
+
+void StreamingEncryptor::EncryptFile(
+    const base::FilePath& source,
+    std::string key,
+    Sink sink,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    DoneCallback callback) {
+  Start(base::MakeRefCounted<Job>(/*encrypt=*/true, source, std::move(key),
+                                  std::move(sink)),
+        std::move(cancellation_token), std::move(callback));
+}
+
+void StreamingEncryptor::DecryptFile(
+    const base::FilePath& source,
+    std::string key,
+    Sink sink,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    DoneCallback callback) {
+  Start(base::MakeRefCounted<Job>(/*encrypt=*/false, source, std::move(key),
+                                  std::move(sink)),
+        std::move(cancellation_token), std::move(callback));
+}
+
+void StreamingEncryptor::Start(
+    scoped_refptr<Job> job,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    DoneCallback callback) {
+  int job_id = next_job_id_++;
+  PendingJob& pending = pending_jobs_[job_id];
+  pending.job = std::move(job);
+  if (cancellation_token) {
+    if (cancellation_token->IsCancelled()) {
+      pending.job->Cancel();
+    } else {
+      pending.cancel_subscription = cancellation_token->AddCancelCallback(
+          base::BindOnce(&Job::Cancel, pending.job));
+    }
+  }
+
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, kWorkerTraits, base::BindOnce(&Job::Prepare, pending.job),
+      base::BindOnce(&StreamingEncryptor::OnJobPrepared,
+                     weak_ptr_factory_.GetWeakPtr(), job_id,
+                     std::move(callback)));
+}
+
+void StreamingEncryptor::OnJobPrepared(int job_id,
+                                       DoneCallback callback,
+                                       bool prepared) {
+  auto it = pending_jobs_.find(job_id);
+  if (it == pending_jobs_.end()) {
+    return;
+  }
+  if (!prepared) {
+    pending_jobs_.erase(it);
+    std::move(callback).Run(Result());
+    return;
+  }
+
+  base::RepeatingClosure done = base::BarrierClosure(
+      kMaxParallelChunks,
+      base::BindOnce(&StreamingEncryptor::OnJobFinished,
+                     weak_ptr_factory_.GetWeakPtr(), job_id,
+                     std::move(callback)));
+  for (size_t i = 0; i < kMaxParallelChunks; ++i) {
+    // Workers that find no chunk left finish at once
+    base::ThreadPool::PostTaskAndReply(
+        FROM_HERE, kWorkerTraits, base::BindOnce(&Job::Run, it->second.job),
+        done);
+  }
+}
+
+void StreamingEncryptor::OnJobFinished(int job_id, DoneCallback callback) {
+  auto it = pending_jobs_.find(job_id);
+  if (it == pending_jobs_.end()) {
+    return;
+  }
+  scoped_refptr<Job> job = std::move(it->second.job);
+  pending_jobs_.erase(it);
+  std::move(callback).Run(job->GetResult());
+}
+
+}  // namespace security
+}  // namespace browser_core
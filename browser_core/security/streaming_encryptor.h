@@ -0,0 +1,135 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_SECURITY_STREAMING_ENCRYPTOR_H_
+#define BROWSER_CORE_SECURITY_STREAMING_ENCRYPTOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <string_view>
+
+#include "base/callback.h"
+#include "base/callback_list.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+
+namespace asol {
+namespace core {
+class CancellationToken;
+}  // namespace core
+}  // namespace asol
+
+namespace browser_core {
+namespace security {
+
+// StreamingEncryptor encrypts and decrypts files of any size as a stream
+// of independently sealed chunks, on several thread pool workers, handing
+// the output to a sink as it is produced, so neither the whole plaintext
+// nor the whole ciphertext is ever in memory.
+//
+// A stream is a header followed by the plaintext in chunks of kChunkSize,
+// the last one shorter, each sealed with its 16 byte tag. The header holds
+// a random salt, from which the chunk key is derived from the caller's
+// key, and a random nonce prefix; a chunk's nonce is the prefix, the
+// chunk's index and a flag set on the last chunk only, and the header is
+// the additional data of every chunk. Chunks therefore cannot be
+// reordered, dropped, truncated away or moved between streams without
+// failing to open. Chunks are sealed with AES-256-GCM where the CPU has
+// AES instructions and with ChaCha20-Poly1305 otherwise, which is faster
+// in software; the header records which.
+//
+// Every chunk has a fixed place in either stream, so workers claim chunks
+// in any order and read them with positional reads. Output reaches the
+// sink in order: a finished chunk waits until those before it are
+// written, and workers stop claiming chunks more than kMaxBufferedChunks
+// ahead of the last one written, which bounds memory.
+//
+// Must be used on one sequence; done callbacks run there.
+class StreamingEncryptor {
+ public:
+  // Plaintext bytes per chunk
+  static constexpr size_t kChunkSize = 1024 * 1024;
+  static constexpr size_t kTagSize = 16;
+  static constexpr size_t kMaxParallelChunks = 4;
+  static constexpr size_t kMaxBufferedChunks = 8;
+
+  // Receives the output in order, on a worker, one call at a time.
+  // Returns false to abort the operation.
+  using Sink = base::RepeatingCallback<bool(std::string_view)>;
+
+  struct Result {
+    // False if the operation was cancelled or aborted by the sink, the
+    // source could not be read or, when decrypting, is not a stream
+    // sealed with the key or was tampered with
+    bool success = false;
+    // Plaintext bytes processed
+    uint64_t plaintext_size = 0;
+  };
+  using DoneCallback = base::OnceCallback<void(const Result&)>;
+
+  StreamingEncryptor();
+  ~StreamingEncryptor();
+
+  StreamingEncryptor(const StreamingEncryptor&) = delete;
+  StreamingEncryptor& operator=(const StreamingEncryptor&) = delete;
+
+  // Encrypt the file at |source| under |key|, a secret key such as one
+  // derived from the sync passphrase, into |sink|. |cancellation_token|
+  // may be null. Operations still running when this is destroyed are
+  // cancelled and their callbacks never run.
+  void EncryptFile(
+      const base::FilePath& source,
+      std::string key,
+      Sink sink,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      DoneCallback callback);
+
+  // Decrypt the stream in the file at |source| under |key| into |sink|.
+  // The sink may already have received part of the plaintext when a later
+  // chunk fails to open; callers should discard it unless |success|.
+  void DecryptFile(
+      const base::FilePath& source,
+      std::string key,
+      Sink sink,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      DoneCallback callback);
+
+  // Operations started and not finished
+  size_t GetPendingCount() const { return pending_jobs_.size(); }
+
+ private:
+  class Job;
+
+  struct PendingJob {
+    PendingJob();
+    PendingJob(PendingJob&&);
+    PendingJob& operator=(PendingJob&&);
+    ~PendingJob();
+
+    scoped_refptr<Job> job;
+    // Forwards the caller's cancellation to the workers
+    base::CallbackListSubscription cancel_subscription;
+  };
+
+  void Start(
+      scoped_refptr<Job> job,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      DoneCallback callback);
+  void OnJobPrepared(int job_id, DoneCallback callback, bool prepared);
+  void OnJobFinished(int job_id, DoneCallback callback);
+
+  int next_job_id_ = 0;
+  std::map<int, PendingJob> pending_jobs_;
+
+  base::WeakPtrFactory<StreamingEncryptor> weak_ptr_factory_{this};
+};
+
+}  // namespace security
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_SECURITY_STREAMING_ENCRYPTOR_H_
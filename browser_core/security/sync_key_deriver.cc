@@ -0,0 +1,269 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/security/sync_key_deriver.h"
+
+#include <utility>
+
+#include "base/memory/page_size.h"
+#include "base/memory/ptr_util.h"
+#include "base/task/thread_pool.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
+#include "crypto/random.h"
+#include "third_party/boringssl/src/include/openssl/evp.h"
+#include "third_party/boringssl/src/include/openssl/mem.h"
+
+#if BUILDFLAG(IS_POSIX)
+#include <sys/mman.h>
+#elif BUILDFLAG(IS_WIN)
+#include <windows.h>
+#endif
+
+namespace browser_core {
+namespace security {
+
+namespace {
+
+// Input of the derivation that times this device
+constexpr char kTuningPassphrase[] = "sync key deriver tuning";
+constexpr char kTuningSalt[] = "0123456789abcdef";
+
+// Account params come from the server; a cost beyond these would only
+// stall the device
+bool AreParamsValid(const SyncKeyDeriver::KdfParams& params) {
+  return params.log2_n >= SyncKeyDeriver::kMinLog2N &&
+         params.log2_n <= SyncKeyDeriver::kMaxLog2N && params.r >= 1 &&
+         params.r <= 16 && params.p >= 1 && params.p <= 4;
+}
+
+bool RunScrypt(std::string_view passphrase,
+               std::string_view salt,
+               const SyncKeyDeriver::KdfParams& params,
+               uint8_t* out,
+               size_t out_size) {
+  // scrypt needs 128 * r * N bytes, and a few blocks of 128 * r besides
+  size_t max_memory =
+      size_t{128} * params.r * ((size_t{1} << params.log2_n) + params.p + 2);
+  return EVP_PBE_scrypt(passphrase.data(), passphrase.size(),
+                        reinterpret_cast<const uint8_t*>(salt.data()),
+                        salt.size(), uint64_t{1} << params.log2_n, params.r,
+                        params.p, max_memory, out, out_size) == 1;
+}
+
+// log2(N) for which a derivation takes about kTargetDerivationTime here
+uint32_t TuneLog2N() {
+  SyncKeyDeriver::KdfParams params;
+  params.log2_n = SyncKeyDeriver::kMinLog2N;
+  uint8_t key[SyncKeyDeriver::kKeySize];
+  base::TimeTicks start = base::TimeTicks::Now();
+  if (!RunScrypt(kTuningPassphrase, kTuningSalt, params, key, sizeof(key))) {
+    return SyncKeyDeriver::kMinLog2N;
+  }
+  // The time grows linearly with N
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  uint32_t log2_n = SyncKeyDeriver::kMinLog2N;
+  while (log2_n < SyncKeyDeriver::kMaxLog2N &&
+         elapsed * 2 <= SyncKeyDeriver::kTargetDerivationTime) {
+    elapsed *= 2;
+    ++log2_n;
+  }
+  return log2_n;
+}
+
+}  // namespace
+
+// Result of a derivation, passed back from the KDF sequence
+struct SyncKeyDeriver::Derivation {
+  // Null on failure
+  std::unique_ptr<LockedKey> key;
+  KdfParams params;
+  // Set if the derivation tuned the cost
+  std::optional<uint32_t> tuned_log2_n;
+};
+
+// static
+std::unique_ptr<LockedKey> LockedKey::Create(size_t size) {
+  size_t page_size = base::GetPageSize();
+  size_t mapping_size = (size + page_size - 1) / page_size * page_size;
+#if BUILDFLAG(IS_POSIX)
+  void* pages = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (pages == MAP_FAILED) {
+    return nullptr;
+  }
+  bool is_locked = mlock(pages, mapping_size) == 0;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  madvise(pages, mapping_size, MADV_DONTDUMP);
+#endif
+#elif BUILDFLAG(IS_WIN)
+  void* pages = VirtualAlloc(nullptr, mapping_size, MEM_COMMIT | MEM_RESERVE,
+                             PAGE_READWRITE);
+  if (!pages) {
+    return nullptr;
+  }
+  bool is_locked = VirtualLock(pages, mapping_size) != 0;
+#endif
+  // Fresh pages are zeroed
+  return base::WrapUnique(new LockedKey(static_cast<uint8_t*>(pages), size,
+                                        mapping_size, is_locked));
+}
+
+LockedKey::LockedKey(uint8_t* data,
+                     size_t size,
+                     size_t mapping_size,
+                     bool is_locked)
+    : data_(data),
+      size_(size),
+      mapping_size_(mapping_size),
+      is_locked_(is_locked) {}
+
+LockedKey::~LockedKey() {
+  OPENSSL_cleanse(data_, mapping_size_);
+#if BUILDFLAG(IS_POSIX)
+  if (is_locked_) {
+    munlock(data_, mapping_size_);
+  }
+  munmap(data_, mapping_size_);
+#elif BUILDFLAG(IS_WIN)
+  if (is_locked_) {
+    VirtualUnlock(data_, mapping_size_);
+  }
+  VirtualFree(data_, 0, MEM_RELEASE);
+#endif
+}
+
+bool LockedKey::Equals(const LockedKey& other) const {
+  return size_ == other.size_ && CRYPTO_memcmp(data_, other.data_, size_) == 0;
+}
+
+SyncKeyDeriver::SyncKeyDeriver(
+    scoped_refptr<base::SequencedTaskRunner> task_runner)
+    : task_runner_(task_runner
+                       ? std::move(task_runner)
+                       : base::ThreadPool::CreateSequencedTaskRunner(
+                             {base::TaskPriority::USER_VISIBLE,
+                              base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})) {
+}
+
+SyncKeyDeriver::~SyncKeyDeriver() = default;
+
+// static
+std::unique_ptr<SyncKeyDeriver::Derivation> SyncKeyDeriver::Derive(
+    std::string passphrase,
+    std::string salt,
+    KdfParams params,
+    bool tune,
+    std::optional<uint32_t> tuned_log2_n) {
+  auto derivation = std::make_unique<Derivation>();
+  if (tune) {
+    if (!tuned_log2_n) {
+      tuned_log2_n = TuneLog2N();
+      derivation->tuned_log2_n = tuned_log2_n;
+    }
+    params.log2_n = *tuned_log2_n;
+  }
+  derivation->params = params;
+
+  std::unique_ptr<LockedKey> key = LockedKey::Create(kKeySize);
+  if (key && RunScrypt(passphrase, salt, params, key->data(), key->size())) {
+    derivation->key = std::move(key);
+  }
+  OPENSSL_cleanse(passphrase.data(), passphrase.size());
+  return derivation;
+}
+
+void SyncKeyDeriver::CreateKey(std::string passphrase,
+                               NewKeyCallback callback) {
+  std::string salt(kSaltSize, '\0');
+  crypto::RandBytes(salt.data(), salt.size());
+  task_runner_->PostTaskAndReplyWithResult(
+      FROM_HERE,
+      base::BindOnce(&SyncKeyDeriver::Derive, std::move(passphrase), salt,
+                     KdfParams(), /*tune=*/true, tuned_log2_n_),
+      base::BindOnce(&SyncKeyDeriver::OnKeyCreated,
+                     weak_ptr_factory_.GetWeakPtr(), salt,
+                     std::move(callback)));
+}
+
+void SyncKeyDeriver::UnlockKey(std::string passphrase,
+                               std::string salt,
+                               const KdfParams& params,
+                               ResultCallback callback) {
+  if (!AreParamsValid(params) || salt.empty()) {
+    OPENSSL_cleanse(passphrase.data(), passphrase.size());
+    std::move(callback).Run(false);
+    return;
+  }
+  task_runner_->PostTaskAndReplyWithResult(
+      FROM_HERE,
+      base::BindOnce(&SyncKeyDeriver::Derive, std::move(passphrase), salt,
+                     params, /*tune=*/false, std::nullopt),
+      base::BindOnce(&SyncKeyDeriver::OnKeyUnlocked,
+                     weak_ptr_factory_.GetWeakPtr(), salt,
+                     std::move(callback)));
+}
+
+void SyncKeyDeriver::VerifyPassphrase(std::string passphrase,
+                                      ResultCallback callback) {
+  if (!key_) {
+    OPENSSL_cleanse(passphrase.data(), passphrase.size());
+    std::move(callback).Run(false);
+    return;
+  }
+  task_runner_->PostTaskAndReplyWithResult(
+      FROM_HERE,
+      base::BindOnce(&SyncKeyDeriver::Derive, std::move(passphrase), salt_,
+                     params_, /*tune=*/false, std::nullopt),
+      base::BindOnce(&SyncKeyDeriver::OnPassphraseDerived,
+                     weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
+}
+
+void SyncKeyDeriver::ClearKey() {
+  key_.reset();
+  salt_.clear();
+  params_ = KdfParams();
+}
+
+void SyncKeyDeriver::OnKeyCreated(std::string salt,
+                                  NewKeyCallback callback,
+                                  std::unique_ptr<Derivation> derivation) {
+  if (derivation->tuned_log2_n) {
+    tuned_log2_n_ = derivation->tuned_log2_n;
+  }
+  NewKey result;
+  if (derivation->key) {
+    key_ = std::move(derivation->key);
+    salt_ = salt;
+    params_ = derivation->params;
+    result.success = true;
+    result.salt = std::move(salt);
+    result.params = params_;
+  }
+  std::move(callback).Run(result);
+}
+
+void SyncKeyDeriver::OnKeyUnlocked(std::string salt,
+                                   ResultCallback callback,
+                                   std::unique_ptr<Derivation> derivation) {
+  if (!derivation->key) {
+    std::move(callback).Run(false);
+    return;
+  }
+  key_ = std::move(derivation->key);
+  salt_ = std::move(salt);
+  params_ = derivation->params;
+  std::move(callback).Run(true);
+}
+
+void SyncKeyDeriver::OnPassphraseDerived(
+    ResultCallback callback,
+    std::unique_ptr<Derivation> derivation) {
+  // The session key may have changed meanwhile; compare with the current
+  std::move(callback).Run(key_ && derivation->key &&
+                          key_->Equals(*derivation->key));
+}
+
+}  // namespace security
+}  // namespace browser_core
@@ -0,0 +1,173 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_SECURITY_SYNC_KEY_DERIVER_H_
+#define BROWSER_CORE_SECURITY_SYNC_KEY_DERIVER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/time.h"
+
+namespace browser_core {
+namespace security {
+
+// LockedKey holds key bytes in pages of their own, locked into memory so
+// they are never written to swap and, where supported, left out of core
+// dumps. The bytes are wiped before the pages are released.
+class LockedKey {
+ public:
+  // A zeroed key of |size| bytes, or null if memory could not be had
+  static std::unique_ptr<LockedKey> Create(size_t size);
+
+  ~LockedKey();
+
+  LockedKey(const LockedKey&) = delete;
+  LockedKey& operator=(const LockedKey&) = delete;
+
+  uint8_t* data() { return data_; }
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  std::string_view view() const {
+    return std::string_view(reinterpret_cast<const char*>(data_), size_);
+  }
+
+  // False if the pages could not be locked, e.g. over the process's
+  // locked memory limit; the key still works but may be swapped out
+  bool is_locked() const { return is_locked_; }
+
+  // Whether this and |other| hold the same bytes, in constant time
+  bool Equals(const LockedKey& other) const;
+
+ private:
+  LockedKey(uint8_t* data, size_t size, size_t mapping_size, bool is_locked);
+
+  uint8_t* const data_;
+  const size_t size_;
+  const size_t mapping_size_;
+  const bool is_locked_;
+};
+
+// SyncKeyDeriver turns the sync passphrase into the sync key with scrypt,
+// off the calling sequence, and keeps the key for the session so sync
+// operations after the first use it without deriving again.
+//
+// Derivations are deliberately slow and memory hungry, and run one at a
+// time on a sequence of their own. The scrypt cost of a new key is tuned
+// on first use to take about kTargetDerivationTime on this device, by
+// timing a derivation at the lowest cost and scaling up, and the tuning is
+// kept for the session. The cost is part of the key's KdfParams, stored
+// with the account along with the salt, since unlocking the key on any
+// device must use the same.
+//
+// The key lives in a LockedKey. Passphrases are wiped from memory once
+// derived from.
+//
+// Must be used on one sequence; callbacks run there.
+class SyncKeyDeriver {
+ public:
+  // Scrypt parameters of a key
+  struct KdfParams {
+    // N is 2^log2_n
+    uint32_t log2_n = kMinLog2N;
+    uint32_t r = 8;
+    uint32_t p = 1;
+  };
+
+  struct NewKey {
+    bool success = false;
+    // To store with the account
+    std::string salt;
+    KdfParams params;
+  };
+
+  static constexpr size_t kKeySize = 32;
+  static constexpr size_t kSaltSize = 16;
+  // 16 MiB to 256 MiB of memory with r = 8
+  static constexpr uint32_t kMinLog2N = 14;
+  static constexpr uint32_t kMaxLog2N = 18;
+  static constexpr base::TimeDelta kTargetDerivationTime =
+      base::Milliseconds(500);
+
+  using NewKeyCallback = base::OnceCallback<void(const NewKey&)>;
+  using ResultCallback = base::OnceCallback<void(bool)>;
+
+  // |task_runner| runs the derivations; defaults to a thread pool sequence
+  explicit SyncKeyDeriver(
+      scoped_refptr<base::SequencedTaskRunner> task_runner = nullptr);
+  ~SyncKeyDeriver();
+
+  SyncKeyDeriver(const SyncKeyDeriver&) = delete;
+  SyncKeyDeriver& operator=(const SyncKeyDeriver&) = delete;
+
+  // Derive a new key from |passphrase| with a fresh salt and a cost tuned
+  // for this device, and make it the session key. For setting up sync and
+  // changing the passphrase.
+  void CreateKey(std::string passphrase, NewKeyCallback callback);
+
+  // Derive the key of an account from |passphrase| and the account's
+  // |salt| and |params|, and make it the session key. For resuming sync
+  // with no session key yet.
+  void UnlockKey(std::string passphrase,
+                 std::string salt,
+                 const KdfParams& params,
+                 ResultCallback callback);
+
+  // Whether |passphrase| derives the session key. False without one.
+  void VerifyPassphrase(std::string passphrase, ResultCallback callback);
+
+  bool HasKey() const { return !!key_; }
+  // The session key; only valid with HasKey()
+  std::string_view GetKey() const { return key_->view(); }
+  const KdfParams& params() const { return params_; }
+
+  // Forget the session key, e.g. on sign out or sync reset
+  void ClearKey();
+
+ private:
+  struct Derivation;
+
+  // Runs on |task_runner_|. With |tune|, derives at this device's cost,
+  // |tuned_log2_n| or tuned now, instead of |params|'.
+  static std::unique_ptr<Derivation> Derive(
+      std::string passphrase,
+      std::string salt,
+      KdfParams params,
+      bool tune,
+      std::optional<uint32_t> tuned_log2_n);
+
+  void OnKeyCreated(std::string salt,
+                    NewKeyCallback callback,
+                    std::unique_ptr<Derivation> derivation);
+  void OnKeyUnlocked(std::string salt,
+                     ResultCallback callback,
+                     std::unique_ptr<Derivation> derivation);
+  void OnPassphraseDerived(ResultCallback callback,
+                           std::unique_ptr<Derivation> derivation);
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+
+  // This device's tuned cost, once known
+  std::optional<uint32_t> tuned_log2_n_;
+
+  std::unique_ptr<LockedKey> key_;
+  std::string salt_;
+  KdfParams params_;
+
+  base::WeakPtrFactory<SyncKeyDeriver> weak_ptr_factory_{this};
+};
+
+}  // namespace security
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_SECURITY_SYNC_KEY_DERIVER_H_
@@ -0,0 +1,252 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/security/url_verdict_cache.h"
+
+#include <algorithm>
+
+#include "base/strings/string_util.h"
+#include "base/time/default_tick_clock.h"
+
+namespace browser_core {
+namespace security {
+
+namespace {
+
+// Split |url| into its canonical form and host. Returns false if it has no
+// host.
+bool Canonicalize(std::string_view url,
+                  std::string* canonical,
+                  std::string* host) {
+  size_t scheme_end = url.find("://");
+  if (scheme_end == std::string_view::npos || scheme_end == 0) {
+    return false;
+  }
+  std::string scheme = base::ToLowerASCII(url.substr(0, scheme_end));
+  url.remove_prefix(scheme_end + 3);
+
+  url = url.substr(0, url.find('#'));
+  size_t authority_end = url.find_first_of("/?");
+  std::string_view authority = url.substr(0, authority_end);
+  std::string_view rest;
+  if (authority_end != std::string_view::npos) {
+    rest = url.substr(authority_end);
+  }
+  size_t at = authority.rfind('@');
+  if (at != std::string_view::npos) {
+    authority.remove_prefix(at + 1);
+  }
+
+  std::string_view port;
+  size_t colon = authority.rfind(':');
+  if (colon != std::string_view::npos &&
+      authority.find(']', colon) == std::string_view::npos) {
+    port = authority.substr(colon + 1);
+    authority = authority.substr(0, colon);
+  }
+  *host = base::ToLowerASCII(authority);
+  while (!host->empty() && host->back() == '.') {
+    host->pop_back();
+  }
+  if (host->empty()) {
+    return false;
+  }
+  if ((scheme == "http" && port == "80") ||
+      (scheme == "https" && port == "443")) {
+    port = std::string_view();
+  }
+
+  *canonical = scheme + "://" + *host;
+  if (!port.empty()) {
+    canonical->append(":").append(port);
+  }
+  if (rest.empty() || rest.front() != '/') {
+    canonical->push_back('/');
+  }
+  canonical->append(rest);
+  return true;
+}
+
+}  // namespace
+
+UrlVerdictCache::UrlVerdictCache(size_t max_entries)
+    : UrlVerdictCache(max_entries, TimesToLive()) {}
+
+UrlVerdictCache::UrlVerdictCache(size_t max_entries,
+                                 const TimesToLive& times_to_live)
+    : max_entries_per_shard_(
+          std::max<size_t>(1, (max_entries + kShardCount - 1) / kShardCount)),
+      times_to_live_(times_to_live),
+      clock_(base::DefaultTickClock::GetInstance()) {}
+
+UrlVerdictCache::~UrlVerdictCache() = default;
+
+bool UrlVerdictCache::Get(std::string_view url,
+                          SecurityManager::SecurityCheckResult* result) {
+  lookups_.fetch_add(1, std::memory_order_relaxed);
+  std::string canonical;
+  std::string host;
+  if (!Canonicalize(url, &canonical, &host)) {
+    return false;
+  }
+
+  Entry entry;
+  bool found =
+      GetEntry(ComputeKey(Scope::kUrl, canonical), Scope::kUrl, canonical,
+               &entry);
+  std::string_view domain = host;
+  bool is_ip = !host.empty() && (host.front() == '[' ||
+                                 base::IsAsciiDigit(host.back()));
+  for (size_t suffixes = 0; !found && suffixes <= kMaxHostSuffixes;
+       ++suffixes) {
+    found = GetEntry(ComputeKey(Scope::kHost, domain), Scope::kHost, domain,
+                     &entry);
+    size_t dot = domain.find('.');
+    if (is_ip || dot == std::string_view::npos ||
+        domain.find('.', dot + 1) == std::string_view::npos) {
+      // Never a verdict for a whole top-level domain
+      break;
+    }
+    domain.remove_prefix(dot + 1);
+  }
+  if (!found) {
+    return false;
+  }
+
+  switch (entry.verdict) {
+    case Verdict::kSafe:
+      negative_hits_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case Verdict::kUnsafe:
+      positive_hits_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case Verdict::kUnknown:
+      unknown_hits_.fetch_add(1, std::memory_order_relaxed);
+      break;
+  }
+  *result = std::move(entry.result);
+  return true;
+}
+
+void UrlVerdictCache::Put(std::string_view url,
+                          Scope scope,
+                          Verdict verdict,
+                          const SecurityManager::SecurityCheckResult& result) {
+  std::string canonical;
+  std::string host;
+  if (!Canonicalize(url, &canonical, &host)) {
+    return;
+  }
+  Entry entry;
+  entry.scope = scope;
+  entry.canonical = scope == Scope::kUrl ? std::move(canonical) : host;
+  Key key = ComputeKey(scope, entry.canonical);
+  entry.result = result;
+  entry.verdict = verdict;
+  entry.expiry = clock_->NowTicks() + GetTimeToLive(verdict);
+  entry.generation = generation_.load(std::memory_order_acquire);
+
+  Shard& shard = GetShard(key);
+  base::AutoLock lock(shard.lock);
+  auto it = shard.index.find(key);
+  if (it != shard.index.end()) {
+    it->second->second = std::move(entry);
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return;
+  }
+  if (shard.lru.size() >= max_entries_per_shard_) {
+    shard.index.erase(shard.lru.back().first);
+    shard.lru.pop_back();
+    entries_.fetch_sub(1, std::memory_order_relaxed);
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+  shard.lru.emplace_front(key, std::move(entry));
+  shard.index[key] = shard.lru.begin();
+  entries_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void UrlVerdictCache::Invalidate() {
+  // Entries of older generations are dropped as lookups run into them or
+  // they reach the cold end of their shard
+  generation_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+UrlVerdictCache::Stats UrlVerdictCache::GetStats() const {
+  Stats stats;
+  stats.lookups = lookups_.load(std::memory_order_relaxed);
+  stats.positive_hits = positive_hits_.load(std::memory_order_relaxed);
+  stats.negative_hits = negative_hits_.load(std::memory_order_relaxed);
+  stats.unknown_hits = unknown_hits_.load(std::memory_order_relaxed);
+  stats.expirations = expirations_.load(std::memory_order_relaxed);
+  stats.evictions = evictions_.load(std::memory_order_relaxed);
+  stats.entries = entries_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+// static
+std::string UrlVerdictCache::CanonicalizeUrl(std::string_view url) {
+  std::string canonical;
+  std::string host;
+  if (!Canonicalize(url, &canonical, &host)) {
+    return std::string();
+  }
+  return canonical;
+}
+
+// static
+UrlVerdictCache::Key UrlVerdictCache::ComputeKey(Scope scope,
+                                                 std::string_view canonical) {
+  asol::core::Hasher128 hasher;
+  hasher.UpdateUint64(static_cast<uint64_t>(scope));
+  hasher.Update(canonical);
+  return hasher.Finish();
+}
+
+UrlVerdictCache::Shard& UrlVerdictCache::GetShard(const Key& key) {
+  // The index hashes on the low half
+  return shards_[key.high % kShardCount];
+}
+
+bool UrlVerdictCache::GetEntry(const Key& key,
+                               Scope scope,
+                               std::string_view canonical,
+                               Entry* entry) {
+  Shard& shard = GetShard(key);
+  base::AutoLock lock(shard.lock);
+  auto it = shard.index.find(key);
+  if (it == shard.index.end()) {
+    return false;
+  }
+  const Entry& stored = it->second->second;
+  // Only a collision of the hash; the entry stays for its own URL
+  if (stored.scope != scope || stored.canonical != canonical) {
+    return false;
+  }
+  if (stored.generation != generation_.load(std::memory_order_acquire) ||
+      clock_->NowTicks() >= stored.expiry) {
+    shard.lru.erase(it->second);
+    shard.index.erase(it);
+    entries_.fetch_sub(1, std::memory_order_relaxed);
+    expirations_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  *entry = stored;
+  return true;
+}
+
+base::TimeDelta UrlVerdictCache::GetTimeToLive(Verdict verdict) const {
+  switch (verdict) {
+    case Verdict::kSafe:
+      return times_to_live_.safe;
+    case Verdict::kUnsafe:
+      return times_to_live_.unsafe;
+    case Verdict::kUnknown:
+      return times_to_live_.unknown;
+  }
+  return times_to_live_.unknown;
+}
+
+}  // namespace security
+}  // namespace browser_core
@@ -0,0 +1,178 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_SECURITY_URL_VERDICT_CACHE_H_
+#define BROWSER_CORE_SECURITY_URL_VERDICT_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "asol/core/request_fingerprint.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/time/tick_clock.h"
+#include "base/time/time.h"
+#include "browser_core/security/security_manager.h"
+
+namespace browser_core {
+namespace security {
+
+// UrlVerdictCache remembers the results of SecurityManager::CheckURL() so
+// that navigations and subresource loads of URLs checked recently do not
+// run the checks again.
+//
+// A verdict is cached for one URL or for a whole host. Lookups try the
+// canonical URL, then its host and up to kMaxHostSuffixes of the domains
+// it is under, so one verdict for "evil.com" answers for every URL on
+// "login.evil.com". Verdicts live as long as their kind deserves: known
+// safe ones long, known unsafe ones less so, and unknown ones briefly so
+// that a check that could not finish is retried soon. Updating the
+// blocklists invalidates every verdict at once by bumping a generation,
+// without walking the shards.
+//
+// Entries are found by a 128-bit hash of their scope and canonical URL or
+// host, but keep that URL or host and a hit must match it: a URL crafted
+// to collide with a safe one cannot inherit its verdict.
+//
+// Keys are spread over independently locked shards, each an LRU, so
+// concurrent checks only contend when they land on the same shard.
+// Counters are atomics. Safe to use from any thread.
+class UrlVerdictCache {
+ public:
+  enum class Verdict {
+    kSafe,
+    kUnsafe,
+    // The checks could not decide, e.g. a list was still loading
+    kUnknown,
+  };
+
+  enum class Scope {
+    // The verdict is for this URL only
+    kUrl,
+    // The verdict is for every URL on the host and hosts under it
+    kHost,
+  };
+
+  struct TimesToLive {
+    base::TimeDelta safe = base::Minutes(30);
+    base::TimeDelta unsafe = base::Minutes(10);
+    base::TimeDelta unknown = base::Seconds(30);
+  };
+
+  struct Stats {
+    size_t lookups = 0;
+    // Cached unsafe verdicts returned
+    size_t positive_hits = 0;
+    // Cached safe verdicts returned
+    size_t negative_hits = 0;
+    // Cached unknown verdicts returned
+    size_t unknown_hits = 0;
+    size_t expirations = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+
+    double GetPositiveHitRate() const {
+      return lookups ? static_cast<double>(positive_hits) / lookups : 0.0;
+    }
+    double GetNegativeHitRate() const {
+      return lookups ? static_cast<double>(negative_hits) / lookups : 0.0;
+    }
+  };
+
+  static constexpr size_t kDefaultMaxEntries = 8192;
+  static constexpr size_t kShardCount = 16;
+  // Domains above the host tried by a lookup, e.g. "b.c.com" and "c.com"
+  // for "a.b.c.com"
+  static constexpr size_t kMaxHostSuffixes = 4;
+
+  explicit UrlVerdictCache(size_t max_entries = kDefaultMaxEntries);
+  UrlVerdictCache(size_t max_entries, const TimesToLive& times_to_live);
+  ~UrlVerdictCache();
+
+  UrlVerdictCache(const UrlVerdictCache&) = delete;
+  UrlVerdictCache& operator=(const UrlVerdictCache&) = delete;
+
+  void SetTickClockForTesting(const base::TickClock* clock) { clock_ = clock; }
+
+  // Copy the verdict cached for |url| to |result|, preferring one for the
+  // URL to one for its host. Returns false if there is none live.
+  bool Get(std::string_view url, SecurityManager::SecurityCheckResult* result);
+
+  // Remember |result| as a |verdict| for |url| or its host
+  void Put(std::string_view url,
+           Scope scope,
+           Verdict verdict,
+           const SecurityManager::SecurityCheckResult& result);
+
+  // Forget every verdict, e.g. because a blocklist changed
+  void Invalidate();
+
+  Stats GetStats() const;
+
+  // |url| with the scheme and host lowercase, without user name, default
+  // port, fragment or trailing dot on the host; empty if it has no host
+  static std::string CanonicalizeUrl(std::string_view url);
+
+ private:
+  struct Entry {
+    Scope scope = Scope::kUrl;
+    // Canonical URL or host the verdict is for
+    std::string canonical;
+    SecurityManager::SecurityCheckResult result;
+    Verdict verdict = Verdict::kUnknown;
+    base::TimeTicks expiry;
+    uint64_t generation = 0;
+  };
+
+  using Key = asol::core::RequestFingerprint;
+  using LruList = std::list<std::pair<Key, Entry>>;
+
+  struct Shard {
+    base::Lock lock;
+    LruList lru GUARDED_BY(lock);
+    std::unordered_map<Key, LruList::iterator, Key::Hash> index
+        GUARDED_BY(lock);
+  };
+
+  static Key ComputeKey(Scope scope, std::string_view canonical);
+  Shard& GetShard(const Key& key);
+
+  // Find the live entry for |canonical| in |scope|, whose key is |key|,
+  // dropping it if it is not live
+  bool GetEntry(const Key& key,
+                Scope scope,
+                std::string_view canonical,
+                Entry* entry);
+
+  base::TimeDelta GetTimeToLive(Verdict verdict) const;
+
+  const size_t max_entries_per_shard_;
+  const TimesToLive times_to_live_;
+  const base::TickClock* clock_;
+
+  std::array<Shard, kShardCount> shards_;
+  std::atomic<uint64_t> generation_{0};
+
+  std::atomic<size_t> lookups_{0};
+  std::atomic<size_t> positive_hits_{0};
+  std::atomic<size_t> negative_hits_{0};
+  std::atomic<size_t> unknown_hits_{0};
+  std::atomic<size_t> expirations_{0};
+  std::atomic<size_t> evictions_{0};
+  std::atomic<size_t> entries_{0};
+};
+
+}  // namespace security
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_SECURITY_URL_VERDICT_CACHE_H_
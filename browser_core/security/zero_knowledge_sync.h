@@ -19,6 +19,10 @@ namespace security {
 
 // ZeroKnowledgeSync provides secure synchronization of browser data
 // without the server being able to read the data.
+//
+// Each data type is synced as encrypted content-defined chunks plus a
+// manifest listing them (see DeltaSyncEncoder), so a sync uploads only
+// the chunks the last synced manifest of the type does not have.
 class ZeroKnowledgeSync {
  public:
   // Data types that can be synced
@@ -99,7 +103,8 @@ class ZeroKnowledgeSync {
   // Get last sync time
   base::Time GetLastSyncTime() const;
 
-  // Force sync now
+  // Force sync now. Sends, per enabled data type, the new manifest and
+  // the chunks not in the last synced one.
   void SyncNow(SyncCallback callback);
 
   // Reset sync (clear all sync data)
@@ -110,7 +115,10 @@ class ZeroKnowledgeSync {
                       const std::string& new_passphrase,
                       base::OnceCallback<void(bool)> callback);
 
-  // Export sync data
+  // Export sync data: the manifest of each data type and the chunks it
+  // lists. Large exports are sealed with a StreamingEncryptor and written
+  // to the export file as they are encrypted, rather than through
+  // EncryptData().
   void ExportSyncData(const std::string& passphrase,
                     base::OnceCallback<void(const std::string&)> callback);
 
@@ -123,7 +131,11 @@ class ZeroKnowledgeSync {
   base::WeakPtr<ZeroKnowledgeSync> GetWeakPtr();
 
  private:
-  // Helper methods
+  // Helper methods. EncryptData() and DecryptData() hold the whole data
+  // and suit single sync items only. DeriveKeyFromPassphrase() and
+  // VerifyPassphrase() must not run on the UI sequence: SetupSync(),
+  // ResumeSync() and ChangePassphrase() go through a SyncKeyDeriver, which
+  // derives off-sequence and keeps the key for the session.
   std::string EncryptData(const std::string& data, const std::string& key);
   std::string DecryptData(const std::string& encrypted_data, const std::string& key);
   std::string DeriveKeyFromPassphrase(const std::string& passphrase, const std::string& salt);
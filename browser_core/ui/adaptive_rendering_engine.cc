@@ -6,12 +6,16 @@
 
 #include <sstream>
 #include <algorithm>
+#include <string_view>
 #include <utility>
 
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/values.h"
+#include "asol/core/prompt_template.h"
+#include "asol/core/request_fingerprint.h"
 
 namespace browser_core {
 namespace ui {
@@ -19,176 +23,330 @@ namespace ui {
 namespace {
 
 // Constants for AI prompts
-constexpr char kLayoutAnalysisPrompt[] = 
-    "Analyze the following web page content and suggest optimizations to improve "
+// Ordered from most to least stable: the instructions, then the device
+// and profile, which rarely change, and the page last, so successive pages
+// share a prompt prefix providers can cache
+constexpr asol::core::PromptTemplate kLayoutAnalysisPrompt(
+    "Analyze the web page content below and suggest optimizations to improve "
     "readability, reduce cognitive load, and enhance user experience. "
     "Consider the device capabilities, user cognitive profile, and content importance. "
-    "\n\nPage content:\n{page_content}\n\n"
-    "Device capabilities:\n{device_capabilities}\n\n"
-    "User cognitive profile:\n{cognitive_profile}\n\n"
     "Provide optimization suggestions in JSON format with the following fields: "
     "style_modifications (array of objects with selector and css_changes), "
     "content_modifications (array of objects with selector and content_changes), "
     "visibility_modifications (array of objects with selector and is_visible), "
     "custom_css (string), custom_js (string), "
     "estimated_cognitive_load_reduction (float 0.0-1.0), "
-    "estimated_performance_improvement (float 0.0-1.0).";
+    "estimated_performance_improvement (float 0.0-1.0)."
+    "\n\nDevice capabilities:\n{device_capabilities}\n\n"
+    "User cognitive profile:\n{cognitive_profile}\n\n"
+    "Page content:\n{page_content}{truncation_note}",
+    "page_content");
 
-// JavaScript for extracting page content
-constexpr char kExtractPageContentScript[] = R"(
+// Page content sent for layout analysis, in bytes
+constexpr size_t kMaxLayoutContentLength = 5000;
+
+// JavaScript for a page's template signature: its host and the skeleton of
+// container elements, each child kind listed once, without text or inline
+// markup. Pages of one template agree however long their content is.
+constexpr char kLayoutSignatureScript[] = R"(
   (function() {
-    // Extract main content
-    const content = {
-      title: document.title,
-      url: window.location.href,
-      headings: [],
-      paragraphs: [],
-      images: [],
-      links: [],
-      forms: [],
-      layout: {}
-    };
-    
-    // Extract headings
-    const headings = document.querySelectorAll('h1, h2, h3, h4, h5, h6');
-    for (let i = 0; i < headings.length; i++) {
-      const heading = headings[i];
-      content.headings.push({
-        text: heading.textContent.trim(),
-        level: parseInt(heading.tagName.substring(1)),
-        position: {
-          x: heading.getBoundingClientRect().left,
-          y: heading.getBoundingClientRect().top
-        }
-      });
+    const kMaxDepth = 6;
+    const kSkipped = new Set(['SCRIPT', 'STYLE', 'NOSCRIPT', 'TEMPLATE',
+                              'LINK', 'META']);
+    const kLeaves = new Set(['P', 'H1', 'H2', 'H3', 'H4', 'H5', 'H6', 'A',
+                             'SPAN', 'EM', 'STRONG', 'B', 'I', 'CODE', 'PRE',
+                             'BLOCKQUOTE', 'IMG', 'PICTURE', 'FIGURE', 'VIDEO',
+                             'IFRAME', 'BUTTON', 'LABEL', 'INPUT', 'SELECT',
+                             'TEXTAREA', 'svg']);
+
+    // Tag, id and classes, leaving out generated ones with digits
+    function describe(element) {
+      let name = element.tagName.toLowerCase();
+      if (element.id && !/\d/.test(element.id)) {
+        name += '#' + element.id;
+      }
+      const classes = Array.from(element.classList)
+          .filter(c => !/\d/.test(c)).sort();
+      if (classes.length) {
+        name += '.' + classes.join('.');
+      }
+      return name;
     }
-    
-    // Extract paragraphs
-    const paragraphs = document.querySelectorAll('p');
-    for (let i = 0; i < paragraphs.length; i++) {
-      const paragraph = paragraphs[i];
-      content.paragraphs.push({
-        text: paragraph.textContent.trim(),
-        length: paragraph.textContent.trim().length,
-        position: {
-          x: paragraph.getBoundingClientRect().left,
-          y: paragraph.getBoundingClientRect().top
+
+    function walk(element, depth) {
+      let out = describe(element);
+      if (depth >= kMaxDepth || kLeaves.has(element.tagName)) {
+        return out;
+      }
+      const parts = [];
+      for (const child of element.children) {
+        if (kSkipped.has(child.tagName)) {
+          continue;
         }
-      });
-    }
-    
-    // Extract images
-    const images = document.querySelectorAll('img');
-    for (let i = 0; i < images.length; i++) {
-      const image = images[i];
-      content.images.push({
-        src: image.src,
-        alt: image.alt,
-        width: image.width,
-        height: image.height,
-        position: {
-          x: image.getBoundingClientRect().left,
-          y: image.getBoundingClientRect().top
+        const part = walk(child, depth + 1);
+        if (!parts.includes(part)) {
+          parts.push(part);
         }
-      });
+      }
+      if (parts.length) {
+        out += '(' + parts.join(',') + ')';
+      }
+      return out;
     }
-    
-    // Extract links
-    const links = document.querySelectorAll('a');
-    for (let i = 0; i < links.length; i++) {
-      const link = links[i];
-      content.links.push({
-        href: link.href,
-        text: link.textContent.trim(),
-        position: {
-          x: link.getBoundingClientRect().left,
-          y: link.getBoundingClientRect().top
+
+    return location.hostname + '|' + walk(document.body, 0);
+  })();
+)";
+
+// JavaScript applying rule-based optimizations and measuring what they
+// changed: running animations, media still loading eagerly and rendered
+// elements, before and after
+constexpr char kApplyRulesScriptTemplate[] = R"(
+  (function() {
+    function measure() {
+      const animations = document.getAnimations ?
+          document.getAnimations()
+              .filter(a => a.playState === 'running').length : 0;
+      let media = 0;
+      for (const img of document.images) {
+        if (!img.complete && img.loading !== 'lazy') {
+          media++;
         }
-      });
-    }
-    
-    // Extract forms
-    const forms = document.querySelectorAll('form');
-    for (let i = 0; i < forms.length; i++) {
-      const form = forms[i];
-      content.forms.push({
-        id: form.id,
-        action: form.action,
-        method: form.method,
-        position: {
-          x: form.getBoundingClientRect().left,
-          y: form.getBoundingClientRect().top
+      }
+      for (const video of document.querySelectorAll('video')) {
+        if (!video.paused || video.preload !== 'none') {
+          media++;
         }
-      });
-    }
-    
-    // Extract layout information
-    content.layout = {
-      viewport: {
-        width: window.innerWidth,
-        height: window.innerHeight
-      },
-      body: {
-        width: document.body.scrollWidth,
-        height: document.body.scrollHeight
       }
-    };
-    
-    return JSON.stringify(content);
+      let rendered = 0;
+      for (const element of document.body.querySelectorAll('*')) {
+        if (element.getClientRects().length) {
+          rendered++;
+        }
+      }
+      return {animations: animations, media: media, rendered: rendered};
+    }
+
+    const before = measure();
+    let styleEl = document.getElementById('dashai-rule-styles');
+    if (!styleEl) {
+      styleEl = document.createElement('style');
+      styleEl.id = 'dashai-rule-styles';
+      // First, so AI refinements added later win
+      document.head.prepend(styleEl);
+    }
+    styleEl.textContent = $CUSTOM_CSS;
+    try {
+      eval($CUSTOM_JS);
+    } catch (e) {
+      console.error('Error applying adaptive rules:', e);
+    }
+    return JSON.stringify({before: before, after: measure()});
   })();
 )";
 
-// JavaScript for applying optimizations
+// Rule-based adaptations, with the share of page cost each is expected to
+// save. The expectations are scaled by how measured savings compare.
+constexpr char kReducedMotionCSS[] =
+    "*, *::before, *::after { animation-duration: 0.01ms !important; "
+    "animation-iteration-count: 1 !important; "
+    "transition-duration: 0.01ms !important; "
+    "scroll-behavior: auto !important; }\n";
+constexpr float kReducedMotionImpact = 0.05f;
+
+constexpr char kReducedDataJS[] =
+    "for (const img of document.images) {"
+    "  if (!img.complete) img.loading = 'lazy';"
+    "}"
+    "for (const video of document.querySelectorAll('video')) {"
+    "  video.autoplay = false; video.preload = 'none';"
+    "  if (!video.paused) video.pause();"
+    "}";
+constexpr float kReducedDataImpact = 0.2f;
+
+constexpr char kDeclutterCSS[] =
+    "aside, [role=\"complementary\"], [class*=\"sidebar\"], "
+    "[id*=\"sidebar\"], [class*=\"advert\"], [id*=\"advert\"], "
+    "[class*=\"newsletter\"], [class*=\"popup\"] "
+    "{ display: none !important; }\n";
+constexpr float kDeclutterImpact = 0.15f;
+
+constexpr char kReadableTextCSS[] =
+    "html { font-size: $FONT_SCALE%; } "
+    "p, li { line-height: 1.6; max-width: 70ch; }\n";
+
+// Screens narrower than this are decluttered
+constexpr int kSmallScreenWidth = 768;
+
+// Readers slower than this, in words per minute, get larger text
+constexpr float kSlowReadingSpeed = 200.0f;
+
+// Whether to hide clutter: on small screens, or for users who prefer
+// simple content
+bool ShouldDeclutter(
+    const AdaptiveRenderingEngine::DeviceCapabilities& device,
+    const AdaptiveRenderingEngine::CognitiveProfile& profile) {
+  return device.screen_width < kSmallScreenWidth ||
+         profile.complexity_tolerance < 0.3f;
+}
+
+// Templates whose optimizations are kept
+constexpr size_t kMaxCachedTemplates = 64;
+
+// Coarse device class: what layouts are tuned for, not the exact device
+std::string GetDeviceClass(
+    const AdaptiveRenderingEngine::DeviceCapabilities& device) {
+  std::string device_class =
+      device.is_mobile ? "mobile" : (device.is_tablet ? "tablet" : "desktop");
+  if (device.screen_width < 480) {
+    device_class += "-s";
+  } else if (device.screen_width < 1024) {
+    device_class += "-m";
+  } else if (device.screen_width < 1600) {
+    device_class += "-l";
+  } else {
+    device_class += "-xl";
+  }
+  if (device.is_touch_enabled) {
+    device_class += "-touch";
+  }
+  return device_class;
+}
+
+void HashString(std::string_view text, asol::core::Hasher128* hasher) {
+  hasher->UpdateUint64(text.size());
+  hasher->Update(text);
+}
+
+void HashCognitiveProfile(
+    const AdaptiveRenderingEngine::CognitiveProfile& profile,
+    asol::core::Hasher128* hasher) {
+  for (float value : {profile.reading_speed, profile.attention_span,
+                      profile.complexity_tolerance}) {
+    hasher->Update(&value, sizeof(value));
+  }
+  HashString(profile.preferred_content_type, hasher);
+  HashString(profile.preferred_learning_style, hasher);
+  hasher->UpdateUint64((profile.prefers_visual_content ? 1 : 0) |
+                       (profile.prefers_reduced_motion ? 2 : 0) |
+                       (profile.prefers_reduced_data ? 4 : 0));
+
+  // Ordered, so the hash does not depend on map iteration order
+  std::vector<std::pair<std::string, float>> expertise(
+      profile.topic_expertise.begin(), profile.topic_expertise.end());
+  std::sort(expertise.begin(), expertise.end());
+  for (const auto& [topic, level] : expertise) {
+    HashString(topic, hasher);
+    hasher->Update(&level, sizeof(level));
+  }
+}
+
+// JavaScript for applying optimizations: one stylesheet for every style
+// and visibility change, content changes per element, then custom JS. The
+// effect is then measured for a few seconds with PerformanceObserver:
+// layout shifts and long tasks beyond the page's own rate before, any
+// later largest paint, and bytes hidden media no longer load.
 constexpr char kApplyOptimizationsScriptTemplate[] = R"(
   (function() {
-    // Apply style modifications
-    const styleModifications = $STYLE_MODIFICATIONS;
-    for (const mod of styleModifications) {
-      const elements = document.querySelectorAll(mod.selector);
-      for (const el of elements) {
-        Object.assign(el.style, mod.css_changes);
+    const stylesheet = $STYLESHEET;
+    const contentModifications = $CONTENT_MODIFICATIONS;
+    const customJS = $CUSTOM_JS;
+    const kMeasureMs = $MEASURE_MS;
+    // Size of a hidden image, when its dimensions are unknown, and bytes
+    // per pixel otherwise
+    const kDefaultImageBytes = 50000;
+    const kImageBytesPerPixel = 0.5;
+
+    function transferredBytes() {
+      let bytes = 0;
+      for (const entry of performance.getEntriesByType('navigation')
+               .concat(performance.getEntriesByType('resource'))) {
+        bytes += entry.transferSize || 0;
       }
+      return bytes;
     }
-    
-    // Apply content modifications
-    const contentModifications = $CONTENT_MODIFICATIONS;
+
+    // Entries before |start| set the page's own rate
+    const start = performance.now();
+    const totals = {
+      clsBefore: 0, clsAfter: 0, longTaskBefore: 0, longTaskAfter: 0,
+      lcpDelay: 0
+    };
+    const observers = [];
+    function observe(type, onEntry) {
+      try {
+        const observer = new PerformanceObserver(
+            list => list.getEntries().forEach(onEntry));
+        observer.observe({type: type, buffered: true});
+        observers.push(observer);
+      } catch (e) {
+        // Entry type not supported
+      }
+    }
+    observe('layout-shift', entry => {
+      if (!entry.hadRecentInput) {
+        totals[entry.startTime < start ? 'clsBefore' : 'clsAfter'] +=
+            entry.value;
+      }
+    });
+    observe('longtask', entry => {
+      totals[entry.startTime < start ? 'longTaskBefore' : 'longTaskAfter'] +=
+          entry.duration;
+    });
+    observe('largest-contentful-paint', entry => {
+      if (entry.startTime >= start) {
+        totals.lcpDelay = entry.startTime - start;
+      }
+    });
+
+    let styleEl = document.getElementById('dashai-adaptive-styles');
+    if (!styleEl) {
+      styleEl = document.createElement('style');
+      styleEl.id = 'dashai-adaptive-styles';
+      document.head.appendChild(styleEl);
+    }
+    styleEl.textContent = stylesheet;
+
     for (const mod of contentModifications) {
-      const elements = document.querySelectorAll(mod.selector);
-      for (const el of elements) {
-        if (mod.content_changes.text) {
-          el.textContent = mod.content_changes.text;
+      const changes = mod.content_changes;
+      for (const el of document.querySelectorAll(mod.selector)) {
+        if (typeof changes === 'string') {
+          el.textContent = changes;
+          continue;
         }
-        if (mod.content_changes.html) {
-          el.innerHTML = mod.content_changes.html;
+        if (changes.text) {
+          el.textContent = changes.text;
         }
-        if (mod.content_changes.attributes) {
-          for (const [attr, value] of Object.entries(mod.content_changes.attributes)) {
+        if (changes.html) {
+          el.innerHTML = changes.html;
+        }
+        if (changes.attributes) {
+          for (const [attr, value] of Object.entries(changes.attributes)) {
             el.setAttribute(attr, value);
           }
         }
       }
     }
-    
-    // Apply visibility modifications
-    const visibilityModifications = $VISIBILITY_MODIFICATIONS;
-    for (const mod of visibilityModifications) {
-      const elements = document.querySelectorAll(mod.selector);
-      for (const el of elements) {
-        el.style.display = mod.is_visible ? '' : 'none';
+
+    // Media hidden before it loaded need not load at all
+    let bytesSaved = 0;
+    for (const img of document.images) {
+      if (img.complete || img.getClientRects().length) {
+        continue;
       }
+      img.loading = 'lazy';
+      const width = parseInt(img.getAttribute('width'));
+      const height = parseInt(img.getAttribute('height'));
+      bytesSaved += width > 0 && height > 0 ?
+          width * height * kImageBytesPerPixel : kDefaultImageBytes;
     }
-    
-    // Apply custom CSS
-    const customCSS = `$CUSTOM_CSS`;
-    if (customCSS) {
-      const styleEl = document.createElement('style');
-      styleEl.id = 'dashai-adaptive-styles';
-      styleEl.textContent = customCSS;
-      document.head.appendChild(styleEl);
+    for (const video of document.querySelectorAll('video')) {
+      if (!video.getClientRects().length) {
+        video.preload = 'none';
+        video.pause();
+      }
     }
-    
-    // Apply custom JS
-    const customJS = `$CUSTOM_JS`;
+
     if (customJS) {
       try {
         eval(customJS);
@@ -196,11 +354,61 @@ constexpr char kApplyOptimizationsScriptTemplate[] = R"(
         console.error('Error executing custom JS:', e);
       }
     }
-    
-    return true;
+
+    return new Promise(resolve => setTimeout(() => {
+      observers.forEach(observer => observer.disconnect());
+      const seconds = kMeasureMs / 1000;
+      const pageSeconds = Math.max(start / 1000, seconds);
+      const excess = (before, after) =>
+          Math.max(0, after - before * seconds / pageSeconds);
+      resolve(JSON.stringify({
+        cls_added: excess(totals.clsBefore, totals.clsAfter),
+        long_task_ms_added:
+            excess(totals.longTaskBefore, totals.longTaskAfter),
+        lcp_delay_ms: totals.lcpDelay,
+        bytes_saved: bytesSaved,
+        bytes_transferred: transferredBytes()
+      }));
+    }, kMeasureMs));
   })();
 )";
 
+// How long the effect of applied optimizations is measured
+constexpr int kMeasureEffectMs = 3000;
+
+// Cost of measured regressions, against the share of bytes saved: a layout
+// shift score of 0.1 costs 0.2, a second of long tasks 1 and a second of
+// largest-paint delay 0.1
+constexpr double kLayoutShiftCost = 2.0;
+constexpr double kLongTaskCostPerMs = 0.001;
+constexpr double kPaintDelayCostPerMs = 0.0001;
+
+// Whether |fragment| can go in a stylesheet without closing its rule
+bool IsSafeCSSFragment(const std::string& fragment) {
+  return fragment.find_first_of("{}<") == std::string::npos;
+}
+
+// All style and visibility changes of |optimizations| as one stylesheet
+std::string BuildStylesheet(
+    const AdaptiveRenderingEngine::LayoutOptimizations& optimizations) {
+  std::string css;
+  for (const auto& [selector, declarations] :
+       optimizations.style_modifications) {
+    if (IsSafeCSSFragment(selector) && IsSafeCSSFragment(declarations)) {
+      css += selector + " { " + declarations + " }\n";
+    }
+  }
+  // Only hiding needs a rule; shown is how elements already are
+  for (const auto& [selector, is_visible] :
+       optimizations.visibility_modifications) {
+    if (!is_visible && IsSafeCSSFragment(selector)) {
+      css += selector + " { display: none !important; }\n";
+    }
+  }
+  css += optimizations.custom_css;
+  return css;
+}
+
 }  // namespace
 
 AdaptiveRenderingEngine::AdaptiveRenderingEngine() {
@@ -217,6 +425,145 @@ AdaptiveRenderingEngine::AdaptiveRenderingEngine() {
 
 AdaptiveRenderingEngine::~AdaptiveRenderingEngine() = default;
 
+AdaptiveRenderingEngine::LayoutOptimizations
+AdaptiveRenderingEngine::ComputeRuleBasedOptimizations(
+    const DeviceCapabilities& device_capabilities) const {
+  LayoutOptimizations optimizations;
+  optimizations.success = true;
+  optimizations.estimated_cognitive_load_reduction = 0.0f;
+  optimizations.estimated_performance_improvement =
+      std::min(1.0f, GetRuleImpact(device_capabilities) * rule_impact_scale_);
+
+  if (cognitive_profile_.prefers_reduced_motion) {
+    optimizations.custom_css += kReducedMotionCSS;
+    optimizations.estimated_cognitive_load_reduction += 0.1f;
+  }
+  if (cognitive_profile_.prefers_reduced_data) {
+    optimizations.custom_js += kReducedDataJS;
+  }
+  if (ShouldDeclutter(device_capabilities, cognitive_profile_)) {
+    optimizations.custom_css += kDeclutterCSS;
+    optimizations.estimated_cognitive_load_reduction += 0.15f;
+  }
+
+  // Larger text for slow readers and small, dense screens
+  int font_scale = 100;
+  if (cognitive_profile_.reading_speed > 0 &&
+      cognitive_profile_.reading_speed < kSlowReadingSpeed) {
+    font_scale += 12;
+  }
+  if (device_capabilities.is_mobile && device_capabilities.pixel_ratio >= 3) {
+    font_scale += 6;
+  }
+  if (font_scale > 100) {
+    std::string css = kReadableTextCSS;
+    base::ReplaceSubstringsAfterOffset(&css, 0, "$FONT_SCALE",
+                                       base::NumberToString(font_scale));
+    optimizations.custom_css += css;
+    optimizations.estimated_cognitive_load_reduction += 0.1f;
+  }
+  return optimizations;
+}
+
+void AdaptiveRenderingEngine::AdaptLayout(
+    WebContents* web_contents,
+    const DeviceCapabilities& device_capabilities,
+    LayoutAnalysisCallback callback) {
+  if (is_enabled_ && web_contents) {
+    ApplyRuleBasedOptimizations(web_contents, device_capabilities);
+  }
+  AnalyzeLayout(
+      web_contents, device_capabilities,
+      base::BindOnce(
+          [](base::WeakPtr<AdaptiveRenderingEngine> self,
+             WebContents* web_contents, LayoutAnalysisCallback callback,
+             const LayoutOptimizations& optimizations) {
+            if (self) {
+              self->ApplyOptimizations(web_contents, optimizations);
+            }
+            std::move(callback).Run(optimizations);
+          },
+          weak_ptr_factory_.GetWeakPtr(), web_contents, std::move(callback)));
+}
+
+void AdaptiveRenderingEngine::ApplyRuleBasedOptimizations(
+    WebContents* web_contents,
+    const DeviceCapabilities& device_capabilities) {
+  LayoutOptimizations rules =
+      ComputeRuleBasedOptimizations(device_capabilities);
+  float expected = GetRuleImpact(device_capabilities);
+  if (rules.custom_css.empty() && rules.custom_js.empty()) {
+    return;
+  }
+
+  std::string css_json;
+  std::string js_json;
+  base::JSONWriter::Write(base::Value(rules.custom_css), &css_json);
+  base::JSONWriter::Write(base::Value(rules.custom_js), &js_json);
+  std::string script = kApplyRulesScriptTemplate;
+  base::ReplaceSubstringsAfterOffset(&script, 0, "$CUSTOM_CSS", css_json);
+  base::ReplaceSubstringsAfterOffset(&script, 0, "$CUSTOM_JS", js_json);
+
+  web_contents->ExecuteJavaScript(
+      script, base::BindOnce(&AdaptiveRenderingEngine::OnRulesApplied,
+                             weak_ptr_factory_.GetWeakPtr(),
+                             device_capabilities, expected));
+}
+
+void AdaptiveRenderingEngine::OnRulesApplied(
+    const DeviceCapabilities& device_capabilities,
+    float expected_impact,
+    const WebContents::JavaScriptResult& result) {
+  if (!result.success || expected_impact <= 0) {
+    return;
+  }
+  absl::optional<base::Value> json = base::JSONReader::Read(result.result);
+  if (!json || !json->is_dict()) {
+    return;
+  }
+  const base::Value::Dict* before = json->GetDict().FindDict("before");
+  const base::Value::Dict* after = json->GetDict().FindDict("after");
+  if (!before || !after) {
+    return;
+  }
+
+  // Share of each cost the rules removed, weighted like the expectation
+  auto reduction = [before, after](const char* key) {
+    double was = before->FindDouble(key).value_or(0.0);
+    double is = after->FindDouble(key).value_or(0.0);
+    return was > 0 ? std::clamp((was - is) / was, 0.0, 1.0) : 0.0;
+  };
+  double measured = 0.0;
+  if (cognitive_profile_.prefers_reduced_motion) {
+    measured += kReducedMotionImpact * reduction("animations");
+  }
+  if (cognitive_profile_.prefers_reduced_data) {
+    measured += kReducedDataImpact * reduction("media");
+  }
+  if (ShouldDeclutter(device_capabilities, cognitive_profile_)) {
+    measured += kDeclutterImpact * reduction("rendered");
+  }
+
+  // Move the scale estimates get toward what was measured
+  float ratio = static_cast<float>(measured) / expected_impact;
+  rule_impact_scale_ = (3 * rule_impact_scale_ + ratio) / 4;
+}
+
+float AdaptiveRenderingEngine::GetRuleImpact(
+    const DeviceCapabilities& device_capabilities) const {
+  float impact = 0.0f;
+  if (cognitive_profile_.prefers_reduced_motion) {
+    impact += kReducedMotionImpact;
+  }
+  if (cognitive_profile_.prefers_reduced_data) {
+    impact += kReducedDataImpact;
+  }
+  if (ShouldDeclutter(device_capabilities, cognitive_profile_)) {
+    impact += kDeclutterImpact;
+  }
+  return impact;
+}
+
 bool AdaptiveRenderingEngine::Initialize(
     asol::core::AIServiceManager* ai_service_manager,
     asol::core::ContextManager* context_manager) {
@@ -226,6 +573,9 @@ bool AdaptiveRenderingEngine::Initialize(
 
   ai_service_manager_ = ai_service_manager;
   context_manager_ = context_manager;
+  if (!snapshot_service_) {
+    snapshot_service_ = base::MakeRefCounted<content::PageSnapshotService>();
+  }
   
   // Load user cognitive profile from context manager
   context_manager_->GetUserContext(
@@ -282,6 +632,11 @@ bool AdaptiveRenderingEngine::Initialize(
   return true;
 }
 
+void AdaptiveRenderingEngine::SetPageSnapshotService(
+    scoped_refptr<content::PageSnapshotService> snapshot_service) {
+  snapshot_service_ = std::move(snapshot_service);
+}
+
 void AdaptiveRenderingEngine::AnalyzeLayout(
     WebContents* web_contents,
     const DeviceCapabilities& device_capabilities,
@@ -294,6 +649,89 @@ void AdaptiveRenderingEngine::AnalyzeLayout(
     return;
   }
 
+  // Pages of a template seen before reuse its optimizations
+  web_contents->ExecuteJavaScript(
+      kLayoutSignatureScript,
+      base::BindOnce(&AdaptiveRenderingEngine::OnLayoutSignature,
+                     weak_ptr_factory_.GetWeakPtr(), web_contents,
+                     device_capabilities, std::move(callback)));
+}
+
+void AdaptiveRenderingEngine::OnLayoutSignature(
+    WebContents* web_contents,
+    const DeviceCapabilities& device_capabilities,
+    LayoutAnalysisCallback callback,
+    const WebContents::JavaScriptResult& result) {
+  if (!result.success || result.result.empty()) {
+    ExtractAndOptimize(web_contents, device_capabilities, std::move(callback));
+    return;
+  }
+
+  asol::core::Hasher128 hasher;
+  HashString(result.result, &hasher);
+  HashString(GetDeviceClass(device_capabilities), &hasher);
+  HashCognitiveProfile(cognitive_profile_, &hasher);
+  // 0 means no template
+  uint64_t key = std::max<uint64_t>(hasher.Finish().low, 1);
+
+  if (const LayoutOptimizations* cached = FindTemplateOptimizations(key)) {
+    std::move(callback).Run(*cached);
+    return;
+  }
+  ExtractAndOptimize(
+      web_contents, device_capabilities,
+      base::BindOnce(&AdaptiveRenderingEngine::OnTemplateOptimized,
+                     weak_ptr_factory_.GetWeakPtr(), key,
+                     std::move(callback)));
+}
+
+void AdaptiveRenderingEngine::OnTemplateOptimized(
+    uint64_t key,
+    LayoutAnalysisCallback callback,
+    const LayoutOptimizations& optimizations) {
+  if (!optimizations.success) {
+    std::move(callback).Run(optimizations);
+    return;
+  }
+  LayoutOptimizations keyed = optimizations;
+  keyed.template_key = key;
+  AddTemplateOptimizations(key, keyed);
+  std::move(callback).Run(keyed);
+}
+
+const AdaptiveRenderingEngine::LayoutOptimizations*
+AdaptiveRenderingEngine::FindTemplateOptimizations(uint64_t key) {
+  auto it = template_index_.find(key);
+  if (it == template_index_.end()) {
+    return nullptr;
+  }
+  template_cache_.splice(template_cache_.begin(), template_cache_,
+                         it->second);
+  return &it->second->second;
+}
+
+void AdaptiveRenderingEngine::AddTemplateOptimizations(
+    uint64_t key,
+    const LayoutOptimizations& optimizations) {
+  auto it = template_index_.find(key);
+  if (it != template_index_.end()) {
+    it->second->second = optimizations;
+    template_cache_.splice(template_cache_.begin(), template_cache_,
+                           it->second);
+    return;
+  }
+  template_cache_.emplace_front(key, optimizations);
+  template_index_[key] = template_cache_.begin();
+  if (template_cache_.size() > kMaxCachedTemplates) {
+    template_index_.erase(template_cache_.back().first);
+    template_cache_.pop_back();
+  }
+}
+
+void AdaptiveRenderingEngine::ExtractAndOptimize(
+    WebContents* web_contents,
+    const DeviceCapabilities& device_capabilities,
+    LayoutAnalysisCallback callback) {
   // Extract page content
   ExtractLayoutElements(web_contents, 
       base::BindOnce([](
@@ -313,19 +751,15 @@ void AdaptiveRenderingEngine::AnalyzeLayout(
 void AdaptiveRenderingEngine::ExtractLayoutElements(
     WebContents* web_contents,
     base::OnceCallback<void(const std::string&)> callback) {
-  // Execute JavaScript to extract page content
-  web_contents->ExecuteJavaScript(
-      kExtractPageContentScript,
-      base::BindOnce([](
-          base::OnceCallback<void(const std::string&)> callback,
-          const WebContents::JavaScriptResult& result) {
-        if (!result.success) {
-          std::move(callback).Run("{}");
-          return;
-        }
-        
-        std::move(callback).Run(result.result);
-      }, std::move(callback)));
+  // The page's layout elements, from the snapshot other features share
+  snapshot_service_->GetSnapshot(
+      web_contents,
+      base::BindOnce(
+          [](base::OnceCallback<void(const std::string&)> callback,
+             scoped_refptr<const content::PageSnapshot> snapshot) {
+            std::move(callback).Run(snapshot->layout);
+          },
+          std::move(callback)));
 }
 
 void AdaptiveRenderingEngine::GenerateOptimizations(
@@ -363,15 +797,6 @@ std::string AdaptiveRenderingEngine::GenerateLayoutAnalysisPrompt(
     const std::string& page_content,
     const DeviceCapabilities& device_capabilities,
     const CognitiveProfile& cognitive_profile) {
-  std::string prompt = kLayoutAnalysisPrompt;
-  
-  // Format page content section (truncate if too long)
-  std::string truncated_content = page_content;
-  if (truncated_content.length() > 5000) {
-    truncated_content = truncated_content.substr(0, 5000) + "... [content truncated]";
-  }
-  base::ReplaceSubstringsAfterOffset(&prompt, 0, "{page_content}", truncated_content);
-  
   // Format device capabilities section
   std::stringstream device_stream;
   device_stream << "Screen size: " << device_capabilities.screen_width << "x" 
@@ -384,7 +809,6 @@ std::string AdaptiveRenderingEngine::GenerateLayoutAnalysisPrompt(
                << device_capabilities.browser_version << "\n";
   device_stream << "OS: " << device_capabilities.os_name << " " 
                << device_capabilities.os_version << "\n";
-  base::ReplaceSubstringsAfterOffset(&prompt, 0, "{device_capabilities}", device_stream.str());
   
   // Format cognitive profile section
   std::stringstream cognitive_stream;
@@ -401,9 +825,19 @@ std::string AdaptiveRenderingEngine::GenerateLayoutAnalysisPrompt(
   for (const auto& [topic, expertise] : cognitive_profile.topic_expertise) {
     cognitive_stream << "  - " << topic << ": " << expertise << "\n";
   }
-  base::ReplaceSubstringsAfterOffset(&prompt, 0, "{cognitive_profile}", cognitive_stream.str());
   
-  return prompt;
+  // Truncate long pages, without copying them first
+  std::string_view content = page_content;
+  std::string_view truncation_note;
+  if (content.size() > kMaxLayoutContentLength) {
+    content = content.substr(0, kMaxLayoutContentLength);
+    truncation_note = "... [content truncated]";
+  }
+  return kLayoutAnalysisPrompt.Render(
+      {{"device_capabilities", device_stream.str()},
+       {"cognitive_profile", cognitive_stream.str()},
+       {"page_content", content},
+       {"truncation_note", truncation_note}});
 }
 
 AdaptiveRenderingEngine::LayoutOptimizations AdaptiveRenderingEngine::ParseAIResponse(
@@ -489,17 +923,6 @@ void AdaptiveRenderingEngine::ApplyOptimizations(
     return;
   }
   
-  // Convert optimizations to JSON for JavaScript
-  base::Value::List style_mods_list;
-  for (const auto& [selector, css_changes] : optimizations.style_modifications) {
-    base::Value::Dict mod;
-    mod.Set("selector", selector);
-    mod.Set("css_changes", css_changes);
-    style_mods_list.Append(std::move(mod));
-  }
-  std::string style_mods_json;
-  base::JSONWriter::Write(style_mods_list, &style_mods_json);
-  
   base::Value::List content_mods_list;
   for (const auto& [selector, content_changes] : optimizations.content_modifications) {
     base::Value::Dict mod;
@@ -509,27 +932,68 @@ void AdaptiveRenderingEngine::ApplyOptimizations(
   }
   std::string content_mods_json;
   base::JSONWriter::Write(content_mods_list, &content_mods_json);
-  
-  base::Value::List visibility_mods_list;
-  for (const auto& [selector, is_visible] : optimizations.visibility_modifications) {
-    base::Value::Dict mod;
-    mod.Set("selector", selector);
-    mod.Set("is_visible", is_visible);
-    visibility_mods_list.Append(std::move(mod));
-  }
-  std::string visibility_mods_json;
-  base::JSONWriter::Write(visibility_mods_list, &visibility_mods_json);
+
+  std::string stylesheet_json;
+  base::JSONWriter::Write(base::Value(BuildStylesheet(optimizations)),
+                          &stylesheet_json);
+  std::string custom_js_json;
+  base::JSONWriter::Write(base::Value(optimizations.custom_js),
+                          &custom_js_json);
   
   // Create the JavaScript to apply optimizations
   std::string script = kApplyOptimizationsScriptTemplate;
-  base::ReplaceSubstringsAfterOffset(&script, 0, "$STYLE_MODIFICATIONS", style_mods_json);
+  base::ReplaceSubstringsAfterOffset(&script, 0, "$MEASURE_MS",
+                                     base::NumberToString(kMeasureEffectMs));
+  base::ReplaceSubstringsAfterOffset(&script, 0, "$STYLESHEET", stylesheet_json);
   base::ReplaceSubstringsAfterOffset(&script, 0, "$CONTENT_MODIFICATIONS", content_mods_json);
-  base::ReplaceSubstringsAfterOffset(&script, 0, "$VISIBILITY_MODIFICATIONS", visibility_mods_json);
-  base::ReplaceSubstringsAfterOffset(&script, 0, "$CUSTOM_CSS", optimizations.custom_css);
-  base::ReplaceSubstringsAfterOffset(&script, 0, "$CUSTOM_JS", optimizations.custom_js);
+  base::ReplaceSubstringsAfterOffset(&script, 0, "$CUSTOM_JS", custom_js_json);
   
-  // Execute the script
-  web_contents->ExecuteJavaScript(script, base::DoNothing());
+  // Execute the script, then judge the optimizations by their effect
+  web_contents->ExecuteJavaScript(
+      script,
+      base::BindOnce(&AdaptiveRenderingEngine::OnOptimizationsMeasured,
+                     weak_ptr_factory_.GetWeakPtr(),
+                     optimizations.template_key));
+}
+
+void AdaptiveRenderingEngine::OnOptimizationsMeasured(
+    uint64_t template_key,
+    const WebContents::JavaScriptResult& result) {
+  if (!result.success || template_key == 0) {
+    return;
+  }
+  absl::optional<base::Value> json = base::JSONReader::Read(result.result);
+  if (!json || !json->is_dict()) {
+    return;
+  }
+  const base::Value::Dict& dict = json->GetDict();
+  double bytes_saved = dict.FindDouble("bytes_saved").value_or(0.0);
+  double bytes_transferred =
+      dict.FindDouble("bytes_transferred").value_or(0.0);
+  double saved_share = bytes_saved > 0
+                           ? bytes_saved / (bytes_saved + bytes_transferred)
+                           : 0.0;
+  double layout_shift = dict.FindDouble("cls_added").value_or(0.0);
+  double long_task_ms = dict.FindDouble("long_task_ms_added").value_or(0.0);
+  double paint_delay_ms = dict.FindDouble("lcp_delay_ms").value_or(0.0);
+  double cost = kLayoutShiftCost * layout_shift +
+                kLongTaskCostPerMs * long_task_ms +
+                kPaintDelayCostPerMs * paint_delay_ms;
+  double measured = saved_share - cost;
+
+  auto it = template_index_.find(template_key);
+  if (it == template_index_.end()) {
+    return;
+  }
+  // Optimizations that made the page slower are dropped; the next page
+  // of the template is analyzed afresh
+  if (measured < 0) {
+    template_cache_.erase(it->second);
+    template_index_.erase(it);
+    return;
+  }
+  it->second->second.estimated_performance_improvement =
+      static_cast<float>(std::min(measured, 1.0));
 }
 
 void AdaptiveRenderingEngine::UpdateCognitiveProfile(const CognitiveProfile& profile) {
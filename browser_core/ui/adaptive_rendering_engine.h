@@ -5,16 +5,21 @@
 #ifndef BROWSER_CORE_UI_ADAPTIVE_RENDERING_ENGINE_H_
 #define BROWSER_CORE_UI_ADAPTIVE_RENDERING_ENGINE_H_
 
+#include <stdint.h>
+
+#include <list>
 #include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
 #include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "browser_core/engine/web_contents.h"
 #include "asol/core/ai_service_manager.h"
 #include "asol/core/context_manager.h"
+#include "browser_core/content/page_snapshot_service.h"
 
 namespace browser_core {
 namespace ui {
@@ -61,7 +66,10 @@ class AdaptiveRenderingEngine {
     std::string custom_css;
     std::string custom_js;
     float estimated_cognitive_load_reduction;
+    // The AI's guess at first; once applied, what was measured
     float estimated_performance_improvement;
+    // Page template the optimizations are cached for, or 0
+    uint64_t template_key = 0;
   };
 
   // Callback for layout analysis
@@ -79,12 +87,37 @@ class AdaptiveRenderingEngine {
   bool Initialize(asol::core::AIServiceManager* ai_service_manager,
                 asol::core::ContextManager* context_manager);
 
-  // Analyze page layout and suggest optimizations
+  // Read pages through |snapshot_service|, shared with the other features
+  // that read them, so a page is extracted once. Call before Initialize(),
+  // which otherwise creates a service of its own.
+  void SetPageSnapshotService(
+      scoped_refptr<content::PageSnapshotService> snapshot_service);
+
+  // Analyze page layout and suggest optimizations. Optimizations are kept
+  // per page template, device class and cognitive profile, so further
+  // pages built on a template seen before get them without an AI call.
   void AnalyzeLayout(WebContents* web_contents,
                    const DeviceCapabilities& device_capabilities,
                    LayoutAnalysisCallback callback);
 
-  // Apply optimizations to the rendered page
+  // Optimizations that follow from |device_capabilities| and the cognitive
+  // profile alone: reduced motion and data, text scaling and hiding
+  // clutter on small screens. Computed locally, without the page; the
+  // estimated performance improvement is scaled by how past measurements
+  // compared to estimates.
+  LayoutOptimizations ComputeRuleBasedOptimizations(
+      const DeviceCapabilities& device_capabilities) const;
+
+  // Apply rule-based optimizations at once, then analyze the page and
+  // apply the AI's refinements, which take precedence, once they arrive.
+  // |callback| gets the refinements.
+  void AdaptLayout(WebContents* web_contents,
+                   const DeviceCapabilities& device_capabilities,
+                   LayoutAnalysisCallback callback);
+
+  // Apply optimizations to the rendered page, then measure their effect on
+  // rendering. Cached optimizations that made a page slower are dropped;
+  // the others keep the improvement measured.
   void ApplyOptimizations(WebContents* web_contents,
                         const LayoutOptimizations& optimizations);
 
@@ -102,6 +135,49 @@ class AdaptiveRenderingEngine {
   base::WeakPtr<AdaptiveRenderingEngine> GetWeakPtr();
 
  private:
+  // Apply rule-based optimizations, measuring what they change
+  void ApplyRuleBasedOptimizations(
+      WebContents* web_contents,
+      const DeviceCapabilities& device_capabilities);
+
+  // Fold the measured effect of rules expected to save |expected_impact|
+  // into |rule_impact_scale_|
+  void OnRulesApplied(const DeviceCapabilities& device_capabilities,
+                      float expected_impact,
+                      const WebContents::JavaScriptResult& result);
+
+  // Score the effect measured for optimizations of |template_key| and
+  // update or drop its cache entry
+  void OnOptimizationsMeasured(uint64_t template_key,
+                               const WebContents::JavaScriptResult& result);
+
+  // Share of page cost the rules for |device_capabilities| should save,
+  // before scaling
+  float GetRuleImpact(const DeviceCapabilities& device_capabilities) const;
+
+  using TemplateCache = std::list<std::pair<uint64_t, LayoutOptimizations>>;
+
+  // Look up the template |result| signs, or analyze the page
+  void OnLayoutSignature(WebContents* web_contents,
+                         const DeviceCapabilities& device_capabilities,
+                         LayoutAnalysisCallback callback,
+                         const WebContents::JavaScriptResult& result);
+
+  // Cache successful |optimizations| for template |key| and pass them on
+  void OnTemplateOptimized(uint64_t key,
+                           LayoutAnalysisCallback callback,
+                           const LayoutOptimizations& optimizations);
+
+  // Cached optimizations for template |key|, promoted, or null
+  const LayoutOptimizations* FindTemplateOptimizations(uint64_t key);
+  void AddTemplateOptimizations(uint64_t key,
+                                const LayoutOptimizations& optimizations);
+
+  // Extract the page and have the AI suggest optimizations for it
+  void ExtractAndOptimize(WebContents* web_contents,
+                          const DeviceCapabilities& device_capabilities,
+                          LayoutAnalysisCallback callback);
+
   // Helper methods
   void ExtractLayoutElements(WebContents* web_contents,
                            base::OnceCallback<void(const std::string&)> callback);
@@ -120,11 +196,19 @@ class AdaptiveRenderingEngine {
   // Components
   asol::core::AIServiceManager* ai_service_manager_ = nullptr;
   asol::core::ContextManager* context_manager_ = nullptr;
+  scoped_refptr<content::PageSnapshotService> snapshot_service_;
 
   // State
   bool is_enabled_ = true;
   CognitiveProfile cognitive_profile_;
 
+  // Measured over estimated savings of rule-based optimizations, averaged
+  float rule_impact_scale_ = 1.0f;
+
+  // Optimizations by template key, most recently used first
+  TemplateCache template_cache_;
+  std::unordered_map<uint64_t, TemplateCache::iterator> template_index_;
+
   // For weak pointers
   base::WeakPtrFactory<AdaptiveRenderingEngine> weak_ptr_factory_{this};
 };
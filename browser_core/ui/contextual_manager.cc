@@ -11,10 +11,15 @@
 #include <ctime>
 #include <iomanip>
 
+#include "base/functional/callback_helpers.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/location.h"
 #include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/time.h"
 #include "base/values.h"
+#include "browser_core/engine/navigation_predictor.h"
 #include "browser_core/engine/tab.h"
 #include "browser_core/engine/web_contents.h"
 
@@ -47,6 +52,10 @@ constexpr char kContextSuggestionsPrompt[] =
     "title, description, type (one of: NAVIGATION, SEARCH, CONTENT, TOOL, REMINDER), "
     "action_url, and relevance_score (float 0.0-1.0).";
 
+// How long the user stays on a page before it is analyzed; pages passed
+// through faster, e.g. flicking through tabs, only get local signals
+constexpr base::TimeDelta kContextSettleDelay = base::Milliseconds(800);
+
 // Helper function to generate a unique ID
 std::string GenerateUniqueId(const std::string& prefix) {
   static int counter = 0;
@@ -65,8 +74,18 @@ std::string FormatTimestamp(const std::chrono::system_clock::time_point& time_po
 
 }  // namespace
 
+ContextualManager::SharedContextSnapshot::SharedContextSnapshot() = default;
+
+ContextualManager::SharedContextSnapshot::SharedContextSnapshot(
+    ContextSnapshot snapshot)
+    : snapshot_(std::move(snapshot)) {}
+
+ContextualManager::SharedContextSnapshot::~SharedContextSnapshot() = default;
+
 ContextualManager::ContextualManager() = default;
-ContextualManager::~ContextualManager() = default;
+ContextualManager::~ContextualManager() {
+  SetPageAnalysisQueue(nullptr);
+}
 
 bool ContextualManager::Initialize(
     BrowserEngine* browser_engine,
@@ -83,7 +102,7 @@ bool ContextualManager::Initialize(
   content_understanding_ = content_understanding;
   
   // Initialize current context
-  current_context_.timestamp = std::chrono::system_clock::now();
+  MutableContext().timestamp = std::chrono::system_clock::now();
   
   return true;
 }
@@ -96,49 +115,242 @@ void ContextualManager::UpdateContext(
     return;
   }
 
-  // Store previous context in history (limit history size)
-  if (context_history_.size() >= 20) {
-    context_history_.erase(context_history_.begin());
-  }
-  context_history_.push_back(current_context_);
+  // Whether tasks need detecting again follows from what changed with
+  // the page being left
+  bool needs_detection = TrackPageLeft();
+  RecordContextHistory();
   
   // Update current context with basic information
-  current_context_.active_url = url;
-  current_context_.active_tab_title = title;
-  current_context_.timestamp = std::chrono::system_clock::now();
+  ContextSnapshot& context = MutableContext();
+  context.active_url = url;
+  context.active_tab_title = title;
+  context.timestamp = std::chrono::system_clock::now();
   
   // Clear previous entities and topics
-  current_context_.entities.clear();
-  current_context_.topics.clear();
-  
-  // Analyze page content to update context
-  AnalyzePageContent(url, title, content);
+  context.entities.clear();
+  context.topics.clear();
+  ++context_epoch_;
   
-  // Periodically detect user tasks
-  // In a real implementation, this would be throttled and possibly done in the background
-  if (context_history_.size() % 5 == 0) {
+  // Analysis, and any task detection, waits until the user settles
+  task_detection_pending_ |= needs_detection;
+  pending_content_ = content;
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&ContextualManager::OnContextSettled,
+                     weak_ptr_factory_.GetWeakPtr(), ++update_generation_),
+      kContextSettleDelay);
+}
+
+void ContextualManager::OnContextSettled(uint64_t generation) {
+  // Superseded by a later update
+  if (generation != update_generation_ || !is_enabled_) {
+    return;
+  }
+
+  std::string content = std::move(pending_content_);
+  pending_content_.clear();
+  AnalyzePageContent(current_context_->get().active_url,
+                     current_context_->get().active_tab_title, content);
+
+  if (task_detection_pending_) {
+    task_detection_pending_ = false;
     DetectUserTasks();
   }
 }
 
+bool ContextualManager::TrackPageLeft() {
+  if (current_context_->get().active_url.empty()) {
+    return false;
+  }
+
+  TaskActivityTracker::Visit visit;
+  visit.url = current_context_->get().active_url;
+  for (const ContextTopic& topic : current_context_->get().topics) {
+    visit.topics.push_back(topic.name.Folded());
+  }
+  visit.dwell = base::Milliseconds(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now() - current_context_->get().timestamp)
+          .count());
+  visit.time = base::Time::Now();
+
+  std::vector<TaskActivityTracker::Task> tasks;
+  std::vector<UserTask*> active_tasks;
+  for (UserTask& task : user_tasks_) {
+    if (task.is_completed) {
+      continue;
+    }
+    TaskActivityTracker::Task& tracked = tasks.emplace_back();
+    tracked.id = task.id;
+    for (const ContextTopic& topic : task.related_topics) {
+      tracked.topics.push_back(topic.name.Folded());
+    }
+    tracked.confidence = task.confidence_score;
+    active_tasks.push_back(&task);
+  }
+
+  TaskActivityTracker::Update update = task_tracker_.AddVisit(visit, tasks);
+  for (size_t i = 0; i < active_tasks.size(); ++i) {
+    active_tasks[i]->confidence_score = update.confidences[i];
+  }
+  UpdateActiveTasks();
+  return update.needs_detection;
+}
+
+void ContextualManager::RecordContextHistory() {
+  // Overwrite the oldest entry once full, reusing its buffers
+  size_t slot = (history_start_ + history_size_) % kContextHistorySize;
+  if (history_size_ == kContextHistorySize) {
+    history_start_ = (history_start_ + 1) % kContextHistorySize;
+  } else {
+    ++history_size_;
+  }
+
+  const ContextSnapshot& context = current_context_->get();
+  HistoryEntry& entry = context_history_[slot];
+  entry.active_url = context.active_url;
+  entry.active_tab_title = context.active_tab_title;
+  entry.timestamp = context.timestamp;
+  entry.topics.clear();
+  for (const ContextTopic& topic : context.topics) {
+    if (entry.topics.size() == kMaxHistoryTopics) {
+      break;
+    }
+    entry.topics.push_back(topic.name);
+  }
+  entry.entities.clear();
+  for (const ContextEntity& entity : context.entities) {
+    if (entry.entities.size() == kMaxHistoryEntities) {
+      break;
+    }
+    entry.entities.emplace_back(entity.name);
+  }
+
+  // Entries share one task list until the tasks change
+  if (!shared_active_tasks_) {
+    shared_active_tasks_ = std::make_shared<const std::vector<UserTask>>(
+        context.active_tasks);
+  }
+  entry.active_tasks = shared_active_tasks_;
+}
+
+const ContextualManager::HistoryEntry& ContextualManager::GetHistoryEntry(
+    size_t index) const {
+  return context_history_[(history_start_ + index) % kContextHistorySize];
+}
+
+void ContextualManager::UpdateActiveTasks() {
+  std::vector<UserTask> active_tasks;
+  for (const auto& task : user_tasks_) {
+    if (!task.is_completed) {
+      active_tasks.push_back(task);
+    }
+  }
+
+  // Confidence and activity times move on every page; suggestions only
+  // depend on which tasks are active and what they are
+  bool changed =
+      !std::equal(active_tasks.begin(), active_tasks.end(),
+                  current_context_->get().active_tasks.begin(),
+                  current_context_->get().active_tasks.end(),
+                  [](const UserTask& a, const UserTask& b) {
+                    return a.id == b.id && a.name == b.name &&
+                           a.description == b.description;
+                  });
+  MutableContext().active_tasks = std::move(active_tasks);
+  shared_active_tasks_.reset();
+  if (changed) {
+    ++context_epoch_;
+  }
+  PredictTaskNavigations();
+}
+
+void ContextualManager::PredictTaskNavigations() {
+  if (!browser_engine_) {
+    return;
+  }
+  // A task's confidence is shared between the pages it may go to next
+  std::vector<NavigationPredictor::Candidate> candidates;
+  for (const UserTask& task : current_context_->get().active_tasks) {
+    size_t first = candidates.size();
+    for (const std::string& url : task.related_urls) {
+      if (url != current_context_->get().active_url) {
+        candidates.push_back({url, task.confidence_score});
+      }
+    }
+    size_t count = candidates.size() - first;
+    for (size_t i = first; i < candidates.size(); ++i) {
+      candidates[i].confidence /= count;
+    }
+  }
+  browser_engine_->GetNavigationPredictor()->SetCandidates(
+      NavigationPredictor::Source::kContextualTasks, std::move(candidates));
+}
+
 void ContextualManager::GetContextSnapshot(ContextSnapshotCallback callback) {
   if (!is_enabled_) {
     ContextSnapshot empty_snapshot;
     empty_snapshot.timestamp = std::chrono::system_clock::now();
-    std::move(callback).Run(empty_snapshot);
+    std::move(callback).Run(
+        base::MakeRefCounted<SharedContextSnapshot>(std::move(empty_snapshot)));
     return;
   }
 
   std::move(callback).Run(current_context_);
 }
 
+ContextualManager::ContextSnapshot& ContextualManager::MutableContext() {
+  if (!current_context_->HasOneRef()) {
+    // A reader holds the published snapshot; update a copy and publish it
+    // in its place
+    current_context_ =
+        base::MakeRefCounted<SharedContextSnapshot>(current_context_->get());
+  }
+  return current_context_->snapshot_;
+}
+
 void ContextualManager::GetContextSuggestions(ContextSuggestionsCallback callback) {
   if (!is_enabled_) {
     std::move(callback).Run({});
     return;
   }
 
-  GenerateContextSuggestions(std::move(callback));
+  // Nothing material has changed since the cached suggestions
+  if (suggestions_epoch_ == context_epoch_) {
+    std::move(callback).Run(cached_suggestions_);
+    return;
+  }
+
+  // Requests for the same context share one generation
+  std::vector<ContextSuggestionsCallback>& waiting =
+      pending_suggestions_[context_epoch_];
+  waiting.push_back(std::move(callback));
+  if (waiting.size() > 1) {
+    return;
+  }
+  GenerateContextSuggestions(
+      base::BindOnce(&ContextualManager::OnContextSuggestionsGenerated,
+                     weak_ptr_factory_.GetWeakPtr(), context_epoch_));
+}
+
+void ContextualManager::OnContextSuggestionsGenerated(
+    uint64_t epoch,
+    const std::vector<ContextSuggestion>& suggestions) {
+  // Empty means failed, or nothing to suggest yet; ask again next time
+  if (epoch == context_epoch_ && !suggestions.empty()) {
+    cached_suggestions_ = suggestions;
+    suggestions_epoch_ = epoch;
+  }
+
+  auto it = pending_suggestions_.find(epoch);
+  if (it == pending_suggestions_.end()) {
+    return;
+  }
+  std::vector<ContextSuggestionsCallback> callbacks = std::move(it->second);
+  pending_suggestions_.erase(it);
+  for (ContextSuggestionsCallback& callback : callbacks) {
+    std::move(callback).Run(suggestions);
+  }
 }
 
 void ContextualManager::GetUserTasks(UserTasksCallback callback) {
@@ -170,12 +382,12 @@ void ContextualManager::CreateUserTask(
   task.is_completed = false;
   
   // Add current URL to related URLs
-  if (!current_context_.active_url.empty()) {
-    task.related_urls.push_back(current_context_.active_url);
+  if (!current_context_->get().active_url.empty()) {
+    task.related_urls.push_back(current_context_->get().active_url);
   }
   
   // Add current topics to related topics
-  for (const auto& topic : current_context_.topics) {
+  for (const auto& topic : current_context_->get().topics) {
     ContextTopic related_topic;
     related_topic.name = topic.name;
     related_topic.relevance_score = topic.relevance_score;
@@ -185,13 +397,7 @@ void ContextualManager::CreateUserTask(
   // Add to user tasks
   user_tasks_.push_back(task);
   
-  // Update active tasks in current context
-  current_context_.active_tasks.clear();
-  for (const auto& task : user_tasks_) {
-    if (!task.is_completed) {
-      current_context_.active_tasks.push_back(task);
-    }
-  }
+  UpdateActiveTasks();
   
   std::move(callback).Run(user_tasks_);
 }
@@ -210,14 +416,9 @@ void ContextualManager::CompleteUserTask(
       break;
     }
   }
+  task_tracker_.RemoveTask(task_id);
   
-  // Update active tasks in current context
-  current_context_.active_tasks.clear();
-  for (const auto& task : user_tasks_) {
-    if (!task.is_completed) {
-      current_context_.active_tasks.push_back(task);
-    }
-  }
+  UpdateActiveTasks();
   
   std::move(callback).Run(user_tasks_);
 }
@@ -238,85 +439,131 @@ void ContextualManager::AnalyzePageContent(
     const std::string& url,
     const std::string& title,
     const std::string& content) {
+  // The shared queue throttles analyses and answers OnPageAnalyzed()
+  if (page_analysis_queue_) {
+    page_analysis_queue_->Enqueue(url, content);
+    return;
+  }
+
   // Use content understanding to analyze the page
   content_understanding_->AnalyzeContent(
-      content,
-      base::BindOnce([](
-          ContextualManager* self,
-          std::string url,
-          std::string title,
-          const ai::ContentUnderstanding::AnalysisResult& result) {
-        if (!result.success) {
-          return;
-        }
-        
-        // Update context with topics
-        for (const auto& topic : result.topics) {
-          ContextTopic context_topic;
-          context_topic.name = topic.name;
-          context_topic.relevance_score = topic.confidence;
-          self->current_context_.topics.push_back(context_topic);
-        }
-        
-        // Update context with entities
-        for (const auto& entity : result.entities) {
-          ContextEntity context_entity;
-          context_entity.name = entity.name;
-          context_entity.type = entity.type;
-          context_entity.relevance_score = entity.confidence;
-          self->current_context_.entities.push_back(context_entity);
-        }
-        
-        // Update user tasks with current URL if relevant
-        for (auto& task : self->user_tasks_) {
-          if (task.is_completed) {
-            continue;
-          }
-          
-          // Check if current page is relevant to any active task
-          bool is_relevant = false;
-          
-          // Check if topics match
-          for (const auto& task_topic : task.related_topics) {
-            for (const auto& page_topic : result.topics) {
-              if (base::ToLowerASCII(task_topic.name) == base::ToLowerASCII(page_topic.name)) {
-                is_relevant = true;
-                break;
-              }
-            }
-            if (is_relevant) break;
-          }
-          
-          if (is_relevant) {
-            // Add URL to task if not already present
-            if (std::find(task.related_urls.begin(), task.related_urls.end(), url) == task.related_urls.end()) {
-              task.related_urls.push_back(url);
-            }
-            
-            // Update last activity time
-            task.last_activity_time = std::chrono::system_clock::now();
-          }
-        }
-        
-        // Update active tasks in current context
-        self->current_context_.active_tasks.clear();
-        for (const auto& task : self->user_tasks_) {
-          if (!task.is_completed) {
-            self->current_context_.active_tasks.push_back(task);
-          }
+      content, base::BindOnce(&ContextualManager::ApplyPageAnalysis,
+                              weak_ptr_factory_.GetWeakPtr(), url));
+}
+
+void ContextualManager::SetPageAnalysisQueue(ai::PageAnalysisQueue* queue) {
+  if (page_analysis_queue_) {
+    page_analysis_queue_->RemoveObserver(this);
+  }
+  page_analysis_queue_ = queue;
+  if (page_analysis_queue_) {
+    page_analysis_queue_->AddObserver(this);
+  }
+}
+
+void ContextualManager::OnPageAnalyzed(
+    const std::string& url,
+    const ai::ContentUnderstanding::ContentAnalysisResult& result) {
+  // Analyses of pages visited before the current one are out of date
+  if (url != current_context_->get().active_url) {
+    return;
+  }
+  ApplyPageAnalysis(url, result);
+}
+
+void ContextualManager::ApplyPageAnalysis(
+    const std::string& url,
+    const ai::ContentUnderstanding::ContentAnalysisResult& result) {
+  if (!result.success) {
+    return;
+  }
+  ++context_epoch_;
+  
+  // Update context with topics
+  std::vector<asol::core::Symbol> page_topics;
+  for (const auto& topic : result.topics) {
+    ContextTopic context_topic;
+    context_topic.name = asol::core::Symbol(topic.name);
+    context_topic.relevance_score = topic.relevance;
+    MutableContext().topics.push_back(context_topic);
+    page_topics.push_back(context_topic.name.Folded());
+  }
+  
+  // Update context with entities
+  for (const auto& entity : result.entities) {
+    ContextEntity context_entity;
+    context_entity.name = entity.name;
+    context_entity.type = entity.type;
+    context_entity.relevance_score = entity.confidence;
+    MutableContext().entities.push_back(context_entity);
+  }
+  
+  // Update user tasks with current URL if relevant
+  for (auto& task : user_tasks_) {
+    if (task.is_completed) {
+      continue;
+    }
+    
+    // Check if current page is relevant to any active task
+    bool is_relevant = false;
+    
+    // Check if topics match
+    for (const auto& task_topic : task.related_topics) {
+      for (asol::core::Symbol page_topic : page_topics) {
+        if (task_topic.name.Folded() == page_topic) {
+          is_relevant = true;
+          break;
         }
-      }, this, url, title));
+      }
+      if (is_relevant) break;
+    }
+    
+    if (is_relevant) {
+      // Add URL to task if not already present
+      if (std::find(task.related_urls.begin(), task.related_urls.end(), url) == task.related_urls.end()) {
+        task.related_urls.push_back(url);
+      }
+      
+      // Update last activity time
+      task.last_activity_time = std::chrono::system_clock::now();
+    }
+  }
+  
+  UpdateActiveTasks();
+}
+
+void ContextualManager::SetRequestScheduler(
+    asol::core::RequestScheduler* scheduler) {
+  request_scheduler_ = scheduler;
 }
 
 void ContextualManager::DetectUserTasks() {
-  if (context_history_.empty()) {
+  if (history_size_ == 0) {
+    return;
+  }
+
+  if (!request_scheduler_) {
+    RunUserTaskDetection(base::DoNothing());
+    return;
+  }
+
+  // Nobody waits on task detection; a shed run is picked up by the next
+  // page update
+  request_scheduler_->Schedule(
+      asol::core::RequestPriority::BACKGROUND,
+      base::BindOnce(&ContextualManager::RunUserTaskDetection,
+                     weak_ptr_factory_.GetWeakPtr()));
+}
+
+void ContextualManager::RunUserTaskDetection(base::OnceClosure done) {
+  if (history_size_ == 0) {
     return;
   }
 
   // Build browsing activity for the prompt
   std::stringstream browsing_activity_stream;
-  for (size_t i = 0; i < context_history_.size(); ++i) {
-    const auto& context = context_history_[i];
+  for (size_t i = 0; i < history_size_; ++i) {
+    const HistoryEntry& context = GetHistoryEntry(i);
     browsing_activity_stream << "Page " << i + 1 << ": " 
                            << context.active_tab_title 
                            << " (" << context.active_url << ")"
@@ -324,9 +571,9 @@ void ContextualManager::DetectUserTasks() {
     
     if (!context.topics.empty()) {
       browsing_activity_stream << ", Topics: ";
-      for (size_t j = 0; j < context.topics.size() && j < 3; ++j) {
+      for (size_t j = 0; j < context.topics.size(); ++j) {
         if (j > 0) browsing_activity_stream << ", ";
-        browsing_activity_stream << context.topics[j].name;
+        browsing_activity_stream << context.topics[j];
       }
     }
     
@@ -339,6 +586,7 @@ void ContextualManager::DetectUserTasks() {
       base::BindOnce([](
           ContextualManager* self,
           std::string browsing_activity,
+          base::OnceClosure done,
           const asol::core::ContextManager::UserContext& user_context) {
         // Build user interests string
         std::stringstream interests_stream;
@@ -358,7 +606,9 @@ void ContextualManager::DetectUserTasks() {
             prompt,
             base::BindOnce([](
                 ContextualManager* self,
+                base::OnceClosure done,
                 const asol::core::TextAdapter::GenerateTextResult& text_result) {
+              std::move(done).Run();
               if (!text_result.success) {
                 return;
               }
@@ -408,7 +658,7 @@ void ContextualManager::DetectUserTasks() {
                   for (const auto& topic_value : *topics_list) {
                     if (topic_value.is_string()) {
                       ContextTopic topic;
-                      topic.name = topic_value.GetString();
+                      topic.name = asol::core::Symbol(topic_value.GetString());
                       topic.relevance_score = 0.8f;  // Default relevance
                       task.related_topics.push_back(topic);
                     }
@@ -457,7 +707,7 @@ void ContextualManager::DetectUserTasks() {
                     for (const auto& topic : detected_task.related_topics) {
                       bool topic_exists = false;
                       for (const auto& existing_topic : existing_task.related_topics) {
-                        if (base::ToLowerASCII(existing_topic.name) == base::ToLowerASCII(topic.name)) {
+                        if (existing_topic.name.EqualsIgnoreCase(topic.name)) {
                           topic_exists = true;
                           break;
                         }
@@ -478,44 +728,38 @@ void ContextualManager::DetectUserTasks() {
                 }
               }
               
-              // Update active tasks in current context
-              self->current_context_.active_tasks.clear();
-              for (const auto& task : self->user_tasks_) {
-                if (!task.is_completed) {
-                  self->current_context_.active_tasks.push_back(task);
-                }
-              }
-            }, self));
-      }, this, browsing_activity));
+              self->UpdateActiveTasks();
+            }, self, std::move(done)));
+      }, this, browsing_activity, std::move(done)));
 }
 
 void ContextualManager::GenerateContextSuggestions(ContextSuggestionsCallback callback) {
-  if (current_context_.active_url.empty()) {
+  if (current_context_->get().active_url.empty()) {
     std::move(callback).Run({});
     return;
   }
 
   // Build entities string
   std::stringstream entities_stream;
-  for (size_t i = 0; i < current_context_.entities.size(); ++i) {
+  for (size_t i = 0; i < current_context_->get().entities.size(); ++i) {
     if (i > 0) entities_stream << ", ";
-    entities_stream << current_context_.entities[i].name << " (" << current_context_.entities[i].type << ")";
+    entities_stream << current_context_->get().entities[i].name << " (" << current_context_->get().entities[i].type << ")";
   }
   std::string entities = entities_stream.str();
   
   // Build topics string
   std::stringstream topics_stream;
-  for (size_t i = 0; i < current_context_.topics.size(); ++i) {
+  for (size_t i = 0; i < current_context_->get().topics.size(); ++i) {
     if (i > 0) topics_stream << ", ";
-    topics_stream << current_context_.topics[i].name;
+    topics_stream << current_context_->get().topics[i].name;
   }
   std::string topics = topics_stream.str();
   
   // Build active tasks string
   std::stringstream tasks_stream;
-  for (size_t i = 0; i < current_context_.active_tasks.size(); ++i) {
+  for (size_t i = 0; i < current_context_->get().active_tasks.size(); ++i) {
     if (i > 0) tasks_stream << "; ";
-    tasks_stream << current_context_.active_tasks[i].name << ": " << current_context_.active_tasks[i].description;
+    tasks_stream << current_context_->get().active_tasks[i].name << ": " << current_context_->get().active_tasks[i].description;
   }
   std::string active_tasks = tasks_stream.str();
   
@@ -634,7 +878,7 @@ void ContextualManager::GenerateContextSuggestions(ContextSuggestionsCallback ca
               
               std::move(callback).Run(context_suggestions);
             }, self, std::move(callback)));
-      }, this, current_context_.active_url, current_context_.active_tab_title, 
+      }, this, current_context_->get().active_url, current_context_->get().active_tab_title, 
       entities, topics, active_tasks, std::move(callback)));
 }
 
@@ -652,10 +896,15 @@ void ContextualManager::GenerateContextSuggestions(ContextSuggestionsCallback ca
 #include <ctime>
 #include <iomanip>
 
+#include "base/functional/callback_helpers.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/location.h"
 #include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/time.h"
 #include "base/values.h"
+#include "browser_core/engine/navigation_predictor.h"
 #include "browser_core/engine/tab.h"
 #include "browser_core/engine/web_contents.h"
 
@@ -688,6 +937,10 @@ constexpr char kContextSuggestionsPrompt[] =
     "title, description, type (one of: NAVIGATION, SEARCH, CONTENT, TOOL, REMINDER), "
     "action_url, and relevance_score (float 0.0-1.0).";
 
+// How long the user stays on a page before it is analyzed; pages passed
+// through faster, e.g. flicking through tabs, only get local signals
+constexpr base::TimeDelta kContextSettleDelay = base::Milliseconds(800);
+
 // Helper function to generate a unique ID
 std::string GenerateUniqueId(const std::string& prefix) {
   static int counter = 0;
@@ -706,8 +959,18 @@ std::string FormatTimestamp(const std::chrono::system_clock::time_point& time_po
 
 }  // namespace
 
+ContextualManager::SharedContextSnapshot::SharedContextSnapshot() = default;
+
+ContextualManager::SharedContextSnapshot::SharedContextSnapshot(
+    ContextSnapshot snapshot)
+    : snapshot_(std::move(snapshot)) {}
+
+ContextualManager::SharedContextSnapshot::~SharedContextSnapshot() = default;
+
 ContextualManager::ContextualManager() = default;
-ContextualManager::~ContextualManager() = default;
+ContextualManager::~ContextualManager() {
+  SetPageAnalysisQueue(nullptr);
+}
 
 bool ContextualManager::Initialize(
     BrowserEngine* browser_engine,
@@ -724,7 +987,7 @@ bool ContextualManager::Initialize(
   content_understanding_ = content_understanding;
   
   // Initialize current context
-  current_context_.timestamp = std::chrono::system_clock::now();
+  MutableContext().timestamp = std::chrono::system_clock::now();
   
   return true;
 }
@@ -737,49 +1000,242 @@ void ContextualManager::UpdateContext(
     return;
   }
 
-  // Store previous context in history (limit history size)
-  if (context_history_.size() >= 20) {
-    context_history_.erase(context_history_.begin());
-  }
-  context_history_.push_back(current_context_);
+  // Whether tasks need detecting again follows from what changed with
+  // the page being left
+  bool needs_detection = TrackPageLeft();
+  RecordContextHistory();
   
   // Update current context with basic information
-  current_context_.active_url = url;
-  current_context_.active_tab_title = title;
-  current_context_.timestamp = std::chrono::system_clock::now();
+  ContextSnapshot& context = MutableContext();
+  context.active_url = url;
+  context.active_tab_title = title;
+  context.timestamp = std::chrono::system_clock::now();
   
   // Clear previous entities and topics
-  current_context_.entities.clear();
-  current_context_.topics.clear();
-  
-  // Analyze page content to update context
-  AnalyzePageContent(url, title, content);
+  context.entities.clear();
+  context.topics.clear();
+  ++context_epoch_;
   
-  // Periodically detect user tasks
-  // In a real implementation, this would be throttled and possibly done in the background
-  if (context_history_.size() % 5 == 0) {
+  // Analysis, and any task detection, waits until the user settles
+  task_detection_pending_ |= needs_detection;
+  pending_content_ = content;
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&ContextualManager::OnContextSettled,
+                     weak_ptr_factory_.GetWeakPtr(), ++update_generation_),
+      kContextSettleDelay);
+}
+
+void ContextualManager::OnContextSettled(uint64_t generation) {
+  // Superseded by a later update
+  if (generation != update_generation_ || !is_enabled_) {
+    return;
+  }
+
+  std::string content = std::move(pending_content_);
+  pending_content_.clear();
+  AnalyzePageContent(current_context_->get().active_url,
+                     current_context_->get().active_tab_title, content);
+
+  if (task_detection_pending_) {
+    task_detection_pending_ = false;
     DetectUserTasks();
   }
 }
 
+bool ContextualManager::TrackPageLeft() {
+  if (current_context_->get().active_url.empty()) {
+    return false;
+  }
+
+  TaskActivityTracker::Visit visit;
+  visit.url = current_context_->get().active_url;
+  for (const ContextTopic& topic : current_context_->get().topics) {
+    visit.topics.push_back(topic.name.Folded());
+  }
+  visit.dwell = base::Milliseconds(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now() - current_context_->get().timestamp)
+          .count());
+  visit.time = base::Time::Now();
+
+  std::vector<TaskActivityTracker::Task> tasks;
+  std::vector<UserTask*> active_tasks;
+  for (UserTask& task : user_tasks_) {
+    if (task.is_completed) {
+      continue;
+    }
+    TaskActivityTracker::Task& tracked = tasks.emplace_back();
+    tracked.id = task.id;
+    for (const ContextTopic& topic : task.related_topics) {
+      tracked.topics.push_back(topic.name.Folded());
+    }
+    tracked.confidence = task.confidence_score;
+    active_tasks.push_back(&task);
+  }
+
+  TaskActivityTracker::Update update = task_tracker_.AddVisit(visit, tasks);
+  for (size_t i = 0; i < active_tasks.size(); ++i) {
+    active_tasks[i]->confidence_score = update.confidences[i];
+  }
+  UpdateActiveTasks();
+  return update.needs_detection;
+}
+
+void ContextualManager::RecordContextHistory() {
+  // Overwrite the oldest entry once full, reusing its buffers
+  size_t slot = (history_start_ + history_size_) % kContextHistorySize;
+  if (history_size_ == kContextHistorySize) {
+    history_start_ = (history_start_ + 1) % kContextHistorySize;
+  } else {
+    ++history_size_;
+  }
+
+  const ContextSnapshot& context = current_context_->get();
+  HistoryEntry& entry = context_history_[slot];
+  entry.active_url = context.active_url;
+  entry.active_tab_title = context.active_tab_title;
+  entry.timestamp = context.timestamp;
+  entry.topics.clear();
+  for (const ContextTopic& topic : context.topics) {
+    if (entry.topics.size() == kMaxHistoryTopics) {
+      break;
+    }
+    entry.topics.push_back(topic.name);
+  }
+  entry.entities.clear();
+  for (const ContextEntity& entity : context.entities) {
+    if (entry.entities.size() == kMaxHistoryEntities) {
+      break;
+    }
+    entry.entities.emplace_back(entity.name);
+  }
+
+  // Entries share one task list until the tasks change
+  if (!shared_active_tasks_) {
+    shared_active_tasks_ = std::make_shared<const std::vector<UserTask>>(
+        context.active_tasks);
+  }
+  entry.active_tasks = shared_active_tasks_;
+}
+
+const ContextualManager::HistoryEntry& ContextualManager::GetHistoryEntry(
+    size_t index) const {
+  return context_history_[(history_start_ + index) % kContextHistorySize];
+}
+
+void ContextualManager::UpdateActiveTasks() {
+  std::vector<UserTask> active_tasks;
+  for (const auto& task : user_tasks_) {
+    if (!task.is_completed) {
+      active_tasks.push_back(task);
+    }
+  }
+
+  // Confidence and activity times move on every page; suggestions only
+  // depend on which tasks are active and what they are
+  bool changed =
+      !std::equal(active_tasks.begin(), active_tasks.end(),
+                  current_context_->get().active_tasks.begin(),
+                  current_context_->get().active_tasks.end(),
+                  [](const UserTask& a, const UserTask& b) {
+                    return a.id == b.id && a.name == b.name &&
+                           a.description == b.description;
+                  });
+  MutableContext().active_tasks = std::move(active_tasks);
+  shared_active_tasks_.reset();
+  if (changed) {
+    ++context_epoch_;
+  }
+  PredictTaskNavigations();
+}
+
+void ContextualManager::PredictTaskNavigations() {
+  if (!browser_engine_) {
+    return;
+  }
+  // A task's confidence is shared between the pages it may go to next
+  std::vector<NavigationPredictor::Candidate> candidates;
+  for (const UserTask& task : current_context_->get().active_tasks) {
+    size_t first = candidates.size();
+    for (const std::string& url : task.related_urls) {
+      if (url != current_context_->get().active_url) {
+        candidates.push_back({url, task.confidence_score});
+      }
+    }
+    size_t count = candidates.size() - first;
+    for (size_t i = first; i < candidates.size(); ++i) {
+      candidates[i].confidence /= count;
+    }
+  }
+  browser_engine_->GetNavigationPredictor()->SetCandidates(
+      NavigationPredictor::Source::kContextualTasks, std::move(candidates));
+}
+
 void ContextualManager::GetContextSnapshot(ContextSnapshotCallback callback) {
   if (!is_enabled_) {
     ContextSnapshot empty_snapshot;
     empty_snapshot.timestamp = std::chrono::system_clock::now();
-    std::move(callback).Run(empty_snapshot);
+    std::move(callback).Run(
+        base::MakeRefCounted<SharedContextSnapshot>(std::move(empty_snapshot)));
     return;
   }
 
   std::move(callback).Run(current_context_);
 }
 
+ContextualManager::ContextSnapshot& ContextualManager::MutableContext() {
+  if (!current_context_->HasOneRef()) {
+    // A reader holds the published snapshot; update a copy and publish it
+    // in its place
+    current_context_ =
+        base::MakeRefCounted<SharedContextSnapshot>(current_context_->get());
+  }
+  return current_context_->snapshot_;
+}
+
 void ContextualManager::GetContextSuggestions(ContextSuggestionsCallback callback) {
   if (!is_enabled_) {
     std::move(callback).Run({});
     return;
   }
 
-  GenerateContextSuggestions(std::move(callback));
+  // Nothing material has changed since the cached suggestions
+  if (suggestions_epoch_ == context_epoch_) {
+    std::move(callback).Run(cached_suggestions_);
+    return;
+  }
+
+  // Requests for the same context share one generation
+  std::vector<ContextSuggestionsCallback>& waiting =
+      pending_suggestions_[context_epoch_];
+  waiting.push_back(std::move(callback));
+  if (waiting.size() > 1) {
+    return;
+  }
+  GenerateContextSuggestions(
+      base::BindOnce(&ContextualManager::OnContextSuggestionsGenerated,
+                     weak_ptr_factory_.GetWeakPtr(), context_epoch_));
+}
+
+void ContextualManager::OnContextSuggestionsGenerated(
+    uint64_t epoch,
+    const std::vector<ContextSuggestion>& suggestions) {
+  // Empty means failed, or nothing to suggest yet; ask again next time
+  if (epoch == context_epoch_ && !suggestions.empty()) {
+    cached_suggestions_ = suggestions;
+    suggestions_epoch_ = epoch;
+  }
+
+  auto it = pending_suggestions_.find(epoch);
+  if (it == pending_suggestions_.end()) {
+    return;
+  }
+  std::vector<ContextSuggestionsCallback> callbacks = std::move(it->second);
+  pending_suggestions_.erase(it);
+  for (ContextSuggestionsCallback& callback : callbacks) {
+    std::move(callback).Run(suggestions);
+  }
 }
 
 void ContextualManager::GetUserTasks(UserTasksCallback callback) {
@@ -811,12 +1267,12 @@ void ContextualManager::CreateUserTask(
   task.is_completed = false;
   
   // Add current URL to related URLs
-  if (!current_context_.active_url.empty()) {
-    task.related_urls.push_back(current_context_.active_url);
+  if (!current_context_->get().active_url.empty()) {
+    task.related_urls.push_back(current_context_->get().active_url);
   }
   
   // Add current topics to related topics
-  for (const auto& topic : current_context_.topics) {
+  for (const auto& topic : current_context_->get().topics) {
     ContextTopic related_topic;
     related_topic.name = topic.name;
     related_topic.relevance_score = topic.relevance_score;
@@ -826,13 +1282,7 @@ void ContextualManager::CreateUserTask(
   // Add to user tasks
   user_tasks_.push_back(task);
   
-  // Update active tasks in current context
-  current_context_.active_tasks.clear();
-  for (const auto& task : user_tasks_) {
-    if (!task.is_completed) {
-      current_context_.active_tasks.push_back(task);
-    }
-  }
+  UpdateActiveTasks();
   
   std::move(callback).Run(user_tasks_);
 }
@@ -851,14 +1301,9 @@ void ContextualManager::CompleteUserTask(
       break;
     }
   }
+  task_tracker_.RemoveTask(task_id);
   
-  // Update active tasks in current context
-  current_context_.active_tasks.clear();
-  for (const auto& task : user_tasks_) {
-    if (!task.is_completed) {
-      current_context_.active_tasks.push_back(task);
-    }
-  }
+  UpdateActiveTasks();
   
   std::move(callback).Run(user_tasks_);
 }
@@ -879,85 +1324,131 @@ void ContextualManager::AnalyzePageContent(
     const std::string& url,
     const std::string& title,
     const std::string& content) {
+  // The shared queue throttles analyses and answers OnPageAnalyzed()
+  if (page_analysis_queue_) {
+    page_analysis_queue_->Enqueue(url, content);
+    return;
+  }
+
   // Use content understanding to analyze the page
   content_understanding_->AnalyzeContent(
-      content,
-      base::BindOnce([](
-          ContextualManager* self,
-          std::string url,
-          std::string title,
-          const ai::ContentUnderstanding::AnalysisResult& result) {
-        if (!result.success) {
-          return;
-        }
-        
-        // Update context with topics
-        for (const auto& topic : result.topics) {
-          ContextTopic context_topic;
-          context_topic.name = topic.name;
-          context_topic.relevance_score = topic.confidence;
-          self->current_context_.topics.push_back(context_topic);
-        }
-        
-        // Update context with entities
-        for (const auto& entity : result.entities) {
-          ContextEntity context_entity;
-          context_entity.name = entity.name;
-          context_entity.type = entity.type;
-          context_entity.relevance_score = entity.confidence;
-          self->current_context_.entities.push_back(context_entity);
-        }
-        
-        // Update user tasks with current URL if relevant
-        for (auto& task : self->user_tasks_) {
-          if (task.is_completed) {
-            continue;
-          }
-          
-          // Check if current page is relevant to any active task
-          bool is_relevant = false;
-          
-          // Check if topics match
-          for (const auto& task_topic : task.related_topics) {
-            for (const auto& page_topic : result.topics) {
-              if (base::ToLowerASCII(task_topic.name) == base::ToLowerASCII(page_topic.name)) {
-                is_relevant = true;
-                break;
-              }
-            }
-            if (is_relevant) break;
-          }
-          
-          if (is_relevant) {
-            // Add URL to task if not already present
-            if (std::find(task.related_urls.begin(), task.related_urls.end(), url) == task.related_urls.end()) {
-              task.related_urls.push_back(url);
-            }
-            
-            // Update last activity time
-            task.last_activity_time = std::chrono::system_clock::now();
-          }
-        }
-        
-        // Update active tasks in current context
-        self->current_context_.active_tasks.clear();
-        for (const auto& task : self->user_tasks_) {
-          if (!task.is_completed) {
-            self->current_context_.active_tasks.push_back(task);
-          }
+      content, base::BindOnce(&ContextualManager::ApplyPageAnalysis,
+                              weak_ptr_factory_.GetWeakPtr(), url));
+}
+
+void ContextualManager::SetPageAnalysisQueue(ai::PageAnalysisQueue* queue) {
+  if (page_analysis_queue_) {
+    page_analysis_queue_->RemoveObserver(this);
+  }
+  page_analysis_queue_ = queue;
+  if (page_analysis_queue_) {
+    page_analysis_queue_->AddObserver(this);
+  }
+}
+
+void ContextualManager::OnPageAnalyzed(
+    const std::string& url,
+    const ai::ContentUnderstanding::ContentAnalysisResult& result) {
+  // Analyses of pages visited before the current one are out of date
+  if (url != current_context_->get().active_url) {
+    return;
+  }
+  ApplyPageAnalysis(url, result);
+}
+
+void ContextualManager::ApplyPageAnalysis(
+    const std::string& url,
+    const ai::ContentUnderstanding::ContentAnalysisResult& result) {
+  if (!result.success) {
+    return;
+  }
+  ++context_epoch_;
+  
+  // Update context with topics
+  std::vector<asol::core::Symbol> page_topics;
+  for (const auto& topic : result.topics) {
+    ContextTopic context_topic;
+    context_topic.name = asol::core::Symbol(topic.name);
+    context_topic.relevance_score = topic.relevance;
+    MutableContext().topics.push_back(context_topic);
+    page_topics.push_back(context_topic.name.Folded());
+  }
+  
+  // Update context with entities
+  for (const auto& entity : result.entities) {
+    ContextEntity context_entity;
+    context_entity.name = entity.name;
+    context_entity.type = entity.type;
+    context_entity.relevance_score = entity.confidence;
+    MutableContext().entities.push_back(context_entity);
+  }
+  
+  // Update user tasks with current URL if relevant
+  for (auto& task : user_tasks_) {
+    if (task.is_completed) {
+      continue;
+    }
+    
+    // Check if current page is relevant to any active task
+    bool is_relevant = false;
+    
+    // Check if topics match
+    for (const auto& task_topic : task.related_topics) {
+      for (asol::core::Symbol page_topic : page_topics) {
+        if (task_topic.name.Folded() == page_topic) {
+          is_relevant = true;
+          break;
         }
-      }, this, url, title));
+      }
+      if (is_relevant) break;
+    }
+    
+    if (is_relevant) {
+      // Add URL to task if not already present
+      if (std::find(task.related_urls.begin(), task.related_urls.end(), url) == task.related_urls.end()) {
+        task.related_urls.push_back(url);
+      }
+      
+      // Update last activity time
+      task.last_activity_time = std::chrono::system_clock::now();
+    }
+  }
+  
+  UpdateActiveTasks();
+}
+
+void ContextualManager::SetRequestScheduler(
+    asol::core::RequestScheduler* scheduler) {
+  request_scheduler_ = scheduler;
 }
 
 void ContextualManager::DetectUserTasks() {
-  if (context_history_.empty()) {
+  if (history_size_ == 0) {
+    return;
+  }
+
+  if (!request_scheduler_) {
+    RunUserTaskDetection(base::DoNothing());
+    return;
+  }
+
+  // Nobody waits on task detection; a shed run is picked up by the next
+  // page update
+  request_scheduler_->Schedule(
+      asol::core::RequestPriority::BACKGROUND,
+      base::BindOnce(&ContextualManager::RunUserTaskDetection,
+                     weak_ptr_factory_.GetWeakPtr()));
+}
+
+void ContextualManager::RunUserTaskDetection(base::OnceClosure done) {
+  if (history_size_ == 0) {
     return;
   }
 
   // Build browsing activity for the prompt
   std::stringstream browsing_activity_stream;
-  for (size_t i = 0; i < context_history_.size(); ++i) {
-    const auto& context = context_history_[i];
+  for (size_t i = 0; i < history_size_; ++i) {
+    const HistoryEntry& context = GetHistoryEntry(i);
     browsing_activity_stream << "Page " << i + 1 << ": " 
                            << context.active_tab_title 
                            << " (" << context.active_url << ")"
@@ -965,9 +1456,9 @@ void ContextualManager::DetectUserTasks() {
     
     if (!context.topics.empty()) {
       browsing_activity_stream << ", Topics: ";
-      for (size_t j = 0; j < context.topics.size() && j < 3; ++j) {
+      for (size_t j = 0; j < context.topics.size(); ++j) {
         if (j > 0) browsing_activity_stream << ", ";
-        browsing_activity_stream << context.topics[j].name;
+        browsing_activity_stream << context.topics[j];
       }
     }
     
@@ -980,6 +1471,7 @@ void ContextualManager::DetectUserTasks() {
       base::BindOnce([](
           ContextualManager* self,
           std::string browsing_activity,
+          base::OnceClosure done,
           const asol::core::ContextManager::UserContext& user_context) {
         // Build user interests string
         std::stringstream interests_stream;
@@ -999,7 +1491,9 @@ void ContextualManager::DetectUserTasks() {
             prompt,
             base::BindOnce([](
                 ContextualManager* self,
+                base::OnceClosure done,
                 const asol::core::TextAdapter::GenerateTextResult& text_result) {
+              std::move(done).Run();
               if (!text_result.success) {
                 return;
               }
@@ -1049,7 +1543,7 @@ void ContextualManager::DetectUserTasks() {
                   for (const auto& topic_value : *topics_list) {
                     if (topic_value.is_string()) {
                       ContextTopic topic;
-                      topic.name = topic_value.GetString();
+                      topic.name = asol::core::Symbol(topic_value.GetString());
                       topic.relevance_score = 0.8f;  // Default relevance
                       task.related_topics.push_back(topic);
                     }
@@ -1098,7 +1592,7 @@ void ContextualManager::DetectUserTasks() {
                     for (const auto& topic : detected_task.related_topics) {
                       bool topic_exists = false;
                       for (const auto& existing_topic : existing_task.related_topics) {
-                        if (base::ToLowerASCII(existing_topic.name) == base::ToLowerASCII(topic.name)) {
+                        if (existing_topic.name.EqualsIgnoreCase(topic.name)) {
                           topic_exists = true;
                           break;
                         }
@@ -1119,44 +1613,38 @@ void ContextualManager::DetectUserTasks() {
                 }
               }
               
-              // Update active tasks in current context
-              self->current_context_.active_tasks.clear();
-              for (const auto& task : self->user_tasks_) {
-                if (!task.is_completed) {
-                  self->current_context_.active_tasks.push_back(task);
-                }
-              }
-            }, self));
-      }, this, browsing_activity));
+              self->UpdateActiveTasks();
+            }, self, std::move(done)));
+      }, this, browsing_activity, std::move(done)));
 }
 
 void ContextualManager::GenerateContextSuggestions(ContextSuggestionsCallback callback) {
-  if (current_context_.active_url.empty()) {
+  if (current_context_->get().active_url.empty()) {
     std::move(callback).Run({});
     return;
   }
 
   // Build entities string
   std::stringstream entities_stream;
-  for (size_t i = 0; i < current_context_.entities.size(); ++i) {
+  for (size_t i = 0; i < current_context_->get().entities.size(); ++i) {
     if (i > 0) entities_stream << ", ";
-    entities_stream << current_context_.entities[i].name << " (" << current_context_.entities[i].type << ")";
+    entities_stream << current_context_->get().entities[i].name << " (" << current_context_->get().entities[i].type << ")";
   }
   std::string entities = entities_stream.str();
   
   // Build topics string
   std::stringstream topics_stream;
-  for (size_t i = 0; i < current_context_.topics.size(); ++i) {
+  for (size_t i = 0; i < current_context_->get().topics.size(); ++i) {
     if (i > 0) topics_stream << ", ";
-    topics_stream << current_context_.topics[i].name;
+    topics_stream << current_context_->get().topics[i].name;
   }
   std::string topics = topics_stream.str();
   
   // Build active tasks string
   std::stringstream tasks_stream;
-  for (size_t i = 0; i < current_context_.active_tasks.size(); ++i) {
+  for (size_t i = 0; i < current_context_->get().active_tasks.size(); ++i) {
     if (i > 0) tasks_stream << "; ";
-    tasks_stream << current_context_.active_tasks[i].name << ": " << current_context_.active_tasks[i].description;
+    tasks_stream << current_context_->get().active_tasks[i].name << ": " << current_context_->get().active_tasks[i].description;
   }
   std::string active_tasks = tasks_stream.str();
   
@@ -1275,7 +1763,7 @@ void ContextualManager::GenerateContextSuggestions(ContextSuggestionsCallback ca
               
               std::move(callback).Run(context_suggestions);
             }, self, std::move(callback)));
-      }, this, current_context_.active_url, current_context_.active_tab_title, 
+      }, this, current_context_->get().active_url, current_context_->get().active_tab_title, 
       entities, topics, active_tasks, std::move(callback)));
 }
 
@@ -5,6 +5,9 @@
 #ifndef BROWSER_CORE_UI_CONTEXTUAL_MANAGER_H_
 #define BROWSER_CORE_UI_CONTEXTUAL_MANAGER_H_
 
+#include <stdint.h>
+
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -12,18 +15,24 @@
 #include <chrono>
 
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "browser_core/ai/content_understanding.h"
+#include "browser_core/ai/page_analysis_queue.h"
 #include "browser_core/engine/browser_engine.h"
+#include "browser_core/ui/task_activity_tracker.h"
 #include "asol/core/ai_service_manager.h"
 #include "asol/core/context_manager.h"
+#include "asol/core/request_scheduler.h"
+#include "asol/core/symbol_table.h"
 
 namespace browser_core {
 namespace ui {
 
 // ContextualManager provides intelligent context-aware browsing assistance
 // by understanding user's current tasks, interests, and browsing patterns.
-class ContextualManager {
+class ContextualManager : public ai::PageAnalysisQueue::Observer {
  public:
   // Context entity representing a recognized entity in the current context
   struct ContextEntity {
@@ -35,7 +44,8 @@ class ContextualManager {
 
   // Context topic representing a recognized topic in the current context
   struct ContextTopic {
-    std::string name;
+    // Interned; compare with EqualsIgnoreCase() rather than by lowercasing
+    asol::core::Symbol name;
     float relevance_score;
     std::vector<std::string> related_topics;
   };
@@ -64,6 +74,29 @@ class ContextualManager {
     std::chrono::system_clock::time_point timestamp;
   };
 
+  // A ContextSnapshot as handed to readers. It never changes once handed
+  // out, so readers may keep it and read it on any sequence; the manager
+  // copies it before its next update while any reader still holds it.
+  class SharedContextSnapshot
+      : public base::RefCountedThreadSafe<SharedContextSnapshot> {
+   public:
+    SharedContextSnapshot();
+    explicit SharedContextSnapshot(ContextSnapshot snapshot);
+
+    SharedContextSnapshot(const SharedContextSnapshot&) = delete;
+    SharedContextSnapshot& operator=(const SharedContextSnapshot&) = delete;
+
+    const ContextSnapshot& get() const { return snapshot_; }
+
+   private:
+    friend class base::RefCountedThreadSafe<SharedContextSnapshot>;
+    friend class ContextualManager;
+
+    ~SharedContextSnapshot();
+
+    ContextSnapshot snapshot_;
+  };
+
   // Context suggestion representing a suggested action based on context
   struct ContextSuggestion {
     enum class Type {
@@ -84,8 +117,8 @@ class ContextualManager {
   };
 
   // Callback for context snapshot
-  using ContextSnapshotCallback = 
-      base::OnceCallback<void(const ContextSnapshot&)>;
+  using ContextSnapshotCallback =
+      base::OnceCallback<void(scoped_refptr<const SharedContextSnapshot>)>;
 
   // Callback for context suggestions
   using ContextSuggestionsCallback = 
@@ -96,7 +129,7 @@ class ContextualManager {
       base::OnceCallback<void(const std::vector<UserTask>&)>;
 
   ContextualManager();
-  ~ContextualManager();
+  ~ContextualManager() override;
 
   // Disallow copy and assign
   ContextualManager(const ContextualManager&) = delete;
@@ -108,15 +141,33 @@ class ContextualManager {
                 asol::core::ContextManager* context_manager,
                 ai::ContentUnderstanding* content_understanding);
 
-  // Update context with current page information
+  // Run task detection as background work through |scheduler| so it does
+  // not compete with user requests. Not owned.
+  void SetRequestScheduler(asol::core::RequestScheduler* scheduler);
+
+  // Take page analyses from |queue|, shared with other features, instead
+  // of requesting one per page. Not owned; null detaches.
+  void SetPageAnalysisQueue(ai::PageAnalysisQueue* queue);
+
+  // ai::PageAnalysisQueue::Observer:
+  void OnPageAnalyzed(
+      const std::string& url,
+      const ai::ContentUnderstanding::ContentAnalysisResult& result) override;
+
+  // Update context with current page information. The page is analyzed
+  // once the user has stayed on it briefly; updates in quick succession
+  // only analyze the last.
   void UpdateContext(const std::string& url, 
                    const std::string& title,
                    const std::string& content);
 
-  // Get current context snapshot
+  // Get current context snapshot. Shares the published snapshot rather
+  // than copying it.
   void GetContextSnapshot(ContextSnapshotCallback callback);
 
-  // Get context-aware suggestions
+  // Get context-aware suggestions. Suggestions are generated once per
+  // context epoch, which moves on with the page, its topics and entities
+  // and the active tasks; until it does they are answered from memory.
   void GetContextSuggestions(ContextSuggestionsCallback callback);
 
   // Get detected user tasks
@@ -138,26 +189,107 @@ class ContextualManager {
   base::WeakPtr<ContextualManager> GetWeakPtr();
 
  private:
+  // Past contexts kept for task detection
+  static constexpr size_t kContextHistorySize = 20;
+  static constexpr size_t kMaxHistoryTopics = 3;
+  static constexpr size_t kMaxHistoryEntities = 5;
+
+  // What history keeps of a ContextSnapshot: names are interned and the
+  // task list is shared with neighbouring entries while it is unchanged
+  struct HistoryEntry {
+    std::string active_url;
+    std::string active_tab_title;
+    std::vector<asol::core::Symbol> topics;
+    std::vector<asol::core::Symbol> entities;
+    std::shared_ptr<const std::vector<UserTask>> active_tasks;
+    std::chrono::system_clock::time_point timestamp;
+  };
+
+  // Analyze the page of the update numbered |generation| if no update has
+  // come since
+  void OnContextSettled(uint64_t generation);
+
   // Helper methods
   void AnalyzePageContent(const std::string& url,
                         const std::string& title,
                         const std::string& content);
+
+  // Add the topics and entities of |result|, analyzed from the page at
+  // |url|, to the current context and the tasks it is relevant to
+  void ApplyPageAnalysis(
+      const std::string& url,
+      const ai::ContentUnderstanding::ContentAnalysisResult& result);
   
+  // Run task detection through AI, for when local tracking finds a new
+  // task candidate or a task's topics shifting
   void DetectUserTasks();
+
+  // Task detection proper; |done| runs once the AI response arrives
+  void RunUserTaskDetection(base::OnceClosure done);
   
   void GenerateContextSuggestions(ContextSuggestionsCallback callback);
 
+  // Cache suggestions generated for |epoch| and answer those waiting
+  void OnContextSuggestionsGenerated(
+      uint64_t epoch,
+      const std::vector<ContextSuggestion>& suggestions);
+
+  // Feed the page being left, with its topics and dwell time, to
+  // |task_tracker_| and apply the task confidences it updates. Returns
+  // whether tasks need detecting again.
+  bool TrackPageLeft();
+
+  // Push the current context into the history ring, evicting the oldest
+  void RecordContextHistory();
+
+  // History entry |index|, oldest first; |index| < |history_size_|
+  const HistoryEntry& GetHistoryEntry(size_t index) const;
+
+  // The current context for updating, copied first if a reader holds it
+  ContextSnapshot& MutableContext();
+
+  // Rebuild the current context's active tasks from |user_tasks_|
+  void UpdateActiveTasks();
+
+  // Offer the URLs of the active tasks to the browser engine's
+  // NavigationPredictor
+  void PredictTaskNavigations();
+
   // Components
   BrowserEngine* browser_engine_ = nullptr;
   asol::core::AIServiceManager* ai_service_manager_ = nullptr;
   asol::core::ContextManager* context_manager_ = nullptr;
   ai::ContentUnderstanding* content_understanding_ = nullptr;
+  asol::core::RequestScheduler* request_scheduler_ = nullptr;
+  ai::PageAnalysisQueue* page_analysis_queue_ = nullptr;
 
   // State
   bool is_enabled_ = true;
-  ContextSnapshot current_context_;
+  // Published to readers by GetContextSnapshot(); update through
+  // MutableContext()
+  scoped_refptr<SharedContextSnapshot> current_context_ =
+      base::MakeRefCounted<SharedContextSnapshot>();
   std::vector<UserTask> user_tasks_;
-  std::vector<ContextSnapshot> context_history_;
+  std::array<HistoryEntry, kContextHistorySize> context_history_;
+  size_t history_start_ = 0;
+  size_t history_size_ = 0;
+  // Active tasks as last recorded in history; reset when they change
+  std::shared_ptr<const std::vector<UserTask>> shared_active_tasks_;
+  TaskActivityTracker task_tracker_{TaskActivityTracker::Options()};
+
+  // Latest update, and what it left to do once the user settles
+  uint64_t update_generation_ = 0;
+  std::string pending_content_;
+  bool task_detection_pending_ = false;
+
+  // Bumped on material changes to the context: page, topics, entities or
+  // active tasks
+  uint64_t context_epoch_ = 0;
+  // Suggestions of |suggestions_epoch_|, and requests waiting by epoch
+  uint64_t suggestions_epoch_ = UINT64_MAX;
+  std::vector<ContextSuggestion> cached_suggestions_;
+  std::map<uint64_t, std::vector<ContextSuggestionsCallback>>
+      pending_suggestions_;
 
   // For weak pointers
   base::WeakPtrFactory<ContextualManager> weak_ptr_factory_{this};
@@ -173,6 +305,9 @@ class ContextualManager {
 #ifndef BROWSER_CORE_UI_CONTEXTUAL_MANAGER_H_
 #define BROWSER_CORE_UI_CONTEXTUAL_MANAGER_H_
 
+#include <stdint.h>
+
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -180,18 +315,24 @@ class ContextualManager {
 #include <chrono>
 
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "browser_core/ai/content_understanding.h"
+#include "browser_core/ai/page_analysis_queue.h"
 #include "browser_core/engine/browser_engine.h"
+#include "browser_core/ui/task_activity_tracker.h"
 #include "asol/core/ai_service_manager.h"
 #include "asol/core/context_manager.h"
+#include "asol/core/request_scheduler.h"
+#include "asol/core/symbol_table.h"
 
 namespace browser_core {
 namespace ui {
 
 // ContextualManager provides intelligent context-aware browsing assistance
 // by understanding user's current tasks, interests, and browsing patterns.
-class ContextualManager {
+class ContextualManager : public ai::PageAnalysisQueue::Observer {
  public:
   // Context entity representing a recognized entity in the current context
   struct ContextEntity {
@@ -203,7 +344,8 @@ class ContextualManager {
 
   // Context topic representing a recognized topic in the current context
   struct ContextTopic {
-    std::string name;
+    // Interned; compare with EqualsIgnoreCase() rather than by lowercasing
+    asol::core::Symbol name;
     float relevance_score;
     std::vector<std::string> related_topics;
   };
@@ -232,6 +374,29 @@ class ContextualManager {
     std::chrono::system_clock::time_point timestamp;
   };
 
+  // A ContextSnapshot as handed to readers. It never changes once handed
+  // out, so readers may keep it and read it on any sequence; the manager
+  // copies it before its next update while any reader still holds it.
+  class SharedContextSnapshot
+      : public base::RefCountedThreadSafe<SharedContextSnapshot> {
+   public:
+    SharedContextSnapshot();
+    explicit SharedContextSnapshot(ContextSnapshot snapshot);
+
+    SharedContextSnapshot(const SharedContextSnapshot&) = delete;
+    SharedContextSnapshot& operator=(const SharedContextSnapshot&) = delete;
+
+    const ContextSnapshot& get() const { return snapshot_; }
+
+   private:
+    friend class base::RefCountedThreadSafe<SharedContextSnapshot>;
+    friend class ContextualManager;
+
+    ~SharedContextSnapshot();
+
+    ContextSnapshot snapshot_;
+  };
+
   // Context suggestion representing a suggested action based on context
   struct ContextSuggestion {
     enum class Type {
@@ -252,8 +417,8 @@ class ContextualManager {
   };
 
   // Callback for context snapshot
-  using ContextSnapshotCallback = 
-      base::OnceCallback<void(const ContextSnapshot&)>;
+  using ContextSnapshotCallback =
+      base::OnceCallback<void(scoped_refptr<const SharedContextSnapshot>)>;
 
   // Callback for context suggestions
   using ContextSuggestionsCallback = 
@@ -264,7 +429,7 @@ class ContextualManager {
       base::OnceCallback<void(const std::vector<UserTask>&)>;
 
   ContextualManager();
-  ~ContextualManager();
+  ~ContextualManager() override;
 
   // Disallow copy and assign
   ContextualManager(const ContextualManager&) = delete;
@@ -276,15 +441,33 @@ class ContextualManager {
                 asol::core::ContextManager* context_manager,
                 ai::ContentUnderstanding* content_understanding);
 
-  // Update context with current page information
+  // Run task detection as background work through |scheduler| so it does
+  // not compete with user requests. Not owned.
+  void SetRequestScheduler(asol::core::RequestScheduler* scheduler);
+
+  // Take page analyses from |queue|, shared with other features, instead
+  // of requesting one per page. Not owned; null detaches.
+  void SetPageAnalysisQueue(ai::PageAnalysisQueue* queue);
+
+  // ai::PageAnalysisQueue::Observer:
+  void OnPageAnalyzed(
+      const std::string& url,
+      const ai::ContentUnderstanding::ContentAnalysisResult& result) override;
+
+  // Update context with current page information. The page is analyzed
+  // once the user has stayed on it briefly; updates in quick succession
+  // only analyze the last.
   void UpdateContext(const std::string& url, 
                    const std::string& title,
                    const std::string& content);
 
-  // Get current context snapshot
+  // Get current context snapshot. Shares the published snapshot rather
+  // than copying it.
   void GetContextSnapshot(ContextSnapshotCallback callback);
 
-  // Get context-aware suggestions
+  // Get context-aware suggestions. Suggestions are generated once per
+  // context epoch, which moves on with the page, its topics and entities
+  // and the active tasks; until it does they are answered from memory.
   void GetContextSuggestions(ContextSuggestionsCallback callback);
 
   // Get detected user tasks
@@ -306,26 +489,107 @@ class ContextualManager {
   base::WeakPtr<ContextualManager> GetWeakPtr();
 
  private:
+  // Past contexts kept for task detection
+  static constexpr size_t kContextHistorySize = 20;
+  static constexpr size_t kMaxHistoryTopics = 3;
+  static constexpr size_t kMaxHistoryEntities = 5;
+
+  // What history keeps of a ContextSnapshot: names are interned and the
+  // task list is shared with neighbouring entries while it is unchanged
+  struct HistoryEntry {
+    std::string active_url;
+    std::string active_tab_title;
+    std::vector<asol::core::Symbol> topics;
+    std::vector<asol::core::Symbol> entities;
+    std::shared_ptr<const std::vector<UserTask>> active_tasks;
+    std::chrono::system_clock::time_point timestamp;
+  };
+
+  // Analyze the page of the update numbered |generation| if no update has
+  // come since
+  void OnContextSettled(uint64_t generation);
+
   // Helper methods
   void AnalyzePageContent(const std::string& url,
                         const std::string& title,
                         const std::string& content);
+
+  // Add the topics and entities of |result|, analyzed from the page at
+  // |url|, to the current context and the tasks it is relevant to
+  void ApplyPageAnalysis(
+      const std::string& url,
+      const ai::ContentUnderstanding::ContentAnalysisResult& result);
   
+  // Run task detection through AI, for when local tracking finds a new
+  // task candidate or a task's topics shifting
   void DetectUserTasks();
+
+  // Task detection proper; |done| runs once the AI response arrives
+  void RunUserTaskDetection(base::OnceClosure done);
   
   void GenerateContextSuggestions(ContextSuggestionsCallback callback);
 
+  // Cache suggestions generated for |epoch| and answer those waiting
+  void OnContextSuggestionsGenerated(
+      uint64_t epoch,
+      const std::vector<ContextSuggestion>& suggestions);
+
+  // Feed the page being left, with its topics and dwell time, to
+  // |task_tracker_| and apply the task confidences it updates. Returns
+  // whether tasks need detecting again.
+  bool TrackPageLeft();
+
+  // Push the current context into the history ring, evicting the oldest
+  void RecordContextHistory();
+
+  // History entry |index|, oldest first; |index| < |history_size_|
+  const HistoryEntry& GetHistoryEntry(size_t index) const;
+
+  // The current context for updating, copied first if a reader holds it
+  ContextSnapshot& MutableContext();
+
+  // Rebuild the current context's active tasks from |user_tasks_|
+  void UpdateActiveTasks();
+
+  // Offer the URLs of the active tasks to the browser engine's
+  // NavigationPredictor
+  void PredictTaskNavigations();
+
   // Components
   BrowserEngine* browser_engine_ = nullptr;
   asol::core::AIServiceManager* ai_service_manager_ = nullptr;
   asol::core::ContextManager* context_manager_ = nullptr;
   ai::ContentUnderstanding* content_understanding_ = nullptr;
+  asol::core::RequestScheduler* request_scheduler_ = nullptr;
+  ai::PageAnalysisQueue* page_analysis_queue_ = nullptr;
 
   // State
   bool is_enabled_ = true;
-  ContextSnapshot current_context_;
+  // Published to readers by GetContextSnapshot(); update through
+  // MutableContext()
+  scoped_refptr<SharedContextSnapshot> current_context_ =
+      base::MakeRefCounted<SharedContextSnapshot>();
   std::vector<UserTask> user_tasks_;
-  std::vector<ContextSnapshot> context_history_;
+  std::array<HistoryEntry, kContextHistorySize> context_history_;
+  size_t history_start_ = 0;
+  size_t history_size_ = 0;
+  // Active tasks as last recorded in history; reset when they change
+  std::shared_ptr<const std::vector<UserTask>> shared_active_tasks_;
+  TaskActivityTracker task_tracker_{TaskActivityTracker::Options()};
+
+  // Latest update, and what it left to do once the user settles
+  uint64_t update_generation_ = 0;
+  std::string pending_content_;
+  bool task_detection_pending_ = false;
+
+  // Bumped on material changes to the context: page, topics, entities or
+  // active tasks
+  uint64_t context_epoch_ = 0;
+  // Suggestions of |suggestions_epoch_|, and requests waiting by epoch
+  uint64_t suggestions_epoch_ = UINT64_MAX;
+  std::vector<ContextSuggestion> cached_suggestions_;
+  std::map<uint64_t, std::vector<ContextSuggestionsCallback>>
+      pending_suggestions_;
 
   // For weak pointers
   base::WeakPtrFactory<ContextualManager> weak_ptr_factory_{this};
@@ -0,0 +1,248 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ui/lexical_page_index.h"
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <utility>
+
+#include "base/json/json_reader.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+
+namespace browser_core {
+namespace ui {
+
+namespace {
+
+// Edit distance allowed between a query word and a page word
+size_t GetMaxEditDistance(size_t word_length) {
+  if (word_length < 4) {
+    return 0;
+  }
+  return word_length < 8 ? 1 : 2;
+}
+
+// Levenshtein distance of |a| and |b|, or |limit| + 1 once it exceeds
+// |limit|
+size_t BoundedEditDistance(std::string_view a,
+                           std::string_view b,
+                           size_t limit) {
+  if (std::max(a.size(), b.size()) - std::min(a.size(), b.size()) > limit) {
+    return limit + 1;
+  }
+  std::vector<size_t> row(b.size() + 1);
+  for (size_t j = 0; j <= b.size(); ++j) {
+    row[j] = j;
+  }
+  for (size_t i = 1; i <= a.size(); ++i) {
+    size_t diagonal = row[0];
+    row[0] = i;
+    size_t row_min = row[0];
+    for (size_t j = 1; j <= b.size(); ++j) {
+      size_t above = row[j];
+      row[j] = std::min({above + 1, row[j - 1] + 1,
+                         diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+      diagonal = above;
+      row_min = std::min(row_min, row[j]);
+    }
+    if (row_min > limit) {
+      return limit + 1;
+    }
+  }
+  return std::min(row[b.size()], limit + 1);
+}
+
+// Lowercase alphanumeric words of |text|
+std::vector<std::string_view> SplitWords(std::string_view text) {
+  std::vector<std::string_view> words;
+  size_t start = 0;
+  while (start < text.size()) {
+    while (start < text.size() && !base::IsAsciiAlphaNumeric(text[start])) {
+      ++start;
+    }
+    size_t end = start;
+    while (end < text.size() && base::IsAsciiAlphaNumeric(text[end])) {
+      ++end;
+    }
+    if (end > start) {
+      words.push_back(text.substr(start, end - start));
+    }
+    start = end;
+  }
+  return words;
+}
+
+}  // namespace
+
+LexicalPageIndex::LexicalPageIndex(const std::string& page_json) {
+  absl::optional<base::Value> json = base::JSONReader::Read(page_json);
+  if (!json || !json->is_dict()) {
+    return;
+  }
+  const base::Value::Dict& dict = json->GetDict();
+
+  if (const base::Value::List* elements = dict.FindList("elements")) {
+    for (const base::Value& element : *elements) {
+      if (!element.is_dict()) {
+        continue;
+      }
+      const base::Value::Dict& element_dict = element.GetDict();
+      AddElement(element_dict.FindString("selector").value_or(""),
+                 element_dict.FindString("text").value_or(""));
+    }
+  }
+  if (!elements_.empty()) {
+    return;
+  }
+
+  // No elements; index the plain text by line, without selectors
+  std::string text = dict.FindString("text").value_or("");
+  for (std::string_view line : base::SplitStringPiece(
+           text, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    AddElement(std::string(), std::string(line));
+  }
+}
+
+LexicalPageIndex::~LexicalPageIndex() = default;
+
+void LexicalPageIndex::AddElement(std::string selector, std::string text) {
+  if (text.empty()) {
+    return;
+  }
+  Element& element = elements_.emplace_back();
+  element.selector = std::move(selector);
+  element.text = std::move(text);
+  element.folded = base::ToLowerASCII(element.text);
+
+  const std::string& folded = element.folded;
+  for (std::string_view word : SplitWords(folded)) {
+    size_t start = static_cast<size_t>(word.data() - folded.data());
+    words_[std::string(word)].push_back(
+        {elements_.size() - 1, start, start + word.size()});
+  }
+}
+
+std::vector<LexicalPageIndex::Match> LexicalPageIndex::Find(
+    const std::string& query,
+    size_t max_matches) const {
+  std::vector<Match> matches;
+  std::string folded_query = base::ToLowerASCII(
+      base::TrimWhitespaceASCII(query, base::TRIM_ALL));
+  if (folded_query.empty() || max_matches == 0) {
+    return matches;
+  }
+
+  std::vector<bool> exact_elements(elements_.size());
+  for (size_t i = 0; i < elements_.size() && matches.size() < max_matches;
+       ++i) {
+    const Element& element = elements_[i];
+    for (size_t pos = element.folded.find(folded_query);
+         pos != std::string::npos && matches.size() < max_matches;
+         pos = element.folded.find(folded_query, pos + folded_query.size())) {
+      exact_elements[i] = true;
+      matches.push_back({element.selector, element.text, pos,
+                         pos + folded_query.size(), 1.0f, true});
+    }
+  }
+
+  std::vector<std::string_view> terms = SplitWords(folded_query);
+  if (matches.size() >= max_matches || terms.empty()) {
+    return matches;
+  }
+  std::vector<Match> fuzzy = FindFuzzy(terms, exact_elements);
+  size_t count = std::min(fuzzy.size(), max_matches - matches.size());
+  std::move(fuzzy.begin(), fuzzy.begin() + count,
+            std::back_inserter(matches));
+  return matches;
+}
+
+std::vector<LexicalPageIndex::Match> LexicalPageIndex::FindFuzzy(
+    const std::vector<std::string_view>& terms,
+    const std::vector<bool>& exact_elements) const {
+  struct Candidate {
+    size_t terms_found = 0;
+    size_t start = 0;
+    size_t end = 0;
+    size_t distance = 0;
+  };
+  std::unordered_map<size_t, Candidate> candidates;
+
+  for (size_t t = 0; t < terms.size(); ++t) {
+    std::string_view term = terms[t];
+    size_t limit = GetMaxEditDistance(term.size());
+    bool is_prefix = t + 1 == terms.size();
+
+    // Best occurrence of this term in each element
+    std::unordered_map<size_t, std::pair<size_t, const WordOccurrence*>> best;
+    for (const auto& [word, occurrences] : words_) {
+      size_t distance;
+      if (is_prefix && base::StartsWith(word, term)) {
+        distance = 0;
+      } else {
+        distance = BoundedEditDistance(term, word, limit);
+        if (distance > limit) {
+          continue;
+        }
+      }
+      for (const WordOccurrence& occurrence : occurrences) {
+        if (exact_elements[occurrence.element]) {
+          continue;
+        }
+        auto [it, inserted] =
+            best.try_emplace(occurrence.element, distance, &occurrence);
+        if (!inserted && (distance < it->second.first ||
+                          (distance == it->second.first &&
+                           occurrence.start < it->second.second->start))) {
+          it->second = {distance, &occurrence};
+        }
+      }
+    }
+
+    for (const auto& [element, found] : best) {
+      if (t > 0 && !candidates.count(element)) {
+        continue;  // Missed an earlier term
+      }
+      Candidate& candidate = candidates[element];
+      if (candidate.terms_found != t) {
+        continue;
+      }
+      const WordOccurrence& occurrence = *found.second;
+      candidate.start =
+          t == 0 ? occurrence.start : std::min(candidate.start,
+                                               occurrence.start);
+      candidate.end = std::max(candidate.end, occurrence.end);
+      candidate.distance += found.first;
+      ++candidate.terms_found;
+    }
+  }
+
+  // Closest first, in page order among equals
+  std::vector<std::pair<size_t, const Candidate*>> found;
+  for (const auto& [element_index, candidate] : candidates) {
+    if (candidate.terms_found == terms.size()) {
+      found.emplace_back(element_index, &candidate);
+    }
+  }
+  std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) {
+    return std::tie(a.second->distance, a.first) <
+           std::tie(b.second->distance, b.first);
+  });
+
+  std::vector<Match> matches;
+  matches.reserve(found.size());
+  for (const auto& [element_index, candidate] : found) {
+    const Element& element = elements_[element_index];
+    float score = std::max(0.3f, 0.9f - 0.1f * candidate->distance);
+    matches.push_back({element.selector, element.text, candidate->start,
+                       candidate->end, score, false});
+  }
+  return matches;
+}
+
+}  // namespace ui
+}  // namespace browser_core
@@ -0,0 +1,81 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_UI_LEXICAL_PAGE_INDEX_H_
+#define BROWSER_CORE_UI_LEXICAL_PAGE_INDEX_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace browser_core {
+namespace ui {
+
+// LexicalPageIndex finds a query in a page's text elements without AI, fast
+// enough to run on every keystroke of find-on-page.
+//
+// It is built once from a page, as the find-on-page extraction script
+// returns it. Exact matches are case-insensitive substring matches. Fuzzy
+// matches find elements containing every query word, each within a small
+// edit distance of a page word; the last query word also matches words it
+// begins, as the user may still be typing it. Fuzzy lookups only scan the
+// page's distinct words, not its text.
+class LexicalPageIndex {
+ public:
+  struct Match {
+    std::string selector;
+    // Text of the matching element
+    std::string element_text;
+    // Span of the match in |element_text|
+    size_t start = 0;
+    size_t end = 0;
+    // 1 for exact matches, lower for fuzzier ones
+    float score = 0.0f;
+    bool exact = false;
+  };
+
+  explicit LexicalPageIndex(const std::string& page_json);
+  ~LexicalPageIndex();
+
+  LexicalPageIndex(const LexicalPageIndex&) = delete;
+  LexicalPageIndex& operator=(const LexicalPageIndex&) = delete;
+
+  // Up to |max_matches| matches of |query|: exact ones in page order, then
+  // fuzzy ones, best first, in elements without an exact match.
+  std::vector<Match> Find(const std::string& query, size_t max_matches) const;
+
+  size_t element_count() const { return elements_.size(); }
+
+ private:
+  struct Element {
+    std::string selector;
+    std::string text;
+    // |text| lowercased, same length
+    std::string folded;
+  };
+
+  struct WordOccurrence {
+    size_t element;
+    size_t start;
+    size_t end;
+  };
+
+  void AddElement(std::string selector, std::string text);
+
+  std::vector<Match> FindFuzzy(const std::vector<std::string_view>& terms,
+                               const std::vector<bool>& exact_elements) const;
+
+  std::vector<Element> elements_;
+
+  // Occurrences of each distinct lowercase word, in page order
+  std::unordered_map<std::string, std::vector<WordOccurrence>> words_;
+};
+
+}  // namespace ui
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_UI_LEXICAL_PAGE_INDEX_H_
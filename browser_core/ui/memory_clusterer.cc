@@ -0,0 +1,339 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ui/memory_clusterer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "asol/core/vector_kernels.h"
+
+namespace browser_core {
+namespace ui {
+
+namespace {
+
+// Centroids whose exact similarity is checked for each assignment; more
+// than one since indexed centroids lag behind the clusters
+constexpr size_t kAssignCandidates = 3;
+
+// Two-means iterations when splitting a cluster
+constexpr int kSplitIterations = 4;
+
+float Length(const std::vector<float>& vector) {
+  return std::sqrt(
+      asol::core::DotProduct(vector.data(), vector.data(), vector.size()));
+}
+
+}  // namespace
+
+MemoryClusterer::MemoryClusterer(size_t dimension, const Options& options)
+    : dimension_(dimension), options_(options) {
+  RebuildCentroidIndex();
+}
+
+MemoryClusterer::~MemoryClusterer() = default;
+
+MemoryClusterer::ClusterId MemoryClusterer::Assign(ItemId id,
+                                                   const float* embedding) {
+  std::vector<float> normalized(dimension_);
+  if (!asol::core::Normalize(embedding, dimension_, normalized.data())) {
+    return 0;
+  }
+  RemoveMember(id);
+
+  ClusterState* best = nullptr;
+  float best_similarity = options_.join_similarity;
+  for (const asol::core::HnswIndex::Neighbor& neighbor :
+       centroid_index_->Search(normalized.data(), kAssignCandidates)) {
+    auto it = clusters_.find(neighbor.id);
+    if (it == clusters_.end()) {
+      continue;
+    }
+    float similarity = CentroidSimilarity(it->second, normalized.data());
+    if (similarity >= best_similarity) {
+      best_similarity = similarity;
+      best = &it->second;
+    }
+  }
+
+  if (best) {
+    AddMember(*best, id, normalized.data());
+    return best->cluster.id;
+  }
+  ClusterState& state = CreateCluster();
+  AddMember(state, id, normalized.data());
+  IndexCentroid(state);
+  return state.cluster.id;
+}
+
+void MemoryClusterer::Maintain() {
+  std::vector<ClusterId> ids;
+  ids.reserve(clusters_.size());
+  for (const auto& [id, state] : clusters_) {
+    ids.push_back(id);
+  }
+
+  // Merge each cluster into its nearest neighbour if they have converged
+  for (ClusterId id : ids) {
+    auto it = clusters_.find(id);
+    if (it == clusters_.end()) {
+      continue;
+    }
+    std::vector<float> centroid(dimension_);
+    if (!asol::core::Normalize(it->second.sum.data(), dimension_,
+                               centroid.data())) {
+      continue;
+    }
+    for (const asol::core::HnswIndex::Neighbor& neighbor :
+         centroid_index_->Search(centroid.data(), 2)) {
+      auto other = clusters_.find(neighbor.id);
+      if (neighbor.id == id || other == clusters_.end()) {
+        continue;
+      }
+      if (CentroidSimilarity(other->second, centroid.data()) >=
+          options_.merge_similarity) {
+        bool larger = it->second.cluster.members.size() >=
+                      other->second.cluster.members.size();
+        Merge(larger ? it->second : other->second,
+              larger ? other->second : it->second);
+      }
+      break;
+    }
+  }
+
+  // Split the clusters that have spread out
+  ids.clear();
+  for (const auto& [id, state] : clusters_) {
+    if (state.cluster.members.size() >= options_.min_split_size &&
+        state.cluster.cohesion < options_.split_cohesion) {
+      ids.push_back(id);
+    }
+  }
+  for (ClusterId id : ids) {
+    Split(clusters_.at(id));
+  }
+
+  RebuildCentroidIndex();
+}
+
+std::vector<MemoryClusterer::ClusterId>
+MemoryClusterer::GetClustersNeedingNames(size_t min_size) const {
+  std::vector<ClusterId> ids;
+  for (const auto& [id, state] : clusters_) {
+    if (state.cluster.members.size() < min_size) {
+      continue;
+    }
+    float threshold = std::max(
+        2.0f, options_.rename_change_ratio * state.size_at_naming);
+    if (!state.named || state.changes_since_naming >= threshold) {
+      ids.push_back(id);
+    }
+  }
+  return ids;
+}
+
+void MemoryClusterer::MarkNamed(ClusterId id) {
+  auto it = clusters_.find(id);
+  if (it == clusters_.end()) {
+    return;
+  }
+  it->second.named = true;
+  it->second.size_at_naming = it->second.cluster.members.size();
+  it->second.changes_since_naming = 0;
+}
+
+const MemoryClusterer::Cluster* MemoryClusterer::GetCluster(
+    ClusterId id) const {
+  auto it = clusters_.find(id);
+  return it == clusters_.end() ? nullptr : &it->second.cluster;
+}
+
+std::vector<const MemoryClusterer::Cluster*> MemoryClusterer::GetClusters(
+    size_t min_size) const {
+  std::vector<const Cluster*> clusters;
+  for (const auto& [id, state] : clusters_) {
+    if (state.cluster.members.size() >= min_size) {
+      clusters.push_back(&state.cluster);
+    }
+  }
+  return clusters;
+}
+
+std::vector<float> MemoryClusterer::GetEmbedding(const ItemState& item) const {
+  std::vector<float> embedding(dimension_);
+  for (size_t i = 0; i < dimension_; ++i) {
+    embedding[i] = item.values[i] * item.scale;
+  }
+  return embedding;
+}
+
+float MemoryClusterer::CentroidSimilarity(const ClusterState& state,
+                                          const float* embedding) const {
+  float length = Length(state.sum);
+  if (length == 0) {
+    return -1.0f;
+  }
+  return asol::core::DotProduct(state.sum.data(), embedding, dimension_) /
+         length;
+}
+
+MemoryClusterer::ClusterState& MemoryClusterer::CreateCluster() {
+  ClusterId id = next_cluster_id_++;
+  ClusterState& state = clusters_[id];
+  state.cluster.id = id;
+  state.sum.assign(dimension_, 0.0f);
+  return state;
+}
+
+void MemoryClusterer::AddMember(ClusterState& state,
+                                ItemId id,
+                                const float* embedding) {
+  ItemState& item = items_[id];
+  item.cluster = state.cluster.id;
+  item.position = state.cluster.members.size();
+  float max_magnitude = 0;
+  for (size_t i = 0; i < dimension_; ++i) {
+    max_magnitude = std::max(max_magnitude, std::abs(embedding[i]));
+  }
+  item.scale = max_magnitude / 127.0f;
+  item.values.resize(dimension_);
+  for (size_t i = 0; i < dimension_; ++i) {
+    item.values[i] = static_cast<int8_t>(
+        item.scale ? std::lround(embedding[i] / item.scale) : 0);
+  }
+
+  // The sum holds what removal will subtract, so it does not drift
+  std::vector<float> stored = GetEmbedding(item);
+  for (size_t i = 0; i < dimension_; ++i) {
+    state.sum[i] += stored[i];
+  }
+  state.cluster.members.push_back(id);
+  state.cluster.cohesion = Length(state.sum) / state.cluster.members.size();
+  ++state.changes_since_naming;
+}
+
+void MemoryClusterer::RemoveMember(ItemId id) {
+  auto item_it = items_.find(id);
+  if (item_it == items_.end()) {
+    return;
+  }
+  const ItemState& item = item_it->second;
+  ClusterState& state = clusters_.at(item.cluster);
+  std::vector<float> stored = GetEmbedding(item);
+  for (size_t i = 0; i < dimension_; ++i) {
+    state.sum[i] -= stored[i];
+  }
+  std::vector<ItemId>& members = state.cluster.members;
+  members[item.position] = members.back();
+  items_.at(members[item.position]).position = item.position;
+  members.pop_back();
+  items_.erase(item_it);
+
+  if (members.empty()) {
+    DeleteCluster(state.cluster.id);
+    return;
+  }
+  state.cluster.cohesion = Length(state.sum) / members.size();
+  ++state.changes_since_naming;
+}
+
+void MemoryClusterer::DeleteCluster(ClusterId id) {
+  centroid_index_->Remove(id);
+  clusters_.erase(id);
+}
+
+void MemoryClusterer::Merge(ClusterState& into, ClusterState& from) {
+  for (ItemId member : from.cluster.members) {
+    ItemState& item = items_.at(member);
+    item.cluster = into.cluster.id;
+    item.position = into.cluster.members.size();
+    into.cluster.members.push_back(member);
+  }
+  for (size_t i = 0; i < dimension_; ++i) {
+    into.sum[i] += from.sum[i];
+  }
+  into.changes_since_naming += from.cluster.members.size();
+  into.cluster.cohesion = Length(into.sum) / into.cluster.members.size();
+  DeleteCluster(from.cluster.id);
+}
+
+void MemoryClusterer::Split(ClusterState& state) {
+  const std::vector<ItemId>& members = state.cluster.members;
+  std::vector<std::vector<float>> embeddings;
+  embeddings.reserve(members.size());
+  for (ItemId member : members) {
+    embeddings.push_back(GetEmbedding(items_.at(member)));
+  }
+
+  // Seed with the member farthest from the centroid and the member
+  // farthest from that one
+  auto farthest_from = [&](const float* point) {
+    size_t farthest = 0;
+    float lowest = 2.0f;
+    for (size_t i = 0; i < embeddings.size(); ++i) {
+      float similarity =
+          asol::core::DotProduct(point, embeddings[i].data(), dimension_);
+      if (similarity < lowest) {
+        lowest = similarity;
+        farthest = i;
+      }
+    }
+    return farthest;
+  };
+  std::vector<float> first = embeddings[farthest_from(state.sum.data())];
+  std::vector<float> second = embeddings[farthest_from(first.data())];
+
+  std::vector<bool> in_second(embeddings.size());
+  for (int iteration = 0; iteration < kSplitIterations; ++iteration) {
+    std::vector<float> first_sum(dimension_, 0.0f);
+    std::vector<float> second_sum(dimension_, 0.0f);
+    for (size_t i = 0; i < embeddings.size(); ++i) {
+      const float* embedding = embeddings[i].data();
+      in_second[i] =
+          asol::core::DotProduct(second.data(), embedding, dimension_) >
+          asol::core::DotProduct(first.data(), embedding, dimension_);
+      std::vector<float>& sum = in_second[i] ? second_sum : first_sum;
+      for (size_t d = 0; d < dimension_; ++d) {
+        sum[d] += embedding[d];
+      }
+    }
+    if (!asol::core::Normalize(first_sum.data(), dimension_, first.data()) ||
+        !asol::core::Normalize(second_sum.data(), dimension_,
+                               second.data())) {
+      // One side is empty; the cluster does not divide
+      return;
+    }
+  }
+
+  std::vector<ItemId> moving;
+  for (size_t i = 0; i < embeddings.size(); ++i) {
+    if (in_second[i]) {
+      moving.push_back(members[i]);
+    }
+  }
+  ClusterState& split = CreateCluster();
+  for (ItemId member : moving) {
+    std::vector<float> embedding = GetEmbedding(items_.at(member));
+    RemoveMember(member);
+    AddMember(split, member, embedding.data());
+  }
+}
+
+void MemoryClusterer::IndexCentroid(const ClusterState& state) {
+  centroid_index_->Add(state.cluster.id, state.sum.data());
+}
+
+void MemoryClusterer::RebuildCentroidIndex() {
+  asol::core::HnswIndex::Options options;
+  options.dimension = dimension_;
+  centroid_index_ = std::make_unique<asol::core::HnswIndex>(options);
+  for (const auto& [id, state] : clusters_) {
+    IndexCentroid(state);
+  }
+}
+
+}  // namespace ui
+}  // namespace browser_core
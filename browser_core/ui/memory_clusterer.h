@@ -0,0 +1,149 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_UI_MEMORY_CLUSTERER_H_
+#define BROWSER_CORE_UI_MEMORY_CLUSTERER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "asol/core/hnsw_index.h"
+
+namespace browser_core {
+namespace ui {
+
+// MemoryClusterer groups history items by embedding as they arrive, so
+// clusters stay current without reclustering the whole history. It is
+// online k-means with a similarity threshold instead of a fixed k: an item
+// joins the cluster with the nearest centroid if it is similar enough and
+// starts a cluster of its own otherwise. The nearest centroid is found
+// through an HNSW index, so an assignment takes time logarithmic in the
+// number of clusters.
+//
+// Assignments move centroids; Maintain(), meant to run as background work,
+// merges clusters that have drifted together, splits ones that have grown
+// incoherent and reindexes the centroids. Clusters report when their
+// membership has changed enough to need a new name.
+//
+// Item embeddings are kept as int8 to split clusters later. Must be used
+// on one sequence.
+class MemoryClusterer {
+ public:
+  using ItemId = uint64_t;
+  using ClusterId = uint64_t;
+
+  struct Options {
+    // Least cosine similarity to a centroid for an item to join its cluster
+    float join_similarity = 0.7f;
+
+    // Least cosine similarity between centroids for clusters to merge
+    float merge_similarity = 0.85f;
+
+    // Clusters of at least |min_split_size| items whose cohesion has fallen
+    // below |split_cohesion| are split in two. By default that is when
+    // members are on average less similar to the centroid than joining
+    // requires.
+    size_t min_split_size = 16;
+    float split_cohesion = 0.7f;
+
+    // Share of a cluster's size at naming that must join or leave before
+    // it needs a new name
+    float rename_change_ratio = 0.25f;
+  };
+
+  struct Cluster {
+    ClusterId id = 0;
+    std::vector<ItemId> members;
+    // Length of the mean member embedding: 1 when all members are the
+    // same, lower the more they are spread out
+    float cohesion = 0;
+  };
+
+  MemoryClusterer(size_t dimension, const Options& options);
+  ~MemoryClusterer();
+
+  MemoryClusterer(const MemoryClusterer&) = delete;
+  MemoryClusterer& operator=(const MemoryClusterer&) = delete;
+
+  // Put item |id| in the nearest cluster or a new one, moving it if it was
+  // assigned before. |embedding| has dimension() floats. Returns the
+  // cluster, or 0 for a zero vector.
+  ClusterId Assign(ItemId id, const float* embedding);
+
+  // Merge clusters whose centroids have drifted together, split incoherent
+  // ones and rebuild the centroid index
+  void Maintain();
+
+  // Clusters of at least |min_size| items never named, or whose membership
+  // changed materially since MarkNamed()
+  std::vector<ClusterId> GetClustersNeedingNames(size_t min_size) const;
+  void MarkNamed(ClusterId id);
+
+  // Null if |id| has been merged away
+  const Cluster* GetCluster(ClusterId id) const;
+
+  // Clusters of at least |min_size| items, by ID
+  std::vector<const Cluster*> GetClusters(size_t min_size) const;
+
+  size_t dimension() const { return dimension_; }
+  size_t GetClusterCount() const { return clusters_.size(); }
+
+ private:
+  struct ClusterState {
+    Cluster cluster;
+    // Sum of the members' normalized embeddings
+    std::vector<float> sum;
+    size_t size_at_naming = 0;
+    size_t changes_since_naming = 0;
+    bool named = false;
+  };
+
+  struct ItemState {
+    ClusterId cluster = 0;
+    size_t position = 0;  // in the cluster's members
+    std::vector<int8_t> values;
+    float scale = 0;
+  };
+
+  // Dequantized, normalized embedding of |item|
+  std::vector<float> GetEmbedding(const ItemState& item) const;
+
+  // Similarity of |embedding| to the current centroid of |state|
+  float CentroidSimilarity(const ClusterState& state,
+                           const float* embedding) const;
+
+  ClusterState& CreateCluster();
+  void AddMember(ClusterState& state, ItemId id, const float* embedding);
+  void RemoveMember(ItemId id);
+  void DeleteCluster(ClusterId id);
+
+  // Move members of |from| into |into|
+  void Merge(ClusterState& into, ClusterState& from);
+
+  // Two-means split of |state|; the farther half becomes a new cluster
+  void Split(ClusterState& state);
+
+  void IndexCentroid(const ClusterState& state);
+  void RebuildCentroidIndex();
+
+  const size_t dimension_;
+  const Options options_;
+
+  std::map<ClusterId, ClusterState> clusters_;
+  std::unordered_map<ItemId, ItemState> items_;
+  ClusterId next_cluster_id_ = 1;
+
+  // Centroids as of their last indexing, by cluster ID
+  std::unique_ptr<asol::core::HnswIndex> centroid_index_;
+};
+
+}  // namespace ui
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_UI_MEMORY_CLUSTERER_H_
@@ -11,12 +11,21 @@
 #include <ctime>
 #include <iomanip>
 
+#include "asol/core/local_ai_processor.h"
+#include "asol/core/request_fingerprint.h"
+#include "base/barrier_closure.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/files/file_util.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/values.h"
 #include "browser_core/engine/tab.h"
 #include "browser_core/engine/web_contents.h"
+#include "third_party/zlib/google/compression_utils.h"
 
 namespace browser_core {
 namespace ui {
@@ -39,6 +48,13 @@ constexpr char kMemorySearchPrompt[] =
     "Format response as JSON with an array of result objects, each containing: "
     "index (integer), relevance_score (float 0.0-1.0), and match_reason (string).";
 
+constexpr char kClusterNamingPrompt[] =
+    "The following pages from a browsing history belong together. Give the group a short name, "
+    "a one-sentence description, and its main topics.\n\n"
+    "Pages:\n{memory_items}\n\n"
+    "Format response as JSON with fields: name (string), description (string), "
+    "and topics (array of strings).";
+
 constexpr char kMemoryJourneyPrompt[] =
     "Create a memory journey through the user's browsing history that helps achieve the goal: \"{goal}\". "
     "A memory journey is a curated sequence of browsing history items that tell a coherent story "
@@ -47,6 +63,78 @@ constexpr char kMemoryJourneyPrompt[] =
     "Format response as JSON with fields: name (string), description (string), "
     "item_indices (array of integers in sequence order), and goal (string).";
 
+// Items a text search sends to the AI for re-ranking, best matches first
+constexpr size_t kMaxSearchCandidates = 20;
+
+// Nearest neighbours of a query looked up for semantic recall, leaving some
+// for the search filters to drop
+constexpr size_t kMaxSemanticNeighbors = 40;
+
+// Reciprocal rank fusion constant; damps the weight of the top few ranks
+constexpr double kRankFusionOffset = 60.0;
+
+// Embeddings added between saves of the semantic index
+constexpr size_t kSemanticSaveInterval = 32;
+
+// Entry of stored_summary_rows_ for a summary already read, or not stored
+constexpr uint32_t kNoStoredSummary = UINT32_MAX;
+
+// Smallest embedding cluster shown and named
+constexpr size_t kMinClusterSize = 2;
+
+// Cluster names asked of the AI per update; the rest wait for the next one
+constexpr size_t kMaxClusterNamesPerUpdate = 3;
+
+// Members described to the AI when naming a cluster
+constexpr size_t kMaxClusterNamingItems = 10;
+
+// Item IDs hash the URL, so they need no allocator and stay the same across
+// sessions, as the saved semantic index requires
+MemoryPalace::MemoryItemId GetMemoryItemId(const std::string& url) {
+  asol::core::Hasher128 hasher;
+  hasher.Update(url);
+  return hasher.Finish().low;
+}
+
+// Times and IDs are saved as strings; JSON numbers cannot hold 64 bits
+std::string TimeToString(const std::chrono::system_clock::time_point& time) {
+  return base::NumberToString(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          time.time_since_epoch())
+          .count());
+}
+
+std::chrono::system_clock::time_point TimeFromString(
+    const std::string& value) {
+  int64_t microseconds = 0;
+  base::StringToInt64(value, &microseconds);
+  return std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::microseconds(microseconds)));
+}
+
+base::Value::List IdsToList(const std::vector<uint64_t>& ids) {
+  base::Value::List list;
+  for (uint64_t id : ids) {
+    list.Append(base::NumberToString(id));
+  }
+  return list;
+}
+
+std::vector<uint64_t> IdsFromList(const base::Value::List* list) {
+  std::vector<uint64_t> ids;
+  if (!list) {
+    return ids;
+  }
+  for (const base::Value& value : *list) {
+    uint64_t id;
+    if (value.is_string() && base::StringToUint64(value.GetString(), &id)) {
+      ids.push_back(id);
+    }
+  }
+  return ids;
+}
+
 // Helper function to format a timestamp
 std::string FormatTimestamp(const std::chrono::system_clock::time_point& time_point) {
   std::time_t time = std::chrono::system_clock::to_time_t(time_point);
@@ -66,7 +154,11 @@ std::string GenerateUniqueId(const std::string& prefix) {
 }  // namespace
 
 MemoryPalace::MemoryPalace() = default;
-MemoryPalace::~MemoryPalace() = default;
+
+MemoryPalace::~MemoryPalace() {
+  SetPageAnalysisQueue(nullptr);
+  SaveSemanticIndex();
+}
 
 bool MemoryPalace::Initialize(
     BrowserEngine* browser_engine,
@@ -94,19 +186,28 @@ void MemoryPalace::RecordPageVisit(
   }
 
   // Check if this URL is already in memory
-  auto it = std::find_if(memory_items_.begin(), memory_items_.end(),
-                       [&url](const MemoryItem& item) { return item.url == url; });
+  auto it = FindMemoryItem(url);
   
   if (it != memory_items_.end()) {
     // Update existing item
+    size_t index = it - memory_items_.begin();
+    EnsureMemoryItemLoaded(index);
+    bool title_changed = it->title != title;
     it->title = title;
-    it->timestamp = std::chrono::system_clock::now();
+    auto now = std::chrono::system_clock::now();
+    timeline_.Move(index, it->timestamp, now);
+    it->timestamp = now;
+    IndexMemoryItem(index);
+    if (title_changed) {
+      EmbedMemoryItem(index);
+    }
     
     // Re-analyze content if it might have changed
     AnalyzePageContent(url, title, content);
   } else {
     // Create new memory item
     MemoryItem item;
+    item.id = GetMemoryItemId(url);
     item.url = url;
     item.title = title;
     item.timestamp = std::chrono::system_clock::now();
@@ -114,7 +215,17 @@ void MemoryPalace::RecordPageVisit(
     item.is_bookmarked = false;
     
     // Add to memory
-    memory_items_.push_back(item);
+    item_slots_[item.id] = memory_items_.size();
+    timeline_.Add(memory_items_.size(), item.timestamp);
+    memory_items_.push_back(std::move(item));
+    IndexMemoryItem(memory_items_.size() - 1);
+
+    // A page embedded in an earlier session keeps its embedding, summary
+    // included, until it is summarized again
+    if (!semantic_index_ ||
+        !semantic_index_->Contains(memory_items_.back().id)) {
+      EmbedMemoryItem(memory_items_.size() - 1);
+    }
     
     // Analyze content
     AnalyzePageContent(url, title, content);
@@ -173,10 +284,23 @@ void MemoryPalace::GetMemoryClusters(MemoryClustersCallback callback) {
     return;
   }
 
-  if (memory_clusters_.empty()) {
-    GenerateMemoryClusters(std::move(callback));
+  if (memory_clusters_.empty() && !clusterer_) {
+    GenerateMemoryClusters(base::BindOnce(
+        [](MemoryPalace* self, MemoryClustersCallback callback,
+           const std::vector<MemoryCluster>& clusters) {
+          std::vector<MemoryCluster> result = clusters;
+          for (MemoryCluster& cluster : result) {
+            cluster.items = self->GetMemoryItems(cluster.item_ids);
+          }
+          std::move(callback).Run(result);
+        },
+        this, std::move(callback)));
   } else {
-    std::move(callback).Run(memory_clusters_);
+    std::vector<MemoryCluster> result = memory_clusters_;
+    for (MemoryCluster& cluster : result) {
+      cluster.items = GetMemoryItems(cluster.item_ids);
+    }
+    std::move(callback).Run(result);
   }
 }
 
@@ -259,14 +383,15 @@ void MemoryPalace::CreateMemoryJourney(
             if (index_value.is_int()) {
               int index = index_value.GetInt();
               if (index >= 0 && index < static_cast<int>(self->memory_items_.size())) {
-                journey.items.push_back(self->memory_items_[index]);
+                const MemoryItem& item = self->memory_items_[index];
+                journey.item_ids.push_back(item.id);
                 
                 // Update time range
-                if (!has_items || journey.items.back().timestamp < journey.start_time) {
-                  journey.start_time = journey.items.back().timestamp;
+                if (!has_items || item.timestamp < journey.start_time) {
+                  journey.start_time = item.timestamp;
                 }
-                if (!has_items || journey.items.back().timestamp > journey.end_time) {
-                  journey.end_time = journey.items.back().timestamp;
+                if (!has_items || item.timestamp > journey.end_time) {
+                  journey.end_time = item.timestamp;
                 }
                 has_items = true;
               }
@@ -274,8 +399,9 @@ void MemoryPalace::CreateMemoryJourney(
           }
         }
         
-        // Store the journey
+        // Store the journey; only copies handed out hold the items
         self->memory_journeys_[journey.id] = journey;
+        journey.items = self->GetMemoryItems(journey.item_ids);
         
         std::move(callback).Run(true, journey);
       }, this, goal, std::move(callback)));
@@ -291,7 +417,9 @@ void MemoryPalace::GetMemoryJourney(
 
   auto it = memory_journeys_.find(journey_id);
   if (it != memory_journeys_.end()) {
-    std::move(callback).Run(true, it->second);
+    MemoryJourney journey = it->second;
+    journey.items = GetMemoryItems(journey.item_ids);
+    std::move(callback).Run(true, journey);
   } else {
     MemoryJourney empty_journey;
     std::move(callback).Run(false, empty_journey);
@@ -306,6 +434,38 @@ bool MemoryPalace::IsEnabled() const {
   return is_enabled_;
 }
 
+void MemoryPalace::SetRequestScheduler(
+    asol::core::RequestScheduler* scheduler) {
+  request_scheduler_ = scheduler;
+}
+
+void MemoryPalace::SetPageAnalysisQueue(ai::PageAnalysisQueue* queue) {
+  if (page_analysis_queue_) {
+    page_analysis_queue_->RemoveObserver(this);
+  }
+  page_analysis_queue_ = queue;
+  if (page_analysis_queue_) {
+    page_analysis_queue_->AddObserver(this);
+  }
+}
+
+void MemoryPalace::EnableSemanticRecall(
+    asol::core::LocalAIProcessor* processor,
+    const base::FilePath& index_path) {
+  local_ai_processor_ = processor;
+  semantic_index_path_ = index_path;
+  // Null if there is no index yet; the first embedding sizes a new one
+  semantic_index_ = asol::core::HnswIndex::Load(index_path);
+  unsaved_embeddings_ = 0;
+
+  for (size_t i = 0; i < memory_items_.size(); ++i) {
+    if (!semantic_index_ ||
+        !semantic_index_->Contains(memory_items_[i].id)) {
+      EmbedMemoryItem(i);
+    }
+  }
+}
+
 base::WeakPtr<MemoryPalace> MemoryPalace::GetWeakPtr() {
   return weak_ptr_factory_.GetWeakPtr();
 }
@@ -315,118 +475,283 @@ void MemoryPalace::AnalyzePageContent(
     const std::string& title,
     const std::string& content) {
   // Find the memory item
-  auto it = std::find_if(memory_items_.begin(), memory_items_.end(),
-                       [&url](const MemoryItem& item) { return item.url == url; });
-  
-  if (it == memory_items_.end()) {
+  if (FindMemoryItem(url) == memory_items_.end()) {
     return;
   }
-  
+
+  // The shared queue throttles analyses and answers OnPageAnalyzed()
+  if (page_analysis_queue_) {
+    page_analysis_queue_->Enqueue(url, content);
+    return;
+  }
+
+  if (!request_scheduler_) {
+    RunPageAnalysis(url, content, base::DoNothing());
+    return;
+  }
+
+  // Nobody waits on the analysis; a shed run is retried on the next visit
+  request_scheduler_->Schedule(
+      asol::core::RequestPriority::BACKGROUND,
+      base::BindOnce(&MemoryPalace::RunPageAnalysis,
+                     weak_ptr_factory_.GetWeakPtr(), url, content));
+}
+
+void MemoryPalace::RunPageAnalysis(const std::string& url,
+                                   const std::string& content,
+                                   base::OnceClosure done) {
   // Use content understanding to analyze the page
   content_understanding_->AnalyzeContent(
-      content,
+      content, base::BindOnce(&MemoryPalace::ApplyPageAnalysis,
+                              weak_ptr_factory_.GetWeakPtr(), url,
+                              std::move(done)));
+}
+
+void MemoryPalace::OnPageAnalyzed(
+    const std::string& url,
+    const ai::ContentUnderstanding::ContentAnalysisResult& result) {
+  ApplyPageAnalysis(url, base::DoNothing(), result);
+}
+
+void MemoryPalace::ApplyPageAnalysis(
+    const std::string& url,
+    base::OnceClosure done,
+    const ai::ContentUnderstanding::ContentAnalysisResult& result) {
+  std::move(done).Run();
+  if (!result.success) {
+    return;
+  }
+
+  // Find the memory item
+  auto it = FindMemoryItem(url);
+  if (it == memory_items_.end()) {
+    return;
+  }
+  size_t index = it - memory_items_.begin();
+  EnsureMemoryItemLoaded(index);
+
+  // Update memory item with analysis results
+  std::vector<asol::core::Symbol> topics;
+  for (const auto& topic : result.topics) {
+    topics.emplace_back(topic.name);
+  }
+
+  std::vector<asol::core::Symbol> entities;
+  for (const auto& entity : result.entities) {
+    entities.emplace_back(entity.name);
+  }
+
+  // The analysis summarizes the page too, so no separate request is needed.
+  // A revisit answered from a recent analysis changes nothing.
+  const std::string& summary = result.summary.brief_summary;
+  bool summary_changed = !summary.empty() && summary != it->summary;
+  if (summary_changed || topics != it->topics || entities != it->entities) {
+    it->topics = std::move(topics);
+    it->entities = std::move(entities);
+    if (summary_changed) {
+      it->summary = summary;
+    }
+    IndexMemoryItem(index);
+    if (!it->summary.empty()) {
+      EmbedMemoryItem(index);
+    }
+  }
+
+  // Adjust importance based on topics
+  if (result.topics.empty()) {
+    return;
+  }
+  // Get user interests from context manager
+  context_manager_->GetUserContext(
       base::BindOnce([](
           MemoryPalace* self,
           std::string url,
-          const ai::ContentUnderstanding::AnalysisResult& result) {
-        if (!result.success) {
-          return;
-        }
-        
+          const std::vector<ai::ContentUnderstanding::Topic>& topics,
+          const asol::core::ContextManager::UserContext& user_context) {
         // Find the memory item
-        auto it = std::find_if(self->memory_items_.begin(), self->memory_items_.end(),
-                             [&url](const MemoryItem& item) { return item.url == url; });
+        auto it = self->FindMemoryItem(url);
         
         if (it == self->memory_items_.end()) {
           return;
         }
         
-        // Update memory item with analysis results
-        it->topics.clear();
-        for (const auto& topic : result.topics) {
-          it->topics.push_back(topic.name);
+        // Calculate importance based on match with user interests
+        float importance = 0.5f;
+        std::vector<asol::core::Symbol> interests;
+        for (const auto& interest : user_context.interests) {
+          interests.push_back(asol::core::Symbol(interest).Folded());
         }
         
-        it->entities.clear();
-        for (const auto& entity : result.entities) {
-          it->entities.push_back(entity.name);
-        }
-        
-        // Generate a summary if needed
-        if (it->summary.empty()) {
-          self->ai_service_manager_->GetTextAdapter()->GenerateText(
-              "Summarize the following content in 1-2 sentences:\n\n" + result.content,
-              base::BindOnce([](
-                  MemoryPalace* self,
-                  std::string url,
-                  const asol::core::TextAdapter::GenerateTextResult& text_result) {
-                if (!text_result.success) {
-                  return;
-                }
-                
-                // Find the memory item
-                auto it = std::find_if(self->memory_items_.begin(), self->memory_items_.end(),
-                                     [&url](const MemoryItem& item) { return item.url == url; });
-                
-                if (it == self->memory_items_.end()) {
-                  return;
-                }
-                
-                // Update summary
-                it->summary = text_result.text;
-              }, self, url));
+        for (const auto& topic : topics) {
+          // Check if topic matches user interests
+          asol::core::Symbol folded_topic =
+              asol::core::Symbol(topic.name).Folded();
+          for (asol::core::Symbol interest : interests) {
+            if (folded_topic == interest) {
+              importance += 0.1f * topic.relevance;
+              break;
+            }
+          }
         }
         
-        // Calculate importance score based on content analysis
-        float importance = 0.5f;  // Default importance
+        // Cap importance at 1.0
+        importance = std::min(importance, 1.0f);
         
-        // Adjust importance based on topics
-        if (!result.topics.empty()) {
-          // Get user interests from context manager
-          self->context_manager_->GetUserContext(
-              base::BindOnce([](
-                  MemoryPalace* self,
-                  std::string url,
-                  const std::vector<ai::ContentUnderstanding::Topic>& topics,
-                  const asol::core::ContextManager::UserContext& user_context) {
-                // Find the memory item
-                auto it = std::find_if(self->memory_items_.begin(), self->memory_items_.end(),
-                                     [&url](const MemoryItem& item) { return item.url == url; });
-                
-                if (it == self->memory_items_.end()) {
-                  return;
-                }
-                
-                // Calculate importance based on match with user interests
-                float importance = 0.5f;
-                
-                for (const auto& topic : topics) {
-                  // Check if topic matches user interests
-                  for (const auto& interest : user_context.interests) {
-                    if (base::ToLowerASCII(topic.name) == base::ToLowerASCII(interest)) {
-                      importance += 0.1f * topic.confidence;
-                      break;
-                    }
-                  }
-                }
-                
-                // Cap importance at 1.0
-                importance = std::min(importance, 1.0f);
-                
-                // Update importance score
-                it->importance_score = importance;
-              }, self, url, result.topics));
-        }
-      }, this, url));
+        // Update importance score
+        it->importance_score = importance;
+      }, this, url, result.topics));
 }
 
 void MemoryPalace::UpdateMemoryClusters() {
-  // This would be called periodically to update memory clusters
-  // For simplicity, we'll just regenerate clusters
-  GenerateMemoryClusters(base::BindOnce([](
-      MemoryPalace* self, const std::vector<MemoryCluster>& clusters) {
-    self->memory_clusters_ = clusters;
-  }, this));
+  if (!clusterer_) {
+    // Without embeddings, regenerate all clusters through the AI
+    GenerateMemoryClusters(base::BindOnce([](
+        MemoryPalace* self, const std::vector<MemoryCluster>& clusters) {
+      self->memory_clusters_ = clusters;
+    }, this));
+    return;
+  }
+
+  // Items are already clustered as they are embedded; what remains is
+  // upkeep nobody waits for
+  if (!request_scheduler_) {
+    MaintainClusters(base::DoNothing());
+    return;
+  }
+  request_scheduler_->Schedule(
+      asol::core::RequestPriority::BACKGROUND,
+      base::BindOnce(&MemoryPalace::MaintainClusters,
+                     weak_ptr_factory_.GetWeakPtr()));
+}
+
+void MemoryPalace::MaintainClusters(base::OnceClosure done) {
+  if (!clusterer_) {
+    std::move(done).Run();
+    return;
+  }
+  clusterer_->Maintain();
+  RebuildMemoryClusters();
+
+  std::vector<MemoryClusterer::ClusterId> unnamed =
+      clusterer_->GetClustersNeedingNames(kMinClusterSize);
+  unnamed.resize(std::min(unnamed.size(), kMaxClusterNamesPerUpdate));
+  base::RepeatingClosure named =
+      base::BarrierClosure(unnamed.size(), std::move(done));
+  for (MemoryClusterer::ClusterId id : unnamed) {
+    NameCluster(id, named);
+  }
+}
+
+void MemoryPalace::NameCluster(MemoryClusterer::ClusterId id,
+                               base::OnceClosure done) {
+  const MemoryClusterer::Cluster* cluster = clusterer_->GetCluster(id);
+  if (!cluster) {
+    std::move(done).Run();
+    return;
+  }
+
+  std::stringstream memory_items_stream;
+  size_t described = 0;
+  for (MemoryItemId member : cluster->members) {
+    auto slot = item_slots_.find(member);
+    if (slot == item_slots_.end()) {
+      continue;
+    }
+    const MemoryItem& item = memory_items_[slot->second];
+    memory_items_stream << "Title: \"" << item.title << "\"";
+    if (!item.topics.empty()) {
+      memory_items_stream
+          << ", Topics: "
+          << base::JoinString(asol::core::GetSymbolStrings(item.topics), ", ");
+    }
+    memory_items_stream << "\n";
+    if (++described == kMaxClusterNamingItems) {
+      break;
+    }
+  }
+
+  std::string prompt = kClusterNamingPrompt;
+  base::ReplaceSubstringsAfterOffset(&prompt, 0, "{memory_items}",
+                                     memory_items_stream.str());
+
+  // The name describes the membership as of now, even if it changes while
+  // the AI answers
+  clusterer_->MarkNamed(id);
+  ai_service_manager_->GetTextAdapter()->GenerateText(
+      prompt,
+      base::BindOnce([](
+          base::WeakPtr<MemoryPalace> self,
+          MemoryClusterer::ClusterId id,
+          base::OnceClosure done,
+          const asol::core::TextAdapter::GenerateTextResult& text_result) {
+        std::move(done).Run();
+        if (!self || !text_result.success) {
+          return;
+        }
+        absl::optional<base::Value> json = base::JSONReader::Read(text_result.text);
+        if (!json || !json->is_dict()) {
+          return;
+        }
+
+        const base::Value::Dict& dict = json->GetDict();
+        MemoryCluster& label = self->cluster_labels_[id];
+        label.name = dict.FindString("name").value_or("Unnamed Cluster");
+        label.description = dict.FindString("description").value_or("");
+        label.topics.clear();
+        if (const base::Value::List* topics = dict.FindList("topics")) {
+          for (const auto& topic : *topics) {
+            if (topic.is_string()) {
+              label.topics.push_back(topic.GetString());
+            }
+          }
+        }
+        self->RebuildMemoryClusters();
+      }, weak_ptr_factory_.GetWeakPtr(), id, std::move(done)));
+}
+
+void MemoryPalace::RebuildMemoryClusters() {
+  std::unordered_map<MemoryClusterer::ClusterId, MemoryCluster> labels;
+  memory_clusters_.clear();
+  for (const MemoryClusterer::Cluster* cluster :
+       clusterer_->GetClusters(kMinClusterSize)) {
+    MemoryCluster memory_cluster;
+    auto label = cluster_labels_.find(cluster->id);
+    if (label != cluster_labels_.end()) {
+      memory_cluster = label->second;
+      labels.insert(*label);
+    } else {
+      memory_cluster.name = "Unnamed Cluster";
+    }
+    memory_cluster.id = "cluster_" + base::NumberToString(cluster->id);
+    memory_cluster.relevance_score = cluster->cohesion;
+
+    bool has_items = false;
+    for (MemoryItemId member : cluster->members) {
+      auto slot = item_slots_.find(member);
+      if (slot == item_slots_.end()) {
+        continue;
+      }
+      const MemoryItem& item = memory_items_[slot->second];
+      memory_cluster.item_ids.push_back(member);
+      if (!has_items || item.timestamp < memory_cluster.start_time) {
+        memory_cluster.start_time = item.timestamp;
+      }
+      if (!has_items || item.timestamp > memory_cluster.end_time) {
+        memory_cluster.end_time = item.timestamp;
+      }
+      has_items = true;
+    }
+    if (has_items) {
+      memory_clusters_.push_back(std::move(memory_cluster));
+    }
+  }
+  // Labels of merged-away clusters go with them
+  cluster_labels_ = std::move(labels);
+
+  std::sort(memory_clusters_.begin(), memory_clusters_.end(),
+            [](const MemoryCluster& a, const MemoryCluster& b) {
+              return a.relevance_score > b.relevance_score;
+            });
 }
 
 void MemoryPalace::GenerateMemoryClusters(MemoryClustersCallback callback) {
@@ -528,14 +853,15 @@ void MemoryPalace::GenerateMemoryClusters(MemoryClustersCallback callback) {
               if (index_value.is_int()) {
                 int index = index_value.GetInt();
                 if (index >= 0 && index < static_cast<int>(self->memory_items_.size())) {
-                  cluster.items.push_back(self->memory_items_[index]);
+                  const MemoryItem& item = self->memory_items_[index];
+                  cluster.item_ids.push_back(item.id);
                   
                   // Update time range
-                  if (!has_items || cluster.items.back().timestamp < cluster.start_time) {
-                    cluster.start_time = cluster.items.back().timestamp;
+                  if (!has_items || item.timestamp < cluster.start_time) {
+                    cluster.start_time = item.timestamp;
                   }
-                  if (!has_items || cluster.items.back().timestamp > cluster.end_time) {
-                    cluster.end_time = cluster.items.back().timestamp;
+                  if (!has_items || item.timestamp > cluster.end_time) {
+                    cluster.end_time = item.timestamp;
                   }
                   has_items = true;
                 }
@@ -544,7 +870,7 @@ void MemoryPalace::GenerateMemoryClusters(MemoryClustersCallback callback) {
           }
           
           // Skip empty clusters
-          if (!cluster.items.empty()) {
+          if (!cluster.item_ids.empty()) {
             memory_clusters.push_back(cluster);
           }
         }
@@ -559,6 +885,408 @@ void MemoryPalace::GenerateMemoryClusters(MemoryClustersCallback callback) {
       }, this, std::move(callback)));
 }
 
+std::vector<MemoryPalace::MemoryItem>::iterator MemoryPalace::FindMemoryItem(
+    const std::string& url) {
+  auto it = item_slots_.find(GetMemoryItemId(url));
+  if (it == item_slots_.end() || memory_items_[it->second].url != url) {
+    return memory_items_.end();
+  }
+  return memory_items_.begin() + it->second;
+}
+
+std::vector<MemoryPalace::MemoryItem> MemoryPalace::GetMemoryItems(
+    const std::vector<MemoryItemId>& ids) {
+  std::vector<MemoryItem> items;
+  items.reserve(ids.size());
+  for (MemoryItemId id : ids) {
+    auto it = item_slots_.find(id);
+    if (it != item_slots_.end()) {
+      EnsureMemoryItemLoaded(it->second);
+      items.push_back(memory_items_[it->second]);
+    }
+  }
+  return items;
+}
+
+size_t MemoryPalace::ArchiveColdMemory(
+    const base::FilePath& directory,
+    std::chrono::system_clock::duration min_age) {
+  archive_directory_ = directory;
+  if (!base::CreateDirectory(directory)) {
+    LOG(ERROR) << "Failed to create memory archive: " << directory.value();
+    return 0;
+  }
+  size_t archived = 0;
+  for (MemoryTimeline::Partition* partition : timeline_.GetPartitionsBefore(
+           std::chrono::system_clock::now() - min_age)) {
+    if (!partition->archived && ArchivePartition(partition)) {
+      ++archived;
+    }
+  }
+  return archived;
+}
+
+void MemoryPalace::EnsureMemoryItemLoaded(size_t index) {
+  MemoryTimeline::Partition* partition =
+      timeline_.Find(memory_items_[index].timestamp);
+  if (partition && partition->archived) {
+    RestorePartition(partition);
+  }
+  if (index < stored_summary_rows_.size() &&
+      stored_summary_rows_[index] != kNoStoredSummary) {
+    memory_items_[index].summary =
+        std::string(store_->GetSummary(stored_summary_rows_[index]));
+    stored_summary_rows_[index] = kNoStoredSummary;
+    IndexMemoryItem(index);
+  }
+}
+
+bool MemoryPalace::SaveMemory(const base::FilePath& path) {
+  // Archived days are read back for the write and archived again after
+  std::vector<MemoryTimeline::Partition*> archived;
+  for (MemoryTimeline::Partition* partition :
+       timeline_.GetPartitionsInRange(nullptr, nullptr)) {
+    if (partition->archived) {
+      RestorePartition(partition);
+      archived.push_back(partition);
+    }
+  }
+
+  std::vector<MemoryStore::Item> items(memory_items_.size());
+  for (size_t i = 0; i < memory_items_.size(); ++i) {
+    const MemoryItem& item = memory_items_[i];
+    MemoryStore::Item& stored = items[i];
+    stored.url = item.url;
+    stored.title = item.title;
+    // Summaries not read yet are copied from the old file's mapping
+    if (i < stored_summary_rows_.size() &&
+        stored_summary_rows_[i] != kNoStoredSummary) {
+      stored.summary = store_->GetSummary(stored_summary_rows_[i]);
+    } else {
+      stored.summary = item.summary;
+    }
+    stored.topics = asol::core::GetSymbolStrings(item.topics);
+    stored.entities = asol::core::GetSymbolStrings(item.entities);
+    stored.timestamp = item.timestamp;
+    stored.importance_score = item.importance_score;
+    stored.is_bookmarked = item.is_bookmarked;
+  }
+  bool saved = MemoryStore::Write(path, items, SerializeMetadata());
+
+  if (saved) {
+    // Rows now match item indices; unread summaries are read from the new
+    // file from here on
+    if (std::unique_ptr<MemoryStore> store = MemoryStore::Open(path)) {
+      for (size_t i = 0; i < stored_summary_rows_.size(); ++i) {
+        if (stored_summary_rows_[i] != kNoStoredSummary) {
+          stored_summary_rows_[i] = i;
+        }
+      }
+      store_ = std::move(store);
+    }
+  }
+  for (MemoryTimeline::Partition* partition : archived) {
+    ArchivePartition(partition);
+  }
+  return saved;
+}
+
+bool MemoryPalace::LoadMemory(const base::FilePath& path) {
+  if (!memory_items_.empty()) {
+    return false;
+  }
+  std::unique_ptr<MemoryStore> store = MemoryStore::Open(path);
+  if (!store) {
+    return false;
+  }
+
+  memory_items_.reserve(store->size());
+  stored_summary_rows_.reserve(store->size());
+  for (size_t row = 0; row < store->size(); ++row) {
+    MemoryItem item;
+    item.url = std::string(store->GetUrl(row));
+    item.id = GetMemoryItemId(item.url);
+    if (item_slots_.count(item.id)) {
+      continue;
+    }
+    item.title = std::string(store->GetTitle(row));
+    for (std::string_view topic : store->GetTopics(row)) {
+      item.topics.emplace_back(topic);
+    }
+    for (std::string_view entity : store->GetEntities(row)) {
+      item.entities.emplace_back(entity);
+    }
+    item.timestamp = store->GetTimestamp(row);
+    item.importance_score = store->GetImportanceScore(row);
+    item.is_bookmarked = store->IsBookmarked(row);
+
+    item_slots_[item.id] = memory_items_.size();
+    timeline_.Add(memory_items_.size(), item.timestamp);
+    memory_items_.push_back(std::move(item));
+    stored_summary_rows_.push_back(row);
+    IndexMemoryItem(memory_items_.size() - 1);
+  }
+
+  RestoreMetadata(store->GetMetadata());
+  store_ = std::move(store);
+  return true;
+}
+
+std::string MemoryPalace::SerializeMetadata() const {
+  base::Value::List clusters;
+  for (const MemoryCluster& cluster : memory_clusters_) {
+    base::Value::List topics;
+    for (const auto& topic : cluster.topics) {
+      topics.Append(topic);
+    }
+    base::Value::Dict record;
+    record.Set("id", cluster.id);
+    record.Set("name", cluster.name);
+    record.Set("description", cluster.description);
+    record.Set("topics", std::move(topics));
+    record.Set("item_ids", IdsToList(cluster.item_ids));
+    record.Set("start_time", TimeToString(cluster.start_time));
+    record.Set("end_time", TimeToString(cluster.end_time));
+    record.Set("relevance_score", cluster.relevance_score);
+    clusters.Append(std::move(record));
+  }
+
+  base::Value::List journeys;
+  for (const auto& [id, journey] : memory_journeys_) {
+    base::Value::Dict record;
+    record.Set("id", journey.id);
+    record.Set("name", journey.name);
+    record.Set("description", journey.description);
+    record.Set("goal", journey.goal);
+    record.Set("item_ids", IdsToList(journey.item_ids));
+    record.Set("start_time", TimeToString(journey.start_time));
+    record.Set("end_time", TimeToString(journey.end_time));
+    journeys.Append(std::move(record));
+  }
+
+  base::Value::Dict metadata;
+  metadata.Set("clusters", std::move(clusters));
+  metadata.Set("journeys", std::move(journeys));
+  std::string json;
+  base::JSONWriter::Write(metadata, &json);
+  return json;
+}
+
+void MemoryPalace::RestoreMetadata(std::string_view json) {
+  absl::optional<base::Value> metadata = base::JSONReader::Read(json);
+  if (!metadata || !metadata->is_dict()) {
+    return;
+  }
+
+  if (const base::Value::List* clusters =
+          metadata->GetDict().FindList("clusters")) {
+    for (const base::Value& value : *clusters) {
+      if (!value.is_dict()) {
+        continue;
+      }
+      const base::Value::Dict& record = value.GetDict();
+      MemoryCluster cluster;
+      cluster.id = record.FindString("id").value_or("");
+      cluster.name = record.FindString("name").value_or("Unnamed Cluster");
+      cluster.description = record.FindString("description").value_or("");
+      if (const base::Value::List* topics = record.FindList("topics")) {
+        for (const base::Value& topic : *topics) {
+          if (topic.is_string()) {
+            cluster.topics.push_back(topic.GetString());
+          }
+        }
+      }
+      cluster.item_ids = IdsFromList(record.FindList("item_ids"));
+      cluster.start_time =
+          TimeFromString(record.FindString("start_time").value_or(""));
+      cluster.end_time =
+          TimeFromString(record.FindString("end_time").value_or(""));
+      cluster.relevance_score =
+          record.FindDouble("relevance_score").value_or(0.5);
+      memory_clusters_.push_back(std::move(cluster));
+    }
+  }
+
+  if (const base::Value::List* journeys =
+          metadata->GetDict().FindList("journeys")) {
+    for (const base::Value& value : *journeys) {
+      if (!value.is_dict()) {
+        continue;
+      }
+      const base::Value::Dict& record = value.GetDict();
+      MemoryJourney journey;
+      journey.id = record.FindString("id").value_or("");
+      journey.name = record.FindString("name").value_or("Unnamed Journey");
+      journey.description = record.FindString("description").value_or("");
+      journey.goal = record.FindString("goal").value_or("");
+      journey.item_ids = IdsFromList(record.FindList("item_ids"));
+      journey.start_time =
+          TimeFromString(record.FindString("start_time").value_or(""));
+      journey.end_time =
+          TimeFromString(record.FindString("end_time").value_or(""));
+      if (!journey.id.empty()) {
+        memory_journeys_[journey.id] = std::move(journey);
+      }
+    }
+  }
+}
+
+bool MemoryPalace::ArchivePartition(MemoryTimeline::Partition* partition) {
+  base::Value::List items;
+  for (const MemoryTimeline::Entry& entry : partition->entries) {
+    const MemoryItem& item = memory_items_[entry.id];
+    base::Value::List entities;
+    for (asol::core::Symbol entity : item.entities) {
+      entities.Append(entity.str());
+    }
+    base::Value::Dict record;
+    record.Set("url", item.url);
+    record.Set("summary", item.summary);
+    record.Set("entities", std::move(entities));
+    items.Append(std::move(record));
+  }
+  std::string json;
+  std::string compressed;
+  if (!base::JSONWriter::Write(base::Value(std::move(items)), &json) ||
+      !compression::GzipCompress(json, &compressed) ||
+      !base::WriteFile(GetArchivePath(partition->day), compressed)) {
+    LOG(ERROR) << "Failed to archive memory of day " << partition->day;
+    return false;
+  }
+
+  // Release the memory, not just the contents
+  for (const MemoryTimeline::Entry& entry : partition->entries) {
+    MemoryItem& item = memory_items_[entry.id];
+    std::string().swap(item.summary);
+    std::vector<asol::core::Symbol>().swap(item.entities);
+  }
+  partition->archived = true;
+  return true;
+}
+
+void MemoryPalace::RestorePartition(MemoryTimeline::Partition* partition) {
+  partition->archived = false;
+  base::FilePath path = GetArchivePath(partition->day);
+  std::string compressed;
+  std::string json;
+  absl::optional<base::Value> items;
+  if (base::ReadFileToString(path, &compressed) &&
+      compression::GzipUncompress(compressed, &json)) {
+    items = base::JSONReader::Read(json);
+  }
+  if (!items || !items->is_list()) {
+    // The items are summarized again on their next visit
+    LOG(ERROR) << "Failed to restore memory archive: " << path.value();
+    return;
+  }
+
+  for (const base::Value& value : items->GetList()) {
+    if (!value.is_dict()) {
+      continue;
+    }
+    const base::Value::Dict& dict = value.GetDict();
+    auto it = FindMemoryItem(dict.FindString("url").value_or(""));
+    if (it == memory_items_.end()) {
+      continue;
+    }
+    it->summary = dict.FindString("summary").value_or("");
+    it->entities.clear();
+    if (const base::Value::List* entities = dict.FindList("entities")) {
+      for (const base::Value& entity : *entities) {
+        if (entity.is_string()) {
+          it->entities.emplace_back(entity.GetString());
+        }
+      }
+    }
+  }
+  base::DeleteFile(path);
+}
+
+base::FilePath MemoryPalace::GetArchivePath(int64_t day) const {
+  return archive_directory_.AppendASCII("memory-" + base::NumberToString(day) +
+                                        ".json.gz");
+}
+
+void MemoryPalace::IndexMemoryItem(size_t index) {
+  const MemoryItem& item = memory_items_[index];
+  MemorySearchIndex::Fields fields;
+  fields.title = item.title;
+  fields.summary = item.summary;
+  fields.topics = &item.topics;
+  fields.entities = &item.entities;
+  search_index_.Update(index, fields);
+}
+
+void MemoryPalace::EmbedMemoryItem(size_t index) {
+  if (!local_ai_processor_) {
+    return;
+  }
+  EnsureMemoryItemLoaded(index);
+  const MemoryItem& item = memory_items_[index];
+  std::string text = item.title;
+  if (!item.summary.empty()) {
+    text += "\n" + item.summary;
+  }
+  if (!item.topics.empty()) {
+    text += "\n" + base::JoinString(asol::core::GetSymbolStrings(item.topics),
+                                    ", ");
+  }
+  local_ai_processor_->GenerateEmbedding(
+      text, base::BindOnce(&MemoryPalace::OnMemoryItemEmbedded,
+                           weak_ptr_factory_.GetWeakPtr(), item.url));
+}
+
+void MemoryPalace::OnMemoryItemEmbedded(std::string url,
+                                        const std::vector<float>& embedding) {
+  if (embedding.empty()) {
+    return;
+  }
+  if (!semantic_index_ ||
+      semantic_index_->options().dimension != embedding.size()) {
+    // No index yet, or the embedding model changed and the stored vectors
+    // can no longer be compared with new ones
+    asol::core::HnswIndex::Options options;
+    options.dimension = embedding.size();
+    semantic_index_ = std::make_unique<asol::core::HnswIndex>(options);
+  }
+  if (!clusterer_ || clusterer_->dimension() != embedding.size()) {
+    clusterer_ = std::make_unique<MemoryClusterer>(
+        embedding.size(), MemoryClusterer::Options());
+    cluster_labels_.clear();
+  }
+  clusterer_->Assign(GetMemoryItemId(url), embedding.data());
+  if (semantic_index_->Add(GetMemoryItemId(url), embedding.data()) &&
+      ++unsaved_embeddings_ >= kSemanticSaveInterval) {
+    SaveSemanticIndex();
+  }
+}
+
+void MemoryPalace::SaveSemanticIndex() {
+  if (!semantic_index_ || unsaved_embeddings_ == 0 ||
+      semantic_index_path_.empty()) {
+    return;
+  }
+  if (semantic_index_->Save(semantic_index_path_)) {
+    unsaved_embeddings_ = 0;
+  }
+}
+
+bool MemoryPalace::MatchesFilters(
+    const std::chrono::system_clock::time_point* start_time,
+    const std::chrono::system_clock::time_point* end_time,
+    const std::string* lowercase_topic,
+    size_t index) const {
+  const MemoryItem& item = memory_items_[index];
+  if (start_time && item.timestamp < *start_time) {
+    return false;
+  }
+  if (end_time && item.timestamp > *end_time) {
+    return false;
+  }
+  return !lowercase_topic ||
+         search_index_.HasTopicContaining(index, *lowercase_topic);
+}
+
 void MemoryPalace::SearchMemoryInternal(
     const std::string& query,
     const std::chrono::system_clock::time_point* start_time,
@@ -572,44 +1300,42 @@ void MemoryPalace::SearchMemoryInternal(
     return;
   }
 
-  // First, filter by time range and topic if specified
+  // The topic is lowercased once here; the index keeps item topics
+  // lowercased
+  std::string lowercase_topic;
+  if (topic) {
+    lowercase_topic = base::ToLowerASCII(*topic);
+  }
+  const std::string* topic_filter = topic ? &lowercase_topic : nullptr;
+
   std::vector<MemoryItem> filtered_items;
   std::vector<size_t> filtered_indices;
   
-  for (size_t i = 0; i < memory_items_.size(); ++i) {
-    const auto& item = memory_items_[i];
-    bool include = true;
-    
-    // Filter by time range
-    if (start_time && item.timestamp < *start_time) {
-      include = false;
-    }
-    if (end_time && item.timestamp > *end_time) {
-      include = false;
-    }
-    
-    // Filter by topic
-    if (topic && include) {
-      bool has_topic = false;
-      for (const auto& item_topic : item.topics) {
-        if (base::ToLowerASCII(item_topic).find(base::ToLowerASCII(*topic)) != std::string::npos) {
-          has_topic = true;
-          break;
+  // If no query, return the items that pass the filters
+  if (query.empty()) {
+    if (start_time || end_time) {
+      // Only the days the range overlaps, in recording order as before
+      for (MemoryTimeline::Partition* partition :
+           timeline_.GetPartitionsInRange(start_time, end_time)) {
+        for (const MemoryTimeline::Entry& entry : partition->entries) {
+          if (MatchesFilters(start_time, end_time, topic_filter, entry.id)) {
+            filtered_indices.push_back(entry.id);
+          }
         }
       }
-      if (!has_topic) {
-        include = false;
+      std::sort(filtered_indices.begin(), filtered_indices.end());
+    } else {
+      for (size_t i = 0; i < memory_items_.size(); ++i) {
+        if (MatchesFilters(start_time, end_time, topic_filter, i)) {
+          filtered_indices.push_back(i);
+        }
       }
     }
-    
-    if (include) {
-      filtered_items.push_back(item);
-      filtered_indices.push_back(i);
+    for (size_t index : filtered_indices) {
+      EnsureMemoryItemLoaded(index);
+      filtered_items.push_back(memory_items_[index]);
     }
-  }
-  
-  // If no query, return filtered items
-  if (query.empty()) {
+
     MemorySearchResult result;
     result.success = true;
     result.items = filtered_items;
@@ -626,7 +1352,7 @@ void MemoryPalace::SearchMemoryInternal(
           include = true;
         } else {
           for (const auto& cluster_topic : cluster.topics) {
-            if (base::ToLowerASCII(cluster_topic).find(base::ToLowerASCII(*topic)) != std::string::npos) {
+            if (base::ToLowerASCII(cluster_topic).find(lowercase_topic) != std::string::npos) {
               include = true;
               break;
             }
@@ -636,6 +1362,7 @@ void MemoryPalace::SearchMemoryInternal(
       
       if (include) {
         result.clusters.push_back(cluster);
+        result.clusters.back().items = GetMemoryItems(cluster.item_ids);
       }
     }
     
@@ -643,6 +1370,76 @@ void MemoryPalace::SearchMemoryInternal(
     return;
   }
   
+  SearchFilters filters;
+  if (start_time) {
+    filters.start_time = *start_time;
+  }
+  if (end_time) {
+    filters.end_time = *end_time;
+  }
+  if (topic) {
+    filters.lowercase_topic = std::move(lowercase_topic);
+  }
+  if (semantic_index_ && semantic_index_->size() > 0) {
+    local_ai_processor_->GenerateEmbedding(
+        query, base::BindOnce(&MemoryPalace::SearchMemoryByText,
+                              weak_ptr_factory_.GetWeakPtr(), query,
+                              std::move(filters), std::move(callback)));
+    return;
+  }
+  SearchMemoryByText(query, filters, std::move(callback), {});
+}
+
+void MemoryPalace::SearchMemoryByText(
+    const std::string& query,
+    const SearchFilters& filters,
+    MemorySearchCallback callback,
+    const std::vector<float>& query_embedding) {
+  auto matches_filters = base::BindRepeating(
+      &MemoryPalace::MatchesFilters, base::Unretained(this),
+      filters.start_time ? &*filters.start_time : nullptr,
+      filters.end_time ? &*filters.end_time : nullptr,
+      filters.lowercase_topic ? &*filters.lowercase_topic : nullptr);
+
+  // Rank locally and have the AI re-rank only the best matches, so the
+  // prompt stays the same size however long the history grows. Word and
+  // semantic matches are merged by reciprocal rank, which needs no scale
+  // shared between BM25 scores and similarities.
+  std::map<size_t, double> fused_scores;
+  std::vector<MemorySearchIndex::Hit> hits =
+      search_index_.Search(query, kMaxSearchCandidates, matches_filters);
+  for (size_t rank = 0; rank < hits.size(); ++rank) {
+    fused_scores[hits[rank].id] += 1.0 / (kRankFusionOffset + rank + 1);
+  }
+  if (semantic_index_ &&
+      semantic_index_->options().dimension == query_embedding.size()) {
+    size_t rank = 0;
+    for (const asol::core::HnswIndex::Neighbor& neighbor :
+         semantic_index_->Search(query_embedding.data(),
+                                 kMaxSemanticNeighbors)) {
+      // Skip pages only known from earlier sessions, and filtered ones
+      auto it = item_slots_.find(neighbor.id);
+      if (it == item_slots_.end() || !matches_filters.Run(it->second)) {
+        continue;
+      }
+      fused_scores[it->second] += 1.0 / (kRankFusionOffset + ++rank);
+    }
+  }
+
+  std::vector<std::pair<size_t, double>> candidates(fused_scores.begin(),
+                                                    fused_scores.end());
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.second > b.second;
+                   });
+  candidates.resize(std::min(candidates.size(), kMaxSearchCandidates));
+
+  std::vector<MemoryItem> filtered_items;
+  for (const auto& candidate : candidates) {
+    EnsureMemoryItemLoaded(candidate.first);
+    filtered_items.push_back(memory_items_[candidate.first]);
+  }
+
   // If filtered items is empty, return empty result
   if (filtered_items.empty()) {
     MemorySearchResult empty_result;
@@ -687,7 +1484,6 @@ void MemoryPalace::SearchMemoryInternal(
       base::BindOnce([](
           MemoryPalace* self,
           std::vector<MemoryItem> filtered_items,
-          std::vector<size_t> filtered_indices,
           std::string query,
           MemorySearchCallback callback,
           const asol::core::TextAdapter::GenerateTextResult& text_result) {
@@ -744,42 +1540,26 @@ void MemoryPalace::SearchMemoryInternal(
         }
         
         // Find relevant clusters
-        std::set<size_t> result_indices;
-        for (size_t i = 0; i < filtered_indices.size(); ++i) {
-          for (const auto& scored_item : scored_items) {
-            if (filtered_items[i].url == scored_item.first.url) {
-              result_indices.insert(filtered_indices[i]);
-              break;
-            }
-          }
+        std::set<MemoryItemId> result_ids;
+        for (const auto& scored_item : scored_items) {
+          result_ids.insert(scored_item.first.id);
         }
         
         // Add clusters that contain result items
         for (const auto& cluster : self->memory_clusters_) {
-          bool include = false;
-          
-          for (const auto& item : cluster.items) {
-            auto it = std::find_if(self->memory_items_.begin(), self->memory_items_.end(),
-                                 [&item](const MemoryItem& memory_item) {
-                                   return memory_item.url == item.url;
-                                 });
-            
-            if (it != self->memory_items_.end()) {
-              size_t index = std::distance(self->memory_items_.begin(), it);
-              if (result_indices.find(index) != result_indices.end()) {
-                include = true;
-                break;
-              }
-            }
-          }
+          bool include = std::any_of(
+              cluster.item_ids.begin(), cluster.item_ids.end(),
+              [&result_ids](MemoryItemId id) { return result_ids.count(id) > 0; });
           
           if (include) {
             result.clusters.push_back(cluster);
+            result.clusters.back().items =
+                self->GetMemoryItems(cluster.item_ids);
           }
         }
         
         std::move(callback).Run(result);
-      }, this, filtered_items, filtered_indices, query, std::move(callback)));
+      }, this, filtered_items, query, std::move(callback)));
 }
 
 }  // namespace ui
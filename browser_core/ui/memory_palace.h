@@ -6,32 +6,54 @@
 #define BROWSER_CORE_UI_MEMORY_PALACE_H_
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <map>
 #include <chrono>
 
 #include "base/callback.h"
+#include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "browser_core/ai/content_understanding.h"
+#include "browser_core/ai/page_analysis_queue.h"
 #include "browser_core/engine/browser_engine.h"
+#include "browser_core/ui/memory_clusterer.h"
+#include "browser_core/ui/memory_search_index.h"
+#include "browser_core/ui/memory_store.h"
+#include "browser_core/ui/memory_timeline.h"
 #include "asol/core/ai_service_manager.h"
 #include "asol/core/context_manager.h"
+#include "asol/core/hnsw_index.h"
+#include "asol/core/request_scheduler.h"
+#include "asol/core/symbol_table.h"
+
+namespace asol {
+namespace core {
+class LocalAIProcessor;
+}  // namespace core
+}  // namespace asol
 
 namespace browser_core {
 namespace ui {
 
 // MemoryPalace provides an intelligent browsing history organization system
 // that helps users recall and revisit content based on semantic understanding.
-class MemoryPalace {
+class MemoryPalace : public ai::PageAnalysisQueue::Observer {
  public:
+  // Stable for the life of an item and across sessions: a hash of its URL
+  using MemoryItemId = uint64_t;
+
   // Memory item representing a visited page
   struct MemoryItem {
+    MemoryItemId id;
     std::string url;
     std::string title;
     std::string summary;
-    std::vector<std::string> topics;
-    std::vector<std::string> entities;
+    // Interned, since the same topics and entities recur across items
+    std::vector<asol::core::Symbol> topics;
+    std::vector<asol::core::Symbol> entities;
     std::chrono::system_clock::time_point timestamp;
     float importance_score;
     bool is_bookmarked;
@@ -42,6 +64,8 @@ class MemoryPalace {
     std::string id;
     std::string name;
     std::string description;
+    // Members by ID; |items| holds copies of them only in results
+    std::vector<MemoryItemId> item_ids;
     std::vector<MemoryItem> items;
     std::vector<std::string> topics;
     std::chrono::system_clock::time_point start_time;
@@ -54,6 +78,8 @@ class MemoryPalace {
     std::string id;
     std::string name;
     std::string description;
+    // Members in order by ID; |items| holds copies of them only in results
+    std::vector<MemoryItemId> item_ids;
     std::vector<MemoryItem> items;
     std::chrono::system_clock::time_point start_time;
     std::chrono::system_clock::time_point end_time;
@@ -81,7 +107,7 @@ class MemoryPalace {
       base::OnceCallback<void(const std::vector<MemoryCluster>&)>;
 
   MemoryPalace();
-  ~MemoryPalace();
+  ~MemoryPalace() override;
 
   // Disallow copy and assign
   MemoryPalace(const MemoryPalace&) = delete;
@@ -119,6 +145,47 @@ class MemoryPalace {
   // Get a memory journey by ID
   void GetMemoryJourney(const std::string& journey_id, MemoryJourneyCallback callback);
 
+  // Run page analysis as background work through |scheduler| so it does
+  // not compete with user requests. Not owned.
+  void SetRequestScheduler(asol::core::RequestScheduler* scheduler);
+
+  // Take page analyses from |queue|, shared with other features, instead
+  // of requesting one per visit. Not owned; null detaches.
+  void SetPageAnalysisQueue(ai::PageAnalysisQueue* queue);
+
+  // ai::PageAnalysisQueue::Observer:
+  void OnPageAnalyzed(
+      const std::string& url,
+      const ai::ContentUnderstanding::ContentAnalysisResult& result) override;
+
+  // Recall items by meaning as well as by their words. Each item is
+  // embedded with |processor| when recorded and again when its summary
+  // arrives, and a text search adds the items nearest the query embedding
+  // to the word matches. The embeddings also cluster items as they arrive,
+  // replacing reclustering the whole history through the AI. The embeddings are kept in an index loaded from
+  // |index_path| when it exists and saved back to it. |processor| is not
+  // owned and must outlive this.
+  void EnableSemanticRecall(asol::core::LocalAIProcessor* processor,
+                            const base::FilePath& index_path);
+
+  // Keep the summaries and entities of items not visited for |min_age| in
+  // compressed files under |directory|, one per day of history, instead of
+  // in memory. A day is read back when a search returns or a visit updates
+  // one of its items; until then clustering and journey prompts describe
+  // its items without them. |directory| must be the same on every call.
+  // Returns the number of days archived.
+  size_t ArchiveColdMemory(const base::FilePath& directory,
+                           std::chrono::system_clock::duration min_age);
+
+  // Save history, clusters and journeys to |path| as a MemoryStore
+  bool SaveMemory(const base::FilePath& path);
+
+  // Load what SaveMemory() wrote, before any visit is recorded. The file
+  // stays mapped and summaries are read from it only when a search returns
+  // or a visit updates their item; until then text search matches those
+  // items by title, topics and entities.
+  bool LoadMemory(const base::FilePath& path);
+
   // Enable/disable memory palace
   void Enable(bool enable);
   bool IsEnabled() const;
@@ -131,26 +198,117 @@ class MemoryPalace {
   void AnalyzePageContent(const std::string& url,
                         const std::string& title,
                         const std::string& content);
+
+  // Page analysis proper; |done| runs once the AI work has finished
+  void RunPageAnalysis(const std::string& url,
+                       const std::string& content,
+                       base::OnceClosure done);
+
+  // Store the topics, entities and summary of |result| on the item for
+  // |url|; |done| runs first
+  void ApplyPageAnalysis(
+      const std::string& url,
+      base::OnceClosure done,
+      const ai::ContentUnderstanding::ContentAnalysisResult& result);
   
   void UpdateMemoryClusters();
+
+  // Merge and split embedding clusters, then name those whose membership
+  // changed; |done| runs once the names are in
+  void MaintainClusters(base::OnceClosure done);
+  void NameCluster(MemoryClusterer::ClusterId id, base::OnceClosure done);
+
+  // Rebuild memory_clusters_ from clusterer_ and cluster_labels_
+  void RebuildMemoryClusters();
   
   void GenerateMemoryClusters(MemoryClustersCallback callback);
   
+  // The item recorded for |url|, or memory_items_.end()
+  std::vector<MemoryItem>::iterator FindMemoryItem(const std::string& url);
+
+  // Copies of the items with |ids| that are still in memory, in order
+  std::vector<MemoryItem> GetMemoryItems(const std::vector<MemoryItemId>& ids);
+
+  // Read back the archived data of memory_items_[index]'s day, if any
+  void EnsureMemoryItemLoaded(size_t index);
+  bool ArchivePartition(MemoryTimeline::Partition* partition);
+  void RestorePartition(MemoryTimeline::Partition* partition);
+  base::FilePath GetArchivePath(int64_t day) const;
+
+  // Clusters and journeys, which refer to items by ID, as saved with them
+  std::string SerializeMetadata() const;
+  void RestoreMetadata(std::string_view json);
+
+  // Reindex memory_items_[index] for search after it changed
+  void IndexMemoryItem(size_t index);
+
+  // Embed memory_items_[index] for semantic recall
+  void EmbedMemoryItem(size_t index);
+  void OnMemoryItemEmbedded(std::string url,
+                            const std::vector<float>& embedding);
+  void SaveSemanticIndex();
+
+  // Whether memory_items_[index] is in the time range and has a topic
+  // containing |lowercase_topic|; null pointers do not filter
+  bool MatchesFilters(const std::chrono::system_clock::time_point* start_time,
+                      const std::chrono::system_clock::time_point* end_time,
+                      const std::string* lowercase_topic,
+                      size_t index) const;
+
   void SearchMemoryInternal(const std::string& query,
                           const std::chrono::system_clock::time_point* start_time,
                           const std::chrono::system_clock::time_point* end_time,
                           const std::string* topic,
                           MemorySearchCallback callback);
 
+  // Search filters copied to outlive an embedding request
+  struct SearchFilters {
+    std::optional<std::chrono::system_clock::time_point> start_time;
+    std::optional<std::chrono::system_clock::time_point> end_time;
+    std::optional<std::string> lowercase_topic;
+  };
+
+  // Rank items for a text query by its words and, if |query_embedding| is
+  // not empty, by meaning, and have the AI re-rank the best of them
+  void SearchMemoryByText(const std::string& query,
+                          const SearchFilters& filters,
+                          MemorySearchCallback callback,
+                          const std::vector<float>& query_embedding);
+
   // Components
   BrowserEngine* browser_engine_ = nullptr;
   asol::core::AIServiceManager* ai_service_manager_ = nullptr;
   asol::core::ContextManager* context_manager_ = nullptr;
   ai::ContentUnderstanding* content_understanding_ = nullptr;
+  asol::core::RequestScheduler* request_scheduler_ = nullptr;
+  ai::PageAnalysisQueue* page_analysis_queue_ = nullptr;
+  asol::core::LocalAIProcessor* local_ai_processor_ = nullptr;
 
   // State
   bool is_enabled_ = true;
   std::vector<MemoryItem> memory_items_;
+  // Index in memory_items_ of each item, so a visit finds its item without
+  // a scan. Items are never removed, so indices stay valid.
+  std::unordered_map<MemoryItemId, size_t> item_slots_;
+  // memory_items_ by index, partitioned by day of last visit
+  MemoryTimeline timeline_;
+  base::FilePath archive_directory_;
+  // History loaded by LoadMemory(), and the row in it of each loaded item
+  // whose summary has not been read yet, by index in memory_items_
+  std::unique_ptr<MemoryStore> store_;
+  std::vector<uint32_t> stored_summary_rows_;
+  // Text search over memory_items_, by index
+  MemorySearchIndex search_index_;
+  // Semantic recall over memory items by ID; null until semantic recall is
+  // enabled and sized by the first embedding
+  std::unique_ptr<asol::core::HnswIndex> semantic_index_;
+  // Clusters of the same embeddings, with their AI-given names,
+  // descriptions and topics by cluster
+  std::unique_ptr<MemoryClusterer> clusterer_;
+  std::unordered_map<MemoryClusterer::ClusterId, MemoryCluster>
+      cluster_labels_;
+  base::FilePath semantic_index_path_;
+  size_t unsaved_embeddings_ = 0;
   std::vector<MemoryCluster> memory_clusters_;
   std::map<std::string, MemoryJourney> memory_journeys_;
 
@@ -0,0 +1,195 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ui/memory_search_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "base/strings/string_util.h"
+
+namespace browser_core {
+namespace ui {
+
+namespace {
+
+// BM25 term frequency saturation and length normalization
+constexpr double kK1 = 1.2;
+constexpr double kB = 0.75;
+
+// Weight of one occurrence of a word in each field
+constexpr float kTitleWeight = 3.0f;
+constexpr float kTopicWeight = 2.0f;
+constexpr float kEntityWeight = 2.0f;
+constexpr float kSummaryWeight = 1.0f;
+
+// Single characters match too much to rank by
+constexpr size_t kMinWordLength = 2;
+
+template <typename Visitor>
+void ForEachWord(std::string_view text, Visitor visitor) {
+  std::string word;
+  for (char c : text) {
+    if (base::IsAsciiAlphaNumeric(c) || (c & 0x80)) {
+      word.push_back(base::ToLowerASCII(c));
+    } else if (!word.empty()) {
+      if (word.size() >= kMinWordLength) {
+        visitor(word);
+      }
+      word.clear();
+    }
+  }
+  if (word.size() >= kMinWordLength) {
+    visitor(word);
+  }
+}
+
+}  // namespace
+
+MemorySearchIndex::MemorySearchIndex() = default;
+MemorySearchIndex::~MemorySearchIndex() = default;
+
+void MemorySearchIndex::Update(ItemId id, const Fields& fields) {
+  if (id >= items_.size()) {
+    items_.resize(id + 1);
+  }
+  Remove(id);
+
+  std::unordered_map<TermId, float> frequencies;
+  float length = 0;
+  auto add_field = [&](std::string_view text, float weight) {
+    ForEachWord(text, [&](const std::string& word) {
+      auto [it, inserted] =
+          term_ids_.try_emplace(word, static_cast<TermId>(postings_.size()));
+      if (inserted) {
+        postings_.emplace_back();
+      }
+      frequencies[it->second] += weight;
+      length += weight;
+    });
+  };
+  add_field(fields.title, kTitleWeight);
+  add_field(fields.summary, kSummaryWeight);
+  if (fields.topics) {
+    for (asol::core::Symbol topic : *fields.topics) {
+      add_field(topic.str(), kTopicWeight);
+    }
+  }
+  if (fields.entities) {
+    for (asol::core::Symbol entity : *fields.entities) {
+      add_field(entity.str(), kEntityWeight);
+    }
+  }
+
+  Item& item = items_[id];
+  item.indexed = true;
+  item.length = length;
+  item.terms.reserve(frequencies.size());
+  for (const auto& [term, frequency] : frequencies) {
+    postings_[term].push_back({id, frequency});
+    item.terms.push_back(term);
+  }
+  if (fields.topics) {
+    for (asol::core::Symbol topic : *fields.topics) {
+      item.folded_topics.push_back(topic.Folded());
+    }
+  }
+  ++item_count_;
+  total_length_ += length;
+}
+
+std::vector<MemorySearchIndex::Hit> MemorySearchIndex::Search(
+    std::string_view query,
+    size_t max_hits,
+    const ItemFilter& filter) const {
+  std::vector<TermId> terms;
+  ForEachWord(query, [&](const std::string& word) {
+    auto it = term_ids_.find(word);
+    if (it != term_ids_.end()) {
+      terms.push_back(it->second);
+    }
+  });
+  std::sort(terms.begin(), terms.end());
+  terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+  if (terms.empty() || item_count_ == 0 || max_hits == 0) {
+    return {};
+  }
+
+  double count = static_cast<double>(item_count_);
+  double average_length = std::max(total_length_ / count, 1.0);
+  std::unordered_map<ItemId, double> scores;
+  for (TermId term : terms) {
+    const std::vector<Posting>& postings = postings_[term];
+    if (postings.empty()) {
+      continue;
+    }
+    double frequency_in_items = static_cast<double>(postings.size());
+    double idf = std::log(1.0 + (count - frequency_in_items + 0.5) /
+                                    (frequency_in_items + 0.5));
+    for (const Posting& posting : postings) {
+      double norm =
+          kK1 * (1.0 - kB + kB * items_[posting.id].length / average_length);
+      scores[posting.id] +=
+          idf * posting.frequency * (kK1 + 1.0) / (posting.frequency + norm);
+    }
+  }
+
+  std::vector<Hit> hits;
+  hits.reserve(scores.size());
+  for (const auto& [id, score] : scores) {
+    if (!filter || filter.Run(id)) {
+      hits.push_back({id, score});
+    }
+  }
+  auto better = [](const Hit& a, const Hit& b) {
+    return a.score != b.score ? a.score > b.score : a.id < b.id;
+  };
+  if (hits.size() > max_hits) {
+    std::partial_sort(hits.begin(), hits.begin() + max_hits, hits.end(),
+                      better);
+    hits.resize(max_hits);
+  } else {
+    std::sort(hits.begin(), hits.end(), better);
+  }
+  return hits;
+}
+
+bool MemorySearchIndex::HasTopicContaining(
+    ItemId id,
+    std::string_view lowercase_topic) const {
+  if (id >= items_.size()) {
+    return false;
+  }
+  return std::any_of(items_[id].folded_topics.begin(),
+                     items_[id].folded_topics.end(),
+                     [&](asol::core::Symbol topic) {
+                       return topic.str().find(lowercase_topic) !=
+                              std::string_view::npos;
+                     });
+}
+
+void MemorySearchIndex::Remove(ItemId id) {
+  Item& item = items_[id];
+  if (!item.indexed) {
+    return;
+  }
+  for (TermId term : item.terms) {
+    std::vector<Posting>& postings = postings_[term];
+    auto it = std::find_if(postings.begin(), postings.end(),
+                           [id](const Posting& posting) {
+                             return posting.id == id;
+                           });
+    if (it != postings.end()) {
+      *it = postings.back();
+      postings.pop_back();
+    }
+  }
+  --item_count_;
+  total_length_ -= item.length;
+  item = Item();
+}
+
+}  // namespace ui
+}  // namespace browser_core
@@ -0,0 +1,106 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_UI_MEMORY_SEARCH_INDEX_H_
+#define BROWSER_CORE_UI_MEMORY_SEARCH_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "asol/core/symbol_table.h"
+#include "base/functional/callback.h"
+
+namespace browser_core {
+namespace ui {
+
+// MemorySearchIndex finds the history items that match a text query
+// without scanning them: an inverted index from each word to the items it
+// occurs in, ranked with BM25.
+//
+// The title, summary, topics and entities of an item are indexed as one
+// document, with a word counting more in the title, topics and entities
+// than in the summary. Words are ASCII-lowercased runs of letters and
+// digits; other bytes, including UTF-8, are kept as they are.
+//
+// Items are identified by the caller's index; reindexing an item replaces
+// what was indexed for it. Must be used on one sequence.
+class MemorySearchIndex {
+ public:
+  using ItemId = size_t;
+
+  struct Fields {
+    std::string_view title;
+    std::string_view summary;
+    const std::vector<asol::core::Symbol>* topics = nullptr;
+    const std::vector<asol::core::Symbol>* entities = nullptr;
+  };
+
+  struct Hit {
+    ItemId id;
+    double score;
+  };
+
+  // Return false to leave an item out of the results
+  using ItemFilter = base::RepeatingCallback<bool(ItemId id)>;
+
+  MemorySearchIndex();
+  ~MemorySearchIndex();
+
+  MemorySearchIndex(const MemorySearchIndex&) = delete;
+  MemorySearchIndex& operator=(const MemorySearchIndex&) = delete;
+
+  // Index |fields| as item |id|, replacing what was indexed for it before
+  void Update(ItemId id, const Fields& fields);
+
+  // Up to |max_hits| items matching any word of |query| that |filter| (may
+  // be null) accepts, best first. Costs time in the number of items that
+  // contain a query word, not in the size of the index.
+  std::vector<Hit> Search(std::string_view query,
+                          size_t max_hits,
+                          const ItemFilter& filter) const;
+
+  // Whether a topic of item |id| contains |lowercase_topic|, compared
+  // without case
+  bool HasTopicContaining(ItemId id, std::string_view lowercase_topic) const;
+
+  size_t GetItemCount() const { return item_count_; }
+  size_t GetTermCount() const { return postings_.size(); }
+
+ private:
+  using TermId = uint32_t;
+
+  struct Posting {
+    ItemId id;
+    // Occurrences, weighted by the field they are in
+    float frequency;
+  };
+
+  struct Item {
+    bool indexed = false;
+    // Weighted word count, the document length of BM25
+    float length = 0;
+    // Terms with a posting for this item, to remove them on reindexing
+    std::vector<TermId> terms;
+    // Lowercase forms of the item's topics
+    std::vector<asol::core::Symbol> folded_topics;
+  };
+
+  void Remove(ItemId id);
+
+  std::unordered_map<std::string, TermId> term_ids_;
+  std::vector<std::vector<Posting>> postings_;
+  std::vector<Item> items_;
+  size_t item_count_ = 0;
+  double total_length_ = 0;
+};
+
+}  // namespace ui
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_UI_MEMORY_SEARCH_INDEX_H_
@@ -0,0 +1,364 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ui/memory_store.h"
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include "base/files/file_util.h"
+#include "base/logging.h"
+
+namespace browser_core {
+namespace ui {
+
+namespace {
+
+constexpr uint32_t kFileMagic = 0x4c41504d;  // "MPAL"
+constexpr uint32_t kFileVersion = 1;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t item_count;
+  uint32_t section_count;
+};
+
+// One per section, after the header
+struct SectionRecord {
+  uint64_t offset;
+  uint64_t size;
+};
+
+template <typename T>
+void Append(T value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T Read(const uint8_t* data, size_t index) {
+  T value;
+  memcpy(&value, data + index * sizeof(T), sizeof(T));
+  return value;
+}
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+// Builds a string pool: offsets of |OffsetType|, starting with 0, and the
+// bytes they index
+template <typename OffsetType>
+class PoolWriter {
+ public:
+  PoolWriter() { Append<OffsetType>(0, &offsets_); }
+
+  bool Add(std::string_view value) {
+    bytes_.append(value);
+    if (bytes_.size() > std::numeric_limits<OffsetType>::max()) {
+      return false;
+    }
+    Append(static_cast<OffsetType>(bytes_.size()), &offsets_);
+    return true;
+  }
+
+  std::string offsets_;
+  std::string bytes_;
+};
+
+// Builds a dictionary-encoded list column: per item, offsets into a column
+// of dictionary IDs
+class DictionaryListWriter {
+ public:
+  explicit DictionaryListWriter(
+      std::unordered_map<std::string_view, uint32_t>* dictionary,
+      PoolWriter<uint32_t>* strings)
+      : dictionary_(dictionary), strings_(strings) {
+    Append<uint32_t>(0, &offsets_);
+  }
+
+  bool Add(const std::vector<std::string_view>& values) {
+    for (std::string_view value : values) {
+      auto [it, inserted] = dictionary_->try_emplace(
+          value, static_cast<uint32_t>(dictionary_->size()));
+      if (inserted && !strings_->Add(value)) {
+        return false;
+      }
+      Append(it->second, &ids_);
+    }
+    Append(static_cast<uint32_t>(ids_.size() / sizeof(uint32_t)), &offsets_);
+    return true;
+  }
+
+  std::string offsets_;
+  std::string ids_;
+
+ private:
+  std::unordered_map<std::string_view, uint32_t>* dictionary_;
+  PoolWriter<uint32_t>* strings_;
+};
+
+}  // namespace
+
+MemoryStore::MemoryStore() = default;
+MemoryStore::~MemoryStore() = default;
+
+// static
+std::unique_ptr<MemoryStore> MemoryStore::Open(const base::FilePath& path) {
+  if (!base::PathExists(path)) {
+    return nullptr;
+  }
+  std::unique_ptr<MemoryStore> store(new MemoryStore());
+  if (!store->mapping_.Initialize(path)) {
+    LOG(ERROR) << "Failed to map memory store: " << path.value();
+    return nullptr;
+  }
+  if (!store->Parse()) {
+    LOG(ERROR) << "Malformed memory store: " << path.value();
+    return nullptr;
+  }
+  return store;
+}
+
+// static
+bool MemoryStore::Write(const base::FilePath& path,
+                        const std::vector<Item>& items,
+                        std::string_view metadata) {
+  PoolWriter<uint32_t> urls;
+  PoolWriter<uint32_t> titles;
+  PoolWriter<uint64_t> summaries;
+  PoolWriter<uint32_t> dictionary_strings;
+  std::unordered_map<std::string_view, uint32_t> dictionary;
+  DictionaryListWriter topics(&dictionary, &dictionary_strings);
+  DictionaryListWriter entities(&dictionary, &dictionary_strings);
+  std::string timestamps;
+  std::string importance_scores;
+  std::string bookmarks;
+
+  int64_t previous_time = 0;
+  bool ok = items.size() <= std::numeric_limits<uint32_t>::max();
+  for (size_t i = 0; ok && i < items.size(); ++i) {
+    const Item& item = items[i];
+    ok = urls.Add(item.url) && titles.Add(item.title) &&
+         summaries.Add(item.summary) && topics.Add(item.topics) &&
+         entities.Add(item.entities);
+
+    int64_t time = std::chrono::duration_cast<std::chrono::microseconds>(
+                       item.timestamp.time_since_epoch())
+                       .count();
+    uint64_t delta = static_cast<uint64_t>(time) -
+                     static_cast<uint64_t>(previous_time);
+    // Zigzag, so small steps back in time stay short too
+    AppendVarint((delta << 1) ^ static_cast<uint64_t>(
+                                    static_cast<int64_t>(delta) >> 63),
+                 &timestamps);
+    previous_time = time;
+
+    Append(item.importance_score, &importance_scores);
+    bookmarks.push_back(item.is_bookmarked ? 1 : 0);
+  }
+  if (!ok) {
+    LOG(ERROR) << "Memory too large to store: " << path.value();
+    return false;
+  }
+
+  std::array<std::string_view, kSectionCount> sections;
+  sections[kUrlOffsets] = urls.offsets_;
+  sections[kUrls] = urls.bytes_;
+  sections[kTitleOffsets] = titles.offsets_;
+  sections[kTitles] = titles.bytes_;
+  sections[kSummaryOffsets] = summaries.offsets_;
+  sections[kSummaries] = summaries.bytes_;
+  sections[kDictionaryOffsets] = dictionary_strings.offsets_;
+  sections[kDictionary] = dictionary_strings.bytes_;
+  sections[kTopicOffsets] = topics.offsets_;
+  sections[kTopicIds] = topics.ids_;
+  sections[kEntityOffsets] = entities.offsets_;
+  sections[kEntityIds] = entities.ids_;
+  sections[kTimestamps] = timestamps;
+  sections[kImportanceScores] = importance_scores;
+  sections[kBookmarks] = bookmarks;
+  sections[kMetadata] = metadata;
+
+  std::string data;
+  Append(FileHeader{kFileMagic, kFileVersion,
+                    static_cast<uint32_t>(items.size()), kSectionCount},
+         &data);
+  uint64_t offset = sizeof(FileHeader) + kSectionCount * sizeof(SectionRecord);
+  for (std::string_view section : sections) {
+    Append(SectionRecord{offset, section.size()}, &data);
+    offset += section.size();
+  }
+  for (std::string_view section : sections) {
+    data.append(section);
+  }
+
+  base::FilePath temp_path = path.AddExtension(FILE_PATH_LITERAL("tmp"));
+  if (!base::WriteFile(temp_path, data) ||
+      !base::ReplaceFile(temp_path, path, nullptr)) {
+    LOG(ERROR) << "Failed to write memory store: " << path.value();
+    base::DeleteFile(temp_path);
+    return false;
+  }
+  return true;
+}
+
+std::string_view MemoryStore::GetUrl(size_t index) const {
+  return GetString<uint32_t>(kUrlOffsets, kUrls, index);
+}
+
+std::string_view MemoryStore::GetTitle(size_t index) const {
+  return GetString<uint32_t>(kTitleOffsets, kTitles, index);
+}
+
+std::string_view MemoryStore::GetSummary(size_t index) const {
+  return GetString<uint64_t>(kSummaryOffsets, kSummaries, index);
+}
+
+std::vector<std::string_view> MemoryStore::GetTopics(size_t index) const {
+  return GetDictionaryStrings(kTopicOffsets, kTopicIds, index);
+}
+
+std::vector<std::string_view> MemoryStore::GetEntities(size_t index) const {
+  return GetDictionaryStrings(kEntityOffsets, kEntityIds, index);
+}
+
+std::string_view MemoryStore::GetMetadata() const {
+  const Column& column = sections_[kMetadata];
+  return std::string_view(reinterpret_cast<const char*>(column.data),
+                          column.size);
+}
+
+std::chrono::system_clock::time_point MemoryStore::GetTimestamp(
+    size_t index) const {
+  return std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::microseconds(timestamps_[index])));
+}
+
+float MemoryStore::GetImportanceScore(size_t index) const {
+  return Read<float>(sections_[kImportanceScores].data, index);
+}
+
+bool MemoryStore::IsBookmarked(size_t index) const {
+  return sections_[kBookmarks].data[index] != 0;
+}
+
+bool MemoryStore::Parse() {
+  const uint8_t* data = mapping_.data();
+  const size_t length = mapping_.length();
+
+  FileHeader header;
+  if (length < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (header.magic != kFileMagic || header.version != kFileVersion ||
+      header.section_count != kSectionCount ||
+      length - sizeof(header) < kSectionCount * sizeof(SectionRecord)) {
+    return false;
+  }
+  for (size_t i = 0; i < kSectionCount; ++i) {
+    SectionRecord record =
+        Read<SectionRecord>(data + sizeof(header), i);
+    if (record.offset > length || record.size > length - record.offset) {
+      return false;
+    }
+    sections_[i] = {data + record.offset, static_cast<size_t>(record.size)};
+  }
+
+  // Fixed-width columns must hold one entry per item, and offset columns
+  // one more; their contents are checked when read
+  const size_t count = header.item_count;
+  const size_t entries[][2] = {
+      {kUrlOffsets, (count + 1) * sizeof(uint32_t)},
+      {kTitleOffsets, (count + 1) * sizeof(uint32_t)},
+      {kSummaryOffsets, (count + 1) * sizeof(uint64_t)},
+      {kTopicOffsets, (count + 1) * sizeof(uint32_t)},
+      {kEntityOffsets, (count + 1) * sizeof(uint32_t)},
+      {kImportanceScores, count * sizeof(float)},
+      {kBookmarks, count},
+  };
+  for (const auto& [section, size] : entries) {
+    if (sections_[section].size != size) {
+      return false;
+    }
+  }
+  const size_t dictionary_offsets = sections_[kDictionaryOffsets].size;
+  if (dictionary_offsets == 0 || dictionary_offsets % sizeof(uint32_t) ||
+      sections_[kTopicIds].size % sizeof(uint32_t) ||
+      sections_[kEntityIds].size % sizeof(uint32_t)) {
+    return false;
+  }
+  dictionary_size_ = dictionary_offsets / sizeof(uint32_t) - 1;
+
+  // Visit times are needed for every item, so they are decoded now
+  const Column& times = sections_[kTimestamps];
+  timestamps_.reserve(count);
+  int64_t time = 0;
+  size_t position = 0;
+  while (timestamps_.size() < count) {
+    uint64_t value = 0;
+    int shift = 0;
+    while (true) {
+      if (position == times.size || shift > 63) {
+        return false;
+      }
+      uint8_t byte = times.data[position++];
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+      if (!(byte & 0x80)) {
+        break;
+      }
+    }
+    uint64_t delta = (value >> 1) ^ (~(value & 1) + 1);
+    time = static_cast<int64_t>(static_cast<uint64_t>(time) + delta);
+    timestamps_.push_back(time);
+  }
+  return position == times.size;
+}
+
+template <typename OffsetType>
+std::string_view MemoryStore::GetString(Section offsets,
+                                        Section bytes,
+                                        size_t index) const {
+  OffsetType start = Read<OffsetType>(sections_[offsets].data, index);
+  OffsetType end = Read<OffsetType>(sections_[offsets].data, index + 1);
+  if (start > end || end > sections_[bytes].size) {
+    return std::string_view();
+  }
+  return std::string_view(
+      reinterpret_cast<const char*>(sections_[bytes].data) + start,
+      end - start);
+}
+
+std::vector<std::string_view> MemoryStore::GetDictionaryStrings(
+    Section offsets,
+    Section ids,
+    size_t index) const {
+  uint32_t start = Read<uint32_t>(sections_[offsets].data, index);
+  uint32_t end = Read<uint32_t>(sections_[offsets].data, index + 1);
+  if (start > end || end > sections_[ids].size / sizeof(uint32_t)) {
+    return {};
+  }
+  std::vector<std::string_view> strings;
+  strings.reserve(end - start);
+  for (uint32_t i = start; i < end; ++i) {
+    uint32_t id = Read<uint32_t>(sections_[ids].data, i);
+    if (id < dictionary_size_) {
+      strings.push_back(
+          GetString<uint32_t>(kDictionaryOffsets, kDictionary, id));
+    }
+  }
+  return strings;
+}
+
+}  // namespace ui
+}  // namespace browser_core
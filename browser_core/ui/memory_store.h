@@ -0,0 +1,126 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_UI_MEMORY_STORE_H_
+#define BROWSER_CORE_UI_MEMORY_STORE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+
+namespace browser_core {
+namespace ui {
+
+// MemoryStore is the on-disk form of browsing history: one file of columns
+// that is mapped rather than read, so opening it reads only the small
+// fixed-width columns and strings are read from the mapping when asked for.
+//
+// URLs and titles are string pools, an offset column and a bytes column.
+// Topics and entities are indices into one dictionary of distinct strings.
+// Visit times are zigzag varint deltas in microseconds, decoded on opening.
+// Summaries, the bulk of the file, are a separate blob column that listing
+// items never touches. A metadata blob holds what is not per item.
+class MemoryStore {
+ public:
+  // An item to write; views need only live until Write() returns
+  struct Item {
+    std::string_view url;
+    std::string_view title;
+    std::string_view summary;
+    std::vector<std::string_view> topics;
+    std::vector<std::string_view> entities;
+    std::chrono::system_clock::time_point timestamp;
+    float importance_score = 0;
+    bool is_bookmarked = false;
+  };
+
+  ~MemoryStore();
+
+  MemoryStore(const MemoryStore&) = delete;
+  MemoryStore& operator=(const MemoryStore&) = delete;
+
+  // Map the store at |path|. Returns null if the file is missing or
+  // malformed.
+  static std::unique_ptr<MemoryStore> Open(const base::FilePath& path);
+
+  // Write |items| and |metadata| to |path|, replacing the file atomically.
+  // An open store of the same file keeps reading the old contents.
+  static bool Write(const base::FilePath& path,
+                    const std::vector<Item>& items,
+                    std::string_view metadata);
+
+  size_t size() const { return timestamps_.size(); }
+
+  // Views into the mapping, valid as long as this store. A string found
+  // malformed reads as empty.
+  std::string_view GetUrl(size_t index) const;
+  std::string_view GetTitle(size_t index) const;
+  std::string_view GetSummary(size_t index) const;
+  std::vector<std::string_view> GetTopics(size_t index) const;
+  std::vector<std::string_view> GetEntities(size_t index) const;
+  std::string_view GetMetadata() const;
+
+  std::chrono::system_clock::time_point GetTimestamp(size_t index) const;
+  float GetImportanceScore(size_t index) const;
+  bool IsBookmarked(size_t index) const;
+
+ private:
+  enum Section {
+    kUrlOffsets,
+    kUrls,
+    kTitleOffsets,
+    kTitles,
+    kSummaryOffsets,
+    kSummaries,
+    kDictionaryOffsets,
+    kDictionary,
+    kTopicOffsets,
+    kTopicIds,
+    kEntityOffsets,
+    kEntityIds,
+    kTimestamps,
+    kImportanceScores,
+    kBookmarks,
+    kMetadata,
+    kSectionCount,
+  };
+
+  struct Column {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+  };
+
+  MemoryStore();
+
+  bool Parse();
+
+  // Entry |index| of a pool whose offsets are |OffsetType| values
+  template <typename OffsetType>
+  std::string_view GetString(Section offsets,
+                             Section bytes,
+                             size_t index) const;
+
+  // Dictionary strings of item |index| in an offsets and IDs column pair
+  std::vector<std::string_view> GetDictionaryStrings(Section offsets,
+                                                     Section ids,
+                                                     size_t index) const;
+
+  base::MemoryMappedFile mapping_;
+  std::array<Column, kSectionCount> sections_;
+  size_t dictionary_size_ = 0;
+  std::vector<int64_t> timestamps_;  // microseconds since the Unix epoch
+};
+
+}  // namespace ui
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_UI_MEMORY_STORE_H_
@@ -0,0 +1,112 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ui/memory_timeline.h"
+
+#include <algorithm>
+
+namespace browser_core {
+namespace ui {
+
+namespace {
+
+using Days = std::chrono::duration<int64_t, std::ratio<86400>>;
+
+}  // namespace
+
+MemoryTimeline::MemoryTimeline() = default;
+MemoryTimeline::~MemoryTimeline() = default;
+
+// static
+int64_t MemoryTimeline::GetDay(TimePoint time) {
+  return std::chrono::floor<Days>(time.time_since_epoch()).count();
+}
+
+void MemoryTimeline::Add(ItemId id, TimePoint time) {
+  int64_t day = GetDay(time);
+  auto [it, inserted] = partitions_.try_emplace(day);
+  Partition& partition = it->second;
+  if (inserted) {
+    partition.day = day;
+    partition.min_time = time;
+    partition.max_time = time;
+  } else {
+    partition.min_time = std::min(partition.min_time, time);
+    partition.max_time = std::max(partition.max_time, time);
+  }
+  partition.entries.push_back({id, time});
+}
+
+void MemoryTimeline::Move(ItemId id, TimePoint old_time, TimePoint new_time) {
+  Remove(id, old_time);
+  Add(id, new_time);
+}
+
+MemoryTimeline::Partition* MemoryTimeline::Find(TimePoint time) {
+  auto it = partitions_.find(GetDay(time));
+  return it == partitions_.end() ? nullptr : &it->second;
+}
+
+std::vector<MemoryTimeline::Partition*> MemoryTimeline::GetPartitionsInRange(
+    const TimePoint* start_time,
+    const TimePoint* end_time) {
+  if (start_time && end_time && *start_time > *end_time) {
+    return {};
+  }
+  auto begin = start_time ? partitions_.lower_bound(GetDay(*start_time))
+                          : partitions_.begin();
+  auto end = end_time ? partitions_.upper_bound(GetDay(*end_time))
+                      : partitions_.end();
+  std::vector<Partition*> result;
+  for (auto it = begin; it != end; ++it) {
+    Partition& partition = it->second;
+    if ((!start_time || partition.max_time >= *start_time) &&
+        (!end_time || partition.min_time <= *end_time)) {
+      result.push_back(&partition);
+    }
+  }
+  return result;
+}
+
+std::vector<MemoryTimeline::Partition*> MemoryTimeline::GetPartitionsBefore(
+    TimePoint time) {
+  std::vector<Partition*> result;
+  for (auto it = partitions_.begin();
+       it != partitions_.end() && it->first <= GetDay(time); ++it) {
+    if (it->second.max_time < time) {
+      result.push_back(&it->second);
+    }
+  }
+  return result;
+}
+
+void MemoryTimeline::Remove(ItemId id, TimePoint time) {
+  auto partition_it = partitions_.find(GetDay(time));
+  if (partition_it == partitions_.end()) {
+    return;
+  }
+  Partition& partition = partition_it->second;
+  auto it = std::find_if(partition.entries.begin(), partition.entries.end(),
+                         [id](const Entry& entry) { return entry.id == id; });
+  if (it == partition.entries.end()) {
+    return;
+  }
+  *it = partition.entries.back();
+  partition.entries.pop_back();
+  if (partition.entries.empty()) {
+    partitions_.erase(partition_it);
+    return;
+  }
+
+  if (time == partition.min_time || time == partition.max_time) {
+    auto [min_it, max_it] = std::minmax_element(
+        partition.entries.begin(), partition.entries.end(),
+        [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    partition.min_time = min_it->time;
+    partition.max_time = max_it->time;
+  }
+}
+
+}  // namespace ui
+}  // namespace browser_core
@@ -0,0 +1,79 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_UI_MEMORY_TIMELINE_H_
+#define BROWSER_CORE_UI_MEMORY_TIMELINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <map>
+#include <vector>
+
+namespace browser_core {
+namespace ui {
+
+// MemoryTimeline partitions history items by the day they were last
+// visited, so a time range query looks only at the days it overlaps
+// instead of at every item. Each partition knows the earliest and latest
+// visit in it, which also tells which partitions have gone cold.
+//
+// Items are identified by the caller's index. Days are UTC days since the
+// Unix epoch. Must be used on one sequence.
+class MemoryTimeline {
+ public:
+  using ItemId = size_t;
+  using TimePoint = std::chrono::system_clock::time_point;
+
+  struct Entry {
+    ItemId id;
+    TimePoint time;
+  };
+
+  struct Partition {
+    int64_t day = 0;
+    TimePoint min_time;
+    TimePoint max_time;
+    std::vector<Entry> entries;
+    // Set by the owner while part of the items' data is stored elsewhere
+    bool archived = false;
+  };
+
+  MemoryTimeline();
+  ~MemoryTimeline();
+
+  MemoryTimeline(const MemoryTimeline&) = delete;
+  MemoryTimeline& operator=(const MemoryTimeline&) = delete;
+
+  static int64_t GetDay(TimePoint time);
+
+  void Add(ItemId id, TimePoint time);
+
+  // Move item |id|, last visited at |old_time|, to |new_time|
+  void Move(ItemId id, TimePoint old_time, TimePoint new_time);
+
+  // The partition holding items visited at |time|, or null
+  Partition* Find(TimePoint time);
+
+  // Partitions with a visit in [start_time, end_time], oldest first. Null
+  // bounds are open.
+  std::vector<Partition*> GetPartitionsInRange(const TimePoint* start_time,
+                                               const TimePoint* end_time);
+
+  // Partitions whose latest visit is before |time|, oldest first
+  std::vector<Partition*> GetPartitionsBefore(TimePoint time);
+
+  size_t GetPartitionCount() const { return partitions_.size(); }
+
+ private:
+  void Remove(ItemId id, TimePoint time);
+
+  std::map<int64_t, Partition> partitions_;
+};
+
+}  // namespace ui
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_UI_MEMORY_TIMELINE_H_
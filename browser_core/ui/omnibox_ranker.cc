@@ -0,0 +1,171 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ui/omnibox_ranker.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "base/json/json_reader.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+
+namespace browser_core {
+namespace ui {
+
+namespace {
+
+// Feature names in model files, by Feature
+constexpr const char* kFeatureNames[] = {
+    "prefix_match",        "word_prefix_match", "url_prefix_match",
+    "substring_match",     "input_coverage",    "frecency",
+    "provider_confidence", "context_relevance", "is_action",
+    "is_navigation",       "is_search_query",
+};
+static_assert(std::size(kFeatureNames) == OmniboxRanker::kFeatureCount,
+              "Every feature needs a name");
+
+// Hand-tuned weights, used until a trained model is loaded
+constexpr float kDefaultBias = 0.0f;
+constexpr OmniboxRanker::FeatureVector kDefaultWeights = {
+    1.0f,   // kPrefixMatch
+    0.6f,   // kWordPrefixMatch
+    0.8f,   // kUrlPrefixMatch
+    0.2f,   // kSubstringMatch
+    0.3f,   // kInputCoverage
+    1.2f,   // kFrecency
+    0.8f,   // kProviderConfidence
+    0.6f,   // kContextRelevance
+    -0.2f,  // kIsAction
+    0.1f,   // kIsNavigation
+    0.0f,   // kIsSearchQuery
+};
+
+// Whether |text| has a word after the first that starts with |prefix|
+bool HasWordStartingWith(std::string_view text, std::string_view prefix) {
+  for (size_t pos = text.find(prefix, 1); pos != std::string_view::npos;
+       pos = text.find(prefix, pos + 1)) {
+    if (!base::IsAsciiAlphaNumeric(text[pos - 1])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+OmniboxRanker::OmniboxRanker()
+    : bias_(kDefaultBias), weights_(kDefaultWeights) {}
+
+OmniboxRanker::~OmniboxRanker() = default;
+
+bool OmniboxRanker::LoadModelFromJSON(const std::string& json) {
+  absl::optional<base::Value> model = base::JSONReader::Read(json);
+  if (!model || !model->is_dict()) {
+    return false;
+  }
+  const base::Value::Dict& dict = model->GetDict();
+  const base::Value::Dict* weights = dict.FindDict("weights");
+  if (!weights) {
+    return false;
+  }
+
+  FeatureVector loaded = {};
+  for (const auto [name, value] : *weights) {
+    const char* const* it =
+        std::find_if(std::begin(kFeatureNames), std::end(kFeatureNames),
+                     [&name](const char* feature) { return name == feature; });
+    if (it == std::end(kFeatureNames) ||
+        !(value.is_double() || value.is_int())) {
+      return false;
+    }
+    loaded[it - std::begin(kFeatureNames)] =
+        static_cast<float>(value.GetDouble());
+  }
+  bias_ = static_cast<float>(dict.FindDouble("bias").value_or(0.0));
+  weights_ = loaded;
+  return true;
+}
+
+std::vector<size_t> OmniboxRanker::Rank(
+    std::string_view input,
+    const std::vector<Candidate>& candidates,
+    size_t max_results) const {
+  std::string folded_input =
+      base::ToLowerASCII(base::TrimWhitespaceASCII(input, base::TRIM_ALL));
+  std::vector<float> scores(candidates.size());
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    scores[i] = Score(ExtractFeatures(folded_input, candidates[i]));
+  }
+
+  std::vector<size_t> order(candidates.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  size_t count = std::min(max_results, order.size());
+  std::partial_sort(order.begin(), order.begin() + count, order.end(),
+                    [&scores](size_t a, size_t b) {
+                      return scores[a] != scores[b] ? scores[a] > scores[b]
+                                                    : a < b;
+                    });
+  order.resize(count);
+  return order;
+}
+
+// static
+OmniboxRanker::FeatureVector OmniboxRanker::ExtractFeatures(
+    std::string_view folded_input,
+    const Candidate& candidate) {
+  FeatureVector features = {};
+  std::string text = base::ToLowerASCII(candidate.text);
+  std::string url = base::ToLowerASCII(candidate.url);
+
+  if (!folded_input.empty()) {
+    bool prefix = base::StartsWith(text, folded_input);
+    bool word_prefix = !prefix && HasWordStartingWith(text, folded_input);
+    std::string_view url_key = url;
+    for (std::string_view scheme : {"https://", "http://", "www."}) {
+      if (base::StartsWith(url_key, scheme)) {
+        url_key.remove_prefix(scheme.size());
+      }
+    }
+    bool url_prefix =
+        !url_key.empty() && base::StartsWith(url_key, folded_input);
+    features[kPrefixMatch] = prefix;
+    features[kWordPrefixMatch] = word_prefix;
+    features[kUrlPrefixMatch] = url_prefix;
+    features[kSubstringMatch] =
+        !prefix && !word_prefix && !url_prefix &&
+        (text.find(folded_input) != std::string::npos ||
+         url.find(folded_input) != std::string::npos);
+    if (!text.empty()) {
+      features[kInputCoverage] =
+          std::min(1.0f, static_cast<float>(folded_input.size()) /
+                             static_cast<float>(text.size()));
+    }
+  }
+
+  if (candidate.is_action) {
+    features[kContextRelevance] = candidate.relevance_score;
+  } else if (candidate.is_local) {
+    features[kFrecency] = candidate.relevance_score;
+  } else {
+    features[kProviderConfidence] = candidate.relevance_score;
+  }
+  features[kIsAction] = candidate.is_action;
+  features[kIsNavigation] = candidate.is_navigation;
+  features[kIsSearchQuery] = candidate.is_search_query;
+  return features;
+}
+
+float OmniboxRanker::Score(const FeatureVector& features) const {
+  float score = bias_;
+  for (size_t i = 0; i < kFeatureCount; ++i) {
+    score += weights_[i] * features[i];
+  }
+  return score;
+}
+
+}  // namespace ui
+}  // namespace browser_core
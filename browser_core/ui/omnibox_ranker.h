@@ -0,0 +1,96 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_UI_OMNIBOX_RANKER_H_
+#define BROWSER_CORE_UI_OMNIBOX_RANKER_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace browser_core {
+namespace ui {
+
+// OmniboxRanker orders merged omnibox suggestions, from every source, with
+// one linear model over features of each suggestion and the input.
+//
+// The model ships with hand-tuned weights and can be replaced by weights
+// trained offline, as JSON:
+//   {"bias": 0.0, "weights": {"prefix_match": 1.0, ...}}
+// naming any of the features below; features left out weigh 0.
+//
+// Scoring is a dot product per suggestion and ordering a partial sort of
+// the top K, so ranking stays in microseconds as sources are added.
+class OmniboxRanker {
+ public:
+  enum Feature {
+    // Text begins with the input
+    kPrefixMatch,
+    // A later word of the text begins with the input
+    kWordPrefixMatch,
+    // URL, without scheme or "www.", begins with the input
+    kUrlPrefixMatch,
+    // Input appears elsewhere in the text or URL
+    kSubstringMatch,
+    // Share of the text the input covers
+    kInputCoverage,
+    // Decayed visit weight, for local history, bookmarks and searches
+    kFrecency,
+    // AI or smart suggestion provider's own score
+    kProviderConfidence,
+    // Relevance of an action to the current page
+    kContextRelevance,
+    kIsAction,
+    kIsNavigation,
+    kIsSearchQuery,
+    kFeatureCount
+  };
+
+  using FeatureVector = std::array<float, kFeatureCount>;
+
+  // What ranking needs of one suggestion
+  struct Candidate {
+    std::string_view text;
+    std::string_view url;
+    float relevance_score = 0.0f;
+    bool is_local = false;
+    bool is_action = false;
+    bool is_navigation = false;
+    bool is_search_query = false;
+  };
+
+  OmniboxRanker();
+  ~OmniboxRanker();
+
+  OmniboxRanker(const OmniboxRanker&) = delete;
+  OmniboxRanker& operator=(const OmniboxRanker&) = delete;
+
+  // Replace the model with the one in |json|. Keeps the current model and
+  // returns false if |json| is malformed or names an unknown feature.
+  bool LoadModelFromJSON(const std::string& json);
+
+  // Indices of the best |max_results| of |candidates| for |input|, best
+  // first; equal scores keep their order.
+  std::vector<size_t> Rank(std::string_view input,
+                           const std::vector<Candidate>& candidates,
+                           size_t max_results) const;
+
+  // Features of |candidate| for the lowercase |folded_input|
+  static FeatureVector ExtractFeatures(std::string_view folded_input,
+                                       const Candidate& candidate);
+
+  float Score(const FeatureVector& features) const;
+
+ private:
+  float bias_;
+  FeatureVector weights_;
+};
+
+}  // namespace ui
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_UI_OMNIBOX_RANKER_H_
@@ -0,0 +1,381 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ui/omnibox_suggestion_trie.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "base/check.h"
+#include "base/strings/string_util.h"
+
+namespace browser_core {
+namespace ui {
+
+namespace {
+
+// Longest key indexed; longer text only matches by its beginning
+constexpr size_t kMaxKeyLength = 128;
+
+// |url| lowercased, without scheme or "www."
+std::string GetUrlKey(std::string_view url) {
+  std::string key = base::ToLowerASCII(url);
+  for (std::string_view prefix : {"https://", "http://", "www."}) {
+    if (base::StartsWith(key, prefix)) {
+      key.erase(0, prefix.size());
+    }
+  }
+  return key;
+}
+
+// log(exp(a) + exp(b)) without overflow
+double LogAddExp(double a, double b) {
+  double high = std::max(a, b);
+  return high + std::log1p(std::exp(std::min(a, b) - high));
+}
+
+size_t CommonPrefixLength(std::string_view a, std::string_view b) {
+  size_t length = 0;
+  while (length < a.size() && length < b.size() && a[length] == b[length]) {
+    ++length;
+  }
+  return length;
+}
+
+}  // namespace
+
+OmniboxSuggestionTrie::Node::Node() = default;
+OmniboxSuggestionTrie::Node::~Node() = default;
+
+OmniboxSuggestionTrie::OmniboxSuggestionTrie(const Options& options)
+    : options_(options) {}
+
+OmniboxSuggestionTrie::~OmniboxSuggestionTrie() = default;
+
+void OmniboxSuggestionTrie::AddVisit(const std::string& url,
+                                     const std::string& title,
+                                     base::Time time) {
+  if (url.empty()) {
+    return;
+  }
+  EntryId id = GetOrCreateEntry("u:" + url, Source::kHistory, title, url);
+  double weight =
+      entries_[id].bookmarked ? options_.bookmark_visit_weight : 1.0;
+  AddWeight(id, weight, time);
+}
+
+void OmniboxSuggestionTrie::AddBookmark(const std::string& url,
+                                        const std::string& title,
+                                        base::Time time) {
+  if (url.empty()) {
+    return;
+  }
+  EntryId id = GetOrCreateEntry("u:" + url, Source::kBookmark, title, url);
+  entries_[id].bookmarked = true;
+  entries_[id].source = Source::kBookmark;
+  AddWeight(id, options_.bookmark_visit_weight, time);
+}
+
+void OmniboxSuggestionTrie::AddSearchQuery(const std::string& query,
+                                           base::Time time) {
+  std::string text =
+      std::string(base::TrimWhitespaceASCII(query, base::TRIM_ALL));
+  if (text.empty()) {
+    return;
+  }
+  EntryId id = GetOrCreateEntry("q:" + base::ToLowerASCII(text),
+                                Source::kSearchQuery, text, std::string());
+  AddWeight(id, 1.0, time);
+}
+
+void OmniboxSuggestionTrie::RemoveUrl(const std::string& url) {
+  auto it = entry_ids_.find("u:" + url);
+  if (it == entry_ids_.end()) {
+    return;
+  }
+  RemoveEntry(it->second);
+  entry_ids_.erase(it);
+}
+
+void OmniboxSuggestionTrie::RemoveSearchQuery(const std::string& query) {
+  auto it = entry_ids_.find(
+      "q:" + base::ToLowerASCII(
+                 base::TrimWhitespaceASCII(query, base::TRIM_ALL)));
+  if (it == entry_ids_.end()) {
+    return;
+  }
+  RemoveEntry(it->second);
+  entry_ids_.erase(it);
+}
+
+std::vector<OmniboxSuggestionTrie::Suggestion> OmniboxSuggestionTrie::Find(
+    std::string_view input,
+    size_t max_results,
+    base::Time now) const {
+  std::vector<Suggestion> suggestions;
+  std::string key =
+      GetUrlKey(base::TrimWhitespaceASCII(input, base::TRIM_LEADING));
+  if (key.empty()) {
+    return suggestions;
+  }
+
+  // Find the node whose subtree holds every key starting with |key|
+  const Node* node = &root_;
+  size_t pos = 0;
+  while (pos < key.size()) {
+    auto it = std::lower_bound(
+        node->children.begin(), node->children.end(), key[pos],
+        [](const std::unique_ptr<Node>& child, char c) {
+          return child->label[0] < c;
+        });
+    if (it == node->children.end() || (*it)->label[0] != key[pos]) {
+      return suggestions;
+    }
+    std::string_view rest = std::string_view(key).substr(pos);
+    size_t common = CommonPrefixLength((*it)->label, rest);
+    if (common < rest.size() && common < (*it)->label.size()) {
+      return suggestions;
+    }
+    node = it->get();
+    pos += common;
+  }
+
+  const double now_shift = (now - base::Time::UnixEpoch()).InSecondsF() *
+                           std::log(2.0) / options_.half_life.InSecondsF();
+  size_t count = std::min(max_results, node->best.size());
+  suggestions.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const Entry& entry = entries_[node->best[i]];
+    double weight = std::exp(entry.score - now_shift);
+    suggestions.push_back(
+        {entry.text.empty() ? entry.url : entry.text, entry.url, entry.source,
+         static_cast<float>(weight / (weight + 2.0))});
+  }
+  return suggestions;
+}
+
+OmniboxSuggestionTrie::EntryId OmniboxSuggestionTrie::GetOrCreateEntry(
+    const std::string& lookup_key,
+    Source source,
+    std::string text,
+    std::string url) {
+  auto it = entry_ids_.find(lookup_key);
+  if (it != entry_ids_.end()) {
+    if (!text.empty()) {
+      entries_[it->second].text = std::move(text);
+    }
+    return it->second;
+  }
+
+  EntryId id;
+  if (!free_ids_.empty()) {
+    id = free_ids_.back();
+    free_ids_.pop_back();
+    entries_[id] = Entry();
+  } else {
+    id = static_cast<EntryId>(entries_.size());
+    entries_.emplace_back();
+  }
+  Entry& entry = entries_[id];
+  entry.text = std::move(text);
+  entry.url = std::move(url);
+  entry.source = source;
+  entry_ids_.emplace(lookup_key, id);
+  return id;
+}
+
+void OmniboxSuggestionTrie::AddWeight(EntryId id,
+                                      double weight,
+                                      base::Time time) {
+  // A weight |w| at time |t| compares with others as log(w) + t * ln2 /
+  // half_life, whenever they are compared
+  double shift = (time - base::Time::UnixEpoch()).InSecondsF() *
+                 std::log(2.0) / options_.half_life.InSecondsF();
+  Entry& entry = entries_[id];
+  entry.score = LogAddExp(entry.score, std::log(weight) + shift);
+  IndexEntry(id);
+}
+
+void OmniboxSuggestionTrie::IndexEntry(EntryId id) {
+  Entry& entry = entries_[id];
+  std::vector<std::string> keys;
+  if (!entry.url.empty()) {
+    keys.push_back(GetUrlKey(entry.url).substr(0, kMaxKeyLength));
+  }
+  std::string folded = base::ToLowerASCII(entry.text);
+  size_t words = 0;
+  for (size_t i = 0; i < folded.size() && words < options_.max_words_per_entry;
+       ++i) {
+    if (base::IsAsciiAlphaNumeric(folded[i]) &&
+        (i == 0 || !base::IsAsciiAlphaNumeric(folded[i - 1]))) {
+      keys.push_back(folded.substr(i, kMaxKeyLength));
+      ++words;
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  keys.erase(std::remove(keys.begin(), keys.end(), std::string()), keys.end());
+
+  // Keys of an old title go; the rest are promoted in place
+  for (const std::string& key : entry.keys) {
+    if (!std::binary_search(keys.begin(), keys.end(), key)) {
+      RemoveKey(key, id);
+    }
+  }
+  for (const std::string& key : keys) {
+    InsertKey(key, id);
+  }
+  entries_[id].keys = std::move(keys);
+}
+
+void OmniboxSuggestionTrie::RemoveEntry(EntryId id) {
+  std::vector<std::string> keys = std::move(entries_[id].keys);
+  for (const std::string& key : keys) {
+    RemoveKey(key, id);
+  }
+  entries_[id] = Entry();
+  free_ids_.push_back(id);
+}
+
+void OmniboxSuggestionTrie::InsertKey(const std::string& key, EntryId id) {
+  DCHECK(!key.empty());
+  std::vector<Node*> path = {&root_};
+  Node* node = &root_;
+  size_t pos = 0;
+  while (pos < key.size()) {
+    auto it = std::lower_bound(
+        node->children.begin(), node->children.end(), key[pos],
+        [](const std::unique_ptr<Node>& child, char c) {
+          return child->label[0] < c;
+        });
+    if (it == node->children.end() || (*it)->label[0] != key[pos]) {
+      auto child = std::make_unique<Node>();
+      child->label = key.substr(pos);
+      node = node->children.insert(it, std::move(child))->get();
+      path.push_back(node);
+      break;
+    }
+
+    size_t common = CommonPrefixLength((*it)->label,
+                                       std::string_view(key).substr(pos));
+    if (common < (*it)->label.size()) {
+      // Split the edge; the new node's subtree is the old child's
+      auto middle = std::make_unique<Node>();
+      middle->label = (*it)->label.substr(0, common);
+      middle->best = (*it)->best;
+      (*it)->label.erase(0, common);
+      middle->children.push_back(std::move(*it));
+      *it = std::move(middle);
+    }
+    node = it->get();
+    path.push_back(node);
+    pos += common;
+  }
+
+  if (std::find(node->terminal.begin(), node->terminal.end(), id) ==
+      node->terminal.end()) {
+    node->terminal.push_back(id);
+  }
+  for (Node* path_node : path) {
+    Promote(path_node, id);
+  }
+}
+
+void OmniboxSuggestionTrie::RemoveKey(const std::string& key, EntryId id) {
+  std::vector<Node*> path = GetPath(key);
+  if (path.empty()) {
+    return;
+  }
+  std::vector<EntryId>& terminal = path.back()->terminal;
+  terminal.erase(std::remove(terminal.begin(), terminal.end(), id),
+                 terminal.end());
+
+  for (size_t i = path.size() - 1; i > 0; --i) {
+    Node* node = path[i];
+    Node* parent = path[i - 1];
+    if (node->terminal.empty() && node->children.empty()) {
+      auto it = std::find_if(
+          parent->children.begin(), parent->children.end(),
+          [node](const std::unique_ptr<Node>& child) {
+            return child.get() == node;
+          });
+      parent->children.erase(it);
+      continue;
+    }
+    if (node->terminal.empty() && node->children.size() == 1) {
+      // Merge the only child in, keeping the trie compressed
+      std::unique_ptr<Node> child = std::move(node->children.front());
+      node->label += child->label;
+      node->children = std::move(child->children);
+      node->terminal = std::move(child->terminal);
+    }
+    RebuildBest(node);
+  }
+  RebuildBest(&root_);
+}
+
+std::vector<OmniboxSuggestionTrie::Node*> OmniboxSuggestionTrie::GetPath(
+    const std::string& key) {
+  std::vector<Node*> path = {&root_};
+  Node* node = &root_;
+  size_t pos = 0;
+  while (pos < key.size()) {
+    auto it = std::lower_bound(
+        node->children.begin(), node->children.end(), key[pos],
+        [](const std::unique_ptr<Node>& child, char c) {
+          return child->label[0] < c;
+        });
+    if (it == node->children.end() ||
+        std::string_view(key).substr(pos, (*it)->label.size()) !=
+            (*it)->label) {
+      return {};
+    }
+    node = it->get();
+    path.push_back(node);
+    pos += node->label.size();
+  }
+  return path;
+}
+
+void OmniboxSuggestionTrie::Promote(Node* node, EntryId id) {
+  std::vector<EntryId>& best = node->best;
+  best.erase(std::remove(best.begin(), best.end(), id), best.end());
+  auto it = std::lower_bound(
+      best.begin(), best.end(), id,
+      [this](EntryId a, EntryId b) { return IsBetter(a, b); });
+  if (static_cast<size_t>(it - best.begin()) >= options_.max_per_node) {
+    return;
+  }
+  best.insert(it, id);
+  if (best.size() > options_.max_per_node) {
+    best.pop_back();
+  }
+}
+
+void OmniboxSuggestionTrie::RebuildBest(Node* node) {
+  std::vector<EntryId> candidates = node->terminal;
+  for (const std::unique_ptr<Node>& child : node->children) {
+    candidates.insert(candidates.end(), child->best.begin(),
+                      child->best.end());
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [this](EntryId a, EntryId b) { return IsBetter(a, b); });
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+  if (candidates.size() > options_.max_per_node) {
+    candidates.resize(options_.max_per_node);
+  }
+  node->best = std::move(candidates);
+}
+
+bool OmniboxSuggestionTrie::IsBetter(EntryId a, EntryId b) const {
+  if (entries_[a].score != entries_[b].score) {
+    return entries_[a].score > entries_[b].score;
+  }
+  return a < b;
+}
+
+}  // namespace ui
+}  // namespace browser_core
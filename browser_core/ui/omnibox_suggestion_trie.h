@@ -0,0 +1,158 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_UI_OMNIBOX_SUGGESTION_TRIE_H_
+#define BROWSER_CORE_UI_OMNIBOX_SUGGESTION_TRIE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "base/time/time.h"
+
+namespace browser_core {
+namespace ui {
+
+// OmniboxSuggestionTrie suggests visited pages, bookmarks and past searches
+// for omnibox input without leaving the process, fast enough to answer on
+// every keystroke.
+//
+// Entries are keyed in a radix trie by their lowercase URL, without scheme
+// or "www.", and by every word start of their title or query, so "news"
+// finds "BBC News". Every trie node keeps the best entries of its subtree,
+// so a lookup walks the input's characters and reads one list, however
+// many entries the prefix matches.
+//
+// Entries rank by frecency: every visit adds a weight that halves every
+// |half_life|. The weight is kept as its logarithm shifted by the visit
+// time, which orders entries the same way at any later time, so the lists
+// kept in nodes never go stale as time passes; visits only move an entry
+// up. Visits of bookmarked pages weigh |bookmark_visit_weight|.
+class OmniboxSuggestionTrie {
+ public:
+  enum class Source { kHistory, kBookmark, kSearchQuery };
+
+  struct Suggestion {
+    // Title, or the query for kSearchQuery
+    std::string text;
+    // Empty for kSearchQuery
+    std::string url;
+    Source source;
+    // 0 to 1, growing with the decayed visit weight
+    float relevance = 0.0f;
+  };
+
+  struct Options {
+    base::TimeDelta half_life = base::Days(14);
+    double bookmark_visit_weight = 2.0;
+    // Best entries kept per node; the most one lookup returns
+    size_t max_per_node = 8;
+    // Title or query words indexed per entry
+    size_t max_words_per_entry = 8;
+  };
+
+  explicit OmniboxSuggestionTrie(const Options& options);
+  ~OmniboxSuggestionTrie();
+
+  OmniboxSuggestionTrie(const OmniboxSuggestionTrie&) = delete;
+  OmniboxSuggestionTrie& operator=(const OmniboxSuggestionTrie&) = delete;
+
+  // Record a visit of |url| at |time|; |title| replaces the known one if
+  // not empty.
+  void AddVisit(const std::string& url,
+                const std::string& title,
+                base::Time time);
+
+  // Bookmark |url|; counts as one visit at |time|.
+  void AddBookmark(const std::string& url,
+                   const std::string& title,
+                   base::Time time);
+
+  // Record a search for |query| at |time|
+  void AddSearchQuery(const std::string& query, base::Time time);
+
+  // Forget |url| or |query|, e.g. when history is deleted
+  void RemoveUrl(const std::string& url);
+  void RemoveSearchQuery(const std::string& query);
+
+  // Best entries matching |input| as a prefix, best first. |now| sets the
+  // relevance reported, not the order.
+  std::vector<Suggestion> Find(std::string_view input,
+                               size_t max_results,
+                               base::Time now) const;
+
+  size_t size() const { return entry_ids_.size(); }
+
+ private:
+  using EntryId = uint32_t;
+
+  struct Entry {
+    std::string text;
+    std::string url;
+    Source source;
+    bool bookmarked = false;
+    // Log of the visit weight decayed to the epoch
+    double score = -1e300;
+    // Keys the entry is indexed under
+    std::vector<std::string> keys;
+  };
+
+  struct Node {
+    Node();
+    ~Node();
+
+    // Label of the edge from the parent
+    std::string label;
+    // Children, by the first character of their label
+    std::vector<std::unique_ptr<Node>> children;
+    // Entries keyed exactly here
+    std::vector<EntryId> terminal;
+    // Best entries of the subtree, best first
+    std::vector<EntryId> best;
+  };
+
+  EntryId GetOrCreateEntry(const std::string& lookup_key,
+                           Source source,
+                           std::string text,
+                           std::string url);
+
+  // Add a visit of weight |weight| at |time| to |id| and reindex it
+  void AddWeight(EntryId id, double weight, base::Time time);
+
+  // Index |id| under the keys its text and URL give, and move it up the
+  // best lists on their paths
+  void IndexEntry(EntryId id);
+  void RemoveEntry(EntryId id);
+
+  void InsertKey(const std::string& key, EntryId id);
+  void RemoveKey(const std::string& key, EntryId id);
+
+  // Nodes from the root down to the node of |key|; empty if absent
+  std::vector<Node*> GetPath(const std::string& key);
+
+  // Move |id| into or up |node|'s best list
+  void Promote(Node* node, EntryId id);
+  // Rebuild |node|'s best list from its entries and children
+  void RebuildBest(Node* node);
+
+  bool IsBetter(EntryId a, EntryId b) const;
+
+  const Options options_;
+  Node root_;
+  std::vector<Entry> entries_;
+  // Live entries by "u:" URL or "q:" query
+  std::unordered_map<std::string, EntryId> entry_ids_;
+  // Ids of removed entries, for reuse
+  std::vector<EntryId> free_ids_;
+};
+
+}  // namespace ui
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_UI_OMNIBOX_SUGGESTION_TRIE_H_
@@ -0,0 +1,216 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ui/page_chunk_ranker.h"
+
+#include <algorithm>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+#include "asol/core/request_fingerprint.h"
+#include "asol/core/vector_kernels.h"
+#include "base/functional/bind.h"
+#include "base/json/json_reader.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+
+namespace browser_core {
+namespace ui {
+
+namespace {
+
+// Chunks are grown from whole elements until they pass this many characters
+constexpr size_t kTargetChunkSize = 600;
+
+// Chunk embeddings kept across searches
+constexpr size_t kMaxCachedEmbeddings = 2048;
+
+uint64_t HashChunkText(const std::string& text) {
+  asol::core::Hasher128 hasher;
+  hasher.Update(text);
+  return hasher.Finish().low;
+}
+
+void AppendToChunk(std::string_view text,
+                   std::string_view excerpt,
+                   std::vector<PageChunkRanker::Chunk>* chunks) {
+  if (chunks->empty() || chunks->back().text.size() >= kTargetChunkSize) {
+    chunks->emplace_back();
+  }
+  PageChunkRanker::Chunk& chunk = chunks->back();
+  if (!chunk.text.empty()) {
+    chunk.text += '\n';
+    chunk.excerpt += '\n';
+  }
+  chunk.text.append(text);
+  chunk.excerpt.append(excerpt);
+}
+
+}  // namespace
+
+PageChunkRanker::PageChunkRanker(asol::core::LocalAIProcessor* processor)
+    : processor_(processor) {}
+
+PageChunkRanker::~PageChunkRanker() = default;
+
+// static
+std::vector<PageChunkRanker::Chunk> PageChunkRanker::SplitPage(
+    const std::string& page_json) {
+  std::vector<Chunk> chunks;
+  absl::optional<base::Value> json = base::JSONReader::Read(page_json);
+  if (!json || !json->is_dict()) {
+    return chunks;
+  }
+  const base::Value::Dict& dict = json->GetDict();
+
+  if (const base::Value::List* elements = dict.FindList("elements")) {
+    for (const base::Value& element : *elements) {
+      if (!element.is_dict()) {
+        continue;
+      }
+      const base::Value::Dict& element_dict = element.GetDict();
+      std::string text = std::string(base::TrimWhitespaceASCII(
+          element_dict.FindString("text").value_or(""), base::TRIM_ALL));
+      if (text.empty()) {
+        continue;
+      }
+      std::string selector = element_dict.FindString("selector").value_or("");
+      AppendToChunk(text, "[" + selector + "] " + text, &chunks);
+    }
+  }
+  if (!chunks.empty()) {
+    return chunks;
+  }
+
+  // No elements; split the plain text on lines instead
+  std::string text = dict.FindString("text").value_or("");
+  for (std::string_view line : base::SplitStringPiece(
+           text, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    AppendToChunk(line, line, &chunks);
+  }
+  return chunks;
+}
+
+void PageChunkRanker::Rank(const std::string& query,
+                           std::vector<Chunk> chunks,
+                           size_t max_chunks,
+                           RankCallback callback) {
+  if (chunks.size() <= max_chunks) {
+    std::move(callback).Run(std::move(chunks));
+    return;
+  }
+  if (!processor_) {
+    std::move(callback).Run({});
+    return;
+  }
+
+  // Embed only chunks not seen before, each distinct text once, and the
+  // query last
+  std::vector<uint64_t> hashes;
+  hashes.reserve(chunks.size());
+  std::vector<uint64_t> embedded_hashes;
+  std::vector<std::string_view> texts;
+  std::unordered_set<uint64_t> seen;
+  for (const Chunk& chunk : chunks) {
+    uint64_t hash = HashChunkText(chunk.text);
+    hashes.push_back(hash);
+    if (!FindEmbedding(hash) && seen.insert(hash).second) {
+      embedded_hashes.push_back(hash);
+      texts.push_back(chunk.text);
+    }
+  }
+  texts.push_back(query);
+
+  processor_->GenerateEmbeddings(
+      texts, base::BindOnce(&PageChunkRanker::OnEmbedded,
+                            weak_ptr_factory_.GetWeakPtr(), std::move(chunks),
+                            std::move(hashes), std::move(embedded_hashes),
+                            max_chunks, std::move(callback)));
+}
+
+void PageChunkRanker::OnEmbedded(
+    std::vector<Chunk> chunks,
+    std::vector<uint64_t> hashes,
+    std::vector<uint64_t> embedded_hashes,
+    size_t max_chunks,
+    RankCallback callback,
+    asol::core::LocalAIProcessor::EmbeddingBatch batch) {
+  const size_t dimension = batch.dimension;
+  if (batch.size() != embedded_hashes.size() + 1) {
+    std::move(callback).Run({});
+    return;
+  }
+  for (size_t i = 0; i < embedded_hashes.size(); ++i) {
+    AddEmbedding(embedded_hashes[i],
+                 std::vector<float>(batch.row(i), batch.row(i) + dimension));
+  }
+
+  // Gather every chunk's row. One missing means the cache was cleared or
+  // outgrown meanwhile; one of another width means the model changed.
+  std::vector<float> rows;
+  rows.reserve(chunks.size() * dimension);
+  for (uint64_t hash : hashes) {
+    const std::vector<float>* embedding = FindEmbedding(hash);
+    if (!embedding || embedding->size() != dimension) {
+      cache_.clear();
+      cache_index_.clear();
+      std::move(callback).Run({});
+      return;
+    }
+    rows.insert(rows.end(), embedding->begin(), embedding->end());
+  }
+
+  std::vector<float> scores(chunks.size());
+  asol::core::DotProductRows(rows.data(), chunks.size(), dimension,
+                             batch.row(embedded_hashes.size()),
+                             scores.data());
+
+  std::vector<size_t> order(chunks.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::partial_sort(order.begin(), order.begin() + max_chunks, order.end(),
+                    [&scores](size_t a, size_t b) {
+                      return scores[a] > scores[b];
+                    });
+  order.resize(max_chunks);
+  std::sort(order.begin(), order.end());
+
+  std::vector<Chunk> best;
+  best.reserve(max_chunks);
+  for (size_t index : order) {
+    best.push_back(std::move(chunks[index]));
+  }
+  std::move(callback).Run(std::move(best));
+}
+
+const std::vector<float>* PageChunkRanker::FindEmbedding(uint64_t hash) {
+  auto it = cache_index_.find(hash);
+  if (it == cache_index_.end()) {
+    return nullptr;
+  }
+  cache_.splice(cache_.begin(), cache_, it->second);
+  return &it->second->second;
+}
+
+void PageChunkRanker::AddEmbedding(uint64_t hash,
+                                   std::vector<float> embedding) {
+  auto it = cache_index_.find(hash);
+  if (it != cache_index_.end()) {
+    it->second->second = std::move(embedding);
+    cache_.splice(cache_.begin(), cache_, it->second);
+    return;
+  }
+  cache_.emplace_front(hash, std::move(embedding));
+  cache_index_[hash] = cache_.begin();
+  if (cache_.size() > kMaxCachedEmbeddings) {
+    cache_index_.erase(cache_.back().first);
+    cache_.pop_back();
+  }
+}
+
+}  // namespace ui
+}  // namespace browser_core
@@ -0,0 +1,92 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_UI_PAGE_CHUNK_RANKER_H_
+#define BROWSER_CORE_UI_PAGE_CHUNK_RANKER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asol/core/local_ai_processor.h"
+#include "base/functional/callback.h"
+#include "base/memory/weak_ptr.h"
+
+namespace browser_core {
+namespace ui {
+
+// PageChunkRanker picks the parts of a page most related to a query with
+// the on-device embedding model, so only those go to the AI.
+//
+// A page, as the find-on-page extraction script returns it, is split into
+// chunks of consecutive text elements up to a size limit. Chunks and the
+// query are embedded in one batch and ranked by cosine similarity.
+// Embeddings are cached by a hash of the chunk text, so searching the same
+// page again, or a page that changed in places, only embeds new chunks.
+//
+// Must be used on one sequence.
+class PageChunkRanker {
+ public:
+  struct Chunk {
+    // Text of the chunk's elements, for embedding
+    std::string text;
+    // Each element as "[selector] text", one per line, for the prompt
+    std::string excerpt;
+  };
+
+  using RankCallback = base::OnceCallback<void(std::vector<Chunk> chunks)>;
+
+  // |processor| is not owned and must outlive this.
+  explicit PageChunkRanker(asol::core::LocalAIProcessor* processor);
+  ~PageChunkRanker();
+
+  PageChunkRanker(const PageChunkRanker&) = delete;
+  PageChunkRanker& operator=(const PageChunkRanker&) = delete;
+
+  // Chunks of the page in |page_json|, in page order. Falls back to the
+  // page's plain text, without selectors, if it has no elements.
+  static std::vector<Chunk> SplitPage(const std::string& page_json);
+
+  // Run |callback| with the |max_chunks| of |chunks| nearest |query|, in
+  // page order. Runs it with no chunks if embedding failed.
+  void Rank(const std::string& query,
+            std::vector<Chunk> chunks,
+            size_t max_chunks,
+            RankCallback callback);
+
+  size_t GetCachedEmbeddingCount() const { return cache_.size(); }
+
+ private:
+  using EmbeddingCache =
+      std::list<std::pair<uint64_t, std::vector<float>>>;
+
+  void OnEmbedded(std::vector<Chunk> chunks,
+                  std::vector<uint64_t> hashes,
+                  std::vector<uint64_t> embedded_hashes,
+                  size_t max_chunks,
+                  RankCallback callback,
+                  asol::core::LocalAIProcessor::EmbeddingBatch batch);
+
+  // Cached embedding for |hash|, promoted, or null
+  const std::vector<float>* FindEmbedding(uint64_t hash);
+  void AddEmbedding(uint64_t hash, std::vector<float> embedding);
+
+  asol::core::LocalAIProcessor* const processor_;
+
+  // Chunk embeddings by text hash, most recently used first
+  EmbeddingCache cache_;
+  std::unordered_map<uint64_t, EmbeddingCache::iterator> cache_index_;
+
+  base::WeakPtrFactory<PageChunkRanker> weak_ptr_factory_{this};
+};
+
+}  // namespace ui
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_UI_PAGE_CHUNK_RANKER_H_
@@ -8,10 +8,18 @@
 #include <sstream>
 #include <utility>
 
+#include "base/files/file_util.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/strings/string_util.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+#include "base/time/default_tick_clock.h"
+#include "base/time/time.h"
 #include "base/values.h"
+#include "browser_core/engine/navigation_predictor.h"
 #include "browser_core/engine/tab.h"
 #include "browser_core/engine/web_contents.h"
 
@@ -35,13 +43,13 @@ constexpr char kActionPrompt[] =
     "type, display_text, description, relevance_score).";
 
 // Helper function to create an action suggestion
-ActionSuggestion CreateActionSuggestion(
+PredictiveOmnibox::ActionSuggestion CreateActionSuggestion(
     PredictiveOmnibox::ActionType type,
     const std::string& display_text,
     const std::string& description,
     const std::string& icon_name,
     float relevance_score) {
-  ActionSuggestion action;
+  PredictiveOmnibox::ActionSuggestion action;
   action.type = type;
   action.display_text = display_text;
   action.description = description;
@@ -80,9 +88,33 @@ std::string GetActionTypeString(PredictiveOmnibox::ActionType type) {
   }
 }
 
+// Local suggestions shown per input
+constexpr size_t kMaxLocalSuggestions = 6;
+
+// Suggestions shown after merging every source
+constexpr size_t kMaxSuggestions = 10;
+
+// Debounce bounds; within them the delay is 1.5 keystroke intervals
+constexpr base::TimeDelta kMinDebounceDelay = base::Milliseconds(80);
+constexpr base::TimeDelta kMaxDebounceDelay = base::Milliseconds(400);
+constexpr base::TimeDelta kInitialTypingInterval = base::Milliseconds(150);
+
+// Keystroke gaps longer than this are pauses, not typing speed
+constexpr base::TimeDelta kMaxTypingInterval = base::Seconds(1);
+
+// Recent AI answers kept for inputs that extend them, and for how long
+constexpr size_t kMaxRecentAnswers = 8;
+constexpr base::TimeDelta kRecentAnswerLifetime = base::Minutes(1);
+
+// Matching suggestions a recent answer needs to stand for a longer input
+constexpr size_t kMinReusedSuggestions = 3;
+
 }  // namespace
 
-PredictiveOmnibox::PredictiveOmnibox() = default;
+PredictiveOmnibox::PredictiveOmnibox()
+    : clock_(base::DefaultTickClock::GetInstance()),
+      typing_interval_(kInitialTypingInterval) {}
+
 PredictiveOmnibox::~PredictiveOmnibox() = default;
 
 bool PredictiveOmnibox::Initialize(
@@ -116,13 +148,209 @@ void PredictiveOmnibox::GetSuggestions(
     return;
   }
 
-  // Generate context-aware suggestions
-  GenerateContextAwareSuggestions(input, current_tab_id, std::move(callback));
+  // Supersede the previous call
+  uint64_t generation = ++request_generation_;
+  if (request_cancellation_token_) {
+    request_cancellation_token_->Cancel();
+    request_cancellation_token_ = nullptr;
+  }
+
+  // Track typing speed as a moving average of keystroke gaps
+  base::TimeTicks now = clock_->NowTicks();
+  if (!last_input_time_.is_null()) {
+    base::TimeDelta gap = now - last_input_time_;
+    if (gap < kMaxTypingInterval) {
+      typing_interval_ = (typing_interval_ * 3 + gap) / 4;
+    }
+  }
+  last_input_time_ = now;
+
+  OmniboxSuggestions reused;
+  if (FindReusableResult(input, current_tab_id, &reused)) {
+    OnAISuggestions(input, std::move(callback), reused);
+    return;
+  }
+
+  // Generate context-aware suggestions once typing pauses
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&PredictiveOmnibox::StartAIRequest,
+                     weak_ptr_factory_.GetWeakPtr(), generation, input,
+                     current_tab_id, std::move(callback)),
+      GetDebounceDelay());
+}
+
+base::TimeDelta PredictiveOmnibox::GetDebounceDelay() const {
+  return std::clamp(typing_interval_ * 1.5, kMinDebounceDelay,
+                    kMaxDebounceDelay);
+}
+
+void PredictiveOmnibox::StartAIRequest(uint64_t generation,
+                                       const std::string& input,
+                                       int tab_id,
+                                       SuggestionsCallback callback) {
+  if (generation != request_generation_) {
+    return;
+  }
+  request_cancellation_token_ =
+      base::MakeRefCounted<asol::core::CancellationToken>();
+  GenerateContextAwareSuggestions(
+      input, tab_id, request_cancellation_token_,
+      base::BindOnce(&PredictiveOmnibox::OnAIResponse,
+                     weak_ptr_factory_.GetWeakPtr(), generation, input,
+                     tab_id, std::move(callback)));
+}
+
+void PredictiveOmnibox::OnAIResponse(uint64_t generation,
+                                     const std::string& input,
+                                     int tab_id,
+                                     SuggestionsCallback callback,
+                                     const OmniboxSuggestions& result) {
+  if (result.success) {
+    // Kept even if superseded; the newer input may extend this one
+    recent_answers_.push_back({input, tab_id, clock_->NowTicks(), result});
+    if (recent_answers_.size() > kMaxRecentAnswers) {
+      recent_answers_.pop_front();
+    }
+  }
+  if (generation != request_generation_) {
+    return;
+  }
+  request_cancellation_token_ = nullptr;
+  OnAISuggestions(input, std::move(callback), result);
+}
+
+bool PredictiveOmnibox::FindReusableResult(const std::string& input,
+                                           int tab_id,
+                                           OmniboxSuggestions* result) const {
+  std::string folded_input = base::ToLowerASCII(input);
+  base::TimeTicks now = clock_->NowTicks();
+  // Newest first; it is likely the longest prefix
+  for (auto it = recent_answers_.rbegin(); it != recent_answers_.rend();
+       ++it) {
+    if (it->tab_id != tab_id || now - it->time > kRecentAnswerLifetime ||
+        !base::StartsWith(folded_input, base::ToLowerASCII(it->input))) {
+      continue;
+    }
+
+    OmniboxSuggestions reused;
+    reused.success = true;
+    size_t matching = 0;
+    for (const PredictiveSuggestion& suggestion : it->result.suggestions) {
+      if (suggestion.is_action) {
+        // Actions depend on the page, not the input
+        reused.suggestions.push_back(suggestion);
+        continue;
+      }
+      if (base::ToLowerASCII(suggestion.text).find(folded_input) !=
+              std::string::npos ||
+          base::ToLowerASCII(suggestion.url).find(folded_input) !=
+              std::string::npos) {
+        reused.suggestions.push_back(suggestion);
+        ++matching;
+      }
+    }
+    if (matching >= kMinReusedSuggestions) {
+      *result = std::move(reused);
+      return true;
+    }
+  }
+  return false;
+}
+
+PredictiveOmnibox::OmniboxSuggestions PredictiveOmnibox::GetLocalSuggestions(
+    const std::string& input) const {
+  OmniboxSuggestions result;
+  result.success = is_enabled_;
+  if (!is_enabled_) {
+    result.error_message = "Predictive features are disabled";
+    return result;
+  }
+
+  for (const OmniboxSuggestionTrie::Suggestion& local :
+       local_suggestions_.Find(input, kMaxLocalSuggestions,
+                               base::Time::Now())) {
+    PredictiveSuggestion suggestion;
+    suggestion.text = local.text;
+    suggestion.url = local.url;
+    suggestion.relevance_score = local.relevance;
+    suggestion.is_search_query =
+        local.source == OmniboxSuggestionTrie::Source::kSearchQuery;
+    suggestion.is_navigation = !suggestion.is_search_query;
+    suggestion.is_action = false;
+    suggestion.is_local = true;
+    result.suggestions.push_back(std::move(suggestion));
+  }
+  return result;
+}
+
+void PredictiveOmnibox::RecordVisit(const std::string& url,
+                                    const std::string& title) {
+  local_suggestions_.AddVisit(url, title, base::Time::Now());
+}
+
+void PredictiveOmnibox::RecordBookmark(const std::string& url,
+                                       const std::string& title) {
+  local_suggestions_.AddBookmark(url, title, base::Time::Now());
+}
+
+void PredictiveOmnibox::RecordSearchQuery(const std::string& query) {
+  local_suggestions_.AddSearchQuery(query, base::Time::Now());
+}
+
+void PredictiveOmnibox::RemoveFromHistory(const std::string& url) {
+  local_suggestions_.RemoveUrl(url);
+}
+
+void PredictiveOmnibox::OnAISuggestions(const std::string& input,
+                                        SuggestionsCallback callback,
+                                        const OmniboxSuggestions& ai_result) {
+  OmniboxSuggestions local = GetLocalSuggestions(input);
+  if (!ai_result.success) {
+    // The local suggestions still stand without the AI's
+    PredictNavigation(local.suggestions);
+    std::move(callback).Run(local.suggestions.empty() ? ai_result : local);
+    return;
+  }
+
+  OmniboxSuggestions result = ai_result;
+  for (PredictiveSuggestion& suggestion : local.suggestions) {
+    bool duplicate = std::any_of(
+        result.suggestions.begin(), result.suggestions.end(),
+        [&suggestion](const PredictiveSuggestion& existing) {
+          return suggestion.url.empty()
+                     ? base::EqualsCaseInsensitiveASCII(existing.text,
+                                                        suggestion.text)
+                     : existing.url == suggestion.url;
+        });
+    if (!duplicate) {
+      result.suggestions.push_back(std::move(suggestion));
+    }
+  }
+  RankSuggestions(input, &result.suggestions);
+  PredictNavigation(result.suggestions);
+  std::move(callback).Run(result);
+}
+
+void PredictiveOmnibox::PredictNavigation(
+    const std::vector<PredictiveSuggestion>& suggestions) {
+  if (!browser_engine_) {
+    return;
+  }
+  std::vector<NavigationPredictor::Candidate> candidates;
+  for (const PredictiveSuggestion& suggestion : suggestions) {
+    if (suggestion.is_navigation && !suggestion.url.empty()) {
+      candidates.push_back({suggestion.url, suggestion.relevance_score});
+    }
+  }
+  browser_engine_->GetNavigationPredictor()->SetCandidates(
+      NavigationPredictor::Source::kOmnibox, std::move(candidates));
 }
 
 void PredictiveOmnibox::GenerateContextAwareSuggestions(
     const std::string& input,
     int tab_id,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
     SuggestionsCallback callback) {
   // Get the current tab
   Tab* tab = browser_engine_->GetTabById(tab_id);
@@ -147,6 +375,7 @@ void PredictiveOmnibox::GenerateContextAwareSuggestions(
           int tab_id,
           std::string page_url,
           std::string page_title,
+          scoped_refptr<asol::core::CancellationToken> cancellation_token,
           SuggestionsCallback callback,
           const ai::ContentUnderstanding::AnalysisResult& analysis_result) {
         if (!analysis_result.success) {
@@ -172,9 +401,6 @@ void PredictiveOmnibox::GenerateContextAwareSuggestions(
                                      smart_result.suggestions, 
                                      action_suggestions);
                 
-                // Rank suggestions
-                self->RankSuggestions(&result.suggestions);
-                
                 std::move(callback).Run(result);
               }, self, tab_id, std::move(callback)));
           return;
@@ -200,6 +426,7 @@ void PredictiveOmnibox::GenerateContextAwareSuggestions(
                 std::string page_title,
                 std::string topics_str,
                 const ai::ContentUnderstanding::AnalysisResult& analysis_result,
+                scoped_refptr<asol::core::CancellationToken> cancellation_token,
                 SuggestionsCallback callback,
                 const asol::core::ContextManager::UserContext& user_context) {
               // Prepare AI prompt
@@ -211,15 +438,21 @@ void PredictiveOmnibox::GenerateContextAwareSuggestions(
               base::ReplaceSubstringsAfterOffset(&prompt, 0, "{context}", user_context.recent_browsing_summary);
 
               // Request AI suggestions
-              self->ai_service_manager_->GetTextAdapter()->GenerateText(
-                  prompt,
+              asol::core::AIServiceManager::AIRequestParams params;
+              params.task_type =
+                  asol::core::AIServiceManager::TaskType::TEXT_GENERATION;
+              params.input_text = prompt;
+              params.cancellation_token = std::move(cancellation_token);
+              self->ai_service_manager_->ProcessRequest(
+                  params,
                   base::BindOnce([](
                       PredictiveOmnibox* self,
                       int tab_id,
                       const ai::ContentUnderstanding::AnalysisResult& analysis_result,
                       SuggestionsCallback callback,
-                      const asol::core::TextAdapter::GenerateTextResult& text_result) {
-                    if (!text_result.success) {
+                      bool success,
+                      const std::string& response) {
+                    if (!success) {
                       // Fall back to smart suggestions
                       self->smart_suggestions_->GetSuggestionsForCurrentPage(
                           tab_id,
@@ -242,16 +475,13 @@ void PredictiveOmnibox::GenerateContextAwareSuggestions(
                                                  smart_result.suggestions, 
                                                  action_suggestions);
                             
-                            // Rank suggestions
-                            self->RankSuggestions(&result.suggestions);
-                            
                             std::move(callback).Run(result);
                           }, self, tab_id, std::move(callback)));
                       return;
                     }
 
                     // Parse AI response
-                    absl::optional<base::Value> json = base::JSONReader::Read(text_result.text);
+                    absl::optional<base::Value> json = base::JSONReader::Read(response);
                     if (!json || !json->is_dict()) {
                       OmniboxSuggestions error_result;
                       error_result.success = false;
@@ -302,13 +532,10 @@ void PredictiveOmnibox::GenerateContextAwareSuggestions(
                                          {}, // Already added AI suggestions
                                          action_suggestions);
                     
-                    // Rank suggestions
-                    self->RankSuggestions(&result.suggestions);
-                    
                     std::move(callback).Run(result);
                   }, self, tab_id, analysis_result, std::move(callback)));
-            }, self, input, tab_id, page_url, page_title, topics_str, analysis_result, std::move(callback)));
-      }, this, input, tab_id, page_url, page_title, std::move(callback)));
+            }, self, input, tab_id, page_url, page_title, topics_str, analysis_result, std::move(cancellation_token), std::move(callback)));
+      }, this, input, tab_id, page_url, page_title, std::move(cancellation_token), std::move(callback)));
 }
 
 void PredictiveOmnibox::GenerateActionSuggestions(
@@ -320,20 +547,66 @@ void PredictiveOmnibox::GenerateActionSuggestions(
   Tab* tab = browser_engine_->GetTabById(tab_id);
   if (!tab) return;
   
-  // Get page information
+  // Use the actions computed for the tab's page, or compute them from its
+  // URL until the page finishes loading
   std::string page_url = tab->GetURL();
-  std::string page_title = tab->GetTitle();
-  
+  auto it = tab_actions_.find(tab_id);
+  if (it == tab_actions_.end() || it->second.url != page_url) {
+    TabActions& tab_actions = tab_actions_[tab_id];
+    tab_actions.url = page_url;
+    tab_actions.actions = ComputeActionSuggestions(
+        page_url, /*language=*/std::string(), /*is_article=*/false);
+    it = tab_actions_.find(tab_id);
+  }
+  actions->insert(actions->end(), it->second.actions.begin(),
+                  it->second.actions.end());
+}
+
+void PredictiveOmnibox::OnTabLoadFinished(int tab_id) {
+  Tab* tab = browser_engine_ ? browser_engine_->GetTabById(tab_id) : nullptr;
+  if (!tab || !tab->GetWebContents()) {
+    return;
+  }
+  tab->GetWebContents()->AnalyzeContent(base::BindOnce(
+      &PredictiveOmnibox::OnTabContentAnalyzed,
+      weak_ptr_factory_.GetWeakPtr(), tab_id, tab->GetURL()));
+}
+
+void PredictiveOmnibox::OnTabNavigated(int tab_id) {
+  tab_actions_.erase(tab_id);
+}
+
+void PredictiveOmnibox::OnTabContentAnalyzed(
+    int tab_id,
+    const std::string& page_url,
+    const WebContents::ContentAnalysis& analysis) {
+  Tab* tab = browser_engine_->GetTabById(tab_id);
+  if (!tab || tab->GetURL() != page_url) {
+    return;  // Navigated away meanwhile
+  }
+  TabActions& tab_actions = tab_actions_[tab_id];
+  tab_actions.url = page_url;
+  tab_actions.actions = ComputeActionSuggestions(page_url, analysis.language,
+                                                 analysis.is_article);
+}
+
+// static
+std::vector<PredictiveOmnibox::ActionSuggestion>
+PredictiveOmnibox::ComputeActionSuggestions(const std::string& page_url,
+                                            const std::string& language,
+                                            bool is_article) {
+  std::vector<ActionSuggestion> actions;
+
   // Add default actions based on URL patterns
   if (base::StartsWith(page_url, "https://www.youtube.com/watch")) {
-    actions->push_back(CreateActionSuggestion(
+    actions.push_back(CreateActionSuggestion(
         ActionType::SUMMARIZE,
         "Summarize this video",
         "Get a concise summary of this video's content",
         "summarize_icon",
         0.9f));
   } else if (base::EndsWith(page_url, ".pdf")) {
-    actions->push_back(CreateActionSuggestion(
+    actions.push_back(CreateActionSuggestion(
         ActionType::SUMMARIZE,
         "Summarize this PDF",
         "Get a concise summary of this PDF document",
@@ -342,29 +615,36 @@ void PredictiveOmnibox::GenerateActionSuggestions(
   } else if (base::StartsWith(page_url, "https://www.amazon.com/") ||
              base::StartsWith(page_url, "https://www.ebay.com/") ||
              base::StartsWith(page_url, "https://www.walmart.com/")) {
-    actions->push_back(CreateActionSuggestion(
+    actions.push_back(CreateActionSuggestion(
         ActionType::SHOP_COMPARE,
         "Compare prices",
         "Find better deals for this product",
         "shop_icon",
         0.9f));
   } else if (base::StartsWith(page_url, "https://github.com/")) {
-    actions->push_back(CreateActionSuggestion(
+    actions.push_back(CreateActionSuggestion(
         ActionType::ANALYZE,
         "Analyze repository",
         "Get insights about this GitHub repository",
         "analyze_icon",
         0.9f));
+  } else if (is_article) {
+    actions.push_back(CreateActionSuggestion(
+        ActionType::SUMMARIZE,
+        "Summarize this article",
+        "Get a concise summary of this article",
+        "summarize_icon",
+        0.9f));
   } else {
     // Default actions for general pages
-    actions->push_back(CreateActionSuggestion(
+    actions.push_back(CreateActionSuggestion(
         ActionType::SUMMARIZE,
         "Summarize this page",
         "Get a concise summary of this page's content",
         "summarize_icon",
         0.8f));
     
-    actions->push_back(CreateActionSuggestion(
+    actions.push_back(CreateActionSuggestion(
         ActionType::FIND_SIMILAR,
         "Find similar content",
         "Discover related articles and resources",
@@ -372,14 +652,19 @@ void PredictiveOmnibox::GenerateActionSuggestions(
         0.7f));
   }
   
-  // Add translate action if the page might be in a foreign language
-  // This would normally use language detection, but we'll simplify for the example
-  if (base::StartsWith(page_url, "https://www.") && 
-      !base::EndsWith(page_url, ".com") &&
-      !base::EndsWith(page_url, ".org") &&
-      !base::EndsWith(page_url, ".net") &&
-      !base::EndsWith(page_url, ".edu")) {
-    actions->push_back(CreateActionSuggestion(
+  // Add translate action if the page is in a foreign language, guessing
+  // from the domain until the page's language is known
+  bool foreign_language =
+      language.empty()
+          ? base::StartsWith(page_url, "https://www.") &&
+                !base::EndsWith(page_url, ".com") &&
+                !base::EndsWith(page_url, ".org") &&
+                !base::EndsWith(page_url, ".net") &&
+                !base::EndsWith(page_url, ".edu")
+          : !base::StartsWith(language, "en",
+                              base::CompareCase::INSENSITIVE_ASCII);
+  if (foreign_language) {
+    actions.push_back(CreateActionSuggestion(
         ActionType::TRANSLATE,
         "Translate this page",
         "Translate this page to your preferred language",
@@ -391,13 +676,15 @@ void PredictiveOmnibox::GenerateActionSuggestions(
   if (base::StartsWith(page_url, "https://en.wikipedia.org/") ||
       base::StartsWith(page_url, "https://www.britannica.com/") ||
       base::StartsWith(page_url, "https://www.khanacademy.org/")) {
-    actions->push_back(CreateActionSuggestion(
+    actions.push_back(CreateActionSuggestion(
         ActionType::RESEARCH,
         "Research this topic",
         "Find more in-depth information about this topic",
         "research_icon",
         0.9f));
   }
+
+  return actions;
 }
 
 void PredictiveOmnibox::MergeSuggestions(
@@ -405,6 +692,20 @@ void PredictiveOmnibox::MergeSuggestions(
     const std::vector<ai::SmartSuggestions::Suggestion>& smart_suggestions,
     const std::vector<ActionSuggestion>& action_suggestions) {
   if (!merged_suggestions) return;
+
+  if (browser_engine_) {
+    std::vector<NavigationPredictor::Candidate> candidates;
+    for (const auto& smart_suggestion : smart_suggestions) {
+      if (smart_suggestion.type ==
+              ai::SmartSuggestions::SuggestionType::NAVIGATION &&
+          !smart_suggestion.url.empty()) {
+        candidates.push_back(
+            {smart_suggestion.url, smart_suggestion.relevance_score});
+      }
+    }
+    browser_engine_->GetNavigationPredictor()->SetCandidates(
+        NavigationPredictor::Source::kSmartSuggestions, std::move(candidates));
+  }
   
   // Add smart suggestions
   for (const auto& smart_suggestion : smart_suggestions) {
@@ -440,18 +741,55 @@ void PredictiveOmnibox::MergeSuggestions(
 }
 
 void PredictiveOmnibox::RankSuggestions(
+    const std::string& input,
     std::vector<PredictiveSuggestion>* suggestions) {
   if (!suggestions) return;
-  
-  // Sort by relevance score (descending)
-  std::sort(suggestions->begin(), suggestions->end(),
-            [](const PredictiveSuggestion& a, const PredictiveSuggestion& b) {
-              return a.relevance_score > b.relevance_score;
-            });
-  
-  // Limit to top 10 suggestions
-  if (suggestions->size() > 10) {
-    suggestions->resize(10);
+
+  std::vector<OmniboxRanker::Candidate> candidates;
+  candidates.reserve(suggestions->size());
+  for (const PredictiveSuggestion& suggestion : *suggestions) {
+    OmniboxRanker::Candidate candidate;
+    candidate.text = suggestion.text;
+    candidate.url = suggestion.url;
+    candidate.relevance_score = suggestion.relevance_score;
+    candidate.is_local = suggestion.is_local;
+    candidate.is_action = suggestion.is_action;
+    candidate.is_navigation = suggestion.is_navigation;
+    candidate.is_search_query = suggestion.is_search_query;
+    candidates.push_back(candidate);
+  }
+
+  // Keep the top suggestions, best first
+  std::vector<size_t> order =
+      ranker_.Rank(input, candidates, kMaxSuggestions);
+  std::vector<PredictiveSuggestion> ranked;
+  ranked.reserve(order.size());
+  for (size_t index : order) {
+    ranked.push_back(std::move((*suggestions)[index]));
+  }
+  *suggestions = std::move(ranked);
+}
+
+void PredictiveOmnibox::LoadRankingModel(const base::FilePath& path) {
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::BEST_EFFORT},
+      base::BindOnce(
+          [](const base::FilePath& path) {
+            std::string json;
+            if (!base::ReadFileToString(path, &json)) {
+              json.clear();
+            }
+            return json;
+          },
+          path),
+      base::BindOnce(&PredictiveOmnibox::OnRankingModelRead,
+                     weak_ptr_factory_.GetWeakPtr(), path));
+}
+
+void PredictiveOmnibox::OnRankingModelRead(const base::FilePath& path,
+                                           const std::string& json) {
+  if (!ranker_.LoadModelFromJSON(json)) {
+    LOG(ERROR) << "Failed to load omnibox ranking model: " << path.value();
   }
 }
 
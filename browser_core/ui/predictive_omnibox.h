@@ -5,15 +5,27 @@
 #ifndef BROWSER_CORE_UI_PREDICTIVE_OMNIBOX_H_
 #define BROWSER_CORE_UI_PREDICTIVE_OMNIBOX_H_
 
+#include <stdint.h>
+
+#include <deque>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "asol/core/cancellation_token.h"
 #include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/tick_clock.h"
+#include "base/time/time.h"
 #include "browser_core/ai/smart_suggestions.h"
 #include "browser_core/ai/content_understanding.h"
 #include "browser_core/engine/browser_engine.h"
+#include "browser_core/engine/web_contents.h"
+#include "browser_core/ui/omnibox_ranker.h"
+#include "browser_core/ui/omnibox_suggestion_trie.h"
 #include "asol/core/ai_service_manager.h"
 #include "asol/core/context_manager.h"
 
@@ -55,6 +67,8 @@ class PredictiveOmnibox {
     bool is_navigation;
     bool is_action;
     ActionSuggestion action;
+    // From local history, bookmarks or past searches
+    bool is_local = false;
   };
 
   // Suggestions result
@@ -86,11 +100,40 @@ class PredictiveOmnibox {
                 ai::SmartSuggestions* smart_suggestions,
                 ai::ContentUnderstanding* content_understanding);
 
-  // Get suggestions based on user input and current context
+  // Get suggestions based on user input and current context. The result
+  // includes the local suggestions, merged with the AI's.
+  //
+  // Meant to be called on every keystroke. The AI is asked once typing
+  // pauses, for a time adapted to the user's typing speed, and not at all
+  // if a recent answer for a prefix of |input| still has enough matching
+  // suggestions. A newer call supersedes this one: its AI request is
+  // cancelled and |callback| is dropped.
   void GetSuggestions(const std::string& input, 
                     int current_tab_id,
                     SuggestionsCallback callback);
 
+  // Suggestions from local history, bookmarks and past searches, returned
+  // at once, to show while GetSuggestions() waits for the AI
+  OmniboxSuggestions GetLocalSuggestions(const std::string& input) const;
+
+  // Feed the local suggestions
+  void RecordVisit(const std::string& url, const std::string& title);
+  void RecordBookmark(const std::string& url, const std::string& title);
+  void RecordSearchQuery(const std::string& query);
+  void RemoveFromHistory(const std::string& url);
+
+  // Page lifecycle of tab |tab_id|. Action suggestions are computed once
+  // per page when it finishes loading, from its URL, language and kind,
+  // and dropped when the tab navigates or closes.
+  void OnTabLoadFinished(int tab_id);
+  void OnTabNavigated(int tab_id);
+  void OnTabClosed(int tab_id) { OnTabNavigated(tab_id); }
+
+  // Rank suggestions with the model in the JSON file at |path|, once read;
+  // see OmniboxRanker. Until then, and if it fails, the built-in model is
+  // used.
+  void LoadRankingModel(const base::FilePath& path);
+
   // Execute an action suggestion
   void ExecuteAction(const ActionSuggestion& action,
                    int tab_id,
@@ -103,20 +146,66 @@ class PredictiveOmnibox {
   // Get a weak pointer to this instance
   base::WeakPtr<PredictiveOmnibox> GetWeakPtr();
 
+  void SetTickClockForTesting(const base::TickClock* clock) { clock_ = clock; }
+
  private:
   // Helper methods
-  void GenerateContextAwareSuggestions(const std::string& input,
-                                     int tab_id,
-                                     SuggestionsCallback callback);
+  void GenerateContextAwareSuggestions(
+      const std::string& input,
+      int tab_id,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      SuggestionsCallback callback);
+
+  // Debounce delay for the typing speed seen so far
+  base::TimeDelta GetDebounceDelay() const;
+
+  // Ask the AI for |input|, unless a newer call superseded it
+  void StartAIRequest(uint64_t generation,
+                      const std::string& input,
+                      int tab_id,
+                      SuggestionsCallback callback);
+  void OnAIResponse(uint64_t generation,
+                    const std::string& input,
+                    int tab_id,
+                    SuggestionsCallback callback,
+                    const OmniboxSuggestions& result);
+
+  // Suggestions of a recent answer for a prefix of |input| that still
+  // match it, if there are enough
+  bool FindReusableResult(const std::string& input,
+                          int tab_id,
+                          OmniboxSuggestions* result) const;
 
   void GenerateActionSuggestions(int tab_id,
                                std::vector<ActionSuggestion>* actions);
 
+  void OnTabContentAnalyzed(int tab_id,
+                            const std::string& page_url,
+                            const WebContents::ContentAnalysis& analysis);
+
+  // Actions for the page at |page_url|; |language| is empty if unknown
+  static std::vector<ActionSuggestion> ComputeActionSuggestions(
+      const std::string& page_url,
+      const std::string& language,
+      bool is_article);
+
   void MergeSuggestions(std::vector<PredictiveSuggestion>* merged_suggestions,
                       const std::vector<ai::SmartSuggestions::Suggestion>& smart_suggestions,
                       const std::vector<ActionSuggestion>& action_suggestions);
 
-  void RankSuggestions(std::vector<PredictiveSuggestion>* suggestions);
+  // Order |suggestions| for |input| with the ranking model, keeping the top
+  void RankSuggestions(const std::string& input,
+                       std::vector<PredictiveSuggestion>* suggestions);
+  void OnRankingModelRead(const base::FilePath& path, const std::string& json);
+
+  // Merge the local suggestions for |input| into |ai_result|
+  void OnAISuggestions(const std::string& input,
+                       SuggestionsCallback callback,
+                       const OmniboxSuggestions& ai_result);
+
+  // Offer the navigations among the |suggestions| shown to the browser
+  // engine's NavigationPredictor
+  void PredictNavigation(const std::vector<PredictiveSuggestion>& suggestions);
 
   // Components
   BrowserEngine* browser_engine_ = nullptr;
@@ -124,10 +213,37 @@ class PredictiveOmnibox {
   asol::core::ContextManager* context_manager_ = nullptr;
   ai::SmartSuggestions* smart_suggestions_ = nullptr;
   ai::ContentUnderstanding* content_understanding_ = nullptr;
+  OmniboxSuggestionTrie local_suggestions_{OmniboxSuggestionTrie::Options()};
+  OmniboxRanker ranker_;
 
   // State
   bool is_enabled_ = true;
 
+  // Keystroke timing, for the debounce delay
+  const base::TickClock* clock_;
+  base::TimeTicks last_input_time_;
+  base::TimeDelta typing_interval_;
+
+  // The latest GetSuggestions() call, and its AI request if running
+  uint64_t request_generation_ = 0;
+  scoped_refptr<asol::core::CancellationToken> request_cancellation_token_;
+
+  // Recent AI answers, newest last
+  struct RecentAnswer {
+    std::string input;
+    int tab_id;
+    base::TimeTicks time;
+    OmniboxSuggestions result;
+  };
+  std::deque<RecentAnswer> recent_answers_;
+
+  // Action suggestions by tab, for the page at |url|
+  struct TabActions {
+    std::string url;
+    std::vector<ActionSuggestion> actions;
+  };
+  std::map<int, TabActions> tab_actions_;
+
   // For weak pointers
   base::WeakPtrFactory<PredictiveOmnibox> weak_ptr_factory_{this};
 };
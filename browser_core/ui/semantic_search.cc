@@ -6,12 +6,21 @@
 
 #include <sstream>
 #include <algorithm>
+#include <set>
+#include <string_view>
 #include <utility>
 
+#include "base/functional/bind.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/location.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/time.h"
 #include "base/values.h"
+#include "asol/core/prompt_cache.h"
+#include "asol/core/prompt_template.h"
 
 namespace browser_core {
 namespace ui {
@@ -19,223 +28,285 @@ namespace ui {
 namespace {
 
 // Constants for AI prompts
-constexpr char kSemanticSearchPrompt[] = 
-    "Search the following web page content for information related to the query: \"{query}\". "
+// Fixed instructions first, then the page, then the query, so repeated
+// searches of a page share a prompt prefix providers can cache
+constexpr asol::core::PromptTemplate kSemanticSearchPrompt(
+    "Search the web page content below for information related to the query that follows it. "
     "Find content that is semantically relevant to the query, even if it doesn't contain the exact keywords. "
     "Consider synonyms, related concepts, and contextual meaning. "
-    "\n\nPage content:\n{page_content}\n\n"
     "Format response as JSON with the following fields: "
     "matches (array of objects with text, context, relevance_score, selector, start_offset, end_offset, match_reason), "
-    "suggested_query (string), related_concepts (array of strings).";
+    "suggested_query (string), related_concepts (array of strings)."
+    "\n\nPage content:\n{page_content}{truncation_note}\n\n"
+    "Query: \"{query}\"",
+    "query");
 
-// JavaScript for extracting page content
-constexpr char kExtractPageContentScript[] = R"(
-  (function() {
-    // Extract main content
-    const content = {
-      title: document.title,
-      url: window.location.href,
-      text: document.body.innerText,
-      elements: []
-    };
-    
-    // Extract text elements with their selectors
-    const textElements = document.querySelectorAll('p, h1, h2, h3, h4, h5, h6, li, td, th, div:not(:has(*))');
-    for (let i = 0; i < textElements.length; i++) {
-      const el = textElements[i];
-      if (el.innerText.trim().length > 0) {
-        // Create a unique selector for the element
-        let selector = '';
-        if (el.id) {
-          selector = '#' + el.id;
-        } else if (el.className && typeof el.className === 'string') {
-          selector = el.tagName.toLowerCase() + '.' + 
-                    el.className.trim().replace(/\s+/g, '.');
-        } else {
-          // Create a path selector
-          let path = [];
-          let currentEl = el;
-          while (currentEl && currentEl.tagName !== 'HTML') {
-            let selector = currentEl.tagName.toLowerCase();
-            if (currentEl.id) {
-              selector += '#' + currentEl.id;
-              path.unshift(selector);
-              break;
-            } else if (currentEl.className && typeof currentEl.className === 'string') {
-              selector += '.' + currentEl.className.trim().replace(/\s+/g, '.');
-            }
-            
-            // Add nth-child if needed
-            if (!currentEl.id) {
-              let siblings = 1;
-              let sibling = currentEl;
-              while (sibling = sibling.previousElementSibling) {
-                siblings++;
-              }
-              if (siblings > 1) {
-                selector += ':nth-child(' + siblings + ')';
-              }
-            }
-            
-            path.unshift(selector);
-            currentEl = currentEl.parentElement;
-          }
-          selector = path.join(' > ');
-        }
-        
-        content.elements.push({
-          text: el.innerText.trim(),
-          selector: selector,
-          tag: el.tagName.toLowerCase()
-        });
+// Page content sent with a search, in bytes
+constexpr size_t kMaxSearchContentLength = 10000;
+
+// Page chunks sent to the AI when they are pre-ranked locally
+constexpr size_t kMaxPreRankedChunks = 6;
+
+// Lexical matches reported by progressive search
+constexpr size_t kMaxLexicalMatches = 50;
+
+// Typing pause before progressive search asks the AI
+constexpr base::TimeDelta kSemanticSearchDelay = base::Milliseconds(300);
+
+// Page state shared by the highlight, navigate and clear scripts.
+// |highlights| holds each match's spans, by match index, null if the match
+// was not found; |spans| holds every span, for removal.
+constexpr char kHighlightStateScript[] = R"(
+  function dashaiSemanticSearchState() {
+    let state = window.dashai_semantic_search;
+    if (!state) {
+      state = window.dashai_semantic_search = {
+        highlights: [],
+        spans: [],
+        current: -1,
+        pendingFrame: 0,
+        pendingApply: null,
+      };
+      const style = document.createElement('style');
+      style.textContent =
+          '.dashai-semantic-highlight { background-color: rgba(255, 255, 0, 0.3);' +
+          ' color: inherit; border-radius: 2px; }' +
+          '.dashai-semantic-highlight.dashai-semantic-current {' +
+          ' background-color: rgba(255, 165, 0, 0.5); outline: 2px solid orange; }';
+      document.head.appendChild(style);
+    }
+    return state;
+  }
+
+  // Apply a highlight batch still waiting for its frame
+  function dashaiFlushHighlights(state) {
+    if (state.pendingFrame) {
+      cancelAnimationFrame(state.pendingFrame);
+      state.pendingFrame = 0;
+      const apply = state.pendingApply;
+      state.pendingApply = null;
+      apply();
+    }
+  }
+
+  function dashaiRemoveHighlights(state) {
+    dashaiFlushHighlights(state);
+    const parents = new Set();
+    for (const span of state.spans) {
+      const parent = span.parentNode;
+      if (parent) {
+        parent.replaceChild(document.createTextNode(span.textContent), span);
+        parents.add(parent);
       }
     }
-    
-    return JSON.stringify(content);
-  })();
+    for (const parent of parents) {
+      parent.normalize();
+    }
+    state.highlights = [];
+    state.spans = [];
+    state.current = -1;
+  }
 )";
 
-// JavaScript for highlighting matches
+// JavaScript for highlighting matches. One TreeWalker pass maps the page's
+// text to its text nodes; matches are located in that text, preferring
+// ones inside their selector's element, and all are wrapped in one batch
+// in the next animation frame.
 constexpr char kHighlightMatchesScript[] = R"(
   (function(matches) {
-    // Remove existing highlights
-    const existingHighlights = document.querySelectorAll('.dashai-semantic-highlight');
-    for (let i = 0; i < existingHighlights.length; i++) {
-      const highlight = existingHighlights[i];
-      const parent = highlight.parentNode;
-      parent.replaceChild(document.createTextNode(highlight.textContent), highlight);
-      parent.normalize();
+    $HIGHLIGHT_STATE
+    const state = dashaiSemanticSearchState();
+    dashaiRemoveHighlights(state);
+
+    // Offset map: every visible text node and where its text starts
+    const nodes = [];
+    const starts = [];
+    let text = '';
+    const walker = document.createTreeWalker(
+        document.body, NodeFilter.SHOW_TEXT, {
+          acceptNode(node) {
+            const parent = node.parentElement;
+            if (!parent || /^(SCRIPT|STYLE|NOSCRIPT|TEXTAREA)$/.test(parent.tagName)) {
+              return NodeFilter.FILTER_REJECT;
+            }
+            return NodeFilter.FILTER_ACCEPT;
+          }
+        });
+    for (let node = walker.nextNode(); node; node = walker.nextNode()) {
+      nodes.push(node);
+      starts.push(text.length);
+      text += node.data;
+    }
+
+    // Index of the text node holding |offset|
+    function nodeAt(offset) {
+      let low = 0;
+      let high = starts.length - 1;
+      while (low < high) {
+        const mid = (low + high + 1) >> 1;
+        if (starts[mid] <= offset) {
+          low = mid;
+        } else {
+          high = mid - 1;
+        }
+      }
+      return low;
     }
-    
-    // Create highlights for each match
-    const highlightedMatches = [];
+
+    // Locate each match once, not reusing a range another match took
+    const elements = new Map();
+    const taken = new Set();
+    const segments = [];
+    let found = 0;
     for (let i = 0; i < matches.length; i++) {
       const match = matches[i];
-      const elements = document.querySelectorAll(match.selector);
-      
-      for (let j = 0; j < elements.length; j++) {
-        const element = elements[j];
-        const text = element.textContent;
-        
-        // Find the match text in the element
-        const matchText = match.text;
-        const matchIndex = text.indexOf(matchText);
-        
-        if (matchIndex >= 0) {
-          // Create a highlight span
-          const highlightSpan = document.createElement('span');
-          highlightSpan.className = 'dashai-semantic-highlight';
-          highlightSpan.dataset.matchIndex = i;
-          highlightSpan.style.backgroundColor = 'rgba(255, 255, 0, 0.3)';
-          highlightSpan.style.color = 'inherit';
-          highlightSpan.style.borderRadius = '2px';
-          highlightSpan.textContent = matchText;
-          
-          // Replace the text with the highlight
-          const range = document.createRange();
-          const textNode = Array.from(element.childNodes).find(node => 
-            node.nodeType === Node.TEXT_NODE && node.textContent.includes(matchText)
-          );
-          
-          if (textNode) {
-            const nodeText = textNode.textContent;
-            const nodeMatchIndex = nodeText.indexOf(matchText);
-            
-            if (nodeMatchIndex >= 0) {
-              // Split the text node and insert the highlight
-              const beforeText = nodeText.substring(0, nodeMatchIndex);
-              const afterText = nodeText.substring(nodeMatchIndex + matchText.length);
-              
-              const beforeNode = document.createTextNode(beforeText);
-              const afterNode = document.createTextNode(afterText);
-              
-              element.replaceChild(afterNode, textNode);
-              element.insertBefore(highlightSpan, afterNode);
-              element.insertBefore(beforeNode, highlightSpan);
-              
-              highlightedMatches.push({
-                element: highlightSpan,
-                matchIndex: i,
-                rect: highlightSpan.getBoundingClientRect()
-              });
-            }
-          }
+      if (!match.text) {
+        continue;
+      }
+      let scope = null;
+      if (match.selector) {
+        if (!elements.has(match.selector)) {
+          let element = null;
+          try {
+            element = document.querySelector(match.selector);
+          } catch (e) {}
+          elements.set(match.selector, element);
+        }
+        scope = elements.get(match.selector);
+      }
+      let start = -1;
+      let fallback = -1;
+      for (let at = text.indexOf(match.text); at >= 0;
+           at = text.indexOf(match.text, at + 1)) {
+        if (taken.has(at)) {
+          continue;
+        }
+        if (!scope || scope.contains(nodes[nodeAt(at)])) {
+          start = at;
+          break;
+        }
+        if (fallback < 0) {
+          fallback = at;
+        }
+      }
+      if (start < 0) {
+        start = fallback;
+      }
+      if (start < 0) {
+        continue;
+      }
+      taken.add(start);
+      found++;
+
+      // Split the range into per-node pieces
+      const end = start + match.text.length;
+      for (let n = nodeAt(start); n < nodes.length && starts[n] < end; n++) {
+        const nodeStart = Math.max(start - starts[n], 0);
+        const nodeEnd = Math.min(end - starts[n], nodes[n].data.length);
+        if (nodeEnd > nodeStart) {
+          segments.push({node: n, start: nodeStart, end: nodeEnd, match: i});
         }
       }
     }
-    
-    // Store the highlighted matches in a global variable
-    window.dashai_semantic_matches = highlightedMatches;
-    
-    return highlightedMatches.length;
-  })(arguments[0]);
+
+    // Wrap from the end of each node back, so earlier offsets stay valid
+    segments.sort((a, b) => a.node - b.node || b.start - a.start);
+    state.highlights = new Array(matches.length).fill(null);
+    state.pendingApply = function() {
+      for (const segment of segments) {
+        const node = nodes[segment.node];
+        // Skip pieces overlapping one wrapped already, or gone from the page
+        if (!node.parentNode || segment.end > node.data.length) {
+          continue;
+        }
+        node.splitText(segment.end);
+        const piece = node.splitText(segment.start);
+        const span = document.createElement('span');
+        span.className = 'dashai-semantic-highlight';
+        span.dataset.matchIndex = segment.match;
+        piece.parentNode.replaceChild(span, piece);
+        span.appendChild(piece);
+        state.spans.push(span);
+        const spans = state.highlights[segment.match] ||
+                      (state.highlights[segment.match] = []);
+        spans.push(span);
+      }
+    };
+    state.pendingFrame = requestAnimationFrame(function() {
+      state.pendingFrame = 0;
+      const apply = state.pendingApply;
+      state.pendingApply = null;
+      apply();
+    });
+
+    return found;
+  })($MATCHES);
 )";
 
 // JavaScript for navigating matches
 constexpr char kNavigateMatchesScript[] = R"(
   (function(direction) {
-    if (!window.dashai_semantic_matches || window.dashai_semantic_matches.length === 0) {
+    $HIGHLIGHT_STATE
+    const state = window.dashai_semantic_search;
+    if (!state) {
       return -1;
     }
-    
-    // Get the current match index
-    let currentIndex = window.dashai_current_match_index || -1;
-    
-    // Calculate the next index
-    if (direction === 'next') {
-      currentIndex = (currentIndex + 1) % window.dashai_semantic_matches.length;
-    } else {
-      currentIndex = (currentIndex - 1 + window.dashai_semantic_matches.length) % window.dashai_semantic_matches.length;
+    dashaiFlushHighlights(state);
+    const highlights = state.highlights;
+    const count = highlights.length;
+    if (!highlights.some(spans => spans)) {
+      return -1;
     }
-    
-    // Update the current index
-    window.dashai_current_match_index = currentIndex;
-    
-    // Get the current match
-    const match = window.dashai_semantic_matches[currentIndex];
-    
-    // Update highlight styles
-    for (let i = 0; i < window.dashai_semantic_matches.length; i++) {
-      const m = window.dashai_semantic_matches[i];
-      if (i === currentIndex) {
-        m.element.style.backgroundColor = 'rgba(255, 165, 0, 0.5)';
-        m.element.style.outline = '2px solid orange';
-      } else {
-        m.element.style.backgroundColor = 'rgba(255, 255, 0, 0.3)';
-        m.element.style.outline = 'none';
+
+    // Step to the next match that was found on the page
+    const step = direction === 'next' ? 1 : count - 1;
+    let index = state.current;
+    if (index < 0) {
+      index = direction === 'next' ? count - 1 : 0;
+    }
+    do {
+      index = (index + step) % count;
+    } while (!highlights[index]);
+
+    if (state.current >= 0 && highlights[state.current]) {
+      for (const span of highlights[state.current]) {
+        span.classList.remove('dashai-semantic-current');
       }
     }
-    
-    // Scroll to the match
-    match.element.scrollIntoView({
+    for (const span of highlights[index]) {
+      span.classList.add('dashai-semantic-current');
+    }
+    state.current = index;
+
+    highlights[index][0].scrollIntoView({
       behavior: 'smooth',
       block: 'center'
     });
-    
-    return currentIndex;
-  })(arguments[0]);
+
+    return index;
+  })($DIRECTION);
 )";
 
 // JavaScript for clearing highlights
 constexpr char kClearHighlightsScript[] = R"(
   (function() {
-    // Remove existing highlights
-    const existingHighlights = document.querySelectorAll('.dashai-semantic-highlight');
-    for (let i = 0; i < existingHighlights.length; i++) {
-      const highlight = existingHighlights[i];
-      const parent = highlight.parentNode;
-      parent.replaceChild(document.createTextNode(highlight.textContent), highlight);
-      parent.normalize();
+    $HIGHLIGHT_STATE
+    const state = window.dashai_semantic_search;
+    if (state) {
+      dashaiRemoveHighlights(state);
     }
-    
-    // Clear the global variables
-    window.dashai_semantic_matches = null;
-    window.dashai_current_match_index = -1;
-    
     return true;
   })();
 )";
 
+// |script| with the shared highlight state functions in place
+std::string WithHighlightState(const char* script) {
+  std::string result = script;
+  base::ReplaceSubstringsAfterOffset(&result, 0, "$HIGHLIGHT_STATE",
+                                     kHighlightStateScript);
+  return result;
+}
+
 }  // namespace
 
 SemanticSearch::SemanticSearch() = default;
@@ -250,10 +321,18 @@ bool SemanticSearch::Initialize(
 
   ai_service_manager_ = ai_service_manager;
   content_understanding_ = content_understanding;
+  if (!snapshot_service_) {
+    snapshot_service_ = base::MakeRefCounted<content::PageSnapshotService>();
+  }
   
   return true;
 }
 
+void SemanticSearch::SetPageSnapshotService(
+    scoped_refptr<content::PageSnapshotService> snapshot_service) {
+  snapshot_service_ = std::move(snapshot_service);
+}
+
 void SemanticSearch::Search(
     WebContents* web_contents,
     const std::string& query,
@@ -274,77 +353,262 @@ void SemanticSearch::Search(
           SearchResultCallback callback,
           const std::string& page_content) {
         // Perform semantic search
-        self->PerformSemanticSearch(page_content, query, std::move(callback));
+        self->PerformSemanticSearch(page_content, query,
+                                    /*cancellation_token=*/nullptr,
+                                    std::move(callback));
       }, this, query, std::move(callback)));
 }
 
+void SemanticSearch::SearchProgressive(
+    WebContents* web_contents,
+    const std::string& query,
+    SearchProgressCallback callback) {
+  CancelProgressiveSearch();
+  uint64_t generation = search_generation_;
+  if (!is_enabled_ || !web_contents) {
+    SearchResult empty_result;
+    empty_result.success = false;
+    empty_result.error_message = "Semantic search is disabled or web contents is null";
+    callback.Run(empty_result, /*is_final=*/true);
+    return;
+  }
+
+  if (page_index_ && indexed_web_contents_ == web_contents) {
+    RunLexicalSearch(generation, query, std::move(callback));
+    return;
+  }
+  ExtractPageContent(
+      web_contents,
+      base::BindOnce(&SemanticSearch::OnProgressivePageExtracted,
+                     weak_ptr_factory_.GetWeakPtr(), web_contents, generation,
+                     query, std::move(callback)));
+}
+
+void SemanticSearch::CancelProgressiveSearch() {
+  ++search_generation_;
+  if (semantic_cancellation_token_) {
+    semantic_cancellation_token_->Cancel();
+    semantic_cancellation_token_ = nullptr;
+  }
+}
+
+void SemanticSearch::OnProgressivePageExtracted(
+    WebContents* web_contents,
+    uint64_t generation,
+    const std::string& query,
+    SearchProgressCallback callback,
+    const std::string& page_content) {
+  // Index the page even for a stale query; the next one will use it
+  indexed_page_content_ = page_content;
+  page_index_ = std::make_unique<LexicalPageIndex>(page_content);
+  indexed_web_contents_ = web_contents;
+  if (generation != search_generation_) {
+    return;
+  }
+  RunLexicalSearch(generation, query, std::move(callback));
+}
+
+void SemanticSearch::RunLexicalSearch(uint64_t generation,
+                                      const std::string& query,
+                                      SearchProgressCallback callback) {
+  SearchResult result;
+  result.success = true;
+  for (LexicalPageIndex::Match& match :
+       page_index_->Find(query, kMaxLexicalMatches)) {
+    SearchMatch search_match;
+    search_match.text =
+        match.element_text.substr(match.start, match.end - match.start);
+    search_match.context = std::move(match.element_text);
+    search_match.relevance_score = match.score;
+    search_match.selector = std::move(match.selector);
+    search_match.start_offset = static_cast<int>(match.start);
+    search_match.end_offset = static_cast<int>(match.end);
+    search_match.match_reason = match.exact ? "exact" : "fuzzy";
+    result.matches.push_back(std::move(search_match));
+  }
+  current_matches_ = result.matches;
+  current_match_index_ = -1;
+  callback.Run(result, /*is_final=*/false);
+
+  // Ask the AI only once typing pauses on this query
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&SemanticSearch::StartProgressiveSemanticSearch,
+                     weak_ptr_factory_.GetWeakPtr(), generation, query,
+                     std::move(result.matches), std::move(callback)),
+      kSemanticSearchDelay);
+}
+
+void SemanticSearch::StartProgressiveSemanticSearch(
+    uint64_t generation,
+    const std::string& query,
+    std::vector<SearchMatch> lexical_matches,
+    SearchProgressCallback callback) {
+  if (generation != search_generation_) {
+    return;
+  }
+  semantic_cancellation_token_ =
+      base::MakeRefCounted<asol::core::CancellationToken>();
+  PerformSemanticSearch(
+      indexed_page_content_, query, semantic_cancellation_token_,
+      base::BindOnce(&SemanticSearch::OnProgressiveSemanticResult,
+                     weak_ptr_factory_.GetWeakPtr(), generation,
+                     std::move(lexical_matches), std::move(callback)));
+}
+
+void SemanticSearch::OnProgressiveSemanticResult(
+    uint64_t generation,
+    std::vector<SearchMatch> lexical_matches,
+    SearchProgressCallback callback,
+    const SearchResult& result) {
+  if (generation != search_generation_) {
+    return;
+  }
+  semantic_cancellation_token_ = nullptr;
+
+  // Lexical matches first, then semantic ones not already among them
+  SearchResult merged = result;
+  merged.success = true;
+  merged.matches = std::move(lexical_matches);
+  std::set<std::pair<std::string, std::string>> seen;
+  for (const SearchMatch& match : merged.matches) {
+    seen.emplace(match.selector, match.text);
+  }
+  for (const SearchMatch& match : result.matches) {
+    if (seen.emplace(match.selector, match.text).second) {
+      merged.matches.push_back(match);
+    }
+  }
+
+  current_matches_ = merged.matches;
+  current_match_index_ = -1;
+  callback.Run(merged, /*is_final=*/true);
+}
+
 void SemanticSearch::ExtractPageContent(
     WebContents* web_contents,
     base::OnceCallback<void(const std::string&)> callback) {
-  // Execute JavaScript to extract page content
-  web_contents->ExecuteJavaScript(
-      kExtractPageContentScript,
-      base::BindOnce([](
-          base::OnceCallback<void(const std::string&)> callback,
-          const WebContents::JavaScriptResult& result) {
-        if (!result.success) {
-          std::move(callback).Run("{}");
-          return;
-        }
-        
-        std::move(callback).Run(result.result);
-      }, std::move(callback)));
+  // The page's text elements, from the snapshot other features share
+  snapshot_service_->GetSnapshot(
+      web_contents,
+      base::BindOnce(
+          [](base::OnceCallback<void(const std::string&)> callback,
+             scoped_refptr<const content::PageSnapshot> snapshot) {
+            std::move(callback).Run(snapshot->structure);
+          },
+          std::move(callback)));
 }
 
 void SemanticSearch::PerformSemanticSearch(
     const std::string& page_content,
     const std::string& query,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
     SearchResultCallback callback) {
+  if (!chunk_ranker_) {
+    RequestSearch(page_content, query, std::move(cancellation_token),
+                  std::move(callback));
+    return;
+  }
+  std::vector<PageChunkRanker::Chunk> chunks =
+      PageChunkRanker::SplitPage(page_content);
+  if (chunks.size() <= kMaxPreRankedChunks) {
+    RequestSearch(page_content, query, std::move(cancellation_token),
+                  std::move(callback));
+    return;
+  }
+  chunk_ranker_->Rank(
+      query, std::move(chunks), kMaxPreRankedChunks,
+      base::BindOnce(&SemanticSearch::OnChunksRanked,
+                     weak_ptr_factory_.GetWeakPtr(), page_content, query,
+                     std::move(cancellation_token), std::move(callback)));
+}
+
+void SemanticSearch::OnChunksRanked(
+    const std::string& page_content,
+    const std::string& query,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    SearchResultCallback callback,
+    std::vector<PageChunkRanker::Chunk> chunks) {
+  if (chunks.empty()) {
+    // Ranking failed; fall back to the page truncated
+    RequestSearch(page_content, query, std::move(cancellation_token),
+                  std::move(callback));
+    return;
+  }
+  std::string page_text;
+  for (const PageChunkRanker::Chunk& chunk : chunks) {
+    if (!page_text.empty()) {
+      page_text += "\n...\n";
+    }
+    page_text += chunk.excerpt;
+  }
+  RequestSearch(page_text, query, std::move(cancellation_token),
+                std::move(callback));
+}
+
+void SemanticSearch::RequestSearch(
+    const std::string& page_text,
+    const std::string& query,
+    scoped_refptr<asol::core::CancellationToken> cancellation_token,
+    SearchResultCallback callback) {
+  if (cancellation_token && cancellation_token->IsCancelled()) {
+    OnSearchResponse(std::move(callback), false,
+                     asol::core::kRequestCancelledError);
+    return;
+  }
+
   // Generate AI prompt for semantic search
-  std::string prompt = GenerateSearchPrompt(page_content, query);
-  
+  asol::core::AIServiceManager::AIRequestParams params;
+  params.task_type = asol::core::AIServiceManager::TaskType::TEXT_GENERATION;
+  size_t prefix_length = 0;
+  params.input_text = GenerateSearchPrompt(page_text, query, &prefix_length);
+  params.custom_params[asol::core::kPromptPrefixLengthParam] =
+      base::NumberToString(prefix_length);
+  params.cancellation_token = std::move(cancellation_token);
+
   // Request AI analysis
-  ai_service_manager_->GetTextAdapter()->GenerateText(
-      prompt,
-      base::BindOnce([](
-          SemanticSearch* self,
-          SearchResultCallback callback,
-          const asol::core::TextAdapter::GenerateTextResult& result) {
-        if (!result.success) {
-          SearchResult error_result;
-          error_result.success = false;
-          error_result.error_message = "Failed to generate AI analysis: " + result.error_message;
-          std::move(callback).Run(error_result);
-          return;
-        }
-        
-        // Parse AI response
-        SearchResult search_result = self->ParseSearchResponse(result.text);
-        
-        // Store current matches
-        self->current_matches_ = search_result.matches;
-        self->current_match_index_ = -1;
-        
-        std::move(callback).Run(search_result);
-      }, this, std::move(callback)));
+  ai_service_manager_->ProcessRequest(
+      params, base::BindOnce(&SemanticSearch::OnSearchResponse,
+                             weak_ptr_factory_.GetWeakPtr(),
+                             std::move(callback)));
+}
+
+void SemanticSearch::OnSearchResponse(SearchResultCallback callback,
+                                      bool success,
+                                      const std::string& response) {
+  if (!success) {
+    SearchResult error_result;
+    error_result.success = false;
+    error_result.error_message = "Failed to generate AI analysis: " + response;
+    std::move(callback).Run(error_result);
+    return;
+  }
+
+  // Parse AI response
+  SearchResult search_result = ParseSearchResponse(response);
+
+  // Store current matches
+  current_matches_ = search_result.matches;
+  current_match_index_ = -1;
+
+  std::move(callback).Run(search_result);
 }
 
 std::string SemanticSearch::GenerateSearchPrompt(
     const std::string& page_content,
-    const std::string& query) {
-  std::string prompt = kSemanticSearchPrompt;
-  
-  // Format query
-  base::ReplaceSubstringsAfterOffset(&prompt, 0, "{query}", query);
-  
-  // Format page content (truncate if too long)
-  std::string truncated_content = page_content;
-  if (truncated_content.length() > 10000) {
-    truncated_content = truncated_content.substr(0, 10000) + "... [content truncated]";
+    const std::string& query,
+    size_t* prefix_length) {
+  // Truncate long pages, without copying them first
+  std::string_view content = page_content;
+  std::string_view truncation_note;
+  if (content.size() > kMaxSearchContentLength) {
+    content = content.substr(0, kMaxSearchContentLength);
+    truncation_note = "... [content truncated]";
   }
-  base::ReplaceSubstringsAfterOffset(&prompt, 0, "{page_content}", truncated_content);
-  
-  return prompt;
+  return kSemanticSearchPrompt.Render({{"page_content", content},
+                                       {"truncation_note", truncation_note},
+                                       {"query", query}},
+                                      prefix_length);
 }
 
 SemanticSearch::SearchResult SemanticSearch::ParseSearchResponse(
@@ -420,7 +684,7 @@ void SemanticSearch::HighlightMatches(
   
   // Execute JavaScript to highlight matches
   web_contents->ExecuteJavaScript(
-      GetHighlightMatchesScript(),
+      GetHighlightMatchesScript(matches_list),
       base::BindOnce([](
           SemanticSearch* self,
           const WebContents::JavaScriptResult& result) {
@@ -432,31 +696,22 @@ void SemanticSearch::HighlightMatches(
 }
 
 void SemanticSearch::NavigateToNextMatch(WebContents* web_contents) {
-  if (!is_enabled_ || !web_contents || current_matches_.empty()) {
-    return;
-  }
-  
-  // Execute JavaScript to navigate to next match
-  web_contents->ExecuteJavaScript(
-      GetNavigateMatchesScript(),
-      base::BindOnce([](
-          SemanticSearch* self,
-          const WebContents::JavaScriptResult& result) {
-        if (result.success) {
-          // Update current match index
-          self->current_match_index_ = std::stoi(result.result);
-        }
-      }, this));
+  NavigateMatches(web_contents, "next");
 }
 
 void SemanticSearch::NavigateToPreviousMatch(WebContents* web_contents) {
+  NavigateMatches(web_contents, "previous");
+}
+
+void SemanticSearch::NavigateMatches(WebContents* web_contents,
+                                     const char* direction) {
   if (!is_enabled_ || !web_contents || current_matches_.empty()) {
     return;
   }
   
-  // Execute JavaScript to navigate to previous match
+  // Execute JavaScript to navigate to the match
   web_contents->ExecuteJavaScript(
-      GetNavigateMatchesScript(),
+      GetNavigateMatchesScript(direction),
       base::BindOnce([](
           SemanticSearch* self,
           const WebContents::JavaScriptResult& result) {
@@ -471,6 +726,12 @@ void SemanticSearch::ClearHighlights(WebContents* web_contents) {
   if (!web_contents) {
     return;
   }
+
+  // The find session is over; index the page afresh for the next one
+  CancelProgressiveSearch();
+  page_index_.reset();
+  indexed_page_content_.clear();
+  indexed_web_contents_ = nullptr;
   
   // Execute JavaScript to clear highlights
   web_contents->ExecuteJavaScript(
@@ -494,16 +755,31 @@ bool SemanticSearch::IsEnabled() const {
   return is_enabled_;
 }
 
-const char* SemanticSearch::GetHighlightMatchesScript() {
-  return kHighlightMatchesScript;
+void SemanticSearch::EnableLocalPreRanking(
+    asol::core::LocalAIProcessor* processor) {
+  chunk_ranker_ = processor ? std::make_unique<PageChunkRanker>(processor)
+                            : nullptr;
+}
+
+std::string SemanticSearch::GetHighlightMatchesScript(
+    const base::Value::List& matches) {
+  std::string matches_json;
+  base::JSONWriter::Write(matches, &matches_json);
+  std::string script = WithHighlightState(kHighlightMatchesScript);
+  base::ReplaceSubstringsAfterOffset(&script, 0, "$MATCHES", matches_json);
+  return script;
 }
 
-const char* SemanticSearch::GetNavigateMatchesScript() {
-  return kNavigateMatchesScript;
+std::string SemanticSearch::GetNavigateMatchesScript(const char* direction) {
+  std::string direction_json;
+  base::JSONWriter::Write(base::Value(direction), &direction_json);
+  std::string script = WithHighlightState(kNavigateMatchesScript);
+  base::ReplaceSubstringsAfterOffset(&script, 0, "$DIRECTION", direction_json);
+  return script;
 }
 
-const char* SemanticSearch::GetClearHighlightsScript() {
-  return kClearHighlightsScript;
+std::string SemanticSearch::GetClearHighlightsScript() {
+  return WithHighlightState(kClearHighlightsScript);
 }
 
 base::WeakPtr<SemanticSearch> SemanticSearch::GetWeakPtr() {
@@ -5,15 +5,23 @@
 #ifndef BROWSER_CORE_UI_SEMANTIC_SEARCH_H_
 #define BROWSER_CORE_UI_SEMANTIC_SEARCH_H_
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "asol/core/cancellation_token.h"
 #include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/values.h"
 #include "browser_core/engine/web_contents.h"
 #include "asol/core/ai_service_manager.h"
 #include "browser_core/ai/content_understanding.h"
+#include "browser_core/content/page_snapshot_service.h"
+#include "browser_core/ui/lexical_page_index.h"
+#include "browser_core/ui/page_chunk_ranker.h"
 
 namespace browser_core {
 namespace ui {
@@ -47,6 +55,11 @@ class SemanticSearch {
   using SearchResultCallback = 
       base::OnceCallback<void(const SearchResult&)>;
 
+  // Callback for progressive search results; runs with the lexical result,
+  // then with the final, merged one
+  using SearchProgressCallback =
+      base::RepeatingCallback<void(const SearchResult& result, bool is_final)>;
+
   SemanticSearch();
   ~SemanticSearch();
 
@@ -58,11 +71,28 @@ class SemanticSearch {
   bool Initialize(asol::core::AIServiceManager* ai_service_manager,
                 ai::ContentUnderstanding* content_understanding);
 
+  // Read pages through |snapshot_service|, shared with the other features
+  // that read them, so a page is extracted once. Call before Initialize(),
+  // which otherwise creates a service of its own.
+  void SetPageSnapshotService(
+      scoped_refptr<content::PageSnapshotService> snapshot_service);
+
   // Search for content semantically
   void Search(WebContents* web_contents,
             const std::string& query,
             SearchResultCallback callback);
 
+  // Search as the user types. Exact and fuzzy lexical matches from a local
+  // index of the page are reported at once; semantic matches follow,
+  // merged after them, once typing pauses. A new query, or
+  // CancelProgressiveSearch(), cancels the previous query's semantic
+  // request and drops its results. The page is extracted and indexed on
+  // the first query, and again after ClearHighlights().
+  void SearchProgressive(WebContents* web_contents,
+                         const std::string& query,
+                         SearchProgressCallback callback);
+  void CancelProgressiveSearch();
+
   // Highlight matches in the page
   void HighlightMatches(WebContents* web_contents,
                       const std::vector<SearchMatch>& matches);
@@ -78,6 +108,11 @@ class SemanticSearch {
   void Enable(bool enable);
   bool IsEnabled() const;
 
+  // Rank a long page's chunks against the query with |processor|'s
+  // embedding model and send the AI only the nearest ones, instead of the
+  // page truncated. |processor| must outlive this.
+  void EnableLocalPreRanking(asol::core::LocalAIProcessor* processor);
+
   // Get a weak pointer to this instance
   base::WeakPtr<SemanticSearch> GetWeakPtr();
 
@@ -86,33 +121,86 @@ class SemanticSearch {
   void ExtractPageContent(WebContents* web_contents,
                         base::OnceCallback<void(const std::string&)> callback);
 
-  void PerformSemanticSearch(const std::string& page_content,
-                           const std::string& query,
-                           SearchResultCallback callback);
-
+  void PerformSemanticSearch(
+      const std::string& page_content,
+      const std::string& query,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      SearchResultCallback callback);
+
+  void OnChunksRanked(
+      const std::string& page_content,
+      const std::string& query,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      SearchResultCallback callback,
+      std::vector<PageChunkRanker::Chunk> chunks);
+  // Search |page_text|, the whole page or its nearest chunks, with the AI
+  void RequestSearch(
+      const std::string& page_text,
+      const std::string& query,
+      scoped_refptr<asol::core::CancellationToken> cancellation_token,
+      SearchResultCallback callback);
+  void OnSearchResponse(SearchResultCallback callback,
+                        bool success,
+                        const std::string& response);
+
+  // Progressive search steps; each drops out if |generation| is stale
+  void OnProgressivePageExtracted(WebContents* web_contents,
+                                  uint64_t generation,
+                                  const std::string& query,
+                                  SearchProgressCallback callback,
+                                  const std::string& page_content);
+  void RunLexicalSearch(uint64_t generation,
+                        const std::string& query,
+                        SearchProgressCallback callback);
+  void StartProgressiveSemanticSearch(uint64_t generation,
+                                      const std::string& query,
+                                      std::vector<SearchMatch> lexical_matches,
+                                      SearchProgressCallback callback);
+  void OnProgressiveSemanticResult(uint64_t generation,
+                                   std::vector<SearchMatch> lexical_matches,
+                                   SearchProgressCallback callback,
+                                   const SearchResult& result);
+
+  // The prompt for |query| over |page_content|. |prefix_length| receives
+  // the length of the part repeated searches of the page share.
   std::string GenerateSearchPrompt(const std::string& page_content,
-                                 const std::string& query);
+                                   const std::string& query,
+                                   size_t* prefix_length);
 
   SearchResult ParseSearchResponse(const std::string& response);
 
-  // JavaScript for highlighting matches
-  static const char* GetHighlightMatchesScript();
+  // Step the current match "next" or "previous"
+  void NavigateMatches(WebContents* web_contents, const char* direction);
 
-  // JavaScript for navigating matches
-  static const char* GetNavigateMatchesScript();
+  // JavaScript for highlighting |matches|
+  static std::string GetHighlightMatchesScript(
+      const base::Value::List& matches);
+
+  // JavaScript for navigating matches in |direction|
+  static std::string GetNavigateMatchesScript(const char* direction);
 
   // JavaScript for clearing highlights
-  static const char* GetClearHighlightsScript();
+  static std::string GetClearHighlightsScript();
 
   // Components
   asol::core::AIServiceManager* ai_service_manager_ = nullptr;
   ai::ContentUnderstanding* content_understanding_ = nullptr;
+  std::unique_ptr<PageChunkRanker> chunk_ranker_;
+  scoped_refptr<content::PageSnapshotService> snapshot_service_;
 
   // State
   bool is_enabled_ = true;
   int current_match_index_ = -1;
   std::vector<SearchMatch> current_matches_;
 
+  // Progressive search: the indexed page, the tab it came from, compared
+  // only, and the latest query's generation and semantic request
+  std::string indexed_page_content_;
+  std::unique_ptr<LexicalPageIndex> page_index_;
+  const WebContents* indexed_web_contents_ = nullptr;
+  uint64_t search_generation_ = 0;
+  scoped_refptr<asol::core::CancellationToken> semantic_cancellation_token_;
+
   // For weak pointers
   base::WeakPtrFactory<SemanticSearch> weak_ptr_factory_{this};
 };
@@ -34,6 +34,7 @@ class SummarizationUI {
     INACTIVE,     // Feature not available
     AVAILABLE,    // Feature available but not active
     LOADING,      // Summary is being generated
+    STREAMING,    // Summary is shown as it is generated
     ACTIVE,       // Summary is displayed
     ERROR         // Error occurred
   };
@@ -77,6 +78,11 @@ class SummarizationUI {
   // Set the summary length
   void SetSummaryLength(ai::SummarizationService::SummaryLength length);
 
+  // Show the next piece of a summary being streamed for the current
+  // content. The first piece moves the UI from LOADING to STREAMING.
+  void AppendSummaryDelta(
+      const ai::SummarizationService::SummaryDelta& delta);
+
   // Set callback for UI events
   void SetEventCallback(UIEventCallback callback);
 
@@ -144,6 +150,10 @@ class SummarizationUI {
     // Update the sidebar content
     void UpdateContent(const ai::SummarizationService::SummaryResult& result);
 
+    // Append the next piece of a streamed summary, without reloading what
+    // is already shown
+    void AppendContent(const ai::SummarizationService::SummaryDelta& delta);
+
     // Set the sidebar state
     void SetState(UIState state);
 
@@ -160,6 +170,11 @@ class SummarizationUI {
     std::string GenerateSidebarHTML(
         const ai::SummarizationService::SummaryResult& result);
 
+    // Generate the script that appends |delta| to the shown summary and
+    // turns the sentences it links into source links
+    std::string GenerateAppendScript(
+        const ai::SummarizationService::SummaryDelta& delta);
+
     // Handle web view events
     void OnWebViewLoadCompleted();
     void OnLinkClicked(const std::string& url);
@@ -174,6 +189,9 @@ class SummarizationUI {
 
     // Current state
     UIState state_ = UIState::INACTIVE;
+
+    // Summary text shown so far while streaming
+    std::string streamed_text_;
   };
 
   // Handle summarization result
@@ -182,7 +200,7 @@ class SummarizationUI {
   // Handle Synapse button click
   void OnSynapseButtonClicked();
 
-  // Trigger summarization
+  // Trigger summarization; the summary is streamed into the sidebar
   void TriggerSummarization();
 
   // Components
@@ -245,6 +263,7 @@ class SummarizationUI {
     INACTIVE,     // Feature not available
     AVAILABLE,    // Feature available but not active
     LOADING,      // Summary is being generated
+    STREAMING,    // Summary is shown as it is generated
     ACTIVE,       // Summary is displayed
     ERROR         // Error occurred
   };
@@ -288,6 +307,11 @@ class SummarizationUI {
   // Set the summary length
   void SetSummaryLength(ai::SummarizationService::SummaryLength length);
 
+  // Show the next piece of a summary being streamed for the current
+  // content. The first piece moves the UI from LOADING to STREAMING.
+  void AppendSummaryDelta(
+      const ai::SummarizationService::SummaryDelta& delta);
+
   // Set callback for UI events
   void SetEventCallback(UIEventCallback callback);
 
@@ -355,6 +379,10 @@ class SummarizationUI {
     // Update the sidebar content
     void UpdateContent(const ai::SummarizationService::SummaryResult& result);
 
+    // Append the next piece of a streamed summary, without reloading what
+    // is already shown
+    void AppendContent(const ai::SummarizationService::SummaryDelta& delta);
+
     // Set the sidebar state
     void SetState(UIState state);
 
@@ -371,6 +399,11 @@ class SummarizationUI {
     std::string GenerateSidebarHTML(
         const ai::SummarizationService::SummaryResult& result);
 
+    // Generate the script that appends |delta| to the shown summary and
+    // turns the sentences it links into source links
+    std::string GenerateAppendScript(
+        const ai::SummarizationService::SummaryDelta& delta);
+
     // Handle web view events
     void OnWebViewLoadCompleted();
     void OnLinkClicked(const std::string& url);
@@ -385,6 +418,9 @@ class SummarizationUI {
 
     // Current state
     UIState state_ = UIState::INACTIVE;
+
+    // Summary text shown so far while streaming
+    std::string streamed_text_;
   };
 
   // Handle summarization result
@@ -393,7 +429,7 @@ class SummarizationUI {
   // Handle Synapse button click
   void OnSynapseButtonClicked();
 
-  // Trigger summarization
+  // Trigger summarization; the summary is streamed into the sidebar
   void TriggerSummarization();
 
   // Components
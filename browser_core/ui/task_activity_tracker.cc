@@ -0,0 +1,169 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "browser_core/ui/task_activity_tracker.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/strings/string_util.h"
+
+namespace browser_core {
+namespace ui {
+
+namespace {
+
+// Signals lighter than this are forgotten
+constexpr double kPruneWeight = 0.05;
+
+bool Contains(const std::vector<asol::core::Symbol>& symbols,
+              asol::core::Symbol symbol) {
+  return std::find(symbols.begin(), symbols.end(), symbol) != symbols.end();
+}
+
+// Erase the entries of |signals| for which |is_spent| holds
+template <typename Map, typename Predicate>
+void EraseSignals(Map* signals, Predicate is_spent) {
+  for (auto it = signals->begin(); it != signals->end();) {
+    if (is_spent(it->second)) {
+      it = signals->erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace
+
+TaskActivityTracker::TaskActivityTracker(const Options& options)
+    : options_(options) {}
+
+TaskActivityTracker::~TaskActivityTracker() = default;
+
+TaskActivityTracker::Update TaskActivityTracker::AddVisit(
+    const Visit& visit,
+    const std::vector<Task>& tasks) {
+  Update update;
+  base::TimeDelta dwell =
+      std::clamp(visit.dwell, base::TimeDelta(), options_.max_dwell);
+  double weight = 1.0 + dwell / options_.dwell_unit;
+
+  std::vector<asol::core::Symbol> topics;
+  for (asol::core::Symbol topic : visit.topics) {
+    if (!topic.empty() && !Contains(topics, topic)) {
+      topics.push_back(topic);
+    }
+  }
+
+  // Move task confidence toward the tasks this page is part of
+  bool on_task = false;
+  update.confidences.reserve(tasks.size());
+  for (const Task& task : tasks) {
+    size_t shared = 0;
+    for (asol::core::Symbol topic : topics) {
+      shared += Contains(task.topics, topic);
+    }
+    float confidence = task.confidence;
+    if (shared == 0) {
+      confidence *= static_cast<float>(GetDecay(dwell));
+      update.confidences.push_back(confidence);
+      continue;
+    }
+
+    on_task = true;
+    confidence += (1.0f - confidence) *
+                  std::min(1.0f, options_.confidence_gain *
+                                     static_cast<float>(weight));
+    update.confidences.push_back(confidence);
+
+    // Topics the task does not have yet hint its focus has moved
+    size_t added = topics.size() - shared;
+    if (added > 0 &&
+        AddWeight(&task_drift_[task.id],
+                  weight * static_cast<double>(added) /
+                      static_cast<double>(topics.size()),
+                  visit.time, options_.shift_weight)) {
+      update.needs_detection = true;
+    }
+  }
+
+  // Topics no task covers may make a new one
+  for (asol::core::Symbol topic : topics) {
+    bool covered = std::any_of(tasks.begin(), tasks.end(),
+                               [topic](const Task& task) {
+                                 return Contains(task.topics, topic);
+                               });
+    if (!covered && AddWeight(&topic_signals_[topic], weight, visit.time,
+                              options_.candidate_weight)) {
+      update.needs_detection = true;
+    }
+  }
+
+  // So may time spent on one site outside any task, whatever its topics
+  std::string_view site = GetSite(visit.url);
+  if (!on_task && !site.empty() &&
+      AddWeight(&site_signals_[std::string(site)], weight, visit.time,
+                options_.candidate_weight)) {
+    update.needs_detection = true;
+  }
+
+  Prune(visit.time);
+  return update;
+}
+
+void TaskActivityTracker::RemoveTask(const std::string& id) {
+  task_drift_.erase(id);
+}
+
+// static
+std::string_view TaskActivityTracker::GetSite(std::string_view url) {
+  size_t scheme_end = url.find("://");
+  if (scheme_end == std::string_view::npos) {
+    return std::string_view();
+  }
+  std::string_view host = url.substr(scheme_end + 3);
+  host = host.substr(0, host.find_first_of("/:?#"));
+  if (base::StartsWith(host, "www.")) {
+    host.remove_prefix(4);
+  }
+  return host;
+}
+
+bool TaskActivityTracker::AddWeight(Signal* signal,
+                                    double weight,
+                                    base::Time time,
+                                    double threshold) const {
+  if (!signal->updated.is_null()) {
+    signal->weight *= GetDecay(time - signal->updated);
+  }
+  signal->updated = time;
+  if (signal->weight < threshold / 2) {
+    signal->reported = false;
+  }
+  signal->weight += weight;
+  if (signal->reported || signal->weight < threshold) {
+    return false;
+  }
+  signal->reported = true;
+  return true;
+}
+
+void TaskActivityTracker::Prune(base::Time now) {
+  auto is_spent = [this, now](const Signal& signal) {
+    return signal.weight * GetDecay(now - signal.updated) < kPruneWeight;
+  };
+  EraseSignals(&topic_signals_, is_spent);
+  EraseSignals(&site_signals_, is_spent);
+  EraseSignals(&task_drift_, is_spent);
+}
+
+double TaskActivityTracker::GetDecay(base::TimeDelta elapsed) const {
+  if (!elapsed.is_positive()) {
+    return 1.0;
+  }
+  return std::exp2(-(elapsed / options_.half_life));
+}
+
+}  // namespace ui
+}  // namespace browser_core
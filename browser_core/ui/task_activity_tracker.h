@@ -0,0 +1,128 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BROWSER_CORE_UI_TASK_ACTIVITY_TRACKER_H_
+#define BROWSER_CORE_UI_TASK_ACTIVITY_TRACKER_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "asol/core/symbol_table.h"
+#include "base/time/time.h"
+
+namespace browser_core {
+namespace ui {
+
+// TaskActivityTracker keeps the user-task picture current from one page
+// visit to the next without asking the AI, and says when asking is worth
+// it.
+//
+// Each visit, weighted by its dwell time, adds to a decaying weight per
+// topic and per site. Tasks whose topics the page shares gain confidence;
+// the others lose it as time passes off-task. Detection is needed when a
+// topic or site not covered by any task gathers enough weight to be a new
+// task candidate, or when pages of a task keep bringing topics the task
+// does not have, meaning its topic set has shifted.
+//
+// Topics are compared folded, so callers pass Symbol::Folded() forms.
+class TaskActivityTracker {
+ public:
+  struct Options {
+    // Weights halve every |half_life|; so does the confidence of tasks
+    // the user is not working on
+    base::TimeDelta half_life = base::Minutes(20);
+
+    // A visit weighs 1 plus its dwell in |dwell_unit|s, up to |max_dwell|
+    // so a tab left open does not count as work
+    base::TimeDelta dwell_unit = base::Minutes(1);
+    base::TimeDelta max_dwell = base::Minutes(10);
+
+    // Weight an uncovered topic or site needs to be a task candidate
+    double candidate_weight = 4.0;
+
+    // Weight of new topics on a task's pages that marks a topic shift
+    double shift_weight = 3.0;
+
+    // Share of the missing confidence one unit of visit weight adds
+    float confidence_gain = 0.1f;
+  };
+
+  // A page the user has left
+  struct Visit {
+    std::string url;
+    std::vector<asol::core::Symbol> topics;
+    base::TimeDelta dwell;
+    // When the user left it
+    base::Time time;
+  };
+
+  // What the tracker needs of an active task
+  struct Task {
+    std::string id;
+    std::vector<asol::core::Symbol> topics;
+    float confidence = 0.0f;
+  };
+
+  struct Update {
+    // New confidence of each task passed in, in order
+    std::vector<float> confidences;
+    // Whether the task picture needs a detection run
+    bool needs_detection = false;
+  };
+
+  explicit TaskActivityTracker(const Options& options);
+  ~TaskActivityTracker();
+
+  TaskActivityTracker(const TaskActivityTracker&) = delete;
+  TaskActivityTracker& operator=(const TaskActivityTracker&) = delete;
+
+  // Apply |visit| to the topic weights and to |tasks|
+  Update AddVisit(const Visit& visit, const std::vector<Task>& tasks);
+
+  // Drop what is kept about task |id|, e.g. once completed
+  void RemoveTask(const std::string& id);
+
+  // Host of |url| without "www.", or empty
+  static std::string_view GetSite(std::string_view url);
+
+ private:
+  struct Signal {
+    double weight = 0.0;
+    base::Time updated;
+    // Already reported as a candidate; rearmed once the weight has decayed
+    // below half the threshold
+    bool reported = false;
+  };
+
+  // Bring |signal| to |time| and add |weight|. Returns true if that takes
+  // it to |threshold| and it was not reported yet.
+  bool AddWeight(Signal* signal,
+                 double weight,
+                 base::Time time,
+                 double threshold) const;
+
+  // Drop signals that have decayed to nothing
+  void Prune(base::Time now);
+
+  // Factor weights decay by over |elapsed|
+  double GetDecay(base::TimeDelta elapsed) const;
+
+  const Options options_;
+  std::unordered_map<asol::core::Symbol, Signal, asol::core::Symbol::Hash>
+      topic_signals_;
+  // Off-task visits by site; kept apart from topics as sites are not a
+  // bounded vocabulary to intern
+  std::unordered_map<std::string, Signal> site_signals_;
+  // Weight of topics new to each task, by task id
+  std::unordered_map<std::string, Signal> task_drift_;
+};
+
+}  // namespace ui
+}  // namespace browser_core
+
+#endif  // BROWSER_CORE_UI_TASK_ACTIVITY_TRACKER_H_
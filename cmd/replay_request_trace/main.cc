@@ -0,0 +1,298 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Replays a request trace, as written by asol::core::RequestTraceRecorder or
+// the gateway's --record-requests, against a MultiAdapterManager, so a
+// change to the cache, router or scheduler can be measured on the recorded
+// workload rather than a synthetic one:
+//
+//   replay_request_trace --trace=requests.jsonl [--speed=N]
+//       [--provider=mock|gemini] [--api-key=KEY] [--cache-entries=N]
+//       [--no-cache] [--mock-config=key=value,...]
+//
+// Requests are sent at their recorded offsets divided by --speed (default
+// 1; 0 sends them all at once). The trace keeps no text, so each prompt is
+// made up from its hash and padded to its recorded size: repeats of a
+// prompt stay repeats, and the cache sees the recorded reuse. By default
+// they are answered by a mock provider fitted to the trace's cache misses
+// (median and p99 latency, response sizes and error rate); --mock-config
+// overrides its MockProfile keys. The report compares the replay with the
+// recording.
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asol/adapters/gemini/gemini_service_provider.h"
+#include "asol/adapters/mock/mock_service_provider.h"
+#include "asol/core/multi_adapter_manager.h"
+#include "asol/core/request_trace_recorder.h"
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback.h"
+#include "base/logging.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/task/single_thread_task_executor.h"
+#include "base/task/single_thread_task_runner.h"
+#include "base/task/thread_pool/thread_pool_instance.h"
+#include "base/time/time.h"
+
+namespace {
+
+using asol::core::MultiAdapterManager;
+using asol::core::RequestTraceRecorder;
+
+// Outcomes of the replayed requests, collected as they complete
+struct ReplayResults {
+  size_t remaining = 0;
+  size_t hits = 0;
+  size_t failures = 0;
+  std::vector<base::TimeDelta> latencies;
+  std::map<std::string, size_t> per_provider;
+  base::OnceClosure quit;
+};
+
+// The |percentile|th of |sorted|, which must not be empty
+template <typename T>
+T Percentile(const std::vector<T>& sorted, double percentile) {
+  size_t index = static_cast<size_t>(percentile / 100.0 *
+                                     static_cast<double>(sorted.size() - 1));
+  return sorted[index];
+}
+
+// A prompt of |event|'s size that is the same for every event with its hash
+std::string SynthesizePrompt(const RequestTraceRecorder::Event& event) {
+  std::string prompt = event.prompt_hash;
+  if (prompt.size() < event.input_bytes) {
+    prompt.append(event.input_bytes - prompt.size(), '.');
+  }
+  return prompt;
+}
+
+// MockProfile keys for a provider that behaves like the trace's misses
+std::unordered_map<std::string, std::string> FitMockProfile(
+    const std::vector<RequestTraceRecorder::Event>& events) {
+  std::vector<base::TimeDelta> latencies;
+  std::vector<size_t> response_bytes;
+  size_t misses = 0;
+  size_t failures = 0;
+  for (const auto& event : events) {
+    if (event.cache_outcome != RequestTraceRecorder::CacheOutcome::MISS) {
+      continue;
+    }
+    ++misses;
+    if (!event.success) {
+      ++failures;
+      continue;
+    }
+    latencies.push_back(event.latency);
+    // Gateway traces leave sizes out
+    if (event.output_bytes > 0) {
+      response_bytes.push_back(event.output_bytes);
+    }
+  }
+
+  std::unordered_map<std::string, std::string> config;
+  if (!latencies.empty()) {
+    std::sort(latencies.begin(), latencies.end());
+    config["latency_distribution"] = "lognormal";
+    config["latency_ms"] =
+        base::NumberToString(Percentile(latencies, 50).InMilliseconds());
+    config["latency_p99_ms"] =
+        base::NumberToString(Percentile(latencies, 99).InMilliseconds());
+  }
+  if (!response_bytes.empty()) {
+    std::sort(response_bytes.begin(), response_bytes.end());
+    config["response_bytes_min"] =
+        base::NumberToString(Percentile(response_bytes, 5));
+    config["response_bytes_max"] =
+        base::NumberToString(Percentile(response_bytes, 95));
+  }
+  if (misses > 0) {
+    config["error_rate"] = base::NumberToString(
+        static_cast<double>(failures) / static_cast<double>(misses));
+  }
+  return config;
+}
+
+void OnReplayed(ReplayResults* results,
+                base::TimeTicks sent,
+                bool success,
+                const std::string& response,
+                const MultiAdapterManager::ResponseMetadata& metadata) {
+  results->latencies.push_back(base::TimeTicks::Now() - sent);
+  if (metadata.from_cache) {
+    ++results->hits;
+  }
+  if (!success) {
+    ++results->failures;
+  }
+  ++results->per_provider[metadata.provider_id.empty() ? "(none)"
+                                                       : metadata.provider_id];
+  if (--results->remaining == 0) {
+    std::move(results->quit).Run();
+  }
+}
+
+void SendRequest(MultiAdapterManager* manager,
+                 ReplayResults* results,
+                 const RequestTraceRecorder::Event& event) {
+  asol::core::AIServiceProvider::AIRequestParams params;
+  params.task_type = event.task_type;
+  params.input_text = SynthesizePrompt(event);
+  manager->ProcessRequestWithMetadata(
+      params,
+      base::BindOnce(&OnReplayed, results, base::TimeTicks::Now()));
+}
+
+void PrintReport(const std::vector<RequestTraceRecorder::Event>& events,
+                 ReplayResults* results) {
+  size_t recorded_hits = 0;
+  std::map<std::string, size_t> recorded_per_provider;
+  for (const auto& event : events) {
+    if (event.cache_outcome != RequestTraceRecorder::CacheOutcome::MISS) {
+      ++recorded_hits;
+    }
+    ++recorded_per_provider[event.provider_id.empty() ? "(none)"
+                                                      : event.provider_id];
+  }
+  std::sort(results->latencies.begin(), results->latencies.end());
+
+  auto share = [&events](size_t count) {
+    return 100.0 * static_cast<double>(count) /
+           static_cast<double>(events.size());
+  };
+  std::cout << base::StringPrintf(
+      "Requests:     %zu (%zu failed)\n"
+      "Hit rate:     %.1f%% replayed, %.1f%% recorded\n"
+      "Latency (ms): p50 %.1f, p95 %.1f, p99 %.1f\n",
+      events.size(), results->failures, share(results->hits),
+      share(recorded_hits),
+      Percentile(results->latencies, 50).InMillisecondsF(),
+      Percentile(results->latencies, 95).InMillisecondsF(),
+      Percentile(results->latencies, 99).InMillisecondsF());
+  std::map<std::string, std::pair<size_t, size_t>> per_provider;
+  for (const auto& [provider_id, count] : results->per_provider) {
+    per_provider[provider_id].first = count;
+  }
+  for (const auto& [provider_id, count] : recorded_per_provider) {
+    per_provider[provider_id].second = count;
+  }
+  std::cout << "Provider       replayed  recorded" << std::endl;
+  for (const auto& [provider_id, counts] : per_provider) {
+    std::cout << base::StringPrintf("  %-12s %8zu  %8zu\n", provider_id.c_str(),
+                                    counts.first, counts.second);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  base::CommandLine::Init(argc, argv);
+  base::AtExitManager at_exit_manager;
+  base::SingleThreadTaskExecutor main_task_executor;
+  // The manager's background work, e.g. revalidation, runs in the pool
+  base::ThreadPoolInstance::CreateAndStartWithDefaultParams(
+      "replay_request_trace");
+
+  base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
+  base::FilePath trace_path = command_line->GetSwitchValuePath("trace");
+  if (trace_path.empty()) {
+    std::cerr << "Error: A trace is required. Use --trace=PATH" << std::endl;
+    return 1;
+  }
+  std::vector<RequestTraceRecorder::Event> events =
+      RequestTraceRecorder::ReadTrace(trace_path);
+  if (events.empty()) {
+    std::cerr << "Error: No requests in " << trace_path.value() << std::endl;
+    return 1;
+  }
+
+  double speed = 1.0;
+  if (command_line->HasSwitch("speed") &&
+      (!base::StringToDouble(command_line->GetSwitchValueASCII("speed"),
+                             &speed) ||
+       speed < 0)) {
+    std::cerr << "Error: --speed must be a non-negative number" << std::endl;
+    return 1;
+  }
+
+  MultiAdapterManager manager;
+  std::string provider = command_line->GetSwitchValueASCII("provider");
+  if (provider.empty() || provider == "mock") {
+    std::unordered_map<std::string, std::string> config =
+        FitMockProfile(events);
+    base::StringPairs overrides;
+    base::SplitStringIntoKeyValuePairs(
+        command_line->GetSwitchValueASCII("mock-config"), '=', ',',
+        &overrides);
+    for (auto& [key, value] : overrides) {
+      config[key] = value;
+    }
+    auto mock =
+        std::make_unique<asol::adapters::mock::MockServiceProvider>("mock");
+    mock->Configure(config);
+    manager.RegisterProvider(std::move(mock));
+    manager.SetActiveProvider("mock");
+  } else if (provider == "gemini") {
+    std::string api_key = command_line->GetSwitchValueASCII("api-key");
+    if (api_key.empty()) {
+      std::cerr << "Error: --provider=gemini needs --api-key=KEY" << std::endl;
+      return 1;
+    }
+    auto gemini =
+        std::make_unique<asol::adapters::gemini::GeminiServiceProvider>(
+            api_key);
+    std::string provider_id = gemini->GetProviderId();
+    manager.RegisterProvider(std::move(gemini));
+    manager.SetActiveProvider(provider_id);
+  } else {
+    std::cerr << "Error: Unknown provider " << provider << std::endl;
+    return 1;
+  }
+
+  MultiAdapterManager::CacheConfig cache_config;
+  cache_config.enabled = !command_line->HasSwitch("no-cache");
+  if (command_line->HasSwitch("cache-entries")) {
+    size_t max_entries = 0;
+    if (!base::StringToSizeT(command_line->GetSwitchValueASCII("cache-entries"),
+                             &max_entries)) {
+      std::cerr << "Error: --cache-entries must be a count" << std::endl;
+      return 1;
+    }
+    cache_config.max_entries = max_entries;
+  }
+  manager.ConfigureCache(cache_config);
+
+  base::RunLoop run_loop;
+  ReplayResults results;
+  results.remaining = events.size();
+  results.quit = run_loop.QuitClosure();
+  std::cout << "Replaying " << events.size() << " requests from "
+            << trace_path.value() << std::endl;
+  // All are posted now, so each delay is its offset from the start
+  for (const auto& event : events) {
+    base::TimeDelta delay = speed > 0 ? event.start / speed : base::TimeDelta();
+    base::SingleThreadTaskRunner::GetCurrentDefault()->PostDelayedTask(
+        FROM_HERE, base::BindOnce(&SendRequest, &manager, &results, event),
+        std::max(delay, base::TimeDelta()));
+  }
+  run_loop.Run();
+
+  PrintReport(events, &results);
+  base::ThreadPoolInstance::Get()->Shutdown();
+  return 0;
+}
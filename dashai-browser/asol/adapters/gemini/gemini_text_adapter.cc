@@ -1,8 +1,15 @@
 #include "asol/adapters/gemini/gemini_text_adapter.h"
+#include "asol/cpp/utils/curl_multi_http_client.h" // Default IHttpClient
+#include "asol/cpp/utils/sse_event_reader.h" // For streamed completions
+#include <algorithm> // For std::find
+#include <charconv>  // For std::from_chars
 #include <iostream> // For placeholder logging
-#include <vector>   // For header list in dummy network call
+#include <vector>
 #include <sstream>  // For std::ostringstream (manual JSON construction)
 #include <iomanip>  // For std::setw, std::setfill with std::hex for EscapeJsonString
+#include <memory>   // For std::shared_ptr
+#include <string_view>
+#include <utility>  // For std::move
 
 // Note: The dashaibrowser::asol::adapters::GeminiTextAdapter::NetworkRequestHandler
 //       class definition is removed from here as it's replaced by IHttpClient.
@@ -37,12 +44,219 @@ std::string EscapeJsonString(const std::string& input) {
     return oss.str();
 }
 
+namespace {
+
+// Scheme, host and port of |url|, e.g. "https://host" for "https://host/v1/x?y".
+std::string OriginOf(const std::string& url) {
+    size_t scheme_end = url.find("://");
+    if (scheme_end == std::string::npos) {
+        return "";
+    }
+    size_t host_end = url.find_first_of("/?#", scheme_end + 3);
+    return url.substr(0, host_end);
+}
+
+// Appends |code_point| to |out| as UTF-8.
+void AppendUtf8(uint32_t code_point, std::string* out) {
+    if (code_point < 0x80) {
+        out->push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        out->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+// Reads the four hex digits at the start of |digits|.
+bool ParseHex4(std::string_view digits, uint32_t* value) {
+    if (digits.size() < 4) {
+        return false;
+    }
+    auto result = std::from_chars(digits.data(), digits.data() + 4, *value, 16);
+    return result.ec == std::errc() && result.ptr == digits.data() + 4;
+}
+
+// Position just past the ':' following the first "|key|" in |json|, or npos.
+size_t FindJsonValue(std::string_view json, std::string_view key) {
+    std::string quoted_key = "\"" + std::string(key) + "\"";
+    size_t pos = json.find(quoted_key);
+    if (pos == std::string_view::npos) {
+        return pos;
+    }
+    pos = json.find_first_not_of(" \t\r\n", pos + quoted_key.size());
+    if (pos == std::string_view::npos || json[pos] != ':') {
+        return std::string_view::npos;
+    }
+    return json.find_first_not_of(" \t\r\n", pos + 1);
+}
+
+// Reads the first string field named |key| in |json|, decoding escapes.
+// Streamed events are small, so a scan beats building a document.
+bool ReadJsonString(std::string_view json, std::string_view key, std::string* value) {
+    size_t pos = FindJsonValue(json, key);
+    if (pos == std::string_view::npos || json[pos] != '"') {
+        return false;
+    }
+    value->clear();
+    for (++pos; pos < json.size(); ++pos) {
+        char c = json[pos];
+        if (c == '"') {
+            return true;
+        }
+        if (c != '\\') {
+            value->push_back(c);
+            continue;
+        }
+        if (++pos == json.size()) {
+            return false;
+        }
+        switch (json[pos]) {
+            case 'n': value->push_back('\n'); break;
+            case 't': value->push_back('\t'); break;
+            case 'r': value->push_back('\r'); break;
+            case 'b': value->push_back('\b'); break;
+            case 'f': value->push_back('\f'); break;
+            case 'u': {
+                uint32_t code_point = 0;
+                if (!ParseHex4(json.substr(pos + 1), &code_point)) {
+                    return false;
+                }
+                pos += 4;
+                // A high surrogate is followed by "\uDC00".."\uDFFF"
+                uint32_t low = 0;
+                if (code_point >= 0xD800 && code_point < 0xDC00 &&
+                    json.substr(pos + 1, 2) == "\\u" && ParseHex4(json.substr(pos + 3), &low) &&
+                    low >= 0xDC00 && low < 0xE000) {
+                    code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                    pos += 6;
+                }
+                AppendUtf8(code_point, value);
+                break;
+            }
+            default: value->push_back(json[pos]); break; // '"', '\\', '/'
+        }
+    }
+    return false;
+}
+
+// Reads the first integer field named |key| in |json|.
+bool ReadJsonInt(std::string_view json, std::string_view key, int32_t* value) {
+    size_t pos = FindJsonValue(json, key);
+    if (pos == std::string_view::npos) {
+        return false;
+    }
+    auto result = std::from_chars(json.data() + pos, json.data() + json.size(), *value);
+    return result.ec == std::errc();
+}
+
+// Reads the token counts of a response's "usageMetadata", if it has one.
+bool ReadUsageMetadata(std::string_view json, ipc::TokenUsage* usage) {
+    size_t usage_pos = json.find("\"usageMetadata\"");
+    if (usage_pos == std::string_view::npos) {
+        return false;
+    }
+    std::string_view usage_metadata = json.substr(usage_pos);
+    int32_t tokens = 0;
+    if (ReadJsonInt(usage_metadata, "promptTokenCount", &tokens)) {
+        usage->set_prompt_tokens(tokens);
+    }
+    if (ReadJsonInt(usage_metadata, "candidatesTokenCount", &tokens)) {
+        usage->set_completion_tokens(tokens);
+    }
+    if (ReadJsonInt(usage_metadata, "totalTokenCount", &tokens)) {
+        usage->set_total_tokens(tokens);
+    }
+    return true;
+}
+
+// Headers of a call, with its traceparent if the caller traces it
+std::vector<std::string> RequestHeaders(const CallOptions& options) {
+    std::vector<std::string> headers = {"Content-Type: application/json"};
+    if (!options.traceparent.empty()) {
+        headers.push_back("traceparent: " + options.traceparent);
+    }
+    return headers;
+}
+
+} // namespace
+
+void IGeminiTextAdapter::GetSummaryAsync(
+    const std::string& text,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    TextCallback on_complete) {
+    ipc::ErrorDetails error_details;
+    std::string summary = GetSummary(text, prefs, &error_details);
+    on_complete(std::move(summary), std::move(error_details));
+}
+
+void IGeminiTextAdapter::TranslateTextAsync(
+    const std::string& text,
+    const std::string& source_lang_code,
+    const std::string& target_lang_code,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    TextCallback on_complete) {
+    ipc::ErrorDetails error_details;
+    std::string translated_text = TranslateText(text, source_lang_code, target_lang_code, prefs, &error_details);
+    on_complete(std::move(translated_text), std::move(error_details));
+}
+
+void IGeminiTextAdapter::GenerateTextAsync(
+    const std::string& prompt,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    TextCallback on_complete) {
+    ipc::ErrorDetails error_details;
+    std::string generated_text = GenerateText(prompt, prefs, &error_details);
+    on_complete(std::move(generated_text), std::move(error_details));
+}
+
+IGeminiTextAdapter::TextCallback IGeminiTextAdapter::DeliverAsStream(
+    DeltaCallback on_delta,
+    StreamDoneCallback on_complete) {
+    return [on_delta = std::move(on_delta), on_complete = std::move(on_complete)](
+               std::string text, ipc::ErrorDetails error_details) {
+        if (error_details.error_code() == 0 && !text.empty()) {
+            on_delta(text, 0);
+        }
+        on_complete(ipc::TokenUsage(), std::move(error_details));
+    };
+}
+
+void IGeminiTextAdapter::StreamSummary(
+    const std::string& text,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    DeltaCallback on_delta,
+    StreamDoneCallback on_complete) {
+    GetSummaryAsync(text, prefs, options, DeliverAsStream(std::move(on_delta), std::move(on_complete)));
+}
+
+void IGeminiTextAdapter::StreamText(
+    const std::string& prompt,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    DeltaCallback on_delta,
+    StreamDoneCallback on_complete) {
+    GenerateTextAsync(prompt, prefs, options, DeliverAsStream(std::move(on_delta), std::move(on_complete)));
+}
+
 GeminiTextAdapter::GeminiTextAdapter(std::unique_ptr<utils::IHttpClient> http_client)
     : http_client_(std::move(http_client)) {
     if (!http_client_) {
-        // Default to CurlHttpClient if none provided, assuming GlobalInit has been called.
-        // This makes direct instantiation easier for AsolServiceImpl.
-        http_client_ = std::make_unique<utils::CurlHttpClient>();
+        // Default to CurlMultiHttpClient if none provided, assuming GlobalInit has been called.
+        // This makes direct instantiation easier for AsolServiceImpl, and keeps
+        // connections warm and multiplexed across requests.
+        http_client_ = std::make_unique<utils::CurlMultiHttpClient>();
     }
     std::cout << "GeminiTextAdapter: Instance created." << std::endl;
 }
@@ -95,27 +309,53 @@ bool GeminiTextAdapter::Initialize(const GeminiAdapterConfig& config) {
     return initialized_;
 }
 
-// TODO: Replace manual JSON construction and parsing with a proper JSON library.
-std::string GeminiTextAdapter::GetSummary(
-    const std::string& text,
-    const dashaibrowser::ipc::UserPreferences& prefs,
-    dashaibrowser::ipc::ErrorDetails* error_details) {
-
-    SetError(error_details, 0, "", "");
+void GeminiTextAdapter::Preconnect() {
     if (!initialized_) {
-        SetError(error_details, 500, "Adapter not initialized.", "Service configuration error.");
-        return "";
+        return;
     }
-    if (text.empty()) {
-        SetError(error_details, 400, "Input text is empty for summary.", "Cannot summarize empty text.");
-        return "";
+    // All endpoints usually share one origin; warm each distinct one once.
+    std::vector<std::string> origins;
+    for (const std::string* endpoint : {&config_.api_endpoint_summarize,
+                                        &config_.api_endpoint_translate,
+                                        &config_.api_endpoint_generate_text}) {
+        std::string origin = OriginOf(*endpoint);
+        if (!origin.empty() && std::find(origins.begin(), origins.end(), origin) == origins.end()) {
+            origins.push_back(origin);
+        }
+    }
+    for (const auto& origin : origins) {
+        std::cout << "GeminiTextAdapter: Preconnecting to " << origin << std::endl;
     }
+    http_client_->Preconnect(origins);
+}
 
-    std::cout << "GeminiTextAdapter::GetSummary: Requesting summary for text (first 50 chars): \""
-              << text.substr(0, 50) << "...\"" << std::endl;
+std::string GeminiTextAdapter::EndpointUrl(const std::string& endpoint) const {
+    std::string url = endpoint;
+    if (url.find('?') == std::string::npos) {
+        url += "?key=" + config_.api_key;
+    } else {
+        url += "&key=" + config_.api_key;
+    }
+    return url;
+}
+
+std::string GeminiTextAdapter::StreamEndpointUrl(const std::string& endpoint) const {
+    constexpr std::string_view kGenerate = ":generateContent";
+    constexpr std::string_view kStream = ":streamGenerateContent";
+    std::string url = endpoint;
+    size_t query = url.find('?');
+    size_t method = url.rfind(kGenerate, query);
+    if (method != std::string::npos) {
+        url.replace(method, kGenerate.size(), kStream);
+        query = url.find('?');
+    }
+    url += query == std::string::npos ? "?alt=sse&key=" : "&alt=sse&key=";
+    return url + config_.api_key;
+}
 
-    std::string escaped_text = EscapeJsonString("Summarize the following text: " + text);
-    std::string request_body =
+// TODO: Replace manual JSON construction with a proper JSON library.
+std::string GeminiTextAdapter::BuildRequestBody(const std::string& escaped_text) {
+    return
         "{\n"
         "  \"contents\": [\n"
         "    {\n"
@@ -135,88 +375,71 @@ std::string GeminiTextAdapter::GetSummary(
         // "    \"stopSequences\": []\n"
         "  }\n"
         "}";
+}
 
-    std::vector<std::string> headers = {"Content-Type: application/json"};
-
-    std::string url = config_.api_endpoint_summarize;
-    if (url.find('?') == std::string::npos) {
-        url += "?key=" + config_.api_key;
-    } else {
-        url += "&key=" + config_.api_key;
+const GeminiTextAdapter::OperationMessages GeminiTextAdapter::kSummaryMessages = {
+    "Gemini API HTTP request failed for GetSummary",
+    "AI service communication error.",
+    "Gemini response missing 'candidates' for GetSummary.",
+    "Failed to parse summary text from Gemini response for GetSummary.",
+    "AI service returned an unexpected response format.",
+};
+
+const GeminiTextAdapter::OperationMessages GeminiTextAdapter::kTranslationMessages = {
+    "Gemini API HTTP request failed for translation",
+    "AI service communication error for translation.",
+    "Gemini translation response missing 'candidates'.",
+    "Failed to parse translated text from Gemini response.",
+    "AI service returned an unexpected response format for translation.",
+};
+
+const GeminiTextAdapter::OperationMessages GeminiTextAdapter::kGenerateTextMessages = {
+    "Gemini API HTTP request failed for GenerateText",
+    "AI service communication error for text generation.",
+    "Gemini response missing 'candidates' for GenerateText.",
+    "Failed to parse generated text from Gemini response for GenerateText.",
+    "AI service returned an unexpected response format.",
+};
+
+bool GeminiTextAdapter::PrepareSummary(const std::string& text,
+                                       PreparedRequest* request,
+                                       ipc::ErrorDetails* error_details) {
+    SetError(error_details, 0, "", "");
+    if (!initialized_) {
+        SetError(error_details, 500, "Adapter not initialized.", "Service configuration error.");
+        return false;
     }
-
-    // std::cout << "GeminiTextAdapter::GetSummary: URL: " << url << std::endl; // Verbose
-    // std::cout << "GeminiTextAdapter::GetSummary: Request Body: " << request_body << std::endl; // Verbose
-
-
-    utils::HttpResponse http_response = http_client_->Post(
-        url, request_body, headers, config_.timeout_ms
-    );
-
-    // std::cout << "GeminiTextAdapter::GetSummary: Response Status: " << http_response.status_code << std::endl; // Verbose
-    // std::cout << "GeminiTextAdapter::GetSummary: Response Body: " << http_response.body << std::endl; // Verbose
-
-
-    if (!http_response.IsSuccess()) {
-        std::string err_msg = "Gemini API HTTP request failed for GetSummary. Status: " + std::to_string(http_response.status_code);
-        if (!http_response.error_message.empty()) {
-             err_msg += ". Network Error: " + http_response.error_message;
-        } else if (!http_response.body.empty()) {
-            size_t err_msg_start = http_response.body.find("\"message\": \"");
-            if (err_msg_start != std::string::npos) {
-                err_msg_start += 12;
-                size_t err_msg_end = http_response.body.find("\"", err_msg_start);
-                if (err_msg_end != std::string::npos) {
-                    err_msg += ". API Message: " + http_response.body.substr(err_msg_start, err_msg_end - err_msg_start);
-                }
-            } else {
-                 err_msg += ". Body: " + http_response.body.substr(0,100) + "...";
-            }
-        }
-        SetError(error_details, http_response.status_code == 0 ? 504 : static_cast<int32_t>(http_response.status_code),
-                 err_msg, "AI service communication error.");
-        return "";
+    if (text.empty()) {
+        SetError(error_details, 400, "Input text is empty for summary.", "Cannot summarize empty text.");
+        return false;
     }
 
-    size_t candidates_pos = http_response.body.find("\"candidates\":");
-    if (candidates_pos == std::string::npos) {
-        SetError(error_details, 503, "Gemini response missing 'candidates' for GetSummary.", "AI service returned an unexpected response format.");
-        return "";
-    }
-    size_t text_field_pos = http_response.body.find("\"text\": \"", candidates_pos);
-    if (text_field_pos != std::string::npos) {
-        text_field_pos += 9;
-        size_t text_end_pos = http_response.body.find("\"", text_field_pos);
-        if (text_end_pos != std::string::npos) {
-            std::string summary = http_response.body.substr(text_field_pos, text_end_pos - text_field_pos);
-            return summary;
-        }
-    }
+    std::cout << "GeminiTextAdapter::GetSummary: Requesting summary for text (first 50 chars): \""
+              << text.substr(0, 50) << "...\"" << std::endl;
 
-    SetError(error_details, 503, "Failed to parse summary text from Gemini response for GetSummary.", "AI service returned an unexpected response format.");
-    return "";
+    request->endpoint = config_.api_endpoint_summarize;
+    request->body = BuildRequestBody(EscapeJsonString("Summarize the following text: " + text));
+    request->messages = &kSummaryMessages;
+    return true;
 }
 
-// TODO: Replace manual JSON construction and parsing with a proper JSON library.
-std::string GeminiTextAdapter::TranslateText(
-    const std::string& text,
-    const std::string& source_lang_code,
-    const std::string& target_lang_code,
-    const dashaibrowser::ipc::UserPreferences& prefs,
-    dashaibrowser::ipc::ErrorDetails* error_details) {
-
+bool GeminiTextAdapter::PrepareTranslation(const std::string& text,
+                                           const std::string& source_lang_code,
+                                           const std::string& target_lang_code,
+                                           PreparedRequest* request,
+                                           ipc::ErrorDetails* error_details) {
     SetError(error_details, 0, "", "");
     if (!initialized_) {
         SetError(error_details, 500, "Adapter not initialized.", "Service configuration error.");
-        return "";
+        return false;
     }
     if (text.empty()) {
         SetError(error_details, 400, "Input text is empty for translation.", "Cannot translate empty text.");
-        return "";
+        return false;
     }
     if (target_lang_code.empty()) {
         SetError(error_details, 400, "Target language code is empty.", "Please specify a target language.");
-        return "";
+        return false;
     }
 
     std::cout << "GeminiTextAdapter::TranslateText: Requesting translation for (first 50 chars): \""
@@ -229,43 +452,40 @@ std::string GeminiTextAdapter::TranslateText(
     }
     prompt_instruction += " to " + EscapeJsonString(target_lang_code) + ". The text to translate is: ";
 
-    std::string escaped_text_to_translate = EscapeJsonString(text);
-
-    std::string request_body =
-        "{\n"
-        "  \"contents\": [\n"
-        "    {\n"
-        "      \"role\": \"user\",\n"
-        "      \"parts\": [\n"
-        "        { \"text\": \"" + EscapeJsonString(prompt_instruction) + escaped_text_to_translate + "\" }\n"
-        "      ]\n"
-        "    }\n"
-        "  ],\n"
-        "  \"generationConfig\": {\n"
-        "    \"responseMimeType\": \"text/plain\"\n"
-        "  }\n"
-        "}";
+    request->endpoint = config_.api_endpoint_translate;
+    request->body = BuildRequestBody(EscapeJsonString(prompt_instruction) + EscapeJsonString(text));
+    request->messages = &kTranslationMessages;
+    return true;
+}
 
-    std::vector<std::string> headers = {"Content-Type: application/json"};
-    std::string url = config_.api_endpoint_translate;
-     if (url.find('?') == std::string::npos) {
-        url += "?key=" + config_.api_key;
-    } else {
-        url += "&key=" + config_.api_key;
+bool GeminiTextAdapter::PrepareGenerateText(const std::string& prompt,
+                                            PreparedRequest* request,
+                                            ipc::ErrorDetails* error_details) {
+    SetError(error_details, 0, "", ""); // Clear previous errors
+    if (!initialized_) {
+        SetError(error_details, 500, "Adapter not initialized.", "Service configuration error.");
+        return false;
+    }
+    if (prompt.empty()) {
+        SetError(error_details, 400, "Input prompt is empty for text generation.", "Cannot generate text from empty prompt.");
+        return false;
     }
 
-    // std::cout << "GeminiTextAdapter::TranslateText: URL: " << url << std::endl; // Verbose
-    // std::cout << "GeminiTextAdapter::TranslateText: Request Body: " << request_body << std::endl; // Verbose
-
-    utils::HttpResponse http_response = http_client_->Post(
-        url, request_body, headers, config_.timeout_ms
-    );
+    std::cout << "GeminiTextAdapter::GenerateText: Requesting text generation for prompt (first 50 chars): \""
+              << prompt.substr(0, 50) << "...\"" << std::endl;
 
-    // std::cout << "GeminiTextAdapter::TranslateText: Response Status: " << http_response.status_code << std::endl; // Verbose
-    // std::cout << "GeminiTextAdapter::TranslateText: Response Body: " << http_response.body << std::endl; // Verbose
+    request->endpoint = config_.api_endpoint_generate_text; // Use specific endpoint for text gen
+    request->body = BuildRequestBody(EscapeJsonString(prompt));
+    request->messages = &kGenerateTextMessages;
+    return true;
+}
 
+// TODO: Replace manual JSON parsing with a proper JSON library.
+std::string GeminiTextAdapter::ParseResponse(const utils::HttpResponse& http_response,
+                                             const OperationMessages& messages,
+                                             ipc::ErrorDetails* error_details) {
     if (!http_response.IsSuccess()) {
-        std::string err_msg = "Gemini API HTTP request failed for translation. Status: " + std::to_string(http_response.status_code);
+        std::string err_msg = std::string(messages.http_failure) + ". Status: " + std::to_string(http_response.status_code);
         if (!http_response.error_message.empty()) {
              err_msg += ". Network Error: " + http_response.error_message;
         } else if (!http_response.body.empty()) {
@@ -281,13 +501,13 @@ std::string GeminiTextAdapter::TranslateText(
             }
         }
         SetError(error_details, http_response.status_code == 0 ? 504 : static_cast<int32_t>(http_response.status_code),
-                 err_msg, "AI service communication error for translation.");
+                 err_msg, messages.http_user_message);
         return "";
     }
 
     size_t candidates_pos = http_response.body.find("\"candidates\":");
     if (candidates_pos == std::string::npos) {
-        SetError(error_details, 503, "Gemini translation response missing 'candidates'.", "AI service returned an unexpected response format for translation.");
+        SetError(error_details, 503, messages.missing_candidates, messages.format_user_message);
         return "";
     }
     size_t text_field_pos = http_response.body.find("\"text\": \"", candidates_pos);
@@ -295,109 +515,205 @@ std::string GeminiTextAdapter::TranslateText(
         text_field_pos += 9;
         size_t text_end_pos = http_response.body.find("\"", text_field_pos);
         if (text_end_pos != std::string::npos) {
-            std::string translated_text = http_response.body.substr(text_field_pos, text_end_pos - text_field_pos);
-            return translated_text;
+            // TODO: Unescape JSON string
+            return http_response.body.substr(text_field_pos, text_end_pos - text_field_pos);
         }
     }
 
-    SetError(error_details, 503, "Failed to parse translated text from Gemini response.", "AI service returned an unexpected response format for translation.");
+    SetError(error_details, 503, messages.parse_failure, messages.format_user_message);
     return "";
 }
 
-// TODO: Replace manual JSON construction and parsing with a proper JSON library.
-std::string GeminiTextAdapter::GenerateText(
-    const std::string& prompt,
+std::string GeminiTextAdapter::Send(const PreparedRequest& request,
+                                    ipc::ErrorDetails* error_details) {
+    utils::HttpResponse http_response = http_client_->Post(
+        EndpointUrl(request.endpoint), request.body, {"Content-Type: application/json"}, config_.timeout_ms
+    );
+    return ParseResponse(http_response, *request.messages, error_details);
+}
+
+void GeminiTextAdapter::SendAsync(const PreparedRequest& request,
+                                  const CallOptions& options,
+                                  TextCallback on_complete) {
+    const OperationMessages* messages = request.messages;
+    int timeout_ms = config_.timeout_ms;
+    if (options.timeout_ms > 0 && (timeout_ms <= 0 || options.timeout_ms < timeout_ms)) {
+        timeout_ms = options.timeout_ms;
+    }
+    http_client_->PostAsync(
+        EndpointUrl(request.endpoint), request.body, RequestHeaders(options), timeout_ms,
+        [this, messages, trace = options.trace, on_complete = std::move(on_complete)](
+            utils::HttpResponse http_response) {
+            ipc::ErrorDetails error_details;
+            std::string text = ParseResponse(http_response, *messages, &error_details);
+            if (trace && error_details.error_code() == 0) {
+                ReadUsageMetadata(http_response.body, &trace->usage);
+            }
+            on_complete(std::move(text), std::move(error_details));
+        });
+}
+
+std::string GeminiTextAdapter::GetSummary(
+    const std::string& text,
     const dashaibrowser::ipc::UserPreferences& prefs,
     dashaibrowser::ipc::ErrorDetails* error_details) {
-
-    SetError(error_details, 0, "", ""); // Clear previous errors
-    if (!initialized_) {
-        SetError(error_details, 500, "Adapter not initialized.", "Service configuration error.");
+    PreparedRequest request;
+    if (!PrepareSummary(text, &request, error_details)) {
         return "";
     }
-    if (prompt.empty()) {
-        SetError(error_details, 400, "Input prompt is empty for text generation.", "Cannot generate text from empty prompt.");
+    return Send(request, error_details);
+}
+
+std::string GeminiTextAdapter::TranslateText(
+    const std::string& text,
+    const std::string& source_lang_code,
+    const std::string& target_lang_code,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    dashaibrowser::ipc::ErrorDetails* error_details) {
+    PreparedRequest request;
+    if (!PrepareTranslation(text, source_lang_code, target_lang_code, &request, error_details)) {
         return "";
     }
+    return Send(request, error_details);
+}
 
-    std::cout << "GeminiTextAdapter::GenerateText: Requesting text generation for prompt (first 50 chars): \""
-              << prompt.substr(0, 50) << "...\"" << std::endl;
-
-    std::string escaped_prompt = EscapeJsonString(prompt);
-    std::string request_body =
-        "{\n"
-        "  \"contents\": [\n"
-        "    {\n"
-        "      \"role\": \"user\",\n"
-        "      \"parts\": [\n"
-        "        { \"text\": \"" + escaped_prompt + "\" }\n"
-        "      ]\n"
-        "    }\n"
-        "  ],\n"
-        "  \"generationConfig\": {\n"
-        "    \"responseMimeType\": \"text/plain\"\n"
-        // TODO: Add other generation configs from prefs if applicable (temperature, max tokens etc.)
-        "  }\n"
-        "}";
-
-    std::vector<std::string> headers = {"Content-Type: application/json"};
-
-    std::string url = config_.api_endpoint_generate_text; // Use specific endpoint for text gen
-    if (url.find('?') == std::string::npos) {
-        url += "?key=" + config_.api_key;
-    } else {
-        url += "&key=" + config_.api_key;
+std::string GeminiTextAdapter::GenerateText(
+    const std::string& prompt,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    dashaibrowser::ipc::ErrorDetails* error_details) {
+    PreparedRequest request;
+    if (!PrepareGenerateText(prompt, &request, error_details)) {
+        return "";
     }
+    return Send(request, error_details);
+}
 
-    // std::cout << "GeminiTextAdapter::GenerateText: URL: " << url << std::endl; // Verbose
-    // std::cout << "GeminiTextAdapter::GenerateText: Request Body: " << request_body << std::endl; // Verbose
+void GeminiTextAdapter::GetSummaryAsync(
+    const std::string& text,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    TextCallback on_complete) {
+    PreparedRequest request;
+    ipc::ErrorDetails error_details;
+    if (!PrepareSummary(text, &request, &error_details)) {
+        on_complete("", std::move(error_details));
+        return;
+    }
+    SendAsync(request, options, std::move(on_complete));
+}
 
-    utils::HttpResponse http_response = http_client_->Post(
-        url, request_body, headers, config_.timeout_ms
-    );
+void GeminiTextAdapter::TranslateTextAsync(
+    const std::string& text,
+    const std::string& source_lang_code,
+    const std::string& target_lang_code,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    TextCallback on_complete) {
+    PreparedRequest request;
+    ipc::ErrorDetails error_details;
+    if (!PrepareTranslation(text, source_lang_code, target_lang_code, &request, &error_details)) {
+        on_complete("", std::move(error_details));
+        return;
+    }
+    SendAsync(request, options, std::move(on_complete));
+}
 
-    // std::cout << "GeminiTextAdapter::GenerateText: Response Status: " << http_response.status_code << std::endl; // Verbose
-    // std::cout << "GeminiTextAdapter::GenerateText: Response Body: " << http_response.body << std::endl; // Verbose
+void GeminiTextAdapter::GenerateTextAsync(
+    const std::string& prompt,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    TextCallback on_complete) {
+    PreparedRequest request;
+    ipc::ErrorDetails error_details;
+    if (!PrepareGenerateText(prompt, &request, &error_details)) {
+        on_complete("", std::move(error_details));
+        return;
+    }
+    SendAsync(request, options, std::move(on_complete));
+}
 
-    if (!http_response.IsSuccess()) {
-        std::string err_msg = "Gemini API HTTP request failed for GenerateText. Status: " + std::to_string(http_response.status_code);
-        if (!http_response.error_message.empty()) {
-             err_msg += ". Network Error: " + http_response.error_message;
-        } else if (!http_response.body.empty()) {
-            size_t err_msg_start = http_response.body.find("\"message\": \"");
-            if (err_msg_start != std::string::npos) {
-                err_msg_start += 12;
-                size_t err_msg_end = http_response.body.find("\"", err_msg_start);
-                if (err_msg_end != std::string::npos) {
-                    err_msg += ". API Message: " + http_response.body.substr(err_msg_start, err_msg_end - err_msg_start);
-                }
-            } else {
-                 err_msg += ". Body: " + http_response.body.substr(0,100) + "...";
+void GeminiTextAdapter::SendStream(const PreparedRequest& request,
+                                   const CallOptions& options,
+                                   DeltaCallback on_delta,
+                                   StreamDoneCallback on_complete) {
+    // Shared by the chunk and completion callbacks, which curl runs in order
+    // on its event loop thread.
+    struct StreamState {
+        explicit StreamState(DeltaCallback on_delta)
+            : on_delta(std::move(on_delta)),
+              reader([this](std::string_view data) { OnEvent(data); }) {}
+
+        void OnEvent(std::string_view data) {
+            if (stopped) {
+                return;
+            }
+            size_t usage_pos = data.find("\"usageMetadata\"");
+            if (usage_pos != std::string_view::npos) {
+                ReadUsageMetadata(data.substr(usage_pos), &usage);
+            }
+            std::string delta;
+            if (ReadJsonString(data.substr(0, usage_pos), "text", &delta) && !delta.empty()) {
+                stopped = !on_delta(delta, usage.completion_tokens());
             }
         }
-        SetError(error_details, http_response.status_code == 0 ? 504 : static_cast<int32_t>(http_response.status_code),
-                 err_msg, "AI service communication error for text generation.");
-        return "";
-    }
 
-    size_t candidates_pos = http_response.body.find("\"candidates\":");
-    if (candidates_pos == std::string::npos) {
-        SetError(error_details, 503, "Gemini response missing 'candidates' for GenerateText.", "AI service returned an unexpected response format.");
-        return "";
-    }
-    size_t text_field_pos = http_response.body.find("\"text\": \"", candidates_pos);
-    if (text_field_pos != std::string::npos) {
-        text_field_pos += 9;
-        size_t text_end_pos = http_response.body.find("\"", text_field_pos);
-        if (text_end_pos != std::string::npos) {
-            std::string generated_text = http_response.body.substr(text_field_pos, text_end_pos - text_field_pos);
-            // TODO: Unescape JSON string
-            return generated_text;
-        }
+        DeltaCallback on_delta;
+        utils::SseEventReader reader;
+        ipc::TokenUsage usage;
+        bool stopped = false;
+    };
+
+    auto state = std::make_shared<StreamState>(std::move(on_delta));
+    const OperationMessages* messages = request.messages;
+    http_client_->PostStream(
+        StreamEndpointUrl(request.endpoint), request.body, RequestHeaders(options),
+        // Generations can run long, so only the caller's deadline bounds
+        // the transfer; without one, only the connect timeout applies
+        options.timeout_ms,
+        [state](std::string_view chunk) {
+            state->reader.Append(chunk);
+            return !state->stopped;
+        },
+        [this, state, messages, on_complete = std::move(on_complete)](utils::HttpResponse http_response) {
+            ipc::ErrorDetails error_details;
+            if (!http_response.IsSuccess()) {
+                ParseResponse(http_response, *messages, &error_details);
+                on_complete(ipc::TokenUsage(), std::move(error_details));
+                return;
+            }
+            state->reader.Finish();
+            on_complete(state->usage, std::move(error_details));
+        });
+}
+
+void GeminiTextAdapter::StreamSummary(
+    const std::string& text,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    DeltaCallback on_delta,
+    StreamDoneCallback on_complete) {
+    PreparedRequest request;
+    ipc::ErrorDetails error_details;
+    if (!PrepareSummary(text, &request, &error_details)) {
+        on_complete(ipc::TokenUsage(), std::move(error_details));
+        return;
     }
+    SendStream(request, options, std::move(on_delta), std::move(on_complete));
+}
 
-    SetError(error_details, 503, "Failed to parse generated text from Gemini response for GenerateText.", "AI service returned an unexpected response format.");
-    return "";
+void GeminiTextAdapter::StreamText(
+    const std::string& prompt,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    DeltaCallback on_delta,
+    StreamDoneCallback on_complete) {
+    PreparedRequest request;
+    ipc::ErrorDetails error_details;
+    if (!PrepareGenerateText(prompt, &request, &error_details)) {
+        on_complete(ipc::TokenUsage(), std::move(error_details));
+        return;
+    }
+    SendStream(request, options, std::move(on_delta), std::move(on_complete));
 }
 
 } // namespace adapters
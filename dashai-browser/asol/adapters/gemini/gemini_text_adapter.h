@@ -3,6 +3,10 @@
 
 #include "proto/asol_service.pb.h" // For UserPreferences, ErrorDetails
 #include "asol/cpp/utils/network_request_util.h" // For IHttpClient
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // For std::function
 #include <string>
 #include <vector>
 #include <map> // For AdapterConfig
@@ -21,9 +25,53 @@ struct GeminiAdapterConfig {
     int timeout_ms = 10000;
 };
 
+// How one call was served, for the gateway's metrics and the responses'
+// diagnostic_info. The callee fills it in before the call's completion
+// callback runs; the caller reads it from there.
+struct CallTrace {
+    using Duration = std::chrono::steady_clock::duration;
+
+    Duration queue_time{};          // Waiting for the gateway's admission control
+    std::string operation;          // "summary", "translation" or "generate"
+    size_t input_bytes = 0;         // Of the text to summarize, translate or complete
+    uint64_t request_hash = 0;      // Of the cache key; equal for repeats of a request
+    std::string provider_id;        // Provider that answered, or was tried last
+    int attempts = 0;               // Providers tried; 0 when served from cache
+    bool from_cache = false;
+    Duration upstream_latency{};    // Of the last attempt
+    Duration first_token_latency{}; // Of the last attempt, for streams
+    dashaibrowser::ipc::TokenUsage usage; // As reported by the model, if it did
+};
+
+// Per-call settings for the non-blocking calls.
+struct CallOptions {
+    // Bound on the HTTP transfer, e.g. the time left before the client's
+    // deadline. 0 leaves the adapter's own timeout; otherwise the shorter
+    // of the two applies.
+    int timeout_ms = 0;
+    // Optional; filled in as described above
+    std::shared_ptr<CallTrace> trace;
+    // W3C traceparent sent upstream, so the provider's spans join the
+    // caller's trace; empty to send none
+    std::string traceparent;
+};
+
 // Interface for a Gemini Text Adapter
 class IGeminiTextAdapter {
 public:
+    // Receives the result of an asynchronous call: the generated text, or
+    // an empty string and a non-zero error code. May run on another thread.
+    using TextCallback = std::function<void(std::string text, dashaibrowser::ipc::ErrorDetails error_details)>;
+
+    // Receives each piece of a streamed completion as it is generated, with
+    // the output token count so far (0 when the model has not reported
+    // one). Return false to stop the stream.
+    using DeltaCallback = std::function<bool(const std::string& delta, int32_t completion_tokens)>;
+
+    // Ends a streamed completion: the usage on success, or a non-zero
+    // error code.
+    using StreamDoneCallback = std::function<void(dashaibrowser::ipc::TokenUsage usage, dashaibrowser::ipc::ErrorDetails error_details)>;
+
     virtual ~IGeminiTextAdapter() = default;
 
     virtual bool Initialize(const GeminiAdapterConfig& config) = 0;
@@ -48,6 +96,60 @@ public:
         const dashaibrowser::ipc::UserPreferences& prefs, // UserPreferences might be relevant here too
         dashaibrowser::ipc::ErrorDetails* error_details
     ) = 0;
+
+    // Warm connections to the configured endpoints so the first request
+    // skips connection setup. Call after Initialize(). Default: no-op.
+    virtual void Preconnect() {}
+
+    // Non-blocking variants of the calls above: they return once the
+    // request is sent and report through |on_complete|, so a server can
+    // keep many calls in flight without a thread each. The defaults run
+    // the blocking call and report inline; they cannot apply |options|.
+    virtual void GetSummaryAsync(
+        const std::string& text,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        TextCallback on_complete
+    );
+
+    virtual void TranslateTextAsync(
+        const std::string& text,
+        const std::string& source_lang_code,
+        const std::string& target_lang_code,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        TextCallback on_complete
+    );
+
+    virtual void GenerateTextAsync(
+        const std::string& prompt,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        TextCallback on_complete
+    );
+
+    // Streamed variants of GetSummary and GenerateText: |on_delta| runs as
+    // text arrives, then |on_complete| once. Both may run on another
+    // thread. The defaults deliver the whole result as one delta.
+    virtual void StreamSummary(
+        const std::string& text,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        DeltaCallback on_delta,
+        StreamDoneCallback on_complete
+    );
+
+    virtual void StreamText(
+        const std::string& prompt,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        DeltaCallback on_delta,
+        StreamDoneCallback on_complete
+    );
+
+private:
+    // Deliver an Async() result as a stream of one delta.
+    static TextCallback DeliverAsStream(DeltaCallback on_delta, StreamDoneCallback on_complete);
 };
 
 
@@ -79,7 +181,99 @@ public:
         dashaibrowser::ipc::ErrorDetails* error_details
     ) override;
 
+    void Preconnect() override;
+
+    void GetSummaryAsync(
+        const std::string& text,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        TextCallback on_complete
+    ) override;
+
+    void TranslateTextAsync(
+        const std::string& text,
+        const std::string& source_lang_code,
+        const std::string& target_lang_code,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        TextCallback on_complete
+    ) override;
+
+    void GenerateTextAsync(
+        const std::string& prompt,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        TextCallback on_complete
+    ) override;
+
+    void StreamSummary(
+        const std::string& text,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        DeltaCallback on_delta,
+        StreamDoneCallback on_complete
+    ) override;
+
+    void StreamText(
+        const std::string& prompt,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        DeltaCallback on_delta,
+        StreamDoneCallback on_complete
+    ) override;
+
 private:
+    // Error texts reported for one kind of call.
+    struct OperationMessages {
+        const char* http_failure;
+        const char* http_user_message;
+        const char* missing_candidates;
+        const char* parse_failure;
+        const char* format_user_message;
+    };
+
+    static const OperationMessages kSummaryMessages;
+    static const OperationMessages kTranslationMessages;
+    static const OperationMessages kGenerateTextMessages;
+
+    // A validated call, ready to send.
+    struct PreparedRequest {
+        std::string endpoint; // Without the API key
+        std::string body;
+        const OperationMessages* messages = nullptr;
+    };
+
+    // Validate the input and build the request; false with |error_details|
+    // set when the call cannot be made.
+    bool PrepareSummary(const std::string& text,
+                        PreparedRequest* request,
+                        ipc::ErrorDetails* error_details);
+    bool PrepareTranslation(const std::string& text,
+                            const std::string& source_lang_code,
+                            const std::string& target_lang_code,
+                            PreparedRequest* request,
+                            ipc::ErrorDetails* error_details);
+    bool PrepareGenerateText(const std::string& prompt,
+                             PreparedRequest* request,
+                             ipc::ErrorDetails* error_details);
+
+    std::string EndpointUrl(const std::string& endpoint) const;
+    // The streamGenerateContent form of |endpoint|, answering with SSE.
+    std::string StreamEndpointUrl(const std::string& endpoint) const;
+    static std::string BuildRequestBody(const std::string& escaped_text);
+
+    // Generated text of |http_response|, or "" with |error_details| set.
+    std::string ParseResponse(const utils::HttpResponse& http_response,
+                              const OperationMessages& messages,
+                              ipc::ErrorDetails* error_details);
+
+    std::string Send(const PreparedRequest& request, ipc::ErrorDetails* error_details);
+    void SendAsync(const PreparedRequest& request, const CallOptions& options, TextCallback on_complete);
+    void SendStream(const PreparedRequest& request,
+                    const CallOptions& options,
+                    DeltaCallback on_delta,
+                    StreamDoneCallback on_complete);
+
     GeminiAdapterConfig config_;
     bool initialized_ = false;
     std::unique_ptr<utils::IHttpClient> http_client_;
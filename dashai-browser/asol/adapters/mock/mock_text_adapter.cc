@@ -0,0 +1,505 @@
+#include "asol/adapters/mock/mock_text_adapter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <thread>
+#include <utility>
+
+namespace dashaibrowser {
+namespace asol {
+namespace adapters {
+
+namespace {
+
+// z-score of the 99th percentile of the standard normal distribution
+constexpr double kP99ZScore = 2.3263;
+
+// Bytes per token in the usage the mock reports
+constexpr size_t kBytesPerToken = 4;
+
+// Words the responses are made of
+constexpr const char* kWords[] = {
+    "the",     "page",    "describes", "a",       "summary", "of",
+    "recent",  "results", "and",       "their",   "key",     "points",
+    "with",    "several", "examples",  "that",    "show",    "how",
+    "browser", "users",   "read",      "content", "quickly", "today",
+};
+
+// The code and message the real adapter reports for a transfer that did
+// not finish, so the router treats both alike
+void SetTimedOut(ipc::ErrorDetails* error_details, const char* message) {
+    error_details->set_error_code(504);
+    error_details->set_error_message(message);
+    error_details->set_user_facing_message("The AI service took too long to respond.");
+}
+
+bool ParseInt64(const std::string& text, int64_t* value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    long long parsed = std::strtoll(text.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || parsed < 0) {
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+bool ParseDouble(const std::string& text, double* value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    double parsed = std::strtod(text.c_str(), &end);
+    if (errno != 0 || *end != '\0') {
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+std::vector<std::string> Split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(separator, start);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        if (end > start) {
+            parts.push_back(text.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return parts;
+}
+
+int32_t EstimateTokens(size_t bytes) {
+    return static_cast<int32_t>((bytes + kBytesPerToken - 1) / kBytesPerToken);
+}
+
+} // namespace
+
+bool MockProfile::Parse(const std::string& settings, std::string* error) {
+    for (const std::string& setting : Split(settings, ':')) {
+        size_t equals = setting.find('=');
+        if (equals == std::string::npos) {
+            *error = "Expected key=value, got \"" + setting + "\"";
+            return false;
+        }
+        std::string key = setting.substr(0, equals);
+        std::string value = setting.substr(equals + 1);
+
+        int64_t number = 0;
+        double fraction = 0.0;
+        bool valid = true;
+        if (key == "latency_distribution") {
+            if (value == "fixed") {
+                latency_distribution = LatencyDistribution::FIXED;
+            } else if (value == "uniform") {
+                latency_distribution = LatencyDistribution::UNIFORM;
+            } else if (value == "lognormal") {
+                latency_distribution = LatencyDistribution::LOG_NORMAL;
+            } else {
+                valid = false;
+            }
+        } else if (key == "error_rate") {
+            valid = ParseDouble(value, &fraction) && fraction >= 0.0 && fraction <= 1.0;
+            if (valid) {
+                error_rate = fraction;
+            }
+        } else if (!ParseInt64(value, &number)) {
+            valid = false;
+        } else if (key == "latency_ms") {
+            latency_median = std::chrono::milliseconds(number);
+        } else if (key == "latency_p99_ms") {
+            latency_p99 = std::chrono::milliseconds(number);
+        } else if (key == "latency_min_ms") {
+            latency_min = std::chrono::milliseconds(number);
+        } else if (key == "latency_max_ms") {
+            latency_max = std::chrono::milliseconds(number);
+        } else if (key == "chunk_bytes") {
+            chunk_bytes = static_cast<size_t>(number);
+        } else if (key == "chunk_interval_ms") {
+            chunk_interval = std::chrono::milliseconds(number);
+        } else if (key == "chunk_jitter_ms") {
+            chunk_jitter = std::chrono::milliseconds(number);
+        } else if (key == "response_bytes_min") {
+            response_bytes_min = static_cast<size_t>(number);
+        } else if (key == "response_bytes_max") {
+            response_bytes_max = static_cast<size_t>(number);
+        } else if (key == "error_code") {
+            error_code = static_cast<int32_t>(number);
+        } else if (key == "seed") {
+            seed = static_cast<unsigned>(number);
+        } else {
+            *error = "Unknown mock setting \"" + key + "\"";
+            return false;
+        }
+        if (!valid) {
+            *error = "Invalid value for mock setting \"" + key + "\": " + value;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ParseMockProviders(const std::string& spec,
+                        std::vector<MockProviderSpec>* providers,
+                        std::string* error) {
+    providers->clear();
+    for (const std::string& entry : Split(spec, ',')) {
+        MockProviderSpec provider;
+        size_t colon = entry.find(':');
+        provider.id = entry.substr(0, colon);
+        provider.profile.seed = static_cast<unsigned>(providers->size() + 1);
+        if (provider.id.empty()) {
+            *error = "Missing provider ID in \"" + entry + "\"";
+            return false;
+        }
+        if (colon != std::string::npos && !provider.profile.Parse(entry.substr(colon + 1), error)) {
+            *error = provider.id + ": " + *error;
+            return false;
+        }
+        providers->push_back(std::move(provider));
+    }
+    if (providers->empty()) {
+        *error = "No mock providers given";
+        return false;
+    }
+    return true;
+}
+
+// Runs tasks at their due time on a thread of its own. Tasks still queued
+// when it is destroyed are dropped.
+class MockTextAdapter::Timer {
+public:
+    Timer() : thread_([this]() { Run(); }) {}
+
+    ~Timer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    void Schedule(Clock::time_point when, std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push(Task{when, next_sequence_++, std::move(task)});
+        }
+        wake_.notify_one();
+    }
+
+private:
+    struct Task {
+        Clock::time_point when;
+        uint64_t sequence; // Keeps tasks due at once in order
+        std::function<void()> run;
+    };
+
+    struct RunsLater {
+        bool operator()(const Task& a, const Task& b) const {
+            return a.when != b.when ? a.when > b.when : a.sequence > b.sequence;
+        }
+    };
+
+    void Run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopped_) {
+            if (tasks_.empty()) {
+                wake_.wait(lock);
+                continue;
+            }
+            Clock::time_point when = tasks_.top().when;
+            if (when > Clock::now()) {
+                wake_.wait_until(lock, when);
+                continue;
+            }
+            std::function<void()> run = std::move(const_cast<Task&>(tasks_.top()).run);
+            tasks_.pop();
+            lock.unlock();
+            run();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::priority_queue<Task, std::vector<Task>, RunsLater> tasks_;
+    uint64_t next_sequence_ = 0;
+    bool stopped_ = false;
+    std::thread thread_; // Last, so it starts once the rest is constructed
+};
+
+// A stream in progress. Only touched on the timer thread after it starts.
+struct MockTextAdapter::Stream {
+    std::vector<std::string> chunks;
+    size_t next_chunk = 0;
+    size_t bytes_sent = 0;
+    ipc::TokenUsage usage;
+    Clock::time_point deadline = Clock::time_point::max();
+    DeltaCallback on_delta;
+    StreamDoneCallback on_complete;
+};
+
+MockTextAdapter::MockTextAdapter(const MockProfile& profile)
+    : profile_(profile), random_(profile.seed), timer_(std::make_unique<Timer>()) {}
+
+MockTextAdapter::~MockTextAdapter() {
+    timer_.reset(); // Joins the timer thread before the rest goes away
+}
+
+bool MockTextAdapter::Initialize(const GeminiAdapterConfig& config) {
+    return true;
+}
+
+std::string MockTextAdapter::GetSummary(
+    const std::string& text,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    dashaibrowser::ipc::ErrorDetails* error_details) {
+    return AnswerBlocking(text, error_details);
+}
+
+std::string MockTextAdapter::TranslateText(
+    const std::string& text,
+    const std::string& source_lang_code,
+    const std::string& target_lang_code,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    dashaibrowser::ipc::ErrorDetails* error_details) {
+    return AnswerBlocking(text, error_details);
+}
+
+std::string MockTextAdapter::GenerateText(
+    const std::string& prompt,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    dashaibrowser::ipc::ErrorDetails* error_details) {
+    return AnswerBlocking(prompt, error_details);
+}
+
+void MockTextAdapter::GetSummaryAsync(
+    const std::string& text,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    TextCallback on_complete) {
+    Answer(text, options, std::move(on_complete));
+}
+
+void MockTextAdapter::TranslateTextAsync(
+    const std::string& text,
+    const std::string& source_lang_code,
+    const std::string& target_lang_code,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    TextCallback on_complete) {
+    Answer(text, options, std::move(on_complete));
+}
+
+void MockTextAdapter::GenerateTextAsync(
+    const std::string& prompt,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    TextCallback on_complete) {
+    Answer(prompt, options, std::move(on_complete));
+}
+
+void MockTextAdapter::StreamSummary(
+    const std::string& text,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    DeltaCallback on_delta,
+    StreamDoneCallback on_complete) {
+    StartStream(text, options, std::move(on_delta), std::move(on_complete));
+}
+
+void MockTextAdapter::StreamText(
+    const std::string& prompt,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const CallOptions& options,
+    DeltaCallback on_delta,
+    StreamDoneCallback on_complete) {
+    StartStream(prompt, options, std::move(on_delta), std::move(on_complete));
+}
+
+MockTextAdapter::Outcome MockTextAdapter::NextOutcome(const std::string& input, int timeout_ms) {
+    // Always draw the same values in the same order, so changing the error
+    // rate does not shift the latencies of the calls that succeed
+    Outcome outcome;
+    double failure_draw = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        outcome.latency = NextLatency();
+        failure_draw = std::uniform_real_distribution<double>(0.0, 1.0)(random_);
+        outcome.text = NextResponseText();
+    }
+
+    if (failure_draw < profile_.error_rate) {
+        outcome.text.clear();
+        outcome.error.set_error_code(profile_.error_code);
+        outcome.error.set_error_message("Mock provider failure (" + std::to_string(profile_.error_code) + ").");
+        outcome.error.set_user_facing_message("The AI service is temporarily unavailable.");
+        return outcome;
+    }
+
+    auto timeout = std::chrono::milliseconds(timeout_ms);
+    if (timeout_ms > 0 && outcome.latency > timeout) {
+        outcome.latency = timeout;
+        outcome.text.clear();
+        SetTimedOut(&outcome.error, "Mock provider timed out.");
+        return outcome;
+    }
+
+    outcome.usage.set_prompt_tokens(EstimateTokens(input.size()));
+    outcome.usage.set_completion_tokens(EstimateTokens(outcome.text.size()));
+    outcome.usage.set_total_tokens(outcome.usage.prompt_tokens() + outcome.usage.completion_tokens());
+    return outcome;
+}
+
+MockTextAdapter::Clock::duration MockTextAdapter::NextLatency() {
+    switch (profile_.latency_distribution) {
+        case MockProfile::LatencyDistribution::FIXED:
+            return profile_.latency_median;
+        case MockProfile::LatencyDistribution::UNIFORM: {
+            auto min_us = std::chrono::duration_cast<std::chrono::microseconds>(profile_.latency_min).count();
+            auto max_us = std::max<int64_t>(
+                min_us, std::chrono::duration_cast<std::chrono::microseconds>(profile_.latency_max).count());
+            return std::chrono::microseconds(std::uniform_int_distribution<int64_t>(min_us, max_us)(random_));
+        }
+        case MockProfile::LatencyDistribution::LOG_NORMAL: {
+            double median_ms = static_cast<double>(profile_.latency_median.count());
+            double p99_ms = static_cast<double>(profile_.latency_p99.count());
+            if (median_ms <= 0.0) {
+                return Clock::duration::zero();
+            }
+            double sigma = p99_ms > median_ms ? std::log(p99_ms / median_ms) / kP99ZScore : 0.0;
+            double latency_ms = std::lognormal_distribution<double>(std::log(median_ms), sigma)(random_);
+            return std::chrono::microseconds(static_cast<int64_t>(latency_ms * 1000.0));
+        }
+    }
+    return profile_.latency_median;
+}
+
+MockTextAdapter::Clock::duration MockTextAdapter::NextChunkDelay() {
+    auto jitter_us = std::chrono::duration_cast<std::chrono::microseconds>(profile_.chunk_jitter).count();
+    int64_t offset_us = 0;
+    if (jitter_us > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        offset_us = std::uniform_int_distribution<int64_t>(-jitter_us, jitter_us)(random_);
+    }
+    Clock::duration delay = profile_.chunk_interval + std::chrono::microseconds(offset_us);
+    return std::max(delay, Clock::duration::zero());
+}
+
+std::string MockTextAdapter::NextResponseText() {
+    size_t max_bytes = std::max(profile_.response_bytes_min, profile_.response_bytes_max);
+    size_t length = std::uniform_int_distribution<size_t>(profile_.response_bytes_min, max_bytes)(random_);
+
+    std::string text;
+    text.reserve(length + 16);
+    std::uniform_int_distribution<size_t> word(0, std::size(kWords) - 1);
+    while (text.size() < length) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += kWords[word(random_)];
+    }
+    text.resize(length);
+    return text;
+}
+
+void MockTextAdapter::Answer(const std::string& input, const CallOptions& options, TextCallback on_complete) {
+    Outcome outcome = NextOutcome(input, options.timeout_ms);
+    Clock::time_point due = Clock::now() + outcome.latency;
+    std::shared_ptr<CallTrace> trace = options.trace;
+    auto answer = std::make_shared<Outcome>(std::move(outcome));
+    timer_->Schedule(due, [answer, trace, on_complete = std::move(on_complete)]() {
+        if (trace && answer->error.error_code() == 0) {
+            trace->usage = answer->usage;
+        }
+        on_complete(std::move(answer->text), std::move(answer->error));
+    });
+}
+
+void MockTextAdapter::StartStream(const std::string& input,
+                                  const CallOptions& options,
+                                  DeltaCallback on_delta,
+                                  StreamDoneCallback on_complete) {
+    // Only the caller's deadline bounds a stream, as with the real adapter,
+    // so the outcome itself is drawn without a timeout
+    Outcome outcome = NextOutcome(input, 0);
+    Clock::time_point now = Clock::now();
+
+    auto stream = std::make_shared<Stream>();
+    if (options.timeout_ms > 0) {
+        stream->deadline = now + std::chrono::milliseconds(options.timeout_ms);
+    }
+    stream->on_delta = std::move(on_delta);
+    stream->on_complete = std::move(on_complete);
+
+    if (outcome.error.error_code() != 0) {
+        auto error = std::make_shared<ipc::ErrorDetails>(std::move(outcome.error));
+        timer_->Schedule(now + outcome.latency,
+                         [stream, error]() { stream->on_complete(ipc::TokenUsage(), std::move(*error)); });
+        return;
+    }
+
+    size_t chunk_bytes = std::max<size_t>(1, profile_.chunk_bytes);
+    for (size_t offset = 0; offset < outcome.text.size(); offset += chunk_bytes) {
+        stream->chunks.push_back(outcome.text.substr(offset, chunk_bytes));
+    }
+    stream->usage = outcome.usage;
+    timer_->Schedule(std::min(now + outcome.latency, stream->deadline),
+                     [this, stream]() { DeliverChunk(stream); });
+}
+
+void MockTextAdapter::DeliverChunk(std::shared_ptr<Stream> stream) {
+    Clock::time_point now = Clock::now();
+    if (now >= stream->deadline) {
+        ipc::ErrorDetails error_details;
+        SetTimedOut(&error_details, "Mock provider stream timed out.");
+        stream->on_complete(ipc::TokenUsage(), std::move(error_details));
+        return;
+    }
+
+    if (stream->next_chunk < stream->chunks.size()) {
+        const std::string& delta = stream->chunks[stream->next_chunk++];
+        stream->bytes_sent += delta.size();
+        if (!stream->on_delta(delta, EstimateTokens(stream->bytes_sent))) {
+            // Reported as the real adapter reports an aborted transfer
+            ipc::ErrorDetails error_details;
+            SetTimedOut(&error_details, "Mock provider stream stopped by the caller.");
+            stream->on_complete(ipc::TokenUsage(), std::move(error_details));
+            return;
+        }
+    }
+
+    if (stream->next_chunk >= stream->chunks.size()) {
+        stream->on_complete(stream->usage, ipc::ErrorDetails());
+        return;
+    }
+    timer_->Schedule(std::min(now + NextChunkDelay(), stream->deadline),
+                     [this, stream]() { DeliverChunk(stream); });
+}
+
+std::string MockTextAdapter::AnswerBlocking(const std::string& input, ipc::ErrorDetails* error_details) {
+    Outcome outcome = NextOutcome(input, 0);
+    std::this_thread::sleep_for(outcome.latency);
+    if (error_details) {
+        *error_details = std::move(outcome.error);
+    }
+    return std::move(outcome.text);
+}
+
+} // namespace adapters
+} // namespace asol
+} // namespace dashaibrowser
@@ -0,0 +1,193 @@
+#ifndef DASHAI_BROWSER_ASOL_ADAPTERS_MOCK_MOCK_TEXT_ADAPTER_H_
+#define DASHAI_BROWSER_ASOL_ADAPTERS_MOCK_MOCK_TEXT_ADAPTER_H_
+
+#include "asol/adapters/gemini/gemini_text_adapter.h" // For IGeminiTextAdapter
+#include "proto/asol_service.pb.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace dashaibrowser {
+namespace asol {
+namespace adapters {
+
+// How a mock provider behaves. Mirrors asol::adapters::mock::MockProfile
+// of the browser-side adapters, with the same setting names.
+struct MockProfile {
+    enum class LatencyDistribution { FIXED, UNIFORM, LOG_NORMAL };
+
+    // Time to the complete response, or to the first delta of a stream.
+    // FIXED: every call takes latency_median. UNIFORM: drawn from
+    // [latency_min, latency_max]. LOG_NORMAL: heavy-tailed like real
+    // providers, with the given median and 99th percentile.
+    LatencyDistribution latency_distribution = LatencyDistribution::LOG_NORMAL;
+    std::chrono::milliseconds latency_median{400};
+    std::chrono::milliseconds latency_p99{2000};
+    std::chrono::milliseconds latency_min{200};
+    std::chrono::milliseconds latency_max{800};
+
+    // Streams send chunk_bytes at a time, chunk_interval apart after the
+    // first delta, each interval off by up to chunk_jitter either way
+    size_t chunk_bytes = 16;
+    std::chrono::milliseconds chunk_interval{20};
+    std::chrono::milliseconds chunk_jitter{5};
+
+    // Response length, drawn uniformly
+    size_t response_bytes_min = 200;
+    size_t response_bytes_max = 1200;
+
+    // Share of calls that fail with error_code after the drawn latency.
+    // 503 is one the router falls back on.
+    double error_rate = 0.0;
+    int32_t error_code = 503;
+
+    // Seeds the draws: the same seed and call order give the same outcomes
+    unsigned seed = 1;
+
+    // Apply "key=value" settings separated by ':', e.g.
+    // "latency_ms=300:error_rate=0.01". Keys: latency_distribution
+    // (fixed, uniform, lognormal), latency_ms, latency_p99_ms,
+    // latency_min_ms, latency_max_ms, chunk_bytes, chunk_interval_ms,
+    // chunk_jitter_ms, response_bytes_min, response_bytes_max, error_rate,
+    // error_code and seed. False with |error| set on an unknown key or a bad
+    // value.
+    bool Parse(const std::string& settings, std::string* error);
+};
+
+// One provider of the gateway's --mock-providers flag
+struct MockProviderSpec {
+    std::string id;
+    MockProfile profile;
+};
+
+// Parse "ID[:key=value...][,ID[:key=value...]...]", e.g.
+// "mock-fast:latency_ms=200,mock-slow:latency_ms=900:error_rate=0.05".
+// Each provider without a seed gets its own, so they do not fail together.
+bool ParseMockProviders(const std::string& spec,
+                        std::vector<MockProviderSpec>* providers,
+                        std::string* error);
+
+// A text adapter that answers without the network, after latencies drawn
+// from a MockProfile, so the gateway's admission control, routing, caching
+// and streaming can be load tested deterministically and for free. Calls
+// are answered from a timer thread of the adapter's own, so any number can
+// be in flight, as with the real adapter's event loop. Token usage is
+// estimated at four bytes per token. Calls not answered when the adapter
+// is destroyed are dropped.
+class MockTextAdapter : public IGeminiTextAdapter {
+public:
+    explicit MockTextAdapter(const MockProfile& profile);
+    ~MockTextAdapter() override;
+
+    MockTextAdapter(const MockTextAdapter&) = delete;
+    MockTextAdapter& operator=(const MockTextAdapter&) = delete;
+
+    // Nothing to configure; always succeeds.
+    bool Initialize(const GeminiAdapterConfig& config) override;
+
+    // The blocking calls sleep for the drawn latency.
+    std::string GetSummary(
+        const std::string& text,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        dashaibrowser::ipc::ErrorDetails* error_details
+    ) override;
+
+    std::string TranslateText(
+        const std::string& text,
+        const std::string& source_lang_code,
+        const std::string& target_lang_code,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        dashaibrowser::ipc::ErrorDetails* error_details
+    ) override;
+
+    std::string GenerateText(
+        const std::string& prompt,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        dashaibrowser::ipc::ErrorDetails* error_details
+    ) override;
+
+    void GetSummaryAsync(
+        const std::string& text,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        TextCallback on_complete
+    ) override;
+
+    void TranslateTextAsync(
+        const std::string& text,
+        const std::string& source_lang_code,
+        const std::string& target_lang_code,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        TextCallback on_complete
+    ) override;
+
+    void GenerateTextAsync(
+        const std::string& prompt,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        TextCallback on_complete
+    ) override;
+
+    void StreamSummary(
+        const std::string& text,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        DeltaCallback on_delta,
+        StreamDoneCallback on_complete
+    ) override;
+
+    void StreamText(
+        const std::string& prompt,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const CallOptions& options,
+        DeltaCallback on_delta,
+        StreamDoneCallback on_complete
+    ) override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Outcome of one simulated call
+    struct Outcome {
+        Clock::duration latency{};
+        std::string text;         // Empty on failure
+        ipc::ErrorDetails error;  // error_code 0 on success
+        ipc::TokenUsage usage;
+    };
+
+    class Timer;
+    struct Stream;
+
+    // Draw the outcome of a call on |input|, failing it with a timeout if it
+    // would outlast |timeout_ms| (0 for none).
+    Outcome NextOutcome(const std::string& input, int timeout_ms);
+    Clock::duration NextLatency();             // Requires mutex_
+    Clock::duration NextChunkDelay();
+    std::string NextResponseText();            // Requires mutex_
+
+    void Answer(const std::string& input, const CallOptions& options, TextCallback on_complete);
+    void StartStream(const std::string& input,
+                     const CallOptions& options,
+                     DeltaCallback on_delta,
+                     StreamDoneCallback on_complete);
+    void DeliverChunk(std::shared_ptr<Stream> stream);
+    std::string AnswerBlocking(const std::string& input, ipc::ErrorDetails* error_details);
+
+    const MockProfile profile_;
+    std::mutex mutex_;
+    std::mt19937 random_;
+    // Destroyed first, so no callback runs on a half-destroyed adapter
+    std::unique_ptr<Timer> timer_;
+};
+
+} // namespace adapters
+} // namespace asol
+} // namespace dashaibrowser
+
+#endif // DASHAI_BROWSER_ASOL_ADAPTERS_MOCK_MOCK_TEXT_ADAPTER_H_
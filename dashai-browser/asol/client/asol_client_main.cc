@@ -3,10 +3,13 @@
 #include <memory>
 #include <vector>
 #include <chrono> // For timeouts
+#include <cstdlib> // For std::atoi, std::atof
 #include <ctime>  // For time for request ID
 
 #include <grpcpp/grpcpp.h>
 #include "proto/asol_service.grpc.pb.h" // Generated gRPC classes
+#include "asol/client/load_generator.h"
+#include "asol/cpp/utils/shared_memory_text.h"
 
 // Helper function to generate a unique request ID (simple version)
 std::string GenerateRequestID(const std::string& prefix = "req") {
@@ -19,11 +22,15 @@ public:
     AsolClient(std::shared_ptr<grpc::Channel> channel)
         : stub_(dashaibrowser::ipc::AsolInterface::NewStub(channel)) {}
 
+    // Hand texts to summarize over in shared memory instead of inline.
+    // Only works against a gateway on this host.
+    void set_use_shared_memory(bool use_shared_memory) { use_shared_memory_ = use_shared_memory; }
+
     // Calls the GetSummary RPC
     void GetSummary(const std::string& text_to_summarize) {
         dashaibrowser::ipc::SummaryRequest request;
         request.set_request_id(GenerateRequestID("summary"));
-        request.set_original_text(text_to_summarize);
+        auto shared_text = SetOriginalText(text_to_summarize, &request);
 
         dashaibrowser::ipc::SummaryResponse response;
         grpc::ClientContext context;
@@ -67,7 +74,107 @@ public:
         }
     }
 
+    // Calls the StreamSummary RPC, printing the summary as it is generated
+    void StreamSummary(const std::string& text_to_summarize) {
+        dashaibrowser::ipc::SummaryRequest request;
+        request.set_request_id(GenerateRequestID("summary"));
+        auto shared_text = SetOriginalText(text_to_summarize, &request);
+
+        grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(60));
+
+        std::cout << "\n[Client] Sending StreamSummary request..." << std::endl;
+        std::cout << "[Client] Summary: " << std::flush;
+        std::unique_ptr<grpc::ClientReader<dashaibrowser::ipc::CompletionChunk>> reader(
+            stub_->StreamSummary(&context, request));
+        RenderStream("StreamSummary", reader.get());
+    }
+
+    // Calls the StreamChat RPC, printing Jules's reply as it is generated.
+    // Returns the full reply.
+    std::string StreamChat(const std::string& user_message, const std::string& session_id, const std::vector<std::string>& history) {
+        dashaibrowser::ipc::ConversationRequest request;
+        request.set_request_id(GenerateRequestID("chat"));
+        request.set_session_id(session_id);
+        request.set_user_message(user_message);
+        for(const auto& hist_item : history) {
+            request.add_history(hist_item);
+        }
+
+        grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(60));
+
+        std::cout << "Jules: " << std::flush;
+        std::unique_ptr<grpc::ClientReader<dashaibrowser::ipc::CompletionChunk>> reader(
+            stub_->StreamChat(&context, request));
+        return RenderStream("StreamChat", reader.get());
+    }
+
 private:
+    // Put |text| into |request|, in shared memory when enabled. The
+    // returned buffer, if any, must outlive the RPC.
+    std::unique_ptr<dashaibrowser::asol::utils::SharedTextBuffer> SetOriginalText(
+        const std::string& text, dashaibrowser::ipc::SummaryRequest* request) {
+        std::unique_ptr<dashaibrowser::asol::utils::SharedTextBuffer> buffer;
+        if (use_shared_memory_) {
+            buffer = dashaibrowser::asol::utils::SharedTextBuffer::Create(text);
+        }
+        if (!buffer) {
+            request->set_original_text(text);
+            return nullptr;
+        }
+        dashaibrowser::ipc::SharedMemoryText* shm = request->mutable_original_text_shm();
+        shm->set_pid(buffer->pid());
+        shm->set_fd(buffer->fd());
+        shm->set_size(buffer->size());
+        return buffer;
+    }
+
+    // Print each delta as it arrives, then the usage and time to first
+    // token. Returns the accumulated text.
+    std::string RenderStream(const std::string& rpc_name,
+                             grpc::ClientReader<dashaibrowser::ipc::CompletionChunk>* reader) {
+        auto start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::duration first_token_latency{};
+        bool got_text = false;
+        std::string text;
+        dashaibrowser::ipc::CompletionChunk chunk;
+        dashaibrowser::ipc::CompletionChunk final_chunk;
+        while (reader->Read(&chunk)) {
+            if (!chunk.text_delta().empty()) {
+                if (!got_text) {
+                    first_token_latency = std::chrono::steady_clock::now() - start;
+                    got_text = true;
+                }
+                std::cout << chunk.text_delta() << std::flush;
+                text += chunk.text_delta();
+            }
+            if (chunk.is_final()) {
+                final_chunk = chunk;
+            }
+        }
+        std::cout << std::endl;
+
+        grpc::Status status = reader->Finish();
+        if (!status.ok() || final_chunk.has_error_details()) {
+            PrintRpcError(rpc_name, status, final_chunk.has_error_details() ? &final_chunk.error_details() : nullptr);
+            return text;
+        }
+        if (got_text) {
+            std::cout << "[Client] First token after "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(first_token_latency).count() << " ms";
+        }
+        if (final_chunk.has_usage()) {
+            std::cout << (got_text ? ", " : "[Client] ") << "tokens: "
+                      << final_chunk.usage().prompt_tokens() << " prompt, "
+                      << final_chunk.usage().completion_tokens() << " completion";
+        }
+        if (got_text || final_chunk.has_usage()) {
+            std::cout << std::endl;
+        }
+        return text;
+    }
+
     void PrintRpcError(const std::string& rpc_name, const grpc::Status& status, const dashaibrowser::ipc::ErrorDetails* details) {
         std::cerr << "[Client] " << rpc_name << " RPC failed." << std::endl;
         if (!status.ok()) {
@@ -87,15 +194,16 @@ private:
     }
 
     std::unique_ptr<dashaibrowser::ipc::AsolInterface::Stub> stub_;
+    bool use_shared_memory_ = false;
 };
 
-void RunChatSession(AsolClient& client) {
+void RunChatSession(AsolClient& client, bool stream) {
     std::cout << "\nStarting interactive chat session with Jules." << std::endl;
     std::cout << "Type 'quit' or 'exit' to end the session." << std::endl;
 
     std::string user_input;
     std::string session_id = GenerateRequestID("session"); // Simple session ID for this run
-    std::vector<std::string> chat_history; // Simple history
+    std::vector<std::string> chat_history; // Kept by the gateway instead
 
     while (true) {
         std::cout << "You: ";
@@ -109,33 +217,74 @@ void RunChatSession(AsolClient& client) {
             continue;
         }
 
-        // Add to history before sending (optional, for more advanced context)
-        // For now, server-side prompt prepends "User: "
-        // chat_history.push_back("User: " + user_input);
-
-        client.ChatWithJules(user_input, session_id, chat_history);
+        // The gateway keeps this session's history, so only the new turn is
+        // sent; |chat_history| stays empty.
 
-        // If server sent back its response, we could add it to history for next turn
-        // chat_history.push_back("Jules: " + <actual_response_from_server>);
-        // Keep history size manageable if used:
-        // if (chat_history.size() > 10) { chat_history.erase(chat_history.begin(), chat_history.begin() + chat_history.size() - 10); }
+        if (stream) {
+            client.StreamChat(user_input, session_id, chat_history);
+        } else {
+            client.ChatWithJules(user_input, session_id, chat_history);
+        }
     }
 }
 
 
-int main(int argc, char** argv) {
-    std::string target_str = "localhost:50051";
-    if (argc > 1 && std::string(argv[1]) != "--chat") { // Basic arg parsing
-        target_str = argv[1];
+// The value of "--name=value" in |arg|, if |arg| is that flag.
+bool FlagValue(const std::string& arg, const std::string& name, std::string* value) {
+    std::string prefix = "--" + name + "=";
+    if (arg.rfind(prefix, 0) != 0) {
+        return false;
     }
+    *value = arg.substr(prefix.size());
+    return true;
+}
 
+int main(int argc, char** argv) {
+    // Usage: asol_client [target] [--chat] [--unary] [--shm]
+    //        asol_client [target] --bench [--rpc=stream-summary] [--qps=N | --concurrency=N]
+    //                    [--duration=S] [--warmup=S] [--deadline-ms=N] [--prompts=FILE]
+    //                    [--provider=ID] [--repeat-prompts] [--shm]
+    std::string target_str = "localhost:50051";
     bool run_chat_mode = false;
-    if (argc > 1) {
-        for (int i = 1; i < argc; ++i) {
-            if (std::string(argv[i]) == "--chat") {
-                run_chat_mode = true;
-                break;
+    bool run_benchmark = false;
+    bool stream = true; // --unary waits for whole completions instead
+    bool use_shared_memory = false; // --shm: texts in shared memory, for a local gateway
+    dashaibrowser::asol::LoadGenerator::Config bench_config;
+    for (int i = 1; i < argc; ++i) { // Basic arg parsing
+        std::string arg = argv[i];
+        std::string value;
+        if (arg == "--chat") {
+            run_chat_mode = true;
+        } else if (arg == "--unary") {
+            stream = false;
+        } else if (arg == "--shm") {
+            use_shared_memory = true;
+        } else if (arg == "--bench") {
+            run_benchmark = true;
+        } else if (FlagValue(arg, "rpc", &value)) {
+            if (!dashaibrowser::asol::LoadGenerator::ParseRpc(value, &bench_config.rpc)) {
+                std::cerr << "Unknown --rpc " << value
+                          << "; use summary, stream-summary, translate, chat or stream-chat." << std::endl;
+                return 1;
             }
+        } else if (FlagValue(arg, "qps", &value)) {
+            bench_config.qps = std::atof(value.c_str());
+        } else if (FlagValue(arg, "concurrency", &value)) {
+            bench_config.concurrency = std::atoi(value.c_str());
+        } else if (FlagValue(arg, "duration", &value)) {
+            bench_config.duration = std::chrono::seconds(std::atoi(value.c_str()));
+        } else if (FlagValue(arg, "warmup", &value)) {
+            bench_config.warmup = std::chrono::seconds(std::atoi(value.c_str()));
+        } else if (FlagValue(arg, "deadline-ms", &value)) {
+            bench_config.deadline = std::chrono::milliseconds(std::atoi(value.c_str()));
+        } else if (FlagValue(arg, "prompts", &value)) {
+            bench_config.prompts_file = value;
+        } else if (FlagValue(arg, "provider", &value)) {
+            bench_config.preferred_provider = value;
+        } else if (arg == "--repeat-prompts") {
+            bench_config.unique_prompts = false; // Let the gateway's cache answer repeats
+        } else {
+            target_str = arg;
         }
     }
 
@@ -148,12 +297,23 @@ int main(int argc, char** argv) {
     }
     std::cout << "[Client] Connecting to ASOL Gateway at " << target_str << std::endl;
 
+    if (run_benchmark) {
+        bench_config.use_shared_memory = use_shared_memory;
+        dashaibrowser::asol::LoadGenerator generator(channel, bench_config);
+        if (!generator.Init()) {
+            return 1;
+        }
+        return generator.Run() ? 0 : 1;
+    }
+
     AsolClient client(channel);
+    client.set_use_shared_memory(use_shared_memory);
 
     if (run_chat_mode) {
-        RunChatSession(client);
+        RunChatSession(client, stream);
     } else {
-        std::cout << "\nRunning GetSummary example. Use --chat for interactive mode." << std::endl;
+        std::cout << "\nRunning " << (stream ? "StreamSummary" : "GetSummary")
+                  << " example. Use --chat for interactive mode." << std::endl;
         std::string sample_text_long =
             "The James Webb Space Telescope (JWST) is a space telescope designed primarily to conduct infrared astronomy. "
             "As the largest optical telescope in space, its high infrared resolution and sensitivity allow it to view objects "
@@ -164,7 +324,11 @@ int main(int argc, char** argv) {
             "Sun–Earth L2 Lagrange point in January 2022. The first JWST image was released to the public via a press "
             "conference on 11 July 2022. The telescope is the successor of the Hubble Space Telescope and is a flagship "
             "mission of NASA in partnership with the European Space Agency (ESA) and the Canadian Space Agency (CSA).";
-        client.GetSummary(sample_text_long);
+        if (stream) {
+            client.StreamSummary(sample_text_long);
+        } else {
+            client.GetSummary(sample_text_long);
+        }
     }
 
 
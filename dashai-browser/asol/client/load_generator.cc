@@ -0,0 +1,538 @@
+#include "asol/client/load_generator.h"
+#include <algorithm> // For std::sort
+#include <cmath>     // For the log-uniform prompt sizes
+#include <fstream>
+#include <functional>
+#include <iomanip>   // For the report
+#include <iostream>
+#include <utility>
+
+namespace dashaibrowser {
+namespace asol {
+
+namespace {
+
+const char* const kStatusCodeNames[] = {
+    "OK", "CANCELLED", "UNKNOWN", "INVALID_ARGUMENT", "DEADLINE_EXCEEDED", "NOT_FOUND",
+    "ALREADY_EXISTS", "PERMISSION_DENIED", "RESOURCE_EXHAUSTED", "FAILED_PRECONDITION",
+    "ABORTED", "OUT_OF_RANGE", "UNIMPLEMENTED", "INTERNAL", "UNAVAILABLE", "DATA_LOSS",
+    "UNAUTHENTICATED",
+};
+
+std::string StatusName(::grpc::StatusCode code) {
+    size_t index = static_cast<size_t>(code);
+    return index < sizeof(kStatusCodeNames) / sizeof(kStatusCodeNames[0]) ? kStatusCodeNames[index]
+                                                                          : "CODE_" + std::to_string(index);
+}
+
+// "ASOL <code>" for an error reported in the response
+std::string AsolErrorName(const ipc::ErrorDetails& error_details) {
+    return "ASOL " + std::to_string(error_details.error_code());
+}
+
+// Share of browser pages by text size: mostly snippets and articles, with
+// a tail of long pages. Sizes are log-uniform within each range.
+struct SizeBand {
+    double share;
+    size_t min_bytes;
+    size_t max_bytes;
+};
+const SizeBand kSyntheticSizes[] = {
+    {0.50, 512, 2048},
+    {0.35, 2048, 16384},
+    {0.15, 16384, 65536},
+};
+
+double Milliseconds(LoadGenerator::Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// Nearest-rank percentile of sorted |values|
+double Percentile(const std::vector<double>& values, double percentile) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t rank = static_cast<size_t>(percentile / 100.0 * static_cast<double>(values.size()));
+    return values[std::min(rank, values.size() - 1)];
+}
+
+void PrintPercentiles(const char* label, std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    std::cout << "  " << std::left << std::setw(14) << label << std::right << std::fixed << std::setprecision(1)
+              << "p50 " << Percentile(values, 50) << "  p90 " << Percentile(values, 90)
+              << "  p99 " << Percentile(values, 99) << "  p99.9 " << Percentile(values, 99.9)
+              << "  max " << (values.empty() ? 0 : values.back()) << std::endl;
+}
+
+} // namespace
+
+// An RPC in flight on the completion queue; its address is the tag.
+class LoadGenerator::Call {
+public:
+    virtual ~Call() = default;
+
+    // |ok| as returned by CompletionQueue::Next()
+    virtual void Proceed(bool ok) = 0;
+};
+
+template <typename Response>
+class LoadGenerator::UnaryCall : public Call {
+public:
+    using Starter = std::function<std::unique_ptr<::grpc::ClientAsyncResponseReader<Response>>(
+        ::grpc::ClientContext*, ::grpc::CompletionQueue*)>;
+
+    UnaryCall(LoadGenerator* generator,
+              Clock::time_point scheduled,
+              Sample sample,
+              std::unique_ptr<utils::SharedTextBuffer> shared_text)
+        : generator_(generator),
+          scheduled_(scheduled),
+          sample_(std::move(sample)),
+          shared_text_(std::move(shared_text)) {
+        context_.set_deadline(std::chrono::system_clock::now() + generator_->config_.deadline);
+    }
+
+    void Start(const Starter& starter) {
+        reader_ = starter(&context_, &generator_->cq_);
+        reader_->StartCall();
+        reader_->Finish(&response_, &status_, this);
+    }
+
+    void Proceed(bool ok) override {
+        sample_.latency = Clock::now() - scheduled_;
+        sample_.response_bytes = response_.ByteSizeLong();
+        if (!status_.ok()) {
+            sample_.error = StatusName(status_.error_code());
+        } else if (!response_.success()) {
+            sample_.error = AsolErrorName(response_.error_details());
+        }
+        generator_->OnCallDone(scheduled_, std::move(sample_));
+        delete this;
+    }
+
+private:
+    LoadGenerator* const generator_;
+    const Clock::time_point scheduled_;
+    Sample sample_;
+    std::unique_ptr<utils::SharedTextBuffer> shared_text_; // Read by the gateway during the call
+    ::grpc::ClientContext context_;
+    std::unique_ptr<::grpc::ClientAsyncResponseReader<Response>> reader_;
+    Response response_;
+    ::grpc::Status status_;
+};
+
+class LoadGenerator::StreamCall : public Call {
+public:
+    using Starter = std::function<std::unique_ptr<::grpc::ClientAsyncReader<ipc::CompletionChunk>>(
+        ::grpc::ClientContext*, ::grpc::CompletionQueue*)>;
+
+    StreamCall(LoadGenerator* generator,
+               Clock::time_point scheduled,
+               Sample sample,
+               std::unique_ptr<utils::SharedTextBuffer> shared_text)
+        : generator_(generator),
+          scheduled_(scheduled),
+          sample_(std::move(sample)),
+          shared_text_(std::move(shared_text)) {
+        context_.set_deadline(std::chrono::system_clock::now() + generator_->config_.deadline);
+    }
+
+    void Start(const Starter& starter) {
+        reader_ = starter(&context_, &generator_->cq_);
+        reader_->StartCall(this);
+    }
+
+    void Proceed(bool ok) override {
+        switch (state_) {
+            case State::STARTING:
+            case State::READING:
+                if (ok && state_ == State::READING) {
+                    OnChunk();
+                }
+                if (ok) {
+                    state_ = State::READING;
+                    reader_->Read(&chunk_, this);
+                    return;
+                }
+                // The stream ended
+                state_ = State::FINISHING;
+                reader_->Finish(&status_, this);
+                return;
+            case State::FINISHING:
+                sample_.latency = Clock::now() - scheduled_;
+                if (!status_.ok()) {
+                    sample_.error = StatusName(status_.error_code());
+                } else {
+                    sample_.error = final_error_;
+                }
+                generator_->OnCallDone(scheduled_, std::move(sample_));
+                delete this;
+                return;
+        }
+    }
+
+private:
+    enum class State { STARTING, READING, FINISHING };
+
+    void OnChunk() {
+        sample_.response_bytes += chunk_.ByteSizeLong();
+        if (!chunk_.text_delta().empty() && !sample_.has_first_token) {
+            sample_.has_first_token = true;
+            sample_.first_token_latency = Clock::now() - scheduled_;
+        }
+        if (chunk_.is_final() && chunk_.has_error_details()) {
+            final_error_ = AsolErrorName(chunk_.error_details());
+        }
+    }
+
+    LoadGenerator* const generator_;
+    const Clock::time_point scheduled_;
+    Sample sample_;
+    std::unique_ptr<utils::SharedTextBuffer> shared_text_; // Read by the gateway during the call
+    ::grpc::ClientContext context_;
+    std::unique_ptr<::grpc::ClientAsyncReader<ipc::CompletionChunk>> reader_;
+    ipc::CompletionChunk chunk_;
+    std::string final_error_; // From the final chunk
+    ::grpc::Status status_;
+    State state_ = State::STARTING;
+};
+
+LoadGenerator::LoadGenerator(std::shared_ptr<::grpc::Channel> channel, const Config& config)
+    : config_(config),
+      stub_(ipc::AsolInterface::NewStub(channel)),
+      random_(config.seed) {}
+
+LoadGenerator::~LoadGenerator() {
+    if (!cq_shut_down_) {
+        cq_.Shutdown();
+        void* tag = nullptr;
+        bool ok = false;
+        while (cq_.Next(&tag, &ok)) {
+        }
+    }
+}
+
+bool LoadGenerator::ParseRpc(const std::string& name, Rpc* rpc) {
+    const struct {
+        const char* name;
+        Rpc rpc;
+    } kRpcs[] = {
+        {"summary", Rpc::SUMMARY},
+        {"stream-summary", Rpc::STREAM_SUMMARY},
+        {"translate", Rpc::TRANSLATE},
+        {"chat", Rpc::CHAT},
+        {"stream-chat", Rpc::STREAM_CHAT},
+    };
+    for (const auto& entry : kRpcs) {
+        if (name == entry.name) {
+            *rpc = entry.rpc;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LoadGenerator::Init() {
+    if (config_.prompts_file.empty()) {
+        return true;
+    }
+    std::ifstream file(config_.prompts_file);
+    if (!file) {
+        std::cerr << "[Bench] Cannot read prompts from " << config_.prompts_file << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::string prompt;
+        for (size_t i = 0; i < line.size(); ++i) {
+            if (line[i] == '\\' && i + 1 < line.size() && line[i + 1] == 'n') {
+                prompt += '\n';
+                ++i;
+            } else {
+                prompt += line[i];
+            }
+        }
+        prompts_.push_back(std::move(prompt));
+    }
+    if (prompts_.empty()) {
+        std::cerr << "[Bench] No prompts in " << config_.prompts_file << std::endl;
+        return false;
+    }
+    std::cout << "[Bench] Loaded " << prompts_.size() << " prompts from " << config_.prompts_file << std::endl;
+    return true;
+}
+
+std::string LoadGenerator::SyntheticText(size_t bytes, std::mt19937* random) {
+    static const char* const kWords[] = {
+        "the", "telescope", "observed", "distant", "galaxies", "and", "measured", "their", "light",
+        "across", "infrared", "wavelengths", "while", "researchers", "compared", "results", "with",
+        "earlier", "models", "of", "star", "formation", "in", "the", "early", "universe",
+    };
+    constexpr size_t kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+    std::uniform_int_distribution<size_t> word(0, kWordCount - 1);
+    std::string text;
+    text.reserve(bytes + 16);
+    size_t sentence_words = 0;
+    while (text.size() < bytes) {
+        text += kWords[word(*random)];
+        if (++sentence_words == 12) {
+            text += ". ";
+            sentence_words = 0;
+        } else {
+            text += ' ';
+        }
+    }
+    return text;
+}
+
+std::string LoadGenerator::NextPrompt(uint64_t call_id) {
+    std::string prompt;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!prompts_.empty()) {
+            prompt = prompts_[std::uniform_int_distribution<size_t>(0, prompts_.size() - 1)(random_)];
+        } else {
+            double pick = std::uniform_real_distribution<double>(0, 1)(random_);
+            const SizeBand* band = &kSyntheticSizes[0];
+            for (const SizeBand& candidate : kSyntheticSizes) {
+                band = &candidate;
+                if ((pick -= candidate.share) < 0) {
+                    break;
+                }
+            }
+            double log_bytes = std::uniform_real_distribution<double>(
+                std::log(static_cast<double>(band->min_bytes)),
+                std::log(static_cast<double>(band->max_bytes)))(random_);
+            prompt = SyntheticText(static_cast<size_t>(std::exp(log_bytes)), &random_);
+        }
+    }
+    if (config_.unique_prompts) {
+        prompt = "[" + std::to_string(call_id) + "] " + prompt;
+    }
+    return prompt;
+}
+
+void LoadGenerator::StartCall(Clock::time_point scheduled) {
+    uint64_t call_id = next_call_++;
+    std::string prompt = NextPrompt(call_id);
+    Sample sample;
+    sample.prompt_bytes = prompt.size();
+    std::string request_id = "bench_" + std::to_string(call_id);
+    ipc::UserPreferences preferences;
+    if (!config_.preferred_provider.empty()) {
+        preferences.set_preferred_provider(config_.preferred_provider);
+    }
+
+    switch (config_.rpc) {
+        case Rpc::SUMMARY:
+        case Rpc::STREAM_SUMMARY: {
+            ipc::SummaryRequest request;
+            request.set_request_id(request_id);
+            *request.mutable_preferences() = preferences;
+            std::unique_ptr<utils::SharedTextBuffer> shared_text;
+            if (config_.use_shared_memory) {
+                shared_text = utils::SharedTextBuffer::Create(prompt);
+            }
+            if (shared_text) {
+                ipc::SharedMemoryText* shm = request.mutable_original_text_shm();
+                shm->set_pid(shared_text->pid());
+                shm->set_fd(shared_text->fd());
+                shm->set_size(shared_text->size());
+            } else {
+                request.set_original_text(prompt);
+            }
+            if (config_.rpc == Rpc::SUMMARY) {
+                auto* call = new UnaryCall<ipc::SummaryResponse>(this, scheduled, std::move(sample),
+                                                                 std::move(shared_text));
+                call->Start([this, &request](auto* context, auto* cq) {
+                    return stub_->PrepareAsyncGetSummary(context, request, cq);
+                });
+            } else {
+                auto* call = new StreamCall(this, scheduled, std::move(sample), std::move(shared_text));
+                call->Start([this, &request](auto* context, auto* cq) {
+                    return stub_->PrepareAsyncStreamSummary(context, request, cq);
+                });
+            }
+            return;
+        }
+        case Rpc::TRANSLATE: {
+            ipc::TranslationRequest request;
+            request.set_request_id(request_id);
+            request.set_text_to_translate(prompt);
+            request.set_source_language_code("en");
+            request.set_target_language_code("es");
+            *request.mutable_preferences() = preferences;
+            auto* call = new UnaryCall<ipc::TranslationResponse>(this, scheduled, std::move(sample), nullptr);
+            call->Start([this, &request](auto* context, auto* cq) {
+                return stub_->PrepareAsyncTranslateText(context, request, cq);
+            });
+            return;
+        }
+        case Rpc::CHAT:
+        case Rpc::STREAM_CHAT: {
+            // No session_id: each call is a first turn, so the prompt size
+            // stays as recorded rather than growing with history
+            ipc::ConversationRequest request;
+            request.set_request_id(request_id);
+            request.set_user_message(prompt);
+            *request.mutable_preferences() = preferences;
+            if (config_.rpc == Rpc::CHAT) {
+                auto* call = new UnaryCall<ipc::ConversationResponse>(this, scheduled, std::move(sample), nullptr);
+                call->Start([this, &request](auto* context, auto* cq) {
+                    return stub_->PrepareAsyncChatWithJules(context, request, cq);
+                });
+            } else {
+                auto* call = new StreamCall(this, scheduled, std::move(sample), nullptr);
+                call->Start([this, &request](auto* context, auto* cq) {
+                    return stub_->PrepareAsyncStreamChat(context, request, cq);
+                });
+            }
+            return;
+        }
+    }
+}
+
+void LoadGenerator::OnCallDone(Clock::time_point scheduled, Sample sample) {
+    bool start_next = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (scheduled >= measure_from_ && scheduled < measure_until_) {
+            samples_.push_back(std::move(sample));
+        }
+        start_next = issuing_ && config_.qps <= 0;
+        if (!start_next && --in_flight_ == 0) {
+            idle_.notify_all();
+        }
+    }
+    if (start_next) {
+        StartCall(Clock::now());
+    }
+}
+
+void LoadGenerator::PollCompletionQueue() {
+    void* tag = nullptr;
+    bool ok = false;
+    while (cq_.Next(&tag, &ok)) {
+        static_cast<Call*>(tag)->Proceed(ok);
+    }
+}
+
+bool LoadGenerator::Run() {
+    for (int i = 0; i < std::max(1, config_.completion_threads); ++i) {
+        cq_threads_.emplace_back([this]() { PollCompletionQueue(); });
+    }
+
+    Clock::time_point start = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        measure_from_ = start + config_.warmup;
+        measure_until_ = measure_from_ + config_.duration;
+        issuing_ = true;
+    }
+    if (config_.qps > 0) {
+        std::cout << "[Bench] Open loop at " << config_.qps << " calls/s";
+    } else {
+        std::cout << "[Bench] Closed loop with " << config_.concurrency << " calls in flight";
+    }
+    std::cout << ": " << config_.warmup.count() << " s warmup, " << config_.duration.count() << " s measured"
+              << std::endl;
+
+    if (config_.qps > 0) {
+        std::exponential_distribution<double> gap(config_.qps);
+        Clock::time_point next = start;
+        while (next < measure_until_) {
+            std::this_thread::sleep_until(next);
+            bool start_call = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                start_call = in_flight_ < config_.max_outstanding;
+                if (start_call) {
+                    in_flight_++;
+                } else if (next >= measure_from_) {
+                    dropped_++;
+                }
+            }
+            if (start_call) {
+                StartCall(next);
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(gap(random_)));
+        }
+    } else {
+        for (int i = 0; i < std::max(1, config_.concurrency); ++i) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                in_flight_++;
+            }
+            StartCall(Clock::now());
+        }
+        std::this_thread::sleep_until(measure_until_);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        issuing_ = false;
+        idle_.wait(lock, [this]() { return in_flight_ == 0; });
+    }
+    cq_.Shutdown();
+    cq_shut_down_ = true;
+    for (auto& thread : cq_threads_) {
+        thread.join();
+    }
+    cq_threads_.clear();
+
+    PrintReport(config_.duration);
+    return std::any_of(samples_.begin(), samples_.end(), [](const Sample& sample) { return sample.error.empty(); });
+}
+
+void LoadGenerator::PrintReport(Clock::duration measured) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<double> latencies;
+    std::vector<double> first_token_latencies;
+    std::map<std::string, uint64_t> errors;
+    double prompt_bytes = 0;
+    double response_bytes = 0;
+    for (const Sample& sample : samples_) {
+        prompt_bytes += static_cast<double>(sample.prompt_bytes);
+        response_bytes += static_cast<double>(sample.response_bytes);
+        if (!sample.error.empty()) {
+            errors[sample.error]++;
+            continue;
+        }
+        latencies.push_back(Milliseconds(sample.latency));
+        if (sample.has_first_token) {
+            first_token_latencies.push_back(Milliseconds(sample.first_token_latency));
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(measured).count();
+    size_t calls = samples_.size();
+    size_t failed = calls - latencies.size();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "[Bench] Results" << std::endl;
+    std::cout << "  Calls:        " << calls << " (" << latencies.size() << " ok, " << failed << " failed, "
+              << dropped_ << " dropped by the client)" << std::endl;
+    std::cout << "  Throughput:   " << latencies.size() / seconds << " ok/s of " << calls / seconds
+              << " calls/s" << std::endl;
+    PrintPercentiles("Latency ms:", latencies);
+    if (!first_token_latencies.empty()) {
+        PrintPercentiles("First token:", first_token_latencies);
+    }
+    if (calls > 0) {
+        std::cout << "  Mean bytes:   " << prompt_bytes / calls << " prompt, " << response_bytes / calls
+                  << " response" << std::endl;
+    }
+    if (!errors.empty()) {
+        std::cout << "  Errors:";
+        for (const auto& [error, count] : errors) {
+            std::cout << "  " << error << " " << count << " (" << 100.0 * count / calls << "%)";
+        }
+        std::cout << std::endl;
+    }
+}
+
+}  // namespace asol
+}  // namespace dashaibrowser
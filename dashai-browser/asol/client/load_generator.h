@@ -0,0 +1,136 @@
+#ifndef DASHAI_BROWSER_ASOL_CLIENT_LOAD_GENERATOR_H_
+#define DASHAI_BROWSER_ASOL_CLIENT_LOAD_GENERATOR_H_
+
+#include "proto/asol_service.grpc.pb.h"
+#include "asol/cpp/utils/shared_memory_text.h"
+#include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dashaibrowser {
+namespace asol {
+
+// Drives a gateway with load to find where it saturates, e.g. before a
+// rollout. Two modes:
+//  - Closed loop (qps == 0): |concurrency| calls are kept in flight; each
+//    completion starts the next. Finds the peak throughput.
+//  - Open loop (qps > 0): calls start at Poisson arrivals regardless of
+//    how the gateway keeps up, as real clients do. Latency is measured
+//    from the scheduled start, so a backed-up client does not hide the
+//    gateway's queueing (coordinated omission).
+// All calls go through one async completion queue, so thousands can be in
+// flight from a few threads. Whether the gateway talks to real providers
+// or mocks is up to how it was started (asol_gateway --mock-providers).
+class LoadGenerator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Rpc { SUMMARY, STREAM_SUMMARY, TRANSLATE, CHAT, STREAM_CHAT };
+
+    struct Config {
+        Rpc rpc = Rpc::STREAM_SUMMARY;
+        // Open loop rate; 0 runs closed loop at |concurrency|
+        double qps = 0;
+        int concurrency = 8;
+        // Open-loop arrivals beyond this many in flight are dropped and
+        // reported, rather than queued in the client
+        size_t max_outstanding = 10000;
+        // Calls scheduled during the warmup are not measured
+        std::chrono::seconds warmup{5};
+        std::chrono::seconds duration{30};
+        std::chrono::milliseconds deadline{30000};
+        // Recorded prompts, one per line with "\n" for line breaks; empty
+        // uses a synthetic mix of page sizes
+        std::string prompts_file;
+        // Prefix each prompt with a unique tag so the gateway's response
+        // cache does not answer instead of the providers
+        bool unique_prompts = true;
+        // Hand summary texts over in shared memory (local gateway only)
+        bool use_shared_memory = false;
+        // UserPreferences.preferred_provider of every call; empty lets the
+        // gateway choose
+        std::string preferred_provider;
+        unsigned seed = 1;
+        int completion_threads = 2;
+    };
+
+    LoadGenerator(std::shared_ptr<::grpc::Channel> channel, const Config& config);
+    ~LoadGenerator();
+
+    LoadGenerator(const LoadGenerator&) = delete;
+    LoadGenerator& operator=(const LoadGenerator&) = delete;
+
+    // Load the prompts; false with a message on stderr if the file cannot
+    // be read or is empty.
+    bool Init();
+
+    // Run the warmup and the measured period, wait for the calls still in
+    // flight and print the report to stdout. Returns false if no call
+    // succeeded.
+    bool Run();
+
+    // Parse "summary", "stream-summary", "translate", "chat" or
+    // "stream-chat".
+    static bool ParseRpc(const std::string& name, Rpc* rpc);
+
+private:
+    // One call's outcome
+    struct Sample {
+        Clock::duration latency{};
+        Clock::duration first_token_latency{}; // Streams that produced text
+        bool has_first_token = false;
+        size_t prompt_bytes = 0;
+        size_t response_bytes = 0;
+        std::string error; // Empty on success: gRPC or ASOL error code
+    };
+
+    class Call;
+    template <typename Response>
+    class UnaryCall;
+    class StreamCall;
+
+    // Start a call whose latency is counted from |scheduled|.
+    void StartCall(Clock::time_point scheduled);
+    void OnCallDone(Clock::time_point scheduled, Sample sample);
+    void PollCompletionQueue();
+
+    // The prompt of call |call_id|, from the recording or the synthetic mix.
+    std::string NextPrompt(uint64_t call_id);
+    static std::string SyntheticText(size_t bytes, std::mt19937* random);
+
+    void PrintReport(Clock::duration measured) const;
+
+    const Config config_;
+    std::unique_ptr<ipc::AsolInterface::Stub> stub_;
+    ::grpc::CompletionQueue cq_;
+    std::vector<std::thread> cq_threads_;
+    bool cq_shut_down_ = false;
+
+    std::vector<std::string> prompts_; // Recorded; empty for synthetic
+    std::atomic<uint64_t> next_call_{0};
+
+    mutable std::mutex mutex_;
+    std::condition_variable idle_; // in_flight_ dropped to zero
+    std::mt19937 random_;
+    bool issuing_ = false;         // Closed loop: completions start the next call
+    size_t in_flight_ = 0;
+    Clock::time_point measure_from_;
+    Clock::time_point measure_until_;
+    std::vector<Sample> samples_;  // Of calls scheduled in the measured period
+    uint64_t dropped_ = 0;         // Open-loop arrivals over max_outstanding
+};
+
+}  // namespace asol
+}  // namespace dashaibrowser
+
+#endif  // DASHAI_BROWSER_ASOL_CLIENT_LOAD_GENERATOR_H_
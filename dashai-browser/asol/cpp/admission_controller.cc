@@ -0,0 +1,108 @@
+#include "asol/cpp/admission_controller.h"
+#include <utility>
+#include <vector>
+
+namespace dashaibrowser {
+namespace asol {
+
+namespace {
+
+// Weight of the newest sample in the service time average
+constexpr int kServiceTimeWeightInverse = 8;
+
+} // namespace
+
+AdmissionController::AdmissionController() : AdmissionController(Config()) {}
+
+AdmissionController::AdmissionController(const Config& config)
+    : config_(config), interval_start_(Clock::now()) {}
+
+AdmissionController::~AdmissionController() = default;
+
+void AdmissionController::Submit(Clock::time_point deadline, StartCallback start) {
+    Outcome outcome;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Clock::time_point now = Clock::now();
+        if (!CanFinishInTimeLocked(deadline, now)) {
+            outcome = Outcome::DEADLINE_EXCEEDED;
+        } else if (queue_.empty() && in_flight_ < config_.max_concurrent) {
+            in_flight_++;
+            outcome = Outcome::ADMITTED;
+        } else if (overloaded_ || queue_.size() >= config_.max_queued) {
+            outcome = Outcome::OVERLOADED;
+        } else {
+            queue_.push_back({deadline, now, std::move(start)});
+            return;
+        }
+    }
+    start(outcome);
+}
+
+void AdmissionController::Release(Clock::duration service_time) {
+    // Decisions are made under the lock and delivered after it
+    std::vector<std::pair<StartCallback, Outcome>> decisions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Clock::time_point now = Clock::now();
+        in_flight_--;
+        if (expected_service_time_ == Clock::duration::zero()) {
+            expected_service_time_ = service_time;
+        } else {
+            expected_service_time_ += (service_time - expected_service_time_) / kServiceTimeWeightInverse;
+        }
+
+        while (!queue_.empty() && in_flight_ < config_.max_concurrent) {
+            Waiter waiter = std::move(queue_.front());
+            queue_.pop_front();
+            RecordQueueDelayLocked(now - waiter.enqueued, now);
+            if (!CanFinishInTimeLocked(waiter.deadline, now)) {
+                decisions.emplace_back(std::move(waiter.start), Outcome::DEADLINE_EXCEEDED);
+                continue;
+            }
+            in_flight_++;
+            decisions.emplace_back(std::move(waiter.start), Outcome::ADMITTED);
+        }
+        if (queue_.empty()) {
+            overloaded_ = false;
+        }
+    }
+    for (auto& [start, outcome] : decisions) {
+        start(outcome);
+    }
+}
+
+size_t AdmissionController::in_flight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_;
+}
+
+size_t AdmissionController::queued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+bool AdmissionController::CanFinishInTimeLocked(Clock::time_point deadline,
+                                                Clock::time_point now) const {
+    if (deadline == Clock::time_point::max()) {
+        return true;
+    }
+    return deadline - now > expected_service_time_;
+}
+
+void AdmissionController::RecordQueueDelayLocked(Clock::duration delay, Clock::time_point now) {
+    if (delay < min_delay_in_interval_) {
+        min_delay_in_interval_ = delay;
+    }
+    if (now - interval_start_ < config_.interval) {
+        return;
+    }
+    // Even the luckiest call of the interval waited too long: the queue is
+    // not draining, so stop adding to it until it does
+    overloaded_ = min_delay_in_interval_ > config_.queue_delay_target;
+    interval_start_ = now;
+    min_delay_in_interval_ = Clock::duration::max();
+}
+
+}  // namespace asol
+}  // namespace dashaibrowser
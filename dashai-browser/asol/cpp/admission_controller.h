@@ -0,0 +1,93 @@
+#ifndef DASHAI_BROWSER_ASOL_CPP_ADMISSION_CONTROLLER_H_
+#define DASHAI_BROWSER_ASOL_CPP_ADMISSION_CONTROLLER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace dashaibrowser {
+namespace asol {
+
+// Admission control for gateway calls. At most max_concurrent calls work
+// at once; the rest wait in a bounded FIFO without holding a thread. A
+// call is shed up front, rather than left to time out with everyone else,
+// when:
+//  - the queue is full, or has had a standing delay above
+//    queue_delay_target for a whole interval (as in CoDel: short bursts
+//    are absorbed, persistent overload is not), or
+//  - its deadline is closer than the typical service time, so the work
+//    could not finish in time. This is checked again when it leaves the
+//    queue.
+// Thread-safe.
+class AdmissionController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Config {
+        size_t max_concurrent = 64;
+        size_t max_queued = 256;
+        std::chrono::milliseconds queue_delay_target{100};
+        std::chrono::milliseconds interval{1000};
+    };
+
+    enum class Outcome {
+        ADMITTED,
+        OVERLOADED,        // Shed: too many calls or a standing queue
+        DEADLINE_EXCEEDED, // Shed: the call could not finish in time
+    };
+
+    // Receives the decision for a call. ADMITTED calls must call Release()
+    // when their work completes.
+    using StartCallback = std::function<void(Outcome outcome)>;
+
+    AdmissionController();
+    explicit AdmissionController(const Config& config);
+    ~AdmissionController();
+
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    // Decide on a call that must finish by |deadline| (time_point::max()
+    // for none). |start| runs once, inline or when a slot frees up on the
+    // thread that called Release().
+    void Submit(Clock::time_point deadline, StartCallback start);
+
+    // An admitted call finished after running for |service_time|.
+    void Release(Clock::duration service_time);
+
+    size_t in_flight() const;
+    size_t queued() const;
+
+private:
+    struct Waiter {
+        Clock::time_point deadline;
+        Clock::time_point enqueued;
+        StartCallback start;
+    };
+
+    // Whether a call due at |deadline| can still finish. Locked.
+    bool CanFinishInTimeLocked(Clock::time_point deadline, Clock::time_point now) const;
+
+    // Track the smallest queue delay seen this interval. Locked.
+    void RecordQueueDelayLocked(Clock::duration delay, Clock::time_point now);
+
+    const Config config_;
+
+    mutable std::mutex mutex_;
+    std::deque<Waiter> queue_;
+    size_t in_flight_ = 0;
+    // Moving average of service times; zero until the first call finishes
+    Clock::duration expected_service_time_{};
+    // Standing-queue detection: the minimum delay of calls leaving the
+    // queue during the current interval
+    Clock::time_point interval_start_;
+    Clock::duration min_delay_in_interval_ = Clock::duration::max();
+    bool overloaded_ = false;
+};
+
+}  // namespace asol
+}  // namespace dashaibrowser
+
+#endif  // DASHAI_BROWSER_ASOL_CPP_ADMISSION_CONTROLLER_H_
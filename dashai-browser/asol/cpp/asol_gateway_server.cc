@@ -1,10 +1,228 @@
 #include "asol/cpp/asol_gateway_server.h"
+#include "asol/cpp/utils/startup_trace.h"
+#include <algorithm> // For std::max
+#include <deque>
+#include <functional>
 #include <iostream> // For logging
+#include <mutex>
+#include <utility>
 
 namespace dashaibrowser {
 namespace asol {
 
-AsolGatewayServer::AsolGatewayServer() {
+namespace {
+
+// One RPC served from a completion queue. Its address is the tag of every
+// operation it queues, and the thread polling the queue calls Proceed()
+// with each result.
+class AsyncCall {
+public:
+    virtual ~AsyncCall() = default;
+
+    // |ok| is false when the operation failed, e.g. at shutdown.
+    virtual void Proceed(bool ok) = 0;
+};
+
+// A unary RPC: waits for a request, hands it to the service and sends the
+// response once the service reports back. The queue thread is free while
+// the service waits on the provider.
+template <typename Request, typename Response>
+class UnaryCall : public AsyncCall {
+public:
+    using Responder = ::grpc::ServerAsyncResponseWriter<Response>;
+    // Asks the server for the next call of this method.
+    using RequestMethod = std::function<void(::grpc::ServerContext*,
+                                             Request*,
+                                             Responder*,
+                                             ::grpc::ServerCompletionQueue*,
+                                             void* tag)>;
+    using Handler = std::function<void(const Request&,
+                                       const AsolServiceImpl::CallInfo&,
+                                       Response*,
+                                       AsolServiceImpl::DoneCallback)>;
+
+    // Start waiting for a call; the object deletes itself when done.
+    static void Start(RequestMethod request_method,
+                      Handler handler,
+                      ::grpc::ServerCompletionQueue* cq) {
+        new UnaryCall(std::move(request_method), std::move(handler), cq);
+    }
+
+    void Proceed(bool ok) override {
+        if (state_ == State::FINISHING || !ok) {
+            // Response sent, or the server is shutting down
+            delete this;
+            return;
+        }
+
+        // Keep one call waiting on this queue at all times
+        Start(request_method_, handler_, cq_);
+
+        state_ = State::FINISHING;
+        // |done| may run on an adapter thread; Finish() is safe to call
+        // from any thread, and its completion comes back through |cq_|.
+        handler_(request_, AsolServiceImpl::CallInfo::FromContext(context_), &response_, [this](::grpc::Status status) {
+            responder_.Finish(response_, status, this);
+        });
+    }
+
+private:
+    enum class State { WAITING, FINISHING };
+
+    UnaryCall(RequestMethod request_method,
+              Handler handler,
+              ::grpc::ServerCompletionQueue* cq)
+        : request_method_(std::move(request_method)),
+          handler_(std::move(handler)),
+          cq_(cq),
+          responder_(&context_) {
+        request_method_(&context_, &request_, &responder_, cq_, this);
+    }
+
+    RequestMethod request_method_;
+    Handler handler_;
+    ::grpc::ServerCompletionQueue* cq_;
+    ::grpc::ServerContext context_;
+    Request request_;
+    Response response_;
+    Responder responder_;
+    State state_ = State::WAITING;
+};
+
+// A server-streaming RPC. The service writes chunks from adapter threads;
+// they are queued here and sent one at a time, since gRPC allows only one
+// outstanding write per stream. The next write starts when the previous
+// one completes on the queue thread.
+template <typename Request, typename Chunk>
+class ServerStreamingCall : public AsyncCall {
+public:
+    using Writer = ::grpc::ServerAsyncWriter<Chunk>;
+    using RequestMethod = std::function<void(::grpc::ServerContext*,
+                                             Request*,
+                                             Writer*,
+                                             ::grpc::ServerCompletionQueue*,
+                                             void* tag)>;
+    using Handler = std::function<void(const Request&,
+                                       const AsolServiceImpl::CallInfo&,
+                                       AsolServiceImpl::StreamWriter<Chunk>,
+                                       AsolServiceImpl::DoneCallback)>;
+
+    // Start waiting for a call; the object deletes itself when done.
+    static void Start(RequestMethod request_method,
+                      Handler handler,
+                      ::grpc::ServerCompletionQueue* cq) {
+        new ServerStreamingCall(std::move(request_method), std::move(handler), cq);
+    }
+
+    void Proceed(bool ok) override {
+        if (!started_) {
+            if (!ok) {
+                delete this; // The server is shutting down
+                return;
+            }
+            started_ = true;
+            Start(request_method_, handler_, cq_);
+            handler_(request_, AsolServiceImpl::CallInfo::FromContext(context_),
+                     [this](Chunk chunk) { return Write(std::move(chunk)); },
+                     [this](::grpc::Status status) { Finish(std::move(status)); });
+            return;
+        }
+
+        // A Write() or the Finish() completed
+        bool finished = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (finishing_) {
+                finished = true;
+            } else {
+                op_in_flight_ = false;
+                if (ok) {
+                    chunks_.pop_front();
+                } else {
+                    // The client went away; tell the handler to stop
+                    client_gone_ = true;
+                    chunks_.clear();
+                }
+                StartNextOpLocked();
+            }
+        }
+        if (finished) {
+            delete this;
+        }
+    }
+
+private:
+    ServerStreamingCall(RequestMethod request_method,
+                        Handler handler,
+                        ::grpc::ServerCompletionQueue* cq)
+        : request_method_(std::move(request_method)),
+          handler_(std::move(handler)),
+          cq_(cq),
+          writer_(&context_) {
+        request_method_(&context_, &request_, &writer_, cq_, this);
+    }
+
+    bool Write(Chunk chunk) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (client_gone_) {
+            return false;
+        }
+        chunks_.push_back(std::move(chunk));
+        if (!op_in_flight_) {
+            StartNextOpLocked();
+        }
+        return true;
+    }
+
+    void Finish(::grpc::Status status) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        status_ = std::move(status);
+        done_ = true;
+        if (!op_in_flight_) {
+            StartNextOpLocked();
+        }
+    }
+
+    // The front chunk stays queued until its write completes, since gRPC
+    // reads it while the write is in flight.
+    void StartNextOpLocked() {
+        if (!chunks_.empty()) {
+            op_in_flight_ = true;
+            writer_.Write(chunks_.front(), this);
+        } else if (done_) {
+            op_in_flight_ = true;
+            finishing_ = true;
+            writer_.Finish(status_, this);
+        }
+    }
+
+    RequestMethod request_method_;
+    Handler handler_;
+    ::grpc::ServerCompletionQueue* cq_;
+    ::grpc::ServerContext context_;
+    Request request_;
+    Writer writer_;
+    bool started_ = false; // Only touched on the queue thread
+
+    std::mutex mutex_;
+    std::deque<Chunk> chunks_;
+    ::grpc::Status status_;
+    bool op_in_flight_ = false;
+    bool done_ = false;       // The handler has completed
+    bool finishing_ = false;  // Finish() is in flight
+    bool client_gone_ = false;
+};
+
+} // namespace
+
+AsolGatewayServer::AsolGatewayServer() : AsolGatewayServer(Config()) {}
+
+AsolGatewayServer::AsolGatewayServer(const Config& config)
+    : config_(config), service_impl_(config.service) {
+    if (config_.num_completion_queues <= 0) {
+        config_.num_completion_queues =
+            std::max(1u, std::thread::hardware_concurrency());
+    }
     std::cout << "AsolGatewayServer: Instance created." << std::endl;
 }
 
@@ -13,6 +231,11 @@ AsolGatewayServer::~AsolGatewayServer() {
     if (server_thread_.joinable()) {
         server_thread_.join();
     }
+    for (auto& thread : cq_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
     std::cout << "AsolGatewayServer: Instance destroyed." << std::endl;
 }
 
@@ -25,18 +248,53 @@ void AsolGatewayServer::Run(const std::string& address) {
     ::grpc::ServerBuilder builder;
     // Listen on the given address without any authentication mechanism for now.
     builder.AddListeningPort(address, ::grpc::InsecureServerCredentials());
-    // Register "service_impl_" as the instance through which we'll communicate with
-    // clients. In this case, it corresponds to an *synchronous* service.
-    builder.RegisterService(&service_impl_);
+    if (config_.async) {
+        // Calls are parked on the completion queues while the adapter waits
+        // on the provider, so no thread is tied up per call.
+        builder.RegisterService(&async_service_);
+        for (int i = 0; i < config_.num_completion_queues; ++i) {
+            completion_queues_.push_back(builder.AddCompletionQueue());
+        }
+    } else {
+        // Register "service_impl_" as the instance through which we'll communicate with
+        // clients. In this case, it corresponds to an *synchronous* service.
+        builder.RegisterService(&service_impl_);
+    }
 
     // Finally assemble the server.
+    auto listen_start = utils::StartupTrace::Clock::now();
     server_ = builder.BuildAndStart();
     if (!server_) {
         std::cerr << "AsolGatewayServer::Run: Failed to start server on " << address << std::endl;
         return; // TODO: Proper error handling/propagation
     }
-    std::cout << "AsolGatewayServer::Run: Server listening on " << address << std::endl;
+    std::cout << "AsolGatewayServer::Run: Server listening on " << address
+              << (config_.async ? " (async, " + std::to_string(completion_queues_.size()) + " completion queues)"
+                                : " (sync)")
+              << std::endl;
     running_ = true;
+    if (utils::StartupTrace* trace = utils::StartupTrace::Get()) {
+        trace->AddPhase("listen", listen_start, utils::StartupTrace::Clock::now());
+    }
+
+    for (auto& cq : completion_queues_) {
+        ::grpc::ServerCompletionQueue* queue = cq.get();
+        cq_threads_.emplace_back([this, queue]() { PollCompletionQueue(queue); });
+    }
+
+    if (!config_.metrics_address.empty()) {
+        metrics_server_ = std::make_unique<MetricsServer>(
+            [this]() { return service_impl_.RenderMetrics(); }, GatewayMetrics::kContentType);
+        if (!metrics_server_->Start(config_.metrics_address)) {
+            // Serving matters more than being observed
+            std::cerr << "AsolGatewayServer::Run: Metrics disabled." << std::endl;
+            metrics_server_.reset();
+        }
+    }
+
+    // Pay for DNS, TCP and TLS to the providers now rather than on the
+    // first client request.
+    service_impl_.PreconnectProviders();
 
     // Detach the server thread to allow Run to return if needed, or join it.
     // For a simple main, server_->Wait() is blocking.
@@ -53,9 +311,85 @@ void AsolGatewayServer::Run(const std::string& address) {
     // server_->Wait() will block until Shutdown() is called from another thread,
     // or if the server is shut down for other reasons.
     running_ = false;
+
+    // The server has finished its calls; drain the queues and stop polling.
+    for (auto& cq : completion_queues_) {
+        cq->Shutdown();
+    }
+    for (auto& thread : cq_threads_) {
+        thread.join();
+    }
+    cq_threads_.clear();
+    completion_queues_.clear();
+    metrics_server_.reset();
     std::cout << "AsolGatewayServer::Run: Server has shut down." << std::endl;
 }
 
+void AsolGatewayServer::PollCompletionQueue(::grpc::ServerCompletionQueue* cq) {
+    UnaryCall<ipc::SummaryRequest, ipc::SummaryResponse>::Start(
+        [this](auto* context, auto* request, auto* responder, auto* queue, void* tag) {
+            async_service_.RequestGetSummary(context, request, responder, queue, queue, tag);
+        },
+        [this](const auto& request, const auto& call, auto* response, auto done) {
+            service_impl_.HandleGetSummary(request, call, response, std::move(done));
+        },
+        cq);
+    UnaryCall<ipc::TranslationRequest, ipc::TranslationResponse>::Start(
+        [this](auto* context, auto* request, auto* responder, auto* queue, void* tag) {
+            async_service_.RequestTranslateText(context, request, responder, queue, queue, tag);
+        },
+        [this](const auto& request, const auto& call, auto* response, auto done) {
+            service_impl_.HandleTranslateText(request, call, response, std::move(done));
+        },
+        cq);
+    UnaryCall<ipc::ConversationRequest, ipc::ConversationResponse>::Start(
+        [this](auto* context, auto* request, auto* responder, auto* queue, void* tag) {
+            async_service_.RequestChatWithJules(context, request, responder, queue, queue, tag);
+        },
+        [this](const auto& request, const auto& call, auto* response, auto done) {
+            service_impl_.HandleChatWithJules(request, call, response, std::move(done));
+        },
+        cq);
+    ServerStreamingCall<ipc::SummaryRequest, ipc::CompletionChunk>::Start(
+        [this](auto* context, auto* request, auto* writer, auto* queue, void* tag) {
+            async_service_.RequestStreamSummary(context, request, writer, queue, queue, tag);
+        },
+        [this](const auto& request, const auto& call, auto write, auto done) {
+            service_impl_.HandleStreamSummary(request, call, std::move(write), std::move(done));
+        },
+        cq);
+    ServerStreamingCall<ipc::ConversationRequest, ipc::CompletionChunk>::Start(
+        [this](auto* context, auto* request, auto* writer, auto* queue, void* tag) {
+            async_service_.RequestStreamChat(context, request, writer, queue, queue, tag);
+        },
+        [this](const auto& request, const auto& call, auto write, auto done) {
+            service_impl_.HandleStreamChat(request, call, std::move(write), std::move(done));
+        },
+        cq);
+    ServerStreamingCall<ipc::BatchSummaryRequest, ipc::SummaryResponse>::Start(
+        [this](auto* context, auto* request, auto* writer, auto* queue, void* tag) {
+            async_service_.RequestBatchSummarize(context, request, writer, queue, queue, tag);
+        },
+        [this](const auto& request, const auto& call, auto write, auto done) {
+            service_impl_.HandleBatchSummarize(request, call, std::move(write), std::move(done));
+        },
+        cq);
+    ServerStreamingCall<ipc::BatchTranslationRequest, ipc::TranslationResponse>::Start(
+        [this](auto* context, auto* request, auto* writer, auto* queue, void* tag) {
+            async_service_.RequestBatchTranslate(context, request, writer, queue, queue, tag);
+        },
+        [this](const auto& request, const auto& call, auto write, auto done) {
+            service_impl_.HandleBatchTranslate(request, call, std::move(write), std::move(done));
+        },
+        cq);
+
+    void* tag = nullptr;
+    bool ok = false;
+    while (cq->Next(&tag, &ok)) {
+        static_cast<AsyncCall*>(tag)->Proceed(ok);
+    }
+}
+
 void AsolGatewayServer::Shutdown() {
     if (server_ && running_) {
         std::cout << "AsolGatewayServer::Shutdown: Attempting to shut down server..." << std::endl;
@@ -2,17 +2,35 @@
 #define DASHAI_BROWSER_ASOL_CPP_ASOL_GATEWAY_SERVER_H_
 
 #include "asol/cpp/asol_service_impl.h" // The service implementation
+#include "asol/cpp/metrics_server.h"
+#include "proto/asol_service.grpc.pb.h"
 #include <grpcpp/grpcpp.h>
 #include <memory> // For std::unique_ptr
 #include <string>
 #include <thread> // For std::thread
+#include <vector>
 
 namespace dashaibrowser {
 namespace asol {
 
 class AsolGatewayServer {
  public:
+  struct Config {
+    // Serve RPCs from completion queues instead of gRPC's synchronous
+    // thread pool. A call waiting on the AI provider then holds no thread,
+    // so a few threads can keep thousands of calls in flight.
+    bool async = true;
+    // Completion queues for the asynchronous server, each polled by its own
+    // thread. 0 means one per core.
+    int num_completion_queues = 0;
+    // Session history, admission control and batch limits of the service
+    AsolServiceImpl::Config service;
+    // Where Prometheus scrapes /metrics, "host:port"; empty to disable
+    std::string metrics_address = "0.0.0.0:9464";
+  };
+
   AsolGatewayServer();
+  explicit AsolGatewayServer(const Config& config);
   ~AsolGatewayServer();
 
   // Starts the gRPC server and blocks until it's shut down.
@@ -23,8 +41,16 @@ class AsolGatewayServer {
   void Shutdown();
 
  private:
+  // Poll |cq| until it is shut down and drained.
+  void PollCompletionQueue(::grpc::ServerCompletionQueue* cq);
+
+  Config config_;
   AsolServiceImpl service_impl_; // Instance of our service implementation
+  ipc::AsolInterface::AsyncService async_service_; // Used when config_.async
+  std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>> completion_queues_;
+  std::vector<std::thread> cq_threads_; // One per completion queue
   std::unique_ptr<::grpc::Server> server_; // The gRPC server instance
+  std::unique_ptr<MetricsServer> metrics_server_; // While running, if enabled
   std::thread server_thread_; // Thread for the server's blocking run loop
   bool running_ = false;
 };
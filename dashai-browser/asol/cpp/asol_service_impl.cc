@@ -1,13 +1,293 @@
 #include "asol/cpp/asol_service_impl.h"
+#include "asol/cpp/utils/shared_memory_text.h"
+#include "asol/cpp/utils/startup_trace.h"
+#include <algorithm> // For std::min, std::max
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>   // For waiting on handlers in the synchronous RPCs
 #include <iostream> // For placeholder logging
+#include <memory>   // For std::shared_ptr
+#include <mutex>
 #include <sstream>  // For constructing prompts with history
+#include <string_view>
+#include <utility>
 
 namespace dashaibrowser {
 namespace asol {
 
-AsolServiceImpl::AsolServiceImpl() {
+namespace {
+
+// Runs the items of a batch RPC, at most |limit| at a time, and writes each
+// response as its item completes. Items that complete inline (e.g. invalid
+// ones) are picked up by the Pump() loop rather than by recursion.
+template <typename Item, typename Response>
+class BatchRun : public std::enable_shared_from_this<BatchRun<Item, Response>> {
+public:
+    using ItemHandler = std::function<void(const Item&, Response*, AsolServiceImpl::DoneCallback)>;
+
+    // |items| must outlive the run, i.e. until |done| has run.
+    BatchRun(const google::protobuf::RepeatedPtrField<Item>& items,
+             std::string batch_id,
+             size_t limit,
+             ItemHandler handler,
+             AsolServiceImpl::StreamWriter<Response> write,
+             AsolServiceImpl::DoneCallback done)
+        : items_(items),
+          batch_id_(std::move(batch_id)),
+          limit_(limit),
+          handler_(std::move(handler)),
+          write_(std::move(write)),
+          done_(std::move(done)) {}
+
+    void Pump() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (pumping_) {
+            return;
+        }
+        pumping_ = true;
+        while (!client_gone_ && in_flight_ < limit_ && next_ < static_cast<size_t>(items_.size())) {
+            size_t index = next_++;
+            in_flight_++;
+            lock.unlock();
+
+            auto response = std::make_shared<Response>();
+            auto self = this->shared_from_this();
+            handler_(items_[static_cast<int>(index)], response.get(),
+                     [self, response, index](::grpc::Status) {
+                         self->OnItemDone(index, std::move(*response));
+                     });
+
+            lock.lock();
+        }
+        pumping_ = false;
+
+        bool all_done = in_flight_ == 0 &&
+                        (client_gone_ || next_ == static_cast<size_t>(items_.size()));
+        if (!all_done || finished_) {
+            return;
+        }
+        finished_ = true;
+        bool client_gone = client_gone_;
+        lock.unlock();
+        done_(client_gone ? ::grpc::Status(::grpc::StatusCode::CANCELLED, "Client stopped reading the batch.")
+                          : ::grpc::Status::OK);
+    }
+
+private:
+    void OnItemDone(size_t index, Response response) {
+        if (response.request_id().empty()) {
+            response.set_request_id(batch_id_ + "/" + std::to_string(index));
+        }
+        bool written = write_(std::move(response));
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            in_flight_--;
+            if (!written) {
+                client_gone_ = true;
+            }
+        }
+        Pump();
+    }
+
+    const google::protobuf::RepeatedPtrField<Item>& items_;
+    const std::string batch_id_;
+    const size_t limit_;
+    ItemHandler handler_;
+    AsolServiceImpl::StreamWriter<Response> write_;
+    AsolServiceImpl::DoneCallback done_;
+
+    std::mutex mutex_;
+    size_t next_ = 0;       // Next item to start
+    size_t in_flight_ = 0;
+    bool pumping_ = false;  // A Pump() loop is running
+    bool client_gone_ = false;
+    bool finished_ = false;
+};
+
+// Whether |peer|, from ServerContext::peer(), is on this host. gRPC
+// escapes IPv6 brackets in some versions.
+bool IsLocalPeer(const std::string& peer) {
+    for (const char* prefix : {"unix:", "ipv4:127.", "ipv6:[::1]", "ipv6:%5B::1%5D"}) {
+        if (peer.rfind(prefix, 0) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The text |request| asks to summarize: original_text, or the shared
+// memory it names. Null with |error| set when that cannot be read.
+std::shared_ptr<const std::string> OriginalText(const ipc::SummaryRequest& request,
+                                                const AsolServiceImpl::CallInfo& call,
+                                                std::string* error) {
+    if (!request.has_original_text_shm()) {
+        // Not owned: the request outlives the handler's work
+        return std::shared_ptr<const std::string>(std::shared_ptr<void>(), &request.original_text());
+    }
+    if (!call.local_peer) {
+        *error = "Shared memory text is only accepted from local clients.";
+        return nullptr;
+    }
+    const ipc::SharedMemoryText& shm = request.original_text_shm();
+    auto text = std::make_shared<std::string>();
+    if (!utils::ReadSharedText(call.peer, shm.pid(), shm.fd(), shm.size(), text.get(), error)) {
+        return nullptr;
+    }
+    return text;
+}
+
+// Name of |code| for the metrics' code label
+const char* StatusCodeName(::grpc::StatusCode code) {
+    switch (code) {
+        case ::grpc::StatusCode::OK: return "OK";
+        case ::grpc::StatusCode::CANCELLED: return "CANCELLED";
+        case ::grpc::StatusCode::UNKNOWN: return "UNKNOWN";
+        case ::grpc::StatusCode::INVALID_ARGUMENT: return "INVALID_ARGUMENT";
+        case ::grpc::StatusCode::DEADLINE_EXCEEDED: return "DEADLINE_EXCEEDED";
+        case ::grpc::StatusCode::NOT_FOUND: return "NOT_FOUND";
+        case ::grpc::StatusCode::ALREADY_EXISTS: return "ALREADY_EXISTS";
+        case ::grpc::StatusCode::PERMISSION_DENIED: return "PERMISSION_DENIED";
+        case ::grpc::StatusCode::RESOURCE_EXHAUSTED: return "RESOURCE_EXHAUSTED";
+        case ::grpc::StatusCode::FAILED_PRECONDITION: return "FAILED_PRECONDITION";
+        case ::grpc::StatusCode::ABORTED: return "ABORTED";
+        case ::grpc::StatusCode::OUT_OF_RANGE: return "OUT_OF_RANGE";
+        case ::grpc::StatusCode::UNIMPLEMENTED: return "UNIMPLEMENTED";
+        case ::grpc::StatusCode::INTERNAL: return "INTERNAL";
+        case ::grpc::StatusCode::UNAVAILABLE: return "UNAVAILABLE";
+        case ::grpc::StatusCode::DATA_LOSS: return "DATA_LOSS";
+        case ::grpc::StatusCode::UNAUTHENTICATED: return "UNAUTHENTICATED";
+        default: return "UNKNOWN";
+    }
+}
+
+// Describes how a call was served in a response's diagnostic_info:
+//  queue_ms        time waiting for admission control
+//  cache           "hit" when the response came from the router's cache
+//  provider        provider that answered, or was tried last
+//  attempts        providers tried, more than one after a fallback
+//  upstream_ms     duration of the last provider call
+//  first_token_ms  time to the first text of a stream
+//  prompt_tokens, completion_tokens  as reported by the model
+void FillDiagnostics(const adapters::CallTrace& trace,
+                     google::protobuf::Map<std::string, std::string>* info) {
+    auto ms = [](adapters::CallTrace::Duration duration) {
+        return std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+    };
+    (*info)["queue_ms"] = ms(trace.queue_time);
+    if (trace.from_cache) {
+        (*info)["cache"] = "hit";
+    }
+    if (trace.attempts > 0) {
+        (*info)["provider"] = trace.provider_id;
+        (*info)["attempts"] = std::to_string(trace.attempts);
+        (*info)["upstream_ms"] = ms(trace.upstream_latency);
+    }
+    if (trace.first_token_latency != adapters::CallTrace::Duration::zero()) {
+        (*info)["first_token_ms"] = ms(trace.first_token_latency);
+    }
+    if (trace.usage.prompt_tokens() > 0 || trace.usage.completion_tokens() > 0) {
+        (*info)["prompt_tokens"] = std::to_string(trace.usage.prompt_tokens());
+        (*info)["completion_tokens"] = std::to_string(trace.usage.completion_tokens());
+    }
+}
+
+// The spans of one call, and when it arrived
+struct CallSpans {
+    GatewayTracer::SpanContext parent;   // The client's
+    GatewayTracer::SpanContext rpc;
+    GatewayTracer::SpanContext upstream; // Sent to the provider as its parent
+    std::chrono::system_clock::time_point submitted;
+};
+
+// Records a call of |method| that completed with |status| in |tracer|:
+// the RPC, its wait for admission and the last provider attempt, with the
+// details FillDiagnostics() reports
+void RecordCallSpans(GatewayTracer* tracer,
+                     const char* method,
+                     const CallSpans& spans,
+                     const adapters::CallTrace& trace,
+                     const ::grpc::Status& status) {
+    auto now = std::chrono::system_clock::now();
+    auto ms = [](adapters::CallTrace::Duration duration) {
+        return std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+    };
+
+    GatewayTracer::Span rpc;
+    rpc.name = std::string("asol.AsolInterface/") + method;
+    rpc.kind = GatewayTracer::SpanKind::SERVER;
+    rpc.context = spans.rpc;
+    rpc.parent_span_id = spans.parent.span_id;
+    rpc.start = spans.submitted;
+    rpc.end = now;
+    rpc.error = !status.ok();
+    rpc.attributes = {{"rpc.system", "grpc"},
+                      {"rpc.method", method},
+                      {"rpc.grpc.status_code", StatusCodeName(status.error_code())},
+                      {"asol.cache", trace.from_cache ? "hit" : "miss"}};
+    if (trace.attempts > 0) {
+        rpc.attributes.emplace_back("asol.provider", trace.provider_id);
+        rpc.attributes.emplace_back("asol.attempts", std::to_string(trace.attempts));
+    }
+
+    GatewayTracer::Span queue;
+    queue.name = "admission";
+    queue.context = GatewayTracer::NewSpan(spans.rpc);
+    queue.parent_span_id = spans.rpc.span_id;
+    queue.start = spans.submitted;
+    queue.end = spans.submitted + std::chrono::duration_cast<std::chrono::system_clock::duration>(trace.queue_time);
+    tracer->Record(std::move(queue));
+
+    if (trace.attempts > 0) {
+        // Only the last attempt's latency is known; it ended with the call
+        GatewayTracer::Span upstream;
+        upstream.name = "provider " + trace.provider_id;
+        upstream.kind = GatewayTracer::SpanKind::CLIENT;
+        upstream.context = spans.upstream;
+        upstream.parent_span_id = spans.rpc.span_id;
+        upstream.start = now - std::chrono::duration_cast<std::chrono::system_clock::duration>(trace.upstream_latency);
+        upstream.end = now;
+        upstream.error = !status.ok();
+        upstream.attributes = {{"asol.provider", trace.provider_id}};
+        if (trace.first_token_latency != adapters::CallTrace::Duration::zero()) {
+            upstream.attributes.emplace_back("asol.first_token_ms", ms(trace.first_token_latency));
+        }
+        if (trace.usage.prompt_tokens() > 0 || trace.usage.completion_tokens() > 0) {
+            upstream.attributes.emplace_back("gen_ai.usage.input_tokens", std::to_string(trace.usage.prompt_tokens()));
+            upstream.attributes.emplace_back("gen_ai.usage.output_tokens",
+                                             std::to_string(trace.usage.completion_tokens()));
+        }
+        tracer->Record(std::move(upstream));
+    }
+    tracer->Record(std::move(rpc));
+}
+
+} // namespace
+
+AsolServiceImpl::CallInfo AsolServiceImpl::CallInfo::FromContext(const ::grpc::ServerContext& context) {
+    CallInfo call;
+    call.deadline = context.deadline();
+    call.peer = context.peer();
+    call.local_peer = IsLocalPeer(call.peer);
+    auto traceparent = context.client_metadata().find(kTraceparentKey);
+    if (traceparent != context.client_metadata().end()) {
+        call.trace_parent = GatewayTracer::SpanContext::Parse(
+            std::string_view(traceparent->second.data(), traceparent->second.length()));
+    }
+    return call;
+}
+
+AsolServiceImpl::AsolServiceImpl() : AsolServiceImpl(Config()) {}
+
+AsolServiceImpl::AsolServiceImpl(const Config& config)
+    : tracer_(config.tracing),
+      request_recorder_(config.request_trace_path),
+      session_store_(config.sessions),
+      admission_(config.admission),
+      max_batch_concurrency_(config.max_batch_concurrency) {
     std::cout << "AsolServiceImpl: Instance created." << std::endl;
-    if (!InitializeAdapters()) {
+    utils::ScopedStartupPhase provider_init("provider_init");
+    if (!InitializeAdapters(config.routing, config.mock_providers)) {
         // Handle adapter initialization failure, e.g., by logging or throwing.
         // For now, just log. The service methods will check `adapters_initialized_`.
         std::cerr << "AsolServiceImpl: Failed to initialize AI adapters!" << std::endl;
@@ -18,24 +298,52 @@ AsolServiceImpl::~AsolServiceImpl() {
     std::cout << "AsolServiceImpl: Instance destroyed." << std::endl;
 }
 
-bool AsolServiceImpl::InitializeAdapters() {
-    // Create and initialize the Gemini adapter.
-    // It will default to using CurlHttpClient.
-    gemini_adapter_ = std::make_unique<adapters::GeminiTextAdapter>();
+bool AsolServiceImpl::InitializeAdapters(const ProviderRouter::Config& routing_config,
+                                         const std::vector<adapters::MockProviderSpec>& mock_providers) {
+    router_ = std::make_unique<ProviderRouter>(routing_config, &metrics_);
 
-    adapters::GeminiAdapterConfig gemini_config;
-    // TODO: Populate gemini_config.api_key from a secure source (e.g., env variable, config file).
-    // The key "YOUR_GEMINI_API_KEY_HERE" is a placeholder and will not work.
-    // For testing with the actual CurlHttpClient, a valid key needs to be set here or read from env.
-    gemini_config.api_key = "YOUR_GEMINI_API_KEY_PLACEHOLDER"; // Placeholder, ensure this is clear
+    if (!mock_providers.empty()) {
+        for (const auto& provider : mock_providers) {
+            router_->RegisterProvider(provider.id, std::make_unique<adapters::MockTextAdapter>(provider.profile));
+            std::cout << "AsolServiceImpl: Serving mock provider " << provider.id << "." << std::endl;
+        }
+        router_->Initialize(adapters::GeminiAdapterConfig());
+        adapters_initialized_ = true;
+        return true;
+    }
+
+    // One provider per Gemini model: the fast model serves by default and
+    // the larger one takes over when it fails or slows down. Each adapter
+    // defaults to using CurlMultiHttpClient.
+    const struct {
+        const char* id;
+        const char* endpoint;
+    } kProviders[] = {
+        {"gemini-flash", "https://generativelanguage.googleapis.com/v1beta/models/gemini-1.5-flash-latest:generateContent"},
+        {"gemini-pro", "https://generativelanguage.googleapis.com/v1beta/models/gemini-1.5-pro-latest:generateContent"},
+    };
+    for (const auto& provider : kProviders) {
+        auto gemini_adapter = std::make_unique<adapters::GeminiTextAdapter>();
+
+        adapters::GeminiAdapterConfig gemini_config;
+        // TODO: Populate gemini_config.api_key from a secure source (e.g., env variable, config file).
+        // The key "YOUR_GEMINI_API_KEY_HERE" is a placeholder and will not work.
+        // For testing with the actual CurlHttpClient, a valid key needs to be set here or read from env.
+        gemini_config.api_key = "YOUR_GEMINI_API_KEY_PLACEHOLDER"; // Placeholder, ensure this is clear
 
-    gemini_config.api_endpoint_summarize = "https://generativelanguage.googleapis.com/v1beta/models/gemini-1.5-flash-latest:generateContent";
-    gemini_config.api_endpoint_translate = "https://generativelanguage.googleapis.com/v1beta/models/gemini-1.5-flash-latest:generateContent";
-    gemini_config.api_endpoint_generate_text = "https://generativelanguage.googleapis.com/v1beta/models/gemini-1.5-flash-latest:generateContent"; // Using same for general text
+        gemini_config.api_endpoint_summarize = provider.endpoint;
+        gemini_config.api_endpoint_translate = provider.endpoint;
+        gemini_config.api_endpoint_generate_text = provider.endpoint; // Using same for general text
+
+        if (!gemini_adapter->Initialize(gemini_config)) {
+            std::cerr << "AsolServiceImpl: Failed to initialize GeminiTextAdapter for " << provider.id << "." << std::endl;
+            continue;
+        }
+        router_->RegisterProvider(provider.id, std::move(gemini_adapter));
+    }
 
-    if (!gemini_adapter_->Initialize(gemini_config)) {
-        std::cerr << "AsolServiceImpl: Failed to initialize GeminiTextAdapter." << std::endl;
-        gemini_adapter_.reset(); // Release if initialization failed
+    if (!router_->Initialize(adapters::GeminiAdapterConfig())) {
+        router_.reset(); // No provider could be initialized
         adapters_initialized_ = false;
         return false;
     }
@@ -45,6 +353,21 @@ bool AsolServiceImpl::InitializeAdapters() {
     return true;
 }
 
+bool AsolServiceImpl::IsKnownProvider(const ipc::UserPreferences& prefs) const {
+    return prefs.preferred_provider().empty() || router_->HasProvider(prefs.preferred_provider());
+}
+
+void AsolServiceImpl::PreconnectProviders() {
+    if (!adapters_initialized_ || !router_) {
+        return;
+    }
+    router_->Preconnect();
+}
+
+std::string AsolServiceImpl::RenderMetrics() {
+    metrics_.SetAdmissionState(admission_.in_flight(), admission_.queued());
+    return metrics_.RenderPrometheus();
+}
 
 void AsolServiceImpl::SetError(ipc::ErrorDetails* error_details,
                                int32_t code,
@@ -59,182 +382,758 @@ void AsolServiceImpl::SetError(ipc::ErrorDetails* error_details,
     }
 }
 
+::grpc::Status AsolServiceImpl::Wait(
+    const std::function<void(DoneCallback)>& handler) {
+    std::promise<::grpc::Status> status_promise;
+    std::future<::grpc::Status> status = status_promise.get_future();
+    handler([&status_promise](::grpc::Status handler_status) {
+        status_promise.set_value(std::move(handler_status));
+    });
+    return status.get();
+}
+
+template <typename Message>
+::grpc::Status AsolServiceImpl::WaitAndWrite(
+    ::grpc::ServerWriter<Message>* writer,
+    const std::function<void(StreamWriter<Message>, DoneCallback)>& handler) {
+    // The handler produces messages on adapter threads; this thread writes
+    // them, so a slow client holds back only its own RPC.
+    struct Queue {
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<Message> chunks;
+        bool done = false;
+        bool client_gone = false;
+        ::grpc::Status status;
+    };
+    auto queue = std::make_shared<Queue>();
+
+    handler(
+        [queue](Message chunk) {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            if (queue->client_gone) {
+                return false;
+            }
+            queue->chunks.push_back(std::move(chunk));
+            queue->changed.notify_one();
+            return true;
+        },
+        [queue](::grpc::Status status) {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->status = std::move(status);
+            queue->done = true;
+            queue->changed.notify_one();
+        });
+
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    while (true) {
+        queue->changed.wait(lock, [&queue]() { return queue->done || !queue->chunks.empty(); });
+        if (queue->chunks.empty()) {
+            break; // Done and drained
+        }
+        Message chunk = std::move(queue->chunks.front());
+        queue->chunks.pop_front();
+        lock.unlock();
+        bool written = writer->Write(chunk);
+        lock.lock();
+        if (!written) {
+            queue->client_gone = true;
+            queue->chunks.clear();
+        }
+    }
+    return queue->status;
+}
+
+::grpc::Status AsolServiceImpl::AdapterFailure(const char* operation,
+                                               const char* fallback_message,
+                                               ipc::ErrorDetails adapter_error,
+                                               ipc::ErrorDetails* error_details) {
+    error_details->CopyFrom(adapter_error);
+    if (error_details->error_message().empty()) {
+        SetError(error_details, adapter_error.error_code() == 0 ? 500 : adapter_error.error_code(),
+                 fallback_message, "AI service could not complete the request.");
+    }
+    std::cerr << "AsolServiceImpl::" << operation << " Error from adapter: (" << error_details->error_code()
+              << ") " << error_details->error_message() << std::endl;
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, error_details->error_message());
+}
+
+void AsolServiceImpl::Admit(const char* method,
+                            const CallInfo& call,
+                            AdmittedWork work,
+                            RejectCallback reject,
+                            DoneCallback done) {
+    using Clock = AdmissionController::Clock;
+    // The controller measures on the steady clock
+    Clock::time_point steady_deadline = Clock::time_point::max();
+    if (call.deadline != Deadline::max()) {
+        steady_deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                             call.deadline - std::chrono::system_clock::now());
+    }
+
+    // Filled in by the router, read by the handler and the tracer
+    auto trace = std::make_shared<adapters::CallTrace>();
+    std::string upstream_traceparent;
+    if (tracer_.enabled()) {
+        CallSpans spans;
+        spans.parent = call.trace_parent;
+        spans.rpc = GatewayTracer::NewSpan(call.trace_parent);
+        spans.upstream = GatewayTracer::NewSpan(spans.rpc);
+        spans.submitted = std::chrono::system_clock::now();
+        upstream_traceparent = spans.upstream.ToTraceparent();
+        done = [this, method, spans, trace, done = std::move(done)](::grpc::Status status) {
+            RecordCallSpans(&tracer_, method, spans, *trace, status);
+            done(std::move(status));
+        };
+    } else {
+        // Not traced here, but the provider may still join the client's trace
+        upstream_traceparent = call.trace_parent.ToTraceparent();
+    }
+
+    Clock::time_point submitted = Clock::now();
+    if (request_recorder_.enabled()) {
+        done = [this, submitted, trace, done = std::move(done)](::grpc::Status status) {
+            // Calls shed before reaching the router have nothing to replay
+            if (!trace->operation.empty()) {
+                RequestRecorder::Request request;
+                request.start = submitted;
+                request.operation = trace->operation;
+                request.input_bytes = trace->input_bytes;
+                request.request_hash = trace->request_hash;
+                request.provider_id = trace->from_cache ? "" : trace->provider_id;
+                request.from_cache = trace->from_cache;
+                request.latency = Clock::now() - submitted;
+                request.success = status.ok();
+                request_recorder_.Record(request);
+            }
+            done(std::move(status));
+        };
+    }
+    admission_.Submit(steady_deadline, [this, method, submitted, steady_deadline, trace,
+                                        upstream_traceparent = std::move(upstream_traceparent),
+                                        work = std::move(work), reject = std::move(reject),
+                                        done = std::move(done)](AdmissionController::Outcome outcome) {
+        Clock::time_point started = Clock::now();
+        metrics_.RecordQueueTime(method, started - submitted);
+        trace->queue_time = started - submitted;
+        switch (outcome) {
+            case AdmissionController::Outcome::OVERLOADED:
+                std::cerr << "AsolServiceImpl: Shedding call; " << admission_.in_flight() << " in flight, "
+                          << admission_.queued() << " queued." << std::endl;
+                reject(503, "Gateway overloaded.", "The AI service is busy. Please try again shortly.",
+                       ::grpc::Status(::grpc::StatusCode::RESOURCE_EXHAUSTED, "Gateway overloaded."), done);
+                return;
+            case AdmissionController::Outcome::DEADLINE_EXCEEDED:
+                reject(504, "Not enough time left before the deadline.", "The request timed out.",
+                       ::grpc::Status(::grpc::StatusCode::DEADLINE_EXCEEDED,
+                                      "Not enough time left before the deadline."),
+                       done);
+                return;
+            case AdmissionController::Outcome::ADMITTED:
+                break;
+        }
+
+        adapters::CallOptions options;
+        options.trace = trace;
+        options.traceparent = upstream_traceparent;
+        if (steady_deadline != Clock::time_point::max()) {
+            options.timeout_ms = static_cast<int>(std::max<int64_t>(
+                1, std::chrono::duration_cast<std::chrono::milliseconds>(steady_deadline - started).count()));
+        }
+        work(options, [this, started, done](::grpc::Status status) {
+            admission_.Release(Clock::now() - started);
+            done(std::move(status));
+        });
+    });
+}
+
+AsolServiceImpl::DoneCallback AsolServiceImpl::TrackRpc(const char* method,
+                                                        const CallInfo& call,
+                                                        size_t request_bytes,
+                                                        std::function<size_t()> response_bytes,
+                                                        DoneCallback done) {
+    if (call.in_batch) {
+        return done;
+    }
+    auto started = std::chrono::steady_clock::now();
+    return [this, method, request_bytes, started, response_bytes = std::move(response_bytes),
+            done = std::move(done)](::grpc::Status status) {
+        metrics_.RecordRpc(method, StatusCodeName(status.error_code()), std::chrono::steady_clock::now() - started,
+                           request_bytes, response_bytes());
+        if (utils::StartupTrace* trace = utils::StartupTrace::Get()) {
+            trace->AddMark("first_rpc");
+        }
+        done(std::move(status));
+    };
+}
+
+template <typename Message>
+AsolServiceImpl::DoneCallback AsolServiceImpl::TrackStream(const char* method,
+                                                           const CallInfo& call,
+                                                           size_t request_bytes,
+                                                           StreamWriter<Message>* write,
+                                                           DoneCallback done) {
+    // Batch items complete on several threads at once
+    auto bytes = std::make_shared<std::atomic<size_t>>(0);
+    *write = [bytes, write = std::move(*write)](Message message) {
+        bytes->fetch_add(message.ByteSizeLong(), std::memory_order_relaxed);
+        if (utils::StartupTrace* trace = utils::StartupTrace::Get()) {
+            trace->AddMark("first_chunk"); // The gateway's first TTFT
+        }
+        return write(std::move(message));
+    };
+    return TrackRpc(method, call, request_bytes, [bytes]() { return bytes->load(); }, std::move(done));
+}
+
+template <typename Response>
+AsolServiceImpl::RejectCallback AsolServiceImpl::RejectInto(Response* response) {
+    return [this, response](int32_t code, const std::string& message, const std::string& user_message,
+                            ::grpc::Status status, DoneCallback done) {
+        response->set_success(false);
+        SetError(response->mutable_error_details(), code, message, user_message);
+        done(std::move(status));
+    };
+}
+
 ::grpc::Status AsolServiceImpl::GetSummary(
     ::grpc::ServerContext* context,
     const ipc::SummaryRequest* request,
     ipc::SummaryResponse* response) {
+    return Wait([&](DoneCallback done) {
+        HandleGetSummary(*request, CallInfo::FromContext(*context), response, std::move(done));
+    });
+}
+
+::grpc::Status AsolServiceImpl::TranslateText(
+    ::grpc::ServerContext* context,
+    const ipc::TranslationRequest* request,
+    ipc::TranslationResponse* response) {
+    return Wait([&](DoneCallback done) {
+        HandleTranslateText(*request, CallInfo::FromContext(*context), response, std::move(done));
+    });
+}
+
+::grpc::Status AsolServiceImpl::ChatWithJules(
+    ::grpc::ServerContext* context,
+    const ipc::ConversationRequest* request,
+    ipc::ConversationResponse* response) {
+    return Wait([&](DoneCallback done) {
+        HandleChatWithJules(*request, CallInfo::FromContext(*context), response, std::move(done));
+    });
+}
+
+::grpc::Status AsolServiceImpl::StreamSummary(
+    ::grpc::ServerContext* context,
+    const ipc::SummaryRequest* request,
+    ::grpc::ServerWriter<ipc::CompletionChunk>* writer) {
+    return WaitAndWrite<ipc::CompletionChunk>(writer, [&](ChunkWriter write, DoneCallback done) {
+        HandleStreamSummary(*request, CallInfo::FromContext(*context), std::move(write), std::move(done));
+    });
+}
+
+::grpc::Status AsolServiceImpl::StreamChat(
+    ::grpc::ServerContext* context,
+    const ipc::ConversationRequest* request,
+    ::grpc::ServerWriter<ipc::CompletionChunk>* writer) {
+    return WaitAndWrite<ipc::CompletionChunk>(writer, [&](ChunkWriter write, DoneCallback done) {
+        HandleStreamChat(*request, CallInfo::FromContext(*context), std::move(write), std::move(done));
+    });
+}
+
+::grpc::Status AsolServiceImpl::BatchSummarize(
+    ::grpc::ServerContext* context,
+    const ipc::BatchSummaryRequest* request,
+    ::grpc::ServerWriter<ipc::SummaryResponse>* writer) {
+    return WaitAndWrite<ipc::SummaryResponse>(
+        writer, [&](StreamWriter<ipc::SummaryResponse> write, DoneCallback done) {
+            HandleBatchSummarize(*request, CallInfo::FromContext(*context), std::move(write), std::move(done));
+        });
+}
+
+::grpc::Status AsolServiceImpl::BatchTranslate(
+    ::grpc::ServerContext* context,
+    const ipc::BatchTranslationRequest* request,
+    ::grpc::ServerWriter<ipc::TranslationResponse>* writer) {
+    return WaitAndWrite<ipc::TranslationResponse>(
+        writer, [&](StreamWriter<ipc::TranslationResponse> write, DoneCallback done) {
+            HandleBatchTranslate(*request, CallInfo::FromContext(*context), std::move(write), std::move(done));
+        });
+}
+
+std::string AsolServiceImpl::BuildJulesPrompt(const ipc::ConversationRequest& request) {
+    if (request.reset_session() && !request.session_id().empty()) {
+        session_store_.Erase(request.session_id());
+    }
+
+    // Construct prompt for Gemini
+    // TODO: Implement more sophisticated history management and prompt engineering.
+    std::ostringstream prompt_stream;
+    prompt_stream << "You are Jules, a friendly and helpful AI assistant for the DashAIBrowser.\n";
+    if (request.history_size() > 0 || request.session_id().empty()) {
+        // Older clients send the history themselves
+        for (const auto& history_line : request.history()) {
+            prompt_stream << history_line << "\n"; // Assuming history is already formatted "User: ..." or "Jules: ..."
+        }
+    } else {
+        for (const auto& history_line : session_store_.GetHistory(request.session_id())) {
+            prompt_stream << history_line << "\n";
+        }
+    }
+    prompt_stream << "User: " << request.user_message() << "\nJules: ";
+    return prompt_stream.str();
+}
+
+void AsolServiceImpl::HandleGetSummary(
+    const ipc::SummaryRequest& request,
+    const CallInfo& call,
+    ipc::SummaryResponse* response,
+    DoneCallback done) {
 
     std::cout << "AsolServiceImpl::GetSummary: Received request ID "
-              << request->request_id() << " for text: \""
-              << request->original_text().substr(0, 50) << "...\"" << std::endl;
+              << request.request_id() << " for text: \""
+              << request.original_text().substr(0, 50) << "...\"" << std::endl;
+    done = TrackRpc("GetSummary", call, request.ByteSizeLong(), [response]() { return response->ByteSizeLong(); },
+                    std::move(done));
 
-    response->set_request_id(request->request_id());
+    response->set_request_id(request.request_id());
 
-    if (!adapters_initialized_ || !gemini_adapter_) {
+    if (!adapters_initialized_ || !router_) {
         response->set_success(false);
         SetError(response->mutable_error_details(), 500, "AI adapter not available.", "Service not properly configured.");
-        return ::grpc::Status(::grpc::StatusCode::INTERNAL, "AI adapter not available.");
+        done(::grpc::Status(::grpc::StatusCode::INTERNAL, "AI adapter not available."));
+        return;
     }
 
-    if (request->original_text().empty()) {
+    std::string text_error;
+    std::shared_ptr<const std::string> text = OriginalText(request, call, &text_error);
+    if (!text) {
         response->set_success(false);
-        SetError(response->mutable_error_details(), 1001, "Original text is empty.", "Cannot summarize empty text.");
-        return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Original text is empty.");
+        SetError(response->mutable_error_details(), 1004, text_error, "Could not read the text to summarize.");
+        done(::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, text_error));
+        return;
     }
 
-    ipc::ErrorDetails adapter_error;
-    std::string summary = gemini_adapter_->GetSummary(
-        request->original_text(),
-        request->preferences(),
-        &adapter_error
-    );
+    if (text->empty()) {
+        response->set_success(false);
+        SetError(response->mutable_error_details(), 1001, "Original text is empty.", "Cannot summarize empty text.");
+        done(::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Original text is empty."));
+        return;
+    }
 
-    if (adapter_error.error_code() != 0 || (summary.empty() && adapter_error.error_message().empty())) {
+    if (!IsKnownProvider(request.preferences())) {
         response->set_success(false);
-        response->mutable_error_details()->CopyFrom(adapter_error);
-        if (response->error_details().error_message().empty()) {
-             SetError(response->mutable_error_details(), adapter_error.error_code() == 0 ? 500 : adapter_error.error_code(),
-                     "Adapter failed to produce summary and returned no error message.", "AI service could not complete the request.");
-        }
-        std::cerr << "AsolServiceImpl::GetSummary Error from adapter: (" << response->error_details().error_code()
-                  << ") " << response->error_details().error_message() << std::endl;
-        return ::grpc::Status(::grpc::StatusCode::INTERNAL, response->error_details().error_message());
+        SetError(response->mutable_error_details(), 1003, "Unknown AI provider.", "The selected AI provider is not available.");
+        done(::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Unknown AI provider."));
+        return;
     }
 
-    response->set_success(true);
-    response->set_summarized_text(summary);
+    Admit(
+        "GetSummary", call,
+        [this, &request, response, text](const adapters::CallOptions& options, DoneCallback done) {
+            router_->GetSummaryAsync(
+                *text,
+                request.preferences(),
+                options,
+                [this, response, trace = options.trace, done = std::move(done)](
+                    std::string summary, ipc::ErrorDetails adapter_error) {
+                    FillDiagnostics(*trace, response->mutable_diagnostic_info());
+                    if (adapter_error.error_code() != 0 || (summary.empty() && adapter_error.error_message().empty())) {
+                        response->set_success(false);
+                        done(AdapterFailure("GetSummary", "Adapter failed to produce summary and returned no error message.",
+                                            std::move(adapter_error), response->mutable_error_details()));
+                        return;
+                    }
 
-    std::cout << "AsolServiceImpl::GetSummary: Sending response for ID "
-              << response->request_id() << ", Success: " << response->success() << std::endl;
+                    response->set_success(true);
+                    response->set_summarized_text(std::move(summary));
 
-    return ::grpc::Status::OK;
+                    std::cout << "AsolServiceImpl::GetSummary: Sending response for ID "
+                              << response->request_id() << ", Success: " << response->success() << std::endl;
+                    done(::grpc::Status::OK);
+                });
+        },
+        RejectInto(response), std::move(done));
 }
 
-::grpc::Status AsolServiceImpl::TranslateText(
-    ::grpc::ServerContext* context,
-    const ipc::TranslationRequest* request,
-    ipc::TranslationResponse* response) {
+void AsolServiceImpl::HandleTranslateText(
+    const ipc::TranslationRequest& request,
+    const CallInfo& call,
+    ipc::TranslationResponse* response,
+    DoneCallback done) {
 
     std::cout << "AsolServiceImpl::TranslateText: Received request ID "
-              << request->request_id() << " to translate \""
-              << request->text_to_translate().substr(0, 50) << "...\" from "
-              << request->source_language_code() << " to " << request->target_language_code()
+              << request.request_id() << " to translate \""
+              << request.text_to_translate().substr(0, 50) << "...\" from "
+              << request.source_language_code() << " to " << request.target_language_code()
               << std::endl;
+    done = TrackRpc("TranslateText", call, request.ByteSizeLong(), [response]() { return response->ByteSizeLong(); },
+                    std::move(done));
 
-    response->set_request_id(request->request_id());
+    response->set_request_id(request.request_id());
 
-    if (!adapters_initialized_ || !gemini_adapter_) {
+    if (!adapters_initialized_ || !router_) {
         response->set_success(false);
         SetError(response->mutable_error_details(), 500, "AI adapter not available.", "Service not properly configured.");
-        return ::grpc::Status(::grpc::StatusCode::INTERNAL, "AI adapter not available.");
+        done(::grpc::Status(::grpc::StatusCode::INTERNAL, "AI adapter not available."));
+        return;
     }
 
-    if (request->text_to_translate().empty()) {
+    if (request.text_to_translate().empty()) {
         response->set_success(false);
         SetError(response->mutable_error_details(), 1001, "Text to translate is empty.", "Cannot translate empty text.");
-        return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Text to translate is empty.");
+        done(::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Text to translate is empty."));
+        return;
     }
-    if (request->target_language_code().empty()) {
+    if (request.target_language_code().empty()) {
         response->set_success(false);
         SetError(response->mutable_error_details(), 1002, "Target language code is missing.", "Please specify a target language.");
-        return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Target language code is missing.");
+        done(::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Target language code is missing."));
+        return;
     }
 
-    ipc::ErrorDetails adapter_error;
-    std::string translated_text = gemini_adapter_->TranslateText(
-        request->text_to_translate(),
-        request->source_language_code(),
-        request->target_language_code(),
-        request->preferences(),
-        &adapter_error
-    );
-
-    if (adapter_error.error_code() != 0 || (translated_text.empty() && adapter_error.error_message().empty())) {
+    if (!IsKnownProvider(request.preferences())) {
         response->set_success(false);
-        response->mutable_error_details()->CopyFrom(adapter_error);
-         if (response->error_details().error_message().empty()) {
-             SetError(response->mutable_error_details(), adapter_error.error_code() == 0 ? 500 : adapter_error.error_code(),
-                     "Adapter failed to produce translation and returned no error message.", "AI service could not complete the request.");
-        }
-        std::cerr << "AsolServiceImpl::TranslateText Error from adapter: (" << response->error_details().error_code()
-                  << ") " << response->error_details().error_message() << std::endl;
-        return ::grpc::Status(::grpc::StatusCode::INTERNAL, response->error_details().error_message());
+        SetError(response->mutable_error_details(), 1003, "Unknown AI provider.", "The selected AI provider is not available.");
+        done(::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Unknown AI provider."));
+        return;
     }
 
-    response->set_success(true);
-    response->set_translated_text(translated_text);
-    response->set_detected_source_language(
-        request->source_language_code() == "auto" ? "en_simulated_detection" : request->source_language_code()
-    );
+    std::string source_language_code = request.source_language_code();
+    Admit(
+        "TranslateText", call,
+        [this, &request, response, source_language_code](const adapters::CallOptions& options, DoneCallback done) {
+            router_->TranslateTextAsync(
+                request.text_to_translate(),
+                request.source_language_code(),
+                request.target_language_code(),
+                request.preferences(),
+                options,
+                [this, response, source_language_code, trace = options.trace, done = std::move(done)](
+                    std::string translated_text, ipc::ErrorDetails adapter_error) {
+                    FillDiagnostics(*trace, response->mutable_diagnostic_info());
+                    if (adapter_error.error_code() != 0 || (translated_text.empty() && adapter_error.error_message().empty())) {
+                        response->set_success(false);
+                        done(AdapterFailure("TranslateText", "Adapter failed to produce translation and returned no error message.",
+                                            std::move(adapter_error), response->mutable_error_details()));
+                        return;
+                    }
 
-    std::cout << "AsolServiceImpl::TranslateText: Sending response for ID "
-              << response->request_id() << ", Success: " << response->success() << std::endl;
+                    response->set_success(true);
+                    response->set_translated_text(std::move(translated_text));
+                    response->set_detected_source_language(
+                        source_language_code == "auto" ? "en_simulated_detection" : source_language_code
+                    );
 
-    return ::grpc::Status::OK;
+                    std::cout << "AsolServiceImpl::TranslateText: Sending response for ID "
+                              << response->request_id() << ", Success: " << response->success() << std::endl;
+                    done(::grpc::Status::OK);
+                });
+        },
+        RejectInto(response), std::move(done));
 }
 
-::grpc::Status AsolServiceImpl::ChatWithJules(
-    ::grpc::ServerContext* context,
-    const ipc::ConversationRequest* request,
-    ipc::ConversationResponse* response) {
+void AsolServiceImpl::HandleChatWithJules(
+    const ipc::ConversationRequest& request,
+    const CallInfo& call,
+    ipc::ConversationResponse* response,
+    DoneCallback done) {
 
     std::cout << "AsolServiceImpl::ChatWithJules: Received request ID "
-              << request->request_id() << " for session_id: " << request->session_id()
-              << " User message: \"" << request->user_message().substr(0, 50) << "...\"" << std::endl;
+              << request.request_id() << " for session_id: " << request.session_id()
+              << " User message: \"" << request.user_message().substr(0, 50) << "...\"" << std::endl;
+    done = TrackRpc("ChatWithJules", call, request.ByteSizeLong(), [response]() { return response->ByteSizeLong(); },
+                    std::move(done));
 
-    response->set_request_id(request->request_id());
-    response->set_session_id(request->session_id());
+    response->set_request_id(request.request_id());
+    response->set_session_id(request.session_id());
 
-    if (!adapters_initialized_ || !gemini_adapter_) {
+    if (!adapters_initialized_ || !router_) {
         response->set_success(false);
         SetError(response->mutable_error_details(), 500, "AI adapter not available.", "Service not properly configured.");
-        return ::grpc::Status(::grpc::StatusCode::INTERNAL, "AI adapter not available.");
+        done(::grpc::Status(::grpc::StatusCode::INTERNAL, "AI adapter not available."));
+        return;
     }
 
-    if (request->user_message().empty()) {
+    if (request.user_message().empty()) {
         response->set_success(false);
         SetError(response->mutable_error_details(), 1001, "User message is empty.", "Cannot chat with an empty message.");
-        return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "User message is empty.");
+        done(::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "User message is empty."));
+        return;
     }
 
-    // Construct prompt for Gemini
-    // TODO: Implement more sophisticated history management and prompt engineering.
-    std::ostringstream prompt_stream;
-    prompt_stream << "You are Jules, a friendly and helpful AI assistant for the DashAIBrowser.\n";
-    for (const auto& history_line : request->history()) {
-        prompt_stream << history_line << "\n"; // Assuming history is already formatted "User: ..." or "Jules: ..."
+    if (!IsKnownProvider(request.preferences())) {
+        response->set_success(false);
+        SetError(response->mutable_error_details(), 1003, "Unknown AI provider.", "The selected AI provider is not available.");
+        done(::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Unknown AI provider."));
+        return;
     }
-    prompt_stream << "User: " << request->user_message() << "\nJules: ";
-    std::string full_prompt = prompt_stream.str();
 
-    ipc::ErrorDetails adapter_error;
-    std::string jules_reply = gemini_adapter_->GenerateText(
-        full_prompt,
-        request->preferences(),
-        &adapter_error
-    );
+    Admit(
+        "ChatWithJules", call,
+        [this, &request, response](const adapters::CallOptions& options, DoneCallback done) {
+            router_->GenerateTextAsync(
+                BuildJulesPrompt(request),
+                request.preferences(),
+                options,
+                [this, response, user_message = request.user_message(), trace = options.trace,
+                 done = std::move(done)](std::string jules_reply, ipc::ErrorDetails adapter_error) {
+                    FillDiagnostics(*trace, response->mutable_diagnostic_info());
+                    if (adapter_error.error_code() != 0 || (jules_reply.empty() && adapter_error.error_message().empty())) {
+                        response->set_success(false);
+                        done(AdapterFailure("ChatWithJules", "Adapter failed to generate text and returned no error message.",
+                                            std::move(adapter_error), response->mutable_error_details()));
+                        return;
+                    }
 
-    if (adapter_error.error_code() != 0 || (jules_reply.empty() && adapter_error.error_message().empty())) {
-        response->set_success(false);
-        response->mutable_error_details()->CopyFrom(adapter_error);
-        if (response->error_details().error_message().empty()) {
-            SetError(response->mutable_error_details(), adapter_error.error_code() == 0 ? 500 : adapter_error.error_code(),
-                     "Adapter failed to generate text and returned no error message.", "AI service could not complete the request.");
-        }
-        std::cerr << "AsolServiceImpl::ChatWithJules Error from adapter: (" << response->error_details().error_code()
-                  << ") " << response->error_details().error_message() << std::endl;
-        return ::grpc::Status(::grpc::StatusCode::INTERNAL, response->error_details().error_message());
+                    if (!response->session_id().empty()) {
+                        session_store_.AppendTurn(response->session_id(), user_message, jules_reply);
+                    }
+                    response->set_success(true);
+                    response->set_jules_response(std::move(jules_reply));
+
+                    std::cout << "AsolServiceImpl::ChatWithJules: Sending response for ID "
+                              << response->request_id() << ", Success: " << response->success() << std::endl;
+                    done(::grpc::Status::OK);
+                });
+        },
+        RejectInto(response), std::move(done));
+}
+
+
+void AsolServiceImpl::FailStream(const std::string& request_id,
+                                 const std::string& session_id,
+                                 int32_t code,
+                                 const std::string& message,
+                                 const std::string& user_message,
+                                 ::grpc::Status status,
+                                 const ChunkWriter& write,
+                                 const DoneCallback& done) {
+    ipc::CompletionChunk chunk;
+    chunk.set_request_id(request_id);
+    chunk.set_session_id(session_id);
+    chunk.set_is_final(true);
+    SetError(chunk.mutable_error_details(), code, message, user_message);
+    write(std::move(chunk));
+    done(std::move(status));
+}
+
+void AsolServiceImpl::StreamFromAdapter(
+    const std::string& request_id,
+    const std::string& session_id,
+    const char* operation,
+    const CallInfo& call,
+    StreamStart start,
+    ChunkWriter write,
+    DoneCallback done) {
+    auto run = [this, request_id, session_id, operation, start = std::move(start), write](
+                   const adapters::CallOptions& options, DoneCallback done) {
+        start(
+            options,
+            [request_id, session_id, write](const std::string& delta, int32_t completion_tokens) {
+                ipc::CompletionChunk chunk;
+                chunk.set_request_id(request_id);
+                chunk.set_session_id(session_id);
+                chunk.set_text_delta(delta);
+                chunk.set_completion_tokens(completion_tokens);
+                return write(std::move(chunk));
+            },
+            [this, request_id, session_id, operation, write, trace = options.trace, done](
+                ipc::TokenUsage usage, ipc::ErrorDetails adapter_error) {
+                ipc::CompletionChunk chunk;
+                chunk.set_request_id(request_id);
+                chunk.set_session_id(session_id);
+                chunk.set_is_final(true);
+                FillDiagnostics(*trace, chunk.mutable_diagnostic_info());
+                if (adapter_error.error_code() != 0) {
+                    ::grpc::Status status = AdapterFailure(
+                        operation, "Adapter stream failed and returned no error message.",
+                        std::move(adapter_error), chunk.mutable_error_details());
+                    write(std::move(chunk));
+                    done(std::move(status));
+                    return;
+                }
+
+                std::cout << "AsolServiceImpl::" << operation << ": Stream finished for ID " << request_id
+                          << ", completion tokens: " << usage.completion_tokens() << std::endl;
+
+                chunk.set_completion_tokens(usage.completion_tokens());
+                *chunk.mutable_usage() = std::move(usage);
+                write(std::move(chunk));
+                done(::grpc::Status::OK);
+            });
+    };
+    auto reject = [this, request_id, session_id, write](int32_t code, const std::string& message,
+                                                        const std::string& user_message,
+                                                        ::grpc::Status status, DoneCallback done) {
+        FailStream(request_id, session_id, code, message, user_message, std::move(status), write, done);
+    };
+    Admit(operation, call, std::move(run), std::move(reject), std::move(done));
+}
+
+void AsolServiceImpl::HandleStreamSummary(
+    const ipc::SummaryRequest& request,
+    const CallInfo& call,
+    ChunkWriter write,
+    DoneCallback done) {
+
+    std::cout << "AsolServiceImpl::StreamSummary: Received request ID "
+              << request.request_id() << " for text: \""
+              << request.original_text().substr(0, 50) << "...\"" << std::endl;
+    done = TrackStream("StreamSummary", call, request.ByteSizeLong(), &write, std::move(done));
+
+    if (!adapters_initialized_ || !router_) {
+        FailStream(request.request_id(), request.session_id(), 500, "AI adapter not available.",
+                   "Service not properly configured.",
+                   ::grpc::Status(::grpc::StatusCode::INTERNAL, "AI adapter not available."), write, done);
+        return;
     }
 
-    response->set_success(true);
-    response->set_jules_response(jules_reply);
+    std::string text_error;
+    std::shared_ptr<const std::string> text = OriginalText(request, call, &text_error);
+    if (!text) {
+        FailStream(request.request_id(), request.session_id(), 1004, text_error,
+                   "Could not read the text to summarize.",
+                   ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, text_error), write, done);
+        return;
+    }
+
+    if (text->empty()) {
+        FailStream(request.request_id(), request.session_id(), 1001, "Original text is empty.",
+                   "Cannot summarize empty text.",
+                   ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Original text is empty."), write, done);
+        return;
+    }
 
-    std::cout << "AsolServiceImpl::ChatWithJules: Sending response for ID "
-              << response->request_id() << ", Success: " << response->success() << std::endl;
+    if (!IsKnownProvider(request.preferences())) {
+        FailStream(request.request_id(), request.session_id(), 1003, "Unknown AI provider.",
+                   "The selected AI provider is not available.",
+                   ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Unknown AI provider."), write, done);
+        return;
+    }
 
-    return ::grpc::Status::OK;
+    StreamFromAdapter(
+        request.request_id(), request.session_id(), "StreamSummary", call,
+        [this, &request, text](const adapters::CallOptions& options, auto on_delta, auto on_complete) {
+            router_->StreamSummary(*text, request.preferences(), options,
+                                   std::move(on_delta), std::move(on_complete));
+        },
+        std::move(write), std::move(done));
 }
 
+void AsolServiceImpl::HandleStreamChat(
+    const ipc::ConversationRequest& request,
+    const CallInfo& call,
+    ChunkWriter write,
+    DoneCallback done) {
+
+    std::cout << "AsolServiceImpl::StreamChat: Received request ID "
+              << request.request_id() << " for session_id: " << request.session_id()
+              << " User message: \"" << request.user_message().substr(0, 50) << "...\"" << std::endl;
+    done = TrackStream("StreamChat", call, request.ByteSizeLong(), &write, std::move(done));
+
+    if (!adapters_initialized_ || !router_) {
+        FailStream(request.request_id(), request.session_id(), 500, "AI adapter not available.",
+                   "Service not properly configured.",
+                   ::grpc::Status(::grpc::StatusCode::INTERNAL, "AI adapter not available."), write, done);
+        return;
+    }
+
+    if (request.user_message().empty()) {
+        FailStream(request.request_id(), request.session_id(), 1001, "User message is empty.",
+                   "Cannot chat with an empty message.",
+                   ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "User message is empty."), write, done);
+        return;
+    }
+
+    if (!IsKnownProvider(request.preferences())) {
+        FailStream(request.request_id(), request.session_id(), 1003, "Unknown AI provider.",
+                   "The selected AI provider is not available.",
+                   ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Unknown AI provider."), write, done);
+        return;
+    }
+
+    if (!request.session_id().empty()) {
+        // Collect the reply as it streams past, to record the turn
+        auto reply = std::make_shared<std::string>();
+        write = [this, reply, session_id = request.session_id(), user_message = request.user_message(),
+                 write = std::move(write)](ipc::CompletionChunk chunk) {
+            reply->append(chunk.text_delta());
+            if (chunk.is_final() && !chunk.has_error_details()) {
+                session_store_.AppendTurn(session_id, user_message, *reply);
+            }
+            return write(std::move(chunk));
+        };
+    }
+
+    StreamFromAdapter(
+        request.request_id(), request.session_id(), "StreamChat", call,
+        [this, &request](const adapters::CallOptions& options, auto on_delta, auto on_complete) {
+            router_->StreamText(BuildJulesPrompt(request), request.preferences(), options,
+                                std::move(on_delta), std::move(on_complete));
+        },
+        std::move(write), std::move(done));
+}
+
+size_t AsolServiceImpl::BatchConcurrency(int32_t requested) const {
+    size_t limit = static_cast<size_t>(std::max(1, max_batch_concurrency_));
+    if (requested > 0) {
+        limit = std::min(limit, static_cast<size_t>(requested));
+    }
+    return limit;
+}
+
+void AsolServiceImpl::HandleBatchSummarize(
+    const ipc::BatchSummaryRequest& request,
+    const CallInfo& call,
+    StreamWriter<ipc::SummaryResponse> write,
+    DoneCallback done) {
+
+    std::cout << "AsolServiceImpl::BatchSummarize: Received batch ID " << request.request_id()
+              << " with " << request.items_size() << " items" << std::endl;
+    done = TrackStream("BatchSummarize", call, request.ByteSizeLong(), &write, std::move(done));
+
+    if (request.items_size() == 0) {
+        done(::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Batch has no items."));
+        return;
+    }
+
+    CallInfo item_call = call;
+    item_call.in_batch = true;
+    auto run = std::make_shared<BatchRun<ipc::SummaryRequest, ipc::SummaryResponse>>(
+        request.items(), request.request_id(), BatchConcurrency(request.max_concurrency()),
+        [this, item_call](const ipc::SummaryRequest& item, ipc::SummaryResponse* response, DoneCallback item_done) {
+            HandleGetSummary(item, item_call, response, std::move(item_done));
+        },
+        std::move(write), std::move(done));
+    run->Pump();
+}
+
+void AsolServiceImpl::HandleBatchTranslate(
+    const ipc::BatchTranslationRequest& request,
+    const CallInfo& call,
+    StreamWriter<ipc::TranslationResponse> write,
+    DoneCallback done) {
+
+    std::cout << "AsolServiceImpl::BatchTranslate: Received batch ID " << request.request_id()
+              << " with " << request.items_size() << " items" << std::endl;
+    done = TrackStream("BatchTranslate", call, request.ByteSizeLong(), &write, std::move(done));
+
+    if (request.items_size() == 0) {
+        done(::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Batch has no items."));
+        return;
+    }
+
+    CallInfo item_call = call;
+    item_call.in_batch = true;
+    auto run = std::make_shared<BatchRun<ipc::TranslationRequest, ipc::TranslationResponse>>(
+        request.items(), request.request_id(), BatchConcurrency(request.max_concurrency()),
+        [this, item_call](const ipc::TranslationRequest& item, ipc::TranslationResponse* response,
+                          DoneCallback item_done) {
+            HandleTranslateText(item, item_call, response, std::move(item_done));
+        },
+        std::move(write), std::move(done));
+    run->Pump();
+}
 
 }  // namespace asol
 }  // namespace dashaibrowser
@@ -3,15 +3,46 @@
 
 #include "proto/asol_service.grpc.pb.h"
 #include "asol/adapters/gemini/gemini_text_adapter.h" // Include Gemini adapter
+#include "asol/adapters/mock/mock_text_adapter.h"
+#include "asol/cpp/admission_controller.h"
+#include "asol/cpp/gateway_metrics.h"
+#include "asol/cpp/gateway_tracer.h"
+#include "asol/cpp/provider_router.h"
+#include "asol/cpp/request_recorder.h"
+#include "asol/cpp/session_store.h"
 #include <grpcpp/grpcpp.h>
+#include <chrono>
+#include <functional> // For std::function
 #include <memory> // For std::unique_ptr
+#include <vector>
 
 namespace dashaibrowser {
 namespace asol {
 
 class AsolServiceImpl final : public ipc::AsolInterface::Service {
  public:
+  struct Config {
+    // Bounds the chat history kept for clients that send only the new turn
+    SessionStore::Config sessions;
+    // Bounds the calls working and waiting at once; the rest are shed with
+    // RESOURCE_EXHAUSTED
+    AdmissionController::Config admission;
+    // Items of one batch RPC in flight at once. Requests may ask for fewer.
+    int max_batch_concurrency = 8;
+    // Caching, fallback and provider health for the AI providers
+    ProviderRouter::Config routing;
+    // When set, these mock providers are served instead of Gemini, for
+    // load tests that must not reach, or pay for, the real providers
+    std::vector<adapters::MockProviderSpec> mock_providers;
+    // Where the spans of each call are exported; off by default
+    GatewayTracer::Config tracing;
+    // File the shape of each call is recorded to, for replay with
+    // cmd/replay_request_trace; empty records nothing
+    std::string request_trace_path;
+  };
+
   AsolServiceImpl();
+  explicit AsolServiceImpl(const Config& config);
   ~AsolServiceImpl() override;
 
   ::grpc::Status GetSummary(
@@ -29,16 +60,233 @@ class AsolServiceImpl final : public ipc::AsolInterface::Service {
       const ipc::ConversationRequest* request,
       ipc::ConversationResponse* response) override;
 
+  ::grpc::Status StreamSummary(
+      ::grpc::ServerContext* context,
+      const ipc::SummaryRequest* request,
+      ::grpc::ServerWriter<ipc::CompletionChunk>* writer) override;
+
+  ::grpc::Status StreamChat(
+      ::grpc::ServerContext* context,
+      const ipc::ConversationRequest* request,
+      ::grpc::ServerWriter<ipc::CompletionChunk>* writer) override;
+
+  ::grpc::Status BatchSummarize(
+      ::grpc::ServerContext* context,
+      const ipc::BatchSummaryRequest* request,
+      ::grpc::ServerWriter<ipc::SummaryResponse>* writer) override;
+
+  ::grpc::Status BatchTranslate(
+      ::grpc::ServerContext* context,
+      const ipc::BatchTranslationRequest* request,
+      ::grpc::ServerWriter<ipc::TranslationResponse>* writer) override;
+
+  // Open connections to the AI providers ahead of the first request.
+  // Non-blocking; connections are set up in the background.
+  void PreconnectProviders();
+
+  // The gateway's metrics in the Prometheus text format, of type
+  // GatewayMetrics::kContentType.
+  std::string RenderMetrics();
+
+  // Completes an RPC with its status. Runs exactly once, possibly on an
+  // adapter thread after the handler has returned.
+  using DoneCallback = std::function<void(::grpc::Status)>;
+
+  // When the client stops waiting for an RPC, from
+  // ServerContext::deadline(); time_point::max() when it set no deadline.
+  using Deadline = std::chrono::system_clock::time_point;
+
+  // What the handlers know about the RPC they serve.
+  struct CallInfo {
+    Deadline deadline = Deadline::max();
+    // The client is on this host (Unix socket or loopback), so it may hand
+    // payloads over in shared memory
+    bool local_peer = false;
+    // ServerContext::peer(), to check shared memory handovers against
+    std::string peer;
+    // An item of a batch RPC, which is counted in the metrics as part of
+    // the batch rather than as an RPC of its own
+    bool in_batch = false;
+    // The client's span, from the RPC's traceparent metadata; invalid when
+    // it sent none
+    GatewayTracer::SpanContext trace_parent;
+
+    static CallInfo FromContext(const ::grpc::ServerContext& context);
+  };
+
+  // Non-blocking bodies of the RPCs above, for the asynchronous server:
+  // they return once the adapter call is sent, fill |response| when it
+  // completes and then run |done|. |response| must stay alive until then;
+  // |call| is only read before they return.
+  // Calls pass admission control first and the adapter's HTTP timeout is
+  // cut to the time left before the deadline; a call that cannot finish in
+  // time fails with DEADLINE_EXCEEDED without reaching the provider.
+  void HandleGetSummary(const ipc::SummaryRequest& request,
+                        const CallInfo& call,
+                        ipc::SummaryResponse* response,
+                        DoneCallback done);
+  void HandleTranslateText(const ipc::TranslationRequest& request,
+                           const CallInfo& call,
+                           ipc::TranslationResponse* response,
+                           DoneCallback done);
+  void HandleChatWithJules(const ipc::ConversationRequest& request,
+                           const CallInfo& call,
+                           ipc::ConversationResponse* response,
+                           DoneCallback done);
+
+  // Queues |message| for the client without blocking. Returns false once
+  // the client has gone away, after which the handler stops the stream.
+  // Safe to call from any thread.
+  template <typename Message>
+  using StreamWriter = std::function<bool(Message message)>;
+  using ChunkWriter = StreamWriter<ipc::CompletionChunk>;
+
+  // Non-blocking bodies of the streaming RPCs. Chunks are written as the
+  // model produces them; the last has is_final set. Then |done| runs.
+  void HandleStreamSummary(const ipc::SummaryRequest& request,
+                           const CallInfo& call,
+                           ChunkWriter write,
+                           DoneCallback done);
+  void HandleStreamChat(const ipc::ConversationRequest& request,
+                        const CallInfo& call,
+                        ChunkWriter write,
+                        DoneCallback done);
+
+  // Non-blocking bodies of the batch RPCs. Each item's response is written
+  // when the item completes; |done| runs after the last one. Failed items,
+  // including ones shed by admission control, are reported in their
+  // response and do not fail the batch.
+  void HandleBatchSummarize(const ipc::BatchSummaryRequest& request,
+                            const CallInfo& call,
+                            StreamWriter<ipc::SummaryResponse> write,
+                            DoneCallback done);
+  void HandleBatchTranslate(const ipc::BatchTranslationRequest& request,
+                            const CallInfo& call,
+                            StreamWriter<ipc::TranslationResponse> write,
+                            DoneCallback done);
+
  private:
+  // Run |handler| and block until it completes; used by the synchronous
+  // RPCs.
+  static ::grpc::Status Wait(const std::function<void(DoneCallback)>& handler);
+
+  // Run a streaming |handler|, writing its messages to |writer| from the
+  // calling thread, and block until it completes.
+  template <typename Message>
+  static ::grpc::Status WaitAndWrite(
+      ::grpc::ServerWriter<Message>* writer,
+      const std::function<void(StreamWriter<Message>, DoneCallback)>& handler);
+
+  // Reports a call that will not run: fills the response or final chunk
+  // with the error, then completes with |status| through |done|.
+  using RejectCallback = std::function<void(int32_t code,
+                                            const std::string& message,
+                                            const std::string& user_message,
+                                            ::grpc::Status status,
+                                            DoneCallback done)>;
+
+  // The adapter call of an admitted RPC; |done| frees its admission slot.
+  using AdmittedWork = std::function<void(const adapters::CallOptions& options,
+                                          DoneCallback done)>;
+
+  // Run |work| once admission control lets the call through, with an HTTP
+  // timeout no longer than the time left before |call|'s deadline and a
+  // CallTrace to fill. A shed call gets |reject| with RESOURCE_EXHAUSTED or
+  // DEADLINE_EXCEEDED instead. Either way |done| runs once. The wait is
+  // recorded under |method|, and the call is traced as a span of |method|
+  // under the client's span, with the admission wait and the provider call
+  // as its children. Calls that reach the router are also recorded in
+  // request_recorder_.
+  void Admit(const char* method,
+             const CallInfo& call,
+             AdmittedWork work,
+             RejectCallback reject,
+             DoneCallback done);
+
+  // Wrap |done| to record the RPC in metrics_ when it completes, unless
+  // |call| is a batch item. |response_bytes| is read then.
+  DoneCallback TrackRpc(const char* method,
+                        const CallInfo& call,
+                        size_t request_bytes,
+                        std::function<size_t()> response_bytes,
+                        DoneCallback done);
+
+  // TrackRpc() for a streaming RPC: also wraps |write| to count the bytes
+  // it sends.
+  template <typename Message>
+  DoneCallback TrackStream(const char* method,
+                           const CallInfo& call,
+                           size_t request_bytes,
+                           StreamWriter<Message>* write,
+                           DoneCallback done);
+
+  // A RejectCallback that reports in a unary |response|.
+  template <typename Response>
+  RejectCallback RejectInto(Response* response);
+
+  // Items in flight for a batch that asked for |requested| (0: no limit).
+  size_t BatchConcurrency(int32_t requested) const;
+
+  // Starts an adapter stream with the given options and callbacks.
+  using StreamStart = std::function<void(const adapters::CallOptions&,
+                                         adapters::IGeminiTextAdapter::DeltaCallback,
+                                         adapters::IGeminiTextAdapter::StreamDoneCallback)>;
+
+  // Once admitted, forward the adapter's stream to |write| and end it with
+  // |done|.
+  void StreamFromAdapter(
+      const std::string& request_id,
+      const std::string& session_id,
+      const char* operation,
+      const CallInfo& call,
+      StreamStart start,
+      ChunkWriter write,
+      DoneCallback done);
+
+  // Send a final chunk carrying an error and complete with |status|.
+  void FailStream(const std::string& request_id,
+                  const std::string& session_id,
+                  int32_t code,
+                  const std::string& message,
+                  const std::string& user_message,
+                  ::grpc::Status status,
+                  const ChunkWriter& write,
+                  const DoneCallback& done);
+
+  // The Gemini prompt for a turn of the Jules conversation. Uses the
+  // request's history if it has one, else the history kept for its session.
+  std::string BuildJulesPrompt(const ipc::ConversationRequest& request);
+
+  // Whether |prefs| names no provider or one the router has.
+  bool IsKnownProvider(const ipc::UserPreferences& prefs) const;
+
+  // Copy |adapter_error| into |error_details|, filling in
+  // |fallback_message| when the adapter gave none, and return the status.
+  ::grpc::Status AdapterFailure(const char* operation,
+                                const char* fallback_message,
+                                ipc::ErrorDetails adapter_error,
+                                ipc::ErrorDetails* error_details);
+
   void SetError(ipc::ErrorDetails* error_details,
                 int32_t code,
                 const std::string& message,
                 const std::string& user_message = "");
 
-  std::unique_ptr<adapters::IGeminiTextAdapter> gemini_adapter_;
+  // Declared first: the router records into it until destroyed
+  GatewayMetrics metrics_;
+  // Exports the spans still queued when destroyed, after the calls are done
+  GatewayTracer tracer_;
+  // Writes the lines still buffered when destroyed, after the calls are done
+  RequestRecorder request_recorder_;
+  // Every provider, behind the router's cache and fallback
+  std::unique_ptr<ProviderRouter> router_;
+  SessionStore session_store_;
+  AdmissionController admission_;
 
-  bool InitializeAdapters();
+  bool InitializeAdapters(const ProviderRouter::Config& routing_config,
+                          const std::vector<adapters::MockProviderSpec>& mock_providers);
   bool adapters_initialized_ = false;
+  const int max_batch_concurrency_;
 };
 
 }  // namespace asol
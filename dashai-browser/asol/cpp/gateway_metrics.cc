@@ -0,0 +1,224 @@
+#include "asol/cpp/gateway_metrics.h"
+#include <algorithm> // For std::lower_bound
+#include <sstream>
+#include <utility>
+
+namespace dashaibrowser {
+namespace asol {
+
+namespace {
+
+// Seconds, from a fast cache hit to a long generation
+std::vector<double> LatencyBounds() {
+    return {0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60};
+}
+
+// Bytes, from a short prompt to a large page
+std::vector<double> SizeBounds() {
+    return {256, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304, 16777216};
+}
+
+double Seconds(GatewayMetrics::Duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+std::string FormatNumber(double value) {
+    std::ostringstream stream;
+    stream.precision(12);
+    stream << value;
+    return stream.str();
+}
+
+// Label values escaped as the text format requires
+void AppendLabelValue(const std::string& value, std::string* out) {
+    for (char c : value) {
+        switch (c) {
+            case '\\': *out += "\\\\"; break;
+            case '"': *out += "\\\""; break;
+            case '\n': *out += "\\n"; break;
+            default: *out += c; break;
+        }
+    }
+}
+
+// {name="value",...} for a series, with |extra| (e.g. le="0.5") last
+std::string LabelSet(const std::vector<const char*>& names,
+                     const std::vector<std::string>& values,
+                     const std::string& extra = "") {
+    if (names.empty() && extra.empty()) {
+        return "";
+    }
+    std::string out = "{";
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (i > 0) {
+            out += ',';
+        }
+        out += names[i];
+        out += "=\"";
+        AppendLabelValue(values[i], &out);
+        out += '"';
+    }
+    if (!extra.empty()) {
+        if (!names.empty()) {
+            out += ',';
+        }
+        out += extra;
+    }
+    out += '}';
+    return out;
+}
+
+} // namespace
+
+const char GatewayMetrics::kContentType[] = "text/plain; version=0.0.4; charset=utf-8";
+
+GatewayMetrics::Family::Family(const char* name,
+                               const char* help,
+                               Type type,
+                               std::vector<const char*> label_names,
+                               std::vector<double> bounds)
+    : name(name), help(help), type(type), label_names(std::move(label_names)), bounds(std::move(bounds)) {}
+
+GatewayMetrics::GatewayMetrics()
+    : rpc_requests_("asol_rpc_requests_total", "RPCs completed, by method and gRPC status code.",
+                    Type::COUNTER, {"method", "code"}),
+      rpc_duration_("asol_rpc_duration_seconds", "Time from an RPC's arrival to its completion.",
+                    Type::HISTOGRAM, {"method"}, LatencyBounds()),
+      rpc_queue_time_("asol_rpc_queue_seconds", "Time calls waited for admission control.",
+                      Type::HISTOGRAM, {"method"}, LatencyBounds()),
+      rpc_request_bytes_("asol_rpc_request_bytes", "Serialized size of RPC requests.",
+                         Type::HISTOGRAM, {"method"}, SizeBounds()),
+      rpc_response_bytes_("asol_rpc_response_bytes", "Serialized size of RPC responses, summed over a stream.",
+                          Type::HISTOGRAM, {"method"}, SizeBounds()),
+      provider_latency_("asol_provider_latency_seconds", "Duration of calls to AI providers, per attempt.",
+                        Type::HISTOGRAM, {"provider", "operation"}, LatencyBounds()),
+      provider_first_token_("asol_provider_first_token_seconds", "Time to the first text of streamed provider calls.",
+                            Type::HISTOGRAM, {"provider"}, LatencyBounds()),
+      provider_errors_("asol_provider_errors_total", "Failed calls to AI providers, by error code.",
+                       Type::COUNTER, {"provider", "code"}),
+      provider_tokens_("asol_provider_tokens_total", "Tokens reported by AI providers.",
+                       Type::COUNTER, {"provider", "kind"}),
+      cache_requests_("asol_cache_requests_total", "Lookups in the response cache.",
+                      Type::COUNTER, {"operation", "result"}),
+      admission_in_flight_("asol_admission_in_flight", "Calls admitted and not yet complete.",
+                           Type::GAUGE, {}),
+      admission_queued_("asol_admission_queued", "Calls waiting for admission.",
+                        Type::GAUGE, {}) {}
+
+GatewayMetrics::~GatewayMetrics() = default;
+
+void GatewayMetrics::RecordRpc(const std::string& method,
+                               const std::string& code,
+                               Duration duration,
+                               size_t request_bytes,
+                               size_t response_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Add(&rpc_requests_, {method, code}, 1);
+    Observe(&rpc_duration_, {method}, Seconds(duration));
+    Observe(&rpc_request_bytes_, {method}, static_cast<double>(request_bytes));
+    Observe(&rpc_response_bytes_, {method}, static_cast<double>(response_bytes));
+}
+
+void GatewayMetrics::RecordQueueTime(const std::string& method, Duration wait) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Observe(&rpc_queue_time_, {method}, Seconds(wait));
+}
+
+void GatewayMetrics::RecordProviderCall(const std::string& provider,
+                                        const std::string& operation,
+                                        Duration latency,
+                                        int32_t error_code) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Observe(&provider_latency_, {provider, operation}, Seconds(latency));
+    if (error_code != 0) {
+        Add(&provider_errors_, {provider, std::to_string(error_code)}, 1);
+    }
+}
+
+void GatewayMetrics::RecordFirstToken(const std::string& provider, Duration latency) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Observe(&provider_first_token_, {provider}, Seconds(latency));
+}
+
+void GatewayMetrics::RecordTokens(const std::string& provider, int64_t prompt_tokens, int64_t completion_tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Add(&provider_tokens_, {provider, "prompt"}, static_cast<double>(prompt_tokens));
+    Add(&provider_tokens_, {provider, "completion"}, static_cast<double>(completion_tokens));
+}
+
+void GatewayMetrics::RecordCacheLookup(const std::string& operation, bool hit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Add(&cache_requests_, {operation, hit ? "hit" : "miss"}, 1);
+}
+
+void GatewayMetrics::SetAdmissionState(size_t in_flight, size_t queued) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Set(&admission_in_flight_, {}, static_cast<double>(in_flight));
+    Set(&admission_queued_, {}, static_cast<double>(queued));
+}
+
+void GatewayMetrics::Add(Family* family, std::vector<std::string> labels, double delta) {
+    family->series[std::move(labels)].value += delta;
+}
+
+void GatewayMetrics::Set(Family* family, std::vector<std::string> labels, double value) {
+    family->series[std::move(labels)].value = value;
+}
+
+void GatewayMetrics::Observe(Family* family, std::vector<std::string> labels, double value) {
+    Series& series = family->series[std::move(labels)];
+    if (series.bucket_counts.empty()) {
+        series.bucket_counts.resize(family->bounds.size() + 1);
+    }
+    // Bounds are inclusive: a value equal to a bound falls in its bucket
+    size_t bucket = std::lower_bound(family->bounds.begin(), family->bounds.end(), value) - family->bounds.begin();
+    series.bucket_counts[bucket]++;
+    series.count++;
+    series.value += value;
+}
+
+std::string GatewayMetrics::RenderPrometheus() const {
+    std::string out;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Family* family : {&rpc_requests_, &rpc_duration_, &rpc_queue_time_, &rpc_request_bytes_,
+                                 &rpc_response_bytes_, &provider_latency_, &provider_first_token_,
+                                 &provider_errors_, &provider_tokens_, &cache_requests_,
+                                 &admission_in_flight_, &admission_queued_}) {
+        Render(*family, &out);
+    }
+    return out;
+}
+
+void GatewayMetrics::Render(const Family& family, std::string* out) {
+    static const char* const kTypeNames[] = {"counter", "gauge", "histogram"};
+    *out += "# HELP ";
+    *out += family.name;
+    *out += ' ';
+    *out += family.help;
+    *out += "\n# TYPE ";
+    *out += family.name;
+    *out += ' ';
+    *out += kTypeNames[static_cast<int>(family.type)];
+    *out += '\n';
+
+    for (const auto& [labels, series] : family.series) {
+        if (family.type != Type::HISTOGRAM) {
+            *out += family.name + LabelSet(family.label_names, labels) + ' ' + FormatNumber(series.value) + '\n';
+            continue;
+        }
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i <= family.bounds.size(); ++i) {
+            cumulative += series.bucket_counts[i];
+            std::string le = i < family.bounds.size() ? FormatNumber(family.bounds[i]) : "+Inf";
+            *out += std::string(family.name) + "_bucket" +
+                    LabelSet(family.label_names, labels, "le=\"" + le + "\"") + ' ' +
+                    std::to_string(cumulative) + '\n';
+        }
+        std::string label_set = LabelSet(family.label_names, labels);
+        *out += std::string(family.name) + "_sum" + label_set + ' ' + FormatNumber(series.value) + '\n';
+        *out += std::string(family.name) + "_count" + label_set + ' ' + std::to_string(series.count) + '\n';
+    }
+}
+
+}  // namespace asol
+}  // namespace dashaibrowser
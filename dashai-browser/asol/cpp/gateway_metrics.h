@@ -0,0 +1,113 @@
+#ifndef DASHAI_BROWSER_ASOL_CPP_GATEWAY_METRICS_H_
+#define DASHAI_BROWSER_ASOL_CPP_GATEWAY_METRICS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dashaibrowser {
+namespace asol {
+
+// Counters and histograms of the gateway's RPCs and provider calls,
+// rendered in the Prometheus text format for the metrics port:
+//  - asol_rpc_*: per RPC method, from arrival to completion, with the
+//    gRPC status code, time waiting for admission control and message
+//    sizes.
+//  - asol_provider_*: per provider attempt, including ones the router fell
+//    back from, with upstream latency, time to first token and tokens used.
+//  - asol_cache_*: the router's response cache.
+// Label values come from small fixed sets (methods, provider ids, status
+// codes), so the number of series stays bounded. Thread-safe.
+class GatewayMetrics {
+public:
+    using Duration = std::chrono::steady_clock::duration;
+
+    // Content-Type of RenderPrometheus()
+    static const char kContentType[];
+
+    GatewayMetrics();
+    ~GatewayMetrics();
+
+    GatewayMetrics(const GatewayMetrics&) = delete;
+    GatewayMetrics& operator=(const GatewayMetrics&) = delete;
+
+    // An RPC of |method| that completed with the gRPC status |code|, e.g.
+    // "OK" or "RESOURCE_EXHAUSTED". Streams count all their messages.
+    void RecordRpc(const std::string& method,
+                   const std::string& code,
+                   Duration duration,
+                   size_t request_bytes,
+                   size_t response_bytes);
+
+    // Time a call of |method| waited before admission control ran or shed it
+    void RecordQueueTime(const std::string& method, Duration wait);
+
+    // One attempt at |provider|; |error_code| is 0 on success, else the
+    // adapter's (usually HTTP) error code.
+    void RecordProviderCall(const std::string& provider,
+                            const std::string& operation,
+                            Duration latency,
+                            int32_t error_code);
+    void RecordFirstToken(const std::string& provider, Duration latency);
+    void RecordTokens(const std::string& provider, int64_t prompt_tokens, int64_t completion_tokens);
+
+    void RecordCacheLookup(const std::string& operation, bool hit);
+
+    // Current load, sampled when the metrics are scraped
+    void SetAdmissionState(size_t in_flight, size_t queued);
+
+    std::string RenderPrometheus() const;
+
+private:
+    enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Series {
+        double value = 0;                   // Counters and gauges; sum for histograms
+        uint64_t count = 0;                 // Histograms only
+        std::vector<uint64_t> bucket_counts; // Not cumulative; one past the last bound for +Inf
+    };
+
+    struct Family {
+        Family(const char* name,
+               const char* help,
+               Type type,
+               std::vector<const char*> label_names,
+               std::vector<double> bounds = {});
+
+        const char* name;
+        const char* help;
+        Type type;
+        std::vector<const char*> label_names;
+        std::vector<double> bounds; // Histogram bucket upper bounds, ascending
+        std::map<std::vector<std::string>, Series> series; // By label values
+    };
+
+    void Add(Family* family, std::vector<std::string> labels, double delta);
+    void Set(Family* family, std::vector<std::string> labels, double value);
+    void Observe(Family* family, std::vector<std::string> labels, double value);
+
+    static void Render(const Family& family, std::string* out);
+
+    mutable std::mutex mutex_;
+    Family rpc_requests_;
+    Family rpc_duration_;
+    Family rpc_queue_time_;
+    Family rpc_request_bytes_;
+    Family rpc_response_bytes_;
+    Family provider_latency_;
+    Family provider_first_token_;
+    Family provider_errors_;
+    Family provider_tokens_;
+    Family cache_requests_;
+    Family admission_in_flight_;
+    Family admission_queued_;
+};
+
+}  // namespace asol
+}  // namespace dashaibrowser
+
+#endif  // DASHAI_BROWSER_ASOL_CPP_GATEWAY_METRICS_H_
@@ -0,0 +1,232 @@
+#include "asol/cpp/gateway_tracer.h"
+#include "asol/cpp/utils/curl_multi_http_client.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include <random>
+
+namespace dashaibrowser {
+namespace asol {
+
+const char kTraceparentKey[] = "traceparent";
+
+namespace {
+
+bool IsLowerHex(std::string_view text) {
+    for (char c : text) {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IsAllZero(std::string_view text) {
+    return text.find_first_not_of('0') == std::string_view::npos;
+}
+
+// |digits| random lowercase hex digits, not all zero
+std::string RandomHex(size_t digits) {
+    thread_local std::mt19937_64 engine{std::random_device{}()};
+    std::string hex;
+    do {
+        hex.clear();
+        while (hex.size() < digits) {
+            char word[17];
+            std::snprintf(word, sizeof(word), "%016llx", static_cast<unsigned long long>(engine()));
+            hex.append(word, std::min<size_t>(16, digits - hex.size()));
+        }
+    } while (IsAllZero(hex));
+    return hex;
+}
+
+void AppendJsonString(std::string_view text, std::string* out) {
+    out->push_back('"');
+    for (char c : text) {
+        switch (c) {
+            case '"': *out += "\\\""; break;
+            case '\\': *out += "\\\\"; break;
+            case '\n': *out += "\\n"; break;
+            case '\r': *out += "\\r"; break;
+            case '\t': *out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[7];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    *out += escaped;
+                } else {
+                    out->push_back(c);
+                }
+        }
+    }
+    out->push_back('"');
+}
+
+// OTLP/JSON carries 64-bit integers as strings
+std::string UnixNanos(std::chrono::system_clock::time_point time) {
+    return std::to_string(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+}
+
+void AppendAttribute(const std::string& key, const std::string& value, std::string* out) {
+    *out += "{\"key\":";
+    AppendJsonString(key, out);
+    *out += ",\"value\":{\"stringValue\":";
+    AppendJsonString(value, out);
+    *out += "}}";
+}
+
+} // namespace
+
+GatewayTracer::SpanContext GatewayTracer::SpanContext::Parse(std::string_view traceparent) {
+    // "00-" trace_id "-" span_id "-" flags
+    if (traceparent.size() != 55 || traceparent.substr(0, 3) != "00-" || traceparent[35] != '-' ||
+        traceparent[52] != '-') {
+        return SpanContext();
+    }
+    std::string_view trace_id = traceparent.substr(3, 32);
+    std::string_view span_id = traceparent.substr(36, 16);
+    if (!IsLowerHex(trace_id) || !IsLowerHex(span_id) || !IsLowerHex(traceparent.substr(53, 2)) ||
+        IsAllZero(trace_id) || IsAllZero(span_id)) {
+        return SpanContext();
+    }
+    SpanContext context;
+    context.trace_id = std::string(trace_id);
+    context.span_id = std::string(span_id);
+    return context;
+}
+
+std::string GatewayTracer::SpanContext::ToTraceparent() const {
+    if (!IsValid()) {
+        return "";
+    }
+    return "00-" + trace_id + "-" + span_id + "-01";
+}
+
+GatewayTracer::GatewayTracer(const Config& config, std::unique_ptr<utils::IHttpClient> http_client)
+    : config_(config), http_client_(std::move(http_client)) {
+    if (!enabled()) {
+        return;
+    }
+    if (!http_client_) {
+        http_client_ = std::make_unique<utils::CurlMultiHttpClient>();
+    }
+    export_thread_ = std::thread(&GatewayTracer::ExportLoop, this);
+}
+
+GatewayTracer::~GatewayTracer() {
+    if (!export_thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    export_thread_.join();
+}
+
+// static
+GatewayTracer::SpanContext GatewayTracer::NewSpan(const SpanContext& parent) {
+    SpanContext context;
+    context.trace_id = parent.IsValid() ? parent.trace_id : RandomHex(32);
+    context.span_id = RandomHex(16);
+    return context;
+}
+
+void GatewayTracer::Record(Span span) {
+    if (!enabled()) {
+        return;
+    }
+    bool batch_full;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.size() >= config_.max_queued_spans) {
+            ++dropped_;
+            return;
+        }
+        queue_.push_back(std::move(span));
+        batch_full = queue_.size() >= config_.max_batch_size;
+    }
+    if (batch_full) {
+        wake_.notify_one();
+    }
+}
+
+uint64_t GatewayTracer::dropped_spans() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+void GatewayTracer::ExportLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait_for(lock, config_.export_interval,
+                       [this] { return stopping_ || queue_.size() >= config_.max_batch_size; });
+        // On shutdown, keep going until the queue is empty
+        while (!queue_.empty()) {
+            size_t count = std::min(queue_.size(), config_.max_batch_size);
+            std::vector<Span> batch(std::make_move_iterator(queue_.begin()),
+                                    std::make_move_iterator(queue_.begin() + count));
+            queue_.erase(queue_.begin(), queue_.begin() + count);
+            lock.unlock();
+            Export(batch);
+            lock.lock();
+            if (!stopping_ && queue_.size() < config_.max_batch_size) {
+                break;
+            }
+        }
+        if (stopping_) {
+            return;
+        }
+    }
+}
+
+void GatewayTracer::Export(const std::vector<Span>& spans) {
+    utils::HttpResponse response = http_client_->Post(
+        config_.otlp_endpoint, EncodeOtlpJson(spans), {"Content-Type: application/json"},
+        config_.export_timeout_ms);
+    if (!response.IsSuccess()) {
+        // The spans are lost; tracing must not hold up or slow the gateway
+        std::cerr << "GatewayTracer: Export of " << spans.size() << " spans failed with HTTP "
+                  << response.status_code << std::endl;
+        std::lock_guard<std::mutex> lock(mutex_);
+        dropped_ += spans.size();
+    }
+}
+
+std::string GatewayTracer::EncodeOtlpJson(const std::vector<Span>& spans) const {
+    std::string json = "{\"resourceSpans\":[{\"resource\":{\"attributes\":[";
+    AppendAttribute("service.name", config_.service_name, &json);
+    json += "]},\"scopeSpans\":[{\"scope\":{\"name\":\"dashaibrowser.asol.gateway\"},\"spans\":[";
+    for (size_t i = 0; i < spans.size(); ++i) {
+        const Span& span = spans[i];
+        if (i > 0) {
+            json += ',';
+        }
+        json += "{\"traceId\":\"" + span.context.trace_id + "\",\"spanId\":\"" + span.context.span_id + "\"";
+        if (!span.parent_span_id.empty()) {
+            json += ",\"parentSpanId\":\"" + span.parent_span_id + "\"";
+        }
+        json += ",\"name\":";
+        AppendJsonString(span.name, &json);
+        json += ",\"kind\":" + std::to_string(static_cast<int>(span.kind));
+        json += ",\"startTimeUnixNano\":\"" + UnixNanos(span.start) + "\"";
+        json += ",\"endTimeUnixNano\":\"" + UnixNanos(span.end) + "\"";
+        json += ",\"attributes\":[";
+        for (size_t j = 0; j < span.attributes.size(); ++j) {
+            if (j > 0) {
+                json += ',';
+            }
+            AppendAttribute(span.attributes[j].first, span.attributes[j].second, &json);
+        }
+        // STATUS_CODE_OK = 1, STATUS_CODE_ERROR = 2
+        json += "],\"status\":{\"code\":" + std::string(span.error ? "2" : "1") + "}}";
+    }
+    json += "]}]}]}";
+    return json;
+}
+
+}  // namespace asol
+}  // namespace dashaibrowser
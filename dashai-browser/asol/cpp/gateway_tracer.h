@@ -0,0 +1,118 @@
+#ifndef DASHAI_BROWSER_ASOL_CPP_GATEWAY_TRACER_H_
+#define DASHAI_BROWSER_ASOL_CPP_GATEWAY_TRACER_H_
+
+#include "asol/cpp/utils/network_request_util.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dashaibrowser {
+namespace asol {
+
+// Metadata key of the W3C traceparent a client sends with an RPC, and the
+// header the adapters send upstream
+extern const char kTraceparentKey[];
+
+// GatewayTracer records spans of the gateway's RPCs and exports them to an
+// OpenTelemetry collector as OTLP/HTTP JSON. An RPC whose client sent a
+// traceparent, as the browser's ASOL layer does, joins the client's trace,
+// so one request can be followed from the browser's summarization feature
+// through the gateway to the provider.
+//
+// Record() only queues the span; a thread of the tracer's own posts the
+// queue in batches, so a slow or missing collector never delays an RPC.
+// When the queue is full, new spans are dropped. Thread-safe.
+class GatewayTracer {
+public:
+    struct Config {
+        // Collector's OTLP/HTTP traces URL, e.g.
+        // "http://localhost:4318/v1/traces"; empty disables tracing
+        std::string otlp_endpoint;
+        // The service.name resource attribute
+        std::string service_name = "asol-gateway";
+        // Spans per export request
+        size_t max_batch_size = 512;
+        // Longest a span waits before it is exported
+        std::chrono::milliseconds export_interval{5000};
+        // Spans held while the collector is slow or down
+        size_t max_queued_spans = 8192;
+        int export_timeout_ms = 10000;
+    };
+
+    // The W3C trace context of a span
+    struct SpanContext {
+        std::string trace_id; // 32 lowercase hex digits; empty if invalid
+        std::string span_id;  // 16 lowercase hex digits
+
+        bool IsValid() const { return !trace_id.empty(); }
+
+        // Invalid if |traceparent| is malformed
+        static SpanContext Parse(std::string_view traceparent);
+        std::string ToTraceparent() const;
+    };
+
+    // As in OTLP
+    enum class SpanKind { INTERNAL = 1, SERVER = 2, CLIENT = 3 };
+
+    struct Span {
+        std::string name;
+        SpanKind kind = SpanKind::INTERNAL;
+        SpanContext context;
+        std::string parent_span_id; // Empty for a root span
+        std::chrono::system_clock::time_point start;
+        std::chrono::system_clock::time_point end;
+        bool error = false;
+        std::vector<std::pair<std::string, std::string>> attributes;
+    };
+
+    // Exports through |http_client|; null for a CurlMultiHttpClient of the
+    // tracer's own
+    explicit GatewayTracer(const Config& config,
+                           std::unique_ptr<utils::IHttpClient> http_client = nullptr);
+    // Exports the spans still queued
+    ~GatewayTracer();
+
+    GatewayTracer(const GatewayTracer&) = delete;
+    GatewayTracer& operator=(const GatewayTracer&) = delete;
+
+    bool enabled() const { return !config_.otlp_endpoint.empty(); }
+
+    // A new span in |parent|'s trace, or in a new trace if |parent| is
+    // invalid
+    static SpanContext NewSpan(const SpanContext& parent);
+
+    // Queue |span| for export; does nothing when tracing is disabled
+    void Record(Span span);
+
+    // Spans dropped because the queue was full or the export failed
+    uint64_t dropped_spans() const;
+
+private:
+    void ExportLoop();
+    void Export(const std::vector<Span>& spans);
+    std::string EncodeOtlpJson(const std::vector<Span>& spans) const;
+
+    const Config config_;
+    std::unique_ptr<utils::IHttpClient> http_client_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<Span> queue_;
+    uint64_t dropped_ = 0;
+    bool stopping_ = false;
+    std::thread export_thread_;
+};
+
+}  // namespace asol
+}  // namespace dashaibrowser
+
+#endif  // DASHAI_BROWSER_ASOL_CPP_GATEWAY_TRACER_H_
@@ -1,8 +1,12 @@
 #include "asol/cpp/asol_gateway_server.h"
+#include "asol/adapters/mock/mock_text_adapter.h" // For ParseMockProviders
 #include "asol/cpp/utils/curl_http_client.h" // For GlobalInit/Cleanup
+#include "asol/cpp/utils/startup_trace.h" // Phases for the startup benchmark
 #include <iostream>
 #include <string>
 #include <csignal> // For signal handling (Ctrl+C)
+#include <algorithm> // For std::max
+#include <cstdlib> // For std::atoi
 #include <memory>  // For std::unique_ptr
 
 std::unique_ptr<dashaibrowser::asol::AsolGatewayServer> g_server_instance = nullptr;
@@ -22,6 +26,8 @@ void SignalHandler(int signum) {
 }
 
 int main(int argc, char** argv) {
+    dashaibrowser::asol::utils::StartupTrace::Start("gateway");
+
     // Initialize libcurl globally at the start of the application.
     if (!dashaibrowser::asol::utils::CurlHttpClient::GlobalInit()) {
         std::cerr << "Failed to initialize libcurl. Exiting." << std::endl;
@@ -31,13 +37,60 @@ int main(int argc, char** argv) {
     signal(SIGINT, SignalHandler);
     signal(SIGTERM, SignalHandler);
 
+    // Usage: asol_gateway [address] [--sync] [--completion-queues=N]
+    //                    [--max-concurrent-calls=N] [--metrics=ADDRESS|off]
+    //                    [--mock-providers=ID[:key=value...][,...]]
+    //                    [--otlp-endpoint=URL] [--record-requests=PATH]
     std::string server_address("0.0.0.0:50051");
-    if (argc > 1) {
-        server_address = argv[1];
+    dashaibrowser::asol::AsolGatewayServer::Config server_config;
+    const std::string kCompletionQueuesFlag = "--completion-queues=";
+    const std::string kMaxConcurrentCallsFlag = "--max-concurrent-calls=";
+    const std::string kMetricsFlag = "--metrics=";
+    const std::string kMockProvidersFlag = "--mock-providers=";
+    const std::string kOtlpEndpointFlag = "--otlp-endpoint=";
+    const std::string kRecordRequestsFlag = "--record-requests=";
+    auto config_parse_start = dashaibrowser::asol::utils::StartupTrace::Clock::now();
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--sync") {
+            server_config.async = false;
+        } else if (arg.rfind(kCompletionQueuesFlag, 0) == 0) {
+            server_config.num_completion_queues =
+                std::atoi(arg.c_str() + kCompletionQueuesFlag.size());
+        } else if (arg.rfind(kMaxConcurrentCallsFlag, 0) == 0) {
+            server_config.service.admission.max_concurrent = static_cast<size_t>(
+                std::max(1, std::atoi(arg.c_str() + kMaxConcurrentCallsFlag.size())));
+        } else if (arg.rfind(kMetricsFlag, 0) == 0) {
+            std::string metrics_address = arg.substr(kMetricsFlag.size());
+            server_config.metrics_address = metrics_address == "off" ? "" : metrics_address;
+        } else if (arg.rfind(kMockProvidersFlag, 0) == 0) {
+            // e.g. --mock-providers=fast:latency_ms=200,slow:latency_ms=900:error_rate=0.05
+            std::string error;
+            if (!dashaibrowser::asol::adapters::ParseMockProviders(
+                    arg.substr(kMockProvidersFlag.size()), &server_config.service.mock_providers, &error)) {
+                std::cerr << "Invalid --mock-providers: " << error << std::endl;
+                dashaibrowser::asol::utils::CurlHttpClient::GlobalCleanup();
+                return 1;
+            }
+        } else if (arg.rfind(kOtlpEndpointFlag, 0) == 0) {
+            // e.g. --otlp-endpoint=http://localhost:4318/v1/traces
+            server_config.service.tracing.otlp_endpoint = arg.substr(kOtlpEndpointFlag.size());
+        } else if (arg.rfind(kRecordRequestsFlag, 0) == 0) {
+            // e.g. --record-requests=/var/tmp/asol_requests.jsonl, for
+            // cmd/replay_request_trace
+            server_config.service.request_trace_path = arg.substr(kRecordRequestsFlag.size());
+        } else {
+            server_address = arg;
+        }
+    }
+
+    if (auto* startup_trace = dashaibrowser::asol::utils::StartupTrace::Get()) {
+        startup_trace->AddPhase("config_parse", config_parse_start,
+                                dashaibrowser::asol::utils::StartupTrace::Clock::now());
     }
 
     std::cout << "ASOL Gateway starting up..." << std::endl;
-    g_server_instance = std::make_unique<dashaibrowser::asol::AsolGatewayServer>();
+    g_server_instance = std::make_unique<dashaibrowser::asol::AsolGatewayServer>(server_config);
 
     std::cout << "Attempting to run server on address: " << server_address << std::endl;
     g_server_instance->Run(server_address);
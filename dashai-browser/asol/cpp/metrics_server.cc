@@ -0,0 +1,178 @@
+#include "asol/cpp/metrics_server.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream> // For logging
+#include <utility>
+
+namespace dashaibrowser {
+namespace asol {
+
+namespace {
+
+// Longest request head read; scrapers send a few hundred bytes
+constexpr size_t kMaxRequestBytes = 8192;
+
+// A scraper that stalls longer than this is dropped
+constexpr int kIoTimeoutSeconds = 5;
+
+void CloseFd(int* fd) {
+    if (*fd >= 0) {
+        close(*fd);
+        *fd = -1;
+    }
+}
+
+bool WriteAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+std::string HttpResponse(const char* status, const std::string& content_type, const std::string& body) {
+    return std::string("HTTP/1.0 ") + status + "\r\nContent-Type: " + content_type +
+           "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(RenderCallback render, std::string content_type)
+    : render_(std::move(render)), content_type_(std::move(content_type)) {}
+
+MetricsServer::~MetricsServer() {
+    Stop();
+}
+
+bool MetricsServer::Start(const std::string& address) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos || thread_.joinable()) {
+        std::cerr << "MetricsServer: Invalid address " << address << std::endl;
+        return false;
+    }
+    std::string host = address.substr(0, colon);
+    std::string port = address.substr(colon + 1);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* addresses = nullptr;
+    int lookup = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &addresses);
+    if (lookup != 0) {
+        std::cerr << "MetricsServer: Cannot resolve " << address << ": " << gai_strerror(lookup) << std::endl;
+        return false;
+    }
+    for (addrinfo* candidate = addresses; candidate && listen_fd_ < 0; candidate = candidate->ai_next) {
+        listen_fd_ = socket(candidate->ai_family, candidate->ai_socktype | SOCK_CLOEXEC, candidate->ai_protocol);
+        if (listen_fd_ < 0) {
+            continue;
+        }
+        int reuse = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(listen_fd_, candidate->ai_addr, candidate->ai_addrlen) != 0 || listen(listen_fd_, 16) != 0) {
+            CloseFd(&listen_fd_);
+        }
+    }
+    freeaddrinfo(addresses);
+    if (listen_fd_ < 0) {
+        std::cerr << "MetricsServer: Cannot listen on " << address << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (pipe2(wake_fds_, O_CLOEXEC) != 0) {
+        std::cerr << "MetricsServer: pipe2 failed: " << std::strerror(errno) << std::endl;
+        CloseFd(&listen_fd_);
+        return false;
+    }
+
+    thread_ = std::thread([this]() { Serve(); });
+    std::cout << "MetricsServer: Serving /metrics on " << address << std::endl;
+    return true;
+}
+
+void MetricsServer::Stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    char wake = 0;
+    while (write(wake_fds_[1], &wake, 1) < 0 && errno == EINTR) {
+    }
+    thread_.join();
+    CloseFd(&listen_fd_);
+    CloseFd(&wake_fds_[0]);
+    CloseFd(&wake_fds_[1]);
+}
+
+void MetricsServer::Serve() {
+    while (true) {
+        pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {wake_fds_[0], POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "MetricsServer: poll failed: " << std::strerror(errno) << std::endl;
+            return;
+        }
+        if (fds[1].revents != 0) {
+            return; // Stop()
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                HandleConnection(fd);
+                close(fd);
+            }
+        }
+    }
+}
+
+void MetricsServer::HandleConnection(int fd) {
+    timeval timeout = {kIoTimeoutSeconds, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < kMaxRequestBytes) {
+        ssize_t result = recv(fd, buffer, sizeof(buffer), 0);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(result));
+    }
+
+    // Only the request line matters: "GET /metrics HTTP/1.1", possibly
+    // with a query string
+    std::string line = request.substr(0, request.find("\r\n"));
+    bool is_get = line.rfind("GET ", 0) == 0;
+    std::string target = is_get ? line.substr(4, line.find(' ', 4) - 4) : "";
+    std::string path = target.substr(0, target.find('?'));
+    if (!is_get || path != "/metrics") {
+        WriteAll(fd, HttpResponse("404 Not Found", "text/plain", "Not found. Metrics are at /metrics.\n"));
+        return;
+    }
+    WriteAll(fd, HttpResponse("200 OK", content_type_, render_()));
+}
+
+}  // namespace asol
+}  // namespace dashaibrowser
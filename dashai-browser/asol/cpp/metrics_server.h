@@ -0,0 +1,46 @@
+#ifndef DASHAI_BROWSER_ASOL_CPP_METRICS_SERVER_H_
+#define DASHAI_BROWSER_ASOL_CPP_METRICS_SERVER_H_
+
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace dashaibrowser {
+namespace asol {
+
+// Minimal HTTP/1.0 server for Prometheus scrapes on a side port: answers
+// GET /metrics with the text from |render| and anything else with 404.
+// Scrapes are served one at a time on a thread of its own, so a slow
+// scraper never holds up a gRPC thread.
+class MetricsServer {
+public:
+    using RenderCallback = std::function<std::string()>;
+
+    MetricsServer(RenderCallback render, std::string content_type);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // Listen on |address|, "host:port" (e.g. "0.0.0.0:9464", "[::1]:9464")
+    // and start serving. False if the address cannot be bound.
+    bool Start(const std::string& address);
+
+    // Stop serving and join the thread. Safe to call more than once.
+    void Stop();
+
+private:
+    void Serve();
+    void HandleConnection(int fd);
+
+    const RenderCallback render_;
+    const std::string content_type_;
+    int listen_fd_ = -1;
+    int wake_fds_[2] = {-1, -1}; // Written by Stop() to end Serve()
+    std::thread thread_;
+};
+
+}  // namespace asol
+}  // namespace dashaibrowser
+
+#endif  // DASHAI_BROWSER_ASOL_CPP_METRICS_SERVER_H_
@@ -0,0 +1,563 @@
+#include "asol/cpp/provider_router.h"
+#include <algorithm> // For std::stable_sort
+#include <cstdint>
+#include <future>    // For the blocking calls
+#include <iostream>  // For logging
+#include <utility>
+
+namespace dashaibrowser {
+namespace asol {
+
+namespace {
+
+// Weight of the newest sample in the latency averages
+constexpr int kLatencyWeightInverse = 8;
+
+ipc::ErrorDetails NoProviderError() {
+    ipc::ErrorDetails error_details;
+    error_details.set_error_code(503);
+    error_details.set_error_message("No AI provider available.");
+    error_details.set_user_facing_message("The AI service is unavailable. Please try again later.");
+    return error_details;
+}
+
+// FNV-1a, so repeats of a request can be told apart in a trace without
+// recording it
+uint64_t HashKey(const std::string& key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+struct ProviderRouter::TextRoute {
+    const char* operation = nullptr;
+    std::string cache_key;
+    std::vector<Provider*> candidates;
+    size_t next = 0; // Next candidate to try
+    Clock::time_point deadline;
+    TextAttempt attempt;
+    TextCallback on_complete;
+    ipc::ErrorDetails last_error;
+    std::shared_ptr<adapters::CallTrace> trace; // The caller's; may be null
+    std::string traceparent;                     // Sent with every attempt
+};
+
+struct ProviderRouter::StreamRoute {
+    const char* operation = nullptr;
+    std::string cache_key;
+    std::vector<Provider*> candidates;
+    size_t next = 0; // Next candidate to try
+    Clock::time_point deadline;
+    StreamAttempt attempt;
+    DeltaCallback on_delta;
+    StreamDoneCallback on_complete;
+    ipc::ErrorDetails last_error;
+    std::shared_ptr<adapters::CallTrace> trace; // The caller's; may be null
+    std::string traceparent;                     // Sent with every attempt
+
+    // Of the current attempt, whose callbacks run in order
+    std::string text;
+    bool sent_text = false;
+    bool stopped = false; // The caller stopped reading
+    Clock::duration first_token_latency{};
+};
+
+ProviderRouter::ProviderRouter() : ProviderRouter(Config()) {}
+
+ProviderRouter::ProviderRouter(const Config& config) : ProviderRouter(config, nullptr) {}
+
+ProviderRouter::ProviderRouter(const Config& config, GatewayMetrics* metrics)
+    : config_(config), metrics_(metrics) {}
+
+ProviderRouter::~ProviderRouter() = default;
+
+void ProviderRouter::RegisterProvider(const std::string& provider_id,
+                                      std::unique_ptr<adapters::IGeminiTextAdapter> adapter) {
+    auto provider = std::make_unique<Provider>();
+    provider->id = provider_id;
+    provider->adapter = std::move(adapter);
+    providers_.push_back(std::move(provider));
+    std::cout << "ProviderRouter: Registered provider " << provider_id << std::endl;
+}
+
+bool ProviderRouter::HasProvider(const std::string& provider_id) const {
+    return std::any_of(providers_.begin(), providers_.end(),
+                       [&provider_id](const auto& provider) { return provider->id == provider_id; });
+}
+
+std::vector<std::string> ProviderRouter::GetProviderIds() const {
+    std::vector<std::string> ids;
+    for (const auto& provider : providers_) {
+        ids.push_back(provider->id);
+    }
+    return ids;
+}
+
+bool ProviderRouter::Initialize(const adapters::GeminiAdapterConfig& config) {
+    return !providers_.empty();
+}
+
+void ProviderRouter::Preconnect() {
+    for (const auto& provider : providers_) {
+        provider->adapter->Preconnect();
+    }
+}
+
+std::string ProviderRouter::Wait(const std::function<void(TextCallback)>& call,
+                                 ipc::ErrorDetails* error_details) {
+    std::promise<std::pair<std::string, ipc::ErrorDetails>> result_promise;
+    auto result = result_promise.get_future();
+    call([&result_promise](std::string text, ipc::ErrorDetails error) {
+        result_promise.set_value({std::move(text), std::move(error)});
+    });
+    auto [text, error] = result.get();
+    if (error_details) {
+        *error_details = std::move(error);
+    }
+    return text;
+}
+
+std::string ProviderRouter::GetSummary(
+    const std::string& text,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    dashaibrowser::ipc::ErrorDetails* error_details) {
+    return Wait([&](TextCallback on_complete) {
+        GetSummaryAsync(text, prefs, adapters::CallOptions(), std::move(on_complete));
+    }, error_details);
+}
+
+std::string ProviderRouter::TranslateText(
+    const std::string& text,
+    const std::string& source_lang_code,
+    const std::string& target_lang_code,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    dashaibrowser::ipc::ErrorDetails* error_details) {
+    return Wait([&](TextCallback on_complete) {
+        TranslateTextAsync(text, source_lang_code, target_lang_code, prefs, adapters::CallOptions(),
+                           std::move(on_complete));
+    }, error_details);
+}
+
+std::string ProviderRouter::GenerateText(
+    const std::string& prompt,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    dashaibrowser::ipc::ErrorDetails* error_details) {
+    return Wait([&](TextCallback on_complete) {
+        GenerateTextAsync(prompt, prefs, adapters::CallOptions(), std::move(on_complete));
+    }, error_details);
+}
+
+void ProviderRouter::GetSummaryAsync(
+    const std::string& text,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const adapters::CallOptions& options,
+    TextCallback on_complete) {
+    RouteText("summary", CacheKey("summary", prefs, {&text}), text.size(), prefs, options,
+              [text, prefs](adapters::IGeminiTextAdapter* adapter, const adapters::CallOptions& options,
+                            TextCallback on_complete) {
+                  adapter->GetSummaryAsync(text, prefs, options, std::move(on_complete));
+              },
+              std::move(on_complete));
+}
+
+void ProviderRouter::TranslateTextAsync(
+    const std::string& text,
+    const std::string& source_lang_code,
+    const std::string& target_lang_code,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const adapters::CallOptions& options,
+    TextCallback on_complete) {
+    RouteText("translation", CacheKey("translation", prefs, {&source_lang_code, &target_lang_code, &text}),
+              text.size(), prefs, options,
+              [text, source_lang_code, target_lang_code, prefs](
+                  adapters::IGeminiTextAdapter* adapter, const adapters::CallOptions& options,
+                  TextCallback on_complete) {
+                  adapter->TranslateTextAsync(text, source_lang_code, target_lang_code, prefs, options,
+                                              std::move(on_complete));
+              },
+              std::move(on_complete));
+}
+
+void ProviderRouter::GenerateTextAsync(
+    const std::string& prompt,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const adapters::CallOptions& options,
+    TextCallback on_complete) {
+    RouteText("generate", CacheKey("generate", prefs, {&prompt}), prompt.size(), prefs, options,
+              [prompt, prefs](adapters::IGeminiTextAdapter* adapter, const adapters::CallOptions& options,
+                              TextCallback on_complete) {
+                  adapter->GenerateTextAsync(prompt, prefs, options, std::move(on_complete));
+              },
+              std::move(on_complete));
+}
+
+void ProviderRouter::StreamSummary(
+    const std::string& text,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const adapters::CallOptions& options,
+    DeltaCallback on_delta,
+    StreamDoneCallback on_complete) {
+    // Shares cache entries with GetSummary(): the text is the same
+    RouteStream("summary", CacheKey("summary", prefs, {&text}), text.size(), prefs, options,
+                [text, prefs](adapters::IGeminiTextAdapter* adapter, const adapters::CallOptions& options,
+                              DeltaCallback on_delta, StreamDoneCallback on_complete) {
+                    adapter->StreamSummary(text, prefs, options, std::move(on_delta), std::move(on_complete));
+                },
+                std::move(on_delta), std::move(on_complete));
+}
+
+void ProviderRouter::StreamText(
+    const std::string& prompt,
+    const dashaibrowser::ipc::UserPreferences& prefs,
+    const adapters::CallOptions& options,
+    DeltaCallback on_delta,
+    StreamDoneCallback on_complete) {
+    RouteStream("generate", CacheKey("generate", prefs, {&prompt}), prompt.size(), prefs, options,
+                [prompt, prefs](adapters::IGeminiTextAdapter* adapter, const adapters::CallOptions& options,
+                                DeltaCallback on_delta, StreamDoneCallback on_complete) {
+                    adapter->StreamText(prompt, prefs, options, std::move(on_delta), std::move(on_complete));
+                },
+                std::move(on_delta), std::move(on_complete));
+}
+
+void ProviderRouter::RouteText(const char* operation,
+                               std::string cache_key,
+                               size_t input_bytes,
+                               const ipc::UserPreferences& prefs,
+                               const adapters::CallOptions& options,
+                               TextAttempt attempt,
+                               TextCallback on_complete) {
+    if (options.trace) {
+        options.trace->operation = operation;
+        options.trace->input_bytes = input_bytes;
+        options.trace->request_hash = HashKey(cache_key);
+    }
+    std::string cached;
+    if (CacheLookup(operation, cache_key, &cached)) {
+        if (options.trace) {
+            options.trace->from_cache = true;
+        }
+        on_complete(std::move(cached), ipc::ErrorDetails());
+        return;
+    }
+
+    auto route = std::make_shared<TextRoute>();
+    route->operation = operation;
+    route->trace = options.trace;
+    route->traceparent = options.traceparent;
+    route->cache_key = std::move(cache_key);
+    route->candidates = Candidates(prefs, LatencyKind::COMPLETION);
+    route->deadline = options.timeout_ms > 0 ? Clock::now() + std::chrono::milliseconds(options.timeout_ms)
+                                             : Clock::time_point::max();
+    route->attempt = std::move(attempt);
+    route->on_complete = std::move(on_complete);
+    route->last_error = NoProviderError();
+    TryText(std::move(route));
+}
+
+void ProviderRouter::TryText(std::shared_ptr<TextRoute> route) {
+    adapters::CallOptions options;
+    if (route->next >= route->candidates.size() || !OptionsBefore(route->deadline, &options)) {
+        route->on_complete("", std::move(route->last_error));
+        return;
+    }
+
+    Provider* provider = route->candidates[route->next++];
+    options.traceparent = route->traceparent;
+    // Collects the token usage the adapter reports
+    options.trace = std::make_shared<adapters::CallTrace>();
+    Clock::time_point started = Clock::now();
+    route->attempt(provider->adapter.get(), options,
+                   [this, route, provider, started, attempt_trace = options.trace](
+                       std::string text, ipc::ErrorDetails error_details) {
+                       Clock::duration latency = Clock::now() - started;
+                       RecordResult(provider, error_details, latency, LatencyKind::COMPLETION);
+                       TraceAttempt(route->operation, *provider, route->next, latency, error_details,
+                                    attempt_trace->usage, route->trace.get());
+                       if (error_details.error_code() == 0) {
+                           CacheStore(route->cache_key, text);
+                           route->on_complete(std::move(text), std::move(error_details));
+                           return;
+                       }
+                       if (ShouldFallBack(error_details) && route->next < route->candidates.size()) {
+                           std::cerr << "ProviderRouter: " << provider->id << " failed ("
+                                     << error_details.error_code() << "), falling back to "
+                                     << route->candidates[route->next]->id << std::endl;
+                           route->last_error = std::move(error_details);
+                           TryText(route);
+                           return;
+                       }
+                       route->on_complete("", std::move(error_details));
+                   });
+}
+
+void ProviderRouter::RouteStream(const char* operation,
+                                 std::string cache_key,
+                                 size_t input_bytes,
+                                 const ipc::UserPreferences& prefs,
+                                 const adapters::CallOptions& options,
+                                 StreamAttempt attempt,
+                                 DeltaCallback on_delta,
+                                 StreamDoneCallback on_complete) {
+    if (options.trace) {
+        options.trace->operation = operation;
+        options.trace->input_bytes = input_bytes;
+        options.trace->request_hash = HashKey(cache_key);
+    }
+    std::string cached;
+    if (CacheLookup(operation, cache_key, &cached)) {
+        if (options.trace) {
+            options.trace->from_cache = true;
+        }
+        on_delta(cached, 0);
+        on_complete(ipc::TokenUsage(), ipc::ErrorDetails());
+        return;
+    }
+
+    auto route = std::make_shared<StreamRoute>();
+    route->operation = operation;
+    route->trace = options.trace;
+    route->traceparent = options.traceparent;
+    route->cache_key = std::move(cache_key);
+    route->candidates = Candidates(prefs, LatencyKind::FIRST_TOKEN);
+    route->deadline = options.timeout_ms > 0 ? Clock::now() + std::chrono::milliseconds(options.timeout_ms)
+                                             : Clock::time_point::max();
+    route->attempt = std::move(attempt);
+    route->on_delta = std::move(on_delta);
+    route->on_complete = std::move(on_complete);
+    route->last_error = NoProviderError();
+    TryStream(std::move(route));
+}
+
+void ProviderRouter::TryStream(std::shared_ptr<StreamRoute> route) {
+    adapters::CallOptions options;
+    if (route->next >= route->candidates.size() || !OptionsBefore(route->deadline, &options)) {
+        route->on_complete(ipc::TokenUsage(), std::move(route->last_error));
+        return;
+    }
+
+    Provider* provider = route->candidates[route->next++];
+    options.traceparent = route->traceparent;
+    Clock::time_point started = Clock::now();
+    route->text.clear();
+    route->attempt(
+        provider->adapter.get(), options,
+        [route, started](const std::string& delta, int32_t completion_tokens) {
+            if (!route->sent_text) {
+                route->sent_text = true;
+                route->first_token_latency = Clock::now() - started;
+            }
+            route->text += delta;
+            route->stopped = !route->on_delta(delta, completion_tokens);
+            return !route->stopped;
+        },
+        [this, route, provider, started](ipc::TokenUsage usage, ipc::ErrorDetails error_details) {
+            if (route->stopped) {
+                // Ended by the caller; says nothing about the provider
+                route->on_complete(std::move(usage), std::move(error_details));
+                return;
+            }
+            Clock::duration latency = Clock::now() - started;
+            RecordResult(provider, error_details, route->sent_text ? route->first_token_latency : latency,
+                         LatencyKind::FIRST_TOKEN);
+            TraceAttempt(route->operation, *provider, route->next, latency, error_details, usage,
+                         route->trace.get());
+            if (route->sent_text) {
+                if (metrics_) {
+                    metrics_->RecordFirstToken(provider->id, route->first_token_latency);
+                }
+                if (route->trace) {
+                    route->trace->first_token_latency = route->first_token_latency;
+                }
+            }
+            if (error_details.error_code() == 0) {
+                CacheStore(route->cache_key, route->text);
+                route->on_complete(std::move(usage), std::move(error_details));
+                return;
+            }
+            // Text already sent cannot be taken back
+            if (!route->sent_text && ShouldFallBack(error_details) && route->next < route->candidates.size()) {
+                std::cerr << "ProviderRouter: " << provider->id << " stream failed ("
+                          << error_details.error_code() << "), falling back to "
+                          << route->candidates[route->next]->id << std::endl;
+                route->last_error = std::move(error_details);
+                TryStream(route);
+                return;
+            }
+            route->on_complete(ipc::TokenUsage(), std::move(error_details));
+        });
+}
+
+std::vector<ProviderRouter::Provider*> ProviderRouter::Candidates(const ipc::UserPreferences& prefs,
+                                                                  LatencyKind kind) const {
+    std::vector<Provider*> candidates;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Clock::time_point now = Clock::now();
+        for (const auto& provider : providers_) {
+            if (provider->open_until <= now) {
+                candidates.push_back(provider.get());
+            }
+        }
+        // Unmeasured providers (zero latency) sort first
+        std::stable_sort(candidates.begin(), candidates.end(), [kind](const Provider* a, const Provider* b) {
+            return kind == LatencyKind::COMPLETION ? a->latency < b->latency
+                                                   : a->first_token_latency < b->first_token_latency;
+        });
+    }
+
+    if (!prefs.preferred_provider().empty()) {
+        auto preferred = std::find_if(candidates.begin(), candidates.end(), [&prefs](const Provider* provider) {
+            return provider->id == prefs.preferred_provider();
+        });
+        if (preferred != candidates.end()) {
+            std::rotate(candidates.begin(), preferred, preferred + 1);
+        }
+    }
+    if (candidates.size() > config_.max_fallbacks + 1) {
+        candidates.resize(config_.max_fallbacks + 1);
+    }
+    return candidates;
+}
+
+void ProviderRouter::RecordResult(Provider* provider,
+                                  const ipc::ErrorDetails& error_details,
+                                  Clock::duration latency,
+                                  LatencyKind kind) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_details.error_code() == 0) {
+        provider->consecutive_failures = 0;
+        Clock::duration& average =
+            kind == LatencyKind::COMPLETION ? provider->latency : provider->first_token_latency;
+        if (average == Clock::duration::zero()) {
+            average = latency;
+        } else {
+            average += (latency - average) / kLatencyWeightInverse;
+        }
+        return;
+    }
+    if (!ShouldFallBack(error_details)) {
+        return; // The request's fault, not the provider's
+    }
+    // Past the threshold a provider stays one failure from reopening, so a
+    // failed trial call after open_duration takes it straight back out
+    if (++provider->consecutive_failures >= config_.failure_threshold) {
+        provider->open_until = Clock::now() + config_.open_duration;
+        std::cerr << "ProviderRouter: " << provider->id << " failed " << provider->consecutive_failures
+                  << " calls in a row; out of rotation for " << config_.open_duration.count() << "s" << std::endl;
+    }
+}
+
+void ProviderRouter::TraceAttempt(const char* operation,
+                                  const Provider& provider,
+                                  size_t attempts,
+                                  Clock::duration latency,
+                                  const ipc::ErrorDetails& error_details,
+                                  const ipc::TokenUsage& usage,
+                                  adapters::CallTrace* trace) {
+    if (metrics_) {
+        metrics_->RecordProviderCall(provider.id, operation, latency, error_details.error_code());
+        if (usage.prompt_tokens() > 0 || usage.completion_tokens() > 0) {
+            metrics_->RecordTokens(provider.id, usage.prompt_tokens(), usage.completion_tokens());
+        }
+    }
+    if (trace) {
+        trace->provider_id = provider.id;
+        trace->attempts = static_cast<int>(attempts);
+        trace->upstream_latency = latency;
+        trace->usage = usage;
+    }
+}
+
+bool ProviderRouter::ShouldFallBack(const ipc::ErrorDetails& error_details) {
+    int32_t code = error_details.error_code();
+    return code >= 500 || code == 408 || code == 429;
+}
+
+bool ProviderRouter::OptionsBefore(Clock::time_point deadline, adapters::CallOptions* options) {
+    if (deadline == Clock::time_point::max()) {
+        options->timeout_ms = 0;
+        return true;
+    }
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+    if (remaining <= 0) {
+        return false;
+    }
+    options->timeout_ms = static_cast<int>(remaining);
+    return true;
+}
+
+std::string ProviderRouter::CacheKey(const char* operation,
+                                     const ipc::UserPreferences& prefs,
+                                     const std::vector<const std::string*>& inputs) {
+    // Length-prefixed, so no two different requests share a key
+    std::string key = operation;
+    auto append = [&key](const std::string& part) {
+        key += '|';
+        key += std::to_string(part.size());
+        key += ':';
+        key += part;
+    };
+    append(std::to_string(prefs.summary_length()));
+    append(prefs.preferred_language());
+    append(prefs.preferred_provider());
+    for (const std::string* input : inputs) {
+        append(*input);
+    }
+    return key;
+}
+
+bool ProviderRouter::CacheLookup(const char* operation, const std::string& key, std::string* text) {
+    if (!config_.cache_enabled) {
+        return false;
+    }
+    bool hit = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cache_index_.find(key);
+        if (it != cache_index_.end() && it->second->expires <= Clock::now()) {
+            cache_bytes_ -= it->second->key.size() + it->second->text.size();
+            cache_.erase(it->second);
+            cache_index_.erase(it);
+        } else if (it != cache_index_.end()) {
+            cache_.splice(cache_.begin(), cache_, it->second);
+            *text = it->second->text;
+            hit = true;
+        }
+    }
+    if (metrics_) {
+        metrics_->RecordCacheLookup(operation, hit);
+    }
+    return hit;
+}
+
+void ProviderRouter::CacheStore(const std::string& key, const std::string& text) {
+    size_t bytes = key.size() + text.size();
+    if (!config_.cache_enabled || text.empty() || bytes > config_.cache_max_bytes) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_index_.find(key);
+    if (it != cache_index_.end()) {
+        cache_bytes_ -= it->second->key.size() + it->second->text.size();
+        cache_.erase(it->second);
+        cache_index_.erase(it);
+    }
+    cache_.push_front({key, text, Clock::now() + config_.cache_ttl});
+    cache_index_[key] = cache_.begin();
+    cache_bytes_ += bytes;
+    while (cache_.size() > config_.cache_max_entries || cache_bytes_ > config_.cache_max_bytes) {
+        const CacheEntry& oldest = cache_.back();
+        cache_bytes_ -= oldest.key.size() + oldest.text.size();
+        cache_index_.erase(oldest.key);
+        cache_.pop_back();
+    }
+}
+
+}  // namespace asol
+}  // namespace dashaibrowser
@@ -0,0 +1,243 @@
+#ifndef DASHAI_BROWSER_ASOL_CPP_PROVIDER_ROUTER_H_
+#define DASHAI_BROWSER_ASOL_CPP_PROVIDER_ROUTER_H_
+
+#include "asol/adapters/gemini/gemini_text_adapter.h"
+#include "asol/cpp/gateway_metrics.h"
+#include "proto/asol_service.pb.h"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dashaibrowser {
+namespace asol {
+
+// Routes the gateway's text calls across several AI providers. It follows
+// the model of asol::core::MultiAdapterManager, which the standalone
+// gateway cannot link since it depends on //base:
+//  - Responses are cached by operation, input and preferences, so
+//    repeated requests skip the provider round-trip.
+//  - A call goes to UserPreferences.preferred_provider when it is set
+//    and healthy, else to the provider with the lowest recent latency.
+//  - Transient failures (5xx, 408, 429, timeouts) fall back to the next
+//    provider in that order; input errors do not. A stream only falls back
+//    if it failed before sending any text.
+//  - A provider that fails failure_threshold calls in a row is skipped
+//    for open_duration, as with core::CircuitBreaker.
+//  - Every attempt and cache lookup is recorded in the gateway's metrics,
+//    and in the CallTrace of calls that pass one.
+//
+// The router is itself a text adapter, so callers keep using the adapter
+// interface. Register every provider before serving. Thread-safe after
+// that.
+class ProviderRouter : public adapters::IGeminiTextAdapter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Config {
+        // Providers tried after the first choice fails, at most
+        size_t max_fallbacks = 2;
+        bool cache_enabled = true;
+        size_t cache_max_entries = 1000;
+        size_t cache_max_bytes = 16 * 1024 * 1024;
+        std::chrono::seconds cache_ttl = std::chrono::hours(1);
+        // Failures in a row that take a provider out of rotation
+        int failure_threshold = 5;
+        std::chrono::seconds open_duration{30};
+    };
+
+    ProviderRouter();
+    explicit ProviderRouter(const Config& config);
+    // |metrics| may be null; otherwise it must outlive the router.
+    ProviderRouter(const Config& config, GatewayMetrics* metrics);
+    ~ProviderRouter() override;
+
+    ProviderRouter(const ProviderRouter&) = delete;
+    ProviderRouter& operator=(const ProviderRouter&) = delete;
+
+    // Add an initialized provider under |provider_id|. Providers with no
+    // latency recorded yet are tried first, in the order they were
+    // registered, so each one gets measured.
+    void RegisterProvider(const std::string& provider_id,
+                          std::unique_ptr<adapters::IGeminiTextAdapter> adapter);
+
+    bool HasProvider(const std::string& provider_id) const;
+    std::vector<std::string> GetProviderIds() const;
+
+    // Providers are initialized before they are registered; true once one
+    // has been.
+    bool Initialize(const adapters::GeminiAdapterConfig& config) override;
+
+    std::string GetSummary(
+        const std::string& text,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        dashaibrowser::ipc::ErrorDetails* error_details
+    ) override;
+
+    std::string TranslateText(
+        const std::string& text,
+        const std::string& source_lang_code,
+        const std::string& target_lang_code,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        dashaibrowser::ipc::ErrorDetails* error_details
+    ) override;
+
+    std::string GenerateText(
+        const std::string& prompt,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        dashaibrowser::ipc::ErrorDetails* error_details
+    ) override;
+
+    void Preconnect() override;
+
+    void GetSummaryAsync(
+        const std::string& text,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const adapters::CallOptions& options,
+        TextCallback on_complete
+    ) override;
+
+    void TranslateTextAsync(
+        const std::string& text,
+        const std::string& source_lang_code,
+        const std::string& target_lang_code,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const adapters::CallOptions& options,
+        TextCallback on_complete
+    ) override;
+
+    void GenerateTextAsync(
+        const std::string& prompt,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const adapters::CallOptions& options,
+        TextCallback on_complete
+    ) override;
+
+    void StreamSummary(
+        const std::string& text,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const adapters::CallOptions& options,
+        DeltaCallback on_delta,
+        StreamDoneCallback on_complete
+    ) override;
+
+    void StreamText(
+        const std::string& prompt,
+        const dashaibrowser::ipc::UserPreferences& prefs,
+        const adapters::CallOptions& options,
+        DeltaCallback on_delta,
+        StreamDoneCallback on_complete
+    ) override;
+
+private:
+    struct Provider {
+        std::string id;
+        std::unique_ptr<adapters::IGeminiTextAdapter> adapter;
+        // Guarded by mutex_. Moving averages of successful calls; zero
+        // until the first one.
+        Clock::duration latency{};
+        Clock::duration first_token_latency{};
+        int consecutive_failures = 0;
+        Clock::time_point open_until{};
+    };
+
+    // Which latency ranks providers for a call
+    enum class LatencyKind { COMPLETION, FIRST_TOKEN };
+
+    // State of one routed call, defined in the .cc
+    struct TextRoute;
+    struct StreamRoute;
+
+    using TextAttempt = std::function<void(adapters::IGeminiTextAdapter* adapter,
+                                           const adapters::CallOptions& options,
+                                           TextCallback on_complete)>;
+    using StreamAttempt = std::function<void(adapters::IGeminiTextAdapter* adapter,
+                                             const adapters::CallOptions& options,
+                                             DeltaCallback on_delta,
+                                             StreamDoneCallback on_complete)>;
+
+    // Serve from the cache, or try the candidates in turn. |operation|
+    // labels the call in the metrics; it and |input_bytes|, the size of the
+    // request's text, describe the call in its CallTrace.
+    void RouteText(const char* operation,
+                   std::string cache_key,
+                   size_t input_bytes,
+                   const ipc::UserPreferences& prefs,
+                   const adapters::CallOptions& options,
+                   TextAttempt attempt,
+                   TextCallback on_complete);
+    void TryText(std::shared_ptr<TextRoute> route);
+
+    void RouteStream(const char* operation,
+                     std::string cache_key,
+                     size_t input_bytes,
+                     const ipc::UserPreferences& prefs,
+                     const adapters::CallOptions& options,
+                     StreamAttempt attempt,
+                     DeltaCallback on_delta,
+                     StreamDoneCallback on_complete);
+    void TryStream(std::shared_ptr<StreamRoute> route);
+
+    // Providers to try for a call, best first: the preferred one, then the
+    // rest by |kind| latency, skipping those out of rotation.
+    std::vector<Provider*> Candidates(const ipc::UserPreferences& prefs, LatencyKind kind) const;
+
+    // Update |provider|'s health and latency after a call.
+    void RecordResult(Provider* provider,
+                      const ipc::ErrorDetails& error_details,
+                      Clock::duration latency,
+                      LatencyKind kind);
+
+    // Record an attempt at |provider| in the metrics and in |trace|, which
+    // may be null.
+    void TraceAttempt(const char* operation,
+                      const Provider& provider,
+                      size_t attempts,
+                      Clock::duration latency,
+                      const ipc::ErrorDetails& error_details,
+                      const ipc::TokenUsage& usage,
+                      adapters::CallTrace* trace);
+
+    // Whether another provider might succeed where one failed with
+    // |error_details|.
+    static bool ShouldFallBack(const ipc::ErrorDetails& error_details);
+
+    // Options for an attempt that must end by |deadline|; false once the
+    // deadline has passed.
+    static bool OptionsBefore(Clock::time_point deadline, adapters::CallOptions* options);
+
+    static std::string CacheKey(const char* operation,
+                                const ipc::UserPreferences& prefs,
+                                const std::vector<const std::string*>& inputs);
+    // Records the lookup under |operation|.
+    bool CacheLookup(const char* operation, const std::string& key, std::string* text);
+    void CacheStore(const std::string& key, const std::string& text);
+
+    // The text of a blocking call made through its async variant.
+    static std::string Wait(const std::function<void(TextCallback)>& call,
+                            ipc::ErrorDetails* error_details);
+
+    const Config config_;
+    GatewayMetrics* const metrics_;
+    std::vector<std::unique_ptr<Provider>> providers_;
+
+    mutable std::mutex mutex_;
+    struct CacheEntry {
+        std::string key;
+        std::string text;
+        Clock::time_point expires;
+    };
+    std::list<CacheEntry> cache_; // Most recently used first
+    std::unordered_map<std::string, std::list<CacheEntry>::iterator> cache_index_;
+    size_t cache_bytes_ = 0;
+};
+
+}  // namespace asol
+}  // namespace dashaibrowser
+
+#endif  // DASHAI_BROWSER_ASOL_CPP_PROVIDER_ROUTER_H_
@@ -0,0 +1,94 @@
+#include "asol/cpp/request_recorder.h"
+#include <cstdio>
+#include <iostream>
+
+namespace dashaibrowser {
+namespace asol {
+
+namespace {
+
+double Milliseconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// Provider ids come from the configuration, so only quotes and
+// backslashes need escaping
+std::string QuoteJson(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted.push_back('\\');
+        }
+        quoted.push_back(c);
+    }
+    quoted.push_back('"');
+    return quoted;
+}
+
+} // namespace
+
+RequestRecorder::RequestRecorder(const std::string& path) : origin_(Clock::now()) {
+    if (path.empty()) {
+        return;
+    }
+    out_.open(path, std::ios::out | std::ios::trunc);
+    enabled_ = out_.is_open();
+    if (!enabled_) {
+        std::cerr << "RequestRecorder: Cannot open " << path << "; not recording." << std::endl;
+    }
+}
+
+RequestRecorder::~RequestRecorder() {
+    if (enabled_) {
+        out_.flush();
+    }
+}
+
+void RequestRecorder::Record(const Request& request) {
+    if (!enabled_) {
+        return;
+    }
+    std::string line = EncodeLine(request, origin_);
+    line.push_back('\n');
+    // Buffered by the stream; written out as the buffer fills
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_ << line;
+}
+
+// static
+std::string RequestRecorder::EncodeLine(const Request& request, Clock::time_point origin) {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(request.request_hash));
+    char times[96];
+    std::snprintf(times, sizeof(times), "{\"t_ms\":%.3f,", Milliseconds(request.start - origin));
+
+    std::string line = times;
+    line += "\"task\":";
+    line += QuoteJson(TaskName(request.operation));
+    line += ",\"input_bytes\":" + std::to_string(request.input_bytes);
+    line += ",\"prompt_hash\":\"";
+    line += hash;
+    line += "\",\"provider\":" + QuoteJson(request.provider_id);
+    line += request.from_cache ? ",\"cache\":\"hit\"" : ",\"cache\":\"miss\"";
+    std::snprintf(times, sizeof(times), ",\"latency_ms\":%.3f", Milliseconds(request.latency));
+    line += times;
+    line += request.success ? ",\"success\":true}" : ",\"success\":false}";
+    return line;
+}
+
+// static
+const char* RequestRecorder::TaskName(const std::string& operation) {
+    if (operation == "summary") {
+        return "text_summarization";
+    }
+    if (operation == "translation") {
+        return "translation";
+    }
+    if (operation == "generate") {
+        return "text_generation";
+    }
+    return "custom";
+}
+
+}  // namespace asol
+}  // namespace dashaibrowser
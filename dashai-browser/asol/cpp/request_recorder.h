@@ -0,0 +1,69 @@
+#ifndef DASHAI_BROWSER_ASOL_CPP_REQUEST_RECORDER_H_
+#define DASHAI_BROWSER_ASOL_CPP_REQUEST_RECORDER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace dashaibrowser {
+namespace asol {
+
+// RequestRecorder writes the shape of each call the gateway serves to a
+// JSON-lines trace, in the format of the browser's
+// asol::core::RequestTraceRecorder, so production load can be replayed
+// with cmd/replay_request_trace. No text of the request is kept: its
+// operation, input size, a hash of its cache key, the provider, whether it
+// was a cache hit, its latency from arrival and whether it succeeded.
+// Response sizes are not known here and are left out. Thread-safe.
+class RequestRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        Clock::time_point start;        // When the call arrived
+        std::string operation;          // As in adapters::CallTrace
+        size_t input_bytes = 0;
+        uint64_t request_hash = 0;
+        std::string provider_id;        // Empty when served from cache
+        bool from_cache = false;
+        Clock::duration latency{};
+        bool success = false;
+    };
+
+    // Records to |path|, replacing any file there; an empty path, or one
+    // that cannot be opened, records nothing
+    explicit RequestRecorder(const std::string& path);
+    // Writes the lines still buffered
+    ~RequestRecorder();
+
+    RequestRecorder(const RequestRecorder&) = delete;
+    RequestRecorder& operator=(const RequestRecorder&) = delete;
+
+    bool enabled() const { return enabled_; }
+
+    // Does nothing when recording is disabled
+    void Record(const Request& request);
+
+    // One line of the trace, without the newline; |t_ms| of the line is
+    // measured from |origin|
+    static std::string EncodeLine(const Request& request, Clock::time_point origin);
+
+    // The trace's task name for a router operation: "summary" is
+    // "text_summarization" and so on
+    static const char* TaskName(const std::string& operation);
+
+private:
+    const Clock::time_point origin_;
+    bool enabled_ = false;
+
+    std::mutex mutex_;
+    std::ofstream out_;
+};
+
+}  // namespace asol
+}  // namespace dashaibrowser
+
+#endif  // DASHAI_BROWSER_ASOL_CPP_REQUEST_RECORDER_H_
@@ -0,0 +1,87 @@
+#include "asol/cpp/session_store.h"
+#include <utility>
+
+namespace dashaibrowser {
+namespace asol {
+
+SessionStore::SessionStore() : SessionStore(Config()) {}
+
+SessionStore::SessionStore(const Config& config) : config_(config) {}
+
+SessionStore::~SessionStore() = default;
+
+std::vector<std::string> SessionStore::GetHistory(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Clock::time_point now = Clock::now();
+    EvictLocked(now);
+    auto it = sessions_.find(session_id);
+    if (it == sessions_.end()) {
+        return {};
+    }
+    TouchLocked(&it->second, now);
+    return std::vector<std::string>(it->second.lines.begin(), it->second.lines.end());
+}
+
+void SessionStore::AppendTurn(const std::string& session_id,
+                              const std::string& user_message,
+                              const std::string& reply) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Clock::time_point now = Clock::now();
+    auto [it, inserted] = sessions_.try_emplace(session_id);
+    Session* session = &it->second;
+    if (inserted) {
+        lru_.push_front(session_id);
+        session->lru_position = lru_.begin();
+    }
+    AppendLineLocked(session, "User: " + user_message);
+    AppendLineLocked(session, "Jules: " + reply);
+    TouchLocked(session, now);
+    EvictLocked(now);
+}
+
+void SessionStore::Erase(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(session_id);
+    if (it == sessions_.end()) {
+        return;
+    }
+    lru_.erase(it->second.lru_position);
+    sessions_.erase(it);
+}
+
+size_t SessionStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.size();
+}
+
+void SessionStore::AppendLineLocked(Session* session, std::string line) {
+    session->bytes += line.size();
+    session->lines.push_back(std::move(line));
+    // Keep the newest lines; a single oversized line is still kept
+    while (session->lines.size() > 1 &&
+           (session->lines.size() > config_.max_lines_per_session ||
+            session->bytes > config_.max_bytes_per_session)) {
+        session->bytes -= session->lines.front().size();
+        session->lines.pop_front();
+    }
+}
+
+void SessionStore::TouchLocked(Session* session, Clock::time_point now) {
+    session->last_used = now;
+    lru_.splice(lru_.begin(), lru_, session->lru_position);
+}
+
+void SessionStore::EvictLocked(Clock::time_point now) {
+    while (!lru_.empty()) {
+        auto it = sessions_.find(lru_.back());
+        bool idle = now - it->second.last_used > config_.idle_timeout;
+        if (!idle && sessions_.size() <= config_.max_sessions) {
+            return;
+        }
+        sessions_.erase(it);
+        lru_.pop_back();
+    }
+}
+
+}  // namespace asol
+}  // namespace dashaibrowser
@@ -0,0 +1,83 @@
+#ifndef DASHAI_BROWSER_ASOL_CPP_SESSION_STORE_H_
+#define DASHAI_BROWSER_ASOL_CPP_SESSION_STORE_H_
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dashaibrowser {
+namespace asol {
+
+// Conversation history the gateway keeps per session_id, so chat clients
+// send only the new turn and request size stays constant however long the
+// chat runs. Follows the model of asol::core::ContextManager (one context
+// of role-tagged messages per ID), which the standalone gateway cannot
+// link since it depends on //base.
+//
+// Both dimensions are bounded: each session keeps its most recent lines
+// within a line and byte budget, and sessions are evicted least recently
+// used first, or once idle for too long. Thread-safe.
+class SessionStore {
+public:
+    struct Config {
+        size_t max_sessions = 10000;
+        // History lines kept per session; a turn adds two
+        size_t max_lines_per_session = 40;
+        size_t max_bytes_per_session = 32 * 1024;
+        std::chrono::seconds idle_timeout = std::chrono::minutes(30);
+    };
+
+    SessionStore();
+    explicit SessionStore(const Config& config);
+    ~SessionStore();
+
+    SessionStore(const SessionStore&) = delete;
+    SessionStore& operator=(const SessionStore&) = delete;
+
+    // History of |session_id|, oldest line first, formatted as
+    // "User: ..." and "Jules: ...". Empty for an unknown session.
+    std::vector<std::string> GetHistory(const std::string& session_id);
+
+    // Record a completed turn of |session_id|, creating the session if
+    // needed.
+    void AppendTurn(const std::string& session_id,
+                    const std::string& user_message,
+                    const std::string& reply);
+
+    // Forget |session_id|.
+    void Erase(const std::string& session_id);
+
+    size_t size() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Session {
+        std::deque<std::string> lines;
+        size_t bytes = 0;
+        Clock::time_point last_used;
+        std::list<std::string>::iterator lru_position;
+    };
+
+    void AppendLineLocked(Session* session, std::string line);
+    // Move |session| to the front of the LRU list.
+    void TouchLocked(Session* session, Clock::time_point now);
+    // Drop idle sessions and any over max_sessions.
+    void EvictLocked(Clock::time_point now);
+
+    const Config config_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Session> sessions_;
+    std::list<std::string> lru_; // Session IDs, most recently used first
+};
+
+}  // namespace asol
+}  // namespace dashaibrowser
+
+#endif  // DASHAI_BROWSER_ASOL_CPP_SESSION_STORE_H_
@@ -1,4 +1,5 @@
 #include "asol/cpp/utils/curl_http_client.h"
+#include "asol/cpp/utils/request_body.h" // For streamed, optionally compressed uploads
 #include <iostream> // For error logging
 #include <algorithm> // For std::remove_if, for header parsing later if needed
 
@@ -71,6 +72,10 @@ CurlHttpClient::~CurlHttpClient() {
     // Note: GlobalCleanup() should be called by the application, not per instance.
 }
 
+void CurlHttpClient::SetRequestCompression(const RequestCompressionOptions& compression) {
+    compression_ = compression;
+}
+
 HttpResponse CurlHttpClient::Post(const std::string& url,
                                   const std::string& request_body,
                                   const std::vector<std::string>& headers,
@@ -92,15 +97,15 @@ HttpResponse CurlHttpClient::Post(const std::string& url,
     // Set URL
     curl_easy_setopt(curl_handle_, CURLOPT_URL, url.c_str());
 
-    // Set POST method and request body
-    curl_easy_setopt(curl_handle_, CURLOPT_POSTFIELDS, request_body.c_str());
-    // If request_body can contain null bytes, use CURLOPT_POSTFIELDSIZE
-    // curl_easy_setopt(curl_handle_, CURLOPT_POSTFIELDSIZE, (long)request_body.length());
-
     // Set headers
     for (const auto& header : headers) {
         header_list = curl_slist_append(header_list, header.c_str());
     }
+
+    // Set POST method and stream the request body from the caller's buffer
+    // (or its compressed form); Post() blocks, so the buffer outlives the transfer.
+    std::unique_ptr<RequestBody> body = RequestBody::Borrow(request_body, compression_);
+    body->Attach(curl_handle_, &header_list);
     if (header_list) {
         curl_easy_setopt(curl_handle_, CURLOPT_HTTPHEADER, header_list);
     }
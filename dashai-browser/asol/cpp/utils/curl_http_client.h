@@ -29,6 +29,9 @@ public:
                       const std::vector<std::string>& headers,
                       int timeout_ms = 10000) override;
 
+    // Compress large request bodies for endpoints that accept it.
+    void SetRequestCompression(const RequestCompressionOptions& compression);
+
 private:
     // libcurl write callback function.
     // userdata is expected to be a pointer to a std::string.
@@ -41,6 +44,7 @@ private:
     // but focus on status code and body.
 
     CURL* curl_handle_ = nullptr; // Re-usable curl easy handle
+    RequestCompressionOptions compression_;
     static bool global_curl_initialized_;
 };
 
@@ -0,0 +1,483 @@
+#include "asol/cpp/utils/curl_multi_http_client.h"
+#include "asol/cpp/utils/request_body.h" // For streamed, optionally compressed uploads
+#include "asol/cpp/utils/startup_trace.h" // Reports the first warm-up
+#include <algorithm> // For std::find_if
+#include <future>    // For blocking Post() on an async transfer
+#include <iostream>  // For error logging
+
+namespace dashaibrowser {
+namespace asol {
+namespace utils {
+
+namespace {
+
+// How long the loop sleeps in curl_multi_poll() when nothing is due.
+// New submissions wake it early through curl_multi_wakeup().
+constexpr int kPollTimeoutMs = 1000;
+
+// Idle easy handles kept for reuse.
+constexpr size_t kMaxIdleEasyHandles = 16;
+
+// Upper bound on a connection warm-up or keep-alive ping.
+constexpr int kWarmUpTimeoutMs = 10000;
+
+// Whether |url| is served by |origin|, e.g. "https://host" or "https://host:443".
+bool IsSameOrigin(const std::string& url, const std::string& origin) {
+    if (url.compare(0, origin.size(), origin) != 0) {
+        return false;
+    }
+    return url.size() == origin.size() || url[origin.size()] == '/' ||
+           url[origin.size()] == '?';
+}
+
+std::string TrimWhitespace(const std::string& value) {
+    const char* whitespace = " \t\r\n";
+    size_t start = value.find_first_not_of(whitespace);
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = value.find_last_not_of(whitespace);
+    return value.substr(start, end - start + 1);
+}
+
+} // namespace
+
+// One in-flight request. The request body and header list must outlive the
+// transfer, since curl reads them lazily. Warm-up transfers have no body and
+// are sent as HEAD.
+struct CurlMultiHttpClient::Transfer {
+    CURL* easy_handle = nullptr;
+    std::string url;
+    std::unique_ptr<RequestBody> body;
+    struct curl_slist* header_list = nullptr;
+    int timeout_ms = 0;
+    HttpResponse response;
+    ResponseCallback on_complete;
+    // Set for streamed transfers; successful bodies bypass |response.body|.
+    ChunkCallback on_chunk;
+    // Whether on_chunk asked to stop the transfer.
+    bool cancelled = false;
+    // Whether GetActiveTransferCount() includes this transfer.
+    bool counted = false;
+
+    ~Transfer() {
+        if (header_list) {
+            curl_slist_free_all(header_list);
+        }
+    }
+};
+
+CurlMultiHttpClient::CurlMultiHttpClient() : CurlMultiHttpClient(Options()) {}
+
+CurlMultiHttpClient::CurlMultiHttpClient(const Options& options) : options_(options) {
+    multi_handle_ = curl_multi_init();
+    if (!multi_handle_) {
+        std::cerr << "CurlMultiHttpClient: curl_multi_init() failed." << std::endl;
+        return;
+    }
+
+    // Multiplex requests to the same host over one HTTP/2 connection, and
+    // cap sockets so bursts queue on existing connections instead of
+    // opening new ones.
+    curl_multi_setopt(multi_handle_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi_handle_, CURLMOPT_MAX_HOST_CONNECTIONS, options_.max_connections_per_host);
+    curl_multi_setopt(multi_handle_, CURLMOPT_MAX_TOTAL_CONNECTIONS, options_.max_total_connections);
+    curl_multi_setopt(multi_handle_, CURLMOPT_MAX_CONCURRENT_STREAMS, options_.max_concurrent_streams);
+    curl_multi_setopt(multi_handle_, CURLMOPT_MAXCONNECTS, options_.max_cached_connections);
+
+    // Connections already pool per multi handle; the share handle adds DNS
+    // results and TLS session tickets so reconnects resume cheaply.
+    share_handle_ = curl_share_init();
+    if (share_handle_) {
+        curl_share_setopt(share_handle_, CURLSHOPT_LOCKFUNC, ShareLock);
+        curl_share_setopt(share_handle_, CURLSHOPT_UNLOCKFUNC, ShareUnlock);
+        curl_share_setopt(share_handle_, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share_handle_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_handle_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+
+    loop_thread_ = std::thread(&CurlMultiHttpClient::RunEventLoop, this);
+    std::cout << "CurlMultiHttpClient: Event loop started." << std::endl;
+}
+
+CurlMultiHttpClient::~CurlMultiHttpClient() {
+    stopping_ = true;
+    if (multi_handle_) {
+        curl_multi_wakeup(multi_handle_);
+    }
+    if (loop_thread_.joinable()) {
+        loop_thread_.join();
+    }
+
+    // Fail whatever never finished so no caller waits forever.
+    for (auto& transfer : active_transfers_) {
+        curl_multi_remove_handle(multi_handle_, transfer->easy_handle);
+        FinishTransfer(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+    }
+    active_transfers_.clear();
+    std::vector<std::unique_ptr<Transfer>> pending;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending.swap(pending_transfers_);
+    }
+    for (auto& transfer : pending) {
+        FinishTransfer(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+    }
+
+    for (CURL* easy_handle : idle_easy_handles_) {
+        curl_easy_cleanup(easy_handle);
+    }
+    if (multi_handle_) {
+        curl_multi_cleanup(multi_handle_);
+    }
+    if (share_handle_) {
+        curl_share_cleanup(share_handle_);
+    }
+    std::cout << "CurlMultiHttpClient: Instance destroyed." << std::endl;
+}
+
+HttpResponse CurlMultiHttpClient::Post(const std::string& url,
+                                       const std::string& request_body,
+                                       const std::vector<std::string>& headers,
+                                       int timeout_ms) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    std::future<HttpResponse> result = promise->get_future();
+    // The caller waits for completion, so the upload can read its buffer directly.
+    std::unique_ptr<Transfer> transfer = CreateTransfer(
+        url, headers, timeout_ms, RequestBody::Borrow(request_body, options_.compression));
+    transfer->on_complete = [promise](HttpResponse response) {
+        promise->set_value(std::move(response));
+    };
+    SubmitTransfer(std::move(transfer));
+    return result.get();
+}
+
+void CurlMultiHttpClient::PostAsync(const std::string& url,
+                                    const std::string& request_body,
+                                    const std::vector<std::string>& headers,
+                                    int timeout_ms,
+                                    ResponseCallback on_complete) {
+    PostStream(url, request_body, headers, timeout_ms, nullptr, std::move(on_complete));
+}
+
+void CurlMultiHttpClient::PostStream(const std::string& url,
+                                     const std::string& request_body,
+                                     const std::vector<std::string>& headers,
+                                     int timeout_ms,
+                                     ChunkCallback on_chunk,
+                                     ResponseCallback on_complete) {
+    std::unique_ptr<Transfer> transfer = CreateTransfer(
+        url, headers, timeout_ms, RequestBody::Copy(request_body, options_.compression));
+    transfer->on_chunk = std::move(on_chunk);
+    transfer->on_complete = std::move(on_complete);
+    SubmitTransfer(std::move(transfer));
+}
+
+std::unique_ptr<CurlMultiHttpClient::Transfer> CurlMultiHttpClient::CreateTransfer(
+    const std::string& url,
+    const std::vector<std::string>& headers,
+    int timeout_ms,
+    std::unique_ptr<RequestBody> body) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->url = url;
+    transfer->body = std::move(body);
+    transfer->timeout_ms = timeout_ms;
+    for (const auto& header : headers) {
+        transfer->header_list = curl_slist_append(transfer->header_list, header.c_str());
+    }
+    return transfer;
+}
+
+void CurlMultiHttpClient::SubmitTransfer(std::unique_ptr<Transfer> transfer) {
+    if (!multi_handle_ || stopping_) {
+        FinishTransfer(std::move(transfer), CURLE_FAILED_INIT);
+        return;
+    }
+
+    transfer->counted = true;
+    active_count_++;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending_transfers_.push_back(std::move(transfer));
+    }
+    curl_multi_wakeup(multi_handle_);
+}
+
+void CurlMultiHttpClient::Preconnect(const std::vector<std::string>& origins) {
+    if (!multi_handle_ || stopping_ || origins.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending_warm_origins_.insert(pending_warm_origins_.end(), origins.begin(), origins.end());
+    }
+    curl_multi_wakeup(multi_handle_);
+}
+
+size_t CurlMultiHttpClient::GetActiveTransferCount() const {
+    return active_count_;
+}
+
+void CurlMultiHttpClient::RunEventLoop() {
+    while (!stopping_) {
+        MaintainWarmOrigins();
+        AttachPendingTransfers();
+
+        int running = 0;
+        CURLMcode code = curl_multi_perform(multi_handle_, &running);
+        if (code != CURLM_OK) {
+            std::cerr << "CurlMultiHttpClient: curl_multi_perform() failed: "
+                      << curl_multi_strerror(code) << std::endl;
+        }
+        ProcessCompletedTransfers();
+
+        // Sleeps until a socket is ready, a curl timer is due, or
+        // SubmitTransfer() calls curl_multi_wakeup().
+        code = curl_multi_poll(multi_handle_, nullptr, 0, kPollTimeoutMs, nullptr);
+        if (code != CURLM_OK) {
+            std::cerr << "CurlMultiHttpClient: curl_multi_poll() failed: "
+                      << curl_multi_strerror(code) << std::endl;
+        }
+    }
+}
+
+void CurlMultiHttpClient::AttachPendingTransfers() {
+    std::vector<std::unique_ptr<Transfer>> pending;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending.swap(pending_transfers_);
+    }
+
+    for (auto& transfer : pending) {
+        CURL* easy_handle = AcquireEasyHandle();
+        if (!easy_handle) {
+            FinishTransfer(std::move(transfer), CURLE_FAILED_INIT);
+            continue;
+        }
+        transfer->easy_handle = easy_handle;
+
+        // Real traffic keeps the connection alive as well as a ping would.
+        auto now = std::chrono::steady_clock::now();
+        for (WarmOrigin& warm : warm_origins_) {
+            if (IsSameOrigin(transfer->url, warm.origin)) {
+                warm.last_used = now;
+            }
+        }
+
+        curl_easy_setopt(easy_handle, CURLOPT_URL, transfer->url.c_str());
+        if (transfer->body) {
+            transfer->body->Attach(easy_handle, &transfer->header_list);
+        } else {
+            curl_easy_setopt(easy_handle, CURLOPT_NOBODY, 1L);
+        }
+        if (transfer->header_list) {
+            curl_easy_setopt(easy_handle, CURLOPT_HTTPHEADER, transfer->header_list);
+        }
+        curl_easy_setopt(easy_handle, CURLOPT_WRITEFUNCTION, WriteCallback);
+        curl_easy_setopt(easy_handle, CURLOPT_WRITEDATA, transfer.get());
+        curl_easy_setopt(easy_handle, CURLOPT_HEADERFUNCTION, HeaderCallback);
+        curl_easy_setopt(easy_handle, CURLOPT_HEADERDATA, transfer.get());
+        curl_easy_setopt(easy_handle, CURLOPT_PRIVATE, transfer.get());
+        if (transfer->timeout_ms > 0) {
+            curl_easy_setopt(easy_handle, CURLOPT_TIMEOUT_MS, static_cast<long>(transfer->timeout_ms));
+        }
+
+        // Prefer HTTP/2 over TLS, and wait for an in-progress connection to
+        // the host rather than opening a parallel one, so the new stream
+        // lands on it.
+        curl_easy_setopt(easy_handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(easy_handle, CURLOPT_PIPEWAIT, 1L);
+        curl_easy_setopt(easy_handle, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(easy_handle, CURLOPT_NOSIGNAL, 1L);
+        if (share_handle_) {
+            curl_easy_setopt(easy_handle, CURLOPT_SHARE, share_handle_);
+        }
+
+        CURLMcode code = curl_multi_add_handle(multi_handle_, easy_handle);
+        if (code != CURLM_OK) {
+            std::cerr << "CurlMultiHttpClient: curl_multi_add_handle() failed: "
+                      << curl_multi_strerror(code) << std::endl;
+            FinishTransfer(std::move(transfer), CURLE_FAILED_INIT);
+            continue;
+        }
+        active_transfers_.push_back(std::move(transfer));
+    }
+}
+
+void CurlMultiHttpClient::MaintainWarmOrigins() {
+    std::vector<std::string> adopted;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        adopted.swap(pending_warm_origins_);
+    }
+    for (const std::string& origin : adopted) {
+        auto it = std::find_if(warm_origins_.begin(), warm_origins_.end(),
+                               [&origin](const WarmOrigin& warm) { return warm.origin == origin; });
+        if (it == warm_origins_.end()) {
+            // A default time_point is long past, so the first ping goes out now.
+            warm_origins_.push_back(WarmOrigin{origin});
+        }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto interval = std::chrono::milliseconds(options_.keep_alive_interval_ms);
+    std::vector<std::unique_ptr<Transfer>> pings;
+    for (WarmOrigin& warm : warm_origins_) {
+        bool never_used = warm.last_used == std::chrono::steady_clock::time_point();
+        bool idle = options_.keep_alive_interval_ms > 0 && now - warm.last_used >= interval;
+        if (warm.ping_in_flight || !(never_used || idle)) {
+            continue;
+        }
+        warm.ping_in_flight = true;
+
+        // A HEAD to the origin opens (or reuses) the pooled connection; the
+        // response itself is irrelevant.
+        std::unique_ptr<Transfer> ping = CreateTransfer(warm.origin + "/", {}, kWarmUpTimeoutMs, nullptr);
+        std::string origin = warm.origin;
+        ping->on_complete = [this, origin, started = now](HttpResponse response) {
+            if (StartupTrace* trace = StartupTrace::Get()) {
+                trace->AddPhase("connection_warmup", started, std::chrono::steady_clock::now());
+            }
+            for (WarmOrigin& warm : warm_origins_) {
+                if (warm.origin == origin) {
+                    warm.ping_in_flight = false;
+                    warm.last_used = std::chrono::steady_clock::now();
+                }
+            }
+            if (!response.error_message.empty()) {
+                std::cerr << "CurlMultiHttpClient: Warming " << origin << " failed: "
+                          << response.error_message << std::endl;
+            }
+        };
+        pings.push_back(std::move(ping));
+    }
+
+    if (!pings.empty()) {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        for (auto& ping : pings) {
+            pending_transfers_.push_back(std::move(ping));
+        }
+    }
+}
+
+void CurlMultiHttpClient::ProcessCompletedTransfers() {
+    int messages_left = 0;
+    while (CURLMsg* message = curl_multi_info_read(multi_handle_, &messages_left)) {
+        if (message->msg != CURLMSG_DONE) {
+            continue;
+        }
+        CURL* easy_handle = message->easy_handle;
+        CURLcode result = message->data.result;
+        curl_multi_remove_handle(multi_handle_, easy_handle);
+
+        auto it = std::find_if(active_transfers_.begin(), active_transfers_.end(),
+                               [easy_handle](const std::unique_ptr<Transfer>& transfer) {
+                                   return transfer->easy_handle == easy_handle;
+                               });
+        if (it == active_transfers_.end()) {
+            continue;
+        }
+        std::unique_ptr<Transfer> transfer = std::move(*it);
+        *it = std::move(active_transfers_.back());
+        active_transfers_.pop_back();
+        FinishTransfer(std::move(transfer), result);
+    }
+}
+
+void CurlMultiHttpClient::FinishTransfer(std::unique_ptr<Transfer> transfer, CURLcode result) {
+    HttpResponse& response = transfer->response;
+    if (transfer->cancelled) {
+        response.error_message = "Cancelled by caller.";
+        response.body.clear();
+    } else if (result != CURLE_OK) {
+        response.status_code = 0; // Indicate cURL level error
+        response.error_message = std::string("HTTP transfer failed: ") + curl_easy_strerror(result);
+        response.body.clear();
+    } else if (transfer->easy_handle) {
+        long http_code = 0;
+        curl_easy_getinfo(transfer->easy_handle, CURLINFO_RESPONSE_CODE, &http_code);
+        response.status_code = http_code;
+    }
+
+    if (transfer->easy_handle) {
+        // Resetting keeps the handle's DNS and session caches warm for reuse.
+        if (idle_easy_handles_.size() < kMaxIdleEasyHandles) {
+            curl_easy_reset(transfer->easy_handle);
+            idle_easy_handles_.push_back(transfer->easy_handle);
+        } else {
+            curl_easy_cleanup(transfer->easy_handle);
+        }
+        transfer->easy_handle = nullptr;
+    }
+
+    if (transfer->counted) {
+        active_count_--;
+    }
+    if (transfer->on_complete) {
+        transfer->on_complete(std::move(response));
+    }
+}
+
+CURL* CurlMultiHttpClient::AcquireEasyHandle() {
+    if (!idle_easy_handles_.empty()) {
+        CURL* easy_handle = idle_easy_handles_.back();
+        idle_easy_handles_.pop_back();
+        return easy_handle;
+    }
+    return curl_easy_init();
+}
+
+// static
+size_t CurlMultiHttpClient::WriteCallback(void* contents, size_t size, size_t nmemb, void* userdata) {
+    size_t real_size = size * nmemb;
+    Transfer* transfer = static_cast<Transfer*>(userdata);
+    if (transfer->on_chunk) {
+        long http_code = 0;
+        curl_easy_getinfo(transfer->easy_handle, CURLINFO_RESPONSE_CODE, &http_code);
+        // Error bodies are buffered so the final response can carry them.
+        if (http_code >= 200 && http_code < 300) {
+            if (!transfer->on_chunk(std::string_view(static_cast<char*>(contents), real_size))) {
+                transfer->cancelled = true;
+                return 0; // Aborts the transfer with CURLE_WRITE_ERROR.
+            }
+            return real_size;
+        }
+    }
+    transfer->response.body.append(static_cast<char*>(contents), real_size);
+    return real_size;
+}
+
+// static
+size_t CurlMultiHttpClient::HeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata) {
+    size_t real_size = size * nitems;
+    Transfer* transfer = static_cast<Transfer*>(userdata);
+    std::string line(buffer, real_size);
+
+    // A new status line starts a fresh header block (redirects, 100-continue).
+    if (line.compare(0, 5, "HTTP/") == 0) {
+        transfer->response.headers.clear();
+        return real_size;
+    }
+    size_t colon = line.find(':');
+    if (colon != std::string::npos) {
+        transfer->response.headers[TrimWhitespace(line.substr(0, colon))] =
+            TrimWhitespace(line.substr(colon + 1));
+    }
+    return real_size;
+}
+
+// static
+void CurlMultiHttpClient::ShareLock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr) {
+    auto* client = static_cast<CurlMultiHttpClient*>(userptr);
+    client->share_mutexes_[data].lock();
+}
+
+// static
+void CurlMultiHttpClient::ShareUnlock(CURL* handle, curl_lock_data data, void* userptr) {
+    auto* client = static_cast<CurlMultiHttpClient*>(userptr);
+    client->share_mutexes_[data].unlock();
+}
+
+} // namespace utils
+} // namespace asol
+} // namespace dashaibrowser
@@ -0,0 +1,168 @@
+#ifndef DASHAI_BROWSER_ASOL_CPP_UTILS_CURL_MULTI_HTTP_CLIENT_H_
+#define DASHAI_BROWSER_ASOL_CPP_UTILS_CURL_MULTI_HTTP_CLIENT_H_
+
+#include "asol/cpp/utils/network_request_util.h" // For IHttpClient, HttpResponse
+#include <curl/curl.h> // For libcurl
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace dashaibrowser {
+namespace asol {
+namespace utils {
+
+class RequestBody;
+
+// IHttpClient implementation on top of curl_multi.
+//
+// All transfers are driven by a single event-loop thread, so callers no
+// longer hold a thread per round-trip and one instance can be shared across
+// threads. Transfers to the same host share connections from the multi
+// handle's pool and, where the server supports it, are multiplexed as
+// HTTP/2 streams over one connection. DNS results and TLS sessions are kept
+// in a share handle so new connections skip the full handshake.
+//
+// CurlHttpClient::GlobalInit() must have been called before construction.
+class CurlMultiHttpClient : public IHttpClient {
+public:
+    struct Options {
+        // Upper bound on connections per host; extra transfers wait for a
+        // free stream or connection instead of opening new sockets.
+        long max_connections_per_host = 4;
+        // Upper bound on connections across all hosts.
+        long max_total_connections = 32;
+        // Concurrent HTTP/2 streams per connection.
+        long max_concurrent_streams = 100;
+        // Idle connections kept in the pool.
+        long max_cached_connections = 16;
+        // Request body compression for endpoints that accept it.
+        RequestCompressionOptions compression;
+        // A preconnected origin idle for this long is pinged so servers and
+        // NATs do not drop its connection. 0 disables the pings.
+        int keep_alive_interval_ms = 45000;
+    };
+
+    CurlMultiHttpClient();
+    explicit CurlMultiHttpClient(const Options& options);
+    ~CurlMultiHttpClient() override;
+
+    CurlMultiHttpClient(const CurlMultiHttpClient&) = delete;
+    CurlMultiHttpClient& operator=(const CurlMultiHttpClient&) = delete;
+
+    // Blocks the calling thread only; the transfer itself runs on the
+    // event loop alongside every other request. Thread-safe.
+    HttpResponse Post(const std::string& url,
+                      const std::string& request_body,
+                      const std::vector<std::string>& headers,
+                      int timeout_ms = 10000) override;
+
+    using IHttpClient::PostAsync;
+
+    // Queue a POST and return immediately. |on_complete| runs on the
+    // event-loop thread and must not block. Thread-safe.
+    void PostAsync(const std::string& url,
+                   const std::string& request_body,
+                   const std::vector<std::string>& headers,
+                   int timeout_ms,
+                   ResponseCallback on_complete) override;
+
+    // Like PostAsync(), but forwards a successful body to |on_chunk| from
+    // the write callback as each piece arrives. Both callbacks run on the
+    // event-loop thread and must not block. Thread-safe.
+    void PostStream(const std::string& url,
+                    const std::string& request_body,
+                    const std::vector<std::string>& headers,
+                    int timeout_ms,
+                    ChunkCallback on_chunk,
+                    ResponseCallback on_complete) override;
+
+    // Opens pooled connections to |origins| with a HEAD request each, then
+    // keeps them warm: an origin that sees no traffic for
+    // keep_alive_interval_ms gets another HEAD on the same connection.
+    // Warm-up transfers are not counted as active. Thread-safe.
+    void Preconnect(const std::vector<std::string>& origins) override;
+
+    // Transfers queued or in progress.
+    size_t GetActiveTransferCount() const;
+
+private:
+    struct Transfer;
+
+    // A preconnected origin. Loop thread only.
+    struct WarmOrigin {
+        std::string origin;
+        std::chrono::steady_clock::time_point last_used;
+        bool ping_in_flight = false;
+    };
+
+    // Event loop: adds queued transfers, drives curl, completes finished ones.
+    void RunEventLoop();
+
+    // Move queued transfers onto the multi handle. Loop thread only.
+    void AttachPendingTransfers();
+
+    // Adopt newly preconnected origins and ping idle ones. Loop thread only.
+    void MaintainWarmOrigins();
+
+    // Report every finished transfer. Loop thread only.
+    void ProcessCompletedTransfers();
+
+    // Complete |transfer| and return its easy handle to the pool.
+    void FinishTransfer(std::unique_ptr<Transfer> transfer, CURLcode result);
+
+    // A transfer for |url| uploading |body|.
+    std::unique_ptr<Transfer> CreateTransfer(const std::string& url,
+                                             const std::vector<std::string>& headers,
+                                             int timeout_ms,
+                                             std::unique_ptr<RequestBody> body);
+
+    // Queue |transfer| for the loop thread, or fail it when stopping.
+    void SubmitTransfer(std::unique_ptr<Transfer> transfer);
+
+    // A reset easy handle from the pool, or a new one. Loop thread only.
+    CURL* AcquireEasyHandle();
+
+    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userdata);
+    static size_t HeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata);
+
+    // Share-handle locking; curl calls these from the loop thread and from
+    // any other client sharing the handle.
+    static void ShareLock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void ShareUnlock(CURL* handle, curl_lock_data data, void* userptr);
+
+    const Options options_;
+
+    CURLM* multi_handle_ = nullptr;
+    CURLSH* share_handle_ = nullptr;
+    std::mutex share_mutexes_[CURL_LOCK_DATA_LAST];
+
+    // Transfers submitted by callers, waiting to be attached.
+    mutable std::mutex pending_mutex_;
+    std::vector<std::unique_ptr<Transfer>> pending_transfers_;
+    std::vector<std::string> pending_warm_origins_;
+
+    // Origins kept warm, owned by the loop thread.
+    std::vector<WarmOrigin> warm_origins_;
+
+    // Transfers on the multi handle, owned by the loop thread.
+    std::vector<std::unique_ptr<Transfer>> active_transfers_;
+    std::atomic<size_t> active_count_{0};
+
+    // Reusable easy handles, owned by the loop thread.
+    std::vector<CURL*> idle_easy_handles_;
+
+    std::atomic<bool> stopping_{false};
+    std::thread loop_thread_;
+};
+
+} // namespace utils
+} // namespace asol
+} // namespace dashaibrowser
+
+#endif // DASHAI_BROWSER_ASOL_CPP_UTILS_CURL_MULTI_HTTP_CLIENT_H_
@@ -0,0 +1,52 @@
+#include "asol/cpp/utils/network_request_util.h"
+#include <memory> // For std::make_shared
+
+namespace dashaibrowser {
+namespace asol {
+namespace utils {
+
+void IHttpClient::PostAsync(const std::string& url,
+                            const std::string& request_body,
+                            const std::vector<std::string>& headers,
+                            int timeout_ms,
+                            ResponseCallback on_complete) {
+    HttpResponse response = Post(url, request_body, headers, timeout_ms);
+    if (on_complete) {
+        on_complete(std::move(response));
+    }
+}
+
+std::future<HttpResponse> IHttpClient::PostAsync(const std::string& url,
+                                                 const std::string& request_body,
+                                                 const std::vector<std::string>& headers,
+                                                 int timeout_ms) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    std::future<HttpResponse> result = promise->get_future();
+    PostAsync(url, request_body, headers, timeout_ms,
+              [promise](HttpResponse response) { promise->set_value(std::move(response)); });
+    return result;
+}
+
+void IHttpClient::PostStream(const std::string& url,
+                             const std::string& request_body,
+                             const std::vector<std::string>& headers,
+                             int timeout_ms,
+                             ChunkCallback on_chunk,
+                             ResponseCallback on_complete) {
+    HttpResponse response = Post(url, request_body, headers, timeout_ms);
+    if (response.IsSuccess() && on_chunk) {
+        if (!response.body.empty() && !on_chunk(response.body)) {
+            response.error_message = "Cancelled by caller.";
+        }
+        response.body.clear();
+    }
+    if (on_complete) {
+        on_complete(std::move(response));
+    }
+}
+
+void IHttpClient::Preconnect(const std::vector<std::string>& origins) {}
+
+} // namespace utils
+} // namespace asol
+} // namespace dashaibrowser
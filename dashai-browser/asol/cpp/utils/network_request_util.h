@@ -1,7 +1,10 @@
 #ifndef DASHAI_BROWSER_ASOL_CPP_UTILS_NETWORK_REQUEST_UTIL_H_
 #define DASHAI_BROWSER_ASOL_CPP_UTILS_NETWORK_REQUEST_UTIL_H_
 
+#include <functional>
+#include <future>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 
@@ -21,10 +24,35 @@ struct HttpResponse {
     }
 };
 
+// Content-Encoding applied to request bodies.
+enum class RequestEncoding {
+    IDENTITY, // Sent as-is
+    GZIP,
+    DEFLATE,  // zlib format, as HTTP "deflate" specifies
+};
+
+// When and how clients compress request bodies. Servers reject encodings
+// they do not understand, so only enable one for endpoints known to
+// accept it.
+struct RequestCompressionOptions {
+    RequestEncoding encoding = RequestEncoding::IDENTITY;
+    // Smaller bodies are sent uncompressed; the saving would not cover the
+    // CPU cost.
+    size_t min_body_size = 8 * 1024;
+};
+
 // Interface for a simple HTTP client.
 // This allows for different implementations (e.g., curl-based, Chromium network stack based).
 class IHttpClient {
 public:
+    // Receives the final response of an asynchronous request.
+    using ResponseCallback = std::function<void(HttpResponse)>;
+
+    // Receives successive slices of a streamed response body. The slice is
+    // only valid for the duration of the call. Return false to cancel the
+    // transfer.
+    using ChunkCallback = std::function<bool(std::string_view chunk)>;
+
     virtual ~IHttpClient() = default;
 
     // Performs an HTTP POST request.
@@ -37,6 +65,42 @@ public:
                               const std::vector<std::string>& headers,
                               int timeout_ms = 10000) = 0;
 
+    // Performs an HTTP POST request without waiting for the response.
+    // |on_complete| is called exactly once, possibly on another thread.
+    // The default implementation runs Post() on the calling thread;
+    // clients with their own event loop override it.
+    virtual void PostAsync(const std::string& url,
+                           const std::string& request_body,
+                           const std::vector<std::string>& headers,
+                           int timeout_ms,
+                           ResponseCallback on_complete);
+
+    // Future-based convenience wrapper around PostAsync().
+    std::future<HttpResponse> PostAsync(const std::string& url,
+                                        const std::string& request_body,
+                                        const std::vector<std::string>& headers,
+                                        int timeout_ms = 10000);
+
+    // Performs an HTTP POST request and delivers the body of a successful
+    // (2xx) response to |on_chunk| as bytes arrive, so callers can forward
+    // generated tokens before the completion finishes. Error bodies are not
+    // streamed; they are returned in the final response. |on_complete| is
+    // called exactly once with the status and headers; its body is empty
+    // when the body was streamed. timeout_ms bounds the whole transfer, so
+    // long generations need a generous value (0 disables it).
+    // The default implementation buffers Post() and delivers one chunk.
+    virtual void PostStream(const std::string& url,
+                            const std::string& request_body,
+                            const std::vector<std::string>& headers,
+                            int timeout_ms,
+                            ChunkCallback on_chunk,
+                            ResponseCallback on_complete);
+
+    // Opens connections to |origins| (e.g. "https://api.openai.com") ahead
+    // of the first request, so that request does not pay for DNS, TCP and
+    // TLS setup. Best effort and non-blocking. The default does nothing.
+    virtual void Preconnect(const std::vector<std::string>& origins);
+
     // Could add Get, Put, Delete etc. as needed
     // virtual HttpResponse Get(const std::string& url,
     //                          const std::vector<std::string>& headers,
@@ -0,0 +1,139 @@
+#include "asol/cpp/utils/request_body.h"
+#include <zlib.h>   // For gzip/deflate request encoding
+#include <algorithm> // For std::min
+#include <cstring>  // For std::memcpy
+#include <iostream> // For error logging
+
+namespace dashaibrowser {
+namespace asol {
+namespace utils {
+
+namespace {
+
+// zlib window bits; adding 16 selects the gzip wrapper.
+constexpr int kWindowBits = 15;
+constexpr int kGzipWindowBits = kWindowBits + 16;
+constexpr int kMemLevel = 8;
+
+// Output buffer growth step while deflating.
+constexpr size_t kDeflateChunkSize = 64 * 1024;
+
+} // namespace
+
+// static
+std::unique_ptr<RequestBody> RequestBody::Borrow(const std::string& body,
+                                                 const RequestCompressionOptions& compression) {
+    std::unique_ptr<RequestBody> request_body(new RequestBody());
+    if (!request_body->MaybeCompress(body, compression)) {
+        request_body->data_ = &body;
+    }
+    return request_body;
+}
+
+// static
+std::unique_ptr<RequestBody> RequestBody::Copy(const std::string& body,
+                                               const RequestCompressionOptions& compression) {
+    std::unique_ptr<RequestBody> request_body(new RequestBody());
+    if (!request_body->MaybeCompress(body, compression)) {
+        request_body->owned_ = body;
+    }
+    return request_body;
+}
+
+bool RequestBody::MaybeCompress(const std::string& body,
+                                const RequestCompressionOptions& compression) {
+    if (compression.encoding == RequestEncoding::IDENTITY ||
+        body.size() < compression.min_body_size) {
+        return false;
+    }
+    std::string encoded;
+    if (!Encode(body, compression.encoding, &encoded) || encoded.size() >= body.size()) {
+        return false;
+    }
+    owned_ = std::move(encoded);
+    data_ = &owned_;
+    encoding_ = compression.encoding;
+    return true;
+}
+
+void RequestBody::Attach(CURL* easy_handle, struct curl_slist** headers) {
+    offset_ = 0;
+    curl_easy_setopt(easy_handle, CURLOPT_POST, 1L);
+    curl_easy_setopt(easy_handle, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(data_->size()));
+    curl_easy_setopt(easy_handle, CURLOPT_READFUNCTION, ReadCallback);
+    curl_easy_setopt(easy_handle, CURLOPT_READDATA, this);
+    curl_easy_setopt(easy_handle, CURLOPT_SEEKFUNCTION, SeekCallback);
+    curl_easy_setopt(easy_handle, CURLOPT_SEEKDATA, this);
+
+    if (encoding_ == RequestEncoding::GZIP) {
+        *headers = curl_slist_append(*headers, "Content-Encoding: gzip");
+    } else if (encoding_ == RequestEncoding::DEFLATE) {
+        *headers = curl_slist_append(*headers, "Content-Encoding: deflate");
+    }
+    // Large uploads would otherwise wait a round-trip for "100 Continue".
+    *headers = curl_slist_append(*headers, "Expect:");
+}
+
+// static
+bool RequestBody::Encode(const std::string& body, RequestEncoding encoding, std::string* out) {
+    if (encoding == RequestEncoding::IDENTITY) {
+        return false;
+    }
+
+    z_stream stream = {};
+    int window_bits = encoding == RequestEncoding::GZIP ? kGzipWindowBits : kWindowBits;
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, kMemLevel,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        std::cerr << "RequestBody::Encode: deflateInit2() failed." << std::endl;
+        return false;
+    }
+
+    out->clear();
+    // Prompts are mostly text and compress well; start from a third.
+    out->reserve(body.size() / 3 + kDeflateChunkSize);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body.data()));
+    stream.avail_in = static_cast<uInt>(body.size());
+
+    int result = Z_OK;
+    while (result == Z_OK) {
+        size_t used = out->size();
+        out->resize(used + kDeflateChunkSize);
+        stream.next_out = reinterpret_cast<Bytef*>(&(*out)[used]);
+        stream.avail_out = static_cast<uInt>(kDeflateChunkSize);
+        result = deflate(&stream, Z_FINISH);
+        out->resize(used + kDeflateChunkSize - stream.avail_out);
+    }
+    deflateEnd(&stream);
+
+    if (result != Z_STREAM_END) {
+        std::cerr << "RequestBody::Encode: deflate() failed: " << result << std::endl;
+        out->clear();
+        return false;
+    }
+    return true;
+}
+
+// static
+size_t RequestBody::ReadCallback(char* buffer, size_t size, size_t nitems, void* userdata) {
+    RequestBody* body = static_cast<RequestBody*>(userdata);
+    size_t remaining = body->data_->size() - body->offset_;
+    size_t length = std::min(size * nitems, remaining);
+    std::memcpy(buffer, body->data_->data() + body->offset_, length);
+    body->offset_ += length;
+    return length;
+}
+
+// static
+int RequestBody::SeekCallback(void* userdata, curl_off_t offset, int origin) {
+    RequestBody* body = static_cast<RequestBody*>(userdata);
+    // curl only rewinds from the start, e.g. to resend after a redirect.
+    if (origin != SEEK_SET || offset < 0 || static_cast<size_t>(offset) > body->data_->size()) {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    body->offset_ = static_cast<size_t>(offset);
+    return CURL_SEEKFUNC_OK;
+}
+
+} // namespace utils
+} // namespace asol
+} // namespace dashaibrowser
@@ -0,0 +1,63 @@
+#ifndef DASHAI_BROWSER_ASOL_CPP_UTILS_REQUEST_BODY_H_
+#define DASHAI_BROWSER_ASOL_CPP_UTILS_REQUEST_BODY_H_
+
+#include "asol/cpp/utils/network_request_util.h" // For RequestCompressionOptions
+#include <curl/curl.h> // For libcurl
+#include <memory>
+#include <string>
+
+namespace dashaibrowser {
+namespace asol {
+namespace utils {
+
+// A POST body uploaded through curl's read callback, so curl streams it
+// from one buffer instead of needing its own copy. Large bodies are
+// compressed according to RequestCompressionOptions when that makes them
+// smaller.
+class RequestBody {
+public:
+    // References |body|, which must outlive the transfer unless it was
+    // compressed. For calls that block until the transfer finishes.
+    static std::unique_ptr<RequestBody> Borrow(const std::string& body,
+                                               const RequestCompressionOptions& compression);
+
+    // Owns the (possibly compressed) body. For asynchronous transfers.
+    static std::unique_ptr<RequestBody> Copy(const std::string& body,
+                                             const RequestCompressionOptions& compression);
+
+    RequestBody(const RequestBody&) = delete;
+    RequestBody& operator=(const RequestBody&) = delete;
+
+    // Bytes that go on the wire.
+    const std::string& data() const { return *data_; }
+
+    // Encoding actually applied; IDENTITY if compression was skipped.
+    RequestEncoding encoding() const { return encoding_; }
+
+    // Configure |easy_handle| to POST this body and append the matching
+    // request headers to |headers|. The body must outlive the transfer.
+    void Attach(CURL* easy_handle, struct curl_slist** headers);
+
+    // Compress |body| into |out|. Returns false for IDENTITY or on zlib failure.
+    static bool Encode(const std::string& body, RequestEncoding encoding, std::string* out);
+
+private:
+    RequestBody() = default;
+
+    // Compress into owned_ if |compression| applies; returns whether it did.
+    bool MaybeCompress(const std::string& body, const RequestCompressionOptions& compression);
+
+    static size_t ReadCallback(char* buffer, size_t size, size_t nitems, void* userdata);
+    static int SeekCallback(void* userdata, curl_off_t offset, int origin);
+
+    std::string owned_;
+    const std::string* data_ = &owned_;
+    size_t offset_ = 0;
+    RequestEncoding encoding_ = RequestEncoding::IDENTITY;
+};
+
+} // namespace utils
+} // namespace asol
+} // namespace dashaibrowser
+
+#endif // DASHAI_BROWSER_ASOL_CPP_UTILS_REQUEST_BODY_H_
@@ -0,0 +1,294 @@
+#include "asol/cpp/utils/shared_memory_text.h"
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#endif
+
+namespace dashaibrowser {
+namespace asol {
+namespace utils {
+
+#if defined(__linux__)
+
+namespace {
+
+// memfd name, so the gateway can tell our buffers from other sealed memfds
+constexpr char kMemfdName[] = "asol-text";
+
+constexpr int kRequiredSeals = F_SEAL_WRITE | F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+
+std::string ErrnoText(const char* what) {
+    return std::string(what) + ": " + std::strerror(errno);
+}
+
+// Closes a descriptor on scope exit
+class ScopedFd {
+public:
+    explicit ScopedFd(int fd) : fd_(fd) {}
+    ~ScopedFd() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+    ScopedFd(const ScopedFd&) = delete;
+    ScopedFd& operator=(const ScopedFd&) = delete;
+
+    int get() const { return fd_; }
+    int release() {
+        int fd = fd_;
+        fd_ = -1;
+        return fd;
+    }
+
+private:
+    int fd_;
+};
+
+// The local address of the client's end of a loopback TCP connection, as
+// /proc/net/tcp{,6} prints it: "0100007F:D431" on little-endian hosts.
+struct TcpEndpoint {
+    const char* table = nullptr;  // /proc/net/tcp or /proc/net/tcp6
+    std::string address;
+};
+
+// Parses "ipv4:127.0.0.1:54321" or "ipv6:[::1]:54321" (gRPC escapes the
+// brackets in some versions). False for Unix socket peers, whose client
+// end usually has no address to look up.
+bool ParseTcpPeer(const std::string& peer, TcpEndpoint* endpoint) {
+    bool ipv6 = peer.rfind("ipv6:", 0) == 0;
+    if (!ipv6 && peer.rfind("ipv4:", 0) != 0) {
+        return false;
+    }
+    size_t port_start = peer.rfind(':');
+    if (port_start == std::string::npos || port_start <= 5) {
+        return false;
+    }
+    std::string host = peer.substr(5, port_start - 5);
+    unsigned long port = std::strtoul(peer.c_str() + port_start + 1, nullptr, 10);
+    if (port == 0 || port > 0xffff) {
+        return false;
+    }
+    for (const char* bracket : {"[", "%5B"}) {
+        if (host.rfind(bracket, 0) == 0) {
+            host.erase(0, std::strlen(bracket));
+        }
+    }
+    for (const char* bracket : {"]", "%5D"}) {
+        size_t length = std::strlen(bracket);
+        if (host.size() >= length && host.compare(host.size() - length, length, bracket) == 0) {
+            host.erase(host.size() - length);
+        }
+    }
+
+    // The kernel prints each 32-bit word of the address as a host-order
+    // integer, then the port
+    uint32_t words[4] = {};
+    if (inet_pton(ipv6 ? AF_INET6 : AF_INET, host.c_str(), words) != 1) {
+        return false;
+    }
+    char text[8 * 4 + 6];
+    if (ipv6) {
+        std::snprintf(text, sizeof(text), "%08" PRIX32 "%08" PRIX32 "%08" PRIX32 "%08" PRIX32 ":%04lX", words[0],
+                      words[1], words[2], words[3], port);
+    } else {
+        std::snprintf(text, sizeof(text), "%08" PRIX32 ":%04lX", words[0], port);
+    }
+    endpoint->table = ipv6 ? "/proc/net/tcp6" : "/proc/net/tcp";
+    endpoint->address = text;
+    return true;
+}
+
+// Inode of the socket bound to |endpoint|, 0 when there is none
+uint64_t FindSocketInode(const TcpEndpoint& endpoint) {
+    std::ifstream table(endpoint.table);
+    std::string line;
+    std::getline(table, line);  // Header
+    while (std::getline(table, line)) {
+        // sl local_address rem_address st tx:rx tr:when retrnsmt uid timeout inode
+        char local[64];
+        unsigned long long inode = 0;
+        if (std::sscanf(line.c_str(), " %*s %63s %*s %*s %*s %*s %*s %*s %*s %llu", local, &inode) == 2 &&
+            endpoint.address == local) {
+            return inode;
+        }
+    }
+    return 0;
+}
+
+// Whether process |pid| holds the client's end of the connection |peer|
+// came from. gRPC does not hand out the connection's descriptor for
+// getsockopt(SO_PEERCRED), so this finds the client's socket through the
+// kernel's TCP table instead and looks for it among |pid|'s descriptors.
+bool ProcessHoldsConnection(const std::string& peer, int32_t pid, std::string* error) {
+    TcpEndpoint endpoint;
+    if (!ParseTcpPeer(peer, &endpoint)) {
+        *error = "Shared text needs a loopback TCP connection.";
+        return false;
+    }
+    uint64_t inode = FindSocketInode(endpoint);
+    if (inode == 0) {
+        *error = "Cannot find the client's connection.";
+        return false;
+    }
+    std::string socket_link = "socket:[" + std::to_string(inode) + "]";
+
+    std::string fd_dir = "/proc/" + std::to_string(pid) + "/fd";
+    DIR* dir = opendir(fd_dir.c_str());
+    if (!dir) {
+        *error = ErrnoText("Cannot find shared text owner");
+        return false;
+    }
+    bool found = false;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        std::string path = fd_dir + "/" + entry->d_name;
+        char link[64] = {};
+        ssize_t link_length = readlink(path.c_str(), link, sizeof(link) - 1);
+        if (link_length > 0 && socket_link == std::string_view(link, static_cast<size_t>(link_length))) {
+            found = true;
+            break;
+        }
+    }
+    closedir(dir);
+    if (!found) {
+        *error = "Shared text belongs to another process.";
+    }
+    return found;
+}
+
+} // namespace
+
+std::unique_ptr<SharedTextBuffer> SharedTextBuffer::Create(std::string_view text) {
+    ScopedFd fd(memfd_create(kMemfdName, MFD_CLOEXEC | MFD_ALLOW_SEALING));
+    if (fd.get() < 0) {
+        return nullptr;
+    }
+    size_t written = 0;
+    while (written < text.size()) {
+        ssize_t result = write(fd.get(), text.data() + written, text.size() - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return nullptr;
+        }
+        written += static_cast<size_t>(result);
+    }
+    if (fcntl(fd.get(), F_ADD_SEALS, kRequiredSeals) != 0) {
+        return nullptr;
+    }
+    return std::unique_ptr<SharedTextBuffer>(new SharedTextBuffer(fd.release(), text.size()));
+}
+
+SharedTextBuffer::SharedTextBuffer(int32_t fd, uint64_t size)
+    : pid_(static_cast<int32_t>(getpid())), fd_(fd), size_(size) {}
+
+SharedTextBuffer::~SharedTextBuffer() {
+    close(fd_);
+}
+
+bool ReadSharedText(const std::string& peer,
+                    int32_t pid,
+                    int32_t fd,
+                    uint64_t size,
+                    std::string* text,
+                    std::string* error) {
+    if (pid <= 0 || fd < 0) {
+        *error = "Invalid shared text descriptor.";
+        return false;
+    }
+    if (size > kMaxSharedTextBytes) {
+        *error = "Shared text is too large.";
+        return false;
+    }
+    // The pid is the client's word; otherwise any local client could read
+    // another's texts
+    if (!ProcessHoldsConnection(peer, pid, error)) {
+        return false;
+    }
+
+    std::string path = "/proc/" + std::to_string(pid) + "/fd/" + std::to_string(fd);
+    char link[64] = {};
+    ssize_t link_length = readlink(path.c_str(), link, sizeof(link) - 1);
+    if (link_length < 0) {
+        *error = ErrnoText("Cannot find shared text");
+        return false;
+    }
+    if (std::string_view(link, static_cast<size_t>(link_length)).rfind(std::string("/memfd:") + kMemfdName, 0) != 0) {
+        *error = "Descriptor is not a shared text buffer.";
+        return false;
+    }
+
+    ScopedFd file(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (file.get() < 0) {
+        *error = ErrnoText("Cannot open shared text");
+        return false;
+    }
+    int seals = fcntl(file.get(), F_GET_SEALS);
+    if (seals < 0 || (seals & kRequiredSeals) != kRequiredSeals) {
+        *error = "Shared text is not sealed.";
+        return false;
+    }
+    struct stat file_stat;
+    if (fstat(file.get(), &file_stat) != 0 || static_cast<uint64_t>(file_stat.st_size) != size) {
+        *error = "Shared text size does not match.";
+        return false;
+    }
+
+    // Sealed, so the content cannot change or shrink while it is read
+    // straight into |text|
+    text->resize(size);
+    size_t done = 0;
+    while (done < size) {
+        ssize_t result = pread(file.get(), text->data() + done, size - done, static_cast<off_t>(done));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            *error = ErrnoText("Cannot read shared text");
+            text->clear();
+            return false;
+        }
+        done += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+#else // !defined(__linux__)
+
+std::unique_ptr<SharedTextBuffer> SharedTextBuffer::Create(std::string_view text) {
+    return nullptr;
+}
+
+SharedTextBuffer::SharedTextBuffer(int32_t fd, uint64_t size) : pid_(0), fd_(fd), size_(size) {}
+
+SharedTextBuffer::~SharedTextBuffer() = default;
+
+bool ReadSharedText(const std::string& peer,
+                    int32_t pid,
+                    int32_t fd,
+                    uint64_t size,
+                    std::string* text,
+                    std::string* error) {
+    *error = "Shared text is not supported on this platform.";
+    return false;
+}
+
+#endif
+
+} // namespace utils
+} // namespace asol
+} // namespace dashaibrowser
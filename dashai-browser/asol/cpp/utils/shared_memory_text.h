@@ -0,0 +1,63 @@
+#ifndef DASHAI_BROWSER_ASOL_CPP_UTILS_SHARED_MEMORY_TEXT_H_
+#define DASHAI_BROWSER_ASOL_CPP_UTILS_SHARED_MEMORY_TEXT_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace dashaibrowser {
+namespace asol {
+namespace utils {
+
+// Same-host handover of large texts, e.g. a whole article to summarize.
+// The client writes the text once into a sealed memfd and sends only its
+// (pid, fd, size) over gRPC; the gateway reads it through
+// /proc/<pid>/fd/<fd>. That skips serializing, sending and parsing
+// megabytes of protobuf over a socket. Linux only; elsewhere Create()
+// fails and callers send the text inline.
+
+// Client side: an immutable in-memory file holding a text. Keep it alive
+// until every RPC naming it has completed.
+class SharedTextBuffer {
+public:
+    // nullptr when the buffer cannot be created.
+    static std::unique_ptr<SharedTextBuffer> Create(std::string_view text);
+    ~SharedTextBuffer();
+
+    SharedTextBuffer(const SharedTextBuffer&) = delete;
+    SharedTextBuffer& operator=(const SharedTextBuffer&) = delete;
+
+    int32_t pid() const { return pid_; }
+    int32_t fd() const { return fd_; }
+    uint64_t size() const { return size_; }
+
+private:
+    SharedTextBuffer(int32_t fd, uint64_t size);
+
+    const int32_t pid_;
+    const int32_t fd_;
+    const uint64_t size_;
+};
+
+// Largest text ReadSharedText() accepts
+inline constexpr uint64_t kMaxSharedTextBytes = 64 * 1024 * 1024;
+
+// Gateway side: read the text a local client shared. |peer| is the RPC's
+// ServerContext::peer(); the text is read only if |pid| holds the client's
+// end of that connection, which so far means a loopback TCP one. Only a
+// SharedTextBuffer is accepted, i.e. a memfd sealed against writes and
+// resizing, so the content cannot change while it is read. False with
+// |error| set otherwise.
+bool ReadSharedText(const std::string& peer,
+                    int32_t pid,
+                    int32_t fd,
+                    uint64_t size,
+                    std::string* text,
+                    std::string* error);
+
+} // namespace utils
+} // namespace asol
+} // namespace dashaibrowser
+
+#endif // DASHAI_BROWSER_ASOL_CPP_UTILS_SHARED_MEMORY_TEXT_H_
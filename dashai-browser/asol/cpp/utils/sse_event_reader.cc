@@ -0,0 +1,77 @@
+#include "asol/cpp/utils/sse_event_reader.h"
+#include <utility>
+
+namespace dashaibrowser {
+namespace asol {
+namespace utils {
+
+SseEventReader::SseEventReader(EventCallback on_event)
+    : on_event_(std::move(on_event)) {}
+
+SseEventReader::~SseEventReader() = default;
+
+void SseEventReader::Append(std::string_view chunk) {
+    size_t line_start = 0;
+    while (line_start < chunk.size()) {
+        size_t line_end = chunk.find('\n', line_start);
+        if (line_end == std::string_view::npos) {
+            partial_line_.append(chunk.substr(line_start));
+            return;
+        }
+        std::string_view line = chunk.substr(line_start, line_end - line_start);
+        if (partial_line_.empty()) {
+            ProcessLine(line);
+        } else {
+            partial_line_.append(line);
+            ProcessLine(partial_line_);
+            partial_line_.clear();
+        }
+        line_start = line_end + 1;
+    }
+}
+
+void SseEventReader::Finish() {
+    if (!partial_line_.empty()) {
+        std::string line = std::move(partial_line_);
+        partial_line_.clear();
+        ProcessLine(line);
+    }
+    DispatchEvent();
+}
+
+void SseEventReader::ProcessLine(std::string_view line) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    if (line.empty()) {
+        DispatchEvent();
+        return;
+    }
+
+    constexpr std::string_view kDataField = "data:";
+    if (line.substr(0, kDataField.size()) != kDataField) {
+        return; // Comments and the event, id and retry fields
+    }
+    line.remove_prefix(kDataField.size());
+    if (!line.empty() && line.front() == ' ') {
+        line.remove_prefix(1);
+    }
+    if (has_data_) {
+        data_.push_back('\n');
+    }
+    data_.append(line);
+    has_data_ = true;
+}
+
+void SseEventReader::DispatchEvent() {
+    if (!has_data_) {
+        return;
+    }
+    on_event_(data_);
+    data_.clear();
+    has_data_ = false;
+}
+
+} // namespace utils
+} // namespace asol
+} // namespace dashaibrowser
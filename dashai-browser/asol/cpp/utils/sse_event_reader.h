@@ -0,0 +1,47 @@
+#ifndef DASHAI_BROWSER_ASOL_CPP_UTILS_SSE_EVENT_READER_H_
+#define DASHAI_BROWSER_ASOL_CPP_UTILS_SSE_EVENT_READER_H_
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace dashaibrowser {
+namespace asol {
+namespace utils {
+
+// Splits a text/event-stream (server-sent events) body into events as it
+// arrives, e.g. from IHttpClient::PostStream(). Only the "data:" field is
+// kept; an event with several data lines gets them joined with '\n'. Lines
+// are read in place from each chunk; only an unterminated tail is copied.
+class SseEventReader {
+public:
+    // Receives the data of one event. Only valid during the call.
+    using EventCallback = std::function<void(std::string_view data)>;
+
+    explicit SseEventReader(EventCallback on_event);
+    ~SseEventReader();
+
+    SseEventReader(const SseEventReader&) = delete;
+    SseEventReader& operator=(const SseEventReader&) = delete;
+
+    // Feed the next slice of the body.
+    void Append(std::string_view chunk);
+
+    // The body ended; dispatch the last event even without a blank line.
+    void Finish();
+
+private:
+    void ProcessLine(std::string_view line);
+    void DispatchEvent();
+
+    EventCallback on_event_;
+    std::string partial_line_; // Unterminated tail of the previous chunk
+    std::string data_;         // Data of the event being read
+    bool has_data_ = false;
+};
+
+} // namespace utils
+} // namespace asol
+} // namespace dashaibrowser
+
+#endif // DASHAI_BROWSER_ASOL_CPP_UTILS_SSE_EVENT_READER_H_
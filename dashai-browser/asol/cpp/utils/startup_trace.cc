@@ -0,0 +1,71 @@
+#include "asol/cpp/utils/startup_trace.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+namespace dashaibrowser {
+namespace asol {
+namespace utils {
+
+namespace {
+
+// Set once by Start() and kept for the life of the process
+StartupTrace* g_startup_trace = nullptr;
+
+double Milliseconds(StartupTrace::Clock::time_point time) {
+    return std::chrono::duration<double, std::milli>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+// static
+void StartupTrace::Start(const char* process_name) {
+    const char* path = std::getenv("DASHAI_STARTUP_TRACE");
+    if (g_startup_trace || !path || !*path) {
+        return;
+    }
+    int fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "StartupTrace: Cannot open " << path << "; not tracing." << std::endl;
+        return;
+    }
+    // Leaked, with its descriptor: phases may be reported until exit
+    g_startup_trace = new StartupTrace(fd, process_name);
+    g_startup_trace->AddMark("main");
+}
+
+// static
+StartupTrace* StartupTrace::Get() {
+    return g_startup_trace;
+}
+
+StartupTrace::StartupTrace(int fd, const char* process_name) : fd_(fd), process_name_(process_name) {}
+
+void StartupTrace::AddPhase(const std::string& phase, Clock::time_point start, Clock::time_point end) {
+    // Process and phase names are literals, so nothing needs escaping
+    char times[96];
+    std::snprintf(times, sizeof(times), ",\"start_ms\":%.3f,\"end_ms\":%.3f}\n", Milliseconds(start),
+                  Milliseconds(end));
+    std::string line = "{\"process\":\"" + process_name_ + "\",\"phase\":\"" + phase + "\"" + times;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!reported_.insert(phase).second) {
+        return;
+    }
+    // One O_APPEND write per line, so lines from the browser sharing the
+    // file never interleave with ours
+    if (write(fd_, line.data(), line.size()) != static_cast<ssize_t>(line.size())) {
+        std::cerr << "StartupTrace: Cannot append " << phase << std::endl;
+    }
+}
+
+void StartupTrace::AddMark(const std::string& phase) {
+    Clock::time_point now = Clock::now();
+    AddPhase(phase, now, now);
+}
+
+} // namespace utils
+} // namespace asol
+} // namespace dashaibrowser
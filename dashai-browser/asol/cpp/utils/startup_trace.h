@@ -0,0 +1,72 @@
+#ifndef DASHAI_BROWSER_ASOL_CPP_UTILS_STARTUP_TRACE_H_
+#define DASHAI_BROWSER_ASOL_CPP_UTILS_STARTUP_TRACE_H_
+
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace dashaibrowser {
+namespace asol {
+namespace utils {
+
+// The gateway's side of the browser's asol::core::StartupTrace: when the
+// startup benchmark (browser_core/benchmarks/startup_benchmark.cc) sets
+// $DASHAI_STARTUP_TRACE, each startup phase is appended to that file as
+//
+//   {"process":"gateway","phase":"listen","start_ms":81234.5,"end_ms":81236.1}
+//
+// in steady_clock milliseconds, which on Linux is the CLOCK_MONOTONIC the
+// browser's base::TimeTicks reads, so both processes can share one file.
+// Without the variable Get() returns nullptr and nothing is written.
+// Each phase is reported once; later ones of the same name are dropped.
+// Thread-safe.
+class StartupTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Trace this process if $DASHAI_STARTUP_TRACE is set. Call first thing
+    // in main(); adds the "main" mark.
+    static void Start(const char* process_name);
+
+    // nullptr when not tracing
+    static StartupTrace* Get();
+
+    // Report phase |phase| if it is the first of its name
+    void AddPhase(const std::string& phase, Clock::time_point start, Clock::time_point end);
+    // A phase that starts and ends now
+    void AddMark(const std::string& phase);
+
+private:
+    StartupTrace(int fd, const char* process_name);
+
+    const int fd_;
+    const std::string process_name_;
+
+    std::mutex mutex_;
+    std::set<std::string> reported_;
+};
+
+// Reports the phase from its construction to its destruction, if tracing
+class ScopedStartupPhase {
+public:
+    explicit ScopedStartupPhase(const char* phase) : phase_(phase), start_(StartupTrace::Clock::now()) {}
+    ~ScopedStartupPhase() {
+        if (StartupTrace* trace = StartupTrace::Get()) {
+            trace->AddPhase(phase_, start_, StartupTrace::Clock::now());
+        }
+    }
+
+    ScopedStartupPhase(const ScopedStartupPhase&) = delete;
+    ScopedStartupPhase& operator=(const ScopedStartupPhase&) = delete;
+
+private:
+    const char* const phase_;
+    const StartupTrace::Clock::time_point start_;
+};
+
+} // namespace utils
+} // namespace asol
+} // namespace dashaibrowser
+
+#endif // DASHAI_BROWSER_ASOL_CPP_UTILS_STARTUP_TRACE_H_
@@ -0,0 +1,107 @@
+// Copyright 2025 The DashAIBrowser Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "asol/adapters/adapter_factory.h"
+#include "asol/core/ai_service_provider.h"
+#include "asol/core/multi_adapter_manager.h"
+#include "base/functional/bind.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asol {
+namespace {
+
+// The full manager stack (cache, circuit breakers, rate limiting) over
+// mock providers, with mock time, so it runs without network or keys and
+// always takes the same simulated time.
+class MockAdapterIntegrationTest : public testing::Test {
+ protected:
+  struct Result {
+    bool done = false;
+    bool success = false;
+    std::string response;
+    core::MultiAdapterManager::ResponseMetadata metadata;
+  };
+
+  void SetUp() override {
+    std::unordered_map<std::string, std::string> config;
+    config["mock_providers"] = "gemini,openai";
+    config["default_provider"] = "gemini";
+    config["mock_latency_distribution"] = "fixed";
+    config["mock_latency_ms"] = "300";
+    config["openai_latency_ms"] = "800";
+
+    adapter_manager_ =
+        adapters::AdapterFactory::CreateMultiAdapterManager(config);
+  }
+
+  void Send(const std::string& input, Result* result) {
+    core::AIRequestParams params;
+    params.task_type = core::AIServiceProvider::TaskType::TEXT_SUMMARIZATION;
+    params.input_text = input;
+    adapter_manager_->ProcessRequestWithMetadata(
+        params,
+        base::BindOnce(
+            [](Result* result, bool success, const std::string& response,
+               const core::MultiAdapterManager::ResponseMetadata& metadata) {
+              result->done = true;
+              result->success = success;
+              result->response = response;
+              result->metadata = metadata;
+            },
+            result));
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  std::unique_ptr<core::MultiAdapterManager> adapter_manager_;
+};
+
+TEST_F(MockAdapterIntegrationTest, MocksReplaceTheListedProviders) {
+  auto provider_ids = adapter_manager_->GetRegisteredProviderIds();
+  std::sort(provider_ids.begin(), provider_ids.end());
+  EXPECT_EQ(provider_ids, (std::vector<std::string>{"gemini", "openai"}));
+  EXPECT_EQ(adapter_manager_->GetActiveProviderId(), "gemini");
+}
+
+TEST_F(MockAdapterIntegrationTest, AnswersAfterTheProviderLatency) {
+  Result result;
+  Send("page text", &result);
+
+  task_environment_.FastForwardBy(base::Milliseconds(299));
+  EXPECT_FALSE(result.done);
+  task_environment_.FastForwardBy(base::Milliseconds(1));
+  ASSERT_TRUE(result.done);
+  EXPECT_TRUE(result.success);
+  EXPECT_FALSE(result.metadata.from_cache);
+}
+
+TEST_F(MockAdapterIntegrationTest, RepeatedRequestsAreServedFromCache) {
+  Result first;
+  Send("page text", &first);
+  task_environment_.FastForwardBy(base::Milliseconds(300));
+  ASSERT_TRUE(first.success);
+
+  Result second;
+  Send("page text", &second);
+  task_environment_.RunUntilIdle();
+  ASSERT_TRUE(second.done);
+  EXPECT_TRUE(second.metadata.from_cache);
+  EXPECT_EQ(second.response, first.response);
+}
+
+TEST_F(MockAdapterIntegrationTest, ProviderSettingsOverrideSharedOnes) {
+  auto config = adapter_manager_->GetProviderConfiguration("openai");
+  EXPECT_EQ(config["latency_ms"], "800");
+  EXPECT_EQ(config["latency_distribution"], "fixed");
+}
+
+}  // namespace
+}  // namespace asol